@@ -193,6 +193,20 @@ def extract_ios_metric(
     if not method:
         return benchmark_result
 
+    # Recorded for all the tests by the DeviceConditionsMetric of the benchmark app
+    if metric_name == "Thermal State, level":
+        benchmark_result["metric"] = "avg_thermal_state"
+        benchmark_result["actualValue"] = metric_value
+        return benchmark_result
+    elif metric_name == "Low Power Mode, on":
+        benchmark_result["metric"] = "low_power_mode"
+        benchmark_result["actualValue"] = metric_value
+        return benchmark_result
+    elif metric_name == "Battery Level, %":
+        benchmark_result["metric"] = "avg_battery_level(%)"
+        benchmark_result["actualValue"] = metric_value
+        return benchmark_result
+
     # NB: This looks brittle, but unless we can return iOS benchmark results in JSON
     # format by the test, the mapping is needed to match with Android test
     if method == "load":
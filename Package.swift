@@ -38,7 +38,11 @@ let deliverables = [
     ],
   ],
   "backend_xnnpack": [:],
-  "executorch": [:],
+  "executorch": [
+    "frameworks": [
+      "CoreVideo",
+    ],
+  ],
   "kernels_custom": [:],
   "kernels_optimized": [:],
   "kernels_portable": [:],
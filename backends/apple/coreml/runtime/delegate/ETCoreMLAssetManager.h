@@ -90,8 +90,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSArray<ETCoreMLAsset*>*)mostRecentlyUsedAssetsWithMaxCount:(NSUInteger)maxCount
                                                                   error:(NSError* __autoreleasing*)error;
 
-/// Compacts the assets storage. The assets are moved to the trash directory and are asynchronously
-/// deleted.
+/// Compacts the assets storage. The least recently used assets that are not in use are moved to the
+/// trash directory and are asynchronously deleted.
 ///
 /// @param sizeInBytes The maximum size of the assets storage that the compaction should achieve.
 /// @param error   On failure, error is filled with the failure information.
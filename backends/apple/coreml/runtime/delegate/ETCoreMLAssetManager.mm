@@ -225,11 +225,13 @@ get_assets_to_remove(ModelAssetsStore& store,
                      NSMapTable<NSString *, ETCoreMLAsset *> *assets_in_use_map,
                      std::error_code &error) {
     std::vector<Asset> assets;
-    store.impl()->get_keys_sorted_by_access_count([store = store.impl(),
-                                                   &bytes_to_remove,
-                                                   &assets,
-                                                   assets_in_use_map,
-                                                   &error](const std::string& key) {
+    // Least recently used first, so that the models an app switches between
+    // stay cached while the ones it stopped using go away.
+    store.impl()->get_keys_sorted_by_access_time([store = store.impl(),
+                                                  &bytes_to_remove,
+                                                  &assets,
+                                                  assets_in_use_map,
+                                                  &error](const std::string& key) {
         if (bytes_to_remove <= 0) {
             return false;
         }
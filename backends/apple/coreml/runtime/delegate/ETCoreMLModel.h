@@ -63,6 +63,8 @@ __attribute__((objc_subclassing_restricted))
 - (nullable NSArray<MLMultiArray*>*)prepareInputs:(const std::vector<executorchcoreml::MultiArray>&)inputs
                                             error:(NSError* __autoreleasing*)error;
 
+/// Wraps the outputs that the prediction can write in place. The outputs whose shape is only known
+/// after the prediction are `NSNull` instead, and must be copied from the prediction result.
 - (nullable NSArray<MLMultiArray*>*)prepareOutputBackings:(const std::vector<executorchcoreml::MultiArray>&)outputs
                                                     error:(NSError* __autoreleasing*)error;
 
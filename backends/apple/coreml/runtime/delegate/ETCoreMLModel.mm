@@ -139,6 +139,16 @@ MLMultiArray * _Nullable make_ml_multi_array(const std::vector<size_t>& shape,
     return result;
 }
 
+/// Returns `true` if the model always returns the output in this shape, in which case the prediction
+/// can write it directly into the ExecuTorch tensor.
+bool is_output_shape_fixed(MLMultiArrayConstraint *constraint, const std::vector<size_t>& shape) {
+    if (constraint.shapeConstraint.type != MLMultiArrayShapeConstraintTypeUnspecified) {
+        return false;
+    }
+    
+    return to_vector<size_t>(constraint.shape) == shape;
+}
+
 NSDictionary<NSString *, MLMultiArrayConstraint *> *
 get_multi_array_constraints_by_name(NSDictionary<NSString *, MLFeatureDescription *> *feature_descriptions) {
     NSMutableDictionary<NSString *, MLMultiArrayConstraint *> *result = [NSMutableDictionary dictionaryWithCapacity:feature_descriptions.count];
@@ -237,6 +247,13 @@ void reset_state_for_feature_name(NSString *feature_name, MLState *state) {
         const auto& layout = arg.layout();
         auto dataType = to_ml_multiarray_data_type(layout.dataType());
         MLMultiArray *multiArrayArg = nil;
+        if (!copyData && !::is_output_shape_fixed(constraint, layout.shape())) {
+            // The shape of the output is only known after the prediction, let CoreML allocate it, it's
+            // copied to the output afterwards.
+            [result addObject:(MLMultiArray *)NSNull.null];
+            continue;
+        }
+        
         if (dataType == constraint.dataType) {
             // We can use the same data storage.
             multiArrayArg = [[MLMultiArray alloc] initWithDataPointer:arg.data()
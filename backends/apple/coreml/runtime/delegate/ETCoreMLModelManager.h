@@ -95,6 +95,19 @@ __attribute__((objc_subclassing_restricted))
 /// @param maxCount The maximum count of assets to be pre-warmed.
 - (void)prewarmRecentlyUsedAssetsWithMaxCount:(NSUInteger)maxCount;
 
+/// Loads the model from the AOT data and pre-warms it, compiling it first if the asset store
+/// doesn't have it. The model is kept until the next `loadModelFromAOTData` of the same model, which
+/// then returns it, and waits for it if the pre-warm is still in progress. Does nothing if the model
+/// is already loaded or pre-warmed.
+///
+/// @param data The AOT blob data.
+/// @param configuration The model configuration that will be used to load the model.
+/// @param error   On failure, error is filled with the failure information.
+/// @retval `YES` if the model was pre-warmed or already loaded otherwise `NO`.
+- (BOOL)prewarmModelFromAOTData:(NSData*)data
+                  configuration:(MLModelConfiguration*)configuration
+                          error:(NSError* __autoreleasing*)error;
+
 /// Pre-warms the model associated with the handle. This could potentially improve the model
 /// execution time.
 ///
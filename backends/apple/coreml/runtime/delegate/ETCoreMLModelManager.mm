@@ -94,7 +94,10 @@ MLPredictionOptions *get_prediction_options(NSArray<MLMultiArray *> *outputs,
             ETCoreMLLogErrorAndSetNSError(error, 0, "%@: Model is broken.", NSStringFromClass(ETCoreMLModelManager.class));
             return nil;
         }
-        output_backings[output_name] = output;
+        // The model allocates the outputs without a backing.
+        if ([output isKindOfClass:MLMultiArray.class]) {
+            output_backings[output_name] = output;
+        }
     }
     options.outputBackings = output_backings;
     
@@ -340,6 +343,7 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
 @property (nonatomic, readonly, strong) NSMutableDictionary<NSValue *, id<ETCoreMLModelExecutor>> *handleToExecutorMap;
 @property (nonatomic, readonly, strong) NSMapTable<NSString *, dispatch_queue_t> *modelIdentifierToLoadingQueueMap;
 @property (nonatomic, readonly, strong) NSMutableDictionary<NSString *, ETCoreMLAsset *> *modelIdentifierToPrewarmedAssetMap;
+@property (nonatomic, readonly, strong) NSMutableDictionary<NSString *, id<ETCoreMLModelExecutor>> *modelIdentifierToPrewarmedExecutorMap;
 @property (nonatomic, readonly, strong) dispatch_queue_t prewarmQueue;
 
 @end
@@ -354,6 +358,7 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
         _handleToExecutorMap = [NSMutableDictionary dictionary];
         _modelIdentifierToLoadingQueueMap = [NSMapTable strongToWeakObjectsMapTable];
         _modelIdentifierToPrewarmedAssetMap = [NSMutableDictionary dictionary];
+        _modelIdentifierToPrewarmedExecutorMap = [NSMutableDictionary dictionary];
         _fileManager = [[NSFileManager alloc] init];
         dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_DEFAULT, -1);
         _prewarmQueue = dispatch_queue_create("com.executorchcoreml.modelmanager.prewarm", attr);
@@ -521,8 +526,38 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
 }
 #endif
 
+- (BOOL)hasModelWithIdentifier:(NSString *)identifier {
+    BOOL result = NO;
+    {
+        os_unfair_lock_lock(&_lock);
+        result = (self.modelIdentifierToPrewarmedExecutorMap[identifier] != nil);
+        for (id<ETCoreMLModelExecutor> executor in self.handleToExecutorMap.objectEnumerator) {
+            if ([executor.model.identifier isEqualToString:identifier]) {
+                result = YES;
+                break;
+            }
+        }
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    return result;
+}
+
+- (nullable id<ETCoreMLModelExecutor>)takePrewarmedExecutorWithIdentifier:(NSString *)identifier {
+    id<ETCoreMLModelExecutor> executor = nil;
+    {
+        os_unfair_lock_lock(&_lock);
+        executor = self.modelIdentifierToPrewarmedExecutorMap[identifier];
+        [self.modelIdentifierToPrewarmedExecutorMap removeObjectForKey:identifier];
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    return executor;
+}
+
 - (nullable id<ETCoreMLModelExecutor>)_modelExecutorWithAOTData:(NSData *)data
                                                   configuration:(MLModelConfiguration *)configuration
+                                                        prewarm:(BOOL)prewarm
                                                           error:(NSError * __autoreleasing *)error {
     using namespace inmemoryfs;
     
@@ -548,15 +583,32 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
     auto metadataValue = metadata.value();
     add_compute_unit(metadataValue.identifier, configuration.computeUnits);
     NSString *identifier = @(metadataValue.identifier.c_str());
-    // If there are multiple calls to load the same model, we only want to compile it once.
+    // If there are multiple calls to load the same model, we only want to compile it once. This also
+    // makes a load wait for the pre-warm of the same model to finish, and then take the model.
     __block id<ETCoreMLModelExecutor> executor = nil;
     dispatch_queue_t loadingQueue = [self queueForLoadingModelWithIdentifier:identifier];
     auto inMemoryFSPtr = inMemoryFS.get();
     dispatch_sync(loadingQueue, ^{
+        if (prewarm) {
+            if ([self hasModelWithIdentifier:identifier]) {
+                return;
+            }
+        } else {
+            executor = [self takePrewarmedExecutorWithIdentifier:identifier];
+            if (executor) {
+                return;
+            }
+        }
+        
         executor = [self modelExecutorWithMetadata:metadataValue
                                         inMemoryFS:inMemoryFSPtr
                                      configuration:configuration
                                              error:error];
+        if (prewarm && executor && [executor.model prewarmAndReturnError:error]) {
+            os_unfair_lock_lock(&self->_lock);
+            self.modelIdentifierToPrewarmedExecutorMap[identifier] = executor;
+            os_unfair_lock_unlock(&self->_lock);
+        }
     });
     
     return executor;
@@ -579,6 +631,7 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
                                 error:(NSError* __autoreleasing*)error {
     id<ETCoreMLModelExecutor> executor = [self _modelExecutorWithAOTData:data
                                                            configuration:configuration
+                                                                 prewarm:NO
                                                                    error:error];
     {
         os_unfair_lock_lock(&_lock);
@@ -592,6 +645,21 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
     return (__bridge ModelHandle *)executor.model;
 }
 
+- (BOOL)prewarmModelFromAOTData:(NSData *)data
+                  configuration:(MLModelConfiguration *)configuration
+                          error:(NSError * __autoreleasing *)error {
+    NSError *localError = nil;
+    (void)[self _modelExecutorWithAOTData:data
+                            configuration:configuration
+                                  prewarm:YES
+                                    error:&localError];
+    if (error) {
+        *error = localError;
+    }
+    
+    return localError == nil;
+}
+
 - (BOOL)prewarmModelWithHandle:(ModelHandle *)handle
                          error:(NSError * __autoreleasing *)error {
     ETCoreMLModel *model = [self modelWithHandle:handle];
@@ -810,6 +878,9 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
 }
 
 - (BOOL)purgeModelsCacheAndReturnError:(NSError *__autoreleasing *)error {
+    os_unfair_lock_lock(&_lock);
+    [self.modelIdentifierToPrewarmedExecutorMap removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
     return [self.assetManager purgeAndReturnError:error];
 }
 
@@ -75,6 +75,16 @@ public:
     /// initialization failed.
     virtual Handle* init(Buffer processed, const std::unordered_map<std::string, Buffer>& specs) const noexcept = 0;
 
+    /// Must load and pre-warm a CoreML model ahead of its `init`.
+    ///
+    /// The implementation must keep the model so that the next `init` with
+    /// the same AOT blob and specs returns it without loading it again.
+    ///
+    /// @param processed The AOT blob.
+    /// @param specs The specs at the time of compilation.
+    /// @retval `true` if the model was pre-warmed otherwise `false`.
+    virtual bool prewarm(Buffer processed, const std::unordered_map<std::string, Buffer>& specs) const noexcept = 0;
+
     /// Must execute the CoreML model with the specified handle.
     ///
     /// The `args` are inputs and outputs combined. It's the responsibility of the
@@ -103,6 +103,10 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
                        configuration:(MLModelConfiguration*)configuration
                                error:(NSError* __autoreleasing*)error;
 
+- (BOOL)prewarmModelFromAOTData:(NSData*)data
+                  configuration:(MLModelConfiguration*)configuration
+                          error:(NSError* __autoreleasing*)error;
+
 - (BOOL)executeModelWithHandle:(ModelHandle*)handle
                        argsVec:(std::vector<executorchcoreml::MultiArray>&)argsVec
                 loggingOptions:(const executorchcoreml::ModelLoggingOptions&)loggingOptions
@@ -198,6 +202,18 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
     return handle;
 }
 
+- (BOOL)prewarmModelFromAOTData:(NSData*)data
+                  configuration:(MLModelConfiguration*)configuration
+                          error:(NSError* __autoreleasing*)error {
+    if (![self loadAndReturnError:error]) {
+        return NO;
+    }
+    
+    return [self.impl prewarmModelFromAOTData:data
+                                configuration:configuration
+                                        error:error];
+}
+
 - (BOOL)executeModelWithHandle:(ModelHandle*)handle
                        argsVec:(std::vector<executorchcoreml::MultiArray>&)argsVec
                 loggingOptions:(const executorchcoreml::ModelLoggingOptions&)loggingOptions
@@ -285,6 +301,17 @@ public:
         return modelHandle;
     }
     
+    bool prewarm(Buffer processed, const std::unordered_map<std::string, Buffer>& specs) const noexcept override {
+        NSError *localError = nil;
+        MLModelConfiguration *configuration = get_model_configuration(specs);
+        NSData *data = [NSData dataWithBytesNoCopy:const_cast<void *>(processed.data())
+                                            length:processed.size()
+                                      freeWhenDone:NO];
+        return static_cast<bool>([model_manager_ prewarmModelFromAOTData:data
+                                                           configuration:configuration
+                                                                   error:&localError]);
+    }
+    
     bool execute(Handle* handle,
                  std::vector<MultiArray>& args,
                  const ModelLoggingOptions& logging_options,
@@ -13,6 +13,9 @@
 #import <executorch/runtime/core/evalue.h>
 #import <executorch/runtime/platform/log.h>
 #import <executorch/runtime/kernel/kernel_includes.h>
+#import <executorch/schema/extended_header.h>
+#import <executorch/schema/program_generated.h>
+#import <functional>
 #import <memory>
 #import <model_event_logger.h>
 #import <model_logging_options.h>
@@ -38,6 +41,7 @@ using executorch::runtime::CompileSpec;
 using executorch::runtime::DelegateHandle;
 using executorch::runtime::EValue;
 using executorch::runtime::Error;
+using executorch::runtime::ExtendedHeader;
 using executorch::runtime::EventTracerDebugLogLevel;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::get_backend_class;
@@ -149,6 +153,98 @@ ModelLoggingOptions get_logging_options(BackendExecutionContext& context) {
     return options;
 }
 
+using DelegateFn = std::function<void(Buffer, const std::unordered_map<std::string, Buffer>&)>;
+
+/// Calls `fn` with the AOT blob and the compile specs of each CoreML delegate in the program.
+bool for_each_delegate(NSData *program_data, const DelegateFn& fn) {
+    const auto *bytes = static_cast<const uint8_t *>(program_data.bytes);
+    size_t program_size = program_data.length;
+    size_t segment_base_offset = 0;
+    auto header = ExtendedHeader::Parse(bytes, program_data.length);
+    if (header.ok()) {
+        program_size = static_cast<size_t>(header->program_size);
+        segment_base_offset = static_cast<size_t>(header->segment_base_offset);
+    } else if (header.error() != Error::NotFound) {
+        return false;
+    }
+
+    if (program_size > program_data.length || !executorch_flatbuffer::ProgramBufferHasIdentifier(bytes)) {
+        return false;
+    }
+
+    flatbuffers::Verifier verifier(bytes, program_size);
+    if (!executorch_flatbuffer::VerifyProgramBuffer(verifier)) {
+        return false;
+    }
+
+    const auto *program = executorch_flatbuffer::GetProgram(bytes);
+    if (program->execution_plan() == nullptr) {
+        return true;
+    }
+
+    for (const auto *plan : *program->execution_plan()) {
+        if (plan->delegates() == nullptr) {
+            continue;
+        }
+
+        for (const auto *delegate : *plan->delegates()) {
+            if (delegate->id() == nullptr ||
+                delegate->id()->str() != ETCoreMLStrings.delegateIdentifier.UTF8String ||
+                delegate->processed() == nullptr) {
+                continue;
+            }
+
+            const auto *processed = delegate->processed();
+            const size_t index = processed->index();
+            std::optional<Buffer> blob;
+            switch (processed->location()) {
+                case executorch_flatbuffer::DataLocation::INLINE: {
+                    const auto *inline_data = program->backend_delegate_data();
+                    if (inline_data != nullptr && index < inline_data->size() && inline_data->Get(index)->data() != nullptr) {
+                        const auto *data = inline_data->Get(index)->data();
+                        blob = Buffer(data->data(), data->size());
+                    }
+                    break;
+                }
+                case executorch_flatbuffer::DataLocation::SEGMENT: {
+                    const auto *segments = program->segments();
+                    if (segment_base_offset > 0 && segments != nullptr && index < segments->size()) {
+                        const size_t offset = segment_base_offset + segments->Get(index)->offset();
+                        const size_t size = segments->Get(index)->size();
+                        if (offset <= program_data.length && size <= program_data.length - offset) {
+                            blob = Buffer(bytes + offset, size);
+                        }
+                    }
+                    break;
+                }
+            }
+
+            if (!blob) {
+                return false;
+            }
+
+            std::unordered_map<std::string, Buffer> specs;
+            if (delegate->compile_specs() != nullptr) {
+                for (const auto *spec : *delegate->compile_specs()) {
+                    if (spec->key() != nullptr && spec->value() != nullptr) {
+                        specs.emplace(spec->key()->str(), Buffer(spec->value()->data(), spec->value()->size()));
+                    }
+                }
+            }
+
+            fn(std::move(blob.value()), specs);
+        }
+    }
+
+    return true;
+}
+
+dispatch_queue_t get_prewarm_queue() {
+    static dispatch_queue_t queue = dispatch_queue_create("com.executorchcoreml.delegate.prewarm",
+                                                          dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL, QOS_CLASS_UTILITY, 0));
+    return queue;
+}
+
 } //namespace
 
 namespace executorch {
@@ -259,6 +355,31 @@ bool CoreMLBackendDelegate::purge_models_cache() const noexcept {
     return impl_->purge_models_cache();
 }
 
+void CoreMLBackendDelegate::prewarm_programs(std::vector<std::string> program_paths) const noexcept {
+    std::shared_ptr<BackendDelegate> impl = impl_;
+    dispatch_async(get_prewarm_queue(), ^{
+        for (const auto& path : program_paths) {
+            NSError *localError = nil;
+            NSData *data = [NSData dataWithContentsOfFile:@(path.c_str())
+                                                  options:NSDataReadingMappedIfSafe
+                                                    error:&localError];
+            if (!data) {
+                ETCoreMLLogError(localError, "%s: Failed to read program at path = %s", ETCoreMLStrings.delegateIdentifier.UTF8String, path.c_str());
+                continue;
+            }
+
+            bool parsed = for_each_delegate(data, [&impl, &path](Buffer processed, const std::unordered_map<std::string, Buffer>& specs) {
+                if (!impl->prewarm(std::move(processed), specs)) {
+                    ET_LOG(Error, "%s: Failed to prewarm a model of the program at path = %s", ETCoreMLStrings.delegateIdentifier.UTF8String, path.c_str());
+                }
+            });
+            if (!parsed) {
+                ET_LOG(Error, "%s: Program at path = %s is invalid", ETCoreMLStrings.delegateIdentifier.UTF8String, path.c_str());
+            }
+        }
+    });
+}
+
 CoreMLBackendDelegate *CoreMLBackendDelegate::get_registered_delegate() noexcept {
     return static_cast<CoreMLBackendDelegate *>(get_backend_class(ETCoreMLStrings.delegateIdentifier.UTF8String));
 }
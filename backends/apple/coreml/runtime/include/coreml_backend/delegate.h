@@ -12,6 +12,8 @@
 #include <executorch/runtime/core/evalue.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace executorchcoreml {
 class BackendDelegate;
@@ -58,6 +60,16 @@ public:
     /// @param handle The handle returned by an earlier call to `init`.
     void destroy(executorch::runtime::DelegateHandle* handle) const override;
 
+    /// Loads and pre-warms the CoreML models of the programs on a background
+    /// queue, compiling the ones that aren't in the models cache.
+    ///
+    /// Call it early, e.g. at app start, so that the first load of the
+    /// programs doesn't pay for it. The `init` of a model that is being
+    /// pre-warmed waits for it to finish and then takes the pre-warmed model.
+    ///
+    /// @param program_paths The paths to the programs (.pte files).
+    void prewarm_programs(std::vector<std::string> program_paths) const noexcept;
+
     /// Returns the registered `CoreMLBackendDelegate` instance.
     static CoreMLBackendDelegate* get_registered_delegate() noexcept;
 
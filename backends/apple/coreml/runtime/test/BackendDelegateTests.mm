@@ -123,6 +123,21 @@ std::vector<MultiArray> to_multiarrays(NSArray<MLMultiArray *> *ml_multiarrays)
     }
 }
 
+- (void)testDelegatePrewarm {
+    NSURL *modelURL = [[self class] bundledResourceWithName:@"add_coreml_all" extension:@"bin"];
+    XCTAssertNotNil(modelURL);
+    NSData *data = [NSData dataWithContentsOfURL:modelURL];
+    XCTAssertTrue(_delegate->prewarm(Buffer(data.bytes, data.length), {}));
+    // The model is already pre-warmed.
+    XCTAssertTrue(_delegate->prewarm(Buffer(data.bytes, data.length), {}));
+    BackendDelegate::Handle *handle = _delegate->init(Buffer(data.bytes, data.length), {});
+    XCTAssert(handle != nullptr);
+    XCTAssertTrue(_delegate->is_valid_handle(handle));
+    // The model is already loaded.
+    XCTAssertTrue(_delegate->prewarm(Buffer(data.bytes, data.length), {}));
+    _delegate->destroy(handle);
+}
+
 - (void)testDelegateDestroy {
     NSURL *modelURL = [[self class] bundledResourceWithName:@"add_coreml_all" extension:@"bin"];
     XCTAssertNotNil(modelURL);
@@ -68,5 +68,8 @@ mkdir -p "$EXECUTORCH_INCLUDE_DIR_PATH"
 find extension \( -name "*.h" -o -name "*.hpp" \) -exec rsync -R '{}' "$EXECUTORCH_INCLUDE_DIR_PATH" \;
 find runtime \( -name "*.h" -o -name "*.hpp" \) -exec rsync -R '{}' "$EXECUTORCH_INCLUDE_DIR_PATH" \;
 find util \( -name "*.h" -o -name "*.hpp" \) -exec rsync -R '{}' "$EXECUTORCH_INCLUDE_DIR_PATH" \;
+find schema -name "*.h" -exec rsync -R '{}' "$EXECUTORCH_INCLUDE_DIR_PATH" \;
+cp -f "$CMAKE_EXECUTORCH_BUILD_DIR_PATH"/schema/include/executorch/schema/*_generated.h "$EXECUTORCH_INCLUDE_DIR_PATH/schema"
+rsync -r "$EXECUTORCH_ROOT_PATH/third-party/flatbuffers/include/flatbuffers" "$COREML_DIR_PATH/runtime/include"
 
 source "$SCRIPT_DIR_PATH/generate_test_models.sh"
@@ -40,6 +40,9 @@ class MPSExecutor {
   // Input/Output GPU buffer pointer
   std::vector<id<MTLBuffer>> _inputGPUBuffers;
   std::vector<id<MTLBuffer>> _outputGPUBuffers;
+  // Whether the GPU buffer changed since its tensor data was last built
+  std::vector<bool> _inputBuffersChanged;
+  std::vector<bool> _outputBuffersChanged;
 
   // Input/Output CPU buffer pointers
   std::vector<CPUBufferWrapper> _inputCPUBuffers;
@@ -59,6 +62,13 @@ class MPSExecutor {
 
     _inputsArray = nil;
     _outputsArray = nil;
+
+    for (id<MTLBuffer> buffer : _inputGPUBuffers) {
+      [buffer release];
+    }
+    for (id<MTLBuffer> buffer : _outputGPUBuffers) {
+      [buffer release];
+    }
   }
 
   inline size_t getNumInputs() {
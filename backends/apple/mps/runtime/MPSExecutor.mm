@@ -47,15 +47,25 @@ MPSExecutor::set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<
   // updateDataBuffers is a no-op for devices with shared memory.
   // In case of devices with non-shared memory, it will blit the contents to a private GPU buffer.
   updateDataBuffers(inputs, outputs);
+  // The tensor data only needs rebuilding when its buffer changed, so binding
+  // the same memory again is free.
   for (MPSGraphTensor *tensor in [_executable feedTensors]) {
     int i = _mpsGraphTensorToId[tensor];
+    if (!_inputBuffersChanged[i]) {
+      continue;
+    }
     MPSGraphTensorData* tensorData = [[[MPSGraphTensorData alloc]initWithMTLBuffer:_inputGPUBuffers[i]
                                                                             shape:[_inputShapes[i] shape]
                                                                           dataType:[_inputShapes[i] dataType]] autorelease];
     _inputsArray[i] = tensorData;
+    _inputBuffersChanged[i] = false;
   }
 
   for (int i = 0; i < outputs.size(); i++) {
+    if (!_outputBuffersChanged[i]) {
+      continue;
+    }
+    _outputBuffersChanged[i] = false;
     MPSGraphTensorData* tensorData = [[[MPSGraphTensorData alloc] initWithMTLBuffer:_outputGPUBuffers[i]
                                                                               shape:[_outputShapes[i] shape]
                                                                           dataType:[_outputShapes[i] dataType]] autorelease];
@@ -108,8 +118,10 @@ MPSExecutor::initDataBuffers() {
   int nInputs = getNumInputs();
   int nOutputs = getNumOutputs();
 
-  _inputGPUBuffers.resize(nInputs);
-  _outputGPUBuffers.resize(nOutputs);
+  _inputGPUBuffers.resize(nInputs, nil);
+  _outputGPUBuffers.resize(nOutputs, nil);
+  _inputBuffersChanged.resize(nInputs, true);
+  _outputBuffersChanged.resize(nOutputs, true);
 
   if (!_use_shared_mem) {
     _inputCPUBuffers.resize(nInputs);
@@ -146,6 +158,19 @@ MPSExecutor::initDataBuffers() {
   return error;
 }
 
+// Alias the tensor memory with an MTLBuffer, reusing the one of the previous
+// run if the tensor still points to the same memory. Returns whether the
+// buffer changed.
+static bool
+aliasTensorStorage(id<MTLBuffer>& buffer, const Tensor& tensor) {
+  if (buffer && [buffer contents] == tensor.const_data_ptr() && [buffer length] == tensor.nbytes()) {
+    return false;
+  }
+  [buffer release];
+  buffer = getMTLBufferStorage(tensor);
+  return true;
+}
+
 Error
 MPSExecutor::updateDataBuffers(
   std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs
@@ -155,7 +180,9 @@ MPSExecutor::updateDataBuffers(
     void* host_src = tensor.mutable_data_ptr<void*>();
     if (_use_shared_mem) {
       // Use directly the CPU buffer when using shared memory.
-      _inputGPUBuffers[i] = getMTLBufferStorage(tensor);
+      if (aliasTensorStorage(_inputGPUBuffers[i], tensor)) {
+        _inputBuffersChanged[i] = true;
+      }
     } else {
       _inputCPUBuffers[i].flags = 0;
 #if TARGET_OS_SIMULATOR
@@ -184,7 +211,9 @@ MPSExecutor::updateDataBuffers(
 
   if (_use_shared_mem) {
     for (int i = 0; i < outputs.size(); i++) {
-      _outputGPUBuffers[i] = getMTLBufferStorage(*outputs[i]);
+      if (aliasTensorStorage(_outputGPUBuffers[i], *outputs[i])) {
+        _outputBuffersChanged[i] = true;
+      }
     }
   }
 
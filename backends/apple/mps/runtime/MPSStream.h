@@ -65,6 +65,19 @@ class MPSStream {
   void endKernelCoalescing();
   ET_NODISCARD executorch::runtime::Error synchronize(SyncType syncType);
   bool commitAndContinueEnabled();
+
+  /**
+   * Batch the delegate calls made until the matching endBatch() into as few
+   * command buffers as possible: each call commits its work with
+   * commit-and-continue instead of waiting for the GPU, so consecutive calls
+   * are pipelined. Outputs may not be read on the CPU before endBatch()
+   * returns. Batches nest, and only the outermost endBatch() waits.
+   */
+  void beginBatch();
+  ET_NODISCARD executorch::runtime::Error endBatch();
+  bool isBatching() const {
+    return _batchDepth > 0;
+  }
   void copy(
       id<MTLBuffer> srcBuffer,
       id<MTLBuffer> dstBuffer,
@@ -94,6 +107,8 @@ class MPSStream {
   dispatch_queue_t _serialQueue = nullptr;
   // CommitAndContinue is disabled by default
   bool _enableCommitAndContinue = false;
+  // nesting depth of beginBatch() calls
+  int _batchDepth = 0;
   // accumulated sizes of resources encoded on command buffer
   size_t _commandBufferResourceSize = 0;
   // unfortunately, there's no way to get the underlying buffer from
@@ -90,6 +90,27 @@ bool MPSStream::commitAndContinueEnabled() {
   return _enableCommitAndContinue;
 }
 
+void MPSStream::beginBatch() {
+  if (_batchDepth++ == 0) {
+    _enableCommitAndContinue = true;
+  }
+}
+
+ET_NODISCARD
+Error MPSStream::endBatch() {
+  ET_CHECK_OR_RETURN_ERROR(
+    _batchDepth > 0,
+    InvalidState,
+    "endBatch() called without a matching beginBatch()");
+  if (--_batchDepth > 0) {
+    return Error::Ok;
+  }
+  // Wait for the whole batch, then go back to committing per call.
+  Error err = synchronize(SyncType::COMMIT_AND_WAIT);
+  _enableCommitAndContinue = false;
+  return err;
+}
+
 void MPSStream::commitAndContinue() {
   assert(_commandBuffer);
   [_commandBuffer commitAndContinue];
@@ -32,6 +32,7 @@ class ArmCompileSpecBuilder:
         self.path_for_intermediates = None
         self.tosa_spec = None
         self.input_order = None
+        self.shared_scratch = False
 
     def ethosu_compile_spec(
         self,
@@ -40,6 +41,7 @@ class ArmCompileSpecBuilder:
         memory_mode: str,
         extra_flags: Optional[str] = None,
         config_ini: Optional[str] = "Arm/vela.ini",
+        shared_scratch: bool = False,
     ) -> "ArmCompileSpecBuilder":
         """
         Generate compile spec for Ethos-U NPU
@@ -52,6 +54,10 @@ class ArmCompileSpecBuilder:
             extra_flags: Extra flags for the Vela compiler
             config_ini: Vela configuration file(s) in Python ConfigParser .ini
                 file format
+            shared_scratch: Don't embed the scratch in each delegate, but have
+                the runtime allocate it from the temp allocator, so that all
+                the Ethos-U delegates of a method share one arena. The temp
+                allocator must then fit the largest scratch.
         """
         assert (
             self.output_format is None
@@ -67,6 +73,7 @@ class ArmCompileSpecBuilder:
             self.compiler_flags.append(f"--memory-mode={memory_mode}")
         if extra_flags is not None:
             self.compiler_flags.append(extra_flags)
+        self.shared_scratch = shared_scratch
 
         base_tosa_version = "TOSA-0.80+BI"
         if "u55" in config:
@@ -117,6 +124,8 @@ class ArmCompileSpecBuilder:
                 CompileSpec("output_format", "vela".encode()),
                 CompileSpec("compile_flags", " ".join(self.compiler_flags).encode()),
             ]
+            if self.shared_scratch:
+                self.compile_spec.append(CompileSpec("shared_scratch", "1".encode()))
         elif self.output_format == "tosa":
             self.compile_spec.append(CompileSpec("output_format", "tosa".encode()))
 
@@ -46,10 +46,16 @@ def vela_bin_pack_io(prefix, data, shape_order=None):
 # WARNING: Do not change this without changing VelaBinStream.cpp as that
 #          function consumes this format and the two need to align.
 def vela_compile(
-    tosa_flatbuffer: bytes, args: List[str], shape_order=None, verbose: bool = False
+    tosa_flatbuffer: bytes,
+    args: List[str],
+    shape_order=None,
+    verbose: bool = False,
+    shared_scratch: bool = False,
 ):
     """
     Compile a TOSA graph to a binary stream for ArmBackendEthosU using Vela.
+    With shared_scratch, only the size of the scratch is emitted and the
+    runtime allocates it from the temp allocator for each execution.
     """
     if not has_vela:
         raise RuntimeError(
@@ -95,7 +101,10 @@ def vela_compile(
             if not isinstance(data["scratch_shape"][0], np.int64):
                 raise RuntimeError("Expected scratch to be int64")
             block_length = int(data["scratch_shape"][0])
-            bin_blocks["scratch_data"] = b"\x00" * block_length
+            if shared_scratch:
+                bin_blocks["scratch_size"] = struct.pack("<i", block_length)
+            else:
+                bin_blocks["scratch_data"] = b"\x00" * block_length
 
             # Capture inputs and outputs
             bin_blocks["inputs"] = vela_bin_pack_io("input", data, shape_order)
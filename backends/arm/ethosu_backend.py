@@ -44,11 +44,14 @@ class EthosUBackend(BackendDetails):
         """
         compile_flags = []
         input_order = []
+        shared_scratch = False
         for spec in compile_spec:
             if spec.key == "compile_flags":
                 compile_flags.append(spec.value.decode())
             if spec.key == "input_order":
                 input_order = list(map(int, spec.value.decode().split(",")))
+            if spec.key == "shared_scratch":
+                shared_scratch = spec.value.decode() == "1"
 
         if len(compile_flags) == 0:
             # Not testing for compile_flags correctness here, just that they are
@@ -63,6 +66,7 @@ class EthosUBackend(BackendDetails):
             compile_flags,
             input_order,
             verbose=logger.getEffectiveLevel() == logging.INFO,
+            shared_scratch=shared_scratch,
         )
         return binary
 
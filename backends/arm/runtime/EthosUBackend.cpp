@@ -82,6 +82,10 @@ typedef struct {
 extern "C" {
 void __attribute__((weak)) EthosUBackend_execute_begin() {}
 void __attribute__((weak)) EthosUBackend_execute_end() {}
+// Called once the NPU has been started, while it runs the command stream, so
+// the application can get on with other work such as preparing the input of
+// the next inference. It must not touch the tensors of the running one.
+void __attribute__((weak)) EthosUBackend_execute_npu_busy() {}
 }
 
 class EthosUBackendExecuteCallbacks {
@@ -179,6 +183,24 @@ class EthosUBackend final : public ::executorch::runtime::BackendInterface {
         handles.scratch_data,
         handles.scratch_data_size);
 
+    // Models compiled with a shared scratch only carry its size. Since the
+    // temp allocator is reset after each delegate call, all the Ethos-U
+    // delegates of a method share the same arena, sized by the largest one.
+    if (handles.scratch_data == nullptr) {
+      MemoryAllocator* temp_allocator = context.get_temp_allocator();
+      if (temp_allocator != nullptr) {
+        handles.scratch_data = static_cast<char*>(
+            temp_allocator->allocate(handles.scratch_data_size, 16));
+      }
+      if (handles.scratch_data == nullptr) {
+        ET_LOG(
+            Error,
+            "EthosUBackend::execute: failed to allocate %zu bytes of scratch from the temp allocator",
+            handles.scratch_data_size);
+        return Error::MemoryAllocationFailed;
+      }
+    }
+
     // Write argument values (from EValue tensor) into Ethos-U scratch
     // TODO(MLETORCH-123): Optimise into direct write from Vela into the SRAM
     //                     or DRAM output for compatible data layouts.
@@ -270,7 +292,7 @@ class EthosUBackend final : public ::executorch::runtime::BackendInterface {
       }
     }
 
-    // Allocate driver handle and synchronously invoke driver
+    // Allocate driver handle and invoke driver
     auto driver =
         std::unique_ptr<ethosu_driver, decltype(&ethosu_release_driver)>(
             ethosu_reserve_driver(), ethosu_release_driver);
@@ -292,7 +314,7 @@ class EthosUBackend final : public ::executorch::runtime::BackendInterface {
     int result = 0;
     EXECUTORCH_PROF_START(
         event_tracer, event_tracer_local_scope, "+EthosUBackend::execute()NPU");
-    result = ethosu_invoke_v3(
+    result = ethosu_invoke_async(
         driver.get(),
         (void*)handles.cmd_data,
         handles.cmd_data_size,
@@ -300,6 +322,12 @@ class EthosUBackend final : public ::executorch::runtime::BackendInterface {
         bases_size,
         2, /* fixed array of pointers to binary interface*/
         nullptr);
+    if (result == 0) {
+      // Let the CPU do other work while the NPU is running, then block until
+      // the inference is done.
+      EthosUBackend_execute_npu_busy();
+      result = ethosu_wait(driver.get(), true);
+    }
     EXECUTORCH_PROF_END(event_tracer, event_tracer_local_scope);
 
     if (result != 0) {
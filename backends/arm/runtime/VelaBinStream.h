@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2024 Arm Limited and/or its affiliates.
+ * Copyright 2023-2025 Arm Limited and/or its affiliates.
  *
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
@@ -54,6 +54,8 @@ typedef struct {
   size_t cmd_data_size;
   const char* weight_data;
   size_t weight_data_size;
+  // Null when the stream only holds the scratch size, in which case the
+  // backend allocates scratch_data_size bytes for each execution.
   char* scratch_data;
   size_t scratch_data_size;
   VelaIOs* inputs;
@@ -30,6 +30,7 @@ from executorch.backends.cadence.aot.compiler_utils import (
     get_tensor_from_attr,
     get_transposed_dims,
     get_zero_point,
+    quantize_tensor_multiplier,
 )
 from executorch.backends.cadence.aot.pass_utils import (
     CadencePassAttribute,
@@ -1037,6 +1038,116 @@ class FuseFullThenReshapePass(ExportPass):
         return PassResult(graph_module, True)
 
 
+@register_cadence_pass(CadencePassAttribute(opt_level=1))
+class FuseQuantizedReluIntoProducerPass(ExportPass):
+    """
+    Fold a cadence::quantized_relu into the cadence::quantized_conv or
+    cadence::quantized_linear producing its input, so that the relu costs no
+    extra pass over the output. This is exact when the relu output is
+    quantized with the smallest value of its dtype as zero point, which is
+    what an observer of a relu output gives: the producer then requantizes
+    straight to the scale and zero point of the relu output, and saturating to
+    the dtype range clamps the negative values to zero.
+    """
+
+    @staticmethod
+    def get_full_value(node: Argument) -> Number | None:
+        # The value of a single element tensor created by aten.full.
+        if (
+            not isinstance(node, torch.fx.Node)
+            or node.target != exir_ops.edge.aten.full.default
+            or tuple(node.args[0]) != (1,)
+        ):
+            return None
+        return cast(Number, node.args[1])
+
+    @staticmethod
+    def get_requantize_scale(multiplier: Number, shift: Number) -> float:
+        # The inverse of quantize_tensor_multiplier.
+        # pyre-ignore[6]: Incompatible parameter type
+        return abs(multiplier) / (1 << 31) * math.pow(2, shift)
+
+    def attempt_fusion(
+        self, graph_module: torch.fx.GraphModule, relu: torch.fx.Node
+    ) -> None:
+        if relu.target != exir_ops.edge.cadence.quantized_relu.default:
+            return
+
+        producer = relu.args[0]
+        if (
+            not isinstance(producer, torch.fx.Node)
+            or producer.target
+            not in {
+                exir_ops.edge.cadence.quantized_conv.default,
+                exir_ops.edge.cadence.quantized_linear.default,
+            }
+            or len(producer.users) != 1
+        ):
+            return
+        is_conv = producer.target == exir_ops.edge.cadence.quantized_conv.default
+        # The index of out_multiplier, out_shift and out_zero_point in the args
+        # of the producer.
+        (multiplier_idx, shift_idx, zero_point_idx) = (
+            (12, 13, 11) if is_conv else (5, 6, 7)
+        )
+
+        in_zero_point = self.get_full_value(relu.args[1])
+        relu_multiplier = self.get_full_value(relu.args[3])
+        relu_shift = self.get_full_value(relu.args[4])
+        multiplier = self.get_full_value(producer.args[multiplier_idx])
+        shift = self.get_full_value(producer.args[shift_idx])
+        if None in (in_zero_point, relu_multiplier, relu_shift, multiplier, shift):
+            return
+        if in_zero_point != producer.args[zero_point_idx]:
+            return
+
+        # The relu must not clamp anything but what saturation clamps.
+        out_zero_point = relu.args[2]
+        out_dtype = producer.meta["val"].dtype
+        if out_zero_point != torch.iinfo(out_dtype).min:
+            return
+
+        # pyre-ignore[6]: Incompatible parameter type
+        relu_scale = self.get_requantize_scale(relu_multiplier, relu_shift)
+        # pyre-ignore[6]: Incompatible parameter type
+        requantize_scale = self.get_requantize_scale(multiplier, shift) * relu_scale
+        (new_multiplier, new_shift) = quantize_tensor_multiplier(
+            torch.tensor([requantize_scale])
+        )
+
+        new_args = list(producer.args)
+        with graph_module.graph.inserting_before(producer):
+            new_args[multiplier_idx] = graph_module.graph.call_function(
+                exir_ops.edge.aten.full.default,
+                ([1], new_multiplier[0].item()),
+                {"dtype": torch.int32},
+            )
+            new_args[shift_idx] = graph_module.graph.call_function(
+                exir_ops.edge.aten.full.default,
+                ([1], new_shift[0].item()),
+                {"dtype": torch.int32},
+            )
+        new_args[zero_point_idx] = out_zero_point
+        if is_conv:
+            # The HiFi conv requantizes with the float out_scale.
+            # pyre-ignore[58]: Unsupported operand /
+            new_args[10] = producer.args[10] / relu_scale
+
+        logging.debug(f"Fused {relu} into {producer}")
+
+        producer.args = tuple(new_args)
+        relu.replace_all_uses_with(producer)
+        graph_module.graph.erase_node(relu)
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        for node in list(graph_module.graph.nodes):
+            self.attempt_fusion(graph_module, node)
+        graph_module.graph.eliminate_dead_code()
+        graph_module.recompile()
+        result = super().call(graph_module)
+        return result
+
+
 class CadenceFuseOpsInGraph:
     passes = [
         FuseMMWithAdd,
@@ -1046,6 +1157,7 @@ class CadenceFuseOpsInGraph:
         FuseCascadedViewOps,
         FuseQuantDequantToRequantizePass,
         FuseMulIntoDequantPass,
+        FuseQuantizedReluIntoProducerPass,
         FuseFullThenReshapePass,
         FuseTransposeOpPairsPass,
     ]
@@ -17,6 +17,7 @@ from executorch.backends.cadence.aot.fuse_ops import (
     FuseFullThenReshapePass,
     FuseMulIntoDequantPass,
     FuseQuantDequantToRequantizePass,
+    FuseQuantizedReluIntoProducerPass,
     FuseTransposeOpPairsPass,
 )
 from executorch.backends.cadence.aot.graph_builder import GraphBuilder
@@ -484,6 +485,74 @@ class TestFusionPasses(TestFusionPassesBase):
         )
 
 
+    def _build_quantized_linear_relu(self, relu_out_zero_point: int):
+        # Create a graph with quantized_linear -> quantized_relu.
+        builder = GraphBuilder()
+        x = builder.placeholder(
+            "x", torch.randint(-128, 127, (2, 8), dtype=torch.int8)
+        )
+        w = builder.placeholder(
+            "w", torch.randint(-128, 127, (4, 8), dtype=torch.int8)
+        )
+        b = builder.placeholder(
+            "b", torch.randint(-128, 127, (4,), dtype=torch.int32)
+        )
+
+        def full(value):
+            return builder.call_operator(
+                op=exir_ops.edge.aten.full.default,
+                args=([1], value),
+                kwargs={"dtype": torch.int32},
+            )
+
+        # Requantize scales of 2**-7 and 0.5.
+        linear = builder.call_operator(
+            op=exir_ops.edge.cadence.quantized_linear.default,
+            args=(x, w, b, 0, full(0), full(1 << 30), full(-6), 5, None),
+        )
+        relu = builder.call_operator(
+            op=exir_ops.edge.cadence.quantized_relu.default,
+            args=(linear, full(5), relu_out_zero_point, full(1 << 30), full(0)),
+        )
+        builder.output(relu)
+        return builder.get_graph_module()
+
+    def test_fuse_quantized_relu_into_linear(self):
+        gm = self._build_quantized_linear_relu(relu_out_zero_point=-128)
+        gm_after_pass = FuseQuantizedReluIntoProducerPass()(gm).graph_module
+
+        self.check_op_counts(
+            gm_after_pass,
+            expected_op_counts={
+                exir_ops.edge.cadence.quantized_linear.default: 1,
+                exir_ops.edge.cadence.quantized_relu.default: 0,
+            },
+        )
+        linear = next(
+            node
+            for node in gm_after_pass.graph.nodes
+            if node.target == exir_ops.edge.cadence.quantized_linear.default
+        )
+        # The linear now requantizes straight to the relu output, with a scale
+        # of 2**-8.
+        self.assertEqual(linear.args[5].args[1], 1 << 30)
+        self.assertEqual(linear.args[6].args[1], -7)
+        self.assertEqual(linear.args[7], -128)
+
+    def test_no_fuse_quantized_relu_with_clamping_zero_point(self):
+        # A relu output zero point above the dtype min means the relu clamps
+        # more than saturation does.
+        gm = self._build_quantized_linear_relu(relu_out_zero_point=0)
+        gm_after_pass = FuseQuantizedReluIntoProducerPass()(gm).graph_module
+
+        self.check_op_counts(
+            gm_after_pass,
+            expected_op_counts={
+                exir_ops.edge.cadence.quantized_linear.default: 1,
+                exir_ops.edge.cadence.quantized_relu.default: 1,
+            },
+        )
+
 class TestFuseTransposeOpPairsPass(TestFusionPassesBase):
     def test_fuse_transpose_pairs(self):
         # Create a graph with transpose -> quant -> transpose.
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/fusion_g3/operators/operators.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <xa_nnlib_kernels_api.h>
+
+#include <executorch/backends/cadence/fusion_g3/operators/xt_macros.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::string_view;
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::KernelRuntimeContext;
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// Portable fallback for erf gelu and non-float dtypes.
+Tensor& gelu_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    string_view approximate,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace cadence {
+namespace impl {
+namespace G3 {
+namespace native {
+
+namespace {
+
+// Number of elements processed per nnlib call, small enough for the
+// intermediate buffers to live on the stack.
+constexpr int kGeluBlockSize = 256;
+
+} // namespace
+
+Tensor& gelu_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    string_view approximate,
+    Tensor& out) {
+  // nnlib has no vector erf, so only the tanh approximation is accelerated.
+  if (!((in.scalar_type() == ScalarType::Float) &&
+        (out.scalar_type() == ScalarType::Float) && (approximate == "tanh"))) {
+    return torch::executor::native::gelu_out(ctx, in, approximate, out);
+  }
+
+#ifdef OP_ARG_CHECK
+  ET_KERNEL_CHECK(
+      ctx,
+      torch::executor::check_gelu_args(in, approximate, out),
+      InvalidArgument,
+      out);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      executorch::runtime::resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensors_have_same_dim_order(in, out),
+      InvalidArgument,
+      out);
+#endif
+
+  // gelu(x) = 0.5 * x * (1 + tanh(beta * (x + kappa * x^3))), with the tanh of
+  // each block computed by nnlib.
+  constexpr float kBeta = M_SQRT2 * M_2_SQRTPI * 0.5;
+  constexpr float kKappa = 0.044715;
+
+  // in and out may alias, so the tanh goes to its own buffer.
+  const float* const in_data = in.const_data_ptr<float>();
+  float* const out_data = out.mutable_data_ptr<float>();
+  float inner[kGeluBlockSize];
+  float tanh_inner[kGeluBlockSize];
+
+  const int num_elm = out.numel();
+  for (int start = 0; start < num_elm; start += kGeluBlockSize) {
+    const int size = std::min(kGeluBlockSize, num_elm - start);
+    const float* const x = in_data + start;
+    float* const y = out_data + start;
+
+    for (int i = 0; i < size; ++i) {
+      inner[i] = kBeta * x[i] * (1.0f + kKappa * x[i] * x[i]);
+    }
+    XT_KERNEL_CHECK(ctx, out, xa_nn_tanh_f32_f32, tanh_inner, inner, size);
+    // tanh saturates to -1 well before x reaches -inf, where 0.5 * x * 0
+    // would be nan instead of 0.
+    for (int i = 0; i < size; ++i) {
+      const float t = tanh_inner[i];
+      y[i] = t == -1.0f ? 0.0f : 0.5f * x[i] * (1.0f + t);
+    }
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace G3
+} // namespace impl
+} // namespace cadence
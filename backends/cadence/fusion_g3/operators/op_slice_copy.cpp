@@ -124,7 +124,12 @@ Tensor& slice_copy_Tensor_out(
         InvalidArgument,
         out);
 
-    torch::executor::compute_slice(in, dim, start, length, step, out);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        torch::executor::compute_slice(in, dim, start, length, step, out),
+        Internal,
+        out,
+        "parallel_for failed");
   }
 
   return out;
@@ -98,6 +98,12 @@ namespace native {
     const ::executorch::aten::Tensor& in,
     ::executorch::aten::Tensor& out);
 
+::executorch::aten::Tensor& gelu_out(
+    ::executorch::runtime::KernelRuntimeContext& ctx,
+    const ::executorch::aten::Tensor& in,
+    ::executorch::aten::string_view approximate,
+    ::executorch::aten::Tensor& out);
+
 ::executorch::aten::Tensor& mean_dim_out(
     ::executorch::runtime::KernelRuntimeContext& ctx,
     const ::executorch::aten::Tensor& in,
@@ -36,6 +36,7 @@ OPERATORS = [
     "add",
     "cat",
     "clamp",
+    "gelu",
     "lt",
     "rsqrt",
     "sigmoid",
@@ -56,6 +57,13 @@ OPERATORS = [
     "permute_copy"
 ]
 
+# Operators that fall back to their portable kernel for the cases that have no
+# nnlib equivalent. The kernel is linked into the same library, and the op
+# declares it itself because portable kernels have no header.
+OPERATOR_DEPS = {
+    "gelu": ["//executorch/kernels/portable/cpu:op_gelu"],
+}
+
 def define_common_targets():
     """Defines targets that should be shared between fbcode and xplat.
 
@@ -102,4 +110,4 @@ def define_common_targets():
     )
 
     for op in OPERATORS:
-        define_operator(op)
+        define_operator(op, OPERATOR_DEPS.get(op))
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+using executorch::aten::ScalarType;
+using executorch::aten::SizesType;
+using executorch::aten::Tensor;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::kTensorDimensionLimit;
+using executorch::runtime::resize_tensor;
+using executorch::runtime::tensor_is_default_dim_order;
+using executorch::runtime::tensors_have_same_dim_order;
+using torch::executor::check_bmm_args;
+using torch::executor::Error;
+using torch::executor::get_bmm_out_target_size;
+
+namespace cadence {
+namespace impl {
+namespace HiFi {
+namespace native {
+
+Tensor& bmm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    Tensor& out) {
+  ET_KERNEL_CHECK(ctx, check_bmm_args(in, mat2, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, mat2, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  SizesType output_sizes[kTensorDimensionLimit];
+  get_bmm_out_target_size(in, mat2, output_sizes, &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int batch_size = in.size(0);
+  const int m = in.size(1);
+  const int n = in.size(2);
+  const int p = mat2.size(2);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  if (in.scalar_type() == ScalarType::Float) {
+    const float* __restrict__ p_mat1 = in.const_data_ptr<float>();
+    const float* __restrict__ p_mat2 = mat2.const_data_ptr<float>();
+    float* __restrict__ p_out = out.mutable_data_ptr<float>();
+
+    // Each mat2 is transposed into the same scratch buffer, so that the nnlib
+    // matmul reads its columns as contiguous vectors.
+    float* __restrict__ p_mat2_t = (float* __restrict__)
+        kernels::allocate_temp_memory(ctx, n * p * sizeof(float));
+    ET_KERNEL_CHECK(ctx, p_mat2_t != nullptr, MemoryAllocationFailed, out);
+
+    const int inp_shape[2] = {n, p};
+    const int out_shape[2] = {p, n};
+    const int permute_vec[2] = {1, 0};
+    for (int i = 0; i < batch_size; ++i) {
+      WORD32 ret_val = xa_nn_transpose_32_32(
+          (WORD32*)p_mat2_t,
+          out_shape,
+          (const WORD32*)(p_mat2 + i * n * p),
+          inp_shape,
+          permute_vec,
+          2,
+          2);
+      ET_KERNEL_CHECK(ctx, ret_val == 0, Internal, out);
+
+      ret_val = xa_nn_matmul_f32xf32_f32(
+          p_out + i * m * p, // p_out
+          p_mat1 + i * m * n, // p_mat1
+          p_mat2_t, // p_vec1
+          nullptr, // p_bias
+          m, // rows of p_mat1
+          n, // cols of p_mat1
+          n, // row_stride of p_mat1
+          p, // vec_count, i.e., rows of p_mat2_t
+          n, // vec_offset of p_mat2_t
+          1, // out_offset, i.e., offset of next output element written
+          p); // out_stride, i.e., stride to go to next output row
+      ET_KERNEL_CHECK(ctx, ret_val == 0, Internal, out);
+    }
+
+    return out;
+  }
+
+  ET_SWITCH_REAL_TYPES_AND(
+      Half, in.scalar_type(), ctx, "bmm.out", CTYPE, [&]() {
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        const CTYPE* mat2_data = mat2.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+        for (int i = 0; i < batch_size; ++i) {
+          torch::executor::vec_matmul<CTYPE>(
+              out_data + i * m * p,
+              in_data + i * m * n,
+              mat2_data + i * n * p,
+              m,
+              n,
+              p);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace HiFi
+} // namespace impl
+} // namespace cadence
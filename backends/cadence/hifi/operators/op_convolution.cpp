@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+using executorch::aten::IntArrayRef;
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::SizesType;
+using executorch::aten::Tensor;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::kTensorDimensionLimit;
+using executorch::runtime::resize_tensor;
+using executorch::runtime::tensor_is_default_dim_order;
+using torch::executor::check_convolution_args;
+using torch::executor::Error;
+using torch::executor::get_convolution_out_target_size;
+using torch::executor::val_at;
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// Portable fallback for 2d, transposed and non-float convolutions.
+Tensor& convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace cadence {
+namespace impl {
+namespace HiFi {
+namespace native {
+
+// Float 1d convolutions, the common case in audio models, are lowered to
+// im2col followed by the nnlib matmul. Everything else goes to the portable
+// kernel.
+Tensor& convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  bool optimized = true;
+
+  if ((in.scalar_type() != ScalarType::Float) ||
+      (out.scalar_type() != ScalarType::Float))
+    optimized = false;
+
+  if (in.dim() != 3 || transposed)
+    optimized = false;
+
+  if (!optimized) {
+    return torch::executor::native::convolution_out(
+        ctx,
+        in,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        transposed,
+        output_padding,
+        groups,
+        out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // input comes in shape [batch, in_channels, in_len]
+  // weight comes in shape [out_channels, in_channels / groups, kernel_len]
+  // output comes in empty with shape [batch, out_channels, out_len]
+  const int batch_size = in.size(0);
+  const int in_channels = in.size(1);
+  const int in_len = in.size(2);
+  const int out_channels = out.size(1);
+  const int out_len = out.size(2);
+  const int kernel_len = weight.size(2);
+  const int group_in_channels = in_channels / groups;
+  const int group_out_channels = out_channels / groups;
+  const int stride_len = val_at(stride, 0);
+  const int padding_len = val_at(padding, 0, /*default_value=*/0);
+  const int dilation_len = val_at(dilation, 0);
+
+  // Each column, i.e. the receptive field of one output position, is stored
+  // contiguously so that the nnlib matmul reads it as a vector.
+  const int col_size = group_in_channels * kernel_len;
+  float* __restrict__ p_cols = (float* __restrict__)
+      kernels::allocate_temp_memory(ctx, out_len * col_size * sizeof(float));
+  ET_KERNEL_CHECK(ctx, p_cols != nullptr, MemoryAllocationFailed, out);
+
+  const float* __restrict__ p_inp = in.const_data_ptr<float>();
+  const float* __restrict__ p_weight = weight.const_data_ptr<float>();
+  const float* __restrict__ p_bias =
+      bias.has_value() ? bias.value().const_data_ptr<float>() : nullptr;
+  float* __restrict__ p_out = out.mutable_data_ptr<float>();
+
+  for (int b = 0; b < batch_size; ++b) {
+    for (int g = 0; g < groups; ++g) {
+      const float* __restrict__ p_group_inp =
+          p_inp + (b * in_channels + g * group_in_channels) * in_len;
+      for (int t = 0; t < out_len; ++t) {
+        float* __restrict__ p_col = p_cols + t * col_size;
+        const int start = t * stride_len - padding_len;
+        for (int c = 0; c < group_in_channels; ++c) {
+          for (int k = 0; k < kernel_len; ++k) {
+            const int pos = start + k * dilation_len;
+            p_col[c * kernel_len + k] = (pos >= 0 && pos < in_len)
+                ? p_group_inp[c * in_len + pos]
+                : 0.0f;
+          }
+        }
+      }
+
+      WORD32 ret_val = xa_nn_matmul_f32xf32_f32(
+          p_out + (b * out_channels + g * group_out_channels) * out_len,
+          p_weight + g * group_out_channels * col_size, // p_mat1
+          p_cols, // p_vec1
+          p_bias != nullptr ? p_bias + g * group_out_channels
+                            : nullptr, // p_bias
+          group_out_channels, // rows of p_mat1
+          col_size, // cols of p_mat1
+          col_size, // row_stride of p_mat1
+          out_len, // vec_count, i.e., number of columns
+          col_size, // vec_offset of p_cols
+          1, // out_offset, i.e., offset of next output element written
+          out_len); // out_stride, i.e., stride to go to next output row
+      ET_KERNEL_CHECK(ctx, ret_val == 0, Internal, out);
+    }
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace HiFi
+} // namespace impl
+} // namespace cadence
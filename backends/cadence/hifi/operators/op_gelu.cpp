@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <cmath>
+
+using executorch::aten::ScalarType;
+using executorch::aten::string_view;
+using executorch::aten::Tensor;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::resize_tensor;
+using executorch::runtime::tensors_have_same_dim_order;
+using torch::executor::Error;
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// Portable fallback for erf gelu and non-float dtypes.
+Tensor& gelu_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    string_view approximate,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace cadence {
+namespace impl {
+namespace HiFi {
+namespace native {
+
+namespace {
+
+// Number of elements processed per nnlib call, small enough for the
+// intermediate buffer to live on the stack.
+constexpr int kGeluBlockSize = 256;
+
+} // namespace
+
+Tensor& gelu_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    string_view approximate,
+    Tensor& out) {
+  bool optimized = true;
+
+  if ((in.scalar_type() != ScalarType::Float) ||
+      (out.scalar_type() != ScalarType::Float))
+    optimized = false;
+
+  // nnlib has no vector erf, so only the tanh approximation is accelerated.
+  if (approximate != "tanh")
+    optimized = false;
+
+  if (!optimized) {
+    return torch::executor::native::gelu_out(ctx, in, approximate, out);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      torch::executor::check_gelu_args(in, approximate, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  // gelu(x) = 0.5 * x * (1 + tanh(beta * (x + kappa * x^3))), with the tanh of
+  // each block computed by nnlib.
+  constexpr float kBeta = M_SQRT2 * M_2_SQRTPI * 0.5;
+  constexpr float kKappa = 0.044715;
+
+  // in and out may alias, so the tanh goes to its own buffer.
+  const float* in_data = in.const_data_ptr<float>();
+  float* out_data = out.mutable_data_ptr<float>();
+  float inner[kGeluBlockSize];
+  float tanh_inner[kGeluBlockSize];
+
+  const int num_elm = in.numel();
+  for (int start = 0; start < num_elm; start += kGeluBlockSize) {
+    const int size = std::min(kGeluBlockSize, num_elm - start);
+    const float* x = in_data + start;
+    float* y = out_data + start;
+
+    for (int i = 0; i < size; ++i) {
+      inner[i] = kBeta * x[i] * (1.0f + kKappa * x[i] * x[i]);
+    }
+    xa_nn_vec_tanh_f32_f32(tanh_inner, inner, size);
+    // tanh saturates to -1 well before x reaches -inf, where 0.5 * x * 0
+    // would be nan instead of 0.
+    for (int i = 0; i < size; ++i) {
+      const float t = tanh_inner[i];
+      y[i] = t == -1.0f ? 0.0f : 0.5f * x[i] * (1.0f + t);
+    }
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace HiFi
+} // namespace impl
+} // namespace cadence
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::SizesType;
+using executorch::aten::Tensor;
+using executorch::runtime::getLeadingDims;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::kTensorDimensionLimit;
+using executorch::runtime::resize_tensor;
+using executorch::runtime::tensor_is_default_dim_order;
+using executorch::runtime::tensor_is_rank;
+using executorch::runtime::tensors_have_same_dtype;
+using torch::executor::check_linear_args;
+using torch::executor::Error;
+using torch::executor::get_linear_out_target_size;
+
+namespace cadence {
+namespace impl {
+namespace HiFi {
+namespace native {
+
+Tensor& linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_linear_args(in, weight, out), InvalidArgument, out);
+
+  // input comes in shape [leading_dims, in_dim]
+  // weight comes in shape [out_dim, in_dim]
+  // output comes in empty with shape [leading_dims, out_dim]
+  const int leading_dims = getLeadingDims(in, in.dim() - 1);
+  const int out_dim = weight.size(0);
+  const int in_dim = weight.size(1);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      !bias.has_value() ||
+          (tensor_is_rank(bias.value(), 1) &&
+           bias.value().size(0) == out_dim &&
+           tensors_have_same_dtype(in, bias.value())),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  SizesType output_sizes[kTensorDimensionLimit];
+  get_linear_out_target_size(in, weight, output_sizes, &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  if (in.scalar_type() == ScalarType::Float) {
+    // The weight rows are the rows of p_mat1 and the input rows the vectors,
+    // so the nnlib matmul needs no transpose and adds the bias per row.
+    WORD32 ret_val = xa_nn_matmul_f32xf32_f32(
+        out.mutable_data_ptr<float>(), // p_out
+        weight.const_data_ptr<float>(), // p_mat1
+        in.const_data_ptr<float>(), // p_vec1
+        bias.has_value() ? bias.value().const_data_ptr<float>()
+                         : nullptr, // p_bias
+        out_dim, // rows of p_mat1
+        in_dim, // cols of p_mat1
+        in_dim, // row_stride of p_mat1
+        leading_dims, // vec_count, i.e., rows of the input
+        in_dim, // vec_offset of the input
+        out_dim, // out_offset, i.e., offset of next output element written
+        1); // out_stride, i.e., stride to go to next output row
+    ET_KERNEL_CHECK(ctx, ret_val == 0, Internal, out);
+
+    return out;
+  }
+
+  ET_SWITCH_REAL_TYPES_AND2(
+      Half, BFloat16, in.scalar_type(), ctx, "linear.out", CTYPE, [&]() {
+        const CTYPE* __restrict__ in_data = in.const_data_ptr<CTYPE>();
+        const CTYPE* __restrict__ weight_data = weight.const_data_ptr<CTYPE>();
+        const CTYPE* __restrict__ bias_data =
+            bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+        CTYPE* __restrict__ out_data = out.mutable_data_ptr<CTYPE>();
+
+        for (int i = 0; i < leading_dims; ++i) {
+          for (int j = 0; j < out_dim; ++j) {
+            CTYPE sum = bias_data != nullptr ? bias_data[j] : CTYPE(0);
+            for (int k = 0; k < in_dim; ++k) {
+              sum += in_data[i * in_dim + k] * weight_data[j * in_dim + k];
+            }
+            out_data[i * out_dim + j] = sum;
+          }
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace HiFi
+} // namespace impl
+} // namespace cadence
@@ -34,14 +34,19 @@ def define_operator(name: str, deps: list[str] | None = None) -> None:
 OPERATORS = [
     "add",
     "atan2",
+    "bmm",
     "cat",
     "clamp",
+    "convolution",
     "dequantize_per_tensor",
     "div",
     "full",
+    "gelu",
+    "linear",
     "maximum",
     "mean",
     "minimum",
+    "mm",
     "mul",
     "permute_copy",
     "pow",
@@ -60,6 +65,17 @@ OPERATORS = [
     "where"
 ]
 
+# Operators that call into portable code beyond the common utils. Most of them
+# fall back to the portable kernel of the op for the cases that have no nnlib
+# equivalent. That kernel is linked into the same library, and since portable
+# kernels have no header, the op declares it in torch::executor::native itself.
+OPERATOR_DEPS = {
+    "bmm": ["//executorch/kernels/portable/cpu:vec_ops"],
+    "convolution": ["//executorch/kernels/portable/cpu:op_convolution"],
+    "gelu": ["//executorch/kernels/portable/cpu:op_gelu"],
+    "mm": ["//executorch/kernels/portable/cpu:vec_ops"],
+}
+
 def define_common_targets():
     """Defines targets that should be shared between fbcode and xplat.
 
@@ -69,4 +85,4 @@ def define_common_targets():
 
     # Define build targets for all operators registered in the tables above.
     for op in OPERATORS:
-        define_operator(op)
+        define_operator(op, OPERATOR_DEPS.get(op))
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <arm_nnfunctions.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+
+namespace cortex_m {
+namespace native {
+namespace internal {
+
+using executorch::aten::IntArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+
+/**
+ * Splits a positive real multiplier into a Q31 fixed-point multiplier and a
+ * power of two shift, so that real ~= multiplier * 2^(shift - 31). A positive
+ * shift is a left shift, which is the convention of the CMSIS-NN requantize
+ * functions. Same as QuantizeMultiplier() in TFLite, which CMSIS-NN follows.
+ */
+inline void quantize_multiplier(
+    double real,
+    int32_t* multiplier,
+    int32_t* shift) {
+  if (real == 0.0) {
+    *multiplier = 0;
+    *shift = 0;
+    return;
+  }
+  int exponent = 0;
+  const double fraction = std::frexp(real, &exponent);
+  int64_t q = static_cast<int64_t>(std::round(fraction * (1LL << 31)));
+  if (q == (1LL << 31)) {
+    q /= 2;
+    ++exponent;
+  }
+  if (exponent < -31) {
+    q = 0;
+    exponent = 0;
+  }
+  *multiplier = static_cast<int32_t>(q);
+  *shift = exponent;
+}
+
+/// Returns the value of a 2d parameter along dimension d, where a single value
+/// applies to both dimensions.
+inline int64_t param_at(IntArrayRef param, size_t d) {
+  return param.size() == 1 ? param[0] : param[d];
+}
+
+/**
+ * Checks that a 2d parameter holds 1 or 2 values, which are at least
+ * min_value.
+ */
+inline bool check_2d_param(IntArrayRef param, int64_t min_value) {
+  ET_CHECK_OR_RETURN_FALSE(
+      param.size() == 1 || param.size() == 2,
+      "2d parameters must have 1 or 2 values, got %zu",
+      param.size());
+  ET_CHECK_OR_RETURN_FALSE(
+      param_at(param, 0) >= min_value && param_at(param, 1) >= min_value,
+      "2d parameters must be at least %" PRId64,
+      min_value);
+  return true;
+}
+
+inline bool check_int8_range(int64_t quant_min, int64_t quant_max) {
+  ET_CHECK_OR_RETURN_FALSE(
+      -128 <= quant_min && quant_min <= quant_max && quant_max <= 127,
+      "[quant_min, quant_max] = [%" PRId64 ", %" PRId64
+      "] must be within the int8 range",
+      quant_min,
+      quant_max);
+  return true;
+}
+
+/**
+ * CMSIS-NN works on NHWC data, so 4d activations must be in channels last dim
+ * order; to_edge_transform_and_lower() keeps the dim order of the tensors that
+ * are channels last in the exported program.
+ */
+inline bool check_nhwc_int8(const Tensor& t) {
+  ET_LOG_AND_RETURN_IF_FALSE(executorch::runtime::tensor_is_rank(t, 4));
+  ET_CHECK_OR_RETURN_FALSE(
+      t.scalar_type() == ScalarType::Char, "tensor must be int8");
+  ET_CHECK_OR_RETURN_FALSE(
+      executorch::runtime::tensor_is_channels_last_dim_order(t),
+      "tensor must be in channels last dim order");
+  return true;
+}
+
+inline cmsis_nn_dims nhwc_dims(const Tensor& t) {
+  return cmsis_nn_dims{
+      static_cast<int32_t>(t.size(0)),
+      static_cast<int32_t>(t.size(2)),
+      static_cast<int32_t>(t.size(3)),
+      static_cast<int32_t>(t.size(1))};
+}
+
+/**
+ * Checks the per channel weight scales, weight zero points and float bias of
+ * an int8 conv or linear with out_channels output channels. CMSIS-NN only
+ * supports symmetric weights, so the weight zero points must all be zero.
+ */
+inline bool check_per_channel_params(
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    int64_t out_channels) {
+  ET_CHECK_OR_RETURN_FALSE(
+      weight_scales.dim() == 1 &&
+          weight_scales.scalar_type() == ScalarType::Float &&
+          weight_scales.size(0) == out_channels,
+      "weight_scales must be float [%zd]",
+      ssize_t(out_channels));
+  if (weight_zero_points.has_value()) {
+    ET_CHECK_OR_RETURN_FALSE(
+        weight_zero_points->dim() == 1 &&
+            weight_zero_points->scalar_type() == ScalarType::Long &&
+            weight_zero_points->size(0) == out_channels,
+        "weight_zero_points must be int64 [%zd]",
+        ssize_t(out_channels));
+    const int64_t* const zero_points =
+        weight_zero_points->const_data_ptr<int64_t>();
+    for (int64_t c = 0; c < out_channels; ++c) {
+      ET_CHECK_OR_RETURN_FALSE(
+          zero_points[c] == 0, "weight_zero_points must all be zero");
+    }
+  }
+  if (bias.has_value()) {
+    ET_CHECK_OR_RETURN_FALSE(
+        bias->dim() == 1 && bias->scalar_type() == ScalarType::Float &&
+            bias->size(0) == out_channels,
+        "bias must be float [%zd]",
+        ssize_t(out_channels));
+  }
+  return true;
+}
+
+/**
+ * Fills the per channel requantization multipliers and shifts of an int8 conv
+ * or linear, and its bias quantized to int32 with the scale of the
+ * accumulators, input_scale * weight_scales[c], as CMSIS-NN expects.
+ */
+inline void make_per_channel_params(
+    double input_scale,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& bias,
+    double output_scale,
+    int32_t* multipliers,
+    int32_t* shifts,
+    int32_t* bias_data) {
+  const float* const scales = weight_scales.const_data_ptr<float>();
+  const float* const bias_in =
+      bias.has_value() ? bias->const_data_ptr<float>() : nullptr;
+  for (int64_t c = 0; c < weight_scales.size(0); ++c) {
+    const double acc_scale = input_scale * scales[c];
+    quantize_multiplier(
+        acc_scale / output_scale, &multipliers[c], &shifts[c]);
+    bias_data[c] = bias_in == nullptr
+        ? 0
+        : static_cast<int32_t>(std::nearbyint(bias_in[c] / acc_scale));
+  }
+}
+
+/**
+ * Returns the output size of a 2d window of size kernel along a dimension of
+ * size in, rounding down like PyTorch with ceil_mode=False.
+ */
+inline int64_t window_out_size(
+    int64_t in,
+    int64_t kernel,
+    int64_t stride,
+    int64_t padding,
+    int64_t dilation) {
+  return (in + 2 * padding - dilation * (kernel - 1) - 1) / stride + 1;
+}
+
+} // namespace internal
+} // namespace native
+} // namespace cortex_m
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cortex_m/ops/cmsis_utils.h>
+
+#include <algorithm>
+
+namespace cortex_m {
+namespace native {
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+
+namespace {
+
+// The inputs are shifted left by this much before being rescaled, so that
+// rescaling them to the larger of the two scales loses no precision.
+constexpr int32_t kAddLeftShift = 20;
+
+} // namespace
+
+/**
+ * Element wise addition of the int8 tensors a and b, numerically equivalent to
+ * Dq -> fp add -> Q, computed with arm_elementwise_add_s8. The inputs are
+ * rescaled to twice the larger input scale, added, and requantized to the
+ * output scale, like the TFLite reference kernel that CMSIS-NN matches.
+ *
+ * Unlike the portable quantized_decomposed::add, the tensors are int8, and a,
+ * b and out must have the same shape.
+ */
+Tensor& quantized_add_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    int64_t a_quant_min,
+    int64_t a_quant_max,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    int64_t b_quant_min,
+    int64_t b_quant_max,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      a.scalar_type() == ScalarType::Char &&
+          b.scalar_type() == ScalarType::Char &&
+          out.scalar_type() == ScalarType::Char,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensors_have_same_shape_and_dtype(a, b) &&
+          executorch::runtime::tensors_have_same_dim_order(a, b),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_int8_range(a_quant_min, a_quant_max) &&
+          internal::check_int8_range(b_quant_min, b_quant_max) &&
+          internal::check_int8_range(out_quant_min, out_quant_max),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::resize_tensor(out, a.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensors_have_same_dim_order(a, out),
+      InvalidArgument,
+      out);
+
+  const double twice_max_scale = 2.0 * std::max(a_scale, b_scale);
+  int32_t a_multiplier = 0;
+  int32_t a_shift = 0;
+  int32_t b_multiplier = 0;
+  int32_t b_shift = 0;
+  int32_t out_multiplier = 0;
+  int32_t out_shift = 0;
+  internal::quantize_multiplier(
+      a_scale / twice_max_scale, &a_multiplier, &a_shift);
+  internal::quantize_multiplier(
+      b_scale / twice_max_scale, &b_multiplier, &b_shift);
+  internal::quantize_multiplier(
+      twice_max_scale / ((1 << kAddLeftShift) * out_scale),
+      &out_multiplier,
+      &out_shift);
+
+  const arm_cmsis_nn_status status = arm_elementwise_add_s8(
+      a.const_data_ptr<int8_t>(),
+      b.const_data_ptr<int8_t>(),
+      static_cast<int32_t>(-a_zero_point),
+      a_multiplier,
+      a_shift,
+      static_cast<int32_t>(-b_zero_point),
+      b_multiplier,
+      b_shift,
+      kAddLeftShift,
+      out.mutable_data_ptr<int8_t>(),
+      static_cast<int32_t>(out_zero_point),
+      out_multiplier,
+      out_shift,
+      static_cast<int32_t>(out_quant_min),
+      static_cast<int32_t>(out_quant_max),
+      static_cast<int32_t>(out.numel()));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      status == ARM_CMSIS_NN_SUCCESS,
+      Internal,
+      out,
+      "arm_elementwise_add_s8 failed with %d",
+      static_cast<int>(status));
+
+  return out;
+}
+
+} // namespace native
+} // namespace cortex_m
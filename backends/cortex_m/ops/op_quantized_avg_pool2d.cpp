@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cortex_m/ops/cmsis_utils.h>
+
+namespace cortex_m {
+namespace native {
+
+using executorch::aten::IntArrayRef;
+using executorch::aten::SizesType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::Result;
+
+/**
+ * The 2d average pooling of int8 NHWC input, computed with arm_avgpool_s8.
+ * Pooling doesn't change the quantization, so input and out share their scale
+ * and zero point, and the average is clamped to [quant_min, quant_max].
+ *
+ * arm_avgpool_s8 divides by the number of elements of each window that lie
+ * inside the input, so padding is only supported with count_include_pad set
+ * to false.
+ */
+Tensor& quantized_avg_pool2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool count_include_pad,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_nhwc_int8(input) &&
+          internal::check_2d_param(kernel_size, 1) &&
+          internal::check_2d_param(stride, 1) &&
+          internal::check_2d_param(padding, 0) &&
+          internal::check_int8_range(quant_min, quant_max),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !count_include_pad ||
+          (internal::param_at(padding, 0) == 0 &&
+           internal::param_at(padding, 1) == 0),
+      InvalidArgument,
+      out,
+      "Padding is only supported with count_include_pad=False");
+
+  const int64_t out_h = internal::window_out_size(
+      input.size(2),
+      internal::param_at(kernel_size, 0),
+      internal::param_at(stride, 0),
+      internal::param_at(padding, 0),
+      1);
+  const int64_t out_w = internal::window_out_size(
+      input.size(3),
+      internal::param_at(kernel_size, 1),
+      internal::param_at(stride, 1),
+      internal::param_at(padding, 1),
+      1);
+  ET_KERNEL_CHECK(ctx, out_h > 0 && out_w > 0, InvalidArgument, out);
+  const SizesType output_sizes[] = {
+      static_cast<SizesType>(input.size(0)),
+      static_cast<SizesType>(input.size(1)),
+      static_cast<SizesType>(out_h),
+      static_cast<SizesType>(out_w)};
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::resize_tensor(out, {output_sizes, 4}) == Error::Ok,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(ctx, internal::check_nhwc_int8(out), InvalidArgument, out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // Each batch is pooled separately, as arm_avgpool_s8 reads a single image.
+  cmsis_nn_dims input_dims = internal::nhwc_dims(input);
+  cmsis_nn_dims output_dims = internal::nhwc_dims(out);
+  const int32_t batch = input_dims.n;
+  input_dims.n = 1;
+  output_dims.n = 1;
+  const cmsis_nn_dims filter_dims = {
+      1,
+      static_cast<int32_t>(internal::param_at(kernel_size, 0)),
+      static_cast<int32_t>(internal::param_at(kernel_size, 1)),
+      1};
+  cmsis_nn_pool_params pool_params = {};
+  pool_params.stride = {
+      static_cast<int32_t>(internal::param_at(stride, 1)),
+      static_cast<int32_t>(internal::param_at(stride, 0))};
+  pool_params.padding = {
+      static_cast<int32_t>(internal::param_at(padding, 1)),
+      static_cast<int32_t>(internal::param_at(padding, 0))};
+  pool_params.activation = {
+      static_cast<int32_t>(quant_min), static_cast<int32_t>(quant_max)};
+
+  cmsis_nn_context cmsis_ctx = {nullptr, 0};
+  cmsis_ctx.size = arm_avgpool_s8_get_buffer_size(output_dims.w, input_dims.c);
+  if (cmsis_ctx.size > 0) {
+    Result<void*> buffer = ctx.allocate_temp(cmsis_ctx.size, 4);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        buffer.ok(),
+        MemoryAllocationFailed,
+        out,
+        "Failed to allocate %" PRId32 " bytes of temp memory",
+        cmsis_ctx.size);
+    cmsis_ctx.buf = buffer.get();
+  }
+
+  const int64_t in_image = input.numel() / batch;
+  const int64_t out_image = out.numel() / batch;
+  const int8_t* const in_data = input.const_data_ptr<int8_t>();
+  int8_t* const out_data = out.mutable_data_ptr<int8_t>();
+  for (int32_t b = 0; b < batch; ++b) {
+    const arm_cmsis_nn_status status = arm_avgpool_s8(
+        &cmsis_ctx,
+        &pool_params,
+        &input_dims,
+        in_data + b * in_image,
+        &filter_dims,
+        &output_dims,
+        out_data + b * out_image);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        status == ARM_CMSIS_NN_SUCCESS,
+        Internal,
+        out,
+        "arm_avgpool_s8 failed with %d",
+        static_cast<int>(status));
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace cortex_m
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cortex_m/ops/cmsis_utils.h>
+
+namespace cortex_m {
+namespace native {
+
+using executorch::aten::IntArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::SizesType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::Result;
+
+/**
+ * The int8 2d convolution of quantized_decomposed::quantized_conv2d, computed
+ * with arm_convolve_wrapper_s8, or with arm_depthwise_conv_wrapper_s8 when
+ * each group has a single input channel. Both pick the fastest CMSIS-NN kernel
+ * for the shapes, e.g. the 1x1 kernel for pointwise convolutions, and
+ * requantize each output channel with its own scale.
+ *
+ * input and out must be in channels last dim order, which makes them NHWC.
+ * The weight must be too, which makes it OHWI as CMSIS-NN expects, unless its
+ * layout doesn't depend on the dim order. Only groups of 1 and depthwise
+ * convolutions are supported, and the weights must be symmetric.
+ */
+Tensor& quantized_conv2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    double input_scale,
+    int64_t input_zero_point,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    double output_scale,
+    int64_t output_zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_nhwc_int8(input) &&
+          executorch::runtime::tensor_is_rank(weight, 4) &&
+          weight.scalar_type() == ScalarType::Char,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_2d_param(stride, 1) &&
+          internal::check_2d_param(padding, 0) &&
+          internal::check_2d_param(dilation, 1) &&
+          internal::check_int8_range(quant_min, quant_max),
+      InvalidArgument,
+      out);
+
+  const int64_t in_channels = input.size(1);
+  const int64_t out_channels = weight.size(0);
+  const bool depthwise = groups == in_channels && weight.size(1) == 1 &&
+      out_channels % in_channels == 0;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      (groups == 1 && weight.size(1) == in_channels) || depthwise,
+      InvalidArgument,
+      out,
+      "Only groups = 1 and depthwise convolutions are supported, got "
+      "%" PRId64 " groups with %zd input channels",
+      groups,
+      ssize_t(in_channels));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      executorch::runtime::tensor_is_channels_last_dim_order(weight) ||
+          weight.size(1) == 1 || (weight.size(2) == 1 && weight.size(3) == 1),
+      InvalidArgument,
+      out,
+      "weight must be in channels last dim order");
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_per_channel_params(
+          weight_scales, weight_zero_points, bias, out_channels),
+      InvalidArgument,
+      out);
+
+  const int64_t kernel_h = weight.size(2);
+  const int64_t kernel_w = weight.size(3);
+  const int64_t out_h = internal::window_out_size(
+      input.size(2),
+      kernel_h,
+      internal::param_at(stride, 0),
+      internal::param_at(padding, 0),
+      internal::param_at(dilation, 0));
+  const int64_t out_w = internal::window_out_size(
+      input.size(3),
+      kernel_w,
+      internal::param_at(stride, 1),
+      internal::param_at(padding, 1),
+      internal::param_at(dilation, 1));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out_h > 0 && out_w > 0,
+      InvalidArgument,
+      out,
+      "Kernel of size %zd x %zd does not fit the padded input",
+      ssize_t(kernel_h),
+      ssize_t(kernel_w));
+  const SizesType output_sizes[] = {
+      static_cast<SizesType>(input.size(0)),
+      static_cast<SizesType>(out_channels),
+      static_cast<SizesType>(out_h),
+      static_cast<SizesType>(out_w)};
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::resize_tensor(out, {output_sizes, 4}) == Error::Ok,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(ctx, internal::check_nhwc_int8(out), InvalidArgument, out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const cmsis_nn_dims input_dims = internal::nhwc_dims(input);
+  const cmsis_nn_dims output_dims = internal::nhwc_dims(out);
+  const cmsis_nn_dims bias_dims = {1, 1, 1, static_cast<int32_t>(out_channels)};
+  // Depthwise filters are laid out as [1, H, W, out_channels].
+  const cmsis_nn_dims filter_dims = depthwise
+      ? cmsis_nn_dims{1,
+                      static_cast<int32_t>(kernel_h),
+                      static_cast<int32_t>(kernel_w),
+                      static_cast<int32_t>(out_channels)}
+      : cmsis_nn_dims{
+            static_cast<int32_t>(out_channels),
+            static_cast<int32_t>(kernel_h),
+            static_cast<int32_t>(kernel_w),
+            static_cast<int32_t>(in_channels)};
+  const cmsis_nn_tile stride_tile = {
+      static_cast<int32_t>(internal::param_at(stride, 1)),
+      static_cast<int32_t>(internal::param_at(stride, 0))};
+  const cmsis_nn_tile padding_tile = {
+      static_cast<int32_t>(internal::param_at(padding, 1)),
+      static_cast<int32_t>(internal::param_at(padding, 0))};
+  const cmsis_nn_tile dilation_tile = {
+      static_cast<int32_t>(internal::param_at(dilation, 1)),
+      static_cast<int32_t>(internal::param_at(dilation, 0))};
+  const cmsis_nn_activation activation = {
+      static_cast<int32_t>(quant_min), static_cast<int32_t>(quant_max)};
+
+  // The per channel multipliers, shifts and int32 bias, then for depthwise
+  // convolutions the transposed filters.
+  const int64_t filter_size = out_channels * kernel_h * kernel_w;
+  const size_t params_size =
+      3 * out_channels * sizeof(int32_t) + (depthwise ? filter_size : 0);
+  Result<void*> params = ctx.allocate_temp(params_size, alignof(int32_t));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      params.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate %zu bytes of temp memory",
+      params_size);
+  int32_t* const multipliers = static_cast<int32_t*>(params.get());
+  int32_t* const shifts = multipliers + out_channels;
+  int32_t* const bias_data = shifts + out_channels;
+  internal::make_per_channel_params(
+      input_scale,
+      weight_scales,
+      bias,
+      output_scale,
+      multipliers,
+      shifts,
+      bias_data);
+  const cmsis_nn_per_channel_quant_params quant_params = {multipliers, shifts};
+
+  const int8_t* filter_data = weight.const_data_ptr<int8_t>();
+  cmsis_nn_context cmsis_ctx = {nullptr, 0};
+  arm_cmsis_nn_status status = ARM_CMSIS_NN_SUCCESS;
+  if (depthwise) {
+    // [out_channels, 1, H, W] to [1, H, W, out_channels].
+    int8_t* const transposed =
+        reinterpret_cast<int8_t*>(bias_data + out_channels);
+    const int64_t kernel_size = kernel_h * kernel_w;
+    for (int64_t c = 0; c < out_channels; ++c) {
+      for (int64_t i = 0; i < kernel_size; ++i) {
+        transposed[i * out_channels + c] = filter_data[c * kernel_size + i];
+      }
+    }
+    filter_data = transposed;
+
+    cmsis_nn_dw_conv_params dw_conv_params = {};
+    dw_conv_params.input_offset = static_cast<int32_t>(-input_zero_point);
+    dw_conv_params.output_offset = static_cast<int32_t>(output_zero_point);
+    dw_conv_params.ch_mult = static_cast<int32_t>(out_channels / in_channels);
+    dw_conv_params.stride = stride_tile;
+    dw_conv_params.padding = padding_tile;
+    dw_conv_params.dilation = dilation_tile;
+    dw_conv_params.activation = activation;
+
+    cmsis_ctx.size = arm_depthwise_conv_wrapper_s8_get_buffer_size(
+        &dw_conv_params, &input_dims, &filter_dims, &output_dims);
+    if (cmsis_ctx.size > 0) {
+      Result<void*> buffer = ctx.allocate_temp(cmsis_ctx.size, 4);
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          buffer.ok(),
+          MemoryAllocationFailed,
+          out,
+          "Failed to allocate %" PRId32 " bytes of temp memory",
+          cmsis_ctx.size);
+      cmsis_ctx.buf = buffer.get();
+    }
+    status = arm_depthwise_conv_wrapper_s8(
+        &cmsis_ctx,
+        &dw_conv_params,
+        &quant_params,
+        &input_dims,
+        input.const_data_ptr<int8_t>(),
+        &filter_dims,
+        filter_data,
+        &bias_dims,
+        bias_data,
+        &output_dims,
+        out.mutable_data_ptr<int8_t>());
+  } else {
+    cmsis_nn_conv_params conv_params = {};
+    conv_params.input_offset = static_cast<int32_t>(-input_zero_point);
+    conv_params.output_offset = static_cast<int32_t>(output_zero_point);
+    conv_params.stride = stride_tile;
+    conv_params.padding = padding_tile;
+    conv_params.dilation = dilation_tile;
+    conv_params.activation = activation;
+
+    cmsis_ctx.size = arm_convolve_wrapper_s8_get_buffer_size(
+        &conv_params, &input_dims, &filter_dims, &output_dims);
+    if (cmsis_ctx.size > 0) {
+      Result<void*> buffer = ctx.allocate_temp(cmsis_ctx.size, 4);
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          buffer.ok(),
+          MemoryAllocationFailed,
+          out,
+          "Failed to allocate %" PRId32 " bytes of temp memory",
+          cmsis_ctx.size);
+      cmsis_ctx.buf = buffer.get();
+    }
+    status = arm_convolve_wrapper_s8(
+        &cmsis_ctx,
+        &conv_params,
+        &quant_params,
+        &input_dims,
+        input.const_data_ptr<int8_t>(),
+        &filter_dims,
+        filter_data,
+        &bias_dims,
+        bias_data,
+        &output_dims,
+        out.mutable_data_ptr<int8_t>());
+  }
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      status == ARM_CMSIS_NN_SUCCESS,
+      Internal,
+      out,
+      "CMSIS-NN convolution failed with %d",
+      static_cast<int>(status));
+
+  return out;
+}
+
+} // namespace native
+} // namespace cortex_m
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cortex_m/ops/cmsis_utils.h>
+
+namespace cortex_m {
+namespace native {
+
+using executorch::aten::ScalarType;
+using executorch::aten::SizesType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::Result;
+
+/**
+ * The int8 linear of quantized_decomposed::quantized_linear, computed with
+ * CMSIS-NN. The rows of input are treated as the pixels of a 1 x M image with
+ * K channels, convolved with N 1x1 filters, so that arm_convolve_wrapper_s8
+ * picks its 1x1 kernel and requantizes each output channel with its own scale,
+ * which arm_fully_connected_s8 cannot.
+ *
+ * The weights must be symmetric: weight_zero_points, if given, must be zero.
+ */
+Tensor& quantized_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    double input_scale,
+    int64_t input_zero_point,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    double output_scale,
+    int64_t output_zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      input.dim() >= 1 && weight.dim() == 2 &&
+          input.scalar_type() == ScalarType::Char &&
+          weight.scalar_type() == ScalarType::Char &&
+          out.scalar_type() == ScalarType::Char &&
+          weight.size(1) == input.size(input.dim() - 1),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensor_is_default_dim_order(input) &&
+          executorch::runtime::tensor_is_default_dim_order(weight) &&
+          executorch::runtime::tensor_is_default_dim_order(out),
+      InvalidArgument,
+      out);
+  const int64_t n = weight.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_per_channel_params(
+          weight_scales, weight_zero_points, bias, n) &&
+          internal::check_int8_range(quant_min, quant_max),
+      InvalidArgument,
+      out);
+
+  SizesType output_sizes[executorch::runtime::kTensorDimensionLimit];
+  for (size_t d = 0; d < input.dim(); ++d) {
+    output_sizes[d] = input.size(d);
+  }
+  output_sizes[input.dim() - 1] = static_cast<SizesType>(n);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::resize_tensor(
+          out, {output_sizes, static_cast<size_t>(input.dim())}) == Error::Ok,
+      InvalidArgument,
+      out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const int32_t k = static_cast<int32_t>(weight.size(1));
+  const int32_t m = static_cast<int32_t>(out.numel() / n);
+  const cmsis_nn_dims input_dims = {1, 1, m, k};
+  const cmsis_nn_dims filter_dims = {static_cast<int32_t>(n), 1, 1, k};
+  const cmsis_nn_dims bias_dims = {1, 1, 1, static_cast<int32_t>(n)};
+  const cmsis_nn_dims output_dims = {1, 1, m, static_cast<int32_t>(n)};
+  cmsis_nn_conv_params conv_params = {};
+  conv_params.input_offset = static_cast<int32_t>(-input_zero_point);
+  conv_params.output_offset = static_cast<int32_t>(output_zero_point);
+  conv_params.stride = {1, 1};
+  conv_params.padding = {0, 0};
+  conv_params.dilation = {1, 1};
+  conv_params.activation = {
+      static_cast<int32_t>(quant_min), static_cast<int32_t>(quant_max)};
+
+  // The per channel multipliers, shifts and int32 bias.
+  const size_t params_size = 3 * n * sizeof(int32_t);
+  Result<void*> params = ctx.allocate_temp(params_size, alignof(int32_t));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      params.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate %zu bytes of temp memory",
+      params_size);
+  int32_t* const multipliers = static_cast<int32_t*>(params.get());
+  int32_t* const shifts = multipliers + n;
+  int32_t* const bias_data = shifts + n;
+  internal::make_per_channel_params(
+      input_scale,
+      weight_scales,
+      bias,
+      output_scale,
+      multipliers,
+      shifts,
+      bias_data);
+
+  cmsis_nn_context cmsis_ctx = {nullptr, 0};
+  cmsis_ctx.size = arm_convolve_wrapper_s8_get_buffer_size(
+      &conv_params, &input_dims, &filter_dims, &output_dims);
+  if (cmsis_ctx.size > 0) {
+    Result<void*> buffer = ctx.allocate_temp(cmsis_ctx.size, 4);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        buffer.ok(),
+        MemoryAllocationFailed,
+        out,
+        "Failed to allocate %" PRId32 " bytes of temp memory",
+        cmsis_ctx.size);
+    cmsis_ctx.buf = buffer.get();
+  }
+
+  const cmsis_nn_per_channel_quant_params quant_params = {multipliers, shifts};
+  const arm_cmsis_nn_status status = arm_convolve_wrapper_s8(
+      &cmsis_ctx,
+      &conv_params,
+      &quant_params,
+      &input_dims,
+      input.const_data_ptr<int8_t>(),
+      &filter_dims,
+      weight.const_data_ptr<int8_t>(),
+      &bias_dims,
+      bias_data,
+      &output_dims,
+      out.mutable_data_ptr<int8_t>());
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      status == ARM_CMSIS_NN_SUCCESS,
+      Internal,
+      out,
+      "arm_convolve_wrapper_s8 failed with %d",
+      static_cast<int>(status));
+
+  return out;
+}
+
+} // namespace native
+} // namespace cortex_m
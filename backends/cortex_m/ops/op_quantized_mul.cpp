@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cortex_m/ops/cmsis_utils.h>
+
+namespace cortex_m {
+namespace native {
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+
+/**
+ * Element wise multiplication of the int8 tensors a and b, numerically
+ * equivalent to Dq -> fp mul -> Q, computed with arm_elementwise_mul_s8. The
+ * product of the zero point adjusted inputs is requantized with a single
+ * multiplier of a_scale * b_scale / out_scale. a, b and out must have the same
+ * shape.
+ */
+Tensor& quantized_mul_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      a.scalar_type() == ScalarType::Char &&
+          b.scalar_type() == ScalarType::Char &&
+          out.scalar_type() == ScalarType::Char,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensors_have_same_shape_and_dtype(a, b) &&
+          executorch::runtime::tensors_have_same_dim_order(a, b),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      internal::check_int8_range(quant_min, quant_max),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::resize_tensor(out, a.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensors_have_same_dim_order(a, out),
+      InvalidArgument,
+      out);
+
+  int32_t out_multiplier = 0;
+  int32_t out_shift = 0;
+  internal::quantize_multiplier(
+      a_scale * b_scale / out_scale, &out_multiplier, &out_shift);
+
+  const arm_cmsis_nn_status status = arm_elementwise_mul_s8(
+      a.const_data_ptr<int8_t>(),
+      b.const_data_ptr<int8_t>(),
+      static_cast<int32_t>(-a_zero_point),
+      static_cast<int32_t>(-b_zero_point),
+      out.mutable_data_ptr<int8_t>(),
+      static_cast<int32_t>(out_zero_point),
+      out_multiplier,
+      out_shift,
+      static_cast<int32_t>(quant_min),
+      static_cast<int32_t>(quant_max),
+      static_cast<int32_t>(out.numel()));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      status == ARM_CMSIS_NN_SUCCESS,
+      Internal,
+      out,
+      "arm_elementwise_mul_s8 failed with %d",
+      static_cast<int>(status));
+
+  return out;
+}
+
+} // namespace native
+} // namespace cortex_m
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cortex_m/ops/cmsis_utils.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cortex_m {
+namespace native {
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+
+namespace {
+
+// arm_softmax_s8 computes exp() of the differences to the row maximum in
+// fixed point with this many integer bits, like the TFLite reference kernel.
+constexpr int kScaledDiffIntegerBits = 5;
+
+// The fixed output quantization of arm_softmax_s8.
+constexpr double kOutputScale = 1.0 / 256;
+constexpr int64_t kOutputZeroPoint = -128;
+
+} // namespace
+
+/**
+ * The softmax of int8 input along its last dim, numerically equivalent to
+ * Dq -> softmax -> Q, computed with arm_softmax_s8. Its output quantization is
+ * fixed to a scale of 1/256 and a zero point of -128, the usual choice for
+ * values in [0, 1], so output_scale and output_zero_point must match.
+ */
+Tensor& quantized_softmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    double input_scale,
+    int64_t input_zero_point,
+    int64_t dim,
+    double output_scale,
+    int64_t output_zero_point,
+    Tensor& out) {
+  (void)input_zero_point; // Softmax is invariant to shifting its input.
+  ET_KERNEL_CHECK(
+      ctx,
+      input.dim() >= 1 && input.scalar_type() == ScalarType::Char &&
+          out.scalar_type() == ScalarType::Char,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      dim == -1 || dim == input.dim() - 1,
+      InvalidArgument,
+      out,
+      "Only softmax along the last dim is supported, got dim %" PRId64,
+      dim);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      std::abs(output_scale - kOutputScale) < 1e-6 * kOutputScale &&
+          output_zero_point == kOutputZeroPoint,
+      InvalidArgument,
+      out,
+      "Output must be quantized with scale 1/256 and zero point -128");
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensor_is_default_dim_order(input),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  int32_t multiplier = 0;
+  int32_t shift = 0;
+  internal::quantize_multiplier(
+      std::min(
+          input_scale * (1LL << (31 - kScaledDiffIntegerBits)),
+          static_cast<double>((1LL << 31) - 1)),
+      &multiplier,
+      &shift);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      shift >= 0,
+      InvalidArgument,
+      out,
+      "input_scale %f is too small",
+      input_scale);
+  // The most negative difference to the row maximum that still contributes:
+  // anything below underflows exp() in the fixed point format.
+  const int32_t diff_min = -static_cast<int32_t>(std::floor(
+      ((1 << kScaledDiffIntegerBits) - 1) *
+      static_cast<double>(1LL << (31 - kScaledDiffIntegerBits)) /
+      static_cast<double>(1LL << shift)));
+
+  const int64_t row_size = input.size(input.dim() - 1);
+  arm_softmax_s8(
+      input.const_data_ptr<int8_t>(),
+      static_cast<int32_t>(input.numel() / row_size),
+      static_cast<int32_t>(row_size),
+      multiplier,
+      shift,
+      diff_min,
+      out.mutable_data_ptr<int8_t>());
+
+  return out;
+}
+
+} // namespace native
+} // namespace cortex_m
@@ -10,6 +10,7 @@
 #include "NeuronBufferAllocator.h"
 #include "NeuronLog.h"
 #include "NeuronPayloadHeader.h"
+#include "NeuronPlannedMemory.h"
 #include "api/NeuronAdapter.h"
 
 #include "executorch/runtime/core/error.h"
@@ -34,10 +35,32 @@ using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Result;
+using torch::executor::neuron::PlannedMemory;
 
 const char kHighAddrKey[] = "HighAddr";
 const char kImportForeverKey[] = "ImportForever";
 
+namespace {
+
+// Returns the ION/DMA memory that holds data_ptr, and sets offset to the
+// position of data_ptr in it: a planned buffer of the method, or the buffer
+// of the temp allocator that starts at data_ptr.
+const torch::executor::neuron::MemoryUnit* FindMemory(
+    torch::executor::neuron::BufferAllocator* allocator,
+    void* data_ptr,
+    size_t* offset) {
+  auto unit = PlannedMemory::Find(data_ptr, offset);
+  if (unit == nullptr && allocator != nullptr) {
+    unit = allocator->Find(data_ptr);
+    if (unit) {
+      *offset = (char*)data_ptr - (char*)unit->GetAddress();
+    }
+  }
+  return unit;
+}
+
+} // namespace
+
 Result<DelegateHandle*> NeuronBackend::init(
     BackendInitContext& context,
     FreeableBuffer* processed,
@@ -129,10 +152,10 @@ Error NeuronExecuTorchDelegate::execute(
     if (IsCached</*isInput=*/true>(i, data_ptr)) {
       continue;
     };
-    auto unit = allocator != nullptr ? allocator->Find(data_ptr) : nullptr;
+    size_t offset = 0;
+    auto unit = FindMemory(allocator, data_ptr, &offset);
     if (unit) {
       UpdateCache<true>(i, data_ptr);
-      size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
       mExecutor.SetInputOutputFromMemory</*isInput*/ true>(
           i, unit->GetNeuronMemory(), offset, data_size);
     } else {
@@ -147,10 +170,10 @@ Error NeuronExecuTorchDelegate::execute(
     if (IsCached</*isInput=*/false>(output_index, data_ptr)) {
       continue;
     };
-    auto unit = allocator != nullptr ? allocator->Find(data_ptr) : nullptr;
+    size_t offset = 0;
+    auto unit = FindMemory(allocator, data_ptr, &offset);
     if (unit) {
       UpdateCache</*isInput=*/false>(output_index, data_ptr);
-      size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
       mExecutor.SetInputOutputFromMemory</*isInput*/ false>(
           output_index, unit->GetNeuronMemory(), offset, data_size);
     } else {
@@ -172,7 +195,16 @@ int NeuronExecuTorchDelegate::HintNeuronBackend(EValue** args) const {
       if (mHasImported.count(data_ptr)) {
         continue;
       }
-      auto unit = allocator.Find(data_ptr);
+      // A tensor in a planned buffer is imported as its own range of it.
+      size_t offset = 0;
+      auto unit = PlannedMemory::Find(data_ptr, &offset);
+      if (unit) {
+        mExecutor.SetInputOutputFromMemory</*isInput*/ true>(
+            i, unit->GetNeuronMemory(), offset, args[i]->toTensor().nbytes());
+        mHasImported.insert(data_ptr);
+        continue;
+      }
+      unit = allocator.Find(data_ptr);
       if (unit) {
         mExecutor.SetInputOutputFromMemory</*isInput*/ true>(
             i, unit->GetNeuronMemory(), 0, unit->GetSize());
@@ -185,7 +217,18 @@ int NeuronExecuTorchDelegate::HintNeuronBackend(EValue** args) const {
         continue;
       }
       auto output_index = o - inputCount;
-      auto unit = allocator.Find(data_ptr);
+      size_t offset = 0;
+      auto unit = PlannedMemory::Find(data_ptr, &offset);
+      if (unit) {
+        mExecutor.SetInputOutputFromMemory</*isInput*/ false>(
+            output_index,
+            unit->GetNeuronMemory(),
+            offset,
+            args[o]->toTensor().nbytes());
+        mHasImported.insert(data_ptr);
+        continue;
+      }
+      unit = allocator.Find(data_ptr);
       if (unit) {
         mExecutor.SetInputOutputFromMemory</*isInput*/ false>(
             output_index, unit->GetNeuronMemory(), 0, unit->GetSize());
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 MediaTek Inc.
+ *
+ * Licensed under the BSD License (the "License"); you may not use this file
+ * except in compliance with the License. See the license file in the root
+ * directory of this source tree for more details.
+ */
+
+#include "NeuronPlannedMemory.h"
+#include "NeuronLog.h"
+
+#include <map>
+#include <mutex>
+
+namespace torch {
+namespace executor {
+namespace neuron {
+
+using executorch::runtime::HierarchicalAllocator;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Span;
+
+namespace {
+
+// The planned buffers of all live PlannedMemory objects, keyed by their start
+// address. Unlike BufferAllocator::Find, lookups accept any address inside a
+// buffer, which is where the delegate tensors are.
+std::mutex gRegistryMutex;
+std::map<const uint8_t*, const MemoryUnit*> gRegistry;
+
+} // namespace
+
+std::unique_ptr<PlannedMemory> PlannedMemory::Create(
+    const MethodMeta& method_meta) {
+  auto& allocator = GET_NEURON_ALLOCATOR;
+  auto obj = std::unique_ptr<PlannedMemory>(new (std::nothrow) PlannedMemory);
+  if (obj == nullptr) {
+    return nullptr;
+  }
+
+  const size_t num_buffers = method_meta.num_memory_planned_buffers();
+  for (size_t id = 0; id < num_buffers; ++id) {
+    const size_t size =
+        static_cast<size_t>(method_meta.memory_planned_buffer_size(id).get());
+    if (size == 0) {
+      obj->mSpans.push_back({nullptr, 0});
+      continue;
+    }
+    void* address = allocator.Allocate(size);
+    const MemoryUnit* unit =
+        address != nullptr ? allocator.Find(address) : nullptr;
+    if (unit == nullptr) {
+      LogError(
+          "NeuronPlannedMemory",
+          "Failed to allocate planned buffer %zu of size %zu",
+          id,
+          size);
+      return nullptr;
+    }
+    obj->mBuffers.push_back(address);
+    obj->mSpans.push_back({static_cast<uint8_t*>(address), size});
+    {
+      std::lock_guard<std::mutex> lock(gRegistryMutex);
+      gRegistry[static_cast<const uint8_t*>(address)] = unit;
+    }
+    LogInfo(
+        "NeuronPlannedMemory", "Planned buffer %zu, size %zu", id, size);
+  }
+
+  obj->mAllocator = std::make_unique<HierarchicalAllocator>(
+      Span<Span<uint8_t>>{obj->mSpans.data(), obj->mSpans.size()});
+  return obj;
+}
+
+PlannedMemory::~PlannedMemory() {
+  auto& allocator = GET_NEURON_ALLOCATOR;
+  for (void* address : mBuffers) {
+    {
+      std::lock_guard<std::mutex> lock(gRegistryMutex);
+      gRegistry.erase(static_cast<const uint8_t*>(address));
+    }
+    allocator.RemoveBuffer(address);
+  }
+}
+
+const MemoryUnit* PlannedMemory::Find(const void* address, size_t* offset) {
+  const auto* ptr = static_cast<const uint8_t*>(address);
+  std::lock_guard<std::mutex> lock(gRegistryMutex);
+  auto it = gRegistry.upper_bound(ptr);
+  if (it == gRegistry.begin()) {
+    return nullptr;
+  }
+  --it;
+  const MemoryUnit* unit = it->second;
+  if (ptr >= it->first + unit->GetSize()) {
+    return nullptr;
+  }
+  *offset = ptr - it->first;
+  return unit;
+}
+
+} // namespace neuron
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 MediaTek Inc.
+ *
+ * Licensed under the BSD License (the "License"); you may not use this file
+ * except in compliance with the License. See the license file in the root
+ * directory of this source tree for more details.
+ */
+
+#pragma once
+
+#include "NeuronBufferAllocator.h"
+
+#include <executorch/runtime/core/hierarchical_allocator.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/method_meta.h>
+
+#include <memory>
+#include <vector>
+
+// TODO: Move this code to the executorch::backends::neuron namespace.
+// The torch:: namespace is deprecated for ExecuTorch code.
+namespace torch {
+namespace executor {
+namespace neuron {
+
+/**
+ * The memory-planned buffers of a method, allocated from the BufferAllocator.
+ *
+ * The inputs and outputs of the Neuron delegates of a method usually live in
+ * its planned buffers. When those are backed by ION/DMA memory, NeuronBackend
+ * binds each tensor as an offset into the NeuronMemory that holds it, so
+ * nothing is copied between ExecuTorch and Neuron buffers during execution.
+ * The NeuronMemory of a buffer is created once, when it is allocated, and the
+ * delegate only rebinds a tensor when its address changes.
+ *
+ * Usage:
+ *   auto planned_memory = PlannedMemory::Create(*method_meta);
+ *   MemoryManager memory_manager(
+ *       &method_allocator, planned_memory->GetAllocator());
+ */
+class PlannedMemory {
+ public:
+  /**
+   * Allocates all planned buffers of the method. Returns nullptr if any of
+   * them could not be allocated.
+   */
+  static std::unique_ptr<PlannedMemory> Create(
+      const executorch::runtime::MethodMeta& method_meta);
+
+  ~PlannedMemory();
+
+  executorch::runtime::HierarchicalAllocator* GetAllocator() const {
+    return mAllocator.get();
+  }
+
+  /**
+   * Returns the memory of the live planned buffer that contains address, and
+   * sets offset to the position of address in it, or returns nullptr if
+   * address is not in any planned buffer.
+   */
+  static const MemoryUnit* Find(const void* address, size_t* offset);
+
+ private:
+  PlannedMemory() = default;
+
+  PlannedMemory(const PlannedMemory&) = delete;
+
+  PlannedMemory& operator=(const PlannedMemory&) = delete;
+
+ private:
+  std::vector<void*> mBuffers;
+
+  std::vector<executorch::runtime::Span<uint8_t>> mSpans;
+
+  std::unique_ptr<executorch::runtime::HierarchicalAllocator> mAllocator;
+};
+
+} // namespace neuron
+} // namespace executor
+} // namespace torch
@@ -64,6 +64,9 @@ class QnnBackend(BackendDetails):
             edge_program, enable_tensor_dump=enable_tensor_dump
         )
         py_op_wrapper_list = []
+        # QNN names its ops after the nodes, and so does the profiler in the
+        # events it logs to ETDump, which lets the Inspector map them back.
+        debug_handle_map = {}
         for node in pass_result.graph_module.graph.nodes:
             if node.op == "call_function":
                 logger.info(f"Visiting: {node}, {node.target.__name__}")
@@ -72,6 +75,8 @@ class QnnBackend(BackendDetails):
                         node, nodes_to_wrappers
                     )
                     if py_op_wrapper is not None:
+                        if "debug_handle" in node.meta:
+                            debug_handle_map[node.name] = (node.meta["debug_handle"],)
                         if isinstance(py_op_wrapper, List):
                             py_op_wrapper_list.extend(py_op_wrapper)
                         else:
@@ -109,8 +114,7 @@ class QnnBackend(BackendDetails):
         )
         assert len(qnn_context_binary) != 0, "Failed to generate Qnn context binary."
         qnn_manager.Destroy()
-        # For now, debug_handle_map is not used by QNN ExecuTorch
         return PreprocessResult(
             processed_bytes=bytes(qnn_context_binary),
-            debug_handle_map={},
+            debug_handle_map=debug_handle_map,
         )
@@ -69,6 +69,13 @@ void QnnExecuTorchAddCustomMemTensorAddr(void* tensor_addr, void* custom_mem);
 /// time from execution to initialization.
 void QnnExecuTorchAddCustomMemTensorInfo(const CustomMemTensorInfo& info);
 
+/// Register every tensor placed anywhere in the first `bytes` bytes of
+/// `custom_mem`, which must be allocated by QnnExecuTorchAllocCustomMem, as
+/// custom memory within it during execution. This suits buffers holding many
+/// tensors, e.g. memory-planned buffers, whose tensor addresses aren't known
+/// when the buffers are allocated. See SharedMemoryPlannedBuffers.
+void QnnExecuTorchAddCustomMemRegion(void* custom_mem, size_t bytes);
+
 /// Free the allocated shared memory.
 void QnnExecuTorchFreeCustomMem(void* buffer_ptr);
 
@@ -64,50 +64,77 @@ Result<DelegateHandle*> QnnExecuTorchBackend::init(
       QNN_EXECUTORCH_LOG_WARN("unknown argument: %s", compile_spec.key);
   }
 
-  // Create QnnManager
-  MemoryAllocator* runtime_allocator = context.get_runtime_allocator();
-  QnnManager* qnn_manager = runtime_allocator->allocateInstance<QnnManager>();
-  if (qnn_manager == nullptr) {
-    return Error::MemoryAllocationFailed;
-  }
-
-  // NOTE: Since we use placement new and since this type is not trivially
-  // destructible, we must call the destructor manually in destroy().
-  new (qnn_manager) QnnManager(qnn_executorch_options, qnn_context_blob);
-
+  // A context binary with a signature, i.e. one serialized with
+  // QnnContextCustomProtocol, can hold the graphs of several methods, which
+  // may also share their weights. Every delegate of it, in any method of the
+  // program, shares one QnnManager, so the context and its weights are loaded
+  // once. The lock is held until the QnnManager is cached, so that methods
+  // loaded concurrently don't initialize the same context twice.
   // TODO: this is a temporal solution for multi-graph support, will be
   //       removed once framework starts to accept runtime configuration
-  // ---
-  // check if current context binary has already been initialized
-  // return cached one for reducing memory footprint
+  const bool shared_context = status == Error::Ok;
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (shared_context) {
+    lock.lock();
+    auto iter = delegate_map_.find(signature);
+    if (iter != delegate_map_.end()) {
+      QNN_EXECUTORCH_LOG_INFO(
+          "Use cached delegate handle for current method: %s",
+          context.get_method_name());
+      ++delegate_ref_counts_[iter->second];
+      processed->Free();
+      return iter->second;
+    }
+  }
 
-  auto iter = delegate_map_.find(signature);
-  if (iter != delegate_map_.end()) {
-    QNN_EXECUTORCH_LOG_INFO(
-        "Use cached delegate handle for current method: %s",
-        context.get_method_name());
-    return iter->second;
+  // Create QnnManager
+  QnnManager* qnn_manager = nullptr;
+  if (shared_context) {
+    // Shared QnnManagers can outlive the method that creates them, so they
+    // can't live in its runtime allocator.
+    qnn_manager = new QnnManager(qnn_executorch_options, qnn_context_blob);
+  } else {
+    MemoryAllocator* runtime_allocator = context.get_runtime_allocator();
+    qnn_manager = runtime_allocator->allocateInstance<QnnManager>();
+    if (qnn_manager == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+
+    // NOTE: Since we use placement new and since this type is not trivially
+    // destructible, we must call the destructor manually in destroy().
+    new (qnn_manager) QnnManager(qnn_executorch_options, qnn_context_blob);
   }
+  // Releases qnn_manager if initialization fails below
+  auto release_on_error = [&](Error error) {
+    if (shared_context) {
+      delete qnn_manager;
+    } else {
+      qnn_manager->~QnnManager();
+    }
+    return error;
+  };
 
-  ET_CHECK_OR_RETURN_ERROR(
-      qnn_manager->Init() == Error::Ok,
-      Internal,
-      "Fail to initialize Qnn Manager");
+  if (qnn_manager->Init() != Error::Ok) {
+    QNN_EXECUTORCH_LOG_ERROR("Fail to initialize Qnn Manager");
+    return release_on_error(Error::Internal);
+  }
 
   if (qnn_manager->IsOnlinePrepare()) {
-    ET_CHECK_OR_RETURN_ERROR(
-        qnn_manager->CompileQcir() == Error::Ok,
-        Internal,
-        "Fail to compile binary in qcir format");
+    if (qnn_manager->CompileQcir() != Error::Ok) {
+      QNN_EXECUTORCH_LOG_ERROR("Fail to compile binary in qcir format");
+      return release_on_error(Error::Internal);
+    }
   } else {
     for (const std::string& graph_name : qnn_manager->GetGraphNames()) {
-      ET_CHECK_OR_RETURN_ERROR(
-          qnn_manager->AllocateTensor(graph_name) == Error::Ok,
-          Internal,
-          "Fail to allocate tensor");
+      if (qnn_manager->AllocateTensor(graph_name) != Error::Ok) {
+        QNN_EXECUTORCH_LOG_ERROR("Fail to allocate tensor");
+        return release_on_error(Error::Internal);
+      }
     }
   }
-  add_cached_delegate(signature, qnn_manager);
+  if (shared_context) {
+    add_cached_delegate(signature, qnn_manager);
+  }
   // This backend does not need its processed data after Init.
   processed->Free();
   return qnn_manager;
@@ -117,10 +144,6 @@ Error QnnExecuTorchBackend::execute(
     BackendExecutionContext& context,
     DelegateHandle* handle,
     EValue** args) const {
-  ET_CHECK_OR_RETURN_ERROR(
-      delegate_map_rev_.count(handle) != 0,
-      Internal,
-      "DelegateHandle has been deleted");
   QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
 
   std::string method_name = context.get_method_name();
@@ -180,11 +203,23 @@ Error QnnExecuTorchBackend::execute(
 }
 
 void QnnExecuTorchBackend::destroy(DelegateHandle* handle) const {
-  if (handle != nullptr && delegate_map_rev_.count(handle)) {
-    QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
-    qnn_manager->Destroy();
-    erase_cached_delegate(handle);
+  if (handle == nullptr) {
+    return;
+  }
+  QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (delegate_map_rev_.count(handle) == 0) {
+    lock.unlock();
+    qnn_manager->~QnnManager();
+    return;
+  }
+  // Shared QnnManagers are released with the last delegate using them
+  if (--delegate_ref_counts_[handle] > 0) {
+    return;
   }
+  erase_cached_delegate(handle);
+  lock.unlock();
+  delete qnn_manager;
 }
 
 bool QnnExecuTorchBackend::is_available() const {
@@ -194,20 +229,20 @@ bool QnnExecuTorchBackend::is_available() const {
 void QnnExecuTorchBackend::add_cached_delegate(
     const std::int64_t& signature,
     executorch::runtime::DelegateHandle* handle) const {
-  std::lock_guard<std::mutex> guard(mutex_);
   delegate_map_[signature] = handle;
   delegate_map_rev_[handle] = signature;
+  delegate_ref_counts_[handle] = 1;
 }
 
 void QnnExecuTorchBackend::erase_cached_delegate(
     executorch::runtime::DelegateHandle* handle) const {
-  std::lock_guard<std::mutex> guard(mutex_);
   auto iter = delegate_map_rev_.find(handle);
   if (iter == delegate_map_rev_.end()) {
     return;
   }
   delegate_map_.erase(iter->second);
   delegate_map_rev_.erase(handle);
+  delegate_ref_counts_.erase(handle);
 }
 
 namespace {
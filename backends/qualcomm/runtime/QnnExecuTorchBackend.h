@@ -39,16 +39,22 @@ class QnnExecuTorchBackend final
   bool is_available() const override;
 
  private:
+  // The caller must hold mutex_.
   void add_cached_delegate(
       const std::int64_t& signature,
       executorch::runtime::DelegateHandle* handle) const;
   void erase_cached_delegate(executorch::runtime::DelegateHandle* handle) const;
 
+  // Guards the maps below, which track the QnnManagers shared by the
+  // delegates of a context binary, by its signature.
   mutable std::mutex mutex_;
   mutable std::unordered_map<int64_t, executorch::runtime::DelegateHandle*>
       delegate_map_;
   mutable std::unordered_map<executorch::runtime::DelegateHandle*, std::int64_t>
       delegate_map_rev_;
+  // The number of delegates using each shared QnnManager
+  mutable std::unordered_map<executorch::runtime::DelegateHandle*, size_t>
+      delegate_ref_counts_;
 };
 
 } // namespace qnn
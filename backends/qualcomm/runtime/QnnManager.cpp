@@ -389,8 +389,10 @@ Error QnnManager::Execute(
     executorch::runtime::EventTracer* event_tracer) {
   Qnn_ErrorHandle_t error = QNN_SUCCESS;
 
+  backend_params_ptr_->qnn_device_ptr_->OnExecuteBegin();
   error = backend_params_ptr_->qnn_graph_ptr_->GraphExecute(
       graph_name, input_tensor_structs, output_tensor_structs);
+  backend_params_ptr_->qnn_device_ptr_->OnExecuteEnd();
 
   if (error != QNN_SUCCESS) {
     QNN_EXECUTORCH_LOG_ERROR(
@@ -696,3 +698,8 @@ void QnnExecuTorchAddCustomMemTensorInfo(const CustomMemTensorInfo& info) {
   executorch::backends::qnn::SharedBuffer::GetSharedBufferManager()
       .AddCusomMemTensorInfo(info);
 }
+
+void QnnExecuTorchAddCustomMemRegion(void* custom_mem, size_t bytes) {
+  executorch::backends::qnn::SharedBuffer::GetSharedBufferManager()
+      .AddCustomMemRegion(custom_mem, bytes);
+}
@@ -63,10 +63,20 @@ std::mutex SharedBuffer::init_mutex_;
 
 void* SharedBuffer::GetCustomMemBase(void* buf) {
   auto it = tensor_addr_to_custom_mem_.find(buf);
-  if (it == tensor_addr_to_custom_mem_.end()) {
+  if (it != tensor_addr_to_custom_mem_.end()) {
+    return it->second;
+  }
+  // Otherwise find the region the tensor lies in, if any
+  char* addr = static_cast<char*>(buf);
+  auto region = custom_mem_regions_.upper_bound(addr);
+  if (region == custom_mem_regions_.begin()) {
     return nullptr;
   }
-  return it->second;
+  --region;
+  if (addr >= region->first + region->second) {
+    return nullptr;
+  }
+  return region->first;
 }
 
 void* SharedBuffer::GetUnAlignedAddr(void* buf) {
@@ -78,7 +88,10 @@ void* SharedBuffer::GetUnAlignedAddr(void* buf) {
 }
 
 size_t SharedBuffer::GetAllocatedSize(void* buf) {
-  auto it = allocated_size_map_.find(buf);
+  // Sizes are recorded by the address returned from rpcmem_alloc
+  void* unaligned_buf = GetUnAlignedAddr(buf);
+  auto it = allocated_size_map_.find(
+      unaligned_buf != nullptr ? unaligned_buf : buf);
   if (it == allocated_size_map_.end()) {
     return 0;
   }
@@ -152,6 +165,7 @@ void SharedBuffer::FreeMem(void* buf) {
   } else {
     rpc_mem_free_(restore_map_[buf]);
     restore_map_.erase(buf);
+    custom_mem_regions_.erase(static_cast<char*>(buf));
   }
 }
 
@@ -193,6 +207,15 @@ void SharedBuffer::AddCusomMemTensorInfo(const CustomMemTensorInfo& info) {
   tensor_addr_to_custom_mem_.insert({info.tensor_addr, info.custom_mem});
 }
 
+void SharedBuffer::AddCustomMemRegion(void* custom_mem, size_t bytes) {
+  if (!IsAllocated(custom_mem)) {
+    QNN_EXECUTORCH_LOG_WARN(
+        "Custom memory region %p isn't allocated by RPC memory.", custom_mem);
+    return;
+  }
+  custom_mem_regions_[static_cast<char*>(custom_mem)] = bytes;
+}
+
 Error SharedBuffer::UnLoad() {
   if (dlclose(lib_cdsp_rpc_) != 0) {
     QNN_EXECUTORCH_LOG_ERROR(
@@ -11,6 +11,7 @@
 #include <executorch/runtime/core/error.h>
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -62,6 +63,10 @@ class SharedBuffer final {
   // memory handle can be registered before execution
   void AddCusomMemTensorInfo(const CustomMemTensorInfo& info);
 
+  // memory handle is registered during execution for any tensor within the
+  // first bytes of custom_mem, which must be allocated by AllocMem()
+  void AddCustomMemRegion(void* custom_mem, size_t bytes);
+
   size_t GetAllocatedSize(void* buf);
 
   void* GetCustomMemBase(void* buf);
@@ -94,6 +99,8 @@ class SharedBuffer final {
   // Maps for the custom memory
   std::unordered_map<void*, void*> tensor_addr_to_custom_mem_;
   std::unordered_set<CustomMemTensorInfo> custom_mem_tensor_info_set_;
+  // Maps the start of each custom memory region to its size
+  std::map<char*, size_t> custom_mem_regions_;
   std::atomic_bool initialize_{false};
   static std::mutex init_mutex_;
 };
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+#include <cstddef>
+
+namespace executorch {
+namespace backends {
+namespace qnn {
+
+/**
+ * An allocator, in the style of std::allocator, of RPC shared memory.
+ *
+ * Each allocation is added as a custom memory region, so the inputs and
+ * outputs of QNN delegates placed anywhere in it are registered with QNN the
+ * first time they are used, and are read and written by the HTP in place.
+ * The CPU reads and writes the same memory directly, so e.g. a
+ * StaticKVCache<T, SharedBufferAllocator<T>> holds KV caches that a QNN
+ * prefill method and a decode method on another backend share without
+ * copies. The shared_buffer compile spec must be enabled.
+ *
+ * Returns nullptr when the allocation fails, since ExecuTorch is built
+ * without exceptions.
+ */
+template <typename T>
+class SharedBufferAllocator {
+ public:
+  using value_type = T;
+
+  SharedBufferAllocator() = default;
+
+  template <typename U>
+  SharedBufferAllocator(const SharedBufferAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    const size_t bytes = n * sizeof(T);
+    void* buffer = QnnExecuTorchAllocCustomMem(
+        bytes, executorch::runtime::MemoryAllocator::kDefaultAlignment);
+    if (buffer != nullptr) {
+      QnnExecuTorchAddCustomMemRegion(buffer, bytes);
+    }
+    return static_cast<T*>(buffer);
+  }
+
+  void deallocate(T* buffer, size_t /*n*/) {
+    QnnExecuTorchFreeCustomMem(buffer);
+  }
+};
+
+template <typename T, typename U>
+bool operator==(
+    const SharedBufferAllocator<T>&,
+    const SharedBufferAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(
+    const SharedBufferAllocator<T>&,
+    const SharedBufferAllocator<U>&) {
+  return false;
+}
+
+} // namespace qnn
+} // namespace backends
+} // namespace executorch
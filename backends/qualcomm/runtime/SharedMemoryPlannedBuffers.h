@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/hierarchical_allocator.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/method_meta.h>
+
+#include <memory>
+#include <vector>
+
+namespace executorch {
+namespace backends {
+namespace qnn {
+
+/**
+ * Memory-planned buffers of a method allocated on RPC shared memory.
+ *
+ * Load the method with planned_memory() as the planned memory of its
+ * MemoryManager. The inputs and outputs of QNN delegates that memory planning
+ * placed in these buffers are then registered with QNN the first time they are
+ * used, and are read and written by the HTP in place instead of being copied
+ * on every execution. The shared_buffer compile spec must be enabled.
+ */
+class SharedMemoryPlannedBuffers final {
+ public:
+  static executorch::runtime::Result<
+      std::unique_ptr<SharedMemoryPlannedBuffers>>
+  create(const executorch::runtime::MethodMeta& method_meta) {
+    std::unique_ptr<SharedMemoryPlannedBuffers> buffers(
+        new SharedMemoryPlannedBuffers());
+    const size_t num_buffers = method_meta.num_memory_planned_buffers();
+    for (size_t id = 0; id < num_buffers; ++id) {
+      const size_t buffer_size =
+          static_cast<size_t>(method_meta.memory_planned_buffer_size(id).get());
+      void* buffer = QnnExecuTorchAllocCustomMem(
+          buffer_size,
+          executorch::runtime::MemoryAllocator::kDefaultAlignment);
+      ET_CHECK_OR_RETURN_ERROR(
+          buffer != nullptr,
+          MemoryAllocationFailed,
+          "Failed to allocate planned buffer %zu of %zu bytes on shared memory",
+          id,
+          buffer_size);
+      buffers->buffers_.push_back(buffer);
+      QnnExecuTorchAddCustomMemRegion(buffer, buffer_size);
+      buffers->spans_.emplace_back(static_cast<uint8_t*>(buffer), buffer_size);
+    }
+    buffers->planned_memory_ =
+        std::make_unique<executorch::runtime::HierarchicalAllocator>(
+            executorch::runtime::Span<executorch::runtime::Span<uint8_t>>(
+                buffers->spans_.data(), buffers->spans_.size()));
+    return buffers;
+  }
+
+  SharedMemoryPlannedBuffers(const SharedMemoryPlannedBuffers&) = delete;
+  SharedMemoryPlannedBuffers& operator=(const SharedMemoryPlannedBuffers&) =
+      delete;
+  SharedMemoryPlannedBuffers(SharedMemoryPlannedBuffers&&) = delete;
+  SharedMemoryPlannedBuffers& operator=(SharedMemoryPlannedBuffers&&) = delete;
+
+  ~SharedMemoryPlannedBuffers() {
+    for (void* buffer : buffers_) {
+      QnnExecuTorchFreeCustomMem(buffer);
+    }
+  }
+
+  executorch::runtime::HierarchicalAllocator* planned_memory() {
+    return planned_memory_.get();
+  }
+
+ private:
+  SharedMemoryPlannedBuffers() = default;
+
+  std::vector<void*> buffers_;
+  std::vector<executorch::runtime::Span<uint8_t>> spans_;
+  std::unique_ptr<executorch::runtime::HierarchicalAllocator> planned_memory_;
+};
+
+} // namespace qnn
+} // namespace backends
+} // namespace executorch
@@ -31,6 +31,11 @@ class QnnDevice {
 
   executorch::runtime::Error Configure();
 
+  // Called around each graph execution, e.g. to vote for performance only
+  // while graphs run.
+  virtual void OnExecuteBegin(){};
+  virtual void OnExecuteEnd(){};
+
  protected:
   virtual executorch::runtime::Error MakeConfig(
       std::vector<const QnnDevice_Config_t*>& config) {
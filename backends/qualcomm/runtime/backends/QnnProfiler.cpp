@@ -8,6 +8,12 @@
 
 #include <executorch/backends/qualcomm/runtime/backends/QnnProfiler.h>
 
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace executorch {
 namespace backends {
 namespace qnn {
@@ -109,8 +115,11 @@ Qnn_ErrorHandle_t QnnProfile::ProfileData(
             QNN_GET_ERROR_CODE(error));
         return error;
       }
-      QnnProfile_EventData_t sub_event_data;
+      std::vector<QnnProfile_EventData_t> sub_event_datas(num_sub_events);
+      // The bytes that ops moved, for the backends that report them.
+      std::unordered_map<std::string, std::uint64_t> node_bytes;
       for (std::uint32_t j = 0; j < num_sub_events; ++j) {
+        QnnProfile_EventData_t& sub_event_data = sub_event_datas[j];
         error = qnn_interface.qnn_profile_get_event_data(
             sub_events_ptr[j], &sub_event_data);
         if (error != QNN_SUCCESS) {
@@ -123,16 +132,52 @@ Qnn_ErrorHandle_t QnnProfile::ProfileData(
           return error;
         }
         if (sub_event_data.type == QNN_PROFILE_EVENTTYPE_NODE &&
-            (sub_event_data.unit == QNN_PROFILE_EVENTUNIT_MICROSEC ||
-             sub_event_data.unit == QNN_PROFILE_EVENTUNIT_CYCLES)) {
-          executorch::runtime::event_tracer_log_profiling_delegate(
-              event_tracer,
-              sub_event_data.identifier,
-              /*delegate_debug_id=*/
-              static_cast<executorch::runtime::DebugHandle>(-1),
-              0,
-              sub_event_data.value);
+            sub_event_data.unit == QNN_PROFILE_EVENTUNIT_BYTES) {
+          node_bytes[sub_event_data.identifier] += sub_event_data.value;
+        }
+      }
+
+      // The ops are named after the nodes of the delegated graph, which
+      // qnn_preprocess.py maps to their debug handles. QNN only reports how
+      // long each op took, in cycles on HTP, so they are laid out one after
+      // the other from 0, and the unit is in the metadata of each event.
+      std::uint64_t offsets[2] = {0, 0};
+      for (const QnnProfile_EventData_t& sub_event_data : sub_event_datas) {
+        if (sub_event_data.type != QNN_PROFILE_EVENTTYPE_NODE ||
+            (sub_event_data.unit != QNN_PROFILE_EVENTUNIT_MICROSEC &&
+             sub_event_data.unit != QNN_PROFILE_EVENTUNIT_CYCLES)) {
+          continue;
+        }
+        const bool is_cycles =
+            sub_event_data.unit == QNN_PROFILE_EVENTUNIT_CYCLES;
+        std::uint64_t& offset = offsets[is_cycles ? 1 : 0];
+        char metadata[96];
+        int metadata_len = snprintf(
+            metadata,
+            sizeof(metadata),
+            "{\"unit\":\"%s\",\"value\":%" PRIu64,
+            is_cycles ? "cycles" : "us",
+            sub_event_data.value);
+        const auto bytes = node_bytes.find(sub_event_data.identifier);
+        if (bytes != node_bytes.end()) {
+          metadata_len += snprintf(
+              metadata + metadata_len,
+              sizeof(metadata) - metadata_len,
+              ",\"bytes\":%" PRIu64,
+              bytes->second);
         }
+        metadata_len += snprintf(
+            metadata + metadata_len, sizeof(metadata) - metadata_len, "}");
+        executorch::runtime::event_tracer_log_profiling_delegate(
+            event_tracer,
+            sub_event_data.identifier,
+            /*delegate_debug_id=*/
+            static_cast<executorch::runtime::DebugHandle>(-1),
+            offset,
+            offset + sub_event_data.value,
+            metadata,
+            metadata_len);
+        offset += sub_event_data.value;
       }
     }
   }
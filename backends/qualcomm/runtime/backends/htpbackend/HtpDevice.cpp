@@ -282,6 +282,14 @@ std::vector<QnnHtpPerfInfrastructure_PowerConfig_t> SetRpcPollingPowerConfig(
 } // namespace
 
 HtpDevice::~HtpDevice() {
+  if (release_vote_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(vote_mutex_);
+      stop_release_vote_thread_ = true;
+    }
+    vote_cv_.notify_all();
+    release_vote_thread_.join();
+  }
   if (htp_perf_infra_ != nullptr && powerconfig_client_id_ != 0 &&
       !down_vote_power_configs_ptr_.empty()) {
     htp_perf_infra_->setPowerConfig(
@@ -374,6 +382,50 @@ void HtpDevice::ReleasePerformanceVote() {
   }
 };
 
+void HtpDevice::OnExecuteBegin() {
+  if (!IsVoteOnExecute()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(vote_mutex_);
+  ++num_executing_;
+  if (!voted_) {
+    PerformanceVote();
+    voted_ = true;
+  }
+}
+
+void HtpDevice::OnExecuteEnd() {
+  if (!IsVoteOnExecute()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(vote_mutex_);
+    --num_executing_;
+    last_execute_end_ = std::chrono::steady_clock::now();
+  }
+  vote_cv_.notify_all();
+}
+
+void HtpDevice::ReleasePerformanceVoteWhenIdle() {
+  const std::chrono::milliseconds release_after(
+      htp_options_->performance_vote_release_ms());
+  std::unique_lock<std::mutex> lock(vote_mutex_);
+  while (!stop_release_vote_thread_) {
+    if (!voted_ || num_executing_ > 0) {
+      vote_cv_.wait(lock);
+      continue;
+    }
+    // Executions that end in the meantime push the release further out.
+    const auto release_time = last_execute_end_ + release_after;
+    if (std::chrono::steady_clock::now() < release_time) {
+      vote_cv_.wait_until(lock, release_time);
+      continue;
+    }
+    ReleasePerformanceVote();
+    voted_ = false;
+  }
+}
+
 Error HtpDevice::AfterCreateDevice() {
   if (IsPerfModeEnabled()) {
     const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
@@ -411,8 +463,15 @@ Error HtpDevice::AfterCreateDevice() {
     down_vote_power_configs_ptr_ =
         ObtainNullTermPtrVector(down_vote_power_configs_);
 
-    // vote immediately
-    PerformanceVote();
+    if (IsVoteOnExecute()) {
+      // vote on the first execution, and release it when idle
+      release_vote_thread_ =
+          std::thread(&HtpDevice::ReleasePerformanceVoteWhenIdle, this);
+    } else {
+      // vote immediately
+      PerformanceVote();
+      voted_ = true;
+    }
 
     // Set Rpc polling mode
     rpc_power_configs_ =
@@ -10,7 +10,11 @@
 #include <executorch/backends/qualcomm/runtime/backends/QnnDeviceCommon.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDeviceCustomConfig.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDevicePlatformInfoConfig.h>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include "HTP/QnnHtpDevice.h"
 
@@ -37,6 +41,9 @@ class HtpDevice : public QnnDevice {
   }
   ~HtpDevice();
 
+  void OnExecuteBegin() override;
+  void OnExecuteEnd() override;
+
   // Defines Qnn performance mode vote types for htpbackend
   enum PerformanceModeVoteType {
     kNoVote = 0,
@@ -53,12 +60,20 @@ class HtpDevice : public QnnDevice {
  private:
   void PerformanceVote();
   void ReleasePerformanceVote();
+  // Runs on release_vote_thread_, and releases the vote once no graph has run
+  // for performance_vote_release_ms.
+  void ReleasePerformanceVoteWhenIdle();
 
   inline bool IsPerfModeEnabled() {
     return htp_options_->performance_mode() !=
         QnnExecuTorchHtpPerformanceMode::kHtpDefault;
   }
 
+  inline bool IsVoteOnExecute() {
+    return IsPerfModeEnabled() &&
+        htp_options_->performance_vote_release_ms() > 0;
+  }
+
   template <typename T>
   std::vector<std::add_pointer_t<std::add_const_t<T>>> ObtainNullTermPtrVector(
       const std::vector<T>& vec) {
@@ -89,6 +104,15 @@ class HtpDevice : public QnnDevice {
   std::vector<const QnnHtpPerfInfrastructure_PowerConfig_t*>
       down_vote_power_configs_ptr_;
 
+  // Guards everything below but the thread.
+  std::mutex vote_mutex_;
+  std::condition_variable vote_cv_;
+  bool voted_{false};
+  int num_executing_{0};
+  std::chrono::steady_clock::time_point last_execute_end_;
+  bool stop_release_vote_thread_{false};
+  std::thread release_vote_thread_;
+
   const SocInfo* qcom_target_soc_info_;
   const QnnExecuTorchHtpBackendOptions* htp_options_;
 };
@@ -118,6 +118,7 @@ class QnnExecuTorchHtpBackendOptions:
     use_fold_relu: bool = True
     use_multi_contexts: bool = False
     use_weight_sharing: bool = False
+    performance_vote_release_ms: int = 0
 
 
 @unique
@@ -4,6 +4,7 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 import inspect
+import json
 import operator
 import re
 import time
@@ -930,6 +931,21 @@ def draw_graph(title, path, graph_module: torch.fx.GraphModule):
         f.write(graph.get_dot_graph().create_svg())
 
 
+def parse_qnn_delegate_metadata(delegate_metadatas: List[str]) -> Dict[str, Any]:
+    """
+    Parses the metadata that the QNN profiler attaches to the per-op events in
+    ETDump, to be passed as delegate_metadata_parser to the Inspector. It holds
+    the "unit" of the op duration, "cycles" on HTP or "us", its "value", and
+    the "bytes" that the op moved when the backend reports them.
+    """
+    if len(delegate_metadatas) == 0:
+        return {}
+    try:
+        return json.loads(delegate_metadatas[0])
+    except ValueError:
+        return {}
+
+
 def generate_multi_graph_program(
     compiler_specs: List[CompileSpec],
     processed_bytes: List[bytes],
@@ -1143,6 +1159,7 @@ def generate_htp_compiler_spec(
     use_fp16: bool,
     use_dlbc: bool = False,
     use_multi_contexts: bool = False,
+    performance_vote_release_ms: int = 0,
 ) -> QnnExecuTorchBackendOptions:
     """
     Helper function generating backend options for QNN HTP
@@ -1156,6 +1173,9 @@ def generate_htp_compiler_spec(
         use_multi_contexts: When multiple contexts are generated inside the same
             pte, it is possible to reserve a single spill-fill allocation that
             could be re-used across all the splits.
+        performance_vote_release_ms: If positive, the performance vote is only
+            held while the model executes, and released after this many
+            milliseconds without execution to save power between bursts.
 
     Returns:
         QnnExecuTorchHtpBackendOptions: backend options for QNN HTP.
@@ -1170,6 +1190,7 @@ def generate_htp_compiler_spec(
     # But we don't have other place to pass this option at execution stage.
     # TODO: enable voting mechanism in runtime and make this as an option
     htp_options.performance_mode = QnnExecuTorchHtpPerformanceMode.kHtpBurst
+    htp_options.performance_vote_release_ms = performance_vote_release_ms
     htp_options.use_multi_contexts = use_multi_contexts
     htp_options.use_dlbc = use_dlbc
     return QnnExecuTorchBackendOptions(
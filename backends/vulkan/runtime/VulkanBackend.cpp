@@ -10,6 +10,7 @@
 #include <executorch/backends/vulkan/serialization/schema_generated.h>
 
 #include <executorch/backends/vulkan/runtime/graph/ComputeGraph.h>
+#include <executorch/backends/vulkan/runtime/graph/StoragePlan.h>
 
 #include <executorch/backends/vulkan/runtime/graph/ops/OperatorRegistry.h>
 
@@ -23,10 +24,12 @@
 #include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/profiler.h>
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib> /* strtol */
 #include <cstring>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -120,6 +123,7 @@ utils::GPUMemoryLayout get_memory_layout(
 
 GraphConfig get_graph_config(ArrayRef<CompileSpec>& compile_specs) {
   GraphConfig config = GraphConfig();
+  bool has_storage_override = false;
 
   for (const CompileSpec& spec : compile_specs) {
     const uint8_t* value_data = (const uint8_t*)spec.value.buffer;
@@ -131,6 +135,7 @@ GraphConfig get_graph_config(ArrayRef<CompileSpec>& compile_specs) {
           static_cast<utils::StorageType>(value_as_int);
 
       config.set_storage_type_override(storage_type);
+      has_storage_override = true;
     }
     if (strcmp(spec.key, "memory_layout_override") == 0) {
       ET_CHECK_MSG(value_size == sizeof(uint32_t), "Unexpected value size!");
@@ -139,8 +144,29 @@ GraphConfig get_graph_config(ArrayRef<CompileSpec>& compile_specs) {
           static_cast<utils::GPUMemoryLayout>(value_as_int);
 
       config.set_memory_layout_override(memory_layout);
+      has_storage_override = true;
+    }
+    if (strcmp(spec.key, "runtime_memory_planning") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_memory_planning = value_data[0] != 0;
+    }
+    if (strcmp(spec.key, "host_memory_import") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_host_memory_import = value_data[0] != 0;
+    }
+    if (strcmp(spec.key, "storage_autotune") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_storage_autotune = value_data[0] != 0;
+    }
+    if (strcmp(spec.key, "async_prepack") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_async_prepack = value_data[0] != 0;
     }
   }
+  // Storage chosen explicitly is not tuned
+  if (has_storage_override) {
+    config.enable_storage_autotune = false;
+  }
 #ifdef ET_EVENT_TRACER_ENABLED
   config.enable_querypool = true;
 #endif // ET_EVENT_TRACER_ENABLED
@@ -346,8 +372,26 @@ class GraphBuilder {
         args.push_back(get_fb_id_valueref(arg_fb_id));
       }
 
+      const size_t first_prepack_node = compute_graph_->prepack_nodes().size();
+      const size_t first_execute_node = compute_graph_->execute_nodes().size();
+
       auto vkFn = VK_GET_OP_FN(op_name);
       vkFn(*compute_graph_, args);
+
+      // Tag the nodes added for the operator with its delegate debug id, so
+      // that the timestamps of their dispatches can be attributed to it.
+      if (compute_graph_->graphconfig().enable_querypool) {
+        for (size_t i = first_prepack_node;
+             i < compute_graph_->prepack_nodes().size();
+             ++i) {
+          compute_graph_->prepack_nodes()[i]->set_node_id(op_call->node_id());
+        }
+        for (size_t i = first_execute_node;
+             i < compute_graph_->execute_nodes().size();
+             ++i) {
+          compute_graph_->execute_nodes()[i]->set_node_id(op_call->node_id());
+        }
+      }
     }
 
     // Parse the outputs, which will be mostly tensors.  For some reason,
@@ -360,15 +404,6 @@ class GraphBuilder {
         compute_graph_->set_output_tensor(ref);
       }
     }
-
-    if (compute_graph_->graphconfig().enable_querypool) {
-      for (uint32_t i = 0; i < compute_graph_->prepack_nodes().size(); ++i) {
-        compute_graph_->prepack_nodes()[i]->set_node_id(i);
-      }
-      for (uint32_t i = 0; i < compute_graph_->execute_nodes().size(); ++i) {
-        compute_graph_->execute_nodes()[i]->set_node_id(i);
-      }
-    }
   }
 };
 
@@ -451,6 +486,43 @@ void maybe_resize_output(
   ET_CHECK_MSG(err == Error::Ok, "Failed to resize output tensor.");
 }
 
+#ifdef ET_EVENT_TRACER_ENABLED
+std::string format_extent(const uint32_t (&extent)[3]) {
+  return std::to_string(extent[0]) + "," + std::to_string(extent[1]) + "," +
+      std::to_string(extent[2]);
+}
+
+/*
+ * Logs the GPU timestamps of each dispatch of the last execution. Dispatches
+ * are logged with the delegate debug id of the operator that added them, or by
+ * shader name if they don't belong to one, with the shader name and work group
+ * sizes as "shader=<name>;global_wg=<x,y,z>;local_wg=<x,y,z>" metadata.
+ */
+void log_shader_timestamps(
+    ComputeGraph* graph,
+    runtime::EventTracer* event_tracer) {
+  vkapi::QueryPool& querypool = graph->context()->querypool();
+  if (!querypool) {
+    return;
+  }
+  querypool.extract_results();
+  for (const auto& r : querypool.get_shader_timestamp_data()) {
+    const std::string metadata = "shader=" + r.kernel_name +
+        ";global_wg=" + format_extent(r.metadata.global_workgroup_size) +
+        ";local_wg=" + format_extent(r.metadata.local_workgroup_size);
+    const bool has_debug_id = r.dispatch_id != vkapi::kUnsetDispatchId;
+    event_tracer_log_profiling_delegate(
+        event_tracer,
+        has_debug_id ? nullptr : r.kernel_name.c_str(),
+        has_debug_id ? r.dispatch_id : static_cast<runtime::DebugHandle>(-1),
+        r.start_time_ns,
+        r.end_time_ns,
+        metadata.c_str(),
+        metadata.size() + 1);
+  }
+}
+#endif // ET_EVENT_TRACER_ENABLED
+
 //
 // VulkanBackend class
 //
@@ -496,16 +568,136 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
 
     builder.build_graph();
 
+    // Create the pipelines of the model while its weights are prepacked.
+    compute_graph->warm_pipelines();
+
     compute_graph->prepare();
 
-    compute_graph->encode_prepack();
-    compute_graph->prepack();
+    if (compute_graph->graphconfig().enable_memory_planning) {
+      const MemoryPlanningStats& stats =
+          compute_graph->memory_planning_stats();
+      ET_LOG(
+          Info,
+          "Vulkan memory planning: %zu tensors take %zu bytes in %zu shared "
+          "objects, down from %zu bytes",
+          stats.num_planned_tensors,
+          stats.planned_nbytes,
+          stats.num_shared_objects,
+          stats.unplanned_nbytes);
+    }
+
+    // init() starts prepacking on a background thread instead, and the
+    // command buffer is recorded once it is done, at the first execution.
+    if (compute_graph->graphconfig().enable_async_prepack) {
+      return Error::Ok;
+    }
+
+    compute_graph->encode_and_prepack();
 
     compute_graph->encode_execute();
 
+    compute_graph->context()->pipeline_cache().save_cache();
+
     return Error::Ok;
   }
 
+  // Returns how long an execution of compute_graph takes, in microseconds.
+  static double time_execution(ComputeGraph* compute_graph) {
+    constexpr int kTimedExecutions = 3;
+    for (const IOValueRef& input : compute_graph->inputs()) {
+      if (compute_graph->val_is_tensor(input.value)) {
+        std::vector<uint8_t> zeros;
+        size_t numel = 0;
+        {
+          StagingPtr staging = compute_graph->get_staging(input.staging);
+          zeros.resize(staging->nbytes());
+          numel = staging->numel();
+        }
+        compute_graph->copy_into_staging(input.staging, zeros.data(), numel);
+      }
+    }
+    // The first execution pays for one-time costs such as lazy allocations
+    compute_graph->execute();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTimedExecutions; ++i) {
+      compute_graph->execute();
+    }
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kTimedExecutions;
+  }
+
+  // Sets the storage overrides of config to the storage plan tuned for the
+  // model on this device, timing the candidates if it was not tuned yet.
+  void tune_storage_plan(const void* buffer_pointer, GraphConfig& config)
+      const {
+    Result<VulkanDelegateHeader> header =
+        VulkanDelegateHeader::parse(buffer_pointer);
+    if (!header.ok()) {
+      // compileModel() reports the error
+      return;
+    }
+    // The graph is identified by its serialization, without its weights.
+    const uint8_t* flatbuffer_data =
+        reinterpret_cast<const uint8_t*>(buffer_pointer) +
+        header->flatbuffer_offset;
+    uint64_t graph_key = 14695981039346656037ull;
+    for (uint32_t i = 0; i < header->flatbuffer_size; ++i) {
+      graph_key = (graph_key ^ flatbuffer_data[i]) * 1099511628211ull;
+    }
+
+    vkapi::Adapter* adapter = vkapi::runtime()->get_adapter_p();
+    StoragePlan plan{};
+    if (!find_storage_plan(adapter, graph_key, &plan)) {
+      double best_time_us = 0;
+      bool found = false;
+      for (const StoragePlan& candidate : storage_plan_candidates()) {
+        GraphConfig candidate_config = config;
+        candidate_config.enable_storage_autotune = false;
+        candidate_config.enable_async_prepack = false;
+        candidate_config.set_storage_type_override(candidate.storage_type);
+        candidate_config.set_memory_layout_override(candidate.memory_layout);
+        double time_us = 0;
+        try {
+          ComputeGraph candidate_graph(candidate_config);
+          if (compileModel(buffer_pointer, &candidate_graph) != Error::Ok) {
+            continue;
+          }
+          time_us = time_execution(&candidate_graph);
+        } catch (const std::exception& e) {
+          // Not all ops support all storage types and memory layouts
+          ET_LOG(
+              Info,
+              "Vulkan storage autotune: storage type %u, memory layout %u "
+              "is not supported: %s",
+              static_cast<uint32_t>(candidate.storage_type),
+              static_cast<uint32_t>(candidate.memory_layout),
+              e.what());
+          continue;
+        }
+        ET_LOG(
+            Info,
+            "Vulkan storage autotune: storage type %u, memory layout %u "
+            "takes %.1f us",
+            static_cast<uint32_t>(candidate.storage_type),
+            static_cast<uint32_t>(candidate.memory_layout),
+            time_us);
+        if (!found || time_us < best_time_us) {
+          plan = candidate;
+          best_time_us = time_us;
+          found = true;
+        }
+      }
+      if (!found) {
+        // Keep the storage of the config, compileModel() reports the error
+        return;
+      }
+      save_storage_plan(adapter, graph_key, plan);
+    }
+    config.set_storage_type_override(plan.storage_type);
+    config.set_memory_layout_override(plan.memory_layout);
+  }
+
   Result<DelegateHandle*> init(
       BackendInitContext& context,
       FreeableBuffer* processed,
@@ -516,13 +708,22 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
       return Error::MemoryAllocationFailed;
     }
 
-    new (compute_graph) ComputeGraph(get_graph_config(compile_specs));
+    GraphConfig config = get_graph_config(compile_specs);
+    if (config.enable_storage_autotune) {
+      tune_storage_plan(processed->data(), config);
+    }
+    new (compute_graph) ComputeGraph(config);
 
     Error err = compileModel(processed->data(), compute_graph);
 
     // This backend does not need its processed data after compiling the
-    // model.
-    processed->Free();
+    // model, or with async prepacking, once the weights it holds are copied
+    // to staging buffers.
+    if (err == Error::Ok && config.enable_async_prepack) {
+      compute_graph->prepack_async([processed]() { processed->Free(); });
+    } else {
+      processed->Free();
+    }
 
     if (err != Error::Ok) {
       return err;
@@ -539,6 +740,12 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
 
     ComputeGraph* compute_graph = static_cast<ComputeGraph*>(handle);
 
+    // With async prepacking, the first execution waits for it to finish
+    if (!compute_graph->execute_encoded()) {
+      compute_graph->encode_execute();
+      compute_graph->context()->pipeline_cache().save_cache();
+    }
+
     const size_t num_inputs = compute_graph->inputs().size();
     bool should_propagate_resize = false;
     for (size_t i = 0; i < num_inputs; i++) {
@@ -548,6 +755,12 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
         bool was_resized =
             maybe_resize_input(compute_graph, i, args[i]->toTensor());
         should_propagate_resize = should_propagate_resize || was_resized;
+        // Inputs in memory the GPU can import are read in place, which makes
+        // the copy below a no-op.
+        compute_graph->import_staging_memory(
+            compute_graph->inputs()[i].staging,
+            args[i]->toTensor().mutable_data_ptr(),
+            args[i]->toTensor().numel());
         compute_graph->copy_into_staging(
             compute_graph->inputs()[i].staging,
             args[i]->toTensor().const_data_ptr(),
@@ -572,6 +785,19 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
     if (should_propagate_resize) {
       compute_graph->propagate_resize();
     }
+
+    // Likewise, outputs are written in place if their memory can be imported.
+    for (size_t i = 0; i < compute_graph->outputs().size(); i++) {
+      const size_t o = i + num_inputs;
+      if (compute_graph->val_is_tensor(compute_graph->outputs()[i].value) &&
+          args[o]->isTensor()) {
+        compute_graph->import_staging_memory(
+            compute_graph->outputs()[i].staging,
+            args[o]->toTensor().mutable_data_ptr(),
+            args[o]->toTensor().numel());
+      }
+    }
+
     compute_graph->execute();
 
     for (size_t i = 0; i < compute_graph->outputs().size(); i++) {
@@ -595,19 +821,8 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
 
 #ifdef ET_EVENT_TRACER_ENABLED
     runtime::EventTracer* event_tracer = context.event_tracer();
-    compute_graph->context()->querypool().extract_results();
-    for (const auto& r :
-         compute_graph->context()->querypool().get_shader_timestamp_data()) {
-      std::string event_name =
-          r.kernel_name + "_" + std::to_string(r.dispatch_id);
-      event_tracer_log_profiling_delegate(
-          event_tracer,
-          event_name.c_str(),
-          /* delegate_debug_id = */ -1,
-          r.start_time_ns,
-          r.end_time_ns,
-          (void*)(&r.metadata),
-          sizeof(r.metadata));
+    if (event_tracer != nullptr) {
+      log_shader_timestamps(compute_graph, event_tracer);
     }
 #endif // ET_EVENT_TRACER_ENABLED
 
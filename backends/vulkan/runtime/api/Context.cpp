@@ -7,6 +7,9 @@
  */
 
 #include <executorch/backends/vulkan/runtime/api/Context.h>
+#include <executorch/backends/vulkan/runtime/api/ShaderRegistry.h>
+
+#include <sstream>
 
 #ifdef VULKAN_DEBUG
 #include <iomanip>
@@ -31,8 +34,15 @@ Context::Context(size_t adapter_i, const ContextConfig& config)
       device_(adapter_p_->device_handle()),
       queue_(adapter_p_->request_queue()),
       // Resource pools
-      command_pool_(device_, queue_.family_index, config_.cmd_pool_config),
-      descriptor_pool_(device_, config_.descriptor_pool_config),
+      command_pool_(
+          device_,
+          queue_.family_index,
+          config_.cmd_pool_config,
+          &adapter_p_->command_pool_recycler()),
+      descriptor_pool_(
+          device_,
+          config_.descriptor_pool_config,
+          &adapter_p_->descriptor_pool_recycler()),
       fences_(device_),
       // Profiling
       querypool_(config_.query_pool_config, nullptr),
@@ -113,7 +123,7 @@ void Context::check_device_capabilities(const vkapi::ShaderInfo& shader) {
   }
 }
 
-vkapi::DescriptorSet Context::get_descriptor_set(
+vkapi::ComputePipelineCache::Key Context::get_pipeline_key(
     const vkapi::ShaderInfo& shader_descriptor,
     const utils::WorkgroupSize& local_workgroup_size,
     const vkapi::SpecVarList& additional_constants,
@@ -121,9 +131,6 @@ vkapi::DescriptorSet Context::get_descriptor_set(
   VkDescriptorSetLayout shader_layout =
       shader_layout_cache().retrieve(shader_descriptor.kernel_layout);
 
-  VkPipelineLayout pipeline_layout =
-      pipeline_layout_cache().retrieve(shader_layout, push_constants_size);
-
   vkapi::SpecVarList spec_constants = {
       SV(local_workgroup_size[0u]),
       SV(local_workgroup_size[1u]),
@@ -131,12 +138,29 @@ vkapi::DescriptorSet Context::get_descriptor_set(
 
   spec_constants.append(additional_constants);
 
-  VkPipeline pipeline = pipeline_cache().retrieve(
-      {pipeline_layout_cache().retrieve(shader_layout, push_constants_size),
-       shader_cache().retrieve(shader_descriptor),
-       spec_constants});
+  return {
+      pipeline_layout_cache().retrieve(shader_layout, push_constants_size),
+      shader_cache().retrieve(shader_descriptor),
+      spec_constants};
+}
+
+vkapi::DescriptorSet Context::get_descriptor_set(
+    const vkapi::ShaderInfo& shader_descriptor,
+    const utils::WorkgroupSize& local_workgroup_size,
+    const vkapi::SpecVarList& additional_constants,
+    const uint32_t push_constants_size) {
+  VkDescriptorSetLayout shader_layout =
+      shader_layout_cache().retrieve(shader_descriptor.kernel_layout);
 
-  cmd_.bind_pipeline(pipeline, pipeline_layout, local_workgroup_size);
+  const vkapi::ComputePipelineCache::Key key = get_pipeline_key(
+      shader_descriptor,
+      local_workgroup_size,
+      additional_constants,
+      push_constants_size);
+
+  VkPipeline pipeline = pipeline_cache().retrieve(key);
+
+  cmd_.bind_pipeline(pipeline, key.pipeline_layout, local_workgroup_size);
 
   return descriptor_pool().get_descriptor_set(
       shader_layout, shader_descriptor.kernel_layout);
@@ -266,6 +290,16 @@ Context* context() {
   return context.get();
 }
 
+void set_pipeline_cache_dir(const std::string& dir) {
+  if (dir.empty()) {
+    vkapi::set_pipeline_cache_prefix("");
+    return;
+  }
+  std::stringstream prefix;
+  prefix << dir << "/etvk_pipelines_" << std::hex << shader_registry().hash();
+  vkapi::set_pipeline_cache_prefix(prefix.str());
+}
+
 #ifdef VULKAN_DEBUG
 
 #ifdef VK_KHR_pipeline_executable_properties
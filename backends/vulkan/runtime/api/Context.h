@@ -10,6 +10,8 @@
 
 // @lint-ignore-every CLANGTIDY facebook-hte-BadMemberName
 
+#include <algorithm>
+
 #include <executorch/backends/vulkan/runtime/utils/MacroUtils.h>
 #include <executorch/backends/vulkan/runtime/utils/VecUtils.h>
 
@@ -173,6 +175,25 @@ class Context final {
     images_to_clear_.emplace_back(std::move(image));
   }
 
+  size_t num_buffers_to_clear() {
+    std::lock_guard<std::mutex> bufferlist_lock(buffer_clearlist_mutex_);
+    return buffers_to_clear_.size();
+  }
+
+  /*
+   * Destroy the first count buffers registered for cleanup, without waiting
+   * for the queue to be idle as flush() does. The caller must know that the
+   * GPU is done with them, e.g. from the fence of the submission that used
+   * them.
+   */
+  void clear_buffers(const size_t count) {
+    std::lock_guard<std::mutex> bufferlist_lock(buffer_clearlist_mutex_);
+    buffers_to_clear_.erase(
+        buffers_to_clear_.begin(),
+        buffers_to_clear_.begin() +
+            std::min(count, buffers_to_clear_.size()));
+  }
+
   // GPU RPC
 
   inline std::unique_lock<std::mutex> dispatch_lock() {
@@ -188,6 +209,16 @@ class Context final {
 
   void check_device_capabilities(const vkapi::ShaderInfo& shader);
 
+  /*
+   * The key of the compute pipeline that get_descriptor_set() binds for the
+   * same arguments, which can be used to create the pipeline ahead of time.
+   */
+  vkapi::ComputePipelineCache::Key get_pipeline_key(
+      const vkapi::ShaderInfo&,
+      const utils::WorkgroupSize&,
+      const vkapi::SpecVarList&,
+      const uint32_t push_constants_size);
+
   vkapi::DescriptorSet get_descriptor_set(
       const vkapi::ShaderInfo&,
       const utils::WorkgroupSize&,
@@ -267,6 +298,12 @@ bool available();
 // a static local variable.
 Context* context();
 
+// Persist compiled compute pipelines to a file in the given directory, and
+// load them from there on init, so that later processes don't compile them
+// again. The file is keyed by the device, its driver and the registered
+// shaders. Must be called before any Vulkan graph is built.
+void set_pipeline_cache_dir(const std::string& dir);
+
 namespace detail {
 
 inline void arg_is_empty(
@@ -56,6 +56,18 @@ const vkapi::ShaderInfo& ShaderRegistry::get_shader_info(
   return it->second;
 }
 
+size_t ShaderRegistry::hash() const {
+  // The listing is unordered, so combine the shaders in an order independent
+  // way.
+  size_t seed = listings_.size();
+  for (const auto& listing : listings_) {
+    seed += utils::hash_combine(
+        std::hash<std::string>()(listing.first),
+        std::hash<uint32_t>()(listing.second.src_code.size));
+  }
+  return seed;
+}
+
 ShaderRegistry& shader_registry() {
   static ShaderRegistry registry;
   return registry;
@@ -68,6 +68,12 @@ class ShaderRegistry final {
    * Given a shader name, return the ShaderInfo which contains the SPIRV binary
    */
   const vkapi::ShaderInfo& get_shader_info(const std::string& shader_name);
+
+  /*
+   * A hash of the registered shaders, which changes when shaders are added,
+   * removed or resized by a rebuild
+   */
+  size_t hash() const;
 };
 
 class ShaderRegisterInit final {
@@ -24,6 +24,8 @@ class StagingBuffer final {
   Context* context_p_;
   vkapi::ScalarType dtype_;
   vkapi::VulkanBuffer vulkan_buffer_;
+  // Host memory imported in place of vulkan_buffer_, if any
+  vkapi::HostImportedBuffer host_buffer_;
 
   void* mapped_data_;
 
@@ -36,6 +38,7 @@ class StagingBuffer final {
         dtype_(dtype),
         vulkan_buffer_(context_p_->adapter_ptr()->vma().create_staging_buffer(
             element_size(dtype_) * numel)),
+        host_buffer_(),
         mapped_data_(nullptr) {}
 
   StagingBuffer(const StagingBuffer&) = delete;
@@ -94,6 +97,26 @@ class StagingBuffer final {
   inline void set_staging_zeros() {
     memset(data(), 0, nbytes());
   }
+
+  /*
+   * Let shaders access the nbytes bytes of host memory at data in place of the
+   * staging buffer, see vkapi::HostImportedBuffer. Returns false, and keeps
+   * using the staging buffer, if the memory can't be imported. Either way,
+   * command buffers that bound the staging buffer need to be encoded again.
+   */
+  inline bool import_host_memory(void* data, const size_t nbytes) {
+    VK_CHECK_COND(nbytes <= this->nbytes());
+    host_buffer_ = context_p_->adapter_ptr()->import_host_memory(data, nbytes);
+    return host_buffer_;
+  }
+
+  inline void release_host_memory() {
+    host_buffer_ = vkapi::HostImportedBuffer();
+  }
+
+  inline const vkapi::HostImportedBuffer& host_buffer() const {
+    return host_buffer_;
+  }
 };
 
 } // namespace api
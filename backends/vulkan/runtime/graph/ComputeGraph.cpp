@@ -15,6 +15,9 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/utils/StagingUtils.h>
 
+#include <algorithm>
+#include <map>
+
 namespace vkcompute {
 
 //
@@ -148,6 +151,14 @@ ComputeGraph::ComputeGraph(GraphConfig config)
 }
 
 ComputeGraph::~ComputeGraph() {
+  if (pipeline_warmer_.joinable()) {
+    pipeline_warmer_.join();
+  }
+  if (prepacker_.joinable()) {
+    prepacker_.join();
+  }
+  wait_for_execute();
+
   values_.clear();
 
   prepack_nodes_.clear();
@@ -241,7 +252,8 @@ ValueRef ComputeGraph::add_tensor(
     const utils::GPUMemoryLayout memory_layout,
     const int64_t shared_object_idx,
     const utils::AxisMapLayout axis_map_layout) {
-  bool allocate_memory = shared_object_idx < 0;
+  const bool planned = config_.enable_memory_planning && !memory_planned_;
+  bool allocate_memory = shared_object_idx < 0 && !planned;
 
   ValueRef idx(static_cast<int>(values_.size()));
   check_no_active_value_ptrs();
@@ -254,7 +266,9 @@ ValueRef ComputeGraph::add_tensor(
       allocate_memory,
       axis_map_layout));
 
-  if (!allocate_memory) {
+  if (planned) {
+    planned_roots_.emplace(idx, idx);
+  } else if (!allocate_memory) {
     get_shared_object(shared_object_idx).add_user(this, idx);
   }
   return idx;
@@ -346,6 +360,10 @@ ValueRef ComputeGraph::add_tensor_view(const ValueRef vref) {
       sobj.add_user(this, idx);
     }
   }
+  const auto root = planned_roots_.find(vref);
+  if (root != planned_roots_.end()) {
+    planned_roots_.emplace(idx, root->second);
+  }
   return idx;
 }
 
@@ -362,6 +380,10 @@ ValueRef ComputeGraph::add_tensor_view(
       sobj.add_user(this, idx);
     }
   }
+  const auto root = planned_roots_.find(vref);
+  if (root != planned_roots_.end()) {
+    planned_roots_.emplace(idx, root->second);
+  }
   return idx;
 }
 
@@ -569,6 +591,22 @@ void ComputeGraph::copy_into_staging(
     const size_t numel) {
   StagingPtr staging = get_staging(idx);
   size_t nbytes = numel * vkapi::element_size(staging->dtype());
+  if (staging->host_buffer()) {
+    if (staging->host_buffer().data() == data) {
+      // Shaders read the input in place.
+      return;
+    }
+    // The staging buffer stops aliasing the memory of a previous input.
+    wait_for_execute();
+    staging->release_host_memory();
+    staging_rebound_ = true;
+  }
+  if (execute_in_flight()) {
+    // The GPU may still be reading the staging buffer.
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    pending_inputs_[idx].assign(bytes, bytes + nbytes);
+    return;
+  }
   staging->copy_from(data, nbytes);
 }
 
@@ -576,12 +614,190 @@ void ComputeGraph::copy_from_staging(
     const ValueRef idx,
     void* data,
     const size_t numel) {
+  wait_for_execute();
   StagingPtr staging = get_staging(idx);
   size_t nbytes = numel * vkapi::element_size(staging->dtype());
+  const vkapi::HostImportedBuffer& host_buffer = staging->host_buffer();
+  if (host_buffer) {
+    // Shaders wrote the output to the host memory the staging buffer aliases.
+    if (host_buffer.data() != data) {
+      VK_CHECK_COND(nbytes <= host_buffer.nbytes());
+      memcpy(data, host_buffer.data(), nbytes);
+    }
+    return;
+  }
   staging->copy_to(data, nbytes);
 }
 
+bool ComputeGraph::import_staging_memory(
+    const ValueRef idx,
+    void* data,
+    const size_t numel) {
+  if (!config_.enable_host_memory_import ||
+      !context_->adapter_ptr()->supports_host_memory_import()) {
+    return false;
+  }
+  StagingPtr staging = get_staging(idx);
+  size_t nbytes = numel * vkapi::element_size(staging->dtype());
+  if (staging->host_buffer() && staging->host_buffer().data() == data &&
+      staging->host_buffer().nbytes() == nbytes) {
+    // The GPU may still be accessing data, which the caller is about to reuse
+    wait_for_execute();
+    return true;
+  }
+
+  // The command buffer in flight may refer to the current memory.
+  wait_for_execute();
+  const bool had_host_buffer = staging->host_buffer();
+  // Shaders may access the whole staging buffer, e.g. the padding of texture
+  // storage, so only memory of the same size can take its place.
+  bool imported = false;
+  if (nbytes == staging->nbytes()) {
+    imported = staging->import_host_memory(data, nbytes);
+  } else {
+    staging->release_host_memory();
+  }
+  if (imported || had_host_buffer) {
+    staging_rebound_ = true;
+  }
+  return imported;
+}
+
+void ComputeGraph::plan_memory() {
+  if (memory_planned_ || planned_roots_.empty()) {
+    return;
+  }
+  // Tensors added from now on get memory of their own
+  memory_planned_ = true;
+
+  struct Lifetime {
+    // The first and last execute nodes that access the tensor
+    int64_t first = -1;
+    int64_t last = -1;
+    bool shareable = true;
+    // The tensor and its views
+    std::vector<ValueRef> users;
+    VkMemoryRequirements mem_reqs{};
+  };
+  std::map<ValueRef, Lifetime> lifetimes;
+  for (const auto& planned : planned_roots_) {
+    lifetimes[planned.second].users.push_back(planned.first);
+  }
+  auto lifetime_of = [&](const ValueRef idx) -> Lifetime* {
+    const auto root = planned_roots_.find(idx);
+    return root == planned_roots_.end() ? nullptr : &lifetimes[root->second];
+  };
+
+  for (const IOValueRef& io : inputs_) {
+    if (Lifetime* lifetime = lifetime_of(io.value)) {
+      lifetime->shareable = false;
+    }
+  }
+  for (const IOValueRef& io : outputs_) {
+    if (Lifetime* lifetime = lifetime_of(io.value)) {
+      lifetime->shareable = false;
+    }
+  }
+  for (const std::unique_ptr<PrepackNode>& node : prepack_nodes_) {
+    if (Lifetime* lifetime = lifetime_of(node->packed_)) {
+      lifetime->shareable = false;
+    }
+  }
+
+  for (size_t i = 0; i < execute_nodes_.size(); ++i) {
+    // How the node accesses each planned tensor, over all of its arguments
+    std::map<Lifetime*, vkapi::MemoryAccessFlags> accesses;
+    for (const ArgGroup& arg_group : execute_nodes_[i]->args_) {
+      for (const ValueRef idx : arg_group.refs) {
+        if (Lifetime* lifetime = lifetime_of(idx)) {
+          accesses[lifetime] |= arg_group.access;
+        }
+      }
+    }
+    for (const auto& access : accesses) {
+      Lifetime& lifetime = *access.first;
+      if (lifetime.first < 0) {
+        lifetime.first = i;
+        // Reading a tensor before writing it reads the data left by the last
+        // execution.
+        if (access.second != vkapi::MemoryAccessType::WRITE) {
+          lifetime.shareable = false;
+        }
+      }
+      lifetime.last = i;
+    }
+  }
+
+  MemoryPlanningStats stats;
+  std::vector<Lifetime*> shareable;
+  for (auto& planned : lifetimes) {
+    Lifetime& lifetime = planned.second;
+    lifetime.mem_reqs = get_tensor(planned.first)->get_memory_requirements();
+    stats.unplanned_nbytes += lifetime.mem_reqs.size;
+    ++stats.num_planned_tensors;
+    if (lifetime.first < 0) {
+      lifetime.shareable = false;
+    }
+    if (lifetime.shareable) {
+      shareable.push_back(&lifetime);
+      continue;
+    }
+    unshared_objects_.emplace_back();
+    SharedObject& sobj = unshared_objects_.back();
+    for (const ValueRef idx : lifetime.users) {
+      sobj.add_user(this, idx);
+    }
+    sobj.allocate(this);
+    sobj.bind_users(this);
+    stats.planned_nbytes += sobj.aggregate_memory_requirements.size;
+  }
+
+  std::stable_sort(
+      shareable.begin(), shareable.end(), [](Lifetime* a, Lifetime* b) {
+        return a->mem_reqs.size > b->mem_reqs.size;
+      });
+  // The lifetimes of the tensors assigned to each new shared object
+  std::vector<std::vector<Lifetime*>> assigned;
+  const size_t first_sobj = shared_objects_.size();
+  for (Lifetime* lifetime : shareable) {
+    size_t i = 0;
+    for (; i < assigned.size(); ++i) {
+      const SharedObject& sobj = shared_objects_[first_sobj + i];
+      if ((sobj.aggregate_memory_requirements.memoryTypeBits &
+           lifetime->mem_reqs.memoryTypeBits) == 0) {
+        continue;
+      }
+      const bool overlaps = std::any_of(
+          assigned[i].begin(), assigned[i].end(), [&](Lifetime* other) {
+            return lifetime->first <= other->last &&
+                other->first <= lifetime->last;
+          });
+      if (!overlaps) {
+        break;
+      }
+    }
+    if (i == assigned.size()) {
+      assigned.emplace_back();
+    }
+    assigned[i].push_back(lifetime);
+    SharedObject& sobj = get_shared_object(first_sobj + i);
+    for (const ValueRef idx : lifetime->users) {
+      sobj.add_user(this, idx);
+    }
+  }
+  for (size_t i = 0; i < assigned.size(); ++i) {
+    stats.planned_nbytes +=
+        shared_objects_[first_sobj + i].aggregate_memory_requirements.size;
+  }
+  stats.num_shared_objects = assigned.size();
+
+  memory_planning_stats_ = stats;
+  planned_roots_.clear();
+}
+
 void ComputeGraph::prepare() {
+  plan_memory();
+
 #define MERGE_FIELD(field)                    \
   static_cast<uint32_t>(std::ceil(            \
       std::max(                               \
@@ -624,26 +840,154 @@ void ComputeGraph::prepack() const {
   context_->flush();
 }
 
-void ComputeGraph::encode_execute() {
+void ComputeGraph::encode_and_prepack(
+    const std::function<void()>& on_staged) {
+  // The batch in flight, and how many of the buffers registered for cleanup
+  // it uses, which are the ones registered before it was submitted
+  vkapi::VulkanFence inflight_fence;
+  size_t inflight_buffers = 0;
+
+  size_t batch_nbytes = 0;
+  for (size_t i = 0; i < prepack_nodes_.size(); ++i) {
+    // The staging buffer of a node is registered for cleanup once encoded
+    prepack_nodes_[i]->encode(this);
+    batch_nbytes += prepack_nodes_[i]->staging_nbytes(this);
+
+    const bool last_node = i + 1 == prepack_nodes_.size();
+    if (last_node && on_staged) {
+      on_staged();
+    }
+    if (batch_nbytes < kPrepackBatchNbytes && !last_node) {
+      continue;
+    }
+    batch_nbytes = 0;
+
+    const size_t batch_buffers = context_->num_buffers_to_clear();
+    vkapi::VulkanFence fence = context_->fences().get_fence();
+    context_->submit_cmd_to_gpu(
+        fence.get_submit_handle(), /*final_use = */ true);
+
+    // The batch just submitted runs once the previous one completes, while
+    // the next one is recorded
+    if (inflight_fence.waiting()) {
+      inflight_fence.wait();
+      context_->fences().return_fence(inflight_fence);
+      context_->clear_buffers(inflight_buffers);
+    }
+    inflight_fence = std::move(fence);
+    inflight_buffers = batch_buffers - inflight_buffers;
+  }
+
+  if (inflight_fence.waiting()) {
+    inflight_fence.wait();
+    context_->fences().return_fence(inflight_fence);
+  }
+
   context_->flush();
-  context_->set_cmd(/*reusable = */ true);
+}
 
-  context_->cmd_reset_querypool();
+void ComputeGraph::prepack_async(std::function<void()> on_staged) {
+  wait_for_prepack();
+
+  prepacker_ = std::thread([this, on_staged = std::move(on_staged)]() {
+    try {
+      encode_and_prepack(on_staged);
+    } catch (...) {
+      prepack_error_ = std::current_exception();
+    }
+  });
+}
+
+void ComputeGraph::wait_for_prepack() {
+  if (prepacker_.joinable()) {
+    prepacker_.join();
+  }
+  if (prepack_error_) {
+    std::exception_ptr error = prepack_error_;
+    prepack_error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void ComputeGraph::warm_pipelines() {
+  if (pipeline_warmer_.joinable()) {
+    pipeline_warmer_.join();
+  }
+
+  std::vector<vkapi::ComputePipelineCache::Key> keys;
+  for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
+    node->get_pipeline_keys(this, keys);
+  }
+
+  vkapi::ComputePipelineCache* pipeline_cache = &context_->pipeline_cache();
+  pipeline_warmer_ = std::thread([pipeline_cache, keys = std::move(keys)]() {
+    for (const vkapi::ComputePipelineCache::Key& key : keys) {
+      try {
+        pipeline_cache->retrieve(key);
+      } catch (...) {
+        // encode_execute() reports the error when it retrieves the pipeline
+      }
+    }
+  });
+}
+
+void ComputeGraph::encode_execute() {
+  if (pipeline_warmer_.joinable()) {
+    pipeline_warmer_.join();
+  }
+  wait_for_prepack();
 
   for (SharedObject& shared_object : shared_objects_) {
     shared_object.allocate(this);
     shared_object.bind_users(this);
   }
 
+  encode_execute_nodes();
+}
+
+void ComputeGraph::encode_execute_nodes() {
+  context_->flush();
+  context_->set_cmd(/*reusable = */ true);
+
+  context_->cmd_reset_querypool();
+
   for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
     node->encode(this);
   }
+  execute_encoded_ = true;
 }
 
-void ComputeGraph::execute() const {
-  vkapi::VulkanFence fence = context_->fences().get_fence();
-  context_->submit_cmd_to_gpu(fence.get_submit_handle());
-  fence.wait();
+void ComputeGraph::execute() {
+  execute_async();
+  wait_for_execute();
+}
+
+void ComputeGraph::execute_async() {
+  wait_for_execute();
+
+  for (auto& pending_input : pending_inputs_) {
+    get_staging(pending_input.first)
+        ->copy_from(pending_input.second.data(), pending_input.second.size());
+  }
+  pending_inputs_.clear();
+
+  if (staging_rebound_) {
+    if (execute_encoded_) {
+      encode_execute_nodes();
+      ++num_reencodes_;
+    }
+    staging_rebound_ = false;
+  }
+
+  inflight_fence_ = context_->fences().get_fence();
+  context_->submit_cmd_to_gpu(inflight_fence_.get_submit_handle());
+}
+
+void ComputeGraph::wait_for_execute() {
+  if (execute_in_flight()) {
+    inflight_fence_.wait();
+    context_->fences().return_fence(inflight_fence_);
+  }
 }
 
 void ComputeGraph::resize_input(
@@ -654,9 +998,24 @@ void ComputeGraph::resize_input(
 }
 
 void ComputeGraph::propagate_resize() {
+  // Resizing updates buffers that an execution in flight may be reading.
+  wait_for_execute();
   for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
     node->trigger_resize(this);
   }
+  // The command buffer is reused across sizes, since most shaders read the
+  // sizes from UBOs which are updated in place. Re-record it only if a node
+  // embedded values that changed with the resize.
+  if (!execute_encoded_) {
+    return;
+  }
+  for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
+    if (node->requires_reencode(this)) {
+      encode_execute_nodes();
+      ++num_reencodes_;
+      break;
+    }
+  }
 }
 
 } // namespace vkcompute
@@ -10,8 +10,12 @@
 
 // @lint-ignore-every CLANGTIDY facebook-hte-BadMemberName
 
+#include <exception>
+#include <functional>
 #include <optional>
 #include <stack>
+#include <thread>
+#include <unordered_map>
 
 #include <executorch/backends/vulkan/runtime/api/api.h>
 
@@ -69,6 +73,19 @@ DECL_VALUE_PTR_CLASS(SymIntPtr, SymInt);
 
 #undef DECL_VALUE_PTR_CLASS
 
+/*
+ * The GPU memory taken by the tensors whose memory is assigned by
+ * ComputeGraph::plan_memory().
+ */
+struct MemoryPlanningStats {
+  // With the memory shared between tensors that are never alive together
+  size_t planned_nbytes = 0u;
+  // If each tensor had its own memory
+  size_t unplanned_nbytes = 0u;
+  size_t num_planned_tensors = 0u;
+  size_t num_shared_objects = 0u;
+};
+
 //
 // TmpTensor
 //
@@ -184,6 +201,36 @@ class ComputeGraph final {
   std::vector<IOValueRef> inputs_;
   std::vector<IOValueRef> outputs_;
 
+  // Signaled when the execution submitted by execute_async() completes
+  vkapi::VulkanFence inflight_fence_;
+  // Inputs copied in while an execution is in flight, by staging ValueRef.
+  // They are moved to their staging buffers before the next submission.
+  std::unordered_map<ValueRef, std::vector<uint8_t>> pending_inputs_;
+
+  // Creates the pipelines of the execute nodes, see warm_pipelines()
+  std::thread pipeline_warmer_;
+  // Runs the prepack nodes, see prepack_async(), and holds on to the error
+  // that stopped it for wait_for_prepack() to rethrow
+  std::thread prepacker_;
+  std::exception_ptr prepack_error_;
+
+  // With memory planning, the tensors whose memory is assigned by
+  // plan_memory(), and the views of them, mapped to the tensor they view.
+  // Planned tensors map to themselves.
+  std::unordered_map<ValueRef, ValueRef> planned_roots_;
+  // The memory of planned tensors that can't share it with other tensors
+  std::vector<SharedObject> unshared_objects_;
+  MemoryPlanningStats memory_planning_stats_;
+  bool memory_planned_ = false;
+
+  // Whether encode_execute() recorded the command buffer, and how many times
+  // propagate_resize() had to record it again since.
+  bool execute_encoded_ = false;
+  size_t num_reencodes_ = 0;
+  // Whether a staging buffer started or stopped aliasing host memory since the
+  // command buffer was recorded, see import_staging_memory()
+  bool staging_rebound_ = false;
+
  protected:
   size_t values_in_use_ = 0;
 
@@ -669,6 +716,22 @@ class ComputeGraph final {
 
   void prepare();
 
+  inline const MemoryPlanningStats& memory_planning_stats() const {
+    return memory_planning_stats_;
+  }
+
+ private:
+  /*
+   * With memory planning, assign the memory of the tensors added to the graph
+   * once all the nodes are added. Tensors that are alive in disjoint ranges
+   * of execute nodes share memory, assigned greedily from the largest tensor
+   * down, whatever their storage type. Tensors that keep data between
+   * executions, i.e. graph inputs and outputs, prepacked tensors, and tensors
+   * that are read before they are written, get memory of their own.
+   */
+  void plan_memory();
+
+ public:
   //
   // Dispatch Utilities
   //
@@ -710,9 +773,33 @@ class ComputeGraph final {
   // Input/Output
   //
 
+  /*
+   * Copy input data into a staging buffer. If an execution is in flight, the
+   * data is held on the side and only reaches the staging buffer when the
+   * next execution is submitted, so that the input of the next inference can
+   * be uploaded while the GPU is busy with the current one.
+   */
   void
   copy_into_staging(const ValueRef idx, const void* data, const size_t numel);
+  /*
+   * Copy output data out of a staging buffer, waiting for the execution in
+   * flight, if any, to complete first.
+   */
   void copy_from_staging(const ValueRef idx, void* data, const size_t numel);
+  /*
+   * Let the staging buffer of an input or output alias the host memory of
+   * data, so that shaders read the input from, or write the output to, data
+   * directly. The copies of copy_into_staging() and copy_from_staging() are
+   * then skipped for data. Returns false, and keeps the staging buffer, if
+   * host memory import is disabled in the GraphConfig or not supported, or if
+   * data is not exactly as large as the staging buffer.
+   *
+   * Changing the memory a staging buffer aliases records the command buffer
+   * again at the next execution, so data should stay the same across
+   * executions.
+   */
+  bool
+  import_staging_memory(const ValueRef idx, void* data, const size_t numel);
 
   //
   // Graph Prepacking
@@ -721,20 +808,98 @@ class ComputeGraph final {
   void encode_prepack();
   void prepack() const;
 
+  static constexpr size_t kPrepackBatchNbytes = 16u * 1024u * 1024u;
+
+  /*
+   * Equivalent to encode_prepack() followed by prepack(), but the prepack
+   * nodes are submitted in batches of about kPrepackBatchNbytes of staging
+   * memory, in the order they were added, i.e. layer by layer. Each batch is
+   * recorded while the previous one executes, and its staging buffers are
+   * destroyed as soon as it completes, so that at most two batches of staging
+   * memory are alive at once instead of a copy of all the weights.
+   *
+   * on_staged, if set, is called once the data of all the TensorRefs has been
+   * copied to staging buffers, after which it may be freed.
+   */
+  void encode_and_prepack(const std::function<void()>& on_staged = nullptr);
+
+  /*
+   * Run encode_and_prepack() on a background thread, so that loading the
+   * model doesn't wait for it. The thread owns the context until
+   * wait_for_prepack(), which encode_execute() calls, so the graph can't be
+   * used in between. on_staged is called on the background thread.
+   */
+  void prepack_async(std::function<void()> on_staged = nullptr);
+
+  /*
+   * Wait for prepack_async() to finish, and rethrow the error that stopped it
+   * if any. A no-op if prepacking is not in progress.
+   */
+  void wait_for_prepack();
+
   //
   // Graph Execution
   //
 
+  /*
+   * Start creating the compute pipelines of the execute nodes on a background
+   * thread, so that they are ready, or loaded from the pipeline cache, by the
+   * time encode_execute() needs them. Call once the graph is built, before
+   * prepacking.
+   */
+  void warm_pipelines();
+
   void encode_execute();
-  void execute() const;
+  void execute();
+
+  inline bool execute_encoded() const {
+    return execute_encoded_;
+  }
+
+  /*
+   * Submit the encoded command buffer without waiting for it to complete.
+   * The caller syncs with wait_for_execute(), or implicitly by reading an
+   * output through copy_from_staging(). Outputs must be read before the next
+   * execution is submitted, since it overwrites them.
+   *
+   * If an execution is already in flight, it is waited on first, since the
+   * command buffer can't be pending twice.
+   */
+  void execute_async();
+
+  /*
+   * Wait for the execution submitted by execute_async(), if any.
+   */
+  void wait_for_execute();
+
+  inline bool execute_in_flight() const {
+    return inflight_fence_.waiting();
+  }
 
   //
   // Dynamic Shape support
   //
 
   void resize_input(const int64_t idx, const std::vector<int64_t>& new_sizes);
+
+  /*
+   * Run the resize logic of the execute nodes after inputs were resized. The
+   * encoded command buffer is reused for the new sizes unless a node embeds
+   * values in it that changed, such as sizes passed as push constants, in
+   * which case it is recorded again.
+   */
   void propagate_resize();
 
+  inline size_t num_reencodes() const {
+    return num_reencodes_;
+  }
+
+ private:
+  // Record the command buffer of the execute nodes
+  void encode_execute_nodes();
+
+ public:
+
   //
   // Miscellaneous Utilities
   //
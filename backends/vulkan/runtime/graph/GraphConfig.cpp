@@ -63,6 +63,14 @@ GraphConfig::GraphConfig() {
 
   enable_local_wg_size_override = false;
   local_wg_size_override = {};
+
+  enable_memory_planning = false;
+
+  enable_host_memory_import = false;
+
+  enable_storage_autotune = false;
+
+  enable_async_prepack = false;
 }
 
 void GraphConfig::set_storage_type_override(utils::StorageType storage_type) {
@@ -33,6 +33,27 @@ struct GraphConfig final {
   bool enable_local_wg_size_override;
   utils::uvec3 local_wg_size_override;
 
+  // Assign the memory of tensors from their lifetimes in the graph, instead of
+  // from the shared objects that were serialized with it. See
+  // ComputeGraph::plan_memory().
+  bool enable_memory_planning;
+
+  // Let the staging buffers of inputs and outputs alias the host memory they
+  // are copied from and to, when the device can import it. See
+  // ComputeGraph::import_staging_memory(). The host memory must then stay at
+  // the same address across executions, as memory-planned tensors do.
+  bool enable_host_memory_import;
+
+  // Choose the storage plan of the graph, see StoragePlan, by timing the
+  // candidates on the device the first time the graph is loaded on it. The
+  // choice overrides the storage type and memory layout overrides above.
+  bool enable_storage_autotune;
+
+  // Prepack the weights on a background thread instead of while the model is
+  // loaded, see ComputeGraph::prepack_async(). The first execution waits for
+  // it to finish.
+  bool enable_async_prepack;
+
   // Generate a default graph config with pre-configured settings
   explicit GraphConfig();
 
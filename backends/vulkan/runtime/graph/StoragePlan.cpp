@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/vulkan/runtime/graph/StoragePlan.h>
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace vkcompute {
+
+namespace {
+
+using PlanMap = std::unordered_map<uint64_t, StoragePlan>;
+
+struct DevicePlans final {
+  // Empty if the plans are not persisted
+  std::string path;
+  PlanMap plans;
+};
+
+std::mutex& plans_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::string plans_path(vkapi::Adapter* adapter) {
+  const std::string& pipeline_cache_path =
+      adapter->compute_pipeline_cache().cache_data_path();
+  if (pipeline_cache_path.empty()) {
+    return pipeline_cache_path;
+  }
+  return pipeline_cache_path + ".storage";
+}
+
+// One line per graph: its key in hex, the storage type and the memory layout.
+PlanMap load_plans(const std::string& path) {
+  PlanMap plans;
+  if (path.empty()) {
+    return plans;
+  }
+  // The file doesn't exist until the first graph is tuned
+  std::ifstream file(path);
+  uint64_t graph_key = 0;
+  uint32_t storage_type = 0;
+  uint32_t memory_layout = 0;
+  while (file >> std::hex >> graph_key >> std::dec >> storage_type >>
+         memory_layout) {
+    // Ignore plans that are not candidates, e.g. from a corrupted file
+    for (const StoragePlan& candidate : storage_plan_candidates()) {
+      if (static_cast<uint32_t>(candidate.storage_type) == storage_type &&
+          static_cast<uint32_t>(candidate.memory_layout) == memory_layout) {
+        plans[graph_key] = candidate;
+      }
+    }
+  }
+  return plans;
+}
+
+void write_plans(const std::string& path, const PlanMap& plans) {
+  if (path.empty()) {
+    return;
+  }
+  // Write to a temporary file first, so that another process never loads a
+  // partially written file.
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path);
+    for (const auto& entry : plans) {
+      file << std::hex << entry.first << std::dec << ' '
+           << static_cast<uint32_t>(entry.second.storage_type) << ' '
+           << static_cast<uint32_t>(entry.second.memory_layout) << '\n';
+    }
+    if (!file) {
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+DevicePlans& device_plans(vkapi::Adapter* adapter) {
+  static std::unordered_map<vkapi::Adapter*, DevicePlans> plans_by_device;
+  auto it = plans_by_device.find(adapter);
+  if (it == plans_by_device.end()) {
+    DevicePlans plans;
+    plans.path = plans_path(adapter);
+    plans.plans = load_plans(plans.path);
+    it = plans_by_device.emplace(adapter, std::move(plans)).first;
+  }
+  return it->second;
+}
+
+} // namespace
+
+std::vector<StoragePlan> storage_plan_candidates() {
+  return {
+      {utils::kTexture3D, utils::kWidthPacked},
+      {utils::kTexture3D, utils::kChannelsPacked},
+      {utils::kBuffer, utils::kWidthPacked},
+  };
+}
+
+bool find_storage_plan(
+    vkapi::Adapter* adapter,
+    const uint64_t graph_key,
+    StoragePlan* plan) {
+  std::lock_guard<std::mutex> lock(plans_mutex());
+  const PlanMap& plans = device_plans(adapter).plans;
+  auto it = plans.find(graph_key);
+  if (it == plans.end()) {
+    return false;
+  }
+  *plan = it->second;
+  return true;
+}
+
+void save_storage_plan(
+    vkapi::Adapter* adapter,
+    const uint64_t graph_key,
+    const StoragePlan& plan) {
+  std::lock_guard<std::mutex> lock(plans_mutex());
+  DevicePlans& plans = device_plans(adapter);
+  plans.plans[graph_key] = plan;
+  write_plans(plans.path, plans.plans);
+}
+
+} // namespace vkcompute
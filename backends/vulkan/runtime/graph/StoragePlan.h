@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/backends/vulkan/runtime/api/api.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace vkcompute {
+
+/*
+ * The storage type and memory layout given to the tensors of a graph that
+ * were serialized without one, i.e. those whose ops don't require a specific
+ * storage. Which plan is fastest differs between GPUs, e.g. textures tend to
+ * win on Adreno while buffers can be faster on Mali, so it can be chosen by
+ * timing the graph on the device, see GraphConfig::enable_storage_autotune.
+ */
+struct StoragePlan final {
+  utils::StorageType storage_type;
+  utils::GPUMemoryLayout memory_layout;
+};
+
+/*
+ * The plans timed by storage autotuning, most commonly supported first. A
+ * graph may not build with all of them, since not every op supports every
+ * storage type.
+ */
+std::vector<StoragePlan> storage_plan_candidates();
+
+/*
+ * Look up the plan tuned for the graph identified by graph_key on the device
+ * of adapter. Plans are kept for the lifetime of the process, and in a file
+ * next to the pipeline cache of the device, if it has one, so that a graph is
+ * only tuned once per device model and driver.
+ */
+bool find_storage_plan(
+    vkapi::Adapter* adapter,
+    const uint64_t graph_key,
+    StoragePlan* plan);
+
+/*
+ * Record the plan tuned for the graph identified by graph_key on the device of
+ * adapter, see find_storage_plan().
+ */
+void save_storage_plan(
+    vkapi::Adapter* adapter,
+    const uint64_t graph_key,
+    const StoragePlan& plan);
+
+} // namespace vkcompute
@@ -25,7 +25,12 @@ void SharedObject::add_user(ComputeGraph* const graph, const ValueRef idx) {
       std::max(mem_reqs.size, aggregate_memory_requirements.size);
   aggregate_memory_requirements.alignment =
       std::max(mem_reqs.alignment, aggregate_memory_requirements.alignment);
-  aggregate_memory_requirements.memoryTypeBits |= mem_reqs.memoryTypeBits;
+  // The memory must be of a type that every user supports
+  if (users.empty()) {
+    aggregate_memory_requirements.memoryTypeBits = mem_reqs.memoryTypeBits;
+  } else {
+    aggregate_memory_requirements.memoryTypeBits &= mem_reqs.memoryTypeBits;
+  }
 
   users.emplace_back(idx);
 }
@@ -12,6 +12,8 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/utils/BindingUtils.h>
 
+#include <cstring>
+
 namespace vkcompute {
 
 DispatchNode::DispatchNode(
@@ -46,15 +48,9 @@ void DispatchNode::encode(ComputeGraph* graph) {
 
   std::unique_lock<std::mutex> cmd_lock = context->dispatch_lock();
 
-  std::array<uint8_t, kMaxPushConstantSize> push_constants_data;
-  uint32_t push_constants_offset = 0;
-
-  for (const auto& push_constant : push_constants_) {
-    push_constants_offset += push_constant.write(
-        push_constants_data.data(),
-        push_constants_offset,
-        kMaxPushConstantSize);
-  }
+  const uint32_t push_constants_offset =
+      write_push_constants(encoded_push_constants_);
+  encoded_push_constants_size_ = push_constants_offset;
 
   context->report_shader_dispatch_start(
       shader_.kernel_name,
@@ -76,10 +72,47 @@ void DispatchNode::encode(ComputeGraph* graph) {
       pipeline_barrier,
       shader_,
       global_workgroup_size_,
-      push_constants_data.data(),
+      encoded_push_constants_.data(),
       push_constants_offset);
 
   context->report_shader_dispatch_end();
 }
 
+void DispatchNode::get_pipeline_keys(
+    ComputeGraph* graph,
+    std::vector<vkapi::ComputePipelineCache::Key>& keys) {
+  if (!shader_) {
+    return;
+  }
+  std::array<uint8_t, kMaxPushConstantSize> push_constants_data;
+  const uint32_t push_constants_offset =
+      write_push_constants(push_constants_data);
+
+  keys.push_back(graph->context()->get_pipeline_key(
+      shader_, local_workgroup_size_, spec_vars_, push_constants_offset));
+}
+
+bool DispatchNode::requires_reencode(ComputeGraph* graph) const {
+  (void)graph;
+  if (!shader_ || push_constants_.empty()) {
+    return false;
+  }
+  std::array<uint8_t, kMaxPushConstantSize> push_constants_data;
+  const uint32_t push_constants_size =
+      write_push_constants(push_constants_data);
+  return push_constants_size != encoded_push_constants_size_ ||
+      memcmp(push_constants_data.data(),
+             encoded_push_constants_.data(),
+             push_constants_size) != 0;
+}
+
+uint32_t DispatchNode::write_push_constants(
+    std::array<uint8_t, kMaxPushConstantSize>& data) const {
+  uint32_t offset = 0;
+  for (const auto& push_constant : push_constants_) {
+    offset += push_constant.write(data.data(), offset, kMaxPushConstantSize);
+  }
+  return offset;
+}
+
 } // namespace vkcompute
@@ -15,6 +15,8 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/ExecuteNode.h>
 
+#include <array>
+
 namespace vkcompute {
 
 class ComputeGraph;
@@ -42,6 +44,12 @@ class DispatchNode final : public ExecuteNode {
 
   void encode(ComputeGraph* graph) override;
 
+  void get_pipeline_keys(
+      ComputeGraph* graph,
+      std::vector<vkapi::ComputePipelineCache::Key>& keys) override;
+
+  bool requires_reencode(ComputeGraph* graph) const override;
+
  protected:
   const vkapi::ShaderInfo shader_;
   const utils::uvec3 global_workgroup_size_;
@@ -50,6 +58,13 @@ class DispatchNode final : public ExecuteNode {
   const vkapi::SpecVarList spec_vars_;
   const std::vector<PushConstantDataInfo> push_constants_;
 
+  // The push constants recorded by the last call to encode()
+  std::array<uint8_t, kMaxPushConstantSize> encoded_push_constants_{};
+  uint32_t encoded_push_constants_size_ = 0;
+
+  uint32_t write_push_constants(
+      std::array<uint8_t, kMaxPushConstantSize>& data) const;
+
  public:
   operator bool() const {
     return shader_;
@@ -65,6 +65,28 @@ class ExecuteNode {
     (void)graph;
   }
 
+  /*
+   * Append the keys of the compute pipelines that encode() binds, so that
+   * they can be created ahead of time.
+   */
+  virtual void get_pipeline_keys(
+      ComputeGraph* graph,
+      std::vector<vkapi::ComputePipelineCache::Key>& keys) {
+    (void)graph;
+    (void)keys;
+  }
+
+  /*
+   * Whether the commands recorded by encode() no longer match the current
+   * state of the graph, e.g. because they embed tensor sizes as push constants
+   * and the tensors were resized. Sizes read from UBOs are updated in place,
+   * so they never require re-encoding.
+   */
+  virtual bool requires_reencode(ComputeGraph* graph) const {
+    (void)graph;
+    return false;
+  }
+
   inline void trigger_resize(ComputeGraph* graph) {
     if (resize_fn_ != nullptr) {
       resize_fn_(graph, args_, resize_args_);
@@ -80,7 +102,7 @@ class ExecuteNode {
   }
 
  protected:
-  uint32_t node_id_;
+  uint32_t node_id_ = vkapi::kUnsetDispatchId;
   const ResizeFunction resize_fn_;
   const std::vector<ValueRef> resize_args_;
   const std::vector<ArgGroup> args_;
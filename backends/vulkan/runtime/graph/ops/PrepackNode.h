@@ -42,12 +42,18 @@ class PrepackNode final {
 
   void encode(ComputeGraph* graph);
 
+  /*
+   * The size of the staging buffer that encode() fills with the data to
+   * prepack.
+   */
+  size_t staging_nbytes(ComputeGraph* graph);
+
   inline void set_node_id(uint32_t node_id) {
     node_id_ = node_id;
   }
 
  protected:
-  uint32_t node_id_;
+  uint32_t node_id_ = vkapi::kUnsetDispatchId;
   const vkapi::ShaderInfo shader_;
   vkapi::ShaderInfo noop_shader_;
   const utils::uvec3 global_workgroup_size_;
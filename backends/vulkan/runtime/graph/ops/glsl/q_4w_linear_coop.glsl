@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#include "indexing_utils.h"
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, STORAGE)}
+
+${define_active_storage_type(STORAGE)}
+
+${define_required_extensions([DTYPE, "uint8"])}
+#extension GL_EXT_control_flow_attributes : require
+
+layout(std430) buffer;
+
+${layout_declare_tensor(B, "w", "ret", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "x", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "weights", "uint8", "buffer")}
+${layout_declare_tensor(B, "r", "qparams", DTYPE, STORAGE)}
+${layout_declare_ubo(B, "ivec3", "ret_limits")}
+${layout_declare_ubo(B, "ivec4", "x_sizes")}
+${layout_declare_ubo(B, "ivec4", "weights_strides")}
+${layout_declare_ubo(B, "ivec4", "qparams_strides")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+layout(constant_id = 3) const int group_size = 1;
+// The number of threads that co-operate to compute one output texel. Must be a
+// power of 2 no larger than MAX_NWORKERS, and match the local work group size
+// along x.
+layout(constant_id = 4) const int nworkers = 1;
+
+#define MAX_NWORKERS 64
+
+shared vec4 partial_sums[MAX_NWORKERS];
+
+/*
+ * Same computation and tensor layouts as q_4w_linear, but tuned for inputs
+ * with few rows, e.g. the decode phase of an LLM, where one thread per output
+ * texel can't keep the GPU busy because the whole K dimension is reduced by a
+ * single thread.
+ *
+ * Instead each work group computes one output texel: the nworkers threads of
+ * the group each accumulate a strided slice of the K dimension, and the
+ * partial sums are then added up in shared memory with a tree reduction.
+ */
+void main() {
+  const int worker = int(gl_LocalInvocationID.x);
+  // All threads of a work group share the same output position, so the bounds
+  // check below exits the whole group and the barriers stay in uniform control
+  // flow.
+  const ivec3 ret_pos = ivec3(
+      gl_WorkGroupID.x, gl_GlobalInvocationID.y, gl_GlobalInvocationID.z);
+  if (any(greaterThanEqual(ret_pos, ret_limits))) {
+    return;
+  }
+
+  // Since ret is width packed, need to multiply by 4
+  const int n = ret_pos.x * 4;
+  const int num_k_texels = x_sizes.x / 4;
+
+  vec4 sums = vec4(0.0);
+  for (int k_texel_i = worker; k_texel_i < num_k_texels;
+       k_texel_i += nworkers) {
+    // K is guaranteed to be a multiple of group size
+    const int block_idx = (k_texel_i * 4) / group_size;
+    const VEC4_T x_texel =
+        load_texel(x, ivec3(k_texel_i, ret_pos.y, ret_pos.z));
+
+    [[unroll]] for (int comp = 0; comp < 4; comp++) {
+      const vec4 scale_and_zero =
+          load_texel(qparams, ivec3(0, n + comp, block_idx));
+
+      const int weights_bufi = (n + comp) * weights_strides.y + (k_texel_i * 2);
+      // Need to read 4 unpacked values, which corresponds to 2 packed values
+      const uint8_t weights_val_1 = weights[weights_bufi];
+      const uint8_t weights_val_2 = weights[weights_bufi + 1];
+
+      const u8vec4 weights_texel = u8vec4(
+        (weights_val_1 & 0xF0) >> 4,
+        weights_val_1 & 0x0F,
+        (weights_val_2 & 0xF0) >> 4,
+        weights_val_2 & 0x0F);
+
+      // The unpacked 4-bit values are unsigned, so they are centered around 0
+      // by subtracting 8 before applying the scale and zero point.
+      sums[comp] += dot(
+          x_texel,
+          (vec4(weights_texel) - 8.0) * scale_and_zero.x + scale_and_zero.y);
+    }
+  }
+
+  partial_sums[worker] = sums;
+  memoryBarrierShared();
+  barrier();
+
+  for (int stride = nworkers / 2; stride > 0; stride >>= 1) {
+    if (worker < stride) {
+      partial_sums[worker] += partial_sums[worker + stride];
+    }
+    memoryBarrierShared();
+    barrier();
+  }
+
+  if (worker == 0) {
+    write_texel(ret, ret_pos, partial_sums[0]);
+  }
+}
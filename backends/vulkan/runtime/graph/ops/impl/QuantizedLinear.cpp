@@ -313,6 +313,25 @@ void resize_q_4w_linear_node(
   out->virtual_resize(new_out_sizes);
 }
 
+// Inputs with at most this many rows use q_4w_linear_coop, which has several
+// threads co-operate on each output texel.
+constexpr int kQ4wLinearCoopMaxRows = 2;
+// Must not exceed MAX_NWORKERS in q_4w_linear_coop.glsl.
+constexpr uint32_t kQ4wLinearCoopMaxWorkers = 64;
+
+// The number of threads that co-operate on each output texel of
+// q_4w_linear_coop: a power of 2 that leaves each thread at least 4 texels
+// along K.
+uint32_t q_4w_linear_coop_nworkers(const int K) {
+  const uint32_t num_k_texels = utils::safe_downcast<uint32_t>(K) / 4u;
+  uint32_t nworkers = 1;
+  while (nworkers * 2 <= kQ4wLinearCoopMaxWorkers &&
+         nworkers * 2 * 4 <= num_k_texels) {
+    nworkers *= 2;
+  }
+  return nworkers;
+}
+
 void add_q_4w_linear_node(
     ComputeGraph& graph,
     const ValueRef mat1,
@@ -333,7 +352,9 @@ void add_q_4w_linear_node(
       graph.storage_type_of(out),
       utils::kWidthPacked);
 
-  std::string kernel_name = "q_4w_linear";
+  const bool use_coop = graph.size_at<int>(-2, mat1) <= kQ4wLinearCoopMaxRows;
+
+  std::string kernel_name = use_coop ? "q_4w_linear_coop" : "q_4w_linear";
   add_storage_type_suffix(kernel_name, storage_type);
   add_dtype_suffix(kernel_name, graph.dtype_of(out));
 
@@ -366,6 +387,15 @@ void add_q_4w_linear_node(
 
   utils::uvec3 global_wg_size = graph.logical_limits_of(out_W_packed);
   utils::uvec3 local_wg_size = graph.create_local_wg_size(global_wg_size);
+  vkapi::SpecVarList spec_vars = {SV(group_size_val)};
+  if (use_coop) {
+    // One work group of nworkers threads per output texel
+    const uint32_t nworkers =
+        q_4w_linear_coop_nworkers(graph.size_at<int>(-1, mat1));
+    global_wg_size[0u] *= nworkers;
+    local_wg_size = {nworkers, 1u, 1u};
+    spec_vars.append(SV(nworkers));
+  }
 
   graph.execute_nodes().emplace_back(new DispatchNode(
       graph,
@@ -379,7 +409,7 @@ void add_q_4w_linear_node(
       // Shader params buffers
       ubos,
       // Specialization Constants
-      {SV(group_size_val)},
+      spec_vars,
       // Resizing Logic
       resize_q_4w_linear_node,
       {}));
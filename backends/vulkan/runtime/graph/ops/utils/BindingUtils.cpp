@@ -69,7 +69,16 @@ void bind_staging_to_descriptor_set(
     api::StagingBuffer& staging,
     vkapi::DescriptorSet& descriptor_set,
     const uint32_t idx) {
-  descriptor_set.bind(idx, staging.buffer());
+  const vkapi::HostImportedBuffer& host_buffer = staging.host_buffer();
+  if (host_buffer) {
+    vkapi::BufferBindInfo bind_info;
+    bind_info.handle = host_buffer.handle();
+    bind_info.offset = host_buffer.offset();
+    bind_info.range = host_buffer.nbytes();
+    descriptor_set.bind(idx, bind_info);
+  } else {
+    descriptor_set.bind(idx, staging.buffer());
+  }
 }
 
 } // namespace vkcompute
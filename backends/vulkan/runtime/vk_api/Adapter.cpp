@@ -73,6 +73,9 @@ VkDevice create_logical_device(
 #ifdef VK_ANDROID_external_memory_android_hardware_buffer
       VK_ANDROID_EXTERNAL_MEMORY_ANDROID_HARDWARE_BUFFER_EXTENSION_NAME,
 #endif /* VK_ANDROID_external_memory_android_hardware_buffer */
+#ifdef VK_EXT_external_memory_host
+      VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+#endif /* VK_EXT_external_memory_host */
 #ifdef VK_KHR_16bit_storage
       VK_KHR_16BIT_STORAGE_EXTENSION_NAME,
 #endif /* VK_KHR_16bit_storage */
@@ -158,6 +161,8 @@ Adapter::Adapter(
       shader_cache_(device_.handle),
       pipeline_layout_cache_(device_.handle),
       compute_pipeline_cache_(device_.handle, cache_data_path),
+      descriptor_pool_recycler_(device_.handle),
+      command_pool_recycler_(device_.handle),
       sampler_cache_(device_.handle),
       vma_(instance_, physical_device_.handle, device_.handle),
       linear_tiling_3d_enabled_{true} {
@@ -12,10 +12,13 @@
 
 #include <executorch/backends/vulkan/runtime/vk_api/vk_api.h>
 
+#include <executorch/backends/vulkan/runtime/vk_api/Command.h>
+#include <executorch/backends/vulkan/runtime/vk_api/Descriptor.h>
 #include <executorch/backends/vulkan/runtime/vk_api/Device.h>
 #include <executorch/backends/vulkan/runtime/vk_api/Pipeline.h>
 
 #include <executorch/backends/vulkan/runtime/vk_api/memory/Allocator.h>
+#include <executorch/backends/vulkan/runtime/vk_api/memory/HostImportedBuffer.h>
 
 #include <array>
 
@@ -89,6 +92,9 @@ class Adapter final {
   ShaderCache shader_cache_;
   PipelineLayoutCache pipeline_layout_cache_;
   ComputePipelineCache compute_pipeline_cache_;
+  // Pools shared by the Contexts of the adapter
+  DescriptorPoolRecycler descriptor_pool_recycler_;
+  CommandPoolRecycler command_pool_recycler_;
   // Memory Management
   SamplerCache sampler_cache_;
   Allocator vma_;
@@ -145,6 +151,14 @@ class Adapter final {
     return compute_pipeline_cache_;
   }
 
+  inline DescriptorPoolRecycler& descriptor_pool_recycler() {
+    return descriptor_pool_recycler_;
+  }
+
+  inline CommandPoolRecycler& command_pool_recycler() {
+    return command_pool_recycler_;
+  }
+
   // Memory Allocation
 
   inline SamplerCache& sampler_cache() {
@@ -211,6 +225,20 @@ class Adapter final {
     return physical_device_.min_ubo_alignment;
   }
 
+  inline bool supports_host_memory_import() const {
+    return physical_device_.min_imported_host_pointer_alignment > 0;
+  }
+
+  /*
+   * Import host memory as a storage buffer, see HostImportedBuffer. Returns an
+   * empty buffer if the memory can't be imported.
+   */
+  inline HostImportedBuffer import_host_memory(
+      void* data,
+      const size_t nbytes) const {
+    return HostImportedBuffer(physical_device_, device_.handle, data, nbytes);
+  }
+
   // Command Buffer Submission
 
   void
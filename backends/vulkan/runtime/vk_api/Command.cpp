@@ -272,6 +272,54 @@ VkCommandBuffer CommandBuffer::get_submit_handle(const bool final_use) {
   return handle;
 }
 
+//
+// CommandPoolRecycler
+//
+
+CommandPoolRecycler::CommandPoolRecycler(VkDevice device)
+    : device_(device), mutex_{}, pools_{} {}
+
+CommandPoolRecycler::~CommandPoolRecycler() {
+  // Destroying a pool frees the command buffers allocated from it
+  for (const Entry& entry : pools_) {
+    vkDestroyCommandPool(device_, entry.pool, nullptr);
+  }
+}
+
+VkCommandPool CommandPoolRecycler::acquire(
+    const uint32_t queue_family_idx,
+    std::vector<VkCommandBuffer>& buffers) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto it = pools_.begin(); it != pools_.end(); ++it) {
+    if (it->queue_family_idx == queue_family_idx) {
+      VkCommandPool pool = it->pool;
+      buffers = std::move(it->buffers);
+      pools_.erase(it);
+      return pool;
+    }
+  }
+  return VK_NULL_HANDLE;
+}
+
+void CommandPoolRecycler::release(
+    const uint32_t queue_family_idx,
+    VkCommandPool pool,
+    std::vector<VkCommandBuffer>&& buffers) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (pools_.size() >= kMaxPools) {
+    vkDestroyCommandPool(device_, pool, nullptr);
+    return;
+  }
+  pools_.push_back({queue_family_idx, pool, std::move(buffers)});
+}
+
+size_t CommandPoolRecycler::num_pools() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pools_.size();
+}
+
 //
 // CommandPool
 //
@@ -279,14 +327,25 @@ VkCommandBuffer CommandBuffer::get_submit_handle(const bool final_use) {
 CommandPool::CommandPool(
     VkDevice device,
     const uint32_t queue_family_idx,
-    const CommandPoolConfig& config)
+    const CommandPoolConfig& config,
+    CommandPoolRecycler* recycler)
     : device_(device),
       queue_family_idx_(queue_family_idx),
       pool_(VK_NULL_HANDLE),
       config_(config),
+      recycler_(recycler),
       mutex_{},
       buffers_{},
       in_use_(0u) {
+  if (recycler_ != nullptr) {
+    pool_ = recycler_->acquire(queue_family_idx_, buffers_);
+    if (pool_ != VK_NULL_HANDLE) {
+      // No-ops unless the pool has fewer command buffers than requested
+      allocate_new_batch(config_.cmd_pool_initial_size);
+      return;
+    }
+  }
+
   const VkCommandPoolCreateInfo create_info{
       VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
       nullptr,
@@ -304,6 +363,11 @@ CommandPool::~CommandPool() {
   if (pool_ == VK_NULL_HANDLE) {
     return;
   }
+  if (recycler_ != nullptr &&
+      vkResetCommandPool(device_, pool_, 0u) == VK_SUCCESS) {
+    recycler_->release(queue_family_idx_, pool_, std::move(buffers_));
+    return;
+  }
   vkDestroyCommandPool(device_, pool_, nullptr);
 }
 
@@ -110,9 +110,65 @@ struct CommandPoolConfig final {
   uint32_t cmd_pool_batch_size;
 };
 
+/*
+ * Holds on to the command pools of destroyed CommandPools, reset and with the
+ * command buffers allocated from them, so that the CommandPools created next
+ * reuse them, like DescriptorPoolRecycler does for descriptor pools. One is
+ * shared by all the Contexts of an Adapter, so it is thread safe.
+ */
+class CommandPoolRecycler final {
+ public:
+  explicit CommandPoolRecycler(VkDevice device);
+
+  CommandPoolRecycler(const CommandPoolRecycler&) = delete;
+  CommandPoolRecycler& operator=(const CommandPoolRecycler&) = delete;
+
+  CommandPoolRecycler(CommandPoolRecycler&&) = delete;
+  CommandPoolRecycler& operator=(CommandPoolRecycler&&) = delete;
+
+  ~CommandPoolRecycler();
+
+  // Pools released beyond this many are destroyed
+  static constexpr size_t kMaxPools = 16u;
+
+ private:
+  struct Entry final {
+    uint32_t queue_family_idx;
+    VkCommandPool pool;
+    std::vector<VkCommandBuffer> buffers;
+  };
+
+  VkDevice device_;
+  std::mutex mutex_;
+  std::vector<Entry> pools_;
+
+ public:
+  /*
+   * Take a released pool of the queue family, and the command buffers
+   * allocated from it. Returns VK_NULL_HANDLE if there is none.
+   */
+  VkCommandPool acquire(
+      const uint32_t queue_family_idx,
+      std::vector<VkCommandBuffer>& buffers);
+
+  /*
+   * Hand over a reset pool with the command buffers allocated from it.
+   */
+  void release(
+      const uint32_t queue_family_idx,
+      VkCommandPool pool,
+      std::vector<VkCommandBuffer>&& buffers);
+
+  size_t num_pools();
+};
+
 class CommandPool final {
  public:
-  explicit CommandPool(VkDevice, const uint32_t, const CommandPoolConfig&);
+  explicit CommandPool(
+      VkDevice,
+      const uint32_t,
+      const CommandPoolConfig&,
+      CommandPoolRecycler* recycler = nullptr);
 
   CommandPool(const CommandPool&) = delete;
   CommandPool& operator=(const CommandPool&) = delete;
@@ -127,6 +183,8 @@ class CommandPool final {
   uint32_t queue_family_idx_;
   VkCommandPool pool_;
   CommandPoolConfig config_;
+  // Where the pool comes from and goes back to, if set
+  CommandPoolRecycler* recycler_;
   // New Buffers
   std::mutex mutex_;
   std::vector<VkCommandBuffer> buffers_;
@@ -259,16 +259,101 @@ void DescriptorSetPile::allocate_new_batch() {
   in_use_ = 0u;
 }
 
+//
+// DescriptorPoolRecycler
+//
+
+namespace {
+
+bool has_room_for(
+    const DescriptorPoolConfig& pool,
+    const DescriptorPoolConfig& config) {
+  return pool.descriptor_pool_max_sets >= config.descriptor_pool_max_sets &&
+      pool.descriptor_uniform_buffer_count >=
+      config.descriptor_uniform_buffer_count &&
+      pool.descriptor_storage_buffer_count >=
+      config.descriptor_storage_buffer_count &&
+      pool.descriptor_combined_sampler_count >=
+      config.descriptor_combined_sampler_count &&
+      pool.descriptor_storage_image_count >=
+      config.descriptor_storage_image_count;
+}
+
+} // namespace
+
+DescriptorPoolRecycler::DescriptorPoolRecycler(VkDevice device)
+    : device_(device), mutex_{}, pools_{} {}
+
+DescriptorPoolRecycler::~DescriptorPoolRecycler() {
+  for (const Entry& entry : pools_) {
+    vkDestroyDescriptorPool(device_, entry.pool, nullptr);
+  }
+}
+
+VkDescriptorPool DescriptorPoolRecycler::acquire(
+    const DescriptorPoolConfig& config,
+    DescriptorPoolConfig& capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto best = pools_.end();
+  for (auto it = pools_.begin(); it != pools_.end(); ++it) {
+    if (has_room_for(it->capacity, config) &&
+        (best == pools_.end() ||
+         it->capacity.descriptor_pool_max_sets <
+             best->capacity.descriptor_pool_max_sets)) {
+      best = it;
+    }
+  }
+  if (best == pools_.end()) {
+    return VK_NULL_HANDLE;
+  }
+
+  VkDescriptorPool pool = best->pool;
+  capacity = best->capacity;
+  pools_.erase(best);
+  return pool;
+}
+
+void DescriptorPoolRecycler::release(
+    VkDescriptorPool pool,
+    const DescriptorPoolConfig& capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (pools_.size() >= kMaxPools) {
+    // Keep the largest pools, which can be reused by the most graphs
+    auto smallest = std::min_element(
+        pools_.begin(), pools_.end(), [](const Entry& a, const Entry& b) {
+          return a.capacity.descriptor_pool_max_sets <
+              b.capacity.descriptor_pool_max_sets;
+        });
+    if (smallest->capacity.descriptor_pool_max_sets >=
+        capacity.descriptor_pool_max_sets) {
+      vkDestroyDescriptorPool(device_, pool, nullptr);
+      return;
+    }
+    vkDestroyDescriptorPool(device_, smallest->pool, nullptr);
+    pools_.erase(smallest);
+  }
+  pools_.push_back({pool, capacity});
+}
+
+size_t DescriptorPoolRecycler::num_pools() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pools_.size();
+}
+
 //
 // DescriptorPool
 //
 
 DescriptorPool::DescriptorPool(
     VkDevice device,
-    const DescriptorPoolConfig& config)
+    const DescriptorPoolConfig& config,
+    DescriptorPoolRecycler* recycler)
     : device_(device),
       pool_(VK_NULL_HANDLE),
       config_(config),
+      recycler_(recycler),
       mutex_{},
       piles_{} {
   if (config.descriptor_pool_max_sets > 0) {
@@ -280,6 +365,11 @@ DescriptorPool::~DescriptorPool() {
   if (pool_ == VK_NULL_HANDLE) {
     return;
   }
+  if (recycler_ != nullptr &&
+      vkResetDescriptorPool(device_, pool_, 0u) == VK_SUCCESS) {
+    recycler_->release(pool_, config_);
+    return;
+  }
   vkDestroyDescriptorPool(device_, pool_, nullptr);
 }
 
@@ -290,6 +380,17 @@ void DescriptorPool::init(const DescriptorPoolConfig& config) {
 
   config_ = config;
 
+  if (recycler_ != nullptr) {
+    DescriptorPoolConfig capacity{};
+    pool_ = recycler_->acquire(config, capacity);
+    if (pool_ != VK_NULL_HANDLE) {
+      // Descriptor sets are still allocated in piles of the requested size
+      capacity.descriptor_pile_sizes = config.descriptor_pile_sizes;
+      config_ = capacity;
+      return;
+    }
+  }
+
   std::vector<VkDescriptorPoolSize> type_sizes{
       {
           VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
@@ -305,7 +406,7 @@ void DescriptorPool::init(const DescriptorPoolConfig& config) {
       },
       {
           VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-          config_.descriptor_storage_buffer_count,
+          config_.descriptor_storage_image_count,
       },
   };
 
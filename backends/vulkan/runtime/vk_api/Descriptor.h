@@ -17,6 +17,7 @@
 #include <executorch/backends/vulkan/runtime/vk_api/memory/Buffer.h>
 #include <executorch/backends/vulkan/runtime/vk_api/memory/Image.h>
 
+#include <mutex>
 #include <unordered_map>
 
 namespace vkcompute {
@@ -133,9 +134,61 @@ struct DescriptorPoolConfig final {
   uint32_t descriptor_pile_sizes;
 };
 
+/*
+ * Holds on to the descriptor pools of destroyed DescriptorPools, reset, so
+ * that the DescriptorPools created next reuse them instead of creating new
+ * ones. Processes that load many small graphs, each with its own Context,
+ * then stop creating and destroying pools as graphs come and go. One is
+ * shared by all the Contexts of an Adapter, so it is thread safe.
+ */
+class DescriptorPoolRecycler final {
+ public:
+  explicit DescriptorPoolRecycler(VkDevice device);
+
+  DescriptorPoolRecycler(const DescriptorPoolRecycler&) = delete;
+  DescriptorPoolRecycler& operator=(const DescriptorPoolRecycler&) = delete;
+
+  DescriptorPoolRecycler(DescriptorPoolRecycler&&) = delete;
+  DescriptorPoolRecycler& operator=(DescriptorPoolRecycler&&) = delete;
+
+  ~DescriptorPoolRecycler();
+
+  // Pools released beyond this many are destroyed
+  static constexpr size_t kMaxPools = 16u;
+
+ private:
+  struct Entry final {
+    VkDescriptorPool pool;
+    DescriptorPoolConfig capacity;
+  };
+
+  VkDevice device_;
+  std::mutex mutex_;
+  std::vector<Entry> pools_;
+
+ public:
+  /*
+   * Take the smallest released pool that has room for config, and set
+   * capacity to what it can hold. Returns VK_NULL_HANDLE if none does.
+   */
+  VkDescriptorPool acquire(
+      const DescriptorPoolConfig& config,
+      DescriptorPoolConfig& capacity);
+
+  /*
+   * Hand over a reset pool that can hold capacity.
+   */
+  void release(VkDescriptorPool pool, const DescriptorPoolConfig& capacity);
+
+  size_t num_pools();
+};
+
 class DescriptorPool final {
  public:
-  explicit DescriptorPool(VkDevice, const DescriptorPoolConfig&);
+  explicit DescriptorPool(
+      VkDevice,
+      const DescriptorPoolConfig&,
+      DescriptorPoolRecycler* recycler = nullptr);
 
   DescriptorPool(const DescriptorPool&) = delete;
   DescriptorPool& operator=(const DescriptorPool&) = delete;
@@ -149,6 +202,8 @@ class DescriptorPool final {
   VkDevice device_;
   VkDescriptorPool pool_;
   DescriptorPoolConfig config_;
+  // Where the pool comes from and goes back to, if set
+  DescriptorPoolRecycler* recycler_;
   // New Descriptors
   std::mutex mutex_;
   std::unordered_map<VkDescriptorSetLayout, DescriptorSetPile> piles_;
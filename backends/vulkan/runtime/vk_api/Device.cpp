@@ -41,7 +41,9 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
       has_unified_memory(false),
       has_timestamps(false),
       timestamp_period(0),
-      min_ubo_alignment(0) {
+      min_ubo_alignment(0),
+      min_storage_buffer_alignment(0),
+      min_imported_host_pointer_alignment(0) {
   // Extract physical device properties
   vkGetPhysicalDeviceProperties(handle, &properties);
 
@@ -49,6 +51,26 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
   has_timestamps = properties.limits.timestampComputeAndGraphics;
   timestamp_period = properties.limits.timestampPeriod;
   min_ubo_alignment = properties.limits.minUniformBufferOffsetAlignment;
+  min_storage_buffer_alignment =
+      properties.limits.minStorageBufferOffsetAlignment;
+
+#ifdef VK_EXT_external_memory_host
+  std::vector<const char*> host_memory_extension;
+  find_requested_device_extensions(
+      handle,
+      host_memory_extension,
+      {VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME});
+  if (!host_memory_extension.empty()) {
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT host_memory_properties{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT};
+    VkPhysicalDeviceProperties2 properties2{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    properties2.pNext = &host_memory_properties;
+    vkGetPhysicalDeviceProperties2(handle, &properties2);
+    min_imported_host_pointer_alignment =
+        host_memory_properties.minImportedHostPointerAlignment;
+  }
+#endif /* VK_EXT_external_memory_host */
 
   vkGetPhysicalDeviceMemoryProperties(handle, &memory_properties);
 
@@ -50,6 +50,10 @@ struct PhysicalDevice final {
   bool has_timestamps;
   float timestamp_period;
   size_t min_ubo_alignment;
+  size_t min_storage_buffer_alignment;
+  // Alignment of host pointers imported through VK_EXT_external_memory_host,
+  // or 0 if the extension is not available
+  size_t min_imported_host_pointer_alignment;
 
   explicit PhysicalDevice(VkPhysicalDevice);
 };
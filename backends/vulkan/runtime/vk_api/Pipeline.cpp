@@ -8,6 +8,7 @@
 
 #include <executorch/backends/vulkan/runtime/vk_api/Pipeline.h>
 
+#include <cstdio>
 #include <fstream>
 
 namespace vkcompute {
@@ -405,10 +406,12 @@ ComputePipelineCache::ComputePipelineCache(
       device_(device),
       pipeline_cache_{VK_NULL_HANDLE},
       cache_{},
-      cache_data_path_(cache_data_path) {
+      cache_data_path_(cache_data_path),
+      saved_size_{0u} {
   VkPipelineCacheCreateInfo pipeline_cache_create_info{};
 
   auto buffer = load_cache();
+  saved_size_ = buffer.size();
 
   pipeline_cache_create_info = {
       VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, // sType
@@ -427,7 +430,9 @@ ComputePipelineCache::ComputePipelineCache(
     : cache_mutex_{},
       device_(other.device_),
       pipeline_cache_(other.pipeline_cache_),
-      cache_(std::move(other.cache_)) {
+      cache_(std::move(other.cache_)),
+      cache_data_path_(other.cache_data_path_),
+      saved_size_(other.saved_size_) {
   std::lock_guard<std::mutex> lock(other.cache_mutex_);
 
   other.pipeline_cache_ = VK_NULL_HANDLE;
@@ -491,20 +496,34 @@ void ComputePipelineCache::save_cache() {
     return;
   }
 
-  // Return if file exists; the cache is already saved
-  std::ifstream ifile(cache_data_path_);
-  if (ifile.good()) {
-    return;
-  }
+  std::lock_guard<std::mutex> lock(cache_mutex_);
 
   size_t size{};
-  vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr);
+  VK_CHECK(vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr));
+  // Return if no pipelines were added; the cache is already saved
+  if (size == saved_size_) {
+    return;
+  }
 
   std::vector<char> buffer(size);
-  vkGetPipelineCacheData(device_, pipeline_cache_, &size, buffer.data());
-
-  std::ofstream file(cache_data_path_, std::ios::binary);
-  file.write(buffer.data(), buffer.size());
+  VK_CHECK(
+      vkGetPipelineCacheData(device_, pipeline_cache_, &size, buffer.data()));
+
+  // Write to a temporary file first, so that another process never loads a
+  // partially written cache.
+  const std::string tmp_path = cache_data_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary);
+    file.write(buffer.data(), size);
+    if (!file) {
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_data_path_.c_str()) == 0) {
+    saved_size_ = size;
+  } else {
+    std::remove(tmp_path.c_str());
+  }
 }
 
 } // namespace vkapi
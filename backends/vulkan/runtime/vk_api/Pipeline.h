@@ -278,8 +278,16 @@ class ComputePipelineCache final {
     }
   };
 
+  /*
+   * Write the pipeline cache to the cache data path, if the driver added to
+   * it since it was loaded or last saved.
+   */
   void save_cache();
 
+  inline const std::string& cache_data_path() const {
+    return cache_data_path_;
+  }
+
  private:
   std::vector<char> load_cache();
 
@@ -291,6 +299,8 @@ class ComputePipelineCache final {
   VkPipelineCache pipeline_cache_;
   std::unordered_map<Key, Value, Hasher> cache_;
   const std::string cache_data_path_;
+  // The size of the pipeline cache data when it was loaded or last saved
+  size_t saved_size_;
 
  public:
   VkPipeline retrieve(const Key&);
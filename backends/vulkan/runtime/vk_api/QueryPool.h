@@ -26,6 +26,10 @@
 namespace vkcompute {
 namespace vkapi {
 
+// The dispatch id of shaders that aren't attributed to an operator, e.g. the
+// staging copies of a graph's inputs and outputs.
+constexpr uint32_t kUnsetDispatchId = UINT32_MAX;
+
 struct ShaderMetadata final {
   const uint32_t global_workgroup_size[3];
   const uint32_t local_workgroup_size[3];
@@ -11,6 +11,7 @@
 #include <executorch/backends/vulkan/runtime/vk_api/Adapter.h>
 
 #include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 
@@ -254,6 +255,28 @@ uint32_t select_first(const std::vector<Runtime::DeviceMapping>& devices) {
   return devices.size() + 1;
 }
 
+std::string& pipeline_cache_prefix() {
+  static std::string prefix;
+  return prefix;
+}
+
+std::string pipeline_cache_path(
+    const std::string& prefix,
+    const PhysicalDevice& physical_device) {
+  if (prefix.empty()) {
+    return prefix;
+  }
+  const VkPhysicalDeviceProperties& properties = physical_device.properties;
+  std::stringstream path;
+  path << prefix << std::hex << "_" << properties.vendorID << "_"
+       << properties.deviceID << "_" << properties.driverVersion << "_";
+  for (const uint8_t byte : properties.pipelineCacheUUID) {
+    path << std::setw(2) << std::setfill('0') << static_cast<uint32_t>(byte);
+  }
+  path << ".bin";
+  return path.str();
+}
+
 //
 // Global runtime initialization
 //
@@ -278,7 +301,7 @@ std::unique_ptr<Runtime> init_global_vulkan_runtime() {
 #endif /* VULKAN_DEBUG */
   const bool init_default_device = true;
   const uint32_t num_requested_queues = 1; // TODO: raise this value
-  const std::string cache_data_path = ""; // TODO: expose to client
+  const std::string cache_data_path = pipeline_cache_prefix();
 
   const RuntimeConfig default_config{
       enable_validation_messages,
@@ -371,7 +394,7 @@ uint32_t Runtime::create_adapter(const Selector& selector) {
       instance_,
       device_mapping.first,
       config_.num_requested_queues,
-      config_.cache_data_path));
+      pipeline_cache_path(config_.cache_data_path, device_mapping.first)));
   device_mapping.second = adapter_i;
 
   return adapter_i;
@@ -393,5 +416,9 @@ Runtime* runtime() {
   return p_runtime.get();
 }
 
+void set_pipeline_cache_prefix(const std::string& prefix) {
+  pipeline_cache_prefix() = prefix;
+}
+
 } // namespace vkapi
 } // namespace vkcompute
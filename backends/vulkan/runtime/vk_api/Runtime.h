@@ -39,6 +39,8 @@ struct RuntimeConfig final {
   bool init_default_device;
   AdapterSelector default_selector;
   uint32_t num_requested_queues;
+  // Where to persist the pipeline cache of each adapter, see
+  // set_pipeline_cache_prefix()
   std::string cache_data_path;
 };
 
@@ -104,5 +106,11 @@ class Runtime final {
 // a static local variable.
 Runtime* runtime();
 
+// Persist the pipeline cache of each adapter to a file named after the prefix
+// and the identity of the device and its driver, so that a driver update
+// doesn't load a stale cache. Only takes effect if called before the global
+// runtime is first retrieved. An empty prefix, the default, disables it.
+void set_pipeline_cache_prefix(const std::string& prefix);
+
 } // namespace vkapi
 } // namespace vkcompute
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/vulkan/runtime/vk_api/memory/HostImportedBuffer.h>
+
+#include <cstdint>
+
+namespace vkcompute {
+namespace vkapi {
+
+HostImportedBuffer::HostImportedBuffer()
+    : device_(VK_NULL_HANDLE),
+      handle_(VK_NULL_HANDLE),
+      memory_(VK_NULL_HANDLE),
+      data_(nullptr),
+      offset_(0u),
+      nbytes_(0u) {}
+
+HostImportedBuffer::HostImportedBuffer(
+    const PhysicalDevice& physical_device,
+    VkDevice device,
+    void* data,
+    const size_t nbytes)
+    : HostImportedBuffer() {
+#ifdef VK_EXT_external_memory_host
+  const uintptr_t alignment =
+      physical_device.min_imported_host_pointer_alignment;
+  if (alignment == 0u || data == nullptr || nbytes == 0u) {
+    return;
+  }
+
+  // The import must start and end at multiples of the import alignment, and
+  // the data must then start at a valid storage buffer offset in it.
+  const uintptr_t address = reinterpret_cast<uintptr_t>(data);
+  const uintptr_t base = address - address % alignment;
+  const VkDeviceSize offset = address - base;
+  const uintptr_t storage_alignment =
+      physical_device.min_storage_buffer_alignment;
+  if (storage_alignment > 1u && offset % storage_alignment != 0u) {
+    return;
+  }
+  const VkDeviceSize size =
+      (offset + nbytes + alignment - 1u) / alignment * alignment;
+
+  const auto get_host_pointer_properties =
+      reinterpret_cast<PFN_vkGetMemoryHostPointerPropertiesEXT>(
+          vkGetDeviceProcAddr(device, "vkGetMemoryHostPointerPropertiesEXT"));
+  if (get_host_pointer_properties == nullptr) {
+    return;
+  }
+  constexpr VkExternalMemoryHandleTypeFlagBits handle_type =
+      VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+  VkMemoryHostPointerPropertiesEXT host_pointer_properties{
+      VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT};
+  if (get_host_pointer_properties(
+          device,
+          handle_type,
+          reinterpret_cast<void*>(base),
+          &host_pointer_properties) != VK_SUCCESS) {
+    return;
+  }
+
+  const VkExternalMemoryBufferCreateInfo external_create_info{
+      VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO, // sType
+      nullptr, // pNext
+      handle_type, // handleTypes
+  };
+  const VkBufferCreateInfo buffer_create_info{
+      VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, // sType
+      &external_create_info, // pNext
+      0u, // flags
+      size, // size
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, // usage
+      VK_SHARING_MODE_EXCLUSIVE, // sharingMode
+      0u, // queueFamilyIndexCount
+      nullptr, // pQueueFamilyIndices
+  };
+  device_ = device;
+  if (vkCreateBuffer(device_, &buffer_create_info, nullptr, &handle_) !=
+      VK_SUCCESS) {
+    handle_ = VK_NULL_HANDLE;
+    return;
+  }
+
+  VkMemoryRequirements memory_requirements{};
+  vkGetBufferMemoryRequirements(device_, handle_, &memory_requirements);
+
+  // Host writes must be visible to the GPU without flushing, and vice versa,
+  // since the memory is never mapped through Vulkan.
+  const VkMemoryPropertyFlags required_flags =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  const uint32_t memory_type_bits = host_pointer_properties.memoryTypeBits &
+      memory_requirements.memoryTypeBits;
+  uint32_t memory_type_index = UINT32_MAX;
+  for (uint32_t i = 0; i < physical_device.memory_properties.memoryTypeCount;
+       ++i) {
+    const VkMemoryPropertyFlags flags =
+        physical_device.memory_properties.memoryTypes[i].propertyFlags;
+    if ((memory_type_bits & (1u << i)) &&
+        (flags & required_flags) == required_flags) {
+      memory_type_index = i;
+      break;
+    }
+  }
+  if (memory_type_index == UINT32_MAX || memory_requirements.size > size) {
+    release();
+    return;
+  }
+
+  const VkImportMemoryHostPointerInfoEXT import_info{
+      VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT, // sType
+      nullptr, // pNext
+      handle_type, // handleType
+      reinterpret_cast<void*>(base), // pHostPointer
+  };
+  const VkMemoryAllocateInfo allocate_info{
+      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, // sType
+      &import_info, // pNext
+      size, // allocationSize
+      memory_type_index, // memoryTypeIndex
+  };
+  if (vkAllocateMemory(device_, &allocate_info, nullptr, &memory_) !=
+      VK_SUCCESS) {
+    memory_ = VK_NULL_HANDLE;
+    release();
+    return;
+  }
+  if (vkBindBufferMemory(device_, handle_, memory_, 0u) != VK_SUCCESS) {
+    release();
+    return;
+  }
+
+  data_ = data;
+  offset_ = offset;
+  nbytes_ = nbytes;
+#else
+  (void)physical_device;
+  (void)device;
+  (void)data;
+  (void)nbytes;
+#endif /* VK_EXT_external_memory_host */
+}
+
+HostImportedBuffer::HostImportedBuffer(HostImportedBuffer&& other) noexcept
+    : device_(other.device_),
+      handle_(other.handle_),
+      memory_(other.memory_),
+      data_(other.data_),
+      offset_(other.offset_),
+      nbytes_(other.nbytes_) {
+  other.handle_ = VK_NULL_HANDLE;
+  other.memory_ = VK_NULL_HANDLE;
+  other.data_ = nullptr;
+}
+
+HostImportedBuffer& HostImportedBuffer::operator=(
+    HostImportedBuffer&& other) noexcept {
+  if (this != &other) {
+    release();
+
+    device_ = other.device_;
+    handle_ = other.handle_;
+    memory_ = other.memory_;
+    data_ = other.data_;
+    offset_ = other.offset_;
+    nbytes_ = other.nbytes_;
+
+    other.handle_ = VK_NULL_HANDLE;
+    other.memory_ = VK_NULL_HANDLE;
+    other.data_ = nullptr;
+  }
+  return *this;
+}
+
+HostImportedBuffer::~HostImportedBuffer() {
+  release();
+}
+
+void HostImportedBuffer::release() {
+  if (handle_ != VK_NULL_HANDLE) {
+    vkDestroyBuffer(device_, handle_, nullptr);
+    handle_ = VK_NULL_HANDLE;
+  }
+  if (memory_ != VK_NULL_HANDLE) {
+    vkFreeMemory(device_, memory_, nullptr);
+    memory_ = VK_NULL_HANDLE;
+  }
+  data_ = nullptr;
+  offset_ = 0u;
+  nbytes_ = 0u;
+}
+
+} // namespace vkapi
+} // namespace vkcompute
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// @lint-ignore-every CLANGTIDY facebook-hte-BadMemberName
+
+#include <executorch/backends/vulkan/runtime/vk_api/vk_api.h>
+
+#include <executorch/backends/vulkan/runtime/vk_api/Device.h>
+
+#include <cstddef>
+
+namespace vkcompute {
+namespace vkapi {
+
+/*
+ * A storage buffer backed by host memory that the application owns, imported
+ * through VK_EXT_external_memory_host. Shaders read and write the host memory
+ * directly, so that data in it does not need to be copied to a staging
+ * buffer first.
+ *
+ * Importing is best effort: if the device does not support it, or the memory
+ * can't be imported, e.g. because of its alignment, the resulting buffer is
+ * empty and the caller should fall back to a staging buffer. The host memory
+ * must stay valid, at the same address, for the lifetime of the buffer.
+ */
+class HostImportedBuffer final {
+ public:
+  explicit HostImportedBuffer();
+
+  explicit HostImportedBuffer(
+      const PhysicalDevice& physical_device,
+      VkDevice device,
+      void* data,
+      const size_t nbytes);
+
+  HostImportedBuffer(const HostImportedBuffer&) = delete;
+  HostImportedBuffer& operator=(const HostImportedBuffer&) = delete;
+
+  HostImportedBuffer(HostImportedBuffer&&) noexcept;
+  HostImportedBuffer& operator=(HostImportedBuffer&&) noexcept;
+
+  ~HostImportedBuffer();
+
+ private:
+  VkDevice device_;
+  VkBuffer handle_;
+  VkDeviceMemory memory_;
+  // The imported range covers whole multiples of the import alignment, so
+  // data_ may be anywhere in it, at offset_
+  void* data_;
+  VkDeviceSize offset_;
+  VkDeviceSize nbytes_;
+
+  void release();
+
+ public:
+  inline VkBuffer handle() const {
+    return handle_;
+  }
+
+  inline VkDeviceSize offset() const {
+    return offset_;
+  }
+
+  inline VkDeviceSize nbytes() const {
+    return nbytes_;
+  }
+
+  inline void* data() const {
+    return data_;
+  }
+
+  operator bool() const {
+    return (handle_ != VK_NULL_HANDLE);
+  }
+};
+
+} // namespace vkapi
+} // namespace vkcompute
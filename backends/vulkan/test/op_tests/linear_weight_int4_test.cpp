@@ -249,3 +249,17 @@ TEST(VulkanInt4LinearTest, test_vulkan_impl) {
       /*K = */ 128,
       /*N = */ 32);
 }
+
+TEST(VulkanInt4LinearTest, test_vulkan_impl_single_row) {
+  if (!vkcompute::api::context()
+           ->adapter_ptr()
+           ->has_full_int8_buffers_support()) {
+    GTEST_SKIP();
+  }
+  // Few rows use the cooperative shader
+  test_vulkan_linear_int4(
+      /*B = */ 1,
+      /*M = */ 1,
+      /*K = */ 256,
+      /*N = */ 32);
+}
@@ -17,6 +17,7 @@
 #include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
 
 #include <cassert>
 #include <iostream>
@@ -45,7 +46,8 @@ Tensor& sdpa_with_kv_cache_out_no_context(
     // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
     const optional<double> scale,
     Tensor& output) {
-  executorch::runtime::KernelRuntimeContext context{};
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::native::sdpa_with_kv_cache_out(
       context,
       q_projected,
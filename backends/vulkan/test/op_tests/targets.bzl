@@ -145,6 +145,7 @@ def define_common_targets(is_fbcode = False):
         "sdpa_test",
         extra_deps = [
             "//executorch/extension/llm/custom_ops:custom_ops_aot_lib",
+            "//executorch/extension/memory_allocator:malloc_memory_allocator",
             "//executorch/extension/tensor:tensor",
         ]
     )
@@ -8,7 +8,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <bitset>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -16,6 +21,8 @@
 
 #include <executorch/backends/vulkan/runtime/api/api.h>
 
+#include <executorch/backends/vulkan/runtime/graph/StoragePlan.h>
+
 #include <executorch/backends/vulkan/runtime/graph/ops/OperatorRegistry.h>
 
 #include <executorch/backends/vulkan/runtime/graph/ops/utils/StagingUtils.h>
@@ -1150,6 +1157,33 @@ TEST_F(VulkanComputeAPITest, test_tensor_creation_from_vulkan_image) {
   EXPECT_TRUE(tensor.padded_numel() == exp_numel);
 }
 
+TEST_F(VulkanComputeAPITest, pipeline_cache_persists_to_file) {
+  const std::string path =
+      ::testing::TempDir() + "etvk_pipeline_cache_test.bin";
+  std::remove(path.c_str());
+
+  const vkapi::ComputePipelineCache::Key key = context()->get_pipeline_key(
+      VK_KERNEL_FROM_STR("scalar_add_texture"), {4u, 4u, 1u}, {}, 0u);
+  const VkDevice device = context()->adapter_ptr()->device_handle();
+  {
+    vkapi::ComputePipelineCache pipeline_cache(device, path);
+    EXPECT_NE(pipeline_cache.retrieve(key), VK_NULL_HANDLE);
+    pipeline_cache.save_cache();
+  }
+
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  ASSERT_TRUE(file.good());
+  EXPECT_GT(file.tellg(), 0);
+  file.close();
+
+  // A new cache loads the pipeline from the file
+  {
+    vkapi::ComputePipelineCache pipeline_cache(device, path);
+    EXPECT_NE(pipeline_cache.retrieve(key), VK_NULL_HANDLE);
+  }
+  std::remove(path.c_str());
+}
+
 TEST(VulkanComputeGraphTest, test_values_scalars) {
   GraphConfig config;
   ComputeGraph graph(config);
@@ -1446,6 +1480,323 @@ TEST(VulkanComputeGraphTest, test_simple_graph) {
   }
 }
 
+TEST(VulkanComputeGraphTest, test_pools_recycled_across_graphs) {
+  vkapi::Adapter* adapter = api::context()->adapter_ptr();
+
+  auto run_graph = [&]() {
+    GraphConfig config;
+    ComputeGraph graph(config);
+
+    std::vector<int64_t> sizes = {1, 8, 8};
+    IOValueRef a = graph.add_input_tensor(sizes, vkapi::kFloat);
+    IOValueRef b = graph.add_input_tensor(sizes, vkapi::kFloat);
+    IOValueRef out = {};
+    out.value = graph.add_tensor(sizes, vkapi::kFloat);
+
+    auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+    addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+    out.staging = graph.set_output_tensor(out.value);
+
+    graph.prepare();
+    graph.encode_execute();
+
+    fill_vtensor(graph, a, 1.0f);
+    fill_vtensor(graph, b, 2.0f);
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, 3.0f);
+    }
+  };
+
+  // The pools of a destroyed graph are kept for the next one
+  run_graph();
+  const size_t num_descriptor_pools =
+      adapter->descriptor_pool_recycler().num_pools();
+  const size_t num_command_pools = adapter->command_pool_recycler().num_pools();
+  EXPECT_GE(num_descriptor_pools, 1u);
+  EXPECT_GE(num_command_pools, 1u);
+
+  // The next graph reuses them, and gives them back when it is destroyed
+  run_graph();
+  EXPECT_EQ(
+      adapter->descriptor_pool_recycler().num_pools(), num_descriptor_pools);
+  EXPECT_EQ(adapter->command_pool_recycler().num_pools(), num_command_pools);
+}
+
+TEST(VulkanComputeGraphTest, test_simple_graph_warm_pipelines) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {1, 8, 8};
+  std::vector<int64_t> size_small = {1, 1, 8};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  IOValueRef out = {};
+
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.warm_pipelines();
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Run graph
+
+  fill_vtensor(graph, a, 2.0f);
+  fill_vtensor(graph, b, 1.5f);
+
+  graph.execute();
+
+  EXTRACT_TENSOR(out);
+
+  for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+    CHECK_VALUE(data_out, i, 3.5f);
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_simple_graph_execute_async) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {1, 8, 8};
+  std::vector<int64_t> size_small = {1, 1, 8};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  IOValueRef out = {};
+
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Run graph, uploading the inputs of each inference while the previous one
+  // is in flight
+
+  fill_vtensor(graph, a, 7.0f);
+  fill_vtensor(graph, b, 6.5f);
+  graph.execute_async();
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_c = 2 * i + 3.5f;
+
+    EXPECT_TRUE(graph.execute_in_flight());
+    fill_vtensor(graph, a, i + 12.0f);
+    fill_vtensor(graph, b, i + 11.5f);
+
+    EXTRACT_TENSOR(out);
+    EXPECT_FALSE(graph.execute_in_flight());
+
+    // The inputs copied in during the execution must not affect its outputs
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_c);
+    }
+
+    graph.execute_async();
+  }
+  graph.wait_for_execute();
+}
+
+TEST(VulkanComputeGraphTest, test_simple_graph_with_memory_planning) {
+  GraphConfig config;
+  config.enable_memory_planning = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {1, 8, 8};
+  std::vector<int64_t> size_small = {1, 1, 8};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  // Each intermediate is alive until the next one is written, so the first
+  // and the last one can share memory.
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  ValueRef prev = a.value;
+  for (int i = 0; i < 3; ++i) {
+    ValueRef next = graph.add_tensor(size_big, vkapi::kFloat);
+    addFn(graph, {prev, b.value, kDummyValueRef, next});
+    prev = next;
+  }
+
+  IOValueRef out = {};
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+  addFn(graph, {prev, b.value, kDummyValueRef, out.value});
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  const MemoryPlanningStats& stats = graph.memory_planning_stats();
+  EXPECT_EQ(stats.num_planned_tensors, 6u);
+  EXPECT_EQ(stats.num_shared_objects, 2u);
+  EXPECT_LT(stats.planned_nbytes, stats.unplanned_nbytes);
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_a = i + 2.0f;
+    float val_b = i + 1.5f;
+    float val_out = val_a + 4 * val_b;
+
+    fill_vtensor(graph, a, val_a);
+    fill_vtensor(graph, b, val_b);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_simple_graph_with_host_memory_import) {
+  GraphConfig config;
+  config.set_storage_type_override(utils::kBuffer);
+  config.enable_host_memory_import = true;
+  ComputeGraph graph(config);
+  if (!graph.context()->adapter_ptr()->supports_host_memory_import()) {
+    GTEST_SKIP();
+  }
+
+  std::vector<int64_t> sizes = {1, 8, 8};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(sizes, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(sizes, vkapi::kFloat);
+
+  IOValueRef out = {};
+  out.value = graph.add_tensor(sizes, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Host memory aligned well beyond the import alignment of any device
+  constexpr size_t kAlignment = 64 * 1024;
+  using HostMemory = std::unique_ptr<float, decltype(&std::free)>;
+  auto allocate = []() {
+    return HostMemory(
+        static_cast<float*>(std::aligned_alloc(kAlignment, kAlignment)),
+        &std::free);
+  };
+  HostMemory data_a = allocate();
+  HostMemory data_b = allocate();
+  HostMemory data_out = allocate();
+
+  const size_t numel = graph.get_tensor(out.value)->numel();
+  if (!graph.import_staging_memory(a.staging, data_a.get(), numel)) {
+    GTEST_SKIP();
+  }
+  EXPECT_TRUE(graph.import_staging_memory(b.staging, data_b.get(), numel));
+  EXPECT_TRUE(graph.import_staging_memory(out.staging, data_out.get(), numel));
+  // Memory of a different size can't replace the staging buffer
+  EXPECT_FALSE(
+      graph.import_staging_memory(out.staging, data_out.get(), numel / 2));
+  EXPECT_TRUE(graph.import_staging_memory(out.staging, data_out.get(), numel));
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_a = i + 2.0f;
+    float val_b = i + 1.5f;
+    float val_out = val_a + val_b;
+
+    std::fill(data_a.get(), data_a.get() + numel, val_a);
+    std::fill(data_b.get(), data_b.get() + numel, val_b);
+
+    // The shaders read the inputs and write the output in place
+    graph.execute();
+    graph.wait_for_execute();
+
+    for (size_t j = 0; j < numel; ++j) {
+      CHECK_VALUE(data_out.get(), j, val_out);
+    }
+  }
+  // Only the first execution recorded the command buffer again
+  EXPECT_EQ(graph.num_reencodes(), 1u);
+
+  // Outputs read into other memory are copied from the imported memory
+  std::vector<float> copied(numel);
+  graph.copy_from_staging(out.staging, copied.data(), numel);
+  for (size_t j = 0; j < numel; ++j) {
+    CHECK_VALUE(copied.data(), j, data_out.get()[j]);
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_storage_plan_candidates) {
+  std::vector<int64_t> sizes = {1, 8, 8};
+
+  // Every candidate must at least support simple graphs
+  for (const StoragePlan& plan : storage_plan_candidates()) {
+    GraphConfig config;
+    config.set_storage_type_override(plan.storage_type);
+    config.set_memory_layout_override(plan.memory_layout);
+    ComputeGraph graph(config);
+
+    IOValueRef a = graph.add_input_tensor(sizes, vkapi::kFloat);
+    IOValueRef b = graph.add_input_tensor(sizes, vkapi::kFloat);
+
+    IOValueRef out = {};
+    out.value = graph.add_tensor(sizes, vkapi::kFloat);
+
+    auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+    addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+    out.staging = graph.set_output_tensor(out.value);
+
+    graph.prepare();
+    graph.encode_execute();
+
+    fill_vtensor(graph, a, 2.0f);
+    fill_vtensor(graph, b, 1.5f);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, 3.5f);
+    }
+  }
+
+  vkapi::Adapter* adapter = vkapi::runtime()->get_adapter_p();
+  const uint64_t graph_key = 0x5eed5eed5eed5eedull;
+  StoragePlan plan{};
+  const StoragePlan saved = storage_plan_candidates().back();
+  save_storage_plan(adapter, graph_key, saved);
+  EXPECT_TRUE(find_storage_plan(adapter, graph_key, &plan));
+  EXPECT_EQ(plan.storage_type, saved.storage_type);
+  EXPECT_EQ(plan.memory_layout, saved.memory_layout);
+}
+
 TEST(VulkanComputeGraphTest, test_simple_graph_with_symint) {
   GraphConfig config;
   config.set_storage_type_override(utils::kTexture3D);
@@ -1578,6 +1929,122 @@ TEST(VulkanComputeGraphTest, test_simple_prepacked_graph) {
   }
 }
 
+TEST(VulkanComputeGraphTest, test_async_prepacked_graph) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+  std::vector<int64_t> size_small = {8, 73, 1};
+
+  CREATE_WEIGHT_TENSOR(w1, size_small, vkapi::kFloat, 3.5f);
+  CREATE_WEIGHT_TENSOR(w2, size_small, vkapi::kFloat, 3.0f);
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+
+  ValueRef c = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef e = graph.add_tensor(size_big, vkapi::kFloat);
+
+  ValueRef w1_packed = graph.add_tensor(size_small, vkapi::kFloat);
+  ValueRef w2_packed = graph.add_tensor(size_small, vkapi::kFloat);
+
+  auto prepackFn = VK_GET_OP_FN("et_vk.prepack.default");
+  prepackFn(graph, {w1, w1_packed});
+  prepackFn(graph, {w2, w2_packed});
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, w1_packed, kDummyValueRef, c});
+
+  auto mulFn = VK_GET_OP_FN("aten.mul.Tensor");
+  mulFn(graph, {c, w2_packed, e});
+
+  IOValueRef out = {};
+  out.value = e;
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+
+  bool staged = false;
+  graph.prepack_async([&]() {
+    staged = true;
+    // The weights are no longer read once they are staged
+    std::fill(data_w1.begin(), data_w1.end(), 0.0f);
+    std::fill(data_w2.begin(), data_w2.end(), 0.0f);
+  });
+
+  // Waits for prepacking to finish
+  graph.encode_execute();
+  EXPECT_TRUE(staged);
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_out = (i + 3.5f) * 3.0f;
+
+    fill_vtensor(graph, a, i);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_shader_timestamps_with_node_ids) {
+  GraphConfig config;
+  config.enable_querypool = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_big, vkapi::kFloat);
+
+  IOValueRef out = {};
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  const size_t first_add_node = graph.execute_nodes().size();
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+  // Tag the nodes of the add like VulkanBackend does with delegate debug ids
+  for (size_t i = first_add_node; i < graph.execute_nodes().size(); ++i) {
+    graph.execute_nodes()[i]->set_node_id(7);
+  }
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_prepack();
+  graph.prepack();
+  graph.encode_execute();
+
+  if (!graph.context()->querypool()) {
+    GTEST_SKIP();
+  }
+
+  fill_vtensor(graph, a, 1.0f);
+  fill_vtensor(graph, b, 2.0f);
+  graph.execute();
+
+  graph.context()->querypool().extract_results();
+  size_t num_tagged = 0;
+  for (const auto& r :
+       graph.context()->querypool().get_shader_timestamp_data()) {
+    EXPECT_LE(r.start_time_ns, r.end_time_ns);
+    if (r.dispatch_id == 7) {
+      ++num_tagged;
+    } else {
+      // Untagged dispatches, e.g. staging copies, keep the unset id
+      EXPECT_EQ(r.dispatch_id, vkapi::kUnsetDispatchId);
+    }
+  }
+  EXPECT_GT(num_tagged, 0u);
+}
+
 TEST(VulkanComputeGraphTest, test_simple_shared_objects_with_resize) {
   GraphConfig config;
   ComputeGraph graph(config);
@@ -1715,6 +2182,63 @@ TEST(VulkanComputeGraphTest, test_simple_shared_objects_with_resize) {
   }
 }
 
+TEST(VulkanComputeGraphTest, test_resize_reuses_command_buffer) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {12, 64, 64};
+  std::vector<int64_t> size_small = {12, 64, 1};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  IOValueRef out = {};
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  // Texture binary ops pass the sizes of their arguments as push constants
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Run graph
+
+  std::vector<std::vector<int64_t>> new_sizes_list = {
+      {8, 44, 34}, {8, 44, 34}, {4, 13, 56}, {12, 64, 64}, {12, 64, 64}};
+  std::vector<size_t> expected_num_reencodes = {1, 1, 2, 3, 3};
+
+  for (size_t i = 0; i < new_sizes_list.size(); ++i) {
+    std::vector<int64_t> new_sizes = new_sizes_list[i];
+    graph.resize_input(0, new_sizes);
+    new_sizes.back() = 1;
+    graph.resize_input(1, new_sizes);
+    graph.propagate_resize();
+
+    // Resizing to the same sizes again keeps the encoded command buffer
+    EXPECT_EQ(graph.num_reencodes(), expected_num_reencodes[i]);
+
+    float val_a = new_sizes[1] + 2.0f;
+    float val_b = new_sizes[0] + 1.5f;
+    float val_out = val_a + val_b;
+
+    fill_vtensor(graph, a, val_a);
+    fill_vtensor(graph, b, val_b);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t j = 0; j < graph.get_tensor(out.value)->numel(); ++j) {
+      CHECK_VALUE(data_out, j, val_out);
+    }
+  }
+}
+
 TEST(VulkanComputeGraphTest, test_simple_graph_with_tmp_tensors) {
   GraphConfig config;
   ComputeGraph graph(config);
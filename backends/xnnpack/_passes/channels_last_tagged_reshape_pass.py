@@ -58,6 +58,7 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
         "output",
         exir_ops.edge.aten.squeeze_copy.dim,
         exir_ops.edge.aten.unsqueeze_copy.default,
+        exir_ops.edge.aten.view_copy.default,
     }
 
     # Tag which is added to a node's meta to indicate that it uses NHWC format.
@@ -0,0 +1,81 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Dict
+
+import torch
+from executorch.backends.xnnpack.operators.node_visitor import (
+    NodeVisitor,
+    register_node_visitor,
+)
+from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNGraph,
+    XNNStaticReshape,
+    XNode,
+)
+
+from executorch.backends.xnnpack.utils.utils import check_or_raise, get_input_node
+from torch.fx.experimental.symbolic_shapes import free_symbols
+
+
+@register_node_visitor
+class ViewCopyVisitor(NodeVisitor):
+    """
+    Lowers view_copy to a reshape, so that views between XNNPACK ops don't
+    split the graph into several delegates.
+    """
+
+    target = "aten.view_copy.default"
+
+    def __init__(self, *args) -> None:
+        super().__init__(*args)
+
+    def define_node(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        self.define_nodes_tensor_inputs_outputs(node, xnn_graph, vals_to_ids)
+        input_node = get_input_node(node, 0)
+
+        # input
+        input_id = vals_to_ids[input_node]
+
+        # output
+        output_id = vals_to_ids[node]
+
+        check_or_raise(
+            "val" in node.meta,
+            "Missing val in tensor metadata for output when serializing XNNStaticReshape node",
+        )
+        # XNNPACK infers the size of a dim given as 0 from the others.
+        new_shape = []
+        num_dynamic_dims = 0
+        for dim in node.meta["val"].shape:
+            if free_symbols(dim):
+                num_dynamic_dims += 1
+                new_shape.append(0)
+            else:
+                new_shape.append(dim)
+
+        check_or_raise(
+            num_dynamic_dims <= 1,
+            "XNNPACK reshape only supports 1 dynamic dimension",
+        )
+
+        ser_node = XNode(
+            xnode_union=XNNStaticReshape(
+                num_dims=len(new_shape),
+                new_shape=new_shape,
+                input_id=input_id,
+                output_id=output_id,
+                flags=0,
+            ),
+            debug_handle=debug_handle,
+        )
+        xnn_graph.xnodes.append(ser_node)
@@ -475,6 +475,39 @@ class SliceCopyConfig(GenericNodePartitionerConfig):
         return [ConfigPrecisionType.FP32, ConfigPrecisionType.STATIC_QUANT]
 
 
+class ViewCopyConfig(GenericNodePartitionerConfig):
+    target_name = "view_copy.default"
+
+    def check_constraints(self, node: torch.fx.Node, ep: ExportedProgram) -> bool:
+        """
+        XNNPACK's reshape infers at most one dynamic dim, and doesn't support
+        zero-dim tensors
+        """
+        if not self.check_common_constraints(node, ep):
+            return False
+
+        output_shape = list(node.meta["val"].shape)
+        num_dynamic_dims = 0
+        for dim in output_shape:
+            if not isinstance(dim, int):
+                num_dynamic_dims += 1
+            elif dim == 0:
+                why(node, reason="zero-dim tensors are not supported")
+                return False
+
+        if num_dynamic_dims > 1:
+            why(
+                node,
+                reason=f"only one dynamic dim is supported, got {num_dynamic_dims}",
+            )
+            return False
+
+        return True
+
+    def supported_precision_types(self) -> List[ConfigPrecisionType]:
+        return [ConfigPrecisionType.FP32]
+
+
 class SquareRootConfig(GenericNodePartitionerConfig):
     target_name = "sqrt.default"
 
@@ -7,6 +7,7 @@
 import itertools
 
 import logging
+import struct
 from typing import List, Optional, Type, Union
 
 from executorch.backends.xnnpack.partition.config import ALL_PARTITIONER_CONFIGS
@@ -17,6 +18,7 @@ from executorch.backends.xnnpack.partition.config.xnnpack_config import (
 
 from executorch.backends.xnnpack.xnnpack_preprocess import XnnpackBackend
 from executorch.exir.backend.backend_details import ExportedProgram
+from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.backend.canonical_partitioners.config_partitioner import (
     ConfigerationBasedPartitioner,
 )
@@ -36,17 +38,37 @@ class XnnpackPartitioner(ConfigerationBasedPartitioner):
         ] = None,
         per_op_mode=False,
         verbose: bool = False,
+        fp16_inference: bool = False,
+        sparse_inference_threshold: Optional[float] = None,
         **kwargs,
     ):
         """
         @verbose: if True, print out more information about the partitioner.
             Default level is WARNING. If verbose is True, level is set to DEBUG.
+        @fp16_inference: if True, the delegates run their fp32 graphs in fp16 on
+            CPUs with native fp16 arithmetic, and in fp32 elsewhere.
+        @sparse_inference_threshold: if set, the delegates run their 1x1
+            convolutions with sparse microkernels when at least this fraction of
+            their weights are zeros, as checked when the model is loaded.
         """
         if verbose:
             logger.setLevel(logging.DEBUG)
             logger.debug("Verbose logging enabled for XNNPACK partitioner.")
 
-        delegation_spec = DelegationSpec(XnnpackBackend.__name__, [])
+        compile_specs = []
+        if fp16_inference:
+            compile_specs.append(CompileSpec("fp16_inference", bytes([1])))
+        if sparse_inference_threshold is not None:
+            assert (
+                0 < sparse_inference_threshold <= 1
+            ), f"Invalid sparse_inference_threshold {sparse_inference_threshold}"
+            compile_specs.append(
+                CompileSpec(
+                    "sparse_inference_threshold",
+                    struct.pack("<f", sparse_inference_threshold),
+                )
+            )
+        delegation_spec = DelegationSpec(XnnpackBackend.__name__, compile_specs)
         configs_to_use = configs or ALL_PARTITIONER_CONFIGS
         # Can do logic and have extra args to filter/delete/select
         # Certain configs based on user specification
@@ -11,8 +11,12 @@
 #include <executorch/backends/xnnpack/serialization/schema_generated.h>
 #include <executorch/extension/threadpool/threadpool.h>
 #include <executorch/runtime/executor/pte_data_map.h>
+#include <cstring>
+#include <map>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #pragma clang diagnostic ignored "-Wmissing-prototypes"
@@ -236,7 +240,8 @@ Error defineTensor(
     CompileAllocator& allocator,
     const NamedDataMap* named_data_map,
     std::vector<FreeableBuffer>& freeable_buffers,
-    XNNWeightsCache* weights_cache) {
+    XNNWeightsCache* weights_cache,
+    std::unordered_map<uint32_t, const float*>& fp32_constants) {
   const fb_xnnpack::XNNTensorValue* tensor_value = nullptr;
   const fb_xnnpack::XNNQuantizedTensorValue* qtensor_value = nullptr;
 
@@ -280,6 +285,11 @@ Error defineTensor(
       named_data_map,
       freeable_buffers,
       weights_cache);
+  if (buffer_ptr != nullptr && qtensor_value == nullptr &&
+      tensor_value->datatype() == fb_xnnpack::XNNDatatype::xnn_datatype_fp32) {
+    fp32_constants.emplace(
+        tensor_value->id_out(), reinterpret_cast<const float*>(buffer_ptr));
+  }
 
   xnn_status status;
   // The type we might have to convert to
@@ -1948,6 +1958,246 @@ Error defineNotImplementedNode(
       fb_xnnpack::EnumNameXNodeUnion(node->xnode_union_type()));
 }
 
+#if defined(ENABLE_XNNPACK_PROFILING) || defined(ET_EVENT_TRACER_ENABLED)
+/*
+Matches DEFAULT_DEBUG_HANDLE in xnnpack_preprocess.py, which is given to the
+nodes that don't come from a node of the delegated graph.
+*/
+constexpr uint32_t kDefaultDebugHandle = 65535;
+
+using TensorValuePtr = const fb_xnnpack::XNNTensorValue*;
+
+TensorValuePtr getTensorValue(ValuePtr value) {
+  switch (value->xvalue_union_type()) {
+    case fb_xnnpack::XValueUnion::XNNTensorValue:
+      return value->xvalue_union_as_XNNTensorValue();
+    case fb_xnnpack::XValueUnion::XNNQuantizedTensorValue:
+      return value->xvalue_union_as_XNNQuantizedTensorValue()->tensor_value();
+    default:
+      return nullptr;
+  }
+}
+
+uint64_t numelOf(TensorValuePtr value) {
+  uint64_t numel = 1;
+  if (value != nullptr && value->dims() != nullptr) {
+    for (auto dim : *value->dims()) {
+      numel *= dim;
+    }
+  }
+  return numel;
+}
+
+uint64_t bitsPerElement(DataType data_type) {
+  switch (data_type) {
+    case DataType::xnn_datatype_fp16:
+      return 16;
+    case DataType::xnn_datatype_qint8:
+    case DataType::xnn_datatype_quint8:
+    case DataType::xnn_datatype_qcint8:
+    case DataType::xnn_datatype_qdint8:
+      return 8;
+    case DataType::xnn_datatype_qcint4:
+    case DataType::xnn_datatype_qbint4:
+      return 4;
+    default:
+      return 32;
+  }
+}
+
+/*
+Returns the bytes of value if it's a constant, e.g. a weight or a bias.
+*/
+uint64_t constantBytes(
+    const std::unordered_map<uint32_t, TensorValuePtr>& values,
+    uint32_t id) {
+  auto it = values.find(id);
+  if (it == values.end() || it->second->constant_buffer_idx() == 0) {
+    return 0;
+  }
+  return (numelOf(it->second) * bitsPerElement(it->second->datatype()) + 7) /
+      8;
+}
+
+/*
+Describes a node for the profiler, with a rough count of its operations from
+the serialized shapes, which are upper bounds for dynamic ones.
+*/
+profiling::XNNNodeInfo getNodeProfilingInfo(
+    const NodePtr node,
+    const std::unordered_map<uint32_t, TensorValuePtr>& values) {
+  // The names of the union types are "XNN" and the node type.
+  const char* type_name =
+      fb_xnnpack::EnumNameXNodeUnion(node->xnode_union_type());
+  if (strncmp(type_name, "XNN", 3) == 0) {
+    type_name += 3;
+  }
+  profiling::XNNNodeInfo info = {
+      node->debug_handle() == kDefaultDebugHandle
+          ? executorch::runtime::kUnsetDebugHandle
+          : static_cast<executorch::runtime::DebugHandle>(
+                node->debug_handle()),
+      type_name,
+      /*flops=*/0,
+      /*weight_bytes=*/0};
+  auto tensor = [&](uint32_t id) -> TensorValuePtr {
+    auto it = values.find(id);
+    return it != values.end() ? it->second : nullptr;
+  };
+  auto last_dim = [](TensorValuePtr value, size_t from_end) -> uint64_t {
+    if (value == nullptr || value->dims() == nullptr ||
+        value->dims()->size() < from_end) {
+      return 0;
+    }
+    return value->dims()->Get(value->dims()->size() - from_end);
+  };
+
+  switch (node->xnode_union_type()) {
+    case fb_xnnpack::XNodeUnion::XNNFullyConnected: {
+      auto graph_node = node->xnode_union_as_XNNFullyConnected();
+      // The filter is [output_channels, input_channels] unless transposed.
+      const uint64_t input_channels = last_dim(
+          tensor(graph_node->filter_id()),
+          (graph_node->flags() & XNN_FLAG_TRANSPOSE_WEIGHTS) ? 2 : 1);
+      info.flops =
+          2 * numelOf(tensor(graph_node->output_id())) * input_channels;
+      info.weight_bytes = constantBytes(values, graph_node->filter_id()) +
+          constantBytes(values, graph_node->bias_id());
+      break;
+    }
+    case fb_xnnpack::XNodeUnion::XNNConv2d:
+    case fb_xnnpack::XNodeUnion::XNNDepthwiseConv2d:
+    case fb_xnnpack::XNodeUnion::XNNConvTranspose2d: {
+      auto graph_node =
+          static_cast<const fb_xnnpack::_XNNNodeConv*>(node->xnode_union());
+      const uint64_t kernel_size =
+          graph_node->kernel_height() * graph_node->kernel_width();
+      // Each output of a convolution, and each input of a deconvolution,
+      // takes a multiply-add per kernel element and channel of its group.
+      info.flops = node->xnode_union_type() ==
+              fb_xnnpack::XNodeUnion::XNNConvTranspose2d
+          ? 2 * numelOf(tensor(graph_node->input1_id())) * kernel_size *
+              graph_node->group_output_channels()
+          : 2 * numelOf(tensor(graph_node->output_id())) * kernel_size *
+              graph_node->group_input_channels();
+      info.weight_bytes = constantBytes(values, graph_node->filter_id()) +
+          constantBytes(values, graph_node->bias_id());
+      break;
+    }
+    case fb_xnnpack::XNodeUnion::XNNBatchMatrixMultiply: {
+      auto graph_node = node->xnode_union_as_XNNBatchMatrixMultiply();
+      info.flops = 2 * numelOf(tensor(graph_node->output_id())) *
+          last_dim(tensor(graph_node->input1_id()), 1);
+      info.weight_bytes = constantBytes(values, graph_node->input2_id());
+      break;
+    }
+    case fb_xnnpack::XNodeUnion::XNNAdd:
+    case fb_xnnpack::XNodeUnion::XNNDiv:
+    case fb_xnnpack::XNodeUnion::XNNMinimum:
+    case fb_xnnpack::XNodeUnion::XNNMaximum:
+    case fb_xnnpack::XNodeUnion::XNNMultiply:
+    case fb_xnnpack::XNodeUnion::XNNSubtract:
+    case fb_xnnpack::XNodeUnion::XNNPReLU: {
+      auto graph_node =
+          static_cast<const fb_xnnpack::_XNNNode2x1*>(node->xnode_union());
+      info.flops = numelOf(tensor(graph_node->output_id()));
+      info.weight_bytes = constantBytes(values, graph_node->input1_id()) +
+          constantBytes(values, graph_node->input2_id());
+      break;
+    }
+    case fb_xnnpack::XNodeUnion::XNNSoftmax:
+    case fb_xnnpack::XNodeUnion::XNNSigmoid:
+    case fb_xnnpack::XNodeUnion::XNNClamp:
+    case fb_xnnpack::XNodeUnion::XNNFloor:
+    case fb_xnnpack::XNodeUnion::XNNSquareRoot:
+    case fb_xnnpack::XNodeUnion::XNNReciprocalSquareRoot:
+    case fb_xnnpack::XNodeUnion::XNNCeiling:
+    case fb_xnnpack::XNodeUnion::XNNHardswish:
+    case fb_xnnpack::XNodeUnion::XNNNegate:
+    case fb_xnnpack::XNodeUnion::XNNSquare:
+    case fb_xnnpack::XNodeUnion::XNNAbs: {
+      auto graph_node =
+          static_cast<const fb_xnnpack::_XNNNode1x1*>(node->xnode_union());
+      info.flops = numelOf(tensor(graph_node->output_id()));
+      break;
+    }
+    default:
+      // Data movement, which we don't count.
+      break;
+  }
+  return info;
+}
+#endif
+
+/*
+Finds the converts that dynamically quantize a value in the same way as an
+earlier convert, which happens when several linears consume the same
+activation. Their outputs are remapped to the output of the first one, so
+that the activation is quantized once. Returns the converts to skip.
+*/
+std::unordered_set<NodePtr> dedupDynamicQuantizeNodes(
+    GraphPtr graph,
+    std::unordered_map<uint32_t, uint32_t>& remapped_ids) {
+  // The internal, dynamically quantized values
+  std::unordered_map<uint32_t, const fb_xnnpack::XNNQuantizedTensorValue*>
+      dq_values;
+  for (auto value : *graph->xvalues()) {
+    if (value->xvalue_union_type() !=
+        fb_xnnpack::XValueUnion::XNNQuantizedTensorValue) {
+      continue;
+    }
+    auto qtensor_value = value->xvalue_union_as_XNNQuantizedTensorValue();
+    auto tensor_value = qtensor_value->tensor_value();
+    if (qtensor_value->quant_params_type() ==
+            fb_xnnpack::XNNQuantParams::PerTokenDynamicQuant &&
+        tensor_value->external_id() == XNN_INVALID_VALUE_ID &&
+        tensor_value->flags() == 0) {
+      dq_values.emplace(tensor_value->id_out(), qtensor_value);
+    }
+  }
+
+  std::unordered_set<NodePtr> skipped_nodes;
+  if (dq_values.empty()) {
+    return skipped_nodes;
+  }
+  // (input id, datatype, num_nonbatch_dims, flags, qp8) -> first output id
+  std::map<std::tuple<uint32_t, int, int, uint32_t, bool>, uint32_t> converts;
+  for (auto node : *graph->xnodes()) {
+    if (node->xnode_union_type() != fb_xnnpack::XNodeUnion::XNNConvert) {
+      continue;
+    }
+    auto graph_node = node->xnode_union_as_XNNConvert();
+    auto output = dq_values.find(graph_node->output_id());
+    if (output == dq_values.end()) {
+      continue;
+    }
+    bool qp8 = false;
+#ifdef ENABLE_XNNPACK_KLEIDI
+    // The output layout depends on whether the consumers take QP8.
+    qp8 = isQP8(graph, node);
+#endif
+    auto key = std::make_tuple(
+        graph_node->input_id(),
+        static_cast<int>(output->second->tensor_value()->datatype()),
+        output->second->quant_params_as_PerTokenDynamicQuant()
+            ->num_nonbatch_dims(),
+        graph_node->flags(),
+        qp8);
+    auto first = converts.emplace(key, graph_node->output_id());
+    if (!first.second) {
+      remapped_ids[graph_node->output_id()] =
+          remapped_ids.at(first.first->second);
+      skipped_nodes.insert(node);
+      ET_LOG(
+          Debug,
+          "Reusing the dynamic quantization of value %u for node %u",
+          graph_node->input_id(),
+          node->debug_handle());
+    }
+  }
+  return skipped_nodes;
+}
+
 /*
 Returns the pointer to the defineNode function that handles the given
 XNode type
@@ -2010,13 +2260,53 @@ Builds the xnnpack runtime object using the buffer pointer. The buffer pointer
 must be a valid pointer to the serialized xnnpack object. It also fills the
 XNNExecutor object with the built xnn_runtime and the input/output ids.
 */
+/*
+Returns the fraction of zeros among the weights of the 1x1 fp32 convolutions,
+which XNNPACK can run with its sparse NCHW microkernels, or 0 if the graph has
+none. The convolutions must have static weights, no padding, unit strides and
+dilations and a single group, as XNNPACK requires.
+*/
+float getPointwiseConvSparsity(
+    GraphPtr flatbuffer_graph,
+    const std::unordered_map<uint32_t, const float*>& fp32_constants) {
+  uint64_t num_weights = 0;
+  uint64_t num_zeros = 0;
+  for (auto node : *flatbuffer_graph->xnodes()) {
+    if (node->xnode_union_type() != fb_xnnpack::XNodeUnion::XNNConv2d) {
+      continue;
+    }
+    auto graph_node = node->xnode_union_as_XNNConv2d();
+    const bool pointwise = graph_node->kernel_height() == 1 &&
+        graph_node->kernel_width() == 1 &&
+        graph_node->subsampling_height() == 1 &&
+        graph_node->subsampling_width() == 1 &&
+        graph_node->dilation_height() == 1 &&
+        graph_node->dilation_width() == 1 && graph_node->groups() == 1 &&
+        graph_node->padding_top() == 0 && graph_node->padding_right() == 0 &&
+        graph_node->padding_bottom() == 0 && graph_node->padding_left() == 0;
+    auto filter = fp32_constants.find(graph_node->filter_id());
+    if (!pointwise || filter == fp32_constants.end()) {
+      continue;
+    }
+    const uint64_t numel =
+        static_cast<uint64_t>(graph_node->group_output_channels()) *
+        graph_node->group_input_channels();
+    for (uint64_t i = 0; i < numel; ++i) {
+      num_zeros += filter->second[i] == 0.0f;
+    }
+    num_weights += numel;
+  }
+  return num_weights > 0 ? static_cast<float>(num_zeros) / num_weights : 0.0f;
+}
+
 ET_NODISCARD Error XNNCompiler::compileModel(
     const void* buffer_pointer,
     size_t num_bytes,
     XNNExecutor* executor,
     XNNWeightsCache* weights_cache,
-    xnn_workspace_t workspace,
-    const NamedDataMap* named_data_map) {
+    const NamedDataMap* named_data_map,
+    bool fp16_inference,
+    float sparse_inference_threshold) {
   Result<XNNHeader> header = XNNHeader::Parse(buffer_pointer, num_bytes);
   const uint8_t* flatbuffer_data = nullptr;
   const uint8_t* constant_data = nullptr;
@@ -2087,6 +2377,8 @@ ET_NODISCARD Error XNNCompiler::compileModel(
   // External Ids for inputs and outputs
   std::vector<uint32_t> input_ids;
   std::vector<uint32_t> output_ids;
+  // The data of the fp32 constants, by serialized id
+  std::unordered_map<uint32_t, const float*> fp32_constants;
   Error err = Error::Ok;
   for (auto value : *flatbuffer_graph->xvalues()) {
     err = defineTensor(
@@ -2100,25 +2392,68 @@ ET_NODISCARD Error XNNCompiler::compileModel(
         compile_allocator,
         named_data_map,
         unpacked_buffers,
-        weights_cache);
+        weights_cache,
+        fp32_constants);
 
     if (err != Error::Ok) {
       return err;
     }
   }
 
+  const std::unordered_set<NodePtr> skipped_nodes =
+      dedupDynamicQuantizeNodes(flatbuffer_graph, remapped_ids);
   for (auto node : *flatbuffer_graph->xnodes()) {
+    if (skipped_nodes.count(node) > 0) {
+      continue;
+    }
     err = getDefineNodeFunc(node->xnode_union_type())(
         subgraph.get(), remapped_ids, node, flatbuffer_graph);
     if (err != Error::Ok) {
       return err;
     }
   }
+
+#if defined(ENABLE_XNNPACK_PROFILING) || defined(ET_EVENT_TRACER_ENABLED)
+  {
+    // Describe the nodes for the profiler to attribute operators to.
+    std::unordered_map<uint32_t, TensorValuePtr> tensor_values;
+    for (auto value : *flatbuffer_graph->xvalues()) {
+      TensorValuePtr tensor_value = getTensorValue(value);
+      if (tensor_value != nullptr) {
+        tensor_values.emplace(tensor_value->id_out(), tensor_value);
+      }
+    }
+    std::vector<profiling::XNNNodeInfo> node_infos;
+    node_infos.reserve(flatbuffer_graph->xnodes()->size());
+    for (auto node : *flatbuffer_graph->xnodes()) {
+      node_infos.push_back(getNodeProfilingInfo(node, tensor_values));
+    }
+    executor->set_profiled_nodes(std::move(node_infos));
+  }
+#endif
   uint32_t runtime_flags = 0;
 
 #if defined(ENABLE_XNNPACK_PROFILING) || defined(ET_EVENT_TRACER_ENABLED)
   runtime_flags |= XNN_FLAG_BASIC_PROFILING;
 #endif
+  // Only a hint: XNNPACK keeps fp32 if the CPU has no native fp16 arithmetic.
+  // The fp16 weights are packed with different seeds than the fp32 ones, so
+  // the weights cache keeps them apart.
+  if (fp16_inference) {
+    runtime_flags |= XNN_FLAG_HINT_FP16_INFERENCE;
+  }
+  if (sparse_inference_threshold > 0) {
+    const float sparsity =
+        getPointwiseConvSparsity(flatbuffer_graph, fp32_constants);
+    if (sparsity >= sparse_inference_threshold) {
+      ET_LOG(
+          Info,
+          "Pointwise convolution weights are %.0f%% sparse, enabling sparse "
+          "inference",
+          sparsity * 100);
+      runtime_flags |= XNN_FLAG_HINT_SPARSE_INFERENCE;
+    }
+  }
 
   xnn_runtime_t runtime_ptr = nullptr;
 
@@ -2136,24 +2471,27 @@ ET_NODISCARD Error XNNCompiler::compileModel(
   xnn_weights_cache_t weights_cache_ptr = nullptr;
 #endif
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-  ET_CHECK_OR_RETURN_ERROR(
-      workspace != nullptr, Internal, "Failed to initialize XNNPACK workspace");
-  status = xnn_create_runtime_v4(
-      subgraph.get(),
-      weights_cache_ptr,
-      workspace,
-      ::executorch::extension::threadpool::get_pthreadpool(),
-      runtime_flags,
-      &runtime_ptr);
-#else
-  status = xnn_create_runtime_v3(
-      subgraph.get(),
-      weights_cache_ptr,
-      ::executorch::extension::threadpool::get_pthreadpool(),
-      runtime_flags,
-      &runtime_ptr);
-#endif
+  pthreadpool_t threadpool = executor->get_threadpool();
+  if (threadpool == nullptr) {
+    threadpool = ::executorch::extension::threadpool::get_pthreadpool();
+  }
+  const std::shared_ptr<XNNWorkspace>& workspace = executor->get_workspace();
+  if (workspace != nullptr) {
+    status = xnn_create_runtime_v4(
+        subgraph.get(),
+        weights_cache_ptr,
+        workspace->get(),
+        threadpool,
+        runtime_flags,
+        &runtime_ptr);
+  } else {
+    status = xnn_create_runtime_v3(
+        subgraph.get(),
+        weights_cache_ptr,
+        threadpool,
+        runtime_flags,
+        &runtime_ptr);
+  }
 
   ET_CHECK_OR_RETURN_ERROR(
       xnn_status_success == status,
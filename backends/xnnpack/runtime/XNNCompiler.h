@@ -22,14 +22,21 @@ class XNNCompiler {
  public:
   // Takes Flatbuffer Serialized XNNPACK Model and rebuilds the xnn-subgraph
   // returns an executor object that holds the xnn runtime object which we
-  // can then use to set inputs and run inference using the xnn graph.
+  // can then use to set inputs and run inference using the xnn graph. The
+  // runtime is created with the workspace and threadpool of the executor, see
+  // XNNExecutor::set_workspace_and_threadpool. With fp16_inference, XNNPACK
+  // runs the fp32 graph in fp16 if the CPU supports it natively. With a
+  // sparse_inference_threshold in (0, 1], it runs the 1x1 convolutions with
+  // its sparse microkernels if at least that fraction of their weights are
+  // zeros.
   ET_NODISCARD static executorch::runtime::Error compileModel(
       const void* buffer_pointer,
       size_t num_bytes,
       XNNExecutor* executor,
       XNNWeightsCache* weights_cache,
-      xnn_workspace_t workspace,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      bool fp16_inference = false,
+      float sparse_inference_threshold = 0.0f);
 };
 
 } // namespace delegate
@@ -8,6 +8,8 @@
 
 #include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
 
+#include <algorithm>
+
 namespace executorch {
 namespace backends {
 namespace xnnpack {
@@ -52,6 +54,9 @@ ET_NODISCARD Error XNNExecutor::initialize(
   std::sort(output_ids_.begin(), output_ids_.end());
 
   externals_.resize(input_ids_.size() + output_ids_.size());
+  input_shapes_.assign(input_ids_.size() * kInputShapeStride, 0);
+  needs_reshape_ = true;
+  needs_setup_ = true;
   packed_data_names_ = std::move(packed_data_names);
 
   return Error::Ok;
@@ -63,7 +68,8 @@ ET_NODISCARD Error XNNExecutor::initialize(
  * Creates an array of xnn_externals_values from the EValues passed in.
  * Reshapes all the external input tensors, in case any input shapes have
  * changed. The reshapes the entire runtime, propagating shape information
- * through the runtime.
+ * through the runtime. Both are skipped when the input shapes are the same as
+ * in the last reshape, e.g. for every decode step of an LLM.
  *
  * Note: the external ids given to the external tensors in the XNNPACK
  * runtime correspond to their index in the list of arg passed into
@@ -76,7 +82,7 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
       "XNNPACK Delegate did not compile correctly");
 
   // Create xnn_externals_value from evalue args
-  xnn_status status;
+  bool shapes_changed = needs_reshape_;
   for (uint32_t i = 0; i < externals_.size(); ++i) {
     if (i < input_ids_.size()) {
       externals_[i].id = input_ids_[i];
@@ -93,9 +99,13 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
         static_cast<uint32_t>(args[ext_id]->tag));
 
     Tensor* tensor = &args[ext_id]->toTensor();
-    externals_[i].data = tensor->mutable_data_ptr<float>();
+    void* data = tensor->mutable_data_ptr<float>();
+    if (externals_[i].data != data) {
+      externals_[i].data = data;
+      needs_setup_ = true;
+    }
 
-    // Reshape runtime inputs
+    // Record the shapes of runtime inputs
     if (i < input_ids_.size()) {
       size_t num_dims = tensor->dim();
       ET_CHECK_OR_RETURN_ERROR(
@@ -103,25 +113,43 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
           Internal,
           "Expecting default dim_order but got a non default dim_order tensor for external input %u",
           i);
-      size_t dims[XNN_MAX_TENSOR_DIMS];
       ET_CHECK_OR_RETURN_ERROR(
           num_dims <= XNN_MAX_TENSOR_DIMS,
           InvalidArgument,
           "XNNPACK backend accepts tensors with at most %d dims, but got %zu",
           XNN_MAX_TENSOR_DIMS,
           num_dims);
+      size_t* shape = input_shapes_.data() + i * kInputShapeStride;
+      if (shape[0] != num_dims) {
+        shape[0] = num_dims;
+        shapes_changed = true;
+      }
       for (int d = 0; d < num_dims; ++d) {
-        dims[d] = tensor->size(d);
+        const size_t dim = tensor->size(d);
+        if (shape[d + 1] != dim) {
+          shape[d + 1] = dim;
+          shapes_changed = true;
+        }
       }
-      status =
-          xnn_reshape_external_value(runtime_.get(), ext_id, num_dims, dims);
-      ET_CHECK_OR_RETURN_ERROR(
-          status == xnn_status_success,
-          Internal,
-          "Internal Error: Reshape Input Tensor Failed with code: %s",
-          xnn_status_to_string(status));
     }
   }
+  if (!shapes_changed) {
+    return Error::Ok;
+  }
+
+  // Reshape runtime inputs
+  needs_reshape_ = true;
+  xnn_status status;
+  for (uint32_t i = 0; i < input_ids_.size(); ++i) {
+    const size_t* shape = input_shapes_.data() + i * kInputShapeStride;
+    status = xnn_reshape_external_value(
+        runtime_.get(), externals_[i].id, shape[0], shape + 1);
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Internal Error: Reshape Input Tensor Failed with code: %s",
+        xnn_status_to_string(status));
+  }
   // // Propagate Input Shape and Memory Plan for increased allocation
   status = xnn_reshape_runtime(runtime_.get());
 
@@ -131,14 +159,20 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
       "Internal Error: Propagating input shapes failed with code: %s",
       xnn_status_to_string(status));
 
+  needs_reshape_ = false;
+  needs_setup_ = true;
+  if (workspace_ != nullptr) {
+    workspace_->bump_generation();
+  }
   return Error::Ok;
 }
 
 /**
  * Runs the XNNPACK Runtime.
  *
- * We first setup the runtime by feeding the externals_ to runtime setup.
- * After which we then execute the runtime through invoke_runtime.
+ * We first setup the runtime by feeding the externals_ to runtime setup,
+ * unless nothing changed since the last setup. After which we then execute
+ * the runtime through invoke_runtime.
  */
 ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
   ET_CHECK_OR_RETURN_ERROR(
@@ -146,14 +180,27 @@ ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
       Internal,
       "XNNPACK Delegate did not compile correctly");
 
-  xnn_status status = xnn_setup_runtime_v2(
-      runtime_.get(), externals_.size(), externals_.data());
+  xnn_status status;
+  // Another runtime sharing the workspace may have grown it since this one
+  // was set up.
+  if (workspace_ != nullptr &&
+      setup_workspace_generation_ != workspace_->generation()) {
+    needs_setup_ = true;
+  }
+  if (needs_setup_) {
+    status = xnn_setup_runtime_v2(
+        runtime_.get(), externals_.size(), externals_.data());
 
-  ET_CHECK_OR_RETURN_ERROR(
-      status == xnn_status_success,
-      Internal,
-      "Internal Error: Setting up the runtime failed with code: %s",
-      xnn_status_to_string(status));
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Internal Error: Setting up the runtime failed with code: %s",
+        xnn_status_to_string(status));
+    needs_setup_ = false;
+    if (workspace_ != nullptr) {
+      setup_workspace_generation_ = workspace_->generation();
+    }
+  }
 
   auto error = profiler_.start(context.event_tracer());
   if (error != Error::Ok) {
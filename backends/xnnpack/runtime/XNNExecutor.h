@@ -9,11 +9,13 @@
 #pragma once
 
 #include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/backends/xnnpack/runtime/profiling/XNNProfiler.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 
+#include <pthreadpool.h>
 #include <xnnpack.h>
 #include <map>
 #include <memory>
@@ -25,7 +27,17 @@ namespace xnnpack {
 namespace delegate {
 
 class XNNExecutor {
+ public:
+  using ThreadpoolPtr =
+      std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)>;
+
  private:
+  // The workspace and threadpool the runtime is created with, if it doesn't
+  // have a workspace of its own or doesn't use the global threadpool. Declared
+  // before runtime_, which must be deleted first.
+  std::shared_ptr<XNNWorkspace> workspace_;
+  ThreadpoolPtr threadpool_{nullptr, &pthreadpool_destroy};
+
   std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_{
       nullptr,
       &xnn_delete_runtime};
@@ -35,6 +47,17 @@ class XNNExecutor {
   std::vector<uint32_t> output_ids_;
   std::vector<xnn_external_value> externals_;
   std::vector<std::string> packed_data_names_;
+  // Shapes of the inputs at the last reshape, kInputShapeStride entries per
+  // input: the number of dims followed by the dims.
+  std::vector<size_t> input_shapes_;
+  // Whether the runtime must be reshaped or set up again before the next
+  // forward(), because the input shapes or the data pointers changed
+  bool needs_reshape_ = true;
+  bool needs_setup_ = true;
+  // workspace_->generation() when the runtime was last set up
+  uint64_t setup_workspace_generation_ = 0;
+
+  static constexpr size_t kInputShapeStride = XNN_MAX_TENSOR_DIMS + 1;
 
  public:
   XNNExecutor() = default;
@@ -47,10 +70,46 @@ class XNNExecutor {
     return output_ids_.size();
   }
 
+  /**
+   * Sets the nodes of the graph for the profiler to attribute the XNNPACK
+   * operators to. Must be called before initialize.
+   */
+  inline void set_profiled_nodes(std::vector<profiling::XNNNodeInfo> nodes) {
+    profiler_.set_nodes(std::move(nodes));
+  }
+
   inline std::vector<std::string> get_packed_data_names() {
     return packed_data_names_;
   }
 
+  /**
+   * Sets the workspace and the threadpool to create the runtime with. Without
+   * a workspace the runtime gets one of its own, and without a threadpool it
+   * uses the global one. Must be called before the runtime is created.
+   */
+  inline void set_workspace_and_threadpool(
+      std::shared_ptr<XNNWorkspace> workspace,
+      ThreadpoolPtr threadpool) {
+    workspace_ = std::move(workspace);
+    threadpool_ = std::move(threadpool);
+  }
+
+  /**
+   * Returns the workspace shared with other executors, or null if the runtime
+   * has its own. The caller must hold its mutex while using the executor.
+   */
+  inline const std::shared_ptr<XNNWorkspace>& get_workspace() const {
+    return workspace_;
+  }
+
+  /**
+   * Returns the threadpool of this executor, or null if it uses the global
+   * one.
+   */
+  inline pthreadpool_t get_threadpool() const {
+    return threadpool_.get();
+  }
+
   /**
    * Initialize the XNNExecutor with a given runtime and input/output ids.
    * The input/output ids are expected to be sorted in order of their
@@ -66,13 +125,15 @@ class XNNExecutor {
    * Prepares the arguments for runtime graph execution.
    * args is an array of EValues that will be passed into the runtime.
    * input shapes will be propagated through the runtime, and perform
-   * any additional memory planning as needed
+   * any additional memory planning as needed. This is skipped when the input
+   * shapes are the same as in the previous call.
    */
   ET_NODISCARD executorch::runtime::Error prepare_args(
       executorch::runtime::EValue** args);
 
   /**
-   * Executes the graph using the args prepared at prepare_args().
+   * Executes the graph using the args prepared at prepare_args(). The runtime
+   * is only set up again if it was reshaped or the data pointers changed.
    */
   ET_NODISCARD executorch::runtime::Error forward(
       executorch::runtime::BackendExecutionContext& context);
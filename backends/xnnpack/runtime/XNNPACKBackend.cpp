@@ -7,21 +7,30 @@
  */
 
 #include <executorch/backends/xnnpack/runtime/XNNCompiler.h>
+#include <executorch/backends/xnnpack/runtime/XNNPACKBackend.h>
 #include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/executor/pte_data_map.h>
 
+#include <atomic>
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 
 #pragma clang diagnostic ignored "-Wglobal-constructors"
 
 namespace executorch {
 namespace backends {
 
+using executorch::backends::xnnpack::WorkspaceSharingMode;
+using executorch::backends::xnnpack::delegate::XNNExecutor;
 using executorch::backends::xnnpack::delegate::XNNWeightsCache;
+using executorch::backends::xnnpack::delegate::XNNWorkspace;
 using executorch::runtime::ArrayRef;
 using executorch::runtime::Backend;
 using executorch::runtime::BackendExecutionContext;
@@ -48,24 +57,6 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
           (unsigned int)status);
       return;
     }
-
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    // Create a workspace for the XNNExecutor to use. This workspace will be
-    // shared across all delegate instances.
-    ET_LOG(Debug, "Creating XNN workspace");
-    xnn_workspace_t workspace = nullptr;
-    status = xnn_create_workspace(&workspace);
-    if (status != xnn_status_success) {
-      ET_LOG(
-          Error,
-          "Failed to create XNN workspace, XNNPACK status: 0x%x",
-          (unsigned int)status);
-      workspace = nullptr;
-      return;
-    }
-    workspace_.reset(workspace);
-    ET_LOG(Debug, "Created XNN workspace: %p", workspace_.get());
-#endif // ENABLE_XNNPACK_SHARED_WORKSPACE
   }
 
   bool is_available() const override {
@@ -83,11 +74,53 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
     }
 
     const NamedDataMap* named_data_map = context.get_named_data_map();
-    // thread safe. This can heppen when multiple threads call init() on
-    // the same backend instance.
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
+
+    bool fp16_inference = fp16_inference_.load();
+    float sparse_inference_threshold = 0.0f;
+    for (const CompileSpec& spec : compile_specs) {
+      if (std::strcmp(spec.key, "fp16_inference") == 0) {
+        ET_CHECK_OR_RETURN_ERROR(
+            spec.value.nbytes == sizeof(uint8_t),
+            InvalidArgument,
+            "Unexpected size %zu of the fp16_inference compile spec",
+            spec.value.nbytes);
+        fp16_inference = fp16_inference ||
+            *static_cast<const uint8_t*>(spec.value.buffer) != 0;
+      }
+      if (std::strcmp(spec.key, "sparse_inference_threshold") == 0) {
+        ET_CHECK_OR_RETURN_ERROR(
+            spec.value.nbytes == sizeof(float),
+            InvalidArgument,
+            "Unexpected size %zu of the sparse_inference_threshold compile spec",
+            spec.value.nbytes);
+        std::memcpy(
+            &sparse_inference_threshold, spec.value.buffer, sizeof(float));
+      }
+    }
+
+    Result<std::shared_ptr<XNNWorkspace>> workspace =
+        get_or_create_workspace(context);
+    if (!workspace.ok()) {
+      return workspace.error();
+    }
+    XNNExecutor::ThreadpoolPtr threadpool{nullptr, &pthreadpool_destroy};
+    const uint32_t num_threads = delegate_num_threads_.load();
+    if (num_threads > 0) {
+      threadpool.reset(pthreadpool_create(num_threads));
+      if (threadpool == nullptr) {
+        ET_LOG(
+            Error, "Failed to create a threadpool of %u threads", num_threads);
+        return Error::Internal;
+      }
+    }
+
+    // Serializes the runtime creation with the other runtimes sharing the
+    // workspace, as XNNPACK doesn't make it thread safe. This can happen when
+    // multiple threads call init() on the same backend instance.
+    std::unique_lock<std::mutex> lock;
+    if (*workspace != nullptr) {
+      lock = std::unique_lock<std::mutex>((*workspace)->mutex());
+    }
 
 #ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
     const std::lock_guard<std::mutex> lock_weight_cache(weights_cache_mutex_);
@@ -100,13 +133,16 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
     // new and since this type is not trivially destructible, we must call the
     // destructor manually in destroy().
     new (executor) xnnpack::delegate::XNNExecutor;
+    executor->set_workspace_and_threadpool(
+        std::move(*workspace), std::move(threadpool));
     Error err = xnnpack::delegate::XNNCompiler::compileModel(
         processed->data(),
         processed->size(),
         executor,
         weights_cache_.get(),
-        workspace_.get(),
-        named_data_map);
+        named_data_map,
+        fp16_inference,
+        sparse_inference_threshold);
     // This backend does not need its processed data after compiling the model.
     processed->Free();
 
@@ -128,9 +164,10 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
       EValue** args) const override {
     auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
+    std::unique_lock<std::mutex> lock;
+    if (executor->get_workspace() != nullptr) {
+      lock = std::unique_lock<std::mutex>(executor->get_workspace()->mutex());
+    }
 
 #ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
     const std::lock_guard<std::mutex> lock_weights_cache(weights_cache_mutex_);
@@ -156,14 +193,17 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
 
   void destroy(DelegateHandle* handle) const override {
     if (handle != nullptr) {
+      auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+
       // This is needed to serialize access to xnn_delete_runtime which is not
       // thread safe. This can heppen when multiple threads call destroy() on
-      // the same backend instance.
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-      const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
-
-      auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+      // the same backend instance. The copy keeps the mutex alive until the
+      // executor, which may hold the last reference to the workspace, is gone.
+      const std::shared_ptr<XNNWorkspace> workspace = executor->get_workspace();
+      std::unique_lock<std::mutex> lock;
+      if (workspace != nullptr) {
+        lock = std::unique_lock<std::mutex>(workspace->mutex());
+      }
 
 #ifdef ENABLE_XNNPACK_PROFILING
       executor->print_avg_op_timings();
@@ -180,12 +220,96 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
     }
   }
 
+  Error set_weights_cache_file(const std::string& path) {
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    const std::lock_guard<std::mutex> lock_weights_cache(weights_cache_mutex_);
+    return weights_cache_->set_cache_file(path);
+#else
+    (void)path;
+    ET_LOG(
+        Error,
+        "Built without ENABLE_XNNPACK_WEIGHTS_CACHE, packed weights can't be persisted");
+    return Error::NotSupported;
+#endif
+  }
+
+  void set_workspace_sharing_mode(WorkspaceSharingMode mode) {
+    workspace_sharing_mode_.store(mode);
+  }
+
+  WorkspaceSharingMode get_workspace_sharing_mode() const {
+    return workspace_sharing_mode_.load();
+  }
+
+  void set_delegate_num_threads(uint32_t num_threads) {
+    delegate_num_threads_.store(num_threads);
+  }
+
+  void set_fp16_inference(bool enabled) {
+    fp16_inference_.store(enabled);
+  }
+
  private:
-  // This is a global workspace for all delegate instances.
-  mutable std::mutex workspace_mutex_;
-  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_{
-      nullptr,
-      &xnn_release_workspace};
+  // Returns the workspace for a delegate of the Method being initialized, or
+  // null if the delegate should have one of its own.
+  Result<std::shared_ptr<XNNWorkspace>> get_or_create_workspace(
+      BackendInitContext& context) const {
+    const std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    switch (workspace_sharing_mode_.load()) {
+      case WorkspaceSharingMode::Disabled:
+        return std::shared_ptr<XNNWorkspace>();
+      case WorkspaceSharingMode::Global: {
+        if (global_workspace_ == nullptr) {
+          Result<std::shared_ptr<XNNWorkspace>> workspace =
+              XNNWorkspace::create();
+          if (!workspace.ok()) {
+            return workspace.error();
+          }
+          global_workspace_ = std::move(*workspace);
+        }
+        return global_workspace_;
+      }
+      case WorkspaceSharingMode::PerMethod: {
+        // The delegates of a Method share its runtime allocator.
+        for (auto it = method_workspaces_.begin();
+             it != method_workspaces_.end();) {
+          it = it->second.expired() ? method_workspaces_.erase(it) : ++it;
+        }
+        const void* key = context.get_runtime_allocator();
+        auto it = method_workspaces_.find(key);
+        if (it != method_workspaces_.end()) {
+          return it->second.lock();
+        }
+        Result<std::shared_ptr<XNNWorkspace>> workspace =
+            XNNWorkspace::create();
+        if (!workspace.ok()) {
+          return workspace.error();
+        }
+        method_workspaces_.emplace(key, *workspace);
+        return std::move(*workspace);
+      }
+    }
+    ET_LOG(Error, "Unknown workspace sharing mode");
+    return Error::InvalidArgument;
+  }
+
+  // Only apply to the delegates initialized after they are set.
+#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
+  std::atomic<WorkspaceSharingMode> workspace_sharing_mode_{
+      WorkspaceSharingMode::Global};
+#else
+  std::atomic<WorkspaceSharingMode> workspace_sharing_mode_{
+      WorkspaceSharingMode::Disabled};
+#endif
+  std::atomic<uint32_t> delegate_num_threads_{0};
+  std::atomic<bool> fp16_inference_{false};
+
+  // The workspaces shared by the delegates. Each one has a mutex serializing
+  // the delegates using it.
+  mutable std::mutex workspaces_mutex_;
+  mutable std::shared_ptr<XNNWorkspace> global_workspace_;
+  mutable std::unordered_map<const void*, std::weak_ptr<XNNWorkspace>>
+      method_workspaces_;
 
   // Weights cache is global to all delegate instances.
   mutable std::mutex weights_cache_mutex_;
@@ -193,7 +317,8 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
       std::make_unique<XNNWeightsCache>();
 
   // Lock Hiearchy for Mutexes:
-  // workspace_mutex_
+  // workspaces_mutex_ (never held with the others)
+  // XNNWorkspace::mutex()
   // weights_cache_mutex_
 };
 
@@ -203,5 +328,31 @@ Backend backend{"XnnpackBackend", &cls};
 static auto success_with_compiler = register_backend(backend);
 } // namespace
 
+namespace xnnpack {
+
+Error set_weights_cache_file(const char* path) {
+  ET_CHECK_OR_RETURN_ERROR(
+      path != nullptr, InvalidArgument, "The cache file path is null");
+  return cls.set_weights_cache_file(path);
+}
+
+void set_workspace_sharing_mode(WorkspaceSharingMode mode) {
+  cls.set_workspace_sharing_mode(mode);
+}
+
+WorkspaceSharingMode get_workspace_sharing_mode() {
+  return cls.get_workspace_sharing_mode();
+}
+
+void set_delegate_num_threads(uint32_t num_threads) {
+  cls.set_delegate_num_threads(num_threads);
+}
+
+void set_fp16_inference(bool enabled) {
+  cls.set_fp16_inference(enabled);
+}
+
+} // namespace xnnpack
+
 } // namespace backends
 } // namespace executorch
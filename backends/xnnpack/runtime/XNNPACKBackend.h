@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/compiler.h>
+
+#include <cstdint>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+
+/**
+ * Persists the weights packed by the XNNPACK backend to the file at path.
+ * Later processes map the packed weights from the file instead of packing
+ * them again on every load, which saves seconds of load time for large
+ * models. See XNNWeightsCache::set_cache_file for how the file is kept up to
+ * date.
+ *
+ * Needs the backend to be built with the weights cache, i.e. with
+ * EXECUTORCH_XNNPACK_ENABLE_WEIGHT_CACHE, and must be called before loading
+ * the first method that uses XNNPACK.
+ *
+ * @param[in] path The file to read and write the packed weights from.
+ * @returns Error::NotSupported if the weights cache is disabled.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error set_weights_cache_file(
+    const char* path);
+
+/**
+ * How XNNPACK delegates share workspaces, the memory for the intermediate
+ * values of their runtimes. Delegates sharing a workspace use less memory but
+ * run one at a time.
+ */
+enum class WorkspaceSharingMode : uint8_t {
+  /// Each delegate has a workspace of its own and never waits for others.
+  Disabled,
+  /// The delegates of a Method share a workspace, so delegates of different
+  /// Methods, e.g. models running on different threads, don't wait for each
+  /// other.
+  PerMethod,
+  /// All the delegates share one workspace.
+  Global,
+};
+
+/**
+ * Sets how the delegates initialized from now on share workspaces. Defaults to
+ * Global when built with ENABLE_XNNPACK_SHARED_WORKSPACE, and to Disabled
+ * otherwise.
+ */
+ET_EXPERIMENTAL void set_workspace_sharing_mode(WorkspaceSharingMode mode);
+
+ET_EXPERIMENTAL WorkspaceSharingMode get_workspace_sharing_mode();
+
+/**
+ * Gives each delegate initialized from now on a threadpool of its own with
+ * num_threads threads, so that delegates running on different threads don't
+ * contend for the global threadpool. 0, the default, goes back to the global
+ * threadpool of extension/threadpool.
+ */
+ET_EXPERIMENTAL void set_delegate_num_threads(uint32_t num_threads);
+
+/**
+ * Lets the delegates initialized from now on run their fp32 graphs in fp16 on
+ * CPUs with native fp16 arithmetic, e.g. ARMv8.2 cores, by creating their
+ * runtimes with XNN_FLAG_HINT_FP16_INFERENCE. The weights are then packed in
+ * fp16, while inputs and outputs stay fp32. CPUs without native fp16 keep
+ * running in fp32, so the same model can enable it everywhere. A delegate can
+ * also be exported with it enabled, with the "fp16_inference" compile spec.
+ */
+ET_EXPERIMENTAL void set_fp16_inference(bool enabled);
+
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
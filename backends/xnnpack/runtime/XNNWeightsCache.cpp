@@ -9,11 +9,24 @@
 #include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/memory_allocator.h>
+#include <cpuinfo.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <xnnpack.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <vector>
 
+// Identifies the XNNPACK the packed weights in a cache file were packed with.
+// Set by the build, e.g. to the commit of the XNNPACK submodule.
+#ifndef XNNPACK_VERSION
+#define XNNPACK_VERSION "unknown"
+#endif
+
 namespace executorch {
 namespace backends {
 namespace xnnpack {
@@ -22,6 +35,93 @@ namespace delegate {
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::NamedDataMap;
 
+namespace {
+
+// A cache file starts with kCacheFileMagic, the size of the fingerprint and
+// the fingerprint. Then come the records of the packed data: the size of the
+// name, the size of the data, the name and the data. The header, the records
+// and the data in them are aligned to kPackedAllocationAlignment, so that the
+// data can be used right from a mapping of the file.
+constexpr char kCacheFileMagic[8] = {'E', 'T', 'X', 'N', 'N', 'W', 'C', '2'};
+constexpr size_t kCacheFileAlignment =
+    XNNWeightsCache::kPackedAllocationAlignment;
+
+size_t align_to_cache_file(size_t n) {
+  return (n + kCacheFileAlignment - 1) / kCacheFileAlignment *
+      kCacheFileAlignment;
+}
+
+// Packed weights depend on the XNNPACK version and on the microkernels it
+// picks for the CPU, so a cache file is only used when both match.
+std::string cache_file_fingerprint() {
+  std::string fingerprint = "xnnpack=" XNNPACK_VERSION;
+#ifdef ENABLE_XNNPACK_KLEIDI
+  fingerprint += ";kleidi";
+#endif
+  fingerprint += ";pointer_size=" + std::to_string(sizeof(void*));
+  if (!cpuinfo_initialize()) {
+    fingerprint += ";isa=unknown";
+    return fingerprint;
+  }
+  const std::pair<const char*, bool (*)()> isa_features[] = {
+      {"avx", cpuinfo_has_x86_avx},
+      {"avx2", cpuinfo_has_x86_avx2},
+      {"fma3", cpuinfo_has_x86_fma3},
+      {"f16c", cpuinfo_has_x86_f16c},
+      {"avx512f", cpuinfo_has_x86_avx512f},
+      {"avx512bw", cpuinfo_has_x86_avx512bw},
+      {"avx512vl", cpuinfo_has_x86_avx512vl},
+      {"avx512vnni", cpuinfo_has_x86_avx512vnni},
+      {"avx512bf16", cpuinfo_has_x86_avx512bf16},
+      {"avxvnni", cpuinfo_has_x86_avxvnni},
+      {"neon", cpuinfo_has_arm_neon},
+      {"neon_fp16_arith", cpuinfo_has_arm_neon_fp16_arith},
+      {"neon_dot", cpuinfo_has_arm_neon_dot},
+      {"neon_bf16", cpuinfo_has_arm_neon_bf16},
+      {"i8mm", cpuinfo_has_arm_i8mm},
+      {"sve", cpuinfo_has_arm_sve},
+      {"sve2", cpuinfo_has_arm_sve2},
+  };
+  fingerprint += ";isa=";
+  for (const auto& feature : isa_features) {
+    if (feature.second()) {
+      fingerprint += feature.first;
+      fingerprint += ",";
+    }
+  }
+  return fingerprint;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t written = ::write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += written;
+    size -= written;
+  }
+  return true;
+}
+
+// Writes data and pads it up to the alignment of the cache file.
+bool write_aligned(int fd, const void* data, size_t size, size_t& offset) {
+  static const char kPadding[kCacheFileAlignment] = {};
+  const size_t end = align_to_cache_file(offset + size);
+  if (!write_all(fd, data, size) ||
+      !write_all(fd, kPadding, end - offset - size)) {
+    return false;
+  }
+  offset = end;
+  return true;
+}
+
+} // namespace
+
 XNNWeightsCache::XNNWeightsCache() {
   weights_cache_.context = this;
   weights_cache_.look_up = (size_t(*)(
@@ -38,6 +138,159 @@ XNNWeightsCache::XNNWeightsCache() {
       (enum xnn_status(*)(void*))XNNWeightsCache::delete_cache;
 }
 
+XNNWeightsCache::~XNNWeightsCache() {
+  if (cache_file_data_ != nullptr) {
+    munmap(cache_file_data_, cache_file_mapped_size_);
+  }
+}
+
+Error XNNWeightsCache::set_cache_file(const std::string& path) {
+  ET_CHECK_OR_RETURN_ERROR(
+      cache_file_path_.empty() && name_to_packed_data_metadata_.empty(),
+      InvalidState,
+      "The cache file must be set once, before any weights are packed");
+  ET_CHECK_OR_RETURN_ERROR(
+      !path.empty(), InvalidArgument, "The cache file path is empty");
+  cache_file_path_ = path;
+  load_cache_file();
+  return Error::Ok;
+}
+
+void XNNWeightsCache::load_cache_file() {
+  const int fd = ::open(cache_file_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    // Nothing has been cached yet.
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return;
+  }
+  const size_t file_size = st.st_size;
+  void* data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    ET_LOG(
+        Error,
+        "Failed to map the weights cache file %s: %s",
+        cache_file_path_.c_str(),
+        strerror(errno));
+    return;
+  }
+
+  const uint8_t* const base = static_cast<const uint8_t*>(data);
+  const std::string fingerprint = cache_file_fingerprint();
+  const size_t header_size = align_to_cache_file(
+      sizeof(kCacheFileMagic) + sizeof(uint64_t) + fingerprint.size());
+  uint64_t fingerprint_size = 0;
+  if (file_size >= header_size) {
+    memcpy(&fingerprint_size, base + sizeof(kCacheFileMagic), sizeof(uint64_t));
+  }
+  if (file_size < header_size ||
+      memcmp(base, kCacheFileMagic, sizeof(kCacheFileMagic)) != 0 ||
+      fingerprint_size != fingerprint.size() ||
+      memcmp(
+          base + sizeof(kCacheFileMagic) + sizeof(uint64_t),
+          fingerprint.data(),
+          fingerprint.size()) != 0) {
+    ET_LOG(
+        Info,
+        "Weights cache file %s was written by another XNNPACK or CPU, it will be rewritten",
+        cache_file_path_.c_str());
+    munmap(data, file_size);
+    return;
+  }
+
+  size_t offset = header_size;
+  while (offset + 2 * sizeof(uint64_t) <= file_size) {
+    uint64_t name_size = 0;
+    uint64_t data_size = 0;
+    memcpy(&name_size, base + offset, sizeof(uint64_t));
+    memcpy(&data_size, base + offset + sizeof(uint64_t), sizeof(uint64_t));
+    if (name_size > file_size || data_size > file_size) {
+      break;
+    }
+    const size_t name_offset = offset + 2 * sizeof(uint64_t);
+    const size_t data_offset = align_to_cache_file(name_offset + name_size);
+    const size_t end = align_to_cache_file(data_offset + data_size);
+    if (end > file_size) {
+      // The last write was interrupted.
+      break;
+    }
+    std::string name(
+        reinterpret_cast<const char*>(base + name_offset), name_size);
+    cache_file_entries_[name] = base + data_offset;
+    cache_file_names_.insert(std::move(name));
+    offset = end;
+  }
+  cache_file_data_ = data;
+  cache_file_mapped_size_ = file_size;
+  cache_file_size_ = offset;
+}
+
+Error XNNWeightsCache::append_to_cache_file() {
+  if (pending_packed_data_.empty()) {
+    return Error::Ok;
+  }
+  const int fd = ::open(cache_file_path_.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (fd < 0) {
+    ET_LOG(
+        Error,
+        "Failed to open the weights cache file %s: %s",
+        cache_file_path_.c_str(),
+        strerror(errno));
+    return Error::AccessFailed;
+  }
+
+  // Drop what follows the valid records, or the whole file if it's stale. This
+  // never touches the mapped records.
+  size_t offset = cache_file_size_;
+  bool ok = ftruncate(fd, offset) == 0 &&
+      lseek(fd, offset, SEEK_SET) == static_cast<off_t>(offset);
+  if (ok && offset == 0) {
+    const std::string fingerprint = cache_file_fingerprint();
+    const uint64_t fingerprint_size = fingerprint.size();
+    ok = write_all(fd, kCacheFileMagic, sizeof(kCacheFileMagic)) &&
+        write_all(fd, &fingerprint_size, sizeof(fingerprint_size));
+    offset = sizeof(kCacheFileMagic) + sizeof(fingerprint_size);
+    ok = ok &&
+        write_aligned(fd, fingerprint.data(), fingerprint.size(), offset);
+  }
+  for (size_t i = 0; ok && i < pending_packed_data_.size(); ++i) {
+    const PendingPackedData& packed_data = pending_packed_data_[i];
+    const uint64_t sizes[2] = {packed_data.name.size(), packed_data.size};
+    ok = write_all(fd, sizes, sizeof(sizes));
+    offset += sizeof(sizes);
+    ok = ok &&
+        write_aligned(
+             fd, packed_data.name.data(), packed_data.name.size(), offset) &&
+        write_aligned(fd, packed_data.data, packed_data.size, offset);
+  }
+  if (!ok) {
+    ET_LOG(
+        Error,
+        "Failed to write the weights cache file %s: %s",
+        cache_file_path_.c_str(),
+        strerror(errno));
+    // Leave the file as it was, so that the next load doesn't have to drop it.
+    if (ftruncate(fd, cache_file_size_) != 0) {
+      ET_LOG(Error, "Failed to restore the weights cache file");
+    }
+    ::close(fd);
+    pending_packed_data_.clear();
+    return Error::AccessFailed;
+  }
+  ::close(fd);
+
+  cache_file_size_ = offset;
+  for (const PendingPackedData& packed_data : pending_packed_data_) {
+    cache_file_names_.insert(packed_data.name);
+  }
+  pending_packed_data_.clear();
+  return Error::Ok;
+}
+
 Error XNNWeightsCache::initialize_for_runtime(
     MemoryAllocator* runtime_allocator,
     const NamedDataMap* named_data_map) {
@@ -59,6 +312,12 @@ Result<std::vector<std::string>> XNNWeightsCache::finalize_for_runtime() {
   unpacked_data_.clear();
   unpacked_data_to_name_.clear();
 
+  if (!cache_file_path_.empty()) {
+    // Failing to persist the packed data only means packing it again next
+    // time, so this doesn't fail the runtime.
+    append_to_cache_file();
+  }
+
   std::vector<std::string> packed_data_names;
   // update the reference count of all the packed data
   // used by this runtime
@@ -122,33 +381,52 @@ Error XNNWeightsCache::delete_packed_data(
   return Error::Ok;
 }
 
+std::string XNNWeightsCache::get_packed_data_name(
+    const xnn_weights_cache_look_up_key* cache_key) const {
+  auto entry = unpacked_data_to_name_.find(cache_key->kernel);
+  if (entry == unpacked_data_to_name_.end()) {
+    return std::string();
+  }
+  std::string name = entry->second;
+  if (cache_key->bias != nullptr) {
+    auto bias_entry = unpacked_data_to_name_.find(cache_key->bias);
+    if (bias_entry != unpacked_data_to_name_.end()) {
+      name.append(bias_entry->second);
+    }
+  }
+  // The same weights are packed differently for different operators and
+  // microkernels, which XNNPACK tells apart by the seed.
+  char seed[16];
+  snprintf(seed, sizeof(seed), "#%08x", (unsigned int)cache_key->seed);
+  name.append(seed);
+  return name;
+}
+
 size_t XNNWeightsCache::look_up(
     XNNWeightsCache* context,
     const xnn_weights_cache_look_up_key* cache_key) {
-  const void* unpacked_weights_ptr = cache_key->kernel;
-  const void* unpacked_bias_ptr = cache_key->bias;
-  auto entry = context->unpacked_data_to_name_.find(unpacked_weights_ptr);
-
   // Check if weight_pointer has been cached
-  if (entry == context->unpacked_data_to_name_.end()) {
+  const std::string weight_bias_name =
+      context->get_packed_data_name(cache_key);
+  if (weight_bias_name.empty()) {
     return SIZE_MAX;
   }
 
-  std::string weight_bias_name = entry->second;
-
-  // Check if bias_pointer has been cached
-  if (unpacked_bias_ptr != nullptr) {
-    auto bias_entry = context->unpacked_data_to_name_.find(unpacked_bias_ptr);
-    if (bias_entry != context->unpacked_data_to_name_.end()) {
-      weight_bias_name.append(bias_entry->second);
-    }
-  }
-
-  // check if weight_bias_name has been packed already
+  // check if weight_bias_name has been packed already, possibly by another
+  // method or program
   auto packed_weight_entry =
       context->name_to_packed_data_metadata_.find(weight_bias_name);
   if (packed_weight_entry == context->name_to_packed_data_metadata_.end()) {
-    return SIZE_MAX;
+    // Use the packed data from the cache file if it's there
+    auto file_entry = context->cache_file_entries_.find(weight_bias_name);
+    if (file_entry == context->cache_file_entries_.end()) {
+      return SIZE_MAX;
+    }
+    size_t offset = context->packed_data_ptrs_.size();
+    context->packed_data_ptrs_.push_back(const_cast<void*>(file_entry->second));
+    context->name_to_packed_data_metadata_[weight_bias_name] = {
+        .offset = offset, .ref_count = 0, .in_current_runtime = true};
+    return offset;
   }
   packed_weight_entry->second.in_current_runtime = true;
 
@@ -190,17 +468,11 @@ size_t XNNWeightsCache::look_up_or_insert(
 
   // Add to Cache if it is not finalized
   size_t next_offset = context->packed_data_ptrs_.size();
-  auto entry = context->unpacked_data_to_name_.find(cache_key->kernel);
+  const std::string weight_bias_name =
+      context->get_packed_data_name(cache_key);
 
   // Check if weight_pointer has been cached
-  if (entry != context->unpacked_data_to_name_.end()) {
-    std::string weight_bias_name = entry->second;
-    if (cache_key->bias != nullptr) {
-      auto bias_entry = context->unpacked_data_to_name_.find(cache_key->bias);
-      if (bias_entry != context->unpacked_data_to_name_.end()) {
-        weight_bias_name.append(bias_entry->second);
-      }
-    }
+  if (!weight_bias_name.empty()) {
     PackedDataMeta packed_data_metadata = {
         .offset = next_offset,
         .ref_count =
@@ -208,6 +480,10 @@ size_t XNNWeightsCache::look_up_or_insert(
         .in_current_runtime = true};
     context->name_to_packed_data_metadata_[weight_bias_name] =
         packed_data_metadata;
+    if (!context->cache_file_path_.empty() &&
+        context->cache_file_names_.count(weight_bias_name) == 0) {
+      context->pending_packed_data_.push_back({weight_bias_name, ptr, size});
+    }
   } else {
     ET_LOG(
         Info,
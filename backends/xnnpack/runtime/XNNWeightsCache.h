@@ -16,6 +16,7 @@
 #include <executorch/runtime/executor/pte_data_map.h>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace executorch {
@@ -38,9 +39,36 @@ struct PackedDataMeta {
   bool in_current_runtime;
 };
 
+/**
+ * Packed weights of the XNNPACK runtimes, shared by all the delegates in the
+ * process and ref counted by the runtimes using them.
+ *
+ * Packed data is keyed by the names of its weights and bias in the
+ * NamedDataMap, and by XNNPACK's seed for how they were packed. The XNNPACK
+ * serializer names constants by the hash of their data, so different methods
+ * and programs with the same weights share one packed copy of them.
+ */
 class XNNWeightsCache {
  public:
   XNNWeightsCache();
+  ~XNNWeightsCache();
+
+  XNNWeightsCache(const XNNWeightsCache&) = delete;
+  XNNWeightsCache& operator=(const XNNWeightsCache&) = delete;
+
+  /**
+   * Persists packed weights to the file at path, so that later processes can
+   * map them instead of packing the weights again.
+   *
+   * Packed weights found in the file are used as is, read only. Weights packed
+   * by a runtime are appended to the file by finalize_for_runtime. The file is
+   * ignored and rewritten if it was written by another version of XNNPACK or
+   * on a CPU with other ISA extensions. Only one process should write to the
+   * file at a time.
+   *
+   * Must be called before the first runtime is initialized.
+   */
+  Error set_cache_file(const std::string& path);
 
   /**
    * Initializes the XNNWeightsCache for the next xnn_create_runtime
@@ -116,6 +144,23 @@ class XNNWeightsCache {
   Error delete_packed_data(const std::vector<std::string>& packed_names);
 
  private:
+  // Packed data that isn't in the cache file yet.
+  struct PendingPackedData {
+    std::string name;
+    const void* data;
+    size_t size;
+  };
+
+  // Returns the key of the packed data for cache_key, or an empty string if
+  // its weights weren't loaded by name.
+  std::string get_packed_data_name(
+      const xnn_weights_cache_look_up_key* cache_key) const;
+
+  // Maps the packed data in cache_file_path_, if it's valid.
+  void load_cache_file();
+  // Appends pending_packed_data_ to cache_file_path_.
+  Error append_to_cache_file();
+
   // Runtime Allocator used to reserve memory for packed weights
   MemoryAllocator* runtime_allocator_;
 
@@ -137,6 +182,20 @@ class XNNWeightsCache {
   // whether or not the weight cache is finalized
   bool is_finalized_;
 
+  // File to persist the packed data to, empty if disabled
+  std::string cache_file_path_;
+  // Read only mapping of the cache file
+  void* cache_file_data_ = nullptr;
+  size_t cache_file_mapped_size_ = 0;
+  // Size of the valid prefix of the cache file, 0 if it must be rewritten
+  size_t cache_file_size_ = 0;
+  // Map of data names to the packed data mapped from the cache file
+  std::unordered_map<std::string, const void*> cache_file_entries_;
+  // Names of all the packed data written to the cache file
+  std::unordered_set<std::string> cache_file_names_;
+  // Packed data to append to the cache file once the runtime is finalized
+  std::vector<PendingPackedData> pending_packed_data_;
+
   // Function pointers to override XNNPACK's default xnn_weights_cache_provider
   // functions.
   static size_t look_up(
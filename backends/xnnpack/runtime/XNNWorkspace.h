@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <xnnpack.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK workspace, the memory for the intermediate values of the runtimes
+ * created with it. The runtimes sharing a workspace must not run at the same
+ * time, so they hold mutex() while they are created, run and deleted.
+ */
+class XNNWorkspace {
+ public:
+  using WorkspacePtr =
+      std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)>;
+
+  explicit XNNWorkspace(WorkspacePtr workspace)
+      : workspace_(std::move(workspace)) {}
+
+  XNNWorkspace(const XNNWorkspace&) = delete;
+  XNNWorkspace& operator=(const XNNWorkspace&) = delete;
+
+  static executorch::runtime::Result<std::shared_ptr<XNNWorkspace>> create() {
+    xnn_workspace_t workspace = nullptr;
+    xnn_status status = xnn_create_workspace(&workspace);
+    if (status != xnn_status_success) {
+      ET_LOG(
+          Error,
+          "Failed to create XNN workspace, XNNPACK status: 0x%x",
+          (unsigned int)status);
+      return executorch::runtime::Error::Internal;
+    }
+    return std::make_shared<XNNWorkspace>(
+        WorkspacePtr(workspace, &xnn_release_workspace));
+  }
+
+  inline xnn_workspace_t get() const {
+    return workspace_.get();
+  }
+
+  inline std::mutex& mutex() {
+    return mutex_;
+  }
+
+  /**
+   * Counts the reshapes of the runtimes using the workspace. A reshape can
+   * grow the workspace, after which the other runtimes must be set up again.
+   * Only accessed with mutex() held.
+   */
+  inline uint64_t generation() const {
+    return generation_;
+  }
+
+  inline void bump_generation() {
+    ++generation_;
+  }
+
+ private:
+  WorkspacePtr workspace_;
+  std::mutex mutex_;
+  uint64_t generation_ = 0;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
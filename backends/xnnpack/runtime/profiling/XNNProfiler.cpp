@@ -16,6 +16,7 @@
 #include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/types.h>
 
+#include <cctype>
 #include <cinttypes>
 #include <cstring>
 #include <string>
@@ -29,6 +30,49 @@ using executorch::runtime::EventTracer;
 
 #if defined(ET_EVENT_TRACER_ENABLED) || defined(ENABLE_XNNPACK_PROFILING)
 
+namespace {
+
+// Lowercases name up to the first '(' and drops its spaces, e.g. "Fully
+// Connected (NC, F32)" becomes "fullyconnected".
+std::string canonical_name(const char* name) {
+  std::string canonical;
+  for (; *name != '\0' && *name != '('; ++name) {
+    const unsigned char c = static_cast<unsigned char>(*name);
+    if (!isspace(c)) {
+      canonical += static_cast<char>(tolower(c));
+    }
+  }
+  return canonical;
+}
+
+// The canonical name of the XNNPACK operators a node type runs, where it isn't
+// the type name itself.
+std::string operator_name_for_node(const char* type_name) {
+  static const std::unordered_map<std::string, const char*> kOperatorNames = {
+      {"Conv2d", "convolution"},
+      {"DepthwiseConv2d", "convolution"},
+      {"ConvTranspose2d", "deconvolution"},
+      {"Div", "divide"},
+      {"StaticTranspose", "transpose"},
+      {"StaticReshape", "copy"},
+      {"StaticSlice", "slice"},
+      {"StaticConstantPad", "constantpad"},
+      {"StaticResizeBilinear2D", "resizebilinear"},
+      {"AvgPooling2d", "averagepooling"},
+      {"GlobalAvgPooling2d", "globalaveragepooling"},
+      {"MaxPooling2d", "maxpooling"},
+      {"ArgMaxPooling2d", "argmaxpooling"},
+      {"Concatenate2", "copy"},
+      {"Concatenate3", "copy"},
+      {"Concatenate4", "copy"},
+      {"Concatenate5", "copy"},
+  };
+  auto it = kOperatorNames.find(type_name);
+  return it != kOperatorNames.end() ? it->second : canonical_name(type_name);
+}
+
+} // namespace
+
 XNNProfiler::XNNProfiler()
     : state_(XNNProfilerState::Uninitialized), run_count_(0) {}
 
@@ -38,12 +82,53 @@ Error XNNProfiler::initialize(xnn_runtime_t runtime) {
   // Fetch the runtime operator information from XNNPACK.
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_num_operators());
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_operator_names());
+  attribute_operators();
 
   state_ = XNNProfilerState::Ready;
 
   return Error::Ok;
 }
 
+void XNNProfiler::set_nodes(std::vector<XNNNodeInfo> nodes) {
+  nodes_ = std::move(nodes);
+}
+
+void XNNProfiler::attribute_operators() {
+  std::vector<std::string> node_op_names;
+  node_op_names.reserve(nodes_.size());
+  for (const XNNNodeInfo& node : nodes_) {
+    node_op_names.push_back(operator_name_for_node(node.type_name));
+  }
+
+  op_nodes_.assign(op_count_, kNoNode);
+  // The last node matched, and the first one after it.
+  size_t last = kNoNode;
+  size_t next = 0;
+  size_t name_len = 0;
+  for (size_t i = 0; i < op_count_; i++) {
+    const std::string op_name = canonical_name(&op_names_[name_len]);
+    name_len += strlen(&op_names_[name_len]) + 1;
+
+    if (next < nodes_.size() && node_op_names[next] == op_name) {
+      last = next++;
+    } else if (last != kNoNode && node_op_names[last] == op_name) {
+      // Another operator of the same node, e.g. the copies of a concatenate.
+    } else {
+      // Skip the nodes that were fused into others.
+      size_t j = next;
+      while (j < nodes_.size() && node_op_names[j] != op_name) {
+        j++;
+      }
+      if (j == nodes_.size()) {
+        continue;
+      }
+      last = j;
+      next = j + 1;
+    }
+    op_nodes_[i] = last;
+  }
+}
+
 Error XNNProfiler::start(EventTracer* event_tracer) {
   // Validate profiler state.
   if (state_ == XNNProfilerState::Uninitialized) {
@@ -190,6 +275,7 @@ void XNNProfiler::submit_trace() {
   auto tick_ns_conv_multiplier = et_pal_ticks_to_ns_multiplier();
 
   ET_CHECK(op_timings_.size() == op_count_);
+  ET_CHECK(op_nodes_.size() == op_count_);
   size_t name_len = 0;
   et_timestamp_t time = start_time_;
   std::unordered_map<std::string, uint32_t> op_counts;
@@ -198,12 +284,6 @@ void XNNProfiler::submit_trace() {
     auto op_name = &op_names_[name_len];
     name_len += strlen(op_name) + 1;
 
-    // Format the op name as {name} #{count}.
-    auto op_name_str = std::string(op_name);
-    op_counts[op_name_str]++;
-    auto name_formatted =
-        op_name_str + " #" + std::to_string(op_counts[op_name_str]);
-
     // Convert from microseconds (XNNPACK) to PAL ticks (ET).
     // The tick_ns_conv_ratio is ns / tick. We want ticks:
     //  ticks = us * (ns / us) / conv_ratio
@@ -212,20 +292,58 @@ void XNNProfiler::submit_trace() {
         op_timings_[i] * 1000 * tick_ns_conv_multiplier.denominator /
         tick_ns_conv_multiplier.numerator);
 
+    auto start_time = time;
     auto end_time = time + interval_ticks;
+    // Assume that the next op starts immediately after the previous op.
+    // This may not be strictly true, but it should be close enough.
+    // Ideally, we'll get the start and end times from XNNPACK in the
+    // future.
+    time = end_time;
+
+    const size_t node_index = op_nodes_[i];
+    if (node_index != kNoNode &&
+        nodes_[node_index].debug_handle !=
+            executorch::runtime::kUnsetDebugHandle) {
+      // Log the consecutive operators of a node as one event.
+      std::string op_names_str(op_name);
+      while (i + 1 < op_count_ && op_nodes_[i + 1] == node_index) {
+        i++;
+        op_name = &op_names_[name_len];
+        name_len += strlen(op_name) + 1;
+        op_names_str += std::string("|") + op_name;
+        time += static_cast<et_timestamp_t>(
+            op_timings_[i] * 1000 * tick_ns_conv_multiplier.denominator /
+            tick_ns_conv_multiplier.numerator);
+      }
+      end_time = time;
+
+      const XNNNodeInfo& node = nodes_[node_index];
+      const std::string metadata = "op=" + op_names_str +
+          ";flops=" + std::to_string(node.flops) +
+          ";weight_bytes=" + std::to_string(node.weight_bytes);
+      executorch::runtime::event_tracer_log_profiling_delegate(
+          event_tracer_,
+          /*name=*/nullptr,
+          node.debug_handle,
+          start_time,
+          end_time,
+          metadata.c_str(),
+          metadata.size() + 1);
+      continue;
+    }
+
+    // Format the op name as {name} #{count}.
+    auto op_name_str = std::string(op_name);
+    op_counts[op_name_str]++;
+    auto name_formatted =
+        op_name_str + " #" + std::to_string(op_counts[op_name_str]);
 
     executorch::runtime::event_tracer_log_profiling_delegate(
         event_tracer_,
         name_formatted.c_str(),
         /*delegate_debug_id=*/static_cast<executorch::runtime::DebugHandle>(-1),
-        time,
+        start_time,
         end_time);
-
-    // Assume that the next op starts immediately after the previous op.
-    // This may not be strictly true, but it should be close enough.
-    // Ideally, we'll get the start and end times from XNNPACK in the
-    // future.
-    time = end_time;
   }
 }
 
@@ -239,6 +357,10 @@ Error XNNProfiler::initialize(xnn_runtime_t runtime) {
   return Error::Ok;
 }
 
+void XNNProfiler::set_nodes(std::vector<XNNNodeInfo> nodes) {
+  (void)nodes;
+}
+
 Error XNNProfiler::start(EventTracer* event_tracer) {
   (void)event_tracer;
   return Error::Ok;
@@ -12,6 +12,7 @@
 #include <executorch/runtime/core/event_tracer_hooks_delegate.h>
 
 #include <xnnpack.h>
+#include <cstdint>
 #include <vector>
 
 namespace executorch {
@@ -22,6 +23,22 @@ namespace profiling {
 
 enum class XNNProfilerState { Uninitialized, Ready, Running };
 
+/**
+ * A node of the delegated graph, which the profiler attributes the XNNPACK
+ * operators it runs to.
+ */
+struct XNNNodeInfo {
+  // The debug handle of the node in the graph that was delegated.
+  executorch::runtime::DebugHandle debug_handle;
+  // The node type, e.g. "FullyConnected".
+  const char* type_name;
+  // Estimated operations of one run, from the serialized shapes. Multiply-adds
+  // count as two.
+  uint64_t flops;
+  // Bytes of the constant weights the node reads, as serialized.
+  uint64_t weight_bytes;
+};
+
 class XNNProfiler {
  public:
   XNNProfiler();
@@ -32,6 +49,18 @@ class XNNProfiler {
    */
   executorch::runtime::Error initialize(xnn_runtime_t runtime);
 
+  /**
+   * Sets the nodes of the graph, in the order they were defined in the
+   * subgraph. This must be called before initialize. The operators of the
+   * runtime are then logged with the debug handles of their nodes, and with
+   * "op=...;flops=...;weight_bytes=..." as delegate metadata.
+   *
+   * XNNPACK doesn't report which node an operator comes from, so operators
+   * are matched to the nodes by name and order. Nodes fused into others get
+   * no operators, and operators that match no node are logged by name.
+   */
+  void set_nodes(std::vector<XNNNodeInfo> nodes);
+
   /**
    * Start a new profiling session. This is typically invoked
    * immediately before invoking the XNNPACK runtime as part
@@ -58,6 +87,11 @@ class XNNProfiler {
   uint64_t run_count_;
   et_timestamp_t start_time_;
 
+  std::vector<XNNNodeInfo> nodes_;
+  // Index in nodes_ of the node each operator runs, or kNoNode
+  std::vector<size_t> op_nodes_;
+  static constexpr size_t kNoNode = SIZE_MAX;
+
 #ifdef ENABLE_XNNPACK_PROFILING
   // State needed to track average timing. Track the running sum of
   // timing for each op, as well as the number of invocations. The
@@ -69,6 +103,9 @@ class XNNProfiler {
   executorch::runtime::Error get_runtime_num_operators();
   executorch::runtime::Error get_runtime_operator_timings();
 
+  // Fills op_nodes_ from op_names_ and nodes_.
+  void attribute_operators();
+
   void log_operator_timings();
 
   /**
@@ -0,0 +1,67 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+import torch
+from executorch.backends.xnnpack.test.tester import Tester
+
+
+class TestViewCopy(unittest.TestCase):
+    def setUp(self):
+        torch._dynamo.reset()
+
+    class LinearViewLinear(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.linear1 = torch.nn.Linear(8, 8)
+            self.linear2 = torch.nn.Linear(4, 4)
+
+        def forward(self, x):
+            y = self.linear1(x)
+            y = y.view(-1, 4)
+            return self.linear2(y)
+
+    def _test_view_copy(self, inputs):
+        (
+            Tester(self.LinearViewLinear(), inputs)
+            .export()
+            .to_edge_transform_and_lower()
+            # The view doesn't split the graph into two delegates.
+            .check_count({"torch.ops.higher_order.executorch_call_delegate": 1})
+            .check_not(["executorch_exir_dialects_edge__ops_aten_view_copy_default"])
+            .to_executorch()
+            .serialize()
+            .run_method_and_compare_outputs()
+        )
+
+    def test_fp16_view_copy(self):
+        self._test_view_copy((torch.randn(3, 8).to(torch.float16),))
+
+    def test_fp32_view_copy(self):
+        self._test_view_copy((torch.randn(3, 8),))
+
+    def test_fp32_view_copy_after_conv(self):
+        class ConvView(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv = torch.nn.Conv2d(2, 4, 3, padding=1)
+
+            def forward(self, x):
+                # The conv output is channels last inside the delegate, and
+                # must be converted back before the view.
+                return self.conv(x).view(1, 4, -1)
+
+        (
+            Tester(ConvView(), (torch.randn(1, 2, 5, 5),))
+            .export()
+            .to_edge_transform_and_lower()
+            .check_count({"torch.ops.higher_order.executorch_call_delegate": 1})
+            .check_not(["executorch_exir_dialects_edge__ops_aten_view_copy_default"])
+            .to_executorch()
+            .serialize()
+            .run_method_and_compare_outputs()
+        )
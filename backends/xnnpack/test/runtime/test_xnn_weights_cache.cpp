@@ -17,6 +17,7 @@
 #include <executorch/runtime/platform/runtime.h>
 #include <executorch/schema/program_generated.h>
 #include <gtest/gtest.h>
+#include <sys/stat.h>
 #include <xnnpack.h>
 
 using executorch::backends::xnnpack::delegate::XNNWeightsCache;
@@ -284,3 +285,93 @@ TEST_F(XNNWeightsCacheTest, ReusePackedWeights) {
   packed_data_names = weight_cache.get_packed_data_names();
   ASSERT_EQ(packed_data_names.size(), 0);
 }
+
+TEST_F(XNNWeightsCacheTest, ReusePackedWeightsFromCacheFile) {
+  std::vector<size_t> batches{1, 2, 3};
+  size_t num_batches = 6;
+  size_t input_channels = 3;
+  size_t output_channels = 4;
+  std::vector<float> input_tensor(num_batches * input_channels + 32, 1.0f);
+  std::vector<float> expected_output(num_batches * output_channels, 0.0f);
+  std::vector<float> output_tensor(num_batches * output_channels, 0.0f);
+  TempFile cache_file("");
+  struct stat st;
+
+  {
+    // Packs the weights and writes them to the file.
+    XNNWeightsCache weight_cache;
+    ASSERT_EQ(weight_cache.set_cache_file(cache_file.path()), Error::Ok);
+    weight_cache.initialize_for_runtime(
+        memory_allocator_.get(), data_map_.get());
+    BuildAndRunGraphWithWeightsCache(
+        weight_cache,
+        batches,
+        input_channels,
+        output_channels,
+        input_tensor.data(),
+        expected_output.data());
+    weight_cache.delete_packed_data(weight_cache.get_packed_data_names());
+  }
+  ASSERT_EQ(stat(cache_file.path().c_str(), &st), 0);
+  const off_t cache_file_size = st.st_size;
+  EXPECT_GT(cache_file_size, 0);
+
+  {
+    // Maps the packed weights from the file and doesn't append them again.
+    XNNWeightsCache weight_cache;
+    ASSERT_EQ(weight_cache.set_cache_file(cache_file.path()), Error::Ok);
+    weight_cache.initialize_for_runtime(
+        memory_allocator_.get(), data_map_.get());
+    BuildAndRunGraphWithWeightsCache(
+        weight_cache,
+        batches,
+        input_channels,
+        output_channels,
+        input_tensor.data(),
+        output_tensor.data());
+    EXPECT_EQ(output_tensor, expected_output);
+    ASSERT_EQ(weight_cache.get_packed_data_names().size(), 1);
+    weight_cache.delete_packed_data(weight_cache.get_packed_data_names());
+    ASSERT_EQ(weight_cache.get_packed_data_names().size(), 0);
+  }
+  ASSERT_EQ(stat(cache_file.path().c_str(), &st), 0);
+  EXPECT_EQ(st.st_size, cache_file_size);
+}
+
+TEST_F(XNNWeightsCacheTest, SetCacheFileAfterPackingFails) {
+  XNNWeightsCache weight_cache;
+  std::vector<float> input_tensor(6 * 3 + 32, 1.0f);
+  std::vector<float> output_tensor(6 * 4, 0.0f);
+  weight_cache.initialize_for_runtime(memory_allocator_.get(), data_map_.get());
+  BuildAndRunGraphWithWeightsCache(
+      weight_cache, {1, 2, 3}, 3, 4, input_tensor.data(), output_tensor.data());
+
+  TempFile cache_file("");
+  EXPECT_EQ(
+      weight_cache.set_cache_file(cache_file.path()), Error::InvalidState);
+}
+
+TEST_F(XNNWeightsCacheTest, KeysPackedWeightsByPackingSeed) {
+  XNNWeightsCache weight_cache;
+  weight_cache.initialize_for_runtime(memory_allocator_.get(), data_map_.get());
+  Result<const uint8_t*> weight = weight_cache.load_unpacked_data("weight");
+  ASSERT_EQ(weight.error(), Error::Ok);
+  xnn_weights_cache_t cache = weight_cache.get();
+
+  xnn_weights_cache_look_up_key key = {
+      .seed = 1, .kernel = weight.get(), .bias = nullptr};
+  ASSERT_EQ(cache->look_up(cache->context, &key), SIZE_MAX);
+  void* packed = cache->reserve_space(cache->context, 16);
+  memset(packed, 3, 16);
+  const size_t offset =
+      cache->look_up_or_insert(cache->context, &key, packed, 16);
+  ASSERT_NE(offset, SIZE_MAX);
+  EXPECT_EQ(cache->look_up(cache->context, &key), offset);
+
+  // The same weights packed for another operator don't hit the entry.
+  key.seed = 2;
+  EXPECT_EQ(cache->look_up(cache->context, &key), SIZE_MAX);
+
+  ASSERT_EQ(weight_cache.finalize_for_runtime().error(), Error::Ok);
+  EXPECT_EQ(weight_cache.get_packed_data_names().size(), 1);
+}
@@ -12,6 +12,7 @@
 #include <xnnpack.h>
 
 using executorch::backends::xnnpack::delegate::XNNExecutor;
+using executorch::backends::xnnpack::delegate::XNNWorkspace;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::testing::TensorFactory;
@@ -93,3 +94,178 @@ TEST(XNNExecutorTest, ArgumentWithTooManyDimensions) {
   // Check for invalid number of dimensions should fail without stack overflow.
   EXPECT_EQ(executor.prepare_args(args.data()), Error::InvalidArgument);
 }
+
+TEST(XNNExecutorTest, ReusesSetupUntilShapesOrPointersChange) {
+  XNNExecutor executor;
+  xnn_subgraph_t subgraph = nullptr;
+  xnn_runtime_t rt = nullptr;
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  ASSERT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  std::vector<size_t> dims = {3};
+  uint32_t input_id = XNN_INVALID_VALUE_ID;
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id));
+  uint32_t output_id = XNN_INVALID_VALUE_ID;
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id));
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_clamp(subgraph, 0.0f, 10.0f, input_id, output_id, 0));
+  ASSERT_EQ(xnn_create_runtime(subgraph, &rt), xnn_status_success);
+  ASSERT_EQ(executor.initialize(rt, {0}, {1}, {}), Error::Ok);
+
+  TensorFactory<executorch::aten::ScalarType::Float> tf;
+  auto input_tensor = tf.make({3}, {-1.0f, 5.0f, 20.0f});
+  auto output_tensor =
+      tf.zeros({3}, executorch::runtime::TensorShapeDynamism::DYNAMIC_BOUND);
+  EValue input_ev(input_tensor);
+  EValue output_ev(output_tensor);
+  std::array<EValue*, 2> args = {&input_ev, &output_ev};
+  executorch::runtime::BackendExecutionContext context;
+  auto run = [&]() {
+    ASSERT_EQ(executor.prepare_args(args.data()), Error::Ok);
+    ASSERT_EQ(executor.forward(context), Error::Ok);
+    ASSERT_EQ(executor.resize_outputs(args.data()), Error::Ok);
+  };
+
+  run();
+  EXPECT_EQ(output_tensor.const_data_ptr<float>()[2], 10.0f);
+
+  // Same shapes and pointers, new data.
+  input_tensor.mutable_data_ptr<float>()[2] = 7.0f;
+  run();
+  EXPECT_EQ(output_tensor.const_data_ptr<float>()[2], 7.0f);
+
+  // Same shapes, new input pointer.
+  auto other_input = tf.make({3}, {1.0f, 2.0f, 3.0f});
+  input_ev = EValue(other_input);
+  run();
+  EXPECT_EQ(output_tensor.const_data_ptr<float>()[0], 1.0f);
+
+  // New shapes.
+  auto smaller_input = tf.make({2}, {-4.0f, 4.0f});
+  input_ev = EValue(smaller_input);
+  run();
+  ASSERT_EQ(output_tensor.size(0), 2);
+  EXPECT_EQ(output_tensor.const_data_ptr<float>()[0], 0.0f);
+  EXPECT_EQ(output_tensor.const_data_ptr<float>()[1], 4.0f);
+}
+
+TEST(XNNExecutorTest, SetsUpAgainAfterAnotherRuntimeGrowsTheWorkspace) {
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  auto workspace = XNNWorkspace::create();
+  ASSERT_TRUE(workspace.ok());
+
+  // Two executors running clamp graphs in the same workspace.
+  XNNExecutor executors[2];
+  for (auto& executor : executors) {
+    xnn_subgraph_t subgraph = nullptr;
+    ASSERT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+    std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)>
+        auto_subgraph(subgraph, xnn_delete_subgraph);
+    std::vector<size_t> dims = {4};
+    uint32_t input_id = XNN_INVALID_VALUE_ID;
+    ASSERT_EQ(
+        xnn_status_success,
+        xnn_define_tensor_value(
+            subgraph,
+            xnn_datatype_fp32,
+            dims.size(),
+            dims.data(),
+            nullptr,
+            /*external_id=*/0,
+            /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+            &input_id));
+    uint32_t hidden_id = XNN_INVALID_VALUE_ID;
+    ASSERT_EQ(
+        xnn_status_success,
+        xnn_define_tensor_value(
+            subgraph,
+            xnn_datatype_fp32,
+            dims.size(),
+            dims.data(),
+            nullptr,
+            XNN_INVALID_VALUE_ID,
+            /*flags=*/0,
+            &hidden_id));
+    uint32_t output_id = XNN_INVALID_VALUE_ID;
+    ASSERT_EQ(
+        xnn_status_success,
+        xnn_define_tensor_value(
+            subgraph,
+            xnn_datatype_fp32,
+            dims.size(),
+            dims.data(),
+            nullptr,
+            /*external_id=*/1,
+            /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+            &output_id));
+    // The intermediate value lives in the workspace.
+    ASSERT_EQ(
+        xnn_status_success,
+        xnn_define_clamp(subgraph, 0.0f, 10.0f, input_id, hidden_id, 0));
+    ASSERT_EQ(
+        xnn_status_success,
+        xnn_define_clamp(subgraph, 1.0f, 8.0f, hidden_id, output_id, 0));
+
+    executor.set_workspace_and_threadpool(
+        *workspace, XNNExecutor::ThreadpoolPtr(nullptr, &pthreadpool_destroy));
+    xnn_runtime_t rt = nullptr;
+    ASSERT_EQ(
+        xnn_create_runtime_v4(
+            subgraph, nullptr, (*workspace)->get(), nullptr, 0, &rt),
+        xnn_status_success);
+    ASSERT_EQ(executor.initialize(rt, {0}, {1}, {}), Error::Ok);
+  }
+
+  TensorFactory<executorch::aten::ScalarType::Float> tf;
+  executorch::runtime::BackendExecutionContext context;
+  auto run = [&](XNNExecutor& executor, const executorch::aten::Tensor& input) {
+    auto output =
+        tf.zeros({4}, executorch::runtime::TensorShapeDynamism::DYNAMIC_BOUND);
+    EValue input_ev(input);
+    EValue output_ev(output);
+    std::array<EValue*, 2> args = {&input_ev, &output_ev};
+    EXPECT_EQ(executor.prepare_args(args.data()), Error::Ok);
+    EXPECT_EQ(executor.forward(context), Error::Ok);
+    EXPECT_EQ(executor.resize_outputs(args.data()), Error::Ok);
+    return std::vector<float>(
+        output.const_data_ptr<float>(),
+        output.const_data_ptr<float>() + output.numel());
+  };
+
+  auto small_input = tf.make({1}, {20.0f});
+  auto large_input = tf.make({4}, {-1.0f, 0.5f, 5.0f, 20.0f});
+  EXPECT_EQ(run(executors[0], small_input), std::vector<float>({8.0f}));
+  const uint64_t generation = (*workspace)->generation();
+  EXPECT_EQ(
+      run(executors[1], large_input),
+      std::vector<float>({1.0f, 1.0f, 5.0f, 8.0f}));
+  EXPECT_GT((*workspace)->generation(), generation);
+  // The other reshape may have moved the workspace, so this has to be set up
+  // again even though its inputs didn't change.
+  EXPECT_EQ(run(executors[0], small_input), std::vector<float>({8.0f}));
+}
@@ -38,6 +38,7 @@ from executorch.exir.backend.backend_details import (
     CompileSpec,
     PreprocessResult,
 )
+from executorch.exir.backend.utils import DelegateMappingBuilder
 from executorch.exir.verification.verifier import EXIREdgeDialectVerifier
 from torch.export.exported_program import ExportedProgram
 
@@ -164,17 +165,30 @@ class XnnpackBackend(BackendDetails):
 
         constant_data_bytes = bytearray()
         node_visitors = get_node_visitors(ep, node_to_external_map, named_data_store)
+        # The runtime profiler logs the XNNPACK operators with the debug handles
+        # of their nodes.
+        delegate_mapping_builder = DelegateMappingBuilder()
+        mapped_debug_handles = set()
 
         for node in graph_module.graph.nodes:
             if node.op == "call_function":
                 logger.info(f"Visiting: {node}, {node.target.__name__}")
                 if node.target.__name__ in node_visitors:
+                    debug_handle = node.meta.get("debug_handle", DEFAULT_DEBUG_HANDLE)
                     node_visitors[node.target.__name__].define_node(
                         node,
                         xnnpack_graph,
                         vals_to_ids,
-                        node.meta.get("debug_handle", DEFAULT_DEBUG_HANDLE),
+                        debug_handle,
                     )
+                    if (
+                        debug_handle != DEFAULT_DEBUG_HANDLE
+                        and debug_handle not in mapped_debug_handles
+                    ):
+                        delegate_mapping_builder.insert_delegate_mapping_entry(
+                            nodes=node, identifier=debug_handle
+                        )
+                        mapped_debug_handles.add(debug_handle)
                 else:
                     raise RuntimeError(
                         f"For {node}, {node.op}:{node.target.__name__} is not supported in XNNPACK Delegate"
@@ -191,6 +205,6 @@ class XnnpackBackend(BackendDetails):
             processed_bytes=serialize_xnnpack_binary(
                 xnnpack_graph, constant_data_bytes
             ),
-            debug_handle_map={},
+            debug_handle_map=delegate_mapping_builder.get_delegate_mapping(),
             data_store_output=named_data_store.get_named_data_store_output(),
         )
@@ -10,7 +10,7 @@ import re
 import sys
 from functools import reduce
 from pathlib import Path
-from typing import Any, List
+from typing import Any, Dict, List, Set
 
 import yaml
 from torchgen.selective_build.selector import (
@@ -72,6 +72,20 @@ def _raise_if_check_prim_ops_fail(options):
             raise Exception(error)
 
 
+def merge_et_kernel_static_sizes(
+    model_dicts: List[Dict[str, Any]],
+) -> Dict[str, List[int]]:
+    """Merges the static sizes recorded for each operator by gen_oplist.py
+    --include_static_sizes, which SelectiveBuilder doesn't keep.
+    """
+    static_sizes: Dict[str, Set[int]] = {}
+    for model_dict in model_dicts:
+        model_static_sizes = model_dict.get("et_kernel_static_sizes") or {}
+        for op_name, sizes in model_static_sizes.items():
+            static_sizes.setdefault(op_name, set()).update(sizes)
+    return {op_name: sorted(sizes) for op_name, sizes in sorted(static_sizes.items())}
+
+
 def main(argv: List[Any]) -> None:
     """This binary generates 3 files:
 
@@ -220,13 +234,15 @@ def main(argv: List[Any]) -> None:
 
     if not options.allow_include_all_overloads:
         throw_if_any_op_includes_overloads(selective_builder)
+    output = selective_builder.to_dict()
+    et_kernel_static_sizes = merge_et_kernel_static_sizes(model_dicts)
+    if et_kernel_static_sizes:
+        output["et_kernel_static_sizes"] = et_kernel_static_sizes
     with open(
         os.path.join(options.output_dir, "selected_operators.yaml"), "wb"
     ) as out_file:
         out_file.write(
-            yaml.safe_dump(
-                selective_builder.to_dict(), default_flow_style=False
-            ).encode("utf-8"),
+            yaml.safe_dump(output, default_flow_style=False).encode("utf-8"),
         )
 
 
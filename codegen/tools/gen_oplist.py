@@ -9,7 +9,7 @@ import json
 import os
 import sys
 from enum import IntEnum
-from typing import Any, Dict, List, Optional, Set
+from typing import Any, Dict, List, Optional, Set, Tuple
 
 import yaml
 from torchgen.executorch.parse import strip_et_fields
@@ -78,13 +78,58 @@ class KernelType(IntEnum):
     OPTIONAL_TENSOR_LIST = 11
 
 
-def _get_operators(model_file: str) -> List[str]:
-    from executorch.codegen.tools.selective_build import (  # type: ignore[import-not-found]
-        _get_program_from_buffer,
-        _get_program_operators,
+def _get_kernel_calls(model_file: str) -> List[Tuple[str, List[Any]]]:
+    """Returns the name of the operator and the tensor arguments of each kernel
+    call in the model. A tensor list argument is represented by its first
+    tensor. Only needs the Python program schema, so it also works where the
+    selective_build extension isn't built.
+    """
+    from executorch.exir._serialize._program import deserialize_pte_binary
+    from executorch.exir.schema import (
+        KernelCall,
+        OptionalTensorList,
+        Tensor,
+        TensorList,
     )
 
+    with open(model_file, "rb") as f:
+        program = deserialize_pte_binary(f.read())
+
+    kernel_calls = []
+    for plan in program.execution_plan:
+        for chain in plan.chains:
+            for instruction in chain.instructions:
+                kernel_call = instruction.instr_args
+                if not isinstance(kernel_call, KernelCall):
+                    continue
+                operator = plan.operators[kernel_call.op_index]
+                op_name = operator.name
+                if operator.overload:
+                    op_name += "." + operator.overload
+                tensors = []
+                for arg in kernel_call.args:
+                    val = plan.values[arg].val
+                    if isinstance(val, (TensorList, OptionalTensorList)):
+                        items = [i for i in val.items if i >= 0]
+                        val = plan.values[items[0]].val if items else None
+                    if isinstance(val, Tensor):
+                        tensors.append(val)
+                kernel_calls.append((op_name, tensors))
+    return kernel_calls
+
+
+def _get_operators(model_file: str) -> List[str]:
     print("Processing model file: ", model_file)
+    try:
+        from executorch.codegen.tools.selective_build import (  # type: ignore[import-not-found]
+            _get_program_from_buffer,
+            _get_program_operators,
+        )
+    except ImportError:
+        operators = sorted({op_name for op_name, _ in _get_kernel_calls(model_file)})
+        print(f"Model file loaded, operators are: {operators}")
+        return operators
+
     with open(model_file, "rb") as f:
         buf = f.read()
 
@@ -95,12 +140,14 @@ def _get_operators(model_file: str) -> List[str]:
 
 
 def _get_kernel_metadata_for_model(model_file: str) -> Dict[str, List[str]]:
-
-    from executorch.codegen.tools.selective_build import (  # type: ignore[import-not-found]
-        _get_io_metadata_for_program_operators,
-        _get_program_from_buffer,
-        _IOMetaData,
-    )
+    try:
+        from executorch.codegen.tools.selective_build import (  # type: ignore[import-not-found]
+            _get_io_metadata_for_program_operators,
+            _get_program_from_buffer,
+            _IOMetaData,
+        )
+    except ImportError:
+        return _get_kernel_metadata_from_kernel_calls(_get_kernel_calls(model_file))
 
     with open(model_file, "rb") as f:
         buf = f.read()
@@ -132,6 +179,47 @@ def _get_kernel_metadata_for_model(model_file: str) -> Dict[str, List[str]]:
     return op_kernel_key_list
 
 
+def _get_kernel_metadata_from_kernel_calls(
+    kernel_calls: List[Tuple[str, List[Any]]],
+) -> Dict[str, List[str]]:
+    op_kernel_key_list: Dict[str, List[str]] = {}
+    for op_name, tensors in kernel_calls:
+        # For a description of the kernel key format, see
+        # executorch/blob/main/runtime/kernel/operator_registry.h#L97-L123
+        kernel_key = "v1/" + "|".join(
+            f"{int(tensor.scalar_type)};{','.join(map(str, tensor.dim_order))}"
+            for tensor in tensors
+        )
+        kernel_keys = op_kernel_key_list.setdefault(op_name, [])
+        if kernel_key not in kernel_keys:
+            kernel_keys.append(kernel_key)
+    return op_kernel_key_list
+
+
+def _get_static_sizes_for_model(model_file: str) -> Dict[str, List[int]]:
+    """Returns the sizes of the innermost dimension of the first tensor argument
+    of each operator in the model, across all of its calls. Operators that are
+    called on a dynamically shaped tensor are left out, since their sizes are
+    only upper bounds.
+    """
+    from executorch.exir.schema import TensorShapeDynamism
+
+    static_sizes: Dict[str, Set[int]] = {}
+    dynamic_ops: Set[str] = set()
+    for op_name, tensors in _get_kernel_calls(model_file):
+        if len(tensors) == 0 or len(tensors[0].sizes) == 0:
+            continue
+        if tensors[0].shape_dynamism != TensorShapeDynamism.STATIC:
+            dynamic_ops.add(op_name)
+            continue
+        static_sizes.setdefault(op_name, set()).add(tensors[0].sizes[-1])
+    return {
+        op_name: sorted(sizes)
+        for op_name, sizes in static_sizes.items()
+        if op_name not in dynamic_ops
+    }
+
+
 def _get_et_kernel_metadata_from_ops_yaml(ops_yaml_path: str) -> Dict[str, List[str]]:
     ops = []
     with open(ops_yaml_path, "r") as f:
@@ -157,6 +245,7 @@ def _dump_yaml(
     model_name: Optional[str] = None,
     et_kernel_metadata: Optional[Dict[str, List[str]]] = None,
     include_all_operators: bool = False,
+    et_kernel_static_sizes: Optional[Dict[str, List[int]]] = None,
 ):
     # no debug info yet
     output: dict[str, Any] = {}
@@ -180,6 +269,8 @@ def _dump_yaml(
     output["include_all_operators"] = include_all_operators
     output["kernel_metadata"] = {}
     output["et_kernel_metadata"] = et_kernel_metadata
+    if et_kernel_static_sizes:
+        output["et_kernel_static_sizes"] = et_kernel_static_sizes
     with open(output_path, "wb") as out_file:
         out_file.write(
             yaml.safe_dump(
@@ -213,6 +304,7 @@ def gen_oplist(
     root_ops: Optional[str] = None,
     ops_dict: Optional[str] = None,
     include_all_operators: bool = False,
+    include_static_sizes: bool = False,
 ):
     assert (
         model_file_path
@@ -226,6 +318,7 @@ def gen_oplist(
     op_set = set()
     source_name = None
     et_kernel_metadata = {}  # type: ignore[var-annotated]
+    et_kernel_static_sizes = None
     if root_ops:
         # decide delimiter
         delimiter = "," if "," in root_ops else " "
@@ -257,6 +350,8 @@ def gen_oplist(
         et_kernel_metadata = merge_et_kernel_metadata(
             et_kernel_metadata, _get_kernel_metadata_for_model(model_file_path)
         )
+        if include_static_sizes:
+            et_kernel_static_sizes = _get_static_sizes_for_model(model_file_path)
     if ops_schema_yaml_path:
         assert os.path.isfile(
             ops_schema_yaml_path
@@ -273,6 +368,7 @@ def gen_oplist(
         source_name,
         et_kernel_metadata,
         include_all_operators,
+        et_kernel_static_sizes,
     )
 
 
@@ -319,6 +415,18 @@ def main(args: List[Any]) -> None:
         help="Set this flag to request inclusion of all operators (i.e. build is not selective).",
         required=False,
     )
+    parser.add_argument(
+        "--include-static-sizes",
+        "--include_static_sizes",
+        action="store_true",
+        default=False,
+        help=(
+            "Record the static sizes of the tensors the model calls each operator "
+            + "on, so that kernels can be specialized for them. Needs "
+            + "--model_file_path."
+        ),
+        required=False,
+    )
     options = parser.parse_args(args)
 
     try:
@@ -329,6 +437,7 @@ def main(args: List[Any]) -> None:
             root_ops=options.root_ops,
             ops_dict=options.ops_dict,
             include_all_operators=options.include_all_operators,
+            include_static_sizes=options.include_static_sizes,
         )
     except Exception as e:
         command = ["python codegen/tools/gen_oplist.py"]
@@ -342,6 +451,8 @@ def main(args: List[Any]) -> None:
             command.append(f"--ops_dict {options.ops_dict}")
         if options.include_all_operators:
             command.append("--include-all-operators")
+        if options.include_static_sizes:
+            command.append("--include-static-sizes")
         repro_command = " ".join(command)
         raise RuntimeError(
             f"""Failed to generate selected_operators.yaml. Repro command:
@@ -34,6 +34,22 @@ inline constexpr bool should_include_kernel_dtype(
 """
 selected_kernel_dtypes_h_template = CodeTemplate(selected_kernel_dtypes_h_template_str)
 
+ops_and_static_sizes_template_str = """(executorch::aten::string_view(operator_name).compare("$operator_name") == 0) ? $size"""
+ops_and_static_sizes_template = CodeTemplate(ops_and_static_sizes_template_str)
+
+# Appended to selected_op_variants.h when the model's static sizes were recorded.
+# See ET_SPECIALIZE_STATIC_INNER_SIZE in kernels/portable/cpu/selective_build.h.
+kernel_static_sizes_h_template_str = """
+#define EXECUTORCH_SELECTIVE_BUILD_STATIC_SIZES
+
+inline constexpr int64_t kernel_static_inner_size(
+  const char *operator_name
+) {
+  return $body;
+}
+"""
+kernel_static_sizes_h_template = CodeTemplate(kernel_static_sizes_h_template_str)
+
 # enum from: https://github.com/pytorch/executorch/blob/main/runtime/core/portable_type/scalar_type.h
 dtype_enum_to_type = {
     "0": "Byte",
@@ -102,6 +118,22 @@ def write_selected_op_variants(yaml_file_path: str, output_dir: str) -> None:
             )
             body = "\n || ".join(body_parts)
         header_contents = selected_kernel_dtypes_h_template.substitute(body=body)
+
+        # Only operators that always see the same size can be specialized.
+        et_kernel_static_sizes = selected_operators_dict.get("et_kernel_static_sizes")
+        if et_kernel_static_sizes is not None:
+            assert isinstance(et_kernel_static_sizes, dict)
+            size_parts = [
+                ops_and_static_sizes_template.substitute(
+                    operator_name=operator_name.replace("aten::", ""),
+                    size=str(sizes[0]),
+                )
+                for operator_name, sizes in sorted(et_kernel_static_sizes.items())
+                if len(sizes) == 1
+            ]
+            header_contents += kernel_static_sizes_h_template.substitute(
+                body="\n    : ".join(size_parts + ["0"])
+            )
         selected_op_variants_path = os.path.join(output_dir, "selected_op_variants.h")
         with open(selected_op_variants_path, "wb") as out_file:
             out_file.write(header_contents.encode("utf-8"))
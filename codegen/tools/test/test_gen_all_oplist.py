@@ -118,5 +118,20 @@ operators:
         with self.assertRaisesRegex(Exception, "Operator .* is used in 2 models"):
             gen_all_oplist.main(args)
 
+    def test_merge_et_kernel_static_sizes(self) -> None:
+        merged = gen_all_oplist.merge_et_kernel_static_sizes(
+            [
+                {"et_kernel_static_sizes": {"aten::add.out": [16]}},
+                {},
+                {
+                    "et_kernel_static_sizes": {
+                        "aten::add.out": [16, 8],
+                        "aten::mul.out": [4],
+                    }
+                },
+            ]
+        )
+        self.assertEqual(merged, {"aten::add.out": [8, 16], "aten::mul.out": [4]})
+
     def tearDown(self):
         self.temp_dir.cleanup()
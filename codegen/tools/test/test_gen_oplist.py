@@ -81,6 +81,7 @@ class TestGenOpList(unittest.TestCase):
             None,
             {"aten::add": ["default"], "aten::mul": ["default"]},
             False,
+            None,
         )
 
     @patch("executorch.codegen.tools.gen_oplist._dump_yaml")
@@ -110,6 +111,7 @@ class TestGenOpList(unittest.TestCase):
                 "aten::mul": ["default"],
             },
             False,
+            None,
         )
 
     @patch("executorch.codegen.tools.gen_oplist._get_operators")
@@ -137,6 +139,7 @@ class TestGenOpList(unittest.TestCase):
                 "aten::mul.out": ["default"],
             },
             False,
+            None,
         )
 
     @patch("executorch.codegen.tools.gen_oplist._dump_yaml")
@@ -157,6 +160,7 @@ class TestGenOpList(unittest.TestCase):
             None,
             {"aten::add": ["default"], "aten::mul": ["default"]},
             True,
+            None,
         )
 
     def test_get_custom_build_selector_with_both_allowlist_and_yaml(
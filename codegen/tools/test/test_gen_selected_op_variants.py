@@ -202,3 +202,75 @@ inline constexpr bool should_include_kernel_dtype(
 }
 """,
             )
+
+
+class TestGenSelectedOpVariants_StaticSizes(expecttest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.temp_dir.cleanup)
+        self.selected_ops_yaml = os.path.join(
+            self.temp_dir.name, "selected_operators.yaml"
+        )
+        with open(self.selected_ops_yaml, "w") as f:
+            f.write(
+                """
+include_all_non_op_selectives: False
+include_all_operators: False
+operators:
+  aten::add.out:
+    is_root_operator: Yes
+    is_used_for_training: Yes
+    include_all_overloads: No
+kernel_metadata: {}
+et_kernel_metadata:
+  aten::add.out:
+      - v1/6;0,1|6;0,1|6;0,1  # Float, 0, 1
+  aten::mul.out:
+      - v1/6;0,1|6;0,1|6;0,1  # Float, 0, 1
+et_kernel_static_sizes:
+  aten::add.out: [16]
+  # Called with two sizes, so it isn't specialized.
+  aten::mul.out: [3, 4]
+build_features: []
+custom_classes: []
+            """
+            )
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def test_generates_correct_header(self) -> None:
+        gen_selected_op_variants.write_selected_op_variants(
+            os.path.join(self.temp_dir.name, "selected_operators.yaml"),
+            self.temp_dir.name,
+        )
+        with open(
+            os.path.join(self.temp_dir.name, "selected_op_variants.h"), "r"
+        ) as result:
+            self.assertExpectedInline(
+                result.read(),
+                """#pragma once
+/**
+ * Generated by executorch/codegen/tools/gen_selected_op_variants.py
+ */
+
+inline constexpr bool should_include_kernel_dtype(
+  const char *operator_name,
+  executorch::aten::ScalarType scalar_type
+) {
+  return ((executorch::aten::string_view(operator_name).compare("add.out") == 0)
+        && (scalar_type == executorch::aten::ScalarType::Float))
+ || ((executorch::aten::string_view(operator_name).compare("mul.out") == 0)
+        && (scalar_type == executorch::aten::ScalarType::Float));
+}
+
+#define EXECUTORCH_SELECTIVE_BUILD_STATIC_SIZES
+
+inline constexpr int64_t kernel_static_inner_size(
+  const char *operator_name
+) {
+  return (executorch::aten::string_view(operator_name).compare("add.out") == 0) ? 16
+    : 0;
+}
+""",
+            )
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/bundled_program/batch_verification.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <executorch/runtime/platform/log.h>
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Method;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace bundled_program {
+
+namespace {
+
+TestCaseResult run_test_case(
+    Method& method,
+    size_t method_idx,
+    SerializedBundledProgram* bundled_program_ptr,
+    size_t testset_idx,
+    double rtol,
+    double atol) {
+  TestCaseResult result;
+  result.testset_idx = testset_idx;
+  result.method_idx = method_idx;
+  result.status = load_bundled_input(method, bundled_program_ptr, testset_idx);
+  if (result.status != Error::Ok) {
+    return result;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  result.status = method.execute();
+  const auto end = std::chrono::steady_clock::now();
+  result.latency_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
+  if (result.status != Error::Ok) {
+    return result;
+  }
+
+  auto output_error = compute_method_output_error(
+      method, bundled_program_ptr, testset_idx, rtol, atol);
+  if (!output_error.ok()) {
+    result.status = output_error.error();
+    return result;
+  }
+  result.output_error = output_error.get();
+  if (result.output_error.num_mismatched > 0) {
+    result.status = Error::NotFound;
+  }
+  return result;
+}
+
+} // namespace
+
+ET_NODISCARD Result<std::vector<TestCaseResult>> verify_all_test_cases(
+    Span<Method* const> methods,
+    SerializedBundledProgram* bundled_program_ptr,
+    double rtol,
+    double atol) {
+  ET_CHECK_OR_RETURN_ERROR(
+      methods.size() > 0, InvalidArgument, "No Method to verify");
+  const char* method_name = methods[0]->method_meta().name();
+  for (Method* method : methods) {
+    ET_CHECK_OR_RETURN_ERROR(
+        std::strcmp(method->method_meta().name(), method_name) == 0,
+        InvalidArgument,
+        "Method instances must all be '%s', got '%s'",
+        method_name,
+        method->method_meta().name());
+  }
+  auto num_test_cases = get_num_test_cases(bundled_program_ptr, method_name);
+  if (!num_test_cases.ok()) {
+    return num_test_cases.error();
+  }
+
+  std::vector<TestCaseResult> results(num_test_cases.get());
+  // Each instance takes the next test set that has not started.
+  std::atomic<size_t> next_testset_idx{0};
+  const auto worker = [&](size_t method_idx) {
+    for (size_t i = next_testset_idx++; i < results.size();
+         i = next_testset_idx++) {
+      results[i] = run_test_case(
+          *methods[method_idx], method_idx, bundled_program_ptr, i, rtol, atol);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(methods.size() - 1);
+  for (size_t method_idx = 1; method_idx < methods.size(); ++method_idx) {
+    threads.emplace_back(worker, method_idx);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t num_failed = 0;
+  for (const auto& result : results) {
+    num_failed += result.status == Error::Ok ? 0 : 1;
+  }
+  ET_LOG(
+      Info,
+      "Verified %zu test sets of '%s' on %zu instances: %zu failed",
+      results.size(),
+      method_name,
+      methods.size(),
+      num_failed);
+  return results;
+}
+
+} // namespace bundled_program
+} // namespace executorch
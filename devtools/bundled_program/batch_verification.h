@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <executorch/devtools/bundled_program/bundled_program.h>
+#include <executorch/runtime/core/span.h>
+
+namespace executorch {
+namespace bundled_program {
+
+/// The outcome of running one bundled test set.
+struct TestCaseResult {
+  /// The index of the test set in the Method's test suite.
+  size_t testset_idx = 0;
+  /// The index of the Method instance that ran the test set.
+  size_t method_idx = 0;
+  /**
+   * Error::Ok if the outputs matched the expected outputs, Error::NotFound if
+   * they did not (as verify_method_outputs() reports it), or the error that
+   * stopped loading the inputs, executing or comparing the outputs.
+   */
+  ::executorch::runtime::Error status = ::executorch::runtime::Error::Ok;
+  /// The wall time of Method::execute(), in nanoseconds.
+  uint64_t latency_ns = 0;
+  /// The numeric error of the outputs. Zero unless they could be compared.
+  OutputError output_error;
+};
+
+/**
+ * Runs every bundled test set of a Method and compares its outputs with the
+ * expected ones, reporting the latency and numeric error of each.
+ *
+ * The test sets are spread across `methods`, which must be separately loaded
+ * instances of the same Method, each with its own memory. With more than one
+ * instance, the test sets run in parallel on one thread per instance; the
+ * calling thread drives the first instance.
+ *
+ * @param[in] methods The Method instances to run the test sets on.
+ * @param[in] bundled_program_ptr The bundled program holding the test sets.
+ * @param[in] rtol Relative tolerance used for data comparison.
+ * @param[in] atol Absolute tolerance used for data comparison.
+ *
+ * @returns One result per test set, in test set order, or the error that
+ * prevented running them. A failing test set does not stop the others.
+ */
+ET_NODISCARD ::executorch::runtime::Result<std::vector<TestCaseResult>>
+verify_all_test_cases(
+    ::executorch::runtime::Span<::executorch::runtime::Method* const> methods,
+    SerializedBundledProgram* bundled_program_ptr,
+    double rtol = 1e-5,
+    double atol = 1e-8);
+
+} // namespace bundled_program
+} // namespace executorch
@@ -8,6 +8,8 @@
 
 #include <executorch/devtools/bundled_program/bundled_program.h>
 
+#include <algorithm>
+#include <cinttypes>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -227,8 +229,7 @@ bool tensors_are_close(
 Result<bundled_program_flatbuffer::BundledMethodTestSuite*>
 get_method_test_suite(
     const bundled_program_flatbuffer::BundledProgram* bundled_program,
-    Method& method) {
-  const char* method_name = method.method_meta().name();
+    const char* method_name) {
   auto method_test_suites = bundled_program->method_test_suites();
   for (size_t i = 0; i < method_test_suites->size(); i++) {
     auto m_test = method_test_suites->GetMutableObject(i);
@@ -240,6 +241,109 @@ get_method_test_suite(
   return Error::InvalidArgument;
 }
 
+Result<bundled_program_flatbuffer::BundledMethodTestSuite*>
+get_method_test_suite(
+    const bundled_program_flatbuffer::BundledProgram* bundled_program,
+    Method& method) {
+  return get_method_test_suite(bundled_program, method.method_meta().name());
+}
+
+/**
+ * Adds the differences between the expected and actual elements to `error`.
+ * Elements are converted to U before comparison.
+ */
+template <typename T, typename U = T>
+void accumulate_error(
+    const T* expected,
+    const T* actual,
+    size_t numel,
+    double rtol,
+    double atol,
+    OutputError& error) {
+  for (size_t i = 0; i < numel; i++) {
+    const U e = static_cast<U>(expected[i]);
+    const U a = static_cast<U>(actual[i]);
+    const bool close = elem_is_close(e, a, rtol, atol);
+    error.num_mismatched += close ? 0 : 1;
+    if (close && !std::isfinite(e)) {
+      // Matching NaN or infinity.
+      continue;
+    }
+    double abs_error =
+        std::abs(static_cast<double>(a) - static_cast<double>(e));
+    if (std::isnan(abs_error)) {
+      // Only one of the elements is NaN.
+      abs_error = INFINITY;
+    }
+    error.max_abs_error = std::max(error.max_abs_error, abs_error);
+    if (std::isfinite(e) && e != 0) {
+      error.max_rel_error = std::max(
+          error.max_rel_error, abs_error / std::abs(static_cast<double>(e)));
+    }
+  }
+}
+
+// Adds the differences between the expected and actual tensors to `error`.
+Error accumulate_tensor_error(
+    const Tensor& expected,
+    const Tensor& actual,
+    double rtol,
+    double atol,
+    OutputError& error) {
+  ET_CHECK_OR_RETURN_ERROR(
+      expected.scalar_type() == actual.scalar_type() &&
+          expected.sizes() == actual.sizes(),
+      InvalidArgument,
+      "Method's output dtype or shape mismatched the expected one.");
+  if (expected.nbytes() == 0) {
+    return Error::Ok;
+  }
+  const size_t numel = expected.numel();
+  switch (expected.scalar_type()) {
+    case ScalarType::Float:
+      accumulate_error(
+          expected.const_data_ptr<float>(),
+          actual.const_data_ptr<float>(),
+          numel,
+          rtol,
+          atol,
+          error);
+      break;
+    case ScalarType::Double:
+      accumulate_error(
+          expected.const_data_ptr<double>(),
+          actual.const_data_ptr<double>(),
+          numel,
+          rtol,
+          atol,
+          error);
+      break;
+    case ScalarType::Half:
+      accumulate_error<Half, double>(
+          expected.const_data_ptr<Half>(),
+          actual.const_data_ptr<Half>(),
+          numel,
+          rtol,
+          atol,
+          error);
+      break;
+    default: {
+      // Non-floating-point elements are compared bitwise and only counted.
+      const size_t element_size = expected.nbytes() / numel;
+      const auto* e = static_cast<const uint8_t*>(expected.const_data_ptr());
+      const auto* a = static_cast<const uint8_t*>(actual.const_data_ptr());
+      for (size_t i = 0; i < numel; i++) {
+        if (memcmp(e + i * element_size, a + i * element_size, element_size) !=
+            0) {
+          error.num_mismatched++;
+        }
+      }
+      break;
+    }
+  }
+  return Error::Ok;
+}
+
 } // namespace
 
 // Load testset_idx-th bundled data into the Method
@@ -404,6 +508,98 @@ ET_NODISCARD Error verify_method_outputs(
   return Error::Ok;
 }
 
+ET_NODISCARD Result<size_t> get_num_test_cases(
+    SerializedBundledProgram* bundled_program_ptr,
+    const char* method_name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      bundled_program_flatbuffer::BundledProgramBufferHasIdentifier(
+          bundled_program_ptr),
+      NotSupported,
+      "The input buffer should be a bundled program.");
+
+  auto method_test = get_method_test_suite(
+      bundled_program_flatbuffer::GetBundledProgram(bundled_program_ptr),
+      method_name);
+
+  if (!method_test.ok()) {
+    return method_test.error();
+  }
+  return method_test.get()->test_cases()->size();
+}
+
+ET_NODISCARD Result<OutputError> compute_method_output_error(
+    Method& method,
+    SerializedBundledProgram* bundled_program_ptr,
+    size_t testset_idx,
+    double rtol,
+    double atol) {
+  ET_CHECK_OR_RETURN_ERROR(
+      bundled_program_flatbuffer::BundledProgramBufferHasIdentifier(
+          bundled_program_ptr),
+      NotSupported,
+      "The input buffer should be a bundled program.");
+
+  auto method_test = get_method_test_suite(
+      bundled_program_flatbuffer::GetBundledProgram(bundled_program_ptr),
+      method);
+
+  if (!method_test.ok()) {
+    return method_test.error();
+  }
+
+  auto test_cases = method_test.get()->test_cases();
+  ET_CHECK_OR_RETURN_ERROR(
+      testset_idx < test_cases->size(),
+      InvalidArgument,
+      "Test set index %zu out of range for %" PRIu32 " test sets",
+      testset_idx,
+      test_cases->size());
+  auto bundled_expected_outputs =
+      test_cases->Get(testset_idx)->expected_outputs();
+
+  if (bundled_expected_outputs->size() == 0) {
+    // No bundled expected outputs, so we can't verify the method outputs.
+    return Error::NotSupported;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      bundled_expected_outputs->size() == method.outputs_size(),
+      InvalidArgument,
+      "Method has %zu outputs but the test set expects %" PRIu32,
+      method.outputs_size(),
+      bundled_expected_outputs->size());
+
+  OutputError error;
+  for (size_t output_idx = 0; output_idx < method.outputs_size();
+       output_idx++) {
+    auto bundled_expected_output =
+        bundled_expected_outputs->GetMutableObject(output_idx);
+    auto method_output = method.get_output(output_idx);
+    ET_CHECK_OR_RETURN_ERROR(
+        bundled_expected_output->val_type() ==
+                bundled_program_flatbuffer::ValueUnion::Tensor &&
+            method_output.isTensor(),
+        NotSupported,
+        "Data type %hhd not supported",
+        static_cast<uint8_t>(bundled_expected_output->val_type()));
+    auto bundled_expected_output_tensor =
+        static_cast<bundled_program_flatbuffer::Tensor*>(
+            bundled_expected_output->mutable_val());
+
+#ifdef USE_ATEN_LIB
+    Tensor t = tensor_like(bundled_expected_output_tensor);
+#else // !USE_ATEN_LIB
+    TensorImpl impl = impl_like(bundled_expected_output_tensor);
+    Tensor t = Tensor(&impl);
+#endif
+    Error status = accumulate_tensor_error(
+        t, method_output.toTensor(), rtol, atol, error);
+    if (status != Error::Ok) {
+      return status;
+    }
+  }
+  return error;
+}
+
 ET_NODISCARD Error get_program_data(
     void* file_data,
     size_t file_data_len,
@@ -55,6 +55,61 @@ ET_NODISCARD ::executorch::runtime::Error verify_method_outputs(
     double rtol = 1e-5,
     double atol = 1e-8);
 
+/**
+ * The numeric difference between a Method's outputs and the expected outputs
+ * of a bundled test set.
+ */
+struct OutputError {
+  /// The largest absolute difference between an output element and its
+  /// expected value. Infinite if only one of them is NaN.
+  double max_abs_error = 0;
+  /// The largest absolute difference relative to the magnitude of the
+  /// expected value, over the elements whose expected value is finite and
+  /// nonzero.
+  double max_rel_error = 0;
+  /// The number of output elements that are not close to their expected
+  /// value under the given tolerances.
+  size_t num_mismatched = 0;
+};
+
+/**
+ * Returns the number of test sets in the test suite of the named Method.
+ *
+ * @param[in] bundled_program_ptr The bundled program.
+ * @param[in] method_name The name of the Method.
+ *
+ * @returns The number of test sets, or Error::InvalidArgument if the bundled
+ * program has no tests for the Method.
+ */
+ET_NODISCARD ::executorch::runtime::Result<size_t> get_num_test_cases(
+    SerializedBundledProgram* bundled_program_ptr,
+    const char* method_name);
+
+/**
+ * Measures how far the Method's outputs are from the testset_idx-th bundled
+ * expected output. Unlike verify_method_outputs(), a mismatch is not an
+ * error; it is reported in OutputError::num_mismatched.
+ *
+ * Floating point outputs contribute to the absolute and relative errors.
+ * Other outputs are compared bitwise and only counted as mismatched.
+ *
+ * @param[in] method The Method to extract outputs from.
+ * @param[in] bundled_program_ptr The bundled program contains expected output.
+ * @param[in] testset_idx  The index of expected output needs to be compared.
+ * @param[in] rtol Relative tolerance used to count mismatched elements.
+ * @param[in] atol Absolute tolerance used to count mismatched elements.
+ *
+ * @returns The error of the outputs, or the error that prevented comparing
+ * them, e.g. Error::InvalidArgument if an output has another dtype or shape.
+ */
+ET_NODISCARD ::executorch::runtime::Result<OutputError>
+compute_method_output_error(
+    ::executorch::runtime::Method& method,
+    SerializedBundledProgram* bundled_program_ptr,
+    size_t testset_idx,
+    double rtol = 1e-5,
+    double atol = 1e-8);
+
 /**
  * Finds the serialized ExecuTorch program data in the provided bundled program
  * file data.
@@ -26,3 +26,20 @@ def define_common_targets():
                 "//executorch/runtime/executor:program" + aten_suffix,
             ],
         )
+
+        runtime.cxx_library(
+            name = "batch_verification" + aten_suffix,
+            srcs = ["batch_verification.cpp"],
+            exported_headers = ["batch_verification.h"],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+            deps = [
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                ":runtime" + aten_suffix,
+                "//executorch/runtime/core:core",
+            ],
+        )
@@ -59,3 +59,7 @@ class ValueNode(Node):
 @dataclass
 class OperatorNode(Node):
     op: Optional[str] = None
+    # Estimated floating point operations, for the ops they are known for
+    flops: Optional[int] = None
+    # Estimated bytes read and written, from the sizes of the tensors
+    bytes_accessed: Optional[int] = None
@@ -292,6 +292,8 @@ class FXOperatorGraph(OperatorGraph):
                     metadata=metadata,
                     op=FXOperatorGraph._get_op_name(fx_node),
                     named_args=named_args,
+                    flops=FXOperatorGraph._estimate_flops(fx_node),
+                    bytes_accessed=FXOperatorGraph._estimate_bytes_accessed(fx_node),
                 )
                 if enable_module_hierarchy:
                     FXOperatorGraph._update_module_mapping(
@@ -419,3 +421,84 @@ class FXOperatorGraph(OperatorGraph):
             return dtypes
         else:
             return None
+
+    # Yield the tensors of an fx node value, which is a tensor or a list/tuple of them
+    @staticmethod
+    def _iter_tensors(val: Any):
+        if isinstance(val, (FakeTensor, torch.Tensor)):
+            yield val
+        elif isinstance(val, (list, tuple)):
+            for item in val:
+                yield from FXOperatorGraph._iter_tensors(item)
+
+    # Estimate the bytes an op reads and writes, i.e. the size of its input and output
+    # tensors, assuming each one is accessed once
+    @staticmethod
+    def _estimate_bytes_accessed(node: torch.fx.Node) -> Optional[int]:
+        tensors = []
+        for arg in [*node.args, *node.kwargs.values()]:
+            args = arg if isinstance(arg, (list, tuple)) else [arg]
+            for list_arg in args:
+                # Memory planned out args are the same tensors as the outputs
+                if (
+                    isinstance(list_arg, torch.fx.Node)
+                    and list_arg.target != exir.memory.alloc
+                ):
+                    tensors += FXOperatorGraph._iter_tensors(list_arg.meta.get("val"))
+        tensors += FXOperatorGraph._iter_tensors(node.meta.get("val"))
+        if len(tensors) == 0:
+            return None
+        return sum(tensor.numel() * tensor.element_size() for tensor in tensors)
+
+    # Estimate the floating point operations of the compute heavy ops from their
+    # shapes, counting a multiply-add as 2 FLOPs. Returns None for other ops.
+    @staticmethod
+    def _estimate_flops(node: torch.fx.Node) -> Optional[int]:  # noqa: C901
+        if not hasattr(node.target, "_schema"):
+            return None
+        # pyre-ignore[16]: has no attribute `_schema`.
+        op_name = node.target._schema.name.split("::")[-1]
+
+        def arg_val(index: int) -> Any:
+            arg = node.args[index] if len(node.args) > index else None
+            return arg.meta.get("val") if isinstance(arg, torch.fx.Node) else None
+
+        # Indices of the tensor args the estimate needs
+        required_args = {
+            "mm": (0,),
+            "bmm": (0,),
+            "addmm": (1,),
+            "linear": (0,),
+            "convolution": (0, 1),
+            "scaled_dot_product_attention": (0, 1, 2),
+        }
+        out = next(FXOperatorGraph._iter_tensors(node.meta.get("val")), None)
+        if (
+            op_name not in required_args
+            or out is None
+            or any(arg_val(index) is None for index in required_args[op_name])
+        ):
+            return None
+
+        if op_name in ("mm", "bmm"):
+            return 2 * out.numel() * arg_val(0).shape[-1]
+        elif op_name == "addmm":
+            return 2 * out.numel() * arg_val(1).shape[-1] + out.numel()
+        elif op_name == "linear":
+            bias = out.numel() if arg_val(2) is not None else 0
+            return 2 * out.numel() * arg_val(0).shape[-1] + bias
+        elif op_name == "convolution":
+            weight = arg_val(1)
+            # Weights are [C_out, C_in / groups, *kernel], or [C_in, C_out / groups,
+            # *kernel] when transposed, so each output (input when transposed)
+            # element takes weight.numel() / weight.shape[0] multiply-adds.
+            transposed = len(node.args) > 6 and node.args[6]
+            elements = arg_val(0).numel() if transposed else out.numel()
+            bias = out.numel() if arg_val(2) is not None else 0
+            return 2 * elements * (weight.numel() // weight.shape[0]) + bias
+        elif op_name == "scaled_dot_product_attention":
+            # q is [..., L, E], k [..., S, E] and v [..., S, E_v]
+            q, k, v = arg_val(0), arg_val(1), arg_val(2)
+            batch_l = q.numel() // q.shape[-1]
+            return 2 * batch_l * k.shape[-2] * (q.shape[-1] + v.shape[-1])
+        return None
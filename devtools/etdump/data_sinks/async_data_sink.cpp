@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/data_sinks/async_data_sink.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace etdump {
+
+AsyncDataSink::AsyncDataSink(DataSinkBase* sink, Span<uint8_t> buffer)
+    : sink_(sink), buffer_(buffer), base_offset_(sink->get_used_bytes()) {
+  thread_ = std::thread([this]() { writer_loop(); });
+}
+
+AsyncDataSink::~AsyncDataSink() {
+  flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  data_cv_.notify_all();
+  thread_.join();
+}
+
+Result<size_t> AsyncDataSink::write(const void* ptr, size_t length) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (error_ != Error::Ok) {
+    return error_;
+  }
+  const size_t offset = base_offset_ + queued_bytes_;
+  if (length == 0) {
+    return offset;
+  }
+
+  if (length > buffer_.size()) {
+    // Too large to queue: write it directly once the queue has drained.
+    space_cv_.wait(lock, [this]() { return written_bytes_ == queued_bytes_; });
+    Result<size_t> ret = sink_->write(ptr, length);
+    if (!ret.ok()) {
+      error_ = ret.error();
+      return error_;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        ret.get() == offset,
+        Internal,
+        "Sink wrote at offset %zu instead of %zu",
+        ret.get(),
+        offset);
+    queued_bytes_ += length;
+    written_bytes_ += length;
+    return offset;
+  }
+
+  space_cv_.wait(lock, [this, length]() {
+    return buffer_.size() - (queued_bytes_ - written_bytes_) >= length;
+  });
+  // Only this thread queues data, so the space stays free while copying.
+  const size_t start = queued_bytes_ % buffer_.size();
+  lock.unlock();
+  const size_t first = std::min(length, buffer_.size() - start);
+  memcpy(buffer_.data() + start, ptr, first);
+  memcpy(
+      buffer_.data(),
+      static_cast<const uint8_t*>(ptr) + first,
+      length - first);
+  lock.lock();
+  queued_bytes_ += length;
+  lock.unlock();
+  data_cv_.notify_one();
+  return offset;
+}
+
+size_t AsyncDataSink::get_used_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return base_offset_ + queued_bytes_;
+}
+
+Error AsyncDataSink::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  space_cv_.wait(lock, [this]() { return written_bytes_ == queued_bytes_; });
+  return error_;
+}
+
+void AsyncDataSink::writer_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    data_cv_.wait(lock, [this]() {
+      return stopping_ || written_bytes_ != queued_bytes_;
+    });
+    if (written_bytes_ == queued_bytes_) {
+      return;
+    }
+    // Write up to the end of the queued data or of the ring buffer.
+    const size_t start = written_bytes_ % buffer_.size();
+    const size_t length =
+        std::min(queued_bytes_ - written_bytes_, buffer_.size() - start);
+    const size_t offset = base_offset_ + written_bytes_;
+    lock.unlock();
+    Result<size_t> ret = sink_->write(buffer_.data() + start, length);
+    lock.lock();
+    if (error_ == Error::Ok) {
+      if (!ret.ok()) {
+        error_ = ret.error();
+      } else if (ret.get() != offset) {
+        ET_LOG(
+            Error,
+            "Sink wrote at offset %zu instead of %zu",
+            ret.get(),
+            offset);
+        error_ = Error::Internal;
+      }
+    }
+    written_bytes_ += length;
+    space_cv_.notify_all();
+  }
+}
+
+} // namespace etdump
+} // namespace executorch
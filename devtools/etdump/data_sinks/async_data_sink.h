@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <executorch/devtools/etdump/data_sinks/data_sink_base.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/span.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * AsyncDataSink moves the cost of storing debug data off the thread that
+ * runs the model. write() copies the data into a ring buffer and returns
+ * right away; a background thread then writes it to the wrapped sink in
+ * order. write() only blocks when the ring buffer is full, and writes larger
+ * than the ring buffer go to the wrapped sink directly once it has drained.
+ *
+ * Offsets are assigned as the data is queued, so the wrapped sink must
+ * store writes back to back without padding, like FileDataSink or a
+ * BufferDataSink with an alignment of 1. A mismatching offset is reported as
+ * Error::Internal.
+ *
+ * write() may be called from one thread at a time. Call flush() before
+ * reading what the wrapped sink holds.
+ */
+class AsyncDataSink : public DataSinkBase {
+ public:
+  /**
+   * Creates an AsyncDataSink that forwards to `sink`.
+   *
+   * @param[in] sink The sink to write to. Must outlive the AsyncDataSink and
+   *     not be written to by anything else meanwhile.
+   * @param[in] buffer The ring buffer holding the queued data. Must outlive
+   *     the AsyncDataSink.
+   */
+  AsyncDataSink(
+      DataSinkBase* sink,
+      ::executorch::runtime::Span<uint8_t> buffer);
+
+  /**
+   * Writes the queued data to the wrapped sink and stops the background
+   * thread.
+   */
+  ~AsyncDataSink() override;
+
+  AsyncDataSink(const AsyncDataSink&) = delete;
+  AsyncDataSink& operator=(const AsyncDataSink&) = delete;
+  AsyncDataSink(AsyncDataSink&&) = delete;
+  AsyncDataSink& operator=(AsyncDataSink&&) = delete;
+
+  /**
+   * Queues data to be written to the wrapped sink.
+   *
+   * @param[in] ptr A pointer to the data. It is copied before the call
+   *     returns.
+   * @param[in] length The size of the data in bytes.
+   * @return A Result object containing either:
+   *         - The offset the data will have in the wrapped sink, or
+   *         - The first error the wrapped sink returned, if any.
+   */
+  ::executorch::runtime::Result<size_t> write(const void* ptr, size_t length)
+      override;
+
+  /**
+   * Gets the number of bytes the wrapped sink holds once the queued data is
+   * written.
+   */
+  size_t get_used_bytes() const override;
+
+  /**
+   * Waits until all the queued data has been written to the wrapped sink.
+   *
+   * @return Error::Ok, or the first error the wrapped sink returned.
+   */
+  ::executorch::runtime::Error flush();
+
+ private:
+  void writer_loop();
+
+  DataSinkBase* sink_;
+  ::executorch::runtime::Span<uint8_t> buffer_;
+  // The used bytes of the sink when the AsyncDataSink was created.
+  size_t base_offset_;
+
+  mutable std::mutex mutex_;
+  // Signals the writer thread that data was queued or it should stop.
+  std::condition_variable data_cv_;
+  // Signals writers that data left the ring buffer.
+  std::condition_variable space_cv_;
+  // The bytes queued and written since creation. The ring buffer holds
+  // [written_bytes_, queued_bytes_), wrapping around its end.
+  size_t queued_bytes_ = 0;
+  size_t written_bytes_ = 0;
+  ::executorch::runtime::Error error_ = ::executorch::runtime::Error::Ok;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/data_sinks/async_data_sink.h>
+#include <executorch/devtools/etdump/data_sinks/buffer_data_sink.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using ::executorch::etdump::AsyncDataSink;
+using ::executorch::etdump::BufferDataSink;
+using ::executorch::etdump::DataSinkBase;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace {
+
+// A sink that fails every write.
+class FailingDataSink : public DataSinkBase {
+ public:
+  Result<size_t> write(const void*, size_t) override {
+    return Error::OutOfResources;
+  }
+  size_t get_used_bytes() const override {
+    return 0;
+  }
+};
+
+} // namespace
+
+class AsyncDataSinkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    storage_.resize(1024);
+    // Alignment 1 stores writes back to back, as AsyncDataSink requires.
+    Result<BufferDataSink> sink =
+        BufferDataSink::create(storage_.data(), storage_.size(), 1);
+    ASSERT_EQ(sink.error(), Error::Ok);
+    sink_ = std::make_unique<BufferDataSink>(std::move(sink.get()));
+  }
+
+  std::vector<uint8_t> storage_;
+  std::unique_ptr<BufferDataSink> sink_;
+};
+
+TEST_F(AsyncDataSinkTest, WritesInOrderAcrossRingBufferWrapAround) {
+  uint8_t ring[16];
+  AsyncDataSink async_sink(sink_.get(), Span<uint8_t>(ring, sizeof(ring)));
+
+  std::vector<uint8_t> expected;
+  for (uint8_t i = 0; i < 20; ++i) {
+    // Sizes from 1 to 11 bytes wrap around the 16-byte ring.
+    std::vector<uint8_t> data(i % 11 + 1, i);
+    Result<size_t> offset = async_sink.write(data.data(), data.size());
+    ASSERT_EQ(offset.error(), Error::Ok);
+    EXPECT_EQ(offset.get(), expected.size());
+    expected.insert(expected.end(), data.begin(), data.end());
+  }
+  EXPECT_EQ(async_sink.get_used_bytes(), expected.size());
+
+  ASSERT_EQ(async_sink.flush(), Error::Ok);
+  ASSERT_EQ(sink_->get_used_bytes(), expected.size());
+  EXPECT_EQ(memcmp(storage_.data(), expected.data(), expected.size()), 0);
+}
+
+TEST_F(AsyncDataSinkTest, WritesLargerThanRingBufferGoDirectly) {
+  uint8_t ring[8];
+  AsyncDataSink async_sink(sink_.get(), Span<uint8_t>(ring, sizeof(ring)));
+
+  const std::vector<uint8_t> small(4, 1);
+  const std::vector<uint8_t> large(100, 2);
+  ASSERT_EQ(async_sink.write(small.data(), small.size()).get(), 0);
+  ASSERT_EQ(async_sink.write(large.data(), large.size()).get(), 4);
+  ASSERT_EQ(async_sink.write(small.data(), small.size()).get(), 104);
+
+  ASSERT_EQ(async_sink.flush(), Error::Ok);
+  EXPECT_EQ(sink_->get_used_bytes(), 108);
+  EXPECT_EQ(storage_[3], 1);
+  EXPECT_EQ(storage_[4], 2);
+  EXPECT_EQ(storage_[103], 2);
+  EXPECT_EQ(storage_[104], 1);
+}
+
+TEST_F(AsyncDataSinkTest, DestructorFlushes) {
+  {
+    uint8_t ring[64];
+    AsyncDataSink async_sink(sink_.get(), Span<uint8_t>(ring, sizeof(ring)));
+    const uint8_t data[] = {1, 2, 3};
+    ASSERT_EQ(async_sink.write(data, sizeof(data)).error(), Error::Ok);
+  }
+  EXPECT_EQ(sink_->get_used_bytes(), 3);
+  EXPECT_EQ(storage_[2], 3);
+}
+
+TEST_F(AsyncDataSinkTest, ReportsSinkErrors) {
+  FailingDataSink failing_sink;
+  uint8_t ring[64];
+  AsyncDataSink async_sink(&failing_sink, Span<uint8_t>(ring, sizeof(ring)));
+  const uint8_t data[] = {1, 2, 3};
+
+  // The first write is queued before the sink fails.
+  ASSERT_EQ(async_sink.write(data, sizeof(data)).error(), Error::Ok);
+  EXPECT_EQ(async_sink.flush(), Error::OutOfResources);
+  EXPECT_EQ(
+      async_sink.write(data, sizeof(data)).error(), Error::OutOfResources);
+}
+
+TEST_F(AsyncDataSinkTest, ReportsPaddingSinks) {
+  // The default alignment pads writes, so offsets no longer match.
+  alignas(64) uint8_t padded_storage[256];
+  Result<BufferDataSink> padding_sink =
+      BufferDataSink::create(padded_storage, sizeof(padded_storage));
+  ASSERT_EQ(padding_sink.error(), Error::Ok);
+  uint8_t ring[64];
+  AsyncDataSink async_sink(
+      &padding_sink.get(), Span<uint8_t>(ring, sizeof(ring)));
+  const uint8_t data[] = {1, 2, 3};
+
+  ASSERT_EQ(async_sink.write(data, sizeof(data)).error(), Error::Ok);
+  ASSERT_EQ(async_sink.flush(), Error::Ok);
+  ASSERT_EQ(async_sink.write(data, sizeof(data)).error(), Error::Ok);
+  EXPECT_EQ(async_sink.flush(), Error::Internal);
+}
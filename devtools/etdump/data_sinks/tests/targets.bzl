@@ -21,3 +21,14 @@ def define_common_targets():
 
     define_data_sink_test("buffer_data_sink")
     define_data_sink_test("file_data_sink")
+
+    runtime.cxx_test(
+        name = "async_data_sink_test",
+        srcs = [
+            "async_data_sink_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump/data_sinks:async_data_sink",
+            "//executorch/devtools/etdump/data_sinks:buffer_data_sink",
+        ],
+    )
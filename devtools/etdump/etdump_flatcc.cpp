@@ -27,6 +27,7 @@ using ::executorch::runtime::ArrayRef;
 using ::executorch::runtime::ChainID;
 using ::executorch::runtime::DebugHandle;
 using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
 using ::executorch::runtime::EventTracerEntry;
 using ::executorch::runtime::LoggedEValueType;
@@ -73,7 +74,7 @@ executorch_flatbuffer_ScalarType_enum_t get_flatbuffer_scalar_type(
 etdump_Tensor_ref_t add_tensor_entry(
     flatcc_builder_t* builder_,
     const executorch::aten::Tensor& tensor,
-    long offset) {
+    const internal::CapturedTensor& captured) {
   etdump_Tensor_start(builder_);
 
   etdump_Tensor_scalar_type_add(
@@ -92,11 +93,34 @@ etdump_Tensor_ref_t add_tensor_entry(
     etdump_Tensor_strides_push(builder_, &cast_dim);
   }
   etdump_Tensor_strides_end(builder_);
-  etdump_Tensor_offset_add(builder_, offset);
+  etdump_Tensor_offset_add(builder_, captured.offset);
+  if (captured.has_stats) {
+    etdump_Tensor_stats_add(
+        builder_,
+        etdump_TensorStats_create(
+            builder_,
+            captured.stats.min,
+            captured.stats.max,
+            captured.stats.mean,
+            captured.stats.nan_count));
+  }
+  etdump_Tensor_sample_stride_add(builder_, captured.sample_stride);
 
   return etdump_Tensor_end(builder_);
 }
 
+etdump_PerfCounters_ref_t add_perf_counters_entry(
+    flatcc_builder_t* builder_,
+    const PerfCounterValues& perf_counters) {
+  return etdump_PerfCounters_create(
+      builder_,
+      perf_counters[PerfCounter::kCycles],
+      perf_counters[PerfCounter::kInstructions],
+      perf_counters[PerfCounter::kL1DCacheMisses],
+      perf_counters[PerfCounter::kLLCMisses],
+      perf_counters[PerfCounter::kBranchMisses]);
+}
+
 } // namespace
 
 // Constructor implementation
@@ -154,6 +178,15 @@ void ETDumpGen::reset() {
 }
 
 void ETDumpGen::create_event_block(const char* name) {
+  if (etdump_sink_ != nullptr && num_blocks_ >= blocks_per_chunk_) {
+    Error error = flush_etdump();
+    if (error != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to stream ETDump with error 0x%" PRIx32,
+          static_cast<uint32_t>(error));
+    }
+  }
   if (state_ == State::AddingEvents) {
     etdump_RunData_events_end(builder_);
   } else if (state_ == State::Done) {
@@ -217,6 +250,7 @@ EventTracerEntry ETDumpGen::start_profiling(
     prof_entry.debug_handle = debug_handle;
   }
   prof_entry.start_time = et_pal_current_ticks();
+  start_perf_counters(prof_entry);
   return prof_entry;
 }
 
@@ -239,6 +273,7 @@ EventTracerEntry ETDumpGen::start_profiling_delegate(
       ? create_string_entry(name)
       : delegate_debug_index;
   prof_entry.start_time = et_pal_current_ticks();
+  start_perf_counters(prof_entry);
   return prof_entry;
 }
 
@@ -247,6 +282,9 @@ void ETDumpGen::end_profiling_delegate(
     const void* metadata,
     size_t metadata_len) {
   et_timestamp_t end_time = et_pal_current_ticks();
+  PerfCounterValues perf_counters;
+  const bool has_perf_counters =
+      end_perf_counters(event_tracer_entry, perf_counters);
   check_ready_to_add_events();
 
   // Start building the ProfileEvent entry.
@@ -269,6 +307,10 @@ void ETDumpGen::end_profiling_delegate(
   flatbuffers_uint8_vec_ref_t vec_ref = flatbuffers_uint8_vec_create_pe(
       builder_, (const uint8_t*)metadata, metadata_len);
   etdump_ProfileEvent_delegate_debug_metadata_add(builder_, vec_ref);
+  if (has_perf_counters) {
+    etdump_ProfileEvent_perf_counters_add(
+        builder_, add_perf_counters_entry(builder_, perf_counters));
+  }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
   etdump_RunData_events_push_start(builder_);
   etdump_Event_profile_event_add(builder_, id);
@@ -371,8 +413,8 @@ void ETDumpGen::log_intermediate_output_delegate_helper(
 
   // Check the type of `output` then call the corresponding logging functions
   if constexpr (std::is_same<T, Tensor>::value) {
-    long offset = write_tensor_or_raise_error(output);
-    etdump_Tensor_ref_t tensor_ref = add_tensor_entry(builder_, output, offset);
+    etdump_Tensor_ref_t tensor_ref =
+        add_tensor_entry(builder_, output, capture_tensor(output));
 
     etdump_Value_start(builder_);
     etdump_Value_val_add(builder_, etdump_ValueType_Tensor);
@@ -381,9 +423,9 @@ void ETDumpGen::log_intermediate_output_delegate_helper(
   } else if constexpr (std::is_same<T, ArrayRef<Tensor>>::value) {
     etdump_Tensor_vec_start(builder_);
     for (size_t i = 0; i < output.size(); ++i) {
-      long offset = write_tensor_or_raise_error(output[i]);
       etdump_Tensor_vec_push(
-          builder_, add_tensor_entry(builder_, output[i], offset));
+          builder_,
+          add_tensor_entry(builder_, output[i], capture_tensor(output[i])));
     }
     etdump_Tensor_vec_ref_t tensor_vec_ref = etdump_Tensor_vec_end(builder_);
     etdump_TensorList_ref_t tensor_list_ref =
@@ -431,15 +473,51 @@ void ETDumpGen::end_profiling(EventTracerEntry prof_entry) {
   ET_CHECK_MSG(
       prof_entry.delegate_event_id_type == DelegateDebugIdType::kNone,
       "Delegate events must use end_profiling_delegate to mark the end of a delegate profiling event.");
+  PerfCounterValues perf_counters;
+  const bool has_perf_counters = end_perf_counters(prof_entry, perf_counters);
+  add_profile_event(
+      prof_entry.event_id,
+      prof_entry.chain_id,
+      prof_entry.debug_handle,
+      prof_entry.start_time,
+      end_time,
+      has_perf_counters ? &perf_counters : nullptr);
+}
+
+void ETDumpGen::log_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  add_profile_event(
+      name != nullptr ? create_string_entry(name) : -1,
+      chain_id,
+      debug_handle,
+      start_time,
+      end_time);
+}
+
+void ETDumpGen::add_profile_event(
+    int64_t string_id,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const PerfCounterValues* perf_counters) {
   check_ready_to_add_events();
 
   etdump_ProfileEvent_start(builder_);
-  etdump_ProfileEvent_start_time_add(builder_, prof_entry.start_time);
+  etdump_ProfileEvent_start_time_add(builder_, start_time);
   etdump_ProfileEvent_end_time_add(builder_, end_time);
-  etdump_ProfileEvent_chain_index_add(builder_, prof_entry.chain_id);
-  etdump_ProfileEvent_instruction_id_add(builder_, prof_entry.debug_handle);
-  if (prof_entry.event_id != -1) {
-    etdump_ProfileEvent_name_add(builder_, prof_entry.event_id);
+  etdump_ProfileEvent_chain_index_add(builder_, chain_id);
+  etdump_ProfileEvent_instruction_id_add(builder_, debug_handle);
+  if (string_id != -1) {
+    etdump_ProfileEvent_name_add(builder_, string_id);
+  }
+  if (perf_counters != nullptr) {
+    etdump_ProfileEvent_perf_counters_add(
+        builder_, add_perf_counters_entry(builder_, *perf_counters));
   }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
   etdump_RunData_events_push_start(builder_);
@@ -515,6 +593,100 @@ void ETDumpGen::set_data_sink(DataSinkBase* data_sink) {
   data_sink_ = data_sink;
 }
 
+void ETDumpGen::set_tensor_capture_mode(
+    TensorCaptureMode mode,
+    Span<uint8_t> sample_buffer) {
+  tensor_capture_mode_ = mode;
+  sample_buffer_ = sample_buffer;
+}
+
+void ETDumpGen::set_etdump_sink(
+    DataSinkBase* etdump_sink,
+    size_t blocks_per_chunk) {
+  ET_CHECK_MSG(blocks_per_chunk > 0, "blocks_per_chunk must be positive");
+  ET_CHECK_MSG(
+      etdump_sink == nullptr || etdump_sink != data_sink_,
+      "The ETDump sink must differ from the debug data sink");
+  etdump_sink_ = etdump_sink;
+  blocks_per_chunk_ = blocks_per_chunk;
+}
+
+void ETDumpGen::set_perf_counter_reader(PerfCounterReader* reader) {
+  perf_counter_reader_ = reader;
+  perf_counter_depth_ = 0;
+}
+
+void ETDumpGen::start_perf_counters(const EventTracerEntry& prof_entry) {
+  if (perf_counter_reader_ == nullptr) {
+    return;
+  }
+  if (perf_counter_depth_ == kMaxPerfCounterDepth) {
+    ET_LOG(Debug, "Events nested too deep to record their counters");
+    return;
+  }
+  PerfCounterStart& start = perf_counter_starts_[perf_counter_depth_];
+  if (perf_counter_reader_->read(start.values) != Error::Ok) {
+    return;
+  }
+  start.event_id = prof_entry.event_id;
+  start.start_time = prof_entry.start_time;
+  ++perf_counter_depth_;
+}
+
+bool ETDumpGen::end_perf_counters(
+    const EventTracerEntry& prof_entry,
+    PerfCounterValues& deltas) {
+  if (perf_counter_reader_ == nullptr || perf_counter_depth_ == 0 ||
+      perf_counter_reader_->read(deltas) != Error::Ok) {
+    return false;
+  }
+  // Events normally end in the reverse order they started in, so the match
+  // is on top of the stack.
+  for (size_t i = perf_counter_depth_; i-- > 0;) {
+    const PerfCounterStart& start = perf_counter_starts_[i];
+    if (start.event_id != prof_entry.event_id ||
+        start.start_time != prof_entry.start_time) {
+      continue;
+    }
+    for (size_t c = 0; c < kNumPerfCounters; ++c) {
+      if (start.values.values[c] != kPerfCounterUnavailable) {
+        deltas.values[c] -= start.values.values[c];
+      }
+    }
+    for (size_t j = i + 1; j < perf_counter_depth_; ++j) {
+      perf_counter_starts_[j - 1] = perf_counter_starts_[j];
+    }
+    --perf_counter_depth_;
+    return true;
+  }
+  return false;
+}
+
+Error ETDumpGen::flush_etdump() {
+  ET_CHECK_OR_RETURN_ERROR(
+      etdump_sink_ != nullptr,
+      InvalidState,
+      "set_etdump_sink() must be called before flush_etdump()");
+  Error error = Error::Ok;
+  if (state_ != State::Done) {
+    ETDumpResult result = get_etdump_data();
+    if (result.buf != nullptr) {
+      error = etdump_sink_->write(result.buf, result.size).error();
+      if (!is_static_etdump()) {
+        free(result.buf);
+      }
+    }
+  }
+  // reset() forgets the debug data sink, which outlives the chunk.
+  DataSinkBase* data_sink = data_sink_;
+  if (is_static_etdump()) {
+    alloc_.reset_output();
+  }
+  reset();
+  data_sink_ = data_sink;
+  return error;
+}
+
 void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
   check_ready_to_add_events();
 
@@ -526,9 +698,11 @@ void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
   switch (evalue.tag) {
     case Tag::Tensor: {
       executorch::aten::Tensor tensor = evalue.toTensor();
-      long offset = write_tensor_or_raise_error(tensor);
-      etdump_Tensor_ref_t tensor_ref =
-          add_tensor_entry(builder_, tensor, offset);
+      etdump_Tensor_ref_t tensor_ref = add_tensor_entry(
+          builder_,
+          tensor,
+          capture_tensor(
+              tensor, evalue_type == LoggedEValueType::kProgramOutput));
 
       etdump_Value_start(builder_);
       etdump_Value_val_add(builder_, etdump_ValueType_Tensor);
@@ -548,9 +722,14 @@ void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
           evalue.toTensorList();
       etdump_Tensor_vec_start(builder_);
       for (size_t i = 0; i < tensors.size(); ++i) {
-        long offset = write_tensor_or_raise_error(tensors[i]);
         etdump_Tensor_vec_push(
-            builder_, add_tensor_entry(builder_, tensors[i], offset));
+            builder_,
+            add_tensor_entry(
+                builder_,
+                tensors[i],
+                capture_tensor(
+                    tensors[i],
+                    evalue_type == LoggedEValueType::kProgramOutput)));
       }
       etdump_Tensor_vec_ref_t tensor_vec_ref = etdump_Tensor_vec_end(builder_);
       etdump_TensorList_ref_t tensor_list_ref =
@@ -660,5 +839,59 @@ long ETDumpGen::write_tensor_or_raise_error(Tensor tensor) {
   return static_cast<long>(ret.get());
 }
 
+internal::CapturedTensor ETDumpGen::capture_tensor(
+    const Tensor& tensor,
+    bool full) {
+  internal::CapturedTensor captured{-1, 1, false, {}};
+  if (!full && tensor_capture_mode_ != TensorCaptureMode::kFull) {
+    Result<TensorStats> stats = compute_tensor_stats(tensor);
+    if (stats.ok()) {
+      captured.has_stats = true;
+      captured.stats = stats.get();
+    }
+  }
+  if (!captured.has_stats) {
+    captured.offset = write_tensor_or_raise_error(tensor);
+    return captured;
+  }
+
+  const size_t numel = tensor.numel();
+  const size_t element_size = tensor.element_size();
+  const size_t max_samples =
+      tensor_capture_mode_ == TensorCaptureMode::kSampled
+      ? sample_buffer_.size() / element_size
+      : 0;
+  if (numel == 0 || numel <= max_samples) {
+    captured.offset = write_tensor_or_raise_error(tensor);
+    return captured;
+  }
+  if (max_samples == 0) {
+    captured.sample_stride = 0;
+    return captured;
+  }
+
+  // Gather every stride-th element into the sample buffer.
+  const size_t stride = (numel + max_samples - 1) / max_samples;
+  const size_t num_samples = (numel + stride - 1) / stride;
+  const auto* data = static_cast<const uint8_t*>(tensor.const_data_ptr());
+  for (size_t i = 0; i < num_samples; ++i) {
+    memcpy(
+        sample_buffer_.data() + i * element_size,
+        data + i * stride * element_size,
+        element_size);
+  }
+  ET_CHECK_MSG(
+      data_sink_, "Must set data sink before writing tensor-like data");
+  Result<size_t> ret =
+      data_sink_->write(sample_buffer_.data(), num_samples * element_size);
+  ET_CHECK_MSG(
+      ret.ok(),
+      "Failed to write tensor samples with error 0x%" PRIx32,
+      static_cast<uint32_t>(ret.error()));
+  captured.offset = static_cast<long>(ret.get());
+  captured.sample_stride = static_cast<int64_t>(stride);
+  return captured;
+}
+
 } // namespace etdump
 } // namespace executorch
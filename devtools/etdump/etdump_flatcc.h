@@ -13,6 +13,8 @@
 
 #include <executorch/devtools/etdump/data_sinks/buffer_data_sink.h>
 #include <executorch/devtools/etdump/data_sinks/data_sink_base.h>
+#include <executorch/devtools/etdump/perf_counters.h>
+#include <executorch/devtools/etdump/tensor_stats.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/span.h>
@@ -44,6 +46,12 @@ struct ETDumpStaticAllocator {
     front_left = out_size;
   }
 
+  // Discard what was emitted to the build buffer, keeping the allocations.
+  void reset_output() {
+    front_cursor = &data[data_size + out_size];
+    front_left = out_size;
+  }
+
   // Pointer to backing buffer to allocate from.
   uint8_t* data{nullptr};
 
@@ -62,8 +70,29 @@ struct ETDumpStaticAllocator {
   // Bytes left in front of front_cursor.
   size_t front_left{0};
 };
+
+// How ETDumpGen recorded a tensor.
+struct CapturedTensor {
+  // The offset of the logged data in the data sink, or -1 if there is none.
+  long offset;
+  // The stride between the logged elements; 0 if no data was logged.
+  int64_t sample_stride;
+  bool has_stats;
+  TensorStats stats;
+};
 } // namespace internal
 
+/// How ETDumpGen records the intermediate output tensors it logs.
+enum class TensorCaptureMode {
+  /// Copy all of the tensor's data to the data sink.
+  kFull,
+  /// Only record the min, max, mean and NaN count of the tensor in the
+  /// ETDump, without copying its data.
+  kStats,
+  /// Record the statistics and copy evenly spaced elements to the data sink.
+  kSampled,
+};
+
 struct ETDumpResult {
   void* buf;
   size_t size;
@@ -96,6 +125,16 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
       et_timestamp_t end_time,
       const void* metadata,
       size_t metadata_len) override;
+  /**
+   * Log an operator profiling event that has already ended, e.g. one that was
+   * recorded by another event tracer.
+   */
+  void log_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
   virtual void track_allocation(
       ::executorch::runtime::AllocatorID id,
       size_t size) override;
@@ -148,6 +187,52 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
       const double& output) override;
   void set_debug_buffer(::executorch::runtime::Span<uint8_t> buffer);
   void set_data_sink(DataSinkBase* data_sink);
+
+  /**
+   * Set how intermediate output tensors logged by log_evalue() and
+   * log_intermediate_output_delegate() are recorded. Program outputs are
+   * always copied in full, as are tensors whose dtype has no statistics.
+   *
+   * In kSampled mode, sample_buffer bounds the number of elements copied per
+   * tensor: a tensor that does not fit is gathered into it with the smallest
+   * stride that fits, and the stride is recorded in the ETDump. The buffer
+   * must outlive the ETDumpGen or the next call.
+   */
+  void set_tensor_capture_mode(
+      TensorCaptureMode mode,
+      ::executorch::runtime::Span<uint8_t> sample_buffer = {});
+
+  /**
+   * Stream the ETDump to etdump_sink while the model runs instead of keeping
+   * all of it in memory until get_etdump_data(). Once blocks_per_chunk blocks
+   * have been recorded, the next create_event_block() call writes them to the
+   * sink as a complete size-prefixed ETDump and starts a new one, so the
+   * memory used stays bounded however many times the model runs. The sink
+   * then holds a sequence of ETDumps, which deserialize_from_etdump_flatcc()
+   * merges back into one.
+   *
+   * etdump_sink must not be the sink of the debug data set with
+   * set_data_sink(), since ETDump refers to debug data by its offset in that
+   * sink. Pass nullptr to stop streaming.
+   */
+  void set_etdump_sink(DataSinkBase* etdump_sink, size_t blocks_per_chunk = 1);
+
+  /**
+   * Write the blocks recorded so far to the sink set with set_etdump_sink()
+   * and start a new ETDump, e.g. to make the end of a run visible to a reader
+   * of the sink right away.
+   */
+  ::executorch::runtime::Error flush_etdump();
+
+  /**
+   * Record the hardware counters read by reader over each operator and
+   * delegate profiling event, in the perf_counters of its ProfileEvent. Events
+   * that were logged after the fact with log_profiling_delegate() have none.
+   * The reader must belong to the thread that runs the model and outlive the
+   * ETDumpGen. Pass nullptr to stop.
+   */
+  void set_perf_counter_reader(PerfCounterReader* reader);
+
   ETDumpResult get_etdump_data();
   size_t get_num_blocks();
   DataSinkBase* get_data_sink();
@@ -165,6 +250,21 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
 
   void check_ready_to_add_events();
   int64_t create_string_entry(const char* name);
+  void add_profile_event(
+      int64_t string_id,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const PerfCounterValues* perf_counters = nullptr);
+
+  // Snapshot the counters at the start of an event, and compute how much
+  // they changed at its end. Returns false if no snapshot matches the event.
+  void start_perf_counters(
+      const ::executorch::runtime::EventTracerEntry& prof_entry);
+  bool end_perf_counters(
+      const ::executorch::runtime::EventTracerEntry& prof_entry,
+      PerfCounterValues& deltas);
 
   /**
    * Templated helper function used to log various types of intermediate output.
@@ -178,13 +278,37 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
 
   long write_tensor_or_raise_error(executorch::aten::Tensor tensor);
 
+  /**
+   * Record an output tensor as set by set_tensor_capture_mode(), or in full
+   * if `full` is true, writing its data to the data sink if needed.
+   */
+  internal::CapturedTensor capture_tensor(
+      const executorch::aten::Tensor& tensor,
+      bool full = false);
+
   struct flatcc_builder* builder_;
   size_t num_blocks_ = 0;
   DataSinkBase* data_sink_;
+  DataSinkBase* etdump_sink_ = nullptr;
+  size_t blocks_per_chunk_ = 1;
+
+  struct PerfCounterStart {
+    int64_t event_id;
+    et_timestamp_t start_time;
+    PerfCounterValues values;
+  };
+  // The deepest nesting of profiling events whose counters are recorded.
+  static constexpr size_t kMaxPerfCounterDepth = 16;
+  PerfCounterReader* perf_counter_reader_ = nullptr;
+  PerfCounterStart perf_counter_starts_[kMaxPerfCounterDepth];
+  size_t perf_counter_depth_ = 0;
 
   // It is only for set_debug_buffer function.
   BufferDataSink buffer_data_sink_;
 
+  TensorCaptureMode tensor_capture_mode_ = TensorCaptureMode::kFull;
+  ::executorch::runtime::Span<uint8_t> sample_buffer_;
+
   int bundled_input_index_ = -1;
   State state_ = State::Init;
   struct internal::ETDumpStaticAllocator alloc_;
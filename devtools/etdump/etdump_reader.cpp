@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/etdump_reader.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+#include <executorch/devtools/etdump/etdump_schema_flatcc_reader.h>
+#include <executorch/runtime/platform/log.h>
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+// The size prefix and root table offset that precede the file identifier.
+constexpr size_t kIdentifierOffset = 8;
+
+// Returns the offset of the next size-prefixed ETDump at or after `offset`,
+// or `size` if there is none. Streamed ETDumps may be separated by alignment
+// padding.
+size_t find_etdump(const uint8_t* data, size_t size, size_t offset) {
+  const size_t identifier_size = strlen(etdump_ETDump_file_identifier);
+  for (size_t i = offset + kIdentifierOffset; i + identifier_size <= size;
+       ++i) {
+    if (memcmp(data + i, etdump_ETDump_file_identifier, identifier_size) ==
+        0) {
+      return i - kIdentifierOffset;
+    }
+  }
+  return size;
+}
+
+std::string_view to_string_view(flatbuffers_string_t string) {
+  return string != nullptr
+      ? std::string_view(string, flatbuffers_string_len(string))
+      : std::string_view();
+}
+
+void read_run_data(
+    etdump_ETDump_table_t etdump,
+    size_t& run_index,
+    std::vector<ProfileEventRecord>& records) {
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  const size_t num_runs = etdump_RunData_vec_len(run_data_vec);
+  for (size_t i = 0; i < num_runs; ++i, ++run_index) {
+    etdump_Event_vec_t events =
+        etdump_RunData_events(etdump_RunData_vec_at(run_data_vec, i));
+    const size_t num_events = etdump_Event_vec_len(events);
+    for (size_t j = 0; j < num_events; ++j) {
+      etdump_ProfileEvent_table_t event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, j));
+      if (event == nullptr) {
+        continue;
+      }
+      ProfileEventRecord record;
+      record.run_index = run_index;
+      record.name = to_string_view(etdump_ProfileEvent_name(event));
+      record.chain_index = etdump_ProfileEvent_chain_index(event);
+      record.instruction_id = etdump_ProfileEvent_instruction_id(event);
+      record.delegate_debug_id_int =
+          etdump_ProfileEvent_delegate_debug_id_int(event);
+      record.delegate_debug_id_str =
+          to_string_view(etdump_ProfileEvent_delegate_debug_id_str(event));
+      record.start_time = etdump_ProfileEvent_start_time(event);
+      record.end_time = etdump_ProfileEvent_end_time(event);
+      records.push_back(record);
+    }
+  }
+}
+
+std::string group_name(const ProfileEventRecord& event) {
+  if (!event.delegate_debug_id_str.empty()) {
+    return std::string(event.delegate_debug_id_str);
+  }
+  if (event.delegate_debug_id_int != -1) {
+    return "delegate_debug_id_" + std::to_string(event.delegate_debug_id_int);
+  }
+  return std::string(event.name);
+}
+
+uint64_t duration(const ProfileEventRecord& event) {
+  return event.end_time > event.start_time
+      ? event.end_time - event.start_time
+      : 0;
+}
+
+// Returns the time that each event spends outside of the events nested in
+// it. Events of different run data blocks never nest.
+std::vector<uint64_t> self_times(
+    const std::vector<ProfileEventRecord>& events) {
+  std::vector<size_t> order(events.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  // Parents before their children: earlier start first, then later end.
+  const auto key = [&](size_t i) {
+    return std::make_tuple(
+        events[i].run_index, events[i].start_time, ~events[i].end_time);
+  };
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return key(a) < key(b);
+  });
+
+  std::vector<uint64_t> child_times(events.size(), 0);
+  std::vector<size_t> stack;
+  for (const size_t i : order) {
+    const auto& event = events[i];
+    while (!stack.empty() &&
+           (events[stack.back()].run_index != event.run_index ||
+            events[stack.back()].end_time <= event.start_time)) {
+      stack.pop_back();
+    }
+    if (!stack.empty()) {
+      child_times[stack.back()] += duration(event);
+    }
+    stack.push_back(i);
+  }
+
+  std::vector<uint64_t> result(events.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    const uint64_t total = duration(events[i]);
+    // Children on other threads can overlap each other.
+    result[i] = total > child_times[i] ? total - child_times[i] : 0;
+  }
+  return result;
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+  const size_t rank =
+      static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+// Writes `value` as a quoted JSON string.
+void write_json_string(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          constexpr char kHex[] = "0123456789abcdef";
+          out << "\\u00" << kHex[(c >> 4) & 0xf] << kHex[c & 0xf];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+// Writes `value` as a CSV field, quoted if needed.
+void write_csv_field(std::ostream& out, const std::string& value) {
+  if (value.find_first_of(",\"\n") == std::string::npos) {
+    out << value;
+    return;
+  }
+  out << '"';
+  for (const char c : value) {
+    if (c == '"') {
+      out << '"';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+} // namespace
+
+Result<std::vector<ProfileEventRecord>> read_profile_events(
+    const void* data,
+    size_t size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      data != nullptr, InvalidArgument, "ETDump data is null");
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  std::vector<ProfileEventRecord> records;
+  size_t run_index = 0;
+  size_t num_etdumps = 0;
+  for (size_t offset = find_etdump(bytes, size, 0); offset + 4 <= size;
+       ++num_etdumps) {
+    uint32_t etdump_size;
+    memcpy(&etdump_size, bytes + offset, sizeof(etdump_size));
+    const size_t end = offset + sizeof(etdump_size) + etdump_size;
+    if (end > size) {
+      ET_LOG(Error, "ETDump at offset %zu is truncated", offset);
+      break;
+    }
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        bytes + offset + sizeof(etdump_size), etdump_ETDump_file_identifier);
+    if (etdump != nullptr) {
+      read_run_data(etdump, run_index, records);
+    }
+    offset = find_etdump(bytes, size, end);
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      num_etdumps > 0, InvalidArgument, "Data holds no size-prefixed ETDump");
+  return records;
+}
+
+std::vector<ProfileEventStats> aggregate_profile_events(
+    const std::vector<ProfileEventRecord>& events,
+    GroupBy group_by) {
+  using Key = std::tuple<bool, std::string, int32_t, int32_t>;
+  struct Group {
+    std::vector<uint64_t> durations;
+    uint64_t self_time = 0;
+  };
+  const std::vector<uint64_t> self = self_times(events);
+  std::map<Key, Group> groups;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    const bool by_instruction = group_by == GroupBy::Instruction;
+    Key key(
+        event.is_delegate(),
+        group_name(event),
+        by_instruction ? event.chain_index : -1,
+        by_instruction ? event.instruction_id : -1);
+    auto& group = groups[std::move(key)];
+    group.durations.push_back(duration(event));
+    group.self_time += self[i];
+  }
+
+  std::vector<ProfileEventStats> result;
+  result.reserve(groups.size());
+  for (auto& entry : groups) {
+    auto& durations = entry.second.durations;
+    std::sort(durations.begin(), durations.end());
+    ProfileEventStats stats;
+    std::tie(
+        stats.is_delegate,
+        stats.name,
+        stats.chain_index,
+        stats.instruction_id) = entry.first;
+    stats.count = durations.size();
+    stats.total_time = 0;
+    for (const uint64_t d : durations) {
+      stats.total_time += d;
+    }
+    stats.self_time = entry.second.self_time;
+    stats.min_time = durations.front();
+    stats.max_time = durations.back();
+    stats.p50_time = percentile(durations, 50);
+    stats.p90_time = percentile(durations, 90);
+    stats.p99_time = percentile(durations, 99);
+    result.push_back(std::move(stats));
+  }
+  std::stable_sort(
+      result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.total_time > b.total_time;
+      });
+  return result;
+}
+
+void write_csv(
+    std::ostream& out,
+    const std::vector<ProfileEventStats>& stats,
+    double time_scale) {
+  // Print large times in full rather than in scientific notation.
+  const auto precision = out.precision(15);
+  out << "name,is_delegate,chain_index,instruction_id,count,total_time,"
+         "self_time,mean_time,min_time,p50_time,p90_time,p99_time,max_time\n";
+  for (const auto& s : stats) {
+    write_csv_field(out, s.name);
+    out << ',' << (s.is_delegate ? "true" : "false") << ',' << s.chain_index
+        << ',' << s.instruction_id << ',' << s.count << ','
+        << s.total_time * time_scale << ',' << s.self_time * time_scale << ','
+        << s.total_time * time_scale / s.count << ','
+        << s.min_time * time_scale << ',' << s.p50_time * time_scale << ','
+        << s.p90_time * time_scale << ',' << s.p99_time * time_scale << ','
+        << s.max_time * time_scale << '\n';
+  }
+  out.precision(precision);
+}
+
+void write_json(
+    std::ostream& out,
+    const std::vector<ProfileEventStats>& stats,
+    double time_scale) {
+  const auto precision = out.precision(15);
+  out << '[';
+  for (size_t i = 0; i < stats.size(); ++i) {
+    const auto& s = stats[i];
+    out << (i == 0 ? "\n" : ",\n") << "  {\"name\": ";
+    write_json_string(out, s.name);
+    out << ", \"is_delegate\": " << (s.is_delegate ? "true" : "false")
+        << ", \"chain_index\": " << s.chain_index
+        << ", \"instruction_id\": " << s.instruction_id
+        << ", \"count\": " << s.count
+        << ", \"total_time\": " << s.total_time * time_scale
+        << ", \"self_time\": " << s.self_time * time_scale
+        << ", \"mean_time\": " << s.total_time * time_scale / s.count
+        << ", \"min_time\": " << s.min_time * time_scale
+        << ", \"p50_time\": " << s.p50_time * time_scale
+        << ", \"p90_time\": " << s.p90_time * time_scale
+        << ", \"p99_time\": " << s.p99_time * time_scale
+        << ", \"max_time\": " << s.max_time * time_scale << '}';
+  }
+  out << (stats.empty() ? "]\n" : "\n]\n");
+  out.precision(precision);
+}
+
+} // namespace etdump
+} // namespace executorch
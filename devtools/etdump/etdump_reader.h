@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * A profiling event read from an ETDump. The strings point into the buffer
+ * that the event was read from.
+ */
+struct ProfileEventRecord {
+  /// The index of the event's run data block, counted across all ETDumps in
+  /// the buffer.
+  size_t run_index;
+  /// The name of the event; empty for delegate events identified by an id.
+  std::string_view name;
+  int32_t chain_index;
+  int32_t instruction_id;
+  /// The delegate debug id of a delegate event, or -1.
+  int32_t delegate_debug_id_int;
+  /// The delegate debug id of a delegate event identified by a string.
+  std::string_view delegate_debug_id_str;
+  uint64_t start_time;
+  uint64_t end_time;
+
+  /// Whether the event was logged by a delegate rather than the runtime.
+  bool is_delegate() const {
+    return delegate_debug_id_int != -1 || !delegate_debug_id_str.empty();
+  }
+};
+
+/**
+ * Reads the profiling events of a size-prefixed ETDump, as written by
+ * ETDumpGen, in the order they were recorded. The buffer may also hold the
+ * sequence of ETDumps streamed by ETDumpGen::set_etdump_sink(); their run
+ * data blocks are read in order.
+ *
+ * The buffer is not verified, so it must come from a trusted writer.
+ *
+ * @param[in] data The ETDump. Must stay valid while the events are used.
+ * @param[in] size The size of `data` in bytes.
+ *
+ * @returns The events, or Error::InvalidArgument if `data` holds no ETDump.
+ */
+::executorch::runtime::Result<std::vector<ProfileEventRecord>>
+read_profile_events(const void* data, size_t size);
+
+/// How aggregate_profile_events() groups events.
+enum class GroupBy {
+  /// One group per event name or delegate debug id.
+  Name,
+  /// One group per name or delegate debug id and instruction, e.g. per
+  /// operator in the graph for OPERATOR_CALL events.
+  Instruction,
+};
+
+/// Statistics of a group of profiling events, in ticks.
+struct ProfileEventStats {
+  /// The name of the events, or their delegate debug id.
+  std::string name;
+  bool is_delegate;
+  /// The chain and instruction of the events, or -1 when grouped by name.
+  int32_t chain_index;
+  int32_t instruction_id;
+  size_t count;
+  /// The sum of the events' durations.
+  uint64_t total_time;
+  /// The sum of the events' durations minus the time spent in the events
+  /// nested in them.
+  uint64_t self_time;
+  uint64_t min_time;
+  uint64_t max_time;
+  /// Nearest-rank percentiles of the events' durations.
+  uint64_t p50_time;
+  uint64_t p90_time;
+  uint64_t p99_time;
+};
+
+/**
+ * Aggregates profiling events into statistics per group, sorted by
+ * decreasing total time. Events of a run data block nest when one's time
+ * span contains the other's, e.g. operators in Method::execute or delegate
+ * events in DELEGATE_CALL.
+ */
+std::vector<ProfileEventStats> aggregate_profile_events(
+    const std::vector<ProfileEventRecord>& events,
+    GroupBy group_by);
+
+/**
+ * Writes statistics as CSV with a header row, multiplying all times by
+ * `time_scale`, e.g. to convert ticks to nanoseconds.
+ */
+void write_csv(
+    std::ostream& out,
+    const std::vector<ProfileEventStats>& stats,
+    double time_scale = 1.0);
+
+/**
+ * Writes statistics as a JSON array of objects with the same fields as the
+ * CSV columns, multiplying all times by `time_scale`.
+ */
+void write_json(
+    std::ostream& out,
+    const std::vector<ProfileEventStats>& stats,
+    double time_scale = 1.0);
+
+} // namespace etdump
+} // namespace executorch
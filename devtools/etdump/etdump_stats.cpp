@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Prints the statistics of the profiling events in an ETDump: per operator
+ * instruction or event name, and per delegate event, the count, total and
+ * self time, and percentiles of the durations. For example:
+ *
+ *   etdump_stats --etdump_path=etdump.etdp --format=json --time_scale=1e-3
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/devtools/etdump/etdump_reader.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+
+DEFINE_string(etdump_path, "etdump.etdp", "The ETDump to read.");
+DEFINE_string(format, "csv", "The output format: csv or json.");
+DEFINE_string(
+    output_path,
+    "",
+    "The file to write the statistics to. Defaults to stdout.");
+DEFINE_string(
+    group_by,
+    "instruction",
+    "How to group events: instruction, for one group per operator or "
+    "delegate call of the graph, or name.");
+DEFINE_double(
+    time_scale,
+    1.0,
+    "Multiplies the times, which the ETDump holds in ticks, e.g. to convert "
+    "them to nanoseconds.");
+
+using executorch::etdump::GroupBy;
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+  if (FLAGS_format != "csv" && FLAGS_format != "json") {
+    ET_LOG(Error, "Unknown format: %s", FLAGS_format.c_str());
+    return 1;
+  }
+  if (FLAGS_group_by != "instruction" && FLAGS_group_by != "name") {
+    ET_LOG(Error, "Unknown grouping: %s", FLAGS_group_by.c_str());
+    return 1;
+  }
+
+  std::ifstream file(FLAGS_etdump_path, std::ios::binary);
+  if (!file) {
+    ET_LOG(Error, "Failed to open %s", FLAGS_etdump_path.c_str());
+    return 1;
+  }
+  const std::vector<char> data(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  const auto events =
+      executorch::etdump::read_profile_events(data.data(), data.size());
+  if (!events.ok()) {
+    ET_LOG(Error, "Failed to read %s", FLAGS_etdump_path.c_str());
+    return 1;
+  }
+  const auto stats = executorch::etdump::aggregate_profile_events(
+      *events,
+      FLAGS_group_by == "name" ? GroupBy::Name : GroupBy::Instruction);
+  ET_LOG(
+      Info,
+      "Read %zu profiling events into %zu groups",
+      events->size(),
+      stats.size());
+
+  std::ofstream output_file;
+  if (!FLAGS_output_path.empty()) {
+    output_file.open(FLAGS_output_path);
+    if (!output_file) {
+      ET_LOG(Error, "Failed to open %s", FLAGS_output_path.c_str());
+      return 1;
+    }
+  }
+  std::ostream& out = FLAGS_output_path.empty() ? std::cout : output_file;
+  if (FLAGS_format == "json") {
+    executorch::etdump::write_json(out, stats, FLAGS_time_scale);
+  } else {
+    executorch::etdump::write_csv(out, stats, FLAGS_time_scale);
+  }
+  return out ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/perf_counters.h>
+
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace etdump {
+
+#if defined(__linux__)
+
+namespace {
+
+struct CounterConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+// Indexed by PerfCounter.
+constexpr CounterConfig kCounterConfigs[kNumPerfCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int open_counter(const CounterConfig& counter, int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = counter.type;
+  attr.config = counter.config;
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return static_cast<int>(syscall(
+      __NR_perf_event_open,
+      &attr,
+      /*pid=*/0,
+      /*cpu=*/-1,
+      group_fd,
+      /*flags=*/0));
+}
+
+} // namespace
+
+PerfCounterReader::PerfCounterReader() {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    fds_[i] = -1;
+  }
+}
+
+PerfCounterReader::PerfCounterReader(PerfCounterReader&& other) noexcept
+    : group_fd_(other.group_fd_), num_open_(other.num_open_) {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    fds_[i] = other.fds_[i];
+    other.fds_[i] = -1;
+  }
+  other.group_fd_ = -1;
+  other.num_open_ = 0;
+}
+
+PerfCounterReader::~PerfCounterReader() {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    if (fds_[i] >= 0) {
+      close(fds_[i]);
+    }
+  }
+}
+
+Result<PerfCounterReader> PerfCounterReader::create() {
+  PerfCounterReader reader;
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    const int fd = open_counter(kCounterConfigs[i], reader.group_fd_);
+    if (fd < 0) {
+      ET_LOG(Debug, "Hardware counter %zu is not available", i);
+      continue;
+    }
+    reader.fds_[i] = fd;
+    if (reader.group_fd_ < 0) {
+      reader.group_fd_ = fd;
+    }
+    ++reader.num_open_;
+  }
+  if (reader.num_open_ == 0) {
+    ET_LOG(Error, "No hardware counter could be opened");
+    return Error::NotSupported;
+  }
+  ioctl(reader.group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(reader.group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return reader;
+}
+
+Error PerfCounterReader::read(PerfCounterValues& values) const {
+  // With PERF_FORMAT_GROUP, the number of counters followed by their values
+  // in the order they were opened.
+  uint64_t buffer[1 + kNumPerfCounters];
+  const ssize_t expected = (1 + num_open_) * sizeof(uint64_t);
+  if (::read(group_fd_, buffer, sizeof(buffer)) != expected) {
+    return Error::Internal;
+  }
+  size_t next = 1;
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    values.values[i] = fds_[i] >= 0 ? static_cast<int64_t>(buffer[next++])
+                                    : kPerfCounterUnavailable;
+  }
+  return Error::Ok;
+}
+
+#else // !defined(__linux__)
+
+PerfCounterReader::PerfCounterReader() {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    fds_[i] = -1;
+  }
+}
+
+PerfCounterReader::PerfCounterReader(PerfCounterReader&& other) noexcept
+    : PerfCounterReader() {
+  (void)other;
+}
+
+PerfCounterReader::~PerfCounterReader() = default;
+
+Result<PerfCounterReader> PerfCounterReader::create() {
+  ET_LOG(Error, "Hardware counters are only supported on Linux");
+  return Error::NotSupported;
+}
+
+Error PerfCounterReader::read(PerfCounterValues& values) const {
+  (void)values;
+  return Error::NotSupported;
+}
+
+#endif // defined(__linux__)
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace etdump {
+
+/// The hardware counters that PerfCounterReader can read.
+enum class PerfCounter : uint8_t {
+  kCycles,
+  kInstructions,
+  kL1DCacheMisses,
+  kLLCMisses,
+  kBranchMisses,
+};
+
+constexpr size_t kNumPerfCounters = 5;
+
+/// A snapshot of the counters, indexed by PerfCounter. Counters that are not
+/// available read as kPerfCounterUnavailable.
+struct PerfCounterValues {
+  int64_t values[kNumPerfCounters];
+
+  int64_t operator[](PerfCounter counter) const {
+    return values[static_cast<size_t>(counter)];
+  }
+};
+
+constexpr int64_t kPerfCounterUnavailable = -1;
+
+/**
+ * Reads the hardware performance counters (PMU) of the calling thread, with
+ * Linux perf_event_open(2). The counters are opened as one group, so a
+ * snapshot of all of them takes a single read(2), and they count user space
+ * only, which is allowed with the default perf_event_paranoid setting on
+ * Android.
+ *
+ * Counters that the CPU or kernel don't support, e.g. in emulators, are left
+ * out and read as kPerfCounterUnavailable. Only the thread that created the
+ * reader is counted, so work that kernels hand over to a thread pool is
+ * missed.
+ *
+ * Pass it to ETDumpGen::set_perf_counter_reader() to record the counters of
+ * each operator and delegate call.
+ */
+class PerfCounterReader final {
+ public:
+  /**
+   * Opens the counters for the calling thread.
+   *
+   * @retval Error::NotSupported if none of the counters could be opened,
+   * including on platforms other than Linux.
+   */
+  static ::executorch::runtime::Result<PerfCounterReader> create();
+
+  PerfCounterReader(PerfCounterReader&& other) noexcept;
+  PerfCounterReader& operator=(PerfCounterReader&& other) = delete;
+  PerfCounterReader(const PerfCounterReader&) = delete;
+  PerfCounterReader& operator=(const PerfCounterReader&) = delete;
+  ~PerfCounterReader();
+
+  /**
+   * Reads the current values of the counters into values.
+   */
+  ET_NODISCARD ::executorch::runtime::Error read(
+      PerfCounterValues& values) const;
+
+  /// Whether the counter could be opened.
+  bool is_available(PerfCounter counter) const {
+    return fds_[static_cast<size_t>(counter)] >= 0;
+  }
+
+ private:
+  PerfCounterReader();
+
+  // The file descriptor of each counter, -1 if unavailable. The first
+  // available one leads the group.
+  int fds_[kNumPerfCounters];
+  int group_fd_ = -1;
+  size_t num_open_ = 0;
+};
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/ring_buffer_event_tracer.h>
+
+#include <limits>
+#include <new>
+
+#include <executorch/runtime/platform/assert.h>
+
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::AllocatorID;
+using ::executorch::runtime::ArrayRef;
+using ::executorch::runtime::ChainID;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::LoggedEValueType;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+enum EventKind : uint8_t {
+  kBlock,
+  kOperator,
+  kDelegate,
+};
+
+// The start time of entries started while the tracer was disabled.
+constexpr et_timestamp_t kNotRecorded =
+    std::numeric_limits<et_timestamp_t>::max();
+
+constexpr DebugHandle kNoDelegateDebugIndex = static_cast<DebugHandle>(-1);
+
+} // namespace
+
+// Every field is atomic so that snapshot() can read a slot while it is being
+// overwritten: sequence works as a seqlock telling whether what it read is
+// the event it expected.
+struct RingBufferEventTracer::Slot {
+  // The index of the event in the slot plus one, or 0 while it's written.
+  std::atomic<uint64_t> sequence{0};
+  std::atomic<uint8_t> kind{kOperator};
+  std::atomic<const char*> name{nullptr};
+  std::atomic<DebugHandle> delegate_debug_index{kNoDelegateDebugIndex};
+  std::atomic<ChainID> chain_id{0};
+  std::atomic<DebugHandle> debug_handle{0};
+  std::atomic<et_timestamp_t> start_time{0};
+  std::atomic<et_timestamp_t> end_time{0};
+};
+
+const size_t RingBufferEventTracer::kEventSize = sizeof(Slot);
+
+RingBufferEventTracer::RingBufferEventTracer(Span<uint8_t> buffer) {
+  const uintptr_t start = reinterpret_cast<uintptr_t>(buffer.data());
+  const uintptr_t aligned = (start + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+  const size_t padding = aligned - start;
+  capacity_ = buffer.size() > padding
+      ? (buffer.size() - padding) / sizeof(Slot)
+      : 0;
+  ET_CHECK_MSG(
+      capacity_ > 0,
+      "Buffer of %zu bytes can't hold a single event",
+      buffer.size());
+  slots_ = reinterpret_cast<Slot*>(aligned);
+  for (size_t i = 0; i < capacity_; ++i) {
+    new (&slots_[i]) Slot();
+  }
+}
+
+RingBufferEventTracer::~RingBufferEventTracer() {
+  for (size_t i = 0; i < capacity_; ++i) {
+    slots_[i].~Slot();
+  }
+}
+
+void RingBufferEventTracer::record(
+    uint8_t kind,
+    const char* name,
+    DebugHandle delegate_debug_index,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  const uint64_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[index % capacity_];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.kind.store(kind, std::memory_order_relaxed);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.delegate_debug_index.store(
+      delegate_debug_index, std::memory_order_relaxed);
+  slot.chain_id.store(chain_id, std::memory_order_relaxed);
+  slot.debug_handle.store(debug_handle, std::memory_order_relaxed);
+  slot.start_time.store(start_time, std::memory_order_relaxed);
+  slot.end_time.store(end_time, std::memory_order_relaxed);
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void RingBufferEventTracer::create_event_block(const char* name) {
+  if (!enabled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  const et_timestamp_t time = et_pal_current_ticks();
+  record(kBlock, name, kNoDelegateDebugIndex, 0, 0, time, time);
+}
+
+EventTracerEntry RingBufferEventTracer::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  EventTracerEntry prof_entry;
+  // The name is kept as is in the event id, see the class comment.
+  prof_entry.event_id = reinterpret_cast<intptr_t>(name);
+  prof_entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  if (chain_id == -1) {
+    prof_entry.chain_id = chain_id_;
+    prof_entry.debug_handle = debug_handle_;
+  } else {
+    prof_entry.chain_id = chain_id;
+    prof_entry.debug_handle = debug_handle;
+  }
+  prof_entry.start_time = enabled_.load(std::memory_order_relaxed)
+      ? et_pal_current_ticks()
+      : kNotRecorded;
+  return prof_entry;
+}
+
+void RingBufferEventTracer::end_profiling(EventTracerEntry prof_entry) {
+  if (prof_entry.start_time == kNotRecorded) {
+    return;
+  }
+  record(
+      kOperator,
+      reinterpret_cast<const char*>(prof_entry.event_id),
+      kNoDelegateDebugIndex,
+      prof_entry.chain_id,
+      prof_entry.debug_handle,
+      prof_entry.start_time,
+      et_pal_current_ticks());
+}
+
+EventTracerEntry RingBufferEventTracer::start_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index) {
+  EventTracerEntry prof_entry;
+  if (name != nullptr) {
+    prof_entry.delegate_event_id_type = DelegateDebugIdType::kStr;
+    prof_entry.event_id = reinterpret_cast<intptr_t>(name);
+  } else {
+    prof_entry.delegate_event_id_type = DelegateDebugIdType::kInt;
+    prof_entry.event_id = delegate_debug_index;
+  }
+  prof_entry.chain_id = chain_id_;
+  prof_entry.debug_handle = debug_handle_;
+  prof_entry.start_time = enabled_.load(std::memory_order_relaxed)
+      ? et_pal_current_ticks()
+      : kNotRecorded;
+  return prof_entry;
+}
+
+void RingBufferEventTracer::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    const void* /*metadata*/,
+    size_t /*metadata_len*/) {
+  if (prof_entry.start_time == kNotRecorded) {
+    return;
+  }
+  const bool is_str =
+      prof_entry.delegate_event_id_type == DelegateDebugIdType::kStr;
+  record(
+      kDelegate,
+      is_str ? reinterpret_cast<const char*>(prof_entry.event_id) : nullptr,
+      is_str ? kNoDelegateDebugIndex
+             : static_cast<DebugHandle>(prof_entry.event_id),
+      prof_entry.chain_id,
+      prof_entry.debug_handle,
+      prof_entry.start_time,
+      et_pal_current_ticks());
+}
+
+void RingBufferEventTracer::log_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const void* /*metadata*/,
+    size_t /*metadata_len*/) {
+  if (!enabled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  record(
+      kDelegate,
+      name,
+      name != nullptr ? kNoDelegateDebugIndex : delegate_debug_index,
+      chain_id_,
+      debug_handle_,
+      start_time,
+      end_time);
+}
+
+void RingBufferEventTracer::track_allocation(
+    AllocatorID /*id*/,
+    size_t /*size*/) {}
+
+AllocatorID RingBufferEventTracer::track_allocator(const char* /*name*/) {
+  return 0;
+}
+
+void RingBufferEventTracer::log_evalue(
+    const EValue& /*evalue*/,
+    LoggedEValueType /*evalue_type*/) {}
+
+Result<bool> RingBufferEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const Tensor& /*output*/) {
+  return false;
+}
+
+Result<bool> RingBufferEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const ArrayRef<Tensor> /*output*/) {
+  return false;
+}
+
+Result<bool> RingBufferEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const int& /*output*/) {
+  return false;
+}
+
+Result<bool> RingBufferEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const bool& /*output*/) {
+  return false;
+}
+
+Result<bool> RingBufferEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const double& /*output*/) {
+  return false;
+}
+
+size_t RingBufferEventTracer::snapshot(ETDumpGen& etdump_gen) {
+  const uint64_t end = next_index_.load(std::memory_order_acquire);
+  uint64_t begin = snapshot_index_;
+  size_t lost = 0;
+  if (end - begin > capacity_) {
+    lost += end - begin - capacity_;
+    begin = end - capacity_;
+  }
+
+  bool in_block = false;
+  for (uint64_t index = begin; index < end; ++index) {
+    const Slot& slot = slots_[index % capacity_];
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+      ++lost;
+      continue;
+    }
+    const uint8_t kind = slot.kind.load(std::memory_order_relaxed);
+    const char* name = slot.name.load(std::memory_order_relaxed);
+    const DebugHandle delegate_debug_index =
+        slot.delegate_debug_index.load(std::memory_order_relaxed);
+    const ChainID chain_id = slot.chain_id.load(std::memory_order_relaxed);
+    const DebugHandle debug_handle =
+        slot.debug_handle.load(std::memory_order_relaxed);
+    const et_timestamp_t start_time =
+        slot.start_time.load(std::memory_order_relaxed);
+    const et_timestamp_t end_time =
+        slot.end_time.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != index + 1) {
+      // Overwritten while we read it.
+      ++lost;
+      continue;
+    }
+
+    if (kind == kBlock) {
+      etdump_gen.create_event_block(name);
+      in_block = true;
+      continue;
+    }
+    if (!in_block) {
+      etdump_gen.create_event_block("ring_buffer");
+      in_block = true;
+    }
+    if (kind == kOperator) {
+      etdump_gen.log_profiling(
+          name, chain_id, debug_handle, start_time, end_time);
+    } else {
+      etdump_gen.set_chain_debug_handle(chain_id, debug_handle);
+      etdump_gen.log_profiling_delegate(
+          name, delegate_debug_index, start_time, end_time, nullptr, 0);
+    }
+  }
+  etdump_gen.set_chain_debug_handle(
+      ::executorch::runtime::kUnsetChainId,
+      ::executorch::runtime::kUnsetDebugHandle);
+
+  snapshot_index_ = end;
+  return lost;
+}
+
+} // namespace etdump
+} // namespace executorch
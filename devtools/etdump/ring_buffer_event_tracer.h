@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * A low-overhead EventTracer for always-on profiling in production.
+ *
+ * Profiling events are written into a fixed-size ring of slots in a buffer
+ * provided by the user, overwriting the oldest ones once it is full. Starting
+ * and ending an event takes a timestamp and a handful of stores, without
+ * locks or allocations, so the tracer can stay attached to a Method; use
+ * set_enabled() to only record a sample of the inferences. When asked,
+ * snapshot() replays the events recorded since the previous snapshot into an
+ * ETDumpGen, which serializes them to a regular ETDump.
+ *
+ * Only profiling events are recorded: allocations, evalues and intermediate
+ * outputs are ignored, and so is delegate metadata. Unlike what EventTracer
+ * requires, event names are not copied, so they must stay valid until the
+ * snapshot. The names passed in by the runtime point to string literals or
+ * into the loaded Program, which they outlive.
+ *
+ * Events may be recorded from several threads at once. snapshot() may run
+ * concurrently with them, but only from one thread at a time.
+ */
+class RingBufferEventTracer : public ::executorch::runtime::EventTracer {
+ public:
+  /**
+   * @param buffer The memory for the ring, which must outlive the tracer.
+   * Each event takes kEventSize bytes of it.
+   */
+  explicit RingBufferEventTracer(::executorch::runtime::Span<uint8_t> buffer);
+  ~RingBufferEventTracer() override;
+
+  RingBufferEventTracer(const RingBufferEventTracer&) = delete;
+  RingBufferEventTracer& operator=(const RingBufferEventTracer&) = delete;
+
+  void create_event_block(const char* name) override;
+  ::executorch::runtime::EventTracerEntry start_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id = -1,
+      ::executorch::runtime::DebugHandle debug_handle = 0) override;
+  void end_profiling(::executorch::runtime::EventTracerEntry prof_entry)
+      override;
+  ::executorch::runtime::EventTracerEntry start_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index) override;
+  void end_profiling_delegate(
+      ::executorch::runtime::EventTracerEntry prof_entry,
+      const void* metadata,
+      size_t metadata_len) override;
+  void log_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const void* metadata,
+      size_t metadata_len) override;
+  void track_allocation(::executorch::runtime::AllocatorID id, size_t size)
+      override;
+  ::executorch::runtime::AllocatorID track_allocator(const char* name) override;
+  void log_evalue(
+      const ::executorch::runtime::EValue& evalue,
+      ::executorch::runtime::LoggedEValueType evalue_type) override;
+  Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const executorch::aten::Tensor& output) override;
+  Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const ::executorch::runtime::ArrayRef<executorch::aten::Tensor> output)
+      override;
+  Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const int& output) override;
+  Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const bool& output) override;
+  Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const double& output) override;
+
+  /**
+   * Start or stop recording events, e.g. to only profile some inferences.
+   * Events started while disabled are dropped. Enabled by default.
+   */
+  void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * Serialize the events recorded since the previous snapshot into
+   * etdump_gen, oldest first. Each block created with create_event_block()
+   * becomes a block of the ETDump; events recorded before the first one go
+   * into a block named "ring_buffer".
+   *
+   * @return The number of events lost since the previous snapshot, because
+   * the ring wrapped around before the snapshot, or because they were still
+   * being written or got overwritten while it ran.
+   */
+  size_t snapshot(ETDumpGen& etdump_gen);
+
+  /**
+   * The number of events the ring holds.
+   */
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  /// The bytes of the buffer each event takes.
+  static const size_t kEventSize;
+
+ private:
+  struct Slot;
+
+  void record(
+      uint8_t kind,
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
+
+  Slot* slots_;
+  size_t capacity_;
+  std::atomic<bool> enabled_{true};
+  // The number of events ever recorded. The next one goes to
+  // slots_[next_index_ % capacity_].
+  std::atomic<uint64_t> next_index_{0};
+  // The index of the first event not yet snapshotted.
+  uint64_t snapshot_index_ = 0;
+};
+
+} // namespace etdump
+} // namespace executorch
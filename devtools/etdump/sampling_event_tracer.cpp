@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/sampling_event_tracer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <executorch/runtime/platform/assert.h>
+
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::AllocatorID;
+using ::executorch::runtime::ArrayRef;
+using ::executorch::runtime::ChainID;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::kUnsetDebugHandle;
+using ::executorch::runtime::LoggedEValueType;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+constexpr DebugHandle kNoDelegateDebugIndex = static_cast<DebugHandle>(-1);
+
+size_t bucket_of(et_timestamp_t duration) {
+#if defined(__GNUC__) || defined(__clang__)
+  return duration == 0
+      ? 0
+      : 64 - __builtin_clzll(static_cast<unsigned long long>(duration));
+#else
+  size_t bucket = 0;
+  while (duration != 0) {
+    ++bucket;
+    duration >>= 1;
+  }
+  return bucket;
+#endif
+}
+
+size_t hash_event(
+    DebugHandle delegate_debug_index,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  uint64_t hash = static_cast<uint32_t>(chain_id);
+  hash = hash * 0x9e3779b97f4a7c15ULL + debug_handle;
+  hash = hash * 0x9e3779b97f4a7c15ULL + delegate_debug_index;
+  return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+bool same_name(const char* a, const char* b) {
+  if (a == b) {
+    return true;
+  }
+  return a != nullptr && b != nullptr && strcmp(a, b) == 0;
+}
+
+} // namespace
+
+et_timestamp_t OpStats::percentile(double fraction) const {
+  if (count == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(fraction * count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      const et_timestamp_t upper = i == 0 ? 0
+          : i == 64 ? std::numeric_limits<et_timestamp_t>::max()
+                    : (et_timestamp_t(1) << i) - 1;
+      return std::min(std::max(upper, min), max);
+    }
+  }
+  return max;
+}
+
+SamplingEventTracer::SamplingEventTracer(Span<uint8_t> buffer) {
+  const uintptr_t start = reinterpret_cast<uintptr_t>(buffer.data());
+  const uintptr_t aligned =
+      (start + alignof(OpStats) - 1) & ~(alignof(OpStats) - 1);
+  const size_t padding = aligned - start;
+  const size_t available = buffer.size() > padding ? buffer.size() - padding
+                                                    : 0;
+  capacity_ = available / kBytesPerEvent;
+  ET_CHECK_MSG(
+      capacity_ > 0,
+      "Buffer of %zu bytes can't hold the stats of a single event",
+      buffer.size());
+  // A power of two at least twice the capacity keeps probing short. It is at
+  // most four times the capacity, which kBytesPerEvent accounts for.
+  table_size_ = 1;
+  while (table_size_ < 2 * capacity_) {
+    table_size_ <<= 1;
+  }
+  stats_ = reinterpret_cast<OpStats*>(aligned);
+  table_ = reinterpret_cast<int32_t*>(stats_ + capacity_);
+  reset();
+}
+
+void SamplingEventTracer::reset() {
+  num_stats_ = 0;
+  for (size_t i = 0; i < table_size_; ++i) {
+    table_[i] = -1;
+  }
+  num_executions_ = 0;
+  sampled_ = sample_period_ > 0;
+  num_sampled_executions_ = 0;
+  num_dropped_events_ = 0;
+}
+
+void SamplingEventTracer::set_sample_period(uint32_t period) {
+  sample_period_ = period;
+  num_executions_ = 0;
+  if (period == 0) {
+    sampled_ = false;
+  }
+}
+
+void SamplingEventTracer::create_event_block(const char* /*name*/) {
+  sampled_ = sample_period_ > 0 && num_executions_ % sample_period_ == 0;
+  ++num_executions_;
+  if (sampled_) {
+    ++num_sampled_executions_;
+  }
+}
+
+int64_t SamplingEventTracer::find_stats(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  if (filter_ != nullptr) {
+    Result<bool> matches = filter_->filter(
+        const_cast<char*>(name),
+        name != nullptr ? kUnsetDebugHandle : delegate_debug_index);
+    if (!matches.ok() || !matches.get()) {
+      return -1;
+    }
+  }
+
+  const size_t mask = table_size_ - 1;
+  for (size_t slot = hash_event(delegate_debug_index, chain_id, debug_handle);;
+       ++slot) {
+    int32_t& index = table_[slot & mask];
+    if (index < 0) {
+      if (num_stats_ == capacity_) {
+        ++num_dropped_events_;
+        return -1;
+      }
+      OpStats& stats = stats_[num_stats_];
+      stats.name = name;
+      stats.delegate_debug_index = delegate_debug_index;
+      stats.chain_id = chain_id;
+      stats.debug_handle = debug_handle;
+      stats.count = 0;
+      stats.sum = 0;
+      stats.min = std::numeric_limits<et_timestamp_t>::max();
+      stats.max = 0;
+      memset(stats.buckets, 0, sizeof(stats.buckets));
+      index = static_cast<int32_t>(num_stats_++);
+      return index;
+    }
+    const OpStats& stats = stats_[index];
+    if (stats.chain_id == chain_id && stats.debug_handle == debug_handle &&
+        stats.delegate_debug_index == delegate_debug_index &&
+        same_name(stats.name, name)) {
+      return index;
+    }
+  }
+}
+
+void SamplingEventTracer::add_duration(
+    int64_t index,
+    et_timestamp_t duration) {
+  OpStats& stats = stats_[index];
+  ++stats.count;
+  stats.sum += duration;
+  stats.min = std::min(stats.min, duration);
+  stats.max = std::max(stats.max, duration);
+  ++stats.buckets[bucket_of(duration)];
+}
+
+EventTracerEntry SamplingEventTracer::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  EventTracerEntry prof_entry;
+  prof_entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  if (chain_id == -1) {
+    chain_id = chain_id_;
+    debug_handle = debug_handle_;
+  }
+  prof_entry.chain_id = chain_id;
+  prof_entry.debug_handle = debug_handle;
+  // The event id is the index of the stats to update, or -1 to skip it.
+  prof_entry.event_id = sampled_
+      ? find_stats(name, kNoDelegateDebugIndex, chain_id, debug_handle)
+      : -1;
+  prof_entry.start_time = prof_entry.event_id >= 0 ? et_pal_current_ticks() : 0;
+  return prof_entry;
+}
+
+void SamplingEventTracer::end_profiling(EventTracerEntry prof_entry) {
+  if (prof_entry.event_id < 0) {
+    return;
+  }
+  add_duration(
+      prof_entry.event_id, et_pal_current_ticks() - prof_entry.start_time);
+}
+
+EventTracerEntry SamplingEventTracer::start_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index) {
+  EventTracerEntry prof_entry;
+  prof_entry.delegate_event_id_type = name != nullptr
+      ? DelegateDebugIdType::kStr
+      : DelegateDebugIdType::kInt;
+  prof_entry.chain_id = chain_id_;
+  prof_entry.debug_handle = debug_handle_;
+  prof_entry.event_id = sampled_
+      ? find_stats(
+            name,
+            name != nullptr ? kNoDelegateDebugIndex : delegate_debug_index,
+            chain_id_,
+            debug_handle_)
+      : -1;
+  prof_entry.start_time = prof_entry.event_id >= 0 ? et_pal_current_ticks() : 0;
+  return prof_entry;
+}
+
+void SamplingEventTracer::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    const void* /*metadata*/,
+    size_t /*metadata_len*/) {
+  end_profiling(prof_entry);
+}
+
+void SamplingEventTracer::log_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const void* /*metadata*/,
+    size_t /*metadata_len*/) {
+  if (!sampled_) {
+    return;
+  }
+  const int64_t index = find_stats(
+      name,
+      name != nullptr ? kNoDelegateDebugIndex : delegate_debug_index,
+      chain_id_,
+      debug_handle_);
+  if (index >= 0) {
+    add_duration(index, end_time - start_time);
+  }
+}
+
+void SamplingEventTracer::track_allocation(
+    AllocatorID /*id*/,
+    size_t /*size*/) {}
+
+AllocatorID SamplingEventTracer::track_allocator(const char* /*name*/) {
+  return 0;
+}
+
+void SamplingEventTracer::log_evalue(
+    const EValue& /*evalue*/,
+    LoggedEValueType /*evalue_type*/) {}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const Tensor& /*output*/) {
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const ArrayRef<Tensor> /*output*/) {
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const int& /*output*/) {
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const bool& /*output*/) {
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* /*name*/,
+    DebugHandle /*delegate_debug_index*/,
+    const double& /*output*/) {
+  return false;
+}
+
+} // namespace etdump
+} // namespace executorch
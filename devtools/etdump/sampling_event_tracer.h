@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * The aggregated latencies of one profiled event, e.g. one operator of the
+ * plan. All durations are in ticks, see et_pal_ticks_to_ns_multiplier().
+ */
+struct OpStats {
+  /// Durations are counted in bucket i if they have i significant bits, i.e.
+  /// bucket 0 holds durations of 0 and bucket i > 0 those in
+  /// [2^(i-1), 2^i).
+  static constexpr size_t kNumBuckets = 65;
+
+  /// The name of the event, or nullptr for delegate events identified by
+  /// delegate_debug_index.
+  const char* name;
+  ::executorch::runtime::DebugHandle delegate_debug_index;
+  ::executorch::runtime::ChainID chain_id;
+  ::executorch::runtime::DebugHandle debug_handle;
+
+  uint64_t count;
+  et_timestamp_t sum;
+  et_timestamp_t min;
+  et_timestamp_t max;
+  uint32_t buckets[kNumBuckets];
+
+  /**
+   * Estimate the given percentile of the durations from the histogram, e.g.
+   * percentile(0.99) for the p99. The estimate is the upper bound of the
+   * bucket the percentile falls into, clamped to [min, max].
+   */
+  et_timestamp_t percentile(double fraction) const;
+};
+
+/**
+ * An EventTracer that keeps statistics of the profiling events instead of the
+ * events themselves, to measure op-level latencies over many runs at a small
+ * and constant memory cost.
+ *
+ * Each event with a distinct name, delegate debug index, chain id and debug
+ * handle, e.g. each instruction of the plan, gets an OpStats entry with its
+ * count, sum, min, max and a log2 histogram of its durations. To lower the
+ * overhead further, set_sample_period() only profiles one execution in N, and
+ * set_filter() only profiles the events that it matches; the other events
+ * cost a branch.
+ *
+ * An execution begins with each create_event_block() call, which the runtime
+ * makes at the start of Method::execute(). Allocations, evalues, intermediate
+ * outputs and delegate metadata are ignored. Event names are not copied, so
+ * they must outlive the tracer; the names passed in by the runtime point to
+ * string literals or into the loaded Program.
+ *
+ * Not thread safe, like ETDumpGen.
+ */
+class SamplingEventTracer : public ::executorch::runtime::EventTracer {
+ public:
+  /**
+   * @param buffer The memory for the statistics, which must outlive the
+   * tracer. Each distinct event takes kBytesPerEvent bytes of it; events that
+   * don't fit are counted by num_dropped_events().
+   */
+  explicit SamplingEventTracer(::executorch::runtime::Span<uint8_t> buffer);
+
+  SamplingEventTracer(const SamplingEventTracer&) = delete;
+  SamplingEventTracer& operator=(const SamplingEventTracer&) = delete;
+
+  void create_event_block(const char* name) override;
+  ::executorch::runtime::EventTracerEntry start_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id = -1,
+      ::executorch::runtime::DebugHandle debug_handle = 0) override;
+  void end_profiling(::executorch::runtime::EventTracerEntry prof_entry)
+      override;
+  ::executorch::runtime::EventTracerEntry start_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index) override;
+  void end_profiling_delegate(
+      ::executorch::runtime::EventTracerEntry prof_entry,
+      const void* metadata,
+      size_t metadata_len) override;
+  void log_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const void* metadata,
+      size_t metadata_len) override;
+  void track_allocation(::executorch::runtime::AllocatorID id, size_t size)
+      override;
+  ::executorch::runtime::AllocatorID track_allocator(const char* name) override;
+  void log_evalue(
+      const ::executorch::runtime::EValue& evalue,
+      ::executorch::runtime::LoggedEValueType evalue_type) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const executorch::aten::Tensor& output) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const ::executorch::runtime::ArrayRef<executorch::aten::Tensor> output)
+      override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const int& output) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const bool& output) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const double& output) override;
+
+  /**
+   * Only profile one execution in period, starting with the next one. 1, the
+   * default, profiles all of them and 0 none.
+   */
+  void set_sample_period(uint32_t period);
+
+  /**
+   * Only profile the events that filter matches, or all of them if nullptr.
+   * The filter must outlive the tracer. Events it fails on are not profiled.
+   */
+  void set_filter(::executorch::runtime::EventTracerFilterBase* filter) {
+    filter_ = filter;
+  }
+
+  /**
+   * The statistics of the events profiled so far, in the order they were
+   * first seen.
+   */
+  ::executorch::runtime::Span<const OpStats> stats() const {
+    return {stats_, num_stats_};
+  }
+
+  /// The number of executions that were profiled.
+  size_t num_sampled_executions() const {
+    return num_sampled_executions_;
+  }
+
+  /// The number of events not profiled because the buffer was full.
+  size_t num_dropped_events() const {
+    return num_dropped_events_;
+  }
+
+  /// Clear the statistics and restart the sampling period.
+  void reset();
+
+  /// The bytes of the buffer each distinct event takes, at most.
+  static constexpr size_t kBytesPerEvent =
+      sizeof(OpStats) + 4 * sizeof(int32_t);
+
+ private:
+  // Returns the index of the OpStats of the event in stats_, adding it if
+  // needed, or -1 if the event should not be profiled.
+  int64_t find_stats(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle);
+  void add_duration(int64_t index, et_timestamp_t duration);
+
+  OpStats* stats_;
+  // Open addressing table of indices into stats_, -1 for empty entries.
+  int32_t* table_;
+  size_t capacity_;
+  size_t table_size_;
+  size_t num_stats_ = 0;
+
+  ::executorch::runtime::EventTracerFilterBase* filter_ = nullptr;
+  uint32_t sample_period_ = 1;
+  uint64_t num_executions_ = 0;
+  bool sampled_ = true;
+  size_t num_sampled_executions_ = 0;
+  size_t num_dropped_events_ = 0;
+};
+
+} // namespace etdump
+} // namespace executorch
@@ -18,12 +18,22 @@ from typing import List, Optional
 from executorch.exir.scalar_type import ScalarType
 
 
+@dataclass
+class TensorStats:
+    min: float
+    max: float
+    mean: float
+    nan_count: int
+
+
 @dataclass
 class Tensor:
     scalar_type: ScalarType
     sizes: List[int]
     strides: List[int]
     offset: Optional[int]
+    stats: Optional[TensorStats] = None
+    sample_stride: int = 1
 
 
 @dataclass
@@ -109,6 +119,15 @@ class PROFILE_EVENT_ENUM(Enum):
     LOAD_MODEL = "Program::load_method"
 
 
+@dataclass
+class PerfCounters:
+    cycles: int = -1
+    instructions: int = -1
+    l1d_cache_misses: int = -1
+    llc_misses: int = -1
+    branch_misses: int = -1
+
+
 @dataclass
 class ProfileEvent:
     name: Optional[str]
@@ -119,6 +138,7 @@ class ProfileEvent:
     delegate_debug_metadata: Optional[bytes]
     start_time: int
     end_time: int
+    perf_counters: Optional[PerfCounters] = None
 
 
 @dataclass
@@ -8,7 +8,9 @@
 
 import json
 import os
+import struct
 import tempfile
+from typing import List
 
 import pkg_resources
 from executorch.devtools.etdump.schema_flatcc import ETDumpFlatCC
@@ -21,6 +23,9 @@ from executorch.exir._serialize._flatbuffer import _flatc_compile, _flatc_decomp
 ETDUMP_FLATCC_SCHEMA_NAME = "etdump_schema_flatcc"
 SCALAR_TYPE_SCHEMA_NAME = "scalar_type"
 
+# The file_identifier of etdump_schema_flatcc.fbs
+ETDUMP_FILE_IDENTIFIER = b"ED00"
+
 
 def _write_schema(d: str, schema_name: str) -> None:
     schema_path = os.path.join(d, "{}.fbs".format(schema_name))
@@ -94,17 +99,48 @@ def serialize_to_etdump_flatcc(
     return _convert_to_flatcc(_serialize_from_etdump_to_json(etdump))
 
 
+def _split_size_prefixed_etdumps(data: bytes) -> List[bytes]:
+    """
+    Splits the sequence of size-prefixed ETDumps written by a streaming
+    ETDumpGen, which may be separated by alignment padding, into the ETDumps.
+    """
+    chunks = []
+    # A size prefix and the root table offset precede the identifier.
+    start = data.find(ETDUMP_FILE_IDENTIFIER, 8) - 8
+    while 0 <= start and start + 4 <= len(data):
+        (size,) = struct.unpack_from("<I", data, start)
+        end = start + 4 + size
+        if end > len(data):
+            break
+        chunks.append(data[start:end])
+        next_id = data.find(ETDUMP_FILE_IDENTIFIER, end + 8)
+        start = next_id - 8 if next_id >= 0 else -1
+    return chunks
+
+
 def deserialize_from_etdump_flatcc(
     data: bytes, size_prefixed: bool = True
 ) -> ETDumpFlatCC:
     """
     Given an etdump binary blob (constructed using the FlatCC schema) this function will deserialize
     it and return the FlatCC python object representation of etdump.
+    A size-prefixed blob may also hold the sequence of ETDumps streamed by
+    ETDumpGen::set_etdump_sink(), whose run data are merged in order.
     Args:
         data: Serialized etdump binary blob.
     Returns:
         Deserialized ETDump python object.
     """
-    return _deserialize_from_json_to_etdump_flatcc(
-        _convert_from_flatcc(data, size_prefixed)
-    )
+    chunks = _split_size_prefixed_etdumps(data) if size_prefixed else []
+    if len(chunks) <= 1:
+        return _deserialize_from_json_to_etdump_flatcc(
+            _convert_from_flatcc(data, size_prefixed)
+        )
+    etdumps = [
+        _deserialize_from_json_to_etdump_flatcc(_convert_from_flatcc(chunk))
+        for chunk in chunks
+    ]
+    merged = etdumps[0]
+    for etdump in etdumps[1:]:
+        merged.run_data.extend(etdump.run_data)
+    return merged
@@ -87,6 +87,42 @@ def define_common_targets():
         exported_external_deps = ["flatccrt"],
     )
 
+    runtime.cxx_library(
+        name = "etdump_reader",
+        srcs = [
+            "etdump_reader.cpp",
+        ],
+        exported_headers = [
+            "etdump_reader.h",
+        ],
+        deps = [
+            ":etdump_schema_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    # Prints per-operator and per-delegate-event statistics of an ETDump.
+    runtime.cxx_binary(
+        name = "etdump_stats",
+        srcs = [
+            "etdump_stats.cpp",
+        ],
+        deps = [
+            ":etdump_reader",
+            "//executorch/runtime/platform:platform",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+    )
+
     runtime.cxx_library(
         name = "utils",
         srcs = [],
@@ -101,17 +137,43 @@ def define_common_targets():
     for aten_mode in get_aten_mode_options():
         aten_suffix = "_aten" if aten_mode else ""
 
+        runtime.cxx_library(
+            name = "sampling_event_tracer" + aten_suffix,
+            srcs = [
+                "sampling_event_tracer.cpp",
+            ],
+            exported_headers = [
+                "sampling_event_tracer.h",
+            ],
+            deps = [
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core:event_tracer" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
+
         runtime.cxx_library(
             name = "etdump_flatcc" + aten_suffix,
             srcs = [
                 "etdump_flatcc.cpp",
                 "emitter.cpp",
+                "perf_counters.cpp",
+                "ring_buffer_event_tracer.cpp",
+                "tensor_stats.cpp",
             ],
             headers = [
                 "emitter.h",
             ],
             exported_headers = [
                 "etdump_flatcc.h",
+                "perf_counters.h",
+                "ring_buffer_event_tracer.h",
+                "tensor_stats.h",
             ],
             deps = [
                 "//executorch/runtime/platform:platform",
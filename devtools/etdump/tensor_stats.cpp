@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/tensor_stats.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <executorch/runtime/platform/log.h>
+
+using ::executorch::aten::BFloat16;
+using ::executorch::aten::Half;
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+// The number of independent accumulators. Keeping one per lane lets the
+// compiler vectorize the loop without reassociating floating point math.
+constexpr size_t kLanes = 8;
+
+/**
+ * Computes the statistics of `numel` elements of type T, compared in type U
+ * (float or double).
+ */
+template <typename T, typename U>
+TensorStats compute_stats(const T* data, size_t numel) {
+  U min[kLanes];
+  U max[kLanes];
+  double sum[kLanes];
+  size_t nan_count[kLanes];
+  for (size_t l = 0; l < kLanes; ++l) {
+    min[l] = std::numeric_limits<U>::infinity();
+    max[l] = -std::numeric_limits<U>::infinity();
+    sum[l] = 0;
+    nan_count[l] = 0;
+  }
+
+  const auto accumulate = [&](size_t l, U x) {
+    const bool is_nan = x != x;
+    // Comparisons with NaN are false, so it never becomes the min or max.
+    min[l] = x < min[l] ? x : min[l];
+    max[l] = x > max[l] ? x : max[l];
+    sum[l] += is_nan ? 0 : static_cast<double>(x);
+    nan_count[l] += is_nan ? 1 : 0;
+  };
+  size_t i = 0;
+  for (; i + kLanes <= numel; i += kLanes) {
+    for (size_t l = 0; l < kLanes; ++l) {
+      accumulate(l, static_cast<U>(data[i + l]));
+    }
+  }
+  for (; i < numel; ++i) {
+    accumulate(0, static_cast<U>(data[i]));
+  }
+
+  TensorStats stats;
+  stats.min = min[0];
+  stats.max = max[0];
+  double total = sum[0];
+  stats.nan_count = nan_count[0];
+  for (size_t l = 1; l < kLanes; ++l) {
+    stats.min = std::fmin(stats.min, min[l]);
+    stats.max = std::fmax(stats.max, max[l]);
+    total += sum[l];
+    stats.nan_count += nan_count[l];
+  }
+  const size_t count = numel - stats.nan_count;
+  if (count == 0) {
+    stats.min = stats.max = stats.mean = NAN;
+  } else {
+    stats.mean = total / count;
+  }
+  return stats;
+}
+
+} // namespace
+
+Result<TensorStats> compute_tensor_stats(const Tensor& tensor) {
+  const size_t numel = tensor.numel();
+  const void* data = tensor.const_data_ptr();
+  switch (tensor.scalar_type()) {
+#define ET_TENSOR_STATS_CASE(ctype, dtype, compute_type) \
+  case ScalarType::dtype:                                \
+    return compute_stats<ctype, compute_type>(           \
+        static_cast<const ctype*>(data), numel);
+    ET_TENSOR_STATS_CASE(uint8_t, Byte, double)
+    ET_TENSOR_STATS_CASE(int8_t, Char, double)
+    ET_TENSOR_STATS_CASE(int16_t, Short, double)
+    ET_TENSOR_STATS_CASE(int32_t, Int, double)
+    ET_TENSOR_STATS_CASE(int64_t, Long, double)
+    ET_TENSOR_STATS_CASE(float, Float, float)
+    ET_TENSOR_STATS_CASE(double, Double, double)
+    ET_TENSOR_STATS_CASE(Half, Half, float)
+    ET_TENSOR_STATS_CASE(BFloat16, BFloat16, float)
+    ET_TENSOR_STATS_CASE(bool, Bool, float)
+#undef ET_TENSOR_STATS_CASE
+    default:
+      ET_LOG(
+          Error,
+          "Tensor stats of dtype %hhd are not supported",
+          static_cast<int8_t>(tensor.scalar_type()));
+      return Error::NotSupported;
+  }
+}
+
+} // namespace etdump
+} // namespace executorch
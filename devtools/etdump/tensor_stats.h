@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * Summary statistics of the elements of a tensor. NaN elements are counted
+ * but otherwise ignored; min, max and mean are NaN if no other element is
+ * left.
+ */
+struct TensorStats {
+  double min;
+  double max;
+  double mean;
+  size_t nan_count;
+};
+
+/**
+ * Computes the statistics of the elements of a tensor, in one pass over its
+ * data. Supports real, Half, BFloat16 and Bool tensors; returns
+ * Error::NotSupported for other dtypes.
+ */
+::executorch::runtime::Result<TensorStats> compute_tensor_stats(
+    const executorch::aten::Tensor& tensor);
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/devtools/etdump/etdump_reader.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::aggregate_profile_events;
+using ::executorch::etdump::ETDumpGen;
+using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::GroupBy;
+using ::executorch::etdump::ProfileEventRecord;
+using ::executorch::etdump::ProfileEventStats;
+using ::executorch::etdump::read_profile_events;
+using ::executorch::etdump::write_csv;
+using ::executorch::etdump::write_json;
+using ::executorch::runtime::Error;
+
+class ETDumpReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  void TearDown() override {
+    free(result_.buf);
+  }
+
+  // Records `num_runs` runs of a method with an operator and a delegate call
+  // that logs two delegate events. Run i takes i + 1 times as long as the
+  // first.
+  void record_runs(size_t num_runs) {
+    uint64_t time = 0;
+    for (size_t run = 0; run < num_runs; ++run) {
+      const uint64_t scale = run + 1;
+      etdump_gen_.create_event_block("run");
+      etdump_gen_.log_profiling(
+          "Method::execute", -1, 0, time, time + 100 * scale);
+      etdump_gen_.log_profiling(
+          "OPERATOR_CALL", 0, 0, time + 10 * scale, time + 30 * scale);
+      etdump_gen_.log_profiling(
+          "DELEGATE_CALL", 0, 1, time + 30 * scale, time + 90 * scale);
+      etdump_gen_.log_profiling_delegate(
+          "conv", -1, time + 40 * scale, time + 60 * scale, nullptr, 0);
+      etdump_gen_.log_profiling_delegate(
+          nullptr, 7, time + 60 * scale, time + 80 * scale, nullptr, 0);
+      time += 1000;
+    }
+    result_ = etdump_gen_.get_etdump_data();
+    ASSERT_NE(result_.buf, nullptr);
+  }
+
+  static const ProfileEventStats* find(
+      const std::vector<ProfileEventStats>& stats,
+      const char* name) {
+    for (const auto& s : stats) {
+      if (s.name == name) {
+        return &s;
+      }
+    }
+    return nullptr;
+  }
+
+  ETDumpGen etdump_gen_;
+  ETDumpResult result_ = {nullptr, 0};
+};
+
+TEST_F(ETDumpReaderTest, ReadsProfileEvents) {
+  record_runs(2);
+
+  auto events = read_profile_events(result_.buf, result_.size);
+  ASSERT_EQ(events.error(), Error::Ok);
+  ASSERT_EQ(events->size(), 10);
+
+  const ProfileEventRecord& op = events->at(1);
+  EXPECT_EQ(op.run_index, 0);
+  EXPECT_EQ(op.name, "OPERATOR_CALL");
+  EXPECT_EQ(op.chain_index, 0);
+  EXPECT_EQ(op.instruction_id, 0);
+  EXPECT_EQ(op.start_time, 10);
+  EXPECT_EQ(op.end_time, 30);
+  EXPECT_FALSE(op.is_delegate());
+
+  const ProfileEventRecord& conv = events->at(3);
+  EXPECT_TRUE(conv.is_delegate());
+  EXPECT_EQ(conv.delegate_debug_id_str, "conv");
+  EXPECT_EQ(events->at(4).delegate_debug_id_int, 7);
+  EXPECT_EQ(events->at(9).run_index, 1);
+}
+
+TEST_F(ETDumpReaderTest, RejectsOtherData) {
+  const std::vector<uint8_t> data(64, 0);
+  EXPECT_EQ(
+      read_profile_events(data.data(), data.size()).error(),
+      Error::InvalidArgument);
+}
+
+TEST_F(ETDumpReaderTest, ReadsConcatenatedETDumps) {
+  record_runs(1);
+  // Append a second copy after alignment padding, as a streaming ETDumpGen
+  // does.
+  const size_t second_offset = (result_.size + 8 + 15) / 16 * 16;
+  std::vector<uint8_t> data(second_offset + result_.size, 0);
+  memcpy(data.data(), result_.buf, result_.size);
+  memcpy(data.data() + second_offset, result_.buf, result_.size);
+
+  auto events = read_profile_events(data.data(), data.size());
+  ASSERT_EQ(events.error(), Error::Ok);
+  ASSERT_EQ(events->size(), 10);
+  EXPECT_EQ(events->at(4).run_index, 0);
+  EXPECT_EQ(events->at(5).run_index, 1);
+}
+
+TEST_F(ETDumpReaderTest, AggregatesByInstruction) {
+  record_runs(2);
+  auto events = read_profile_events(result_.buf, result_.size);
+  ASSERT_EQ(events.error(), Error::Ok);
+
+  const auto stats = aggregate_profile_events(*events, GroupBy::Instruction);
+  ASSERT_EQ(stats.size(), 5);
+  // Sorted by total time.
+  EXPECT_EQ(stats[0].name, "Method::execute");
+  EXPECT_EQ(stats[1].name, "DELEGATE_CALL");
+
+  const auto* method = find(stats, "Method::execute");
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(method->count, 2);
+  EXPECT_EQ(method->total_time, 300);
+  // The operator and delegate calls take 80 of every 100 ticks.
+  EXPECT_EQ(method->self_time, 60);
+  EXPECT_EQ(method->min_time, 100);
+  EXPECT_EQ(method->max_time, 200);
+  EXPECT_EQ(method->p50_time, 100);
+  EXPECT_EQ(method->p99_time, 200);
+
+  const auto* delegate_call = find(stats, "DELEGATE_CALL");
+  ASSERT_NE(delegate_call, nullptr);
+  EXPECT_FALSE(delegate_call->is_delegate);
+  EXPECT_EQ(delegate_call->instruction_id, 1);
+  EXPECT_EQ(delegate_call->total_time, 180);
+  EXPECT_EQ(delegate_call->self_time, 60);
+
+  const auto* conv = find(stats, "conv");
+  ASSERT_NE(conv, nullptr);
+  EXPECT_TRUE(conv->is_delegate);
+  EXPECT_EQ(conv->total_time, 60);
+  EXPECT_EQ(conv->self_time, 60);
+  EXPECT_NE(find(stats, "delegate_debug_id_7"), nullptr);
+}
+
+TEST_F(ETDumpReaderTest, AggregatesByName) {
+  etdump_gen_.create_event_block("run");
+  etdump_gen_.log_profiling("OPERATOR_CALL", 0, 0, 0, 10);
+  etdump_gen_.log_profiling("OPERATOR_CALL", 0, 1, 10, 40);
+  result_ = etdump_gen_.get_etdump_data();
+  auto events = read_profile_events(result_.buf, result_.size);
+  ASSERT_EQ(events.error(), Error::Ok);
+
+  EXPECT_EQ(aggregate_profile_events(*events, GroupBy::Instruction).size(), 2);
+  const auto stats = aggregate_profile_events(*events, GroupBy::Name);
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].count, 2);
+  EXPECT_EQ(stats[0].chain_index, -1);
+  EXPECT_EQ(stats[0].instruction_id, -1);
+  EXPECT_EQ(stats[0].total_time, 40);
+  EXPECT_EQ(stats[0].p50_time, 10);
+  EXPECT_EQ(stats[0].p90_time, 30);
+}
+
+TEST_F(ETDumpReaderTest, WritesCsvAndJson) {
+  std::vector<ProfileEventStats> stats(1);
+  stats[0].name = "a,\"b\"";
+  stats[0].is_delegate = true;
+  stats[0].chain_index = 0;
+  stats[0].instruction_id = 3;
+  stats[0].count = 2;
+  stats[0].total_time = 3000000000;
+  stats[0].self_time = 10;
+  stats[0].min_time = 1;
+  stats[0].max_time = 2999999999;
+  stats[0].p50_time = 1;
+  stats[0].p90_time = 2999999999;
+  stats[0].p99_time = 2999999999;
+
+  std::ostringstream csv;
+  write_csv(csv, stats);
+  EXPECT_EQ(
+      csv.str(),
+      "name,is_delegate,chain_index,instruction_id,count,total_time,"
+      "self_time,mean_time,min_time,p50_time,p90_time,p99_time,max_time\n"
+      "\"a,\"\"b\"\"\",true,0,3,2,3000000000,10,1500000000,1,1,2999999999,"
+      "2999999999,2999999999\n");
+
+  std::ostringstream json;
+  write_json(json, stats, 0.5);
+  EXPECT_EQ(
+      json.str(),
+      "[\n  {\"name\": \"a,\\\"b\\\"\", \"is_delegate\": true, "
+      "\"chain_index\": 0, \"instruction_id\": 3, \"count\": 2, "
+      "\"total_time\": 1500000000, \"self_time\": 5, "
+      "\"mean_time\": 750000000, \"min_time\": 0.5, \"p50_time\": 0.5, "
+      "\"p90_time\": 1499999999.5, \"p99_time\": 1499999999.5, "
+      "\"max_time\": 1499999999.5}\n]\n");
+}
@@ -22,16 +22,19 @@
 #include <executorch/test/utils/DeathTest.h>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 using ::executorch::aten::ScalarType;
 using ::executorch::aten::Tensor;
 using ::executorch::etdump::ETDumpGen;
 using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::TensorCaptureMode;
 using ::executorch::extension::testing::TempFile;
 using ::executorch::runtime::AllocatorID;
 using ::executorch::runtime::ArrayRef;
 using ::executorch::runtime::BoxedEvalueList;
 using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
 using ::executorch::runtime::EventTracerEntry;
 using ::executorch::runtime::LoggedEValueType;
@@ -827,3 +830,139 @@ TEST_F(ProfilerETDumpTest, WriteAfterGetETDumpData) {
     }
   }
 }
+
+namespace {
+
+// Keeps a copy of each write, to check the ETDumps streamed to it.
+class RecordingDataSink : public ::executorch::etdump::DataSinkBase {
+ public:
+  ::executorch::runtime::Result<size_t> write(const void* ptr, size_t length)
+      override {
+    const size_t offset = used_bytes_;
+    const uint8_t* data = static_cast<const uint8_t*>(ptr);
+    writes.emplace_back(data, data + length);
+    used_bytes_ += length;
+    return offset;
+  }
+
+  size_t get_used_bytes() const override {
+    return used_bytes_;
+  }
+
+  std::vector<std::vector<uint8_t>> writes;
+
+ private:
+  size_t used_bytes_ = 0;
+};
+
+} // namespace
+
+TEST_F(ProfilerETDumpTest, StreamETDumpToDataSink) {
+  for (size_t i = 0; i < 2; i++) {
+    RecordingDataSink etdump_sink;
+    etdump_gen[i]->set_etdump_sink(&etdump_sink, /*blocks_per_chunk=*/2);
+    for (size_t j = 0; j < 5; j++) {
+      etdump_gen[i]->create_event_block("test_block");
+      EventTracerEntry entry =
+          etdump_gen[i]->start_profiling("test_event", 0, 1);
+      etdump_gen[i]->end_profiling(entry);
+    }
+    // The first four blocks were written when the third and fifth started.
+    ASSERT_EQ(etdump_sink.writes.size(), 2);
+    EXPECT_EQ(etdump_gen[i]->get_num_blocks(), 1);
+    ASSERT_EQ(etdump_gen[i]->flush_etdump(), Error::Ok);
+    ASSERT_EQ(etdump_sink.writes.size(), 3);
+
+    const size_t expected_blocks[] = {2, 2, 1};
+    for (size_t j = 0; j < 3; j++) {
+      size_t size = 0;
+      void* buf =
+          flatbuffers_read_size_prefix(etdump_sink.writes[j].data(), &size);
+      etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+          buf, etdump_ETDump_file_identifier);
+      ASSERT_NE(etdump, nullptr);
+      etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+      ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), expected_blocks[j]);
+      etdump_Event_vec_t events =
+          etdump_RunData_events(etdump_RunData_vec_at(run_data_vec, 0));
+      EXPECT_EQ(etdump_Event_vec_len(events), 1);
+    }
+
+    etdump_gen[i]->set_etdump_sink(nullptr);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, TensorCaptureModes) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor tensor = tf.make({2, 5}, {0, 1, 2, 3, NAN, 5, 6, 7, 8, 9});
+  uint8_t sample_buffer[4 * sizeof(float)];
+
+  for (size_t i = 0; i < 2; i++) {
+    RecordingDataSink data_sink;
+    etdump_gen[i]->create_event_block("test_block");
+    etdump_gen[i]->set_data_sink(&data_sink);
+
+    etdump_gen[i]->set_tensor_capture_mode(TensorCaptureMode::kStats);
+    etdump_gen[i]->log_intermediate_output_delegate(nullptr, 1, tensor);
+    etdump_gen[i]->set_tensor_capture_mode(
+        TensorCaptureMode::kSampled,
+        Span<uint8_t>(sample_buffer, sizeof(sample_buffer)));
+    etdump_gen[i]->log_intermediate_output_delegate(nullptr, 2, tensor);
+    // Program outputs are always copied in full.
+    etdump_gen[i]->log_evalue(EValue(tensor), LoggedEValueType::kProgramOutput);
+    etdump_gen[i]->set_tensor_capture_mode(TensorCaptureMode::kFull);
+
+    // Only the samples and the program output were copied. Four samples of
+    // ten elements take every third one.
+    ASSERT_EQ(data_sink.writes.size(), 2);
+    ASSERT_EQ(data_sink.writes[0].size(), 4 * sizeof(float));
+    float samples[4];
+    memcpy(samples, data_sink.writes[0].data(), sizeof(samples));
+    EXPECT_EQ(samples[0], 0);
+    EXPECT_EQ(samples[1], 3);
+    EXPECT_EQ(samples[2], 6);
+    EXPECT_EQ(samples[3], 9);
+    EXPECT_EQ(data_sink.writes[1].size(), tensor.nbytes());
+
+    ETDumpResult result = etdump_gen[i]->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 3);
+    const auto tensor_at = [&](size_t j) {
+      return etdump_Value_tensor(etdump_DebugEvent_debug_entry(
+          etdump_Event_debug_event(etdump_Event_vec_at(events, j))));
+    };
+
+    // Statistics only.
+    etdump_Tensor_table_t stats_only = tensor_at(0);
+    EXPECT_EQ(etdump_Tensor_offset(stats_only), -1);
+    EXPECT_EQ(etdump_Tensor_sample_stride(stats_only), 0);
+    ASSERT_TRUE(etdump_Tensor_stats_is_present(stats_only));
+    etdump_TensorStats_table_t stats = etdump_Tensor_stats(stats_only);
+    EXPECT_EQ(etdump_TensorStats_min(stats), 0);
+    EXPECT_EQ(etdump_TensorStats_max(stats), 9);
+    EXPECT_DOUBLE_EQ(etdump_TensorStats_mean(stats), 41.0 / 9);
+    EXPECT_EQ(etdump_TensorStats_nan_count(stats), 1);
+
+    // Statistics and samples.
+    etdump_Tensor_table_t sampled = tensor_at(1);
+    EXPECT_EQ(etdump_Tensor_offset(sampled), 0);
+    EXPECT_EQ(etdump_Tensor_sample_stride(sampled), 3);
+    EXPECT_TRUE(etdump_Tensor_stats_is_present(sampled));
+
+    // The full program output.
+    etdump_Tensor_table_t full = tensor_at(2);
+    EXPECT_EQ(etdump_Tensor_offset(full), 4 * sizeof(float));
+    EXPECT_EQ(etdump_Tensor_sample_stride(full), 1);
+    EXPECT_FALSE(etdump_Tensor_stats_is_present(full));
+
+    if (!etdump_gen[i]->is_static_etdump()) {
+      free(result.buf);
+    }
+  }
+}
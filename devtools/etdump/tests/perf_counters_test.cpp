@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/devtools/etdump/perf_counters.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::kNumPerfCounters;
+using ::executorch::etdump::kPerfCounterUnavailable;
+using ::executorch::etdump::PerfCounter;
+using ::executorch::etdump::PerfCounterReader;
+using ::executorch::etdump::PerfCounterValues;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+class PerfCounterReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(PerfCounterReaderTest, CountersIncrease) {
+  Result<PerfCounterReader> reader = PerfCounterReader::create();
+  if (!reader.ok()) {
+    // VMs and containers often have no PMU.
+    EXPECT_EQ(reader.error(), Error::NotSupported);
+    GTEST_SKIP() << "No hardware counter available";
+  }
+
+  PerfCounterValues before;
+  ASSERT_EQ(reader->read(before), Error::Ok);
+  volatile uint64_t sum = 0;
+  for (uint64_t i = 0; i < 100000; ++i) {
+    sum += i;
+  }
+  PerfCounterValues after;
+  ASSERT_EQ(reader->read(after), Error::Ok);
+
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    const PerfCounter counter = static_cast<PerfCounter>(i);
+    if (!reader->is_available(counter)) {
+      EXPECT_EQ(after[counter], kPerfCounterUnavailable);
+      continue;
+    }
+    EXPECT_GE(after[counter], before[counter]);
+  }
+  if (reader->is_available(PerfCounter::kInstructions)) {
+    EXPECT_GT(
+        after[PerfCounter::kInstructions], before[PerfCounter::kInstructions]);
+  }
+}
+
+TEST_F(PerfCounterReaderTest, MovedReaderKeepsCounters) {
+  Result<PerfCounterReader> reader = PerfCounterReader::create();
+  if (!reader.ok()) {
+    GTEST_SKIP() << "No hardware counter available";
+  }
+  PerfCounterReader moved(std::move(reader.get()));
+  PerfCounterValues values;
+  EXPECT_EQ(moved.read(values), Error::Ok);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/devtools/etdump/etdump_schema_flatcc_reader.h>
+#include <executorch/devtools/etdump/ring_buffer_event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::ETDumpGen;
+using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::RingBufferEventTracer;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::Span;
+
+class RingBufferEventTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Returns the buffer for a ring of num_events events.
+  static std::vector<uint8_t> make_buffer(size_t num_events) {
+    // Extra room to align the slots.
+    return std::vector<uint8_t>(
+        num_events * RingBufferEventTracer::kEventSize + 16);
+  }
+
+  // Snapshots tracer into a new ETDump and checks it holds the given number
+  // of blocks and events in its last block.
+  static void expect_snapshot(
+      RingBufferEventTracer& tracer,
+      size_t expected_lost,
+      size_t expected_blocks,
+      std::vector<std::string> expected_names) {
+    ETDumpGen etdump_gen;
+    EXPECT_EQ(tracer.snapshot(etdump_gen), expected_lost);
+    ETDumpResult result = etdump_gen.get_etdump_data();
+    ASSERT_NE(result.buf, nullptr);
+
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), expected_blocks);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(run_data_vec, expected_blocks - 1));
+    ASSERT_EQ(etdump_Event_vec_len(events), expected_names.size());
+    for (size_t i = 0; i < expected_names.size(); ++i) {
+      etdump_ProfileEvent_table_t profile_event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, i));
+      const char* name = etdump_ProfileEvent_name(profile_event);
+      EXPECT_EQ(std::string(name, strlen(name)), expected_names[i]);
+      EXPECT_LE(
+          etdump_ProfileEvent_start_time(profile_event),
+          etdump_ProfileEvent_end_time(profile_event));
+    }
+    free(result.buf);
+  }
+};
+
+TEST_F(RingBufferEventTracerTest, SnapshotSerializesEvents) {
+  std::vector<uint8_t> buffer = make_buffer(8);
+  RingBufferEventTracer tracer(Span<uint8_t>(buffer.data(), buffer.size()));
+  EXPECT_EQ(tracer.capacity(), 8);
+
+  tracer.create_event_block("test_block");
+  EventTracerEntry entry_1 = tracer.start_profiling("test_event_1", 0, 1);
+  EventTracerEntry entry_2 = tracer.start_profiling("test_event_2", 0, 2);
+  tracer.end_profiling(entry_2);
+  tracer.end_profiling(entry_1);
+  EventTracerEntry delegate_entry =
+      tracer.start_profiling_delegate("test_delegate", -1);
+  tracer.end_profiling_delegate(delegate_entry, nullptr, 0);
+
+  expect_snapshot(
+      tracer, 0, 1, {"test_event_2", "test_event_1", "test_delegate"});
+
+  // A second snapshot only has what was recorded since the first one, which
+  // goes to the default block.
+  EventTracerEntry entry_3 = tracer.start_profiling("test_event_3", 0, 3);
+  tracer.end_profiling(entry_3);
+  expect_snapshot(tracer, 0, 1, {"test_event_3"});
+}
+
+TEST_F(RingBufferEventTracerTest, WrapAroundDropsOldestEvents) {
+  std::vector<uint8_t> buffer = make_buffer(4);
+  RingBufferEventTracer tracer(Span<uint8_t>(buffer.data(), buffer.size()));
+  ASSERT_EQ(tracer.capacity(), 4);
+
+  const char* names[] = {"e0", "e1", "e2", "e3", "e4", "e5"};
+  for (const char* name : names) {
+    tracer.end_profiling(tracer.start_profiling(name, 0, 0));
+  }
+  expect_snapshot(tracer, 2, 1, {"e2", "e3", "e4", "e5"});
+}
+
+TEST_F(RingBufferEventTracerTest, DisabledTracerDropsEvents) {
+  std::vector<uint8_t> buffer = make_buffer(4);
+  RingBufferEventTracer tracer(Span<uint8_t>(buffer.data(), buffer.size()));
+
+  tracer.set_enabled(false);
+  tracer.create_event_block("disabled_block");
+  EventTracerEntry entry = tracer.start_profiling("dropped", 0, 0);
+  // Events started while disabled are dropped even if enabled meanwhile.
+  tracer.set_enabled(true);
+  tracer.end_profiling(entry);
+  tracer.log_profiling_delegate(
+      nullptr, static_cast<DebugHandle>(7), 1, 2, nullptr, 0);
+  tracer.end_profiling(tracer.start_profiling("kept", 0, 0));
+
+  ETDumpGen etdump_gen;
+  EXPECT_EQ(tracer.snapshot(etdump_gen), 0);
+  EXPECT_EQ(etdump_gen.get_num_blocks(), 1);
+  ETDumpResult result = etdump_gen.get_etdump_data();
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+      buf, etdump_ETDump_file_identifier);
+  etdump_Event_vec_t events = etdump_RunData_events(
+      etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+  ASSERT_EQ(etdump_Event_vec_len(events), 2);
+  etdump_ProfileEvent_table_t delegate_event =
+      etdump_Event_profile_event(etdump_Event_vec_at(events, 0));
+  EXPECT_EQ(etdump_ProfileEvent_delegate_debug_id_int(delegate_event), 7);
+  free(result.buf);
+}
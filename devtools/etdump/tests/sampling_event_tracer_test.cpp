@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <executorch/devtools/etdump/sampling_event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::OpStats;
+using ::executorch::etdump::SamplingEventTracer;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::EventTracerFilterBase;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace {
+
+// Matches the delegate events with the given name.
+class NameFilter : public EventTracerFilterBase {
+ public:
+  explicit NameFilter(const char* name) : name_(name) {}
+
+  Result<bool> filter(char* name, DebugHandle /*delegate_debug_index*/)
+      override {
+    return name != nullptr && strcmp(name, name_) == 0;
+  }
+
+ private:
+  const char* name_;
+};
+
+} // namespace
+
+class SamplingEventTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Runs an execution with one delegate event of the given duration for each
+  // of the given names.
+  static void run(
+      SamplingEventTracer& tracer,
+      std::vector<const char*> names,
+      et_timestamp_t duration) {
+    tracer.create_event_block("Execute");
+    for (size_t i = 0; i < names.size(); ++i) {
+      tracer.set_chain_debug_handle(0, static_cast<DebugHandle>(i));
+      tracer.log_profiling_delegate(
+          names[i],
+          static_cast<DebugHandle>(-1),
+          /*start_time=*/100,
+          /*end_time=*/100 + duration,
+          /*metadata=*/nullptr,
+          /*metadata_len=*/0);
+    }
+    tracer.set_chain_debug_handle(-1, 0);
+  }
+
+  std::vector<uint8_t> buffer_ =
+      std::vector<uint8_t>(16 * SamplingEventTracer::kBytesPerEvent + 16);
+};
+
+TEST_F(SamplingEventTracerTest, AggregatesEventsPerInstruction) {
+  SamplingEventTracer tracer(Span<uint8_t>(buffer_.data(), buffer_.size()));
+  for (et_timestamp_t duration = 1; duration <= 100; ++duration) {
+    run(tracer, {"conv", "relu"}, duration);
+  }
+
+  EXPECT_EQ(tracer.num_sampled_executions(), 100);
+  ASSERT_EQ(tracer.stats().size(), 2);
+  const OpStats& conv = tracer.stats()[0];
+  EXPECT_STREQ(conv.name, "conv");
+  EXPECT_EQ(conv.chain_id, 0);
+  EXPECT_EQ(conv.debug_handle, 0);
+  EXPECT_EQ(conv.count, 100);
+  EXPECT_EQ(conv.sum, 5050);
+  EXPECT_EQ(conv.min, 1);
+  EXPECT_EQ(conv.max, 100);
+  // The 50th duration is in [32, 64), the 99th in [64, 128).
+  EXPECT_EQ(conv.percentile(0.5), 63);
+  EXPECT_EQ(conv.percentile(0.99), 100);
+  EXPECT_EQ(tracer.stats()[1].debug_handle, 1);
+
+  tracer.reset();
+  EXPECT_EQ(tracer.stats().size(), 0);
+}
+
+TEST_F(SamplingEventTracerTest, SampleOneExecutionInN) {
+  SamplingEventTracer tracer(Span<uint8_t>(buffer_.data(), buffer_.size()));
+  tracer.set_sample_period(4);
+  for (int i = 0; i < 10; ++i) {
+    run(tracer, {"conv"}, 10);
+  }
+  // Executions 0, 4 and 8.
+  EXPECT_EQ(tracer.num_sampled_executions(), 3);
+  ASSERT_EQ(tracer.stats().size(), 1);
+  EXPECT_EQ(tracer.stats()[0].count, 3);
+
+  tracer.set_sample_period(0);
+  run(tracer, {"conv"}, 10);
+  EventTracerEntry entry = tracer.start_profiling("OPERATOR_CALL");
+  tracer.end_profiling(entry);
+  EXPECT_EQ(tracer.stats()[0].count, 3);
+  EXPECT_EQ(tracer.stats().size(), 1);
+}
+
+TEST_F(SamplingEventTracerTest, FilterSelectsEvents) {
+  SamplingEventTracer tracer(Span<uint8_t>(buffer_.data(), buffer_.size()));
+  NameFilter filter("relu");
+  tracer.set_filter(&filter);
+  run(tracer, {"conv", "relu", "conv"}, 10);
+  ASSERT_EQ(tracer.stats().size(), 1);
+  EXPECT_STREQ(tracer.stats()[0].name, "relu");
+  EXPECT_EQ(tracer.stats()[0].debug_handle, 1);
+}
+
+TEST_F(SamplingEventTracerTest, OperatorEventsUseCurrentInstruction) {
+  SamplingEventTracer tracer(Span<uint8_t>(buffer_.data(), buffer_.size()));
+  for (int i = 0; i < 2; ++i) {
+    tracer.create_event_block("Execute");
+    for (DebugHandle instr = 0; instr < 3; ++instr) {
+      tracer.set_chain_debug_handle(0, instr);
+      EventTracerEntry entry = tracer.start_profiling("OPERATOR_CALL");
+      tracer.end_profiling(entry);
+    }
+  }
+  ASSERT_EQ(tracer.stats().size(), 3);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(tracer.stats()[i].debug_handle, i);
+    EXPECT_EQ(tracer.stats()[i].count, 2);
+    EXPECT_LE(tracer.stats()[i].min, tracer.stats()[i].max);
+  }
+}
+
+TEST_F(SamplingEventTracerTest, DropsEventsWhenFull) {
+  std::vector<uint8_t> small(2 * SamplingEventTracer::kBytesPerEvent + 16);
+  SamplingEventTracer tracer(Span<uint8_t>(small.data(), small.size()));
+  run(tracer, {"a", "b", "c", "d"}, 1);
+  EXPECT_EQ(tracer.stats().size(), 2);
+  EXPECT_EQ(tracer.num_dropped_events(), 2);
+}
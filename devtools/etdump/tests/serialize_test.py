@@ -8,6 +8,7 @@
 
 import difflib
 import json
+import struct
 import unittest
 from pprint import pformat
 from typing import List
@@ -15,7 +16,9 @@ from typing import List
 import executorch.devtools.etdump.schema_flatcc as flatcc
 
 from executorch.devtools.etdump.serialize import (
+    _split_size_prefixed_etdumps,
     deserialize_from_etdump_flatcc,
+    ETDUMP_FILE_IDENTIFIER,
     serialize_to_etdump_flatcc,
 )
 from executorch.exir._serialize._dataclass import _DataclassEncoder
@@ -140,3 +143,16 @@ class TestSerializeFlatCC(unittest.TestCase):
                 )
             ),
         )
+
+    def test_split_streamed_etdumps(self) -> None:
+        def size_prefixed(payload: bytes) -> bytes:
+            # A root table offset, the file identifier and the tables.
+            body = struct.pack("<I", 8) + ETDUMP_FILE_IDENTIFIER + payload
+            return struct.pack("<I", len(body)) + body
+
+        first = size_prefixed(b"\x01\x02\x03\x04")
+        second = size_prefixed(bytes(8))
+        # Chunks may be separated by the alignment padding of the sink.
+        streamed = first + bytes(5) + second
+        self.assertEqual(_split_size_prefixed_etdumps(streamed), [first, second])
+        self.assertEqual(_split_size_prefixed_etdumps(first), [first])
@@ -21,3 +21,61 @@ def define_common_targets():
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
         ],
     )
+
+    runtime.cxx_test(
+        name = "ring_buffer_event_tracer_test",
+        srcs = [
+            "ring_buffer_event_tracer_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/devtools/etdump:etdump_schema_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "sampling_event_tracer_test",
+        srcs = [
+            "sampling_event_tracer_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:sampling_event_tracer",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "perf_counters_test",
+        srcs = [
+            "perf_counters_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "etdump_reader_test",
+        srcs = [
+            "etdump_reader_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/devtools/etdump:etdump_reader",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "tensor_stats_test",
+        srcs = [
+            "tensor_stats_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
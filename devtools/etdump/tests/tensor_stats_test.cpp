@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/devtools/etdump/tensor_stats.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::aten::ScalarType;
+using ::executorch::etdump::compute_tensor_stats;
+using ::executorch::etdump::TensorStats;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::testing::TensorFactory;
+
+class TensorStatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(TensorStatsTest, Float) {
+  TensorFactory<ScalarType::Float> tf;
+  // More elements than accumulator lanes, and not a multiple of them.
+  std::vector<float> data;
+  for (int i = 0; i < 21; ++i) {
+    data.push_back(static_cast<float>(i - 10));
+  }
+  data[3] = NAN;
+  data[17] = NAN;
+
+  auto stats = compute_tensor_stats(tf.make({3, 7}, data));
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_EQ(stats->min, -10);
+  EXPECT_EQ(stats->max, 10);
+  // The sum of -10..10 without -7 and 7.
+  EXPECT_DOUBLE_EQ(stats->mean, 0.0);
+  EXPECT_EQ(stats->nan_count, 2);
+}
+
+TEST_F(TensorStatsTest, Infinity) {
+  TensorFactory<ScalarType::Float> tf;
+  auto stats = compute_tensor_stats(tf.make({3}, {1, INFINITY, -2}));
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_EQ(stats->min, -2);
+  EXPECT_EQ(stats->max, INFINITY);
+  EXPECT_EQ(stats->mean, INFINITY);
+  EXPECT_EQ(stats->nan_count, 0);
+}
+
+TEST_F(TensorStatsTest, AllNaN) {
+  TensorFactory<ScalarType::Double> tf;
+  auto stats = compute_tensor_stats(tf.make({2}, {NAN, NAN}));
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_TRUE(std::isnan(stats->min));
+  EXPECT_TRUE(std::isnan(stats->max));
+  EXPECT_TRUE(std::isnan(stats->mean));
+  EXPECT_EQ(stats->nan_count, 2);
+}
+
+TEST_F(TensorStatsTest, Empty) {
+  TensorFactory<ScalarType::Float> tf;
+  auto stats = compute_tensor_stats(tf.make({0}, {}));
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_TRUE(std::isnan(stats->mean));
+  EXPECT_EQ(stats->nan_count, 0);
+}
+
+TEST_F(TensorStatsTest, Integers) {
+  TensorFactory<ScalarType::Int> tf;
+  auto stats = compute_tensor_stats(tf.make({4}, {3, -5, 9, 1}));
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_EQ(stats->min, -5);
+  EXPECT_EQ(stats->max, 9);
+  EXPECT_DOUBLE_EQ(stats->mean, 2.0);
+  EXPECT_EQ(stats->nan_count, 0);
+}
+
+TEST_F(TensorStatsTest, Half) {
+  TensorFactory<ScalarType::Half> tf;
+  auto stats = compute_tensor_stats(tf.make({3}, {0.5, -1.5, 4}));
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_EQ(stats->min, -1.5);
+  EXPECT_EQ(stats->max, 4);
+  EXPECT_DOUBLE_EQ(stats->mean, 1.0);
+}
@@ -10,6 +10,7 @@ from executorch.devtools.inspector._inspector import (
     Event,
     EventBlock,
     Inspector,
+    PerfCounterData,
     PerfData,
 )
 from executorch.devtools.inspector._inspector_utils import compare_results, TimeScale
@@ -18,6 +19,7 @@ __all__ = [
     "Event",
     "EventBlock",
     "Inspector",
+    "PerfCounterData",
     "PerfData",
     "compare_results",
     "TimeScale",
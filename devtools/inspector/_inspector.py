@@ -56,6 +56,7 @@ from executorch.devtools.inspector._inspector_utils import (
     is_inference_output_equal,
     ProgramOutput,
     RESERVED_FRAMEWORK_EVENT_NAMES,
+    TIME_SCALE_DICT,
     TimeScale,
     verify_debug_data_equivalence,
 )
@@ -290,6 +291,61 @@ class PerfData:
         return max(self.raw)
 
 
+@dataclass
+class PerfCounterData:
+    """
+    The hardware performance counters of each ProfileEvent of an Event, as
+    recorded by ETDumpGen with a PerfCounterReader. Counters that were not
+    available on the device are -1 in `raw` and ignored by the averages.
+    """
+
+    def __init__(self, raw: List[flatcc.PerfCounters]):
+        self.raw: List[flatcc.PerfCounters] = raw
+
+    def _avg(self, counter: str) -> Optional[float]:
+        values = [getattr(c, counter) for c in self.raw if getattr(c, counter) >= 0]
+        return float(np.mean(values)) if values else None
+
+    def _per_kilo_instruction(self, counter: str) -> Optional[float]:
+        count = self._avg(counter)
+        instructions = self.instructions
+        if count is None or not instructions:
+            return None
+        return 1000 * count / instructions
+
+    @property
+    def cycles(self) -> Optional[float]:
+        return self._avg("cycles")
+
+    @property
+    def instructions(self) -> Optional[float]:
+        return self._avg("instructions")
+
+    @property
+    def ipc(self) -> Optional[float]:
+        """Instructions per cycle."""
+        cycles = self.cycles
+        instructions = self.instructions
+        if not cycles or instructions is None:
+            return None
+        return instructions / cycles
+
+    @property
+    def l1d_mpki(self) -> Optional[float]:
+        """L1 data cache misses per thousand instructions."""
+        return self._per_kilo_instruction("l1d_cache_misses")
+
+    @property
+    def llc_mpki(self) -> Optional[float]:
+        """Last level cache misses per thousand instructions."""
+        return self._per_kilo_instruction("llc_misses")
+
+    @property
+    def branch_mpki(self) -> Optional[float]:
+        """Branch mispredictions per thousand instructions."""
+        return self._per_kilo_instruction("branch_misses")
+
+
 @dataclass
 class Event:
     """
@@ -305,6 +361,9 @@ class Event:
         module_hierarchy: A dictionary mapping the name of each associated op to its module hierarchy.
         is_delegated_op: Whether or not the event was delegated.
         delegate_backend_name: Name of the backend this event was delegated to.
+        perf_counters: Hardware counters associated with the event, if they were recorded (available attributes: cycles, instructions, ipc, l1d_mpki, llc_mpki and branch_mpki).
+        flops: Estimated floating point operations of the associated ops, if known for all of them.
+        bytes_accessed: Estimated bytes read and written by the associated ops, from their tensor sizes.
 
         _delegate_debug_metadatas: A list of raw delegate debug metadata in string, one for each profile event.
             Available parsed (if parser provided) as Event.delegate_debug_metadatas
@@ -325,6 +384,9 @@ class Event:
     module_hierarchy: Dict[str, Dict] = dataclasses.field(default_factory=dict)
     is_delegated_op: Optional[bool] = None
     delegate_backend_name: Optional[str] = None
+    perf_counters: Optional[PerfCounterData] = None
+    flops: Optional[int] = None
+    bytes_accessed: Optional[int] = None
     _delegate_debug_metadatas: List[str] = dataclasses.field(default_factory=list)
 
     debug_data: ProgramOutput = dataclasses.field(default_factory=list)
@@ -522,6 +584,7 @@ class Event:
             delegate_debug_identifier
             is_delegated_op
             perf_data
+            perf_counters
             delegate_debug_metadatas
         """
 
@@ -530,6 +593,7 @@ class Event:
 
         # Fill out fields from profile event
         data = []
+        perf_counters = []
         delegate_debug_metadatas = []
         for event in events:
             if (profile_events := event.profile_events) is not None:
@@ -571,6 +635,8 @@ class Event:
                     )
 
                 data.append(scaled_time)
+                if profile_event.perf_counters is not None:
+                    perf_counters.append(profile_event.perf_counters)
                 delegate_debug_metadatas.append(
                     profile_event.delegate_debug_metadata
                     if profile_event.delegate_debug_metadata
@@ -580,6 +646,8 @@ class Event:
         # Update fields
         if len(data) > 0:
             ret_event.perf_data = PerfData(data)
+        if len(perf_counters) > 0:
+            ret_event.perf_counters = PerfCounterData(perf_counters)
         if any(delegate_debug_metadatas):
             ret_event._delegate_debug_metadatas = delegate_debug_metadatas
 
@@ -633,8 +701,8 @@ class Event:
         debug_handle_to_op_node_map: Dict[int, OperatorNode],
     ) -> None:
         """
-        Helper function to populate the stack_traces, module_hierarchy and op_types attributes
-        based on the debug handles of this event
+        Helper function to populate the stack_traces, module_hierarchy, op_types, flops and
+        bytes_accessed attributes based on the debug handles of this event
         """
 
         # Framework events aren't logically associated with any nodes
@@ -647,6 +715,7 @@ class Event:
         if isinstance(debug_handles, int):
             debug_handles = [debug_handles]
 
+        nodes = []
         for handle in debug_handles:
             node = debug_handle_to_op_node_map.get(handle)
             # Attach node metadata including stack traces, module hierarchy and op_types to this event
@@ -656,6 +725,14 @@ class Event:
                 if node.op:
                     # TODO: consider having this as a dict from node.name -> node.op
                     self.op_types += [node.op]
+                nodes.append(node)
+
+        # The totals are only meaningful if they are known for all the ops, e.g. not
+        # for a delegate call that also runs an op without a FLOP estimate
+        if len(nodes) > 0 and all(node.flops is not None for node in nodes):
+            self.flops = sum(node.flops for node in nodes)
+        if len(nodes) > 0 and all(node.bytes_accessed is not None for node in nodes):
+            self.bytes_accessed = sum(node.bytes_accessed for node in nodes)
 
 
 @dataclass
@@ -708,6 +785,14 @@ class EventBlock:
             allow_duplicates=True,
         )
 
+        # Add hardware counter columns if any event recorded them
+        if any(e.perf_counters is not None for e in self.events):
+            for column in ("ipc", "l1d_mpki", "llc_mpki", "branch_mpki"):
+                df[column] = [
+                    getattr(e.perf_counters, column) if e.perf_counters else None
+                    for e in self.events
+                ]
+
         # Add Delegate Debug Metadata columns
         if include_delegate_debug_data:
             delegate_data = []
@@ -1239,6 +1324,94 @@ class Inspector:
                         break
         return total
 
+    def to_roofline_dataframe(
+        self,
+        peak_gflops_per_second: Optional[float] = None,
+        peak_gbytes_per_second: Optional[float] = None,
+        include_delegated_ops: bool = False,
+    ) -> pd.DataFrame:
+        """
+        Places each event with FLOP or memory traffic estimates on a roofline: its
+        achieved GFLOP/s and GB/s, from its average latency, and its arithmetic
+        intensity. Requires an ETRecord, which the estimates are derived from.
+
+        Note: The estimates count each input and output tensor as accessed once and
+            only cover the FLOPs of mm, bmm, addmm, linear, convolution and
+            scaled_dot_product_attention.
+
+        Args:
+            peak_gflops_per_second: Peak compute throughput of the hardware. Together
+                with peak_gbytes_per_second, adds the columns "attainable_gflops_per_s",
+                the roofline at the arithmetic intensity of the event, and
+                "fraction_of_roofline", its achieved share of it (of the peak bandwidth
+                for events without a FLOP estimate).
+            peak_gbytes_per_second: Peak memory bandwidth of the hardware.
+            include_delegated_ops: Whether to include delegated events (default false)
+
+        Returns:
+            A pandas DataFrame with one row per event, excluding the events without
+            estimates or perf data.
+        """
+        rows = []
+        for block in self.event_blocks:
+            if block.target_time_scale == TimeScale.CYCLES:
+                raise ValueError(
+                    "The roofline needs latencies in time units, not cycles."
+                )
+            seconds_per_unit = 1 / TIME_SCALE_DICT[block.target_time_scale]
+            for event in block.events:
+                if (
+                    event.perf_data is None
+                    or (event.flops is None and event.bytes_accessed is None)
+                    or (event.is_delegated_op and not include_delegated_ops)
+                ):
+                    continue
+                seconds = event.perf_data.avg * seconds_per_unit
+                row = {
+                    "event_block_name": block.name,
+                    "event_name": event.name,
+                    "op_types": event.op_types,
+                    "is_delegated_op": event.is_delegated_op,
+                    "avg_seconds": seconds,
+                    "flops": event.flops,
+                    "bytes_accessed": event.bytes_accessed,
+                    "arithmetic_intensity": (
+                        event.flops / event.bytes_accessed
+                        if event.flops is not None and event.bytes_accessed
+                        else None
+                    ),
+                    "gflops_per_s": (
+                        event.flops / seconds / 1e9
+                        if event.flops is not None and seconds > 0
+                        else None
+                    ),
+                    "gbytes_per_s": (
+                        event.bytes_accessed / seconds / 1e9
+                        if event.bytes_accessed is not None and seconds > 0
+                        else None
+                    ),
+                }
+                if peak_gflops_per_second is not None and peak_gbytes_per_second:
+                    intensity = row["arithmetic_intensity"]
+                    attainable = (
+                        min(peak_gflops_per_second, intensity * peak_gbytes_per_second)
+                        if intensity is not None
+                        else None
+                    )
+                    row["attainable_gflops_per_s"] = attainable
+                    # Ops without a FLOP estimate are taken to be memory bound
+                    row["fraction_of_roofline"] = (
+                        row["gflops_per_s"] / attainable
+                        if attainable and row["gflops_per_s"] is not None
+                        else (
+                            row["gbytes_per_s"] / peak_gbytes_per_second
+                            if row["gbytes_per_s"] is not None
+                            else None
+                        )
+                    )
+                rows.append(row)
+        return pd.DataFrame(rows)
+
     def get_op_list(
         self, event_block: str, show_delegated_ops: Optional[bool] = True
     ) -> Dict[str, List[Event]]:
@@ -133,6 +133,22 @@ def _parse_tensor_value(
 
     torch_dtype, dtype_size = get_scalar_type_size(tensor.scalar_type)
 
+    if tensor.sample_stride != 1:
+        # Only statistics, or every sample_stride-th element, were logged.
+        # Return the logged elements as a 1-D tensor.
+        numel = math.prod(tensor.sizes)
+        num_samples = (
+            0
+            if tensor.sample_stride == 0
+            else math.ceil(numel / tensor.sample_stride)
+        )
+        if output_buffer is None or num_samples == 0:
+            return torch.zeros(num_samples, dtype=torch_dtype)
+        return torch.frombuffer(
+            output_buffer[tensor.offset : tensor.offset + num_samples * dtype_size],
+            dtype=torch_dtype,
+        )
+
     if output_buffer is None:
         # Empty buffer provided. Cannot deserialize tensors.
         return torch.zeros(tensor.sizes, dtype=torch_dtype)
@@ -12,7 +12,7 @@ import tempfile
 import unittest
 from contextlib import redirect_stdout
 
-from typing import Callable, List
+from typing import Callable, List, Optional
 
 from unittest.mock import patch
 
@@ -230,6 +230,99 @@ class TestInspector(unittest.TestCase):
         expected_ops = ["op_0", "op_1"]
         self.assertEqual(event_with_multiple_debug_handles.op_types, expected_ops)
 
+    def test_inspector_associate_with_op_graph_nodes_flops(self):
+        debug_handles = [222, 333]
+        event = Event(name="event", perf_data=PerfData(raw=[]), debug_handles=222)
+        node_0 = OperatorNode(
+            name="node_0",
+            metadata={"debug_handle": debug_handles[0]},
+            op="op_0",
+            flops=100,
+            bytes_accessed=40,
+        )
+        node_1 = OperatorNode(
+            name="node_1",
+            metadata={"debug_handle": debug_handles[1]},
+            op="op_1",
+            bytes_accessed=20,
+        )
+        event._associate_with_op_graph_nodes({222: node_0, 333: node_1})
+        self.assertEqual(event.flops, 100)
+        self.assertEqual(event.bytes_accessed, 40)
+
+        # The FLOPs of node_1 are unknown, so are the total ones
+        event = Event(
+            name="event", perf_data=PerfData(raw=[]), debug_handles=debug_handles
+        )
+        event._associate_with_op_graph_nodes({222: node_0, 333: node_1})
+        self.assertIsNone(event.flops)
+        self.assertEqual(event.bytes_accessed, 60)
+
+    def test_inspector_to_roofline_dataframe(self):
+        # Create a context manager to patch functions called by Inspector.__init__
+        with patch.object(
+            _inspector, "parse_etrecord", return_value=None
+        ), patch.object(
+            _inspector, "gen_etdump_object", return_value=None
+        ), patch.object(
+            EventBlock, "_gen_from_etdump"
+        ), patch.object(
+            _inspector, "gen_graphs_from_etrecord"
+        ):
+            inspector_instance = Inspector(
+                etdump_path=ETDUMP_PATH,
+                etrecord=ETRECORD_PATH,
+            )
+            inspector_instance.event_blocks = [
+                EventBlock(
+                    name=EVENT_BLOCK_NAME,
+                    target_time_scale=TimeScale.MS,
+                    events=[
+                        # 4 GFLOP/s and 1 GB/s
+                        Event(
+                            name="mm",
+                            perf_data=PerfData(raw=[1.0, 3.0]),
+                            flops=8_000_000,
+                            bytes_accessed=2_000_000,
+                            is_delegated_op=False,
+                        ),
+                        # 3 GB/s
+                        Event(
+                            name="add",
+                            perf_data=PerfData(raw=[1.0]),
+                            bytes_accessed=3_000_000,
+                            is_delegated_op=False,
+                        ),
+                        Event(
+                            name="delegate",
+                            perf_data=PerfData(raw=[1.0]),
+                            flops=1,
+                            is_delegated_op=True,
+                        ),
+                        Event(name="no_estimates", perf_data=PerfData(raw=[1.0])),
+                    ],
+                )
+            ]
+
+            df = inspector_instance.to_roofline_dataframe(
+                peak_gflops_per_second=10, peak_gbytes_per_second=2
+            )
+            self.assertEqual(list(df["event_name"]), ["mm", "add"])
+            mm, add = df.iloc[0], df.iloc[1]
+            self.assertAlmostEqual(mm["avg_seconds"], 0.002)
+            self.assertAlmostEqual(mm["arithmetic_intensity"], 4)
+            self.assertAlmostEqual(mm["gflops_per_s"], 4)
+            self.assertAlmostEqual(mm["gbytes_per_s"], 1)
+            # At an intensity of 4, the roofline is 8 GFLOP/s
+            self.assertAlmostEqual(mm["attainable_gflops_per_s"], 8)
+            self.assertAlmostEqual(mm["fraction_of_roofline"], 0.5)
+            self.assertAlmostEqual(add["gbytes_per_s"], 3)
+            self.assertAlmostEqual(add["fraction_of_roofline"], 1.5)
+
+            df = inspector_instance.to_roofline_dataframe(include_delegated_ops=True)
+            self.assertEqual(list(df["event_name"]), ["mm", "add", "delegate"])
+            self.assertNotIn("fraction_of_roofline", df.columns)
+
     def test_inspector_delegate_time_scale_converter(self):
         def time_scale_converter(event_name, time):
             return time / 10
@@ -273,6 +366,63 @@ class TestInspector(unittest.TestCase):
         # Value of the perf data after scaling is done. 200/10 - 100/10.
         self.assertEqual(event.perf_data.raw[0], 10)
 
+    def test_inspector_perf_counters(self):
+        event = Event(name="")
+        event_signature = ProfileEventSignature(name="test_event", instruction_id=0)
+
+        def make_instruction_event(
+            perf_counters: Optional[flatcc.PerfCounters],
+        ) -> InstructionEvent:
+            return InstructionEvent(
+                signature=InstructionEventSignature(0, 0),
+                profile_events=[
+                    ProfileEvent(
+                        name="test_event",
+                        chain_index=0,
+                        instruction_id=0,
+                        delegate_debug_id_int=None,
+                        delegate_debug_id_str=None,
+                        start_time=100,
+                        end_time=200,
+                        delegate_debug_metadata=None,
+                        perf_counters=perf_counters,
+                    )
+                ],
+            )
+
+        instruction_events = [
+            make_instruction_event(
+                flatcc.PerfCounters(
+                    cycles=1000,
+                    instructions=2000,
+                    l1d_cache_misses=20,
+                    llc_misses=-1,
+                    branch_misses=4,
+                )
+            ),
+            make_instruction_event(
+                flatcc.PerfCounters(
+                    cycles=3000,
+                    instructions=4000,
+                    l1d_cache_misses=40,
+                    llc_misses=-1,
+                    branch_misses=2,
+                )
+            ),
+            # Events logged without counters are left out.
+            make_instruction_event(None),
+        ]
+        Event._populate_profiling_related_fields(
+            event, event_signature, instruction_events, 1
+        )
+        self.assertEqual(len(event.perf_data.raw), 3)
+        self.assertEqual(len(event.perf_counters.raw), 2)
+        self.assertEqual(event.perf_counters.ipc, 1.5)
+        self.assertEqual(event.perf_counters.l1d_mpki, 10)
+        self.assertEqual(event.perf_counters.branch_mpki, 1)
+        # The LLC misses were not available.
+        self.assertIsNone(event.perf_counters.llc_mpki)
+
     def test_inspector_get_exported_program(self):
         # Create a context manager to patch functions called by Inspector.__init__
         with patch.object(
@@ -33,9 +33,11 @@ from executorch.devtools.inspector._inspector_utils import (
     EDGE_DIALECT_GRAPH_KEY,
     find_populated_event,
     gen_graphs_from_etrecord,
+    inflate_runtime_output,
     is_inference_output_equal,
     TimeScale,
 )
+from executorch.exir import to_edge
 
 
 class TestInspectorUtils(unittest.TestCase):
@@ -63,6 +65,42 @@ class TestInspectorUtils(unittest.TestCase):
             )
             self.assertTrue(isinstance(graphs[EDGE_DIALECT_GRAPH_KEY], FXOperatorGraph))
 
+    def test_gen_operator_graph_flop_estimates(self):
+        class Model(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv = torch.nn.Conv2d(3, 8, 3)
+                self.linear = torch.nn.Linear(6, 4)
+
+            def forward(self, x):
+                return self.linear(self.conv(x))
+
+        edge_program = to_edge(
+            torch.export.export(Model(), (torch.randn(1, 3, 8, 8),))
+        ).exported_program()
+        graph = FXOperatorGraph.gen_operator_graph(edge_program.graph_module)
+
+        def op_nodes(graph: OperatorGraph):
+            for element in graph.elements:
+                if isinstance(element, OperatorGraph):
+                    yield from op_nodes(element)
+                elif isinstance(element, OperatorNode):
+                    yield element
+
+        flops = {}
+        for node in op_nodes(graph):
+            self.assertIsNotNone(node.bytes_accessed)
+            if node.flops is not None:
+                flops[node.op] = node.flops
+
+        conv_flops = [v for op, v in flops.items() if "convolution" in op]
+        # 8x6x6 outputs per channel, 3x3x3 multiply-adds each, plus the bias
+        self.assertEqual(conv_flops, [2 * 288 * 27 + 288])
+        # Linear may be decomposed into addmm, with the same FLOPs: 48x4 outputs,
+        # 6 multiply-adds each, plus the bias
+        linear_flops = [v for op, v in flops.items() if "linear" in op or "addmm" in op]
+        self.assertEqual(linear_flops, [2 * 192 * 6 + 192])
+
     def test_create_debug_handle_to_op_node_mapping(self):
         graph, expected_mapping = gen_mock_operator_graph_with_expected_map()
         debug_handle_to_op_node_map = create_debug_handle_to_op_node_mapping(graph)
@@ -139,6 +177,37 @@ class TestInspectorUtils(unittest.TestCase):
         )
         self.assertEqual(find_populated_event(event), profile_event)
 
+    def test_inflate_runtime_output_sampled_tensor(self):
+        def tensor_value(sample_stride: int, offset: int) -> flatcc.Value:
+            return flatcc.Value(
+                val=flatcc.ValueType.TENSOR.value,
+                tensor=flatcc.Tensor(
+                    scalar_type=flatcc.ScalarType.FLOAT,
+                    sizes=[2, 5],
+                    strides=[5, 1],
+                    offset=offset,
+                    stats=flatcc.TensorStats(min=0, max=9, mean=4.5, nan_count=0),
+                    sample_stride=sample_stride,
+                ),
+                tensor_list=None,
+                int_value=None,
+                float_value=None,
+                double_value=None,
+                bool_value=None,
+                output=None,
+            )
+
+        # Every third of ten elements, after 8 bytes of other data.
+        buffer = bytes(8) + torch.tensor([0.0, 3.0, 6.0, 9.0]).numpy().tobytes()
+        self.assertTrue(
+            torch.equal(
+                inflate_runtime_output(tensor_value(3, 8), buffer),
+                torch.tensor([0.0, 3.0, 6.0, 9.0]),
+            )
+        )
+        # Only statistics were logged.
+        self.assertEqual(inflate_runtime_output(tensor_value(0, -1), buffer).numel(), 0)
+
     def test_is_inference_output_equal_returns_false_for_different_tensor_values(self):
         self.assertFalse(
             is_inference_output_equal(
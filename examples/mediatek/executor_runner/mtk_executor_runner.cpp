@@ -24,6 +24,7 @@
 
 #include <gflags/gflags.h>
 
+#include <executorch/backends/mediatek/runtime/include/NeuronPlannedMemory.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/evalue_util/print_evalue.h>
 #include <executorch/extension/runner_util/inputs.h>
@@ -132,23 +133,36 @@ int main(int argc, char** argv) {
   // mobile environments will only have a single buffer. Some embedded
   // environments may have more than one for, e.g., slow/large DRAM and
   // fast/small SRAM, or for memory associated with particular cores.
+  //
+  // The buffers are allocated from the Neuron buffer allocator, so that the
+  // inputs and outputs of the Neuron delegates are bound to them in place
+  // instead of being copied in and out at every execution.
+  auto neuron_planned_memory =
+      torch::executor::neuron::PlannedMemory::Create(*method_meta);
   std::vector<std::unique_ptr<uint8_t[]>> planned_buffers; // Owns the memory
   std::vector<Span<uint8_t>> planned_spans; // Passed to the allocator
-  size_t num_memory_planned_buffers = method_meta->num_memory_planned_buffers();
-  for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
-    // .get() will always succeed because id < num_memory_planned_buffers.
-    size_t buffer_size =
-        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
-    ET_LOG(Info, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
-    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
-    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+  if (neuron_planned_memory == nullptr) {
+    ET_LOG(Info, "Falling back to heap allocated planned buffers.");
+    size_t num_memory_planned_buffers =
+        method_meta->num_memory_planned_buffers();
+    for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
+      // .get() will always succeed because id < num_memory_planned_buffers.
+      size_t buffer_size = static_cast<size_t>(
+          method_meta->memory_planned_buffer_size(id).get());
+      ET_LOG(Info, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
+      planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+      planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+    }
   }
-  HierarchicalAllocator planned_memory(
+  HierarchicalAllocator heap_planned_memory(
       {planned_spans.data(), planned_spans.size()});
+  HierarchicalAllocator* planned_memory = neuron_planned_memory != nullptr
+      ? neuron_planned_memory->GetAllocator()
+      : &heap_planned_memory;
 
   // Assemble all of the allocators into the MemoryManager that the Executor
   // will use.
-  MemoryManager memory_manager(&method_allocator, &planned_memory);
+  MemoryManager memory_manager(&method_allocator, planned_memory);
 
   //
   // Load the method from the program, using the provided allocators. Running
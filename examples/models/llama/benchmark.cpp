@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Benchmarks a llama model with synthetic prompts, e.g.
+//
+//   llama_benchmark --model_path=llama.pte --tokenizer_path=tokenizer.model
+//       --prompt_lengths=128,512 --generation_lengths=128 --cpu_threads=4,8
+//
+// and reports the time to first token, the prefill and decode rates, the
+// per-token decode latency, the peak RSS and the KV cache size of each
+// combination, as JSON.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/examples/models/llama/runner/runner.h>
+#include <executorch/extension/llm/runner/llm_benchmark.h>
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#endif
+
+DEFINE_string(
+    model_path,
+    "llama2.pte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(tokenizer_path, "tokenizer.bin", "Tokenizer stuff.");
+
+DEFINE_double(
+    temperature,
+    0,
+    "Temperature; Default is 0, i.e. greedy argmax sampling, so that the runs are deterministic.");
+
+DEFINE_string(
+    prompt_lengths,
+    "128",
+    "Comma separated list of the numbers of words of the synthetic prompts.");
+
+DEFINE_string(
+    generation_lengths,
+    "128",
+    "Comma separated list of the numbers of tokens to generate after the prompt.");
+
+DEFINE_string(
+    cpu_threads,
+    "-1",
+    "Comma separated list of the numbers of CPU threads to benchmark with. -1 uses a heuristic to derive the # of performant cores for a specific device.");
+
+DEFINE_int32(
+    num_warmup_runs,
+    1,
+    "Number of runs of each combination before the measured ones.");
+
+DEFINE_int32(num_runs, 3, "Number of measured runs of each combination.");
+
+DEFINE_int64(
+    kv_cache_bytes_per_token,
+    0,
+    "Bytes of the KV cache per token, i.e. 2 * n_layers * n_kv_heads * head_dim * sizeof(dtype), to report the size of the KV cache the runs used. 0 if unknown.");
+
+DEFINE_string(
+    json_output_path,
+    "",
+    "If not empty, write the results to this path instead of stdout.");
+
+namespace {
+
+std::vector<int32_t> parse_list(const std::string& list) {
+  std::vector<int32_t> values;
+  size_t begin = 0;
+  while (begin <= list.size()) {
+    size_t end = list.find(',', begin);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    if (end > begin) {
+      values.push_back(
+          static_cast<int32_t>(std::stol(list.substr(begin, end - begin))));
+    }
+    begin = end + 1;
+  }
+  return values;
+}
+
+} // namespace
+
+int32_t main(int32_t argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  ::executorch::extension::llm::LlmBenchmarkConfig config;
+  config.prompt_lengths = parse_list(FLAGS_prompt_lengths);
+  config.generation_lengths = parse_list(FLAGS_generation_lengths);
+  config.thread_counts = parse_list(FLAGS_cpu_threads);
+  config.num_warmup_runs = FLAGS_num_warmup_runs;
+  config.num_runs = FLAGS_num_runs;
+  config.kv_cache_bytes_per_token = FLAGS_kv_cache_bytes_per_token;
+#if defined(ET_USE_THREADPOOL)
+  config.set_num_threads = [](int32_t cpu_threads) {
+    uint32_t num_performant_cores = cpu_threads == -1
+        ? ::executorch::extension::cpuinfo::get_num_performant_cores()
+        : static_cast<uint32_t>(cpu_threads);
+    ET_LOG(
+        Info,
+        "Resetting threadpool with num threads = %d",
+        num_performant_cores);
+    if (num_performant_cores > 0) {
+      ::executorch::extension::threadpool::get_threadpool()
+          ->_unsafe_reset_threadpool(num_performant_cores);
+    }
+  };
+#endif
+
+  // create llama runner
+  example::Runner runner(
+      FLAGS_model_path, FLAGS_tokenizer_path, FLAGS_temperature);
+
+  auto results =
+      ::executorch::extension::llm::run_llm_benchmark(runner, config);
+  if (!results.ok()) {
+    ET_LOG(Error, "Benchmark failed: 0x%" PRIx32, (uint32_t)results.error());
+    return 1;
+  }
+  const std::string json =
+      ::executorch::extension::llm::llm_benchmark_results_to_json(
+          results.get());
+
+  if (FLAGS_json_output_path.empty()) {
+    printf("%s\n", json.c_str());
+    return 0;
+  }
+  std::unique_ptr<FILE, decltype(&fclose)> file(
+      fopen(FLAGS_json_output_path.c_str(), "w"), fclose);
+  if (!file) {
+    ET_LOG(Error, "Failed to open %s", FLAGS_json_output_path.c_str());
+    return 1;
+  }
+  fprintf(file.get(), "%s\n", json.c_str());
+  return 0;
+}
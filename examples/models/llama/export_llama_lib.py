@@ -67,9 +67,15 @@ from .source_transformation.quantized_kv_cache import (
     replace_kv_cache_with_custom_kv_cache,
     replace_kv_cache_with_quantized_kv_cache,
 )
-from .source_transformation.rms_norm import replace_rms_norm_with_native_rms_norm
+from .source_transformation.rms_norm import (
+    replace_rms_norm_with_custom_op,
+    replace_rms_norm_with_native_rms_norm,
+)
 
-from .source_transformation.rope import materialze_broadcast_of_rope_freq_cis
+from .source_transformation.rope import (
+    materialze_broadcast_of_rope_freq_cis,
+    replace_rope_with_custom_op,
+)
 from .source_transformation.sdpa import (
     replace_causal_mask,
     replace_kv_cache_with_coreml_kv_cache,
@@ -79,6 +85,7 @@ from .source_transformation.sdpa import (
     replace_sdpa_with_flex_sdpa,
     replace_sdpa_with_simple_sdpa,
 )
+from .source_transformation.silu_mul import replace_feed_forward_with_custom_op
 from .source_transformation.vulkan_rope import replace_with_vulkan_rotary_emb
 
 IS_FBCODE = True  #  os.environ.get("FBCODE_PLATFORM", False)
@@ -271,6 +278,24 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_true",
         help="Whether to use sdpa_with_kv_cache update op when using kv cache",
     )
+    parser.add_argument(
+        "--use_custom_rms_norm",
+        default=False,
+        action="store_true",
+        help="Replace RMSNorm with the fused llama::rms_norm custom op",
+    )
+    parser.add_argument(
+        "--use_custom_rope",
+        default=False,
+        action="store_true",
+        help="Replace rotary embeddings with the fused llama::apply_rotary_emb custom op",
+    )
+    parser.add_argument(
+        "--use_custom_silu_mul",
+        default=False,
+        action="store_true",
+        help="Fuse the silu gating of feed forward layers into llama::silu_mul",
+    )
     parser.add_argument(
         "--disable_dynamic_shape",
         dest="enable_dynamic_shape",
@@ -430,6 +455,14 @@ def build_args_parser() -> argparse.ArgumentParser:
         help="Generate logits for all inputs.",
     )
 
+    parser.add_argument(
+        "--output_argmax",
+        action="store_true",
+        required=False,
+        default=False,
+        help="Return the id of the most likely next token instead of the logits, for greedy decoding. Saves copying the logits out of the model.",
+    )
+
     parser.add_argument(
         "--soc_model",
         help="[QNN backend] SoC model of current device. e.g. 'SM8650' for Snapdragon 8 Gen 3.",
@@ -606,6 +639,7 @@ def _prepare_for_llama_export(args) -> LLMEdgeManager:
         use_kv_cache=args.use_kv_cache,
         use_sdpa_with_kv_cache=args.use_sdpa_with_kv_cache,
         generate_full_logits=args.generate_full_logits,
+        output_argmax=args.output_argmax,
         weight_type=weight_type,
         enable_dynamic_shape=args.enable_dynamic_shape,
         calibration_tasks=args.calibration_tasks,
@@ -1024,6 +1058,7 @@ def _load_llama_model(
     use_kv_cache: bool = False,
     use_sdpa_with_kv_cache: bool = False,
     generate_full_logits: bool = False,
+    output_argmax: bool = False,
     weight_type: WeightType = WeightType.LLAMA,
     enable_dynamic_shape: bool = False,
     calibration_tasks: Optional[List[str]] = None,
@@ -1071,6 +1106,7 @@ def _load_llama_model(
             use_kv_cache=use_kv_cache,
             use_sdpa_with_kv_cache=use_sdpa_with_kv_cache,
             generate_full_logits=generate_full_logits,
+            output_argmax=output_argmax,
             fairseq2=weight_type == WeightType.FAIRSEQ2,
             max_seq_len=max_seq_len,
             max_context_len=max_context_len,
@@ -1209,6 +1245,15 @@ def _get_source_transforms(  # noqa
         transforms.append(replace_kv_cache_with_custom_kv_cache)
         transforms.append(replace_sdpa_with_custom_op)
 
+    if args.use_custom_rms_norm:
+        transforms.append(replace_rms_norm_with_custom_op)
+
+    if args.use_custom_rope:
+        transforms.append(replace_rope_with_custom_op)
+
+    if args.use_custom_silu_mul:
+        transforms.append(replace_feed_forward_with_custom_op)
+
     if args.quantize_kv_cache:
         assert args.use_kv_cache, "quantize_kv_cache requires use_kv_cache=True"
         transforms.append(replace_kv_cache_with_quantized_kv_cache)
@@ -142,6 +142,7 @@ class Transformer(nn.Module):
         )
         self.use_kv_cache = params.use_kv_cache
         self.generate_full_logits = params.generate_full_logits
+        self.output_argmax = params.output_argmax
         self.max_seq_len = params.max_seq_len
         self.max_context_len = params.max_context_len
         self.input_prune_map = params.input_prune_map
@@ -205,6 +206,10 @@ class Transformer(nn.Module):
                     )
                     expanded_logits[:, list(self.output_prune_map.values())] = logits
                 logits = expanded_logits
+
+            if self.output_argmax:
+                # (1, [seq_len,] vocab_size) -> (1, [seq_len])
+                logits = torch.argmax(logits, dim=-1)
         else:
             logits = h
 
@@ -6,6 +6,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <fstream>
+
 #include <gflags/gflags.h>
 
 #include <executorch/examples/models/llama/runner/runner.h>
@@ -41,6 +43,16 @@ DEFINE_int32(
 
 DEFINE_bool(warmup, false, "Whether to run a warmup run.");
 
+DEFINE_int32(
+    num_lookup_tokens,
+    0,
+    "Number of tokens to propose per step by looking up the prompt and the generated text. The proposals are verified in one step, which needs a model exported with a KV cache, dynamic shapes and full logits. Defaults to 0, which disables the lookup.");
+
+DEFINE_string(
+    session_path,
+    "",
+    "File to resume the conversation from, and to save it to after generating, so that the next run does not prefill the part of its prompt that was already seen. Needs a model exported with a KV cache. Defaults to no session.");
+
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -61,6 +73,8 @@ int32_t main(int32_t argc, char** argv) {
 
   bool warmup = FLAGS_warmup;
 
+  int32_t num_lookup_tokens = FLAGS_num_lookup_tokens;
+
 #if defined(ET_USE_THREADPOOL)
   uint32_t num_performant_cores = cpu_threads == -1
       ? ::executorch::extension::cpuinfo::get_num_performant_cores()
@@ -73,13 +87,23 @@ int32_t main(int32_t argc, char** argv) {
   }
 #endif
   // create llama runner
-  example::Runner runner(model_path, tokenizer_path, temperature);
+  example::Runner runner(
+      model_path, tokenizer_path, temperature, std::nullopt, num_lookup_tokens);
 
   if (warmup) {
     runner.warmup(prompt, seq_len);
   }
+  const std::string& session_path = FLAGS_session_path;
+  if (!session_path.empty() && std::ifstream(session_path).good() &&
+      runner.load_session(session_path) != ::executorch::runtime::Error::Ok) {
+    ET_LOG(Info, "Ignoring session %s", session_path.c_str());
+  }
   // generate
   runner.generate(prompt, seq_len);
+  if (!session_path.empty() &&
+      runner.save_session(session_path) != ::executorch::runtime::Error::Ok) {
+    ET_LOG(Error, "Failed to save session %s", session_path.c_str());
+  }
 
   return 0;
 }
@@ -30,6 +30,10 @@ class ModelArgs:
     # at runtime. Enable it only necessary (e.g., use perplexity tools that requires
     # logits for all input tokens.)
     generate_full_logits: bool = False
+    # Return the id of the most likely token (greedy decoding) instead of the
+    # logits, so that only token ids leave the model instead of vocab-sized
+    # logits for every token.
+    output_argmax: bool = False
     enable_dynamic_shape: bool = False  # export model with dynamic shape support
     # A dictionary mapping from pruned token-id to original token-id
     input_prune_map: Optional[Dict[int, int]] = None
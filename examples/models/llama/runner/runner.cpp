@@ -11,8 +11,10 @@
 
 #include <executorch/examples/models/llama/runner/runner.h>
 
+#include <algorithm>
 #include <ctime>
 
+#include <executorch/extension/llm/runner/kv_cache_session.h>
 #include <executorch/extension/llm/runner/util.h>
 
 #include <executorch/examples/models/llama/tokenizer/llama_tiktoken.h>
@@ -35,17 +37,26 @@ static constexpr auto kMaxContextLen = "get_max_context_len";
 static constexpr auto kVocabSize = "get_vocab_size";
 static constexpr auto kUseKVCache = "use_kv_cache";
 static constexpr auto kUseSDPAWithKVCache = "use_sdpa_with_kv_cache";
+// Whether the KV cache is a ring buffer (see llama::sdpa_with_ring_kv_cache),
+// which keeps the attention sinks and a recent window, so generation can run
+// past max_context_len.
+static constexpr auto kUseRingKVCache = "use_ring_kv_cache";
+
+// Longest suffix of the context to look up when proposing tokens.
+static constexpr int32_t kLookupMaxNgramSize = 3;
 } // namespace
 
 Runner::Runner(
     const std::string& model_path,
     const std::string& tokenizer_path,
     const float temperature,
-    std::optional<const std::string> data_path)
+    std::optional<const std::string> data_path,
+    int32_t num_lookup_tokens)
     // NOTE: we observed ~2x loading performance increase on iPhone 15
     // and a ~5% improvement on Galaxy S22 by switching to
     // FileDataLoader instead of MmapDataLoader + UseMlockIgnoreErrors.
     : temperature_(temperature),
+      num_lookup_tokens_(num_lookup_tokens),
       tokenizer_path_(tokenizer_path),
       metadata_({
           {kEnableDynamicShape, false},
@@ -53,6 +64,7 @@ Runner::Runner(
           {kMaxContextLen, 128},
           {kUseKVCache, true},
           {kUseSDPAWithKVCache, false},
+          {kUseRingKVCache, false},
       }) {
   if (data_path.has_value()) {
     module_ = std::make_unique<Module>(
@@ -137,17 +149,41 @@ Error Runner::load() {
       metadata_.at(kUseKVCache),
       metadata_.at(kVocabSize),
       temperature_);
+  // The exported prefill seq dim is bounded by max_seq_len - 1, so longer
+  // prompts are prefilled in chunks.
   text_prefiller_ = std::make_unique<llm::TextPrefiller>(
       text_decoder_runner_.get(),
       metadata_.at(kUseKVCache),
-      metadata_.at(kEnableDynamicShape));
-
+      metadata_.at(kEnableDynamicShape),
+      metadata_.at(kMaxSeqLen) - 1);
+
+  // Verifying the proposals takes a multi-token step through the KV cache.
+  // The model must also have been exported with full logits, which is checked
+  // at the first step.
+  lookup_token_generator_.reset();
+  if (num_lookup_tokens_ > 0) {
+    if (metadata_.at(kUseKVCache) && metadata_.at(kEnableDynamicShape)) {
+      lookup_token_generator_ =
+          std::make_unique<llm::SpeculativeTokenGenerator>(
+              tokenizer_.get(),
+              text_decoder_runner_.get(),
+              num_lookup_tokens_,
+              kLookupMaxNgramSize,
+              std::make_unique<std::unordered_set<uint64_t>>(*eos_ids),
+              &stats_);
+    } else {
+      ET_LOG(
+          Info,
+          "Lookup decoding needs a KV cache and dynamic shapes, ignoring num_lookup_tokens");
+    }
+  }
   text_token_generator_ = std::make_unique<llm::TextTokenGenerator>(
       tokenizer_.get(),
       text_decoder_runner_.get(),
       metadata_.at(kUseKVCache),
       std::move(eos_ids),
       &stats_);
+  cached_tokens_.clear();
 
   return Error::Ok;
 }
@@ -202,8 +238,12 @@ Error Runner::generate(
   stats_.inference_start_ms = llm::time_in_ms();
   shouldStop_ = false;
 
-  // Set the sequence length to the max seq length if not provided
-  seq_len = (seq_len > 0 && seq_len <= metadata_.at(kMaxContextLen))
+  // Set the sequence length to the max seq length if not provided. A ring
+  // buffer KV cache evicts old positions instead of running out of them.
+  const bool use_ring_kv_cache =
+      metadata_.at(kUseKVCache) && metadata_.at(kUseRingKVCache);
+  seq_len = (seq_len > 0 &&
+             (use_ring_kv_cache || seq_len <= metadata_.at(kMaxContextLen)))
       ? seq_len
       : metadata_.at(kMaxContextLen);
 
@@ -220,8 +260,11 @@ Error Runner::generate(
   int num_prompt_tokens = prompt_tokens.size();
 
   ET_CHECK_MSG(num_prompt_tokens >= 1, "Expected at least 1 prompt token");
+  // With a KV cache the prompt is prefilled in chunks, so only the context
+  // length bounds it.
   ET_CHECK_MSG(
-      num_prompt_tokens < metadata_.at(kMaxSeqLen),
+      metadata_.at(kUseKVCache) ||
+          num_prompt_tokens < metadata_.at(kMaxSeqLen),
       "num_prompt_tokens %d >= max_seq_len_ %" PRId64
       ", Max seq length exceeded - please increase max seq len value in .../llama2/model.py",
       num_prompt_tokens,
@@ -240,8 +283,33 @@ Error Runner::generate(
   if (echo) {
     wrapped_callback(prompt);
   }
+  // Resume prefill at the first prompt token that isn't in the KV cache
+  // already. At least one token is always prefilled, for its logits.
   int64_t pos = 0;
-  auto prefill_res = text_prefiller_->prefill(prompt_tokens, pos);
+  if (use_ring_kv_cache &&
+      static_cast<int64_t>(cached_tokens_.size()) >
+          metadata_.at(kMaxContextLen)) {
+    // The cache has wrapped around, so it no longer holds every position of
+    // the cached prefix.
+    cached_tokens_.clear();
+  }
+  if (metadata_.at(kUseKVCache)) {
+    const auto max_reused = std::min<size_t>(
+        cached_tokens_.size(), num_prompt_tokens - 1);
+    pos = std::mismatch(
+              cached_tokens_.begin(),
+              cached_tokens_.begin() + max_reused,
+              prompt_tokens.begin())
+              .first -
+        cached_tokens_.begin();
+    RUNNER_ET_LOG(
+        warmup, "Reusing the KV cache of %" PRId64 " prompt tokens", pos);
+  }
+  // Whatever is in the KV cache past pos is about to be overwritten.
+  cached_tokens_.clear();
+  std::vector<uint64_t> new_prompt_tokens(
+      prompt_tokens.begin() + pos, prompt_tokens.end());
+  auto prefill_res = text_prefiller_->prefill(new_prompt_tokens, pos);
   stats_.first_token_ms = llm::time_in_ms();
   stats_.prompt_eval_end_ms = llm::time_in_ms();
   ET_CHECK_OK_OR_RETURN_ERROR(prefill_res.error());
@@ -257,8 +325,27 @@ Error Runner::generate(
 
   // start the main loop
   prompt_tokens.push_back(cur_token);
-  int64_t num_generated_tokens = ET_UNWRAP(text_token_generator_->generate(
-      prompt_tokens, num_prompt_tokens, seq_len, wrapped_callback));
+  std::vector<uint64_t> generated_tokens;
+  int64_t num_generated_tokens = ET_UNWRAP(
+      lookup_token_generator_ ? lookup_token_generator_->generate(
+                                    prompt_tokens,
+                                    num_prompt_tokens,
+                                    seq_len,
+                                    wrapped_callback,
+                                    &generated_tokens)
+                              : text_token_generator_->generate(
+                                    prompt_tokens,
+                                    num_prompt_tokens,
+                                    seq_len,
+                                    wrapped_callback,
+                                    &generated_tokens));
+  if (metadata_.at(kUseKVCache)) {
+    // Every token but the last generated one went through the model.
+    cached_tokens_ = std::move(prompt_tokens);
+    cached_tokens_.insert(
+        cached_tokens_.end(), generated_tokens.begin(), generated_tokens.end());
+    cached_tokens_.resize(num_prompt_tokens + num_generated_tokens);
+  }
 
   stats_.inference_end_ms = llm::time_in_ms();
   if (!warmup) {
@@ -301,9 +388,58 @@ Error Runner::warmup(const std::string& prompt, int32_t seq_len) {
   return err;
 }
 
+Error Runner::save_session(const std::string& path) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_loaded() && metadata_.at(kUseKVCache),
+      InvalidState,
+      "Only a loaded model with a KV cache has a session to save");
+  const auto buffers = ET_UNWRAP(module_->mutable_buffers("forward"));
+  ET_CHECK_OR_RETURN_ERROR(
+      !buffers.empty(),
+      NotSupported,
+      "The model was not exported with the names of its KV cache buffers");
+  return llm::KVCacheSession::save(path, buffers, cached_tokens_);
+}
+
+Error Runner::load_session(const std::string& path) {
+  if (!is_loaded()) {
+    stats_.model_load_start_ms = llm::time_in_ms();
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+    stats_.model_load_end_ms = llm::time_in_ms();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      metadata_.at(kUseKVCache),
+      NotSupported,
+      "Sessions need a model with a KV cache");
+  const auto buffers = ET_UNWRAP(module_->mutable_buffers("forward"));
+  // Whatever the cache held is gone, even if loading fails midway.
+  cached_tokens_.clear();
+  auto tokens = ET_UNWRAP(llm::KVCacheSession::load(path, buffers));
+  ET_CHECK_OR_RETURN_ERROR(
+      metadata_.at(kUseRingKVCache) ||
+          static_cast<int64_t>(tokens.size()) <= metadata_.at(kMaxContextLen),
+      InvalidArgument,
+      "Session has %zu tokens, more than max_context_len %" PRId64,
+      tokens.size(),
+      metadata_.at(kMaxContextLen));
+  for (const auto token : tokens) {
+    ET_CHECK_OR_RETURN_ERROR(
+        static_cast<int64_t>(token) < metadata_.at(kVocabSize),
+        InvalidArgument,
+        "Session token %" PRIu64 " is not in the vocabulary",
+        token);
+  }
+  cached_tokens_ = std::move(tokens);
+  ET_LOG(Info, "Restored a session of %zu tokens", cached_tokens_.size());
+  return Error::Ok;
+}
+
 void Runner::stop() {
   if (is_loaded()) {
     text_token_generator_->stop();
+    if (lookup_token_generator_) {
+      lookup_token_generator_->stop();
+    }
   } else {
     ET_LOG(Error, "Token generator is not loaded, cannot stop");
   }
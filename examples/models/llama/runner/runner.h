@@ -17,8 +17,10 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -34,7 +36,8 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
       const std::string& model_path,
       const std::string& tokenizer_path,
       const float temperature = 0.8f,
-      std::optional<const std::string> data_path = std::nullopt);
+      std::optional<const std::string> data_path = std::nullopt,
+      int32_t num_lookup_tokens = 0);
 
   bool is_loaded() const;
   ::executorch::runtime::Error load();
@@ -49,10 +52,19 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
   ::executorch::runtime::Error warmup(
       const std::string& prompt,
       int32_t seq_len = 128);
+  // Saves the KV cache and the tokens it holds, so that load_session() can
+  // resume the conversation, e.g. after the app restarts, without
+  // prefilling it again. The next generate() reuses the cache for the prompt
+  // tokens that match the saved ones.
+  ::executorch::runtime::Error save_session(const std::string& path);
+  ::executorch::runtime::Error load_session(const std::string& path);
   void stop();
 
  private:
   float temperature_;
+  // If positive, up to this many tokens are proposed per step by looking up
+  // the context, and verified in one step of the model.
+  int32_t num_lookup_tokens_;
   bool shouldStop_{false};
 
   // model
@@ -65,6 +77,15 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
   std::unique_ptr<::executorch::extension::llm::TextPrefiller> text_prefiller_;
   std::unique_ptr<::executorch::extension::llm::TextTokenGenerator>
       text_token_generator_;
+  // Only set if num_lookup_tokens_ is positive and the model supports it.
+  std::unique_ptr<::executorch::extension::llm::SpeculativeTokenGenerator>
+      lookup_token_generator_;
+
+  // The tokens whose keys and values are in the model's KV cache, at
+  // positions [0, size()). generate() only prefills the prompt from the
+  // first token that differs, so e.g. a chat history that is sent again
+  // with every turn is only prefilled once.
+  std::vector<uint64_t> cached_tokens_;
 
   // stats
   ::executorch::extension::llm::Stats stats_;
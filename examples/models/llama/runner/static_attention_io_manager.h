@@ -11,173 +11,13 @@
 #include <unordered_map>
 #include <vector>
 
+#include <executorch/extension/llm/runner/static_kv_cache.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/executor/method.h>
 
 namespace example {
 
-template <typename T, typename AllocatorT = std::allocator<T>>
-class StaticKVCache {
- public:
-  /**
-   * Helper class to handle KV cache I/O. Assumes batch size 1, same context
-   * length and head dimension for each cache. Supports hybrid operation mixing
-   * prefill and decode. Create one instance for key caches and another one for
-   * value caches.
-   */
-  StaticKVCache(
-      size_t n_caches,
-      size_t cache_len,
-      size_t head_dim,
-      size_t max_input_len = 1,
-      bool transpose = false)
-      : n_caches_(n_caches),
-        cache_len_(cache_len),
-        max_input_len_(max_input_len),
-        head_dim_(head_dim),
-        transpose_(transpose) {
-    // Updates are appeneded at the end. Need one extra segment to support the
-    // sliding window.
-    data_size_ = (n_caches_ + 1) * cache_len_ * head_dim_ + max_input_len_;
-    data_ = allocator_.allocate(data_size_);
-    ET_CHECK(data_ != nullptr);
-    reset();
-  }
-
-  StaticKVCache(const StaticKVCache& other) = delete;
-  StaticKVCache& operator=(const StaticKVCache& other) = delete;
-  StaticKVCache(StaticKVCache&& other) = delete;
-  StaticKVCache& operator=(StaticKVCache&& other) = delete;
-
-  ~StaticKVCache() {
-    allocator_.deallocate(data_, data_size_);
-  }
-
-  /**
-   * Set up data pointers for the KV cache related inputs and outputs based on
-   * the current state of the cache. Call StaticKVCache<T>::update or
-   * StaticKVCache<T>::reset first as needed before calling this function.
-   */
-  void prepare(
-      torch::executor::Method& method,
-      const std::vector<size_t>& inputIndices,
-      const std::vector<size_t>& outputIndices) {
-    ET_CHECK(inputIndices.size() == outputIndices.size());
-    auto methodMeta = method.method_meta();
-    for (size_t i = 0; i < n_caches_; i++) {
-      auto inIdx = inputIndices[i];
-      auto outIdx = outputIndices[i];
-      auto inMeta = methodMeta.input_tensor_meta(inIdx);
-      auto outMeta = methodMeta.output_tensor_meta(outIdx);
-      ET_CHECK(inMeta.ok());
-      ET_CHECK(outMeta.ok());
-
-      auto inSizes = inMeta->sizes();
-      auto outSizes = outMeta->sizes();
-      ET_CHECK_MSG(inSizes[0] == 1, "Only support batch size 1.");
-      ET_CHECK_MSG(outSizes[0] == 1, "Only support batch size 1.");
-      if (transpose_) {
-        ET_CHECK_MSG(inSizes[1] == head_dim_, "KV head dim mismatch.");
-        ET_CHECK_MSG(outSizes[1] == head_dim_, "KV head dim mismatch.");
-        ET_CHECK_MSG(inSizes[2] == cache_len_, "Cache length dim mismatch.");
-      } else {
-        ET_CHECK_MSG(inSizes[2] == head_dim_, "KV head dim mismatch.");
-        ET_CHECK_MSG(outSizes[2] == head_dim_, "KV head dim mismatch.");
-        ET_CHECK_MSG(inSizes[1] == cache_len_, "Cache length dim mismatch.");
-      }
-
-      auto impl = ::executorch::runtime::etensor::TensorImpl(
-          inMeta->scalar_type(),
-          inMeta->sizes().size(),
-          const_cast<torch::executor::TensorImpl::SizesType*>(
-              inMeta->sizes().data()),
-          input_ptrs_[i],
-          const_cast<torch::executor::TensorImpl::DimOrderType*>(
-              inMeta->dim_order().data()));
-      torch::executor::Tensor t(&impl);
-      ET_CHECK(method.set_input(t, inIdx) == torch::executor::Error::Ok);
-      ET_CHECK(
-          method.set_output_data_ptr(
-              output_ptrs_[i], outMeta->nbytes(), outIdx) ==
-          torch::executor::Error::Ok);
-    }
-  }
-
-  /**
-   * Update the internal data pointers using the cache updates returned by the
-   * model. This length of each individual update cannot exceed the max update
-   * length specified during the creation, and the total length cannot exceed
-   * the context length.
-   */
-  void update(
-      torch::executor::Method& method,
-      const std::vector<size_t>& outputIndices,
-      size_t update_len) {
-    if (valid_len_ + update_len > cache_len_) {
-      throw std::runtime_error("Cache capacity exceeded.");
-    }
-
-    if (transpose_) {
-      throw std::runtime_error("Not implemented.");
-    } else {
-      updateSeqDim(method, outputIndices, update_len);
-    }
-    valid_len_ += update_len;
-  }
-
-  /**
-   * Reset the cache. After this the cache contains no valid data and is ready
-   * for number of tokens up to the context length.
-   */
-  void reset() {
-    valid_len_ = 0;
-    if (transpose_) {
-      throw std::runtime_error("Not implemented.");
-    } else {
-      initSeqDim();
-    }
-  }
-
- private:
-  void initSeqDim() {
-    auto cacheSize = cache_len_ * head_dim_;
-    input_ptrs_.resize(n_caches_);
-    output_ptrs_.resize(n_caches_);
-    for (size_t i = 0; i < n_caches_; i++) {
-      input_ptrs_[i] = data_ + i * cacheSize;
-      output_ptrs_[i] = input_ptrs_[i] + cacheSize;
-    }
-  }
-
-  void updateSeqDim(
-      torch::executor::Method& method,
-      const std::vector<size_t>& outputIndices,
-      size_t update_len) {
-    ET_CHECK(n_caches_ == outputIndices.size());
-    for (size_t i = 0; i < n_caches_; i++) {
-      const auto& updateTensor = method.get_output(outputIndices[i]).toTensor();
-      ET_CHECK(
-          input_ptrs_[i] + cache_len_ * head_dim_ ==
-          updateTensor.mutable_data_ptr<T>());
-
-      input_ptrs_[i] += update_len * head_dim_;
-      output_ptrs_[i] += update_len * head_dim_;
-    }
-  }
-
-  // std::vector<T> pool_;
-  size_t n_caches_;
-  size_t cache_len_;
-  size_t max_input_len_;
-  size_t head_dim_;
-  bool transpose_;
-  AllocatorT allocator_;
-  size_t data_size_;
-  T* data_;
-  std::vector<T*> input_ptrs_;
-  std::vector<T*> output_ptrs_;
-  size_t valid_len_ = 0;
-};
+using ::executorch::extension::llm::StaticKVCache;
 
 template <typename T, typename AllocatorT = std::allocator<T>>
 class StaticAttentionMask {
@@ -309,14 +149,16 @@ class StaticAttentionIOManager {
     return attentionMasks_.at(input_len);
   }
 
-  void prepare(
+  executorch::runtime::Error prepare(
       torch::executor::Method& method,
       const std::vector<size_t>& k_cache_input_indices,
       const std::vector<size_t>& k_cache_output_indices,
       const std::vector<size_t>& v_cache_input_indices,
       const std::vector<size_t>& v_cache_output_indices) {
-    kCaches_.prepare(method, k_cache_input_indices, k_cache_output_indices);
-    vCaches_.prepare(method, v_cache_input_indices, v_cache_output_indices);
+    ET_CHECK_OK_OR_RETURN_ERROR(kCaches_.prepare(
+        method, k_cache_input_indices, k_cache_output_indices));
+    ET_CHECK_OK_OR_RETURN_ERROR(vCaches_.prepare(
+        method, v_cache_input_indices, v_cache_output_indices));
     set_input(
         method,
         rope_freqs_cos_index_,
@@ -325,19 +167,23 @@ class StaticAttentionIOManager {
         method,
         rope_freqs_sin_index_,
         rope_freqs_sin_ + input_pos_ * head_dim_ / 2);
+    return executorch::runtime::Error::Ok;
   }
 
-  void update(
+  executorch::runtime::Error update(
       torch::executor::Method& method,
       const std::vector<size_t>& k_cache_output_indices,
       const std::vector<size_t>& v_cache_output_indices,
       size_t update_len) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        kCaches_.update(method, k_cache_output_indices, update_len));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        vCaches_.update(method, v_cache_output_indices, update_len));
     input_pos_ += update_len;
-    kCaches_.update(method, k_cache_output_indices, update_len);
-    vCaches_.update(method, v_cache_output_indices, update_len);
     for (auto& it : attentionMasks_) {
       it.second.updateCacheMask(update_len);
     }
+    return executorch::runtime::Error::Ok;
   }
 
   void reset() {
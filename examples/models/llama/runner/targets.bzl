@@ -37,6 +37,8 @@ def define_common_targets():
             exported_deps = [
                 "//executorch/backends/xnnpack:xnnpack_backend",
                 "//executorch/extension/llm/runner:irunner",
+                "//executorch/extension/llm/runner:kv_cache_session" + aten_suffix,
+                "//executorch/extension/llm/runner:speculative_token_generator" + aten_suffix,
                 "//executorch/extension/llm/runner:stats",
                 "//executorch/extension/llm/runner:text_decoder_runner" + aten_suffix,
                 "//executorch/extension/llm/runner:text_prefiller" + aten_suffix,
@@ -68,6 +70,7 @@ def define_common_targets():
             "@EXECUTORCH_CLIENTS",
         ],
         exported_deps = [
+            "//executorch/extension/llm/runner:static_kv_cache",
             "//executorch/runtime/executor:program",
         ]
     )
@@ -9,7 +9,7 @@
 # Helper functions for tranforming the model to be able to load checkpoints with
 # LoRA adaptors. See https://arxiv.org/abs/2106.09685 for more details about LoRA.
 
-from typing import Any
+from typing import Any, Dict, List, Optional
 
 import torch
 from torch import nn
@@ -151,3 +151,128 @@ def transform_linear_for_lora_after_quantization(
         lora_rank,
     )
     return module
+
+
+class _AdaptorSelection:
+    """The adaptor of each row of the batch, shared by the layers of a model."""
+
+    def __init__(self) -> None:
+        self.adaptor_ids: Optional[torch.Tensor] = None
+
+
+class MultiLoRALinear(nn.Module):
+    """
+    A linear layer with a bank of LoRA adaptors, of which every row of the
+    batch uses its own, or none, so that the sequences of different adaptors
+    are decoded in one batch. The deltas come from llama::lora_bgmv.
+    """
+
+    def __init__(
+        self,
+        base: nn.Module,
+        lora_a: torch.Tensor,
+        lora_b: torch.Tensor,
+        scale: float,
+        selection: _AdaptorSelection,
+    ) -> None:
+        super().__init__()
+        self.base = base
+        # [num adaptors, rank, in features] and [num adaptors, out features, rank].
+        self.register_buffer("lora_a", lora_a)
+        self.register_buffer("lora_b", lora_b)
+        self.scale = scale
+        self._selection = selection
+
+    def forward(self, input: torch.Tensor) -> torch.Tensor:
+        adaptor_ids = self._selection.adaptor_ids
+        assert adaptor_ids is not None, "Call the model through MultiLoRAModel"
+        out = self.base(input)
+        delta = torch.ops.llama.lora_bgmv(
+            input.to(self.lora_a.dtype),
+            self.lora_a,
+            self.lora_b,
+            adaptor_ids,
+            self.scale,
+        )
+        return out + delta.to(out.dtype)
+
+
+class MultiLoRAModel(nn.Module):
+    """
+    Takes the id of the adaptor of every row of the batch, a [batch size] long
+    tensor with -1 for no adaptor, after the inputs of the wrapped model.
+    """
+
+    def __init__(self, model: nn.Module, selection: _AdaptorSelection) -> None:
+        super().__init__()
+        self.model = model
+        self._selection = selection
+
+    def forward(self, *args: Any) -> Any:
+        *inputs, adaptor_ids = args
+        self._selection.adaptor_ids = adaptor_ids
+        try:
+            return self.model(*inputs)
+        finally:
+            self._selection.adaptor_ids = None
+
+
+def _replace_linear_for_multi_lora(
+    module: nn.Module,
+    checkpoints: List[Dict[str, torch.Tensor]],
+    lora_rank: int,
+    lora_scale: float,
+    selection: _AdaptorSelection,
+    prefix: str = "",
+) -> None:
+    for name, child in module.named_children():
+        fqn = f"{prefix}{name}"
+        adaptor_A_key = f"{fqn}.adaptor.A.weight"
+        adaptor_B_key = f"{fqn}.adaptor.B.weight"
+        if (
+            hasattr(child, "in_features")
+            and hasattr(child, "out_features")
+            and all(
+                adaptor_A_key in checkpoint and adaptor_B_key in checkpoint
+                for checkpoint in checkpoints
+            )
+        ):
+            lora_a = torch.stack([c[adaptor_A_key] for c in checkpoints])
+            lora_b = torch.stack([c[adaptor_B_key] for c in checkpoints])
+            assert lora_a.shape[1:] == (lora_rank, child.in_features)
+            assert lora_b.shape[1:] == (child.out_features, lora_rank)
+            setattr(
+                module,
+                name,
+                MultiLoRALinear(child, lora_a, lora_b, lora_scale, selection),
+            )
+        else:
+            _replace_linear_for_multi_lora(
+                child, checkpoints, lora_rank, lora_scale, selection, f"{fqn}."
+            )
+
+
+def transform_linear_for_multi_lora(
+    module: nn.Module,
+    checkpoints: List[Dict[str, torch.Tensor]],
+    lora_rank: int,
+    lora_scale: float = 2.0,
+) -> MultiLoRAModel:
+    """
+    Adds the LoRA adaptors of several checkpoints to the model at once, as
+    banks that every linear layer with an adaptor in all of the checkpoints
+    indexes by the adaptor id of each row of the batch. Adaptor i is the one
+    of checkpoints[i].
+
+    Export the result with the model's metadata plus get_num_lora_adapters,
+    which BatchedTextRunner reads to feed the adaptor ids of its rows as the
+    last input of forward.
+    """
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    assert checkpoints, "Expected at least one adaptor checkpoint"
+    selection = _AdaptorSelection()
+    _replace_linear_for_multi_lora(
+        module, checkpoints, lora_rank, lora_scale, selection
+    )
+    return MultiLoRAModel(module, selection)
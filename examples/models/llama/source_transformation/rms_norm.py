@@ -21,3 +21,32 @@ def replace_rms_norm_with_native_rms_norm(module: torch.nn.Module):
         else:
             replace_rms_norm_with_native_rms_norm(child)
     return module
+
+
+class RMSNormCustom(torch.nn.Module):
+    def __init__(self, rms_norm: RMSNorm):
+        super().__init__()
+        self.dim = rms_norm.dim
+        self.eps = rms_norm.eps
+        self.weight = rms_norm.weight
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        # Unlike RMSNorm, which rounds the normalized input back to x's dtype
+        # before scaling it by the weight, llama::rms_norm scales in float and
+        # rounds once.
+        return torch.ops.llama.rms_norm(x, self.weight.type_as(x), self.eps)
+
+
+def _replace_rms_norm_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, RMSNorm):
+            setattr(module, name, RMSNormCustom(child))
+        else:
+            _replace_rms_norm_with_custom_op(child)
+
+
+def replace_rms_norm_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    _replace_rms_norm_with_custom_op(module)
+    return module
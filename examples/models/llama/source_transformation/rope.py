@@ -37,3 +37,38 @@ def materialze_broadcast_of_rope_freq_cis(
         dim0, num_heads, dim1
     ).contiguous()
     return module
+
+
+class RopeCustom(torch.nn.Module):
+    def __init__(self, interleaved: bool):
+        super().__init__()
+        self.interleaved = interleaved
+
+    def forward(
+        self,
+        xq: torch.Tensor,
+        xk: torch.Tensor,
+        freqs_cos: torch.Tensor,
+        freqs_sin: torch.Tensor,
+    ):
+        # freqs come sliced from the precomputed tables in Rope.get_freqs, so
+        # the op only does the rotation, in place of the slices, muls and cats
+        # of the eager implementation.
+        xq_out = torch.ops.llama.apply_rotary_emb(
+            xq, freqs_cos, freqs_sin, self.interleaved
+        )
+        xk_out = torch.ops.llama.apply_rotary_emb(
+            xk, freqs_cos, freqs_sin, self.interleaved
+        )
+        return xq_out, xk_out
+
+
+def replace_rope_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    assert isinstance(module, Transformer)
+    # The HF rope splits each head in halves, the Meta one in pairs.
+    module.rope.apply_rotary_emb = RopeCustom(
+        interleaved=not module.rope.params.use_hf_rope
+    )
+    return module
@@ -0,0 +1,36 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import torch
+from executorch.examples.models.llama.llama_transformer import FeedForward
+
+
+class FeedForwardCustom(torch.nn.Module):
+    def __init__(self, feed_forward: FeedForward):
+        super().__init__()
+        self.w1 = feed_forward.w1
+        self.w2 = feed_forward.w2
+        self.w3 = feed_forward.w3
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        # silu(w1(x)) * w3(x) otherwise exports as sigmoid and two muls, each a
+        # separate pass over the hidden activations.
+        return self.w2(torch.ops.llama.silu_mul(self.w1(x), self.w3(x)))
+
+
+def _replace_feed_forward_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, FeedForward):
+            setattr(module, name, FeedForwardCustom(child))
+        else:
+            _replace_feed_forward_with_custom_op(child)
+
+
+def replace_feed_forward_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    _replace_feed_forward_with_custom_op(module)
+    return module
@@ -25,3 +25,21 @@ def define_common_targets():
                 ],
                 **get_oss_build_kwargs()
             )
+
+    runtime.cxx_binary(
+        name = "llama_benchmark",
+        srcs = [
+            "benchmark.cpp",
+        ],
+        compiler_flags = ["-Wno-global-constructors"],
+        deps = [
+            "//executorch/examples/models/llama/runner:runner",
+            "//executorch/extension/llm/runner:llm_benchmark",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/extension/threadpool:cpuinfo_utils",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        **get_oss_build_kwargs()
+    )
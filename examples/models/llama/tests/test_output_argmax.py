@@ -0,0 +1,39 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+import torch
+from executorch.examples.models.llama.llama_transformer import Transformer
+from executorch.examples.models.llama.model_args import ModelArgs
+
+
+class OutputArgmaxTest(unittest.TestCase):
+    def setUp(self):
+        torch.manual_seed(42)
+
+    def test_matches_argmax_of_logits(self):
+        for generate_full_logits in (False, True):
+            config = ModelArgs(
+                dim=64,
+                n_layers=2,
+                n_heads=4,
+                n_kv_heads=2,
+                vocab_size=100,
+                max_seq_len=8,
+                generate_full_logits=generate_full_logits,
+            )
+            model = Transformer(config).eval()
+            config.output_argmax = True
+            argmax_model = Transformer(config).eval()
+            argmax_model.load_state_dict(model.state_dict())
+
+            tokens = torch.randint(0, config.vocab_size, (1, 5))
+            with torch.no_grad():
+                logits = model(tokens)
+                output = argmax_model(tokens)
+            self.assertEqual(output.dtype, torch.long)
+            self.assertTrue(torch.equal(output, torch.argmax(logits, dim=-1)))
@@ -18,8 +18,17 @@ namespace example {
 class ET_EXPERIMENTAL LlavaImagePrefiller
     : public ::executorch::extension::llm::ImagePrefiller {
  public:
-  LlavaImagePrefiller(::executorch::extension::Module* module)
-      : ImagePrefiller(module){};
+  /**
+   * @param module The LLaVA Module.
+   * @param encoder_module If set, another instance of the LLaVA Module to run
+   * the image encoder on, so that images can be encoded while the text model
+   * runs.
+   */
+  LlavaImagePrefiller(
+      ::executorch::extension::Module* module,
+      ::executorch::extension::Module* encoder_module = nullptr)
+      : ImagePrefiller(module),
+        encoder_module_(encoder_module ? encoder_module : module){};
   /**
    * Prefill an LLM Module with the given image input.
    * @param image The image input to LLaVa.
@@ -29,30 +38,36 @@ class ET_EXPERIMENTAL LlavaImagePrefiller
   inline ::executorch::runtime::Result<executorch::aten::Tensor> prefill(
       ::executorch::extension::llm::Image& image,
       int64_t& start_pos) override {
-    auto image_tensor = executorch::extension::from_blob(
-        image.data.data(),
-        {3, image.height, image.width},
-        ::executorch::aten::ScalarType::Byte);
     // Run image encoder
-    auto image_encoder_outputs =
-        ET_UNWRAP(module_->execute(kImageEncoderMethod, image_tensor));
-
-    // inputs:[start_pos, embeds]
-    auto start_pos_tensor = executorch::extension::from_blob(
-        &start_pos, {1}, ::executorch::aten::ScalarType::Long);
-
-    // Run text model
-    auto outputs_res = ET_UNWRAP(module_->execute(
-        kTextModelMethod, {start_pos_tensor, image_encoder_outputs[0]}));
-    ET_CHECK_MSG(
-        outputs_res[0].isTensor(),
-        "Non Tensor Output returned from executing image prefill");
+    auto image_encoder_outputs = ET_UNWRAP(run_image_encoder(image));
+    return run_text_model(image_encoder_outputs[0].toTensor(), start_pos);
+  }
 
-    // Update the start_pos, which is only available inside this function.
-    // outputs_res can have only one logits.
-    start_pos += image_encoder_outputs[0].toTensor().size(1);
+  /**
+   * Run the image encoder alone.
+   * @param image The image input to LLaVa.
+   * @return A copy of the image embeddings.
+   */
+  inline ::executorch::runtime::Result<executorch::extension::TensorPtr>
+  encode(::executorch::extension::llm::Image& image) override {
+    auto image_encoder_outputs = ET_UNWRAP(run_image_encoder(image));
+    // The outputs live in the planned memory of the encoder, which the next
+    // image overwrites.
+    return executorch::extension::clone_tensor_ptr(
+        image_encoder_outputs[0].toTensor());
+  }
 
-    return outputs_res[0].toTensor();
+  /**
+   * Prefill an LLM Module with the embeddings from encode().
+   * @param embeddings The image embeddings.
+   * @param start_pos The starting position in KV cache of the input in the LLM
+   * @return logits of the image prefill.
+   */
+  inline ::executorch::runtime::Result<executorch::aten::Tensor>
+  prefill_embeddings(
+      const executorch::extension::TensorPtr& embeddings,
+      int64_t& start_pos) override {
+    return run_text_model(*embeddings, start_pos);
   }
 
   /**
@@ -63,7 +78,8 @@ class ET_EXPERIMENTAL LlavaImagePrefiller
     if (is_method_loaded()) {
       return ::executorch::runtime::Error::Ok;
     }
-    ET_CHECK_OK_OR_RETURN_ERROR(module_->load_method(kImageEncoderMethod));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        encoder_module_->load_method(kImageEncoderMethod));
     ET_CHECK_OK_OR_RETURN_ERROR(module_->load_method(kTextModelMethod));
     return ::executorch::runtime::Error::Ok;
   }
@@ -91,13 +107,49 @@ class ET_EXPERIMENTAL LlavaImagePrefiller
           kImageEncoderMethod.c_str(),
           kTextModelMethod.c_str());
     }
-    bool methods_loaded = module_->is_method_loaded(kImageEncoderMethod) &&
+    bool methods_loaded =
+        encoder_module_->is_method_loaded(kImageEncoderMethod) &&
         module_->is_method_loaded(kTextModelMethod);
     return methods_loaded;
   }
 
   inline static const std::string kImageEncoderMethod = "image_encoder";
   inline static const std::string kTextModelMethod = "text_model";
+
+ private:
+  inline ::executorch::runtime::Result<
+      std::vector<::executorch::runtime::EValue>>
+  run_image_encoder(::executorch::extension::llm::Image& image) {
+    auto image_tensor = executorch::extension::from_blob(
+        image.data.data(),
+        {3, image.height, image.width},
+        ::executorch::aten::ScalarType::Byte);
+    return encoder_module_->execute(kImageEncoderMethod, image_tensor);
+  }
+
+  inline ::executorch::runtime::Result<executorch::aten::Tensor>
+  run_text_model(
+      const executorch::aten::Tensor& embeddings,
+      int64_t& start_pos) {
+    // inputs:[start_pos, embeds]
+    auto start_pos_tensor = executorch::extension::from_blob(
+        &start_pos, {1}, ::executorch::aten::ScalarType::Long);
+
+    // Run text model
+    auto outputs_res = ET_UNWRAP(
+        module_->execute(kTextModelMethod, {start_pos_tensor, embeddings}));
+    ET_CHECK_MSG(
+        outputs_res[0].isTensor(),
+        "Non Tensor Output returned from executing image prefill");
+
+    // Update the start_pos, which is only available inside this function.
+    // outputs_res can have only one logits.
+    start_pos += embeddings.size(1);
+
+    return outputs_res[0].toTensor();
+  }
+
+  ::executorch::extension::Module* encoder_module_;
 };
 
 } // namespace example
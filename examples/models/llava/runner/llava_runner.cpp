@@ -28,7 +28,7 @@ namespace example {
 
 bool LlavaRunner::is_loaded() {
   bool instantiated = tokenizer_ && text_decoder_runner_ && text_prefiller_ &&
-      image_prefiller_ && text_token_generator_;
+      image_prefiller_ && pipelined_image_prefiller_ && text_token_generator_;
   if (!instantiated) {
     return false;
   }
@@ -57,9 +57,17 @@ Error LlavaRunner::load() {
       /*use_kv_cache=*/true,
       /*enable_parallel_prefill=*/true);
 
-  // Load the image prefiller
-  image_prefiller_ = std::make_unique<LlavaImagePrefiller>(module_.get());
+  // Load the image prefiller, with the image encoder on its own instance of
+  // the model so that it can run alongside the text model. The encoder is
+  // only loaded there, not on module_.
+  encoder_module_ = std::make_unique<::executorch::extension::Module>(
+      model_path_,
+      ::executorch::extension::Module::LoadMode::MmapUseMlockIgnoreErrors);
+  image_prefiller_ = std::make_unique<LlavaImagePrefiller>(
+      module_.get(), encoder_module_.get());
   image_prefiller_->load();
+  pipelined_image_prefiller_ =
+      std::make_unique<llm::PipelinedImagePrefiller>(image_prefiller_.get());
 
   // Load the text token generator
   text_token_generator_ = std::make_unique<llm::TextTokenGenerator>(
@@ -77,11 +85,9 @@ Error LlavaRunner::load() {
 Error LlavaRunner::prefill_images(
     std::vector<llm::Image>& images,
     int64_t& start_pos) {
-  for (auto& image : images) {
-    // pos is updated inside image prefill.
-    ET_UNWRAP(image_prefiller_->prefill(image, start_pos));
-  }
-  return Error::Ok;
+  // Each image is encoded while the one before it is prefilled.
+  ET_CHECK_OK_OR_RETURN_ERROR(pipelined_image_prefiller_->start(images));
+  return pipelined_image_prefiller_->prefill(start_pos);
 }
 
 Result<uint64_t> LlavaRunner::prefill_prompt(
@@ -156,11 +162,15 @@ Error LlavaRunner::generate(
   int64_t pos = 0;
   stats_.inference_start_ms = llm::time_in_ms();
 
-  // prefill preset prompt
-  prefill_prompt(kPresetPrompt, pos, /*bos=*/1, /*eos*/ 0);
+  // Start encoding the images, and prefill the preset prompt meanwhile.
+  ET_CHECK_OK_OR_RETURN_ERROR(pipelined_image_prefiller_->start(images));
+  auto preset_res = prefill_prompt(kPresetPrompt, pos, /*bos=*/1, /*eos*/ 0);
 
-  // prefill images
-  prefill_images(images, pos);
+  // prefill images, each as soon as it's encoded. This also waits for the
+  // encoding to finish, so it must run even if the preset prompt failed.
+  Error image_err = pipelined_image_prefiller_->prefill(pos);
+  ET_CHECK_OK_OR_RETURN_ERROR(preset_res.error());
+  ET_CHECK_OK_OR_RETURN_ERROR(image_err);
 
   ET_LOG(
       Info,
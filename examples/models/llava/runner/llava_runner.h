@@ -18,6 +18,7 @@
 #include <unordered_map>
 
 #include <executorch/extension/llm/runner/multimodal_runner.h>
+#include <executorch/extension/llm/runner/pipelined_image_prefiller.h>
 
 namespace example {
 
@@ -28,7 +29,8 @@ class ET_EXPERIMENTAL LlavaRunner
       const std::string& model_path,
       const std::string& tokenizer_path,
       const float temperature = 0.8f)
-      : MultimodalRunner(model_path, tokenizer_path, temperature){};
+      : MultimodalRunner(model_path, tokenizer_path, temperature),
+        model_path_(model_path){};
 
   bool is_loaded() override;
 
@@ -63,6 +65,13 @@ class ET_EXPERIMENTAL LlavaRunner
       bool echo = true) override;
 
  private:
+  std::string model_path_;
+  // Another instance of the model to encode images on while the text model
+  // runs.
+  std::unique_ptr<::executorch::extension::Module> encoder_module_;
+  std::unique_ptr<::executorch::extension::llm::PipelinedImagePrefiller>
+      pipelined_image_prefiller_;
+
   inline static const std::string kPresetPrompt =
       "A chat between a curious human and an artificial intelligence assistant. The assistant gives helpful, detailed, and polite answers to the human's questions. USER: ";
 };
@@ -0,0 +1,706 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Benchmarks the methods of an ExecuTorch model file, e.g.
+ *
+ *   benchmark_runner --model_path=mv2_xnnpack_fp32.pte --num_iterations=50
+ *       --cpu_threads=1,2,4 --json_output_path=benchmark_results.json
+ *
+ * For each method and thread count, it reports the method load time, the
+ * latency percentiles of the executions that follow the warmup ones, the
+ * memory the method and temp allocators used and the peak RSS of the process.
+ * It also samples the temperatures, frequencies and power of the device after
+ * each execution, so that throttling shows next to the latencies it causes.
+ *
+ * The JSON output is a list of metrics in the format of the benchmark apps in
+ * extension/benchmark, with "method" and "numThreads" fields added, so that
+ * results from the device lab and CI can be processed by the same tools.
+ *
+ * Like executor_runner, it sets all input tensor data to ones. The inputs are
+ * prepared before each execution, out of the timed region.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/runner_util/device_monitor.h>
+#include <executorch/extension/runner_util/inputs.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#if defined(__linux__) || defined(__ANDROID__) || defined(__unix__)
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#endif
+
+DEFINE_string(
+    model_path,
+    "model.pte",
+    "Model serialized in flatbuffer format.");
+DEFINE_string(
+    method_name,
+    "",
+    "Method to benchmark. Defaults to all the methods of the model.");
+DEFINE_uint32(
+    num_warmup_iterations,
+    3,
+    "Number of executions to run before measuring.");
+DEFINE_uint32(num_iterations, 10, "Number of executions to measure.");
+DEFINE_uint32(
+    duration_ms,
+    0,
+    "If nonzero, measure executions for this long instead of a fixed number of them.");
+DEFINE_string(
+    cpu_threads,
+    "-1",
+    "Comma separated list of the numbers of CPU threads to benchmark with, e.g. 1,2,4. -1 uses a heuristic to derive the # of performant cores for a specific device. Requires the threadpool.");
+DEFINE_uint32(
+    method_allocator_pool_size,
+    4 * 1024U * 1024U,
+    "Size in bytes of the memory pool for the metadata of the loaded method.");
+DEFINE_uint32(
+    temp_allocator_pool_size,
+    1024U * 1024U,
+    "Size in bytes of the memory pool for the temporary memory of kernels.");
+DEFINE_bool(
+    sample_device,
+    true,
+    "Sample the temperatures, frequencies and power of the device after each execution, out of the timed region.");
+DEFINE_string(
+    json_output_path,
+    "",
+    "If not empty, write the results to this path in the format of the benchmark apps.");
+
+using executorch::extension::DeviceMonitor;
+using executorch::extension::DeviceSample;
+using executorch::extension::DeviceSampleSummary;
+using executorch::extension::FileDataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::HierarchicalAllocator;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::MemoryManager;
+using executorch::runtime::Method;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+namespace {
+
+/// A MemoryAllocator that records the most memory it handed out at once.
+class PeakTrackingAllocator : public MemoryAllocator {
+ public:
+  PeakTrackingAllocator(uint32_t size, uint8_t* base_address)
+      : MemoryAllocator(size, base_address) {}
+
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    void* ptr = MemoryAllocator::allocate(size, alignment);
+    if (ptr != nullptr) {
+      used_ = static_cast<uint8_t*>(ptr) + size - base_address();
+      peak_ = std::max(peak_, used_);
+    }
+    return ptr;
+  }
+
+  void reset() override {
+    MemoryAllocator::reset();
+    used_ = 0;
+  }
+
+  size_t peak() const {
+    return peak_;
+  }
+
+ private:
+  size_t used_ = 0;
+  size_t peak_ = 0;
+};
+
+double ticks_to_ms(et_timestamp_t ticks) {
+  const auto tick_ratio = et_pal_ticks_to_ns_multiplier();
+  constexpr double kNanosecondsPerMillisecond = 1000000;
+  return static_cast<double>(ticks) * tick_ratio.numerator /
+      tick_ratio.denominator / kNanosecondsPerMillisecond;
+}
+
+// Returns the peak RSS of the process in bytes, or 0 if not supported.
+size_t get_peak_rss_bytes() {
+#if defined(__linux__) || defined(__ANDROID__)
+  struct rusage r_usage;
+  if (getrusage(RUSAGE_SELF, &r_usage) == 0) {
+    return r_usage.ru_maxrss * 1024;
+  }
+#endif
+  // ru_maxrss is not in kbytes on all versions of macOS.
+  return 0;
+}
+
+// Returns the value at the given fraction of the sorted values, e.g. 0.9 for
+// the p90, with the nearest-rank method.
+double percentile(const std::vector<double>& sorted, double fraction) {
+  size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.5);
+  rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+  return sorted[rank - 1];
+}
+
+// The mean of the middle 80% of the sorted values, which discards outliers
+// like the benchmark apps do.
+double trimmed_mean(const std::vector<double>& sorted) {
+  size_t begin = sorted.size() / 10;
+  size_t end = sorted.size() * 9 / 10;
+  if (begin >= end) {
+    begin = 0;
+    end = sorted.size();
+  }
+  double sum = 0;
+  for (size_t i = begin; i < end; ++i) {
+    sum += sorted[i];
+  }
+  return sum / (end - begin);
+}
+
+std::vector<int32_t> parse_thread_counts(const std::string& list) {
+  std::vector<int32_t> counts;
+  size_t begin = 0;
+  while (begin <= list.size()) {
+    size_t end = list.find(',', begin);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    const std::string item = list.substr(begin, end - begin);
+    if (!item.empty()) {
+      counts.push_back(static_cast<int32_t>(std::stol(item)));
+    }
+    begin = end + 1;
+  }
+  if (counts.empty()) {
+    counts.push_back(-1);
+  }
+  return counts;
+}
+
+// Sets the size of the threadpool, and returns the number of threads used.
+int32_t set_num_threads(int32_t cpu_threads) {
+#if defined(ET_USE_THREADPOOL)
+  const uint32_t num_threads = cpu_threads == -1
+      ? ::executorch::extension::cpuinfo::get_num_performant_cores()
+      : static_cast<uint32_t>(cpu_threads);
+  ET_LOG(Info, "Resetting threadpool with num threads = %" PRIu32, num_threads);
+  if (num_threads > 0) {
+    ::executorch::extension::threadpool::get_threadpool()
+        ->_unsafe_reset_threadpool(num_threads);
+  }
+  return static_cast<int32_t>(num_threads);
+#else
+  if (cpu_threads != -1) {
+    ET_LOG(
+        Error,
+        "Built without the threadpool, ignoring cpu_threads=%" PRId32,
+        cpu_threads);
+  }
+  return 1;
+#endif
+}
+
+struct MethodResult {
+  std::string method_name;
+  int32_t num_threads;
+  Error load_status;
+  double method_load_time_ms;
+  // Sorted.
+  std::vector<double> latencies_ms;
+  // One per execution, in the order they ran, with their latencies.
+  std::vector<double> ordered_latencies_ms;
+  std::vector<DeviceSample> device_samples;
+  size_t method_allocator_bytes;
+  size_t temp_allocator_peak_bytes;
+  size_t planned_memory_bytes;
+  size_t peak_rss_bytes;
+};
+
+MethodResult benchmark_method(
+    Program& program,
+    const char* method_name,
+    int32_t num_threads) {
+  MethodResult result{};
+  result.method_name = method_name;
+  result.num_threads = num_threads;
+
+  Result<MethodMeta> method_meta = program.method_meta(method_name);
+  ET_CHECK_MSG(
+      method_meta.ok(),
+      "Failed to get method_meta for %s: 0x%" PRIx32,
+      method_name,
+      (uint32_t)method_meta.error());
+
+  std::vector<uint8_t> method_allocator_pool(FLAGS_method_allocator_pool_size);
+  std::vector<uint8_t> temp_allocator_pool(FLAGS_temp_allocator_pool_size);
+  PeakTrackingAllocator method_allocator(
+      method_allocator_pool.size(), method_allocator_pool.data());
+  PeakTrackingAllocator temp_allocator(
+      temp_allocator_pool.size(), temp_allocator_pool.data());
+
+  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers;
+  std::vector<Span<uint8_t>> planned_spans;
+  for (size_t id = 0; id < method_meta->num_memory_planned_buffers(); ++id) {
+    // .get() will always succeed because id < num_memory_planned_buffers.
+    size_t buffer_size =
+        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
+    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+    result.planned_memory_bytes += buffer_size;
+  }
+  HierarchicalAllocator planned_memory(
+      {planned_spans.data(), planned_spans.size()});
+  MemoryManager memory_manager(
+      &method_allocator, &planned_memory, &temp_allocator);
+
+  const et_timestamp_t before_load = et_pal_current_ticks();
+  Result<Method> method = program.load_method(method_name, &memory_manager);
+  result.method_load_time_ms =
+      ticks_to_ms(et_pal_current_ticks() - before_load);
+  result.load_status = method.error();
+  if (!method.ok()) {
+    ET_LOG(
+        Error,
+        "Loading of method %s failed with status 0x%" PRIx32,
+        method_name,
+        (uint32_t)method.error());
+    return result;
+  }
+  result.method_allocator_bytes = method_allocator.peak();
+
+  const auto run_once = [&]() -> et_timestamp_t {
+    // The inputs must be prepared again before each execution, since memory
+    // planning may reuse their space.
+    auto inputs = executorch::extension::prepare_input_tensors(*method);
+    ET_CHECK_MSG(
+        inputs.ok(),
+        "Could not prepare inputs: 0x%" PRIx32,
+        (uint32_t)inputs.error());
+    const et_timestamp_t before_execute = et_pal_current_ticks();
+    Error status = method->execute();
+    const et_timestamp_t after_execute = et_pal_current_ticks();
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Execution of method %s failed with status 0x%" PRIx32,
+        method_name,
+        (uint32_t)status);
+    return after_execute - before_execute;
+  };
+
+  for (uint32_t i = 0; i < FLAGS_num_warmup_iterations; ++i) {
+    run_once();
+  }
+  DeviceMonitor device_monitor;
+  const auto measure_once = [&]() {
+    result.ordered_latencies_ms.push_back(ticks_to_ms(run_once()));
+    if (FLAGS_sample_device) {
+      result.device_samples.push_back(device_monitor.sample());
+    }
+    return result.ordered_latencies_ms.back();
+  };
+  if (FLAGS_duration_ms > 0) {
+    double elapsed_ms = 0;
+    while (elapsed_ms < FLAGS_duration_ms) {
+      elapsed_ms += measure_once();
+    }
+  } else {
+    for (uint32_t i = 0; i < FLAGS_num_iterations; ++i) {
+      measure_once();
+    }
+  }
+  result.latencies_ms = result.ordered_latencies_ms;
+  std::sort(result.latencies_ms.begin(), result.latencies_ms.end());
+
+  result.temp_allocator_peak_bytes = temp_allocator.peak();
+  result.peak_rss_bytes = get_peak_rss_bytes();
+  return result;
+}
+
+void print_result(const MethodResult& result, double program_load_time_ms) {
+  printf(
+      "Method %s, %" PRId32 " thread(s): load %.3f ms",
+      result.method_name.c_str(),
+      result.num_threads,
+      program_load_time_ms + result.method_load_time_ms);
+  if (result.load_status != Error::Ok) {
+    printf(
+        ", failed with status 0x%" PRIx32 "\n", (uint32_t)result.load_status);
+    return;
+  }
+  const std::vector<double>& latencies = result.latencies_ms;
+  if (!latencies.empty()) {
+    printf(
+        ", %zu executions: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms,"
+        " min %.3f ms, max %.3f ms",
+        latencies.size(),
+        percentile(latencies, 0.5),
+        percentile(latencies, 0.9),
+        percentile(latencies, 0.99),
+        latencies.front(),
+        latencies.back());
+  }
+  printf(
+      "\n  method allocator %zu B, temp allocator peak %zu B,"
+      " planned memory %zu B, peak RSS %zu B\n",
+      result.method_allocator_bytes,
+      result.temp_allocator_peak_bytes,
+      result.planned_memory_bytes,
+      result.peak_rss_bytes);
+  if (!latencies.empty()) {
+    printf(
+        "  last/first tenth latency ratio %.3f",
+        executorch::extension::sustained_latency_ratio(
+            result.ordered_latencies_ms));
+    const DeviceSampleSummary summary =
+        executorch::extension::summarize_device_samples(result.device_samples);
+    if (summary.max_temperature_c) {
+      printf(", max temperature %.1f C", *summary.max_temperature_c);
+    }
+    if (summary.min_cpu_freq_mhz) {
+      printf(
+          ", CPU frequency min %.0f MHz, avg %.0f MHz",
+          *summary.min_cpu_freq_mhz,
+          *summary.avg_cpu_freq_mhz);
+    }
+    if (summary.avg_power_w) {
+      printf(", avg power %.2f W", *summary.avg_power_w);
+    }
+    if (summary.avg_battery_current_ma) {
+      printf(", avg battery current %.0f mA", *summary.avg_battery_current_ma);
+    }
+    printf("\n");
+  }
+}
+
+std::string json_string(const std::string& value) {
+  std::string escaped = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      escaped += buffer;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped + "\"";
+}
+
+// The samples of the device after each execution as a JSON list, with the
+// latencies of the executions they followed.
+std::string device_samples_json(const MethodResult& result) {
+  std::string json = "[";
+  char buffer[64];
+  for (size_t i = 0; i < result.device_samples.size(); ++i) {
+    const DeviceSample& sample = result.device_samples[i];
+    snprintf(
+        buffer,
+        sizeof(buffer),
+        "%s{\"iteration\": %zu, \"timestampMs\": %.3f",
+        i == 0 ? "" : ", ",
+        i,
+        sample.timestamp_ms);
+    json += buffer;
+    const auto add_field = [&](const char* name, double value) {
+      snprintf(buffer, sizeof(buffer), ", \"%s\": %.3f", name, value);
+      json += buffer;
+    };
+    add_field("latencyMs", result.ordered_latencies_ms[i]);
+    if (sample.max_temperature_c) {
+      add_field("maxTemperatureC", *sample.max_temperature_c);
+    }
+    if (!sample.cpu_freq_mhz.empty()) {
+      json += ", \"cpuFreqMhz\": [";
+      for (size_t cpu = 0; cpu < sample.cpu_freq_mhz.size(); ++cpu) {
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "%s%.0f",
+            cpu == 0 ? "" : ", ",
+            sample.cpu_freq_mhz[cpu]);
+        json += buffer;
+      }
+      json += "]";
+    }
+    if (sample.gpu_freq_mhz) {
+      add_field("gpuFreqMhz", *sample.gpu_freq_mhz);
+    }
+    if (sample.energy_j) {
+      add_field("energyJ", *sample.energy_j);
+    }
+    if (sample.battery_current_ma) {
+      add_field("batteryCurrentMa", *sample.battery_current_ma);
+    }
+    json += "}";
+  }
+  return json + "]";
+}
+
+// Writes the results as the list of BenchmarkMetric objects that the Android
+// benchmark app writes to benchmark_results.json.
+bool write_json(
+    const char* path,
+    const std::vector<MethodResult>& results,
+    double program_load_time_ms) {
+  // The model name, backend and quantization are parsed from the file name,
+  // e.g. mv2_xnnpack_fp32.pte, like the benchmark apps do.
+  std::string model = FLAGS_model_path;
+  model = model.substr(model.find_last_of("/\\") + 1);
+  if (model.size() > 4 && model.compare(model.size() - 4, 4, ".pte") == 0) {
+    model.resize(model.size() - 4);
+  }
+  std::string name = model;
+  std::string backend;
+  std::string quantization;
+  std::smatch match;
+  if (std::regex_match(
+          model, match, std::regex("(\\w+)_([\\w\\+]+)_(\\w+)"))) {
+    name = match[1];
+    backend = match[2];
+    quantization = match[3];
+  }
+
+  std::string device = "unknown";
+  std::string arch = "unknown";
+  std::string os = "unknown";
+  long long total_mem = 0;
+  long long avail_mem = 0;
+#if defined(__linux__) || defined(__ANDROID__) || defined(__unix__)
+  struct utsname uts;
+  if (uname(&uts) == 0) {
+    device = uts.nodename;
+    arch = uts.machine;
+    os = std::string(uts.sysname) + " " + uts.release;
+  }
+#if defined(_SC_PHYS_PAGES) && defined(_SC_AVPHYS_PAGES)
+  const long long page_size = sysconf(_SC_PAGESIZE);
+  total_mem = sysconf(_SC_PHYS_PAGES) * page_size;
+  avail_mem = sysconf(_SC_AVPHYS_PAGES) * page_size;
+#endif
+#endif
+
+  std::unique_ptr<FILE, decltype(&fclose)> file(fopen(path, "w"), fclose);
+  if (!file) {
+    ET_LOG(Error, "Failed to open %s", path);
+    return false;
+  }
+
+  bool first = true;
+  // extra_fields, if any, are appended to the fields of the metric.
+  const auto write_metric = [&](const MethodResult& result,
+                                const char* metric,
+                                double value,
+                                const std::string& extra_fields = "") {
+    fprintf(
+        file.get(),
+        "%s\n  {\"benchmarkModel\": {\"name\": %s, \"backend\": %s,"
+        " \"quantization\": %s}, \"metric\": %s, \"actualValue\": %f,"
+        " \"targetValue\": 0.0, \"deviceInfo\": {\"device\": %s,"
+        " \"arch\": %s, \"os\": %s, \"totalMem\": %lld, \"availMem\": %lld},"
+        " \"method\": %s, \"numThreads\": %" PRId32 "%s}",
+        first ? "" : ",",
+        json_string(name).c_str(),
+        json_string(backend).c_str(),
+        json_string(quantization).c_str(),
+        json_string(metric).c_str(),
+        value,
+        json_string(device).c_str(),
+        json_string(arch).c_str(),
+        json_string(os).c_str(),
+        total_mem,
+        avail_mem,
+        json_string(result.method_name).c_str(),
+        result.num_threads,
+        extra_fields.c_str());
+    first = false;
+  };
+
+  constexpr double kBytesPerMegabyte = 1024 * 1024;
+  fprintf(file.get(), "[");
+  for (const MethodResult& result : results) {
+    write_metric(
+        result,
+        "model_load_time(ms)",
+        program_load_time_ms + result.method_load_time_ms);
+    write_metric(result, "method_load_time(ms)", result.method_load_time_ms);
+    write_metric(
+        result, "load_status", static_cast<double>(result.load_status));
+    const std::vector<double>& latencies = result.latencies_ms;
+    if (!latencies.empty()) {
+      double sum = 0;
+      for (double latency : latencies) {
+        sum += latency;
+      }
+      write_metric(
+          result, "avg_inference_latency(ms)", sum / latencies.size());
+      write_metric(
+          result, "trimmean_inference_latency(ms)", trimmed_mean(latencies));
+      write_metric(
+          result, "p50_inference_latency(ms)", percentile(latencies, 0.5));
+      write_metric(
+          result, "p90_inference_latency(ms)", percentile(latencies, 0.9));
+      write_metric(
+          result, "p99_inference_latency(ms)", percentile(latencies, 0.99));
+      write_metric(result, "min_inference_latency(ms)", latencies.front());
+      write_metric(result, "max_inference_latency(ms)", latencies.back());
+      write_metric(
+          result,
+          "sustained_latency_ratio",
+          executorch::extension::sustained_latency_ratio(
+              result.ordered_latencies_ms));
+    }
+    const DeviceSampleSummary summary =
+        executorch::extension::summarize_device_samples(result.device_samples);
+    if (summary.max_temperature_c) {
+      write_metric(
+          result, "max_temperature(celsius)", *summary.max_temperature_c);
+    }
+    if (summary.min_cpu_freq_mhz) {
+      write_metric(result, "min_cpu_freq(mhz)", *summary.min_cpu_freq_mhz);
+      write_metric(result, "avg_cpu_freq(mhz)", *summary.avg_cpu_freq_mhz);
+    }
+    if (summary.min_gpu_freq_mhz) {
+      write_metric(result, "min_gpu_freq(mhz)", *summary.min_gpu_freq_mhz);
+    }
+    if (summary.energy_j) {
+      // The energy is the one between the first and the last sample, which
+      // follow the first and the last execution.
+      write_metric(
+          result,
+          "energy_per_inference(mj)",
+          *summary.energy_j * 1000 / (result.device_samples.size() - 1));
+    }
+    if (summary.avg_power_w) {
+      write_metric(result, "avg_power(w)", *summary.avg_power_w);
+    }
+    if (summary.avg_battery_current_ma) {
+      write_metric(
+          result, "avg_battery_current(ma)", *summary.avg_battery_current_ma);
+    }
+    if (!result.device_samples.empty()) {
+      // The samples are listed in a field of their own, as the metric value
+      // would only be their count.
+      write_metric(
+          result,
+          "device_samples",
+          static_cast<double>(result.device_samples.size()),
+          ", \"samples\": " + device_samples_json(result));
+    }
+    write_metric(
+        result,
+        "method_allocator_usage(mb)",
+        result.method_allocator_bytes / kBytesPerMegabyte);
+    write_metric(
+        result,
+        "temp_allocator_peak_usage(mb)",
+        result.temp_allocator_peak_bytes / kBytesPerMegabyte);
+    write_metric(
+        result,
+        "planned_memory(mb)",
+        result.planned_memory_bytes / kBytesPerMegabyte);
+    write_metric(
+        result,
+        "peak_rss_usage(mb)",
+        result.peak_rss_bytes / kBytesPerMegabyte);
+  }
+  fprintf(file.get(), "\n]\n");
+  ET_LOG(Info, "Results written to %s", path);
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+
+  const char* model_path = FLAGS_model_path.c_str();
+  const et_timestamp_t before_load = et_pal_current_ticks();
+  Result<FileDataLoader> loader = FileDataLoader::from(model_path);
+  ET_CHECK_MSG(
+      loader.ok(),
+      "FileDataLoader::from() failed: 0x%" PRIx32,
+      (uint32_t)loader.error());
+  Result<Program> program = Program::load(&loader.get());
+  const double program_load_time_ms =
+      ticks_to_ms(et_pal_current_ticks() - before_load);
+  if (!program.ok()) {
+    ET_LOG(Error, "Failed to parse model file %s", model_path);
+    return 1;
+  }
+  ET_LOG(
+      Info,
+      "Model file %s is loaded in %f ms.",
+      model_path,
+      program_load_time_ms);
+
+  std::vector<std::string> method_names;
+  if (!FLAGS_method_name.empty()) {
+    method_names.push_back(FLAGS_method_name);
+  } else {
+    for (size_t i = 0; i < program->num_methods(); ++i) {
+      method_names.push_back(program->get_method_name(i).get());
+    }
+  }
+
+  std::vector<MethodResult> results;
+  for (int32_t cpu_threads : parse_thread_counts(FLAGS_cpu_threads)) {
+    const int32_t num_threads = set_num_threads(cpu_threads);
+    for (const std::string& method_name : method_names) {
+      results.push_back(
+          benchmark_method(program.get(), method_name.c_str(), num_threads));
+      print_result(results.back(), program_load_time_ms);
+    }
+  }
+
+  if (!FLAGS_json_output_path.empty() &&
+      !write_json(
+          FLAGS_json_output_path.c_str(), results, program_load_time_ms)) {
+    return 1;
+  }
+  for (const MethodResult& result : results) {
+    if (result.load_status != Error::Ok) {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Wraps a commandline executable that can be linked against any desired
+    # kernel or backend implementations. Contains a main() function.
+    runtime.cxx_library(
+        name = "benchmark_runner_lib",
+        srcs = ["benchmark_runner.cpp"],
+        compiler_flags = ["-Wno-global-constructors"],
+        deps = [
+            "//executorch/runtime/executor:program",
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/extension/runner_util:device_monitor",
+            "//executorch/extension/runner_util:inputs",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        visibility = [
+            "//executorch/examples/...",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "benchmark_runner_lib_with_threadpool",
+        srcs = ["benchmark_runner.cpp"],
+        compiler_flags = ["-Wno-global-constructors"],
+        deps = [
+            "//executorch/runtime/executor:program",
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/extension/runner_util:device_monitor",
+            "//executorch/extension/runner_util:inputs",
+            "//executorch/extension/threadpool:cpuinfo_utils",
+            "//executorch/extension/threadpool:threadpool",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        visibility = [
+            "//executorch/examples/...",
+        ],
+    )
+
+    # Benchmarks models that only use portable kernels, like executor_runner.
+    runtime.cxx_binary(
+        name = "benchmark_runner",
+        srcs = [],
+        deps = [
+            ":benchmark_runner_lib",
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/kernels/quantized:generated_lib",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
+
+    # Benchmarks models with all fast CPU kernels (XNNPACK, custom SDPA, etc.)
+    # available, and supports thread count sweeps.
+    runtime.cxx_binary(
+        name = "benchmark_runner_opt",
+        srcs = [],
+        deps = [
+            ":benchmark_runner_lib_with_threadpool",
+            "//executorch/backends/xnnpack:xnnpack_backend",
+            "//executorch/configurations:executor_cpu_optimized",
+            "//executorch/examples/portable/executor_runner:generated_op_lib_for_runner",
+            "//executorch/extension/llm/custom_ops:custom_ops",
+            "//executorch/kernels/quantized:generated_lib",
+        ],
+    )
@@ -251,22 +251,23 @@ int main(int argc, char** argv) {
   ET_LOG(Info, "Method loaded.");
 
   et_timestamp_t time_spent_executing = 0;
+  // Owns the memory of the input tensors, allocated on the first execution,
+  // and must live past the last call to `execute()`.
+  executorch::extension::InputWorkspace inputs;
   // Run the model.
   for (uint32_t i = 0; i < FLAGS_num_executions; i++) {
     ET_LOG(Debug, "Preparing inputs.");
-    // Allocate input tensors and set all of their elements to 1. The `inputs`
-    // variable owns the allocated memory and must live past the last call to
-    // `execute()`.
+    // Set all of the elements of the input tensors to 1.
     //
     // NOTE: we have to re-prepare input tensors on every execution
     // because inputs whose space gets reused by memory planning (if
     // any such inputs exist) will not be preserved for the next
     // execution.
-    auto inputs = executorch::extension::prepare_input_tensors(*method);
+    Error prepare_status = inputs.prepare(*method);
     ET_CHECK_MSG(
-        inputs.ok(),
+        prepare_status == Error::Ok,
         "Could not prepare inputs: 0x%" PRIx32,
-        (uint32_t)inputs.error());
+        (uint32_t)prepare_status);
     ET_LOG(Debug, "Inputs prepared.");
 
     const et_timestamp_t before_execute = et_pal_current_ticks();
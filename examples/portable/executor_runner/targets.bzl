@@ -93,6 +93,9 @@ def define_common_targets():
         custom_ops_yaml_target = "//executorch/kernels/portable:custom_ops.yaml",
         fallback_yaml_target = "//executorch/kernels/portable:functions.yaml",
         define_static_targets = True,
+        visibility = [
+            "//executorch/examples/...",
+        ],
     )
 
     # Test driver for models, should have all fast CPU kernels
@@ -18,6 +18,7 @@
  */
 
 #include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
+#include <executorch/backends/qualcomm/runtime/SharedMemoryPlannedBuffers.h>
 #include <executorch/devtools/etdump/etdump_flatcc.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/runner_util/inputs.h>
@@ -95,6 +96,7 @@ DEFINE_int32(
 
 using executorch::aten::Tensor;
 using executorch::aten::TensorImpl;
+using executorch::backends::qnn::SharedMemoryPlannedBuffers;
 using executorch::etdump::ETDumpGen;
 using executorch::etdump::ETDumpResult;
 using executorch::extension::FileDataLoader;
@@ -228,23 +230,40 @@ int main(int argc, char** argv) {
   // mobile environments will only have a single buffer. Some embedded
   // environments may have more than one for, e.g., slow/large DRAM and
   // fast/small SRAM, or for memory associated with particular cores.
+  //
+  // With shared buffers, the planned buffers are allocated on RPC shared
+  // memory, so that the delegate inputs and outputs planned in them don't need
+  // to be copied to and from the HTP.
   std::vector<std::unique_ptr<uint8_t[]>> planned_buffers; // Owns the memory
   std::vector<Span<uint8_t>> planned_spans; // Passed to the allocator
+  std::unique_ptr<SharedMemoryPlannedBuffers> shared_planned_buffers;
   size_t num_memory_planned_buffers = method_meta->num_memory_planned_buffers();
-  for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
-    // .get() will always succeed because id < num_memory_planned_buffers.
-    size_t buffer_size =
-        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
-    ET_LOG(Info, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
-    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
-    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+  if (FLAGS_shared_buffer) {
+    auto buffers = SharedMemoryPlannedBuffers::create(*method_meta);
+    ET_CHECK_MSG(
+        buffers.ok(),
+        "Failed to allocate planned buffers on shared memory: 0x%" PRIx32,
+        (int)buffers.error());
+    shared_planned_buffers = std::move(buffers.get());
+  } else {
+    for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
+      // .get() will always succeed because id < num_memory_planned_buffers.
+      size_t buffer_size = static_cast<size_t>(
+          method_meta->memory_planned_buffer_size(id).get());
+      ET_LOG(Info, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
+      planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+      planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+    }
   }
   HierarchicalAllocator planned_memory(
       {planned_spans.data(), planned_spans.size()});
 
   // Assemble all of the allocators into the MemoryManager that the Executor
   // will use.
-  MemoryManager memory_manager(&method_allocator, &planned_memory);
+  MemoryManager memory_manager(
+      &method_allocator,
+      shared_planned_buffers ? shared_planned_buffers->planned_memory()
+                             : &planned_memory);
 
   //
   // Load the method from the program, using the provided allocators. Running
@@ -0,0 +1,264 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""Compression of PTE and PTD segments.
+
+A compressed segment is split into chunks that are compressed independently,
+so that the runtime can decompress them in parallel, directly into their
+destination, and can decompress a single tensor of a segment without
+decompressing the chunks before it. See SegmentCompression in
+schema/program.fbs.
+
+Chunks are compressed with the LZ4 block format. The `lz4` package is used if it
+is installed; otherwise a slower pure Python encoder produces the same format.
+"""
+
+from dataclasses import dataclass
+from typing import List, Optional, Tuple
+
+from executorch.exir.schema import CompressionAlgorithm, SegmentCompression
+
+try:
+    import lz4.block as _lz4_block  # pyre-ignore[21]
+except ImportError:  # pragma: no cover
+    _lz4_block = None
+
+
+@dataclass
+class SegmentCompressionConfig:
+    """Configures the compression of the data segments of a PTE or PTD file."""
+
+    # The size in bytes of the uncompressed chunks. Smaller chunks decompress
+    # with more parallelism, and make loading a single tensor of a segment
+    # decompress less unrelated data, but compress a little worse.
+    chunk_size: int = 1 << 20
+
+    # If greater than 1, group the bytes of each chunk by their position in
+    # elements of this size before compressing it. 2 suits fp16 and bf16
+    # weights, 4 suits fp32 ones.
+    shuffle_element_size: int = 0
+
+    # Segments smaller than this are stored uncompressed.
+    min_segment_size: int = 4096
+
+    # Segments that do not compress to at most this fraction of their size are
+    # stored uncompressed, since decompressing them would not save any I/O.
+    max_compression_ratio: float = 0.9
+
+    def __post_init__(self) -> None:
+        if self.chunk_size <= 0:
+            raise ValueError(f"chunk_size {self.chunk_size} must be positive")
+        if not 0 <= self.shuffle_element_size <= 255:
+            raise ValueError(
+                f"shuffle_element_size {self.shuffle_element_size} must fit in a byte"
+            )
+
+
+# The LZ4 block format requires the last 5 bytes of a block to be literals, and
+# the last match to start at least 12 bytes before the end of the block.
+_LZ4_LAST_LITERALS = 5
+_LZ4_MATCH_FIND_LIMIT = 12
+_LZ4_MIN_MATCH = 4
+_LZ4_MAX_OFFSET = 65535
+
+
+def _lz4_write_length(out: bytearray, length: int) -> None:
+    """Writes the extra length bytes of a token field that is saturated at 15."""
+    length -= 15
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _lz4_write_sequence(
+    out: bytearray, literals: bytes, offset: int, match_length: int
+) -> None:
+    """Writes literals and, if match_length is not zero, the match after them."""
+    literal_token = min(len(literals), 15)
+    match_token = 0 if match_length == 0 else min(match_length - _LZ4_MIN_MATCH, 15)
+    out.append((literal_token << 4) | match_token)
+    if literal_token == 15:
+        _lz4_write_length(out, len(literals))
+    out += literals
+    if match_length == 0:
+        return
+    out += offset.to_bytes(2, byteorder="little")
+    if match_token == 15:
+        _lz4_write_length(out, match_length - _LZ4_MIN_MATCH)
+
+
+def _lz4_compress_python(data: bytes) -> bytes:
+    """Greedy LZ4 block encoder that matches the first 4-byte repetition."""
+    out = bytearray()
+    size = len(data)
+    match_end_limit = size - _LZ4_LAST_LITERALS
+    last_match_start = size - _LZ4_MATCH_FIND_LIMIT
+    last_positions = {}
+    anchor = 0
+    pos = 0
+    misses = 0
+    while pos <= last_match_start:
+        key = data[pos : pos + _LZ4_MIN_MATCH]
+        candidate = last_positions.get(key)
+        last_positions[key] = pos
+        if candidate is None or pos - candidate > _LZ4_MAX_OFFSET:
+            # Like the reference encoder, skip faster through data that does
+            # not compress.
+            pos += 1 + (misses >> 6)
+            misses += 1
+            continue
+        misses = 0
+        match_length = _LZ4_MIN_MATCH
+        while (
+            pos + match_length < match_end_limit
+            and data[candidate + match_length] == data[pos + match_length]
+        ):
+            match_length += 1
+        _lz4_write_sequence(out, data[anchor:pos], pos - candidate, match_length)
+        pos += match_length
+        anchor = pos
+    _lz4_write_sequence(out, data[anchor:], offset=0, match_length=0)
+    return bytes(out)
+
+
+def lz4_compress_block(data: bytes) -> bytes:
+    """Returns data compressed in the LZ4 block format."""
+    if _lz4_block is not None:
+        return _lz4_block.compress(data, store_size=False)
+    return _lz4_compress_python(data)
+
+
+def _lz4_read_length(data: bytes, pos: int, length: int) -> Tuple[int, int]:
+    """Reads the extra length bytes of a saturated token field."""
+    while True:
+        if pos >= len(data):
+            raise ValueError("Truncated LZ4 block")
+        byte = data[pos]
+        pos += 1
+        length += byte
+        if byte != 255:
+            return length, pos
+
+
+def lz4_decompress_block(data: bytes, uncompressed_size: int) -> bytes:
+    """Returns the data of an LZ4 block that decompresses to uncompressed_size."""
+    out = bytearray()
+    pos = 0
+    while True:
+        if pos >= len(data):
+            raise ValueError("Truncated LZ4 block")
+        token = data[pos]
+        pos += 1
+        literal_length = token >> 4
+        if literal_length == 15:
+            literal_length, pos = _lz4_read_length(data, pos, literal_length)
+        if pos + literal_length > len(data):
+            raise ValueError("Truncated LZ4 block")
+        out += data[pos : pos + literal_length]
+        pos += literal_length
+        if pos == len(data):
+            break
+        if pos + 2 > len(data):
+            raise ValueError("Truncated LZ4 block")
+        offset = int.from_bytes(data[pos : pos + 2], byteorder="little")
+        pos += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError(f"Invalid LZ4 match offset {offset}")
+        match_length = token & 15
+        if match_length == 15:
+            match_length, pos = _lz4_read_length(data, pos, match_length)
+        match_length += _LZ4_MIN_MATCH
+        start = len(out) - offset
+        for i in range(match_length):
+            out.append(out[start + i])
+    if len(out) != uncompressed_size:
+        raise ValueError(
+            f"LZ4 block decompressed to {len(out)} bytes, expected {uncompressed_size}"
+        )
+    return bytes(out)
+
+
+def shuffle_bytes(data: bytes, element_size: int) -> bytes:
+    """Groups the bytes of data by their position in elements of element_size.
+
+    Bytes after the last whole element are kept at the end, unshuffled.
+    """
+    if element_size <= 1:
+        return data
+    num_elements = len(data) // element_size
+    whole = num_elements * element_size
+    return (
+        b"".join(data[i:whole:element_size] for i in range(element_size))
+        + data[whole:]
+    )
+
+
+def unshuffle_bytes(data: bytes, element_size: int) -> bytes:
+    """Reverses shuffle_bytes()."""
+    if element_size <= 1:
+        return data
+    num_elements = len(data) // element_size
+    whole = num_elements * element_size
+    out = bytearray(len(data))
+    for i in range(element_size):
+        out[i:whole:element_size] = data[i * num_elements : (i + 1) * num_elements]
+    out[whole:] = data[whole:]
+    return bytes(out)
+
+
+def compress_segment(
+    data: bytes, config: SegmentCompressionConfig
+) -> Optional[Tuple[bytes, SegmentCompression]]:
+    """Compresses the data of a segment.
+
+    Returns:
+        The compressed data and its description, or None if the segment should
+        be stored uncompressed according to config.
+    """
+    if len(data) < config.min_segment_size:
+        return None
+    chunks: List[bytes] = []
+    for start in range(0, len(data), config.chunk_size):
+        chunk = shuffle_bytes(
+            data[start : start + config.chunk_size], config.shuffle_element_size
+        )
+        chunks.append(lz4_compress_block(chunk))
+    compressed = b"".join(chunks)
+    if len(compressed) > len(data) * config.max_compression_ratio:
+        return None
+    return compressed, SegmentCompression(
+        algorithm=CompressionAlgorithm.LZ4,
+        uncompressed_size=len(data),
+        chunk_size=config.chunk_size,
+        chunk_compressed_sizes=[len(chunk) for chunk in chunks],
+        shuffle_element_size=config.shuffle_element_size,
+    )
+
+
+def decompress_segment(data: bytes, compression: SegmentCompression) -> bytes:
+    """Returns the uncompressed data of a compressed segment."""
+    if compression.algorithm != CompressionAlgorithm.LZ4:
+        raise ValueError(f"Unsupported compression {compression.algorithm}")
+    chunks: List[bytes] = []
+    pos = 0
+    for i, compressed_size in enumerate(compression.chunk_compressed_sizes):
+        chunk_size = min(
+            compression.chunk_size,
+            compression.uncompressed_size - i * compression.chunk_size,
+        )
+        chunk = lz4_decompress_block(data[pos : pos + compressed_size], chunk_size)
+        chunks.append(unshuffle_bytes(chunk, compression.shuffle_element_size))
+        pos += compressed_size
+    out = b"".join(chunks)
+    if len(out) != compression.uncompressed_size:
+        raise ValueError(
+            f"Segment decompressed to {len(out)} bytes, expected "
+            f"{compression.uncompressed_size}"
+        )
+    return out
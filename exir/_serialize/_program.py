@@ -14,6 +14,11 @@ import re
 from dataclasses import dataclass
 from typing import ClassVar, Dict, List, Literal, Optional, Tuple
 
+from executorch.exir._serialize._compression import (
+    compress_segment,
+    decompress_segment,
+    SegmentCompressionConfig,
+)
 from executorch.exir._serialize._cord import Cord
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 from executorch.exir._serialize._flatbuffer import (
@@ -36,6 +41,7 @@ from executorch.exir.schema import (
     DataSegment,
     NamedData,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
 )
 from executorch.exir.tensor import ALIGNMENT
@@ -59,10 +65,12 @@ class AlignedData:
 
     data: Cord
     alignment: int
+    compression: Optional[SegmentCompression]
 
     def __init__(self, data: Cord, alignment: Optional[int] = None) -> None:
         self.data = data
         self.alignment = alignment or 1
+        self.compression = None
 
 
 def _program_to_json(program: Program) -> str:
@@ -375,9 +383,30 @@ def _extract_named_data(
                 )
             )
         named_data.append(NamedData(key=name, segment_index=segment_index))
+    # Sorted keys let the runtime binary search them. Python orders str by code
+    # point, which matches the byte order of their UTF-8 encoding.
+    named_data.sort(key=lambda entry: entry.key)
     program.named_data = named_data
 
 
+# The runtime decompresses segments into buffers with this alignment, so
+# segments whose data needs a larger alignment are never compressed. Keep in
+# sync with kCompressedSegmentAlignment in runtime/executor/segment_compression.h.
+_COMPRESSED_SEGMENT_ALIGNMENT: int = 64
+
+
+def _compress_aligned_data(
+    segment: AlignedData, config: SegmentCompressionConfig, alignment: int
+) -> None:
+    """Compresses the data of segment in-place if config says it is worth it."""
+    if alignment > _COMPRESSED_SEGMENT_ALIGNMENT:
+        return
+    compressed = compress_segment(bytes(segment.data), config)
+    if compressed is not None:
+        segment.data = Cord(compressed[0])
+        segment.compression = compressed[1]
+
+
 def serialize_pte_binary(
     program: Program,
     *,
@@ -387,6 +416,7 @@ def serialize_pte_binary(
     constant_tensor_alignment: Optional[int] = None,
     delegate_alignment: Optional[int] = None,
     named_data: Optional[NamedDataStoreOutput] = None,
+    segment_compression: Optional[SegmentCompressionConfig] = None,
 ) -> Cord:
     """Returns the runtime binary representation of the given Program.
 
@@ -408,6 +438,9 @@ def serialize_pte_binary(
             value in the schema file.
         named_data: If provided, named blobs to be stored in segments
             after the PTE file.
+        segment_compression: If provided, how to compress the constant,
+            mutable and named data segments. Delegate segments are never
+            compressed.
     Returns:
         The serialized form of the Program, ready for execution by the runtime.
     """
@@ -457,11 +490,26 @@ def serialize_pte_binary(
             # Add to the aggregate segments cord.
             segments.append(AlignedData(mutable_segment_data))
 
+    # Delegates may expect to access their segments directly in the file, e.g.
+    # with mmap(), so only the segments of weights before and after them are
+    # candidates for compression.
+    num_weight_segments = len(segments)
     if extract_delegate_segments:
         _extract_delegate_segments(program, segments)
+    num_delegate_segments = len(segments) - num_weight_segments
     if named_data is not None:
         _extract_named_data(program, segments, named_data.buffers, named_data.pte_data)
 
+    if segment_compression is not None:
+        for i, segment in enumerate(segments):
+            if num_weight_segments <= i < num_weight_segments + num_delegate_segments:
+                continue
+            _compress_aligned_data(
+                segment,
+                segment_compression,
+                max(segment.alignment, constant_tensor_alignment),
+            )
+
     # Append all segments into a single Cord, adding any necessary padding to ensure that
     # each segment begins at the required alignment.
     # Update program.segments with the offsets to each segment.
@@ -475,7 +523,9 @@ def serialize_pte_binary(
         alignment = math.lcm(segment_alignment, segment.alignment)
         program.segments.append(
             DataSegment(
-                offset=aligned_size(prev_end, alignment), size=len(segment.data)
+                offset=aligned_size(prev_end, alignment),
+                size=len(segment.data),
+                compression=segment.compression,
             )
         )
         # Add to aggregate segments cord with padding.
@@ -572,7 +622,10 @@ def _restore_segments(program: Program, segment_data: bytes) -> Program:
             raise ValueError(
                 f"Segment {i} {segment} overflows data length {len(segment_data)}"
             )
-        segments.append(segment_data[segment.offset : segment.offset + segment.size])
+        data = segment_data[segment.offset : segment.offset + segment.size]
+        if segment.compression is not None:
+            data = decompress_segment(data, segment.compression)
+        segments.append(data)
 
     # Find and replace the Program's references to these segments, inlining the
     # data.
@@ -54,6 +54,7 @@ def serialize_for_executorch(
         constant_tensor_alignment=config.constant_tensor_alignment,
         delegate_alignment=config.delegate_alignment,
         named_data=pte_named_data,
+        segment_compression=config.segment_compression,
     )
 
     # Serialize PTD files.
@@ -0,0 +1,101 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import random
+import struct
+import unittest
+
+from executorch.exir._serialize._compression import (
+    _lz4_compress_python,
+    compress_segment,
+    decompress_segment,
+    lz4_decompress_block,
+    SegmentCompressionConfig,
+    shuffle_bytes,
+    unshuffle_bytes,
+)
+from executorch.exir.schema import CompressionAlgorithm
+
+
+def _fp16_weights(count: int) -> bytes:
+    """Returns fp16 weights with few distinct values, like dequantized ones."""
+    rng = random.Random(0)
+    return b"".join(
+        struct.pack("<e", round(rng.gauss(0, 3)) / 64) for _ in range(count)
+    )
+
+
+class TestCompression(unittest.TestCase):
+    def test_lz4_round_trip(self) -> None:
+        rng = random.Random(0)
+        for data in (
+            b"",
+            b"a",
+            b"abcdefghijklmnop",
+            b"ab" * 1000,
+            bytes(rng.randrange(256) for _ in range(3000)),
+            b"x" * 300 + bytes(range(256)) * 20 + b"y" * 70000,
+        ):
+            compressed = _lz4_compress_python(data)
+            self.assertEqual(lz4_decompress_block(compressed, len(data)), data)
+
+    def test_lz4_compresses_repetitions(self) -> None:
+        data = b"0123456789" * 1000
+        compressed = _lz4_compress_python(data)
+        self.assertLess(len(compressed), len(data) // 20)
+        # The end of block rules: the last 5 bytes are literals of the final
+        # sequence, which has no match.
+        self.assertEqual(compressed[-5:], data[-5:])
+
+    def test_lz4_rejects_malformed_blocks(self) -> None:
+        compressed = _lz4_compress_python(b"0123456789" * 10)
+        with self.assertRaises(ValueError):
+            lz4_decompress_block(compressed[:-3], 100)
+        with self.assertRaises(ValueError):
+            lz4_decompress_block(compressed, 99)
+        # A match pointing before the start of the output.
+        with self.assertRaises(ValueError):
+            lz4_decompress_block(b"\x10a\x05\x00\x00", 6)
+
+    def test_shuffle_round_trip(self) -> None:
+        data = bytes(range(11))
+        shuffled = shuffle_bytes(data, 4)
+        self.assertEqual(shuffled, bytes([0, 4, 1, 5, 2, 6, 3, 7, 8, 9, 10]))
+        self.assertEqual(unshuffle_bytes(shuffled, 4), data)
+        self.assertEqual(shuffle_bytes(data, 1), data)
+
+    def test_compress_segment_chunks(self) -> None:
+        data = _fp16_weights(10000)
+        config = SegmentCompressionConfig(chunk_size=4096, shuffle_element_size=2)
+        result = compress_segment(data, config)
+        assert result is not None
+        compressed, compression = result
+        self.assertEqual(compression.algorithm, CompressionAlgorithm.LZ4)
+        self.assertEqual(compression.uncompressed_size, len(data))
+        self.assertEqual(compression.chunk_size, 4096)
+        self.assertEqual(len(compression.chunk_compressed_sizes), 5)
+        self.assertEqual(sum(compression.chunk_compressed_sizes), len(compressed))
+        self.assertEqual(decompress_segment(compressed, compression), data)
+
+    def test_shuffle_improves_fp16_compression(self) -> None:
+        data = _fp16_weights(10000)
+        shuffled = compress_segment(
+            data, SegmentCompressionConfig(shuffle_element_size=2)
+        )
+        assert shuffled is not None
+        unshuffled = compress_segment(
+            data, SegmentCompressionConfig(max_compression_ratio=1.1)
+        )
+        assert unshuffled is not None
+        self.assertLess(len(shuffled[0]), len(unshuffled[0]))
+
+    def test_compress_segment_skips_incompressible_data(self) -> None:
+        rng = random.Random(0)
+        data = bytes(rng.randrange(256) for _ in range(10000))
+        self.assertIsNone(compress_segment(data, SegmentCompressionConfig()))
+        self.assertIsNone(compress_segment(b"0" * 100, SegmentCompressionConfig()))
@@ -13,8 +13,9 @@ import json
 import math
 import unittest
 
-from typing import List, Sequence
+from typing import List, Optional, Sequence
 
+from executorch.exir._serialize._compression import SegmentCompressionConfig
 from executorch.exir._serialize._flatbuffer import _program_flatbuffer_to_json
 from executorch.exir._serialize._named_data_store import (
     BufferEntry,
@@ -622,6 +623,54 @@ class TestProgram(unittest.TestCase):
         self.assertEqual(len(flatbuffer_program.constant_segment.offsets), 1)
         self.assertEqual(flatbuffer_program.constant_segment.offsets[0], 0)
 
+    def test_round_trip_with_compressed_segments(self) -> None:
+        program = get_test_program()
+        add_constant_data(
+            program,
+            [b"", b"\x01\x02\x03\x04" * 2048, self.gen_blob_data(100, b"\x05\x06\x07")],
+        )
+        add_delegate_data(program, program.execution_plan[0], [b"\x06\x07" * 4096])
+
+        def serialize(compression: Optional[SegmentCompressionConfig]) -> bytes:
+            return bytes(
+                serialize_pte_binary(
+                    program,
+                    extract_delegate_segments=True,
+                    segment_alignment=SEGMENT_ALIGNMENT,
+                    constant_tensor_alignment=CONSTANT_TENSOR_ALIGNMENT,
+                    segment_compression=compression,
+                )
+            )
+
+        pte_data = serialize(SegmentCompressionConfig(chunk_size=1024))
+        uncompressed_pte_data = serialize(None)
+        self.assertLess(len(pte_data), len(uncompressed_pte_data))
+
+        # Only the constant segment is compressed; delegate data is not.
+        flatbuffer_program = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        self.assertEqual(len(flatbuffer_program.segments), 2)
+        constant_segment = flatbuffer_program.segments[
+            flatbuffer_program.constant_segment.segment_index
+        ]
+        compression = constant_segment.compression
+        self.assertIsNotNone(compression)
+        self.assertEqual(compression.chunk_size, 1024)
+        self.assertEqual(sum(compression.chunk_compressed_sizes), constant_segment.size)
+        self.assertEqual(
+            len(compression.chunk_compressed_sizes),
+            math.ceil(compression.uncompressed_size / 1024),
+        )
+        delegate_segment = flatbuffer_program.segments[
+            flatbuffer_program.execution_plan[0].delegates[0].processed.index
+        ]
+        self.assertIsNone(delegate_segment.compression)
+
+        # Deserializing decompresses the segments.
+        self.assert_programs_equal(
+            deserialize_pte_binary(pte_data),
+            deserialize_pte_binary(uncompressed_pte_data),
+        )
+
     def test_unused_inline_delegate_blobs_with_segments(self) -> None:
         # Create a program with some delegate data blobs.
         program = get_test_program()
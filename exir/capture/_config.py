@@ -10,6 +10,7 @@ from typing import Dict, List, Optional, Union
 
 import torch
 
+from executorch.exir._serialize._compression import SegmentCompressionConfig
 from executorch.exir.dynamic_shape import DynamicMemoryPlanningMode
 from executorch.exir.pass_manager import PassType
 from executorch.exir.passes import MemoryPlanningPass, ToOutVarPass
@@ -97,3 +98,21 @@ class ExecutorchBackendConfig:
     # If set to true, all trainable weights will be stored in a separate file,
     # external to the PTE file.
     external_mutable_weights: bool = False
+
+    # If provided, the constant, mutable and named data segments of the PTE
+    # file, and the data segments of PTD files, are compressed as configured.
+    # Compressed files are smaller and faster to read from slow storage, at the
+    # cost of decompressing them when loading.
+    segment_compression: Optional[SegmentCompressionConfig] = None
+
+    # If provided, the data of each tensor in PTD files starts at a file offset
+    # that is a multiple of this value, e.g. the OS page size, so that
+    # MmapDataLoader maps each tensor onto pages of its own. Must be a power of
+    # 2. Only affects programs with external_constants or
+    # external_mutable_weights.
+    external_data_page_alignment: Optional[int] = None
+
+    # If set to true, the data of the tensors of each layer is placed together
+    # in PTD files, in the order in which the layers first appear, so that
+    # loading the layers in order reads the file sequentially.
+    group_external_data_by_layer: bool = False
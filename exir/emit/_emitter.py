@@ -456,7 +456,10 @@ class _Emitter(torch.fx.Interpreter):
 
             hashed = hashlib.sha256(buffer_data).hexdigest()
 
-            if allocation_info and spec.extra_tensor_info is None:
+            if allocation_info and (
+                spec.extra_tensor_info is None
+                or spec.extra_tensor_info.location != TensorDataLocation.EXTERNAL
+            ):
                 buffer_idx = self.program_state.cached_spec_mutable_hash_values.get(
                     hashed, -1
                 )
@@ -1262,8 +1265,23 @@ class _Emitter(torch.fx.Interpreter):
         for elem in pytree.tree_flatten(out_args)[0]:
             kernel_args.append(cast(_AbstractValue, elem).id)
 
+        # Scratch memory that the memory planner reserved for the kernel.
+        scratch_spec = self.node.meta.get("scratch_spec")
         self.chain.instructions.append(
-            Instruction(KernelCall(op_index=op_index, args=kernel_args))
+            Instruction(
+                KernelCall(
+                    op_index=op_index,
+                    args=kernel_args,
+                    scratch=(
+                        self._get_allocation_info(scratch_spec)
+                        if scratch_spec is not None
+                        else None
+                    ),
+                    scratch_size=(
+                        scratch_spec.nbytes() if scratch_spec is not None else 0
+                    ),
+                )
+            )
         )
         self._add_debug_handle(len(self.chain.instructions) - 1, target)
 
@@ -1639,6 +1657,13 @@ class _TopLevelEmitter(_Emitter):
                 else:
                     spec.extra_tensor_info.fully_qualified_name = fqn
                     spec.extra_tensor_info.location = TensorDataLocation.EXTERNAL
+            # Name mutable buffers so that the runtime can share them between
+            # methods, like a KV cache used by both prefill and decode.
+            elif is_mutable_buffer and fqn is not None:
+                if spec.extra_tensor_info is None:
+                    spec.extra_tensor_info = ExtraTensorInfo(fully_qualified_name=fqn)
+                else:
+                    spec.extra_tensor_info.fully_qualified_name = fqn
 
             # From the fqn find the corresponding tensor
             real_tensor = None
@@ -1605,6 +1605,13 @@ class TestEmit(unittest.TestCase):
             model.executorch_program.execution_plan[0].values[0].val.allocation_info
             is not None
         )
+        # The buffer is named so that methods can share it at runtime.
+        self.assertEqual(
+            model.executorch_program.execution_plan[0]
+            .values[0]
+            .val.extra_tensor_info.fully_qualified_name,
+            "state",
+        )
         executorch_module = _load_for_executorch_from_buffer(model.buffer)
         self.assertEqual(executorch_module(torch.zeros(1))[0], torch.zeros(1))
         self.assertEqual(executorch_module(torch.zeros(1))[0], torch.zeros(1) + 1)
@@ -379,6 +379,7 @@ def collect_specs_from_nodes(  # noqa: C901
     dedup: bool = True,
     do_assertion: bool = True,
     ignore_dynamic_unbound_tensor: bool = True,
+    ignore_kernel_scratch: bool = False,
 ) -> Iterable[TensorSpec]:
     r"""
     Collect specs from the passed in nodes. Do filtering as controlled by
@@ -389,6 +390,7 @@ def collect_specs_from_nodes(  # noqa: C901
         ignore_out_var_node: whether to ignore out variant node
         dedup: whether do dedup
         do_assertion: whether to assert the filtered nodes belong to a resticted set like alloc, getitem
+        ignore_kernel_scratch: whether to ignore the scratch memory of out-var nodes
     """
     unique_spec = set()
     graph_input_tensors: Set[TensorSpec] = (
@@ -403,6 +405,14 @@ def collect_specs_from_nodes(  # noqa: C901
         if node.op in ["get_attr"]:
             continue
 
+        # The kernel's scratch memory belongs to the node itself, unlike its
+        # out tensors which are planned through their alloc nodes.
+        scratch_spec = node.meta.get("scratch_spec")
+        if not ignore_kernel_scratch and scratch_spec is not None:
+            if not dedup or scratch_spec not in unique_spec:
+                unique_spec.add(scratch_spec)
+                yield scratch_spec
+
         # don't reallocate memory for out-variant op's output tensors,
         # since they are just input tenors.
         if ignore_out_var_node and _is_out_var_node(node):
@@ -479,9 +489,14 @@ def update_all_tensors_lifetime(
             dedup=False,
             do_assertion=False,
             ignore_dynamic_unbound_tensor=False,
+            ignore_kernel_scratch=True,
         ):
             update_tensor_lifetime(node, spec, node_idx)
             specs.add(spec)
+        # Scratch memory only lives while its node runs.
+        if (scratch_spec := node.meta.get("scratch_spec")) is not None:
+            update_tensor_lifetime(node, scratch_spec, node_idx)
+            specs.add(scratch_spec)
     return specs
 
 
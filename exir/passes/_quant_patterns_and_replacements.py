@@ -468,6 +468,73 @@ quantized_decomposed_lib.define(
     "mixed_linear(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, ScalarType? dtype=None) -> Tensor",
 )
 
+quantized_decomposed_lib.define(
+    "linear_8da4w(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "int group_size) -> Tensor",
+)
+
+quantized_decomposed_lib.define(
+    "linear_8da4w.out(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "int group_size, *, Tensor(a!) out) -> Tensor(a!)",
+)
+
+
+@impl(quantized_decomposed_lib, "linear_8da4w", "CompositeExplicitAutograd")
+def linear_8da4w(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    group_size: int,
+) -> torch.Tensor:
+    """
+    Linear with int8 per-token dynamically quantized activations and groupwise
+    int4 weights. weight is either int8 with values in [-8, 7], or uint8 with
+    two values per byte, packed like embedding_4bit.
+    """
+    if weight.dtype == torch.uint8:
+        weight_even = weight.div(16, rounding_mode="trunc")
+        weight_odd = weight.remainder(16)
+        weight_unpacked = torch.stack((weight_even, weight_odd), dim=-1)
+        weight = weight_unpacked.view(weight.shape[0], -1)
+        weight = weight.view(torch.int8).add(-8)
+
+    scales, zero_points = (
+        torch.ops.quantized_decomposed.choose_qparams_per_token_asymmetric.default(
+            input, torch.int8
+        )
+    )
+    input = torch.ops.quantized_decomposed.quantize_per_token.default(
+        input, scales, zero_points, -128, 127, torch.int8
+    )
+    input = torch.ops.quantized_decomposed.dequantize_per_token.default(
+        input, scales, zero_points, -128, 127, torch.int8, weight_scales.dtype
+    )
+    weight = torch.ops.quantized_decomposed.dequantize_per_channel_group.default(
+        weight,
+        weight_scales,
+        weight_zero_points,
+        -8,
+        7,
+        torch.int8,
+        group_size,
+        weight_scales.dtype,
+    )
+    return torch.ops.aten.linear.default(input, weight)
+
+
+@register_fake("quantized_decomposed::linear_8da4w.out")
+def linear_8da4w_out_meta(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    group_size: int,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    return linear_8da4w(input, weight, weight_scales, weight_zero_points, group_size)
+
+
 quantized_decomposed_lib.define(
     "add(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
 )
@@ -1129,6 +1196,67 @@ def _get_embedding_ops_patterns_and_replacements() -> (
     return patterns_and_replacements
 
 
+def _get_linear_8da4w_patterns_and_replacements() -> (
+    List[Tuple[Callable, Callable, List[Callable]]]
+):
+    # Matches the 8da4w linear of torchao's Int8DynActInt4WeightQuantizer once
+    # ConvertToLinearPass has turned the decomposed linear back into
+    # aten.linear.
+    @bind_pattern_to_op(quantized_decomposed_lib, "linear_8da4w")
+    def pattern(
+        input,
+        weight,
+        weight_scales,
+        weight_zero_points,
+        group_size,
+    ):
+        qparams = (
+            torch.ops.quantized_decomposed.choose_qparams_per_token_asymmetric.default(
+                input, torch.int8
+            )
+        )
+        input = torch.ops.quantized_decomposed.quantize_per_token.default(
+            input, qparams[0], qparams[1], -128, 127, torch.int8
+        )
+        input = torch.ops.quantized_decomposed.dequantize_per_token.default(
+            input, qparams[0], qparams[1], -128, 127, torch.int8, torch.float32
+        )
+        weight = torch.ops.quantized_decomposed.dequantize_per_channel_group.default(
+            weight,
+            weight_scales,
+            weight_zero_points,
+            -8,
+            7,
+            torch.int8,
+            group_size,
+            torch.float32,
+        )
+        return torch.ops.aten.linear.default(input, weight)
+
+    def replacement(
+        input,
+        weight,
+        weight_scales,
+        weight_zero_points,
+        group_size,
+    ):
+        return torch.ops.quantized_decomposed.linear_8da4w.default(
+            input,
+            weight,
+            weight_scales,
+            weight_zero_points,
+            group_size,
+        )
+
+    return [
+        (
+            _trace_and_lower_to_edge_ops(pattern),
+            _trace_and_lower_to_edge_ops(replacement),
+            [],
+        ),
+    ]
+
+
 """
 def _get_fixed_qparams_ops_patterns_and_replacements() -> List[Tuple[Callable, Callable, List[Callable]]]:
     fixed_qparams_op_to_qop = {
@@ -1167,5 +1295,6 @@ def get_quant_patterns_and_replacements() -> (
             *_get_slice_patterns_and_replacements(),
             # *_get_fixed_qparams_ops_patterns_and_replacements(),
             *_get_embedding_ops_patterns_and_replacements(),
+            *_get_linear_8da4w_patterns_and_replacements(),
         ]
     )
@@ -0,0 +1,262 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+import copy
+from typing import Dict, List, Sequence, Set, Tuple
+
+import torch
+from torch.export import ExportedProgram
+from torch.export.exported_program import OutputKind
+
+# Name of the constant method that lists the checkpointed variants of a joint
+# graph method. TrainingModule picks one of them to fit its memory budget.
+CHECKPOINTED_METHODS_PREFIX = "__et_training_checkpointed_methods_"
+
+# Ops that are only recomputed when recomputing the cheaper ones isn't enough
+# to fit the budget.
+_COMPUTE_INTENSIVE_OPS = {
+    "_convolution",
+    "_scaled_dot_product_flash_attention",
+    "addmm",
+    "baddbmm",
+    "bmm",
+    "convolution",
+    "linear",
+    "matmul",
+    "mm",
+    "scaled_dot_product_attention",
+}
+
+_GRADIENT_OUTPUT_KINDS = (
+    OutputKind.GRADIENT_TO_PARAMETER,
+    OutputKind.GRADIENT_TO_USER_INPUT,
+)
+
+
+def _aten_op(target):
+    # Edge ops wrap the ATen op they were created from.
+    return getattr(target, "_op", target)
+
+
+def _nbytes(node: torch.fx.Node) -> int:
+    val = node.meta.get("val")
+    if not isinstance(val, torch.Tensor):
+        return 0
+    try:
+        return int(val.numel()) * val.element_size()
+    except (TypeError, RuntimeError):
+        # Dynamic shapes without a hint.
+        return 0
+
+
+def _is_recomputable(node: torch.fx.Node) -> bool:
+    if node.op != "call_function" or _nbytes(node) == 0:
+        return False
+    op = _aten_op(node.target)
+    if not isinstance(op, torch._ops.OpOverload):
+        return False
+    # Recomputing a random op would give a different value, and recomputing a
+    # mutating one would apply it twice.
+    return (
+        not op._schema.is_mutable
+        and torch.Tag.nondeterministic_seeded not in op.tags
+    )
+
+
+def _is_compute_intensive(node: torch.fx.Node) -> bool:
+    return _aten_op(node.target).__name__.split(".")[0] in _COMPUTE_INTENSIVE_OPS
+
+
+def _split_joint_graph(
+    exported_program: ExportedProgram,
+) -> Tuple[Set[torch.fx.Node], Set[torch.fx.Node]]:
+    """
+    Splits the nodes of a joint graph into the forward ones, that compute the
+    outputs other than gradients, and the backward ones, that only compute the
+    gradients.
+    """
+    graph = exported_program.graph_module.graph
+    output_node = next(n for n in graph.nodes if n.op == "output")
+    forward_roots = [
+        node
+        for node, spec in zip(
+            output_node.args[0], exported_program.graph_signature.output_specs
+        )
+        if spec.kind not in _GRADIENT_OUTPUT_KINDS and isinstance(node, torch.fx.Node)
+    ]
+    forward: Set[torch.fx.Node] = set()
+    stack = list(forward_roots)
+    while stack:
+        node = stack.pop()
+        if node in forward:
+            continue
+        forward.add(node)
+        stack.extend(node.all_input_nodes)
+    backward = {
+        node
+        for node in graph.nodes
+        if node.op == "call_function" and node not in forward
+    }
+    return forward, backward
+
+
+def _saved_activations(
+    forward: Set[torch.fx.Node], backward: Set[torch.fx.Node]
+) -> Set[torch.fx.Node]:
+    return {
+        node
+        for node in forward
+        if node.op == "call_function" and any(u in backward for u in node.users)
+    }
+
+
+def saved_activation_bytes(exported_program: ExportedProgram) -> int:
+    """
+    Returns the number of bytes of activations that the forward pass of a joint
+    graph keeps alive for the backward pass.
+    """
+    forward, backward = _split_joint_graph(exported_program)
+    return sum(_nbytes(node) for node in _saved_activations(forward, backward))
+
+
+def activation_checkpointing_pass(
+    exported_program: ExportedProgram,
+    memory_budget: float,
+) -> ExportedProgram:
+    """
+    This pass is for joint graphs, like those from _export_forward_backward. It
+    recomputes activations in the backward pass instead of keeping them alive
+    from the forward pass, until the saved activations are at most
+    `memory_budget` times what they were. Memory planning then reuses their
+    memory in the rest of the forward pass.
+
+    Cheap ops, like pointwise ones and views, are recomputed first, along
+    with the chains of ops that lead to them. Matmuls, convolutions and
+    attention are only recomputed when that isn't enough. Random and mutating
+    ops are never recomputed. The budget is a best effort: activations that
+    can't be recomputed stay saved.
+
+    Args:
+        exported_program: The joint graph ExportedProgram to update.
+        memory_budget: The fraction of the saved activations to keep, between 0
+            and 1. 1 leaves the graph unchanged.
+
+    Returns:
+        The modified ExportedProgram.
+    """
+    if not 0 <= memory_budget <= 1:
+        raise ValueError(f"memory_budget must be in [0, 1], got {memory_budget}")
+
+    forward, backward = _split_joint_graph(exported_program)
+    saved = _saved_activations(forward, backward)
+    saved_bytes = sum(_nbytes(node) for node in saved)
+    budget_bytes = memory_budget * saved_bytes
+    if saved_bytes <= budget_bytes:
+        return exported_program
+
+    # Greedily pick the saved activations to recompute. Recomputing one frees
+    # it, but keeps alive the inputs it is recomputed from, unless they are
+    # recomputed too.
+    recomputed: Set[torch.fx.Node] = set()
+    for allow_compute_intensive in (False, True):
+        changed = True
+        while changed and saved_bytes > budget_bytes:
+            changed = False
+            candidates = sorted(
+                (
+                    node
+                    for node in saved
+                    if _is_recomputable(node)
+                    and (allow_compute_intensive or not _is_compute_intensive(node))
+                ),
+                key=lambda node: (-_nbytes(node), node.name),
+            )
+            for node in candidates:
+                added = [
+                    arg
+                    for arg in node.all_input_nodes
+                    if arg.op == "call_function"
+                    and arg not in recomputed
+                    and arg not in saved
+                ]
+                delta = sum(_nbytes(arg) for arg in added) - _nbytes(node)
+                # Moving the boundary without saving anything is still worth it
+                # for cheap ops, since their inputs may be recomputed next.
+                if delta > 0 or (delta == 0 and _is_compute_intensive(node)):
+                    continue
+                recomputed.add(node)
+                saved.remove(node)
+                saved.update(added)
+                saved_bytes += delta
+                changed = True
+                if saved_bytes <= budget_bytes:
+                    break
+
+    if not recomputed:
+        return exported_program
+
+    graph = exported_program.graph_module.graph
+    clones: Dict[torch.fx.Node, torch.fx.Node] = {}
+
+    def recompute(node: torch.fx.Node, before: torch.fx.Node) -> torch.fx.Node:
+        if node not in clones:
+            for arg in node.all_input_nodes:
+                if arg in recomputed:
+                    recompute(arg, before)
+            with graph.inserting_before(before):
+                clone = graph.node_copy(node, lambda arg: clones.get(arg, arg))
+            clone.meta["recomputed"] = True
+            clones[node] = clone
+        return clones[node]
+
+    # Recompute each activation right before the first backward node that uses
+    # it, so it is only alive during the backward pass.
+    for node in list(graph.nodes):
+        if node not in backward:
+            continue
+        for arg in [arg for arg in node.all_input_nodes if arg in recomputed]:
+            node.replace_input_with(arg, recompute(arg, node))
+
+    exported_program.graph.eliminate_dead_code()
+    exported_program.graph_module.recompile()
+
+    return exported_program
+
+
+def activation_checkpointing_plans(
+    method_name: str,
+    exported_program: ExportedProgram,
+    memory_budgets: Sequence[float],
+) -> Tuple[Dict[str, ExportedProgram], Dict[str, List[str]]]:
+    """
+    Makes a checkpointed variant of the joint graph method `method_name` for
+    each of `memory_budgets`, so that the runtime can pick the one that fits the
+    memory it has. TrainingModule::set_memory_budget() selects them.
+
+    Args:
+        method_name: The name of the joint graph method.
+        exported_program: The joint graph ExportedProgram of the method, which
+            is left unchanged.
+        memory_budgets: The memory_budget of each variant, as passed to
+            activation_checkpointing_pass().
+
+    Returns:
+        The methods, including the original one, and the constant methods that
+        list the variants, to pass to to_edge().
+    """
+    methods = {method_name: exported_program}
+    for i, memory_budget in enumerate(memory_budgets):
+        methods[f"{method_name}__checkpointed_{i}"] = activation_checkpointing_pass(
+            copy.deepcopy(exported_program), memory_budget
+        )
+    constant_methods = {
+        CHECKPOINTED_METHODS_PREFIX + method_name: [
+            name for name in methods if name != method_name
+        ]
+    }
+    return methods, constant_methods
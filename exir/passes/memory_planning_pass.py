@@ -7,7 +7,7 @@
 import logging
 import warnings
 from functools import partial
-from typing import Any, Callable, List, Optional
+from typing import Any, Callable, Dict, FrozenSet, List, Optional
 
 import torch
 from executorch.exir._warnings import deprecated
@@ -16,15 +16,31 @@ from executorch.exir.memory import alloc
 from executorch.exir.memory_planning import (
     _is_out_var_node,
     apply_algo,
+    filter_nodes,
     get_node_tensor_specs,
     memory_planning_algorithm_suite,
     Verifier,
 )
 from executorch.exir.operator.convert import get_out_args_from_opoverload
 from executorch.exir.pass_base import PassBase, PassResult
-from executorch.exir.tensor import ALIGNMENT
+from executorch.exir.tensor import ALIGNMENT, TensorSpec
 from torch.export.exported_program import ExportGraphSignature
 
+# Out-variant ops whose kernels may be called with out aliasing self. Each one
+# reads every element of self before writing the same element of out, and the
+# kernel tests cover the aliased call (see the OutAliasesSelf tests under
+# kernels/test). Custom kernels can declare the same property when they are
+# registered (see Kernel::in_place_safe_ in runtime/kernel/operator_registry.h).
+IN_PLACE_SAFE_OPS: FrozenSet[str] = frozenset(
+    {
+        "aten::add.out",
+        "aten::clamp.out",
+        "aten::masked_fill.Scalar_out",
+        "aten::mul.out",
+        "aten::relu.out",
+    }
+)
+
 
 # copied from https://stackoverflow.com/questions/75582932/python-how-can-i-print-the-function-name-of-a-partial-function
 def _callable_name(any_callable: Callable[..., Any]) -> str:
@@ -47,18 +63,37 @@ class MemoryPlanningPass(PassBase):
         alloc_graph_input: bool = True,
         alloc_graph_output: bool = True,
         alignment: int = ALIGNMENT,
+        in_place_safe_ops: Optional[FrozenSet[str]] = None,
+        kernel_scratch_sizes: Optional[
+            Dict[str, Callable[[torch.fx.Node], int]]
+        ] = None,
     ) -> None:
         r"""
         alloc_graph_input/alloc_graph_output will have 4 different combinations
         to control if the memory planning algorithm need allocate memory for
         the graph input/output. The default behavior is the algorithm will allocate
         memory for both graph input and output.
+
+        in_place_safe_ops names out-variant ops (e.g. IN_PLACE_SAFE_OPS) whose
+        out may be placed in the memory of their self argument when self is not
+        used afterwards. By default no outputs are aliased.
+
+        kernel_scratch_sizes maps out-variant ops to a function that returns the
+        temp memory, in bytes, that the kernel of a node needs. The planner
+        reserves that memory for the duration of the node, and the runtime hands
+        it out from KernelRuntimeContext::allocate_temp() (see
+        Kernel::scratch_size_ in runtime/kernel/operator_registry.h for the
+        runtime side of the same declaration).
         """
         self.memory_planning_algo = memory_planning_algo
         self.allow_lifetime_and_storage_overlap = allow_lifetime_and_storage_overlap
         self.alloc_graph_input = alloc_graph_input
         self.alloc_graph_output = alloc_graph_output
         self.alignment = alignment
+        self.in_place_safe_ops: FrozenSet[str] = in_place_safe_ops or frozenset()
+        self.kernel_scratch_sizes: Dict[str, Callable[[torch.fx.Node], int]] = (
+            kernel_scratch_sizes or {}
+        )
 
     def _set_alloc_node_spec(self, graph_module: torch.fx.GraphModule) -> None:
         """
@@ -101,6 +136,84 @@ class MemoryPlanningPass(PassBase):
                         out_alloc_node.meta["spec"] = specs[i]
                         i += 1
 
+    def _alias_in_place_safe_outputs(self, graph_module: torch.fx.GraphModule) -> None:
+        """
+        Makes each in-place safe out-var node write into its self argument,
+        instead of a fresh allocation, when self is the output of another
+        out-var node that has no other users and the two tensors have the same
+        layout. The two nodes then share one TensorSpec, so the planner gives
+        them a single buffer that lives until the last use of either.
+        """
+        for subgm in graph_module.modules():
+            if not isinstance(subgm, torch.fx.GraphModule):
+                continue
+            output_nodes = set()
+            for node in subgm.graph.nodes:
+                if node.op == "output":
+                    output_nodes.update(filter_nodes(node.args))
+            for node in subgm.graph.nodes:
+                if not _is_out_var_node(node) or not node.args:
+                    continue
+                schema = node.target._schema
+                op_name = f"{schema.name}.{schema.overload_name}"
+                if op_name not in self.in_place_safe_ops:
+                    continue
+                out_arg_names = get_out_args_from_opoverload(node.target)
+                if len(out_arg_names) != 1:
+                    continue
+                out_alloc_node = node.kwargs.get(out_arg_names[0])
+                self_node = node.args[0]
+                if (
+                    not isinstance(out_alloc_node, torch.fx.Node)
+                    or out_alloc_node.target != alloc
+                    or len(out_alloc_node.users) != 1
+                    or not isinstance(self_node, torch.fx.Node)
+                    or not _is_out_var_node(self_node)
+                    or len(self_node.users) != 1
+                    or self_node in output_nodes
+                ):
+                    continue
+                self_spec = self_node.meta.get("spec")
+                out_spec = node.meta.get("spec")
+                if not (
+                    isinstance(self_spec, TensorSpec)
+                    and isinstance(out_spec, TensorSpec)
+                    and not self_spec.const
+                    and self_spec.dtype == out_spec.dtype
+                    and list(self_spec.shape) == list(out_spec.shape)
+                    and list(self_spec.dim_order) == list(out_spec.dim_order)
+                    and self_spec.shape_dynamism == out_spec.shape_dynamism
+                ):
+                    continue
+                node.update_kwarg(out_arg_names[0], self_node)
+                subgm.graph.erase_node(out_alloc_node)
+                node.meta["spec"] = self_spec
+            subgm.recompile()
+
+    def _set_kernel_scratch_specs(self, graph_module: torch.fx.GraphModule) -> None:
+        """
+        Gives each out-var node whose op is in kernel_scratch_sizes a uint8
+        TensorSpec of its scratch size, which the planner places like any other
+        tensor that only lives while the node runs.
+        """
+        for subgm in graph_module.modules():
+            if not isinstance(subgm, torch.fx.GraphModule):
+                continue
+            for node in subgm.graph.nodes:
+                if not _is_out_var_node(node):
+                    continue
+                schema = node.target._schema
+                scratch_size = self.kernel_scratch_sizes.get(
+                    f"{schema.name}.{schema.overload_name}"
+                )
+                if scratch_size is None:
+                    continue
+                nbytes = scratch_size(node)
+                if nbytes > 0:
+                    node.meta["scratch_spec"] = TensorSpec(
+                        dtype=torch.uint8, shape=torch.Size([nbytes])
+                    )
+
     @deprecated(
         "MemoryPlanningPass.call() is deprecated as it does not handle graphs \
         with mutation, please use MemoryPlanningPass.run() instead",
@@ -118,7 +231,11 @@ class MemoryPlanningPass(PassBase):
         A pass for memory planning. The actual algorithm used will be picked by
         memory_planning_algo
         """
+        if self.in_place_safe_ops:
+            self._alias_in_place_safe_outputs(graph_module)
         self._set_alloc_node_spec(graph_module)
+        if self.kernel_scratch_sizes:
+            self._set_kernel_scratch_specs(graph_module)
         # TODO(shunting) if people have concern of adding a field to GraphModule
         # directly, we should define a GraphModule subclass that we can add our
         # customized fields. Using the graph_module object to convey information across
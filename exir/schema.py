@@ -177,6 +177,8 @@ class BackendDelegateInlineData:
 class KernelCall:
     op_index: int
     args: List[int]
+    scratch: Optional[AllocationDetails] = None
+    scratch_size: int = 0
 
 
 @dataclass
@@ -278,10 +280,25 @@ class ExecutionPlan:
     non_const_buffer_sizes: List[int]
 
 
+class CompressionAlgorithm(IntEnum):
+    NONE = 0
+    LZ4 = 1
+
+
+@dataclass
+class SegmentCompression:
+    algorithm: CompressionAlgorithm
+    uncompressed_size: int
+    chunk_size: int
+    chunk_compressed_sizes: List[int]
+    shuffle_element_size: int = 0
+
+
 @dataclass
 class DataSegment:
     offset: int
     size: int
+    compression: Optional[SegmentCompression] = None
 
 
 @dataclass
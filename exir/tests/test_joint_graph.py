@@ -6,16 +6,24 @@
 
 # pyre-strict
 import unittest
+from typing import Tuple
 
 import torch
 import torch._dynamo
 
 from executorch.exir import to_edge
+from executorch.exir.passes.activation_checkpointing_pass import (
+    activation_checkpointing_pass,
+    activation_checkpointing_plans,
+    CHECKPOINTED_METHODS_PREFIX,
+    saved_activation_bytes,
+)
 
 from executorch.extension.pybindings.portable_lib import (
     _load_for_executorch_from_buffer,
 )
 from torch.export._trace import _export
+from torch.export import ExportedProgram
 from torch.export.experimental import _export_forward_backward
 from torch.export.exported_program import OutputKind
 from torch.testing import assert_close
@@ -130,3 +138,92 @@ class TestJointGraph(unittest.TestCase):
             et.executorch_program.execution_plan[3].values[0].val.int_val,
             3,
         )
+
+    def test_activation_checkpointing(self) -> None:
+        class Module(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.linear1 = torch.nn.Linear(16, 16)
+                self.linear2 = torch.nn.Linear(16, 16)
+                self.loss = torch.nn.CrossEntropyLoss()
+
+            def forward(self, x, y):
+                h = torch.sigmoid(torch.relu(self.linear1(x)) * 2)
+                return self.loss(self.linear2(h).softmax(dim=1), y)
+
+        def joint_ep() -> (
+            Tuple[ExportedProgram, torch.nn.Module, Tuple[torch.Tensor, torch.Tensor]]
+        ):
+            m = Module()
+            torch.manual_seed(0)
+            for param in m.parameters():
+                torch.nn.init.normal_(param)
+            example_inputs = (torch.ones(4, 16), torch.ones(4, 16))
+            ep = _export(m, example_inputs, pre_dispatch=True)
+            return _export_forward_backward(ep), m, example_inputs
+
+        ep, m, example_inputs = joint_ep()
+        saved = saved_activation_bytes(ep)
+        self.assertGreater(saved, 0)
+
+        checkpointed_ep, _, _ = joint_ep()
+        checkpointed_ep = activation_checkpointing_pass(checkpointed_ep, 0.5)
+        self.assertLessEqual(saved_activation_bytes(checkpointed_ep), saved * 0.5)
+        self.assertTrue(
+            any(n.meta.get("recomputed") for n in checkpointed_ep.graph.nodes)
+        )
+
+        # Recomputing the activations doesn't change the loss or gradients.
+        loss = m(*example_inputs)
+        loss.backward()
+        et = to_edge(checkpointed_ep).to_executorch()
+        et_outputs = _load_for_executorch_from_buffer(et.buffer).forward(
+            example_inputs
+        )
+        assert_close(loss, et_outputs[0], rtol=1e-4, atol=1e-4)
+        assert_close(m.linear1.weight.grad, et_outputs[1], rtol=1e-4, atol=1e-4)
+        assert_close(m.linear1.bias.grad, et_outputs[2], rtol=1e-4, atol=1e-4)
+
+        # A budget of 1 leaves the graph alone.
+        unchanged_ep, _, _ = joint_ep()
+        num_nodes = len(unchanged_ep.graph.nodes)
+        activation_checkpointing_pass(unchanged_ep, 1.0)
+        self.assertEqual(len(unchanged_ep.graph.nodes), num_nodes)
+
+    def test_activation_checkpointing_plans(self) -> None:
+        class Module(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.linear = torch.nn.Linear(3, 3)
+                self.loss = torch.nn.CrossEntropyLoss()
+
+            def forward(self, x, y):
+                return self.loss(torch.relu(self.linear(x)).softmax(dim=0), y)
+
+        m = Module()
+        example_inputs = (torch.ones(3), torch.tensor([1.0, 0.0, 0.0]))
+        ep = _export(m, example_inputs, pre_dispatch=True)
+        joint_ep = _export_forward_backward(ep)
+        methods, constant_methods = activation_checkpointing_plans(
+            "forward", joint_ep, [0.5, 0.0]
+        )
+        self.assertEqual(
+            list(methods),
+            ["forward", "forward__checkpointed_0", "forward__checkpointed_1"],
+        )
+        self.assertIs(methods["forward"], joint_ep)
+        self.assertEqual(
+            constant_methods,
+            {
+                CHECKPOINTED_METHODS_PREFIX
+                + "forward": ["forward__checkpointed_0", "forward__checkpointed_1"]
+            },
+        )
+
+        et = to_edge(methods, constant_methods=constant_methods).to_executorch()
+        et_mod = _load_for_executorch_from_buffer(et.buffer)
+        expected = et_mod.run_method("forward", example_inputs)
+        for name in ("forward__checkpointed_0", "forward__checkpointed_1"):
+            outputs = et_mod.run_method(name, example_inputs)
+            for expected_output, output in zip(expected, outputs):
+                assert_close(expected_output, output)
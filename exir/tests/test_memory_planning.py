@@ -14,7 +14,7 @@ from typing import Any, Callable, List, Optional, Tuple, Type
 import executorch.exir as exir
 
 import torch
-from executorch.exir import ExecutorchBackendConfig, to_edge
+from executorch.exir import ExecutorchBackendConfig, memory, to_edge
 from executorch.exir.dialects._ops import ops as exir_ops
 from executorch.exir.memory_planning import (
     filter_nodes,
@@ -32,7 +32,10 @@ from executorch.exir.passes import (  # noqa
     SpecPropPass,
     ToOutVarPass,
 )
+from executorch.exir.passes.memory_planning_pass import IN_PLACE_SAFE_OPS
 from executorch.exir.passes.sym_shape_eval_pass import ConstraintBasedSymShapeEvalPass
+from executorch.exir.schema import KernelCall
+from executorch.exir.tensor import TensorSpec
 from parameterized import parameterized
 
 from torch import nn
@@ -775,3 +778,77 @@ class TestMisc(unittest.TestCase):
             .val.allocation_info,  # pyright: ignore
             None,
         )
+
+    def test_in_place_safe_outputs_aliased(self) -> None:
+        class Simple(torch.nn.Module):
+            def forward(self, x: torch.Tensor, y: torch.Tensor) -> torch.Tensor:
+                # relu reuses the buffer of x * y, and the add that of the relu.
+                return torch.relu(x * y) + x
+
+        def planned_values(et: Any) -> Tuple[int, int]:  # pyre-ignore
+            num_allocs = 0
+            offsets = set()
+            graph_module = et.exported_program().graph_module
+            for node in graph_module.graph.nodes:
+                if node.op == "call_function" and node.target == memory.alloc:
+                    num_allocs += 1
+                elif node.op == "call_function" and "spec" in node.meta:
+                    spec = node.meta["spec"]
+                    if isinstance(spec, TensorSpec) and spec.mem_id is not None:
+                        offsets.add((spec.mem_id, spec.mem_offset))
+            return num_allocs, len(offsets)
+
+        inputs = (torch.randn(4, 4), torch.randn(4, 4))
+
+        et_default = to_edge(export(Simple(), inputs, strict=True)).to_executorch()
+        self.assertEqual(planned_values(et_default)[0], 3)
+
+        et_aliased = to_edge(export(Simple(), inputs, strict=True)).to_executorch(
+            config=ExecutorchBackendConfig(
+                memory_planning_pass=MemoryPlanningPass(
+                    in_place_safe_ops=IN_PLACE_SAFE_OPS
+                ),
+            )
+        )
+        self.assertEqual(planned_values(et_aliased), (1, 1))
+
+    def test_kernel_scratch_planned(self) -> None:
+        class Simple(torch.nn.Module):
+            def forward(self, x: torch.Tensor, y: torch.Tensor) -> torch.Tensor:
+                return torch.relu(x * y) + x
+
+        inputs = (torch.randn(4, 4), torch.randn(4, 4))
+        et = to_edge(export(Simple(), inputs, strict=True)).to_executorch(
+            config=ExecutorchBackendConfig(
+                memory_planning_pass=MemoryPlanningPass(
+                    kernel_scratch_sizes={
+                        "aten::relu.out": lambda node: node.meta["spec"].nbytes()
+                    }
+                ),
+            )
+        )
+
+        # Only relu gets scratch memory, of the size that it declared.
+        scratch_specs = []
+        for node in et.exported_program().graph_module.graph.nodes:
+            if "scratch_spec" in node.meta:
+                self.assertEqual(node.target, torch.ops.aten.relu.out)
+                scratch_specs.append(node.meta["scratch_spec"])
+        self.assertEqual(len(scratch_specs), 1)
+        scratch_spec = scratch_specs[0]
+        self.assertEqual(scratch_spec.nbytes(), 4 * 4 * 4)
+        self.assertEqual(scratch_spec.lifetime[0], scratch_spec.lifetime[1])
+
+        plan = et.executorch_program.execution_plan[0]
+        kernel_calls = [
+            instruction.instr_args
+            for instruction in plan.chains[0].instructions
+            if isinstance(instruction.instr_args, KernelCall)
+        ]
+        planned = [call for call in kernel_calls if call.scratch is not None]
+        self.assertEqual(len(planned), 1)
+        self.assertEqual(planned[0].scratch_size, 4 * 4 * 4)
+        self.assertEqual(planned[0].scratch.memory_id, scratch_spec.mem_id)
+        self.assertEqual(
+            planned[0].scratch.memory_offset_low, scratch_spec.mem_offset
+        )
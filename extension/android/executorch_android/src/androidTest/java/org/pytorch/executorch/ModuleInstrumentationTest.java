@@ -12,6 +12,7 @@ import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertTrue;
 import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertNotEquals;
+import static org.junit.Assert.assertSame;
 import static org.junit.Assert.fail;
 
 import android.os.Environment;
@@ -28,6 +29,7 @@ import java.net.URISyntaxException;
 import java.io.IOException;
 import java.io.File;
 import java.io.FileOutputStream;
+import java.nio.FloatBuffer;
 import org.junit.runners.JUnit4;
 import org.apache.commons.io.FileUtils;
 import androidx.test.ext.junit.runners.AndroidJUnit4;
@@ -93,6 +95,35 @@ public class ModuleInstrumentationTest {
         assertTrue(results[0].isTensor());
     }
 
+    @Test
+    public void testModuleExecuteBound() throws IOException{
+        Module module = Module.load(getTestFilePath(TEST_FILE_NAME));
+
+        FloatBuffer input = Tensor.allocateFloatBuffer(1);
+        Tensor inputTensor = Tensor.fromBlob(input, new long[] {1});
+        assertEquals(module.bindInput(FORWARD_METHOD, 0, inputTensor), OK);
+        assertEquals(module.bindInput(FORWARD_METHOD, 1, inputTensor), OK);
+        Tensor outputTensor = Tensor.fromBlob(Tensor.allocateFloatBuffer(1), new long[] {1});
+        assertEquals(module.bindOutput(FORWARD_METHOD, 0, outputTensor), OK);
+
+        // The bound buffers are read and written in place on every execution.
+        for (int i = 1; i <= 3; i++) {
+            input.put(0, (float) i);
+            module.executeBound(FORWARD_METHOD);
+            assertEquals(2.0f * i, outputTensor.getDataAsFloatArray()[0], 1e-5f);
+        }
+
+        // Executing with explicit inputs returns the bound output tensor itself.
+        EValue[] results =
+            module.execute(FORWARD_METHOD, EValue.from(inputTensor), EValue.from(inputTensor));
+        assertSame(outputTensor, results[0].toTensor());
+        assertEquals(6.0f, outputTensor.getDataAsFloatArray()[0], 1e-5f);
+
+        assertEquals(module.bindOutput(FORWARD_METHOD, 0, null), OK);
+        results = module.forward(EValue.from(inputTensor), EValue.from(inputTensor));
+        assertNotEquals(outputTensor, results[0].toTensor());
+    }
+
     @Test
     public void testModuleLoadNonExistantFile() throws IOException{
         Module module = Module.load(getTestFilePath(MISSING_FILE_NAME));
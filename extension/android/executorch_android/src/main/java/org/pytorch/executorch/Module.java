@@ -99,6 +99,49 @@ public class Module {
     return mNativePeer.loadMethod(methodName);
   }
 
+  /**
+   * Binds an input of a method to a tensor, so that every later execution reads the tensor's
+   * buffer directly instead of copying it. The tensor's data must be backed by a direct buffer,
+   * like the ones returned by {@link Tensor#allocateFloatBuffer}, and its contents can be updated
+   * in place between executions. The binding lasts until the input is passed to {@link #execute}
+   * or {@link #forward}.
+   *
+   * @param methodName name of the ExecuTorch method.
+   * @param index index of the input to bind.
+   * @param tensor the tensor to bind.
+   * @return the Error code if there was an error binding the input
+   */
+  public int bindInput(String methodName, int index, Tensor tensor) {
+    return mNativePeer.bindInput(methodName, index, tensor);
+  }
+
+  /**
+   * Binds an output of a method to a preallocated tensor, which receives the output of every later
+   * execution. Outputs that are not memory-planned are written into the tensor's buffer directly;
+   * others are copied there once the method finishes. {@link #execute} and {@link #forward} return
+   * the bound tensor itself for that output instead of a new one. The tensor must be backed by a
+   * direct buffer and have the shape and dtype of the output.
+   *
+   * @param methodName name of the ExecuTorch method.
+   * @param index index of the output to bind.
+   * @param tensor the tensor to bind, or null to remove the binding.
+   * @return the Error code if there was an error binding the output
+   */
+  public int bindOutput(String methodName, int index, Tensor tensor) {
+    return mNativePeer.bindOutput(methodName, index, tensor);
+  }
+
+  /**
+   * Runs the specified method with its bound inputs, or the inputs of its last execution, and
+   * writes its outputs into the tensors bound with {@link #bindOutput}. Unlike {@link #execute},
+   * this does not create any Java objects, so it can run every frame without adding GC pressure.
+   *
+   * @param methodName name of the ExecuTorch method to run.
+   */
+  public void executeBound(String methodName) {
+    mNativePeer.executeBound(methodName);
+  }
+
   /** Retrieve the in-memory log buffer, containing the most recent ExecuTorch log entries. */
   public String[] readLogBuffer() {
     return mNativePeer.readLogBuffer();
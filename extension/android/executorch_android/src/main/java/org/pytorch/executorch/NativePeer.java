@@ -55,6 +55,26 @@ class NativePeer {
   @DoNotStrip
   public native int loadMethod(String methodName);
 
+  /**
+   * Bind an input of a method to a tensor, whose buffer the method reads directly.
+   *
+   * @return the Error code if there was an error binding the input
+   */
+  @DoNotStrip
+  public native int bindInput(String methodName, int index, Tensor tensor);
+
+  /**
+   * Bind an output of a method to a tensor, or remove the binding if the tensor is null.
+   *
+   * @return the Error code if there was an error binding the output
+   */
+  @DoNotStrip
+  public native int bindOutput(String methodName, int index, Tensor tensor);
+
+  /** Run a method with its bound inputs, writing its outputs into the bound output tensors */
+  @DoNotStrip
+  public native void executeBound(String methodName);
+
   /** Retrieve the in-memory log buffer, containing the most recent ExecuTorch log entries. */
   @DoNotStrip
   public native String[] readLogBuffer();
@@ -130,6 +130,63 @@ public class LlmModule {
       LlmCallback llmCallback,
       boolean echo);
 
+  /**
+   * Start generating tokens from the module on a native thread, and return without waiting for
+   * the result. The thread is pinned to the performance cores when possible. The callback is
+   * called from that thread, so results must be posted to the UI thread by the caller.
+   *
+   * @param prompt Input prompt
+   * @param seqLen sequence length
+   * @param llmCallback callback object to receive results
+   * @param echo indicate whether to echo the input prompt or not (text completion vs chat)
+   * @return 0 if the generation was started, or an error code if another generation is running.
+   */
+  public int generateAsync(String prompt, int seqLen, LlmCallback llmCallback, boolean echo) {
+    return generateAsync(null, 0, 0, 0, prompt, seqLen, llmCallback, echo);
+  }
+
+  /**
+   * Start generating tokens from the module on a native thread. See {@link #generateAsync(String,
+   * int, LlmCallback, boolean)}.
+   *
+   * @param image Input image as a byte array
+   * @param width Input image width
+   * @param height Input image height
+   * @param channels Input image number of channels
+   * @param prompt Input prompt
+   * @param seqLen sequence length
+   * @param llmCallback callback object to receive results.
+   * @param echo indicate whether to echo the input prompt or not (text completion vs chat)
+   * @return 0 if the generation was started, or an error code if another generation is running.
+   */
+  @DoNotStrip
+  public native int generateAsync(
+      int[] image,
+      int width,
+      int height,
+      int channels,
+      String prompt,
+      int seqLen,
+      LlmCallback llmCallback,
+      boolean echo);
+
+  /** Block until the generation started by generateAsync() has finished. */
+  @DoNotStrip
+  public native void waitForGeneration();
+
+  /**
+   * Batch the text passed to {@link LlmCallback#onResult(String)}, so that each call carries
+   * several tokens instead of one. A batch is passed on once it has {@code maxTokens} tokens, or
+   * once {@code maxDelayMs} milliseconds have passed since the last one, whichever comes first.
+   * The rest is passed on at the end of the generation, before {@link
+   * LlmCallback#onStats(float)}.
+   *
+   * @param maxTokens the most tokens per callback; 1, the default, disables batching
+   * @param maxDelayMs the longest time to hold tokens back, or 0 for no limit
+   */
+  @DoNotStrip
+  public native void setCallbackBatching(int maxTokens, int maxDelayMs);
+
   /**
    * Prefill an LLaVA Module with the given images input.
    *
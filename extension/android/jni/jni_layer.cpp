@@ -89,6 +89,56 @@ class TensorHybrid : public facebook::jni::HybridClass<TensorHybrid> {
         cls, jTensorBuffer, jTensorShape, jdtype, makeCxxInstance(tensor));
   }
 
+  // Wraps the direct buffer of a Java Tensor, without copying its data. The
+  // buffer must stay valid while the returned tensor is used.
+  static TensorPtr newTensorFromJTensor(
+      facebook::jni::alias_ref<TensorHybrid::javaobject> jtensor) {
+    static auto cls = TensorHybrid::javaClassStatic();
+    static const auto dtypeMethod = cls->getMethod<jint()>("dtypeJniCode");
+    jint jdtype = dtypeMethod(jtensor);
+
+    static const auto shapeField = cls->getField<jlongArray>("shape");
+    auto jshape = jtensor->getFieldValue(shapeField);
+
+    static auto dataBufferMethod = cls->getMethod<
+        facebook::jni::local_ref<facebook::jni::JBuffer::javaobject>()>(
+        "getRawDataBuffer");
+    facebook::jni::local_ref<facebook::jni::JBuffer> jbuffer =
+        dataBufferMethod(jtensor);
+
+    const auto rank = jshape->size();
+
+    const auto shapeArr = jshape->getRegion(0, rank);
+    std::vector<executorch::aten::SizesType> shape_vec;
+    shape_vec.reserve(rank);
+
+    auto numel = 1;
+    for (int i = 0; i < rank; i++) {
+      shape_vec.push_back(shapeArr[i]);
+    }
+    for (int i = rank - 1; i >= 0; --i) {
+      numel *= shapeArr[i];
+    }
+    JNIEnv* jni = facebook::jni::Environment::current();
+    if (java_dtype_to_scalar_type.count(jdtype) == 0) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Unknown Tensor jdtype %d",
+          jdtype);
+    }
+    ScalarType scalar_type = java_dtype_to_scalar_type.at(jdtype);
+    const auto dataCapacity = jni->GetDirectBufferCapacity(jbuffer.get());
+    if (dataCapacity != numel) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Tensor dimensions(elements number:%d inconsistent with buffer capacity(%d)",
+          numel,
+          dataCapacity);
+    }
+    return from_blob(
+        jni->GetDirectBufferAddress(jbuffer.get()), shape_vec, scalar_type);
+  }
+
  private:
   friend HybridBase;
 };
@@ -104,6 +154,15 @@ class JEValue : public facebook::jni::JavaClass<JEValue> {
   constexpr static int kTypeCodeInt = 4;
   constexpr static int kTypeCodeBool = 5;
 
+  static facebook::jni::local_ref<JEValue> newJEValueFromJTensor(
+      facebook::jni::alias_ref<TensorHybrid::javaobject> jtensor) {
+    static auto jMethodTensor =
+        JEValue::javaClassStatic()
+            ->getStaticMethod<facebook::jni::local_ref<JEValue>(
+                facebook::jni::alias_ref<TensorHybrid::javaobject>)>("from");
+    return jMethodTensor(JEValue::javaClassStatic(), jtensor);
+  }
+
   static facebook::jni::local_ref<JEValue> newJEValueFromEValue(EValue evalue) {
     if (evalue.isTensor()) {
       static auto jMethodTensor =
@@ -158,51 +217,7 @@ class JEValue : public facebook::jni::JavaClass<JEValue> {
               ->getMethod<facebook::jni::alias_ref<TensorHybrid::javaobject>()>(
                   "toTensor");
       auto jtensor = jMethodGetTensor(JEValue);
-
-      static auto cls = TensorHybrid::javaClassStatic();
-      static const auto dtypeMethod = cls->getMethod<jint()>("dtypeJniCode");
-      jint jdtype = dtypeMethod(jtensor);
-
-      static const auto shapeField = cls->getField<jlongArray>("shape");
-      auto jshape = jtensor->getFieldValue(shapeField);
-
-      static auto dataBufferMethod = cls->getMethod<
-          facebook::jni::local_ref<facebook::jni::JBuffer::javaobject>()>(
-          "getRawDataBuffer");
-      facebook::jni::local_ref<facebook::jni::JBuffer> jbuffer =
-          dataBufferMethod(jtensor);
-
-      const auto rank = jshape->size();
-
-      const auto shapeArr = jshape->getRegion(0, rank);
-      std::vector<executorch::aten::SizesType> shape_vec;
-      shape_vec.reserve(rank);
-
-      auto numel = 1;
-      for (int i = 0; i < rank; i++) {
-        shape_vec.push_back(shapeArr[i]);
-      }
-      for (int i = rank - 1; i >= 0; --i) {
-        numel *= shapeArr[i];
-      }
-      JNIEnv* jni = facebook::jni::Environment::current();
-      if (java_dtype_to_scalar_type.count(jdtype) == 0) {
-        facebook::jni::throwNewJavaException(
-            facebook::jni::gJavaLangIllegalArgumentException,
-            "Unknown Tensor jdtype %d",
-            jdtype);
-      }
-      ScalarType scalar_type = java_dtype_to_scalar_type.at(jdtype);
-      const auto dataCapacity = jni->GetDirectBufferCapacity(jbuffer.get());
-      if (dataCapacity != numel) {
-        facebook::jni::throwNewJavaException(
-            facebook::jni::gJavaLangIllegalArgumentException,
-            "Tensor dimensions(elements number:%d inconsistent with buffer capacity(%d)",
-            numel,
-            dataCapacity);
-      }
-      return from_blob(
-          jni->GetDirectBufferAddress(jbuffer.get()), shape_vec, scalar_type);
+      return TensorHybrid::newTensorFromJTensor(jtensor);
     }
     facebook::jni::throwNewJavaException(
         facebook::jni::gJavaLangIllegalArgumentException,
@@ -214,7 +229,21 @@ class JEValue : public facebook::jni::JavaClass<JEValue> {
 class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
  private:
   friend HybridBase;
+
+  // A Java Tensor bound to an input or output, and the native tensor that
+  // wraps its buffer.
+  struct BoundTensor {
+    facebook::jni::global_ref<TensorHybrid::javaobject> jtensor;
+    TensorPtr tensor;
+  };
+
   std::unique_ptr<Module> module_;
+  // Bound tensors by method name and index. Holding the Java Tensors keeps
+  // their buffers alive while the Module refers to them.
+  std::unordered_map<std::string, std::unordered_map<int, BoundTensor>>
+      bound_inputs_;
+  std::unordered_map<std::string, std::unordered_map<int, BoundTensor>>
+      bound_outputs_;
 
  public:
   constexpr static auto kJavaDescriptor = "Lorg/pytorch/executorch/NativePeer;";
@@ -279,6 +308,58 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
     return static_cast<jint>(module_->load_method(methodName->toStdString()));
   }
 
+  jint bind_input(
+      facebook::jni::alias_ref<jstring> methodName,
+      jint index,
+      facebook::jni::alias_ref<TensorHybrid::javaobject> jtensor) {
+    const std::string method = methodName->toStdString();
+    BoundTensor bound{
+        facebook::jni::make_global(jtensor),
+        TensorHybrid::newTensorFromJTensor(jtensor)};
+    const auto error = module_->bind_input(method, EValue(bound.tensor), index);
+    if (error == Error::Ok) {
+      bound_inputs_[method][index] = std::move(bound);
+    }
+    return static_cast<jint>(error);
+  }
+
+  jint bind_output(
+      facebook::jni::alias_ref<jstring> methodName,
+      jint index,
+      facebook::jni::alias_ref<TensorHybrid::javaobject> jtensor) {
+    const std::string method = methodName->toStdString();
+    if (!jtensor) {
+      const auto error = module_->bind_output(method, EValue(), index);
+      if (error == Error::Ok) {
+        bound_outputs_[method].erase(index);
+      }
+      return static_cast<jint>(error);
+    }
+    BoundTensor bound{
+        facebook::jni::make_global(jtensor),
+        TensorHybrid::newTensorFromJTensor(jtensor)};
+    const auto error =
+        module_->bind_output(method, EValue(bound.tensor), index);
+    if (error == Error::Ok) {
+      bound_outputs_[method][index] = std::move(bound);
+    }
+    return static_cast<jint>(error);
+  }
+
+  // Executes a method with its current inputs, leaving its outputs in the
+  // bound output tensors. Creates no Java objects.
+  void execute_bound(facebook::jni::alias_ref<jstring> methodName) {
+    const std::string method = methodName->toStdString();
+    const auto result = module_->execute(method, std::vector<EValue>{});
+    if (!result.ok()) {
+      facebook::jni::throwNewJavaException(
+          "java/lang/Exception",
+          "Execution of method %s failed with status 0x%" PRIx32,
+          method.c_str(),
+          static_cast<error_code_t>(result.error()));
+    }
+  }
+
   facebook::jni::local_ref<facebook::jni::JArrayClass<JEValue>> execute_method(
       std::string method,
       facebook::jni::alias_ref<
@@ -357,7 +438,18 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
     facebook::jni::local_ref<facebook::jni::JArrayClass<JEValue>> jresult =
         facebook::jni::JArrayClass<JEValue>::newArray(result.get().size());
 
+    const auto bound_outputs = bound_outputs_.find(method);
     for (int i = 0; i < result.get().size(); i++) {
+      // Return bound outputs as the Java Tensors they were bound to, which
+      // hold the outputs already.
+      if (bound_outputs != bound_outputs_.end()) {
+        const auto bound = bound_outputs->second.find(i);
+        if (bound != bound_outputs->second.end()) {
+          jresult->setElement(
+              i, *JEValue::newJEValueFromJTensor(bound->second.jtensor));
+          continue;
+        }
+      }
       auto jevalue = JEValue::newJEValueFromEValue(result.get()[i]);
       jresult->setElement(i, *jevalue);
     }
@@ -401,6 +493,9 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
         makeNativeMethod("forward", ExecuTorchJni::forward),
         makeNativeMethod("execute", ExecuTorchJni::execute),
         makeNativeMethod("loadMethod", ExecuTorchJni::load_method),
+        makeNativeMethod("bindInput", ExecuTorchJni::bind_input),
+        makeNativeMethod("bindOutput", ExecuTorchJni::bind_output),
+        makeNativeMethod("executeBound", ExecuTorchJni::execute_bound),
         makeNativeMethod("readLogBuffer", ExecuTorchJni::readLogBuffer),
     });
   }
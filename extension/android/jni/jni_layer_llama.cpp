@@ -6,10 +6,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -69,8 +72,6 @@ bool utf8_check_validity(const char* str, size_t length) {
   }
   return true; // All bytes were valid
 }
-
-std::string token_buffer;
 } // namespace
 
 namespace executorch_jni {
@@ -81,19 +82,11 @@ class ExecuTorchLlmCallbackJni
   constexpr static const char* kJavaDescriptor =
       "Lorg/pytorch/executorch/extension/llm/LlmCallback;";
 
-  void onResult(std::string result) const {
+  void onResult(const std::string& result) const {
     static auto cls = ExecuTorchLlmCallbackJni::javaClassStatic();
     static const auto method =
         cls->getMethod<void(facebook::jni::local_ref<jstring>)>("onResult");
 
-    token_buffer += result;
-    if (!utf8_check_validity(token_buffer.c_str(), token_buffer.size())) {
-      ET_LOG(
-          Info, "Current token buffer is not valid UTF-8. Waiting for more.");
-      return;
-    }
-    result = token_buffer;
-    token_buffer = "";
     facebook::jni::local_ref<jstring> s = facebook::jni::make_jstring(result);
     method(self(), s);
   }
@@ -111,12 +104,121 @@ class ExecuTorchLlmCallbackJni
   }
 };
 
+// Collects generated text and passes it to the Java callback in batches of
+// tokens, so that each JNI transition and Java string covers several tokens.
+// Text is only passed on once it is valid UTF-8, since a token may end in the
+// middle of a character.
+class TokenBatcher {
+ public:
+  TokenBatcher(
+      facebook::jni::alias_ref<ExecuTorchLlmCallbackJni> callback,
+      size_t max_tokens,
+      std::chrono::milliseconds max_delay)
+      : callback_(callback),
+        max_tokens_(max_tokens),
+        max_delay_(max_delay),
+        last_flush_(std::chrono::steady_clock::now()) {}
+
+  void add(const std::string& token) {
+    // The buffer keeps its capacity across flushes, so steady-state decoding
+    // doesn't allocate.
+    text_ += token;
+    num_tokens_ += 1;
+    if (num_tokens_ >= max_tokens_ ||
+        (max_delay_.count() > 0 &&
+         std::chrono::steady_clock::now() - last_flush_ >= max_delay_)) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (text_.empty() ||
+        !utf8_check_validity(text_.c_str(), text_.size())) {
+      return;
+    }
+    callback_->onResult(text_);
+    text_.clear();
+    num_tokens_ = 0;
+    last_flush_ = std::chrono::steady_clock::now();
+  }
+
+  // Passes on the rest of the text at the end of a generation.
+  void finish() {
+    flush();
+    if (!text_.empty()) {
+      ET_LOG(Info, "Dropping %zu bytes of incomplete UTF-8", text_.size());
+      text_.clear();
+    }
+  }
+
+ private:
+  facebook::jni::alias_ref<ExecuTorchLlmCallbackJni> callback_;
+  const size_t max_tokens_;
+  const std::chrono::milliseconds max_delay_;
+  std::chrono::steady_clock::time_point last_flush_;
+  std::string text_;
+  size_t num_tokens_ = 0;
+};
+
 class ExecuTorchLlmJni : public facebook::jni::HybridClass<ExecuTorchLlmJni> {
  private:
   friend HybridBase;
   int model_type_category_;
   std::unique_ptr<llm::IRunner> runner_;
   std::unique_ptr<llm::MultimodalRunner> multi_modal_runner_;
+  // Set by setCallbackBatching().
+  size_t callback_batch_tokens_ = 1;
+  std::chrono::milliseconds callback_batch_delay_{0};
+  // The thread of the last generateAsync(), and whether it is still running.
+  std::thread generation_thread_;
+  std::atomic<bool> generating_{false};
+
+  static std::vector<llm::Image> to_images(
+      facebook::jni::alias_ref<jintArray> image,
+      jint width,
+      jint height,
+      jint channels) {
+    std::vector<llm::Image> images;
+    if (!image) {
+      return images;
+    }
+    auto image_size = image->size();
+    if (image_size != 0) {
+      std::vector<jint> image_data_jint(image_size);
+      std::vector<uint8_t> image_data(image_size);
+      image->getRegion(0, image_size, image_data_jint.data());
+      for (int i = 0; i < image_size; i++) {
+        image_data[i] = image_data_jint[i];
+      }
+      llm::Image image_runner{image_data, width, height, channels};
+      images.push_back(image_runner);
+    }
+    return images;
+  }
+
+  void run_generate(
+      std::vector<llm::Image> images,
+      const std::string& prompt,
+      jint seq_len,
+      facebook::jni::alias_ref<ExecuTorchLlmCallbackJni> callback,
+      bool echo) {
+    TokenBatcher batcher(
+        callback, callback_batch_tokens_, callback_batch_delay_);
+    auto on_token = [&batcher](const std::string& token) {
+      batcher.add(token);
+    };
+    auto on_stats = [&batcher, callback](const llm::Stats& stats) {
+      batcher.finish();
+      callback->onStats(stats);
+    };
+    if (model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL) {
+      multi_modal_runner_->generate(
+          std::move(images), prompt, seq_len, on_token, on_stats, echo);
+    } else if (model_type_category_ == MODEL_TYPE_CATEGORY_LLM) {
+      runner_->generate(prompt, seq_len, on_token, on_stats, echo);
+    }
+    batcher.finish();
+  }
 
  public:
   constexpr static auto kJavaDescriptor =
@@ -153,8 +255,13 @@ class ExecuTorchLlmJni : public facebook::jni::HybridClass<ExecuTorchLlmJni> {
         ::executorch::extension::cpuinfo::get_num_performant_cores() - 1;
     if (num_performant_cores > 0) {
       ET_LOG(Info, "Resetting threadpool to %d threads", num_performant_cores);
-      ::executorch::extension::threadpool::get_threadpool()
-          ->_unsafe_reset_threadpool(num_performant_cores);
+      auto* const threadpool =
+          ::executorch::extension::threadpool::get_threadpool();
+      threadpool->_unsafe_reset_threadpool(num_performant_cores);
+      // Keep the decode threads from migrating to the little cores.
+      threadpool->_unsafe_set_affinity(
+          ::executorch::extension::threadpool::ThreadPool::Affinity::
+              Performance);
     }
 #endif
 
@@ -189,6 +296,13 @@ class ExecuTorchLlmJni : public facebook::jni::HybridClass<ExecuTorchLlmJni> {
     }
   }
 
+  ~ExecuTorchLlmJni() {
+    if (generation_thread_.joinable()) {
+      stop();
+      generation_thread_.join();
+    }
+  }
+
   jint generate(
       facebook::jni::alias_ref<jintArray> image,
       jint width,
@@ -198,37 +312,78 @@ class ExecuTorchLlmJni : public facebook::jni::HybridClass<ExecuTorchLlmJni> {
       jint seq_len,
       facebook::jni::alias_ref<ExecuTorchLlmCallbackJni> callback,
       jboolean echo) {
-    if (model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL) {
-      auto image_size = image->size();
-      std::vector<llm::Image> images;
-      if (image_size != 0) {
-        std::vector<jint> image_data_jint(image_size);
-        std::vector<uint8_t> image_data(image_size);
-        image->getRegion(0, image_size, image_data_jint.data());
-        for (int i = 0; i < image_size; i++) {
-          image_data[i] = image_data_jint[i];
-        }
-        llm::Image image_runner{image_data, width, height, channels};
-        images.push_back(image_runner);
-      }
-      multi_modal_runner_->generate(
-          std::move(images),
-          prompt->toStdString(),
-          seq_len,
-          [callback](std::string result) { callback->onResult(result); },
-          [callback](const llm::Stats& result) { callback->onStats(result); },
-          echo);
-    } else if (model_type_category_ == MODEL_TYPE_CATEGORY_LLM) {
-      runner_->generate(
-          prompt->toStdString(),
-          seq_len,
-          [callback](std::string result) { callback->onResult(result); },
-          [callback](const llm::Stats& result) { callback->onStats(result); },
-          echo);
+    if (generating_) {
+      return static_cast<jint>(Error::InvalidState);
     }
+    run_generate(
+        model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL
+            ? to_images(image, width, height, channels)
+            : std::vector<llm::Image>{},
+        prompt->toStdString(),
+        seq_len,
+        callback,
+        echo);
     return 0;
   }
 
+  // Like generate(), but returns right away and generates on a new thread
+  // that runs on the performance cores and calls `callback` from there.
+  jint generate_async(
+      facebook::jni::alias_ref<jintArray> image,
+      jint width,
+      jint height,
+      jint channels,
+      facebook::jni::alias_ref<jstring> prompt,
+      jint seq_len,
+      facebook::jni::alias_ref<ExecuTorchLlmCallbackJni> callback,
+      jboolean echo) {
+    if (generating_.exchange(true)) {
+      return static_cast<jint>(Error::InvalidState);
+    }
+    if (generation_thread_.joinable()) {
+      // The previous generation has finished.
+      generation_thread_.join();
+    }
+    auto images = model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL
+        ? to_images(image, width, height, channels)
+        : std::vector<llm::Image>{};
+    generation_thread_ = std::thread(
+        [this,
+         images = std::move(images),
+         prompt = prompt->toStdString(),
+         seq_len,
+         callback = facebook::jni::make_global(callback),
+         echo]() mutable {
+          facebook::jni::ThreadScope::WithClassLoader([&]() {
+#if defined(ET_USE_THREADPOOL)
+            // Keep the decode loop from migrating to the little cores, like
+            // the threadpool threads.
+            ::executorch::extension::cpuinfo::set_thread_affinity(
+                ::executorch::extension::cpuinfo::get_cpus(
+                    ::executorch::extension::cpuinfo::CoreType::Performance));
+#endif
+            run_generate(std::move(images), prompt, seq_len, callback, echo);
+            // Release the reference while the thread is still attached.
+            callback.reset();
+          });
+          generating_ = false;
+        });
+    return 0;
+  }
+
+  // Blocks until the generation started by generate_async() has finished.
+  void wait_for_generation() {
+    if (generation_thread_.joinable()) {
+      generation_thread_.join();
+    }
+  }
+
+  void set_callback_batching(jint max_tokens, jint max_delay_ms) {
+    callback_batch_tokens_ = std::max<jint>(max_tokens, 1);
+    callback_batch_delay_ =
+        std::chrono::milliseconds(std::max<jint>(max_delay_ms, 0));
+  }
+
   // Returns a tuple of (error, start_pos)
   // Contract is valid within an AAR (JNI + corresponding Java code)
   // If the first element is not Error::Ok, the other element is undefined.
@@ -300,13 +455,20 @@ class ExecuTorchLlmJni : public facebook::jni::HybridClass<ExecuTorchLlmJni> {
     if (model_type_category_ != MODEL_TYPE_CATEGORY_MULTIMODAL) {
       return static_cast<jint>(Error::NotSupported);
     }
-    return static_cast<jint>(multi_modal_runner_->generate_from_pos(
+    TokenBatcher batcher(
+        callback, callback_batch_tokens_, callback_batch_delay_);
+    const auto error = multi_modal_runner_->generate_from_pos(
         prompt->toStdString(),
         seq_len,
         start_pos,
-        [callback](const std::string& result) { callback->onResult(result); },
-        [callback](const llm::Stats& stats) { callback->onStats(stats); },
-        echo));
+        [&batcher](const std::string& result) { batcher.add(result); },
+        [&batcher, callback](const llm::Stats& stats) {
+          batcher.finish();
+          callback->onStats(stats);
+        },
+        echo);
+    batcher.finish();
+    return static_cast<jint>(error);
   }
 
   void stop() {
@@ -330,6 +492,11 @@ class ExecuTorchLlmJni : public facebook::jni::HybridClass<ExecuTorchLlmJni> {
     registerHybrid({
         makeNativeMethod("initHybrid", ExecuTorchLlmJni::initHybrid),
         makeNativeMethod("generate", ExecuTorchLlmJni::generate),
+        makeNativeMethod("generateAsync", ExecuTorchLlmJni::generate_async),
+        makeNativeMethod(
+            "waitForGeneration", ExecuTorchLlmJni::wait_for_generation),
+        makeNativeMethod(
+            "setCallbackBatching", ExecuTorchLlmJni::set_callback_batching),
         makeNativeMethod("stop", ExecuTorchLlmJni::stop),
         makeNativeMethod("load", ExecuTorchLlmJni::load),
         makeNativeMethod(
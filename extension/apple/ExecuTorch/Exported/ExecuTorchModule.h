@@ -130,6 +130,89 @@ __attribute__((deprecated("This API is experimental.")))
                                                  error:(NSError **)error
     NS_SWIFT_NAME(execute(_:_:));
 
+/**
+ * Executes a specific method with the provided input values on the module's execution queue,
+ * without blocking the caller.
+ *
+ * Executions are run one at a time, in the order they were requested. Synchronous calls must not
+ * overlap with them.
+ *
+ * @param methodName A string representing the method name.
+ * @param values An NSArray of ExecuTorchValue objects representing the inputs.
+ * @param completion A block that is called on the execution queue with the outputs, or with an
+ *   error if the execution failed.
+ */
+- (void)executeMethod:(NSString *)methodName
+           withInputs:(NSArray<ExecuTorchValue *> *)values
+           completion:(void (^)(NSArray<ExecuTorchValue *> *_Nullable outputs, NSError *_Nullable error))completion
+    NS_SWIFT_NAME(execute(_:_:completion:));
+
+/**
+ * Binds an input of a specific method to a tensor, so that later executions read the tensor's
+ * data directly instead of copying it.
+ *
+ * The binding lasts until the input is passed to an execution again. The module keeps a reference
+ * to the tensor while it is bound; the tensor's data must stay valid and must not be changed while
+ * the method executes.
+ *
+ * @param tensor The tensor to bind.
+ * @param methodName A string representing the method name.
+ * @param index The index of the input.
+ * @param error A pointer to an NSError pointer that is set if an error occurs.
+ * @return YES if the input was bound; otherwise, NO.
+ */
+- (BOOL)bindInput:(ExecuTorchTensor *)tensor
+         toMethod:(NSString *)methodName
+          atIndex:(NSInteger)index
+            error:(NSError **)error
+    NS_SWIFT_NAME(bindInput(_:to:at:));
+
+/**
+ * Binds an input of the "forward" method to a tensor.
+ *
+ * @param tensor The tensor to bind.
+ * @param index The index of the input.
+ * @param error A pointer to an NSError pointer that is set if an error occurs.
+ * @return YES if the input was bound; otherwise, NO.
+ */
+- (BOOL)bindInput:(ExecuTorchTensor *)tensor
+          atIndex:(NSInteger)index
+            error:(NSError **)error
+    NS_SWIFT_NAME(bindInput(_:at:));
+
+/**
+ * Binds an output of a specific method to a tensor, which then receives the output of every
+ * later execution and is returned in place of a new tensor.
+ *
+ * Outputs that the method does not allocate memory for are written into the tensor directly;
+ * others are copied into it after the method finishes, and the tensor is resized to the output's
+ * shape. The module keeps a reference to the tensor while it is bound.
+ *
+ * @param tensor The tensor to bind, or nil to remove the binding.
+ * @param methodName A string representing the method name.
+ * @param index The index of the output.
+ * @param error A pointer to an NSError pointer that is set if an error occurs.
+ * @return YES if the output was bound; otherwise, NO.
+ */
+- (BOOL)bindOutput:(nullable ExecuTorchTensor *)tensor
+          toMethod:(NSString *)methodName
+           atIndex:(NSInteger)index
+             error:(NSError **)error
+    NS_SWIFT_NAME(bindOutput(_:to:at:));
+
+/**
+ * Binds an output of the "forward" method to a tensor.
+ *
+ * @param tensor The tensor to bind, or nil to remove the binding.
+ * @param index The index of the output.
+ * @param error A pointer to an NSError pointer that is set if an error occurs.
+ * @return YES if the output was bound; otherwise, NO.
+ */
+- (BOOL)bindOutput:(nullable ExecuTorchTensor *)tensor
+           atIndex:(NSInteger)index
+             error:(NSError **)error
+    NS_SWIFT_NAME(bindOutput(_:at:));
+
 /**
  * Executes a specific method with the provided single input value.
  *
@@ -201,6 +284,20 @@ __attribute__((deprecated("This API is experimental.")))
                                                      error:(NSError **)error
     NS_SWIFT_NAME(forward(_:));
 
+/**
+ * Executes the "forward" method with the provided input values on the module's execution queue,
+ * without blocking the caller.
+ *
+ * This is a convenience method that calls the executeMethod with "forward" as the method name.
+ *
+ * @param values An NSArray of ExecuTorchValue objects representing the inputs.
+ * @param completion A block that is called on the execution queue with the outputs, or with an
+ *   error if the execution failed.
+ */
+- (void)forwardWithInputs:(NSArray<ExecuTorchValue *> *)values
+               completion:(void (^)(NSArray<ExecuTorchValue *> *_Nullable outputs, NSError *_Nullable error))completion
+    NS_SWIFT_NAME(forward(_:completion:));
+
 /**
  * Executes the "forward" method with the provided single input value.
  *
@@ -62,8 +62,18 @@ static inline ExecuTorchValue *toExecuTorchValue(EValue value) {
   return [ExecuTorchValue new];
 }
 
+static inline NSError *toNSError(Error errorCode) {
+  return [NSError errorWithDomain:ExecuTorchErrorDomain
+                             code:(NSInteger)errorCode
+                         userInfo:nil];
+}
+
 @implementation ExecuTorchModule {
   std::unique_ptr<Module> _module;
+  dispatch_queue_t _executionQueue;
+  // Bound tensors by method name and index, kept alive while bound.
+  NSMutableDictionary<NSString *, NSMutableDictionary<NSNumber *, ExecuTorchTensor *> *> *_boundInputs;
+  NSMutableDictionary<NSString *, NSMutableDictionary<NSNumber *, ExecuTorchTensor *> *> *_boundOutputs;
 }
 
 - (instancetype)initWithFilePath:(NSString *)filePath
@@ -74,6 +84,12 @@ static inline ExecuTorchValue *toExecuTorchValue(EValue value) {
       filePath.UTF8String,
       static_cast<Module::LoadMode>(loadMode)
     );
+    _executionQueue = dispatch_queue_create(
+      "org.pytorch.executorch.module",
+      dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0)
+    );
+    _boundInputs = [NSMutableDictionary new];
+    _boundOutputs = [NSMutableDictionary new];
   }
   return self;
 }
@@ -149,21 +165,106 @@ static inline ExecuTorchValue *toExecuTorchValue(EValue value) {
     inputs.push_back(toEValue(value));
   }
   const auto result = _module->execute(methodName.UTF8String, inputs);
+  // Passing an input replaces its binding.
+  NSMutableDictionary<NSNumber *, ExecuTorchTensor *> *boundInputs = _boundInputs[methodName];
+  for (NSUInteger index = 0; index < values.count && boundInputs.count > 0; ++index) {
+    [boundInputs removeObjectForKey:@(index)];
+  }
   if (!result.ok()) {
     if (error) {
-      *error = [NSError errorWithDomain:ExecuTorchErrorDomain
-                                   code:(NSInteger)result.error()
-                               userInfo:nil];
+      *error = toNSError(result.error());
     }
     return nil;
   }
+  NSDictionary<NSNumber *, ExecuTorchTensor *> *boundOutputs = _boundOutputs[methodName];
   NSMutableArray<ExecuTorchValue *> *outputs = [NSMutableArray arrayWithCapacity:result->size()];
-  for (const auto &value : *result) {
-    [outputs addObject:toExecuTorchValue(value)];
+  for (NSUInteger index = 0; index < result->size(); ++index) {
+    // Bound outputs already hold the result, so return them as they are.
+    ExecuTorchTensor *boundOutput = boundOutputs[@(index)];
+    [outputs addObject:boundOutput ? [ExecuTorchValue valueWithTensor:boundOutput]
+                                   : toExecuTorchValue(result->at(index))];
   }
   return outputs;
 }
 
+- (void)executeMethod:(NSString *)methodName
+           withInputs:(NSArray<ExecuTorchValue *> *)values
+           completion:(void (^)(NSArray<ExecuTorchValue *> *_Nullable outputs, NSError *_Nullable error))completion {
+  ET_CHECK(completion);
+  NSString *name = [methodName copy];
+  NSArray<ExecuTorchValue *> *inputs = [values copy];
+  dispatch_async(_executionQueue, ^{
+    NSError *error;
+    NSArray<ExecuTorchValue *> *outputs = [self executeMethod:name
+                                                   withInputs:inputs
+                                                        error:&error];
+    completion(outputs, error);
+  });
+}
+
+- (BOOL)bindInput:(ExecuTorchTensor *)tensor
+         toMethod:(NSString *)methodName
+          atIndex:(NSInteger)index
+            error:(NSError **)error {
+  ET_CHECK(tensor);
+  const auto errorCode = _module->bind_input(
+    methodName.UTF8String,
+    EValue(**reinterpret_cast<TensorPtr *>(tensor.nativeInstance)),
+    index
+  );
+  if (errorCode != Error::Ok) {
+    if (error) {
+      *error = toNSError(errorCode);
+    }
+    return NO;
+  }
+  if (!_boundInputs[methodName]) {
+    _boundInputs[methodName] = [NSMutableDictionary new];
+  }
+  _boundInputs[methodName][@(index)] = tensor;
+  return YES;
+}
+
+- (BOOL)bindInput:(ExecuTorchTensor *)tensor
+          atIndex:(NSInteger)index
+            error:(NSError **)error {
+  return [self bindInput:tensor
+                toMethod:@"forward"
+                 atIndex:index
+                   error:error];
+}
+
+- (BOOL)bindOutput:(nullable ExecuTorchTensor *)tensor
+          toMethod:(NSString *)methodName
+           atIndex:(NSInteger)index
+             error:(NSError **)error {
+  const auto errorCode = _module->bind_output(
+    methodName.UTF8String,
+    tensor ? EValue(**reinterpret_cast<TensorPtr *>(tensor.nativeInstance)) : EValue(),
+    index
+  );
+  if (errorCode != Error::Ok) {
+    if (error) {
+      *error = toNSError(errorCode);
+    }
+    return NO;
+  }
+  if (!_boundOutputs[methodName]) {
+    _boundOutputs[methodName] = [NSMutableDictionary new];
+  }
+  _boundOutputs[methodName][@(index)] = tensor;
+  return YES;
+}
+
+- (BOOL)bindOutput:(nullable ExecuTorchTensor *)tensor
+           atIndex:(NSInteger)index
+             error:(NSError **)error {
+  return [self bindOutput:tensor
+                 toMethod:@"forward"
+                  atIndex:index
+                    error:error];
+}
+
 - (nullable NSArray<ExecuTorchValue *> *)executeMethod:(NSString *)methodName
                                              withInput:(ExecuTorchValue *)value
                                                  error:(NSError **)error {
@@ -219,6 +320,13 @@ static inline ExecuTorchValue *toExecuTorchValue(EValue value) {
                        error:error];
 }
 
+- (void)forwardWithInputs:(NSArray<ExecuTorchValue *> *)values
+               completion:(void (^)(NSArray<ExecuTorchValue *> *_Nullable outputs, NSError *_Nullable error))completion {
+  [self executeMethod:@"forward"
+           withInputs:values
+           completion:completion];
+}
+
 - (nullable NSArray<ExecuTorchValue *> *)forwardWithTensors:(NSArray<ExecuTorchTensor *> *)tensors
                                                       error:(NSError **)error {
   NSMutableArray<ExecuTorchValue *> *values = [NSMutableArray arrayWithCapacity:tensors.count];
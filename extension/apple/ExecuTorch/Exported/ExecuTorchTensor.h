@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#import <CoreVideo/CoreVideo.h>
 #import <Foundation/Foundation.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -279,6 +280,27 @@ __attribute__((deprecated("This API is experimental.")))
 
 @end
 
+#pragma mark - PixelBuffer Category
+
+@interface ExecuTorchTensor (PixelBuffer)
+
+/**
+ * Initializes a tensor over the pixels of a CVPixelBuffer without copying them.
+ *
+ * The tensor has the shape [height, width, channels] and the static shape dynamism, with the
+ * channels in the order of the pixel format, e.g. BGRA for kCVPixelFormatType_32BGRA. The base
+ * address of the pixel buffer stays locked, and the buffer retained, for as long as the tensor
+ * exists. Supported are non-planar 8-bit, half and float formats whose rows have no padding.
+ *
+ * @param pixelBuffer The pixel buffer to wrap.
+ * @param error A pointer to an NSError pointer that is set if an error occurs.
+ * @return An initialized ExecuTorchTensor instance, or nil if the pixel buffer is not supported.
+ */
+- (nullable instancetype)initWithPixelBuffer:(CVPixelBufferRef)pixelBuffer
+                                       error:(NSError **)error;
+
+@end
+
 #pragma mark - Bytes Category
 
 @interface ExecuTorchTensor (Bytes)
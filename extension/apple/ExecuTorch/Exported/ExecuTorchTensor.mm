@@ -21,6 +21,21 @@ NSInteger ExecuTorchSizeOfDataType(ExecuTorchDataType dataType) {
   return elementSize(static_cast<ScalarType>(dataType));
 }
 
+// Whether an array cached from the tensor's metadata is still up to date,
+// since the native tensor can be resized by the method it is bound to.
+template <typename T>
+static inline bool isUpToDate(NSArray<NSNumber *> *array, ArrayRef<T> values) {
+  if (!array || array.count != values.size()) {
+    return false;
+  }
+  for (NSUInteger index = 0; index < values.size(); ++index) {
+    if (array[index].longLongValue != values[index]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 NSInteger ExecuTorchElementCountOfShape(NSArray<NSNumber *> *shape) {
   NSInteger count = 1;
   for (NSNumber *dimension in shape) {
@@ -32,6 +47,7 @@ NSInteger ExecuTorchElementCountOfShape(NSArray<NSNumber *> *shape) {
 @implementation ExecuTorchTensor {
   TensorPtr _tensor;
   NSData *_data;
+  CVPixelBufferRef _pixelBuffer;
   NSArray<NSNumber *> *_shape;
   NSArray<NSNumber *> *_strides;
   NSArray<NSNumber *> *_dimensionOrder;
@@ -51,7 +67,23 @@ NSInteger ExecuTorchElementCountOfShape(NSArray<NSNumber *> *shape) {
   auto tensor = make_tensor_ptr(
     **reinterpret_cast<TensorPtr *>(otherTensor.nativeInstance)
   );
-  return [self initWithNativeInstance:&tensor];
+  self = [self initWithNativeInstance:&tensor];
+  if (self) {
+    // The new tensor shares the data, so it must keep its owner alive too.
+    _data = otherTensor->_data;
+    if (otherTensor->_pixelBuffer) {
+      CVPixelBufferLockBaseAddress(otherTensor->_pixelBuffer, 0);
+      _pixelBuffer = CVPixelBufferRetain(otherTensor->_pixelBuffer);
+    }
+  }
+  return self;
+}
+
+- (void)dealloc {
+  if (_pixelBuffer) {
+    CVPixelBufferUnlockBaseAddress(_pixelBuffer, 0);
+    CVPixelBufferRelease(_pixelBuffer);
+  }
 }
 
 - (instancetype)copy {
@@ -72,21 +104,21 @@ NSInteger ExecuTorchElementCountOfShape(NSArray<NSNumber *> *shape) {
 }
 
 - (NSArray<NSNumber *> *)shape {
-  if (!_shape) {
+  if (!isUpToDate(_shape, _tensor->sizes())) {
     _shape = utils::toNSArray(_tensor->sizes());
   }
   return _shape;
 }
 
 - (NSArray<NSNumber *> *)dimensionOrder {
-  if (!_dimensionOrder) {
+  if (!isUpToDate(_dimensionOrder, _tensor->dim_order())) {
     _dimensionOrder = utils::toNSArray(_tensor->dim_order());
   }
   return _dimensionOrder;
 }
 
 - (NSArray<NSNumber *> *)strides {
-  if (!_strides) {
+  if (!isUpToDate(_strides, _tensor->strides())) {
     _strides = utils::toNSArray(_tensor->strides());
   }
   return _strides;
@@ -595,3 +627,76 @@ NSInteger ExecuTorchElementCountOfShape(NSArray<NSNumber *> *shape) {
 }
 
 @end
+
+@implementation ExecuTorchTensor (PixelBuffer)
+
+- (nullable instancetype)initWithPixelBuffer:(CVPixelBufferRef)pixelBuffer
+                                       error:(NSError **)error {
+  ET_CHECK(pixelBuffer);
+  NSInteger channels = 0;
+  ExecuTorchDataType dataType = ExecuTorchDataTypeByte;
+  switch (CVPixelBufferGetPixelFormatType(pixelBuffer)) {
+    case kCVPixelFormatType_OneComponent8:
+      channels = 1;
+      break;
+    case kCVPixelFormatType_24RGB:
+    case kCVPixelFormatType_24BGR:
+      channels = 3;
+      break;
+    case kCVPixelFormatType_32ARGB:
+    case kCVPixelFormatType_32BGRA:
+    case kCVPixelFormatType_32RGBA:
+      channels = 4;
+      break;
+    case kCVPixelFormatType_OneComponent16Half:
+    case kCVPixelFormatType_DepthFloat16:
+      channels = 1;
+      dataType = ExecuTorchDataTypeHalf;
+      break;
+    case kCVPixelFormatType_64RGBAHalf:
+      channels = 4;
+      dataType = ExecuTorchDataTypeHalf;
+      break;
+    case kCVPixelFormatType_OneComponent32Float:
+    case kCVPixelFormatType_DepthFloat32:
+      channels = 1;
+      dataType = ExecuTorchDataTypeFloat;
+      break;
+    case kCVPixelFormatType_128RGBAFloat:
+      channels = 4;
+      dataType = ExecuTorchDataTypeFloat;
+      break;
+  }
+  const size_t width = CVPixelBufferGetWidth(pixelBuffer);
+  const size_t height = CVPixelBufferGetHeight(pixelBuffer);
+  // Tensors can't express padded rows, so the rows must be tightly packed.
+  if (channels == 0 || CVPixelBufferIsPlanar(pixelBuffer) ||
+      CVPixelBufferGetBytesPerRow(pixelBuffer) != width * channels * ExecuTorchSizeOfDataType(dataType)) {
+    if (error) {
+      *error = [NSError errorWithDomain:ExecuTorchErrorDomain
+                                   code:(NSInteger)Error::InvalidArgument
+                               userInfo:nil];
+    }
+    return nil;
+  }
+  if (CVPixelBufferLockBaseAddress(pixelBuffer, 0) != kCVReturnSuccess) {
+    if (error) {
+      *error = [NSError errorWithDomain:ExecuTorchErrorDomain
+                                   code:(NSInteger)Error::AccessFailed
+                               userInfo:nil];
+    }
+    return nil;
+  }
+  self = [self initWithBytesNoCopy:CVPixelBufferGetBaseAddress(pixelBuffer)
+                             shape:@[@(height), @(width), @(channels)]
+                          dataType:dataType
+                     shapeDynamism:ExecuTorchShapeDynamismStatic];
+  if (self) {
+    _pixelBuffer = CVPixelBufferRetain(pixelBuffer);
+  } else {
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, 0);
+  }
+  return self;
+}
+
+@end
@@ -61,4 +61,42 @@ class ModuleTest: XCTestCase {
     XCTAssertNoThrow(outputs = try module.forward(inputs))
     XCTAssertEqual(outputs?[0].tensor, Tensor([2], dataType: .float, shapeDynamism: .static))
   }
+
+  func testBindOutput() {
+    guard let modelPath = resourceBundle.path(forResource: "add", ofType: "pte") else {
+      XCTFail("Couldn't find the model file")
+      return
+    }
+    let module = Module(filePath: modelPath)
+    var data: [Float] = [0]
+    let output = data.withUnsafeMutableBytes {
+      Tensor(bytesNoCopy: $0.baseAddress!, shape: [1], dataType: .float)
+    }
+    XCTAssertNoThrow(try module.bindOutput(output, at: 0))
+    let inputs = [Tensor([1], dataType: .float), Tensor([2], dataType: .float)]
+    var outputs: [Value]?
+    XCTAssertNoThrow(outputs = try module.forward(inputs))
+    XCTAssertTrue(outputs?[0].tensor === output)
+    XCTAssertEqual(data, [3])
+
+    XCTAssertNoThrow(try module.bindOutput(nil, at: 0))
+    XCTAssertNoThrow(outputs = try module.forward(inputs))
+    XCTAssertFalse(outputs?[0].tensor === output)
+  }
+
+  func testForwardCompletion() {
+    guard let modelPath = resourceBundle.path(forResource: "add", ofType: "pte") else {
+      XCTFail("Couldn't find the model file")
+      return
+    }
+    let module = Module(filePath: modelPath)
+    let inputs = [Tensor([1], dataType: .float), Tensor([1], dataType: .float)]
+    let expectation = expectation(description: "forward")
+    module.forward(inputs.map { Value($0) }) { outputs, error in
+      XCTAssertNil(error)
+      XCTAssertEqual(outputs?[0].tensor, Tensor([2], dataType: .float, shapeDynamism: .static))
+      expectation.fulfill()
+    }
+    wait(for: [expectation], timeout: 10)
+  }
 }
@@ -8,6 +8,7 @@
 
 @testable import ExecuTorch
 
+import CoreVideo
 import XCTest
 
 class TensorTest: XCTestCase {
@@ -111,6 +112,41 @@ class TensorTest: XCTestCase {
     }
   }
 
+  func testInitPixelBuffer() {
+    var pixelBuffer: CVPixelBuffer?
+    XCTAssertEqual(CVPixelBufferCreate(nil, 16, 2, kCVPixelFormatType_32BGRA, nil, &pixelBuffer), kCVReturnSuccess)
+    guard let pixelBuffer else {
+      XCTFail("Couldn't create the pixel buffer")
+      return
+    }
+    CVPixelBufferLockBaseAddress(pixelBuffer, [])
+    memset(CVPixelBufferGetBaseAddress(pixelBuffer), 7, CVPixelBufferGetDataSize(pixelBuffer))
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, [])
+
+    var tensor: Tensor?
+    XCTAssertNoThrow(tensor = try Tensor(pixelBuffer: pixelBuffer))
+    XCTAssertEqual(tensor?.dataType, .byte)
+    XCTAssertEqual(tensor?.shape, [2, 16, 4])
+    XCTAssertEqual(tensor?.shapeDynamism, .static)
+    tensor?.mutableBytes { pointer, count, dataType in
+      XCTAssertEqual(count, 128)
+      XCTAssertEqual(Array(UnsafeBufferPointer(start: pointer.assumingMemoryBound(to: UInt8.self), count: count)), Array(repeating: 7, count: 128))
+      pointer.assumingMemoryBound(to: UInt8.self)[0] = 1
+    }
+    // The tensor writes to the pixels directly.
+    XCTAssertEqual(CVPixelBufferGetBaseAddress(pixelBuffer)?.assumingMemoryBound(to: UInt8.self)[0], 1)
+  }
+
+  func testInitPixelBufferError() {
+    var pixelBuffer: CVPixelBuffer?
+    XCTAssertEqual(CVPixelBufferCreate(nil, 16, 2, kCVPixelFormatType_420YpCbCr8BiPlanarFullRange, nil, &pixelBuffer), kCVReturnSuccess)
+    guard let pixelBuffer else {
+      XCTFail("Couldn't create the pixel buffer")
+      return
+    }
+    XCTAssertThrowsError(try Tensor(pixelBuffer: pixelBuffer))
+  }
+
   func testWithCustomStridesAndDimensionOrder() {
     let data: [Float] = [1.0, 2.0, 3.0, 4.0]
     let tensor = Tensor(
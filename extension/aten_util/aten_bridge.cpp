@@ -9,7 +9,10 @@
 #include <executorch/extension/aten_util/aten_bridge.h>
 
 #include <executorch/runtime/platform/assert.h>
+#include <algorithm>
+#include <cinttypes>
 #include <cstring>
+#include <numeric>
 
 namespace executorch {
 namespace extension {
@@ -94,6 +97,40 @@ c10::ScalarType executorch_to_torch_scalar_type(
   return static_cast<c10::ScalarType>(intermediate);
 }
 
+executorch::runtime::Result<std::vector<executorch::aten::DimOrderType>>
+get_attensor_dim_order(const at::Tensor& t) {
+  std::vector<executorch::aten::DimOrderType> dim_order(t.dim());
+  std::iota(dim_order.begin(), dim_order.end(), 0);
+  // Outermost dim first. Ties keep the order of the dims, so a contiguous
+  // tensor gets the default dim order even if it has dims of size 1.
+  std::stable_sort(
+      dim_order.begin(),
+      dim_order.end(),
+      [&](executorch::aten::DimOrderType a, executorch::aten::DimOrderType b) {
+        return t.stride(a) > t.stride(b);
+      });
+  if (t.numel() == 0) {
+    return dim_order;
+  }
+  int64_t expected_stride = 1;
+  for (size_t i = dim_order.size(); i > 0; --i) {
+    const auto d = dim_order[i - 1];
+    // The stride of a dim of size 1 is never used.
+    if (t.size(d) == 1) {
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        t.stride(d) == expected_stride,
+        InvalidArgument,
+        "Stride %" PRId64 " of dim %d is not dense, expected %" PRId64,
+        t.stride(d),
+        static_cast<int>(d),
+        expected_stride);
+    expected_stride *= t.size(d);
+  }
+  return dim_order;
+}
+
 /*
  * Following makes two assumptions:
  * 1. aten_tensor's lifetime is longer than the liftime within which mutable_et
@@ -109,13 +146,12 @@ c10::ScalarType executorch_to_torch_scalar_type(
 void alias_etensor_to_attensor(
     at::Tensor& aten_tensor,
     torch::executor::Tensor& mutable_et) {
-  // TODO(kimishpatel): contiguous according to memformat
-  // Right now we assume everything is channels first contiguous
-  // Note that input tensor must be contiguous for us to alias.
-  // Mixing aliasing and copying is dangerous since if we aliased
-  // the instance of mutatble_et to aten_tensor in the previous call,
-  // then in the next call copying will not be the correct behavior.
-  ET_CHECK_MSG(aten_tensor.is_contiguous(), "Input tensor must be contiguous");
+  // The strides of mutable_et follow its dim order, so matching them means
+  // that aten_tensor is dense in that dim order, which need not be the
+  // contiguous one. We never fall back to copying: mixing aliasing and copying
+  // is dangerous since if we aliased the instance of mutatble_et to aten_tensor
+  // in the previous call, then in the next call copying will not be the
+  // correct behavior.
   check_tensor_meta(aten_tensor, mutable_et);
   mutable_et.unsafeGetTensorImpl()->set_data(aten_tensor.mutable_data_ptr());
 }
@@ -139,9 +175,16 @@ at::Tensor alias_attensor_to_etensor(const torch::executor::Tensor& etensor) {
 }
 
 TensorPtr alias_tensor_ptr_to_attensor(at::Tensor& t) {
+  auto dim_order = get_attensor_dim_order(t);
+  ET_CHECK_MSG(
+      dim_order.ok(),
+      "Input tensor must be dense in some dim order, e.g. contiguous or "
+      "channels last");
   return make_tensor_ptr(
       {t.sizes().begin(), t.sizes().end()},
       t.mutable_data_ptr(),
+      std::move(dim_order.get()),
+      {},
       torch::executor::ScalarType(t.scalar_type()));
 }
 
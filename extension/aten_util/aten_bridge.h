@@ -10,6 +10,7 @@
 
 #include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
 
 #include <ATen/Functions.h> // @manual=//caffe2/aten:ATen-cpu
 #include <ATen/Tensor.h> // @manual=//caffe2/aten:ATen-core
@@ -29,7 +30,18 @@ c10::ScalarType executorch_to_torch_scalar_type(
     torch::executor::ScalarType type);
 
 /*
- * @param[in] aten_tensor Input at::Tensor
+ * Returns the dim order in which the at::Tensor is laid out without gaps or
+ * overlaps, e.g. {0, 2, 3, 1} for a channels-last tensor, so that an ETensor
+ * with that dim order can alias its memory. Fails with InvalidArgument for
+ * tensors that no dim order describes, like slices along an inner dim.
+ */
+executorch::runtime::Result<std::vector<executorch::aten::DimOrderType>>
+get_attensor_dim_order(const at::Tensor& t);
+
+/*
+ * @param[in] aten_tensor Input at::Tensor, which must have the sizes, strides
+ * and dtype of mutable_et. It needs not be contiguous, e.g. a channels-last
+ * tensor aliases an ETensor of the same dim order.
  * @param[in,out] mutable_et ETensor whose underlying memory now will alias to
  * aten_tensor
  */
@@ -49,6 +61,11 @@ void alias_etensor_to_attensor(at::Tensor& at, torch::executor::Tensor& et);
  */
 at::Tensor alias_attensor_to_etensor(const torch::executor::Tensor& et);
 
+/*
+ * Returns a TensorPtr that aliases the memory of the at::Tensor, with the dim
+ * order of get_attensor_dim_order(), so that channels-last and other
+ * non-contiguous but dense tensors are not copied.
+ */
 TensorPtr alias_tensor_ptr_to_attensor(at::Tensor& t);
 
 } // namespace extension
@@ -137,6 +137,8 @@ struct type_convert<
         converted_(at::from_blob(
             value_.mutable_data_ptr(),
             std::vector<int64_t>{value_.sizes().begin(), value_.sizes().end()},
+            std::vector<int64_t>{
+                value_.strides().begin(), value_.strides().end()},
             c10::ScalarType(value_.scalar_type()))) {}
 
   ATensor call() {
@@ -154,3 +154,46 @@ TEST(ATenBridgeTest, AliasTensorPtrToATenTensor) {
   alias_etensor_to_attensor(at_tensor, *et_tensor_ptr);
   EXPECT_EQ(at_tensor.const_data_ptr(), et_tensor_ptr->const_data_ptr());
 }
+
+TEST(ATenBridgeTest, GetATenTensorDimOrder) {
+  auto at_tensor = at::empty({2, 3, 4, 5});
+  EXPECT_EQ(
+      *get_attensor_dim_order(at_tensor),
+      (std::vector<Tensor::DimOrderType>{0, 1, 2, 3}));
+  EXPECT_EQ(
+      *get_attensor_dim_order(
+          at_tensor.contiguous(at::MemoryFormat::ChannelsLast)),
+      (std::vector<Tensor::DimOrderType>{0, 2, 3, 1}));
+  // Slicing the outermost dim keeps the tensor dense, an inner one doesn't.
+  EXPECT_EQ(
+      *get_attensor_dim_order(at_tensor.slice(0, 1, 2)),
+      (std::vector<Tensor::DimOrderType>{0, 1, 2, 3}));
+  EXPECT_EQ(
+      get_attensor_dim_order(at_tensor.slice(1, 0, 2)).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      get_attensor_dim_order(at_tensor.expand({2, 2, 3, 4, 5})).error(),
+      Error::InvalidArgument);
+}
+
+TEST(ATenBridgeTest, AliasChannelsLastTensorPtrToATenTensor) {
+  auto at_tensor =
+      at::rand({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast);
+  ASSERT_FALSE(at_tensor.is_contiguous());
+  const auto& et_tensor_ptr = alias_tensor_ptr_to_attensor(at_tensor);
+  EXPECT_EQ(at_tensor.const_data_ptr(), et_tensor_ptr->const_data_ptr());
+  EXPECT_EQ(
+      std::vector<Tensor::DimOrderType>(
+          et_tensor_ptr->dim_order().begin(), et_tensor_ptr->dim_order().end()),
+      (std::vector<Tensor::DimOrderType>{0, 2, 3, 1}));
+  alias_etensor_to_attensor(at_tensor, *et_tensor_ptr);
+
+  // Aliasing back keeps the layout, so the elements are where ATen expects.
+  auto aliased_at_tensor = alias_attensor_to_etensor(*et_tensor_ptr);
+  EXPECT_EQ(aliased_at_tensor.const_data_ptr(), at_tensor.const_data_ptr());
+  EXPECT_EQ(aliased_at_tensor.strides(), at_tensor.strides());
+  EXPECT_TRUE(at::equal(aliased_at_tensor, at_tensor));
+
+  auto sliced_tensor = at_tensor.slice(2, 0, 2);
+  ET_EXPECT_DEATH(alias_tensor_ptr_to_attensor(sliced_tensor), "");
+}
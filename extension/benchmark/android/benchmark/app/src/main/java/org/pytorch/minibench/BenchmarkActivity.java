@@ -67,11 +67,14 @@ public class BenchmarkActivity extends Activity {
           module.forward();
         }
 
+        DeviceMonitor deviceMonitor = new DeviceMonitor(BenchmarkActivity.this);
         for (int i = 0; i < numIter; i++) {
           long start = System.nanoTime();
           module.forward();
           double forwardMs = (System.nanoTime() - start) * 1e-6;
           stats.latency.add(forwardMs);
+          // Out of the timed region.
+          stats.deviceSamples.add(deviceMonitor.sample(i, forwardMs));
         }
         return null;
       }
@@ -86,6 +89,8 @@ public class BenchmarkActivity extends Activity {
         // Avg inference latency after N iterations
         // Currently the result has large variance from outliers, so only use
         // 80% samples in the middle (trimmean 0.2)
+        // How much slower the last iterations ran than the first ones, e.g. when throttled
+        final double sustainedLatencyRatio = DeviceMonitor.sustainedLatencyRatio(stats.latency);
         Collections.sort(stats.latency);
         int resultSize = stats.latency.size();
         List<Double> usedLatencyResults =
@@ -116,6 +121,11 @@ public class BenchmarkActivity extends Activity {
         results.add(
             new BenchmarkMetric(
                 benchmarkModel, "ram_pss_usage(mb)", (Debug.getPss() - pssIdle) / 1024, 0));
+        results.add(
+            new BenchmarkMetric(
+                benchmarkModel, "sustained_latency_ratio", sustainedLatencyRatio, 0.0f));
+        // Thermal state, frequencies and battery current during the iterations
+        results.addAll(DeviceMonitor.summarize(benchmarkModel, stats.deviceSamples));
 
         try (FileWriter writer = new FileWriter(getFilesDir() + "/benchmark_results.json")) {
           Gson gson = new Gson();
@@ -132,6 +142,8 @@ class Stats {
   long loadStart;
   long loadEnd;
   List<Double> latency = new ArrayList<>();
+  // One per iteration, taken right after it
+  List<DeviceMonitor.Sample> deviceSamples = new ArrayList<>();
   int errorCode = 0;
 
   @Override
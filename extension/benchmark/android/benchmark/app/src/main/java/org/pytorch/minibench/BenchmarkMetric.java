@@ -10,6 +10,7 @@ package org.pytorch.minibench;
 
 import android.app.ActivityManager;
 import android.os.Build;
+import java.util.List;
 import java.util.regex.Matcher;
 import java.util.regex.Pattern;
 
@@ -48,6 +49,9 @@ class BenchmarkMetric {
 
   DeviceInfo deviceInfo = new DeviceInfo();
 
+  // The samples of the "device_samples" metric, null for the others.
+  List<DeviceMonitor.Sample> samples;
+
   public BenchmarkMetric(
       final BenchmarkModel benchmarkModel,
       final String metric,
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+package org.pytorch.minibench;
+
+import android.content.Context;
+import android.os.BatteryManager;
+import android.os.Build;
+import android.os.PowerManager;
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Samples the thermal state, the CPU and GPU frequencies and the battery current of the device
+ * during a benchmark, for the samples of a BenchmarkMetric and the metrics of summarize(). Fields
+ * that the device doesn't report are left null, and Gson leaves them out of the JSON.
+ */
+class DeviceMonitor {
+  static class Sample {
+    // The iteration, or the token for LLMs, that the sample follows.
+    final int iteration;
+    final double timestampMs;
+    // The latency of the iteration, if any.
+    final Double latencyMs;
+    // One of PowerManager.THERMAL_STATUS_*, from NONE (0) to SHUTDOWN (6).
+    Integer thermalStatus;
+    // How close the device is to severe throttling: 1.0 is THERMAL_STATUS_SEVERE.
+    Float thermalHeadroom;
+    long[] cpuFreqKhz;
+    Long gpuFreqHz;
+    // Negative when discharging on most devices.
+    Long batteryCurrentUa;
+    Long batteryEnergyNwh;
+
+    Sample(int iteration, double timestampMs, Double latencyMs) {
+      this.iteration = iteration;
+      this.timestampMs = timestampMs;
+      this.latencyMs = latencyMs;
+    }
+  }
+
+  private static final String CPU_ROOT = "/sys/devices/system/cpu";
+  private static final String KGSL_GPU_CLOCK = "/sys/class/kgsl/kgsl-3d0/gpuclk";
+  private static final String DEVFREQ_ROOT = "/sys/class/devfreq";
+
+  private final PowerManager mPowerManager;
+  private final BatteryManager mBatteryManager;
+  private final long mStartNanos = System.nanoTime();
+  private final List<String> mCpuFreqPaths = new ArrayList<>();
+  private String mGpuFreqPath;
+
+  DeviceMonitor(Context context) {
+    mPowerManager = (PowerManager) context.getSystemService(Context.POWER_SERVICE);
+    mBatteryManager = (BatteryManager) context.getSystemService(Context.BATTERY_SERVICE);
+
+    // Look the files up once, keeping the ones the app is allowed to read.
+    for (int cpu = 0; cpu < Runtime.getRuntime().availableProcessors(); cpu++) {
+      final String path = CPU_ROOT + "/cpu" + cpu + "/cpufreq/scaling_cur_freq";
+      if (readLong(path) != null) {
+        mCpuFreqPaths.add(path);
+      }
+    }
+    if (readLong(KGSL_GPU_CLOCK) != null) {
+      mGpuFreqPath = KGSL_GPU_CLOCK;
+    } else {
+      // Mali and other GPUs are devfreq devices named after the GPU.
+      final String[] devices = new File(DEVFREQ_ROOT).list();
+      if (devices != null) {
+        for (String device : devices) {
+          final String path = DEVFREQ_ROOT + "/" + device + "/cur_freq";
+          if ((device.contains("gpu") || device.contains("mali")) && readLong(path) != null) {
+            mGpuFreqPath = path;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  /** Reads the current state of the device. */
+  Sample sample(int iteration, Double latencyMs) {
+    final Sample sample =
+        new Sample(iteration, (System.nanoTime() - mStartNanos) * 1e-6, latencyMs);
+    if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+      sample.thermalStatus = mPowerManager.getCurrentThermalStatus();
+    }
+    if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+      final float headroom = mPowerManager.getThermalHeadroom(0);
+      if (!Float.isNaN(headroom)) {
+        sample.thermalHeadroom = headroom;
+      }
+    }
+    if (!mCpuFreqPaths.isEmpty()) {
+      sample.cpuFreqKhz = new long[mCpuFreqPaths.size()];
+      for (int i = 0; i < mCpuFreqPaths.size(); i++) {
+        final Long freq = readLong(mCpuFreqPaths.get(i));
+        sample.cpuFreqKhz[i] = freq != null ? freq : 0;
+      }
+    }
+    if (mGpuFreqPath != null) {
+      sample.gpuFreqHz = readLong(mGpuFreqPath);
+    }
+    sample.batteryCurrentUa =
+        readBatteryProperty(BatteryManager.BATTERY_PROPERTY_CURRENT_NOW);
+    sample.batteryEnergyNwh =
+        readBatteryProperty(BatteryManager.BATTERY_PROPERTY_ENERGY_COUNTER);
+    return sample;
+  }
+
+  /**
+   * Summarizes the samples as metrics, to be reported next to the latency ones, followed by a
+   * "device_samples" metric that holds the samples themselves.
+   */
+  static List<BenchmarkMetric> summarize(
+      final BenchmarkMetric.BenchmarkModel benchmarkModel, final List<Sample> samples) {
+    final List<BenchmarkMetric> metrics = new ArrayList<>();
+    if (samples.isEmpty()) {
+      return metrics;
+    }
+    Integer maxThermalStatus = null;
+    Float minThermalHeadroom = null;
+    Double minCpuFreqMhz = null;
+    Long minGpuFreqHz = null;
+    double currentSumUa = 0;
+    int numCurrents = 0;
+    for (Sample sample : samples) {
+      if (sample.thermalStatus != null) {
+        maxThermalStatus =
+            maxThermalStatus == null
+                ? sample.thermalStatus
+                : Math.max(maxThermalStatus, sample.thermalStatus);
+      }
+      if (sample.thermalHeadroom != null) {
+        minThermalHeadroom =
+            minThermalHeadroom == null
+                ? sample.thermalHeadroom
+                : Math.min(minThermalHeadroom, sample.thermalHeadroom);
+      }
+      if (sample.cpuFreqKhz != null && sample.cpuFreqKhz.length > 0) {
+        double sum = 0;
+        for (long freq : sample.cpuFreqKhz) {
+          sum += freq;
+        }
+        final double meanMhz = sum / sample.cpuFreqKhz.length / 1000;
+        minCpuFreqMhz = minCpuFreqMhz == null ? meanMhz : Math.min(minCpuFreqMhz, meanMhz);
+      }
+      if (sample.gpuFreqHz != null) {
+        minGpuFreqHz =
+            minGpuFreqHz == null ? sample.gpuFreqHz : Math.min(minGpuFreqHz, sample.gpuFreqHz);
+      }
+      if (sample.batteryCurrentUa != null) {
+        currentSumUa += sample.batteryCurrentUa;
+        numCurrents++;
+      }
+    }
+
+    if (maxThermalStatus != null) {
+      metrics.add(new BenchmarkMetric(benchmarkModel, "max_thermal_status", maxThermalStatus, 0));
+    }
+    if (minThermalHeadroom != null) {
+      metrics.add(
+          new BenchmarkMetric(benchmarkModel, "min_thermal_headroom", minThermalHeadroom, 0));
+    }
+    if (minCpuFreqMhz != null) {
+      metrics.add(new BenchmarkMetric(benchmarkModel, "min_cpu_freq(mhz)", minCpuFreqMhz, 0));
+    }
+    if (minGpuFreqHz != null) {
+      metrics.add(
+          new BenchmarkMetric(benchmarkModel, "min_gpu_freq(mhz)", minGpuFreqHz * 1e-6, 0));
+    }
+    if (numCurrents > 0) {
+      metrics.add(
+          new BenchmarkMetric(
+              benchmarkModel, "avg_battery_current(ma)", currentSumUa / numCurrents / 1000, 0));
+    }
+    final Sample first = samples.get(0);
+    final Sample last = samples.get(samples.size() - 1);
+    if (samples.size() >= 2 && first.batteryEnergyNwh != null && last.batteryEnergyNwh != null) {
+      // The counter decreases as the battery discharges.
+      metrics.add(
+          new BenchmarkMetric(
+              benchmarkModel,
+              "battery_energy(mwh)",
+              (first.batteryEnergyNwh - last.batteryEnergyNwh) * 1e-6,
+              0));
+    }
+    final BenchmarkMetric samplesMetric =
+        new BenchmarkMetric(benchmarkModel, "device_samples", samples.size(), 0);
+    samplesMetric.samples = samples;
+    metrics.add(samplesMetric);
+    return metrics;
+  }
+
+  /**
+   * The ratio of the average of the last tenth of the latencies to the average of their first
+   * tenth, in the order the iterations ran. Above 1 when the device slowed down during the
+   * benchmark, e.g. because it throttled.
+   */
+  static double sustainedLatencyRatio(final List<Double> latencies) {
+    final int n = Math.max(latencies.size() / 10, 1);
+    if (latencies.size() < 2 * n) {
+      return 1;
+    }
+    double first = 0;
+    double last = 0;
+    for (int i = 0; i < n; i++) {
+      first += latencies.get(i);
+      last += latencies.get(latencies.size() - n + i);
+    }
+    return first > 0 ? last / first : 1;
+  }
+
+  private Long readBatteryProperty(int property) {
+    // Devices that don't support the property return Long.MIN_VALUE, or 0 on older releases.
+    final long value = mBatteryManager.getLongProperty(property);
+    return value != Long.MIN_VALUE && value != 0 ? value : null;
+  }
+
+  private static Long readLong(final String path) {
+    try (BufferedReader reader = new BufferedReader(new FileReader(path))) {
+      final String line = reader.readLine();
+      return line != null ? Long.parseLong(line.trim()) : null;
+    } catch (IOException | NumberFormatException e) {
+      return null;
+    }
+  }
+}
@@ -29,6 +29,10 @@ public class LlmBenchmarkActivity extends Activity implements ModelRunnerCallbac
 
   String mPrompt;
   StatsInfo mStatsInfo;
+  DeviceMonitor mDeviceMonitor;
+
+  // Sample the device every this many tokens, to follow throttling over the generation
+  private static final int TOKENS_PER_DEVICE_SAMPLE = 16;
 
   @Override
   protected void onCreate(Bundle savedInstanceState) {
@@ -71,12 +75,19 @@ public class LlmBenchmarkActivity extends Activity implements ModelRunnerCallbac
       onGenerationStopped();
       return;
     }
+    mDeviceMonitor = new DeviceMonitor(this);
+    mStatsInfo.deviceSamples.add(mDeviceMonitor.sample(0, null));
     mStatsInfo.generateStart = System.nanoTime();
     mModelRunner.generate(mPrompt);
   }
 
   @Override
-  public void onTokenGenerated(String token) {}
+  public void onTokenGenerated(String token) {
+    mStatsInfo.numTokens++;
+    if (mStatsInfo.numTokens % TOKENS_PER_DEVICE_SAMPLE == 0) {
+      mStatsInfo.deviceSamples.add(mDeviceMonitor.sample(mStatsInfo.numTokens, null));
+    }
+  }
 
   @Override
   public void onStats(String stats) {
@@ -86,6 +97,9 @@ public class LlmBenchmarkActivity extends Activity implements ModelRunnerCallbac
   @Override
   public void onGenerationStopped() {
     mStatsInfo.generateEnd = System.nanoTime();
+    if (mDeviceMonitor != null) {
+      mStatsInfo.deviceSamples.add(mDeviceMonitor.sample(mStatsInfo.numTokens, null));
+    }
 
     final BenchmarkMetric.BenchmarkModel benchmarkModel =
         BenchmarkMetric.extractBackendAndQuantization(mStatsInfo.modelName);
@@ -110,6 +124,9 @@ public class LlmBenchmarkActivity extends Activity implements ModelRunnerCallbac
     // Token per second
     results.add(
         new BenchmarkMetric(benchmarkModel, "token_per_sec", extractTPS(mStatsInfo.tokens), 0.0f));
+    // Thermal state, frequencies and battery current during the generation, sampled every
+    // TOKENS_PER_DEVICE_SAMPLE tokens
+    results.addAll(DeviceMonitor.summarize(benchmarkModel, mStatsInfo.deviceSamples));
 
     try (FileWriter writer = new FileWriter(getFilesDir() + "/benchmark_results.json")) {
       Gson gson = new Gson();
@@ -137,6 +154,8 @@ class StatsInfo {
   long generateEnd;
   String tokens;
   String modelName;
+  int numTokens;
+  List<DeviceMonitor.Sample> deviceSamples = new ArrayList<>();
 
   @Override
   public String toString() {
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#import <XCTest/XCTest.h>
+
+/**
+ * DeviceConditionsMetric records the conditions of the device during each
+ * iteration of a measured block, next to its clock and memory metrics, so
+ * that slow iterations can be told apart from throttled ones:
+ * - "Thermal State", the highest NSProcessInfoThermalState at the start and
+ *   the end of the iteration, from 0 (nominal) to 3 (critical);
+ * - "Low Power Mode", 1 if it was on at the end of the iteration, when iOS
+ *   lowers the CPU and GPU frequencies;
+ * - "Battery Level", in percent at the end of the iteration, on iOS only.
+ */
+@interface DeviceConditionsMetric : NSObject<XCTMetric>
+@end
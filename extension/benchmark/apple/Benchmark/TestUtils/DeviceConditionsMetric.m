@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#import "DeviceConditionsMetric.h"
+
+#if TARGET_OS_IOS
+#import <UIKit/UIKit.h>
+#endif
+
+@implementation DeviceConditionsMetric {
+  NSProcessInfoThermalState _startThermalState;
+}
+
+- (instancetype)init {
+  if (self = [super init]) {
+#if TARGET_OS_IOS
+    UIDevice.currentDevice.batteryMonitoringEnabled = YES;
+#endif
+  }
+  return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+  return [[[self class] allocWithZone:zone] init];
+}
+
+- (void)willBeginMeasuring {
+  _startThermalState = NSProcessInfo.processInfo.thermalState;
+}
+
+- (NSArray<XCTPerformanceMeasurement *> *)
+    reportMeasurementsFromStartTime:
+        (XCTPerformanceMeasurementTimestamp *)startTime
+                          toEndTime:
+                              (XCTPerformanceMeasurementTimestamp *)endTime
+                              error:(NSError **)error {
+  NSProcessInfo *processInfo = NSProcessInfo.processInfo;
+  NSMutableArray<XCTPerformanceMeasurement *> *measurements = [@[
+    [[XCTPerformanceMeasurement alloc]
+        initWithIdentifier:@"DeviceConditionsMetric.thermalState"
+               displayName:@"Thermal State"
+               doubleValue:MAX(_startThermalState, processInfo.thermalState)
+                unitSymbol:@"level"],
+    [[XCTPerformanceMeasurement alloc]
+        initWithIdentifier:@"DeviceConditionsMetric.lowPowerMode"
+               displayName:@"Low Power Mode"
+               doubleValue:processInfo.lowPowerModeEnabled ? 1 : 0
+                unitSymbol:@"on"],
+  ] mutableCopy];
+#if TARGET_OS_IOS
+  const float batteryLevel = UIDevice.currentDevice.batteryLevel;
+  // -1 when unknown, e.g. on the simulator.
+  if (batteryLevel >= 0) {
+    [measurements addObject:[[XCTPerformanceMeasurement alloc]
+                                initWithIdentifier:
+                                    @"DeviceConditionsMetric.batteryLevel"
+                                       displayName:@"Battery Level"
+                                       doubleValue:batteryLevel * 100
+                                        unitSymbol:@"%"]];
+  }
+#endif
+  return measurements;
+}
+
+@end
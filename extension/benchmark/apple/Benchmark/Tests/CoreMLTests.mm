@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#import "DeviceConditionsMetric.h"
 #import "ResourceTestCase.h"
 
 #import <CoreML/CoreML.h>
@@ -90,7 +91,7 @@ static NSMutableDictionary *DummyInputsForModel(MLModel *model, NSError **error)
         XCTFail(@"Failed to create input provider: %@", error.localizedDescription);
         return;
       }
-      [testCase measureWithMetrics:@[[XCTClockMetric new], [XCTMemoryMetric new]]
+      [testCase measureWithMetrics:@[[XCTClockMetric new], [XCTMemoryMetric new], [DeviceConditionsMetric new]]
                              block:^{
         NSError *error = nil;
         id<MLFeatureProvider> prediction = [model predictionFromFeatures:featureProvider error:&error];
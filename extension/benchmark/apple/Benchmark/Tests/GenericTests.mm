@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#import "DeviceConditionsMetric.h"
 #import "ResourceTestCase.h"
 
 #import <executorch/extension/module/module.h>
@@ -48,7 +49,11 @@ using namespace ::executorch::runtime;
   return @{
     @"load" : ^(XCTestCase *testCase){
       [testCase
-          measureWithMetrics:@[ [XCTClockMetric new], [XCTMemoryMetric new] ]
+          measureWithMetrics:@[
+            [XCTClockMetric new],
+            [XCTMemoryMetric new],
+            [DeviceConditionsMetric new],
+          ]
                        block:^{
                          XCTAssertEqual(
                              Module(modelPath.UTF8String).load_forward(),
@@ -87,7 +92,11 @@ using namespace ::executorch::runtime;
       }
       XCTMeasureOptions *options = [[XCTMeasureOptions alloc] init];
       options.iterationCount = 20;
-      [testCase measureWithMetrics:@[ [XCTClockMetric new], [XCTMemoryMetric new] ]
+      [testCase measureWithMetrics:@[
+        [XCTClockMetric new],
+        [XCTMemoryMetric new],
+        [DeviceConditionsMetric new],
+      ]
                             options:options
                             block:^{
                               XCTAssertEqual(module->forward().error(), Error::Ok);
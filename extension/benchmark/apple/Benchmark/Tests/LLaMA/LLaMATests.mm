@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#import "DeviceConditionsMetric.h"
 #import "ResourceTestCase.h"
 
 #import <executorch/examples/models/llama/runner/runner.h>
@@ -82,7 +83,12 @@ using namespace ::executorch::runtime;
         return;
       }
       TokensPerSecondMetric *tokensPerSecondMetric = [TokensPerSecondMetric new];
-      [testCase measureWithMetrics:@[ tokensPerSecondMetric, [XCTClockMetric new], [XCTMemoryMetric new] ]
+      [testCase measureWithMetrics:@[
+        tokensPerSecondMetric,
+        [XCTClockMetric new],
+        [XCTMemoryMetric new],
+        [DeviceConditionsMetric new],
+      ]
                             block:^{
                               tokensPerSecondMetric.tokenCount = 0;
                               const auto status = runner->generate(
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that can also load data without blocking the caller.
+ *
+ * Code that knows it will need several ranges of the data source, such as a
+ * weight loader walking a list of segments, can issue all of the loads up
+ * front and wait for them together, letting the implementation keep several
+ * reads in flight at once.
+ */
+class AsyncDataLoader : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * Starts loading data from the underlying data source into the provided
+   * buffer, and returns without waiting for the load to finish.
+   *
+   * NOTE: This must be thread-safe. If this call modifies common state, the
+   * implementation must do its own locking.
+   *
+   * @param offset The byte offset in the data source to start loading from.
+   * @param size The number of bytes to load.
+   * @param segment_info Information about the segment being loaded.
+   * @param buffer The buffer to load data into. Must point to at least `size`
+   *     bytes of memory, and must stay valid until the returned future is
+   *     ready.
+   *
+   * @returns A future that becomes ready once the load has finished,
+   *     holding an Error that indicates whether it succeeded.
+   */
+  ET_NODISCARD virtual std::future<executorch::runtime::Error> load_async(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const = 0;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/async_file_data_loader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <executorch/runtime/platform/compat_unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+#if defined(__linux__) && defined(O_DIRECT)
+#define ET_HAVE_O_DIRECT 1
+#else
+#define ET_HAVE_O_DIRECT 0
+#endif
+
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+bool is_power_of_2(size_t value) {
+  return value > 0 && (value & ~(value - 1)) == value;
+}
+
+bool is_aligned(uintptr_t value, size_t alignment) {
+  return (value & (alignment - 1)) == 0;
+}
+
+/// The state shared by all of the chunks of one load.
+struct LoadRequest {
+  std::promise<Error> promise;
+  /// The number of chunks that have not been read yet.
+  std::atomic<size_t> remaining_chunks{0};
+  /// The first error seen by any chunk.
+  std::atomic<Error> error{Error::Ok};
+};
+
+/// A contiguous part of a load that a single worker reads.
+struct Chunk {
+  std::shared_ptr<LoadRequest> request;
+  size_t offset;
+  size_t size;
+  uint8_t* buffer;
+};
+
+/**
+ * FreeableBuffer::FreeFn-compatible callback.
+ *
+ * `context` is actually a ptrdiff_t value (not a pointer) that contains the
+ * offset in bytes between `data` and the actual pointer to free.
+ */
+void FreeSegment(void* context, void* data, ET_UNUSED size_t size) {
+  ptrdiff_t offset = reinterpret_cast<ptrdiff_t>(context);
+  ET_DCHECK_MSG(offset >= 0, "Unexpected offset %ld", (long int)offset);
+  std::free(static_cast<uint8_t*>(data) - offset);
+}
+
+} // namespace
+
+struct AsyncFileDataLoader::State {
+  State(
+      int fd_,
+      int direct_fd_,
+      size_t file_size_,
+      const Config& config_,
+      const char* file_name_)
+      : fd(fd_),
+        direct_fd(direct_fd_),
+        file_size(file_size_),
+        config(config_),
+        file_name(file_name_) {}
+
+  ~State() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    cv.notify_all();
+    // Workers only exit once the queue is empty, so every outstanding future
+    // becomes ready before the file is closed.
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    if (direct_fd >= 0) {
+      ::close(direct_fd);
+    }
+    ::close(fd);
+    std::free(const_cast<char*>(file_name));
+  }
+
+  void run_worker() {
+    while (true) {
+      Chunk chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+          return;
+        }
+        chunk = std::move(queue.front());
+        queue.pop_front();
+      }
+      Error err = read_chunk(chunk);
+      LoadRequest& request = *chunk.request;
+      if (err != Error::Ok) {
+        Error expected = Error::Ok;
+        request.error.compare_exchange_strong(expected, err);
+      }
+      if (request.remaining_chunks.fetch_sub(1) == 1) {
+        request.promise.set_value(request.error.load());
+      }
+    }
+  }
+
+  Error read_chunk(const Chunk& chunk) const {
+    // Direct I/O needs the file offset, size, and buffer to all be aligned.
+    // Anything else goes through the page cache.
+    const int read_fd = direct_fd >= 0 &&
+            is_aligned(chunk.offset, kDirectIoAlignment) &&
+            is_aligned(chunk.size, kDirectIoAlignment) &&
+            is_aligned(
+                reinterpret_cast<uintptr_t>(chunk.buffer), kDirectIoAlignment)
+        ? direct_fd
+        : fd;
+
+    size_t needed = chunk.size;
+    size_t offset = chunk.offset;
+    uint8_t* buf = chunk.buffer;
+    while (needed > 0) {
+      // Reads on macOS will fail with EINVAL if size > INT32_MAX.
+      const auto read_size = std::min<size_t>(
+          needed, static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+      const auto nread = ::pread(read_fd, buf, read_size, offset);
+      if (nread < 0 && errno == EINTR) {
+        // Interrupted by a signal; zero bytes read.
+        continue;
+      }
+      if (nread <= 0) {
+        // nread == 0 means EOF, which we shouldn't see if we were able to read
+        // the full amount. nread < 0 means an error occurred.
+        ET_LOG(
+            Error,
+            "Reading from %s: failed to read %zu bytes at offset %zu: %s",
+            file_name,
+            chunk.size,
+            chunk.offset,
+            nread == 0 ? "EOF" : strerror(errno));
+        return Error::AccessFailed;
+      }
+      needed -= nread;
+      buf += nread;
+      offset += nread;
+    }
+    return Error::Ok;
+  }
+
+  const int fd;
+  /// A second descriptor for the same file opened with O_DIRECT, or -1.
+  const int direct_fd;
+  const size_t file_size;
+  const Config config;
+  const char* const file_name; // Owned by the instance.
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Chunk> queue;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+};
+
+Result<AsyncFileDataLoader> AsyncFileDataLoader::from(
+    const char* file_name,
+    const Config& config) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_power_of_2(config.alignment),
+      InvalidArgument,
+      "Alignment %zu is not a power of 2",
+      config.alignment);
+  ET_CHECK_OR_RETURN_ERROR(
+      config.num_threads > 0, InvalidArgument, "num_threads must be > 0");
+  ET_CHECK_OR_RETURN_ERROR(
+      config.chunk_size > 0 && config.chunk_size % kDirectIoAlignment == 0,
+      InvalidArgument,
+      "chunk_size %zu is not a non-zero multiple of %zu",
+      config.chunk_size,
+      kDirectIoAlignment);
+
+  int fd = ::open(file_name, O_RDONLY);
+  if (fd < 0) {
+    ET_LOG(
+        Error, "Failed to open %s: %s (%d)", file_name, strerror(errno), errno);
+    return Error::AccessFailed;
+  }
+
+  // Cache the file size.
+  struct stat st;
+  int err = ::fstat(fd, &st);
+  if (err < 0) {
+    ET_LOG(
+        Error,
+        "Could not get length of %s: %s (%d)",
+        file_name,
+        ::strerror(errno),
+        errno);
+    ::close(fd);
+    return Error::AccessFailed;
+  }
+  size_t file_size = st.st_size;
+
+  int direct_fd = -1;
+#if ET_HAVE_O_DIRECT
+  if (config.use_direct_io) {
+    direct_fd = ::open(file_name, O_RDONLY | O_DIRECT);
+    if (direct_fd < 0) {
+      // Some filesystems (e.g. tmpfs) don't support O_DIRECT. Reads still
+      // work through the regular descriptor.
+      ET_LOG(
+          Info,
+          "O_DIRECT not available for %s: %s (%d)",
+          file_name,
+          strerror(errno),
+          errno);
+    }
+  }
+#endif // ET_HAVE_O_DIRECT
+
+  // Copy the filename so we can print better debug messages if reads fail.
+  const char* file_name_copy = ::strdup(file_name);
+  if (file_name_copy == nullptr) {
+    ET_LOG(Error, "strdup(%s) failed", file_name);
+    if (direct_fd >= 0) {
+      ::close(direct_fd);
+    }
+    ::close(fd);
+    return Error::MemoryAllocationFailed;
+  }
+
+  // From here on, State owns the descriptors and the name.
+  auto state = std::make_unique<State>(
+      fd, direct_fd, file_size, config, file_name_copy);
+  state->workers.reserve(config.num_threads);
+  for (size_t i = 0; i < config.num_threads; ++i) {
+    State* s = state.get();
+    state->workers.emplace_back([s] { s->run_worker(); });
+  }
+  return AsyncFileDataLoader(std::move(state));
+}
+
+AsyncFileDataLoader::AsyncFileDataLoader(std::unique_ptr<State> state)
+    : state_(std::move(state)) {}
+
+AsyncFileDataLoader::AsyncFileDataLoader(AsyncFileDataLoader&& rhs) noexcept =
+    default;
+
+AsyncFileDataLoader::~AsyncFileDataLoader() = default;
+
+std::future<Error> AsyncFileDataLoader::load_async(
+    size_t offset,
+    size_t size,
+    ET_UNUSED const SegmentInfo& segment_info,
+    void* buffer) const {
+  auto request = std::make_shared<LoadRequest>();
+  std::future<Error> future = request->promise.get_future();
+  auto fail = [&](Error err) {
+    request->promise.set_value(err);
+    return std::move(future);
+  };
+
+  if (state_ == nullptr) {
+    // Probably had its value moved to another instance.
+    ET_LOG(Error, "Uninitialized");
+    return fail(Error::InvalidState);
+  }
+  if (offset + size > state_->file_size) {
+    ET_LOG(
+        Error,
+        "File %s: offset %zu + size %zu > file_size_ %zu",
+        state_->file_name,
+        offset,
+        size,
+        state_->file_size);
+    return fail(Error::InvalidArgument);
+  }
+  if (buffer == nullptr) {
+    ET_LOG(Error, "Provided buffer cannot be null");
+    return fail(Error::InvalidArgument);
+  }
+  if (size == 0) {
+    return fail(Error::Ok);
+  }
+
+  // Split the load at multiples of chunk_size in the file, so that every chunk
+  // except possibly the first and last is aligned for direct I/O.
+  const size_t chunk_size = state_->config.chunk_size;
+  std::vector<Chunk> chunks;
+  const size_t end = offset + size;
+  for (size_t begin = offset; begin < end;) {
+    const size_t next = std::min(end, (begin / chunk_size + 1) * chunk_size);
+    chunks.push_back(
+        {request,
+         begin,
+         next - begin,
+         static_cast<uint8_t*>(buffer) + (begin - offset)});
+    begin = next;
+  }
+  request->remaining_chunks.store(chunks.size());
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    for (auto& chunk : chunks) {
+      state_->queue.push_back(std::move(chunk));
+    }
+  }
+  state_->cv.notify_all();
+  return future;
+}
+
+Error AsyncFileDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  return load_async(offset, size, segment_info, buffer).get();
+}
+
+Result<FreeableBuffer> AsyncFileDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      state_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= state_->file_size,
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > file_size_ %zu",
+      state_->file_name,
+      offset,
+      size,
+      state_->file_size);
+
+  // Don't bother allocating/freeing for empty segments.
+  if (size == 0) {
+    return FreeableBuffer(nullptr, 0, /*free_fn=*/nullptr);
+  }
+
+  // When possible, place the data so that file offsets that are aligned for
+  // direct I/O land on aligned addresses. That only works if the skew this
+  // needs still satisfies the requested alignment; otherwise the chunks are
+  // read through the page cache.
+  size_t alignment = state_->config.alignment;
+  size_t skew = 0;
+  if (state_->direct_fd >= 0 &&
+      is_aligned(offset % kDirectIoAlignment, alignment)) {
+    alignment = std::max(alignment, kDirectIoAlignment);
+    skew = offset % kDirectIoAlignment;
+  }
+  const size_t alloc_size = size + alignment + skew;
+  void* buffer = std::malloc(alloc_size);
+  if (buffer == nullptr) {
+    ET_LOG(
+        Error,
+        "Reading from %s at offset %zu: malloc(%zd) failed",
+        state_->file_name,
+        offset,
+        size);
+    return Error::MemoryAllocationFailed;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+  addr = ((addr + alignment - 1) & ~(alignment - 1)) + skew;
+  void* aligned_buffer = reinterpret_cast<void*>(addr);
+
+  Error err = load_into(offset, size, segment_info, aligned_buffer);
+  if (err != Error::Ok) {
+    std::free(buffer);
+    return err;
+  }
+  return FreeableBuffer(
+      aligned_buffer,
+      size,
+      FreeSegment,
+      /*free_fn_context=*/
+      reinterpret_cast<void*>(
+          reinterpret_cast<intptr_t>(aligned_buffer) -
+          reinterpret_cast<intptr_t>(buffer)));
+}
+
+Result<size_t> AsyncFileDataLoader::size() const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      state_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+  return state_->file_size;
+}
+
+} // namespace extension
+} // namespace executorch
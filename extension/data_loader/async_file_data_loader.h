@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <memory>
+
+#include <executorch/extension/data_loader/async_data_loader.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that reads from a file using a pool of worker threads.
+ *
+ * Each load is split into chunks that the workers read concurrently with
+ * pread(), so large loads, and many loads issued through load_async(), keep
+ * several requests in flight instead of being bounded by one blocking syscall
+ * at a time. This matters most for multi-gigabyte weights on fast storage.
+ *
+ * On Linux, the loader can also bypass the page cache with O_DIRECT for the
+ * parts of each load that meet the alignment that direct I/O requires. The
+ * buffers returned by load() are laid out so that this is always possible;
+ * buffers passed to load_into() and load_async() use direct I/O only where
+ * they happen to be suitably aligned.
+ */
+class AsyncFileDataLoader final : public AsyncDataLoader {
+ public:
+  /**
+   * Options for creating an AsyncFileDataLoader.
+   */
+  struct Config {
+    /// The alignment of the data returned by load(). Must be a power of 2.
+    size_t alignment = alignof(std::max_align_t);
+    /// The number of worker threads. Must be greater than zero.
+    size_t num_threads = 4;
+    /// Loads are split into chunks of at most this many bytes, which are
+    /// read in parallel. Must be a non-zero multiple of kDirectIoAlignment.
+    size_t chunk_size = 4 * 1024 * 1024;
+    /// If true, uses O_DIRECT reads where possible. Ignored on platforms that
+    /// don't support O_DIRECT.
+    bool use_direct_io = false;
+  };
+
+  /// The offset, size, and buffer alignment needed for direct I/O.
+  static constexpr size_t kDirectIoAlignment = 4096;
+
+  /**
+   * Creates a new AsyncFileDataLoader that wraps the named file and starts
+   * its worker threads.
+   *
+   * @param[in] file_name Path to the file to read from.
+   * @param[in] config Options for the loader.
+   *
+   * @returns A new AsyncFileDataLoader on success.
+   * @retval Error::InvalidArgument `config` is invalid.
+   * @retval Error::AccessFailed `file_name` could not be opened, or its size
+   *     could not be found.
+   * @retval Error::MemoryAllocationFailed Internal memory allocation failure.
+   */
+  static executorch::runtime::Result<AsyncFileDataLoader> from(
+      const char* file_name,
+      const Config& config);
+
+  /// Creates an AsyncFileDataLoader with the default Config.
+  static executorch::runtime::Result<AsyncFileDataLoader> from(
+      const char* file_name) {
+    return from(file_name, Config());
+  }
+
+  // Movable to be compatible with Result.
+  AsyncFileDataLoader(AsyncFileDataLoader&& rhs) noexcept;
+
+  /// Waits for all outstanding loads to finish, then stops the workers.
+  ~AsyncFileDataLoader() override;
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD std::future<executorch::runtime::Error> load_async(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+ private:
+  struct State;
+
+  explicit AsyncFileDataLoader(std::unique_ptr<State> state);
+
+  // Not safely copyable.
+  AsyncFileDataLoader(const AsyncFileDataLoader&) = delete;
+  AsyncFileDataLoader& operator=(const AsyncFileDataLoader&) = delete;
+  AsyncFileDataLoader& operator=(AsyncFileDataLoader&&) = delete;
+
+  // Owns the file descriptors and the worker threads. Null if this instance
+  // was moved from.
+  std::unique_ptr<State> state_;
+};
+
+} // namespace extension
+} // namespace executorch
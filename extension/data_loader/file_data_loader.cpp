@@ -19,6 +19,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <executorch/extension/data_loader/prefetch_util.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/log.h>
@@ -294,5 +295,26 @@ ET_NODISCARD Error FileDataLoader::load_into(
   return Error::Ok;
 }
 
+ET_NODISCARD Error FileDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    ET_UNUSED const SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= file_size_,
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > file_size_ %zu",
+      file_name_,
+      offset,
+      size,
+      file_size_);
+  internal::prefetch_file_range(fd_, offset, size, file_name_);
+  return Error::Ok;
+}
+
 } // namespace extension
 } // namespace executorch
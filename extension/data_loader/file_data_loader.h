@@ -72,6 +72,11 @@ class FileDataLoader final : public executorch::runtime::DataLoader {
 
   ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
 
+  ET_NODISCARD executorch::runtime::Error prefetch(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const override;
+
   ET_NODISCARD executorch::runtime::Error load_into(
       size_t offset,
       size_t size,
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/file_verification_cache.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+/// The number of bytes at each end of the program data that are hashed.
+constexpr size_t kHashedBytes = 4096;
+
+/// Mixes `size` bytes at `data` into the FNV-1a hash `hash`.
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+} // namespace
+
+Result<FileVerificationCache> FileVerificationCache::from(
+    const char* file_name,
+    const char* cache_dir) {
+  ET_CHECK_OR_RETURN_ERROR(
+      cache_dir != nullptr && cache_dir[0] != '\0',
+      InvalidArgument,
+      "Cache directory must not be empty");
+  Result<FileIdentity> file = FileIdentity::of(file_name);
+  if (!file.ok()) {
+    return file.error();
+  }
+  return FileVerificationCache(file.get(), cache_dir);
+}
+
+std::string FileVerificationCache::marker_path(
+    const void* data,
+    size_t size) const {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = fnv1a(hash, &file_.device, sizeof(file_.device));
+  hash = fnv1a(hash, &file_.inode, sizeof(file_.inode));
+  hash = fnv1a(hash, &file_.file_size, sizeof(file_.file_size));
+  hash = fnv1a(
+      hash, &file_.modification_time, sizeof(file_.modification_time));
+  const uint64_t program_size = size;
+  hash = fnv1a(hash, &program_size, sizeof(program_size));
+  const size_t head = std::min(size, kHashedBytes);
+  hash = fnv1a(hash, data, head);
+  const size_t tail = std::min(size - head, kHashedBytes);
+  hash = fnv1a(hash, static_cast<const uint8_t*>(data) + size - tail, tail);
+
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016" PRIx64 ".verified", hash);
+  return cache_dir_ + "/" + name;
+}
+
+bool FileVerificationCache::contains(const void* data, size_t size) {
+  const std::string path = marker_path(data, size);
+  struct stat st;
+  return ::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+void FileVerificationCache::insert(const void* data, size_t size) {
+  const std::string path = marker_path(data, size);
+  const int fd =
+      ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    if (errno != EEXIST) {
+      ET_LOG(
+          Debug,
+          "Could not create %s: %s (%d)",
+          path.c_str(),
+          std::strerror(errno),
+          errno);
+    }
+    return;
+  }
+  ::close(fd);
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <executorch/extension/data_loader/shared_weight_cache.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/verification_cache.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A VerificationCache that remembers verified programs across processes by
+ * creating an empty marker file per verified program in a directory.
+ *
+ * A program is identified by the FileIdentity of the file it was loaded from
+ * (device, inode, size and modification time) combined with the program size
+ * and its first and last bytes, which include the flatbuffer header and root
+ * table. Since nothing else about the contents is checked, this is only safe
+ * for program files and cache directories that cannot be written by anyone
+ * who should not be trusted, such as files in the app's own install or data
+ * directory. Use an app-private cache directory; anyone who can create files
+ * in it can make unverified programs look verified.
+ *
+ * Rewriting the program file changes its modification time or inode, so the
+ * program is verified again on the next load. Stale marker files are never
+ * removed; they are empty and the directory can be cleared at any time.
+ */
+class FileVerificationCache final
+    : public executorch::runtime::VerificationCache {
+ public:
+  /**
+   * Creates a cache for the program in `file_name`.
+   *
+   * @param[in] file_name The path to the program file that the data passed to
+   *     `contains()` and `insert()` is loaded from.
+   * @param[in] cache_dir An existing, app-private directory to keep the
+   *     marker files in.
+   *
+   * @retval Error::AccessFailed `file_name` could not be stat()ed.
+   * @retval Error::NotSupported The platform does not provide stable file
+   *     identities, so verification results cannot be cached.
+   */
+  static executorch::runtime::Result<FileVerificationCache> from(
+      const char* file_name,
+      const char* cache_dir);
+
+  bool contains(const void* data, size_t size) override;
+
+  void insert(const void* data, size_t size) override;
+
+ private:
+  FileVerificationCache(const FileIdentity& file, std::string cache_dir)
+      : file_(file), cache_dir_(std::move(cache_dir)) {}
+
+  /// Returns the path of the marker file for the given program data.
+  std::string marker_path(const void* data, size_t size) const;
+
+  FileIdentity file_;
+  std::string cache_dir_;
+};
+
+} // namespace extension
+} // namespace executorch
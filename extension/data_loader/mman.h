@@ -18,6 +18,22 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+// Transparent huge pages and NUMA placement are Linux only. mbind() is called
+// through syscall() so that libnuma isn't needed.
+#if defined(__linux__) && defined(MADV_HUGEPAGE) && \
+    !defined(ET_HAVE_MADVISE_HUGEPAGE)
+#define ET_HAVE_MADVISE_HUGEPAGE 1
+#endif
+
+#if defined(__linux__) && !defined(ET_HAVE_MBIND)
+#define ET_HAVE_MBIND 1
+#endif
+
+#if ET_HAVE_MBIND
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
 ET_INLINE size_t get_os_page_size() {
   return sysconf(_SC_PAGESIZE);
 }
@@ -41,3 +57,11 @@ ET_INLINE long get_os_page_size() {
 }
 
 #endif
+
+#ifndef ET_HAVE_MADVISE_HUGEPAGE
+#define ET_HAVE_MADVISE_HUGEPAGE 0
+#endif
+
+#ifndef ET_HAVE_MBIND
+#define ET_HAVE_MBIND 0
+#endif
@@ -17,6 +17,8 @@
 #include <sys/types.h>
 
 #include <executorch/extension/data_loader/mman.h>
+#include <executorch/extension/data_loader/page_util.h>
+#include <executorch/extension/data_loader/prefetch_util.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/log.h>
@@ -70,6 +72,14 @@ MmapDataLoader::~MmapDataLoader() {
 Result<MmapDataLoader> MmapDataLoader::from(
     const char* file_name,
     MmapDataLoader::MlockConfig mlock_config) {
+  Options options;
+  options.mlock_config = mlock_config;
+  return from(file_name, options);
+}
+
+Result<MmapDataLoader> MmapDataLoader::from(
+    const char* file_name,
+    const MmapDataLoader::Options& options) {
   // Cache the page size.
   long page_size = get_os_page_size();
   if (page_size < 0) {
@@ -121,7 +131,7 @@ Result<MmapDataLoader> MmapDataLoader::from(
       file_size,
       file_name_copy,
       static_cast<size_t>(page_size),
-      mlock_config);
+      options);
 }
 
 namespace {
@@ -150,6 +160,34 @@ void MunmapSegment(void* context, void* data, size_t size) {
 }
 } // namespace
 
+void MmapDataLoader::apply_page_options(void* pages, size_t size) const {
+  if (options_.use_huge_pages) {
+    internal::advise_huge_pages(pages, size, file_name_);
+  }
+#ifndef _WIN32
+  if (options_.will_need && ::madvise(pages, size, MADV_WILLNEED) < 0) {
+    ET_LOG(
+        Debug,
+        "Ignoring madvise(MADV_WILLNEED) error for file %s: %s (%d)",
+        file_name_,
+        ::strerror(errno),
+        errno);
+  }
+#endif // !_WIN32
+  if (options_.numa_node >= 0) {
+    internal::bind_to_numa_node(
+        pages, size, options_.numa_node, /*move_pages=*/true, file_name_);
+  }
+  if (options_.prefault_threads > 0) {
+    internal::prefault_pages(
+        pages,
+        size,
+        page_size_,
+        options_.prefault_threads,
+        internal::PrefaultAccess::Read);
+  }
+}
+
 Result<FreeableBuffer> MmapDataLoader::load(
     size_t offset,
     size_t size,
@@ -212,11 +250,11 @@ Result<FreeableBuffer> MmapDataLoader::load(
       fd_,
       range.start);
 
-  if (mlock_config_ == MlockConfig::UseMlock ||
-      mlock_config_ == MlockConfig::UseMlockIgnoreErrors) {
+  if (options_.mlock_config == MlockConfig::UseMlock ||
+      options_.mlock_config == MlockConfig::UseMlockIgnoreErrors) {
     int err = ::mlock(pages, size);
     if (err < 0) {
-      if (mlock_config_ == MlockConfig::UseMlockIgnoreErrors) {
+      if (options_.mlock_config == MlockConfig::UseMlockIgnoreErrors) {
         ET_LOG(
             Debug,
             "Ignoring mlock error for file %s (off=0x%zd): "
@@ -244,6 +282,8 @@ Result<FreeableBuffer> MmapDataLoader::load(
     // No need to keep track of this. munmap() will unlock as a side effect.
   }
 
+  apply_page_options(pages, map_size);
+
   // The requested data is at an offset into the mapped pages.
   const void* data = static_cast<const uint8_t*>(pages) + offset - range.start;
 
@@ -268,5 +308,66 @@ Result<size_t> MmapDataLoader::size() const {
   return file_size_;
 }
 
+ET_NODISCARD Error MmapDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    ET_UNUSED const SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= file_size_,
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > file_size_ %zu",
+      file_name_,
+      offset,
+      size,
+      file_size_);
+  internal::prefetch_file_range(fd_, offset, size, file_name_);
+  return Error::Ok;
+}
+
+ET_NODISCARD Error MmapDataLoader::release(
+    const FreeableBuffer& buffer,
+    size_t offset,
+    size_t size) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= buffer.size(),
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > buffer size %zu",
+      file_name_,
+      offset,
+      size,
+      buffer.size());
+  if (options_.mlock_config != MlockConfig::NoMlock) {
+    // The caller asked for the data to stay resident.
+    return Error::Ok;
+  }
+#ifndef _WIN32
+  // Only drop the pages that hold nothing but the range; the pages at its
+  // ends may hold data that is still in use. The mapping is private and never
+  // written, so MADV_DONTNEED only drops clean page cache pages, which are
+  // read from the file again if touched.
+  const uintptr_t start = reinterpret_cast<uintptr_t>(buffer.data()) + offset;
+  const uintptr_t first_page = (start + page_size_ - 1) & ~(page_size_ - 1);
+  const uintptr_t end_page = (start + size) & ~(page_size_ - 1);
+  if (end_page > first_page &&
+      ::madvise(
+          reinterpret_cast<void*>(first_page),
+          end_page - first_page,
+          MADV_DONTNEED) < 0) {
+    ET_LOG(
+        Debug,
+        "Ignoring madvise(MADV_DONTNEED) error for file %s: %s (%d)",
+        file_name_,
+        ::strerror(errno),
+        errno);
+  }
+#endif // !_WIN32
+  return Error::Ok;
+}
+
 } // namespace extension
 } // namespace executorch
@@ -54,6 +54,44 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
       const char* file_name,
       MlockConfig mlock_config = MlockConfig::UseMlock);
 
+  /**
+   * Additional hints about how loaded pages will be used. All of these are
+   * best-effort: they are ignored on platforms that don't support them, and
+   * failures are logged but do not fail the load.
+   */
+  struct Options {
+    /// How and whether to lock loaded pages with `mlock()`.
+    MlockConfig mlock_config = MlockConfig::UseMlock;
+    /// If true, calls `madvise(MADV_HUGEPAGE)` on loaded pages so that the
+    /// kernel can back them with transparent huge pages, reducing TLB misses
+    /// when streaming through large weights. Linux only.
+    bool use_huge_pages = false;
+    /// If true, calls `madvise(MADV_WILLNEED)` on loaded pages so that the
+    /// kernel starts reading them in the background.
+    bool will_need = false;
+    /// If non-negative, asks the kernel to place loaded pages on this NUMA
+    /// node with `mbind()`, moving pages that are already resident. Linux
+    /// only.
+    int numa_node = -1;
+    /// If greater than zero, touches every loaded page using this many
+    /// threads before load() returns, so that page faults happen in parallel
+    /// up front instead of one at a time during execution.
+    size_t prefault_threads = 0;
+  };
+
+  /**
+   * Creates a new MmapDataLoader that wraps the named file. Fails if
+   * the file can't be opened for reading or if its size can't be found.
+   *
+   * @param[in] file_name The path to the file to load from. The file will be
+   *     kept open until the MmapDataLoader is destroyed, to avoid the
+   *     overhead of opening it again for every load() call.
+   * @param[in] options How to treat loaded pages.
+   */
+  static executorch::runtime::Result<MmapDataLoader> from(
+      const char* file_name,
+      const Options& options);
+
   /// DEPRECATED: Use the lowercase `from()` instead.
   ET_DEPRECATED static executorch::runtime::Result<MmapDataLoader> From(
       const char* file_name,
@@ -77,12 +115,12 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
         file_size_(rhs.file_size_),
         page_size_(rhs.page_size_),
         fd_(rhs.fd_),
-        mlock_config_(rhs.mlock_config_) {
+        options_(rhs.options_) {
     const_cast<const char*&>(rhs.file_name_) = nullptr;
     const_cast<size_t&>(rhs.file_size_) = 0;
     const_cast<size_t&>(rhs.page_size_) = 0;
     const_cast<int&>(rhs.fd_) = -1;
-    const_cast<MlockConfig&>(rhs.mlock_config_) = MlockConfig::NoMlock;
+    const_cast<Options&>(rhs.options_) = Options();
   }
 
   ~MmapDataLoader() override;
@@ -95,18 +133,35 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
 
   ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
 
+  ET_NODISCARD executorch::runtime::Error prefetch(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const override;
+
+  /**
+   * Drops the pages that lie entirely inside the range from memory, unless
+   * they are mlock()ed. They are read from the file again if touched later.
+   */
+  ET_NODISCARD executorch::runtime::Error release(
+      const executorch::runtime::FreeableBuffer& buffer,
+      size_t offset,
+      size_t size) const override;
+
  private:
   MmapDataLoader(
       int fd,
       size_t file_size,
       const char* file_name,
       size_t page_size,
-      MlockConfig mlock_config)
+      const Options& options)
       : file_name_(file_name),
         file_size_(file_size),
         page_size_(page_size),
         fd_(fd),
-        mlock_config_(mlock_config) {}
+        options_(options) {}
+
+  // Applies the best-effort parts of options_ to newly-mapped pages.
+  void apply_page_options(void* pages, size_t size) const;
 
   // Not safely copyable.
   MmapDataLoader(const MmapDataLoader&) = delete;
@@ -117,7 +172,7 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
   const size_t file_size_;
   const size_t page_size_;
   const int fd_; // Owned by the instance.
-  const MlockConfig mlock_config_;
+  const Options options_;
 };
 
 } // namespace extension
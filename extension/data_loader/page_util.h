@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <executorch/extension/data_loader/mman.h>
+#include <executorch/runtime/platform/compiler.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+namespace internal {
+
+/**
+ * Asks the kernel to back `size` bytes at `pages` with transparent huge pages.
+ * The hint is best-effort: errors are logged with `name` and otherwise
+ * ignored, and it does nothing without MADV_HUGEPAGE.
+ */
+inline void advise_huge_pages(
+    ET_UNUSED void* pages,
+    ET_UNUSED size_t size,
+    ET_UNUSED const char* name) {
+#if ET_HAVE_MADVISE_HUGEPAGE
+  if (::madvise(pages, size, MADV_HUGEPAGE) < 0) {
+    ET_LOG(
+        Debug,
+        "Ignoring madvise(MADV_HUGEPAGE) error for %s: %s (%d)",
+        name,
+        ::strerror(errno),
+        errno);
+  }
+#endif // ET_HAVE_MADVISE_HUGEPAGE
+}
+
+/**
+ * Asks the kernel to place `size` bytes at `pages` on NUMA node `numa_node`.
+ * With `move_pages`, pages that are already resident are moved too, which
+ * page cache pages need because they are not placed by the mapping's policy
+ * when they are first read. Errors are logged with `name` and otherwise
+ * ignored, and it does nothing without mbind().
+ */
+inline void bind_to_numa_node(
+    ET_UNUSED void* pages,
+    ET_UNUSED size_t size,
+    ET_UNUSED int numa_node,
+    ET_UNUSED bool move_pages,
+    ET_UNUSED const char* name) {
+#if ET_HAVE_MBIND
+  // Call the syscall directly to avoid depending on libnuma.
+  constexpr size_t kBitsPerWord = 8 * sizeof(unsigned long);
+  unsigned long node_mask[4] = {};
+  const size_t node = static_cast<size_t>(numa_node);
+  if (node >= kBitsPerWord * 4) {
+    ET_LOG(
+        Debug, "Ignoring out-of-range NUMA node %d for %s", numa_node, name);
+    return;
+  }
+  node_mask[node / kBitsPerWord] = 1UL << (node % kBitsPerWord);
+  long ret = ::syscall(
+      SYS_mbind,
+      pages,
+      size,
+      MPOL_PREFERRED,
+      node_mask,
+      kBitsPerWord * 4,
+      move_pages ? MPOL_MF_MOVE : 0);
+  if (ret < 0) {
+    ET_LOG(
+        Debug,
+        "Ignoring mbind(node=%d) error for %s: %s (%d)",
+        numa_node,
+        name,
+        ::strerror(errno),
+        errno);
+  }
+#endif // ET_HAVE_MBIND
+}
+
+/// How prefault_pages() touches each page.
+enum class PrefaultAccess {
+  /// Reads a byte, which maps in file-backed pages.
+  Read,
+  /// Writes a zero byte, which makes the kernel allocate anonymous pages.
+  /// The pages must be writable and zero-filled.
+  Write,
+};
+
+/**
+ * Touches every page in the region, splitting the pages between
+ * `num_threads` threads so that their page faults are serviced in parallel.
+ */
+inline void prefault_pages(
+    void* start,
+    size_t size,
+    size_t page_size,
+    size_t num_threads,
+    PrefaultAccess access) {
+  auto* bytes = static_cast<uint8_t*>(start);
+  const size_t num_pages = (size + page_size - 1) / page_size;
+  const size_t pages_per_thread = (num_pages + num_threads - 1) / num_threads;
+  auto touch = [=](size_t first_page, size_t end_page) {
+    for (size_t page = first_page; page < end_page; ++page) {
+      // The volatile access keeps the compiler from dropping it.
+      auto* byte = static_cast<volatile uint8_t*>(bytes + page * page_size);
+      if (access == PrefaultAccess::Write) {
+        *byte = 0;
+      } else {
+        (void)*byte;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t first_page = pages_per_thread; first_page < num_pages;
+       first_page += pages_per_thread) {
+    threads.emplace_back(
+        touch, first_page, std::min(first_page + pages_per_thread, num_pages));
+  }
+  // Do the first share on this thread.
+  touch(0, std::min(pages_per_thread, num_pages));
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace internal
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include <executorch/runtime/platform/compiler.h>
+#include <executorch/runtime/platform/log.h>
+
+// posix_fadvise() is not available on all platforms (e.g. Apple and Windows).
+// Prefetch hints are ignored where it is missing.
+#if defined(__linux__) && !defined(ET_HAVE_FADVISE)
+#define ET_HAVE_FADVISE 1
+#endif // defined(__linux__) && !defined(ET_HAVE_FADVISE)
+
+#ifndef ET_HAVE_FADVISE
+#define ET_HAVE_FADVISE 0
+#endif // !ET_HAVE_FADVISE
+
+namespace executorch {
+namespace extension {
+namespace internal {
+
+/**
+ * Asks the kernel to start reading `size` bytes at `offset` of `fd` into the
+ * page cache. This returns immediately, and later reads of the range wait for
+ * the I/O. The hint is best-effort: errors are logged with `file_name` and
+ * otherwise ignored, and it does nothing without posix_fadvise().
+ */
+inline void prefetch_file_range(
+    ET_UNUSED int fd,
+    ET_UNUSED size_t offset,
+    ET_UNUSED size_t size,
+    ET_UNUSED const char* file_name) {
+#if ET_HAVE_FADVISE
+  int err = ::posix_fadvise(
+      fd, static_cast<off_t>(offset), size, POSIX_FADV_WILLNEED);
+  if (err != 0) {
+    // posix_fadvise() returns the error instead of setting errno.
+    ET_LOG(
+        Debug,
+        "Ignoring posix_fadvise error for file %s (off=0x%zx): %s (%d)",
+        file_name,
+        offset,
+        ::strerror(err),
+        err);
+  }
+#endif // ET_HAVE_FADVISE
+}
+
+} // namespace internal
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/shared_weight_cache.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <sys/stat.h>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+struct SharedWeightCache::Entry {
+  explicit Entry(FreeableBuffer&& buffer) : buffer(std::move(buffer)) {}
+
+  /// The data loaded on the cache miss. Freed with the last reference.
+  FreeableBuffer buffer;
+};
+
+namespace {
+using EntryRef = std::shared_ptr<void>;
+
+/// FreeableBuffer::FreeFn for buffers handed out by the cache. The context is
+/// a heap-allocated std::shared_ptr that keeps the cached entry alive.
+void release_entry(void* context, void* /*data*/, size_t /*size*/) {
+  delete static_cast<EntryRef*>(context);
+}
+} // namespace
+
+Result<FileIdentity> FileIdentity::of(const char* file_name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      file_name != nullptr, InvalidArgument, "File name must not be null");
+  struct stat st;
+  if (::stat(file_name, &st) != 0) {
+    ET_LOG(
+        Error,
+        "Could not stat %s: %s (%d)",
+        file_name,
+        std::strerror(errno),
+        errno);
+    return Error::AccessFailed;
+  }
+  if (st.st_ino == 0) {
+    // Without inode numbers there is no way to tell files apart other than by
+    // path, which is not stable enough to share data.
+    ET_LOG(Debug, "No stable identity for %s", file_name);
+    return Error::NotSupported;
+  }
+  FileIdentity identity;
+  identity.device = static_cast<uint64_t>(st.st_dev);
+  identity.inode = static_cast<uint64_t>(st.st_ino);
+  identity.file_size = static_cast<uint64_t>(st.st_size);
+  identity.modification_time = static_cast<int64_t>(st.st_mtime);
+  return identity;
+}
+
+SharedWeightCache& SharedWeightCache::global() {
+  // Leaked so that buffers freed during static destruction stay safe.
+  static SharedWeightCache* cache = new SharedWeightCache();
+  return *cache;
+}
+
+Result<FreeableBuffer> SharedWeightCache::load(
+    const DataLoader& loader,
+    const FileIdentity& file,
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) {
+  if (size == 0) {
+    // Nothing to share.
+    return loader.load(offset, size, segment_info);
+  }
+
+  const Key key(file, offset, size);
+  // Hold the lock across the load so that concurrent misses on the same
+  // segment read it only once.
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<Entry> entry;
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    entry = it->second.lock();
+  }
+  if (!entry) {
+    Result<FreeableBuffer> buffer = loader.load(offset, size, segment_info);
+    if (!buffer.ok()) {
+      return buffer.error();
+    }
+    entry = std::make_shared<Entry>(std::move(buffer.get()));
+    // Drop keys whose data has already been released before adding this one.
+    for (auto e = entries_.begin(); e != entries_.end();) {
+      e = e->second.expired() ? entries_.erase(e) : std::next(e);
+    }
+    entries_[key] = entry;
+  }
+
+  const void* data = entry->buffer.data();
+  const size_t entry_size = entry->buffer.size();
+  auto* context = new (std::nothrow) EntryRef(std::move(entry));
+  ET_CHECK_OR_RETURN_ERROR(
+      context != nullptr,
+      MemoryAllocationFailed,
+      "Failed to allocate reference for cached segment");
+  return FreeableBuffer(data, entry_size, release_entry, context);
+}
+
+size_t SharedWeightCache::num_live_segments() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& e : entries_) {
+    count += e.second.expired() ? 0 : 1;
+  }
+  return count;
+}
+
+Result<CachingDataLoader> CachingDataLoader::from(
+    const char* file_name,
+    std::unique_ptr<DataLoader> loader,
+    SharedWeightCache* cache) {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader != nullptr, InvalidArgument, "Loader must not be null");
+  Result<FileIdentity> file = FileIdentity::of(file_name);
+  if (!file.ok()) {
+    return file.error();
+  }
+  return CachingDataLoader(
+      std::move(loader),
+      file.get(),
+      cache != nullptr ? cache : &SharedWeightCache::global());
+}
+
+Result<FreeableBuffer> CachingDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader_ != nullptr, InvalidState, "Uninitialized loader");
+  return cache_->load(*loader_, file_, offset, size, segment_info);
+}
+
+Result<size_t> CachingDataLoader::size() const {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader_ != nullptr, InvalidState, "Uninitialized loader");
+  return loader_->size();
+}
+
+Error CachingDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader_ != nullptr, InvalidState, "Uninitialized loader");
+  return loader_->load_into(offset, size, segment_info, buffer);
+}
+
+Error CachingDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader_ != nullptr, InvalidState, "Uninitialized loader");
+  return loader_->prefetch(offset, size, segment_info);
+}
+
+Error CachingDataLoader::release(
+    const FreeableBuffer& buffer,
+    size_t offset,
+    size_t size) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader_ != nullptr, InvalidState, "Uninitialized loader");
+  // Cached buffers point at the data loaded by loader_, and other users only
+  // need the range to stay readable, so the hint can be passed on.
+  return loader_->release(buffer, offset, size);
+}
+
+} // namespace extension
+} // namespace executorch
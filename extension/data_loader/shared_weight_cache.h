@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Identifies the contents of a file on disk, independent of the path used to
+ * open it.
+ */
+struct FileIdentity {
+  uint64_t device = 0;
+  uint64_t inode = 0;
+  uint64_t file_size = 0;
+  int64_t modification_time = 0;
+
+  /**
+   * Looks up the identity of the named file.
+   *
+   * @retval Error::AccessFailed The file could not be stat()ed.
+   * @retval Error::NotSupported The platform does not provide stable file
+   *     identities (for example, inode numbers are always zero).
+   */
+  static executorch::runtime::Result<FileIdentity> of(const char* file_name);
+
+  bool operator<(const FileIdentity& rhs) const {
+    return std::tie(device, inode, file_size, modification_time) <
+        std::tie(rhs.device,
+                 rhs.inode,
+                 rhs.file_size,
+                 rhs.modification_time);
+  }
+};
+
+/**
+ * A ref-counted cache of read-only segments loaded from files.
+ *
+ * Segments are keyed by the identity of the file they came from plus their
+ * offset and size, so two DataLoaders over the same file, even when opened
+ * through different paths, share one copy of each segment for as long as
+ * either of them holds it. A segment is released once the last FreeableBuffer
+ * that refers to it is freed; the cache itself never keeps data alive.
+ *
+ * All methods are thread-safe.
+ */
+class SharedWeightCache final {
+ public:
+  /// Returns the process-wide cache.
+  static SharedWeightCache& global();
+
+  SharedWeightCache() = default;
+
+  /**
+   * Returns the cached copy of the requested segment, loading it with
+   * `loader` if no live copy exists.
+   *
+   * Buffers returned by `loader.load()` must remain valid after `loader` is
+   * destroyed, because another user of the cache may still hold them. This is
+   * true of FileDataLoader and MmapDataLoader.
+   *
+   * @param[in] loader The loader to read from on a cache miss.
+   * @param[in] file The identity of the file that `loader` reads.
+   * @param[in] offset The byte offset in the file to start loading from.
+   * @param[in] size The number of bytes to load.
+   * @param[in] segment_info Information about the segment being loaded.
+   *
+   * @returns A buffer that shares the cached data, or the error returned by
+   *     `loader.load()`.
+   */
+  ET_NODISCARD executorch::runtime::Result<executorch::runtime::FreeableBuffer>
+  load(
+      const executorch::runtime::DataLoader& loader,
+      const FileIdentity& file,
+      size_t offset,
+      size_t size,
+      const executorch::runtime::DataLoader::SegmentInfo& segment_info);
+
+  /// Returns the number of segments that are currently held by some user.
+  size_t num_live_segments() const;
+
+ private:
+  struct Entry;
+  using Key = std::tuple<FileIdentity, size_t, size_t>;
+
+  // Not copyable or movable; users hold pointers to it.
+  SharedWeightCache(const SharedWeightCache&) = delete;
+  SharedWeightCache& operator=(const SharedWeightCache&) = delete;
+
+  mutable std::mutex mutex_;
+  std::map<Key, std::weak_ptr<Entry>> entries_;
+};
+
+/**
+ * A DataLoader that serves load() calls from a SharedWeightCache, so that
+ * several Programs or data maps over the same file share their read-only
+ * segments. load_into() copies into caller-owned memory, such as mutable
+ * tensor state, and always goes to the wrapped loader.
+ */
+class CachingDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * Wraps a loader that reads the named file.
+   *
+   * @param[in] file_name The path of the file that `loader` reads. Only used
+   *     to find the file's identity.
+   * @param[in] loader The loader to read from on a cache miss. See
+   *     SharedWeightCache::load() for the requirements on its buffers.
+   * @param[in] cache The cache to use. If null, uses
+   *     SharedWeightCache::global(). Must outlive the returned loader.
+   *
+   * @returns A new CachingDataLoader on success.
+   * @retval Error::InvalidArgument `loader` is null.
+   * @retval Error::AccessFailed The file's identity could not be found.
+   * @retval Error::NotSupported The platform can't identify files.
+   */
+  static executorch::runtime::Result<CachingDataLoader> from(
+      const char* file_name,
+      std::unique_ptr<executorch::runtime::DataLoader> loader,
+      SharedWeightCache* cache = nullptr);
+
+  // Movable to be compatible with Result.
+  CachingDataLoader(CachingDataLoader&&) noexcept = default;
+  ~CachingDataLoader() override = default;
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD executorch::runtime::Error prefetch(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Error release(
+      const executorch::runtime::FreeableBuffer& buffer,
+      size_t offset,
+      size_t size) const override;
+
+ private:
+  CachingDataLoader(
+      std::unique_ptr<executorch::runtime::DataLoader> loader,
+      const FileIdentity& file,
+      SharedWeightCache* cache)
+      : loader_(std::move(loader)), file_(file), cache_(cache) {}
+
+  // Not safely copyable.
+  CachingDataLoader(const CachingDataLoader&) = delete;
+  CachingDataLoader& operator=(const CachingDataLoader&) = delete;
+  CachingDataLoader& operator=(CachingDataLoader&&) = delete;
+
+  std::unique_ptr<executorch::runtime::DataLoader> loader_;
+  const FileIdentity file_;
+  SharedWeightCache* const cache_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -37,6 +37,18 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "prefetch_util",
+        srcs = [],
+        exported_headers = ["prefetch_util.h"],
+        visibility = [
+            "//executorch/extension/data_loader/...",
+        ],
+        exported_deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     runtime.cxx_library(
         name = "file_data_loader",
         srcs = ["file_data_loader.cpp"],
@@ -50,6 +62,66 @@ def define_common_targets():
         exported_deps = [
             "//executorch/runtime/core:core",
         ],
+        deps = [
+            ":prefetch_util",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "async_data_loader",
+        srcs = [],
+        exported_headers = ["async_data_loader.h"],
+        visibility = [
+            "//executorch/extension/data_loader/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "async_file_data_loader",
+        srcs = ["async_file_data_loader.cpp"],
+        exported_headers = ["async_file_data_loader.h"],
+        visibility = [
+            "//executorch/test/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            ":async_data_loader",
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "shared_weight_cache",
+        srcs = ["shared_weight_cache.cpp"],
+        exported_headers = ["shared_weight_cache.h"],
+        visibility = [
+            "//executorch/extension/module/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "file_verification_cache",
+        srcs = ["file_verification_cache.cpp"],
+        exported_headers = ["file_verification_cache.h"],
+        visibility = [
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            ":shared_weight_cache",
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/executor:verification_cache",
+        ],
     )
 
     runtime.cxx_library(
@@ -65,6 +137,9 @@ def define_common_targets():
         exported_deps = [
             "//executorch/runtime/core:core",
         ],
+        deps = [
+            ":prefetch_util",
+        ],
     )
 
     runtime.cxx_library(
@@ -81,7 +156,8 @@ def define_common_targets():
         }),
         exported_headers = [
             "mman.h",
-            "mmap_data_loader.h"
+            "mmap_data_loader.h",
+            "page_util.h",
         ],
         visibility = [
             "//executorch/test/...",
@@ -93,4 +169,7 @@ def define_common_targets():
         exported_deps = [
             "//executorch/runtime/core:core",
         ],
+        deps = [
+            ":prefetch_util",
+        ],
     )
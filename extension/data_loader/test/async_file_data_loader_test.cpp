@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/async_file_data_loader.h>
+
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/test/utils/alignment.h>
+
+using namespace ::testing;
+using executorch::extension::AsyncFileDataLoader;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace {
+constexpr size_t kChunkSize = AsyncFileDataLoader::kDirectIoAlignment;
+} // namespace
+
+// The parameter enables or disables direct I/O.
+class AsyncFileDataLoaderTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    // A file several chunks long, with contents that differ between chunks.
+    contents_.resize(5 * kChunkSize + 123);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<uint8_t>(i * 7 + i / kChunkSize);
+    }
+    temp_file_ = std::make_unique<TempFile>(contents_.data(), contents_.size());
+  }
+
+  Result<AsyncFileDataLoader> make_loader(size_t alignment = 16) {
+    AsyncFileDataLoader::Config config;
+    config.alignment = alignment;
+    config.num_threads = 3;
+    config.chunk_size = kChunkSize;
+    config.use_direct_io = GetParam();
+    return AsyncFileDataLoader::from(temp_file_->path().c_str(), config);
+  }
+
+  std::vector<uint8_t> contents_;
+  std::unique_ptr<TempFile> temp_file_;
+};
+
+TEST_P(AsyncFileDataLoaderTest, InBoundsLoadsSucceed) {
+  for (size_t alignment : {16, 64, 8192}) {
+    Result<AsyncFileDataLoader> loader = make_loader(alignment);
+    ASSERT_EQ(loader.error(), Error::Ok);
+    EXPECT_EQ(loader->size().get(), contents_.size());
+
+    // Ranges that start and end inside, and on the boundaries of, chunks.
+    const std::vector<std::pair<size_t, size_t>> ranges = {
+        {0, contents_.size()},
+        {0, kChunkSize},
+        {kChunkSize, 2 * kChunkSize},
+        {1, 1},
+        {kChunkSize - 3, 3 * kChunkSize + 10},
+        {contents_.size() - 200, 200},
+    };
+    for (const auto& range : ranges) {
+      Result<FreeableBuffer> fb = loader->load(
+          range.first,
+          range.second,
+          DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+      ASSERT_EQ(fb.error(), Error::Ok);
+      EXPECT_ALIGNED(fb->data(), alignment);
+      ASSERT_EQ(fb->size(), range.second);
+      EXPECT_EQ(
+          0,
+          std::memcmp(
+              fb->data(), contents_.data() + range.first, range.second));
+    }
+  }
+}
+
+TEST_P(AsyncFileDataLoaderTest, ConcurrentAsyncLoadsSucceed) {
+  Result<AsyncFileDataLoader> loader = make_loader();
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // Issue many loads before waiting for any of them.
+  constexpr size_t kNumLoads = 32;
+  std::vector<std::vector<uint8_t>> buffers(kNumLoads);
+  std::vector<std::future<Error>> futures;
+  for (size_t i = 0; i < kNumLoads; ++i) {
+    const size_t offset = i * 97;
+    const size_t size = contents_.size() - offset;
+    buffers[i].resize(size);
+    futures.push_back(loader->load_async(
+        offset,
+        size,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend),
+        buffers[i].data()));
+  }
+  for (size_t i = 0; i < kNumLoads; ++i) {
+    ASSERT_EQ(futures[i].get(), Error::Ok);
+    EXPECT_EQ(
+        0,
+        std::memcmp(
+            buffers[i].data(), contents_.data() + i * 97, buffers[i].size()));
+  }
+}
+
+TEST_P(AsyncFileDataLoaderTest, OutOfBoundsLoadFails) {
+  Result<AsyncFileDataLoader> loader = make_loader();
+  ASSERT_EQ(loader.error(), Error::Ok);
+  const auto segment_info =
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program);
+
+  EXPECT_NE(
+      loader->load(/*offset=*/0, contents_.size() + 1, segment_info).error(),
+      Error::Ok);
+  std::vector<uint8_t> buffer(contents_.size() + 1);
+  EXPECT_EQ(
+      loader->load_async(0, buffer.size(), segment_info, buffer.data()).get(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      loader->load_into(0, 1, segment_info, /*buffer=*/nullptr),
+      Error::InvalidArgument);
+}
+
+TEST_P(AsyncFileDataLoaderTest, BadConfigFails) {
+  AsyncFileDataLoader::Config config;
+  config.alignment = 3;
+  EXPECT_EQ(
+      AsyncFileDataLoader::from(temp_file_->path().c_str(), config).error(),
+      Error::InvalidArgument);
+
+  config = AsyncFileDataLoader::Config();
+  config.num_threads = 0;
+  EXPECT_EQ(
+      AsyncFileDataLoader::from(temp_file_->path().c_str(), config).error(),
+      Error::InvalidArgument);
+
+  config = AsyncFileDataLoader::Config();
+  config.chunk_size = 1000;
+  EXPECT_EQ(
+      AsyncFileDataLoader::from(temp_file_->path().c_str(), config).error(),
+      Error::InvalidArgument);
+
+  EXPECT_EQ(
+      AsyncFileDataLoader::from("/should/not/exist").error(),
+      Error::AccessFailed);
+}
+
+TEST_P(AsyncFileDataLoaderTest, MoveCtor) {
+  Result<AsyncFileDataLoader> loader = make_loader();
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  AsyncFileDataLoader loader2(std::move(*loader));
+
+  // Old loader should now be invalid.
+  const auto segment_info =
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program);
+  EXPECT_EQ(loader->size().error(), Error::InvalidState);
+  EXPECT_EQ(loader->load(0, 0, segment_info).error(), Error::InvalidState);
+
+  // New loader should point to the file.
+  Result<FreeableBuffer> fb = loader2.load(0, contents_.size(), segment_info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), contents_.data(), fb->size()));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    DirectIo,
+    AsyncFileDataLoaderTest,
+    ::testing::Values(false, true));
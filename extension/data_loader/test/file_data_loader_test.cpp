@@ -147,6 +147,30 @@ TEST_P(FileDataLoaderTest, OutOfBoundsLoadFails) {
   }
 }
 
+TEST_P(FileDataLoaderTest, PrefetchChecksBounds) {
+  uint8_t data[256] = {};
+  TempFile tf(data, sizeof(data));
+
+  Result<FileDataLoader> fdl =
+      FileDataLoader::from(tf.path().c_str(), alignment());
+  ASSERT_EQ(fdl.error(), Error::Ok);
+
+  const auto segment_info =
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend);
+  EXPECT_EQ(
+      fdl->prefetch(/*offset=*/0, /*size=*/sizeof(data), segment_info),
+      Error::Ok);
+  EXPECT_EQ(
+      fdl->prefetch(/*offset=*/0, /*size=*/sizeof(data) + 1, segment_info),
+      Error::InvalidArgument);
+
+  // Loads still work after a prefetch.
+  Result<FreeableBuffer> fb =
+      fdl->load(/*offset=*/0, /*size=*/sizeof(data), segment_info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(fb->size(), sizeof(data));
+}
+
 TEST_P(FileDataLoaderTest, FromMissingFileFails) {
   // Wrapping a file that doesn't exist should fail.
   Result<FileDataLoader> fdl = FileDataLoader::from(
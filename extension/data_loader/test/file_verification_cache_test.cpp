@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/file_verification_cache.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::FileVerificationCache;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+class FileVerificationCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    contents_.resize(10000);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<uint8_t>(i * 7);
+    }
+    temp_file_ = std::make_unique<TempFile>(contents_.data(), contents_.size());
+
+    std::string dir_template = ::testing::TempDir() + "verification_XXXXXX";
+    ASSERT_NE(::mkdtemp(dir_template.data()), nullptr);
+    cache_dir_ = dir_template;
+  }
+
+  void TearDown() override {
+    DIR* dir = ::opendir(cache_dir_.c_str());
+    if (dir != nullptr) {
+      while (const dirent* entry = ::readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name != "." && name != "..") {
+          ::unlink((cache_dir_ + "/" + name).c_str());
+        }
+      }
+      ::closedir(dir);
+    }
+    ::rmdir(cache_dir_.c_str());
+  }
+
+  std::vector<uint8_t> contents_;
+  std::unique_ptr<TempFile> temp_file_;
+  std::string cache_dir_;
+};
+
+TEST_F(FileVerificationCacheTest, RemembersInsertedData) {
+  Result<FileVerificationCache> cache = FileVerificationCache::from(
+      temp_file_->path().c_str(), cache_dir_.c_str());
+  ASSERT_EQ(cache.error(), Error::Ok);
+
+  EXPECT_FALSE(cache->contains(contents_.data(), contents_.size()));
+  cache->insert(contents_.data(), contents_.size());
+  EXPECT_TRUE(cache->contains(contents_.data(), contents_.size()));
+
+  // Inserting again is harmless.
+  cache->insert(contents_.data(), contents_.size());
+  EXPECT_TRUE(cache->contains(contents_.data(), contents_.size()));
+
+  // A prefix of the data is a different program.
+  EXPECT_FALSE(cache->contains(contents_.data(), contents_.size() - 1));
+}
+
+TEST_F(FileVerificationCacheTest, PersistsAcrossInstances) {
+  {
+    Result<FileVerificationCache> cache = FileVerificationCache::from(
+        temp_file_->path().c_str(), cache_dir_.c_str());
+    ASSERT_EQ(cache.error(), Error::Ok);
+    cache->insert(contents_.data(), contents_.size());
+  }
+
+  Result<FileVerificationCache> cache = FileVerificationCache::from(
+      temp_file_->path().c_str(), cache_dir_.c_str());
+  ASSERT_EQ(cache.error(), Error::Ok);
+  EXPECT_TRUE(cache->contains(contents_.data(), contents_.size()));
+}
+
+TEST_F(FileVerificationCacheTest, ChangedDataIsNotVerified) {
+  Result<FileVerificationCache> cache = FileVerificationCache::from(
+      temp_file_->path().c_str(), cache_dir_.c_str());
+  ASSERT_EQ(cache.error(), Error::Ok);
+  cache->insert(contents_.data(), contents_.size());
+
+  // Changes near either end of the data change the key.
+  std::vector<uint8_t> changed = contents_;
+  changed[8] ^= 1;
+  EXPECT_FALSE(cache->contains(changed.data(), changed.size()));
+  changed = contents_;
+  changed[changed.size() - 1] ^= 1;
+  EXPECT_FALSE(cache->contains(changed.data(), changed.size()));
+}
+
+TEST_F(FileVerificationCacheTest, DifferentFileIsNotVerified) {
+  Result<FileVerificationCache> cache = FileVerificationCache::from(
+      temp_file_->path().c_str(), cache_dir_.c_str());
+  ASSERT_EQ(cache.error(), Error::Ok);
+  cache->insert(contents_.data(), contents_.size());
+
+  // A copy of the same data in another file has another identity.
+  TempFile other(contents_.data(), contents_.size());
+  Result<FileVerificationCache> other_cache =
+      FileVerificationCache::from(other.path().c_str(), cache_dir_.c_str());
+  ASSERT_EQ(other_cache.error(), Error::Ok);
+  EXPECT_FALSE(other_cache->contains(contents_.data(), contents_.size()));
+}
+
+TEST_F(FileVerificationCacheTest, FromFailsForMissingFile) {
+  Result<FileVerificationCache> cache = FileVerificationCache::from(
+      "/there/is/no/such/file.pte", cache_dir_.c_str());
+  EXPECT_EQ(cache.error(), Error::AccessFailed);
+
+  Result<FileVerificationCache> no_dir =
+      FileVerificationCache::from(temp_file_->path().c_str(), "");
+  EXPECT_EQ(no_dir.error(), Error::InvalidArgument);
+}
+
+TEST_F(FileVerificationCacheTest, UnwritableDirectoryIsNotAnError) {
+  Result<FileVerificationCache> cache = FileVerificationCache::from(
+      temp_file_->path().c_str(), "/there/is/no/such/dir");
+  ASSERT_EQ(cache.error(), Error::Ok);
+
+  cache->insert(contents_.data(), contents_.size());
+  EXPECT_FALSE(cache->contains(contents_.data(), contents_.size()));
+}
@@ -8,10 +8,19 @@
 
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
 #include <executorch/extension/data_loader/mman.h>
 #include <executorch/extension/testing_util/temp_file.h>
 #include <executorch/runtime/core/result.h>
@@ -243,6 +252,151 @@ TEST_F(MmapDataLoaderTest, InBoundsLoadsSucceedUseMlockIgnoreErrors) {
       MmapDataLoader::MlockConfig::UseMlockIgnoreErrors);
 }
 
+TEST_F(MmapDataLoaderTest, InBoundsLoadsSucceedWithPageOptions) {
+  // There's no portable way to observe the effect of these hints, but exercise
+  // the paths to make sure the loaded data is still correct.
+  const size_t contents_size = 8 * page_size_ + page_size_ / 2;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i * 13 + i / page_size_);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  MmapDataLoader::Options options;
+  options.mlock_config = MmapDataLoader::MlockConfig::NoMlock;
+  options.use_huge_pages = true;
+  options.will_need = true;
+  options.numa_node = 0;
+  options.prefault_threads = 3;
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(tf.path().c_str(), options);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+
+  const std::vector<std::pair<size_t, size_t>> ranges = {
+      {0, contents_size},
+      {page_size_ / 3, 5 * page_size_},
+      {contents_size - 10, 10},
+  };
+  for (const auto& range : ranges) {
+    Result<FreeableBuffer> fb = mdl->load(
+        range.first,
+        range.second,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(fb->size(), range.second);
+    EXPECT_EQ(0, std::memcmp(fb->data(), &contents[range.first], fb->size()));
+  }
+}
+
+#if defined(__linux__)
+namespace {
+
+// Returns the start address of the mapping that contains `address`, and its
+// VmFlags line from /proc/self/smaps, or 0 and "" if there is none.
+std::pair<uintptr_t, std::string> find_mapping(const void* address) {
+  const uintptr_t target = reinterpret_cast<uintptr_t>(address);
+  FILE* smaps = fopen("/proc/self/smaps", "r");
+  if (smaps == nullptr) {
+    return {0, ""};
+  }
+  std::pair<uintptr_t, std::string> result = {0, ""};
+  bool in_mapping = false;
+  char line[512];
+  while (fgets(line, sizeof(line), smaps) != nullptr) {
+    unsigned long start = 0;
+    unsigned long end = 0;
+    // Mapping headers start with "start-end", field lines with a name.
+    if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+      in_mapping = start <= target && target < end;
+      if (in_mapping) {
+        result.first = start;
+      }
+    } else if (in_mapping && strncmp(line, "VmFlags:", 8) == 0) {
+      result.second = line;
+      break;
+    }
+  }
+  fclose(smaps);
+  return result;
+}
+
+// Returns the line of /proc/self/numa_maps of the mapping at `start`, or "".
+std::string find_numa_policy(uintptr_t start) {
+  FILE* numa_maps = fopen("/proc/self/numa_maps", "r");
+  if (numa_maps == nullptr) {
+    return "";
+  }
+  std::string result;
+  char line[1024];
+  while (fgets(line, sizeof(line), numa_maps) != nullptr) {
+    unsigned long line_start = 0;
+    if (sscanf(line, "%lx ", &line_start) == 1 && line_start == start) {
+      result = line;
+      break;
+    }
+  }
+  fclose(numa_maps);
+  return result;
+}
+
+} // namespace
+
+TEST_F(MmapDataLoaderTest, PageOptionsReachTheKernel) {
+  // Linux reports the hints of each mapping in /proc/self/smaps and
+  // /proc/self/numa_maps, so this fails if the hints are compiled out.
+  EXPECT_TRUE(ET_HAVE_MADVISE_HUGEPAGE);
+  EXPECT_TRUE(ET_HAVE_MBIND);
+
+  const size_t contents_size = 4 * page_size_;
+  std::vector<uint8_t> contents(contents_size, 7);
+  TempFile tf(contents.data(), contents_size);
+
+  MmapDataLoader::Options options;
+  options.mlock_config = MmapDataLoader::MlockConfig::NoMlock;
+  options.use_huge_pages = true;
+  options.numa_node = 0;
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(tf.path().c_str(), options);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+  Result<FreeableBuffer> fb = mdl->load(
+      0,
+      contents_size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(fb.error(), Error::Ok);
+
+  const auto mapping = find_mapping(fb->data());
+  ASSERT_NE(mapping.first, 0);
+  if (access("/sys/kernel/mm/transparent_hugepage", F_OK) == 0) {
+    // MADV_HUGEPAGE shows up as the "hg" flag.
+    EXPECT_NE(mapping.second.find(" hg"), std::string::npos)
+        << mapping.second;
+  }
+
+  // mbind() needs NUMA support in the kernel and may be filtered out, e.g.
+  // by seccomp in containers, so only check the policy where it works.
+  void* probe = ::mmap(
+      nullptr,
+      page_size_,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  ASSERT_NE(probe, MAP_FAILED);
+  unsigned long node_mask = 1;
+  const bool has_mbind = ::syscall(
+                             SYS_mbind,
+                             probe,
+                             page_size_,
+                             MPOL_PREFERRED,
+                             &node_mask,
+                             8 * sizeof(node_mask),
+                             0) == 0;
+  ::munmap(probe, page_size_);
+  if (has_mbind) {
+    const std::string policy = find_numa_policy(mapping.first);
+    EXPECT_NE(policy.find("prefer:0"), std::string::npos) << policy;
+  }
+}
+#endif // defined(__linux__)
+
 TEST_F(MmapDataLoaderTest, FinalPageOfUnevenFileSucceeds) {
   // Create a file whose length is not an even multiple of a page.
   // Each 4-byte word in the file has a different value.
@@ -316,6 +470,39 @@ TEST_F(MmapDataLoaderTest, OutOfBoundsLoadFails) {
   }
 }
 
+TEST_F(MmapDataLoaderTest, ReleasedRangeIsStillReadable) {
+  const size_t contents_size = 8 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i * 7 + i / page_size_);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(
+      tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+
+  Result<FreeableBuffer> fb = mdl->load(
+      /*offset=*/0,
+      contents_size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  ASSERT_EQ(0, std::memcmp(fb->data(), contents.get(), contents_size));
+
+  // Release a range that covers some whole pages and ends mid-page, and one
+  // that is smaller than a page.
+  EXPECT_EQ(mdl->release(fb.get(), page_size_ / 2, 5 * page_size_), Error::Ok);
+  EXPECT_EQ(mdl->release(fb.get(), 7 * page_size_ + 1, 10), Error::Ok);
+
+  // The data is read from the file again.
+  EXPECT_EQ(0, std::memcmp(fb->data(), contents.get(), contents_size));
+
+  // Ranges outside the buffer are rejected.
+  EXPECT_EQ(
+      mdl->release(fb.get(), page_size_, contents_size),
+      Error::InvalidArgument);
+}
+
 TEST_F(MmapDataLoaderTest, FromMissingFileFails) {
   // Wrapping a file that doesn't exist should fail.
   Result<MmapDataLoader> mdl = MmapDataLoader::from(
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/shared_weight_cache.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::CachingDataLoader;
+using executorch::extension::FileDataLoader;
+using executorch::extension::SharedWeightCache;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+class SharedWeightCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    contents_.resize(1024);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<uint8_t>(i * 3);
+    }
+    temp_file_ = std::make_unique<TempFile>(contents_.data(), contents_.size());
+  }
+
+  Result<CachingDataLoader> make_loader() {
+    Result<FileDataLoader> fdl =
+        FileDataLoader::from(temp_file_->path().c_str());
+    if (!fdl.ok()) {
+      return fdl.error();
+    }
+    return CachingDataLoader::from(
+        temp_file_->path().c_str(),
+        std::make_unique<FileDataLoader>(std::move(*fdl)),
+        &cache_);
+  }
+
+  std::vector<uint8_t> contents_;
+  std::unique_ptr<TempFile> temp_file_;
+  SharedWeightCache cache_;
+};
+
+TEST_F(SharedWeightCacheTest, LoadersOnSameFileShareSegments) {
+  Result<CachingDataLoader> loader = make_loader();
+  ASSERT_EQ(loader.error(), Error::Ok);
+  EXPECT_EQ(loader->size().get(), contents_.size());
+  const auto segment_info =
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend);
+
+  Result<FreeableBuffer> fb1 = loader->load(16, 256, segment_info);
+  ASSERT_EQ(fb1.error(), Error::Ok);
+  {
+    // A second loader over the same file, which goes away before the data it
+    // read does.
+    Result<CachingDataLoader> other = make_loader();
+    ASSERT_EQ(other.error(), Error::Ok);
+    Result<FreeableBuffer> fb2 = other->load(16, 256, segment_info);
+    ASSERT_EQ(fb2.error(), Error::Ok);
+    EXPECT_EQ(fb1->data(), fb2->data());
+    EXPECT_EQ(fb2->size(), 256);
+    EXPECT_EQ(cache_.num_live_segments(), 1);
+  }
+
+  // The shared segment stays alive until its last user frees it.
+  EXPECT_EQ(cache_.num_live_segments(), 1);
+  EXPECT_EQ(0, std::memcmp(fb1->data(), contents_.data() + 16, 256));
+
+  // A different range is a different segment.
+  Result<FreeableBuffer> fb3 = loader->load(16, 128, segment_info);
+  ASSERT_EQ(fb3.error(), Error::Ok);
+  EXPECT_NE(fb3->data(), fb1->data());
+  EXPECT_EQ(cache_.num_live_segments(), 2);
+
+  fb1->Free();
+  fb3->Free();
+  EXPECT_EQ(cache_.num_live_segments(), 0);
+}
+
+TEST_F(SharedWeightCacheTest, LoadIntoBypassesCache) {
+  Result<CachingDataLoader> loader = make_loader();
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  std::vector<uint8_t> buffer(100);
+  ASSERT_EQ(
+      loader->load_into(
+          10,
+          buffer.size(),
+          DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Mutable),
+          buffer.data()),
+      Error::Ok);
+  EXPECT_EQ(0, std::memcmp(buffer.data(), contents_.data() + 10, 100));
+  EXPECT_EQ(cache_.num_live_segments(), 0);
+}
+
+TEST_F(SharedWeightCacheTest, BadArgumentsFail) {
+  EXPECT_EQ(
+      CachingDataLoader::from(temp_file_->path().c_str(), nullptr, &cache_)
+          .error(),
+      Error::InvalidArgument);
+
+  Result<FileDataLoader> fdl = FileDataLoader::from(temp_file_->path().c_str());
+  ASSERT_EQ(fdl.error(), Error::Ok);
+  EXPECT_EQ(
+      CachingDataLoader::from(
+          "/should/not/exist",
+          std::make_unique<FileDataLoader>(std::move(*fdl)),
+          &cache_)
+          .error(),
+      Error::AccessFailed);
+}
+
+TEST_F(SharedWeightCacheTest, MoveCtor) {
+  Result<CachingDataLoader> loader = make_loader();
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  CachingDataLoader loader2(std::move(*loader));
+
+  // Old loader should now be invalid.
+  const auto segment_info =
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program);
+  EXPECT_EQ(loader->size().error(), Error::InvalidState);
+  EXPECT_EQ(loader->load(0, 1, segment_info).error(), Error::InvalidState);
+
+  // New loader should point to the file.
+  Result<FreeableBuffer> fb = loader2.load(0, contents_.size(), segment_info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), contents_.data(), fb->size()));
+}
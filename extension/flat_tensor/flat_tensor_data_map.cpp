@@ -17,6 +17,7 @@
 #include <executorch/runtime/core/freeable_buffer.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/segment_compression.h>
 #include <executorch/runtime/platform/compiler.h>
 
 using executorch::runtime::Error;
@@ -26,6 +27,8 @@ using executorch::runtime::Span;
 
 using executorch::aten::ScalarType;
 using executorch::runtime::DataLoader;
+using executorch::runtime::ParallelTaskRunner;
+using executorch::runtime::SegmentCompression;
 using executorch::runtime::TensorLayout;
 
 namespace executorch {
@@ -44,27 +47,85 @@ bool is_aligned(const void* data) {
   return addr % kMinimumAlignment == 0;
 }
 
-Result<const flat_tensor_flatbuffer::TensorMetadata*> get_flat_tensor_metadata(
-    const char* key,
+/**
+ * Returns true if the tensors have names that are strictly increasing in byte
+ * order, as the serializer writes them.
+ */
+bool are_tensors_sorted(
     const flatbuffers::Vector<
         flatbuffers::Offset<flat_tensor_flatbuffer::TensorMetadata>>* tensors) {
-  // Linear search by name.
-  for (int i = 0; i < tensors->size(); i++) {
+  if (tensors == nullptr) {
+    return false;
+  }
+  const char* prev_name = nullptr;
+  for (size_t i = 0; i < tensors->size(); i++) {
+    if (tensors->Get(i)->fully_qualified_name() == nullptr) {
+      return false;
+    }
+    const char* name = tensors->Get(i)->fully_qualified_name()->c_str();
+    if (prev_name != nullptr && std::strcmp(prev_name, name) >= 0) {
+      return false;
+    }
+    prev_name = name;
+  }
+  return true;
+}
+
+/**
+ * Returns the index of the tensor with the given name, or Error::NotFound.
+ * Binary searches the tensors if `sorted` is true.
+ */
+Result<size_t> find_tensor(
+    const char* key,
+    const flatbuffers::Vector<
+        flatbuffers::Offset<flat_tensor_flatbuffer::TensorMetadata>>* tensors,
+    bool sorted) {
+  if (sorted) {
+    size_t low = 0;
+    size_t high = tensors->size();
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      const int cmp =
+          std::strcmp(tensors->Get(mid)->fully_qualified_name()->c_str(), key);
+      if (cmp == 0) {
+        return mid;
+      } else if (cmp < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return Error::NotFound;
+  }
+  // Linear search by name, for files from older serializers.
+  for (size_t i = 0; i < tensors->size(); i++) {
     if (std::strcmp(tensors->Get(i)->fully_qualified_name()->c_str(), key) ==
         0) {
-      const auto* metadata = tensors->Get(i);
-      ET_CHECK_OR_RETURN_ERROR(
-          metadata->segment_index() >= 0 && metadata->offset() >= 0,
-          InvalidExternalData,
-          "Invalid segment_index %d or offset %" PRIu64 "; malformed PTD file.",
-          metadata->segment_index(),
-          metadata->offset());
-      return metadata;
+      return i;
     }
   }
   return Error::NotFound;
 }
 
+Result<const flat_tensor_flatbuffer::TensorMetadata*> get_flat_tensor_metadata(
+    const char* key,
+    const flatbuffers::Vector<
+        flatbuffers::Offset<flat_tensor_flatbuffer::TensorMetadata>>* tensors,
+    bool sorted) {
+  Result<size_t> index = find_tensor(key, tensors, sorted);
+  if (!index.ok()) {
+    return index.error();
+  }
+  const auto* metadata = tensors->Get(index.get());
+  ET_CHECK_OR_RETURN_ERROR(
+      metadata->segment_index() >= 0 && metadata->offset() >= 0,
+      InvalidExternalData,
+      "Invalid segment_index %d or offset %" PRIu64 "; malformed PTD file.",
+      metadata->segment_index(),
+      metadata->offset());
+  return metadata;
+}
+
 Result<const TensorLayout> create_tensor_layout(
     const flat_tensor_flatbuffer::TensorMetadata* tensor_metadata) {
   ScalarType scalar_type =
@@ -95,12 +156,28 @@ Result<int> get_and_check_segment_offset(
   return segments->Get(metadata->segment_index())->offset();
 }
 
+/**
+ * Returns the compression of the segment of a tensor, or Error::NotFound if the
+ * segment is not compressed. The segment index must have been checked.
+ */
+Result<SegmentCompression> get_segment_compression(
+    const flatbuffers::Vector<
+        flatbuffers::Offset<flat_tensor_flatbuffer::DataSegment>>* segments,
+    const flat_tensor_flatbuffer::TensorMetadata* metadata) {
+  const auto* segment = segments->Get(metadata->segment_index());
+  if (segment->compression() == nullptr) {
+    return Error::NotFound;
+  }
+  return executorch::runtime::parse_segment_compression(
+      segment->compression(), segment->size());
+}
+
 } // namespace
 
 ET_NODISCARD Result<const TensorLayout> FlatTensorDataMap::get_metadata(
     const char* key) const {
   Result<const flat_tensor_flatbuffer::TensorMetadata*> metadata_res =
-      get_flat_tensor_metadata(key, flat_tensor_->tensors());
+      get_flat_tensor_metadata(key, flat_tensor_->tensors(), tensors_sorted_);
   if (!metadata_res.ok()) {
     return metadata_res.error();
   }
@@ -110,7 +187,7 @@ ET_NODISCARD Result<const TensorLayout> FlatTensorDataMap::get_metadata(
 ET_NODISCARD Result<FreeableBuffer> FlatTensorDataMap::get_data(
     const char* key) const {
   Result<const flat_tensor_flatbuffer::TensorMetadata*> metadata =
-      get_flat_tensor_metadata(key, flat_tensor_->tensors());
+      get_flat_tensor_metadata(key, flat_tensor_->tensors(), tensors_sorted_);
   if (!metadata.ok()) {
     return metadata.error();
   }
@@ -134,6 +211,21 @@ ET_NODISCARD Result<FreeableBuffer> FlatTensorDataMap::get_data(
       "; malformed PTD file.",
       segment_offset.get(),
       header_.segment_base_offset + header_.segment_data_size);
+  Result<SegmentCompression> compression =
+      get_segment_compression(flat_tensor_->segments(), metadata.get());
+  if (compression.ok()) {
+    // Decompress only the chunks that hold the tensor.
+    return executorch::runtime::load_compressed_segment(
+        loader_,
+        header_.segment_base_offset + segment_offset.get(),
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External),
+        compression.get(),
+        metadata.get()->offset(),
+        tensor_layout.get().nbytes(),
+        task_runner_);
+  } else if (compression.error() != Error::NotFound) {
+    return compression.error();
+  }
   return loader_->load(
       header_.segment_base_offset + segment_offset.get() +
           metadata.get()->offset(),
@@ -146,7 +238,7 @@ ET_NODISCARD Error FlatTensorDataMap::load_data_into(
     ET_UNUSED void* buffer,
     ET_UNUSED size_t size) const {
   Result<const flat_tensor_flatbuffer::TensorMetadata*> metadata =
-      get_flat_tensor_metadata(key, flat_tensor_->tensors());
+      get_flat_tensor_metadata(key, flat_tensor_->tensors(), tensors_sorted_);
   if (!metadata.ok()) {
     return metadata.error();
   }
@@ -170,6 +262,21 @@ ET_NODISCARD Error FlatTensorDataMap::load_data_into(
   // Load mutable data.
   DataLoader::SegmentInfo info = DataLoader::SegmentInfo(
       DataLoader::SegmentInfo::Type::Mutable, 0, nullptr);
+  Result<SegmentCompression> compression =
+      get_segment_compression(flat_tensor_->segments(), metadata.get());
+  if (compression.ok()) {
+    return executorch::runtime::load_compressed_segment_into(
+        loader_,
+        header_.segment_base_offset + segment_offset.get(),
+        info,
+        compression.get(),
+        metadata.get()->offset(),
+        tensor_layout.get().nbytes(),
+        buffer,
+        task_runner_);
+  } else if (compression.error() != Error::NotFound) {
+    return compression.error();
+  }
   return loader_->load_into(
       header_.segment_base_offset + segment_offset.get() +
           metadata.get()->offset(),
@@ -192,7 +299,8 @@ ET_NODISCARD Result<const char*> FlatTensorDataMap::get_key(
 }
 
 /* static */ Result<FlatTensorDataMap> FlatTensorDataMap::load(
-    DataLoader* loader) {
+    DataLoader* loader,
+    ParallelTaskRunner* task_runner) {
   // Check header.
   Result<FreeableBuffer> header = loader->load(
       /*offset=*/0,
@@ -249,7 +357,12 @@ ET_NODISCARD Result<const char*> FlatTensorDataMap::get_key(
       flat_tensor_flatbuffer::GetFlatTensor(flat_tensor_data->data());
 
   return FlatTensorDataMap(
-      fh.get(), std::move(flat_tensor_data.get()), flat_tensor, loader);
+      fh.get(),
+      std::move(flat_tensor_data.get()),
+      flat_tensor,
+      loader,
+      task_runner,
+      are_tensors_sorted(flat_tensor->tensors()));
 }
 
 } // namespace extension
@@ -16,6 +16,7 @@
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/tensor_layout.h>
+#include <executorch/runtime/executor/parallel_task_runner.h>
 #include <executorch/runtime/platform/compiler.h>
 
 #include <utility>
@@ -39,9 +40,13 @@ class FlatTensorDataMap final : public executorch::runtime::NamedDataMap {
    *
    * @param[in] loader The DataLoader that wraps the FlatTensor file.
    * Note: the loader must outlive the FlatTensorDataMap instance.
+   * @param[in] task_runner If not null, used to decompress the chunks of
+   * compressed segments in parallel. Note: the task runner must outlive the
+   * FlatTensorDataMap instance.
    */
   static executorch::runtime::Result<FlatTensorDataMap> load(
-      executorch::runtime::DataLoader* loader);
+      executorch::runtime::DataLoader* loader,
+      executorch::runtime::ParallelTaskRunner* task_runner = nullptr);
 
   /**
    * Retrieve the metadata for the specified key.
@@ -57,6 +62,11 @@ class FlatTensorDataMap final : public executorch::runtime::NamedDataMap {
   /**
    * Retrieve read-only data for the specified key.
    *
+   * Uncompressed data is returned as loaded by the DataLoader, without a copy:
+   * with MmapDataLoader, the buffer maps the tensor's region of the file. Files
+   * serialized with FlatTensorConfig.page_alignment place each tensor on pages
+   * of its own, so that these mappings do not share pages.
+   *
    * @param[in] key The name of the tensor to get data on.
    *
    * @return error if the key is not present or data cannot be loaded.
@@ -99,11 +109,15 @@ class FlatTensorDataMap final : public executorch::runtime::NamedDataMap {
       const FlatTensorHeader& header,
       executorch::runtime::FreeableBuffer&& flat_tensor_data,
       const flat_tensor_flatbuffer::FlatTensor* flat_tensor,
-      executorch::runtime::DataLoader* loader)
+      executorch::runtime::DataLoader* loader,
+      executorch::runtime::ParallelTaskRunner* task_runner,
+      bool tensors_sorted)
       : header_(header),
         flat_tensor_data_(std::move(flat_tensor_data)),
         flat_tensor_(flat_tensor),
-        loader_(loader) {}
+        loader_(loader),
+        task_runner_(task_runner),
+        tensors_sorted_(tensors_sorted) {}
 
   // Not copyable or assignable.
   FlatTensorDataMap(const FlatTensorDataMap& rhs) = delete;
@@ -121,6 +135,13 @@ class FlatTensorDataMap final : public executorch::runtime::NamedDataMap {
 
   // Data loader, used to load segment data.
   executorch::runtime::DataLoader* loader_;
+
+  // Decompresses compressed segments in parallel. May be null.
+  executorch::runtime::ParallelTaskRunner* task_runner_;
+
+  // True if the tensors are sorted by name, so that lookups can binary search
+  // them.
+  bool tensors_sorted_;
 };
 
 } // namespace extension
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/flat_tensor/layer_streaming_data_map.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdlib>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::NamedDataMap;
+using executorch::runtime::Result;
+using executorch::runtime::TensorLayout;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+/// Returns true if `component` is a non-empty run of decimal digits.
+bool is_numeric(const std::string& component) {
+  if (component.empty()) {
+    return false;
+  }
+  for (const char c : component) {
+    if (!std::isdigit(static_cast<unsigned char>(c))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns the prefix of `key` up to its first numeric component, e.g.
+ * "layers.3" for "layers.3.attention.wq.weight", or `key` if it has none.
+ * Matches _layer_of() in flat_tensor/serialize/serialize.py.
+ */
+std::string layer_of(const char* key) {
+  const std::string name(key);
+  size_t begin = 0;
+  while (begin <= name.size()) {
+    size_t end = name.find('.', begin);
+    if (end == std::string::npos) {
+      end = name.size();
+    }
+    if (is_numeric(name.substr(begin, end - begin))) {
+      return name.substr(0, end);
+    }
+    begin = end + 1;
+  }
+  return name;
+}
+
+/**
+ * Returns the name of the layer after `layer` if its last component is numeric,
+ * e.g. "layers.4" for "layers.3", or an empty string.
+ */
+std::string next_layer_name(const std::string& layer) {
+  const size_t dot = layer.rfind('.');
+  const size_t begin = dot == std::string::npos ? 0 : dot + 1;
+  const std::string index = layer.substr(begin);
+  if (!is_numeric(index)) {
+    return std::string();
+  }
+  return layer.substr(0, begin) +
+      std::to_string(std::strtoull(index.c_str(), nullptr, 10) + 1);
+}
+
+} // namespace
+
+/* static */ Result<LayerStreamingDataMap> LayerStreamingDataMap::create(
+    const NamedDataMap* data_map,
+    size_t max_resident_layers) {
+  ET_CHECK_OR_RETURN_ERROR(
+      data_map != nullptr, InvalidArgument, "Missing data_map");
+  ET_CHECK_OR_RETURN_ERROR(
+      max_resident_layers > 0,
+      InvalidArgument,
+      "max_resident_layers must be positive");
+  Result<size_t> num_keys = data_map->get_num_keys();
+  if (!num_keys.ok()) {
+    return num_keys.error();
+  }
+
+  // Group the keys by layer, in the order that each layer first appears.
+  std::vector<Layer> layers;
+  std::vector<std::string> layer_names;
+  std::unordered_map<std::string, size_t> layer_indices;
+  std::unordered_map<std::string, KeyLocation> key_locations;
+  for (size_t i = 0; i < num_keys.get(); ++i) {
+    Result<const char*> key = data_map->get_key(i);
+    if (!key.ok()) {
+      return key.error();
+    }
+    std::string name = layer_of(key.get());
+    auto inserted = layer_indices.emplace(name, layers.size());
+    if (inserted.second) {
+      layers.emplace_back();
+      layer_names.push_back(std::move(name));
+    }
+    Layer& layer = layers[inserted.first->second];
+    key_locations[key.get()] =
+        KeyLocation{inserted.first->second, layer.keys.size()};
+    layer.keys.push_back(key.get());
+  }
+
+  // Until execution shows otherwise, expect "layers.<N+1>" after "layers.<N>".
+  for (size_t i = 0; i < layers.size(); ++i) {
+    auto next = layer_indices.find(next_layer_name(layer_names[i]));
+    if (next != layer_indices.end()) {
+      layers[i].next = next->second;
+    }
+  }
+
+  return LayerStreamingDataMap(
+      data_map,
+      max_resident_layers,
+      std::move(layers),
+      std::move(key_locations));
+}
+
+LayerStreamingDataMap::~LayerStreamingDataMap() {
+  if (prefetch_.valid()) {
+    prefetch_.wait();
+  }
+}
+
+ET_NODISCARD Result<const TensorLayout> LayerStreamingDataMap::get_metadata(
+    const char* key) const {
+  return data_map_->get_metadata(key);
+}
+
+ET_NODISCARD Result<FreeableBuffer> LayerStreamingDataMap::get_data(
+    const char* key) const {
+  Result<KeyLocation> location = find_key(key);
+  if (!location.ok()) {
+    return location.error();
+  }
+  Error err = make_resident(location->layer);
+  if (err != Error::Ok) {
+    return err;
+  }
+  const FreeableBuffer& buffer =
+      layers_[location->layer].buffers[location->index];
+  // The layer owns the data, so the view must not free it.
+  return FreeableBuffer(buffer.data(), buffer.size(), /*free_fn=*/nullptr);
+}
+
+ET_NODISCARD Error LayerStreamingDataMap::load_data_into(
+    const char* key,
+    void* buffer,
+    size_t size) const {
+  return data_map_->load_data_into(key, buffer, size);
+}
+
+ET_NODISCARD Result<size_t> LayerStreamingDataMap::get_num_keys() const {
+  return data_map_->get_num_keys();
+}
+
+ET_NODISCARD Result<const char*> LayerStreamingDataMap::get_key(
+    size_t index) const {
+  return data_map_->get_key(index);
+}
+
+ET_NODISCARD Result<const void*> LayerStreamingDataMap::resolve(
+    const char* key,
+    size_t chain_index,
+    size_t instruction_index) {
+  Result<KeyLocation> location = find_key(key);
+  if (!location.ok()) {
+    return location.error();
+  }
+  const size_t layer = location->layer;
+  // The data of every constant of an instruction must stay valid until it
+  // returns, so the layers that it reads are not released before the next one.
+  if (chain_index != current_chain_ ||
+      instruction_index != current_instruction_) {
+    current_chain_ = chain_index;
+    current_instruction_ = instruction_index;
+    pinned_layers_.clear();
+  }
+  if (last_resolved_layer_ != kNoLayer && last_resolved_layer_ != layer) {
+    // Learn the order of the layers from the first execution.
+    Layer& previous = layers_[last_resolved_layer_];
+    if (!previous.next_observed) {
+      previous.next = layer;
+      previous.next_observed = true;
+    }
+  }
+  last_resolved_layer_ = layer;
+
+  Error err = make_resident(layer);
+  if (err != Error::Ok) {
+    return err;
+  }
+  pinned_layers_.push_back(layer);
+  const size_t next = layers_[layer].next;
+  if (next != kNoLayer && next != layer && max_resident_layers_ > 1) {
+    prefetch(next);
+  }
+  return layers_[layer].buffers[location->index].data();
+}
+
+size_t LayerStreamingDataMap::num_resident_layers() const {
+  return num_resident_;
+}
+
+/* static */ Error LayerStreamingDataMap::load_layer(
+    const NamedDataMap* data_map,
+    Layer* layer) {
+  layer->buffers.clear();
+  layer->buffers.reserve(layer->keys.size());
+  for (const char* key : layer->keys) {
+    Result<FreeableBuffer> buffer = data_map->get_data(key);
+    if (!buffer.ok()) {
+      ET_LOG(
+          Error,
+          "Failed to load '%s': 0x%" PRIx32,
+          key,
+          static_cast<uint32_t>(buffer.error()));
+      layer->buffers.clear();
+      return buffer.error();
+    }
+    layer->buffers.push_back(std::move(buffer.get()));
+  }
+  return Error::Ok;
+}
+
+Result<LayerStreamingDataMap::KeyLocation> LayerStreamingDataMap::find_key(
+    const char* key) const {
+  ET_CHECK_OR_RETURN_ERROR(key != nullptr, InvalidArgument, "Missing key");
+  auto location = key_locations_.find(key);
+  if (location == key_locations_.end()) {
+    return Error::NotFound;
+  }
+  return location->second;
+}
+
+Error LayerStreamingDataMap::make_resident(size_t layer) const {
+  // Only one thread loads from data_map_ at a time.
+  const bool prefetching = prefetch_layer_ == layer;
+  Error err = wait_for_prefetch();
+  if (prefetching && err != Error::Ok) {
+    return err;
+  }
+  Layer& target = layers_[layer];
+  if (!target.resident) {
+    make_room(layer);
+    err = load_layer(data_map_, &target);
+    if (err != Error::Ok) {
+      return err;
+    }
+    target.resident = true;
+    num_resident_++;
+  }
+  target.last_used = ++use_count_;
+  return Error::Ok;
+}
+
+void LayerStreamingDataMap::prefetch(size_t layer) const {
+  Layer& target = layers_[layer];
+  if (target.resident || prefetch_layer_ != kNoLayer) {
+    return;
+  }
+  // The current layer is the most recently used one, so it is kept.
+  make_room(layer);
+  target.resident = true;
+  target.last_used = ++use_count_;
+  num_resident_++;
+  prefetch_layer_ = layer;
+  prefetch_ = std::async(
+      std::launch::async, load_layer, data_map_, &layers_[layer]);
+}
+
+Error LayerStreamingDataMap::wait_for_prefetch() const {
+  if (prefetch_layer_ == kNoLayer) {
+    return Error::Ok;
+  }
+  Error err = prefetch_.get();
+  if (err != Error::Ok) {
+    // load_layer() left the layer empty, so it will be loaded again when it is
+    // needed.
+    layers_[prefetch_layer_].resident = false;
+    num_resident_--;
+  }
+  prefetch_layer_ = kNoLayer;
+  return err;
+}
+
+void LayerStreamingDataMap::make_room(size_t keep) const {
+  while (num_resident_ >= max_resident_layers_) {
+    size_t oldest = kNoLayer;
+    for (size_t i = 0; i < layers_.size(); ++i) {
+      if (i == keep || i == prefetch_layer_ || !layers_[i].resident ||
+          std::find(pinned_layers_.begin(), pinned_layers_.end(), i) !=
+              pinned_layers_.end()) {
+        continue;
+      }
+      if (oldest == kNoLayer ||
+          layers_[i].last_used < layers_[oldest].last_used) {
+        oldest = i;
+      }
+    }
+    if (oldest == kNoLayer) {
+      // Everything else is in use.
+      return;
+    }
+    Layer& evicted = layers_[oldest];
+    for (FreeableBuffer& buffer : evicted.buffers) {
+      buffer.Free();
+    }
+    evicted.buffers.clear();
+    evicted.resident = false;
+    num_resident_--;
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/named_data_map.h>
+
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/tensor_layout.h>
+#include <executorch/runtime/executor/external_constant_resolver.h>
+#include <executorch/runtime/platform/compiler.h>
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: A NamedDataMap that keeps only a sliding window of the layers
+ * of another NamedDataMap resident, to run models whose weights don't fit in
+ * memory.
+ *
+ * Keys are grouped into layers by their prefix up to the first numeric
+ * component, e.g. "layers.3" for "layers.3.attention.wq.weight"; keys without
+ * one form a layer of their own. This matches the grouping of
+ * FlatTensorConfig.group_tensors_by_layer, which places the tensors of a layer
+ * next to each other in the .ptd file.
+ *
+ * Load the method with this map, then pass it to
+ * `Method::set_external_constant_resolver()`. While the method executes, the
+ * layer of each constant is loaded before the instruction that reads it, and
+ * the layer that is expected to run next is loaded on a background thread.
+ * Once more than `max_resident_layers` layers would be resident, the least
+ * recently used ones are released with `FreeableBuffer::Free()`. The order of
+ * the layers is learned from the first execution; until then, "layers.<N+1>"
+ * is expected to follow "layers.<N>".
+ *
+ * Unlike most NamedDataMaps, the buffers returned by `get_data()` do not own
+ * their data, which is only valid until its layer is released. The wrapped
+ * map's `get_data()` is called from the background thread, one call at a
+ * time, so it must not rely on being called from the thread that uses this
+ * map. Not thread-safe otherwise.
+ */
+class LayerStreamingDataMap final
+    : public executorch::runtime::NamedDataMap,
+      public executorch::runtime::ExternalConstantResolver {
+ public:
+  /**
+   * Creates a LayerStreamingDataMap that wraps another NamedDataMap.
+   *
+   * @param[in] data_map The map to load the layers from. Must outlive the
+   * LayerStreamingDataMap instance.
+   * @param[in] max_resident_layers The maximum number of layers to keep
+   * resident, including the one being loaded in the background. Must be at
+   * least 2 for loads to overlap execution.
+   *
+   * @return Error::InvalidArgument if data_map is null or max_resident_layers
+   * is zero.
+   */
+  static executorch::runtime::Result<LayerStreamingDataMap> create(
+      const executorch::runtime::NamedDataMap* data_map,
+      size_t max_resident_layers = 2);
+
+  /**
+   * Retrieve the metadata for the specified key from the wrapped map.
+   */
+  ET_NODISCARD
+  executorch::runtime::Result<const executorch::runtime::TensorLayout>
+  get_metadata(const char* key) const override;
+
+  /**
+   * Makes the layer of the specified key resident, and returns a view of its
+   * data that is only valid until the layer is released.
+   *
+   * @param[in] key The name of the tensor to get data on.
+   *
+   * @return Error::NotFound if the key is not present, or the error of the
+   * wrapped map if the layer cannot be loaded.
+   */
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> get_data(
+      const char* key) const override;
+
+  /**
+   * Loads the data of the specified tensor from the wrapped map into the
+   * provided buffer, without making its layer resident.
+   */
+  ET_NODISCARD executorch::runtime::Error
+  load_data_into(const char* key, void* buffer, size_t size) const override;
+
+  /**
+   * @returns The number of keys in the wrapped map.
+   */
+  ET_NODISCARD executorch::runtime::Result<size_t> get_num_keys()
+      const override;
+
+  /**
+   * @returns The key of the wrapped map at the specified index.
+   */
+  ET_NODISCARD executorch::runtime::Result<const char*> get_key(
+      size_t index) const override;
+
+  /**
+   * Makes the layer of `key` resident, starts loading the layer expected to
+   * run next in the background, and returns the data of `key`.
+   */
+  ET_NODISCARD executorch::runtime::Result<const void*> resolve(
+      const char* key,
+      size_t chain_index,
+      size_t instruction_index) override;
+
+  /**
+   * @returns The number of layers that are resident or being loaded.
+   */
+  size_t num_resident_layers() const;
+
+  LayerStreamingDataMap(LayerStreamingDataMap&&) noexcept = default;
+
+  ~LayerStreamingDataMap() override;
+
+ private:
+  static constexpr size_t kNoLayer = SIZE_MAX;
+
+  struct Layer {
+    /// The keys of the tensors of the layer, owned by the wrapped map.
+    std::vector<const char*> keys;
+    /// The data of each key while the layer is resident.
+    std::vector<executorch::runtime::FreeableBuffer> buffers;
+    bool resident = false;
+    /// The value of use_count_ when the layer was last used.
+    uint64_t last_used = 0;
+    /// The layer expected to run after this one, or kNoLayer.
+    size_t next = kNoLayer;
+    /// True once `next` was observed rather than guessed from the names.
+    bool next_observed = false;
+  };
+
+  /// Where the data of a key lives.
+  struct KeyLocation {
+    size_t layer;
+    size_t index;
+  };
+
+  LayerStreamingDataMap(
+      const executorch::runtime::NamedDataMap* data_map,
+      size_t max_resident_layers,
+      std::vector<Layer>&& layers,
+      std::unordered_map<std::string, KeyLocation>&& key_locations)
+      : data_map_(data_map),
+        max_resident_layers_(max_resident_layers),
+        layers_(std::move(layers)),
+        key_locations_(std::move(key_locations)) {}
+
+  // Not copyable or assignable.
+  LayerStreamingDataMap(const LayerStreamingDataMap& rhs) = delete;
+  LayerStreamingDataMap& operator=(LayerStreamingDataMap&& rhs) noexcept =
+      delete;
+  LayerStreamingDataMap& operator=(const LayerStreamingDataMap& rhs) = delete;
+
+  /// Loads the buffers of every key of `layer` from `data_map`.
+  static executorch::runtime::Error load_layer(
+      const executorch::runtime::NamedDataMap* data_map,
+      Layer* layer);
+
+  executorch::runtime::Result<KeyLocation> find_key(const char* key) const;
+
+  /// Makes `layer` resident, waiting for it if it is being prefetched.
+  executorch::runtime::Error make_resident(size_t layer) const;
+
+  /// Starts loading `layer` in the background, unless it is resident.
+  void prefetch(size_t layer) const;
+
+  /// Waits for the pending prefetch, if any, and returns its error.
+  executorch::runtime::Error wait_for_prefetch() const;
+
+  /// Releases least recently used layers other than `keep` until no more than
+  /// `max_resident_layers_ - 1` layers are resident.
+  void make_room(size_t keep) const;
+
+  const executorch::runtime::NamedDataMap* data_map_;
+  const size_t max_resident_layers_;
+
+  // Resident layers change in const methods like get_data().
+  mutable std::vector<Layer> layers_;
+  std::unordered_map<std::string, KeyLocation> key_locations_;
+
+  mutable uint64_t use_count_ = 0;
+  mutable size_t num_resident_ = 0;
+
+  // The layer that resolve() was last called for, or kNoLayer.
+  size_t last_resolved_layer_ = kNoLayer;
+
+  // The instruction that resolve() was last called for, and the layers that
+  // it reads, which must stay resident until it returns.
+  size_t current_chain_ = SIZE_MAX;
+  size_t current_instruction_ = SIZE_MAX;
+  std::vector<size_t> pinned_layers_;
+
+  // The layer being loaded by prefetch_, or kNoLayer.
+  mutable size_t prefetch_layer_ = kNoLayer;
+  mutable std::future<executorch::runtime::Error> prefetch_;
+};
+
+} // namespace extension
+} // namespace executorch
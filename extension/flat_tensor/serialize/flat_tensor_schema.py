@@ -7,9 +7,10 @@
 # pyre-strict
 
 from dataclasses import dataclass
-from typing import List
+from typing import List, Optional
 
 from executorch.exir.scalar_type import ScalarType
+from executorch.exir.schema import SegmentCompression
 
 # Note: check executorch/extension/data_format/flat_tensor.fbs for explanations of these fields.
 
@@ -29,6 +30,7 @@ class TensorMetadata:
 class DataSegment:
     offset: int
     size: int
+    compression: Optional[SegmentCompression] = None
 
 
 @dataclass
@@ -13,6 +13,10 @@ from dataclasses import dataclass
 from typing import ClassVar, Dict, List, Literal, Optional, Sequence
 
 import pkg_resources
+from executorch.exir._serialize._compression import (
+    compress_segment,
+    SegmentCompressionConfig,
+)
 from executorch.exir._serialize._cord import Cord
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 
@@ -92,6 +96,29 @@ def _deserialize_to_flat_tensor(flatbuffer: bytes) -> FlatTensor:
 class FlatTensorConfig:
     tensor_alignment: int = 16
     segment_alignment: int = 16
+    # If provided, how to compress the data segments.
+    segment_compression: Optional[SegmentCompressionConfig] = None
+    # If provided, the data of every tensor starts at a file offset that is a
+    # multiple of this value. Use the page size of the target, e.g. 4096, or
+    # 16384 for both 4KB and 16KB pages, so that MmapDataLoader maps each tensor
+    # onto pages of its own, which it can then advise and release on its own.
+    # Costs up to page_alignment - 1 bytes of padding per tensor. Must be a
+    # power of 2.
+    page_alignment: Optional[int] = None
+    # If true, the data of the tensors of a layer, i.e. whose names share the
+    # prefix up to the first numeric component like "layers.3", is placed
+    # together. Layers keep the order in which their first tensor appears, so
+    # loading them in order reads the file sequentially.
+    group_tensors_by_layer: bool = False
+
+    def __post_init__(self) -> None:
+        if self.page_alignment is not None and (
+            self.page_alignment <= 0
+            or self.page_alignment & (self.page_alignment - 1) != 0
+        ):
+            raise ValueError(
+                f"page_alignment {self.page_alignment} must be a power of 2"
+            )
 
 
 @dataclass
@@ -213,6 +240,31 @@ def _get_extended_header(flat_tensor_data: bytes) -> Optional[FlatTensorHeader]:
     return None
 
 
+def _layer_of(fqn: str) -> str:
+    """Returns the prefix of fqn up to its first numeric component, e.g.
+    "layers.3" for "layers.3.attention.wq.weight", or fqn if it has none.
+    """
+    components = fqn.split(".")
+    for i, component in enumerate(components):
+        if component.isdigit():
+            return ".".join(components[: i + 1])
+    return fqn
+
+
+def _group_by_layer(fqn_to_tensor: Dict[str, TensorEntry]) -> Dict[str, TensorEntry]:
+    """Returns fqn_to_tensor with the tensors of each layer next to each other,
+    keeping the order of the layers and of the tensors within them.
+    """
+    layers: Dict[str, Dict[str, TensorEntry]] = {}
+    for fqn, tensor_entry in fqn_to_tensor.items():
+        layers.setdefault(_layer_of(fqn), {})[fqn] = tensor_entry
+    return {
+        fqn: tensor_entry
+        for layer in layers.values()
+        for fqn, tensor_entry in layer.items()
+    }
+
+
 def _extract_tensors(
     fqn_to_tensor: Dict[str, TensorEntry],
     buffers: Sequence[bytes],
@@ -220,7 +272,7 @@ def _extract_tensors(
     tensor_alignment: int,
 ) -> List[TensorMetadata]:
     """Places tensors into a single segment, aligned to tensor_alignment within
-        the segment.
+        the segment, in the order of fqn_to_tensor.
 
     Args:
         fqn_to_tensor: A map from fully qualified names to tensor entries.
@@ -229,7 +281,8 @@ def _extract_tensors(
         tensor_alignment: The alignment of the tensor data.
 
     Returns:
-        A list of TensorMetadata, which describes the tensors in the segment.
+        A list of TensorMetadata, which describes the tensors in the segment,
+        sorted by fully qualified name.
     """
     tensor_data: Cord = Cord()
     tensors: List[TensorMetadata] = []
@@ -266,6 +319,9 @@ def _extract_tensors(
             )
         )
     segments.append(tensor_data)
+    # Sorted names let the runtime binary search them. Python orders str by code
+    # point, which matches the byte order of their UTF-8 encoding.
+    tensors.sort(key=lambda tensor: tensor.fully_qualified_name)
     return tensors
 
 
@@ -289,12 +345,22 @@ class FlatTensorSerializer(DataSerializer):
     ) -> Cord:
         """Serializes a list of tensors and named data into a blob."""
 
+        # Page alignment applies to the tensor data, not to the header and the
+        # flatbuffer before it.
+        page_alignment = self.config.page_alignment or 1
+        tensor_alignment = max(self.config.tensor_alignment, page_alignment)
+        segment_alignment = max(self.config.segment_alignment, page_alignment)
+
+        fqn_to_tensor = data.fqn_to_tensor
+        if self.config.group_tensors_by_layer:
+            fqn_to_tensor = _group_by_layer(fqn_to_tensor)
+
         segments: List[Cord] = []
         tensors = _extract_tensors(
-            data.fqn_to_tensor,
+            fqn_to_tensor,
             data.buffers,
             segments,
-            self.config.tensor_alignment,
+            tensor_alignment,
         )
 
         data_segments: List[DataSegment] = []
@@ -305,16 +371,23 @@ class FlatTensorSerializer(DataSerializer):
                 if data_segments
                 else 0
             )
+            compression = None
+            if self.config.segment_compression is not None:
+                compressed = compress_segment(
+                    bytes(segment), self.config.segment_compression
+                )
+                if compressed is not None:
+                    segment = Cord(compressed[0])
+                    compression = compressed[1]
             data_segments.append(
                 DataSegment(
-                    offset=aligned_size(prev_end, self.config.segment_alignment),
+                    offset=aligned_size(prev_end, segment_alignment),
                     size=len(segment),
+                    compression=compression,
                 )
             )
             # Pad segment_data to segment alignment.
-            segment_pad_length = padding_required(
-                len(segment_data), self.config.segment_alignment
-            )
+            segment_pad_length = padding_required(len(segment_data), segment_alignment)
             if segment_pad_length > 0:
                 segment_data.append(b"\x00" * segment_pad_length)
             segment_data.append(segment)
@@ -323,7 +396,7 @@ class FlatTensorSerializer(DataSerializer):
         # points to all the data segments. It will be serialized to flatbuffer.
         flat_tensor = FlatTensor(
             version=0,  # Keep in sync with c++ version number in serialize.h
-            tensor_alignment=self.config.tensor_alignment,
+            tensor_alignment=tensor_alignment,
             tensors=tensors,
             segments=data_segments,
             named_data=[],
@@ -342,7 +415,7 @@ class FlatTensorSerializer(DataSerializer):
 
         segment_base_offset = aligned_size(
             padded_flatbuffer_length + padded_header_length,
-            self.config.segment_alignment,
+            segment_alignment,
         )
 
         # Create FlatTensorHeader, which stores the offsets and sizes of the
@@ -13,12 +13,33 @@ def define_common_targets():
             "//executorch/runtime/core:named_data_map",
             "//executorch/runtime/core/exec_aten:lib",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/runtime/executor:segment_compression",
         ],
         exported_deps = [
             "//executorch/extension/flat_tensor/serialize:flat_tensor_header",
             "//executorch/extension/flat_tensor/serialize:generated_headers",
+            "//executorch/runtime/executor:parallel_task_runner",
         ],
         visibility = [
             "//executorch/...",
         ],
     )
+
+    runtime.cxx_library(
+        name = "layer_streaming_data_map",
+        srcs = [
+            "layer_streaming_data_map.cpp",
+        ],
+        exported_headers = ["layer_streaming_data_map.h"],
+        deps = [
+            "//executorch/runtime/core:core",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:named_data_map",
+            "//executorch/runtime/executor:external_constant_resolver",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/flat_tensor/layer_streaming_data_map.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/named_data_map.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ::testing;
+using executorch::extension::LayerStreamingDataMap;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::NamedDataMap;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::runtime::TensorLayout;
+
+namespace {
+
+/**
+ * A NamedDataMap whose data for each key is the key itself. Counts the buffers
+ * that are alive, and the ones that were loaded off the test thread.
+ */
+class FakeDataMap final : public NamedDataMap {
+ public:
+  explicit FakeDataMap(std::vector<std::string> keys)
+      : keys_(std::move(keys)), test_thread_(std::this_thread::get_id()) {}
+
+  Result<const TensorLayout> get_metadata(const char* key) const override {
+    if (find(key) == nullptr) {
+      return Error::NotFound;
+    }
+    return TensorLayout::create(
+        Span<const int32_t>(sizes_, 1),
+        Span<const uint8_t>(dim_order_, 1),
+        executorch::aten::ScalarType::Char);
+  }
+
+  Result<FreeableBuffer> get_data(const char* key) const override {
+    const std::string* name = find(key);
+    if (name == nullptr) {
+      return Error::NotFound;
+    }
+    num_loads_++;
+    if (std::this_thread::get_id() != test_thread_) {
+      num_background_loads_++;
+    }
+    int live = ++num_live_buffers_;
+    int max_live = max_live_buffers_.load();
+    while (live > max_live &&
+           !max_live_buffers_.compare_exchange_weak(max_live, live)) {
+    }
+    return FreeableBuffer(
+        name->c_str(),
+        name->size(),
+        [](void* context, void*, size_t) {
+          static_cast<FakeDataMap*>(context)->num_live_buffers_--;
+        },
+        const_cast<FakeDataMap*>(this));
+  }
+
+  Error load_data_into(const char* key, void* buffer, size_t size)
+      const override {
+    const std::string* name = find(key);
+    if (name == nullptr) {
+      return Error::NotFound;
+    }
+    std::memcpy(buffer, name->data(), std::min(size, name->size()));
+    return Error::Ok;
+  }
+
+  Result<size_t> get_num_keys() const override {
+    return keys_.size();
+  }
+
+  Result<const char*> get_key(size_t index) const override {
+    if (index >= keys_.size()) {
+      return Error::InvalidArgument;
+    }
+    return keys_[index].c_str();
+  }
+
+  mutable std::atomic<int> num_loads_{0};
+  mutable std::atomic<int> num_background_loads_{0};
+  mutable std::atomic<int> num_live_buffers_{0};
+  mutable std::atomic<int> max_live_buffers_{0};
+
+ private:
+  const std::string* find(const char* key) const {
+    for (const std::string& name : keys_) {
+      if (name == key) {
+        return &name;
+      }
+    }
+    return nullptr;
+  }
+
+  const std::vector<std::string> keys_;
+  const std::thread::id test_thread_;
+  const int32_t sizes_[1] = {4};
+  const uint8_t dim_order_[1] = {0};
+};
+
+std::string data_of(const void* data, size_t size) {
+  return std::string(static_cast<const char*>(data), size);
+}
+
+} // namespace
+
+class LayerStreamingDataMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(LayerStreamingDataMapTest, InvalidArguments) {
+  FakeDataMap data_map({"layers.0.w"});
+  EXPECT_EQ(
+      LayerStreamingDataMap::create(nullptr).error(), Error::InvalidArgument);
+  EXPECT_EQ(
+      LayerStreamingDataMap::create(&data_map, /*max_resident_layers=*/0)
+          .error(),
+      Error::InvalidArgument);
+}
+
+TEST_F(LayerStreamingDataMapTest, ForwardsToWrappedMap) {
+  FakeDataMap data_map({"layers.0.w", "output.w"});
+  Result<LayerStreamingDataMap> streaming =
+      LayerStreamingDataMap::create(&data_map);
+  ASSERT_EQ(streaming.error(), Error::Ok);
+
+  EXPECT_EQ(streaming->get_num_keys().get(), 2);
+  EXPECT_STREQ(streaming->get_key(1).get(), "output.w");
+  EXPECT_EQ(streaming->get_metadata("output.w")->nbytes(), 4);
+  EXPECT_EQ(streaming->get_metadata("missing").error(), Error::NotFound);
+  EXPECT_EQ(streaming->get_data("missing").error(), Error::NotFound);
+  EXPECT_EQ(streaming->resolve("missing", 0, 0).error(), Error::NotFound);
+
+  char buffer[9] = {};
+  EXPECT_EQ(streaming->load_data_into("output.w", buffer, 8), Error::Ok);
+  EXPECT_STREQ(buffer, "output.w");
+  EXPECT_EQ(streaming->num_resident_layers(), 0);
+}
+
+TEST_F(LayerStreamingDataMapTest, GetDataKeepsWindowOfLayers) {
+  FakeDataMap data_map(
+      {"layers.0.wq",
+       "layers.0.wk",
+       "layers.1.wq",
+       "layers.1.wk",
+       "layers.2.wq",
+       "layers.2.wk"});
+  Result<LayerStreamingDataMap> streaming =
+      LayerStreamingDataMap::create(&data_map, /*max_resident_layers=*/2);
+  ASSERT_EQ(streaming.error(), Error::Ok);
+
+  for (const char* key :
+       {"layers.0.wq",
+        "layers.0.wk",
+        "layers.1.wq",
+        "layers.1.wk",
+        "layers.2.wq",
+        "layers.2.wk"}) {
+    Result<FreeableBuffer> buffer = streaming->get_data(key);
+    ASSERT_EQ(buffer.error(), Error::Ok);
+    EXPECT_EQ(data_of(buffer->data(), buffer->size()), key);
+  }
+  // Layers are loaded whole, once, and at most two at a time.
+  EXPECT_EQ(data_map.num_loads_.load(), 6);
+  EXPECT_EQ(data_map.max_live_buffers_.load(), 4);
+  EXPECT_EQ(data_map.num_live_buffers_.load(), 4);
+  EXPECT_EQ(streaming->num_resident_layers(), 2);
+  // get_data() doesn't prefetch.
+  EXPECT_EQ(data_map.num_background_loads_.load(), 0);
+}
+
+TEST_F(LayerStreamingDataMapTest, ResolvePrefetchesNextLayer) {
+  FakeDataMap data_map(
+      {"layers.0.w", "layers.1.w", "layers.10.w", "layers.2.w", "layers.3.w"});
+  Result<LayerStreamingDataMap> streaming =
+      LayerStreamingDataMap::create(&data_map, /*max_resident_layers=*/2);
+  ASSERT_EQ(streaming.error(), Error::Ok);
+
+  // Keys are sorted by name, but the layers run by number.
+  const char* keys[] = {"layers.0.w", "layers.1.w", "layers.2.w", "layers.3.w"};
+  for (size_t i = 0; i < 4; ++i) {
+    Result<const void*> data = streaming->resolve(keys[i], 0, i);
+    ASSERT_EQ(data.error(), Error::Ok);
+    EXPECT_EQ(data_of(data.get(), strlen(keys[i])), keys[i]);
+    EXPECT_LE(streaming->num_resident_layers(), 2);
+  }
+  // Every layer after the first was loaded while the previous one ran, and
+  // layers.10 was never loaded.
+  EXPECT_EQ(data_map.num_loads_.load(), 4);
+  EXPECT_EQ(data_map.num_background_loads_.load(), 3);
+  EXPECT_EQ(data_map.max_live_buffers_.load(), 2);
+}
+
+TEST_F(LayerStreamingDataMapTest, ResolveLearnsLayerOrder) {
+  FakeDataMap data_map({"embedding.w", "layers.0.w", "output.w"});
+  Result<LayerStreamingDataMap> streaming =
+      LayerStreamingDataMap::create(&data_map, /*max_resident_layers=*/2);
+  ASSERT_EQ(streaming.error(), Error::Ok);
+
+  const char* keys[] = {"embedding.w", "layers.0.w", "output.w"};
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(streaming->resolve(keys[i], 0, i).error(), Error::Ok);
+  }
+  // Nothing predicts the order of the first execution.
+  EXPECT_EQ(data_map.num_loads_.load(), 3);
+  EXPECT_EQ(data_map.num_background_loads_.load(), 0);
+
+  // The second execution learns that the first layer follows the last one.
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(streaming->resolve(keys[i], 0, i).error(), Error::Ok);
+  }
+  const int num_loads = data_map.num_loads_.load();
+  const int num_background_loads = data_map.num_background_loads_.load();
+
+  // From then on, every layer is loaded while the previous one runs.
+  for (size_t i = 0; i < 3; ++i) {
+    Result<const void*> data = streaming->resolve(keys[i], 0, i);
+    ASSERT_EQ(data.error(), Error::Ok);
+    EXPECT_EQ(data_of(data.get(), strlen(keys[i])), keys[i]);
+  }
+  EXPECT_EQ(data_map.num_loads_.load() - num_loads, 3);
+  EXPECT_EQ(
+      data_map.num_background_loads_.load() - num_background_loads, 3);
+  EXPECT_EQ(data_map.max_live_buffers_.load(), 2);
+}
+
+TEST_F(LayerStreamingDataMapTest, InstructionKeepsItsLayersResident) {
+  FakeDataMap data_map({"layers.0.w", "layers.1.w", "layers.2.w"});
+  Result<LayerStreamingDataMap> streaming =
+      LayerStreamingDataMap::create(&data_map, /*max_resident_layers=*/2);
+  ASSERT_EQ(streaming.error(), Error::Ok);
+
+  // An instruction that reads two layers that aren't next to each other.
+  Result<const void*> first = streaming->resolve("layers.0.w", 0, 0);
+  ASSERT_EQ(first.error(), Error::Ok);
+  Result<const void*> second = streaming->resolve("layers.2.w", 0, 0);
+  ASSERT_EQ(second.error(), Error::Ok);
+  // The prefetched layers.1 is released rather than layers.0.
+  EXPECT_EQ(data_of(first.get(), 10), "layers.0.w");
+  EXPECT_EQ(data_of(second.get(), 10), "layers.2.w");
+  EXPECT_EQ(data_map.num_live_buffers_.load(), 2);
+}
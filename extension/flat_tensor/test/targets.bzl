@@ -30,6 +30,17 @@ def define_common_targets(is_fbcode=False):
         ],
     )
 
+    runtime.cxx_test(
+        name = "layer_streaming_data_map_test",
+        srcs = [
+            "layer_streaming_data_map_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/flat_tensor:layer_streaming_data_map",
+            "//executorch/runtime/core:named_data_map",
+        ],
+    )
+
     if not runtime.is_oss and is_fbcode:
         modules_env = {
             # The tests use this var to find the program file to load. This uses
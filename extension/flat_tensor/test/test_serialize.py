@@ -181,3 +181,74 @@ class TestSerialize(unittest.TestCase):
             segments[0].size, aligned_size(t1_end, config.segment_alignment)
         )
         self.assertEqual(segments[0].size, header.segment_data_size)
+
+    def test_serialize_sorts_tensors(self) -> None:
+        config = FlatTensorConfig()
+        serializer: DataSerializer = FlatTensorSerializer(config)
+        payload = DataPayload(
+            buffers=TEST_TENSOR_BUFFER,
+            fqn_to_tensor={
+                fqn: TEST_TENSOR_MAP[fqn] for fqn in ("fqn3", "fqn1", "fqn2")
+            },
+        )
+        serialized_data = bytes(serializer.serialize(payload))
+        header = FlatTensorHeader.from_bytes(
+            serialized_data[8 : FlatTensorHeader.EXPECTED_LENGTH + 8]
+        )
+        flat_tensor = _deserialize_to_flat_tensor(
+            serialized_data[0 : header.flatbuffer_offset + header.flatbuffer_size]
+        )
+
+        # Tensors are sorted by name, so the runtime can binary search them,
+        # while their data keeps the order of the payload.
+        tensors = flat_tensor.tensors
+        self.assertEqual(
+            [tensor.fully_qualified_name for tensor in tensors],
+            ["fqn1", "fqn2", "fqn3"],
+        )
+        self.assertEqual(tensors[0].offset, config.tensor_alignment)
+        self.assertEqual(tensors[1].offset, config.tensor_alignment)
+        self.assertEqual(tensors[2].offset, 0)
+
+    def test_serialize_page_aligned_and_grouped_by_layer(self) -> None:
+        page_alignment = 4096
+        config = FlatTensorConfig(
+            page_alignment=page_alignment, group_tensors_by_layer=True
+        )
+        layout = TensorLayout(scalar_type=ScalarType.CHAR, sizes=[3], dim_order=[0])
+        fqns = ["layers.0.wq", "layers.1.wq", "layers.0.w1", "norm", "layers.1.w1"]
+        payload = DataPayload(
+            buffers=[bytes([i]) * 3 for i in range(len(fqns))],
+            fqn_to_tensor={
+                fqn: TensorEntry(buffer_index=i, layout=layout)
+                for i, fqn in enumerate(fqns)
+            },
+        )
+        serialized_data = bytes(FlatTensorSerializer(config).serialize(payload))
+        header = FlatTensorHeader.from_bytes(
+            serialized_data[8 : FlatTensorHeader.EXPECTED_LENGTH + 8]
+        )
+        flat_tensor = _deserialize_to_flat_tensor(
+            serialized_data[0 : header.flatbuffer_offset + header.flatbuffer_size]
+        )
+        self.assertEqual(flat_tensor.tensor_alignment, page_alignment)
+        self.assertEqual(header.segment_base_offset % page_alignment, 0)
+
+        # Every tensor starts on a page of its own, and the tensors of each
+        # layer are next to each other.
+        offsets = {}
+        for tensor in flat_tensor.tensors:
+            segment = flat_tensor.segments[tensor.segment_index]
+            offset = header.segment_base_offset + segment.offset + tensor.offset
+            self.assertEqual(offset % page_alignment, 0)
+            index = fqns.index(tensor.fully_qualified_name)
+            self.assertEqual(serialized_data[offset : offset + 3], bytes([index]) * 3)
+            offsets[tensor.fully_qualified_name] = offset
+        self.assertEqual(
+            sorted(offsets, key=lambda fqn: offsets[fqn]),
+            ["layers.0.wq", "layers.0.w1", "layers.1.wq", "layers.1.w1", "norm"],
+        )
+
+    def test_invalid_page_alignment(self) -> None:
+        with self.assertRaises(ValueError):
+            FlatTensorConfig(page_alignment=3000)
@@ -171,6 +171,35 @@ static executorch::runtime::Kernel make_boxed_kernel(
       name, WrapUnboxedIntoFunctor<FuncType>::call);
 }
 
+/// Like make_boxed_kernel() above, but also records whether the kernel may be
+/// called with its out tensor aliasing its self argument. See
+/// `Kernel::in_place_safe_`.
+template <typename FuncType>
+static executorch::runtime::Kernel
+make_boxed_kernel(const char* name, FuncType, bool in_place_safe) {
+  return executorch::runtime::Kernel(
+      name,
+      executorch::runtime::KernelKey{},
+      WrapUnboxedIntoFunctor<FuncType>::call,
+      in_place_safe);
+}
+
+/// Like make_boxed_kernel() above, but also records how much temp memory the
+/// kernel needs for its arguments. See `Kernel::scratch_size_`.
+template <typename FuncType>
+static executorch::runtime::Kernel make_boxed_kernel(
+    const char* name,
+    FuncType,
+    bool in_place_safe,
+    executorch::runtime::ScratchSizeFunction scratch_size) {
+  return executorch::runtime::Kernel(
+      name,
+      executorch::runtime::KernelKey{},
+      WrapUnboxedIntoFunctor<FuncType>::call,
+      in_place_safe,
+      scratch_size);
+}
+
 } // namespace extension
 } // namespace executorch
 
@@ -24,8 +24,12 @@ using executorch::runtime::BoxedEvalueList;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::get_op_function_from_registry;
+using executorch::runtime::Kernel;
 using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::register_kernels;
 using executorch::runtime::registry_has_op_function;
+using executorch::runtime::registry_op_is_in_place_safe;
+using executorch::runtime::registry_op_scratch_size_function;
 
 Tensor& my_op_out(KernelRuntimeContext& ctx, const Tensor& a, Tensor& out) {
   (void)ctx;
@@ -204,3 +208,39 @@ TEST_F(MakeBoxedFromUnboxedFunctorTest, UnboxOptionalArrayRef) {
     EXPECT_EQ(stack[1]->toTensor().const_data_ptr<int32_t>()[i], 1);
   }
 }
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, InPlaceSafe) {
+  Kernel kernels[] = {
+      executorch::extension::make_boxed_kernel(
+          "my_ns::in_place_safe.out",
+          EXECUTORCH_FN(my_op_out),
+          /*in_place_safe=*/true),
+      executorch::extension::make_boxed_kernel(
+          "my_ns::in_place_unsafe.out", EXECUTORCH_FN(my_op_out))};
+  ASSERT_EQ(register_kernels(kernels), Error::Ok);
+
+  EXPECT_TRUE(registry_op_is_in_place_safe("my_ns::in_place_safe.out"));
+  EXPECT_FALSE(registry_op_is_in_place_safe("my_ns::in_place_unsafe.out"));
+}
+
+size_t my_op_scratch_size(EValue** stack) {
+  return stack[0]->toTensor().nbytes();
+}
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, ScratchSize) {
+  Kernel kernels[] = {executorch::extension::make_boxed_kernel(
+      "my_ns::scratch.out",
+      EXECUTORCH_FN(my_op_out),
+      /*in_place_safe=*/false,
+      my_op_scratch_size)};
+  ASSERT_EQ(register_kernels(kernels), Error::Ok);
+
+  EXPECT_FALSE(registry_op_is_in_place_safe("my_ns::scratch.out"));
+  auto scratch_size = registry_op_scratch_size_function("my_ns::scratch.out");
+  ASSERT_NE(scratch_size, nullptr);
+
+  torch::executor::testing::TensorFactory<ScalarType::Int> tf;
+  EValue values[] = {tf.zeros({2, 3}), tf.zeros({2, 3})};
+  EValue* stack[] = {&values[0], &values[1]};
+  EXPECT_EQ(scratch_size(stack), 6 * sizeof(int32_t));
+}
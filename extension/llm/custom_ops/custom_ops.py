@@ -151,6 +151,80 @@ def fast_hadamard_transform_meta(mat):
     return torch.empty_like(mat)
 
 
+@impl(custom_ops_lib, "rms_norm", "Meta")
+def rms_norm_meta(input, weight, eps):
+    assert input.dim() >= 1, "input must have at least one dimension"
+    if weight is not None:
+        assert weight.dim() == 1 and weight.size(0) == input.size(
+            -1
+        ), f"weight must be 1-D of size {input.size(-1)}, got {weight.shape}"
+        assert (
+            weight.dtype == input.dtype
+        ), f"Expected weight dtype {input.dtype}, got {weight.dtype}"
+    return torch.empty_like(input)
+
+
+@impl(custom_ops_lib, "silu_mul", "Meta")
+def silu_mul_meta(gate, up):
+    assert (
+        gate.shape == up.shape
+    ), f"gate and up must have the same shape, got {gate.shape} and {up.shape}"
+    assert (
+        gate.dtype == up.dtype
+    ), f"gate and up must have the same dtype, got {gate.dtype} and {up.dtype}"
+    return torch.empty_like(gate)
+
+
+@impl(custom_ops_lib, "lora_bgmv", "Meta")
+def lora_bgmv_meta(x, lora_a, lora_b, adapter_ids, scale):
+    assert x.dim() >= 2, f"Expected x to have at least 2 dimensions, got {x.dim()}"
+    assert (
+        lora_a.dim() == 3 and lora_b.dim() == 3
+    ), f"Expected 3 dimensional adapter banks, got {lora_a.shape} and {lora_b.shape}"
+    assert (
+        lora_a.size(0) == lora_b.size(0) and lora_a.size(1) == lora_b.size(2)
+    ), f"lora_a {lora_a.shape} and lora_b {lora_b.shape} must have the same adapters and rank"
+    assert lora_a.size(2) == x.size(
+        -1
+    ), f"Expected {x.size(-1)} in features in lora_a, got {lora_a.size(2)}"
+    assert (
+        adapter_ids.dtype == torch.long
+        and adapter_ids.dim() == 1
+        and adapter_ids.size(0) == x.size(0)
+    ), f"Expected [{x.size(0)}] long adapter_ids, got {adapter_ids.shape} {adapter_ids.dtype}"
+    assert (
+        x.dtype == lora_a.dtype == lora_b.dtype
+    ), f"x, lora_a and lora_b must have the same dtype, got {x.dtype}, {lora_a.dtype} and {lora_b.dtype}"
+    return x.new_empty(x.shape[:-1] + (lora_b.size(1),))
+
+
+@impl(custom_ops_lib, "apply_rotary_emb", "Meta")
+def apply_rotary_emb_meta(x, freqs_cos, freqs_sin, interleaved=True):
+    assert x.dim() == 4, f"Expected x to be 4 dimensional, got {x.dim()}"
+    assert (
+        freqs_cos.shape == freqs_sin.shape
+    ), f"freqs_cos and freqs_sin shapes must match, got {freqs_cos.shape} and {freqs_sin.shape}"
+    assert freqs_cos.dim() in (2, 3) and freqs_cos.size(0) == x.size(
+        1
+    ), f"Expected freqs of shape [seq_len, d] or [seq_len, n_heads, d], got {freqs_cos.shape}"
+    if freqs_cos.dim() == 3:
+        assert freqs_cos.size(1) == x.size(
+            2
+        ), f"Expected {x.size(2)} heads in freqs, got {freqs_cos.size(1)}"
+    assert (
+        interleaved or freqs_cos.size(-1) % 2 == 0
+    ), f"Expected an even number of half-split freqs, got {freqs_cos.size(-1)}"
+    rotary_dim = freqs_cos.size(-1) * (2 if interleaved else 1)
+    assert (
+        rotary_dim <= x.size(-1)
+    ), f"freqs of size {freqs_cos.size(-1)} don't fit a head_dim of {x.size(-1)}"
+    assert freqs_cos.dtype in (
+        torch.float,
+        x.dtype,
+    ), f"Expected freqs dtype float or {x.dtype}, got {freqs_cos.dtype}"
+    return torch.empty_like(x)
+
+
 @impl(custom_ops_lib, "custom_sdpa", "Meta")
 def custom_sdpa(
     query,
@@ -229,3 +303,249 @@ def update_cache_meta(
     # workaround. Should we just return cache instead? But I am afraid that
     # will result in extra memory allocation
     return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+def _validate_paged_cache_params(
+    value,
+    cache,
+    block_table,
+    start_pos,
+):
+    assert (
+        value.dim() == 4
+    ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
+    assert (
+        cache.dim() == 4
+    ), f"Expected cache to be 4 dimensional but got {cache.dim()} dimensions."
+
+    assert (
+        value.dtype == cache.dtype
+    ), f"Expected value and cache to be of the same type but got value type {value.dtype} and cache type {cache.dtype}"
+
+    for i in [2, 3]:
+        assert value.size(i) == cache.size(
+            i
+        ), f"Expected value and cache to have same size in dimension {i} but got {value.size(i)} and {cache.size(i)}"
+
+    assert (
+        block_table.dim() == 2 and block_table.size(0) == value.size(0)
+    ), f"Expected block_table to be [batch size, max blocks] but got {block_table.size()}"
+    assert (
+        block_table.dtype == torch.int64
+    ), f"Expected block_table to be int64 but got {block_table.dtype}"
+    assert (
+        start_pos.dim() == 1 and start_pos.size(0) == value.size(0)
+    ), f"Expected start_pos to be [batch size] but got {start_pos.size()}"
+    assert (
+        start_pos.dtype == torch.int64
+    ), f"Expected start_pos to be int64 but got {start_pos.dtype}"
+
+
+@impl(custom_ops_lib, "update_cache_paged", "Meta")
+def update_cache_paged_meta(
+    value,
+    cache,
+    block_table,
+    start_pos,
+):
+    _validate_paged_cache_params(
+        value,
+        cache,
+        block_table,
+        start_pos,
+    )
+
+    # Like update_cache, the output is only a placeholder.
+    return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+@impl(custom_ops_lib, "sdpa_with_paged_kv_cache", "Meta")
+def sdpa_with_paged_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    block_table,
+    start_pos,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    assert (
+        query.dim() == 4
+    ), f"Expected query to be 4 dimensional but got {query.dim()} dimensions."
+    assert (
+        query.dtype == torch.float32
+    ), f"Expected query to be float32 but got {query.dtype}"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+    _validate_paged_cache_params(key, key_cache, block_table, start_pos)
+    _validate_paged_cache_params(value, value_cache, block_table, start_pos)
+
+    return torch.empty_like(query)
+
+
+def _validate_ring_cache_params(
+    value,
+    cache,
+    start_pos,
+    num_sinks,
+):
+    assert (
+        value.dim() == 4
+    ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
+    assert (
+        value.dtype == cache.dtype
+    ), f"Expected value and cache to be of the same type but got value type {value.dtype} and cache type {cache.dtype}"
+
+    for i in [0, 2, 3]:
+        assert value.size(i) == cache.size(
+            i
+        ), f"Expected value and cache to have same size in dimension {i} but got {value.size(i)} and {cache.size(i)}"
+
+    # start_pos may be past the cache size, but every chunk must fit in the
+    # window.
+    torch._check_is_size(start_pos)
+    torch._check(num_sinks < cache.size(1))
+    torch._check(value.size(1) <= cache.size(1) - num_sinks)
+
+
+@impl(custom_ops_lib, "update_ring_cache", "Meta")
+def update_ring_cache_meta(
+    value,
+    cache,
+    start_pos,
+    num_sinks,
+):
+    _validate_ring_cache_params(
+        value,
+        cache,
+        start_pos,
+        num_sinks,
+    )
+
+    # Like update_cache, the output is only a placeholder.
+    return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+@impl(custom_ops_lib, "sdpa_with_ring_kv_cache", "Meta")
+def sdpa_with_ring_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    start_pos,
+    seq_len,
+    num_sinks,
+    drpout_p=0.0,
+    scale=None,
+):
+    assert (
+        query.dim() == 4
+    ), f"Expected query to be 4 dimensional but got {query.dim()} dimensions."
+    assert (
+        query.dtype == torch.float32
+    ), f"Expected query to be float32 but got {query.dtype}"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+    _validate_ring_cache_params(key, key_cache, start_pos, num_sinks)
+    _validate_ring_cache_params(value, value_cache, start_pos, num_sinks)
+
+    return torch.empty_like(query)
+
+
+def _validate_quantized_cache_params(
+    value,
+    cache,
+    scales,
+    start_pos,
+):
+    assert (
+        value.dim() == 4
+    ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
+    assert (
+        value.dtype == torch.float32
+    ), f"Expected value to be float32 but got {value.dtype}"
+    assert cache.dtype in (
+        torch.int8,
+        torch.uint8,
+    ), f"Expected cache to be int8, or uint8 with packed int4, but got {cache.dtype}"
+
+    # An int4 cache packs two values per byte.
+    values_per_element = 2 if cache.dtype == torch.uint8 else 1
+    for i in [0, 2]:
+        assert value.size(i) == cache.size(
+            i
+        ), f"Expected value and cache to have same size in dimension {i} but got {value.size(i)} and {cache.size(i)}"
+    assert (
+        value.size(3) == cache.size(3) * values_per_element
+    ), f"Expected head dim {cache.size(3) * values_per_element} but got {value.size(3)}"
+
+    assert (
+        scales.dtype == torch.float32
+    ), f"Expected scales to be float32 but got {scales.dtype}"
+    assert scales.size() == (
+        *cache.size()[:3],
+        1,
+    ), f"Expected scales to be {(*cache.size()[:3], 1)} but got {scales.size()}"
+
+    torch._check_is_size(start_pos)
+    torch._check(start_pos < cache.size(1))
+
+
+@impl(custom_ops_lib, "update_quantized_cache", "Meta")
+def update_quantized_cache_meta(
+    value,
+    cache,
+    scales,
+    start_pos,
+):
+    _validate_quantized_cache_params(
+        value,
+        cache,
+        scales,
+        start_pos,
+    )
+
+    # Like update_cache, the output is only a placeholder.
+    return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+@impl(custom_ops_lib, "sdpa_with_quantized_kv_cache", "Meta")
+def sdpa_with_quantized_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    key_scales,
+    value_scales,
+    start_pos,
+    seq_len,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    assert (
+        query.dim() == 4
+    ), f"Expected query to be 4 dimensional but got {query.dim()} dimensions."
+    assert (
+        query.dtype == torch.float32
+    ), f"Expected query to be float32 but got {query.dtype}"
+    assert (
+        key_cache.dtype == value_cache.dtype
+        and key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same dtype and size but got {key_cache.size()} and {value_cache.size()}"
+    _validate_quantized_cache_params(key, key_cache, key_scales, start_pos)
+    _validate_quantized_cache_params(value, value_cache, value_scales, start_pos)
+    if attn_mask is not None:
+        assert (
+            attn_mask.dim() == 2
+        ), f"Expected attn_mask to be 2 dimensional but got {attn_mask.dim()} dimensions."
+
+    return torch.empty_like(query)
@@ -9,8 +9,12 @@
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
 #include <executorch/extension/llm/custom_ops/spinquant/fast_hadamard_transform.h>
 #include <executorch/kernels/optimized/utils/llvmMathExtras.h>
-#include <executorch/kernels/portable/cpu/util/reduce_util.h> // For apply_over_dim.
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
 
 namespace torch {
 namespace executor {
@@ -67,31 +71,78 @@ Tensor& fast_hadamard_transform_out(
       static_cast<unsigned int>(power_of_two_size),
       executorch::llvm::ZeroBehavior::ZB_Undefined);
 
+  // Each row is copied, transformed and normalized before moving on to the
+  // next one, so it stays in cache, and rows are split across threads.
+  // Half-precision rows go through a float buffer so they can use the
+  // vectorized float FHT, which is also more accurate than accumulating in
+  // half precision.
+  const int64_t row_size = last_dim_size;
+  const int64_t num_rows = mat.numel() / row_size;
+  // Keep enough work per task to amortize the scheduling overhead.
+  constexpr int64_t kMinElementsPerTask = 1 << 14;
+  const int64_t grain_size =
+      std::max<int64_t>(1, kMinElementsPerTask / row_size);
   ET_SWITCH_FLOATH_TYPES(mat.scalar_type(), ctx, __func__, CTYPE, [&] {
     const CTYPE* const mat_data = mat.const_data_ptr<CTYPE>();
     CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
 
-    std::memcpy(out_data, mat_data, mat.numel() * sizeof(CTYPE));
-
-    if (divisible_by_28) {
-      apply_over_dim(
-          [log2_power_of_two_size, out_data](
-              const size_t size, const size_t stride, const size_t base) {
-            executorch::fast_hadamard_transform_28N(
-                out_data + base, log2_power_of_two_size);
-          },
-          out,
-          out.dim() - 1);
+    auto transform_row = [divisible_by_28, log2_power_of_two_size](auto* row) {
+      if (divisible_by_28) {
+        executorch::fast_hadamard_transform_28N(row, log2_power_of_two_size);
+      } else {
+        executorch::fast_hadamard_transform(row, log2_power_of_two_size);
+      }
+    };
+    bool success = true;
+    if constexpr (std::is_floating_point_v<CTYPE>) {
+      success = torch::executor::parallel_for(
+          0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+            for (int64_t row = begin; row < end; ++row) {
+              CTYPE* const out_row = out_data + row * row_size;
+              std::memcpy(
+                  out_row, mat_data + row * row_size, row_size * sizeof(CTYPE));
+              transform_row(out_row);
+            }
+          });
     } else {
-      apply_over_dim(
-          [log2_power_of_two_size, out_data](
-              const size_t size, const size_t stride, const size_t base) {
-            executorch::fast_hadamard_transform(
-                out_data + base, log2_power_of_two_size);
-          },
-          out,
-          out.dim() - 1);
+      // Each task gets its own float buffer from temp memory. Capping the
+      // number of tasks bounds the buffers by kMaxTasks rows.
+      constexpr int64_t kMaxTasks = 16;
+      const int64_t num_tasks = std::min(
+          kMaxTasks, (num_rows + grain_size - 1) / grain_size);
+      const int64_t rows_per_task = (num_rows + num_tasks - 1) / num_tasks;
+      Result<void*> buffers = ctx.allocate_temp(
+          num_tasks * row_size * sizeof(float), alignof(float));
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          buffers.ok(),
+          MemoryAllocationFailed,
+          ,
+          "Failed to allocate the row buffers");
+      float* const buffers_data = static_cast<float*>(buffers.get());
+      success = torch::executor::parallel_for(
+          0, num_tasks, 1, [&](int64_t begin_task, int64_t end_task) {
+            for (int64_t task = begin_task; task < end_task; ++task) {
+              float* const buffer = buffers_data + task * row_size;
+              const int64_t begin = task * rows_per_task;
+              const int64_t end = std::min(begin + rows_per_task, num_rows);
+              for (int64_t row = begin; row < end; ++row) {
+                const CTYPE* const mat_row = mat_data + row * row_size;
+                CTYPE* const out_row = out_data + row * row_size;
+                std::transform(
+                    mat_row, mat_row + row_size, buffer, [](CTYPE x) {
+                      return static_cast<float>(x);
+                    });
+                transform_row(buffer);
+                std::transform(
+                    buffer, buffer + row_size, out_row, [](float x) {
+                      return static_cast<CTYPE>(x);
+                    });
+              }
+            }
+          });
     }
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
   });
   return out;
 }
@@ -8,13 +8,15 @@
 
 #include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
 #include <executorch/extension/llm/custom_ops/op_fast_hadamard_transform.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
 
 #include <torch/library.h>
 
 namespace torch::executor::native {
 namespace {
 Tensor& fast_hadamard_transform_out_no_context(const Tensor& vec, Tensor& out) {
-  executorch::aten::RuntimeContext context;
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::aten::RuntimeContext context(nullptr, &temp_allocator);
   return fast_hadamard_transform_out(context, vec, out);
 }
 at::Tensor fast_hadamard_transform_aten(const at::Tensor& vec) {
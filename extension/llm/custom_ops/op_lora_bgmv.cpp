@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_lora_bgmv.h>
+
+#include <algorithm>
+#include <array>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+bool validate_lora_bgmv_args(
+    const Tensor& x,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const Tensor& adapter_ids,
+    const Tensor& out) {
+  ET_CHECK_OR_RETURN_FALSE(
+      x.dim() >= 2, "x must have a batch and a features dimension");
+  ET_CHECK_OR_RETURN_FALSE(
+      lora_a.dim() == 3 && lora_b.dim() == 3,
+      "lora_a and lora_b must be [num adapters, rank, in features] and "
+      "[num adapters, out features, rank]");
+  ET_CHECK_OR_RETURN_FALSE(
+      lora_a.size(0) == lora_b.size(0) && lora_a.size(1) == lora_b.size(2),
+      "lora_a and lora_b must have the same adapters and rank");
+  ET_CHECK_OR_RETURN_FALSE(
+      lora_a.size(2) == x.size(x.dim() - 1),
+      "lora_a has %zd in features, x has %zd",
+      static_cast<ssize_t>(lora_a.size(2)),
+      static_cast<ssize_t>(x.size(x.dim() - 1)));
+  ET_CHECK_OR_RETURN_FALSE(
+      adapter_ids.scalar_type() == ScalarType::Long &&
+          adapter_ids.dim() == 1 && adapter_ids.size(0) == x.size(0),
+      "adapter_ids must be a Long tensor with one id per batch entry");
+  ET_CHECK_OR_RETURN_FALSE(
+      tensors_have_same_dtype(x, lora_a, lora_b) &&
+          tensors_have_same_dtype(x, out),
+      "x, lora_a, lora_b and out must have the same dtype");
+  for (const Tensor* t : {&x, &lora_a, &lora_b, &out}) {
+    ET_CHECK_OR_RETURN_FALSE(
+        is_contiguous_dim_order(t->dim_order().data(), t->dim()),
+        "x, lora_a, lora_b and out must be contiguous");
+  }
+
+  const int64_t num_adapters = lora_a.size(0);
+  const int64_t* ids = adapter_ids.const_data_ptr<int64_t>();
+  for (int64_t b = 0; b < adapter_ids.size(0); ++b) {
+    ET_CHECK_OR_RETURN_FALSE(
+        ids[b] >= -1 && ids[b] < num_adapters,
+        "adapter id %" PRId64 " of batch entry %" PRId64
+        " is not in [-1, %" PRId64 ")",
+        ids[b],
+        b,
+        num_adapters);
+  }
+  return true;
+}
+
+} // namespace
+
+Tensor& lora_bgmv_out(
+    RuntimeContext& ctx,
+    const Tensor& x,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const Tensor& adapter_ids,
+    const double scale,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_lora_bgmv_args(x, lora_a, lora_b, adapter_ids, out),
+      InvalidArgument,
+      out);
+
+  std::array<executorch::aten::SizesType, kTensorDimensionLimit> out_sizes;
+  std::copy(x.sizes().begin(), x.sizes().end(), out_sizes.begin());
+  out_sizes[x.dim() - 1] = lora_b.size(1);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, {out_sizes.data(), static_cast<size_t>(x.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  const int64_t batch_size = x.size(0);
+  const int64_t in_features = lora_a.size(2);
+  const int64_t rank = lora_a.size(1);
+  const int64_t out_features = lora_b.size(1);
+  // The rows of x, like the tokens of a prompt, of each batch entry.
+  int64_t num_rows = 1;
+  for (ssize_t d = 1; d < x.dim() - 1; ++d) {
+    num_rows *= x.size(d);
+  }
+  const int64_t* const ids = adapter_ids.const_data_ptr<int64_t>();
+
+  ET_SWITCH_FLOATHBF16_TYPES(x.scalar_type(), ctx, __func__, CTYPE, [&] {
+    const CTYPE* const x_data = x.const_data_ptr<CTYPE>();
+    const CTYPE* const a_data = lora_a.const_data_ptr<CTYPE>();
+    const CTYPE* const b_data = lora_b.const_data_ptr<CTYPE>();
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+    // x @ lora_a.T of every batch entry, [batch size, rows, rank].
+    Result<void*> shrunk = ctx.allocate_temp(
+        std::max<int64_t>(batch_size * num_rows * rank, 1) * sizeof(CTYPE),
+        alignof(CTYPE));
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        shrunk.ok(),
+        MemoryAllocationFailed,
+        ,
+        "Failed to allocate the shrunk rows");
+    CTYPE* const shrunk_data = static_cast<CTYPE*>(shrunk.get());
+    const bool success = executorch::extension::parallel_for(
+        0, batch_size, 1, [&](const auto begin, const auto end) {
+          for (int64_t b = begin; b < end; ++b) {
+            CTYPE* const out_b = out_data + b * num_rows * out_features;
+            if (ids[b] < 0) {
+              std::fill(out_b, out_b + num_rows * out_features, CTYPE(0));
+              continue;
+            }
+            CTYPE* const shrunk_b = shrunk_data + b * num_rows * rank;
+            // The matrices are row major, so each product is computed
+            // transposed: shrunk.T = lora_a @ x.T, out.T = lora_b @ shrunk.T.
+            ::executorch::cpublas::gemm(
+                ::executorch::cpublas::TransposeType::Transpose,
+                ::executorch::cpublas::TransposeType::NoTranspose,
+                rank,
+                num_rows,
+                in_features,
+                static_cast<CTYPE>(1),
+                a_data + ids[b] * rank * in_features,
+                in_features,
+                x_data + b * num_rows * in_features,
+                in_features,
+                static_cast<CTYPE>(0),
+                shrunk_b,
+                rank);
+            ::executorch::cpublas::gemm(
+                ::executorch::cpublas::TransposeType::Transpose,
+                ::executorch::cpublas::TransposeType::NoTranspose,
+                out_features,
+                num_rows,
+                rank,
+                static_cast<CTYPE>(scale),
+                b_data + ids[b] * out_features * rank,
+                rank,
+                shrunk_b,
+                rank,
+                static_cast<CTYPE>(0),
+                out_b,
+                out_features);
+          }
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "lora_bgmv.out",
+    torch::executor::native::lora_bgmv_out);
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+// The LoRA deltas of a batch whose rows each use an adapter of a bank, so
+// that sequences of different adapters are decoded in one step:
+//
+//   a = adapter_ids[b]
+//   out[b] = scale * x[b] @ lora_a[a].T @ lora_b[a].T
+//
+// x is [batch size, ..., in features], lora_a is [num adapters, rank, in
+// features], lora_b is [num adapters, out features, rank] and adapter_ids is
+// a [batch size] Long tensor. out has the sizes of x, but out features in the
+// last dimension. Rows whose adapter id is -1 use no adapter and get zeros.
+//
+// x, lora_a, lora_b and out must be contiguous and have the same dtype. The
+// rows of each batch entry go through its adapter as one matrix product, so
+// prefill is as efficient as decode.
+Tensor& lora_bgmv_out(
+    RuntimeContext& ctx,
+    const Tensor& x,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const Tensor& adapter_ids,
+    const double scale,
+    Tensor& out);
+} // namespace torch::executor::native
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_lora_bgmv.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& lora_bgmv_out_no_context(
+    const Tensor& x,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const Tensor& adapter_ids,
+    const double scale,
+    Tensor& out) {
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::aten::RuntimeContext context(nullptr, &temp_allocator);
+  return lora_bgmv_out(context, x, lora_a, lora_b, adapter_ids, scale, out);
+}
+
+at::Tensor lora_bgmv_aten(
+    const at::Tensor& x,
+    const at::Tensor& lora_a,
+    const at::Tensor& lora_b,
+    const at::Tensor& adapter_ids,
+    const double scale) {
+  auto sizes = x.sizes().vec();
+  sizes.back() = lora_b.size(1);
+  auto out = at::empty(sizes, x.options());
+  WRAP_TO_ATEN(lora_bgmv_out_no_context, 5)
+  (x, lora_a, lora_b, adapter_ids, scale, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "lora_bgmv(Tensor x, Tensor lora_a, Tensor lora_b, Tensor adapter_ids, "
+      "float scale) -> Tensor");
+  m.def(
+      "lora_bgmv.out(Tensor x, Tensor lora_a, Tensor lora_b, "
+      "Tensor adapter_ids, float scale, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("lora_bgmv", torch::executor::native::lora_bgmv_aten);
+  m.impl(
+      "lora_bgmv.out",
+      WRAP_TO_ATEN(torch::executor::native::lora_bgmv_out_no_context, 5));
+}
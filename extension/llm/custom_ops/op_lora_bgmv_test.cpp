@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_lora_bgmv.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::test_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_lora_bgmv_out(
+    const Tensor& x,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const Tensor& adapter_ids,
+    double scale,
+    Tensor& out) {
+  TempMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
+  return torch::executor::native::lora_bgmv_out(
+      context, x, lora_a, lora_b, adapter_ids, scale, out);
+}
+
+// scale * x @ a.T @ b.T of every row, each batch entry with its own adapter.
+std::vector<float> reference_lora_bgmv(
+    const std::vector<float>& x,
+    const std::vector<float>& a,
+    const std::vector<float>& b,
+    const std::vector<int64_t>& ids,
+    int64_t num_rows,
+    int64_t in_features,
+    int64_t rank,
+    int64_t out_features,
+    float scale) {
+  std::vector<float> out(ids.size() * num_rows * out_features, 0.0f);
+  for (size_t batch = 0; batch < ids.size(); ++batch) {
+    if (ids[batch] < 0) {
+      continue;
+    }
+    const float* a_i = a.data() + ids[batch] * rank * in_features;
+    const float* b_i = b.data() + ids[batch] * out_features * rank;
+    for (int64_t row = 0; row < num_rows; ++row) {
+      const float* x_row = x.data() + (batch * num_rows + row) * in_features;
+      std::vector<double> shrunk(rank, 0.0);
+      for (int64_t r = 0; r < rank; ++r) {
+        for (int64_t i = 0; i < in_features; ++i) {
+          shrunk[r] += x_row[i] * a_i[r * in_features + i];
+        }
+      }
+      for (int64_t o = 0; o < out_features; ++o) {
+        double acc = 0.0;
+        for (int64_t r = 0; r < rank; ++r) {
+          acc += shrunk[r] * b_i[o * rank + r];
+        }
+        out[(batch * num_rows + row) * out_features + o] = scale * acc;
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OpLoraBgmvTest, Small) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  // Two adapters of rank 1, from 2 to 3 features.
+  Tensor x = tf.make({3, 2}, {1, 2, 3, 4, 5, 6});
+  Tensor lora_a = tf.make({2, 1, 2}, {1, 1, 1, -1});
+  Tensor lora_b = tf.make({2, 3, 1}, {1, 2, 3, -1, 0, 1});
+  Tensor adapter_ids = tf_long.make({3}, {1, -1, 0});
+  Tensor out = tf.zeros({3, 3});
+  op_lora_bgmv_out(x, lora_a, lora_b, adapter_ids, 2.0, out);
+  // Row 0: x @ a[1].T = -1. Row 1: no adapter. Row 2: x @ a[0].T = 11.
+  EXPECT_TENSOR_CLOSE(out, tf.make({3, 3}, {2, 0, -2, 0, 0, 0, 22, 44, 66}));
+}
+
+TEST(OpLoraBgmvTest, PrefillMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  constexpr int64_t kBatch = 5;
+  constexpr int64_t kRows = 7;
+  constexpr int64_t kIn = 67;
+  constexpr int64_t kRank = 8;
+  constexpr int64_t kOut = 45;
+  constexpr int64_t kAdapters = 3;
+  const auto x_data = test_data(kBatch * kRows * kIn, 0.1f);
+  const auto a_data = test_data(kAdapters * kRank * kIn, 0.5f);
+  const auto b_data = test_data(kAdapters * kOut * kRank, 0.9f);
+  const std::vector<int64_t> ids = {2, 0, -1, 2, 1};
+  Tensor x = tf.make({kBatch, kRows, kIn}, x_data);
+  Tensor lora_a = tf.make({kAdapters, kRank, kIn}, a_data);
+  Tensor lora_b = tf.make({kAdapters, kOut, kRank}, b_data);
+  Tensor adapter_ids = tf_long.make({kBatch}, ids);
+  Tensor out = tf.zeros({kBatch, kRows, kOut});
+  op_lora_bgmv_out(x, lora_a, lora_b, adapter_ids, 0.5, out);
+  Tensor expected = tf.make(
+      {kBatch, kRows, kOut},
+      reference_lora_bgmv(
+          x_data, a_data, b_data, ids, kRows, kIn, kRank, kOut, 0.5f));
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+}
+
+TEST(OpLoraBgmvTest, InvalidAdapterIdFails) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor x = tf.ones({2, 4});
+  Tensor lora_a = tf.ones({2, 1, 4});
+  Tensor lora_b = tf.ones({2, 3, 1});
+  Tensor out = tf.zeros({2, 3});
+  for (const int64_t bad_id : {2, -2}) {
+    Tensor adapter_ids = tf_long.make({2}, {0, bad_id});
+    executorch::runtime::KernelRuntimeContext context{};
+    torch::executor::native::lora_bgmv_out(
+        context, x, lora_a, lora_b, adapter_ids, 1.0, out);
+    EXPECT_EQ(
+        context.failure_state(), executorch::runtime::Error::InvalidArgument);
+  }
+}
+
+TEST(OpLoraBgmvTest, MismatchedFeaturesFail) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor x = tf.ones({2, 4});
+  Tensor lora_a = tf.ones({2, 1, 5});
+  Tensor lora_b = tf.ones({2, 3, 1});
+  Tensor adapter_ids = tf_long.make({2}, {0, 1});
+  Tensor out = tf.zeros({2, 3});
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::lora_bgmv_out(
+      context, x, lora_a, lora_b, adapter_ids, 1.0, out);
+  EXPECT_EQ(
+      context.failure_state(), executorch::runtime::Error::InvalidArgument);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <cmath>
+#include <type_traits>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+template <typename CTYPE_ACC>
+struct SumOfSquaresReducer : SumReducer<CTYPE_ACC> {
+  template <typename T>
+  T map(const T& v) const {
+    return v * v;
+  }
+};
+
+// Normalizes one row in two passes over it: one to accumulate the sum of
+// squares and one to scale. Unlike a python-level RMSNorm, the rescaled
+// values are multiplied by the weight before rounding back to CTYPE.
+template <typename CTYPE>
+void rms_norm_row(
+    const CTYPE* in,
+    const CTYPE* weight,
+    float eps,
+    int64_t size,
+    CTYPE* out) {
+  const float sum_of_squares =
+      vectorized_reduce<CTYPE, float>(SumOfSquaresReducer<float>{}, in, size);
+  const float scale =
+      1.0f / std::sqrt(sum_of_squares / static_cast<float>(size) + eps);
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    const Vec scale_vec(scale);
+    for (; i + Vec::size() <= size; i += Vec::size()) {
+      Vec y = Vec::loadu(in + i) * scale_vec;
+      if (weight != nullptr) {
+        y = y * Vec::loadu(weight + i);
+      }
+      y.store(out + i);
+    }
+  }
+  for (; i < size; ++i) {
+    float y = static_cast<float>(in[i]) * scale;
+    if (weight != nullptr) {
+      y *= static_cast<float>(weight[i]);
+    }
+    out[i] = static_cast<CTYPE>(y);
+  }
+}
+
+} // namespace
+
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const optional<Tensor>& weight,
+    double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      input.dim() >= 1,
+      InvalidArgument,
+      out,
+      "input must have at least one dimension");
+  ET_KERNEL_CHECK(
+      ctx, input.scalar_type() == out.scalar_type(), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(input.dim_order().data(), input.dim()),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(out.dim_order().data(), out.dim()),
+      InvalidArgument,
+      out);
+
+  const int64_t row_size = input.sizes().back();
+  if (weight.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        weight->scalar_type() == input.scalar_type(),
+        InvalidArgument,
+        out);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        weight->dim() == 1 && weight->size(0) == row_size,
+        InvalidArgument,
+        out,
+        "weight must be 1-D with as many elements as the last dim of input");
+  }
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  if (input.numel() == 0) {
+    return out;
+  }
+
+  const int64_t num_rows = input.numel() / row_size;
+  const float eps_val = static_cast<float>(eps);
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, __func__, CTYPE, [&] {
+    const CTYPE* const in_data = input.const_data_ptr<CTYPE>();
+    const CTYPE* const weight_data =
+        weight.has_value() ? weight->const_data_ptr<CTYPE>() : nullptr;
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+    const bool success = executorch::extension::parallel_for(
+        0,
+        num_rows,
+        std::max<int64_t>(
+            1, executorch::extension::internal::GRAIN_SIZE / row_size),
+        [&](const auto begin, const auto end) {
+          for (const auto row : c10::irange(begin, end)) {
+            rms_norm_row(
+                in_data + row * row_size,
+                weight_data,
+                eps_val,
+                row_size,
+                out_data + row * row_size);
+          }
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "rms_norm.out",
+    torch::executor::native::rms_norm_out);
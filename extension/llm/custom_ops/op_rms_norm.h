@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+// Root mean square layer normalization over the last dimension of input,
+// which must be contiguous:
+//
+//   out = input * rsqrt(mean(input * input, -1) + eps) * weight
+//
+// weight, if present, is a 1-D tensor of the same dtype as input whose size
+// matches input.sizes().back(). Statistics are accumulated in float for
+// Half and BFloat16 inputs.
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const optional<Tensor>& weight,
+    double eps,
+    Tensor& out);
+} // namespace torch::executor::native
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::test_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_rms_norm_out(
+    const Tensor& input,
+    const optional<Tensor>& weight,
+    double eps,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::rms_norm_out(
+      context, input, weight, eps, out);
+}
+
+// Computes rms_norm over the last dim of a [rows, cols] matrix.
+std::vector<float> reference_rms_norm(
+    const std::vector<float>& input,
+    const std::vector<float>& weight,
+    int32_t cols,
+    float eps) {
+  std::vector<float> out(input.size());
+  for (size_t row = 0; row < input.size() / cols; ++row) {
+    double sum_of_squares = 0;
+    for (int32_t i = 0; i < cols; ++i) {
+      const double v = input[row * cols + i];
+      sum_of_squares += v * v;
+    }
+    const double scale = 1.0 / std::sqrt(sum_of_squares / cols + eps);
+    for (int32_t i = 0; i < cols; ++i) {
+      const double w = weight.empty() ? 1.0 : weight[i];
+      out[row * cols + i] = input[row * cols + i] * scale * w;
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OpRmsNormTest, SmallWithWeight) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.make({2, 3}, {1, 2, 3, -4, 0, 4});
+  Tensor weight = tf.make({3}, {1, 0.5, 2});
+  Tensor out = tf.zeros({2, 3});
+  // rms([1, 2, 3]) = sqrt(14 / 3), rms([-4, 0, 4]) = sqrt(32 / 3).
+  const float r0 = 1.0f / std::sqrt(14.0f / 3);
+  const float r1 = 1.0f / std::sqrt(32.0f / 3);
+  Tensor expected = tf.make(
+      {2, 3}, {r0, 2 * r0 * 0.5f, 3 * r0 * 2, -4 * r1, 0, 4 * r1 * 2});
+  op_rms_norm_out(input, weight, 0.0, out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpRmsNormTest, LongRowsWithoutWeight) {
+  TensorFactory<ScalarType::Float> tf;
+  // Long enough to use the vector and scalar tails, and enough rows to be
+  // split between threads.
+  constexpr int32_t kRows = 37;
+  constexpr int32_t kCols = 4103;
+  const auto input_data = test_data(kRows * kCols, 0.1f, 2.0f);
+  Tensor input = tf.make({kRows, kCols}, input_data);
+  Tensor out = tf.zeros({kRows, kCols});
+  op_rms_norm_out(input, executorch::aten::nullopt, 1e-5, out);
+  Tensor expected = tf.make(
+      {kRows, kCols}, reference_rms_norm(input_data, {}, kCols, 1e-5f));
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+}
+
+TEST(OpRmsNormTest, HalfAccumulatesInFloat) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Half> tf_half;
+  constexpr int32_t kRows = 3;
+  constexpr int32_t kCols = 2048;
+  // Round the inputs to half first so that the reference sees the same
+  // values as the kernel.
+  auto input_data = test_data(kRows * kCols, 0.7f, 2.0f);
+  auto weight_data = test_data(kCols, 1.3f, 2.0f);
+  for (auto& v : input_data) {
+    v = static_cast<float>(executorch::aten::Half(v));
+  }
+  for (auto& v : weight_data) {
+    v = static_cast<float>(executorch::aten::Half(v));
+  }
+  Tensor input =
+      tf_half.make({kRows, kCols}, {input_data.begin(), input_data.end()});
+  Tensor weight =
+      tf_half.make({kCols}, {weight_data.begin(), weight_data.end()});
+  Tensor out = tf_half.zeros({kRows, kCols});
+  op_rms_norm_out(input, weight, 1e-6, out);
+  const auto expected_data =
+      reference_rms_norm(input_data, weight_data, kCols, 1e-6f);
+  Tensor expected = tf_half.make(
+      {kRows, kCols}, {expected_data.begin(), expected_data.end()});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-3, 1e-3);
+}
+
+TEST(OpRmsNormTest, MismatchedWeightSizeFails) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({3});
+  Tensor out = tf.zeros({2, 4});
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::rms_norm_out(context, input, weight, 1e-5, out);
+  EXPECT_EQ(
+      context.failure_state(), executorch::runtime::Error::InvalidArgument);
+}
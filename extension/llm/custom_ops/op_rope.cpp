@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+
+#include <cstring>
+#include <type_traits>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+// Rotates one head. cos and sin point at the table entries of its position
+// and head, and half is the number of rotated pairs.
+template <typename CTYPE, typename FTYPE>
+void rope_row(
+    const CTYPE* in,
+    const FTYPE* cos,
+    const FTYPE* sin,
+    int64_t half,
+    int64_t head_dim,
+    bool interleaved,
+    CTYPE* out) {
+  int64_t i = 0;
+  if (interleaved) {
+    if constexpr (
+        std::is_same_v<CTYPE, float> && std::is_same_v<FTYPE, float>) {
+      using Vec = executorch::vec::Vectorized<float>;
+      for (; i + Vec::size() <= half; i += Vec::size()) {
+        auto [re, im] = executorch::vec::deinterleave2(
+            Vec::loadu(in + 2 * i), Vec::loadu(in + 2 * i + Vec::size()));
+        const Vec c = Vec::loadu(cos + i);
+        const Vec s = Vec::loadu(sin + i);
+        auto [lo, hi] = executorch::vec::interleave2(
+            re * c - im * s, re * s + im * c);
+        lo.store(out + 2 * i);
+        hi.store(out + 2 * i + Vec::size());
+      }
+    }
+    for (; i < half; ++i) {
+      const float re = static_cast<float>(in[2 * i]);
+      const float im = static_cast<float>(in[2 * i + 1]);
+      const float c = static_cast<float>(cos[i]);
+      const float s = static_cast<float>(sin[i]);
+      out[2 * i] = static_cast<CTYPE>(re * c - im * s);
+      out[2 * i + 1] = static_cast<CTYPE>(re * s + im * c);
+    }
+  } else {
+    const CTYPE* const in_hi = in + half;
+    CTYPE* const out_hi = out + half;
+    if constexpr (
+        std::is_same_v<CTYPE, float> && std::is_same_v<FTYPE, float>) {
+      using Vec = executorch::vec::Vectorized<float>;
+      for (; i + Vec::size() <= half; i += Vec::size()) {
+        const Vec lo = Vec::loadu(in + i);
+        const Vec hi = Vec::loadu(in_hi + i);
+        (lo * Vec::loadu(cos + i) - hi * Vec::loadu(sin + i)).store(out + i);
+        (hi * Vec::loadu(cos + half + i) + lo * Vec::loadu(sin + half + i))
+            .store(out_hi + i);
+      }
+    }
+    for (; i < half; ++i) {
+      const float lo = static_cast<float>(in[i]);
+      const float hi = static_cast<float>(in_hi[i]);
+      out[i] = static_cast<CTYPE>(
+          lo * static_cast<float>(cos[i]) - hi * static_cast<float>(sin[i]));
+      out_hi[i] = static_cast<CTYPE>(
+          hi * static_cast<float>(cos[half + i]) +
+          lo * static_cast<float>(sin[half + i]));
+    }
+  }
+  if (2 * half < head_dim) {
+    std::memcpy(
+        out + 2 * half, in + 2 * half, (head_dim - 2 * half) * sizeof(CTYPE));
+  }
+}
+
+} // namespace
+
+Tensor& apply_rotary_emb_out(
+    RuntimeContext& ctx,
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    bool interleaved,
+    Tensor& out) {
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      x.dim() == 4,
+      InvalidArgument,
+      out,
+      "x must be [batch, seq_len, n_heads, head_dim]");
+  ET_KERNEL_CHECK(
+      ctx, x.scalar_type() == out.scalar_type(), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      freqs_cos.scalar_type() == freqs_sin.scalar_type() &&
+          (freqs_cos.scalar_type() == ScalarType::Float ||
+           freqs_cos.scalar_type() == x.scalar_type()),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_shape(freqs_cos, freqs_sin), InvalidArgument, out);
+  const Tensor* const tensors[] = {&x, &freqs_cos, &freqs_sin, &out};
+  for (const Tensor* t : tensors) {
+    ET_KERNEL_CHECK(
+        ctx,
+        is_contiguous_dim_order(t->dim_order().data(), t->dim()),
+        InvalidArgument,
+        out);
+  }
+
+  const int64_t seq_len = x.size(1);
+  const int64_t n_heads = x.size(2);
+  const int64_t head_dim = x.size(3);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      (freqs_cos.dim() == 2 ||
+       (freqs_cos.dim() == 3 && freqs_cos.size(1) == n_heads)) &&
+          freqs_cos.size(0) == seq_len,
+      InvalidArgument,
+      out,
+      "freqs must be [seq_len, d] or [seq_len, n_heads, d]");
+  const int64_t freqs_dim = freqs_cos.sizes().back();
+  const int64_t half = interleaved ? freqs_dim : freqs_dim / 2;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      (interleaved || freqs_dim % 2 == 0) && 2 * half <= head_dim,
+      InvalidArgument,
+      out,
+      "freqs of size %zd don't fit a head_dim of %zd",
+      static_cast<ssize_t>(freqs_dim),
+      static_cast<ssize_t>(head_dim));
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, x.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  if (x.numel() == 0) {
+    return out;
+  }
+
+  const int64_t num_rows = x.numel() / head_dim;
+  const int64_t freqs_head_stride = freqs_cos.dim() == 3 ? freqs_dim : 0;
+  const int64_t freqs_seq_stride = freqs_cos.dim() == 3
+      ? n_heads * freqs_dim
+      : freqs_dim;
+  ET_SWITCH_FLOATHBF16_TYPES(x.scalar_type(), ctx, __func__, CTYPE, [&] {
+    ET_SWITCH_FLOATHBF16_TYPES(
+        freqs_cos.scalar_type(), ctx, __func__, FTYPE, [&] {
+          const CTYPE* const in_data = x.const_data_ptr<CTYPE>();
+          const FTYPE* const cos_data = freqs_cos.const_data_ptr<FTYPE>();
+          const FTYPE* const sin_data = freqs_sin.const_data_ptr<FTYPE>();
+          CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+          const bool success = executorch::extension::parallel_for(
+              0,
+              num_rows,
+              std::max<int64_t>(
+                  1, executorch::extension::internal::GRAIN_SIZE / head_dim),
+              [&](const auto begin, const auto end) {
+                for (const auto row : c10::irange(begin, end)) {
+                  const int64_t head = row % n_heads;
+                  const int64_t pos = (row / n_heads) % seq_len;
+                  const int64_t freqs_offset =
+                      pos * freqs_seq_stride + head * freqs_head_stride;
+                  rope_row(
+                      in_data + row * head_dim,
+                      cos_data + freqs_offset,
+                      sin_data + freqs_offset,
+                      half,
+                      head_dim,
+                      interleaved,
+                      out_data + row * head_dim);
+                }
+              });
+          ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+        });
+  });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "apply_rotary_emb.out",
+    torch::executor::native::apply_rotary_emb_out);
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+// Rotary position embedding of x, which must be a contiguous
+// [batch, seq_len, n_heads, head_dim] tensor, using precomputed tables of
+// shape [seq_len, d] or [seq_len, n_heads, d]:
+//
+// - interleaved (Meta Llama): (x[2i], x[2i + 1]) is rotated by cos[i] and
+//   sin[i], and d is rotary_dim / 2.
+// - half-split (HuggingFace): (x[i], x[i + rotary_dim / 2]) is rotated by
+//   cos[i] and sin[i], and cos[i + rotary_dim / 2] and sin[i + rotary_dim / 2],
+//   and d is rotary_dim.
+//
+// Elements past rotary_dim, which may be smaller than head_dim, are copied
+// through unchanged. freqs_cos and freqs_sin are either Float or the dtype of
+// x, and the rotation is computed in float.
+Tensor& apply_rotary_emb_out(
+    RuntimeContext& ctx,
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    bool interleaved,
+    Tensor& out);
+} // namespace torch::executor::native
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::test_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_apply_rotary_emb_out(
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    bool interleaved,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::apply_rotary_emb_out(
+      context, x, freqs_cos, freqs_sin, interleaved, out);
+}
+
+// freqs[pos, i] = pos * base ** (-i / n), like precompute_freqs_cis in
+// examples/models/llama/rope.py. With duplicate set, the table has 2n entries
+// per position like hf_precompute_freqs_cis.
+void make_freqs(
+    int64_t seq_len,
+    int64_t n,
+    bool duplicate,
+    std::vector<float>& cos,
+    std::vector<float>& sin) {
+  const int64_t d = duplicate ? 2 * n : n;
+  cos.resize(seq_len * d);
+  sin.resize(seq_len * d);
+  for (int64_t pos = 0; pos < seq_len; ++pos) {
+    for (int64_t i = 0; i < d; ++i) {
+      const float freq =
+          pos * std::pow(10000.0f, -static_cast<float>(i % n) / n);
+      cos[pos * d + i] = std::cos(freq);
+      sin[pos * d + i] = std::sin(freq);
+    }
+  }
+}
+
+// Rotates a [batch, seq_len, n_heads, head_dim] x with [seq_len, d] tables.
+std::vector<float> reference_rope(
+    const std::vector<float>& x,
+    const std::vector<float>& cos,
+    const std::vector<float>& sin,
+    int64_t seq_len,
+    int64_t n_heads,
+    int64_t head_dim,
+    int64_t d,
+    bool interleaved) {
+  std::vector<float> out = x;
+  const int64_t half = interleaved ? d : d / 2;
+  for (size_t row = 0; row < x.size() / head_dim; ++row) {
+    const int64_t pos = (row / n_heads) % seq_len;
+    const float* in = x.data() + row * head_dim;
+    float* dst = out.data() + row * head_dim;
+    const float* c = cos.data() + pos * d;
+    const float* s = sin.data() + pos * d;
+    for (int64_t i = 0; i < half; ++i) {
+      if (interleaved) {
+        dst[2 * i] = in[2 * i] * c[i] - in[2 * i + 1] * s[i];
+        dst[2 * i + 1] = in[2 * i] * s[i] + in[2 * i + 1] * c[i];
+      } else {
+        dst[i] = in[i] * c[i] - in[i + half] * s[i];
+        dst[i + half] = in[i + half] * c[i + half] + in[i] * s[i + half];
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OpApplyRotaryEmbTest, Interleaved) {
+  TensorFactory<ScalarType::Float> tf;
+  // 10 pairs per head to use both the vector loop and the scalar tail.
+  constexpr int64_t kBatch = 2;
+  constexpr int64_t kSeqLen = 5;
+  constexpr int64_t kHeads = 3;
+  constexpr int64_t kHeadDim = 20;
+  std::vector<float> cos, sin;
+  make_freqs(kSeqLen, kHeadDim / 2, /*duplicate=*/false, cos, sin);
+  const auto x_data =
+      test_data(kBatch * kSeqLen * kHeads * kHeadDim, 0.1f, 2.0f);
+  Tensor x = tf.make({kBatch, kSeqLen, kHeads, kHeadDim}, x_data);
+  Tensor freqs_cos = tf.make({kSeqLen, kHeadDim / 2}, cos);
+  Tensor freqs_sin = tf.make({kSeqLen, kHeadDim / 2}, sin);
+  Tensor out = tf.zeros({kBatch, kSeqLen, kHeads, kHeadDim});
+  op_apply_rotary_emb_out(x, freqs_cos, freqs_sin, /*interleaved=*/true, out);
+  Tensor expected = tf.make(
+      {kBatch, kSeqLen, kHeads, kHeadDim},
+      reference_rope(
+          x_data,
+          cos,
+          sin,
+          kSeqLen,
+          kHeads,
+          kHeadDim,
+          kHeadDim / 2,
+          /*interleaved=*/true));
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-6, 1e-6);
+}
+
+TEST(OpApplyRotaryEmbTest, HalfSplitPartialRotary) {
+  TensorFactory<ScalarType::Float> tf;
+  // Rotates the first 24 of 28 elements of each head, per-head tables as
+  // produced by materialze_broadcast_of_rope_freq_cis.
+  constexpr int64_t kSeqLen = 3;
+  constexpr int64_t kHeads = 2;
+  constexpr int64_t kHeadDim = 28;
+  constexpr int64_t kRotaryDim = 24;
+  std::vector<float> cos, sin;
+  make_freqs(kSeqLen, kRotaryDim / 2, /*duplicate=*/true, cos, sin);
+  std::vector<float> cos_per_head, sin_per_head;
+  for (int64_t pos = 0; pos < kSeqLen; ++pos) {
+    for (int64_t h = 0; h < kHeads; ++h) {
+      cos_per_head.insert(
+          cos_per_head.end(),
+          cos.begin() + pos * kRotaryDim,
+          cos.begin() + (pos + 1) * kRotaryDim);
+      sin_per_head.insert(
+          sin_per_head.end(),
+          sin.begin() + pos * kRotaryDim,
+          sin.begin() + (pos + 1) * kRotaryDim);
+    }
+  }
+  const auto x_data = test_data(kSeqLen * kHeads * kHeadDim, 0.4f, 2.0f);
+  Tensor x = tf.make({1, kSeqLen, kHeads, kHeadDim}, x_data);
+  Tensor freqs_cos = tf.make({kSeqLen, kHeads, kRotaryDim}, cos_per_head);
+  Tensor freqs_sin = tf.make({kSeqLen, kHeads, kRotaryDim}, sin_per_head);
+  Tensor out = tf.zeros({1, kSeqLen, kHeads, kHeadDim});
+  op_apply_rotary_emb_out(x, freqs_cos, freqs_sin, /*interleaved=*/false, out);
+  Tensor expected = tf.make(
+      {1, kSeqLen, kHeads, kHeadDim},
+      reference_rope(
+          x_data,
+          cos,
+          sin,
+          kSeqLen,
+          kHeads,
+          kHeadDim,
+          kRotaryDim,
+          /*interleaved=*/false));
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-6, 1e-6);
+}
+
+TEST(OpApplyRotaryEmbTest, BFloat16WithFloatFreqs) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::BFloat16> tf_bf16;
+  constexpr int64_t kSeqLen = 4;
+  constexpr int64_t kHeads = 2;
+  constexpr int64_t kHeadDim = 16;
+  std::vector<float> cos, sin;
+  make_freqs(kSeqLen, kHeadDim / 2, /*duplicate=*/false, cos, sin);
+  // Round the inputs first so that the reference sees the same values as the
+  // kernel.
+  auto x_data = test_data(kSeqLen * kHeads * kHeadDim, 0.9f, 2.0f);
+  for (auto& v : x_data) {
+    v = static_cast<float>(executorch::aten::BFloat16(v));
+  }
+  Tensor x = tf_bf16.make(
+      {1, kSeqLen, kHeads, kHeadDim}, {x_data.begin(), x_data.end()});
+  Tensor freqs_cos = tf.make({kSeqLen, kHeadDim / 2}, cos);
+  Tensor freqs_sin = tf.make({kSeqLen, kHeadDim / 2}, sin);
+  Tensor out = tf_bf16.zeros({1, kSeqLen, kHeads, kHeadDim});
+  op_apply_rotary_emb_out(x, freqs_cos, freqs_sin, /*interleaved=*/true, out);
+  const auto expected_data = reference_rope(
+      x_data,
+      cos,
+      sin,
+      kSeqLen,
+      kHeads,
+      kHeadDim,
+      kHeadDim / 2,
+      /*interleaved=*/true);
+  Tensor expected = tf_bf16.make(
+      {1, kSeqLen, kHeads, kHeadDim},
+      {expected_data.begin(), expected_data.end()});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-2, 1e-2);
+}
+
+TEST(OpApplyRotaryEmbTest, MismatchedSeqLenFails) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({1, 3, 2, 8});
+  Tensor freqs = tf.ones({2, 4});
+  Tensor out = tf.zeros({1, 3, 2, 8});
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::apply_rotary_emb_out(
+      context, x, freqs, freqs, /*interleaved=*/true, out);
+  EXPECT_EQ(
+      context.failure_state(), executorch::runtime::Error::InvalidArgument);
+}
+
+TEST(OpApplyRotaryEmbTest, FreqsTooLargeFails) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({1, 3, 2, 8});
+  Tensor freqs = tf.ones({3, 8});
+  Tensor out = tf.zeros({1, 3, 2, 8});
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::apply_rotary_emb_out(
+      context, x, freqs, freqs, /*interleaved=*/true, out);
+  EXPECT_EQ(
+      context.failure_state(), executorch::runtime::Error::InvalidArgument);
+}
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
 #include <executorch/kernels/optimized/vec/functional.h>
@@ -213,8 +214,73 @@ sdpa_with_kv_cache does not use attn_mask.
 
 TODO: Just handle conversion of bool mask to float
 */
+
+/*
+A paged KV cache is a pool of [num blocks, block size, num heads, head dim]
+blocks shared by the whole batch, instead of a [batch size, max seq len, num
+heads, head dim] tensor. Position p of sequence b lives in row p % block_size
+of block block_table[b][p / block_size], and each sequence has its own
+start_pos, so a sequence only holds blocks for what it has filled.
+*/
+struct PagedKVCache {
+  const int64_t* block_table;
+  // Row stride of block_table, i.e. the max number of blocks per sequence.
+  int64_t block_table_stride;
+  int64_t block_size;
+  // [batch size]
+  const int64_t* start_pos;
+};
+
+/*
+A quantized KV cache holds int8 values, or int4 values packed two per byte,
+with one Float scale per position and head (see update_quantized_cache_out).
+key and value are then the Char or Byte caches, and every kv split is
+dequantized into a per-thread [kv split size x head dim] buffer right before
+it is used, so that the caches are never expanded to float as a whole.
+*/
+struct QuantizedKVCache {
+  // [batch size, max seq len, num heads kv, 1]
+  const float* key_scales;
+  const float* value_scales;
+  int64_t scaleStrideB;
+  int64_t scaleStrideN;
+  bool is_int4;
+};
+
+// Dequantizes count positions of one head of a quantized cache, stride
+// elements apart with their scales scale_stride apart, into a
+// [count x head_size] buffer.
+template <typename accum_t>
+void dequantize_kv_rows(
+    const uint8_t* data,
+    const float* scales,
+    int64_t stride,
+    int64_t scale_stride,
+    int64_t count,
+    int64_t head_size,
+    bool is_int4,
+    accum_t* dst) {
+  for (int64_t t = 0; t < count; ++t) {
+    const uint8_t* src = data + t * stride;
+    const accum_t scale = scales[t * scale_stride];
+    accum_t* dst_row = dst + t * head_size;
+    if (is_int4) {
+      for (int64_t d = 0; d < head_size / 2; ++d) {
+        dst_row[2 * d] = static_cast<accum_t>((src[d] & 0xF) - 8) * scale;
+        dst_row[2 * d + 1] = static_cast<accum_t>((src[d] >> 4) - 8) * scale;
+      }
+    } else {
+      const int8_t* src_int8 = reinterpret_cast<const int8_t*>(src);
+      for (int64_t d = 0; d < head_size; ++d) {
+        dst_row[d] = static_cast<accum_t>(src_int8[d]) * scale;
+      }
+    }
+  }
+}
+
 template <typename scalar_t, int64_t q_split_size, int64_t kv_split_size>
 void cpu_flash_attention(
+    RuntimeContext& ctx,
     Tensor& output,
     const Tensor& query,
     const Tensor& key,
@@ -224,7 +290,9 @@ void cpu_flash_attention(
     const optional<Tensor>& attn_mask,
     const optional<double>& scale,
     bool is_seq_at_dim_1 = false,
-    const int64_t start_pos = 0) {
+    const int64_t start_pos = 0,
+    const PagedKVCache* paged_kv_cache = nullptr,
+    const QuantizedKVCache* quantized_kv_cache = nullptr) {
   (void)dropout_p;
   // Query (Batch x Num_heads  x Q_seq_len  x Dim_per_head)
   // Key   (Batch x Num_heads  x KV_seq_len x Dim_per_head)
@@ -271,6 +339,19 @@ void cpu_flash_attention(
     kvSize = value.size(1);
   }
 
+  if (paged_kv_cache != nullptr) {
+    // key and value are the block pools. Every sequence attends to its own
+    // start_pos + qSize positions, and one kv split is one block so that
+    // each split is contiguous.
+    ET_CHECK_MSG(
+        is_seq_at_dim_1 && !(attn_mask.has_value() && attn_mask->numel()),
+        "Paged KV cache needs seq at dim 1 and no attn_mask");
+    kvSize = 0;
+    for (int64_t b = 0; b < batchSize; ++b) {
+      kvSize = std::max(kvSize, paged_kv_cache->start_pos[b] + qSize);
+    }
+  }
+
   ET_CHECK_MSG(
       num_heads_kv <= num_head,
       "FlashAttention does not support num kv heads > num query heads.Got num query heads=%" PRId64
@@ -363,6 +444,9 @@ void cpu_flash_attention(
 
   int64_t qSplitSize = q_split_size > qSize ? qSize : q_split_size;
   int64_t kvSplitSize = kv_split_size > kvSize ? kvSize : kv_split_size;
+  if (paged_kv_cache != nullptr) {
+    kvSplitSize = paged_kv_cache->block_size;
+  }
   int64_t qSlice = (qSize - 1) / qSplitSize + 1;
 #ifdef ET_USE_THREADPOOL
   int64_t num_thread =
@@ -383,26 +467,344 @@ void cpu_flash_attention(
       /* dst    */ qSplitSize * headSize;
 
   int64_t size_bytes = size_per_thread * num_thread * query.element_size();
-  std::vector<char> buf_vec(size_bytes);
-  void* buf = reinterpret_cast<void*>(buf_vec.data());
+  Result<void*> buf = ctx.allocate_temp(size_bytes, alignof(accum_t));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      buf.ok(),
+      MemoryAllocationFailed,
+      ,
+      "Failed to allocate the attention buffers");
   // Need to double check the following
   size_bytes = num_thread * qSplitSize * kvSplitSize * query.element_size();
-  std::vector<char> buf_reduced_vec(size_bytes);
-  void* buf_reduced = reinterpret_cast<void*>(buf_reduced_vec.data());
+  Result<void*> buf_reduced = ctx.allocate_temp(size_bytes, alignof(scalar_t));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      buf_reduced.ok(),
+      MemoryAllocationFailed,
+      ,
+      "Failed to allocate the reduced attention buffers");
   // at::Tensor buf_reduced = at::empty(
   //    {num_thread, qSplitSize, is_reduced_type ? kvSplitSize : 0},
   //    query.options());
 
   // Data ptrs
   const scalar_t* q_data = query.const_data_ptr<scalar_t>();
-  const scalar_t* k_data = key.const_data_ptr<scalar_t>();
-  const scalar_t* v_data = value.const_data_ptr<scalar_t>();
+  const scalar_t* k_data = quantized_kv_cache == nullptr
+      ? key.const_data_ptr<scalar_t>()
+      : nullptr;
+  const scalar_t* v_data = quantized_kv_cache == nullptr
+      ? value.const_data_ptr<scalar_t>()
+      : nullptr;
   const accum_t* mask_data =
       has_attn_mask ? attn_mask.value().const_data_ptr<accum_t>() : nullptr;
   scalar_t* out_data = output.mutable_data_ptr<scalar_t>();
-  accum_t* buf_data = reinterpret_cast<accum_t*>(buf);
+  accum_t* buf_data = static_cast<accum_t*>(buf.get());
   scalar_t* buf_reduced_data =
-      is_reduced_type ? reinterpret_cast<scalar_t*>(buf_reduced) : nullptr;
+      is_reduced_type ? static_cast<scalar_t*>(buf_reduced.get()) : nullptr;
+
+  // Offset of the key or value at position n of sequence b, where n is the
+  // start of a kv split.
+  auto kv_offset = [paged_kv_cache](
+                       int64_t b, int64_t n, int64_t strideB, int64_t strideN) {
+    if (paged_kv_cache == nullptr) {
+      return b * strideB + n * strideN;
+    }
+    const int64_t block = paged_kv_cache->block_table
+                              [b * paged_kv_cache->block_table_stride +
+                               n / paged_kv_cache->block_size];
+    return block * strideB + (n % paged_kv_cache->block_size) * strideN;
+  };
+
+  // With a quantized cache, every thread dequantizes the keys and the values
+  // of its current kv split into its own buffers, and reads them from there.
+  accum_t* dequant_data = nullptr;
+  if (quantized_kv_cache != nullptr) {
+    Result<void*> dequant = ctx.allocate_temp(
+        num_thread * 2 * kvSplitSize * headSize * sizeof(accum_t),
+        alignof(accum_t));
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        dequant.ok(),
+        MemoryAllocationFailed,
+        ,
+        "Failed to allocate the dequantized kv buffers");
+    dequant_data = static_cast<accum_t*>(dequant.get());
+  }
+  // The keys of kv head j_kv of sequence i at positions [n, n + count), and
+  // their row stride.
+  auto key_split = [&](int64_t i, int64_t n, int64_t j_kv, int64_t count,
+                       int64_t& row_stride) -> const scalar_t* {
+    if (quantized_kv_cache == nullptr) {
+      row_stride = kStrideN;
+      return k_data + kv_offset(i, n, kStrideB, kStrideN) + j_kv * kStrideH;
+    }
+    accum_t* buf_ptr = dequant_data +
+        torch::executor::get_thread_num() * 2 * kvSplitSize * headSize;
+    dequantize_kv_rows(
+        static_cast<const uint8_t*>(key.const_data_ptr()) +
+            kv_offset(i, n, kStrideB, kStrideN) + j_kv * kStrideH,
+        quantized_kv_cache->key_scales +
+            kv_offset(
+                i,
+                n,
+                quantized_kv_cache->scaleStrideB,
+                quantized_kv_cache->scaleStrideN) +
+            j_kv,
+        kStrideN,
+        quantized_kv_cache->scaleStrideN,
+        count,
+        headSize,
+        quantized_kv_cache->is_int4,
+        buf_ptr);
+    row_stride = headSize;
+    return buf_ptr;
+  };
+  // Same as key_split, for the values.
+  auto value_split = [&](int64_t i, int64_t n, int64_t j_kv, int64_t count,
+                         int64_t& row_stride) -> const scalar_t* {
+    if (quantized_kv_cache == nullptr) {
+      row_stride = vStrideN;
+      return v_data + kv_offset(i, n, vStrideB, vStrideN) + j_kv * vStrideH;
+    }
+    accum_t* buf_ptr = dequant_data +
+        (torch::executor::get_thread_num() * 2 + 1) * kvSplitSize * headSize;
+    dequantize_kv_rows(
+        static_cast<const uint8_t*>(value.const_data_ptr()) +
+            kv_offset(i, n, vStrideB, vStrideN) + j_kv * vStrideH,
+        quantized_kv_cache->value_scales +
+            kv_offset(
+                i,
+                n,
+                quantized_kv_cache->scaleStrideB,
+                quantized_kv_cache->scaleStrideN) +
+            j_kv,
+        vStrideN,
+        quantized_kv_cache->scaleStrideN,
+        count,
+        headSize,
+        quantized_kv_cache->is_int4,
+        buf_ptr);
+    row_stride = headSize;
+    return buf_ptr;
+  };
+
+  if (qSize == 1) {
+    // Decode (flash-decoding): with a single query token there are only
+    // batchSize * num_heads_kv independent rows of work, fewer than the
+    // threads with GQA, and the loop over the kv splits of each is serial.
+    // So split the keys of every (batch, kv head) into num_splits ranges,
+    // run each as a separate task that keeps its own max, sum and
+    // unnormalized output, and then rescale the partial results by
+    // exp(max - global max) and combine them. The num_reps query heads that
+    // share a kv head run together, as one [num_reps x headSize] block, so
+    // that each key and value is read once for all of them.
+    int64_t max_num_keys = 0;
+    for (int64_t b = 0; b < batchSize; ++b) {
+      const int64_t seq_start_pos = paged_kv_cache != nullptr
+          ? paged_kv_cache->start_pos[b]
+          : start_pos;
+      const int64_t seq_kv_size =
+          paged_kv_cache != nullptr ? seq_start_pos + qSize : kvSize;
+      max_num_keys = std::max(
+          max_num_keys,
+          is_causal ? std::min(seq_start_pos + 1, seq_kv_size) : seq_kv_size);
+    }
+    // Splits shorter than this don't pay for combining them.
+    constexpr int64_t kMinDecodeSplitSize = 256;
+    const int64_t num_groups = batchSize * num_heads_kv;
+    const int64_t num_splits = std::max<int64_t>(
+        1,
+        std::min(
+            (num_thread + num_groups - 1) / num_groups,
+            max_num_keys / kMinDecodeSplitSize));
+    int64_t split_size = (max_num_keys + num_splits - 1) / num_splits;
+    if (paged_kv_cache != nullptr) {
+      // Whole blocks, so that every kv split stays within one.
+      split_size = (split_size + kvSplitSize - 1) / kvSplitSize * kvSplitSize;
+    }
+
+    // Per task, the max and sum of each query head followed by its output.
+    const int64_t partial_size = num_reps * (2 + headSize);
+    Result<void*> partial = ctx.allocate_temp(
+        num_groups * num_splits * partial_size * sizeof(accum_t),
+        alignof(accum_t));
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        partial.ok(),
+        MemoryAllocationFailed,
+        ,
+        "Failed to allocate the partial attention results");
+    accum_t* partial_data = static_cast<accum_t*>(partial.get());
+    Result<void*> decode_qk = ctx.allocate_temp(
+        num_thread * num_reps * kvSplitSize * sizeof(accum_t),
+        alignof(accum_t));
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        decode_qk.ok(),
+        MemoryAllocationFailed,
+        ,
+        "Failed to allocate the decode attention scores");
+    accum_t* decode_qk_data = static_cast<accum_t*>(decode_qk.get());
+
+    auto decode_lambda = [&](int64_t begin, int64_t end) {
+      accum_t* qk_data = decode_qk_data +
+          torch::executor::get_thread_num() * num_reps * kvSplitSize;
+      for (int64_t task = begin; task < end; ++task) {
+        const int64_t i = task / (num_heads_kv * num_splits);
+        const int64_t j_kv = task / num_splits % num_heads_kv;
+        const int64_t split = task % num_splits;
+        accum_t* qk_max_data = partial_data + task * partial_size;
+        accum_t* qk_sum_data = qk_max_data + num_reps;
+        accum_t* dst_data = qk_sum_data + num_reps;
+        fill_stub(
+            qk_max_data, -std::numeric_limits<accum_t>::infinity(), num_reps);
+        fill_stub(qk_sum_data, static_cast<accum_t>(0), num_reps);
+        fill_stub(dst_data, static_cast<accum_t>(0), num_reps * headSize);
+
+        const int64_t seq_start_pos = paged_kv_cache != nullptr
+            ? paged_kv_cache->start_pos[i]
+            : start_pos;
+        const int64_t seq_kv_size =
+            paged_kv_cache != nullptr ? seq_start_pos + qSize : kvSize;
+        const int64_t num_keys = is_causal
+            ? std::min(seq_start_pos + 1, seq_kv_size)
+            : seq_kv_size;
+        const int64_t split_start = split * split_size;
+        const int64_t split_end = std::min(split_start + split_size, num_keys);
+        const scalar_t* q_ptr =
+            q_data + i * qStrideB + j_kv * num_reps * qStrideH;
+        for (int64_t n = split_start; n < split_end; n += kvSplitSize) {
+          const int64_t kvBlockSize = std::min(kvSplitSize, split_end - n);
+          // Calculate q @ k.T for all the query heads of the group. These
+          // are matrix-vector products that stream the keys once, which is
+          // faster done directly than through gemm.
+          int64_t k_row_stride = 0;
+          const scalar_t* k_ptr =
+              key_split(i, n, j_kv, kvBlockSize, k_row_stride);
+          for (int64_t t = 0; t < kvBlockSize; ++t) {
+            for (int64_t row = 0; row < num_reps; ++row) {
+              qk_data[row * kvBlockSize + t] = vec::map2_reduce_all<accum_t>(
+                  [](Vec x, Vec y) { return x * y; },
+                  [](Vec x, Vec y) { return x + y; },
+                  q_ptr + row * qStrideH,
+                  k_ptr + t * k_row_stride,
+                  headSize);
+            }
+          }
+          for (int64_t row = 0; row < num_reps; ++row) {
+            accum_t* row_ptr = qk_data + row * kvBlockSize;
+            accum_t tmp_max = 0;
+            if (has_attn_mask) {
+              vec::map2<accum_t>(
+                  [scaling_factor](Vec x, Vec y) {
+                    return x * Vec(scaling_factor) + y;
+                  },
+                  row_ptr,
+                  row_ptr,
+                  mask_data + n,
+                  kvBlockSize);
+              tmp_max = vec::reduce_all<accum_t>(
+                  [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+                  row_ptr,
+                  kvBlockSize);
+            } else {
+              _mul_reduce_max_fusion_kernel(
+                  row_ptr, scaling_factor, kvBlockSize, row_ptr, tmp_max);
+            }
+            tmp_max = std::max(qk_max_data[row], tmp_max);
+            if (tmp_max == -std::numeric_limits<accum_t>::infinity()) {
+              // Everything so far is masked out, so it adds nothing.
+              fill_stub(row_ptr, static_cast<accum_t>(0), kvBlockSize);
+              continue;
+            }
+            // qk <- exp(qk - max) and sum per row
+            accum_t tmp_sum = tmp_max;
+            _exp_reduce_sum_fusion_kernel(
+                row_ptr, kvBlockSize, row_ptr, tmp_sum);
+            const accum_t exp_tmp = std::exp(qk_max_data[row] - tmp_max);
+            qk_sum_data[row] = tmp_sum + exp_tmp * qk_sum_data[row];
+            qk_max_data[row] = tmp_max;
+            vec::map<accum_t>(
+                [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
+                dst_data + row * headSize,
+                dst_data + row * headSize,
+                headSize);
+          }
+          // dst <- dst + Softmax(q @ k.T) @ v
+          int64_t v_row_stride = 0;
+          const scalar_t* v_ptr =
+              value_split(i, n, j_kv, kvBlockSize, v_row_stride);
+          for (int64_t t = 0; t < kvBlockSize; ++t) {
+            for (int64_t row = 0; row < num_reps; ++row) {
+              const accum_t weight = qk_data[row * kvBlockSize + t];
+              vec::map2<accum_t>(
+                  [weight](Vec x, Vec y) {
+                    return vec::fmadd(y, Vec(weight), x);
+                  },
+                  dst_data + row * headSize,
+                  dst_data + row * headSize,
+                  v_ptr + t * v_row_stride,
+                  headSize);
+            }
+          }
+        }
+      }
+    };
+    torch::executor::parallel_for(
+        0, num_groups * num_splits, 1, decode_lambda);
+
+    // Combine the splits of every query head into its output.
+    auto combine_lambda = [&](int64_t begin, int64_t end) {
+      for (int64_t head = begin; head < end; ++head) {
+        const int64_t i = head / num_head;
+        const int64_t j = head % num_head;
+        const int64_t row = j % num_reps;
+        const accum_t* partial = partial_data +
+            (i * num_heads_kv + j / num_reps) * num_splits * partial_size;
+        accum_t global_max = -std::numeric_limits<accum_t>::infinity();
+        for (int64_t split = 0; split < num_splits; ++split) {
+          global_max =
+              std::max(global_max, partial[split * partial_size + row]);
+        }
+        scalar_t* out_ptr = out_data + i * oStrideB + j * oStrideH;
+        accum_t sum = 0;
+        for (int64_t split = 0; split < num_splits; ++split) {
+          const accum_t* split_partial = partial + split * partial_size;
+          const accum_t split_max = split_partial[row];
+          const accum_t weight =
+              split_max == -std::numeric_limits<accum_t>::infinity()
+              ? static_cast<accum_t>(0)
+              : std::exp(split_max - global_max);
+          sum += weight * split_partial[num_reps + row];
+          const accum_t* split_dst =
+              split_partial + 2 * num_reps + row * headSize;
+          if (split == 0) {
+            vec::map<scalar_t>(
+                [weight](Vec x) { return x * Vec(weight); },
+                out_ptr,
+                split_dst,
+                headSize);
+          } else {
+            vec::map2<scalar_t>(
+                [weight](Vec x, Vec y) { return x + y * Vec(weight); },
+                out_ptr,
+                out_ptr,
+                split_dst,
+                headSize);
+          }
+        }
+        const accum_t sum_reciprocal = 1 / sum;
+        vec::map<scalar_t>(
+            [sum_reciprocal](Vec x) { return x * Vec(sum_reciprocal); },
+            out_ptr,
+            out_ptr,
+            headSize);
+      }
+    };
+    torch::executor::parallel_for(
+        0, batchSize * num_head, 1, combine_lambda);
+    return;
+  }
 
   auto compute_lambda = [&](int64_t begin, int64_t end) {
     int64_t i = 0, j = 0, k = 0;
@@ -450,14 +852,23 @@ void cpu_flash_attention(
       // but that requires storing attention mask in float as the current
       // code doesnt support bool attention mask.
       // However, lets just fix that as well.
-      int64_t num_keys =
-          is_causal ? std::min(m + start_pos + qBlockSize, kvSize) : kvSize;
-      int64_t m_start_pos = m + start_pos;
+      const int64_t seq_start_pos = paged_kv_cache != nullptr
+          ? paged_kv_cache->start_pos[i]
+          : start_pos;
+      const int64_t seq_kv_size =
+          paged_kv_cache != nullptr ? seq_start_pos + qSize : kvSize;
+      int64_t num_keys = is_causal
+          ? std::min(m + seq_start_pos + qBlockSize, seq_kv_size)
+          : seq_kv_size;
+      int64_t m_start_pos = m + seq_start_pos;
       auto j_kv = j / num_reps;
       for (int64_t n = 0; n < num_keys; n += kvSplitSize) {
-        int64_t kvBlockSize = std::min(kvSplitSize, kvSize - n);
+        int64_t kvBlockSize = std::min(kvSplitSize, seq_kv_size - n);
         // Calculate scale * q @ k.T
         fill_stub(qk_data, static_cast<accum_t>(0), qSplitSize * kvSplitSize);
+        int64_t k_row_stride = 0;
+        const scalar_t* k_ptr =
+            key_split(i, n, j_kv, kvBlockSize, k_row_stride);
         ::executorch::cpublas::gemm(
             ::executorch::cpublas::TransposeType::Transpose,
             ::executorch::cpublas::TransposeType::NoTranspose,
@@ -465,8 +876,8 @@ void cpu_flash_attention(
             qBlockSize,
             headSize,
             static_cast<accum_t>(1),
-            k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN,
-            kStrideN,
+            k_ptr,
+            k_row_stride,
             q_data + i * qStrideB + j * qStrideH + m * qStrideM,
             qStrideM,
             static_cast<accum_t>(0),
@@ -565,6 +976,15 @@ void cpu_flash_attention(
                 tmp_max);
           }
           tmp_max = qk_max_data[row] > tmp_max ? qk_max_data[row] : tmp_max;
+          if (tmp_max == -std::numeric_limits<accum_t>::infinity()) {
+            // Everything so far is masked out, so it adds nothing.
+            fill_stub(
+                conditional_data_ptr(qk_data, qk_reduced_data) +
+                    row * kvBlockSize,
+                static_cast<scalar_t>(0),
+                kvBlockSize);
+            continue;
+          }
           // qk <- exp(qk - max) and sum per row
           tmp_sum = tmp_max;
           _exp_reduce_sum_fusion_kernel(
@@ -589,6 +1009,9 @@ void cpu_flash_attention(
           }
         }
         // Calculate Softmax(q @ k.T) @ v
+        int64_t v_row_stride = 0;
+        const scalar_t* v_ptr =
+            value_split(i, n, j_kv, kvBlockSize, v_row_stride);
         ::executorch::cpublas::gemm(
             ::executorch::cpublas::TransposeType::NoTranspose,
             ::executorch::cpublas::TransposeType::NoTranspose,
@@ -596,8 +1019,8 @@ void cpu_flash_attention(
             qBlockSize,
             kvBlockSize,
             static_cast<accum_t>(1),
-            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
-            vStrideN,
+            v_ptr,
+            v_row_stride,
             conditional_data_ptr(qk_data, qk_reduced_data),
             kvBlockSize,
             n == 0 ? static_cast<accum_t>(0) : static_cast<accum_t>(1),
@@ -820,6 +1243,7 @@ Tensor& flash_attention_kernel_out(
         // we might consider another appraoch
         if (q_seq_len >= 768) {
           cpu_flash_attention<CTYPE, 256, 512>(
+              ctx,
               output,
               query,
               key,
@@ -830,6 +1254,7 @@ Tensor& flash_attention_kernel_out(
               scale);
         } else if (q_seq_len >= 192) {
           cpu_flash_attention<CTYPE, 64, 512>(
+              ctx,
               output,
               query,
               key,
@@ -840,6 +1265,7 @@ Tensor& flash_attention_kernel_out(
               scale);
         } else {
           cpu_flash_attention<CTYPE, 32, 512>(
+              ctx,
               output,
               query,
               key,
@@ -962,6 +1388,7 @@ Tensor& custom_sdpa_out(
     // we might consider another appraoch
     if (q_seq_len >= 768) {
       cpu_flash_attention<CTYPE, 256, 512>(
+          ctx,
           output,
           q,
           sliced_key_cache,
@@ -974,6 +1401,7 @@ Tensor& custom_sdpa_out(
           start_pos);
     } else if (q_seq_len >= 192) {
       cpu_flash_attention<CTYPE, 64, 512>(
+          ctx,
           output,
           q,
           sliced_key_cache,
@@ -986,6 +1414,7 @@ Tensor& custom_sdpa_out(
           start_pos);
     } else {
       cpu_flash_attention<CTYPE, 32, 512>(
+          ctx,
           output,
           q,
           sliced_key_cache,
@@ -1057,6 +1486,462 @@ Tensor& sdpa_with_kv_cache_out(
 
   return output;
 }
+
+/*
+  Input params
+  @param[in] q_projected Projected query with query weights.
+  Format [batch size, seq_len, num heads, head dim]
+  @param[in] k_projected Projected query with key weights.
+  Format [batch size, seq_len, num kv heads, head dim]
+  @param[in] v_projected Projected query with value weights.
+  Format [batch size, seq_len, num kv heads, head dim]
+  @param[in] key_cache Ring buffer cache of previous k_projected.
+  Format [batch size, num_sinks + window, num kv heads, head dim]
+  @param[in] value_cache Ring buffer cache of previous v_projected.
+  Format [batch size, num_sinks + window, num kv heads, head dim]
+  @param[in] start_pos: sequence position, which may be past the cache size.
+  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
+  @param[in] num_sinks: number of leading positions that are always kept.
+
+  Attention is always causal. The query at position p attends to the sinks
+  and to the positions in (p - window, p] that are still in the cache.
+*/
+Tensor& sdpa_with_ring_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sinks,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_flash_attention_args(
+          q_projected, key_cache, value_cache, optional<Tensor>()),
+      InvalidArgument,
+      output);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      key_cache.sizes() == value_cache.sizes(),
+      InvalidArgument,
+      output,
+      "key_cache and value_cache must have the same shape");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q_projected.size(1) == seq_len,
+      InvalidArgument,
+      output,
+      "query must have seq_len positions");
+
+  // Validates start_pos, num_sinks and seq_len against both caches too.
+  update_ring_cache_out(
+      ctx, k_projected, key_cache, start_pos, num_sinks, output);
+  update_ring_cache_out(
+      ctx, v_projected, value_cache, start_pos, num_sinks, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+
+  const int64_t cache_size = key_cache.size(1);
+  const int64_t end_pos = start_pos + seq_len;
+  if (end_pos <= cache_size) {
+    // Nothing has wrapped around yet, so every position is in its own slot.
+    return custom_sdpa_out(
+        ctx,
+        q_projected,
+        key_cache,
+        value_cache,
+        start_pos,
+        optional<Tensor>(),
+        dropout_p,
+        /*is_causal=*/true,
+        scale,
+        output);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  // Attention doesn't depend on the order of the keys, so attend to the
+  // whole cache in slot order, and mask every slot by the position it holds.
+  // Window slot s holds the latest position before end_pos that maps to it.
+  const int64_t window = cache_size - num_sinks;
+  std::vector<float> mask_data(seq_len * cache_size);
+  for (int64_t slot = 0; slot < cache_size; ++slot) {
+    int64_t pos = slot;
+    if (slot >= num_sinks) {
+      pos = end_pos - 1 - (end_pos - 1 - slot) % window;
+    }
+    for (int64_t m = 0; m < seq_len; ++m) {
+      const int64_t q_pos = start_pos + m;
+      const bool attend =
+          pos <= q_pos && (pos < num_sinks || pos > q_pos - window);
+      mask_data[m * cache_size + slot] =
+          attend ? 0.0f : -std::numeric_limits<float>::infinity();
+    }
+  }
+  std::array<::executorch::aten::SizesType, 2> mask_sizes{
+      static_cast<::executorch::aten::SizesType>(seq_len),
+      static_cast<::executorch::aten::SizesType>(cache_size)};
+  std::array<::executorch::aten::DimOrderType, 2> mask_dim_order{0, 1};
+  std::array<::executorch::aten::StridesType, 2> mask_strides{
+      static_cast<::executorch::aten::StridesType>(cache_size), 1};
+  TensorImpl mask_impl = TensorImpl(
+      ScalarType::Float,
+      2,
+      mask_sizes.data(),
+      mask_data.data(),
+      mask_dim_order.data(),
+      mask_strides.data(),
+      TensorShapeDynamism::STATIC);
+  const optional<Tensor> attn_mask{Tensor(&mask_impl)};
+
+  if (seq_len >= 768) {
+    cpu_flash_attention<float, 256, 512>(
+        ctx,
+        output,
+        q_projected,
+        key_cache,
+        value_cache,
+        dropout_p,
+        /*is_causal=*/false,
+        attn_mask,
+        scale,
+        true /* is_seq_at_dim_1 */);
+  } else if (seq_len >= 192) {
+    cpu_flash_attention<float, 64, 512>(
+        ctx,
+        output,
+        q_projected,
+        key_cache,
+        value_cache,
+        dropout_p,
+        /*is_causal=*/false,
+        attn_mask,
+        scale,
+        true /* is_seq_at_dim_1 */);
+  } else {
+    cpu_flash_attention<float, 32, 512>(
+        ctx,
+        output,
+        q_projected,
+        key_cache,
+        value_cache,
+        dropout_p,
+        /*is_causal=*/false,
+        attn_mask,
+        scale,
+        true /* is_seq_at_dim_1 */);
+  }
+  return output;
+}
+
+/*
+  Input params
+  @param[in] q_projected Projected query with query weights.
+  Format [batch size, seq_len, num heads, head dim]
+  @param[in] k_projected Projected query with key weights.
+  Format [batch size, seq_len, num kv heads, head dim]
+  @param[in] v_projected Projected query with value weights.
+  Format [batch size, seq_len, num kv heads, head dim]
+  @param[in] key_cache Quantized cache of previous k_projected. Char (int8)
+  [batch size, max_seq_len, num kv heads, head dim], or Byte (int4 packed two
+  per byte) [batch size, max_seq_len, num kv heads, head dim / 2].
+  @param[in] value_cache Quantized cache of previous v_projected, like
+  key_cache.
+  @param[in] key_scales Scale of every position and head of key_cache.
+  Format [batch size, max_seq_len, num kv heads, 1], Float
+  @param[in] value_scales Scale of every position and head of value_cache.
+  Format [batch size, max_seq_len, num kv heads, 1], Float
+  ....
+  @param[in] start_pos: sequence position
+  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
+*/
+Tensor& sdpa_with_quantized_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value() || !is_causal,
+      InvalidArgument,
+      output,
+      "attn_mask and is_causal cannot be set at the same time");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q_projected.dim() == 4 &&
+          q_projected.scalar_type() == ScalarType::Float &&
+          is_contiguous_dim_order(
+              q_projected.dim_order().data(), q_projected.dim()),
+      InvalidArgument,
+      output,
+      "query must be a contiguous 4D Float tensor");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      key_cache.scalar_type() == value_cache.scalar_type() &&
+          key_cache.sizes() == value_cache.sizes(),
+      InvalidArgument,
+      output,
+      "key_cache and value_cache must have the same dtype and shape");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      k_projected.dim() == 4 && k_projected.size(1) == seq_len &&
+          q_projected.size(1) == seq_len &&
+          q_projected.size(3) == k_projected.size(3),
+      InvalidArgument,
+      output,
+      "query and key must have seq_len positions of the same head dim");
+
+  // Validates the caches and scales too.
+  update_quantized_cache_out(
+      ctx, k_projected, key_cache, key_scales, start_pos, output);
+  update_quantized_cache_out(
+      ctx, v_projected, value_cache, value_scales, start_pos, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  // Views of positions [0, start_pos + seq_len) of the caches.
+  std::array<::executorch::aten::DimOrderType, util::kKVDim>
+      sliced_dim_order{0, 1, 2, 3};
+  std::array<::executorch::aten::SizesType, util::kKVDim> sliced_sizes{
+      static_cast<::executorch::aten::SizesType>(key_cache.size(0)),
+      static_cast<::executorch::aten::SizesType>(start_pos + seq_len),
+      static_cast<::executorch::aten::SizesType>(key_cache.size(2)),
+      static_cast<::executorch::aten::SizesType>(key_cache.size(3))};
+  std::array<::executorch::aten::StridesType, util::kKVDim> sliced_strides;
+  dim_order_to_stride_nocheck(
+      sliced_sizes.data(),
+      sliced_dim_order.data(),
+      util::kKVDim,
+      sliced_strides.data());
+  // since the cache is sliced, the batch stride needs to stay the same.
+  sliced_strides[0] = key_cache.strides()[0];
+  TensorImpl k_impl = TensorImpl(
+      key_cache.scalar_type(),
+      util::kKVDim,
+      sliced_sizes.data(),
+      key_cache.mutable_data_ptr(),
+      sliced_dim_order.data(),
+      sliced_strides.data(),
+      TensorShapeDynamism::STATIC);
+  Tensor sliced_key_cache(&k_impl);
+  TensorImpl value_impl = TensorImpl(
+      value_cache.scalar_type(),
+      util::kKVDim,
+      sliced_sizes.data(),
+      value_cache.mutable_data_ptr(),
+      sliced_dim_order.data(),
+      sliced_strides.data(),
+      TensorShapeDynamism::STATIC);
+  Tensor sliced_value_cache(&value_impl);
+
+  const QuantizedKVCache quantized_kv_cache{
+      key_scales.const_data_ptr<float>(),
+      value_scales.const_data_ptr<float>(),
+      key_scales.strides()[0],
+      key_scales.strides()[1],
+      key_cache.scalar_type() == ScalarType::Byte};
+
+  if (seq_len >= 768) {
+    cpu_flash_attention<float, 256, 512>(
+        ctx,
+        output,
+        q_projected,
+        sliced_key_cache,
+        sliced_value_cache,
+        dropout_p,
+        is_causal,
+        attn_mask,
+        scale,
+        true, /* is_seq_at_dim_1 */
+        start_pos,
+        nullptr,
+        &quantized_kv_cache);
+  } else if (seq_len >= 192) {
+    cpu_flash_attention<float, 64, 512>(
+        ctx,
+        output,
+        q_projected,
+        sliced_key_cache,
+        sliced_value_cache,
+        dropout_p,
+        is_causal,
+        attn_mask,
+        scale,
+        true, /* is_seq_at_dim_1 */
+        start_pos,
+        nullptr,
+        &quantized_kv_cache);
+  } else {
+    cpu_flash_attention<float, 32, 512>(
+        ctx,
+        output,
+        q_projected,
+        sliced_key_cache,
+        sliced_value_cache,
+        dropout_p,
+        is_causal,
+        attn_mask,
+        scale,
+        true, /* is_seq_at_dim_1 */
+        start_pos,
+        nullptr,
+        &quantized_kv_cache);
+  }
+  return output;
+}
+
+/*
+  Input params
+  @param[in] q_projected Projected query with query weights.
+  Format [batch size, seq_len, num heads, head dim]
+  @param[in] k_projected Projected query with key weights.
+  Format [batch size, seq_len, num heads, head dim]
+  @param[in] v_projected Projected query with value weights.
+  Format [batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Pool of key cache blocks.
+  Format [num blocks, block size, num heads, head dim]
+  @param[in] value_cache Pool of value cache blocks.
+  Format [num blocks, block size, num heads, head dim]
+  @param[in] block_table Blocks of each sequence, in position order.
+  Format [batch size, max blocks per sequence], Long
+  @param[in] start_pos Position of the first query token of each sequence.
+  Format [batch size], Long
+*/
+Tensor& sdpa_with_paged_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_flash_attention_args(
+          q_projected, key_cache, value_cache, optional<Tensor>()),
+      InvalidArgument,
+      output);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      key_cache.sizes() == value_cache.sizes(),
+      InvalidArgument,
+      output,
+      "key_cache and value_cache must have the same shape");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      k_projected.size(1) == q_projected.size(1) &&
+          v_projected.size(1) == q_projected.size(1),
+      InvalidArgument,
+      output,
+      "query, key and value must have the same seq_len");
+
+  // Validates block_table and start_pos against both caches too.
+  update_cache_paged_out(
+      ctx, k_projected, key_cache, block_table, start_pos, output);
+  update_cache_paged_out(
+      ctx, v_projected, value_cache, block_table, start_pos, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  const PagedKVCache paged_kv_cache{
+      block_table.const_data_ptr<int64_t>(),
+      block_table.size(1),
+      key_cache.size(1),
+      start_pos.const_data_ptr<int64_t>()};
+  const optional<Tensor> attn_mask;
+  auto q_seq_len = q_projected.size(1);
+
+  ET_SWITCH_FLOAT_TYPES(
+      q_projected.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
+        if (q_seq_len >= 768) {
+          cpu_flash_attention<CTYPE, 256, 512>(
+              ctx,
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              0,
+              &paged_kv_cache);
+        } else if (q_seq_len >= 192) {
+          cpu_flash_attention<CTYPE, 64, 512>(
+              ctx,
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              0,
+              &paged_kv_cache);
+        } else {
+          cpu_flash_attention<CTYPE, 32, 512>(
+              ctx,
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              0,
+              &paged_kv_cache);
+        }
+      });
+  return output;
+}
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -1070,3 +1955,18 @@ EXECUTORCH_LIBRARY(
     llama,
     "custom_sdpa.out",
     torch::executor::native::custom_sdpa_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_paged_kv_cache.out",
+    torch::executor::native::sdpa_with_paged_kv_cache_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_quantized_kv_cache.out",
+    torch::executor::native::sdpa_with_quantized_kv_cache_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_ring_kv_cache.out",
+    torch::executor::native::sdpa_with_ring_kv_cache_out);
@@ -10,6 +10,7 @@
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
 #include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
 
 #include <torch/library.h>
 
@@ -33,7 +34,8 @@ Tensor& sdpa_with_kv_cache_out_no_context(
     // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
     const optional<double> scale,
     Tensor& output) {
-  executorch::runtime::KernelRuntimeContext context{};
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::native::sdpa_with_kv_cache_out(
       context,
       q_projected,
@@ -95,7 +97,8 @@ Tensor& custom_sdpa_out_no_context(
     // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
     const optional<double> scale,
     Tensor& output) {
-  executorch::aten::RuntimeContext context{};
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::aten::RuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::native::custom_sdpa_out(
       context,
       q,
@@ -147,6 +150,262 @@ at::Tensor update_cache_aten(
   return output;
 }
 
+Tensor& sdpa_with_paged_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
+  return torch::executor::native::sdpa_with_paged_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      block_table,
+      start_pos,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_paged_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    const at::Tensor& block_table,
+    const at::Tensor& start_pos,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_paged_kv_cache_out_no_context, 11)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   block_table,
+   start_pos,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& update_cache_paged_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    Tensor& output) {
+  executorch::aten::RuntimeContext context{};
+  return torch::executor::native::update_cache_paged_out(
+      context, value, cache, block_table, start_pos, output);
+}
+
+at::Tensor update_cache_paged_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    const at::Tensor& block_table,
+    const at::Tensor& start_pos) {
+  auto output = at::empty({1});
+  WRAP_TO_ATEN(update_cache_paged_out_no_context, 4)
+  (value, cache, block_table, start_pos, output);
+  return output;
+}
+
+Tensor& update_ring_cache_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    const int64_t start_pos,
+    const int64_t num_sinks,
+    Tensor& output) {
+  executorch::aten::RuntimeContext context{};
+  return torch::executor::native::update_ring_cache_out(
+      context, value, cache, start_pos, num_sinks, output);
+}
+
+at::Tensor update_ring_cache_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    const int64_t start_pos,
+    const int64_t num_sinks) {
+  auto output = at::empty({1});
+  WRAP_TO_ATEN(update_ring_cache_out_no_context, 4)
+  (value, cache, start_pos, num_sinks, output);
+  return output;
+}
+
+Tensor& sdpa_with_ring_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sinks,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
+  return torch::executor::native::sdpa_with_ring_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      start_pos,
+      seq_len,
+      num_sinks,
+      dropout_p,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_ring_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sinks,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_ring_kv_cache_out_no_context, 10)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   start_pos,
+   seq_len,
+   num_sinks,
+   dropout_p,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& update_quantized_cache_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    const int64_t start_pos,
+    Tensor& output) {
+  executorch::aten::RuntimeContext context{};
+  return torch::executor::native::update_quantized_cache_out(
+      context, value, cache, scales, start_pos, output);
+}
+
+at::Tensor update_quantized_cache_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    at::Tensor& scales,
+    const int64_t start_pos) {
+  auto output = at::empty({1});
+  WRAP_TO_ATEN(update_quantized_cache_out_no_context, 4)
+  (value, cache, scales, start_pos, output);
+  return output;
+}
+
+Tensor& sdpa_with_quantized_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  executorch::extension::MallocMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
+  return torch::executor::native::sdpa_with_quantized_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      key_scales,
+      value_scales,
+      start_pos,
+      seq_len,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_quantized_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& key_scales,
+    at::Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_quantized_kv_cache_out_no_context, 13)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   key_scales,
+   value_scales,
+   start_pos,
+   seq_len,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -174,6 +433,57 @@ TORCH_LIBRARY_FRAGMENT(llama, m) {
   m.def(
       "update_cache.out(Tensor value, Tensor(a!) cache, "
       "SymInt start_pos, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "sdpa_with_paged_kv_cache(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor block_table, "
+      "Tensor start_pos, float drpout_p=0.0, bool is_causal=False, "
+      "float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_paged_kv_cache.out(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor block_table, "
+      "Tensor start_pos, float drpout_p=0.0, bool is_causal=False, "
+      "float? scale=None, *, Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "update_cache_paged(Tensor value, Tensor(a!) cache, "
+      "Tensor block_table, Tensor start_pos) -> Tensor");
+  m.def(
+      "update_cache_paged.out(Tensor value, Tensor(a!) cache, "
+      "Tensor block_table, Tensor start_pos, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "update_ring_cache(Tensor value, Tensor(a!) cache, "
+      "SymInt start_pos, SymInt num_sinks) -> Tensor");
+  m.def(
+      "update_ring_cache.out(Tensor value, Tensor(a!) cache, "
+      "SymInt start_pos, SymInt num_sinks, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "sdpa_with_ring_kv_cache(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, SymInt start_pos, "
+      "SymInt seq_len, SymInt num_sinks, float drpout_p=0.0, "
+      "float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_ring_kv_cache.out(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, SymInt start_pos, "
+      "SymInt seq_len, SymInt num_sinks, float drpout_p=0.0, "
+      "float? scale=None, *, Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "update_quantized_cache(Tensor value, Tensor(a!) cache, "
+      "Tensor(b!) scales, SymInt start_pos) -> Tensor");
+  m.def(
+      "update_quantized_cache.out(Tensor value, Tensor(a!) cache, "
+      "Tensor(b!) scales, SymInt start_pos, *, Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "sdpa_with_quantized_kv_cache(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor(c!) key_scales, "
+      "Tensor(d!) value_scales, SymInt start_pos, SymInt seq_len, "
+      "Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, "
+      "float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_quantized_kv_cache.out(Tensor query, Tensor key, "
+      "Tensor value, Tensor(a!) key_cache, Tensor(b!) value_cache, "
+      "Tensor(c!) key_scales, Tensor(d!) value_scales, SymInt start_pos, "
+      "SymInt seq_len, Tensor? attn_mask=None, float drpout_p=0.0, "
+      "bool is_causal=False, float? scale=None, *, Tensor(e!) out) -> "
+      "Tensor(e!)");
 }
 
 // TODO: Rename this file to op_custom_ops_aot.cpp
@@ -192,4 +502,45 @@ TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
   m.impl(
       "update_cache.out",
       WRAP_TO_ATEN(torch::executor::native::update_cache_out_no_context, 3));
+  m.impl(
+      "sdpa_with_paged_kv_cache",
+      torch::executor::native::sdpa_with_paged_kv_cache_aten);
+  m.impl(
+      "sdpa_with_paged_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_paged_kv_cache_out_no_context,
+          11));
+  m.impl(
+      "update_cache_paged", torch::executor::native::update_cache_paged_aten);
+  m.impl(
+      "update_cache_paged.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::update_cache_paged_out_no_context, 4));
+  m.impl("update_ring_cache", torch::executor::native::update_ring_cache_aten);
+  m.impl(
+      "update_ring_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::update_ring_cache_out_no_context, 4));
+  m.impl(
+      "sdpa_with_ring_kv_cache",
+      torch::executor::native::sdpa_with_ring_kv_cache_aten);
+  m.impl(
+      "sdpa_with_ring_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_ring_kv_cache_out_no_context, 10));
+  m.impl(
+      "update_quantized_cache",
+      torch::executor::native::update_quantized_cache_aten);
+  m.impl(
+      "update_quantized_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::update_quantized_cache_out_no_context, 4));
+  m.impl(
+      "sdpa_with_quantized_kv_cache",
+      torch::executor::native::sdpa_with_quantized_kv_cache_aten);
+  m.impl(
+      "sdpa_with_quantized_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_quantized_kv_cache_out_no_context,
+          13));
 }
@@ -28,7 +28,8 @@ executorch::aten::Tensor op_scaled_dot_product_attention(
     bool is_causal,
     executorch::aten::optional<double> scale,
     executorch::aten::Tensor& out) {
-  executorch::runtime::KernelRuntimeContext context{};
+  TempMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::native::flash_attention_kernel_out(
       context, query, key, value, attn_mask, dropout_p, is_causal, scale, out);
 }
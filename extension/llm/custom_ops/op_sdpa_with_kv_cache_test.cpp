@@ -6,9 +6,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cmath>
 #include <limits>
+#include <vector>
 
 #include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/extension/llm/custom_ops/test_util.h>
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
@@ -16,6 +19,7 @@
 #include <gtest/gtest.h>
 
 using namespace ::testing;
+using executorch::extension::llm::testing::make_data;
 using executorch::runtime::testing::TensorFactory;
 
 executorch::aten::Tensor op_sdpa_with_kv_cache(
@@ -31,7 +35,8 @@ executorch::aten::Tensor op_sdpa_with_kv_cache(
     bool is_causal,
     executorch::aten::optional<double> scale,
     executorch::aten::Tensor& out) {
-  executorch::runtime::KernelRuntimeContext context{};
+  TempMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::native::sdpa_with_kv_cache_out(
       context,
       query,
@@ -985,3 +990,102 @@ TEST(OpScaledDotProductAttentionTest, SequenceTest) {
       out);
   EXPECT_TENSOR_CLOSE_WITH_TOL(ret, ret_expected_3, 1e-4, 1e-4);
 }
+
+// Decoding one token over a long cache, with more query heads than kv heads,
+// splits the keys across threads. Check it against a plain softmax.
+TEST(OpScaledDotProductAttentionTest, DecodeWithGQAMatchesReference) {
+  TensorFactory<executorch::aten::ScalarType::Float> tfFloat;
+
+  constexpr int64_t kBatch = 2;
+  constexpr int64_t kQHeads = 8;
+  constexpr int64_t kKVHeads = 2;
+  constexpr int64_t kDim = 16;
+  constexpr int64_t kMaxSeqLen = 2048;
+  constexpr int64_t kStartPos = 1800;
+  // With the mask, only the last kWindow positions are attended to.
+  constexpr int64_t kWindow = 300;
+
+  for (const bool use_mask : {false, true}) {
+    const auto q_data = make_data(kBatch * kQHeads * kDim, 1);
+    const auto k_data = make_data(kBatch * kKVHeads * kDim, 2);
+    const auto v_data = make_data(kBatch * kKVHeads * kDim, 3);
+    executorch::aten::Tensor query =
+        tfFloat.make({kBatch, 1, kQHeads, kDim}, q_data);
+    executorch::aten::Tensor key =
+        tfFloat.make({kBatch, 1, kKVHeads, kDim}, k_data);
+    executorch::aten::Tensor value =
+        tfFloat.make({kBatch, 1, kKVHeads, kDim}, v_data);
+    executorch::aten::Tensor key_cache = tfFloat.make(
+        {kBatch, kMaxSeqLen, kKVHeads, kDim},
+        make_data(kBatch * kMaxSeqLen * kKVHeads * kDim, 4));
+    executorch::aten::Tensor value_cache = tfFloat.make(
+        {kBatch, kMaxSeqLen, kKVHeads, kDim},
+        make_data(kBatch * kMaxSeqLen * kKVHeads * kDim, 5));
+
+    constexpr int64_t kNumKeys = kStartPos + 1;
+    std::vector<float> mask_data(kNumKeys, 0.0f);
+    for (int64_t n = 0; n < kNumKeys - kWindow; ++n) {
+      mask_data[n] = -std::numeric_limits<float>::infinity();
+    }
+    executorch::aten::optional<executorch::aten::Tensor> attn_mask;
+    if (use_mask) {
+      attn_mask = tfFloat.make({1, kNumKeys}, mask_data);
+    }
+
+    executorch::aten::Tensor out = tfFloat.zeros({kBatch, 1, kQHeads, kDim});
+    op_sdpa_with_kv_cache(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        kStartPos,
+        1,
+        attn_mask,
+        0,
+        /*is_causal=*/!use_mask,
+        {},
+        out);
+
+    // The caches now hold the new key and value at kStartPos.
+    const float* k = key_cache.const_data_ptr<float>();
+    const float* v = value_cache.const_data_ptr<float>();
+    std::vector<float> expected_data(kBatch * kQHeads * kDim, 0.0f);
+    const float scale = 1.0f / std::sqrt(static_cast<float>(kDim));
+    for (int64_t b = 0; b < kBatch; ++b) {
+      for (int64_t h = 0; h < kQHeads; ++h) {
+        const int64_t h_kv = h / (kQHeads / kKVHeads);
+        const float* q = q_data.data() + (b * kQHeads + h) * kDim;
+        std::vector<float> scores(kNumKeys);
+        float max_score = -std::numeric_limits<float>::infinity();
+        for (int64_t n = 0; n < kNumKeys; ++n) {
+          const float* k_n =
+              k + ((b * kMaxSeqLen + n) * kKVHeads + h_kv) * kDim;
+          float dot = 0;
+          for (int64_t d = 0; d < kDim; ++d) {
+            dot += q[d] * k_n[d];
+          }
+          scores[n] = dot * scale + (use_mask ? mask_data[n] : 0.0f);
+          max_score = std::max(max_score, scores[n]);
+        }
+        float sum = 0;
+        float* o = expected_data.data() + (b * kQHeads + h) * kDim;
+        for (int64_t n = 0; n < kNumKeys; ++n) {
+          const float weight = std::exp(scores[n] - max_score);
+          sum += weight;
+          const float* v_n =
+              v + ((b * kMaxSeqLen + n) * kKVHeads + h_kv) * kDim;
+          for (int64_t d = 0; d < kDim; ++d) {
+            o[d] += weight * v_n[d];
+          }
+        }
+        for (int64_t d = 0; d < kDim; ++d) {
+          o[d] /= sum;
+        }
+      }
+    }
+    executorch::aten::Tensor expected =
+        tfFloat.make({kBatch, 1, kQHeads, kDim}, expected_data);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+  }
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+
+TEST(OpUpdateCachePagedTest, WritesThroughBlockTable) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfLong;
+
+  // [batch 2, seq_len 3, heads 1, dim 2]
+  Tensor value =
+      tf.make({2, 3, 1, 2}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+  // 4 blocks of 2 positions
+  Tensor cache = tf.zeros({4, 2, 1, 2});
+  Tensor block_table = tfLong.make({2, 2}, {2, 0, 1, 3});
+  Tensor start_pos = tfLong.make({2}, {0, 1});
+  Tensor out = tf.zeros({1});
+
+  KernelRuntimeContext context{};
+  torch::executor::native::update_cache_paged_out(
+      context, value, cache, block_table, start_pos, out);
+  EXPECT_EQ(context.failure_state(), Error::Ok);
+
+  // Sequence 0 fills positions 0, 1 (block 2) and 2 (block 0, row 0).
+  // Sequence 1 fills position 1 (block 1, row 1) and 2, 3 (block 3).
+  Tensor expected = tf.make(
+      {4, 2, 1, 2}, {5, 6, 0, 0, 0, 0, 7, 8, 1, 2, 3, 4, 9, 10, 11, 12});
+  EXPECT_TENSOR_EQ(cache, expected);
+}
+
+TEST(OpUpdateCachePagedTest, RejectsOutOfRangeBlock) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfLong;
+
+  Tensor value = tf.ones({1, 1, 1, 2});
+  Tensor cache = tf.zeros({2, 2, 1, 2});
+  Tensor block_table = tfLong.make({1, 2}, {0, 2});
+  Tensor start_pos = tfLong.make({1}, {2});
+  Tensor out = tf.zeros({1});
+
+  KernelRuntimeContext context{};
+  torch::executor::native::update_cache_paged_out(
+      context, value, cache, block_table, start_pos, out);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+  EXPECT_TENSOR_EQ(cache, tf.zeros({2, 2, 1, 2}));
+}
+
+// Each sequence of a paged batch must get the same output as
+// sdpa_with_kv_cache on its own contiguous cache.
+TEST(OpSdpaWithPagedKVCacheTest, MatchesContiguousCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfLong;
+
+  constexpr int64_t kBatch = 2;
+  constexpr int64_t kSeqLen = 3;
+  constexpr int64_t kQHeads = 4;
+  constexpr int64_t kKVHeads = 2;
+  constexpr int64_t kDim = 8;
+  constexpr int64_t kBlockSize = 2;
+  constexpr int64_t kMaxBlocks = 5;
+  constexpr int64_t kNumBlocks = 11;
+  constexpr int64_t kMaxSeqLen = kMaxBlocks * kBlockSize;
+  constexpr int64_t kRow = kKVHeads * kDim;
+  const std::vector<int64_t> start_pos_data = {6, 1};
+  // Blocks handed out out of order, as an allocator would after churn.
+  const std::vector<int64_t> block_table_data = {
+      7, 3, 9, 0, 10, 4, 8, 1, 10, 10};
+
+  for (const bool is_causal : {true, false}) {
+    const auto q_data = make_data(kBatch * kSeqLen * kQHeads * kDim, 1);
+    const auto k_data = make_data(kBatch * kSeqLen * kRow, 2);
+    const auto v_data = make_data(kBatch * kSeqLen * kRow, 3);
+    const auto k_history = make_data(kBatch * kMaxSeqLen * kRow, 4);
+    const auto v_history = make_data(kBatch * kMaxSeqLen * kRow, 5);
+
+    // Fill positions [0, start_pos) of every sequence with history.
+    Tensor key_pool = tf.zeros({kNumBlocks, kBlockSize, kKVHeads, kDim});
+    Tensor value_pool = tf.zeros({kNumBlocks, kBlockSize, kKVHeads, kDim});
+    for (int64_t b = 0; b < kBatch; ++b) {
+      for (int64_t pos = 0; pos < start_pos_data[b]; ++pos) {
+        const int64_t block =
+            block_table_data[b * kMaxBlocks + pos / kBlockSize];
+        const int64_t dst = (block * kBlockSize + pos % kBlockSize) * kRow;
+        const int64_t src = (b * kMaxSeqLen + pos) * kRow;
+        std::memcpy(
+            key_pool.mutable_data_ptr<float>() + dst,
+            k_history.data() + src,
+            kRow * sizeof(float));
+        std::memcpy(
+            value_pool.mutable_data_ptr<float>() + dst,
+            v_history.data() + src,
+            kRow * sizeof(float));
+      }
+    }
+
+    Tensor q = tf.make({kBatch, kSeqLen, kQHeads, kDim}, q_data);
+    Tensor k = tf.make({kBatch, kSeqLen, kKVHeads, kDim}, k_data);
+    Tensor v = tf.make({kBatch, kSeqLen, kKVHeads, kDim}, v_data);
+    Tensor block_table = tfLong.make({kBatch, kMaxBlocks}, block_table_data);
+    Tensor start_pos = tfLong.make({kBatch}, start_pos_data);
+    Tensor out = tf.zeros({kBatch, kSeqLen, kQHeads, kDim});
+
+    TempMemoryAllocator temp_allocator;
+    KernelRuntimeContext context(nullptr, &temp_allocator);
+    torch::executor::native::sdpa_with_paged_kv_cache_out(
+        context,
+        q,
+        k,
+        v,
+        key_pool,
+        value_pool,
+        block_table,
+        start_pos,
+        /*dropout_p=*/0.0,
+        is_causal,
+        /*scale=*/{},
+        out);
+    ASSERT_EQ(context.failure_state(), Error::Ok);
+
+    for (int64_t b = 0; b < kBatch; ++b) {
+      const auto slice = [&](const std::vector<float>& data,
+                             int64_t offset,
+                             int64_t size) {
+        return std::vector<float>(
+            data.begin() + offset, data.begin() + offset + size);
+      };
+      const int64_t q_size = kSeqLen * kQHeads * kDim;
+      const int64_t kv_size = kSeqLen * kRow;
+      Tensor q_b = tf.make(
+          {1, kSeqLen, kQHeads, kDim}, slice(q_data, b * q_size, q_size));
+      Tensor k_b = tf.make(
+          {1, kSeqLen, kKVHeads, kDim}, slice(k_data, b * kv_size, kv_size));
+      Tensor v_b = tf.make(
+          {1, kSeqLen, kKVHeads, kDim}, slice(v_data, b * kv_size, kv_size));
+      Tensor key_cache = tf.make(
+          {1, kMaxSeqLen, kKVHeads, kDim},
+          slice(k_history, b * kMaxSeqLen * kRow, kMaxSeqLen * kRow));
+      Tensor value_cache = tf.make(
+          {1, kMaxSeqLen, kKVHeads, kDim},
+          slice(v_history, b * kMaxSeqLen * kRow, kMaxSeqLen * kRow));
+      Tensor expected = tf.zeros({1, kSeqLen, kQHeads, kDim});
+      TempMemoryAllocator ref_temp_allocator;
+      KernelRuntimeContext ref_context(nullptr, &ref_temp_allocator);
+      torch::executor::native::sdpa_with_kv_cache_out(
+          ref_context,
+          q_b,
+          k_b,
+          v_b,
+          key_cache,
+          value_cache,
+          start_pos_data[b],
+          kSeqLen,
+          /*attn_mask=*/{},
+          /*dropout_p=*/0.0,
+          is_causal,
+          /*scale=*/{},
+          expected);
+      ASSERT_EQ(ref_context.failure_state(), Error::Ok);
+
+      Tensor actual = tf.make(
+          {1, kSeqLen, kQHeads, kDim},
+          slice(
+              std::vector<float>(
+                  out.const_data_ptr<float>(),
+                  out.const_data_ptr<float>() + out.numel()),
+              b * q_size,
+              q_size));
+      EXPECT_TENSOR_CLOSE_WITH_TOL(actual, expected, 1e-5, 1e-5);
+    }
+  }
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+// Dequantizes a [batch, max seq len, heads, packed dim] cache into a float
+// [batch, max seq len, heads, head_dim] one.
+std::vector<float> dequantize(
+    const Tensor& cache,
+    const Tensor& scales,
+    int64_t head_dim) {
+  const bool is_int4 = cache.scalar_type() == ScalarType::Byte;
+  const int64_t rows = cache.size(0) * cache.size(1) * cache.size(2);
+  const uint8_t* data = static_cast<const uint8_t*>(cache.const_data_ptr());
+  const float* scales_data = scales.const_data_ptr<float>();
+  std::vector<float> out(rows * head_dim);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t d = 0; d < head_dim; ++d) {
+      const int32_t q = is_int4
+          ? ((data[r * cache.size(3) + d / 2] >> (4 * (d % 2))) & 0xF) - 8
+          : static_cast<int8_t>(data[r * head_dim + d]);
+      out[r * head_dim + d] = q * scales_data[r];
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OpUpdateQuantizedCacheTest, QuantizesInt8) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tfChar;
+
+  // [batch 1, seq_len 1, heads 2, dim 4]
+  Tensor value = tf.make({1, 1, 2, 4}, {127, -64, 1, 0, 0.5, -1, 0, 0.25});
+  Tensor cache = tfChar.zeros({1, 3, 2, 4});
+  Tensor scales = tf.zeros({1, 3, 2, 1});
+  Tensor out = tf.zeros({1});
+
+  KernelRuntimeContext context{};
+  torch::executor::native::update_quantized_cache_out(
+      context, value, cache, scales, /*start_pos=*/1, out);
+  EXPECT_EQ(context.failure_state(), Error::Ok);
+
+  EXPECT_TENSOR_EQ(
+      cache,
+      tfChar.make(
+          {1, 3, 2, 4},
+          {0, 0, 0, 0, 0, 0, 0, 0, 127, -64, 1, 0, 64, -127, 0, 32,
+           0, 0, 0, 0, 0, 0, 0, 0}));
+  EXPECT_TENSOR_CLOSE(
+      scales, tf.make({1, 3, 2, 1}, {0, 0, 1, 1.0f / 127, 0, 0}));
+}
+
+TEST(OpUpdateQuantizedCacheTest, PacksInt4) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tfByte;
+
+  Tensor value = tf.make({1, 1, 1, 4}, {7, -3, 1, 0});
+  Tensor cache = tfByte.zeros({1, 2, 1, 2});
+  Tensor scales = tf.zeros({1, 2, 1, 1});
+  Tensor out = tf.zeros({1});
+
+  KernelRuntimeContext context{};
+  torch::executor::native::update_quantized_cache_out(
+      context, value, cache, scales, /*start_pos=*/0, out);
+  EXPECT_EQ(context.failure_state(), Error::Ok);
+
+  // 7 + 8 | (-3 + 8) << 4, 1 + 8 | (0 + 8) << 4
+  EXPECT_TENSOR_EQ(cache, tfByte.make({1, 2, 1, 2}, {0x5F, 0x89, 0, 0}));
+  EXPECT_TENSOR_CLOSE(scales, tf.make({1, 2, 1, 1}, {1, 0}));
+}
+
+TEST(OpUpdateQuantizedCacheTest, RejectsMismatchedHeadDim) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tfByte;
+
+  Tensor value = tf.ones({1, 1, 1, 4});
+  // An int4 cache of head dim 4 is [..., 2].
+  Tensor cache = tfByte.zeros({1, 2, 1, 4});
+  Tensor scales = tf.zeros({1, 2, 1, 1});
+  Tensor out = tf.zeros({1});
+
+  KernelRuntimeContext context{};
+  torch::executor::native::update_quantized_cache_out(
+      context, value, cache, scales, /*start_pos=*/0, out);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+}
+
+// Prefills a prompt and then decodes a few tokens with GQA. Every step must
+// match custom_sdpa on the dequantized caches, and stay close to
+// sdpa_with_kv_cache on float caches.
+TEST(OpSdpaWithQuantizedKVCacheTest, MatchesDequantizedCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tfChar;
+  TensorFactory<ScalarType::Byte> tfByte;
+
+  constexpr int64_t kBatch = 2;
+  constexpr int64_t kQHeads = 4;
+  constexpr int64_t kKVHeads = 2;
+  constexpr int64_t kDim = 16;
+  constexpr int64_t kMaxSeqLen = 24;
+  constexpr int64_t kPromptLen = 9;
+  constexpr int64_t kNumDecodeSteps = 3;
+
+  for (const bool is_int4 : {false, true}) {
+    const int32_t packed_dim = static_cast<int32_t>(is_int4 ? kDim / 2 : kDim);
+    Tensor key_cache = is_int4
+        ? tfByte.zeros({kBatch, kMaxSeqLen, kKVHeads, packed_dim})
+        : tfChar.zeros({kBatch, kMaxSeqLen, kKVHeads, packed_dim});
+    Tensor value_cache = is_int4
+        ? tfByte.zeros({kBatch, kMaxSeqLen, kKVHeads, packed_dim})
+        : tfChar.zeros({kBatch, kMaxSeqLen, kKVHeads, packed_dim});
+    Tensor key_scales = tf.zeros({kBatch, kMaxSeqLen, kKVHeads, 1});
+    Tensor value_scales = tf.zeros({kBatch, kMaxSeqLen, kKVHeads, 1});
+    Tensor float_key_cache = tf.zeros({kBatch, kMaxSeqLen, kKVHeads, kDim});
+    Tensor float_value_cache = tf.zeros({kBatch, kMaxSeqLen, kKVHeads, kDim});
+
+    int64_t start_pos = 0;
+    for (int64_t step = 0; step <= kNumDecodeSteps; ++step) {
+      const int32_t seq_len = static_cast<int32_t>(step == 0 ? kPromptLen : 1);
+      Tensor q = tf.make(
+          {kBatch, seq_len, kQHeads, kDim},
+          make_data(kBatch * seq_len * kQHeads * kDim, 10 * step + 1));
+      Tensor k = tf.make(
+          {kBatch, seq_len, kKVHeads, kDim},
+          make_data(kBatch * seq_len * kKVHeads * kDim, 10 * step + 2));
+      Tensor v = tf.make(
+          {kBatch, seq_len, kKVHeads, kDim},
+          make_data(kBatch * seq_len * kKVHeads * kDim, 10 * step + 3));
+      Tensor out = tf.zeros({kBatch, seq_len, kQHeads, kDim});
+
+      TempMemoryAllocator temp_allocator;
+      KernelRuntimeContext context(nullptr, &temp_allocator);
+      torch::executor::native::sdpa_with_quantized_kv_cache_out(
+          context,
+          q,
+          k,
+          v,
+          key_cache,
+          value_cache,
+          key_scales,
+          value_scales,
+          start_pos,
+          seq_len,
+          /*attn_mask=*/{},
+          /*dropout_p=*/0.0,
+          /*is_causal=*/true,
+          /*scale=*/{},
+          out);
+      ASSERT_EQ(context.failure_state(), Error::Ok);
+
+      Tensor dequantized_key_cache = tf.make(
+          {kBatch, kMaxSeqLen, kKVHeads, kDim},
+          dequantize(key_cache, key_scales, kDim));
+      Tensor dequantized_value_cache = tf.make(
+          {kBatch, kMaxSeqLen, kKVHeads, kDim},
+          dequantize(value_cache, value_scales, kDim));
+      Tensor expected = tf.zeros({kBatch, seq_len, kQHeads, kDim});
+      TempMemoryAllocator ref_temp_allocator;
+      KernelRuntimeContext ref_context(nullptr, &ref_temp_allocator);
+      torch::executor::native::custom_sdpa_out(
+          ref_context,
+          q,
+          dequantized_key_cache,
+          dequantized_value_cache,
+          start_pos,
+          /*attn_mask=*/{},
+          /*dropout_p=*/0.0,
+          /*is_causal=*/true,
+          /*scale=*/{},
+          expected);
+      ASSERT_EQ(ref_context.failure_state(), Error::Ok);
+      EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+
+      Tensor float_expected = tf.zeros({kBatch, seq_len, kQHeads, kDim});
+      torch::executor::native::sdpa_with_kv_cache_out(
+          ref_context,
+          q,
+          k,
+          v,
+          float_key_cache,
+          float_value_cache,
+          start_pos,
+          seq_len,
+          /*attn_mask=*/{},
+          /*dropout_p=*/0.0,
+          /*is_causal=*/true,
+          /*scale=*/{},
+          float_expected);
+      ASSERT_EQ(ref_context.failure_state(), Error::Ok);
+      const double tol = is_int4 ? 1e-1 : 1e-2;
+      EXPECT_TENSOR_CLOSE_WITH_TOL(out, float_expected, 0, tol);
+
+      start_pos += seq_len;
+    }
+  }
+}
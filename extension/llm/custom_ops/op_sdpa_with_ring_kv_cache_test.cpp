@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+
+TEST(OpUpdateRingCacheTest, WrapsAroundAfterSinks) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // 1 sink and a window of 3, [batch 1, 4 slots, heads 1, dim 1]
+  Tensor cache = tf.zeros({1, 4, 1, 1});
+  Tensor out = tf.zeros({1});
+  KernelRuntimeContext context{};
+  torch::executor::native::update_ring_cache_out(
+      context,
+      tf.make({1, 3, 1, 1}, {10, 11, 12}),
+      cache,
+      /*start_pos=*/0,
+      /*num_sinks=*/1,
+      out);
+  EXPECT_TENSOR_EQ(cache, tf.make({1, 4, 1, 1}, {10, 11, 12, 0}));
+
+  // Positions 3, 4 and 5 take slots 3, 1 and 2.
+  torch::executor::native::update_ring_cache_out(
+      context,
+      tf.make({1, 3, 1, 1}, {13, 14, 15}),
+      cache,
+      /*start_pos=*/3,
+      /*num_sinks=*/1,
+      out);
+  EXPECT_EQ(context.failure_state(), Error::Ok);
+  EXPECT_TENSOR_EQ(cache, tf.make({1, 4, 1, 1}, {10, 14, 15, 13}));
+}
+
+TEST(OpUpdateRingCacheTest, RejectsChunkLongerThanWindow) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor cache = tf.zeros({1, 4, 1, 1});
+  Tensor out = tf.zeros({1});
+  KernelRuntimeContext context{};
+  torch::executor::native::update_ring_cache_out(
+      context,
+      tf.zeros({1, 3, 1, 1}),
+      cache,
+      /*start_pos=*/0,
+      /*num_sinks=*/2,
+      out);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+}
+
+// Streams a prompt and then decodes well past the cache size. Every query
+// must attend to exactly the sinks and the window before it that is still in
+// the cache.
+TEST(OpSdpaWithRingKVCacheTest, MatchesSlidingWindowReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  constexpr int64_t kBatch = 2;
+  constexpr int64_t kQHeads = 4;
+  constexpr int64_t kKVHeads = 2;
+  constexpr int64_t kDim = 8;
+  constexpr int64_t kNumSinks = 2;
+  constexpr int64_t kWindow = 6;
+  constexpr int64_t kCacheSize = kNumSinks + kWindow;
+  constexpr int64_t kNumPositions = 30;
+  constexpr int64_t kRow = kKVHeads * kDim;
+  // A prompt in chunks, the last one wrapping around, then decode steps.
+  const std::vector<int64_t> chunks = {5, 4, 4};
+
+  // [batch, position, kv heads, dim] of every position ever written.
+  const auto k_history = make_data(kBatch * kNumPositions * kRow, 1);
+  const auto v_history = make_data(kBatch * kNumPositions * kRow, 2);
+  Tensor key_cache = tf.zeros({kBatch, kCacheSize, kKVHeads, kDim});
+  Tensor value_cache = tf.zeros({kBatch, kCacheSize, kKVHeads, kDim});
+
+  int64_t start_pos = 0;
+  for (size_t step = 0; start_pos < kNumPositions; ++step) {
+    const int64_t seq_len = step < chunks.size() ? chunks[step] : 1;
+    const auto q_data =
+        make_data(kBatch * seq_len * kQHeads * kDim, 10 + step);
+    std::vector<float> k_data, v_data;
+    for (int64_t b = 0; b < kBatch; ++b) {
+      const int64_t offset = (b * kNumPositions + start_pos) * kRow;
+      k_data.insert(
+          k_data.end(),
+          k_history.begin() + offset,
+          k_history.begin() + offset + seq_len * kRow);
+      v_data.insert(
+          v_data.end(),
+          v_history.begin() + offset,
+          v_history.begin() + offset + seq_len * kRow);
+    }
+    const auto seq_size = static_cast<int32_t>(seq_len);
+    Tensor q = tf.make({kBatch, seq_size, kQHeads, kDim}, q_data);
+    Tensor k = tf.make({kBatch, seq_size, kKVHeads, kDim}, k_data);
+    Tensor v = tf.make({kBatch, seq_size, kKVHeads, kDim}, v_data);
+    Tensor out = tf.zeros({kBatch, seq_size, kQHeads, kDim});
+
+    TempMemoryAllocator temp_allocator;
+    KernelRuntimeContext context(nullptr, &temp_allocator);
+    torch::executor::native::sdpa_with_ring_kv_cache_out(
+        context,
+        q,
+        k,
+        v,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        kNumSinks,
+        /*dropout_p=*/0.0,
+        /*scale=*/{},
+        out);
+    ASSERT_EQ(context.failure_state(), Error::Ok);
+
+    // The cache holds the sinks and the latest kWindow positions.
+    const int64_t end_pos = start_pos + seq_len;
+    std::vector<float> expected(q_data.size());
+    for (int64_t b = 0; b < kBatch; ++b) {
+      for (int64_t m = 0; m < seq_len; ++m) {
+        const int64_t q_pos = start_pos + m;
+        for (int64_t h = 0; h < kQHeads; ++h) {
+          const int64_t h_kv = h / (kQHeads / kKVHeads);
+          const float* q_row =
+              q_data.data() + ((b * seq_len + m) * kQHeads + h) * kDim;
+          std::vector<int64_t> positions;
+          for (int64_t pos = 0; pos <= q_pos; ++pos) {
+            if (pos < kNumSinks ||
+                pos >= std::max(end_pos - kWindow, q_pos - kWindow + 1)) {
+              positions.push_back(pos);
+            }
+          }
+          std::vector<float> weights;
+          float max_weight = -INFINITY;
+          for (const int64_t pos : positions) {
+            const float* k_row = k_history.data() +
+                (b * kNumPositions + pos) * kRow + h_kv * kDim;
+            float dot = 0;
+            for (int64_t d = 0; d < kDim; ++d) {
+              dot += q_row[d] * k_row[d];
+            }
+            weights.push_back(dot / std::sqrt(static_cast<float>(kDim)));
+            max_weight = std::max(max_weight, weights.back());
+          }
+          float sum = 0;
+          for (auto& w : weights) {
+            w = std::exp(w - max_weight);
+            sum += w;
+          }
+          float* dst =
+              expected.data() + ((b * seq_len + m) * kQHeads + h) * kDim;
+          for (size_t t = 0; t < positions.size(); ++t) {
+            const float* v_row = v_history.data() +
+                (b * kNumPositions + positions[t]) * kRow + h_kv * kDim;
+            for (int64_t d = 0; d < kDim; ++d) {
+              dst[d] += weights[t] / sum * v_row[d];
+            }
+          }
+        }
+      }
+    }
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.make({kBatch, seq_size, kQHeads, kDim}, expected), 1e-5, 1e-5);
+
+    start_pos = end_pos;
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_silu_mul.h>
+
+#include <type_traits>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+// Takes a Vectorized<float> or Vectorized<double>, so that the same lambda
+// serves map2() and map2_via_float().
+struct SiluMul {
+  template <typename Vec>
+  Vec operator()(const Vec& gate, const Vec& up) const {
+    using T = typename Vec::value_type;
+    const Vec sigmoid = (gate.neg().exp() + Vec(T(1))).reciprocal();
+    return gate * sigmoid * up;
+  }
+};
+
+template <typename CTYPE>
+void silu_mul(const CTYPE* gate, const CTYPE* up, int64_t size, CTYPE* out) {
+  if constexpr (
+      std::is_same_v<CTYPE, float> || std::is_same_v<CTYPE, double>) {
+    executorch::vec::map2<CTYPE>(SiluMul{}, out, gate, up, size);
+  } else {
+    executorch::vec::map2_via_float<CTYPE>(SiluMul{}, out, gate, up, size);
+  }
+}
+
+} // namespace
+
+Tensor& silu_mul_out(
+    RuntimeContext& ctx,
+    const Tensor& gate,
+    const Tensor& up,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dtype(gate, up, out), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_shape(gate, up), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(gate.dim_order().data(), gate.dim()),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(up.dim_order().data(), up.dim()),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(out.dim_order().data(), out.dim()),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, gate.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_SWITCH_FLOATHBF16_TYPES(gate.scalar_type(), ctx, __func__, CTYPE, [&] {
+    const CTYPE* const gate_data = gate.const_data_ptr<CTYPE>();
+    const CTYPE* const up_data = up.const_data_ptr<CTYPE>();
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+    const bool success = executorch::extension::parallel_for(
+        0,
+        gate.numel(),
+        executorch::extension::internal::GRAIN_SIZE,
+        [&](const auto begin, const auto end) {
+          silu_mul<CTYPE>(
+              gate_data + begin,
+              up_data + begin,
+              end - begin,
+              out_data + begin);
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "silu_mul.out",
+    torch::executor::native::silu_mul_out);
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+// The gating of a SwiGLU feed forward layer, in one pass over memory:
+//
+//   out = silu(gate) * up = gate * sigmoid(gate) * up
+//
+// gate and up must be contiguous and have the same sizes and dtype. Half and
+// BFloat16 are computed in float and rounded once.
+Tensor& silu_mul_out(
+    RuntimeContext& ctx,
+    const Tensor& gate,
+    const Tensor& up,
+    Tensor& out);
+} // namespace torch::executor::native
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_silu_mul.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::extension::llm::testing::test_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_silu_mul_out(const Tensor& gate, const Tensor& up, Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::silu_mul_out(context, gate, up, out);
+}
+
+std::vector<float> reference_silu_mul(
+    const std::vector<float>& gate,
+    const std::vector<float>& up) {
+  std::vector<float> out(gate.size());
+  for (size_t i = 0; i < gate.size(); ++i) {
+    const double g = gate[i];
+    out[i] = g / (1.0 + std::exp(-g)) * up[i];
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OpSiluMulTest, Small) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor gate = tf.make({2, 2}, {0, 1, -2, 20});
+  Tensor up = tf.make({2, 2}, {3, 2, 0.5, -1});
+  Tensor out = tf.zeros({2, 2});
+  Tensor expected = tf.make(
+      {2, 2},
+      {0,
+       2 / (1 + std::exp(-1.0f)),
+       -1 / (1 + std::exp(2.0f)),
+       -20 / (1 + std::exp(-20.0f))});
+  op_silu_mul_out(gate, up, out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpSiluMulTest, LongMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  // Long enough to use the vector and partial tails, and to be split between
+  // threads.
+  constexpr int32_t kRows = 11;
+  constexpr int32_t kCols = 8195;
+  const auto gate_data = test_data(kRows * kCols, 0.1f, 6.0f);
+  const auto up_data = test_data(kRows * kCols, 0.9f, 6.0f);
+  Tensor gate = tf.make({kRows, kCols}, gate_data);
+  Tensor up = tf.make({kRows, kCols}, up_data);
+  Tensor out = tf.zeros({kRows, kCols});
+  op_silu_mul_out(gate, up, out);
+  Tensor expected =
+      tf.make({kRows, kCols}, reference_silu_mul(gate_data, up_data));
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+}
+
+TEST(OpSiluMulTest, BFloat16ComputesInFloat) {
+  TensorFactory<ScalarType::BFloat16> tf_bf16;
+  constexpr int32_t kSize = 1027;
+  // Round the inputs to bfloat16 first so that the reference sees the same
+  // values as the kernel.
+  auto gate_data = test_data(kSize, 0.3f, 6.0f);
+  auto up_data = test_data(kSize, 1.7f, 6.0f);
+  for (auto* data : {&gate_data, &up_data}) {
+    for (auto& v : *data) {
+      v = static_cast<float>(executorch::aten::BFloat16(v));
+    }
+  }
+  Tensor gate = tf_bf16.make({kSize}, {gate_data.begin(), gate_data.end()});
+  Tensor up = tf_bf16.make({kSize}, {up_data.begin(), up_data.end()});
+  Tensor out = tf_bf16.zeros({kSize});
+  op_silu_mul_out(gate, up, out);
+  const auto expected_data = reference_silu_mul(gate_data, up_data);
+  Tensor expected =
+      tf_bf16.make({kSize}, {expected_data.begin(), expected_data.end()});
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpSiluMulTest, MismatchedShapesFail) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor gate = tf.ones({2, 4});
+  Tensor up = tf.ones({4, 2});
+  Tensor out = tf.zeros({2, 4});
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::silu_mul_out(context, gate, up, out);
+  EXPECT_EQ(
+      context.failure_state(), executorch::runtime::Error::InvalidArgument);
+}
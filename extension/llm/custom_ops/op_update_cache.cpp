@@ -8,6 +8,9 @@
 
 #include <executorch/extension/llm/custom_ops/op_update_cache.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 // @lint-ignore CLANGTIDY facebook-unused-include-check
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
@@ -58,6 +61,154 @@ bool validate_cache_params(
 
   return true;
 }
+
+bool validate_paged_cache_params(
+    const Tensor& value,
+    const Tensor& cache,
+    const Tensor& block_table,
+    const Tensor& start_pos) {
+  ET_CHECK_OR_RETURN_FALSE(value.dim() == 4, "value must be a 4D tensor");
+  ET_CHECK_OR_RETURN_FALSE(cache.dim() == 4, "cache must be a 4D tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      value.size(2) == cache.size(2) && value.size(3) == cache.size(3),
+      "value and cache must have the same number of heads and head dim");
+  ET_CHECK_OR_RETURN_FALSE(
+      value.scalar_type() == cache.scalar_type(),
+      "value and cache must have the same dtype");
+
+  ET_CHECK_OR_RETURN_FALSE(
+      block_table.dim() == 2 && block_table.size(0) == value.size(0),
+      "block_table must be a [batch size, max blocks] tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      block_table.scalar_type() == ScalarType::Long,
+      "block_table must be a Long tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      start_pos.dim() == 1 && start_pos.size(0) == value.size(0),
+      "start_pos must be a [batch size] tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      start_pos.scalar_type() == ScalarType::Long,
+      "start_pos must be a Long tensor");
+
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(cache.dim_order().data(), cache.dim()),
+      "cache must be in contiguous dim order");
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(value.dim_order().data(), value.dim()),
+      "value must be in contiguous dim order");
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(
+          block_table.dim_order().data(), block_table.dim()),
+      "block_table must be in contiguous dim order");
+
+  // Every block that holds one of the positions [0, start_pos + seq_len) of
+  // a sequence, i.e. everything this op writes and attention then reads,
+  // must be in the pool.
+  const int64_t seq_len = value.size(1);
+  const int64_t block_size = cache.size(1);
+  const int64_t max_blocks = block_table.size(1);
+  const int64_t* block_table_data = block_table.const_data_ptr<int64_t>();
+  const int64_t* start_pos_data = start_pos.const_data_ptr<int64_t>();
+  for (int64_t b = 0; b < value.size(0); ++b) {
+    const int64_t end_pos = start_pos_data[b] + seq_len;
+    ET_CHECK_OR_RETURN_FALSE(
+        start_pos_data[b] >= 0 && end_pos <= max_blocks * block_size,
+        "start_pos + seq_len must be at most max blocks * block size. "
+        "start pos: %" PRId64 ", seq_len: %" PRId64 ", block size: %" PRId64
+        ", max blocks: %" PRId64,
+        start_pos_data[b],
+        seq_len,
+        block_size,
+        max_blocks);
+    for (int64_t i = 0; i * block_size < end_pos; ++i) {
+      const int64_t block = block_table_data[b * max_blocks + i];
+      ET_CHECK_OR_RETURN_FALSE(
+          block >= 0 && block < cache.size(0),
+          "block_table[%" PRId64 "][%" PRId64 "] = %" PRId64
+          " is out of range for a cache of %zd blocks",
+          b,
+          i,
+          block,
+          cache.size(0));
+    }
+  }
+  return true;
+}
+
+bool validate_ring_cache_params(
+    const Tensor& value,
+    const Tensor& cache,
+    int64_t start_pos,
+    int64_t num_sinks) {
+  ET_CHECK_OR_RETURN_FALSE(value.dim() == 4, "value must be a 4D tensor");
+  ET_CHECK_OR_RETURN_FALSE(cache.dim() == 4, "cache must be a 4D tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      value.size(0) == cache.size(0) && value.size(2) == cache.size(2) &&
+          value.size(3) == cache.size(3),
+      "value and cache must have the same batch size, heads and head dim");
+  ET_CHECK_OR_RETURN_FALSE(
+      value.scalar_type() == cache.scalar_type(),
+      "value and cache must have the same dtype");
+  ET_CHECK_OR_RETURN_FALSE(start_pos >= 0, "start_pos must be non-negative");
+  ET_CHECK_OR_RETURN_FALSE(
+      num_sinks >= 0 && num_sinks < cache.size(1),
+      "num_sinks must be in [0, cache size at dim 1). num_sinks: %" PRId64
+      ", cache size: %zd",
+      num_sinks,
+      cache.size(1));
+  ET_CHECK_OR_RETURN_FALSE(
+      value.size(1) <= cache.size(1) - num_sinks,
+      "seq_len must be at most the window, cache size - num_sinks. "
+      "seq_len: %zd, window: %" PRId64,
+      value.size(1),
+      cache.size(1) - num_sinks);
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(cache.dim_order().data(), cache.dim()),
+      "cache must be in contiguous dim order");
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(value.dim_order().data(), value.dim()),
+      "value must be in contiguous dim order");
+  return true;
+}
+
+bool validate_quantized_cache_params(
+    const Tensor& value,
+    const Tensor& cache,
+    const Tensor& scales,
+    int64_t start_pos) {
+  ET_CHECK_OR_RETURN_FALSE(value.dim() == 4, "value must be a 4D tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      validate_cache_params(value, cache, start_pos, value.size(1)),
+      "Invalid cache params");
+  ET_CHECK_OR_RETURN_FALSE(
+      value.scalar_type() == ScalarType::Float, "value must be a Float tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      cache.scalar_type() == ScalarType::Char ||
+          cache.scalar_type() == ScalarType::Byte,
+      "quantized cache must be a Char (int8) or Byte (packed int4) tensor");
+  const int64_t values_per_element =
+      cache.scalar_type() == ScalarType::Byte ? 2 : 1;
+  ET_CHECK_OR_RETURN_FALSE(
+      value.size(0) == cache.size(0) && value.size(2) == cache.size(2) &&
+          value.size(3) == cache.size(3) * values_per_element,
+      "value must be [batch size, seq_len, num heads, head dim] for a cache "
+      "of %zd x %zd x %zd x %zd",
+      cache.size(0),
+      cache.size(1),
+      cache.size(2),
+      cache.size(3));
+  ET_CHECK_OR_RETURN_FALSE(
+      scales.scalar_type() == ScalarType::Float,
+      "scales must be a Float tensor");
+  ET_CHECK_OR_RETURN_FALSE(
+      scales.dim() == 4 && scales.size(0) == cache.size(0) &&
+          scales.size(1) == cache.size(1) && scales.size(2) == cache.size(2) &&
+          scales.size(3) == 1,
+      "scales must be [batch size, max seq len, num heads, 1]");
+  ET_CHECK_OR_RETURN_FALSE(
+      is_contiguous_dim_order(scales.dim_order().data(), scales.dim()),
+      "scales must be in contiguous dim order");
+  return true;
+}
 } // anonymous namespace
 
 Tensor& update_cache_out(
@@ -127,6 +278,151 @@ Tensor& update_cache_out(
   // Noone uses output. Just a placeholder.
   return output;
 }
+
+Tensor& update_cache_paged_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_paged_cache_params(value, cache, block_table, start_pos),
+      InvalidArgument,
+      output);
+
+  const uint8_t* value_data =
+      static_cast<const uint8_t*>(value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+  const int64_t* block_table_data = block_table.const_data_ptr<int64_t>();
+  const int64_t* start_pos_data = start_pos.const_data_ptr<int64_t>();
+
+  const int64_t seq_len = value.size(1);
+  const int64_t block_size = cache.size(1);
+  const int64_t max_blocks = block_table.size(1);
+  const size_t element_size = cache.element_size();
+  const size_t block_bytes = cache.strides()[0] * element_size;
+  // Bytes of one position: [num heads, head dim].
+  const size_t row_bytes = cache.strides()[1] * element_size;
+
+  for (int64_t b = 0; b < value.size(0); ++b) {
+    for (int64_t s = 0; s < seq_len; ++s) {
+      const int64_t pos = start_pos_data[b] + s;
+      const int64_t block = block_table_data[b * max_blocks + pos / block_size];
+      std::memcpy(
+          cache_data + block * block_bytes + (pos % block_size) * row_bytes,
+          value_data + (b * seq_len + s) * row_bytes,
+          row_bytes);
+    }
+  }
+
+  // Noone uses output. Just a placeholder.
+  return output;
+}
+
+Tensor& update_ring_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const int64_t start_pos,
+    const int64_t num_sinks,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_ring_cache_params(value, cache, start_pos, num_sinks),
+      InvalidArgument,
+      output);
+
+  const uint8_t* value_data =
+      static_cast<const uint8_t*>(value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+  const int64_t seq_len = value.size(1);
+  const int64_t window = cache.size(1) - num_sinks;
+  const size_t element_size = cache.element_size();
+  const size_t cache_batch_bytes = cache.strides()[0] * element_size;
+  // Bytes of one position: [num heads, head dim].
+  const size_t row_bytes = cache.strides()[1] * element_size;
+
+  for (int64_t b = 0; b < value.size(0); ++b) {
+    for (int64_t s = 0; s < seq_len; ++s) {
+      const int64_t slot = ring_cache_slot(start_pos + s, num_sinks, window);
+      std::memcpy(
+          cache_data + b * cache_batch_bytes + slot * row_bytes,
+          value_data + (b * seq_len + s) * row_bytes,
+          row_bytes);
+    }
+  }
+
+  // Noone uses output. Just a placeholder.
+  return output;
+}
+
+Tensor& update_quantized_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    const int64_t start_pos,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_quantized_cache_params(value, cache, scales, start_pos),
+      InvalidArgument,
+      output);
+
+  const bool is_int4 = cache.scalar_type() == ScalarType::Byte;
+  const float qmax = is_int4 ? 7.0f : 127.0f;
+  const int64_t batch_size = value.size(0);
+  const int64_t seq_len = value.size(1);
+  const int64_t num_heads = value.size(2);
+  const int64_t head_dim = value.size(3);
+  const float* value_data = value.const_data_ptr<float>();
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+  float* scales_data = scales.mutable_data_ptr<float>();
+  const auto cache_strides = cache.strides();
+  const auto scales_strides = scales.strides();
+
+  // Quantize straight into the cache, one head of one position at a time.
+  for (int64_t b = 0; b < batch_size; ++b) {
+    for (int64_t s = 0; s < seq_len; ++s) {
+      const int64_t pos = start_pos + s;
+      for (int64_t h = 0; h < num_heads; ++h) {
+        const float* src =
+            value_data + ((b * seq_len + s) * num_heads + h) * head_dim;
+        float amax = 0;
+        for (int64_t d = 0; d < head_dim; ++d) {
+          amax = std::max(amax, std::abs(src[d]));
+        }
+        const float scale = amax / qmax;
+        const float inv_scale = amax > 0 ? 1 / scale : 0;
+        scales_data
+            [b * scales_strides[0] + pos * scales_strides[1] +
+             h * scales_strides[2]] = scale;
+        uint8_t* dst = cache_data + b * cache_strides[0] +
+            pos * cache_strides[1] + h * cache_strides[2];
+        auto quantize = [&](float x) {
+          return static_cast<int32_t>(std::max(
+              -qmax, std::min(qmax, std::nearbyint(x * inv_scale))));
+        };
+        if (is_int4) {
+          for (int64_t d = 0; d < head_dim; d += 2) {
+            dst[d / 2] = static_cast<uint8_t>(
+                (quantize(src[d]) + 8) | ((quantize(src[d + 1]) + 8) << 4));
+          }
+        } else {
+          for (int64_t d = 0; d < head_dim; ++d) {
+            dst[d] =
+                static_cast<uint8_t>(static_cast<int8_t>(quantize(src[d])));
+          }
+        }
+      }
+    }
+  }
+
+  // Noone uses output. Just a placeholder.
+  return output;
+}
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -141,3 +437,27 @@ EXECUTORCH_LIBRARY(
     llama,
     "update_cache.out",
     torch::executor::native::update_cache_out);
+
+// Paged counterpart of update_cache: cache is a pool of
+// [num blocks, block size, num heads, head dim] blocks, and position p of
+// sequence b is written to row p % block size of block
+// block_table[b][p / block size]. Each sequence has its own start_pos.
+EXECUTORCH_LIBRARY(
+    llama,
+    "update_cache_paged.out",
+    torch::executor::native::update_cache_paged_out);
+
+// Ring buffer counterpart of update_cache: keeps the first num_sinks
+// positions, and writes every later one over the position window before it,
+// so that generation can run past the cache size.
+EXECUTORCH_LIBRARY(
+    llama,
+    "update_ring_cache.out",
+    torch::executor::native::update_ring_cache_out);
+
+// Quantized counterpart of update_cache: quantizes value per position and
+// head into an int8 or packed int4 cache, see update_quantized_cache_out.
+EXECUTORCH_LIBRARY(
+    llama,
+    "update_quantized_cache.out",
+    torch::executor::native::update_quantized_cache_out);
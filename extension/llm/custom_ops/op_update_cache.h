@@ -21,6 +21,58 @@ Tensor& update_cache_out(
     Tensor& cache,
     const int64_t start_pos,
     Tensor& output);
+
+Tensor& update_cache_paged_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    Tensor& output);
+
+/*
+  Quantizes value, [batch size, seq_len, num heads, head dim] Float, and
+  writes it to cache at positions [start_pos, start_pos + seq_len).
+
+  Every position of every head holds head dim values q with a single Float
+  scale in scales, [batch size, max seq len, num heads, 1], and stands for
+  q * scale. The quantization is symmetric and scale = max(abs(x)) / qmax.
+  - A Char cache, [batch size, max seq len, num heads, head dim], holds int8
+    values in [-127, 127].
+  - A Byte cache, [batch size, max seq len, num heads, head dim / 2], holds
+    int4 values in [-7, 7], offset by 8 and packed two per byte, the even
+    element in the low nibble.
+*/
+/*
+  Writes value, [batch size, seq_len, num heads, head dim], to a ring buffer
+  cache, [batch size, num_sinks + window, num heads, head dim], at positions
+  [start_pos, start_pos + seq_len). start_pos may be past the cache size.
+
+  The first num_sinks positions (the attention sinks) keep their own slots,
+  and every later position p takes slot ring_cache_slot(p), overwriting the
+  position window before it. seq_len must be at most window.
+*/
+Tensor& update_ring_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const int64_t start_pos,
+    const int64_t num_sinks,
+    Tensor& output);
+
+// The slot of position pos in a ring buffer cache, see update_ring_cache_out.
+inline int64_t
+ring_cache_slot(int64_t pos, int64_t num_sinks, int64_t window) {
+  return pos < num_sinks ? pos : num_sinks + (pos - num_sinks) % window;
+}
+
+Tensor& update_quantized_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    Tensor& scales,
+    const int64_t start_pos,
+    Tensor& output);
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -23,7 +23,8 @@ using executorch::runtime::testing::reference_fht_impl;
 
 namespace {
 Tensor& fast_hadamard_transform_nocontext(const Tensor& vec, Tensor& out) {
-  executorch::aten::RuntimeContext context;
+  TempMemoryAllocator temp_allocator;
+  executorch::aten::RuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::native::fast_hadamard_transform_out(
       context, vec, out);
 }
@@ -112,6 +113,36 @@ TEST(OpFastHadamardTransformTest, Basic28N) {
   }
 }
 
+TEST(OpFastHadamardTransformTest, HalfMultipleRows28N) {
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Half>
+      tfHalf;
+  constexpr int kTestLogSize = 3;
+  constexpr int kRowSize = (1 << kTestLogSize) * 28;
+  constexpr int kNumRows = 5;
+  std::vector<float> data = random_floats(kNumRows * kRowSize);
+  std::vector<executorch::aten::Half> half_data(data.begin(), data.end());
+  auto mat = tfHalf.make({kNumRows, kRowSize}, half_data);
+  auto out = tfHalf.zeros({kNumRows, kRowSize});
+
+  auto result = fast_hadamard_transform_nocontext(mat, out);
+
+  // Half rows are transformed in float, so the result must match the float
+  // reference up to the final rounding to half.
+  std::vector<float> reference_result(half_data.begin(), half_data.end());
+  for (int ii = 0; ii < kNumRows; ++ii) {
+    fast_hadamard_transform_28N_with_transpose(
+        &reference_result[ii * kRowSize], kTestLogSize);
+  }
+
+  const auto* const result_data =
+      result.const_data_ptr<executorch::aten::Half>();
+  for (int ii = 0; ii < data.size(); ++ii) {
+    EXPECT_EQ(
+        result_data[ii],
+        static_cast<executorch::aten::Half>(reference_result[ii]));
+  }
+}
+
 TEST(OpFastHadamardTransformTest, InvalidSize) {
   torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
       tfFloat;
@@ -21,13 +21,21 @@ def define_common_targets():
             srcs = [
                 "op_fallback.cpp",
                 "op_fast_hadamard_transform.cpp",
+                "op_lora_bgmv.cpp",
+                "op_rms_norm.cpp",
+                "op_rope.cpp",
                 "op_sdpa.cpp",
+                "op_silu_mul.cpp",
                 "op_update_cache.cpp",
             ],
             exported_headers = [
                 "op_fallback.h",
                 "op_fast_hadamard_transform.h",
+                "op_lora_bgmv.h",
+                "op_rms_norm.h",
+                "op_rope.h",
                 "op_sdpa.h",
+                "op_silu_mul.h",
                 "op_update_cache.h",
             ],
             preprocessor_flags = get_vec_preprocessor_flags(),
@@ -58,7 +66,11 @@ def define_common_targets():
             name = "custom_ops_aot_lib" + mkl_dep,
             srcs = [
                 "op_fast_hadamard_transform_aten.cpp",
+                "op_lora_bgmv_aten.cpp",
+                "op_rms_norm_aten.cpp",
+                "op_rope_aten.cpp",
                 "op_sdpa_aot.cpp",
+                "op_silu_mul_aten.cpp",
                 "op_tile_crop.cpp",
                 "op_tile_crop_aot.cpp",
             ],
@@ -74,6 +86,7 @@ def define_common_targets():
             deps = [
                 ":custom_ops" + mkl_dep,
                 "//executorch/extension/aten_util:aten_bridge",
+                "//executorch/extension/memory_allocator:malloc_memory_allocator",
             ],
         )
 
@@ -91,6 +104,74 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "test_util",
+        exported_headers = [
+            "test_util.h",
+        ],
+        visibility = ["//executorch/extension/llm/custom_ops/..."],
+    )
+
+    runtime.cxx_test(
+        name = "op_rms_norm_test",
+        srcs = [
+            "op_rms_norm_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rope_test",
+        srcs = [
+            "op_rope_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_lora_bgmv_test",
+        srcs = [
+            "op_lora_bgmv_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_silu_mul_test",
+        srcs = [
+            "op_silu_mul_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
     runtime.cxx_test(
         name = "op_sdpa_test",
         srcs = [
@@ -116,6 +197,52 @@ def define_common_targets():
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
             "//executorch/kernels/test:test_util",
             ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_sdpa_with_paged_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_paged_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_sdpa_with_ring_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_ring_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_sdpa_with_quantized_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_quantized_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
         ],
     )
 
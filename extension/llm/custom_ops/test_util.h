@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ * Input data for the custom op tests.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+namespace testing {
+
+/**
+ * Returns `n` pseudo-random values in [-0.5, 0.5), generated by an LCG from
+ * `seed` so that they are the same on every platform.
+ */
+inline std::vector<float> make_data(size_t n, uint32_t seed) {
+  std::vector<float> data(n);
+  for (auto& x : data) {
+    seed = seed * 1664525u + 1013904223u;
+    x = static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) - 0.5f;
+  }
+  return data;
+}
+
+/**
+ * Returns `size` values of `scale * sin(0.37 * i + offset)`. They vary
+ * smoothly and take both signs, and different offsets give different data.
+ */
+inline std::vector<float>
+test_data(size_t size, float offset, float scale = 1.0f) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = std::sin(0.37f * i + offset) * scale;
+  }
+  return data;
+}
+
+} // namespace testing
+} // namespace llm
+} // namespace extension
+} // namespace executorch
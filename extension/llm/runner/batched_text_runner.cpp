@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Serve many text prompts at once by decoding them together, one batched
+// step of the LLM at a time.
+
+#include <executorch/extension/llm/runner/batched_text_runner.h>
+
+#include <algorithm>
+#include <cinttypes>
+
+#include <c10/util/irange.h>
+#include <executorch/extension/llm/runner/util.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+
+namespace {
+static constexpr auto kEosIds = "get_eos_ids";
+static constexpr auto kKVBlockSize = "get_kv_block_size";
+static constexpr auto kMaxContextLen = "get_max_context_len";
+static constexpr auto kMaxSeqLen = "get_max_seq_len";
+static constexpr auto kNumKVBlocks = "get_num_kv_blocks";
+static constexpr auto kNumLoRAAdapters = "get_num_lora_adapters";
+} // namespace
+
+struct BatchedTextRunner::Sequence {
+  std::vector<uint64_t> prompt_tokens;
+  int32_t seq_len = 0;
+  // Index of the LoRA adapter, or -1 for none.
+  int32_t adapter = -1;
+  // Position of the token fed at the next step: prompt_tokens[pos] while the
+  // prompt is being prefilled, and then cur_token.
+  int64_t pos = 0;
+  uint64_t cur_token = 0;
+  // Text of the tokens generated since the owning generate() call last woke
+  // up, which it passes to its token callback.
+  std::vector<std::string> pending_pieces;
+  bool done = false;
+  Error error = Error::Ok;
+  Stats stats;
+};
+
+BatchedTextRunner::BatchedTextRunner(
+    std::unique_ptr<Module> module,
+    std::unique_ptr<::tokenizers::Tokenizer> tokenizer,
+    int32_t max_batch_size,
+    float temperature)
+    : module_(std::move(module)),
+      tokenizer_(std::move(tokenizer)),
+      max_batch_size_(max_batch_size),
+      temperature_(temperature),
+      rows_(max_batch_size),
+      tokens_(max_batch_size),
+      start_pos_(max_batch_size),
+      adapter_ids_(max_batch_size, -1) {}
+
+bool BatchedTextRunner::is_loaded() const {
+  return module_->is_loaded() && text_decoder_runner_ != nullptr;
+}
+
+Error BatchedTextRunner::load() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (is_loaded()) {
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      max_batch_size_ > 0,
+      InvalidArgument,
+      "max_batch_size %" PRId32 " must be positive",
+      max_batch_size_);
+  ET_CHECK_OR_RETURN_ERROR(
+      tokenizer_ != nullptr && tokenizer_->is_loaded(),
+      InvalidState,
+      "The tokenizer must be loaded");
+  ET_CHECK_OK_OR_RETURN_ERROR(module_->load_method("forward"));
+
+  const auto method_meta = ET_UNWRAP(module_->method_meta("forward"));
+  const auto tokens_meta = ET_UNWRAP(method_meta.input_tensor_meta(0));
+  ET_CHECK_OR_RETURN_ERROR(
+      tokens_meta.sizes().size() == 2 &&
+          tokens_meta.sizes()[0] == max_batch_size_,
+      InvalidArgument,
+      "Expected forward to take [%" PRId32 ", 1] tokens",
+      max_batch_size_);
+
+  const auto method_names =
+      ET_UNWRAP(module_->method_names(), "Failed reading method names");
+  for (const auto* method_name : {kMaxContextLen, kMaxSeqLen}) {
+    if (method_names.count(method_name)) {
+      max_context_len_ =
+          ET_UNWRAP(module_->get(method_name)).toScalar().to<int64_t>();
+      break;
+    }
+  }
+  ET_LOG(Info, "Metadata: max context length = %" PRId64, max_context_len_);
+
+  eos_ids_ = {tokenizer_->eos_tok()};
+  if (method_names.count(kEosIds)) {
+    eos_ids_.clear();
+    for (const auto& eos_id : ET_UNWRAP(module_->execute(kEosIds))) {
+      eos_ids_.emplace(eos_id.toScalar().to<int64_t>());
+    }
+  }
+
+  // The adapter ids come after the inputs of the KV cache.
+  const bool has_adapters = method_names.count(kNumLoRAAdapters) != 0;
+  const size_t num_cache_inputs =
+      method_meta.num_inputs() - (has_adapters ? 1 : 0);
+  if (num_cache_inputs == 3) {
+    ET_CHECK_OR_RETURN_ERROR(
+        method_names.count(kKVBlockSize) && method_names.count(kNumKVBlocks),
+        InvalidArgument,
+        "A paged KV cache needs %s and %s methods",
+        kKVBlockSize,
+        kNumKVBlocks);
+    const auto block_size =
+        ET_UNWRAP(module_->get(kKVBlockSize)).toScalar().to<int64_t>();
+    const auto num_blocks =
+        ET_UNWRAP(module_->get(kNumKVBlocks)).toScalar().to<int64_t>();
+    const auto table_meta = ET_UNWRAP(method_meta.input_tensor_meta(2));
+    ET_CHECK_OR_RETURN_ERROR(
+        block_size > 0 && table_meta.sizes().size() == 2 &&
+            table_meta.sizes()[0] == max_batch_size_,
+        InvalidArgument,
+        "Expected forward to take a [%" PRId32 ", max blocks] block table",
+        max_batch_size_);
+    const int64_t max_blocks = table_meta.sizes()[1];
+    kv_block_allocator_ = std::make_unique<KVBlockAllocator>(
+        num_blocks, block_size, max_batch_size_, max_blocks);
+    block_table_ = from_blob(
+        kv_block_allocator_->block_table(),
+        {max_batch_size_, static_cast<executorch::aten::SizesType>(max_blocks)},
+        ::executorch::aten::ScalarType::Long);
+    // The allocator updates the table in place, so bind it once.
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        module_->bind_input("forward", block_table_, 2));
+    max_context_len_ = std::min(max_context_len_, max_blocks * block_size);
+    ET_LOG(
+        Info,
+        "Paged KV cache: %" PRId64 " blocks of %" PRId64 " positions",
+        num_blocks,
+        block_size);
+  }
+
+  if (has_adapters) {
+    num_lora_adapters_ =
+        ET_UNWRAP(module_->get(kNumLoRAAdapters)).toScalar().to<int64_t>();
+    const auto ids_meta =
+        ET_UNWRAP(method_meta.input_tensor_meta(num_cache_inputs));
+    ET_CHECK_OR_RETURN_ERROR(
+        ids_meta.sizes().size() == 1 && ids_meta.sizes()[0] == max_batch_size_,
+        InvalidArgument,
+        "Expected forward to take [%" PRId32 "] LoRA adapter ids",
+        max_batch_size_);
+    adapter_ids_tensor_ = from_blob(
+        adapter_ids_.data(),
+        {max_batch_size_},
+        ::executorch::aten::ScalarType::Long);
+    // step() updates the ids in place, so bind them once.
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->bind_input(
+        "forward", adapter_ids_tensor_, num_cache_inputs));
+    ET_LOG(Info, "LoRA adapters: %" PRId64, num_lora_adapters_);
+  }
+
+  text_decoder_runner_ = std::make_unique<TextDecoderRunner>(
+      module_.get(),
+      /*use_kv_cache=*/true,
+      tokenizer_->vocab_size(),
+      temperature_);
+  return Error::Ok;
+}
+
+Error BatchedTextRunner::generate(
+    const std::string& prompt,
+    int32_t seq_len,
+    std::function<void(const std::string&)> token_callback,
+    std::function<void(const Stats&)> stats_callback,
+    bool echo,
+    bool warming) {
+  return generate_with_adapter(
+      prompt,
+      /*adapter=*/-1,
+      seq_len,
+      std::move(token_callback),
+      std::move(stats_callback),
+      echo,
+      warming);
+}
+
+Error BatchedTextRunner::generate_with_adapter(
+    const std::string& prompt,
+    int32_t adapter,
+    int32_t seq_len,
+    std::function<void(const std::string&)> token_callback,
+    std::function<void(const Stats&)> stats_callback,
+    bool echo,
+    bool warming) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !prompt.empty(), InvalidArgument, "Prompt cannot be empty");
+  auto sequence = std::make_shared<Sequence>();
+  sequence->stats.reset(/*all_stats=*/true);
+  if (!is_loaded()) {
+    sequence->stats.model_load_start_ms = time_in_ms();
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+    sequence->stats.model_load_end_ms = time_in_ms();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      adapter >= -1 && adapter < num_lora_adapters_,
+      InvalidArgument,
+      "Adapter %" PRId32 " is not one of the model's %" PRId64
+      " LoRA adapters",
+      adapter,
+      num_lora_adapters_);
+  sequence->adapter = adapter;
+  if (warming) {
+    token_callback = nullptr;
+    stats_callback = nullptr;
+  }
+
+  sequence->stats.inference_start_ms = time_in_ms();
+  sequence->seq_len = (seq_len > 0 && seq_len <= max_context_len_)
+      ? seq_len
+      : static_cast<int32_t>(max_context_len_);
+  sequence->prompt_tokens =
+      ET_UNWRAP_TOKENIZER(tokenizer_->encode(prompt, /*bos=*/0, /*eos=*/0));
+  const auto num_prompt_tokens =
+      static_cast<int64_t>(sequence->prompt_tokens.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      num_prompt_tokens >= 1,
+      InvalidArgument,
+      "Expected at least 1 prompt token");
+  ET_CHECK_OR_RETURN_ERROR(
+      num_prompt_tokens < sequence->seq_len,
+      InvalidArgument,
+      "num_prompt_tokens %" PRId64 " >= seq_len %" PRId32,
+      num_prompt_tokens,
+      sequence->seq_len);
+  sequence->stats.token_encode_end_ms = time_in_ms();
+  sequence->stats.num_prompt_tokens = num_prompt_tokens;
+
+  if (echo && token_callback) {
+    token_callback(prompt);
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  waiting_.push_back(sequence);
+  while (true) {
+    if (!sequence->pending_pieces.empty()) {
+      std::vector<std::string> pieces;
+      pieces.swap(sequence->pending_pieces);
+      lock.unlock();
+      if (token_callback) {
+        for (const auto& piece : pieces) {
+          token_callback(piece);
+        }
+      }
+      lock.lock();
+      continue;
+    }
+    if (sequence->done) {
+      break;
+    }
+    if (!driving_) {
+      // Nobody is running the model: take a turn. Any error is recorded on
+      // the sequences that were in the batch.
+      driving_ = true;
+      lock.unlock();
+      (void)step();
+      lock.lock();
+      driving_ = false;
+      cv_.notify_all();
+      continue;
+    }
+    cv_.wait(lock);
+  }
+  lock.unlock();
+
+  sequence->stats.num_generated_tokens =
+      std::max<int64_t>(sequence->pos - num_prompt_tokens, 0);
+  sequence->stats.inference_end_ms = time_in_ms();
+  if (stats_callback) {
+    stats_callback(sequence->stats);
+  }
+  return sequence->error;
+}
+
+void BatchedTextRunner::stop() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& sequence : waiting_) {
+    sequence->done = true;
+  }
+  waiting_.clear();
+  for (const auto row : c10::irange(rows_.size())) {
+    if (rows_[row] != nullptr) {
+      retire_locked(row, Error::Ok);
+    }
+  }
+  cv_.notify_all();
+}
+
+Error BatchedTextRunner::step() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    bool any_active = false;
+    for (const auto row : c10::irange(rows_.size())) {
+      // Prompts are admitted in order, and only once all of their KV cache
+      // blocks are in.
+      if (rows_[row] == nullptr && !waiting_.empty() &&
+          reserve_blocks_locked(
+              row, waiting_.front()->prompt_tokens.size() + 1)) {
+        rows_[row] = std::move(waiting_.front());
+        waiting_.pop_front();
+      }
+      const auto& sequence = rows_[row];
+      if (sequence != nullptr &&
+          !reserve_blocks_locked(row, sequence->pos + 1)) {
+        retire_locked(row, Error::MemoryAllocationFailed);
+      }
+      if (sequence == nullptr) {
+        // Free rows decode a dummy token into their own, unused KV cache,
+        // or into block 0 of a paged one.
+        tokens_[row] = 0;
+        start_pos_[row] = 0;
+        adapter_ids_[row] = -1;
+        continue;
+      }
+      any_active = true;
+      const auto num_prompt_tokens =
+          static_cast<int64_t>(sequence->prompt_tokens.size());
+      tokens_[row] = sequence->pos < num_prompt_tokens
+          ? sequence->prompt_tokens[sequence->pos]
+          : sequence->cur_token;
+      start_pos_[row] = sequence->pos;
+      adapter_ids_[row] = sequence->adapter;
+    }
+    if (!any_active) {
+      if (!waiting_.empty()) {
+        // Every block is free, and still not enough for this prompt.
+        waiting_.front()->done = true;
+        waiting_.front()->error = Error::MemoryAllocationFailed;
+        waiting_.pop_front();
+      }
+      return Error::Ok;
+    }
+  }
+
+  auto tokens = tensor_pool_.from_blob(
+      tokens_.data(),
+      {max_batch_size_, 1},
+      ::executorch::aten::ScalarType::Long);
+  auto start_pos = tensor_pool_.from_blob(
+      start_pos_.data(),
+      {max_batch_size_},
+      ::executorch::aten::ScalarType::Long);
+  auto logits_res = text_decoder_runner_->step(tokens, start_pos);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!logits_res.ok()) {
+    for (const auto row : c10::irange(rows_.size())) {
+      if (rows_[row] != nullptr) {
+        retire_locked(row, logits_res.error());
+      }
+    }
+    return logits_res.error();
+  }
+  const auto& logits = logits_res.get();
+  // stop() may have retired some of the rows in the meantime.
+  for (const auto row : c10::irange(rows_.size())) {
+    const auto& sequence = rows_[row];
+    if (sequence == nullptr) {
+      continue;
+    }
+    sequence->pos++;
+    const auto num_prompt_tokens =
+        static_cast<int64_t>(sequence->prompt_tokens.size());
+    if (sequence->pos < num_prompt_tokens) {
+      // Still prefilling: the logits of prompt tokens aren't needed.
+      continue;
+    }
+
+    const bool is_first_token = sequence->pos == num_prompt_tokens;
+    sequence->stats.on_sampling_begin();
+    const uint64_t next_token =
+        text_decoder_runner_->logits_to_token(logits, row);
+    sequence->stats.on_sampling_end();
+    // No previous token for the first generated one, so use it for both.
+    const uint64_t prev_token =
+        is_first_token ? next_token : sequence->cur_token;
+    sequence->cur_token = next_token;
+    if (is_first_token) {
+      sequence->stats.first_token_ms = time_in_ms();
+      sequence->stats.prompt_eval_end_ms = sequence->stats.first_token_ms;
+    }
+
+    auto piece = tokenizer_->decode(prev_token, next_token);
+    if (!piece.ok()) {
+      ET_LOG(
+          Error,
+          "Tokenizers error code %d",
+          static_cast<uint32_t>(piece.error()));
+      retire_locked(row, Error::InvalidArgument);
+      continue;
+    }
+    sequence->pending_pieces.push_back(std::move(*piece));
+
+    if (eos_ids_.count(next_token) != 0 ||
+        sequence->pos >= sequence->seq_len - 1) {
+      retire_locked(row, Error::Ok);
+    }
+  }
+  return Error::Ok;
+}
+
+void BatchedTextRunner::retire_locked(size_t row, Error error) {
+  rows_[row]->done = true;
+  rows_[row]->error = error;
+  rows_[row] = nullptr;
+  if (kv_block_allocator_ != nullptr) {
+    kv_block_allocator_->release(row);
+  }
+}
+
+bool BatchedTextRunner::reserve_blocks_locked(
+    size_t row,
+    int64_t num_positions) {
+  return kv_block_allocator_ == nullptr ||
+      kv_block_allocator_->reserve(row, num_positions) == Error::Ok;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Serve many text prompts at once by decoding them together, one batched
+// step of the LLM at a time.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/kv_block_allocator.h>
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/module/module.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Runs concurrent generate() calls on one model with continuous batching.
+ *
+ * The model's forward method must take a [max_batch_size, 1] Long tensor of
+ * tokens and a [max_batch_size] Long tensor with the start position of each
+ * row, keep a separate KV cache for every row, and return logits of shape
+ * [max_batch_size, vocab_size] or [max_batch_size, 1, vocab_size].
+ *
+ * Every step feeds one token of each active sequence: its next prompt token
+ * while its prompt is being prefilled, and then the token sampled from it at
+ * the previous step. Sequences are retired as soon as they finish, and
+ * waiting prompts take over their rows at the next step, so a long prompt or
+ * generation never holds up the others.
+ *
+ * If forward takes a third input, a [max_batch_size, max blocks] Long block
+ * table, the KV cache is paged (see KVBlockAllocator) and the model must also
+ * have get_kv_block_size and get_num_kv_blocks metadata methods. Prompts are
+ * then admitted once their blocks are available, and a sequence that can't
+ * get a block to grow fails with MemoryAllocationFailed.
+ *
+ * If the model has a get_num_lora_adapters metadata method, forward takes the
+ * LoRA adapter of every row, a [max_batch_size] Long tensor with -1 for none,
+ * as its last input (see llama::lora_bgmv), and generate_with_adapter()
+ * picks the adapter of a sequence. Sequences of different adapters are then
+ * decoded in the same steps.
+ *
+ * generate() blocks until its own sequence is done. The waiting callers take
+ * turns running the steps, and each call's callbacks run on its own thread.
+ */
+class ET_EXPERIMENTAL BatchedTextRunner : public IRunner {
+ public:
+  /**
+   * @param module The LLM Module.
+   * @param tokenizer A loaded tokenizer for the model.
+   * @param max_batch_size The number of rows of the model's inputs, which is
+   * how many sequences are decoded at once.
+   * @param temperature The sampling temperature.
+   */
+  BatchedTextRunner(
+      std::unique_ptr<Module> module,
+      std::unique_ptr<::tokenizers::Tokenizer> tokenizer,
+      int32_t max_batch_size,
+      float temperature = 0.8f);
+
+  bool is_loaded() const override;
+
+  ::executorch::runtime::Error load() override;
+
+  /**
+   * Generates text for one prompt, decoded alongside the prompts of any
+   * other concurrent calls. Safe to call from many threads at once.
+   * @param prompt The prompt.
+   * @param seq_len The total number of tokens, including the prompt, to stop
+   * at. Clamped to the model's max context length.
+   * @param token_callback Called with the prompt if echo is set, and then
+   * with the text of each generated token.
+   * @param stats_callback Called with the stats of this call at the end.
+   * @param echo Whether to pass the prompt to token_callback.
+   * @param warming If set, neither callback is called.
+   * @return The error code.
+   */
+  ::executorch::runtime::Error generate(
+      const std::string& prompt,
+      int32_t seq_len,
+      std::function<void(const std::string&)> token_callback = {},
+      std::function<void(const ::executorch::extension::llm::Stats&)>
+          stats_callback = {},
+      bool echo = true,
+      bool warming = false) override;
+
+  /**
+   * Like generate(), with the sequence using one of the model's LoRA
+   * adapters.
+   * @param adapter The index of the adapter in the model's bank, or -1 for
+   * the base model.
+   * @return InvalidArgument if the model has no such adapter, or the error
+   * code of the generation.
+   */
+  ::executorch::runtime::Error generate_with_adapter(
+      const std::string& prompt,
+      int32_t adapter,
+      int32_t seq_len,
+      std::function<void(const std::string&)> token_callback = {},
+      std::function<void(const ::executorch::extension::llm::Stats&)>
+          stats_callback = {},
+      bool echo = true,
+      bool warming = false);
+
+  /**
+   * Stops every queued and active sequence. Their generate() calls return
+   * the text generated so far.
+   */
+  void stop() override;
+
+ private:
+  struct Sequence;
+
+  // Runs one step of the model over the active sequences, after admitting
+  // waiting ones into free rows. Called without mutex_ held, by the one
+  // caller of generate() that is driving.
+  ::executorch::runtime::Error step();
+
+  // Marks the sequence in `row` done and frees the row. mutex_ must be held.
+  void retire_locked(size_t row, ::executorch::runtime::Error error);
+
+  // Makes sure `row` has KV cache blocks for num_positions positions, if the
+  // cache is paged. mutex_ must be held.
+  bool reserve_blocks_locked(size_t row, int64_t num_positions);
+
+  std::unique_ptr<Module> module_;
+  std::unique_ptr<::tokenizers::Tokenizer> tokenizer_;
+  std::unique_ptr<TextDecoderRunner> text_decoder_runner_;
+  std::unordered_set<uint64_t> eos_ids_;
+  const int32_t max_batch_size_;
+  const float temperature_;
+  int64_t max_context_len_ = 128;
+  // Only set if the KV cache is paged.
+  std::unique_ptr<KVBlockAllocator> kv_block_allocator_;
+  TensorPtr block_table_;
+  // The number of LoRA adapters of the model, 0 if it has none.
+  int64_t num_lora_adapters_ = 0;
+  TensorPtr adapter_ids_tensor_;
+
+  // Guards everything below, and the state of every sequence.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Whether one of the generate() calls is running a step.
+  bool driving_ = false;
+  std::deque<std::shared_ptr<Sequence>> waiting_;
+  // The sequence decoded in each row of the batch; null for free rows.
+  std::vector<std::shared_ptr<Sequence>> rows_;
+
+  // Inputs of the next step, only touched by the driving caller.
+  std::vector<int64_t> tokens_;
+  std::vector<int64_t> start_pos_;
+  // Bound as the last input of forward if the model has LoRA adapters.
+  std::vector<int64_t> adapter_ids_;
+  // Recycles the input tensors of every step.
+  TensorPool tensor_pool_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
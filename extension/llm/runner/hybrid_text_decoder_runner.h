@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Run prefill and decode with separate methods, e.g. delegated to different
+// backends, that share one set of static KV caches.
+
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/llm/runner/static_kv_cache.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * The inputs and outputs of a method that HybridTextDecoderRunner runs. The
+ * method takes a fixed number of tokens, and reads and writes the KV caches
+ * as explicit inputs and outputs, as StaticKVCache expects.
+ */
+struct HybridMethodConfig {
+  // The name of the method in its Module.
+  std::string method_name;
+  // The number of tokens the method takes per step. Shorter inputs are
+  // padded.
+  int64_t input_len = 1;
+  // The index of the [1, input_len] Long or Int tokens input.
+  size_t tokens_input_index = 0;
+  // The index of the logits output, of shape [1, input_len, vocab_size]. A
+  // [1, vocab_size] output only holds the logits of the last token, so the
+  // inputs of the method must then not be padded.
+  size_t logits_output_index = 0;
+  std::vector<size_t> k_cache_input_indices;
+  std::vector<size_t> k_cache_output_indices;
+  std::vector<size_t> v_cache_input_indices;
+  std::vector<size_t> v_cache_output_indices;
+  // Whether the K caches of the method are [1, head_dim, cache_len].
+  bool transpose_k_cache = false;
+};
+
+/**
+ * The shape of the KV caches that the methods of a HybridTextDecoderRunner
+ * share. See StaticKVCache.
+ */
+struct HybridKVCacheConfig {
+  // The number of K caches, and of V caches, e.g. one per layer and KV head.
+  size_t n_caches = 0;
+  size_t cache_len = 0;
+  size_t head_dim = 0;
+  StaticKVCacheUpdateStyle style = StaticKVCacheUpdateStyle::kSlidingWindow;
+};
+
+/**
+ * A drop-in for TextDecoderRunner, for TextPrefiller and TextTokenGenerator,
+ * that runs prompts with a prefill method and generates with a decode method,
+ * each of which can be delegated to a different backend, e.g. prefill to the
+ * NPU, where it is compute bound, and decode to the CPU or the GPU, where it
+ * is bandwidth bound. The methods may be in one Module or in two.
+ *
+ * Inputs of more tokens than the decode method takes run through the prefill
+ * method, in chunks of its input length, and the others through the decode
+ * method. The methods read the caches from and write them to StaticKVCaches
+ * that the runner owns, without copying them between steps or between the
+ * methods, and only convert the layout of the K caches when the next method
+ * expects another one, which needs kDoubleBuffer updates. Allocating the
+ * caches with a backend's shared memory, e.g. with
+ * backends/qualcomm/runtime/SharedBufferAllocator.h for QNN, lets that
+ * backend access them in place as well. With kSlidingWindow updates, the
+ * cache inputs move with every step, so such a backend registers new
+ * addresses every step.
+ *
+ * The caches are only ever appended to, so start_pos must be the number of
+ * tokens that ran since the last reset(), or 0 to reset the caches.
+ *
+ * @tparam T The type of the cache elements, e.g. float, or uint8_t for
+ * quantized caches.
+ * @tparam AllocatorT The allocator of the cache memory.
+ */
+template <typename T, typename AllocatorT = std::allocator<T>>
+class ET_EXPERIMENTAL HybridTextDecoderRunner : public TextDecoderRunner {
+ public:
+  /**
+   * Sets the inputs of a method other than the tokens and the KV caches,
+   * e.g. attention masks or RoPE tables, before each step of num_tokens
+   * tokens at position pos.
+   */
+  using SetInputsFn = std::function<::executorch::runtime::Error(
+      Module& module,
+      const HybridMethodConfig& method,
+      int64_t pos,
+      int64_t num_tokens)>;
+
+  /**
+   * @param prefill_module The Module of the prefill method.
+   * @param prefill The prefill method.
+   * @param decode_module The Module of the decode method, which may be
+   * prefill_module.
+   * @param decode The decode method.
+   * @param kv_cache The shape of the KV caches.
+   * @param vocab_size The size of the vocabulary.
+   * @param temperature The sampling temperature.
+   * @param set_inputs Sets the other inputs of the methods, if any.
+   */
+  HybridTextDecoderRunner(
+      Module* prefill_module,
+      HybridMethodConfig prefill,
+      Module* decode_module,
+      HybridMethodConfig decode,
+      const HybridKVCacheConfig& kv_cache,
+      int32_t vocab_size,
+      float temperature,
+      SetInputsFn set_inputs = nullptr)
+      : TextDecoderRunner(
+            decode_module,
+            /*use_kv_cache=*/true,
+            vocab_size,
+            temperature),
+        prefill_(prefill_module, std::move(prefill)),
+        decode_(decode_module, std::move(decode)),
+        kv_cache_(kv_cache),
+        k_caches_(
+            kv_cache.n_caches,
+            kv_cache.cache_len,
+            kv_cache.head_dim,
+            max_input_len(),
+            /*transpose=*/false,
+            kv_cache.style),
+        v_caches_(
+            kv_cache.n_caches,
+            kv_cache.cache_len,
+            kv_cache.head_dim,
+            max_input_len(),
+            /*transpose=*/false,
+            kv_cache.style),
+        set_inputs_(std::move(set_inputs)) {}
+
+  /**
+   * Loads both methods and binds their tokens and KV cache inputs and
+   * outputs.
+   * @return The error code.
+   */
+  ::executorch::runtime::Error load() override {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        prefill_.module->load_method(prefill_.config.method_name));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        decode_.module->load_method(decode_.config.method_name));
+    ET_CHECK_OK_OR_RETURN_ERROR(bind(prefill_));
+    ET_CHECK_OK_OR_RETURN_ERROR(bind(decode_));
+    reset();
+    // The caches hold no data yet, so start in the layout of the prefill.
+    return k_caches_.set_transpose(prefill_.config.transpose_k_cache);
+  }
+
+  bool is_method_loaded() override {
+    return !prefill_.tokens_data.empty() && !decode_.tokens_data.empty() &&
+        prefill_.module->is_method_loaded(prefill_.config.method_name) &&
+        decode_.module->is_method_loaded(decode_.config.method_name);
+  }
+
+  /**
+   * Runs the tokens through the prefill or the decode method.
+   * @param tokens The [1, num_tokens] Long tokens.
+   * @param start_pos The position of the first of the tokens.
+   * @return The logits of the last of the tokens, as a tensor of the rank of
+   * the logits output of the method.
+   */
+  ::executorch::runtime::Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override {
+    const int64_t pos = start_pos->const_data_ptr<int64_t>()[0];
+    if (pos == 0) {
+      reset();
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        pos == pos_,
+        InvalidArgument,
+        "Expected start_pos %" PRId64 ", got %" PRId64
+        "; the caches can only be appended to.",
+        pos_,
+        pos);
+    const int64_t num_tokens = tokens->numel();
+    ET_CHECK_OR_RETURN_ERROR(
+        num_tokens > 0, InvalidArgument, "No tokens to run.");
+    MethodState& method =
+        num_tokens > decode_.config.input_len ? prefill_ : decode_;
+    const int64_t input_len = method.config.input_len;
+    const int64_t* data = tokens->const_data_ptr<int64_t>();
+    int64_t offset = 0;
+    for (; num_tokens - offset > input_len; offset += input_len) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          run(method, data + offset, input_len).error());
+    }
+    // Only the logits of the last chunk are needed.
+    return run(method, data + offset, num_tokens - offset);
+  }
+
+  /**
+   * Empties the KV caches.
+   */
+  void reset() {
+    k_caches_.reset();
+    v_caches_.reset();
+    pos_ = 0;
+  }
+
+ private:
+  struct MethodState {
+    MethodState(Module* module, HybridMethodConfig config)
+        : module(module), config(std::move(config)) {}
+
+    Module* module;
+    HybridMethodConfig config;
+    // The padded tokens of a step, in the type of the tokens input.
+    std::vector<int64_t> tokens_data;
+    TensorPtr tokens;
+    // Views of the cache data, which are pointed at the data of the caches
+    // before each step.
+    std::vector<TensorPtr> k_inputs;
+    std::vector<TensorPtr> k_outputs;
+    std::vector<TensorPtr> v_inputs;
+    std::vector<TensorPtr> v_outputs;
+    // The logits of the last token of the last step.
+    TensorPtr logits;
+  };
+
+  size_t max_input_len() const {
+    return static_cast<size_t>(
+        std::max(prefill_.config.input_len, decode_.config.input_len));
+  }
+
+  // Binds the tokens input and the cache inputs and outputs of the method to
+  // the runner's memory.
+  ::executorch::runtime::Error bind(MethodState& method) {
+    const HybridMethodConfig& config = method.config;
+    Module& module = *method.module;
+    const auto method_meta = module.method_meta(config.method_name);
+    ET_CHECK_OK_OR_RETURN_ERROR(method_meta.error());
+    ET_CHECK_OR_RETURN_ERROR(
+        config.input_len > 0,
+        InvalidArgument,
+        "Method %s must take at least one token.",
+        config.method_name.c_str());
+
+    const auto tokens_meta =
+        method_meta->input_tensor_meta(config.tokens_input_index);
+    ET_CHECK_OK_OR_RETURN_ERROR(tokens_meta.error());
+    const auto tokens_type = tokens_meta->scalar_type();
+    ET_CHECK_OR_RETURN_ERROR(
+        tokens_type == executorch::aten::ScalarType::Long ||
+            tokens_type == executorch::aten::ScalarType::Int,
+        InvalidArgument,
+        "The tokens of method %s must be Long or Int.",
+        config.method_name.c_str());
+    ET_CHECK_OR_RETURN_ERROR(
+        tokens_meta->nbytes() ==
+            config.input_len * executorch::runtime::elementSize(tokens_type),
+        InvalidArgument,
+        "Method %s takes a different number of tokens than %" PRId64 ".",
+        config.method_name.c_str(),
+        config.input_len);
+    method.tokens_data.assign(config.input_len, 0);
+    method.tokens = from_blob(
+        method.tokens_data.data(),
+        {1, static_cast<executorch::aten::SizesType>(config.input_len)},
+        tokens_type);
+    ET_CHECK_OK_OR_RETURN_ERROR(module.bind_input(
+        config.method_name, *method.tokens, config.tokens_input_index));
+
+    const size_t cache_numel = kv_cache_.cache_len * kv_cache_.head_dim;
+    const size_t update_numel =
+        kv_cache_.style == StaticKVCacheUpdateStyle::kDoubleBuffer
+        ? cache_numel
+        : max_input_len() * kv_cache_.head_dim;
+    ET_CHECK_OK_OR_RETURN_ERROR(bind_caches(
+        method,
+        config.k_cache_input_indices,
+        /*is_input=*/true,
+        cache_numel,
+        method.k_inputs));
+    ET_CHECK_OK_OR_RETURN_ERROR(bind_caches(
+        method,
+        config.k_cache_output_indices,
+        /*is_input=*/false,
+        update_numel,
+        method.k_outputs));
+    ET_CHECK_OK_OR_RETURN_ERROR(bind_caches(
+        method,
+        config.v_cache_input_indices,
+        /*is_input=*/true,
+        cache_numel,
+        method.v_inputs));
+    ET_CHECK_OK_OR_RETURN_ERROR(bind_caches(
+        method,
+        config.v_cache_output_indices,
+        /*is_input=*/false,
+        update_numel,
+        method.v_outputs));
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  // Binds the cache inputs or outputs at the indices to views that hold up
+  // to max_numel elements, which run() points at the caches.
+  ::executorch::runtime::Error bind_caches(
+      MethodState& method,
+      const std::vector<size_t>& indices,
+      bool is_input,
+      size_t max_numel,
+      std::vector<TensorPtr>& views) {
+    const HybridMethodConfig& config = method.config;
+    Module& module = *method.module;
+    ET_CHECK_OR_RETURN_ERROR(
+        indices.size() == kv_cache_.n_caches,
+        InvalidArgument,
+        "Method %s has %zu cache %s, expected %zu.",
+        config.method_name.c_str(),
+        indices.size(),
+        is_input ? "inputs" : "outputs",
+        kv_cache_.n_caches);
+    const auto method_meta = module.method_meta(config.method_name);
+    ET_CHECK_OK_OR_RETURN_ERROR(method_meta.error());
+    views.clear();
+    for (size_t index : indices) {
+      const auto meta = is_input ? method_meta->input_tensor_meta(index)
+                                 : method_meta->output_tensor_meta(index);
+      ET_CHECK_OK_OR_RETURN_ERROR(meta.error());
+      const size_t element_size =
+          executorch::runtime::elementSize(meta->scalar_type());
+      ET_CHECK_OR_RETURN_ERROR(
+          element_size == sizeof(T) && meta->nbytes() <= max_numel * sizeof(T),
+          InvalidArgument,
+          "Cache %s %zu of method %s doesn't fit the caches.",
+          is_input ? "input" : "output",
+          index,
+          config.method_name.c_str());
+      const auto sizes = meta->sizes();
+      // The data is set by run(), before each step.
+      views.push_back(from_blob(
+          k_caches_.input_data(0),
+          std::vector<executorch::aten::SizesType>(sizes.begin(), sizes.end()),
+          meta->scalar_type()));
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          is_input
+              ? module.bind_input(config.method_name, *views.back(), index)
+              : module.bind_output(config.method_name, *views.back(), index));
+    }
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  // Runs one step of up to input_len tokens of the method.
+  ::executorch::runtime::Result<executorch::aten::Tensor>
+  run(MethodState& method, const int64_t* tokens, int64_t num_tokens) {
+    const HybridMethodConfig& config = method.config;
+    if (method.tokens->scalar_type() == executorch::aten::ScalarType::Int) {
+      auto* data = reinterpret_cast<int32_t*>(method.tokens_data.data());
+      std::fill(data, data + config.input_len, 0);
+      for (int64_t i = 0; i < num_tokens; ++i) {
+        data[i] = static_cast<int32_t>(tokens[i]);
+      }
+    } else {
+      std::fill(method.tokens_data.begin(), method.tokens_data.end(), 0);
+      std::copy(tokens, tokens + num_tokens, method.tokens_data.begin());
+    }
+
+    // A no-op unless the other method left the K caches in another layout.
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        k_caches_.set_transpose(config.transpose_k_cache));
+    for (size_t i = 0; i < kv_cache_.n_caches; ++i) {
+      method.k_inputs[i]->unsafeGetTensorImpl()->set_data(
+          k_caches_.input_data(i));
+      method.k_outputs[i]->unsafeGetTensorImpl()->set_data(
+          k_caches_.output_data(i));
+      method.v_inputs[i]->unsafeGetTensorImpl()->set_data(
+          v_caches_.input_data(i));
+      method.v_outputs[i]->unsafeGetTensorImpl()->set_data(
+          v_caches_.output_data(i));
+    }
+    if (set_inputs_) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          set_inputs_(*method.module, config, pos_, num_tokens));
+    }
+
+    auto outputs = method.module->execute(config.method_name);
+    ET_CHECK_OK_OR_RETURN_ERROR(outputs.error());
+    ET_CHECK_OK_OR_RETURN_ERROR(k_caches_.update(num_tokens));
+    ET_CHECK_OK_OR_RETURN_ERROR(v_caches_.update(num_tokens));
+    pos_ += num_tokens;
+
+    ET_CHECK_OR_RETURN_ERROR(
+        config.logits_output_index < outputs->size() &&
+            outputs->at(config.logits_output_index).isTensor(),
+        InvalidArgument,
+        "Method %s has no logits output %zu.",
+        config.method_name.c_str(),
+        config.logits_output_index);
+    const auto& logits = outputs->at(config.logits_output_index).toTensor();
+    // Logits of [1, vocab_size] or tokens of [1] are of the last token.
+    const bool per_token = logits.dim() == 3 ||
+        (logits.dim() == 2 &&
+         logits.scalar_type() == executorch::aten::ScalarType::Long);
+    if (!per_token) {
+      ET_CHECK_OR_RETURN_ERROR(
+          num_tokens == config.input_len,
+          InvalidArgument,
+          "Method %s only returns the logits of its last token, so it can't "
+          "take padded inputs.",
+          config.method_name.c_str());
+      return logits;
+    }
+    // Return the logits of the last token that isn't padding.
+    std::vector<executorch::aten::SizesType> sizes(
+        logits.sizes().begin(), logits.sizes().end());
+    const size_t token_nbytes = logits.nbytes() / sizes[1];
+    sizes[1] = 1;
+    method.logits = from_blob(
+        static_cast<uint8_t*>(logits.mutable_data_ptr()) +
+            (num_tokens - 1) * token_nbytes,
+        std::move(sizes),
+        logits.scalar_type());
+    return *method.logits;
+  }
+
+  MethodState prefill_;
+  MethodState decode_;
+  HybridKVCacheConfig kv_cache_;
+  StaticKVCache<T, AllocatorT> k_caches_;
+  StaticKVCache<T, AllocatorT> v_caches_;
+  SetInputsFn set_inputs_;
+  // The number of tokens in the caches.
+  int64_t pos_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
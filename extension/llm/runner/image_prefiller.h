@@ -12,6 +12,7 @@
 
 #include <executorch/extension/llm/runner/image.h>
 #include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace executorch {
@@ -35,6 +36,33 @@ class ET_EXPERIMENTAL ImagePrefiller {
       Image& image,
       int64_t& start_pos) = 0;
 
+  /**
+   * Encode an image into the embeddings that prefill() feeds to the LLM,
+   * without touching its KV cache. Prefillers that implement this and
+   * prefill_embeddings() can be pipelined with PipelinedImagePrefiller, so
+   * this must be safe to call while the LLM runs on another thread.
+   * @param image The image input to the multimodal LLM.
+   * @return The embeddings of the image, owned by the caller.
+   */
+  virtual ::executorch::runtime::Result<TensorPtr> encode(Image& image) {
+    (void)image;
+    return ::executorch::runtime::Error::NotSupported;
+  }
+
+  /**
+   * Prefill an LLM Module with the embeddings of an image from encode().
+   * @param embeddings The embeddings of the image.
+   * @param start_pos The starting position in KV cache of the input in the LLM.
+   * It's passed as reference and will be updated inside this function.
+   * @return The next token of the LLM Module after prefill.
+   */
+  virtual ::executorch::runtime::Result<executorch::aten::Tensor>
+  prefill_embeddings(const TensorPtr& embeddings, int64_t& start_pos) {
+    (void)embeddings;
+    (void)start_pos;
+    return ::executorch::runtime::Error::NotSupported;
+  }
+
   virtual ::executorch::runtime::Error load() = 0;
   virtual bool is_method_loaded() = 0;
 
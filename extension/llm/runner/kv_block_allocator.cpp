@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/kv_block_allocator.h>
+
+#include <cinttypes>
+
+#include <executorch/runtime/core/error.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+
+KVBlockAllocator::KVBlockAllocator(
+    int64_t num_blocks,
+    int64_t block_size,
+    int32_t max_batch_size,
+    int64_t max_blocks_per_row)
+    : block_size_(block_size),
+      max_blocks_per_row_(max_blocks_per_row),
+      block_table_(max_batch_size * max_blocks_per_row, 0),
+      num_row_blocks_(max_batch_size, 0) {
+  // Hand out the lowest blocks first.
+  for (int64_t block = num_blocks - 1; block > 0; --block) {
+    free_blocks_.push_back(block);
+  }
+}
+
+Error KVBlockAllocator::reserve(int32_t row, int64_t num_positions) {
+  const int64_t needed = (num_positions + block_size_ - 1) / block_size_;
+  ET_CHECK_OR_RETURN_ERROR(
+      needed <= max_blocks_per_row_,
+      InvalidArgument,
+      "%" PRId64 " positions need more than %" PRId64 " blocks",
+      num_positions,
+      max_blocks_per_row_);
+  int64_t& held = num_row_blocks_[row];
+  if (needed <= held) {
+    return Error::Ok;
+  }
+  if (needed - held > num_free_blocks()) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (; held < needed; ++held) {
+    block_table_[row * max_blocks_per_row_ + held] = free_blocks_.back();
+    free_blocks_.pop_back();
+  }
+  return Error::Ok;
+}
+
+void KVBlockAllocator::release(int32_t row) {
+  int64_t& held = num_row_blocks_[row];
+  for (; held > 0; --held) {
+    int64_t& entry = block_table_[row * max_blocks_per_row_ + held - 1];
+    free_blocks_.push_back(entry);
+    entry = 0;
+  }
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Hands out the blocks of a paged KV cache to the rows of a batch.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Owns the block table of a paged KV cache, the layout used by
+ * llama::sdpa_with_paged_kv_cache and llama::update_cache_paged: a pool of
+ * num_blocks blocks of block_size positions each, shared by every row of the
+ * batch. A row only takes blocks as it grows, so the rows together can hold
+ * more context than a contiguous cache of the same size would give each of
+ * them.
+ *
+ * Block 0 is never handed out. Every block table entry without a block
+ * points to it, so that free rows, which still run through the model, write
+ * their dummy tokens somewhere harmless.
+ */
+class ET_EXPERIMENTAL KVBlockAllocator {
+ public:
+  /**
+   * @param num_blocks The number of blocks in the pool, including block 0.
+   * @param block_size The number of positions per block.
+   * @param max_batch_size The number of rows of the block table.
+   * @param max_blocks_per_row The number of columns of the block table.
+   */
+  KVBlockAllocator(
+      int64_t num_blocks,
+      int64_t block_size,
+      int32_t max_batch_size,
+      int64_t max_blocks_per_row);
+
+  /**
+   * Makes sure that positions [0, num_positions) of a row have blocks.
+   *
+   * @return MemoryAllocationFailed without taking any block if the pool
+   * doesn't have enough free blocks left, and InvalidArgument if the row's
+   * block table is too short.
+   */
+  ::executorch::runtime::Error reserve(int32_t row, int64_t num_positions);
+
+  /// Returns all the blocks of a row to the pool.
+  void release(int32_t row);
+
+  int64_t num_free_blocks() const {
+    return static_cast<int64_t>(free_blocks_.size());
+  }
+
+  int64_t block_size() const {
+    return block_size_;
+  }
+
+  /// The [max_batch_size, max_blocks_per_row] block table, row major. The
+  /// address stays the same for the lifetime of the allocator.
+  int64_t* block_table() {
+    return block_table_.data();
+  }
+
+ private:
+  const int64_t block_size_;
+  const int64_t max_blocks_per_row_;
+  std::vector<int64_t> block_table_;
+  // Number of blocks held by each row.
+  std::vector<int64_t> num_row_blocks_;
+  std::vector<int64_t> free_blocks_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
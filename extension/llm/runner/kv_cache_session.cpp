@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/kv_cache_session.h>
+
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::DataLoader;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+// The size of the data up to its last nonzero byte.
+size_t stored_size(const uint8_t* data, size_t nbytes) {
+  size_t end = nbytes;
+  while (end >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + end - sizeof(word), sizeof(word));
+    if (word != 0) {
+      break;
+    }
+    end -= sizeof(word);
+  }
+  while (end > 0 && data[end - 1] == 0) {
+    --end;
+  }
+  return end;
+}
+} // namespace
+
+Error KVCacheSession::save(
+    const std::string& path,
+    const std::vector<Tensor>& buffers,
+    const std::vector<uint64_t>& tokens) {
+  std::vector<BufferHeader> buffer_headers;
+  buffer_headers.reserve(buffers.size());
+  for (const auto& buffer : buffers) {
+    buffer_headers.push_back(BufferHeader{
+        buffer.nbytes(),
+        stored_size(buffer.const_data_ptr<uint8_t>(), buffer.nbytes()),
+        static_cast<int32_t>(buffer.scalar_type()),
+        0});
+  }
+  const Header header{
+      kMagic,
+      kVersion,
+      static_cast<uint32_t>(buffers.size()),
+      0,
+      tokens.size()};
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  ET_CHECK_OR_RETURN_ERROR(
+      file.is_open(), AccessFailed, "Failed to open %s", path.c_str());
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(
+      reinterpret_cast<const char*>(tokens.data()),
+      tokens.size() * sizeof(uint64_t));
+  file.write(
+      reinterpret_cast<const char*>(buffer_headers.data()),
+      buffer_headers.size() * sizeof(BufferHeader));
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    file.write(
+        buffers[i].const_data_ptr<char>(), buffer_headers[i].stored_nbytes);
+  }
+  file.close();
+  ET_CHECK_OR_RETURN_ERROR(
+      !file.fail(), AccessFailed, "Failed to write %s", path.c_str());
+  return Error::Ok;
+}
+
+Result<std::vector<uint64_t>> KVCacheSession::load(
+    const std::string& path,
+    const std::vector<Tensor>& buffers) {
+  auto loader = ET_UNWRAP(FileDataLoader::from(path.c_str()));
+  const auto file_size = ET_UNWRAP(loader.size());
+  const DataLoader::SegmentInfo segment_info(
+      DataLoader::SegmentInfo::Type::Mutable);
+
+  Header header;
+  ET_CHECK_OR_RETURN_ERROR(
+      file_size >= sizeof(header),
+      InvalidArgument,
+      "%s is too small for a session",
+      path.c_str());
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      loader.load_into(0, sizeof(header), segment_info, &header));
+  ET_CHECK_OR_RETURN_ERROR(
+      header.magic == kMagic && header.version == kVersion,
+      InvalidArgument,
+      "%s is not a session of version %" PRIu32,
+      path.c_str(),
+      kVersion);
+  ET_CHECK_OR_RETURN_ERROR(
+      header.num_buffers == buffers.size(),
+      InvalidArgument,
+      "Session has %" PRIu32 " buffers, expected %zu",
+      header.num_buffers,
+      buffers.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      header.num_tokens <= (file_size - sizeof(header)) / sizeof(uint64_t),
+      InvalidArgument,
+      "Session has more tokens than fit in %s",
+      path.c_str());
+
+  std::vector<uint64_t> tokens(header.num_tokens);
+  size_t offset = sizeof(header);
+  ET_CHECK_OK_OR_RETURN_ERROR(loader.load_into(
+      offset, tokens.size() * sizeof(uint64_t), segment_info, tokens.data()));
+  offset += tokens.size() * sizeof(uint64_t);
+
+  std::vector<BufferHeader> buffer_headers(header.num_buffers);
+  ET_CHECK_OR_RETURN_ERROR(
+      file_size - offset >= buffer_headers.size() * sizeof(BufferHeader),
+      InvalidArgument,
+      "%s is truncated",
+      path.c_str());
+  ET_CHECK_OK_OR_RETURN_ERROR(loader.load_into(
+      offset,
+      buffer_headers.size() * sizeof(BufferHeader),
+      segment_info,
+      buffer_headers.data()));
+  offset += buffer_headers.size() * sizeof(BufferHeader);
+
+  // Check everything before touching any buffer.
+  size_t data_size = 0;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    const auto& buffer_header = buffer_headers[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer_header.nbytes == buffers[i].nbytes() &&
+            buffer_header.scalar_type ==
+                static_cast<int32_t>(buffers[i].scalar_type()),
+        InvalidArgument,
+        "Buffer %zu of the session has %" PRIu64
+        " bytes of type %" PRId32 ", expected %zu bytes of type %" PRId32,
+        i,
+        buffer_header.nbytes,
+        buffer_header.scalar_type,
+        buffers[i].nbytes(),
+        static_cast<int32_t>(buffers[i].scalar_type()));
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer_header.stored_nbytes <= buffer_header.nbytes &&
+            buffer_header.stored_nbytes <= file_size - offset - data_size,
+        InvalidArgument,
+        "%s is truncated",
+        path.c_str());
+    data_size += buffer_header.stored_nbytes;
+  }
+
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    auto* data = buffers[i].mutable_data_ptr<uint8_t>();
+    const size_t stored_nbytes = buffer_headers[i].stored_nbytes;
+    if (stored_nbytes > 0) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          loader.load_into(offset, stored_nbytes, segment_info, data));
+    }
+    std::memset(data + stored_nbytes, 0, buffers[i].nbytes() - stored_nbytes);
+    offset += stored_nbytes;
+  }
+  return tokens;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
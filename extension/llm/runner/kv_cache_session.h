@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Saves the KV cache of a conversation to a file and restores it, so that the
+// conversation resumes without prefilling it again.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * A session is the state of the mutable buffers of a method, like its KV
+ * caches (see Module::mutable_buffers()), together with the tokens whose keys
+ * and values they hold. Restoring a session reads the file straight into the
+ * buffers, which is much faster than running the tokens through the model
+ * again.
+ *
+ * The file is in the byte order of the device, and made of:
+ * - a Header;
+ * - uint64_t tokens[num_tokens];
+ * - BufferHeader buffers[num_buffers];
+ * - the stored bytes of each buffer, one after the other.
+ *
+ * Only the bytes of a buffer up to its last nonzero byte are stored, and the
+ * rest is zeroed when restoring. A cache that is laid out position major and
+ * was never filled past the session therefore only takes the space of the
+ * positions in use.
+ */
+class ET_EXPERIMENTAL KVCacheSession {
+ public:
+  static constexpr uint32_t kMagic = 0x53564B00; // "\0KVS"
+  static constexpr uint32_t kVersion = 1;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_buffers;
+    uint32_t reserved;
+    uint64_t num_tokens;
+  };
+
+  struct BufferHeader {
+    uint64_t nbytes;
+    uint64_t stored_nbytes;
+    int32_t scalar_type;
+    uint32_t reserved;
+  };
+
+  /**
+   * Writes the buffers and the tokens to the file at the path, replacing it.
+   *
+   * @retval Error::AccessFailed if the file could not be written.
+   */
+  static ::executorch::runtime::Error save(
+      const std::string& path,
+      const std::vector<executorch::aten::Tensor>& buffers,
+      const std::vector<uint64_t>& tokens);
+
+  /**
+   * Reads the file at the path into the buffers, which must have the sizes
+   * and types of the saved ones.
+   *
+   * @returns The saved tokens.
+   * @retval Error::InvalidArgument, leaving the buffers untouched, if the
+   * file is not a session or was saved from other buffers. If reading the
+   * file fails midway, the content of the buffers is undefined.
+   */
+  static ::executorch::runtime::Result<std::vector<uint64_t>> load(
+      const std::string& path,
+      const std::vector<executorch::aten::Tensor>& buffers);
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
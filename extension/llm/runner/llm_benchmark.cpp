@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/llm_benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <sstream>
+
+#include <executorch/extension/llm/runner/util.h>
+
+using ::executorch::extension::DeviceMonitor;
+using ::executorch::extension::DeviceSample;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_between(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Nearest-rank percentile of the sorted values, 0 if there are none.
+double percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.5);
+  rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+  return sorted[rank - 1];
+}
+
+// Writes the fields that are set as "name":value, each followed by a comma.
+void write_optional(
+    std::stringstream& ss,
+    const char* name,
+    const std::optional<double>& value) {
+  if (value) {
+    ss << "\"" << name << "\":" << *value << ",";
+  }
+}
+
+struct RunMeasurement {
+  int64_t num_prompt_tokens = 0;
+  int64_t num_generated_tokens = 0;
+  double ttft_ms = 0;
+  double decode_ms = 0;
+  std::vector<double> token_latencies_ms;
+};
+
+Error measure_run(
+    IRunner& runner,
+    const std::string& prompt,
+    int32_t seq_len,
+    bool warming,
+    RunMeasurement& measurement) {
+  std::vector<Clock::time_point> token_times;
+  const Clock::time_point start = Clock::now();
+  Error error = runner.generate(
+      prompt,
+      seq_len,
+      [&](const std::string&) { token_times.push_back(Clock::now()); },
+      [&](const Stats& stats) {
+        measurement.num_prompt_tokens = stats.num_prompt_tokens;
+        measurement.num_generated_tokens = stats.num_generated_tokens;
+      },
+      /*echo=*/false,
+      warming);
+  if (error != Error::Ok || token_times.empty()) {
+    return error;
+  }
+  measurement.ttft_ms = ms_between(start, token_times.front());
+  measurement.decode_ms = ms_between(token_times.front(), token_times.back());
+  for (size_t i = 1; i < token_times.size(); ++i) {
+    measurement.token_latencies_ms.push_back(
+        ms_between(token_times[i - 1], token_times[i]));
+  }
+  return Error::Ok;
+}
+
+} // namespace
+
+std::string make_synthetic_prompt(int32_t num_words, int32_t seed) {
+  static constexpr const char* kWords[] = {
+      "the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog"};
+  constexpr size_t kNumWords = sizeof(kWords) / sizeof(kWords[0]);
+  std::string prompt = std::to_string(seed) + ".";
+  for (int32_t i = 1; i < num_words; ++i) {
+    prompt += " ";
+    prompt += kWords[i % kNumWords];
+  }
+  return prompt;
+}
+
+Result<std::vector<LlmBenchmarkResult>> run_llm_benchmark(
+    IRunner& runner,
+    const LlmBenchmarkConfig& config) {
+  if (!runner.is_loaded()) {
+    Error error = runner.load();
+    if (error != Error::Ok) {
+      ET_LOG(Error, "Failed to load the runner: 0x%" PRIx32, (uint32_t)error);
+      return error;
+    }
+  }
+
+  std::vector<LlmBenchmarkResult> results;
+  int32_t seed = 0;
+  for (int32_t num_threads : config.thread_counts) {
+    if (config.set_num_threads) {
+      config.set_num_threads(num_threads);
+    }
+    for (int32_t prompt_length : config.prompt_lengths) {
+      for (int32_t generation_length : config.generation_lengths) {
+        const int32_t seq_len = prompt_length + generation_length;
+        for (int32_t i = 0; i < config.num_warmup_runs; ++i) {
+          RunMeasurement warmup;
+          Error error = measure_run(
+              runner,
+              make_synthetic_prompt(prompt_length, seed++),
+              seq_len,
+              /*warming=*/true,
+              warmup);
+          if (error != Error::Ok) {
+            return error;
+          }
+        }
+
+        LlmBenchmarkResult result{};
+        result.prompt_length = prompt_length;
+        result.generation_length = generation_length;
+        result.num_threads = num_threads;
+        result.num_runs = config.num_runs;
+        std::vector<double> token_latencies_ms;
+        int64_t max_tokens = 0;
+        DeviceMonitor device_monitor;
+        std::vector<DeviceSample> device_samples = {device_monitor.sample()};
+        for (int32_t i = 0; i < config.num_runs; ++i) {
+          RunMeasurement run;
+          Error error = measure_run(
+              runner,
+              make_synthetic_prompt(prompt_length, seed++),
+              seq_len,
+              /*warming=*/false,
+              run);
+          if (error != Error::Ok) {
+            return error;
+          }
+          device_samples.push_back(device_monitor.sample());
+          result.run_samples.push_back(
+              {device_samples.back(),
+               run.ttft_ms,
+               run.decode_ms > 0
+                   ? run.token_latencies_ms.size() / run.decode_ms * 1000
+                   : 0});
+          result.num_prompt_tokens += run.num_prompt_tokens;
+          result.num_generated_tokens += run.num_generated_tokens;
+          result.ttft_ms += run.ttft_ms;
+          if (run.ttft_ms > 0) {
+            result.prefill_tokens_per_second +=
+                run.num_prompt_tokens / run.ttft_ms * 1000;
+          }
+          result.decode_tokens_per_second +=
+              result.run_samples.back().decode_tokens_per_second;
+          token_latencies_ms.insert(
+              token_latencies_ms.end(),
+              run.token_latencies_ms.begin(),
+              run.token_latencies_ms.end());
+          max_tokens = std::max(
+              max_tokens, run.num_prompt_tokens + run.num_generated_tokens);
+        }
+        if (config.num_runs > 0) {
+          result.num_prompt_tokens /= config.num_runs;
+          result.num_generated_tokens /= config.num_runs;
+          result.ttft_ms /= config.num_runs;
+          result.prefill_tokens_per_second /= config.num_runs;
+          result.decode_tokens_per_second /= config.num_runs;
+        }
+        std::sort(token_latencies_ms.begin(), token_latencies_ms.end());
+        result.decode_token_latency_p50_ms =
+            percentile(token_latencies_ms, 0.5);
+        result.decode_token_latency_p99_ms =
+            percentile(token_latencies_ms, 0.99);
+        result.peak_rss_bytes = get_rss_bytes();
+        result.kv_cache_bytes = config.kv_cache_bytes_per_token * max_tokens;
+        result.device_summary =
+            ::executorch::extension::summarize_device_samples(device_samples);
+        results.push_back(result);
+      }
+    }
+  }
+  return results;
+}
+
+std::string llm_benchmark_results_to_json(
+    const std::vector<LlmBenchmarkResult>& results) {
+  std::stringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const LlmBenchmarkResult& result = results[i];
+    ss << (i == 0 ? "" : ",") << "{\"prompt_length\":" << result.prompt_length
+       << "," << "\"generation_length\":" << result.generation_length << ","
+       << "\"num_threads\":" << result.num_threads << ","
+       << "\"num_runs\":" << result.num_runs << ","
+       << "\"prompt_tokens\":" << result.num_prompt_tokens << ","
+       << "\"generated_tokens\":" << result.num_generated_tokens << ","
+       << "\"ttft_ms\":" << result.ttft_ms << ","
+       << "\"prefill_tokens_per_second\":" << result.prefill_tokens_per_second
+       << ","
+       << "\"decode_tokens_per_second\":" << result.decode_tokens_per_second
+       << ","
+       << "\"decode_token_latency_p50_ms\":"
+       << result.decode_token_latency_p50_ms << ","
+       << "\"decode_token_latency_p99_ms\":"
+       << result.decode_token_latency_p99_ms << ","
+       << "\"peak_rss_bytes\":" << result.peak_rss_bytes << ","
+       << "\"kv_cache_bytes\":" << result.kv_cache_bytes << ",";
+    const auto& summary = result.device_summary;
+    write_optional(ss, "max_temperature_c", summary.max_temperature_c);
+    write_optional(ss, "min_cpu_freq_mhz", summary.min_cpu_freq_mhz);
+    write_optional(ss, "avg_cpu_freq_mhz", summary.avg_cpu_freq_mhz);
+    write_optional(ss, "min_gpu_freq_mhz", summary.min_gpu_freq_mhz);
+    write_optional(ss, "energy_j", summary.energy_j);
+    write_optional(ss, "avg_power_w", summary.avg_power_w);
+    write_optional(
+        ss, "avg_battery_current_ma", summary.avg_battery_current_ma);
+    ss << "\"run_samples\":[";
+    for (size_t j = 0; j < result.run_samples.size(); ++j) {
+      const auto& sample = result.run_samples[j];
+      ss << (j == 0 ? "" : ",") << "{\"run\":" << j << ","
+         << "\"ttft_ms\":" << sample.ttft_ms << ","
+         << "\"decode_tokens_per_second\":"
+         << sample.decode_tokens_per_second << ",";
+      write_optional(
+          ss, "max_temperature_c", sample.device.max_temperature_c);
+      if (!sample.device.cpu_freq_mhz.empty()) {
+        ss << "\"cpu_freq_mhz\":[";
+        for (size_t cpu = 0; cpu < sample.device.cpu_freq_mhz.size(); ++cpu) {
+          ss << (cpu == 0 ? "" : ",") << sample.device.cpu_freq_mhz[cpu];
+        }
+        ss << "],";
+      }
+      write_optional(ss, "gpu_freq_mhz", sample.device.gpu_freq_mhz);
+      write_optional(ss, "energy_j", sample.device.energy_j);
+      write_optional(
+          ss, "battery_current_ma", sample.device.battery_current_ma);
+      ss << "\"timestamp_ms\":" << sample.device.timestamp_ms << "}";
+    }
+    ss << "]}";
+  }
+  ss << "]";
+  return ss.str();
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Benchmarks an LLM runner over sweeps of prompt lengths, generation lengths
+// and thread counts, with the same metrics for all models and runners.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/runner_util/device_monitor.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+struct ET_EXPERIMENTAL LlmBenchmarkConfig {
+  // Number of words of the synthetic prompts. The number of prompt tokens
+  // depends on the tokenizer, and is reported in the results.
+  std::vector<int32_t> prompt_lengths = {128};
+  // Number of tokens to generate after the prompt. Generation stops earlier
+  // if the model emits an EOS token.
+  std::vector<int32_t> generation_lengths = {128};
+  // Thread counts to sweep. Each one is passed to set_num_threads before its
+  // runs, e.g. to resize the threadpool; ignored if set_num_threads is empty.
+  std::vector<int32_t> thread_counts = {-1};
+  std::function<void(int32_t)> set_num_threads;
+  // Runs of each configuration before the measured ones.
+  int32_t num_warmup_runs = 1;
+  // Measured runs of each configuration.
+  int32_t num_runs = 3;
+  // Bytes of the KV cache per token, i.e. 2 * n_layers * n_kv_heads *
+  // head_dim * sizeof(cache dtype), to report the KV cache the runs used.
+  // 0 if unknown.
+  int64_t kv_cache_bytes_per_token = 0;
+};
+
+struct ET_EXPERIMENTAL LlmBenchmarkResult {
+  int32_t prompt_length;
+  int32_t generation_length;
+  int32_t num_threads;
+  int32_t num_runs;
+  // Averages over the measured runs.
+  double num_prompt_tokens;
+  double num_generated_tokens;
+  // Time to first token, from the generate() call, including tokenization
+  // and prefill.
+  double ttft_ms;
+  double prefill_tokens_per_second;
+  double decode_tokens_per_second;
+  // Percentiles of the latency of each generated token after the first one,
+  // over all the measured runs.
+  double decode_token_latency_p50_ms;
+  double decode_token_latency_p99_ms;
+  // Peak RSS of the process at the end of the runs, 0 if not supported.
+  size_t peak_rss_bytes;
+  // KV cache used by the longest run, 0 if kv_cache_bytes_per_token is 0.
+  int64_t kv_cache_bytes;
+
+  // The state of the device after a measured run, with the timings of that
+  // run, to tell whether the device throttled as the runs went on. The device
+  // isn't sampled during runs, to keep the reads out of the token latencies.
+  struct RunSample {
+    ::executorch::extension::DeviceSample device;
+    double ttft_ms;
+    double decode_tokens_per_second;
+  };
+  std::vector<RunSample> run_samples;
+  // The summary of run_samples and of a sample taken before the first run, so
+  // that the energy covers all the measured runs.
+  ::executorch::extension::DeviceSampleSummary device_summary;
+};
+
+/**
+ * Returns a prompt of num_words words, starting with seed so that prompts of
+ * different runs differ from their first token on. Runners that reuse the KV
+ * cache of a common prompt prefix can't skip any of their prefill then.
+ */
+ET_EXPERIMENTAL std::string make_synthetic_prompt(
+    int32_t num_words,
+    int32_t seed);
+
+/**
+ * Loads the runner if needed, and measures each combination of prompt
+ * length, generation length and thread count of config.
+ *
+ * @returns One result per combination, or the first error that load() or
+ * generate() returned.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Result<std::vector<LlmBenchmarkResult>>
+run_llm_benchmark(IRunner& runner, const LlmBenchmarkConfig& config);
+
+/// Formats the results as a JSON list, with one object per result.
+ET_EXPERIMENTAL std::string llm_benchmark_results_to_json(
+    const std::vector<LlmBenchmarkResult>& results);
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/pipelined_image_prefiller.h>
+
+#include <functional>
+#include <iterator>
+#include <string_view>
+
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+namespace {
+
+uint64_t hash_image(const Image& image) {
+  uint64_t hash = std::hash<std::string_view>{}(std::string_view(
+      reinterpret_cast<const char*>(image.data.data()), image.data.size()));
+  for (const int32_t dim : {image.width, image.height, image.channels}) {
+    hash ^= std::hash<int32_t>{}(dim) + 0x9e3779b97f4a7c15ULL + (hash << 6) +
+        (hash >> 2);
+  }
+  return hash;
+}
+
+} // namespace
+
+PipelinedImagePrefiller::~PipelinedImagePrefiller() {
+  join();
+}
+
+Error PipelinedImagePrefiller::start(std::vector<Image>& images) {
+  join();
+  images_ = &images;
+  embeddings_.clear();
+  embeddings_.reserve(images.size());
+  error_ = Error::Ok;
+  stop_ = false;
+  if (!images.empty()) {
+    worker_ = std::thread(&PipelinedImagePrefiller::encode_images, this);
+  }
+  return Error::Ok;
+}
+
+Error PipelinedImagePrefiller::prefill(int64_t& start_pos) {
+  ET_CHECK_OR_RETURN_ERROR(
+      images_ != nullptr,
+      InvalidState,
+      "start() must be called before prefill()");
+  Error error = Error::Ok;
+  for (size_t i = 0; i < images_->size() && error == Error::Ok; ++i) {
+    TensorPtr embeddings;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] {
+        return embeddings_.size() > i || error_ != Error::Ok;
+      });
+      if (embeddings_.size() <= i) {
+        error = error_;
+        break;
+      }
+      embeddings = embeddings_[i];
+    }
+    // pos is updated inside image prefill.
+    error = image_prefiller_->prefill_embeddings(embeddings, start_pos).error();
+  }
+  join();
+  images_ = nullptr;
+  return error;
+}
+
+void PipelinedImagePrefiller::encode_images() {
+  for (size_t i = 0; i < images_->size(); ++i) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stop_) {
+        return;
+      }
+    }
+    auto& image = (*images_)[i];
+    const uint64_t hash = hash_image(image);
+    TensorPtr embeddings = find_cached(hash);
+    if (!embeddings) {
+      auto encoded = image_prefiller_->encode(image);
+      if (!encoded.ok()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = encoded.error();
+        cv_.notify_all();
+        return;
+      }
+      embeddings = std::move(encoded.get());
+      add_cached(hash, embeddings);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    embeddings_.push_back(std::move(embeddings));
+    cv_.notify_all();
+  }
+}
+
+void PipelinedImagePrefiller::join() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+TensorPtr PipelinedImagePrefiller::find_cached(uint64_t hash) {
+  auto it = cache_index_.find(hash);
+  if (it == cache_index_.end()) {
+    return nullptr;
+  }
+  cache_.splice(cache_.end(), cache_, it->second);
+  return it->second->second;
+}
+
+void PipelinedImagePrefiller::add_cached(uint64_t hash, TensorPtr embeddings) {
+  if (max_cached_images_ == 0) {
+    return;
+  }
+  if (cache_.size() >= max_cached_images_) {
+    cache_index_.erase(cache_.front().first);
+    cache_.pop_front();
+  }
+  cache_.emplace_back(hash, std::move(embeddings));
+  cache_index_[hash] = std::prev(cache_.end());
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
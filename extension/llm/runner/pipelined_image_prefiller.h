@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Encode the images of a multimodal prompt on a worker thread, so that the
+// LLM can prefill what comes before them, and then each image as soon as its
+// embeddings are ready.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <executorch/extension/llm/runner/image.h>
+#include <executorch/extension/llm/runner/image_prefiller.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Pipelines image encoding with the prefill of the LLM.
+ *
+ * start() hands the images to a worker thread that encodes them one after
+ * the other, while the caller keeps prefilling the text before them. prefill()
+ * then feeds each image to the LLM as soon as it's encoded, so the encoding
+ * of an image overlaps the prefill of the one before it.
+ *
+ * The embeddings of the latest images are also kept by their content, so an
+ * image that shows up again, e.g. in every turn of a chat, isn't encoded
+ * again.
+ *
+ * The ImagePrefiller must implement encode() and prefill_embeddings(), and
+ * encode() must not share a Method with the LLM.
+ */
+class ET_EXPERIMENTAL PipelinedImagePrefiller {
+ public:
+  /**
+   * @param image_prefiller The prefiller to pipeline.
+   * @param max_cached_images How many image embeddings to keep for images
+   * that show up again. 0 disables the cache.
+   */
+  explicit PipelinedImagePrefiller(
+      ImagePrefiller* image_prefiller,
+      size_t max_cached_images = 8)
+      : image_prefiller_(image_prefiller),
+        max_cached_images_(max_cached_images) {}
+
+  PipelinedImagePrefiller(const PipelinedImagePrefiller&) = delete;
+  PipelinedImagePrefiller& operator=(const PipelinedImagePrefiller&) = delete;
+
+  ~PipelinedImagePrefiller();
+
+  /**
+   * Start encoding the images in the background.
+   * @param images The images, which must stay alive and unchanged until
+   * prefill() returns.
+   * @return The error code.
+   */
+  ::executorch::runtime::Error start(std::vector<Image>& images);
+
+  /**
+   * Prefill the images passed to start(), in order, waiting for each one to
+   * be encoded.
+   * @param start_pos The starting position in KV cache of the input in the LLM.
+   * It's passed as reference and will be updated inside this function.
+   * @return The error code.
+   */
+  ::executorch::runtime::Error prefill(int64_t& start_pos);
+
+ private:
+  // Runs on worker_ and encodes images_ into embeddings_.
+  void encode_images();
+
+  // Stops the worker and waits for it to exit.
+  void join();
+
+  // The cached embeddings of an image, or null. Only called by the worker.
+  TensorPtr find_cached(uint64_t hash);
+  void add_cached(uint64_t hash, TensorPtr embeddings);
+
+  ImagePrefiller* image_prefiller_;
+  const size_t max_cached_images_;
+
+  std::thread worker_;
+  // Guards everything below but the cache, which only the worker touches.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Image>* images_ = nullptr;
+  // The embeddings of the images encoded so far.
+  std::vector<TensorPtr> embeddings_;
+  ::executorch::runtime::Error error_ = ::executorch::runtime::Error::Ok;
+  bool stop_ = false;
+
+  // Least recently used first.
+  std::list<std::pair<uint64_t, TensorPtr>> cache_;
+  std::unordered_map<uint64_t, decltype(cache_)::iterator> cache_index_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens with a small draft model, or a lookup into the context,
+// proposing them and the target model verifying several at a time.
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#endif
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * A drop-in for TextTokenGenerator that runs speculative decoding.
+ *
+ * Every round, the draft model proposes up to num_draft_tokens tokens one
+ * step at a time, and the target model runs the current token and all of the
+ * proposals in a single step. The proposals are accepted for as long as they
+ * match what the target samples, and the target's own token at the first
+ * mismatch (or after the last proposal) comes for free. Every emitted token
+ * is sampled by the target given an accepted prefix, so the output follows
+ * the target model exactly; the draft only decides how many tokens a target
+ * step yields.
+ *
+ * Without a draft model, the proposals are looked up in the context instead
+ * (prompt lookup decoding): the longest suffix of the prompt and generated
+ * tokens, of up to max_ngram_size tokens, is searched for earlier in them,
+ * and the tokens that followed its latest occurrence are proposed. This needs
+ * no extra model and pays off when the output copies from the prompt, as in
+ * summarization or code editing.
+ *
+ * Both models must use a KV cache. The target's forward must take a dynamic
+ * number of tokens, up to num_draft_tokens + 1, and return the logits of
+ * every one of them, i.e. [1, num_tokens, vocab_size]. Rejected proposals are
+ * rolled back by moving start_pos back: the cache entries they wrote are past
+ * the new position, so they are never attended to and the next update_cache
+ * overwrites them.
+ */
+class ET_EXPERIMENTAL SpeculativeTokenGenerator {
+ public:
+  SpeculativeTokenGenerator(
+      ::tokenizers::Tokenizer* tokenizer,
+      TextDecoderRunner* draft_decoder_runner,
+      TextDecoderRunner* target_decoder_runner,
+      int32_t num_draft_tokens,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats)
+      : tokenizer_(tokenizer),
+        draft_decoder_runner_(draft_decoder_runner),
+        target_decoder_runner_(target_decoder_runner),
+        num_draft_tokens_(num_draft_tokens),
+        eos_ids_(std::move(eos_ids)),
+        stats_(stats) {}
+
+  /**
+   * Proposes tokens by prompt lookup instead of with a draft model.
+   * @param num_draft_tokens The most tokens to propose per step.
+   * @param max_ngram_size The longest suffix to look up.
+   */
+  SpeculativeTokenGenerator(
+      ::tokenizers::Tokenizer* tokenizer,
+      TextDecoderRunner* target_decoder_runner,
+      int32_t num_draft_tokens,
+      int32_t max_ngram_size,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats)
+      : tokenizer_(tokenizer),
+        draft_decoder_runner_(nullptr),
+        target_decoder_runner_(target_decoder_runner),
+        num_draft_tokens_(num_draft_tokens),
+        max_ngram_size_(max_ngram_size),
+        eos_ids_(std::move(eos_ids)),
+        stats_(stats) {}
+
+  /**
+   * Token generation loop.
+   * @param tokens prompt tokens as well as the first token generated by
+   * prefill. Both models must have the prompt in their KV cache.
+   * @param start_pos the start position of the new tokens, based on how many
+   * prompt tokens is prefilled.
+   * @param seq_len the total sequence length, including the prompt tokens, next
+   * token from prefill and new tokens.
+   * @param token_callback what to do after a token is generated.
+   * @param generated_tokens if set, every generated token is appended to it.
+   * @return how many tokens are generated.
+   */
+  inline ::executorch::runtime::Result<int64_t> generate(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t seq_len,
+      std::function<void(const std::string&)> token_callback,
+      std::vector<uint64_t>* generated_tokens = nullptr) {
+    ET_CHECK_MSG(
+        !tokens.empty(), "Token generation loop shouldn't take empty tokens");
+    ET_CHECK_OR_RETURN_ERROR(
+        num_draft_tokens_ > 0,
+        InvalidArgument,
+        "num_draft_tokens must be positive, got %" PRId32,
+        num_draft_tokens_);
+    int64_t pos = start_pos; // position in the sequence
+    // The draft's KV cache holds the accepted tokens up to draft_pos.
+    int64_t draft_pos = start_pos;
+    int64_t draft_input_pos = start_pos;
+    int64_t target_pos = start_pos;
+
+    // The prompt and the accepted tokens; the last one is the current token,
+    // which neither model has seen yet. The token at position p is
+    // history[p + history_offset].
+    std::vector<uint64_t> history = std::move(tokens);
+    const int64_t history_offset =
+        static_cast<int64_t>(history.size()) - 1 - start_pos;
+
+    std::vector<uint64_t> draft_token_data = {history.back()};
+    auto draft_tokens_managed = from_blob(
+        draft_token_data.data(), {1, 1}, executorch::aten::ScalarType::Long);
+    auto draft_start_pos_managed =
+        from_blob(&draft_input_pos, {1}, executorch::aten::ScalarType::Long);
+
+    // The current token followed by the proposals.
+    std::vector<uint64_t> target_token_data(num_draft_tokens_ + 1);
+    auto target_tokens_managed = from_blob(
+        target_token_data.data(),
+        {1, num_draft_tokens_ + 1},
+        executorch::aten::ScalarType::Long);
+    auto target_start_pos_managed =
+        from_blob(&target_pos, {1}, executorch::aten::ScalarType::Long);
+
+    should_stop_ = false;
+
+#if defined(ET_USE_THREADPOOL)
+    // Each step runs a handful of small parallel regions, so keep the workers
+    // awake between them instead of waking them up for every token.
+    ::executorch::extension::threadpool::KeepWorkersHotGuard hot_workers(
+        ::executorch::extension::threadpool::get_threadpool());
+#endif
+
+    // Generate our tokens
+    while (pos < seq_len - 1) {
+      // Leave room for the target's own token after the proposals.
+      int64_t num_proposals =
+          std::min<int64_t>(num_draft_tokens_, seq_len - 2 - pos);
+      target_token_data[0] = history.back();
+
+      if (draft_decoder_runner_ == nullptr) {
+        num_proposals = num_proposals > 0
+            ? lookup_proposals(
+                  history, num_proposals, target_token_data.data() + 1)
+            : 0;
+      } else if (num_proposals > 0) {
+        // Catch the draft up on the accepted tokens it hasn't run yet.
+        while (draft_pos < pos) {
+          draft_token_data[0] = history[draft_pos + history_offset];
+          draft_input_pos = draft_pos;
+          ET_CHECK_OK_OR_RETURN_ERROR(
+              draft_decoder_runner_
+                  ->step(draft_tokens_managed, draft_start_pos_managed)
+                  .error());
+          draft_pos++;
+        }
+        // Then let it propose, starting from the current token.
+        for (int64_t i = 0; i < num_proposals; ++i) {
+          draft_token_data[0] = target_token_data[i];
+          draft_input_pos = draft_pos;
+          auto logits_res = draft_decoder_runner_->step(
+              draft_tokens_managed, draft_start_pos_managed);
+          ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+          draft_pos++;
+          stats_->on_sampling_begin();
+          target_token_data[i + 1] =
+              draft_decoder_runner_->logits_to_token(logits_res.get());
+          stats_->on_sampling_end();
+        }
+      }
+
+      // Verify the proposals in one step of the target.
+      ET_CHECK_OK_OR_RETURN_ERROR(resize_tensor_ptr(
+          target_tokens_managed, {1, static_cast<int>(num_proposals + 1)}));
+      target_pos = pos;
+      auto logits_res = target_decoder_runner_->step(
+          target_tokens_managed, target_start_pos_managed);
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+      executorch::aten::Tensor& logits_tensor = logits_res.get();
+      // Logits are [1, num_tokens, vocab_size], or [1, num_tokens] tokens if
+      // the model picks them itself.
+      const bool per_token = logits_tensor.dim() ==
+          (logits_tensor.scalar_type() == executorch::aten::ScalarType::Long
+               ? 2
+               : 3);
+      ET_CHECK_OR_RETURN_ERROR(
+          num_proposals == 0 ||
+              (per_token && logits_tensor.size(1) == num_proposals + 1),
+          InvalidArgument,
+          "The target model must return the logits of every input token");
+
+      // Keep sampling the target while it agrees with the proposals.
+      int64_t num_accepted = 0;
+      bool done = false;
+      for (int64_t i = 0; i <= num_proposals && !done; ++i) {
+        stats_->on_sampling_begin();
+        const uint64_t token = target_decoder_runner_->logits_to_token(
+            logits_tensor, /*batch_index=*/0, /*token_index=*/i);
+        stats_->on_sampling_end();
+        const bool matches_draft =
+            i < num_proposals && token == target_token_data[i + 1];
+
+        const uint64_t prev_token = history.back();
+        history.push_back(token);
+        pos++;
+        if (generated_tokens != nullptr) {
+          generated_tokens->push_back(token);
+        }
+
+        // print the token as string, decode it with the Tokenizer object
+        token_callback(
+            ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, token)));
+
+        if (should_stop_) {
+          done = true;
+        } else if (eos_ids_->find(token) != eos_ids_->end()) {
+          // data-dependent terminating condition: we have n_eos_ number of EOS
+          printf("\n");
+          ET_LOG(Info, "\nReached to the end of generation");
+          done = true;
+        }
+        if (!matches_draft) {
+          break;
+        }
+        num_accepted++;
+      }
+      stats_->num_draft_tokens += num_proposals;
+      stats_->num_accepted_draft_tokens += num_accepted;
+      if (done) {
+        break;
+      }
+
+      // Roll the draft back past the proposals the target rejected; what it
+      // ran up to the new current token matches the accepted tokens. The
+      // target's start_pos is set from pos at the next round.
+      draft_pos = std::min(draft_pos, pos);
+    }
+    return pos - start_pos;
+  }
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+ private:
+  // Finds the latest earlier occurrence of the longest suffix of history, of
+  // up to max_ngram_size_ tokens, and copies up to max_proposals of the tokens
+  // that followed it into proposals. Returns how many were copied.
+  int64_t lookup_proposals(
+      const std::vector<uint64_t>& history,
+      int64_t max_proposals,
+      uint64_t* proposals) const {
+    const int64_t size = static_cast<int64_t>(history.size());
+    for (int64_t n = std::min<int64_t>(max_ngram_size_, size - 1); n > 0;
+         --n) {
+      const auto suffix = history.end() - n;
+      // Latest first, leaving at least one token after the match.
+      for (int64_t start = size - n - 1; start >= 0; --start) {
+        if (std::equal(suffix, history.end(), history.begin() + start)) {
+          const int64_t count =
+              std::min<int64_t>(max_proposals, size - start - n);
+          std::copy_n(history.begin() + start + n, count, proposals);
+          return count;
+        }
+      }
+    }
+    return 0;
+  }
+
+  ::tokenizers::Tokenizer* tokenizer_;
+  TextDecoderRunner* draft_decoder_runner_;
+  TextDecoderRunner* target_decoder_runner_;
+  const int32_t num_draft_tokens_;
+  // Only used without a draft model.
+  const int32_t max_ngram_size_ = 0;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// KV cache I/O for models exported with static shapes, where the caches are
+// explicit inputs and outputs of every step.
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/executor/method.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * What a static-shape model returns for each of its KV caches.
+ */
+enum class StaticKVCacheUpdateStyle {
+  /**
+   * Only the entries of the new tokens, i.e. [1, input_len, head_dim]. The
+   * valid entries sit at the end of the input window, and the outputs land
+   * right after it, so the window just slides over them. The cache holds up
+   * to cache_len tokens.
+   */
+  kSlidingWindow,
+  /**
+   * The whole updated cache, i.e. [1, cache_len, head_dim]. Each cache has
+   * two buffers which the model reads from and writes to in turns, so how it
+   * evicts old entries is up to the model.
+   */
+  kDoubleBuffer,
+};
+
+/**
+ * Handles the KV cache inputs and outputs of a static-shape model without
+ * copying them between steps: cache inputs are bound to the data with
+ * Method::bind_input, and outputs are written in place through
+ * Method::set_output_data_ptr, so the outputs of a step become the inputs of
+ * the next one by moving pointers. The cache outputs must therefore not be
+ * memory planned.
+ *
+ * Assumes batch size 1, and the same cache length and head dimension for
+ * each cache. Supports hybrid operation mixing prefill and decode, with
+ * methods of different input lengths up to max_input_len sharing the caches.
+ * Create one instance for key caches and another one for value caches.
+ */
+template <typename T, typename AllocatorT = std::allocator<T>>
+class ET_EXPERIMENTAL StaticKVCache {
+ public:
+  /**
+   * @param n_caches The number of caches, e.g. one per layer and KV head.
+   * @param cache_len The length of each cache input.
+   * @param head_dim The head dimension.
+   * @param max_input_len The most tokens a step takes.
+   * @param transpose Whether the caches are [1, head_dim, cache_len]. Only
+   * supported with kDoubleBuffer.
+   * @param style What the model returns for each cache.
+   */
+  StaticKVCache(
+      size_t n_caches,
+      size_t cache_len,
+      size_t head_dim,
+      size_t max_input_len = 1,
+      bool transpose = false,
+      StaticKVCacheUpdateStyle style = StaticKVCacheUpdateStyle::kSlidingWindow)
+      : n_caches_(n_caches),
+        cache_len_(cache_len),
+        max_input_len_(max_input_len),
+        head_dim_(head_dim),
+        transpose_(transpose),
+        style_(style) {
+    const size_t cache_size = cache_len_ * head_dim_;
+    if (style_ == StaticKVCacheUpdateStyle::kDoubleBuffer) {
+      data_size_ = 2 * n_caches_ * cache_size;
+    } else {
+      ET_CHECK_MSG(
+          !transpose_, "Transposed caches need kDoubleBuffer updates.");
+      // The output of each cache overlaps the oldest entries of the next
+      // one, which have slid out of its window by then. The last one needs
+      // an extra segment, plus room for a padded input at the end.
+      data_size_ = (n_caches_ + 1) * cache_size + max_input_len_ * head_dim_;
+    }
+    data_ = allocator_.allocate(data_size_);
+    ET_CHECK(data_ != nullptr);
+    reset();
+  }
+
+  StaticKVCache(const StaticKVCache& other) = delete;
+  StaticKVCache& operator=(const StaticKVCache& other) = delete;
+  StaticKVCache(StaticKVCache&& other) = delete;
+  StaticKVCache& operator=(StaticKVCache&& other) = delete;
+
+  ~StaticKVCache() {
+    allocator_.deallocate(data_, data_size_);
+  }
+
+  /**
+   * Set up data pointers for the KV cache related inputs and outputs based on
+   * the current state of the cache. Call StaticKVCache<T>::update or
+   * StaticKVCache<T>::reset first as needed before calling this function.
+   */
+  ET_NODISCARD ::executorch::runtime::Error prepare(
+      ::executorch::runtime::Method& method,
+      const std::vector<size_t>& inputIndices,
+      const std::vector<size_t>& outputIndices) {
+    ET_CHECK_OR_RETURN_ERROR(
+        inputIndices.size() == n_caches_ &&
+            outputIndices.size() == n_caches_,
+        InvalidArgument,
+        "Expected %" ET_PRIsize_t
+        " cache inputs and outputs, got %" ET_PRIsize_t " and %" ET_PRIsize_t
+        ".",
+        n_caches_,
+        inputIndices.size(),
+        outputIndices.size());
+    auto methodMeta = method.method_meta();
+    const size_t seqDim = transpose_ ? 2 : 1;
+    const size_t headDim = transpose_ ? 1 : 2;
+    const size_t outLen =
+        style_ == StaticKVCacheUpdateStyle::kDoubleBuffer ? cache_len_ : 0;
+    for (size_t i = 0; i < n_caches_; i++) {
+      auto inIdx = inputIndices[i];
+      auto outIdx = outputIndices[i];
+      auto inMeta = methodMeta.input_tensor_meta(inIdx);
+      auto outMeta = methodMeta.output_tensor_meta(outIdx);
+      ET_CHECK_OK_OR_RETURN_ERROR(inMeta.error());
+      ET_CHECK_OK_OR_RETURN_ERROR(outMeta.error());
+
+      auto inSizes = inMeta->sizes();
+      auto outSizes = outMeta->sizes();
+      // Shapes are never negative.
+      auto size = [](auto sizes, size_t dim) {
+        return static_cast<size_t>(sizes[dim]);
+      };
+      ET_CHECK_OR_RETURN_ERROR(
+          inSizes.size() == 3 && outSizes.size() == 3,
+          InvalidArgument,
+          "KV caches must be 3D.");
+      ET_CHECK_OR_RETURN_ERROR(
+          size(inSizes, 0) == 1 && size(outSizes, 0) == 1,
+          NotSupported,
+          "Only support batch size 1.");
+      ET_CHECK_OR_RETURN_ERROR(
+          size(inSizes, headDim) == head_dim_ &&
+              size(outSizes, headDim) == head_dim_,
+          InvalidArgument,
+          "KV head dim mismatch.");
+      ET_CHECK_OR_RETURN_ERROR(
+          size(inSizes, seqDim) == cache_len_,
+          InvalidArgument,
+          "Cache length dim mismatch.");
+      ET_CHECK_OR_RETURN_ERROR(
+          outLen > 0 ? size(outSizes, seqDim) == outLen
+                     : size(outSizes, seqDim) <= max_input_len_,
+          InvalidArgument,
+          "Cache output length dim mismatch.");
+
+      auto impl = ::executorch::runtime::etensor::TensorImpl(
+          inMeta->scalar_type(),
+          inSizes.size(),
+          const_cast<::executorch::aten::TensorImpl::SizesType*>(
+              inSizes.data()),
+          input_ptrs_[i],
+          const_cast<::executorch::aten::TensorImpl::DimOrderType*>(
+              inMeta->dim_order().data()));
+      ::executorch::aten::Tensor t(&impl);
+      ET_CHECK_OK_OR_RETURN_ERROR(method.bind_input(t, inIdx));
+      ET_CHECK_OK_OR_RETURN_ERROR(method.set_output_data_ptr(
+          output_ptrs_[i], outMeta->nbytes(), outIdx));
+    }
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Update the internal data pointers using the cache updates returned by the
+   * model. The length of each individual update cannot exceed the max input
+   * length specified during the creation. With kSlidingWindow updates, the
+   * total length cannot exceed the context length either.
+   */
+  ET_NODISCARD ::executorch::runtime::Error update(
+      ::executorch::runtime::Method& method,
+      const std::vector<size_t>& outputIndices,
+      size_t update_len) {
+    ET_CHECK_OR_RETURN_ERROR(
+        outputIndices.size() == n_caches_,
+        InvalidArgument,
+        "Expected %" ET_PRIsize_t " cache outputs, got %" ET_PRIsize_t ".",
+        n_caches_,
+        outputIndices.size());
+    for (size_t i = 0; i < n_caches_; i++) {
+      const auto& updateTensor = method.get_output(outputIndices[i]).toTensor();
+      ET_CHECK_OR_RETURN_ERROR(
+          updateTensor.const_data_ptr() == output_ptrs_[i],
+          InvalidState,
+          "Cache output %" ET_PRIsize_t
+          " was not written in place; call prepare() first.",
+          outputIndices[i]);
+    }
+    return update(update_len);
+  }
+
+  /**
+   * Like update(method, outputIndices, update_len), for callers that bind the
+   * cache inputs and outputs to input_data() and output_data() themselves,
+   * e.g. through Module::bind_input() and Module::bind_output().
+   */
+  ET_NODISCARD ::executorch::runtime::Error update(size_t update_len) {
+    ET_CHECK_OR_RETURN_ERROR(
+        update_len <= max_input_len_,
+        InvalidArgument,
+        "Update length %" ET_PRIsize_t
+        " exceeds the max input length %" ET_PRIsize_t ".",
+        update_len,
+        max_input_len_);
+    const bool doubleBuffer = style_ == StaticKVCacheUpdateStyle::kDoubleBuffer;
+    ET_CHECK_OR_RETURN_ERROR(
+        doubleBuffer || valid_len_ + update_len <= cache_len_,
+        OutOfResources,
+        "Cache capacity exceeded.");
+    for (size_t i = 0; i < n_caches_; i++) {
+      if (doubleBuffer) {
+        std::swap(input_ptrs_[i], output_ptrs_[i]);
+      } else {
+        input_ptrs_[i] += update_len * head_dim_;
+        output_ptrs_[i] += update_len * head_dim_;
+      }
+    }
+    valid_len_ = std::min(valid_len_ + update_len, cache_len_);
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Reset the cache. After this the cache contains no valid data and is ready
+   * for number of tokens up to the context length.
+   */
+  void reset() {
+    valid_len_ = 0;
+    const size_t cacheSize = cache_len_ * head_dim_;
+    const bool doubleBuffer = style_ == StaticKVCacheUpdateStyle::kDoubleBuffer;
+    input_ptrs_.resize(n_caches_);
+    output_ptrs_.resize(n_caches_);
+    for (size_t i = 0; i < n_caches_; i++) {
+      input_ptrs_[i] = data_ + (doubleBuffer ? 2 * i : i) * cacheSize;
+      output_ptrs_[i] = input_ptrs_[i] + cacheSize;
+    }
+  }
+
+  /**
+   * Converts the caches between the [1, cache_len, head_dim] and the
+   * [1, head_dim, cache_len] layouts, e.g. when methods that share them on
+   * different backends expect different layouts. Does nothing if the caches
+   * already have the requested layout. Each cache is transposed into its
+   * second buffer, so this needs kDoubleBuffer updates.
+   */
+  ET_NODISCARD ::executorch::runtime::Error set_transpose(bool transpose) {
+    if (transpose == transpose_) {
+      return ::executorch::runtime::Error::Ok;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        style_ == StaticKVCacheUpdateStyle::kDoubleBuffer,
+        NotSupported,
+        "Transposed caches need kDoubleBuffer updates.");
+    // The rows and columns of the current layout.
+    const size_t rows = transpose_ ? head_dim_ : cache_len_;
+    const size_t cols = transpose_ ? cache_len_ : head_dim_;
+    for (size_t i = 0; i < n_caches_; i++) {
+      const T* src = input_ptrs_[i];
+      T* dst = output_ptrs_[i];
+      for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < cols; c++) {
+          dst[c * rows + r] = src[r * cols + c];
+        }
+      }
+      std::swap(input_ptrs_[i], output_ptrs_[i]);
+    }
+    transpose_ = transpose;
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Whether the caches are [1, head_dim, cache_len].
+   */
+  bool transposed() const {
+    return transpose_;
+  }
+
+  /**
+   * The data that the model reads cache i from at the next step, as set up
+   * by prepare().
+   */
+  T* input_data(size_t i) const {
+    return input_ptrs_[i];
+  }
+
+  /**
+   * The data that the model writes the update of cache i to at the next
+   * step, as set up by prepare().
+   */
+  T* output_data(size_t i) const {
+    return output_ptrs_[i];
+  }
+
+  /**
+   * The number of valid entries in each cache, capped at the cache length.
+   */
+  size_t valid_len() const {
+    return valid_len_;
+  }
+
+ private:
+  size_t n_caches_;
+  size_t cache_len_;
+  size_t max_input_len_;
+  size_t head_dim_;
+  bool transpose_;
+  StaticKVCacheUpdateStyle style_;
+  AllocatorT allocator_;
+  size_t data_size_;
+  T* data_;
+  std::vector<T*> input_ptrs_;
+  std::vector<T*> output_ptrs_;
+  size_t valid_len_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
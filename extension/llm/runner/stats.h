@@ -10,14 +10,84 @@
 #pragma once
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/runtime/platform/log.h>
+#include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace executorch {
 namespace extension {
 namespace llm {
 
+/**
+ * The steps of generating a token, whose latencies Stats records one sample of
+ * per token.
+ */
+enum class TokenPhase : uint8_t {
+  // The whole step, from running the model to returning from the callback.
+  Token,
+  // Running the decoder model.
+  ModelExecution,
+  // Picking the token from the logits.
+  Sampling,
+  // Detokenizing it into text.
+  Decoding,
+  // The callback that receives the text.
+  Callback,
+};
+
+constexpr size_t kNumTokenPhases = 5;
+
+inline const char* token_phase_name(TokenPhase phase) {
+  switch (phase) {
+    case TokenPhase::Token:
+      return "token";
+    case TokenPhase::ModelExecution:
+      return "model_execution";
+    case TokenPhase::Sampling:
+      return "sampling";
+    case TokenPhase::Decoding:
+      return "decoding";
+    case TokenPhase::Callback:
+      return "callback";
+  }
+  return "unknown";
+}
+
+/**
+ * Latency samples in microseconds, e.g. one per generated token, to report
+ * percentiles: the average hides the jitter between tokens.
+ */
+struct ET_EXPERIMENTAL LatencyStats {
+  std::vector<long> samples_us;
+
+  void add(long latency_us) {
+    samples_us.push_back(latency_us);
+  }
+
+  /**
+   * The smallest sample that is greater than or equal to `percent` percent of
+   * the samples (the nearest-rank percentile), or 0 without samples.
+   */
+  long percentile(double percent) const {
+    if (samples_us.empty()) {
+      return 0;
+    }
+    const size_t n = samples_us.size();
+    size_t rank = static_cast<size_t>(percent / 100.0 * n + 0.999999);
+    rank = std::min(std::max<size_t>(rank, 1), n);
+    std::vector<long> sorted = samples_us;
+    std::nth_element(sorted.begin(), sorted.begin() + rank - 1, sorted.end());
+    return sorted[rank - 1];
+  }
+
+  void clear() {
+    samples_us.clear();
+  }
+};
+
 struct ET_EXPERIMENTAL Stats {
   // Scaling factor for timestamps - in this case, we use ms.
   const long SCALING_FACTOR_UNITS_PER_SECOND = 1000;
@@ -49,13 +119,35 @@ struct ET_EXPERIMENTAL Stats {
   int64_t num_prompt_tokens;
   // Token count from generated (total - prompt)
   int64_t num_generated_tokens;
+  // Speculative decoding: tokens proposed by the draft model, and how many of
+  // them the target model accepted.
+  int64_t num_draft_tokens = 0;
+  int64_t num_accepted_draft_tokens = 0;
+  // Per-token latencies of each TokenPhase, in microseconds.
+  std::array<LatencyStats, kNumTokenPhases> token_phase_latencies;
+
+  const LatencyStats& latencies(TokenPhase phase) const {
+    return token_phase_latencies[static_cast<size_t>(phase)];
+  }
+
+  inline void on_token_phase_begin(TokenPhase phase) {
+    token_phase_start_us_[static_cast<size_t>(phase)] = time_in_us();
+  }
+  inline void on_token_phase_end(TokenPhase phase) {
+    const size_t index = static_cast<size_t>(phase);
+    const long latency_us = time_in_us() - token_phase_start_us_[index];
+    token_phase_latencies[index].add(latency_us);
+    if (phase == TokenPhase::Sampling) {
+      aggregate_sampling_time_us_ += latency_us;
+      aggregate_sampling_time_ms = aggregate_sampling_time_us_ / 1000;
+    }
+  }
+
   inline void on_sampling_begin() {
-    aggregate_sampling_timer_start_timestamp = time_in_ms();
+    on_token_phase_begin(TokenPhase::Sampling);
   }
   inline void on_sampling_end() {
-    aggregate_sampling_time_ms +=
-        time_in_ms() - aggregate_sampling_timer_start_timestamp;
-    aggregate_sampling_timer_start_timestamp = 0;
+    on_token_phase_end(TokenPhase::Sampling);
   }
 
   void reset(bool all_stats = false) {
@@ -75,11 +167,19 @@ struct ET_EXPERIMENTAL Stats {
     aggregate_sampling_time_ms = 0;
     num_prompt_tokens = 0;
     num_generated_tokens = 0;
-    aggregate_sampling_timer_start_timestamp = 0;
+    num_draft_tokens = 0;
+    num_accepted_draft_tokens = 0;
+    for (auto& latencies : token_phase_latencies) {
+      latencies.clear();
+    }
+    aggregate_sampling_time_us_ = 0;
   }
 
  private:
-  long aggregate_sampling_timer_start_timestamp = 0;
+  std::array<long, kNumTokenPhases> token_phase_start_us_{};
+  // Sampling time at microsecond precision, so that summing short samples
+  // doesn't truncate them.
+  long aggregate_sampling_time_us_ = 0;
 };
 
 static constexpr auto kTopp = 0.9f;
@@ -95,7 +195,19 @@ inline std::string stats_to_json_string(const Stats& stats) {
      << "\"prompt_eval_end_ms\":" << stats.prompt_eval_end_ms << ","
      << "\"first_token_ms\":" << stats.first_token_ms << ","
      << "\"aggregate_sampling_time_ms\":" << stats.aggregate_sampling_time_ms
-     << "," << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
+     << "," << "\"draft_tokens\":" << stats.num_draft_tokens << ","
+     << "\"accepted_draft_tokens\":" << stats.num_accepted_draft_tokens << ","
+     << "\"token_latency_us\":{";
+  for (size_t i = 0; i < kNumTokenPhases; ++i) {
+    const auto phase = static_cast<TokenPhase>(i);
+    const LatencyStats& latencies = stats.latencies(phase);
+    ss << (i > 0 ? "," : "") << "\"" << token_phase_name(phase) << "\":{"
+       << "\"count\":" << latencies.samples_us.size() << ","
+       << "\"p50\":" << latencies.percentile(50) << ","
+       << "\"p90\":" << latencies.percentile(90) << ","
+       << "\"p99\":" << latencies.percentile(99) << "}";
+  }
+  ss << "}," << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
      << stats.SCALING_FACTOR_UNITS_PER_SECOND << "}";
   return ss.str();
 }
@@ -158,6 +270,31 @@ inline void print_report(const Stats& stats) {
       stats.num_prompt_tokens + stats.num_generated_tokens,
       (double)stats.aggregate_sampling_time_ms /
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
+
+  for (size_t i = 0; i < kNumTokenPhases; ++i) {
+    const auto phase = static_cast<TokenPhase>(i);
+    const LatencyStats& latencies = stats.latencies(phase);
+    if (latencies.samples_us.empty()) {
+      continue;
+    }
+    ET_LOG(
+        Info,
+        "\t%s latency over %zu tokens:\tp50 %ld, p90 %ld, p99 %ld (us)",
+        token_phase_name(phase),
+        latencies.samples_us.size(),
+        latencies.percentile(50),
+        latencies.percentile(90),
+        latencies.percentile(99));
+  }
+
+  if (stats.num_draft_tokens > 0) {
+    ET_LOG(
+        Info,
+        "\tAccepted %" PRIu64 " of %" PRIu64 " draft tokens:\t%f%%",
+        stats.num_accepted_draft_tokens,
+        stats.num_draft_tokens,
+        100.0 * stats.num_accepted_draft_tokens / stats.num_draft_tokens);
+  }
 }
 
 } // namespace llm
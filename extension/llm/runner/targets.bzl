@@ -22,6 +22,57 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "llm_benchmark",
+        exported_headers = ["llm_benchmark.h"],
+        srcs = ["llm_benchmark.cpp"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            ":irunner",
+            ":stats",
+            "//executorch/extension/runner_util:device_monitor",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "kv_block_allocator",
+        exported_headers = ["kv_block_allocator.h"],
+        srcs = ["kv_block_allocator.cpp"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "static_kv_cache",
+        exported_headers = ["static_kv_cache.h"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/executor:program",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "hybrid_text_decoder_runner",
+        exported_headers = ["hybrid_text_decoder_runner.h"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            ":static_kv_cache",
+            ":text_decoder_runner",
+            "//executorch/extension/module:module",
+            "//executorch/extension/tensor:tensor",
+        ],
+    )
+
     for aten in (True, False):
         aten_suffix = "_aten" if aten else ""
 
@@ -35,11 +86,28 @@ def define_common_targets():
             exported_deps = [
                 ":stats",
                 "//executorch/extension/llm/sampler:sampler" + aten_suffix,
+                "//executorch/extension/llm/sampler:token_constraint",
                 "//executorch/extension/module:module" + aten_suffix,
                 "//executorch/extension/tensor:tensor" + aten_suffix,
             ],
         )
 
+        runtime.cxx_library(
+            name = "kv_cache_session" + aten_suffix,
+            exported_headers = ["kv_cache_session.h"],
+            srcs = ["kv_cache_session.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            deps = [
+                "//executorch/extension/data_loader:file_data_loader",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "text_prefiller" + aten_suffix,
             exported_headers = ["text_prefiller.h"],
@@ -61,6 +129,21 @@ def define_common_targets():
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                "//pytorch/tokenizers:headers",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+                "//executorch/runtime/core:event_tracer" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "speculative_token_generator" + aten_suffix,
+            exported_headers = ["speculative_token_generator.h"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
             exported_deps = [
                 ":text_decoder_runner" + aten_suffix,
                 "//pytorch/tokenizers:headers",
@@ -77,6 +160,38 @@ def define_common_targets():
             ],
             exported_deps = [
                 "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "pipelined_image_prefiller" + aten_suffix,
+            exported_headers = ["pipelined_image_prefiller.h"],
+            srcs = ["pipelined_image_prefiller.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":image_prefiller" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "batched_text_runner" + aten_suffix,
+            exported_headers = ["batched_text_runner.h"],
+            srcs = ["batched_text_runner.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":irunner",
+                ":kv_block_allocator",
+                ":stats",
+                ":text_decoder_runner" + aten_suffix,
+                "//pytorch/tokenizers:headers",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
             ],
         )
 
@@ -89,7 +204,11 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":batched_text_runner" + aten_suffix,
                 ":image_prefiller" + aten_suffix,
+                ":kv_cache_session" + aten_suffix,
+                ":pipelined_image_prefiller" + aten_suffix,
+                ":speculative_token_generator" + aten_suffix,
                 ":text_decoder_runner" + aten_suffix,
                 ":text_prefiller" + aten_suffix,
                 ":text_token_generator" + aten_suffix,
@@ -0,0 +1,40 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_test(
+        name = "test_kv_cache_session",
+        srcs = [
+            "test_kv_cache_session.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:kv_cache_session",
+            "//executorch/extension/tensor:tensor",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_stats",
+        srcs = [
+            "test_stats.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:stats",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_static_kv_cache",
+        srcs = [
+            "test_static_kv_cache.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:static_kv_cache",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
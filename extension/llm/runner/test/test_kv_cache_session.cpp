@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/kv_cache_session.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace ::testing;
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::Tensor;
+using ::executorch::extension::make_tensor_ptr;
+using ::executorch::extension::TensorPtr;
+using ::executorch::extension::llm::KVCacheSession;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+class KVCacheSessionTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    path_ = testing::TempDir() + "kv_cache_session_test.bin";
+    // A cache of 4 positions of 2 values, with the first 2 positions in use.
+    k_cache_ =
+        make_tensor_ptr({4, 2}, {1.f, 2.f, 3.f, 4.f, 0.f, 0.f, 0.f, 0.f});
+    v_cache_ =
+        make_tensor_ptr({4, 2}, std::vector<int8_t>{5, 6, 7, 8, 0, 0, 0, 0});
+  }
+
+  void TearDown() override {
+    std::remove(path_.c_str());
+  }
+
+  std::vector<Tensor> buffers() const {
+    return {*k_cache_, *v_cache_};
+  }
+
+  size_t file_size() const {
+    std::ifstream file(path_, std::ios::binary | std::ios::ate);
+    return file.tellg();
+  }
+
+  std::string path_;
+  TensorPtr k_cache_;
+  TensorPtr v_cache_;
+};
+
+TEST_F(KVCacheSessionTest, RestoresBuffersAndTokens) {
+  const std::vector<uint64_t> tokens = {128000, 9906};
+  ASSERT_EQ(KVCacheSession::save(path_, buffers(), tokens), Error::Ok);
+
+  // Only the positions in use are stored.
+  EXPECT_EQ(
+      file_size(),
+      sizeof(KVCacheSession::Header) + 2 * sizeof(uint64_t) +
+          2 * sizeof(KVCacheSession::BufferHeader) + 4 * sizeof(float) + 4);
+
+  // Restoring overwrites whatever the buffers held, zeroing the rest.
+  std::fill(
+      k_cache_->mutable_data_ptr<float>(),
+      k_cache_->mutable_data_ptr<float>() + k_cache_->numel(),
+      9.f);
+  std::fill(
+      v_cache_->mutable_data_ptr<int8_t>(),
+      v_cache_->mutable_data_ptr<int8_t>() + v_cache_->numel(),
+      9);
+  Result<std::vector<uint64_t>> restored =
+      KVCacheSession::load(path_, buffers());
+  ASSERT_EQ(restored.error(), Error::Ok);
+  EXPECT_EQ(*restored, tokens);
+  const std::vector<float> k(
+      k_cache_->const_data_ptr<float>(),
+      k_cache_->const_data_ptr<float>() + k_cache_->numel());
+  const std::vector<int8_t> v(
+      v_cache_->const_data_ptr<int8_t>(),
+      v_cache_->const_data_ptr<int8_t>() + v_cache_->numel());
+  EXPECT_EQ(k, (std::vector<float>{1.f, 2.f, 3.f, 4.f, 0.f, 0.f, 0.f, 0.f}));
+  EXPECT_EQ(v, (std::vector<int8_t>{5, 6, 7, 8, 0, 0, 0, 0}));
+}
+
+TEST_F(KVCacheSessionTest, RejectsOtherBuffers) {
+  ASSERT_EQ(KVCacheSession::save(path_, buffers(), {1, 2}), Error::Ok);
+
+  auto other = make_tensor_ptr({4, 2}, std::vector<int8_t>(8, 3));
+  EXPECT_EQ(
+      KVCacheSession::load(path_, {*k_cache_}).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      KVCacheSession::load(path_, {*k_cache_, *k_cache_}).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      KVCacheSession::load(path_, {*other, *v_cache_}).error(),
+      Error::InvalidArgument);
+  // The buffers are left as they were.
+  EXPECT_EQ(other->const_data_ptr<int8_t>()[0], 3);
+}
+
+TEST_F(KVCacheSessionTest, RejectsMalformedFiles) {
+  ASSERT_EQ(KVCacheSession::save(path_, buffers(), {1, 2}), Error::Ok);
+  std::vector<char> data;
+  {
+    std::ifstream file(path_, std::ios::binary);
+    data.assign(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  const auto write = [this](const std::vector<char>& contents) {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+  };
+  write(std::vector<char>(data.begin(), data.end() - 1));
+  EXPECT_EQ(
+      KVCacheSession::load(path_, buffers()).error(), Error::InvalidArgument);
+
+  std::vector<char> bad_magic = data;
+  bad_magic[0] = 'x';
+  write(bad_magic);
+  EXPECT_EQ(
+      KVCacheSession::load(path_, buffers()).error(), Error::InvalidArgument);
+
+  std::vector<char> many_tokens = data;
+  const uint64_t num_tokens = UINT64_MAX / sizeof(uint64_t);
+  std::memcpy(
+      many_tokens.data() + offsetof(KVCacheSession::Header, num_tokens),
+      &num_tokens,
+      sizeof(num_tokens));
+  write(many_tokens);
+  EXPECT_EQ(
+      KVCacheSession::load(path_, buffers()).error(), Error::InvalidArgument);
+
+  EXPECT_NE(
+      KVCacheSession::load(path_ + ".missing", buffers()).error(), Error::Ok);
+}
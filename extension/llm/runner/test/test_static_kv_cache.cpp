@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/static_kv_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using ::executorch::extension::llm::StaticKVCache;
+using ::executorch::extension::llm::StaticKVCacheUpdateStyle;
+using ::executorch::runtime::Error;
+
+class StaticKVCacheTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(StaticKVCacheTest, SlidingWindowUpdatesMoveThePointers) {
+  StaticKVCache<float> caches(
+      /*n_caches=*/2, /*cache_len=*/4, /*head_dim=*/3, /*max_input_len=*/2);
+  float* input = caches.input_data(1);
+  float* output = caches.output_data(1);
+  EXPECT_EQ(output, input + 4 * 3);
+
+  EXPECT_EQ(caches.update(2), Error::Ok);
+  EXPECT_EQ(caches.valid_len(), 2);
+  EXPECT_EQ(caches.input_data(1), input + 2 * 3);
+  EXPECT_EQ(caches.output_data(1), output + 2 * 3);
+
+  // Longer than the max input length, then past the cache length.
+  EXPECT_EQ(caches.update(3), Error::InvalidArgument);
+  EXPECT_EQ(caches.update(2), Error::Ok);
+  EXPECT_EQ(caches.update(1), Error::OutOfResources);
+
+  caches.reset();
+  EXPECT_EQ(caches.valid_len(), 0);
+  EXPECT_EQ(caches.input_data(1), input);
+}
+
+TEST_F(StaticKVCacheTest, DoubleBufferUpdatesSwapTheBuffers) {
+  StaticKVCache<float> caches(
+      /*n_caches=*/1,
+      /*cache_len=*/4,
+      /*head_dim=*/3,
+      /*max_input_len=*/1,
+      /*transpose=*/false,
+      StaticKVCacheUpdateStyle::kDoubleBuffer);
+  float* input = caches.input_data(0);
+  float* output = caches.output_data(0);
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(caches.update(1), Error::Ok);
+  }
+  // The model manages the entries, so there is no capacity to exceed.
+  EXPECT_EQ(caches.valid_len(), 4);
+  EXPECT_EQ(caches.input_data(0), input);
+  EXPECT_EQ(caches.update(1), Error::Ok);
+  EXPECT_EQ(caches.input_data(0), output);
+}
+
+TEST_F(StaticKVCacheTest, SetTransposeConvertsTheLayout) {
+  constexpr size_t kCacheLen = 4;
+  constexpr size_t kHeadDim = 3;
+  StaticKVCache<float> caches(
+      /*n_caches=*/2,
+      kCacheLen,
+      kHeadDim,
+      /*max_input_len=*/1,
+      /*transpose=*/false,
+      StaticKVCacheUpdateStyle::kDoubleBuffer);
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < kCacheLen * kHeadDim; ++j) {
+      caches.input_data(i)[j] = static_cast<float>(100 * i + j);
+    }
+  }
+  float* input = caches.input_data(0);
+
+  // Already in that layout.
+  EXPECT_EQ(caches.set_transpose(false), Error::Ok);
+  EXPECT_EQ(caches.input_data(0), input);
+
+  EXPECT_EQ(caches.set_transpose(true), Error::Ok);
+  EXPECT_TRUE(caches.transposed());
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t pos = 0; pos < kCacheLen; ++pos) {
+      for (size_t d = 0; d < kHeadDim; ++d) {
+        EXPECT_EQ(
+            caches.input_data(i)[d * kCacheLen + pos],
+            static_cast<float>(100 * i + pos * kHeadDim + d));
+      }
+    }
+  }
+
+  EXPECT_EQ(caches.set_transpose(false), Error::Ok);
+  EXPECT_FALSE(caches.transposed());
+  EXPECT_EQ(caches.input_data(0), input);
+  for (size_t j = 0; j < kCacheLen * kHeadDim; ++j) {
+    EXPECT_EQ(caches.input_data(1)[j], static_cast<float>(100 + j));
+  }
+}
+
+TEST_F(StaticKVCacheTest, SetTransposeNeedsDoubleBuffers) {
+  StaticKVCache<float> caches(/*n_caches=*/1, /*cache_len=*/4, /*head_dim=*/3);
+  EXPECT_EQ(caches.set_transpose(true), Error::NotSupported);
+  EXPECT_FALSE(caches.transposed());
+}
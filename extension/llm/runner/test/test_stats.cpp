@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/stats.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::llm::LatencyStats;
+using ::executorch::extension::llm::Stats;
+using ::executorch::extension::llm::stats_to_json_string;
+using ::executorch::extension::llm::TokenPhase;
+
+TEST(LatencyStatsTest, NearestRankPercentiles) {
+  LatencyStats latencies;
+  EXPECT_EQ(latencies.percentile(50), 0);
+
+  // 100 down to 1, so that the samples are not already sorted.
+  for (long i = 100; i >= 1; --i) {
+    latencies.add(i);
+  }
+  EXPECT_EQ(latencies.percentile(0), 1);
+  EXPECT_EQ(latencies.percentile(50), 50);
+  EXPECT_EQ(latencies.percentile(90), 90);
+  EXPECT_EQ(latencies.percentile(99), 99);
+  EXPECT_EQ(latencies.percentile(100), 100);
+
+  latencies.clear();
+  latencies.add(7);
+  EXPECT_EQ(latencies.percentile(50), 7);
+  EXPECT_EQ(latencies.percentile(99), 7);
+}
+
+TEST(LatencyStatsTest, StatsRecordsTokenPhases) {
+  Stats stats;
+  for (int i = 0; i < 3; ++i) {
+    stats.on_token_phase_begin(TokenPhase::Token);
+    stats.on_sampling_begin();
+    stats.on_sampling_end();
+    stats.on_token_phase_end(TokenPhase::Token);
+  }
+  EXPECT_EQ(stats.latencies(TokenPhase::Token).samples_us.size(), 3);
+  EXPECT_EQ(stats.latencies(TokenPhase::Sampling).samples_us.size(), 3);
+  EXPECT_TRUE(stats.latencies(TokenPhase::Callback).samples_us.empty());
+  EXPECT_NE(
+      stats_to_json_string(stats).find("\"token_latency_us\":{\"token\":{"
+                                       "\"count\":3,"),
+      std::string::npos);
+
+  stats.reset();
+  EXPECT_TRUE(stats.latencies(TokenPhase::Token).samples_us.empty());
+  EXPECT_EQ(stats.aggregate_sampling_time_ms, 0);
+}
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <executorch/extension/llm/sampler/sampler.h>
+#include <executorch/extension/llm/sampler/token_constraint.h>
 #include <executorch/extension/module/module.h>
 #include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/platform/compiler.h>
@@ -61,6 +62,29 @@ class ET_EXPERIMENTAL TextDecoderRunner {
     should_stop_ = true;
   }
 
+  /**
+   * Constrains the tokens sampled by logits_to_token(logits_tensor), and so
+   * by TextPrefiller and TextTokenGenerator, to the ones the constraint
+   * allows, and advances it past every token sampled. Tokens picked by the
+   * model itself are taken as they are. The constraint is not owned, and
+   * nullptr removes it.
+   * @return InvalidArgument if the constraint has fewer tokens than the
+   * vocabulary.
+   */
+  ::executorch::runtime::Error set_token_constraint(
+      TokenConstraint* constraint) {
+    ET_CHECK_OR_RETURN_ERROR(
+        constraint == nullptr ||
+            constraint->vocab_size() >=
+                static_cast<size_t>(sampler_->vocab_size()),
+        InvalidArgument,
+        "The constraint has %zu tokens, for a vocabulary of %" PRId32,
+        constraint->vocab_size(),
+        sampler_->vocab_size());
+    token_constraint_ = constraint;
+    return ::executorch::runtime::Error::Ok;
+  }
+
   /**
    * Sample the next token from the logits tensor.
    * @param logits_tensor The logits tensor.
@@ -68,6 +92,49 @@ class ET_EXPERIMENTAL TextDecoderRunner {
    */
   inline int32_t logits_to_token(
       const executorch::aten::Tensor& logits_tensor) {
+    if (token_constraint_ == nullptr) {
+      return logits_to_token(logits_tensor, /*batch_index=*/0);
+    }
+    const int32_t token = logits_to_token(
+        logits_tensor,
+        /*batch_index=*/0,
+        /*token_index=*/-1,
+        token_constraint_->allowed_tokens());
+    if (token_constraint_->advance(token) != ::executorch::runtime::Error::Ok) {
+      ET_LOG(Error, "Token %" PRId32 " breaks the constraint", token);
+    }
+    return token;
+  }
+
+  /**
+   * Sample the next token of one sequence of a batch from the logits tensor.
+   * @param logits_tensor The logits tensor, of shape [batch, vocab_size] or
+   * [batch, seq_length, vocab_size]. A Long tensor of shape [batch] or
+   * [batch, seq_length] holds tokens already picked by the model, e.g. with
+   * an in-graph argmax, and is read as is.
+   * @param batch_index The sequence of the batch to sample for.
+   * @param token_index The position along seq_length to sample from, or -1
+   * for the last one. Ignored for logits of rank 2.
+   * @param allowed_tokens If set, the bitmask of the tokens that may be
+   * sampled, see Sampler::sample().
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const executorch::aten::Tensor& logits_tensor,
+      int64_t batch_index,
+      int64_t token_index = -1,
+      const uint32_t* allowed_tokens = nullptr) {
+    if (logits_tensor.scalar_type() == executorch::aten::ScalarType::Long) {
+      const auto* tokens = logits_tensor.const_data_ptr<int64_t>();
+      if (logits_tensor.dim() == 2) {
+        auto num_tokens = logits_tensor.size(1);
+        return static_cast<int32_t>(
+            tokens
+                [batch_index * num_tokens +
+                 (token_index < 0 ? num_tokens - 1 : token_index)]);
+      }
+      return static_cast<int32_t>(tokens[batch_index]);
+    }
     int32_t result = 0;
     ET_SWITCH_THREE_TYPES(
         Float,
@@ -79,17 +146,22 @@ class ET_EXPERIMENTAL TextDecoderRunner {
         CTYPE,
         [&]() {
           // If the logit_tensor rank is 3, the shape is [batch, seq_length,
-          // vocab_size], get the last logits, sample and return. Else the model
-          // outputs the last logit, directly sample and return.
+          // vocab_size], get the requested (by default the last) logits,
+          // sample and return. Else the model outputs the last logit,
+          // directly sample and return.
           auto* logits = logits_tensor.mutable_data_ptr<CTYPE>();
           if (logits_tensor.dim() == 3) {
             auto num_tokens = logits_tensor.size(1);
             auto vocab_size = logits_tensor.size(2);
             auto* logits_last = logits;
-            logits_last += (num_tokens - 1) * vocab_size;
-            result = sampler_->sample(logits_last);
+            logits_last += (batch_index * num_tokens +
+                            (token_index < 0 ? num_tokens - 1 : token_index)) *
+                vocab_size;
+            result = sampler_->sample(logits_last, {}, allowed_tokens);
           } else {
-            result = sampler_->sample(logits);
+            auto vocab_size = logits_tensor.size(logits_tensor.dim() - 1);
+            result = sampler_->sample(
+                logits + batch_index * vocab_size, {}, allowed_tokens);
           }
         });
     return result;
@@ -101,6 +173,7 @@ class ET_EXPERIMENTAL TextDecoderRunner {
   std::unique_ptr<Sampler> sampler_;
   bool use_kv_cache_;
   bool should_stop_{false};
+  TokenConstraint* token_constraint_ = nullptr;
 };
 
 } // namespace llm
@@ -11,6 +11,9 @@
 
 #include <executorch/extension/llm/runner/text_prefiller.h>
 
+#include <algorithm>
+#include <cstdint>
+
 namespace executorch {
 namespace extension {
 namespace llm {
@@ -18,10 +21,12 @@ namespace llm {
 TextPrefiller::TextPrefiller(
     TextDecoderRunner* text_decoder_runner,
     bool use_kv_cache,
-    bool enable_parallel_prefill)
+    bool enable_parallel_prefill,
+    int64_t max_chunk_size)
     : text_decoder_runner_(text_decoder_runner),
       use_kv_cache_(use_kv_cache),
-      enable_parallel_prefill_(enable_parallel_prefill) {}
+      enable_parallel_prefill_(enable_parallel_prefill),
+      max_chunk_size_(max_chunk_size) {}
 
 ::executorch::runtime::Result<uint64_t> TextPrefiller::prefill(
     std::vector<uint64_t>& prompt_tokens,
@@ -37,23 +42,20 @@ TextPrefiller::TextPrefiller(
   // store the token
   uint64_t cur_token;
   if (enable_parallel_prefill_ || !use_kv_cache_) {
-    // initialize tensor wrappers
-    auto tokens = from_blob(
-        prompt_tokens.data(),
-        {1, num_prompt_tokens},
-        executorch::aten::ScalarType::Long);
-
-    auto start_pos_tensor =
-        from_blob(&start_pos, {1}, executorch::aten::ScalarType::Long);
-
-    auto outputs_res = text_decoder_runner_->step(tokens, start_pos_tensor);
-
-    ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
-    ET_LOG(
-        Info, "Prefill token result numel(): %zu", outputs_res.get().numel());
-
-    start_pos += num_prompt_tokens;
-    cur_token = text_decoder_runner_->logits_to_token(outputs_res.get());
+    // Without a KV cache the whole sequence has to go in at once.
+    const int32_t chunk_size = use_kv_cache_ && max_chunk_size_ > 0
+        ? static_cast<int32_t>(std::min<int64_t>(max_chunk_size_, INT32_MAX))
+        : num_prompt_tokens;
+    int32_t offset = 0;
+    for (; num_prompt_tokens - offset > chunk_size; offset += chunk_size) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          prefill_chunk(prompt_tokens.data() + offset, chunk_size, start_pos)
+              .error());
+    }
+    // Only the logits of the last chunk are needed.
+    auto logits = ET_UNWRAP(prefill_chunk(
+        prompt_tokens.data() + offset, num_prompt_tokens - offset, start_pos));
+    cur_token = text_decoder_runner_->logits_to_token(logits);
   } else { // sequential prefill
     int64_t pos = 0; // position in the sequence
     // NOLINTNEXTLINE(facebook-hte-ParameterUncheckedArrayBounds)
@@ -91,6 +93,29 @@ TextPrefiller::TextPrefiller(
   return cur_token;
 }
 
+::executorch::runtime::Result<executorch::aten::Tensor>
+TextPrefiller::prefill_chunk(
+    uint64_t* tokens,
+    int32_t num_tokens,
+    int64_t& start_pos) {
+  // initialize tensor wrappers
+  auto tokens_tensor = tensor_pool_.from_blob(
+      tokens, {1, num_tokens}, executorch::aten::ScalarType::Long);
+
+  auto start_pos_tensor = tensor_pool_.from_blob(
+      &start_pos, {1}, executorch::aten::ScalarType::Long);
+
+  auto outputs_res =
+      text_decoder_runner_->step(tokens_tensor, start_pos_tensor);
+
+  ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+  ET_LOG(
+      Info, "Prefill token result numel(): %zu", outputs_res.get().numel());
+
+  start_pos += num_tokens;
+  return outputs_res.get();
+}
+
 } // namespace llm
 } // namespace extension
 } // namespace executorch
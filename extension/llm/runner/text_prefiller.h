@@ -19,10 +19,17 @@ namespace llm {
 
 class ET_EXPERIMENTAL TextPrefiller {
  public:
+  /**
+   * @param max_chunk_size The most tokens that parallel prefill with a KV
+   * cache feeds to the model in one step, e.g. the bound of the exported
+   * dynamic seq dim. Longer prompts are prefilled in chunks of this many
+   * tokens. Non-positive means no limit.
+   */
   TextPrefiller(
       TextDecoderRunner* text_decoder_runner,
       bool use_kv_cache_,
-      bool enable_parallel_prefill);
+      bool enable_parallel_prefill,
+      int64_t max_chunk_size = -1);
   /**
    * Prefill an LLM Module with the given text input.
    * @param prompt_tokens The text prompt tokens to the LLM Module. Encoded by
@@ -36,9 +43,19 @@ class ET_EXPERIMENTAL TextPrefiller {
       int64_t& start_pos);
 
  private:
+  // Feeds num_tokens tokens to the model in one step, and advances start_pos
+  // past them. Returns the logits.
+  ::executorch::runtime::Result<executorch::aten::Tensor> prefill_chunk(
+      uint64_t* tokens,
+      int32_t num_tokens,
+      int64_t& start_pos);
+
   TextDecoderRunner* text_decoder_runner_;
   bool use_kv_cache_;
   bool enable_parallel_prefill_;
+  int64_t max_chunk_size_;
+  // Recycles the input tensors of prefill_chunk().
+  TensorPool tensor_pool_;
 };
 
 } // namespace llm
@@ -12,8 +12,14 @@
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/core/event_tracer_hooks.h>
 #include <pytorch/tokenizers/tokenizer.h>
 
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#endif
+
 namespace executorch {
 namespace extension {
 namespace llm {
@@ -32,6 +38,15 @@ class ET_EXPERIMENTAL TextTokenGenerator {
         use_kv_cache_(use_kv_cache),
         stats_(stats) {}
 
+  /**
+   * Also records the phases of generating each token (see TokenPhase) as
+   * profiling events of the event tracer, named "llm::<phase>". The tracer
+   * must outlive the generation; nullptr stops recording.
+   */
+  inline void set_event_tracer(::executorch::runtime::EventTracer* tracer) {
+    event_tracer_ = tracer;
+  }
+
   /**
    * Token generation loop.
    * @param tokens prompt tokens as well as the first token generated by
@@ -39,15 +54,19 @@ class ET_EXPERIMENTAL TextTokenGenerator {
    * @param start_pos the start position of the new tokens, based on how many
    * prompt tokens is prefilled.
    * @param seq_len the total sequence length, including the prompt tokens, next
-   * token from prefill and new tokens.
+   * token from prefill and new tokens. With a ring buffer KV cache (see
+   * llama::sdpa_with_ring_kv_cache), start_pos keeps counting up and this may
+   * be past the model's max context length.
    * @param token_callback what to do after a token is generated.
+   * @param generated_tokens if set, every generated token is appended to it.
    * @return how many tokens are generated.
    */
   inline ::executorch::runtime::Result<int64_t> generate(
       std::vector<uint64_t> tokens,
       int64_t start_pos,
       int32_t seq_len,
-      std::function<void(const std::string&)> token_callback) {
+      std::function<void(const std::string&)> token_callback,
+      std::vector<uint64_t>* generated_tokens = nullptr) {
     ET_CHECK_MSG(
         !tokens.empty(), "Token generation loop shouldn't take empty tokens");
     int64_t pos = start_pos; // position in the sequence
@@ -77,22 +96,36 @@ class ET_EXPERIMENTAL TextTokenGenerator {
 
     should_stop_ = false;
 
+#if defined(ET_USE_THREADPOOL)
+    // Each step runs a handful of small parallel regions, so keep the workers
+    // awake between them instead of waking them up for every token.
+    ::executorch::extension::threadpool::KeepWorkersHotGuard hot_workers(
+        ::executorch::extension::threadpool::get_threadpool());
+#endif
+
     // Generate our tokens
     while (pos < seq_len - 1) {
+      const auto token_event = begin_phase(TokenPhase::Token);
+
       // Run the model
+      const auto model_event = begin_phase(TokenPhase::ModelExecution);
       auto logits_res =
           text_decoder_runner_->step(tokens_managed, start_pos_managed);
+      end_phase(TokenPhase::ModelExecution, model_event);
 
       ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
       executorch::aten::Tensor& logits_tensor = logits_res.get();
 
       prev_token = cur_token;
 
-      stats_->on_sampling_begin();
+      const auto sampling_event = begin_phase(TokenPhase::Sampling);
       cur_token = text_decoder_runner_->logits_to_token(logits_tensor);
-      stats_->on_sampling_end();
+      end_phase(TokenPhase::Sampling, sampling_event);
 
       pos++;
+      if (generated_tokens != nullptr) {
+        generated_tokens->push_back(cur_token);
+      }
 
       if (use_kv_cache_) {
         // update the token tensor. token_data will not be empty.
@@ -106,8 +139,16 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       }
 
       // print the token as string, decode it with the Tokenizer object
-      token_callback(
-          ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, cur_token)));
+      const auto decoding_event = begin_phase(TokenPhase::Decoding);
+      auto piece = tokenizer_->decode(prev_token, cur_token);
+      end_phase(TokenPhase::Decoding, decoding_event);
+      const std::string text = ET_UNWRAP_TOKENIZER(std::move(piece));
+
+      const auto callback_event = begin_phase(TokenPhase::Callback);
+      token_callback(text);
+      end_phase(TokenPhase::Callback, callback_event);
+
+      end_phase(TokenPhase::Token, token_event);
 
       if (should_stop_) {
         break;
@@ -131,6 +172,26 @@ class ET_EXPERIMENTAL TextTokenGenerator {
   }
 
  private:
+  inline ::executorch::runtime::EventTracerEntry begin_phase(TokenPhase phase) {
+    static constexpr const char* kEventNames[kNumTokenPhases] = {
+        "llm::token",
+        "llm::model_execution",
+        "llm::sampling",
+        "llm::decoding",
+        "llm::callback"};
+    stats_->on_token_phase_begin(phase);
+    return ::executorch::runtime::internal::event_tracer_begin_profiling_event(
+        event_tracer_, kEventNames[static_cast<size_t>(phase)]);
+  }
+
+  inline void end_phase(
+      TokenPhase phase,
+      ::executorch::runtime::EventTracerEntry event) {
+    ::executorch::runtime::internal::event_tracer_end_profiling_event(
+        event_tracer_, event);
+    stats_->on_token_phase_end(phase);
+  }
+
   ::tokenizers::Tokenizer* tokenizer_;
   TextDecoderRunner* text_decoder_runner_;
   std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
@@ -141,6 +202,7 @@ class ET_EXPERIMENTAL TextTokenGenerator {
 
   // stats
   Stats* stats_;
+  ::executorch::runtime::EventTracer* event_tracer_ = nullptr;
 };
 
 } // namespace llm
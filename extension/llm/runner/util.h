@@ -72,6 +72,14 @@ ET_EXPERIMENTAL long inline time_in_ms() {
   return time.tv_sec * 1000 + time.tv_nsec / 1000000;
 }
 
+ET_EXPERIMENTAL long inline time_in_us() {
+  // return time in microseconds from a monotonic clock, for timing short
+  // intervals like the steps of generating a token
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1000000 + time.tv_nsec / 1000;
+}
+
 // ----------------------------------------------------------------------------
 // utilities: memory usage
 
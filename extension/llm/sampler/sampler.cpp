@@ -33,121 +33,333 @@
  */
 
 #include <executorch/extension/llm/sampler/sampler.h>
+
 #include <algorithm>
+#include <limits>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 
 namespace executorch {
 namespace extension {
 namespace llm {
 
-// sampler stuff
+namespace {
+
+using Vec = ::executorch::vec::Vectorized<float>;
+
+// Loads Vec::size() logits as floats. Half and BFloat16 logits go through a
+// register-sized buffer, so they are never copied as a whole.
 template <typename T>
-int32_t Sampler::sample_argmax(T* probabilities) {
-  // return the index that has the highest probability
-  int max_i = 0;
-  T max_p = probabilities[0];
-  for (int i = 1; i < vocab_size_; i++) {
-    if (probabilities[i] > max_p) {
-      max_i = i;
-      max_p = probabilities[i];
-    }
+inline Vec load_float(const T* x) {
+  __at_align__ float buffer[Vec::size()];
+  for (int j = 0; j < Vec::size(); ++j) {
+    buffer[j] = static_cast<float>(x[j]);
   }
-  return max_i;
+  return Vec::loadu(buffer);
+}
+
+template <>
+inline Vec load_float<float>(const float* x) {
+  return Vec::loadu(x);
+}
+
+inline float reduce_max(const Vec& v) {
+  return ::executorch::vec::vec_reduce_all<float>(
+      [](Vec a, Vec b) { return ::executorch::vec::maximum(a, b); }, v);
+}
+
+inline float reduce_sum(const Vec& v) {
+  return ::executorch::vec::vec_reduce_all<float>(
+      [](Vec a, Vec b) { return a + b; }, v);
 }
 
 template <typename T>
-int32_t Sampler::sample_mult(T* probabilities, float coin) {
-  // sample index from probabilities (they must sum to 1!)
-  // coin is a random number in [0, 1), usually from random_f32()
-  T cdf = 0.0;
-  for (int i = 0; i < vocab_size_; i++) {
-    cdf += probabilities[i];
-    if (coin < cdf) {
-      return i;
-    }
+float max_logit(const T* x, int32_t n) {
+  Vec acc(-std::numeric_limits<float>::infinity());
+  int32_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    acc = ::executorch::vec::maximum(acc, load_float(x + i));
+  }
+  float max_val = reduce_max(acc);
+  for (; i < n; ++i) {
+    max_val = std::max(max_val, static_cast<float>(x[i]));
   }
-  return vocab_size_ - 1; // in case of rounding errors
+  return max_val;
 }
 
+// The softmax denominator, sum(exp((x - max_val) * scale)), with the
+// temperature folded into scale.
 template <typename T>
-int32_t Sampler::sample_topp(T* probabilities, float coin) {
-  // top-p sampling (or "nucleus sampling") samples from the smallest set of
-  // tokens that exceed probability topp. This way we never sample tokens that
-  // have very low probabilities and are less likely to go "off the rails".
-  // coin is a random number in [0, 1), usually from random_f32()
-  int n = vocab_size_;
-  int n0 = 0;
-  // quicksort indices in descending order of probabilities
-  // values smaller than (1 - topp) / (n - 1) cannot be part of the result
-  // so for efficiency we crop these out as candidates before sorting
-  std::unique_ptr<ProbIndex<T>[]> probindex =
-      std::make_unique<ProbIndex<T>[]>(vocab_size_);
-
-  const float cutoff = (1.0f - topp_) / (n - 1);
-  for (int i = 0; i < n; i++) {
-    if (probabilities[i] >= cutoff) {
-      probindex[n0].index = i;
-      probindex[n0].prob = probabilities[i];
-      n0++;
-    }
+float sum_weights(const T* x, int32_t n, float max_val, float scale) {
+  const Vec max_vec(max_val);
+  const Vec scale_vec(scale);
+  Vec acc(0.0f);
+  int32_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    acc = acc + ((load_float(x + i) - max_vec) * scale_vec).exp();
   }
+  float sum = reduce_sum(acc);
+  for (; i < n; ++i) {
+    sum += std::exp((static_cast<float>(x[i]) - max_val) * scale);
+  }
+  return sum;
+}
 
-  auto compare = [](const ProbIndex<T>& a, const ProbIndex<T>& b) {
-    return a.prob > b.prob;
-  };
-  std::sort(probindex.get(), probindex.get() + n0, compare);
-
-  // truncate the list where cumulative probability exceeds topp
-  T cumulative_prob = 0;
-  int last_idx = n0 - 1; // in case of rounding errors consider all elements
-  for (int i = 0; i < n0; i++) {
-    cumulative_prob += probindex[i].prob;
-    if (cumulative_prob > topp_) {
-      last_idx = i;
-      break; // we've exceeded topp by including last_idx
+// Returns the first index at which the running sum of the weights exceeds r.
+// Skips over a vector of weights at a time, and only walks the one it lands
+// in.
+template <typename T>
+int32_t sample_weights(
+    const T* x,
+    int32_t n,
+    float max_val,
+    float scale,
+    float r) {
+  const Vec max_vec(max_val);
+  const Vec scale_vec(scale);
+  __at_align__ float weights[Vec::size()];
+  float cdf = 0;
+  int32_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    const Vec w = ((load_float(x + i) - max_vec) * scale_vec).exp();
+    const float block = reduce_sum(w);
+    if (cdf + block <= r) {
+      cdf += block;
+      continue;
+    }
+    w.store(weights);
+    for (int j = 0; j < Vec::size(); ++j) {
+      cdf += weights[j];
+      if (r < cdf) {
+        return i + j;
+      }
     }
   }
-
-  // sample from the truncated list
-  const T& r = coin * cumulative_prob;
-  T cdf = 0;
-  for (int i = 0; i <= last_idx; i++) {
-    cdf += probindex[i].prob;
+  for (; i < n; ++i) {
+    cdf += std::exp((static_cast<float>(x[i]) - max_val) * scale);
     if (r < cdf) {
-      return probindex[i].index;
+      return i;
     }
   }
-  return probindex[last_idx].index; // in case of rounding errors
+  return n - 1; // in case of rounding errors
+}
+
+bool greater_prob(const ProbIndex<float>& a, const ProbIndex<float>& b) {
+  return a.prob > b.prob;
 }
 
+} // namespace
+
 Sampler::Sampler(
     int vocab_size,
     float temperature,
     float topp,
-    unsigned long long rng_seed)
+    unsigned long long rng_seed,
+    int32_t topk,
+    float minp,
+    float repetition_penalty)
     : vocab_size_(vocab_size),
       inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
       topp_(topp),
+      topk_(topk),
+      minp_(minp),
+      repetition_penalty_(repetition_penalty),
       rng_state_(rng_seed) {}
 
 template <typename T>
-static void softmax(T* x, int size) {
-  // find max value (for numerical stability)
-  T max_val = x[0];
-  for (int i = 1; i < size; i++) {
-    if (x[i] > max_val) {
-      max_val = x[i];
+void Sampler::apply_repetition_penalty(
+    T* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens) {
+  if (repetition_penalty_ == 1.0f || recent_tokens.empty()) {
+    return;
+  }
+  // Penalize each token once, however often it appeared.
+  penalized_tokens_.assign(recent_tokens.begin(), recent_tokens.end());
+  std::sort(penalized_tokens_.begin(), penalized_tokens_.end());
+  penalized_tokens_.erase(
+      std::unique(penalized_tokens_.begin(), penalized_tokens_.end()),
+      penalized_tokens_.end());
+  for (const auto token : penalized_tokens_) {
+    if (token >= static_cast<uint64_t>(vocab_size_)) {
+      continue;
     }
+    const float logit = static_cast<float>(logits[token]);
+    logits[token] = static_cast<T>(
+        logit > 0 ? logit / repetition_penalty_ : logit * repetition_penalty_);
   }
-  // exp and sum
-  T sum = 0;
-  for (int i = 0; i < size; i++) {
-    x[i] = expf(x[i] - max_val);
-    sum += x[i];
+}
+
+template <typename T>
+void Sampler::apply_token_mask(T* logits, const uint32_t* allowed_tokens) {
+  // Whole words of the mask are usually all set or all clear, so only the
+  // others are looked at bit by bit.
+  const T masked = static_cast<T>(-std::numeric_limits<float>::infinity());
+  for (int32_t begin = 0; begin < vocab_size_; begin += 32) {
+    const uint32_t bits = allowed_tokens[begin / 32];
+    if (bits == UINT32_MAX) {
+      continue;
+    }
+    const int32_t end = std::min(begin + 32, vocab_size_);
+    if (bits == 0) {
+      std::fill(logits + begin, logits + end, masked);
+      continue;
+    }
+    for (int32_t i = begin; i < end; ++i) {
+      if (((bits >> (i - begin)) & 1) == 0) {
+        logits[i] = masked;
+      }
+    }
   }
-  // normalize
-  for (int i = 0; i < size; i++) {
-    x[i] /= sum;
+}
+
+template <typename T>
+int32_t Sampler::sample_argmax(const T* logits) {
+  // return the index that has the highest probability
+  const float max_val = max_logit(logits, vocab_size_);
+  for (int32_t i = 0; i < vocab_size_; i++) {
+    if (static_cast<float>(logits[i]) == max_val) {
+      return i;
+    }
   }
+  return 0; // only if there are NaNs
+}
+
+template <typename T>
+int32_t Sampler::sample_topk(const T* logits, float coin) {
+  // Keep the topk largest logits in a min-heap. Once it is full, most logits
+  // are rejected by a single comparison with its top.
+  candidates_.clear();
+  for (int32_t i = 0; i < topk_; i++) {
+    candidates_.push_back({static_cast<float>(logits[i]), i});
+  }
+  std::make_heap(candidates_.begin(), candidates_.end(), greater_prob);
+  float threshold = candidates_.front().prob;
+  for (int32_t i = topk_; i < vocab_size_; i++) {
+    const float logit = static_cast<float>(logits[i]);
+    if (logit > threshold) {
+      std::pop_heap(candidates_.begin(), candidates_.end(), greater_prob);
+      candidates_.back() = {logit, i};
+      std::push_heap(candidates_.begin(), candidates_.end(), greater_prob);
+      threshold = candidates_.front().prob;
+    }
+  }
+  std::sort(candidates_.begin(), candidates_.end(), greater_prob);
+
+  // Turn the logits into unnormalized probabilities, relative to the most
+  // likely token, and drop the ones under minp.
+  const float max_val = candidates_.front().prob;
+  float total = 0;
+  size_t num_kept = 0;
+  for (auto& candidate : candidates_) {
+    candidate.prob = std::exp((candidate.prob - max_val) * inv_temperature_);
+    if (candidate.prob < minp_) {
+      break;
+    }
+    total += candidate.prob;
+    num_kept++;
+  }
+  candidates_.resize(num_kept);
+  return sample_candidates(total, coin);
+}
+
+template <typename T>
+int32_t Sampler::sample_vocab(const T* logits, float coin) {
+  const int32_t n = vocab_size_;
+  const float max_val = max_logit(logits, n);
+  const float sum = sum_weights(logits, n, max_val, inv_temperature_);
+  if (!use_topp() && minp_ <= 0) {
+    // simply sample from the predicted probability distribution
+    return sample_weights(logits, n, max_val, inv_temperature_, coin * sum);
+  }
+
+  // Only look at the tokens that can make the cut. With top-p alone, values
+  // smaller than (1 - topp) / (n - 1) cannot be part of the result. The
+  // cutoff is compared with the logits directly, instead of computing every
+  // probability.
+  const float min_weight = minp_ > 0
+      ? std::min(minp_, 1.0f)
+      : std::min((1.0f - topp_) / (n - 1) * sum, 1.0f);
+  const float min_logit = max_val + std::log(min_weight) / inv_temperature_;
+  candidates_.clear();
+  float total = 0;
+  for (int32_t i = 0; i < n; i++) {
+    const float logit = static_cast<float>(logits[i]);
+    if (logit >= min_logit) {
+      const float weight = std::exp((logit - max_val) * inv_temperature_);
+      if (weight >= min_weight) {
+        candidates_.push_back({weight, i});
+        total += weight;
+      }
+    }
+  }
+  if (candidates_.empty()) {
+    // in case of rounding errors, fall back to the most likely token
+    return sample_argmax(logits);
+  }
+  if (minp_ <= 0) {
+    // The cropped tokens still count towards top-p.
+    total = sum;
+  }
+  return sample_candidates(total, coin);
+}
+
+int32_t Sampler::sample_candidates(float total, float coin) {
+  // top-p sampling (or "nucleus sampling") samples from the smallest set of
+  // tokens that exceed probability topp. This way we never sample tokens that
+  // have very low probabilities and are less likely to go "off the rails".
+  const int32_t n0 = static_cast<int32_t>(candidates_.size());
+  float cumulative_prob = 0;
+  int32_t last_idx = n0 - 1; // in case of rounding errors consider all
+  if (use_topp()) {
+    // Instead of sorting all the candidates, move the most likely ones to
+    // the front with nth_element, halving the range that can hold the
+    // cutoff every time, and only sort the last few.
+    auto begin = candidates_.begin();
+    int32_t lo = 0;
+    int32_t hi = n0;
+    float remaining = topp_ * total;
+    while (hi - lo > 32) {
+      const int32_t mid = lo + (hi - lo) / 2;
+      std::nth_element(begin + lo, begin + mid, begin + hi, greater_prob);
+      float mass = 0;
+      for (int32_t i = lo; i < mid; i++) {
+        mass += candidates_[i].prob;
+      }
+      if (mass > remaining) {
+        hi = mid;
+      } else {
+        remaining -= mass;
+        cumulative_prob += mass;
+        lo = mid;
+      }
+    }
+    std::sort(begin + lo, begin + hi, greater_prob);
+    last_idx = hi - 1;
+    for (int32_t i = lo; i < hi; i++) {
+      cumulative_prob += candidates_[i].prob;
+      if (candidates_[i].prob > remaining) {
+        last_idx = i;
+        break; // we've exceeded topp by including last_idx
+      }
+      remaining -= candidates_[i].prob;
+    }
+  } else {
+    for (int32_t i = 0; i < n0; i++) {
+      cumulative_prob += candidates_[i].prob;
+    }
+  }
+
+  // sample from the truncated list
+  const float r = coin * cumulative_prob;
+  float cdf = 0;
+  for (int32_t i = 0; i <= last_idx; i++) {
+    cdf += candidates_[i].prob;
+    if (r < cdf) {
+      return candidates_[i].index;
+    }
+  }
+  return candidates_[last_idx].index; // in case of rounding errors
 }
 
 static unsigned int random_u32(unsigned long long* state) {
@@ -164,30 +376,43 @@ static float random_f32(unsigned long long* state) { // random float32 in [0,1)
 
 template <typename T>
 int32_t Sampler::sample(T* logits) {
+  return sample(logits, {});
+}
+
+template <typename T>
+int32_t Sampler::sample(
+    T* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens) {
+  return sample(logits, recent_tokens, nullptr);
+}
+
+template <typename T>
+int32_t Sampler::sample(
+    T* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens,
+    const uint32_t* allowed_tokens) {
+  apply_repetition_penalty(logits, recent_tokens);
+  if (allowed_tokens != nullptr) {
+    // The masked logits are -inf, whose weight is 0 everywhere below.
+    apply_token_mask(logits, allowed_tokens);
+  }
   // sample the token given the logits and some hyperparameters
-  int next;
   if (inv_temperature_ == 0.0f) {
     // greedy argmax sampling: take the token with the highest probability
-    next = sample_argmax(logits);
-  } else {
-    // apply the temperature to the logits
-    for (int q = 0; q < vocab_size_; q++) {
-      logits[q] *= inv_temperature_;
-    }
-    // apply softmax to the logits to get the probabilities for next token
-    softmax(logits, vocab_size_);
-    // flip a (float) coin (this is our source of entropy for sampling)
-    float coin = random_f32(&rng_state_);
-    // we sample from this distribution to get the next token
-    if (topp_ <= 0 || topp_ >= 1) {
-      // simply sample from the predicted probability distribution
-      next = sample_mult(logits, coin);
-    } else {
-      // top-p (nucleus) sampling, clamping the least likely tokens to zero
-      next = sample_topp(logits, coin);
-    }
+    return sample_argmax(logits);
   }
-  return next;
+  // flip a (float) coin (this is our source of entropy for sampling)
+  const float coin = random_f32(&rng_state_);
+  const int32_t token = topk_ > 0 && topk_ < vocab_size_
+      ? sample_topk(logits, coin)
+      : sample_vocab(logits, coin);
+  if (allowed_tokens != nullptr &&
+      ((allowed_tokens[token / 32] >> (token % 32)) & 1) == 0) {
+    // The fallbacks for rounding errors may land on a masked token, unlike
+    // the argmax.
+    return sample_argmax(logits);
+  }
+  return token;
 }
 
 template int32_t Sampler::sample<float>(float* logits);
@@ -195,6 +420,27 @@ template int32_t Sampler::sample<executorch::aten::Half>(
     executorch::aten::Half* logits);
 template int32_t Sampler::sample<executorch::aten::BFloat16>(
     executorch::aten::BFloat16* logits);
+template int32_t Sampler::sample<float>(
+    float* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens);
+template int32_t Sampler::sample<executorch::aten::Half>(
+    executorch::aten::Half* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens);
+template int32_t Sampler::sample<executorch::aten::BFloat16>(
+    executorch::aten::BFloat16* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens);
+template int32_t Sampler::sample<float>(
+    float* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens,
+    const uint32_t* allowed_tokens);
+template int32_t Sampler::sample<executorch::aten::Half>(
+    executorch::aten::Half* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens,
+    const uint32_t* allowed_tokens);
+template int32_t Sampler::sample<executorch::aten::BFloat16>(
+    executorch::aten::BFloat16* logits,
+    executorch::aten::ArrayRef<uint64_t> recent_tokens,
+    const uint32_t* allowed_tokens);
 
 } // namespace llm
 } // namespace extension
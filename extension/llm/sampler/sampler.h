@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <vector>
 #ifdef USE_ATEN_LIB
 #include <torch/torch.h>
 #endif
@@ -34,29 +35,95 @@ struct ET_EXPERIMENTAL ProbIndex {
 
 class ET_EXPERIMENTAL Sampler {
  public:
+  /**
+   * @param vocab_size The number of logits per sample.
+   * @param temperature The sampling temperature, 0 for greedy argmax.
+   * @param topp Only sample from the most likely tokens whose probabilities
+   * add up to topp. Disabled unless in (0, 1).
+   * @param rng_seed The seed of the random number generator.
+   * @param topk Only sample from the topk most likely tokens. Disabled if 0.
+   * @param minp Only sample from the tokens at least minp times as likely as
+   * the most likely one. Disabled if 0.
+   * @param repetition_penalty How much to discourage the recent tokens passed
+   * to sample(): their positive logits are divided by it and their negative
+   * ones multiplied by it. Disabled if 1.
+   *
+   * The filters apply in the order top-k, min-p, top-p, each on the
+   * distribution renormalized after the previous one.
+   */
   Sampler(
       int32_t vocab_size,
       float temperature,
       float topp,
-      unsigned long long rng_seed);
+      unsigned long long rng_seed,
+      int32_t topk = 0,
+      float minp = 0.0f,
+      float repetition_penalty = 1.0f);
 
+  /**
+   * Samples a token from logits, which may be overwritten. T is float, Half
+   * or BFloat16; the math is done in float either way, without converting the
+   * logits up front.
+   */
   template <typename T>
   int32_t sample(T* logits);
 
+  /// Same as above, applying the repetition penalty to recent_tokens first.
+  template <typename T>
+  int32_t sample(
+      T* logits,
+      executorch::aten::ArrayRef<uint64_t> recent_tokens);
+
+  /**
+   * Same as above, only sampling the tokens set in allowed_tokens, a bitmask
+   * of vocab_size bits where bit i % 32 of word i / 32 is token i, e.g. from
+   * TokenConstraint::allowed_tokens(). It must allow at least one token.
+   * Ignored if nullptr.
+   */
+  template <typename T>
+  int32_t sample(
+      T* logits,
+      executorch::aten::ArrayRef<uint64_t> recent_tokens,
+      const uint32_t* allowed_tokens);
+
+  int32_t vocab_size() const {
+    return vocab_size_;
+  }
+
  private:
   template <typename T>
-  int32_t sample_topp(T* probabilities, float coin);
+  void apply_repetition_penalty(
+      T* logits,
+      executorch::aten::ArrayRef<uint64_t> recent_tokens);
   template <typename T>
-  int32_t sample_mult(T* probabilities, float coin);
+  void apply_token_mask(T* logits, const uint32_t* allowed_tokens);
   template <typename T>
-  int32_t sample_argmax(T* probabilities);
+  int32_t sample_argmax(const T* logits);
+  template <typename T>
+  int32_t sample_topk(const T* logits, float coin);
+  template <typename T>
+  int32_t sample_vocab(const T* logits, float coin);
+  int32_t sample_candidates(float total, float coin);
+
+  bool use_topp() const {
+    return topp_ > 0 && topp_ < 1;
+  }
 
  private:
   int32_t vocab_size_;
   // reciprocal of temperature, or 0 if temperature == 0.
   float inv_temperature_;
   float topp_;
+  int32_t topk_;
+  float minp_;
+  float repetition_penalty_;
   unsigned long long rng_state_;
+
+  // Scratch space, kept across calls to not allocate for every token. The
+  // candidates hold logits while they are selected, then unnormalized
+  // probabilities.
+  std::vector<ProbIndex<float>> candidates_;
+  std::vector<uint64_t> penalized_tokens_;
 };
 
 } // namespace llm
@@ -1,6 +1,23 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
 def define_common_targets():
+    runtime.cxx_library(
+        name = "token_constraint",
+        exported_headers = [
+            "token_constraint.h",
+        ],
+        srcs = [
+            "token_constraint.cpp",
+        ],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/platform:compiler",
+        ],
+    )
+
     for aten in (True, False):
         aten_suffix = "_aten" if aten else ""
 
@@ -18,6 +35,9 @@ def define_common_targets():
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
+            deps = [
+                "//executorch/kernels/optimized:libvec",
+            ],
             external_deps = [
                 "libtorch",
             ] if aten else [],
@@ -22,3 +22,13 @@ def define_common_targets():
             "//caffe2:torch-cpp",
         ],
     )
+
+    runtime.cxx_test(
+        name = "test_token_constraint",
+        srcs = [
+            "test_token_constraint.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/sampler:token_constraint",
+        ],
+    )
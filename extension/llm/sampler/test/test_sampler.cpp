@@ -11,6 +11,10 @@
 #include <gtest/gtest.h>
 #include <torch/torch.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using ::executorch::extension::llm::Sampler;
 
@@ -39,3 +43,183 @@ TEST(SamplerTest, TestArgMaxWithFP16) {
   input[0][0][396] = 1.0f;
   EXPECT_EQ(sampler.sample(input.data_ptr<c10::Half>()), 396);
 }
+
+namespace {
+
+// Returns how often each token is sampled from a fresh copy of logits.
+template <typename T>
+std::vector<int> sample_counts(
+    Sampler& sampler,
+    const std::vector<T>& logits,
+    int num_samples) {
+  std::vector<int> counts(logits.size(), 0);
+  for (int i = 0; i < num_samples; i++) {
+    std::vector<T> copy = logits;
+    counts[sampler.sample(copy.data())]++;
+  }
+  return counts;
+}
+
+} // namespace
+
+TEST(SamplerTest, TestTopK) {
+  constexpr int kVocabSize = 1000;
+  Sampler sampler{
+      kVocabSize,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.0f,
+      /*rng_seed*/ 42,
+      /*topk*/ 3};
+  std::vector<float> logits(kVocabSize);
+  for (int i = 0; i < kVocabSize; i++) {
+    logits[i] = static_cast<float>((i * 37) % 101) / 100.0f;
+  }
+  logits[17] = logits[513] = logits[998] = 2.0f;
+  auto counts = sample_counts(sampler, logits, 300);
+  EXPECT_EQ(counts[17] + counts[513] + counts[998], 300);
+  EXPECT_GT(counts[17], 50);
+  EXPECT_GT(counts[513], 50);
+  EXPECT_GT(counts[998], 50);
+}
+
+TEST(SamplerTest, TestMinP) {
+  constexpr int kVocabSize = 100;
+  Sampler sampler{
+      kVocabSize,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.0f,
+      /*rng_seed*/ 42,
+      /*topk*/ 0,
+      /*minp*/ 0.4f};
+  std::vector<float> logits(kVocabSize, -1.0f);
+  logits[5] = 0.0f;
+  logits[7] = std::log(0.5f);
+  auto counts = sample_counts(sampler, logits, 300);
+  EXPECT_EQ(counts[5] + counts[7], 300);
+  EXPECT_GT(counts[7], 50);
+}
+
+TEST(SamplerTest, TestTopPDistribution) {
+  // Not a multiple of the vector width.
+  constexpr int kVocabSize = 37;
+  Sampler sampler{
+      kVocabSize,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.7f,
+      /*rng_seed*/ 42};
+  std::vector<float> logits(kVocabSize, -100.0f);
+  logits[3] = std::log(0.5f);
+  logits[30] = std::log(0.3f);
+  logits[36] = std::log(0.2f);
+  constexpr int kNumSamples = 10000;
+  auto counts = sample_counts(sampler, logits, kNumSamples);
+  // The nucleus is {3, 30}, renormalized to 0.625 / 0.375.
+  EXPECT_EQ(counts[3] + counts[30], kNumSamples);
+  EXPECT_NEAR(counts[3] / static_cast<double>(kNumSamples), 0.625, 0.02);
+}
+
+TEST(SamplerTest, TestMultinomialDistribution) {
+  constexpr int kVocabSize = 37;
+  Sampler sampler{
+      kVocabSize,
+      /*temperature*/ 0.5f,
+      /*topp*/ 1.0f,
+      /*rng_seed*/ 42};
+  std::vector<float> logits(kVocabSize);
+  double sum = 0;
+  for (int i = 0; i < kVocabSize; i++) {
+    logits[i] = static_cast<float>(i % 7) / 4.0f;
+    sum += std::exp(logits[i] * 2.0);
+  }
+  constexpr int kNumSamples = 20000;
+  auto counts = sample_counts(sampler, logits, kNumSamples);
+  for (int i = 0; i < kVocabSize; i++) {
+    EXPECT_NEAR(
+        counts[i] / static_cast<double>(kNumSamples),
+        std::exp(logits[i] * 2.0) / sum,
+        0.01)
+        << "token " << i;
+  }
+}
+
+TEST(SamplerTest, TestRepetitionPenalty) {
+  constexpr int kVocabSize = 10;
+  Sampler sampler{
+      kVocabSize,
+      /*temperature*/ 0.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0,
+      /*topk*/ 0,
+      /*minp*/ 0.0f,
+      /*repetition_penalty*/ 1.2f};
+  std::vector<float> logits(kVocabSize, -1.0f);
+  logits[2] = 2.0f;
+  logits[4] = 1.5f;
+  // Repeats are penalized once: 2.0 / 1.2 is still the largest.
+  std::vector<uint64_t> recent = {2, 2, 2};
+  auto copy = logits;
+  EXPECT_EQ(sampler.sample(copy.data(), {recent.data(), recent.size()}), 2);
+  // Without repeats, 2.0 / 1.2 falls under 1.8.
+  recent = {2};
+  copy = logits;
+  copy[4] = 1.8f;
+  EXPECT_EQ(sampler.sample(copy.data(), {recent.data(), recent.size()}), 4);
+  // Negative logits are multiplied: -0.5 * 1.2 falls under -0.55.
+  std::fill(copy.begin(), copy.end(), -1.0f);
+  copy[0] = -0.5f;
+  copy[1] = -0.55f;
+  recent = {0};
+  EXPECT_EQ(sampler.sample(copy.data(), {recent.data(), recent.size()}), 1);
+}
+
+TEST(SamplerTest, TestBFloat16MatchesFloat) {
+  constexpr int kVocabSize = 517;
+  std::vector<float> logits(kVocabSize);
+  std::vector<c10::BFloat16> bf16_logits(kVocabSize);
+  for (int i = 0; i < kVocabSize; i++) {
+    // Exactly representable in bfloat16.
+    logits[i] = static_cast<float>((i * 13) % 31) / 8.0f;
+    bf16_logits[i] = logits[i];
+  }
+  for (const int topk : {0, 40}) {
+    Sampler sampler{kVocabSize, 0.7f, 0.9f, /*rng_seed*/ 42, topk};
+    Sampler bf16_sampler{kVocabSize, 0.7f, 0.9f, /*rng_seed*/ 42, topk};
+    for (int i = 0; i < 100; i++) {
+      auto copy = logits;
+      auto bf16_copy = bf16_logits;
+      EXPECT_EQ(
+          sampler.sample(copy.data()), bf16_sampler.sample(bf16_copy.data()));
+    }
+  }
+}
+
+TEST(SamplerTest, TestTokenMask) {
+  constexpr int kVocabSize = 100;
+  // Allow 3, 40 and 70, which are the least likely.
+  std::vector<uint32_t> allowed((kVocabSize + 31) / 32, 0);
+  for (const int token : {3, 40, 70}) {
+    allowed[token / 32] |= 1u << (token % 32);
+  }
+  std::vector<float> logits(kVocabSize, 5.0f);
+  logits[3] = -1.0f;
+  logits[40] = 1.0f;
+  logits[70] = 0.0f;
+
+  Sampler greedy{kVocabSize, /*temperature*/ 0.0f, /*topp*/ 0.9f, 0};
+  auto copy = logits;
+  EXPECT_EQ(greedy.sample(copy.data(), {}, allowed.data()), 40);
+
+  for (const int topk : {0, 2, 10}) {
+    Sampler sampler{kVocabSize, 1.0f, /*topp*/ 0.0f, /*rng_seed*/ 3, topk};
+    std::vector<int> counts(kVocabSize, 0);
+    for (int i = 0; i < 1000; i++) {
+      copy = logits;
+      counts[sampler.sample(copy.data(), {}, allowed.data())]++;
+    }
+    EXPECT_EQ(counts[3] + counts[40] + counts[70], 1000) << "topk " << topk;
+    EXPECT_GT(counts[40], counts[70]);
+    if (topk == 2) {
+      EXPECT_EQ(counts[3], 0);
+    }
+  }
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/sampler/token_constraint.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ::testing;
+using ::executorch::extension::llm::TokenConstraint;
+using ::executorch::runtime::Error;
+
+namespace {
+
+// The bytes, then a few merges, an EOS token and a special token.
+std::vector<std::string> make_vocab() {
+  std::vector<std::string> vocab;
+  for (int c = 0; c < 256; ++c) {
+    vocab.emplace_back(1, static_cast<char>(c));
+  }
+  for (const char* merge :
+       {"{\"", "\":", "true", "false", "}", "\"a", "12", "ab", "\"}"}) {
+    vocab.emplace_back(merge);
+  }
+  vocab.emplace_back(""); // EOS
+  vocab.emplace_back(""); // BOS
+  return vocab;
+}
+
+std::vector<uint64_t> allowed(const TokenConstraint& constraint) {
+  std::vector<uint64_t> tokens;
+  for (uint64_t i = 0; i < constraint.vocab_size(); ++i) {
+    if (constraint.is_allowed(i)) {
+      tokens.push_back(i);
+    }
+  }
+  return tokens;
+}
+
+} // namespace
+
+class TokenConstraintTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    vocab_ = make_vocab();
+    for (size_t i = 0; i < vocab_.size(); ++i) {
+      ids_[vocab_[i]] = i;
+    }
+    eos_ = vocab_.size() - 2;
+  }
+
+  uint64_t id(const std::string& token) {
+    return ids_.at(token);
+  }
+
+  std::vector<std::string> vocab_;
+  std::unordered_map<std::string, uint64_t> ids_;
+  uint64_t eos_;
+};
+
+TEST_F(TokenConstraintTest, Alternation) {
+  auto constraint = TokenConstraint::from_regex("true|false", vocab_, {eos_});
+  ASSERT_EQ(constraint.error(), Error::Ok);
+  EXPECT_EQ(
+      allowed(*constraint),
+      (std::vector<uint64_t>{id("f"), id("t"), id("true"), id("false")}));
+
+  ASSERT_EQ(constraint->advance(id("t")), Error::Ok);
+  EXPECT_EQ(allowed(*constraint), (std::vector<uint64_t>{id("r")}));
+  EXPECT_EQ(constraint->advance(id("true")), Error::InvalidArgument);
+  for (const char* token : {"r", "u", "e"}) {
+    ASSERT_EQ(constraint->advance(id(token)), Error::Ok);
+  }
+  // Only EOS can follow a match that can't be extended.
+  EXPECT_EQ(allowed(*constraint), (std::vector<uint64_t>{eos_}));
+  EXPECT_FALSE(constraint->is_complete());
+  ASSERT_EQ(constraint->advance(eos_), Error::Ok);
+  EXPECT_TRUE(constraint->is_complete());
+
+  constraint->reset();
+  EXPECT_FALSE(constraint->is_complete());
+  EXPECT_TRUE(constraint->is_allowed(id("false")));
+}
+
+TEST_F(TokenConstraintTest, JsonObject) {
+  auto constraint = TokenConstraint::from_regex(
+      R"(\{"a": ?(true|false|\d{1,3})(, ?"[a-z]+": ?"[^"]*")*\})",
+      vocab_,
+      {eos_});
+  ASSERT_EQ(constraint.error(), Error::Ok);
+  EXPECT_TRUE(constraint->is_allowed(id("{\"")));
+  EXPECT_FALSE(constraint->is_allowed(id("\"a")));
+  EXPECT_FALSE(constraint->is_allowed(eos_));
+
+  for (const char* token : {"{\"", "a", "\":", "12", "3", ",", "\"a", "b",
+                            "\":", "\"", "}", "\"}"}) {
+    ASSERT_EQ(constraint->advance(id(token)), Error::Ok) << token;
+  }
+  // 4 digits are too many, the string can go on, and "} ends the object.
+  constraint->reset();
+  for (const char* token : {"{\"", "a", "\":", "12", "3"}) {
+    ASSERT_EQ(constraint->advance(id(token)), Error::Ok) << token;
+  }
+  EXPECT_FALSE(constraint->is_allowed(id("1")));
+  EXPECT_TRUE(constraint->is_allowed(id("}")));
+  EXPECT_TRUE(constraint->is_allowed(id(",")));
+  EXPECT_FALSE(constraint->is_allowed(id("\"}")));
+  ASSERT_EQ(constraint->advance(id("}")), Error::Ok);
+  EXPECT_EQ(allowed(*constraint), (std::vector<uint64_t>{eos_}));
+}
+
+TEST_F(TokenConstraintTest, SpecialTokensAreNeverAllowed) {
+  auto constraint = TokenConstraint::from_regex(".*", vocab_, {eos_});
+  ASSERT_EQ(constraint.error(), Error::Ok);
+  EXPECT_FALSE(constraint->is_allowed(vocab_.size() - 1));
+  EXPECT_FALSE(constraint->is_allowed(id("\n")));
+  EXPECT_TRUE(constraint->is_allowed(id("ab")));
+  EXPECT_TRUE(constraint->is_allowed(eos_));
+  EXPECT_FALSE(constraint->is_allowed(vocab_.size()));
+}
+
+TEST_F(TokenConstraintTest, InvalidRegex) {
+  for (const char* pattern : {"(ab", "ab)", "[a-", "a{3,2}", "\\q", "^a"}) {
+    EXPECT_NE(
+        TokenConstraint::from_regex(pattern, vocab_, {eos_}).error(),
+        Error::Ok)
+        << pattern;
+  }
+  EXPECT_EQ(
+      TokenConstraint::from_regex("[^\\x00-\\xff]", vocab_, {eos_}).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      TokenConstraint::from_regex("a", vocab_, {vocab_.size()}).error(),
+      Error::InvalidArgument);
+}
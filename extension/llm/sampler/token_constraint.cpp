@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/sampler/token_constraint.h>
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cinttypes>
+#include <map>
+#include <numeric>
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+namespace {
+
+constexpr uint32_t kDeadState = UINT32_MAX;
+constexpr uint32_t kNoState = UINT32_MAX;
+// Bounds on the size of the automata, as every DFA state costs a bitmask of
+// the vocabulary.
+constexpr size_t kMaxNfaStates = 1 << 16;
+constexpr size_t kMaxDfaStates = 2048;
+constexpr int kMaxRepeat = 1000;
+
+using ByteSet = std::bitset<256>;
+
+struct RegexNode {
+  enum class Kind { Bytes, Concat, Alternate, Repeat };
+
+  Kind kind;
+  // For Bytes.
+  ByteSet bytes;
+  std::vector<RegexNode> children;
+  // For Repeat, with max < 0 for no limit.
+  int min = 0;
+  int max = 0;
+};
+
+ByteSet byte_range(int first, int last) {
+  ByteSet bytes;
+  for (int c = first; c <= last; ++c) {
+    bytes.set(c);
+  }
+  return bytes;
+}
+
+int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// Recursive descent parser of the regex subset documented in
+// token_constraint.h.
+class RegexParser {
+ public:
+  explicit RegexParser(std::string_view pattern) : pattern_(pattern) {}
+
+  Result<RegexNode> parse() {
+    auto node = ET_UNWRAP(parse_alternate());
+    ET_CHECK_OR_RETURN_ERROR(
+        at_end(), InvalidArgument, "unmatched ')' at %zu in regex", pos_);
+    return node;
+  }
+
+ private:
+  bool at_end() const {
+    return pos_ >= pattern_.size();
+  }
+
+  bool consume(char c) {
+    if (!at_end() && pattern_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  Result<RegexNode> parse_alternate() {
+    RegexNode node{RegexNode::Kind::Alternate};
+    node.children.push_back(ET_UNWRAP(parse_concat()));
+    while (consume('|')) {
+      node.children.push_back(ET_UNWRAP(parse_concat()));
+    }
+    if (node.children.size() == 1) {
+      RegexNode only = std::move(node.children[0]);
+      return only;
+    }
+    return node;
+  }
+
+  Result<RegexNode> parse_concat() {
+    RegexNode node{RegexNode::Kind::Concat};
+    while (!at_end() && pattern_[pos_] != '|' && pattern_[pos_] != ')') {
+      node.children.push_back(ET_UNWRAP(parse_repeat()));
+    }
+    return node;
+  }
+
+  Result<RegexNode> parse_repeat() {
+    auto node = ET_UNWRAP(parse_atom());
+    while (!at_end()) {
+      int min = 0;
+      int max = 0;
+      if (consume('*')) {
+        max = -1;
+      } else if (consume('+')) {
+        min = 1;
+        max = -1;
+      } else if (consume('?')) {
+        max = 1;
+      } else if (consume('{')) {
+        min = ET_UNWRAP(parse_count());
+        max = min;
+        if (consume(',')) {
+          max = !at_end() && pattern_[pos_] == '}' ? -1
+                                                   : ET_UNWRAP(parse_count());
+        }
+        ET_CHECK_OR_RETURN_ERROR(
+            consume('}') && (max < 0 || min <= max),
+            InvalidArgument,
+            "invalid repetition at %zu in regex",
+            pos_);
+      } else {
+        break;
+      }
+      RegexNode repeat{RegexNode::Kind::Repeat};
+      repeat.min = min;
+      repeat.max = max;
+      repeat.children.push_back(std::move(node));
+      node = std::move(repeat);
+    }
+    return node;
+  }
+
+  Result<int> parse_count() {
+    int count = 0;
+    const size_t start = pos_;
+    while (!at_end() && pattern_[pos_] >= '0' && pattern_[pos_] <= '9') {
+      count = count * 10 + (pattern_[pos_++] - '0');
+      ET_CHECK_OR_RETURN_ERROR(
+          count <= kMaxRepeat,
+          NotSupported,
+          "repetitions of more than %d at %zu in regex",
+          kMaxRepeat,
+          start);
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        pos_ > start,
+        InvalidArgument,
+        "expected a count at %zu in regex",
+        pos_);
+    return count;
+  }
+
+  Result<RegexNode> parse_atom() {
+    RegexNode node{RegexNode::Kind::Bytes};
+    const char c = pattern_[pos_++];
+    switch (c) {
+      case '(': {
+        if (consume('?')) {
+          ET_CHECK_OR_RETURN_ERROR(
+              consume(':'),
+              NotSupported,
+              "only (?:...) groups are supported, at %zu in regex",
+              pos_);
+        }
+        auto group = ET_UNWRAP(parse_alternate());
+        ET_CHECK_OR_RETURN_ERROR(
+            consume(')'), InvalidArgument, "missing ')' in regex");
+        return group;
+      }
+      case '[':
+        node.bytes = ET_UNWRAP(parse_class());
+        return node;
+      case '.':
+        node.bytes.set();
+        node.bytes.reset('\n');
+        return node;
+      case '\\':
+        node.bytes = ET_UNWRAP(parse_escape());
+        return node;
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+      case '^':
+      case '$':
+        ET_LOG(Error, "unexpected '%c' at %zu in regex", c, pos_ - 1);
+        return Error::NotSupported;
+      default:
+        node.bytes.set(static_cast<uint8_t>(c));
+        return node;
+    }
+  }
+
+  // After a backslash.
+  Result<ByteSet> parse_escape() {
+    ET_CHECK_OR_RETURN_ERROR(
+        !at_end(), InvalidArgument, "trailing '\\' in regex");
+    const char c = pattern_[pos_++];
+    const ByteSet digits = byte_range('0', '9');
+    const ByteSet word = digits | byte_range('a', 'z') |
+        byte_range('A', 'Z') | byte_range('_', '_');
+    ByteSet space;
+    for (const char s : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+      space.set(static_cast<uint8_t>(s));
+    }
+    ByteSet bytes;
+    switch (c) {
+      case 'd':
+        return digits;
+      case 'D':
+        return ~digits;
+      case 'w':
+        return word;
+      case 'W':
+        return ~word;
+      case 's':
+        return space;
+      case 'S':
+        return ~space;
+      case 't':
+        bytes.set('\t');
+        return bytes;
+      case 'n':
+        bytes.set('\n');
+        return bytes;
+      case 'r':
+        bytes.set('\r');
+        return bytes;
+      case 'x': {
+        const int high =
+            pos_ < pattern_.size() ? hex_digit(pattern_[pos_]) : -1;
+        const int low =
+            pos_ + 1 < pattern_.size() ? hex_digit(pattern_[pos_ + 1]) : -1;
+        ET_CHECK_OR_RETURN_ERROR(
+            high >= 0 && low >= 0,
+            InvalidArgument,
+            "invalid \\x escape at %zu in regex",
+            pos_);
+        pos_ += 2;
+        bytes.set(high * 16 + low);
+        return bytes;
+      }
+      default:
+        ET_CHECK_OR_RETURN_ERROR(
+            !std::isalnum(static_cast<unsigned char>(c)),
+            NotSupported,
+            "unsupported escape '\\%c' in regex",
+            c);
+        bytes.set(static_cast<uint8_t>(c));
+        return bytes;
+    }
+  }
+
+  // After the opening bracket.
+  Result<ByteSet> parse_class() {
+    const bool negate = consume('^');
+    ByteSet bytes;
+    bool first = true;
+    while (!at_end() && (first || pattern_[pos_] != ']')) {
+      first = false;
+      ByteSet item;
+      int low = -1;
+      if (consume('\\')) {
+        item = ET_UNWRAP(parse_escape());
+        if (item.count() == 1) {
+          for (int c = 0; c < 256; ++c) {
+            if (item.test(c)) {
+              low = c;
+            }
+          }
+        }
+      } else {
+        low = static_cast<uint8_t>(pattern_[pos_++]);
+        item.set(low);
+      }
+      if (low >= 0 && pos_ + 1 < pattern_.size() && pattern_[pos_] == '-' &&
+          pattern_[pos_ + 1] != ']') {
+        ++pos_;
+        int high = static_cast<uint8_t>(pattern_[pos_++]);
+        if (high == '\\') {
+          const ByteSet end = ET_UNWRAP(parse_escape());
+          ET_CHECK_OR_RETURN_ERROR(
+              end.count() == 1,
+              InvalidArgument,
+              "invalid range end at %zu in regex",
+              pos_);
+          for (high = 0; !end.test(high); ++high) {
+          }
+        }
+        ET_CHECK_OR_RETURN_ERROR(
+            low <= high,
+            InvalidArgument,
+            "invalid range at %zu in regex",
+            pos_);
+        item = byte_range(low, high);
+      }
+      bytes |= item;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        consume(']'), InvalidArgument, "missing ']' in regex");
+    return negate ? ~bytes : bytes;
+  }
+
+  std::string_view pattern_;
+  size_t pos_ = 0;
+};
+
+// Thompson NFA: every state has at most one byte transition, and any number
+// of epsilon ones.
+struct Nfa {
+  struct State {
+    ByteSet bytes;
+    uint32_t next = kNoState;
+    std::vector<uint32_t> epsilon;
+  };
+
+  uint32_t add_state() {
+    states.emplace_back();
+    return static_cast<uint32_t>(states.size() - 1);
+  }
+
+  // Adds the states matching node after start, and returns the state where
+  // they end.
+  uint32_t build(const RegexNode& node, uint32_t start) {
+    if (states.size() > kMaxNfaStates) {
+      return start; // the caller checks the size
+    }
+    switch (node.kind) {
+      case RegexNode::Kind::Bytes: {
+        const uint32_t from = add_state();
+        const uint32_t to = add_state();
+        states[start].epsilon.push_back(from);
+        states[from].bytes = node.bytes;
+        states[from].next = to;
+        return to;
+      }
+      case RegexNode::Kind::Concat: {
+        uint32_t end = start;
+        for (const auto& child : node.children) {
+          end = build(child, end);
+        }
+        return end;
+      }
+      case RegexNode::Kind::Alternate: {
+        const uint32_t end = add_state();
+        for (const auto& child : node.children) {
+          const uint32_t branch = add_state();
+          states[start].epsilon.push_back(branch);
+          const uint32_t branch_end = build(child, branch);
+          states[branch_end].epsilon.push_back(end);
+        }
+        return end;
+      }
+      case RegexNode::Kind::Repeat: {
+        const RegexNode& child = node.children[0];
+        uint32_t end = start;
+        for (int i = 0; i < node.min; ++i) {
+          end = build(child, end);
+        }
+        if (node.max < 0) {
+          const uint32_t loop = add_state();
+          states[end].epsilon.push_back(loop);
+          const uint32_t body_end = build(child, loop);
+          states[body_end].epsilon.push_back(loop);
+          return loop;
+        }
+        for (int i = node.min; i < node.max; ++i) {
+          const uint32_t skip = add_state();
+          states[end].epsilon.push_back(skip);
+          const uint32_t body_end = build(child, end);
+          states[body_end].epsilon.push_back(skip);
+          end = skip;
+        }
+        return end;
+      }
+    }
+    return start;
+  }
+
+  // Adds the states reachable from set by epsilon transitions, and sorts it.
+  void close(std::vector<uint32_t>& set) const {
+    std::vector<bool> seen(states.size(), false);
+    for (const uint32_t s : set) {
+      seen[s] = true;
+    }
+    for (size_t i = 0; i < set.size(); ++i) {
+      for (const uint32_t next : states[set[i]].epsilon) {
+        if (!seen[next]) {
+          seen[next] = true;
+          set.push_back(next);
+        }
+      }
+    }
+    std::sort(set.begin(), set.end());
+  }
+
+  std::vector<State> states;
+};
+
+} // namespace
+
+Result<TokenConstraint> TokenConstraint::from_regex(
+    std::string_view pattern,
+    const std::vector<std::string>& token_bytes,
+    const std::vector<uint64_t>& eos_tokens) {
+  const RegexNode regex = ET_UNWRAP(RegexParser(pattern).parse());
+  Nfa nfa;
+  const uint32_t nfa_start = nfa.add_state();
+  const uint32_t nfa_accept = nfa.build(regex, nfa_start);
+  ET_CHECK_OR_RETURN_ERROR(
+      nfa.states.size() <= kMaxNfaStates,
+      NotSupported,
+      "regex is too large, with more than %zu NFA states",
+      kMaxNfaStates);
+
+  // Subset construction.
+  TokenConstraint constraint;
+  std::vector<std::vector<uint32_t>> dfa_sets;
+  std::map<std::vector<uint32_t>, uint32_t> dfa_ids;
+  std::vector<uint32_t> initial = {nfa_start};
+  nfa.close(initial);
+  dfa_ids.emplace(initial, 0);
+  dfa_sets.push_back(std::move(initial));
+  for (size_t d = 0; d < dfa_sets.size(); ++d) {
+    constraint.accepting_.push_back(std::binary_search(
+        dfa_sets[d].begin(), dfa_sets[d].end(), nfa_accept));
+    for (int c = 0; c < 256; ++c) {
+      std::vector<uint32_t> next;
+      for (const uint32_t s : dfa_sets[d]) {
+        if (nfa.states[s].next != kNoState && nfa.states[s].bytes.test(c)) {
+          next.push_back(nfa.states[s].next);
+        }
+      }
+      if (next.empty()) {
+        constraint.transitions_.push_back(kDeadState);
+        continue;
+      }
+      nfa.close(next);
+      auto it = dfa_ids.find(next);
+      if (it == dfa_ids.end()) {
+        ET_CHECK_OR_RETURN_ERROR(
+            dfa_sets.size() < kMaxDfaStates,
+            NotSupported,
+            "regex is too large, with more than %zu DFA states",
+            kMaxDfaStates);
+        it = dfa_ids.emplace(next, dfa_sets.size()).first;
+        dfa_sets.push_back(std::move(next));
+      }
+      constraint.transitions_.push_back(it->second);
+    }
+  }
+  const size_t num_states = dfa_sets.size();
+
+  // Send the states that can't lead to a match to the dead state, so that no
+  // token is allowed into them.
+  std::vector<bool> live = constraint.accepting_;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t d = 0; d < num_states; ++d) {
+      for (int c = 0; c < 256 && !live[d]; ++c) {
+        const uint32_t next = constraint.transitions_[d * 256 + c];
+        if (next != kDeadState && live[next]) {
+          live[d] = true;
+          changed = true;
+        }
+      }
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      live[0], InvalidArgument, "regex doesn't match anything");
+  for (auto& next : constraint.transitions_) {
+    if (next != kDeadState && !live[next]) {
+      next = kDeadState;
+    }
+  }
+
+  // Flatten the vocabulary.
+  constraint.vocab_size_ = token_bytes.size();
+  ET_CHECK_OR_RETURN_ERROR(
+      constraint.vocab_size_ < UINT32_MAX,
+      InvalidArgument,
+      "vocabulary is too large");
+  constraint.num_words_ = (constraint.vocab_size_ + 31) / 32;
+  constraint.token_offsets_.push_back(0);
+  size_t max_token_size = 0;
+  for (const auto& bytes : token_bytes) {
+    constraint.token_data_ += bytes;
+    constraint.token_offsets_.push_back(constraint.token_data_.size());
+    max_token_size = std::max(max_token_size, bytes.size());
+  }
+  constraint.is_eos_.assign(constraint.vocab_size_, false);
+  for (const uint64_t eos : eos_tokens) {
+    ET_CHECK_OR_RETURN_ERROR(
+        eos < constraint.vocab_size_,
+        InvalidArgument,
+        "EOS token %" PRIu64 " is not in the vocabulary",
+        eos);
+    constraint.is_eos_[eos] = true;
+  }
+
+  // Walk the tokens in sorted order from every state, so that the states
+  // along the prefix shared with the previous token are reused, and tokens
+  // sharing a prefix that dies are skipped.
+  std::vector<uint32_t> order(constraint.vocab_size_);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return token_bytes[a] < token_bytes[b];
+  });
+  std::vector<size_t> common_prefix(order.size(), 0);
+  for (size_t i = 1; i < order.size(); ++i) {
+    const auto& prev = token_bytes[order[i - 1]];
+    const auto& cur = token_bytes[order[i]];
+    const size_t n = std::min(prev.size(), cur.size());
+    size_t k = 0;
+    while (k < n && prev[k] == cur[k]) {
+      ++k;
+    }
+    common_prefix[i] = k;
+  }
+
+  constraint.masks_.assign(num_states * constraint.num_words_, 0);
+  std::vector<uint32_t> path(max_token_size + 1);
+  for (size_t d = 0; d < num_states; ++d) {
+    uint32_t* mask = constraint.masks_.data() + d * constraint.num_words_;
+    if (!live[d]) {
+      continue;
+    }
+    path[0] = static_cast<uint32_t>(d);
+    // The depth at which the walk of the previous token died.
+    size_t dead_depth = SIZE_MAX;
+    for (size_t i = 0; i < order.size(); ++i) {
+      const uint32_t token = order[i];
+      const auto& bytes = token_bytes[token];
+      if (bytes.empty() || dead_depth <= common_prefix[i]) {
+        continue;
+      }
+      dead_depth = SIZE_MAX;
+      for (size_t k = common_prefix[i]; k < bytes.size(); ++k) {
+        const uint32_t next = constraint.transitions_
+            [path[k] * 256 + static_cast<uint8_t>(bytes[k])];
+        if (next == kDeadState) {
+          dead_depth = k + 1;
+          break;
+        }
+        path[k + 1] = next;
+      }
+      if (dead_depth == SIZE_MAX && !constraint.is_eos_[token]) {
+        mask[token / 32] |= 1u << (token % 32);
+      }
+    }
+    if (constraint.accepting_[d]) {
+      for (const uint64_t eos : eos_tokens) {
+        mask[eos / 32] |= 1u << (eos % 32);
+      }
+    }
+  }
+  return constraint;
+}
+
+Error TokenConstraint::advance(uint64_t token) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_allowed(token),
+      InvalidArgument,
+      "token %" PRIu64 " is not allowed by the constraint",
+      token);
+  if (is_eos_[token]) {
+    complete_ = true;
+    return Error::Ok;
+  }
+  for (uint32_t i = token_offsets_[token]; i < token_offsets_[token + 1];
+       ++i) {
+    state_ = transitions_[state_ * 256 + static_cast<uint8_t>(token_data_[i])];
+  }
+  return Error::Ok;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
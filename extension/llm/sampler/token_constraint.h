@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Constrains generation to text that matches a regular expression, e.g. one
+ * derived from a JSON schema.
+ *
+ * The regex is compiled into a DFA over bytes, and for every state of the DFA
+ * the tokens whose bytes keep it alive are precomputed once into a bitmask of
+ * the vocabulary, which Sampler::sample() applies to the logits. Sampling a
+ * token then only advances the DFA through the bytes of that token.
+ *
+ * The whole generated text must match. Supported are literals, `.`, classes
+ * such as `[a-z0-9_]` and `[^"]`, the escapes `\d \w \s \D \W \S \t \n \r`
+ * and `\xHH`, groups `(...)` and `(?:...)`, alternation `|`, and the
+ * repetitions `* + ? {m} {m,} {m,n}`. Everything is matched byte by byte, so
+ * `.` and negated classes also match the bytes of UTF-8 characters.
+ */
+class ET_EXPERIMENTAL TokenConstraint {
+ public:
+  /**
+   * @param pattern The regex the generated text must match.
+   * @param token_bytes The bytes of every token of the vocabulary, indexed by
+   * token. Tokens with no bytes, e.g. BOS and other special tokens, are never
+   * allowed.
+   * @param eos_tokens The tokens that end generation, which are only allowed
+   * once the text matches.
+   */
+  static ::executorch::runtime::Result<TokenConstraint> from_regex(
+      std::string_view pattern,
+      const std::vector<std::string>& token_bytes,
+      const std::vector<uint64_t>& eos_tokens);
+
+  /**
+   * The tokens allowed next, as a bitmask of the vocabulary: bit i % 32 of
+   * word i / 32 is set if token i is.
+   */
+  const uint32_t* allowed_tokens() const {
+    return masks_.data() + state_ * num_words_;
+  }
+
+  bool is_allowed(uint64_t token) const {
+    return token < vocab_size_ &&
+        (allowed_tokens()[token / 32] >> (token % 32)) & 1;
+  }
+
+  /**
+   * Moves past a generated token. Fails with InvalidArgument, without moving,
+   * if the token is not allowed.
+   */
+  ::executorch::runtime::Error advance(uint64_t token);
+
+  /// Whether an EOS token was generated, which ends the constrained text.
+  bool is_complete() const {
+    return complete_;
+  }
+
+  /// Starts over, for the next generation.
+  void reset() {
+    state_ = 0;
+    complete_ = false;
+  }
+
+  /// The number of tokens the bitmasks have a bit for.
+  size_t vocab_size() const {
+    return vocab_size_;
+  }
+
+  size_t num_states() const {
+    return accepting_.size();
+  }
+
+ private:
+  TokenConstraint() = default;
+
+  size_t vocab_size_ = 0;
+  size_t num_words_ = 0;
+  // DFA transitions, 256 per state, to kDeadState when no text can match.
+  // State 0 is the initial one.
+  std::vector<uint32_t> transitions_;
+  std::vector<bool> accepting_;
+  // num_words_ words of bitmask per state.
+  std::vector<uint32_t> masks_;
+  // The bytes of token i are token_data_[token_offsets_[i],
+  // token_offsets_[i + 1]).
+  std::string token_data_;
+  std::vector<uint32_t> token_offsets_;
+  std::vector<bool> is_eos_;
+
+  uint32_t state_ = 0;
+  bool complete_ = false;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/llm/tokenizer/binary_vocab.h>
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+
+using ::executorch::extension::MmapDataLoader;
+using ::executorch::runtime::DataLoader;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::FreeableBuffer;
+using ::executorch::runtime::Result;
+
+namespace executorch::extension::llm {
+
+bool BinaryVocab::is_binary_vocab(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  uint32_t magic = 0;
+  return file.read(reinterpret_cast<char*>(&magic), sizeof(magic)) &&
+      magic == kMagic;
+}
+
+Result<BinaryVocab> BinaryVocab::load(const std::string& path) {
+  auto loader = ET_UNWRAP(MmapDataLoader::from(
+      path.c_str(), MmapDataLoader::MlockConfig::NoMlock));
+  const size_t size = ET_UNWRAP(loader.size());
+  // The mapping outlives the loader.
+  auto buffer = ET_UNWRAP(loader.load(
+      0,
+      size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External)));
+  return from_buffer(std::move(buffer));
+}
+
+Result<BinaryVocab> BinaryVocab::from_buffer(FreeableBuffer&& buffer) {
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer.size() >= sizeof(Header),
+      InvalidArgument,
+      "binary vocab of %zu bytes is too small",
+      buffer.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      reinterpret_cast<uintptr_t>(buffer.data()) % alignof(uint32_t) == 0,
+      InvalidArgument,
+      "binary vocab is not aligned");
+  Header header;
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  ET_CHECK_OR_RETURN_ERROR(
+      header.magic == kMagic, InvalidArgument, "not a binary vocab");
+  ET_CHECK_OR_RETURN_ERROR(
+      header.version == kVersion,
+      NotSupported,
+      "unsupported binary vocab version %" PRIu32,
+      header.version);
+  ET_CHECK_OR_RETURN_ERROR(
+      header.num_buckets > 0 && header.num_slots >= header.num_tokens,
+      InvalidArgument,
+      "binary vocab has %" PRIu32 " buckets and %" PRIu32
+      " slots for %" PRIu32 " tokens",
+      header.num_buckets,
+      header.num_slots,
+      header.num_tokens);
+  const uint64_t expected_size = sizeof(Header) +
+      sizeof(uint32_t) *
+          (uint64_t(header.num_tokens) + 1 + header.num_buckets +
+           header.num_slots) +
+      header.string_table_size;
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer.size() == expected_size,
+      InvalidArgument,
+      "binary vocab of %zu bytes, expected %" PRIu64,
+      buffer.size(),
+      expected_size);
+
+  BinaryVocab vocab(std::move(buffer));
+  // The lookups trust the offsets and slots, so check them once here.
+  ET_CHECK_OR_RETURN_ERROR(
+      vocab.offsets_[0] == 0 &&
+          vocab.offsets_[header.num_tokens] == header.string_table_size,
+      InvalidArgument,
+      "binary vocab offsets don't cover the string table");
+  for (uint32_t i = 0; i < header.num_tokens; ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        vocab.offsets_[i] <= vocab.offsets_[i + 1],
+        InvalidArgument,
+        "binary vocab offset %" PRIu32 " is out of order",
+        i);
+  }
+  for (uint32_t i = 0; i < header.num_slots; ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        vocab.slots_[i] == kEmptySlot || vocab.slots_[i] < header.num_tokens,
+        InvalidArgument,
+        "binary vocab slot %" PRIu32 " holds an invalid rank",
+        i);
+  }
+  return vocab;
+}
+
+BinaryVocab::BinaryVocab(FreeableBuffer&& buffer)
+    : buffer_(std::move(buffer)) {
+  const auto* header = static_cast<const Header*>(buffer_.data());
+  num_tokens_ = header->num_tokens;
+  num_buckets_ = header->num_buckets;
+  num_slots_ = header->num_slots;
+  offsets_ = reinterpret_cast<const uint32_t*>(header + 1);
+  seeds_ = offsets_ + num_tokens_ + 1;
+  slots_ = seeds_ + num_buckets_;
+  strings_ = reinterpret_cast<const char*>(slots_ + num_slots_);
+}
+
+std::optional<std::uint64_t> BinaryVocab::tryGetInteger(
+    std::string_view str) const {
+  const uint32_t seed = seeds_[hash(str, 0) % num_buckets_];
+  const uint32_t rank = slots_[hash(str, seed) % num_slots_];
+  // Strings not in the vocabulary land in any slot, so check the token.
+  if (rank == kEmptySlot || tryGetString(rank) != str) {
+    return std::nullopt;
+  }
+  return rank;
+}
+
+std::optional<std::string_view> BinaryVocab::tryGetString(
+    std::uint64_t integer) const {
+  if (integer >= num_tokens_) {
+    return std::nullopt;
+  }
+  return std::string_view(
+      strings_ + offsets_[integer], offsets_[integer + 1] - offsets_[integer]);
+}
+
+std::uint64_t BinaryVocab::hash(std::string_view str, std::uint64_t seed) {
+  uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+  for (const char c : str) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 0x100000001b3ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace executorch::extension::llm
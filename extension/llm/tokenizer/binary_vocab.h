@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace executorch::extension::llm {
+
+/**
+ * BinaryVocab is a read-only map between the tokens of a tiktoken vocabulary
+ * and their ranks, read in place from a file written by binary_vocab.py, so
+ * that loading it is mapping the file into memory rather than decoding and
+ * hashing every token. It offers the lookups of StringIntegerMap.
+ *
+ * The file is little endian, and made of:
+ * - a Header;
+ * - uint32_t offsets[num_tokens + 1]: the bytes of the token of rank i are
+ *   strings[offsets[i], offsets[i + 1]);
+ * - uint32_t seeds[num_buckets] and uint32_t slots[num_slots]: a hash and
+ *   displace perfect hash of the tokens. A token falls in the bucket
+ *   hash(token, 0) % num_buckets, and its rank is in the slot
+ *   hash(token, seed of the bucket) % num_slots. Slots of no token hold
+ *   kEmptySlot;
+ * - char strings[string_table_size]: the bytes of the tokens, in rank order.
+ *
+ * Ranks must be 0 to num_tokens - 1.
+ */
+class BinaryVocab {
+ public:
+  static constexpr uint32_t kMagic = 0x42565400; // "\0TVB"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_tokens;
+    uint32_t num_buckets;
+    uint32_t num_slots;
+    uint32_t string_table_size;
+  };
+
+  /**
+   * Whether the file at the path starts with kMagic. Tiktoken text files
+   * start with base64, never with the NUL of kMagic.
+   */
+  static bool is_binary_vocab(const std::string& path);
+
+  /**
+   * Maps the file at the path into memory, and checks that it is well formed.
+   */
+  static ::executorch::runtime::Result<BinaryVocab> load(
+      const std::string& path);
+
+  /**
+   * Reads the vocabulary in place from the buffer, which it takes ownership
+   * of, after checking that it is well formed.
+   */
+  static ::executorch::runtime::Result<BinaryVocab> from_buffer(
+      ::executorch::runtime::FreeableBuffer&& buffer);
+
+  BinaryVocab(BinaryVocab&&) = default;
+  BinaryVocab(const BinaryVocab&) = delete;
+  BinaryVocab& operator=(const BinaryVocab&) = delete;
+  BinaryVocab& operator=(BinaryVocab&&) = delete;
+
+  /// The rank of the token, if it's in the vocabulary.
+  std::optional<std::uint64_t> tryGetInteger(std::string_view str) const;
+
+  /// The bytes of the token of the rank, which point into the file.
+  std::optional<std::string_view> tryGetString(std::uint64_t integer) const;
+
+  std::size_t size() const {
+    return num_tokens_;
+  }
+
+  /**
+   * 64 bit FNV-1a with the seed mixed into the basis, then the finalizer of
+   * MurmurHash3. binary_vocab.py must compute the same.
+   */
+  static std::uint64_t hash(std::string_view str, std::uint64_t seed);
+
+ private:
+  explicit BinaryVocab(::executorch::runtime::FreeableBuffer&& buffer);
+
+  ::executorch::runtime::FreeableBuffer buffer_;
+  std::uint32_t num_tokens_ = 0;
+  std::uint32_t num_buckets_ = 0;
+  std::uint32_t num_slots_ = 0;
+  // These point into buffer_.
+  const std::uint32_t* offsets_ = nullptr;
+  const std::uint32_t* seeds_ = nullptr;
+  const std::uint32_t* slots_ = nullptr;
+  const char* strings_ = nullptr;
+};
+
+} // namespace executorch::extension::llm
@@ -0,0 +1,163 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+
+# Script to precompile a tiktoken vocabulary into the binary format that
+# Tiktoken::load maps into memory, instead of decoding and hashing every token
+# at startup. See binary_vocab.h for the format.
+
+import argparse
+import base64
+import logging
+import math
+import os
+import struct
+from typing import Dict, List, Optional
+
+MAGIC = 0x42565400  # "\0TVB"
+VERSION = 1
+EMPTY_SLOT = 0xFFFFFFFF
+# The average number of tokens per bucket, and the number of slots per token.
+KEYS_PER_BUCKET = 4
+SLOTS_PER_KEY = 1.25
+
+_MASK = (1 << 64) - 1
+
+
+def vocab_hash(token: bytes, seed: int) -> int:
+    """Must match BinaryVocab::hash."""
+    h = 0xCBF29CE484222325 ^ ((seed * 0x9E3779B97F4A7C15) & _MASK)
+    for b in token:
+        h = ((h ^ b) * 0x100000001B3) & _MASK
+    h ^= h >> 33
+    h = (h * 0xFF51AFD7ED558CCD) & _MASK
+    return h ^ (h >> 33)
+
+
+def load_tiktoken(path: str) -> List[bytes]:
+    """The tokens of a tiktoken file, indexed by rank."""
+    ranks: Dict[int, bytes] = {}
+    with open(path, "rb") as f:
+        for line in f.read().splitlines():
+            if not line:
+                continue
+            token, rank = line.split()
+            assert int(rank) not in ranks, f"duplicate rank: {line!r}"
+            ranks[int(rank)] = base64.b64decode(token)
+    assert sorted(ranks) == list(
+        range(len(ranks))
+    ), "ranks must be 0 to the number of tokens - 1"
+    tokens = [ranks[i] for i in range(len(ranks))]
+    assert len(set(tokens)) == len(tokens), "duplicate tokens"
+    return tokens
+
+
+def build_perfect_hash(tokens: List[bytes]) -> tuple:
+    """
+    Hash and displace: the tokens are spread into buckets, then the buckets are
+    placed largest first, each with the first seed that sends all of its tokens
+    to free slots.
+
+    :return: (seeds of the buckets, rank in each slot)
+    """
+    num_buckets = max(1, math.ceil(len(tokens) / KEYS_PER_BUCKET))
+    num_slots = max(1, math.ceil(len(tokens) * SLOTS_PER_KEY))
+    buckets: List[List[int]] = [[] for _ in range(num_buckets)]
+    for rank, token in enumerate(tokens):
+        buckets[vocab_hash(token, 0) % num_buckets].append(rank)
+
+    seeds = [0] * num_buckets
+    slots = [EMPTY_SLOT] * num_slots
+    for bucket in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+        ranks = buckets[bucket]
+        if not ranks:
+            break
+        seed = 1
+        while True:
+            placed = {vocab_hash(tokens[r], seed) % num_slots for r in ranks}
+            if len(placed) == len(ranks) and all(
+                slots[s] == EMPTY_SLOT for s in placed
+            ):
+                break
+            seed += 1
+            assert seed <= 0xFFFFFFFF, "failed to build the perfect hash"
+        for r in ranks:
+            slots[vocab_hash(tokens[r], seed) % num_slots] = r
+        seeds[bucket] = seed
+    return seeds, slots
+
+
+def write_binary_vocab(tokens: List[bytes], output_path: str) -> None:
+    seeds, slots = build_perfect_hash(tokens)
+    offsets = [0]
+    for token in tokens:
+        offsets.append(offsets[-1] + len(token))
+    assert offsets[-1] <= 0xFFFFFFFF, "string table is too large"
+
+    with open(output_path, "wb") as f:
+        f.write(
+            struct.pack(
+                "<6I",
+                MAGIC,
+                VERSION,
+                len(tokens),
+                len(seeds),
+                len(slots),
+                offsets[-1],
+            )
+        )
+        f.write(struct.pack(f"<{len(offsets)}I", *offsets))
+        f.write(struct.pack(f"<{len(seeds)}I", *seeds))
+        f.write(struct.pack(f"<{len(slots)}I", *slots))
+        f.write(b"".join(tokens))
+    logging.info(f"Wrote {len(tokens)} tokens to {output_path}")
+
+
+def lookup(data: bytes, token: bytes) -> Optional[int]:
+    """The rank of the token in a binary vocabulary, as BinaryVocab does it."""
+    _, _, num_tokens, num_buckets, num_slots, _ = struct.unpack_from("<6I", data)
+    offsets_start = struct.calcsize("<6I")
+    seeds_start = offsets_start + 4 * (num_tokens + 1)
+    slots_start = seeds_start + 4 * num_buckets
+    strings_start = slots_start + 4 * num_slots
+
+    bucket = vocab_hash(token, 0) % num_buckets
+    (seed,) = struct.unpack_from("<I", data, seeds_start + 4 * bucket)
+    slot = vocab_hash(token, seed) % num_slots
+    (rank,) = struct.unpack_from("<I", data, slots_start + 4 * slot)
+    if rank == EMPTY_SLOT:
+        return None
+    start, end = struct.unpack_from("<2I", data, offsets_start + 4 * rank)
+    if data[strings_start + start : strings_start + end] != token:
+        return None
+    return rank
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "-t",
+        "--tokenizer-model",
+        type=str,
+        default="tokenizer.model",
+        help="path to the tiktoken tokenizer model",
+    )
+    parser.add_argument(
+        "-o",
+        "--output-path",
+        type=str,
+        default=None,
+        help="output path of the binary vocabulary",
+    )
+
+    args = parser.parse_args()
+
+    output_path = (
+        args.output_path
+        if args.output_path
+        else os.path.splitext(args.tokenizer_model)[0] + ".vocab.bin"
+    )
+    write_binary_vocab(load_tiktoken(args.tokenizer_model), output_path)
@@ -133,6 +133,12 @@ BPETokenizer::~BPETokenizer() {
  */
 Result<std::string> BPETokenizer::decode(uint64_t prev_token, uint64_t token)
     const {
+  return std::string(ET_UNWRAP(decode_view(prev_token, token)));
+}
+
+Result<std::string_view> BPETokenizer::decode_view(
+    uint64_t prev_token,
+    uint64_t token) const {
   ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(token));
   const char* piece = vocab_[token];
   // following BOS token, sentencepiece decoder strips any leading
@@ -146,8 +152,7 @@ Result<std::string> BPETokenizer::decode(uint64_t prev_token, uint64_t token)
   if (sscanf(piece, "<0x%02hhX>", &byte_val) == 1) {
     piece = (char*)byte_pieces_ + byte_val * 2;
   }
-  std::string res(piece);
-  return res;
+  return std::string_view(piece);
 }
 
 static int32_t
@@ -36,6 +36,10 @@ class ET_EXPERIMENTAL BPETokenizer : public Tokenizer {
       uint64_t prev_token,
       uint64_t token) const override;
 
+  ::executorch::runtime::Result<std::string_view> decode_view(
+      uint64_t prev_token,
+      uint64_t token) const override;
+
  private:
   std::unique_ptr<char*[]> vocab_ = nullptr;
   std::unique_ptr<float[]> vocab_scores_ = nullptr;
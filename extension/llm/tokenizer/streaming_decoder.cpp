@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/tokenizer/streaming_decoder.h>
+
+#include <algorithm>
+#include <string_view>
+
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+namespace {
+
+bool is_continuation(unsigned char byte) {
+  return (byte & 0xC0) == 0x80;
+}
+
+// The length of the character a byte starts, or 0 if it can't start one.
+size_t sequence_length(unsigned char byte) {
+  if (byte < 0x80) {
+    return 1;
+  }
+  if ((byte & 0xE0) == 0xC0) {
+    return 2;
+  }
+  if ((byte & 0xF0) == 0xE0) {
+    return 3;
+  }
+  if ((byte & 0xF8) == 0xF0) {
+    return 4;
+  }
+  return 0;
+}
+
+} // namespace
+
+Error StreamingDecoder::decode(uint64_t token, std::string& out) {
+  std::string_view piece;
+  auto view = tokenizer_->decode_view(prev_token_, token);
+  if (view.ok()) {
+    piece = view.get();
+  } else if (view.error() == Error::NotSupported) {
+    auto text = tokenizer_->decode(prev_token_, token);
+    ET_CHECK_OK_OR_RETURN_ERROR(text.error());
+    decoded_ = std::move(text.get());
+    piece = decoded_;
+  } else {
+    return view.error();
+  }
+  prev_token_ = token;
+
+  // Finish the character held back from the previous tokens first.
+  while (pending_size_ > 0 && !piece.empty()) {
+    if (!is_continuation(piece.front())) {
+      // It was never going to be completed.
+      flush(out);
+      break;
+    }
+    pending_[pending_size_++] = piece.front();
+    piece.remove_prefix(1);
+    if (pending_size_ == sequence_length(pending_[0])) {
+      flush(out);
+    }
+  }
+  if (pending_size_ > 0) {
+    // The whole piece went into a character that still isn't complete.
+    return Error::Ok;
+  }
+
+  // Hold back the start of a character the piece ends in the middle of.
+  size_t complete_size = piece.size();
+  for (size_t i = 1; i <= std::min<size_t>(3, piece.size()); ++i) {
+    const unsigned char byte = piece[piece.size() - i];
+    if (!is_continuation(byte)) {
+      if (sequence_length(byte) > i) {
+        complete_size = piece.size() - i;
+      }
+      break;
+    }
+  }
+  out.append(piece.data(), complete_size);
+  pending_size_ = piece.size() - complete_size;
+  std::copy(piece.begin() + complete_size, piece.end(), pending_);
+  return Error::Ok;
+}
+
+void StreamingDecoder::flush(std::string& out) {
+  out.append(pending_, pending_size_);
+  pending_size_ = 0;
+}
+
+void StreamingDecoder::reset(uint64_t prev_token) {
+  prev_token_ = prev_token;
+  pending_size_ = 0;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
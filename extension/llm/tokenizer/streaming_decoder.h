@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Decodes generated tokens one at a time into a caller-owned string.
+ *
+ * Tokens don't have to end on a UTF-8 character boundary: byte fallback and
+ * byte-level BPE split multi-byte characters across tokens. The trailing
+ * bytes of a character that isn't complete yet are held back until the
+ * tokens that complete it arrive, so that every piece of text handed out is
+ * valid UTF-8 if the whole stream is. Bytes that can't start or continue a
+ * character are passed through as they are.
+ *
+ * Nothing is allocated per token with tokenizers that implement
+ * Tokenizer::decode_view(): the text is appended to `out`, which keeps its
+ * capacity if the caller clears and reuses it. Other tokenizers go through
+ * Tokenizer::decode().
+ */
+class ET_EXPERIMENTAL StreamingDecoder {
+ public:
+  /**
+   * @param tokenizer A loaded tokenizer, which must outlive the decoder.
+   * @param prev_token The token before the first one to decode, usually the
+   * last token of the prompt.
+   */
+  explicit StreamingDecoder(const Tokenizer* tokenizer, uint64_t prev_token = 0)
+      : tokenizer_(tokenizer), prev_token_(prev_token) {}
+
+  /**
+   * Appends the text of `token` to `out`, except for an incomplete character
+   * at its end.
+   */
+  ::executorch::runtime::Error decode(uint64_t token, std::string& out);
+
+  /// Appends the bytes held back so far to `out`, complete or not.
+  void flush(std::string& out);
+
+  /// Drops the bytes held back so far and starts a new stream.
+  void reset(uint64_t prev_token);
+
+  uint64_t prev_token() const {
+    return prev_token_;
+  }
+
+ private:
+  const Tokenizer* tokenizer_;
+  uint64_t prev_token_;
+  // The start of a character that isn't complete yet.
+  char pending_[4];
+  size_t pending_size_ = 0;
+  // Holds the text of the last token for tokenizers without decode_view().
+  std::string decoded_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
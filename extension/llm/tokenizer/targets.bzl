@@ -10,6 +10,7 @@ def define_common_targets():
         name = "tokenizer_py_lib",
         srcs = [
             "__init__.py",
+            "binary_vocab.py",
             "hf_tokenizer.py",
             "tokenizer.py",
             "utils.py",
@@ -58,6 +59,23 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "streaming_decoder",
+        srcs = [
+            "streaming_decoder.cpp",
+        ],
+        exported_headers = [
+            "streaming_decoder.h",
+        ],
+        exported_deps = [
+            ":tokenizer_header",
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     runtime.cxx_library(
         name = "bpe_tokenizer",
         srcs = [
@@ -78,15 +96,18 @@ def define_common_targets():
     runtime.cxx_library(
         name = "tiktoken",
         srcs = [
+            "binary_vocab.cpp",
             "tiktoken.cpp",
         ],
         exported_headers = [
             "tiktoken.h",
             "base64.h",
+            "binary_vocab.h",
             "string_integer_map.h",
         ],
         exported_deps = [
             ":tokenizer_header",
+            "//executorch/extension/data_loader:mmap_data_loader",
             "//executorch/runtime/core:core",
         ],
         visibility = [
@@ -50,6 +50,30 @@ def define_common_targets():
         platforms = [CXX, ANDROID],  # Cannot bundle resources on Apple platform.
     )
 
+    runtime.cxx_test(
+        name = "test_streaming_decoder",
+        srcs = [
+            "test_streaming_decoder.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/tokenizer:streaming_decoder",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_binary_vocab",
+        srcs = [
+            "test_binary_vocab.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/tokenizer:tiktoken",
+        ],
+        env = {
+            "RESOURCES_PATH": "$(location :resources)/resources",
+        },
+        platforms = [CXX, ANDROID],  # Cannot bundle resources on Apple platform.
+    )
+
     runtime.cxx_test(
         name = "test_tiktoken",
         srcs = [
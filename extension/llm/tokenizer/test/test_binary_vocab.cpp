@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/tokenizer/binary_vocab.h>
+#include <executorch/extension/llm/tokenizer/tiktoken.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <iterator>
+
+using namespace ::testing;
+using ::executorch::extension::llm::BinaryVocab;
+using ::executorch::extension::llm::Tiktoken;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::FreeableBuffer;
+using ::executorch::runtime::Result;
+
+namespace {
+// test_binary_vocab.bin was written by binary_vocab.py from
+// test_binary_vocab.model, which has the 256 bytes then these merges.
+const std::vector<std::string> kMerges = {
+    "he", "ll", "hell", "hello", " w", "or", "orld", " world"};
+
+std::unique_ptr<std::vector<std::string>> _get_special_tokens() {
+  return std::make_unique<std::vector<std::string>>(
+      std::vector<std::string>{"<|begin_of_text|>", "<|end_of_text|>"});
+}
+} // namespace
+
+class BinaryVocabTest : public Test {
+ public:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    const std::string resources = std::getenv("RESOURCES_PATH");
+    binaryPath_ = resources + "/test_binary_vocab.bin";
+    textPath_ = resources + "/test_binary_vocab.model";
+  }
+
+  std::string binaryPath_;
+  std::string textPath_;
+};
+
+TEST_F(BinaryVocabTest, DetectsFormat) {
+  EXPECT_TRUE(BinaryVocab::is_binary_vocab(binaryPath_));
+  EXPECT_FALSE(BinaryVocab::is_binary_vocab(textPath_));
+  EXPECT_FALSE(BinaryVocab::is_binary_vocab(binaryPath_ + ".missing"));
+}
+
+TEST_F(BinaryVocabTest, LooksUpEveryToken) {
+  Result<BinaryVocab> vocab = BinaryVocab::load(binaryPath_);
+  ASSERT_EQ(vocab.error(), Error::Ok);
+  ASSERT_EQ(vocab->size(), 256 + kMerges.size());
+
+  for (uint64_t i = 0; i < 256; ++i) {
+    const std::string token(1, static_cast<char>(i));
+    EXPECT_EQ(vocab->tryGetInteger(token), i);
+    EXPECT_EQ(vocab->tryGetString(i), token);
+  }
+  for (uint64_t i = 0; i < kMerges.size(); ++i) {
+    EXPECT_EQ(vocab->tryGetInteger(kMerges[i]), 256 + i);
+    EXPECT_EQ(vocab->tryGetString(256 + i), kMerges[i]);
+  }
+  EXPECT_EQ(vocab->tryGetInteger("hellow"), std::nullopt);
+  EXPECT_EQ(vocab->tryGetInteger(""), std::nullopt);
+  EXPECT_EQ(vocab->tryGetString(vocab->size()), std::nullopt);
+}
+
+TEST_F(BinaryVocabTest, RejectsMalformedBuffers) {
+  std::ifstream file(binaryPath_, std::ios::binary);
+  std::vector<char> data(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  auto truncated = BinaryVocab::from_buffer(
+      FreeableBuffer(data.data(), data.size() - 1, nullptr));
+  EXPECT_EQ(truncated.error(), Error::InvalidArgument);
+
+  // An offset past the end of the string table.
+  std::vector<char> bad_offset = data;
+  const uint32_t offset = UINT32_MAX;
+  std::memcpy(
+      bad_offset.data() + sizeof(BinaryVocab::Header) + sizeof(uint32_t),
+      &offset,
+      sizeof(offset));
+  auto out_of_order = BinaryVocab::from_buffer(
+      FreeableBuffer(bad_offset.data(), bad_offset.size(), nullptr));
+  EXPECT_EQ(out_of_order.error(), Error::InvalidArgument);
+
+  auto text = BinaryVocab::load(textPath_);
+  EXPECT_EQ(text.error(), Error::InvalidArgument);
+}
+
+TEST_F(BinaryVocabTest, TiktokenEncodesAsWithTextFile) {
+  Tiktoken binary(_get_special_tokens(), 0, 1);
+  Tiktoken text(_get_special_tokens(), 0, 1);
+  ASSERT_EQ(binary.load(binaryPath_), Error::Ok);
+  ASSERT_EQ(text.load(textPath_), Error::Ok);
+  EXPECT_EQ(binary.vocab_size(), text.vocab_size());
+  EXPECT_EQ(binary.bos_tok(), text.bos_tok());
+  EXPECT_EQ(binary.eos_tok(), text.eos_tok());
+
+  const std::string input =
+      "hello world, hellorld<|end_of_text|> wor ld\nhe ll";
+  Result<std::vector<uint64_t>> tokens = binary.encode(input, 1, 0);
+  Result<std::vector<uint64_t>> expected = text.encode(input, 1, 0);
+  ASSERT_EQ(tokens.error(), Error::Ok);
+  ASSERT_EQ(expected.error(), Error::Ok);
+  EXPECT_EQ(*tokens, *expected);
+  EXPECT_EQ((std::vector<uint64_t>{(*tokens)[1], (*tokens)[2]}),
+            (std::vector<uint64_t>{259, 263}));
+
+  std::string decoded;
+  for (size_t i = 1; i < tokens->size(); ++i) {
+    decoded += *binary.decode((*tokens)[i - 1], (*tokens)[i]);
+  }
+  EXPECT_EQ(decoded, input);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/tokenizer/streaming_decoder.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+using ::executorch::extension::llm::StreamingDecoder;
+using ::executorch::extension::llm::Tokenizer;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+// Decodes token i to pieces[i].
+class FakeTokenizer : public Tokenizer {
+ public:
+  explicit FakeTokenizer(std::vector<std::string> pieces, bool has_view = true)
+      : pieces_(std::move(pieces)), has_view_(has_view) {
+    initialized_ = true;
+    vocab_size_ = pieces_.size();
+  }
+
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return Error::NotSupported;
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    ET_CHECK_OK_OR_RETURN_ERROR(decode_verify(token));
+    num_copies_++;
+    return pieces_[token];
+  }
+
+  Result<std::string_view> decode_view(uint64_t, uint64_t token)
+      const override {
+    if (!has_view_) {
+      return Error::NotSupported;
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(decode_verify(token));
+    return std::string_view(pieces_[token]);
+  }
+
+  mutable int num_copies_ = 0;
+
+ private:
+  std::vector<std::string> pieces_;
+  bool has_view_;
+};
+
+// "é" is C3 A9, "€" is E2 82 AC and "😀" is F0 9F 98 80.
+const std::vector<std::string> kPieces = {
+    "a",
+    "\xC3",
+    "\xA9",
+    "b\xE2",
+    "\x82",
+    "\xAC c",
+    "\xF0\x9F",
+    "\x98\x80",
+    "\xF0",
+};
+
+} // namespace
+
+class StreamingDecoderTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // Decodes every token, and returns the text appended by each one.
+  std::vector<std::string> decode_all(
+      StreamingDecoder& decoder,
+      const std::vector<uint64_t>& tokens) {
+    std::vector<std::string> texts;
+    for (uint64_t token : tokens) {
+      std::string out;
+      EXPECT_EQ(decoder.decode(token, out), Error::Ok);
+      texts.push_back(out);
+    }
+    return texts;
+  }
+};
+
+TEST_F(StreamingDecoderTest, HoldsBackSplitCharacters) {
+  FakeTokenizer tokenizer(kPieces);
+  StreamingDecoder decoder(&tokenizer);
+  EXPECT_EQ(
+      decode_all(decoder, {0, 1, 2, 3, 4, 5, 6, 7}),
+      std::vector<std::string>(
+          {"a",
+           "",
+           "\xC3\xA9",
+           "b",
+           "",
+           "\xE2\x82\xAC c",
+           "",
+           "\xF0\x9F\x98\x80"}));
+  EXPECT_EQ(decoder.prev_token(), 7);
+  EXPECT_EQ(tokenizer.num_copies_, 0);
+}
+
+TEST_F(StreamingDecoderTest, AppendsToTheBuffer) {
+  FakeTokenizer tokenizer(kPieces);
+  StreamingDecoder decoder(&tokenizer);
+  std::string out = "> ";
+  for (uint64_t token : {0, 1, 2, 3, 4, 5}) {
+    EXPECT_EQ(decoder.decode(token, out), Error::Ok);
+  }
+  EXPECT_EQ(out, "> a\xC3\xA9" "b\xE2\x82\xAC c");
+}
+
+TEST_F(StreamingDecoderTest, PassesThroughBrokenCharacters) {
+  FakeTokenizer tokenizer(kPieces);
+  StreamingDecoder decoder(&tokenizer);
+  // A lead byte followed by one that doesn't continue it, and a stray
+  // continuation byte.
+  EXPECT_EQ(
+      decode_all(decoder, {1, 0, 2}),
+      std::vector<std::string>({"", "\xC3" "a", "\xA9"}));
+}
+
+TEST_F(StreamingDecoderTest, FlushAndReset) {
+  FakeTokenizer tokenizer(kPieces);
+  StreamingDecoder decoder(&tokenizer);
+  std::string out;
+  EXPECT_EQ(decoder.decode(8, out), Error::Ok);
+  EXPECT_EQ(out, "");
+  decoder.flush(out);
+  EXPECT_EQ(out, "\xF0");
+
+  out.clear();
+  EXPECT_EQ(decoder.decode(6, out), Error::Ok);
+  decoder.reset(0);
+  EXPECT_EQ(decoder.prev_token(), 0);
+  EXPECT_EQ(decoder.decode(0, out), Error::Ok);
+  EXPECT_EQ(out, "a");
+}
+
+TEST_F(StreamingDecoderTest, FallsBackToDecode) {
+  FakeTokenizer tokenizer(kPieces, /*has_view=*/false);
+  StreamingDecoder decoder(&tokenizer);
+  EXPECT_EQ(
+      decode_all(decoder, {1, 2, 0}),
+      std::vector<std::string>({"", "\xC3\xA9", "a"}));
+  EXPECT_EQ(tokenizer.num_copies_, 3);
+}
+
+TEST_F(StreamingDecoderTest, OutOfRangeFails) {
+  FakeTokenizer tokenizer(kPieces);
+  StreamingDecoder decoder(&tokenizer);
+  std::string out;
+  EXPECT_EQ(decoder.decode(kPieces.size(), out), Error::NotSupported);
+}
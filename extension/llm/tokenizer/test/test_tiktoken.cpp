@@ -90,6 +90,43 @@ TEST_F(TiktokenExtensionTest, TokenizerEncodeCorrectly) {
   EXPECT_EQ(out.get()[2], 1917);
 }
 
+TEST_F(TiktokenExtensionTest, TokenizerEncodeLongInputCorrectly) {
+  Error res = tokenizer_->load(modelPath_);
+  EXPECT_EQ(res, Error::Ok);
+  // Long enough to be encoded in chunks, in parallel.
+  std::string text = "hello";
+  std::vector<uint64_t> expected = {15339};
+  for (int i = 0; i < 20000; i++) {
+    text += " world hello";
+    expected.push_back(1917);
+    expected.push_back(24748);
+  }
+  Result<std::vector<uint64_t>> out = tokenizer_->encode(text, 0, 0);
+  EXPECT_EQ(out.error(), Error::Ok);
+  EXPECT_EQ(out.get(), expected);
+}
+
+TEST_F(TiktokenExtensionTest, TokenizerEncodeLongPieceRoundTrips) {
+  Error res = tokenizer_->load(modelPath_);
+  EXPECT_EQ(res, Error::Ok);
+  // A single split long enough to be merged with a heap. Encode it twice to
+  // also go through the cached tokens.
+  std::string piece;
+  for (int i = 0; i < 1000; i++) {
+    piece += static_cast<char>('a' + (i * 7 + i / 13) % 26);
+  }
+  for (int i = 0; i < 2; i++) {
+    Result<std::vector<uint64_t>> out = tokenizer_->encode(piece, 0, 0);
+    EXPECT_EQ(out.error(), Error::Ok);
+    EXPECT_GT(out.get().size(), 1);
+    std::string decoded;
+    for (uint64_t token : out.get()) {
+      decoded += tokenizer_->decode(0, token).get();
+    }
+    EXPECT_EQ(decoded, piece);
+  }
+}
+
 TEST_F(TiktokenExtensionTest, TokenizerDecodeCorrectly) {
   Error res = tokenizer_->load(modelPath_);
   EXPECT_EQ(res, Error::Ok);
@@ -10,6 +10,10 @@ import tempfile
 import unittest
 from unittest.mock import patch
 
+from executorch.extension.llm.tokenizer.binary_vocab import (
+    lookup,
+    write_binary_vocab,
+)
 from executorch.extension.llm.tokenizer.tokenizer import Tokenizer
 
 
@@ -41,3 +45,14 @@ class TestTokenizer(unittest.TestCase):
                 self.assertEqual(eos_id, 0)
                 # Check that the max token length is correct
                 self.assertEqual(max_token_length, 0)
+
+    def test_binary_vocab(self):
+        tokens = [bytes([i]) for i in range(256)] + [b"he", b"ll", b"hello"]
+        with tempfile.NamedTemporaryFile(delete=True) as output:
+            write_binary_vocab(tokens, output.name)
+            with open(output.name, "rb") as f:
+                data = f.read()
+        for rank, token in enumerate(tokens):
+            self.assertEqual(lookup(data, token), rank)
+        self.assertIsNone(lookup(data, b"hel"))
+        self.assertIsNone(lookup(data, b""))
@@ -28,9 +28,13 @@
 #include <executorch/extension/llm/tokenizer/base64.h>
 #include <executorch/extension/llm/tokenizer/tiktoken.h>
 #include <executorch/runtime/core/result.h>
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <limits>
+#include <list>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 
 using ::executorch::runtime::Error;
@@ -119,10 +123,35 @@ static Result<Encoder> _load_encoder(const std::string& path) {
   return encoder;
 }
 
-static std::vector<uint64_t> _byte_pair_merge(
-    const std::string& piece,
-    const StringIntegerMap<>& ranks,
-    std::function<uint64_t(uint64_t, uint64_t)> func) {
+// Pieces at least this long are merged with a heap instead of by scanning
+// every pair for the lowest rank at each merge.
+static constexpr size_t kLargePieceSize = 128;
+
+// Inputs at least this long are split into chunks that are encoded in
+// parallel.
+static constexpr size_t kParallelEncodeMinSize = 64 * 1024;
+static constexpr size_t kMaxEncodeThreads = 8;
+
+// The number of pieces whose tokens Tiktoken keeps around.
+static constexpr size_t kWordCacheSize = 4096;
+
+// TRanks is StringIntegerMap<> or BinaryVocab.
+template <typename TRanks>
+static std::optional<uint64_t> _get_rank(
+    std::string_view piece,
+    const TRanks& ranks,
+    uint64_t start,
+    uint64_t end) {
+  return ranks.tryGetInteger(piece.substr(start, end - start));
+}
+
+// Merges the bytes of the piece into parts, and writes the start of every
+// part followed by the size of the piece into `bounds`.
+template <typename TRanks>
+static void _byte_pair_merge(
+    std::string_view piece,
+    const TRanks& ranks,
+    std::vector<uint64_t>& bounds) {
   // This is a vector of (start, rank).
   // The rank is of the byte pair starting at position start.
   // The rank of the last item in the vector is not a valid value.
@@ -137,10 +166,11 @@ static std::vector<uint64_t> _byte_pair_merge(
                       uint64_t start_idx,
                       uint64_t skip) -> std::optional<uint64_t> {
     if (start_idx + skip + 2 < parts.size()) {
-      auto s = parts[start_idx].first;
-      auto e = parts[start_idx + skip + 2].first;
-      auto key = piece.substr(s, e - s);
-      return ranks.tryGetInteger(key);
+      return _get_rank(
+          piece,
+          ranks,
+          parts[start_idx].first,
+          parts[start_idx + skip + 2].first);
     }
     return std::nullopt;
   };
@@ -157,10 +187,10 @@ static std::vector<uint64_t> _byte_pair_merge(
   }
 
   // If you have n parts and m merges, this does O(mn) work.
-  // We could do something with a heap and do O(m log n) work.
-  // It is important to consider that n is often small (<100), and as such
-  // the cache-locality benefits outweigh the algorithmic complexity downsides
-  // of the `parts` vector data structure above.
+  // _byte_pair_merge_large does something with a heap and does O(m log n)
+  // work. It is important to consider that n is often small (<100), and as
+  // such the cache-locality benefits outweigh the algorithmic complexity
+  // downsides of the `parts` vector data structure above.
 
   // Note that we hash bytes, not token pairs. As long as we train BPE the way
   // we currently do, this is equivalent. An easy way to break this would be
@@ -210,45 +240,178 @@ static std::vector<uint64_t> _byte_pair_merge(
       break;
     }
   }
-  std::vector<uint64_t> out;
-  out.reserve(parts.size() - 1);
-  for (auto i = 0U; i < parts.size() - 1; ++i) {
-    auto s = parts[i].first;
-    auto e = parts[i + 1].first;
-    out.push_back(func(s, e));
+  bounds.clear();
+  for (const auto& part : parts) {
+    bounds.push_back(part.first);
   }
-  return out;
 }
 
-static std::vector<uint64_t> _byte_pair_encode(
-    const std::string& piece,
-    const StringIntegerMap<>& tokenizer) {
-  if (piece.size() == 1) {
-    const auto result = tokenizer.tryGetInteger(piece);
-    if (result) {
-      return std::vector<uint64_t>(*result);
-    } else {
-      // TODO: is it possible?
-      return {};
+// Same as _byte_pair_merge, in O(n log n): the pairs wait in a heap ordered by
+// (rank, start), which gives the same merges, lowest rank and leftmost first.
+// Parts are linked by their start, and merged parts stay in the heap until
+// they come up and are skipped.
+template <typename TRanks>
+static void _byte_pair_merge_large(
+    std::string_view piece,
+    const TRanks& ranks,
+    std::vector<uint64_t>& bounds) {
+  const uint64_t n = piece.size();
+  // next[i] and prev[i] are the starts of the parts around the one at i, and
+  // part_rank[i] is the rank of the pair of it and the next one.
+  std::vector<uint64_t> next(n + 1);
+  std::vector<uint64_t> prev(n + 1);
+  std::vector<uint64_t> part_rank(n + 1, _max_size());
+  using Pair = std::pair<uint64_t, uint64_t>; // (rank, start)
+  std::vector<Pair> heap;
+  heap.reserve(n);
+  for (uint64_t i = 0; i <= n; ++i) {
+    next[i] = i + 1;
+    prev[i] = i - 1;
+  }
+
+  auto update_rank = [&](uint64_t start) {
+    const uint64_t end = next[start] < n ? next[next[start]] : n + 1;
+    if (end > n) {
+      part_rank[start] = _max_size();
+      return;
+    }
+    const auto rank = _get_rank(piece, ranks, start, end);
+    part_rank[start] = rank ? *rank : _max_size();
+    if (rank) {
+      heap.emplace_back(*rank, start);
+      std::push_heap(heap.begin(), heap.end(), std::greater<Pair>());
     }
+  };
+  for (uint64_t i = 0; i + 1 < n; ++i) {
+    update_rank(i);
   }
 
-  return _byte_pair_merge(
-      piece, tokenizer, [&piece, &tokenizer](uint64_t start, uint64_t stop) {
-        std::string key = piece.substr(start, stop - start);
-        const auto result = tokenizer.tryGetInteger(key);
-        if (result) {
-          return *result;
-        } else {
-          // TODO: what if key does not exist? Should we return `unknown`?
-          // assert(false); // ??
-          return uint64_t(0);
-        }
-      });
+  // Merged parts are marked by pointing next at themselves.
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<Pair>());
+    const auto [rank, start] = heap.back();
+    heap.pop_back();
+    if (next[start] == start || part_rank[start] != rank) {
+      continue; // stale
+    }
+    const uint64_t merged = next[start];
+    next[start] = next[merged];
+    if (next[merged] <= n) {
+      prev[next[merged]] = start;
+    }
+    next[merged] = merged;
+    update_rank(start);
+    if (start > 0) {
+      update_rank(prev[start]);
+    }
+  }
+
+  bounds.clear();
+  for (uint64_t i = 0; i <= n; i = next[i]) {
+    bounds.push_back(i);
+  }
+}
+
+template <typename TRanks>
+static void _byte_pair_encode(
+    std::string_view piece,
+    const TRanks& tokenizer,
+    std::vector<uint64_t>& bounds,
+    std::vector<uint64_t>& out) {
+  if (piece.size() >= kLargePieceSize) {
+    _byte_pair_merge_large(piece, tokenizer, bounds);
+  } else {
+    _byte_pair_merge(piece, tokenizer, bounds);
+  }
+  for (auto i = 0U; i + 1 < bounds.size(); ++i) {
+    const auto result = _get_rank(piece, tokenizer, bounds[i], bounds[i + 1]);
+    // TODO: what if key does not exist? Should we return `unknown`?
+    out.push_back(result ? *result : uint64_t(0));
+  }
+}
+
+// Splits text into about num_chunks chunks, between words: only at a space
+// with an ASCII letter on both sides. The regex never matches across such a
+// space, since the match before it ends with the letters and the one after it
+// starts with the space, so each chunk splits into the same pieces on its own.
+static std::vector<std::string_view> _split_into_chunks(
+    std::string_view text,
+    size_t num_chunks) {
+  auto is_letter = [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+  };
+  const size_t target_size = text.size() / num_chunks;
+  std::vector<std::string_view> chunks;
+  size_t start = 0;
+  while (chunks.size() + 1 < num_chunks) {
+    size_t cut = start + target_size;
+    while (cut + 1 < text.size() &&
+           !(text[cut] == ' ' && is_letter(text[cut - 1]) &&
+             is_letter(text[cut + 1]))) {
+      ++cut;
+    }
+    if (cut + 1 >= text.size()) {
+      break;
+    }
+    chunks.push_back(text.substr(start, cut - start));
+    start = cut;
+  }
+  chunks.push_back(text.substr(start));
+  return chunks;
 }
 // ------------------------------Util end------------------------------------
 // -------------------------private method start-------------------------------
 
+// A least recently used cache of the tokens of pieces, shared by the threads
+// encoding the chunks of an input.
+class Tiktoken::WordCache {
+ public:
+  explicit WordCache(size_t capacity) : capacity_(capacity) {
+    index_.reserve(capacity);
+  }
+
+  // Appends the tokens of the piece to out if it's in the cache.
+  bool lookup(std::string_view piece, std::vector<uint64_t>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(piece);
+    if (it == index_.end()) {
+      return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    const auto& tokens = it->second->second;
+    out.insert(out.end(), tokens.begin(), tokens.end());
+    return true;
+  }
+
+  void insert(std::string_view piece, const uint64_t* tokens, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(piece) > 0) {
+      return;
+    }
+    if (entries_.size() < capacity_) {
+      entries_.emplace_front();
+    } else {
+      // Reuse the least recently used entry.
+      index_.erase(entries_.back().first);
+      entries_.splice(entries_.begin(), entries_, std::prev(entries_.end()));
+    }
+    auto& entry = entries_.front();
+    entry.first.assign(piece.data(), piece.size());
+    entry.second.assign(tokens, tokens + size);
+    index_.emplace(entry.first, entries_.begin());
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::vector<uint64_t>>;
+
+  std::mutex mutex_;
+  const size_t capacity_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  // Keys point into the strings of entries_.
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+};
+
 template <typename T>
 std::pair<std::optional<std::string>, re2::StringPiece>
 Tiktoken::_split_with_allowed_special_token(
@@ -291,18 +454,84 @@ void Tiktoken::_encode(
     re2::StringPiece& input,
     std::vector<uint64_t>& ret,
     uint64_t& last_piece_token_len) const {
-  std::string piece;
+  const std::string_view text(input.data(), input.size());
+  input.remove_prefix(input.size());
+  const size_t num_threads = std::min<size_t>(
+      {kMaxEncodeThreads,
+       std::max(1u, std::thread::hardware_concurrency()),
+       text.size() / kParallelEncodeMinSize + 1});
+  if (num_threads <= 1) {
+    _encode_chunk(text, ret, last_piece_token_len);
+    return;
+  }
+
+  const auto chunks = _split_into_chunks(text, num_threads);
+  std::vector<std::vector<uint64_t>> chunk_tokens(chunks.size());
+  std::vector<uint64_t> chunk_last_piece_token_len(chunks.size(), 0);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      _encode_chunk(chunks[i], chunk_tokens[i], chunk_last_piece_token_len[i]);
+    });
+  }
+  _encode_chunk(chunks[0], ret, last_piece_token_len);
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    threads[i - 1].join();
+    ret.insert(ret.end(), chunk_tokens[i].begin(), chunk_tokens[i].end());
+    last_piece_token_len = chunk_last_piece_token_len[i];
+  }
+}
+
+void Tiktoken::_encode_chunk(
+    std::string_view chunk,
+    std::vector<uint64_t>& ret,
+    uint64_t& last_piece_token_len) const {
+  if (_binary_token_map) {
+    _encode_chunk(*_binary_token_map, chunk, ret, last_piece_token_len);
+  } else {
+    _encode_chunk(*_token_map, chunk, ret, last_piece_token_len);
+  }
+}
+
+template <typename TRanks>
+void Tiktoken::_encode_chunk(
+    const TRanks& ranks,
+    std::string_view chunk,
+    std::vector<uint64_t>& ret,
+    uint64_t& last_piece_token_len) const {
   assert(_regex);
-  while (re2::RE2::FindAndConsume(&input, *_regex, &piece)) {
-    const auto result = _token_map->tryGetInteger(piece);
+  std::vector<uint64_t> bounds;
+  re2::StringPiece piece;
+  size_t pos = 0;
+  while (pos < chunk.size()) {
+    // Every regex split starts where the previous one ended, so match from
+    // there: without a capture group, and anchored, RE2 finds the end of
+    // the match with its DFA alone.
+    if (!_regex->Match(
+            chunk, pos, chunk.size(), re2::RE2::ANCHOR_START, &piece, 1) &&
+        !_regex->Match(
+            chunk, pos, chunk.size(), re2::RE2::UNANCHORED, &piece, 1)) {
+      break;
+    }
+    if (piece.empty()) {
+      break;
+    }
+    pos = piece.data() + piece.size() - chunk.data();
+    const std::string_view piece_view(piece.data(), piece.size());
+
+    const auto result = ranks.tryGetInteger(piece_view);
     if (result) {
       last_piece_token_len = 1;
       ret.push_back(*result);
       continue;
     }
-    auto tokens = _byte_pair_encode(piece, *_token_map);
-    last_piece_token_len = tokens.size();
-    ret.insert(ret.end(), tokens.begin(), tokens.end());
+    const size_t num_tokens = ret.size();
+    if (!_word_cache->lookup(piece_view, ret)) {
+      _byte_pair_encode(piece_view, ranks, bounds, ret);
+      _word_cache->insert(
+          piece_view, ret.data() + num_tokens, ret.size() - num_tokens);
+    }
+    last_piece_token_len = ret.size() - num_tokens;
   }
 }
 
@@ -369,13 +598,26 @@ Tiktoken::Tiktoken(
       _eos_token_index);
 }
 
+Tiktoken::~Tiktoken() = default;
+
 Error Tiktoken::load(const std::string& path) {
-  auto encoder = ET_UNWRAP(_load_encoder(path));
-  _token_map.emplace(StringIntegerMap<>(encoder));
-  auto special_token_encoder = _build_special_token_encoder(encoder.size());
+  size_t num_base_tokens = 0;
+  if (BinaryVocab::is_binary_vocab(path)) {
+    _binary_token_map.emplace(ET_UNWRAP(BinaryVocab::load(path)));
+    _token_map.reset();
+    num_base_tokens = _binary_token_map->size();
+  } else {
+    auto encoder = ET_UNWRAP(_load_encoder(path));
+    _token_map.emplace(StringIntegerMap<>(encoder));
+    _binary_token_map.reset();
+    num_base_tokens = encoder.size();
+  }
+  auto special_token_encoder = _build_special_token_encoder(num_base_tokens);
   _special_token_map.emplace(StringIntegerMap<>(special_token_encoder));
 
-  _regex = _create_regex(_pattern);
+  // Unlike the special token regex, the splits are matched without a capture
+  // group; see _encode_chunk.
+  _regex = std::make_unique<re2::RE2>(_pattern);
   // Warmup re2 as it is slow on the first run, void the return value as it's
   // not needed Refer to
   // https://github.com/google/re2/blob/6dcd83d60f7944926bfd308cc13979fc53dd69ca/re2/fuzzing/re2_fuzzer.cc#L136-L141
@@ -386,10 +628,12 @@ Error Tiktoken::load(const std::string& path) {
   (void)_special_token_regex->ReverseProgramSize();
 
   // initialize vocab_size, bos_tok, eos_tok
-  vocab_size_ = encoder.size() + special_token_encoder.size();
+  vocab_size_ = num_base_tokens + special_token_encoder.size();
   bos_tok_ = special_token_encoder.at(_special_tokens->at(_bos_token_index));
   eos_tok_ = special_token_encoder.at(_special_tokens->at(_eos_token_index));
 
+  _word_cache = std::make_unique<WordCache>(kWordCacheSize);
+
   initialized_ = true;
   return Error::Ok;
 }
@@ -410,12 +654,17 @@ Tiktoken::encode(const std::string& text, int8_t bos, int8_t eos) const {
 }
 
 Result<std::string> Tiktoken::decode(uint64_t prev, uint64_t cur) const {
+  return std::string(ET_UNWRAP(decode_view(prev, cur)));
+}
+
+Result<std::string_view> Tiktoken::decode_view(uint64_t prev, uint64_t cur)
+    const {
   (void)prev;
   ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(cur));
-  std::string ret;
 
   std::string_view token_bytes;
-  auto result = _token_map->tryGetString(cur);
+  auto result = _binary_token_map ? _binary_token_map->tryGetString(cur)
+                                  : _token_map->tryGetString(cur);
   if (!result) {
     result = _special_token_map->tryGetString(cur);
     if (!result) {
@@ -426,7 +675,7 @@ Result<std::string> Tiktoken::decode(uint64_t prev, uint64_t cur) const {
   } else {
     token_bytes = *result;
   }
-  return std::string(token_bytes);
+  return token_bytes;
 }
 // -------------------------public method end-------------------------------
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <executorch/extension/llm/tokenizer/binary_vocab.h>
 #include <executorch/extension/llm/tokenizer/string_integer_map.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 #include <re2/re2.h>
@@ -35,6 +36,12 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
       size_t bos_token_index,
       size_t eos_token_index);
 
+  ~Tiktoken() override;
+
+  /**
+   * Loads a tiktoken text file, or a binary vocabulary written from one by
+   * binary_vocab.py, which is mapped into memory instead of being parsed.
+   */
   ::executorch::runtime::Error load(const std::string& tokenizer_path) override;
 
   ::executorch::runtime::Result<std::vector<uint64_t>>
@@ -44,6 +51,10 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
       uint64_t prev_token,
       uint64_t token) const override;
 
+  ::executorch::runtime::Result<std::string_view> decode_view(
+      uint64_t prev_token,
+      uint64_t token) const override;
+
  private:
   template <typename T>
   std::pair<std::optional<std::string>, re2::StringPiece>
@@ -56,6 +67,18 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
       std::vector<uint64_t>& ret,
       uint64_t& last_piece_token_len) const;
 
+  void _encode_chunk(
+      std::string_view chunk,
+      std::vector<uint64_t>& ret,
+      uint64_t& last_piece_token_len) const;
+
+  template <typename TRanks>
+  void _encode_chunk(
+      const TRanks& ranks,
+      std::string_view chunk,
+      std::vector<uint64_t>& ret,
+      uint64_t& last_piece_token_len) const;
+
   template <typename T>
   std::pair<std::vector<uint64_t>, uint64_t> _encode_with_special_token(
       const std::string& text,
@@ -69,11 +92,17 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
   // Removed negative lookahead \s+(?!\S) since it's not supported by RE2.
   const std::string _pattern =
       R"((?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}| ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+)";
+  // Only one of these is set, depending on the format of the file loaded.
   std::optional<StringIntegerMap<>> _token_map;
+  std::optional<BinaryVocab> _binary_token_map;
   std::optional<StringIntegerMap<>> _special_token_map;
 
   Re2UPtr _regex;
   Re2UPtr _special_token_regex;
+
+  // The tokens of recently encoded pieces that took merges.
+  class WordCache;
+  std::unique_ptr<WordCache> _word_cache;
 };
 
 } // namespace llm
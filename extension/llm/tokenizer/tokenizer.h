@@ -10,6 +10,7 @@
 
 #include <cinttypes>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <executorch/runtime/core/error.h>
@@ -52,6 +53,20 @@ class ET_EXPERIMENTAL Tokenizer {
       uint64_t prev_token,
       uint64_t token) const = 0;
 
+  /**
+   * Like decode(), but returns a view of the text of the token instead of a
+   * copy. The view stays valid until the tokenizer is loaded again or
+   * destroyed. Tokenizers that don't keep the text of every token around
+   * return NotSupported.
+   */
+  virtual ::executorch::runtime::Result<std::string_view> decode_view(
+      uint64_t prev_token,
+      uint64_t token) const {
+    (void)prev_token;
+    (void)token;
+    return ::executorch::runtime::Error::NotSupported;
+  }
+
   // getters
   int32_t vocab_size() const {
     return vocab_size_;
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * An arena allocator that keeps the memory it gets from malloc() across calls
+ * to reset(), so that repeated workloads, like the temp allocations made by
+ * kernels during every execution of a Method, stop calling malloc() once the
+ * arena has grown to fit them.
+ *
+ * Memory is handed out by bumping a pointer through a list of blocks. Blocks
+ * are sized in power-of-two size classes, so that a block allocated for one
+ * request can be reused for requests of similar size after a reset(). reset()
+ * is O(1): it rewinds to the first block without freeing anything. release()
+ * returns all blocks to the heap.
+ *
+ * Like other MemoryAllocators this is not thread-safe; use
+ * thread_local_instance() to get a separate arena per thread.
+ */
+class PoolingMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// The default size of the smallest block that the arena allocates.
+  static constexpr size_t kDefaultMinBlockSize = 64 * 1024;
+
+  /**
+   * Constructs an empty arena. No memory is allocated until the first call to
+   * allocate().
+   *
+   * @param[in] min_block_size The size of the smallest block to allocate.
+   *     Larger requests get a block of the next power of two that fits them.
+   */
+  explicit PoolingMemoryAllocator(size_t min_block_size = kDefaultMinBlockSize)
+      : MemoryAllocator(0, nullptr),
+        min_block_size_(std::max<size_t>(min_block_size, 1)) {}
+
+  ~PoolingMemoryAllocator() override {
+    release();
+  }
+
+  /**
+   * Returns an arena owned by the calling thread, which lives until the
+   * thread exits.
+   */
+  static PoolingMemoryAllocator& thread_local_instance() {
+    thread_local PoolingMemoryAllocator allocator;
+    return allocator;
+  }
+
+  /**
+   * Allocates 'size' bytes of memory, returning a pointer to the allocated
+   * region, or nullptr upon failure.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+
+    // Look for room in the current block, then in the blocks kept from
+    // earlier runs. The unused tail of a skipped block is wasted until reset.
+    for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+      void* ptr = allocate_from(blocks_[current_], size, alignment);
+      if (ptr != nullptr) {
+        return ptr;
+      }
+    }
+
+    // Nothing fits; grow the arena. Reserve room for alignment padding so the
+    // request always fits in the new block.
+    if (size > (SIZE_MAX >> 1) - alignment) {
+      ET_LOG(Error, "Allocation of %zu bytes is too large", size);
+      return nullptr;
+    }
+    size_t block_size = min_block_size_;
+    while (block_size < size + alignment) {
+      block_size *= 2;
+    }
+    uint8_t* data = static_cast<uint8_t*>(std::malloc(block_size));
+    if (data == nullptr) {
+      ET_LOG(Error, "Failed to allocate a %zu byte block", block_size);
+      return nullptr;
+    }
+    blocks_.push_back({data, block_size});
+    reserved_bytes_ += block_size;
+    offset_ = 0;
+    return allocate_from(blocks_[current_], size, alignment);
+  }
+
+  /**
+   * Makes all memory in the arena available again, without returning it to
+   * the heap. Pointers returned by earlier calls to allocate() become
+   * invalid.
+   */
+  void reset() override {
+    current_ = 0;
+    offset_ = 0;
+    used_bytes_ = 0;
+  }
+
+  /// Resets the arena and frees all of its blocks.
+  void release() {
+    reset();
+    for (const auto& block : blocks_) {
+      std::free(block.data);
+    }
+    blocks_.clear();
+    reserved_bytes_ = 0;
+  }
+
+  /// Returns the number of bytes allocated since the last reset, including
+  /// alignment padding.
+  size_t used_bytes() const {
+    return used_bytes_;
+  }
+
+  /// Returns the largest value that used_bytes() has reached.
+  size_t high_water_mark() const {
+    return high_water_mark_;
+  }
+
+  /// Sets the high water mark to the current value of used_bytes().
+  void reset_high_water_mark() {
+    high_water_mark_ = used_bytes_;
+  }
+
+  /// Returns the total size of the blocks that the arena holds.
+  size_t reserved_bytes() const {
+    return reserved_bytes_;
+  }
+
+  /// Returns the number of blocks that the arena holds.
+  size_t num_blocks() const {
+    return blocks_.size();
+  }
+
+ private:
+  struct Block {
+    uint8_t* data;
+    size_t size;
+  };
+
+  // Not copyable or movable; the blocks are owned by this instance.
+  PoolingMemoryAllocator(const PoolingMemoryAllocator&) = delete;
+  PoolingMemoryAllocator& operator=(const PoolingMemoryAllocator&) = delete;
+
+  /// Bumps offset_ through `block`, or returns nullptr if the request doesn't
+  /// fit in what is left of it.
+  void* allocate_from(const Block& block, size_t size, size_t alignment) {
+    uint8_t* cur = block.data + offset_;
+    uint8_t* start = alignPointer(cur, alignment);
+    if (start + size > block.data + block.size) {
+      return nullptr;
+    }
+    used_bytes_ += static_cast<size_t>(start + size - cur);
+    high_water_mark_ = std::max(high_water_mark_, used_bytes_);
+    offset_ = static_cast<size_t>(start + size - block.data);
+    return start;
+  }
+
+  const size_t min_block_size_;
+  std::vector<Block> blocks_;
+  /// Index into blocks_ of the block currently being allocated from.
+  size_t current_ = 0;
+  /// Offset into the current block of the next free byte.
+  size_t offset_ = 0;
+  size_t used_bytes_ = 0;
+  size_t high_water_mark_ = 0;
+  size_t reserved_bytes_ = 0;
+};
+
+} // namespace extension
+} // namespace executorch
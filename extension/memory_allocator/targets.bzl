@@ -20,3 +20,18 @@ def define_common_targets():
             "@EXECUTORCH_CLIENTS",
         ],
     )
+
+    runtime.cxx_library(
+        name = "pooling_memory_allocator",
+        exported_headers = [
+            "pooling_memory_allocator.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+        ],
+        visibility = [
+            "//executorch/extension/memory_allocator/test/...",
+            "//executorch/extension/module/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/pooling_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::PoolingMemoryAllocator;
+
+constexpr auto kDefaultAlignment = PoolingMemoryAllocator::kDefaultAlignment;
+
+class PoolingMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+#define EXPECT_ALIGNED(ptr, alignment)        \
+  EXPECT_TRUE(is_aligned((ptr), (alignment))) \
+      << "Pointer " << (ptr) << " is not aligned to " << (alignment)
+
+TEST_F(PoolingMemoryAllocatorTest, AlignmentSmokeTest) {
+  PoolingMemoryAllocator allocator(/*min_block_size=*/256);
+
+  std::vector<size_t> alignments = {
+      kDefaultAlignment * 64,
+      kDefaultAlignment * 8,
+      kDefaultAlignment * 16,
+      kDefaultAlignment * 2,
+      kDefaultAlignment * 128,
+      kDefaultAlignment / 2,
+      kDefaultAlignment,
+  };
+
+  static constexpr int kNumPasses = 20;
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    for (size_t alignment : alignments) {
+      constexpr size_t kAllocationSize = 16;
+      auto p = allocator.allocate(kAllocationSize, alignment);
+      EXPECT_NE(p, nullptr);
+      EXPECT_ALIGNED(p, alignment);
+      // Write to the allocated memory. If it overruns, ASAN should catch it.
+      memset(p, 0x55, kAllocationSize);
+    }
+  }
+}
+
+TEST_F(PoolingMemoryAllocatorTest, BadAlignmentFails) {
+  PoolingMemoryAllocator allocator;
+
+  // Should fail because the requested alignment is not a power of 2.
+  std::vector<size_t> alignments = {0, 5, 6, 12, 34};
+  for (auto alignment : alignments) {
+    auto p = allocator.allocate(16, alignment);
+    EXPECT_EQ(p, nullptr);
+  }
+}
+
+TEST_F(PoolingMemoryAllocatorTest, ResetReusesMemory) {
+  PoolingMemoryAllocator allocator(/*min_block_size=*/1024);
+
+  // Allocations that need several blocks, including one larger than the
+  // minimum block size.
+  std::vector<void*> first;
+  for (size_t size : {512, 512, 4000, 16}) {
+    first.push_back(allocator.allocate(size));
+    ASSERT_NE(first.back(), nullptr);
+  }
+  const size_t num_blocks = allocator.num_blocks();
+  const size_t reserved = allocator.reserved_bytes();
+  EXPECT_GT(num_blocks, 1);
+  EXPECT_GE(allocator.used_bytes(), 512 + 512 + 4000 + 16);
+
+  // The same sequence after a reset lands at the same addresses, without
+  // growing the arena.
+  allocator.reset();
+  EXPECT_EQ(allocator.used_bytes(), 0);
+  size_t i = 0;
+  for (size_t size : {512, 512, 4000, 16}) {
+    EXPECT_EQ(allocator.allocate(size), first[i++]);
+  }
+  EXPECT_EQ(allocator.num_blocks(), num_blocks);
+  EXPECT_EQ(allocator.reserved_bytes(), reserved);
+
+  allocator.release();
+  EXPECT_EQ(allocator.num_blocks(), 0);
+  EXPECT_EQ(allocator.reserved_bytes(), 0);
+  EXPECT_NE(allocator.allocate(16), nullptr);
+}
+
+TEST_F(PoolingMemoryAllocatorTest, TracksHighWaterMark) {
+  PoolingMemoryAllocator allocator(/*min_block_size=*/4096);
+
+  EXPECT_EQ(allocator.high_water_mark(), 0);
+  ASSERT_NE(allocator.allocate(1000, 8), nullptr);
+  ASSERT_NE(allocator.allocate(1000, 8), nullptr);
+  EXPECT_EQ(allocator.used_bytes(), 2000);
+  EXPECT_EQ(allocator.high_water_mark(), 2000);
+
+  // The mark survives resets and smaller runs.
+  allocator.reset();
+  ASSERT_NE(allocator.allocate(1000, 8), nullptr);
+  EXPECT_EQ(allocator.used_bytes(), 1000);
+  EXPECT_EQ(allocator.high_water_mark(), 2000);
+
+  allocator.reset_high_water_mark();
+  EXPECT_EQ(allocator.high_water_mark(), 1000);
+}
+
+TEST_F(PoolingMemoryAllocatorTest, ThreadLocalInstancesAreDistinct) {
+  PoolingMemoryAllocator* main_instance =
+      &PoolingMemoryAllocator::thread_local_instance();
+  EXPECT_EQ(main_instance, &PoolingMemoryAllocator::thread_local_instance());
+
+  PoolingMemoryAllocator* other_instance = nullptr;
+  std::thread thread([&other_instance]() {
+    other_instance = &PoolingMemoryAllocator::thread_local_instance();
+    EXPECT_NE(other_instance->allocate(16), nullptr);
+  });
+  thread.join();
+  EXPECT_NE(other_instance, main_instance);
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/method_scheduler.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::Method;
+
+namespace executorch {
+namespace extension {
+
+MethodScheduler::MethodScheduler(size_t num_threads) {
+  num_threads = std::max<size_t>(num_threads, 1);
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this]() { worker_loop(); });
+  }
+}
+
+MethodScheduler::~MethodScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    paused_ = false;
+    paused_flag_.store(false, std::memory_order_relaxed);
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+std::future<Error> MethodScheduler::submit(
+    Method& method,
+    const JobOptions& options) {
+  auto job = std::make_unique<Job>();
+  job->method = &method;
+  job->options = options;
+  std::future<Error> future = job->promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!active_methods_.insert(&method).second) {
+      ET_LOG(Error, "Method already has an unfinished job");
+      job->promise.set_value(Error::InvalidState);
+      return future;
+    }
+    job->sequence_number = next_sequence_number_++;
+    push(std::move(job));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void MethodScheduler::pause() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  paused_ = true;
+  paused_flag_.store(true, std::memory_order_relaxed);
+}
+
+void MethodScheduler::resume() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    paused_ = false;
+    paused_flag_.store(false, std::memory_order_relaxed);
+  }
+  cv_.notify_all();
+}
+
+/* static */ bool MethodScheduler::runs_before(const Job& a, const Job& b) {
+  return std::make_tuple(
+             -int64_t(a.options.priority),
+             a.options.deadline,
+             a.sequence_number) <
+      std::make_tuple(
+             -int64_t(b.options.priority),
+             b.options.deadline,
+             b.sequence_number);
+}
+
+/* static */ bool MethodScheduler::preempts(const Job& a, const Job& b) {
+  if (a.options.priority != b.options.priority) {
+    return a.options.priority > b.options.priority;
+  }
+  return a.options.deadline < b.options.deadline;
+}
+
+void MethodScheduler::push(std::unique_ptr<Job> job) {
+  queue_.push_back(std::move(job));
+  // The front of the heap is the job that runs next.
+  std::push_heap(
+      queue_.begin(), queue_.end(), [](const auto& a, const auto& b) {
+        return runs_before(*b, *a);
+      });
+  num_queued_.store(queue_.size(), std::memory_order_relaxed);
+}
+
+std::unique_ptr<MethodScheduler::Job> MethodScheduler::pop() {
+  // The front of the heap is the job that runs next.
+  std::pop_heap(
+      queue_.begin(), queue_.end(), [](const auto& a, const auto& b) {
+        return runs_before(*b, *a);
+      });
+  std::unique_ptr<Job> job = std::move(queue_.back());
+  queue_.pop_back();
+  num_queued_.store(queue_.size(), std::memory_order_relaxed);
+  return job;
+}
+
+void MethodScheduler::finish(std::unique_ptr<Job> job, Error error) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_methods_.erase(job->method);
+  }
+  // Set the value last, so that the Method can be submitted again as soon as
+  // the caller sees the result.
+  job->promise.set_value(error);
+}
+
+void MethodScheduler::worker_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ++num_idle_;
+    cv_.wait(lock, [this]() {
+      return (!paused_ && !queue_.empty()) || (stopping_ && queue_.empty());
+    });
+    --num_idle_;
+    if (queue_.empty()) {
+      // Stopping, and no work is left for this worker.
+      return;
+    }
+    std::unique_ptr<Job> job = pop();
+    lock.unlock();
+
+    while (job != nullptr) {
+      Error error = job->method->step();
+      if (error == Error::EndOfMethod) {
+        error = job->method->reset_execution();
+        finish(std::move(job), error);
+        break;
+      }
+      if (error != Error::Ok) {
+        finish(std::move(job), error);
+        break;
+      }
+      // Only take the lock between instructions if there is something to
+      // decide.
+      if (num_queued_.load(std::memory_order_relaxed) == 0 &&
+          !paused_flag_.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      lock.lock();
+      if (paused_) {
+        push(std::move(job));
+      } else if (
+          !queue_.empty() && num_idle_ == 0 &&
+          preempts(*queue_.front(), *job)) {
+        push(std::move(job));
+        job = pop();
+        num_preemptions_.fetch_add(1, std::memory_order_relaxed);
+      }
+      lock.unlock();
+    }
+    lock.lock();
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: Interleaves the execution of several Methods on a fixed set
+ * of worker threads, by priority and deadline.
+ *
+ * Methods are run with `Method::step()`, one instruction at a time. After
+ * every instruction, a worker checks whether a waiting job should run before
+ * the one it is running, and if so puts its job back in the queue and
+ * switches to the waiting one. A job therefore waits for at most one
+ * instruction of a job that it preempts; since a delegate call is a single
+ * instruction, latency-sensitive models should be preempting models whose
+ * delegates run in small pieces.
+ *
+ * Jobs run in order of:
+ *   1. Higher `JobOptions::priority` first.
+ *   2. Earlier `JobOptions::deadline` first. Deadlines only order jobs; late
+ *      jobs still run to completion.
+ *   3. Earlier submission first.
+ * Only the first two preempt a running job; jobs that differ only in
+ * submission order never interrupt each other.
+ *
+ * The caller sets the inputs of a Method before submitting it and reads its
+ * outputs once the returned future is ready, and must not otherwise touch the
+ * Method in between. Step-based execution does not use
+ * `Method::set_parallel_execution()` or the shape cache.
+ *
+ * All methods are thread-safe.
+ */
+class MethodScheduler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Scheduling parameters of a job.
+  struct JobOptions {
+    /// Jobs with higher priorities run first.
+    int32_t priority = 0;
+    /// Among jobs of the same priority, the earliest deadline runs first.
+    Clock::time_point deadline = Clock::time_point::max();
+  };
+
+  /**
+   * Starts the worker threads.
+   *
+   * @param[in] num_threads The number of Methods that can execute at the
+   *     same time. Zero is treated as one.
+   */
+  explicit MethodScheduler(size_t num_threads = 1);
+
+  /**
+   * Resumes the workers if paused, waits for all submitted jobs to finish,
+   * then stops the worker threads.
+   */
+  ~MethodScheduler();
+
+  MethodScheduler(const MethodScheduler&) = delete;
+  MethodScheduler& operator=(const MethodScheduler&) = delete;
+  MethodScheduler(MethodScheduler&&) = delete;
+  MethodScheduler& operator=(MethodScheduler&&) = delete;
+
+  /**
+   * Queues a complete execution of `method`.
+   *
+   * @param[in] method The Method to execute, which must be at the start of
+   *     its instructions: either never stepped, or reset after its last
+   *     execution. Must stay valid until the returned future is ready.
+   * @param[in] options How to order the job among the others.
+   *
+   * @returns A future that becomes ready once the Method has finished,
+   *     holding Error::Ok on success, Error::InvalidState if `method` already
+   *     has a job that has not finished, or the error of the instruction that
+   *     failed. A Method that fails mid-execution cannot be executed again.
+   */
+  ET_NODISCARD std::future<executorch::runtime::Error> submit(
+      executorch::runtime::Method& method,
+      const JobOptions& options);
+
+  /// Queues a complete execution of `method` with the default JobOptions.
+  ET_NODISCARD std::future<executorch::runtime::Error> submit(
+      executorch::runtime::Method& method) {
+    return submit(method, JobOptions());
+  }
+
+  /**
+   * Stops the workers after their current instructions, without dropping any
+   * jobs. Jobs submitted while paused are queued.
+   */
+  void pause();
+
+  /// Lets the workers continue after `pause()`.
+  void resume();
+
+  /// Returns how many times a running job has been preempted so far.
+  size_t num_preemptions() const {
+    return num_preemptions_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Job {
+    executorch::runtime::Method* method;
+    JobOptions options;
+    uint64_t sequence_number;
+    std::promise<executorch::runtime::Error> promise;
+  };
+
+  /// Whether `a` must run before `b`, including by submission order.
+  static bool runs_before(const Job& a, const Job& b);
+
+  /// Whether `a` is important enough to preempt `b`.
+  static bool preempts(const Job& a, const Job& b);
+
+  /// Pushes `job` onto `queue_`. Must hold `mutex_`.
+  void push(std::unique_ptr<Job> job);
+
+  /// Pops the job that must run next from `queue_`. Must hold `mutex_`.
+  std::unique_ptr<Job> pop();
+
+  /// Resolves the future of `job` with `error`.
+  void finish(std::unique_ptr<Job> job, executorch::runtime::Error error);
+
+  void worker_loop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /// Heap of waiting jobs, ordered by runs_before().
+  std::vector<std::unique_ptr<Job>> queue_;
+  /// Methods with unfinished jobs.
+  std::unordered_set<const executorch::runtime::Method*> active_methods_;
+  uint64_t next_sequence_number_ = 0;
+  /// The number of workers waiting for a job.
+  size_t num_idle_ = 0;
+  bool paused_ = false;
+  bool stopping_ = false;
+
+  /// The size of `queue_`, readable without `mutex_` between instructions.
+  std::atomic<size_t> num_queued_{0};
+  std::atomic<bool> paused_flag_{false};
+  std::atomic<size_t> num_preemptions_{0};
+
+  std::vector<std::thread> threads_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -8,10 +8,21 @@
 
 #include <executorch/extension/module/module.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/data_loader/mman.h>
 #include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/data_loader/page_util.h>
+#include <executorch/extension/data_loader/shared_weight_cache.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/memory_allocator/pooling_memory_allocator.h>
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/runtime.h>
 
 /**
@@ -40,7 +51,9 @@ namespace extension {
 namespace {
 runtime::Result<std::unique_ptr<runtime::DataLoader>> load_file(
     const std::string& file_path,
-    Module::LoadMode mode) {
+    Module::LoadMode mode,
+    bool share_weights,
+    SharedWeightCache* segment_cache) {
   std::unique_ptr<runtime::DataLoader> res = nullptr;
   switch (mode) {
     case Module::LoadMode::File:
@@ -59,18 +72,159 @@ runtime::Result<std::unique_ptr<runtime::DataLoader>> load_file(
           MmapDataLoader::MlockConfig::UseMlockIgnoreErrors));
       break;
   }
+  if (share_weights) {
+    res = ET_UNWRAP_UNIQUE(
+        CachingDataLoader::from(file_path.c_str(), std::move(res)));
+  } else if (FileIdentity::of(file_path.c_str()).ok()) {
+    // The serializer stores byte-identical constants and delegate payloads
+    // once, so the methods that refer to them load the same segments. Sharing
+    // those loads gives every method one copy of the data instead of reading
+    // it again. Without a file identity, each load reads its own copy.
+    res = ET_UNWRAP_UNIQUE(CachingDataLoader::from(
+        file_path.c_str(), std::move(res), segment_cache));
+  }
   return res;
 }
+
+std::vector<size_t> planned_buffer_sizes(
+    const runtime::MethodMeta& method_meta) {
+  std::vector<size_t> buffer_sizes;
+  for (size_t index = 0; index < method_meta.num_memory_planned_buffers();
+       ++index) {
+    buffer_sizes.push_back(method_meta.memory_planned_buffer_size(index).get());
+  }
+  return buffer_sizes;
+}
+
+bool is_same_scalar(const runtime::EValue& a, const runtime::EValue& b) {
+  if (a.isInt() && b.isInt()) {
+    return a.toInt() == b.toInt();
+  }
+  if (a.isDouble() && b.isDouble()) {
+    return a.toDouble() == b.toDouble();
+  }
+  if (a.isBool() && b.isBool()) {
+    return a.toBool() == b.toBool();
+  }
+  return false;
+}
+
+/**
+ * Returns the leading dimension of each request's tensor inputs if the
+ * requests can run as one batch concatenated along that dimension, or an
+ * empty vector if they can't.
+ */
+std::vector<size_t> coalescible_rows(
+    const runtime::MethodMeta& method_meta,
+    const std::vector<std::vector<runtime::EValue>>& requests) {
+  if (requests.size() < 2) {
+    return {};
+  }
+  std::vector<size_t> rows(requests.size(), 0);
+  bool has_tensor_input = false;
+  for (size_t i = 0; i < method_meta.num_inputs(); ++i) {
+    const auto& first = requests[0][i];
+    const auto tag = method_meta.input_tag(i);
+    if (!tag.ok()) {
+      return {};
+    }
+    if (tag.get() != runtime::Tag::Tensor) {
+      // Other inputs are shared by the whole batch, so they must match.
+      for (const auto& request : requests) {
+        if (!is_same_scalar(request[i], first)) {
+          return {};
+        }
+      }
+      continue;
+    }
+    const auto tensor_meta = method_meta.input_tensor_meta(i);
+    if (!tensor_meta.ok() ||
+        tensor_meta->shape_dynamism() ==
+            runtime::TensorShapeDynamism::STATIC ||
+        tensor_meta->sizes().empty() || !first.isTensor()) {
+      return {};
+    }
+    const auto& first_tensor = first.toTensor();
+    const auto max_rows = static_cast<size_t>(tensor_meta->sizes()[0]);
+    size_t total_rows = 0;
+    for (size_t r = 0; r < requests.size(); ++r) {
+      if (!requests[r][i].isTensor()) {
+        return {};
+      }
+      const auto& tensor = requests[r][i].toTensor();
+      const auto dim = static_cast<size_t>(tensor.dim());
+      if (dim != tensor_meta->sizes().size() ||
+          tensor.scalar_type() != tensor_meta->scalar_type() ||
+          tensor.size(0) == 0 || tensor.const_data_ptr() == nullptr ||
+          !runtime::tensor_is_default_dim_order(tensor)) {
+        return {};
+      }
+      for (size_t d = 1; d < dim; ++d) {
+        if (tensor.size(d) != first_tensor.size(d)) {
+          return {};
+        }
+      }
+      const auto tensor_rows = static_cast<size_t>(tensor.size(0));
+      if (has_tensor_input && rows[r] != tensor_rows) {
+        return {};
+      }
+      rows[r] = tensor_rows;
+      total_rows += tensor_rows;
+    }
+    if (total_rows > max_rows) {
+      return {};
+    }
+    has_tensor_input = true;
+  }
+  if (!has_tensor_input) {
+    return {};
+  }
+  return rows;
+}
+
+/**
+ * Runs every `stride`-th request on `method`, starting at `first`, and copies
+ * the output tensors out of the method's memory into `owned`.
+ */
+runtime::Error run_requests(
+    runtime::Method& method,
+    const std::vector<std::vector<runtime::EValue>>& requests,
+    size_t first,
+    size_t stride,
+    std::vector<std::vector<runtime::EValue>>& results,
+    std::vector<std::vector<TensorPtr>>& owned) {
+  for (size_t r = first; r < requests.size(); r += stride) {
+    const auto& inputs = requests[r];
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(method.set_input(inputs[i], i));
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(method.execute());
+
+    auto& outputs = results[r];
+    outputs.resize(method.outputs_size());
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        method.get_outputs(outputs.data(), outputs.size()));
+    for (auto& output : outputs) {
+      if (output.isTensor()) {
+        owned[r].push_back(clone_tensor_ptr(output.toTensor()));
+        output = runtime::EValue(*owned[r].back());
+      }
+    }
+  }
+  return runtime::Error::Ok;
+}
 } // namespace
 
 Module::Module(
     const std::string& file_path,
     const LoadMode load_mode,
-    std::unique_ptr<runtime::EventTracer> event_tracer)
+    std::unique_ptr<runtime::EventTracer> event_tracer,
+    bool share_weights)
     : file_path_(file_path),
       load_mode_(load_mode),
+      share_weights_(share_weights),
       memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
-      temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      temp_allocator_(std::make_unique<PoolingMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)),
       data_map_loader_(nullptr),
       data_map_(nullptr) {
@@ -81,12 +235,14 @@ Module::Module(
     const std::string& file_path,
     const std::string& data_map_path,
     const LoadMode load_mode,
-    std::unique_ptr<runtime::EventTracer> event_tracer)
+    std::unique_ptr<runtime::EventTracer> event_tracer,
+    bool share_weights)
     : file_path_(file_path),
       data_map_path_(data_map_path),
       load_mode_(load_mode),
+      share_weights_(share_weights),
       memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
-      temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      temp_allocator_(std::make_unique<PoolingMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)),
       data_map_loader_(nullptr),
       data_map_(nullptr) {
@@ -105,7 +261,7 @@ Module::Module(
                            : std::make_unique<MallocMemoryAllocator>()),
       temp_allocator_(
           temp_allocator ? std::move(temp_allocator)
-                         : std::make_unique<MallocMemoryAllocator>()),
+                         : std::make_unique<PoolingMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)),
       data_map_loader_(std::move(data_map_loader)),
       data_map_(nullptr) {
@@ -124,18 +280,29 @@ Module::Module(
                            : std::make_unique<MallocMemoryAllocator>()),
       temp_allocator_(
           temp_allocator ? std::move(temp_allocator)
-                         : std::make_unique<MallocMemoryAllocator>()),
+                         : std::make_unique<PoolingMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)),
       data_map_loader_(std::move(data_map_loader)),
       data_map_(nullptr) {
   runtime::runtime_init();
 }
 
+SharedWeightCache* Module::segment_cache() {
+  if (share_weights_) {
+    return nullptr;
+  }
+  if (!segment_cache_) {
+    segment_cache_ = std::make_shared<SharedWeightCache>();
+  }
+  return segment_cache_.get();
+}
+
 runtime::Error Module::load(const runtime::Program::Verification verification) {
   if (!is_loaded()) {
     // Load the program
     if (!data_loader_) {
-      auto res = load_file(file_path_, load_mode_);
+      auto res = load_file(
+          file_path_, load_mode_, share_weights_, segment_cache());
       if (!res.ok()) {
         return res.error();
       }
@@ -143,7 +310,8 @@ runtime::Error Module::load(const runtime::Program::Verification verification) {
     }
     // If a .ptd path was given load it.
     if (data_map_path_ != "") {
-      auto res = load_file(data_map_path_, load_mode_);
+      auto res = load_file(
+          data_map_path_, load_mode_, share_weights_, segment_cache());
       if (!res.ok()) {
         return res.error();
       }
@@ -164,6 +332,100 @@ runtime::Error Module::load(const runtime::Program::Verification verification) {
   return runtime::Error::Ok;
 }
 
+Module::PlannedBuffer Module::allocate_planned_buffer(size_t size) const {
+  const auto& options = planned_memory_options_;
+  const size_t page_size = get_os_page_size();
+  PlannedBuffer buffer;
+#ifndef _WIN32
+  // Round up so that the whole mapping can be unmapped by page, and map a
+  // huge page more than needed so that the buffer can start at a huge page
+  // boundary.
+  constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+  const size_t mapped_size = (size + page_size - 1) / page_size * page_size;
+  const size_t slack = options.use_huge_pages ? kHugePageSize : 0;
+  void* mapping = MAP_FAILED;
+  if (mapped_size > 0) {
+    mapping = ::mmap(
+        nullptr,
+        mapped_size + slack,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+  }
+  if (mapping != MAP_FAILED) {
+    auto* data = static_cast<uint8_t*>(mapping);
+    if (slack > 0) {
+      // Unmap the pages before the first huge page boundary and after the
+      // buffer.
+      const size_t head = (kHugePageSize -
+                           reinterpret_cast<uintptr_t>(data) % kHugePageSize) %
+          kHugePageSize;
+      if (head > 0) {
+        ::munmap(data, head);
+      }
+      if (slack > head) {
+        ::munmap(data + head + mapped_size, slack - head);
+      }
+      data += head;
+    }
+    buffer = PlannedBuffer(
+        data, [mapped_size](uint8_t* ptr) { ::munmap(ptr, mapped_size); });
+  }
+#endif // !_WIN32
+  if (buffer == nullptr) {
+    // Anonymous mappings start zeroed, so do the same here.
+    buffer = PlannedBuffer(
+        static_cast<uint8_t*>(std::calloc(std::max<size_t>(size, 1), 1)),
+        [](uint8_t* ptr) { std::free(ptr); });
+  }
+  if (buffer == nullptr || size == 0) {
+    return buffer;
+  }
+  if (options.use_huge_pages) {
+    internal::advise_huge_pages(buffer.get(), size, "planned memory");
+  }
+  if (options.numa_node >= 0) {
+    // The pages are new, so there is nothing to move yet.
+    internal::bind_to_numa_node(
+        buffer.get(),
+        size,
+        options.numa_node,
+        /*move_pages=*/false,
+        "planned memory");
+  }
+  if (options.prefault_threads > 0) {
+    // Buffers start zeroed, so writing zeros doesn't change them.
+    internal::prefault_pages(
+        buffer.get(),
+        size,
+        page_size,
+        options.prefault_threads,
+        internal::PrefaultAccess::Write);
+  }
+  return buffer;
+}
+
+runtime::Result<std::unique_ptr<runtime::HierarchicalAllocator>>
+Module::make_planned_memory(
+    const std::vector<size_t>& buffer_sizes,
+    std::vector<PlannedBuffer>& buffers,
+    std::vector<runtime::Span<uint8_t>>& spans) const {
+  buffers.reserve(buffer_sizes.size());
+  spans.reserve(buffer_sizes.size());
+  for (const auto buffer_size : buffer_sizes) {
+    buffers.push_back(allocate_planned_buffer(buffer_size));
+    ET_CHECK_OR_RETURN_ERROR(
+        buffers.back() != nullptr,
+        MemoryAllocationFailed,
+        "Failed to allocate %zu bytes of planned memory",
+        buffer_size);
+    spans.emplace_back(buffers.back().get(), buffer_size);
+  }
+  return std::make_unique<runtime::HierarchicalAllocator>(
+      runtime::Span(spans.data(), spans.size()));
+}
+
 runtime::Result<size_t> Module::num_methods() {
   ET_CHECK_OK_OR_RETURN_ERROR(load());
   return program_->num_methods();
@@ -193,22 +455,10 @@ runtime::Error Module::load_method(
     if (!planned_memory) {
       const auto method_metadata =
           ET_UNWRAP(program_->method_meta(method_name.c_str()));
-      const auto planned_buffers_count =
-          method_metadata.num_memory_planned_buffers();
-      method_holder.planned_buffers.reserve(planned_buffers_count);
-      method_holder.planned_spans.reserve(planned_buffers_count);
-
-      for (auto index = 0; index < planned_buffers_count; ++index) {
-        const auto buffer_size =
-            method_metadata.memory_planned_buffer_size(index).get();
-        method_holder.planned_buffers.emplace_back(buffer_size);
-        method_holder.planned_spans.emplace_back(
-            method_holder.planned_buffers.back().data(), buffer_size);
-      }
-      method_holder.planned_memory =
-          std::make_unique<runtime::HierarchicalAllocator>(runtime::Span(
-              method_holder.planned_spans.data(),
-              method_holder.planned_spans.size()));
+      method_holder.planned_memory = ET_UNWRAP(make_planned_memory(
+          planned_buffer_sizes(method_metadata),
+          method_holder.planned_buffers,
+          method_holder.planned_spans));
       planned_memory = method_holder.planned_memory.get();
     }
     method_holder.memory_manager = std::make_unique<runtime::MemoryManager>(
@@ -219,11 +469,67 @@ runtime::Error Module::load_method(
         event_tracer ? event_tracer : this->event_tracer(),
         data_map_.get()));
     method_holder.inputs.resize(method_holder.method->inputs_size());
+    method_holder.bound_inputs.resize(method_holder.inputs.size());
+    method_holder.bound_outputs.resize(method_holder.method->outputs_size());
     methods_.emplace(method_name, std::move(method_holder));
   }
   return runtime::Error::Ok;
 }
 
+runtime::Error Module::load_methods_with_shared_planned_memory(
+    const std::vector<std::string>& method_names) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+  ET_CHECK_OR_RETURN_ERROR(
+      shared_planned_memory_ == nullptr,
+      InvalidState,
+      "Methods were already loaded with shared planned memory");
+  std::vector<size_t> buffer_sizes;
+  for (const auto& method_name : method_names) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !is_method_loaded(method_name),
+        InvalidState,
+        "Method %s is already loaded",
+        method_name.c_str());
+    const auto method_metadata =
+        ET_UNWRAP(program_->method_meta(method_name.c_str()));
+    const auto planned_buffers_count =
+        method_metadata.num_memory_planned_buffers();
+    if (buffer_sizes.size() < planned_buffers_count) {
+      buffer_sizes.resize(planned_buffers_count, 0);
+    }
+    for (size_t index = 0; index < planned_buffers_count; ++index) {
+      buffer_sizes[index] = std::max<size_t>(
+          buffer_sizes[index],
+          method_metadata.memory_planned_buffer_size(index).get());
+    }
+  }
+  shared_planned_memory_ = ET_UNWRAP(make_planned_memory(
+      buffer_sizes, shared_planned_buffers_, shared_planned_spans_));
+
+  for (const auto& method_name : method_names) {
+    auto error = load_method(method_name, shared_planned_memory_.get());
+    if (error == runtime::Error::Ok) {
+      // Move the state out before the next method initializes its own state
+      // in the same memory. An unnamed mutable buffer can't be moved, so its
+      // state would be overwritten; that is reported as NotSupported.
+      error = methods_.at(method_name)
+                  .method->move_mutable_buffers(memory_allocator_.get())
+                  .error();
+    }
+    if (error != runtime::Error::Ok) {
+      // Unload the methods again, since they depend on the shared memory.
+      for (const auto& loaded_name : method_names) {
+        methods_.erase(loaded_name);
+      }
+      shared_planned_memory_.reset();
+      shared_planned_spans_.clear();
+      shared_planned_buffers_.clear();
+      return error;
+    }
+  }
+  return runtime::Error::Ok;
+}
+
 runtime::Result<runtime::MethodMeta> Module::method_meta(
     const std::string& method_name) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
@@ -234,21 +540,42 @@ runtime::Result<std::vector<runtime::EValue>> Module::execute(
     const std::string& method_name,
     const std::vector<runtime::EValue>& input_values) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
-  auto& method = methods_.at(method_name).method;
-  auto& inputs = methods_.at(method_name).inputs;
+  auto& method_holder = methods_.at(method_name);
+  auto& method = method_holder.method;
+  auto& inputs = method_holder.inputs;
+  auto& bound_inputs = method_holder.bound_inputs;
+  const auto& bound_outputs = method_holder.bound_outputs;
 
+  ET_CHECK_OR_RETURN_ERROR(
+      input_values.size() <= inputs.size(),
+      InvalidArgument,
+      "input size: %zu exceeds method input size: %zu",
+      input_values.size(),
+      inputs.size());
   for (size_t i = 0; i < input_values.size(); ++i) {
     if (!input_values[i].isNone()) {
       inputs[i] = input_values[i];
+      bound_inputs[i] = false;
     }
   }
   for (size_t i = 0; i < inputs.size(); ++i) {
     ET_CHECK_OR_RETURN_ERROR(
         !inputs[i].isNone(), InvalidArgument, "input %zu is none", i);
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        bound_inputs[i] ? method->bind_input(inputs[i], i)
+                        : method->set_input(inputs[i], i));
+  }
+  for (size_t i = 0; i < bound_outputs.size(); ++i) {
+    if (bound_outputs[i].isNone()) {
+      continue;
+    }
+    const auto tensor_meta = method->method_meta().output_tensor_meta(i);
+    if (tensor_meta.ok() && !tensor_meta->is_memory_planned()) {
+      const auto& bound = bound_outputs[i].toTensor();
+      ET_CHECK_OK_OR_RETURN_ERROR(method->set_output_data_ptr(
+          bound.mutable_data_ptr(), bound.nbytes(), i));
+    }
   }
-  ET_CHECK_OK_OR_RETURN_ERROR(
-      method->set_inputs(executorch::aten::ArrayRef<runtime::EValue>(
-          inputs.data(), inputs.size())));
   ET_CHECK_OK_OR_RETURN_ERROR(method->execute());
 
   const auto outputs_size = method->outputs_size();
@@ -256,15 +583,242 @@ runtime::Result<std::vector<runtime::EValue>> Module::execute(
   ET_CHECK_OK_OR_RETURN_ERROR(
       method->get_outputs(outputs.data(), outputs_size));
 
+  for (size_t i = 0; i < bound_outputs.size(); ++i) {
+    if (bound_outputs[i].isNone()) {
+      continue;
+    }
+    const auto& bound = bound_outputs[i].toTensor();
+    const auto& output = outputs[i].toTensor();
+    if (bound.const_data_ptr() != output.const_data_ptr()) {
+      // The output lives in planned memory, so copy it out.
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          runtime::resize_tensor(bound, output.sizes()));
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          runtime::internal::copy_tensor_data(bound, output));
+    }
+  }
   return outputs;
 }
 
+runtime::Result<std::vector<std::vector<runtime::EValue>>>
+Module::execute_batch(
+    const std::string& method_name,
+    const std::vector<std::vector<runtime::EValue>>& requests,
+    bool coalesce_rows) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method_holder = methods_.at(method_name);
+  const auto& bound_outputs = method_holder.bound_outputs;
+  ET_CHECK_OR_RETURN_ERROR(
+      std::all_of(
+          bound_outputs.begin(),
+          bound_outputs.end(),
+          [](const runtime::EValue& output) { return output.isNone(); }),
+      InvalidState,
+      "execute_batch() does not support bound outputs");
+  const auto inputs_size = method_holder.inputs.size();
+  for (size_t r = 0; r < requests.size(); ++r) {
+    ET_CHECK_OR_RETURN_ERROR(
+        requests[r].size() == inputs_size,
+        InvalidArgument,
+        "request %zu input size: %zu does not match method input size: %zu",
+        r,
+        requests[r].size(),
+        inputs_size);
+  }
+  method_holder.batch_tensors.clear();
+
+  const auto method_meta = method_holder.method->method_meta();
+  bool outputs_planned = true;
+  for (size_t i = 0; i < method_meta.num_outputs(); ++i) {
+    const auto tensor_meta = method_meta.output_tensor_meta(i);
+    if (tensor_meta.ok() && !tensor_meta->is_memory_planned()) {
+      outputs_planned = false;
+    }
+  }
+  if (coalesce_rows && outputs_planned) {
+    const auto rows = coalescible_rows(method_meta, requests);
+    if (!rows.empty()) {
+      std::vector<std::vector<runtime::EValue>> results;
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          execute_coalesced(method_holder, requests, rows, results));
+      if (!results.empty()) {
+        return results;
+      }
+      ET_LOG(
+          Debug,
+          "Outputs of method %s don't split by request, running separately",
+          method_name.c_str());
+    }
+  }
+  return execute_pipelined(
+      method_holder,
+      requests,
+      outputs_planned && method_meta.num_backends() == 0);
+}
+
+runtime::Error Module::execute_coalesced(
+    MethodHolder& method_holder,
+    const std::vector<std::vector<runtime::EValue>>& requests,
+    const std::vector<size_t>& rows,
+    std::vector<std::vector<runtime::EValue>>& results) {
+  auto& method = *method_holder.method;
+  auto& batch_tensors = method_holder.batch_tensors;
+  const auto total_rows = std::accumulate(rows.begin(), rows.end(), size_t(0));
+
+  for (size_t i = 0; i < method.inputs_size(); ++i) {
+    const auto& first = requests[0][i];
+    if (!first.isTensor()) {
+      ET_CHECK_OK_OR_RETURN_ERROR(method.set_input(first, i));
+      continue;
+    }
+    const auto& first_tensor = first.toTensor();
+    std::vector<executorch::aten::SizesType> sizes(
+        first_tensor.sizes().begin(), first_tensor.sizes().end());
+    sizes[0] = total_rows;
+    std::vector<uint8_t> data;
+    data.reserve(first_tensor.nbytes() / rows[0] * total_rows);
+    for (const auto& request : requests) {
+      const auto& tensor = request[i].toTensor();
+      const auto* bytes = static_cast<const uint8_t*>(tensor.const_data_ptr());
+      data.insert(data.end(), bytes, bytes + tensor.nbytes());
+    }
+    batch_tensors.push_back(make_tensor_ptr(
+        std::move(sizes), std::move(data), first_tensor.scalar_type()));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        method.set_input(runtime::EValue(*batch_tensors.back()), i));
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(method.execute());
+
+  const auto outputs_size = method.outputs_size();
+  std::vector<runtime::EValue> outputs(outputs_size);
+  ET_CHECK_OK_OR_RETURN_ERROR(method.get_outputs(outputs.data(), outputs_size));
+  for (const auto& output : outputs) {
+    if (output.isTensor()) {
+      const auto& tensor = output.toTensor();
+      if (tensor.dim() == 0 ||
+          static_cast<size_t>(tensor.size(0)) != total_rows ||
+          !runtime::tensor_is_default_dim_order(tensor)) {
+        return runtime::Error::Ok;
+      }
+    } else if (!output.isInt() && !output.isDouble() && !output.isBool()) {
+      return runtime::Error::Ok;
+    }
+  }
+
+  results.assign(requests.size(), std::vector<runtime::EValue>(outputs_size));
+  for (size_t i = 0; i < outputs_size; ++i) {
+    if (!outputs[i].isTensor()) {
+      for (auto& result : results) {
+        result[i] = outputs[i];
+      }
+      continue;
+    }
+    const auto& output = outputs[i].toTensor();
+    const auto row_bytes = output.nbytes() / total_rows;
+    const auto* bytes = static_cast<const uint8_t*>(output.const_data_ptr());
+    std::vector<executorch::aten::SizesType> sizes(
+        output.sizes().begin(), output.sizes().end());
+    for (size_t r = 0; r < requests.size(); ++r) {
+      sizes[0] = rows[r];
+      batch_tensors.push_back(make_tensor_ptr(
+          sizes,
+          std::vector<uint8_t>(bytes, bytes + rows[r] * row_bytes),
+          output.scalar_type()));
+      bytes += rows[r] * row_bytes;
+      results[r][i] = runtime::EValue(*batch_tensors.back());
+    }
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Result<std::vector<std::vector<runtime::EValue>>>
+Module::execute_pipelined(
+    MethodHolder& method_holder,
+    const std::vector<std::vector<runtime::EValue>>& requests,
+    bool concurrent) {
+  const size_t num_workers = concurrent
+      ? std::min<size_t>(
+            requests.size(), std::max(1u, std::thread::hardware_concurrency()))
+      : 1;
+  const auto method_meta = method_holder.method->method_meta();
+  auto& clones = method_holder.clones;
+  while (clones.size() + 1 < num_workers) {
+    auto clone = std::make_unique<MethodClone>();
+    clone->planned_memory = ET_UNWRAP(make_planned_memory(
+        planned_buffer_sizes(method_meta),
+        clone->planned_buffers,
+        clone->planned_spans));
+    clone->method_allocator = std::make_unique<MallocMemoryAllocator>();
+    clone->temp_allocator = std::make_unique<PoolingMemoryAllocator>();
+    clone->memory_manager = std::make_unique<runtime::MemoryManager>(
+        clone->method_allocator.get(),
+        clone->planned_memory.get(),
+        clone->temp_allocator.get());
+    clone->method = ET_UNWRAP_UNIQUE(
+        method_holder.method->clone_with_memory(clone->memory_manager.get()));
+    clones.push_back(std::move(clone));
+  }
+
+  // The calling thread runs the requests of the first worker on the method
+  // itself; each other worker gets a thread and a clone.
+  std::vector<std::vector<runtime::EValue>> results(requests.size());
+  std::vector<std::vector<TensorPtr>> owned(requests.size());
+  std::vector<runtime::Error> errors(num_workers, runtime::Error::Ok);
+  std::vector<std::thread> threads;
+  threads.reserve(num_workers - 1);
+  for (size_t worker = 1; worker < num_workers; ++worker) {
+    threads.emplace_back([&, worker]() {
+      errors[worker] = run_requests(
+          *clones[worker - 1]->method,
+          requests,
+          worker,
+          num_workers,
+          results,
+          owned);
+    });
+  }
+  errors[0] = run_requests(
+      *method_holder.method, requests, 0, num_workers, results, owned);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto error : errors) {
+    ET_CHECK_OK_OR_RETURN_ERROR(error);
+  }
+  for (auto& tensors : owned) {
+    std::move(
+        tensors.begin(),
+        tensors.end(),
+        std::back_inserter(method_holder.batch_tensors));
+  }
+  return results;
+}
+
 runtime::Error Module::set_input(
     const std::string& method_name,
     const runtime::EValue& input_value,
     size_t input_index) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
-  methods_.at(method_name).inputs.at(input_index) = input_value;
+  auto& method_holder = methods_.at(method_name);
+  method_holder.inputs.at(input_index) = input_value;
+  method_holder.bound_inputs.at(input_index) = false;
+  return runtime::Error::Ok;
+}
+
+runtime::Error Module::bind_input(
+    const std::string& method_name,
+    const runtime::EValue& input_value,
+    size_t input_index) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method_holder = methods_.at(method_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      input_index < method_holder.inputs.size(),
+      InvalidArgument,
+      "input index: %zu is out of range for method input size: %zu",
+      input_index,
+      method_holder.inputs.size());
+  method_holder.inputs[input_index] = input_value;
+  method_holder.bound_inputs[input_index] = true;
   return runtime::Error::Ok;
 }
 
@@ -280,6 +834,8 @@ runtime::Error Module::set_inputs(
       input_values.size(),
       inputs.size());
   inputs = input_values;
+  auto& bound_inputs = methods_.at(method_name).bound_inputs;
+  std::fill(bound_inputs.begin(), bound_inputs.end(), false);
   return runtime::Error::Ok;
 }
 
@@ -299,5 +855,141 @@ runtime::Error Module::set_output(
       output_tensor.mutable_data_ptr(), output_tensor.nbytes(), output_index);
 }
 
+runtime::Error Module::bind_output(
+    const std::string& method_name,
+    runtime::EValue output_value,
+    size_t output_index) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& bound_outputs = methods_.at(method_name).bound_outputs;
+  ET_CHECK_OR_RETURN_ERROR(
+      output_index < bound_outputs.size(),
+      InvalidArgument,
+      "output index: %zu is out of range for method output size: %zu",
+      output_index,
+      bound_outputs.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      output_value.isTensor() || output_value.isNone(),
+      InvalidArgument,
+      "output type: %zu is not tensor",
+      (size_t)output_value.tag);
+  bound_outputs[output_index] = std::move(output_value);
+  return runtime::Error::Ok;
+}
+
+runtime::Error Module::update_external_constants(
+    const std::string& method_name,
+    const std::string& data_map_path) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method_holder = methods_.at(method_name);
+  auto loader = ET_UNWRAP(
+      load_file(data_map_path, load_mode_, share_weights_, segment_cache()));
+  auto data_map = ET_UNWRAP_UNIQUE(FlatTensorDataMap::load(loader.get()));
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      method_holder.method->update_external_constants(data_map.get()));
+  // The method no longer refers to the previous map.
+  method_holder.external_data_loader = std::move(loader);
+  method_holder.external_data_map = std::move(data_map);
+  return runtime::Error::Ok;
+}
+
+runtime::Error Module::warmup(
+    const std::string& method_name,
+    size_t num_iterations,
+    const std::vector<std::vector<std::vector<executorch::aten::SizesType>>>&
+        input_sizes) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+  const auto method_meta = method->method_meta();
+
+  // Save the state, which warming up must not change.
+  std::vector<std::vector<uint8_t>> saved_buffers;
+  for (size_t i = 0; i < method->num_mutable_buffers(); ++i) {
+    const auto buffer = ET_UNWRAP(method->get_mutable_buffer(i));
+    const auto* data = buffer.const_data_ptr<uint8_t>();
+    saved_buffers.emplace_back(data, data + buffer.nbytes());
+  }
+
+  std::vector<runtime::EValue> inputs(method->inputs_size());
+  ET_CHECK_OK_OR_RETURN_ERROR(method->get_inputs(inputs.data(), inputs.size()));
+  for (const auto& sizes : input_sizes) {
+    ET_CHECK_OR_RETURN_ERROR(
+        sizes.size() >= inputs.size(),
+        InvalidArgument,
+        "Expected sizes for %zu inputs, got %zu",
+        inputs.size(),
+        sizes.size());
+  }
+  // The method keeps pointing at these, so they must outlive warming up.
+  auto& output_buffers = methods_.at(method_name).warmup_outputs;
+  output_buffers.clear();
+  for (size_t i = 0; i < method->outputs_size(); ++i) {
+    const auto tensor_meta = method_meta.output_tensor_meta(i);
+    if (tensor_meta.ok() && !tensor_meta->is_memory_planned()) {
+      output_buffers.emplace_back(tensor_meta->nbytes());
+      ET_CHECK_OK_OR_RETURN_ERROR(method->set_output_data_ptr(
+          output_buffers.back().data(), output_buffers.back().size(), i));
+    }
+  }
+
+  const size_t num_size_sets = std::max<size_t>(input_sizes.size(), 1);
+  runtime::Error error = runtime::Error::Ok;
+  for (size_t set = 0; set < num_size_sets && error == runtime::Error::Ok;
+       ++set) {
+    std::vector<TensorPtr> tensors;
+    for (size_t i = 0; i < inputs.size() && error == runtime::Error::Ok; ++i) {
+      const auto tensor_meta = method_meta.input_tensor_meta(i);
+      if (!tensor_meta.ok()) {
+        error = method->set_input(inputs[i], i);
+        continue;
+      }
+      std::vector<executorch::aten::SizesType> sizes(
+          tensor_meta->sizes().begin(), tensor_meta->sizes().end());
+      if (!input_sizes.empty()) {
+        sizes = input_sizes[set][i];
+      }
+      tensors.push_back(ones(std::move(sizes), tensor_meta->scalar_type()));
+      error = method->set_input(*tensors.back(), i);
+    }
+    for (size_t iteration = 0;
+         iteration < num_iterations && error == runtime::Error::Ok;
+         ++iteration) {
+      error = method->execute();
+    }
+  }
+
+  for (size_t i = 0; i < saved_buffers.size(); ++i) {
+    const auto buffer = ET_UNWRAP(method->get_mutable_buffer(i));
+    std::copy(
+        saved_buffers[i].begin(),
+        saved_buffers[i].end(),
+        buffer.mutable_data_ptr<uint8_t>());
+  }
+  return error;
+}
+
+runtime::Error Module::share_mutable_buffers(
+    const std::string& method_name,
+    const std::string& other_method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(other_method_name));
+  auto& method = methods_.at(method_name).method;
+  const auto& other_method = methods_.at(other_method_name).method;
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      method->share_mutable_buffers(*other_method).error());
+  return runtime::Error::Ok;
+}
+
+runtime::Result<std::vector<executorch::aten::Tensor>>
+Module::mutable_buffers(const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  const auto& method = methods_.at(method_name).method;
+  std::vector<executorch::aten::Tensor> buffers;
+  buffers.reserve(method->num_mutable_buffers());
+  for (size_t i = 0; i < method->num_mutable_buffers(); ++i) {
+    buffers.push_back(ET_UNWRAP(method->get_mutable_buffer(i)));
+  }
+  return buffers;
+}
+
 } // namespace extension
 } // namespace executorch
@@ -8,17 +8,21 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <executorch/extension/tensor/tensor_ptr.h>
 #include <executorch/runtime/executor/program.h>
 
 namespace executorch {
 namespace extension {
 
+class SharedWeightCache;
+
 /**
  * A facade class for loading programs and executing methods within them.
  */
@@ -38,6 +42,28 @@ class Module {
     MmapUseMlockIgnoreErrors,
   };
 
+  /**
+   * How the memory-planned buffers that the Module allocates for methods are
+   * backed. Each option is a best-effort hint that is ignored where it is not
+   * supported.
+   */
+  struct PlannedMemoryOptions {
+    /// If true, aligns the buffers to huge pages and calls
+    /// `madvise(MADV_HUGEPAGE)` on them so that the kernel can back them with
+    /// transparent huge pages, reducing TLB misses. Linux only.
+    bool use_huge_pages = false;
+    /// If non-negative, asks the kernel to place the buffers on this NUMA
+    /// node with `mbind()`. Linux only.
+    int numa_node = -1;
+    /// If greater than zero, writes to every page of the buffers using this
+    /// many threads when a method is loaded, so that the first execution
+    /// doesn't take page faults across the whole arena. If zero, pages are
+    /// faulted in by the first execution instead, which places them on the
+    /// NUMA node of the thread that executes the method under the default
+    /// first-touch policy.
+    size_t prefault_threads = 1;
+  };
+
   /**
    * Constructs an instance by loading a program from a file with specified
    * memory locking behavior.
@@ -45,11 +71,16 @@ class Module {
    * @param[in] file_path The path to the ExecuTorch program file to load.
    * @param[in] load_mode The loading mode to use.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
+   * @param[in] share_weights If true, read-only segments of the file are
+   * shared through SharedWeightCache::global() with every other Module in the
+   * process that loads the same file with this option. Otherwise they are
+   * still shared between the methods of this Module.
    */
   explicit Module(
       const std::string& file_path,
       const LoadMode load_mode = LoadMode::MmapUseMlock,
-      std::unique_ptr<runtime::EventTracer> event_tracer = nullptr);
+      std::unique_ptr<runtime::EventTracer> event_tracer = nullptr,
+      bool share_weights = false);
 
   /**
    * Constructs an instance by loading a program from a file with specified
@@ -59,12 +90,17 @@ class Module {
    * @param[in] data_map_path The path to a .ptd file
    * @param[in] load_mode The loading mode to use.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
+   * @param[in] share_weights If true, read-only segments of both files are
+   * shared through SharedWeightCache::global() with every other Module in the
+   * process that loads the same files with this option. Otherwise they are
+   * still shared between the methods of this Module.
    */
   explicit Module(
       const std::string& file_path,
       const std::string& data_map_path,
       const LoadMode load_mode = LoadMode::MmapUseMlock,
-      std::unique_ptr<runtime::EventTracer> event_tracer = nullptr);
+      std::unique_ptr<runtime::EventTracer> event_tracer = nullptr,
+      bool share_weights = false);
 
   /**
    * Constructs an instance with the provided data loader and memory allocator.
@@ -72,7 +108,8 @@ class Module {
    * @param[in] data_loader A DataLoader used for loading program data.
    * @param[in] memory_allocator A MemoryAllocator used for memory management.
    * @param[in] temp_allocator A MemoryAllocator to use when allocating
-   * temporary data during kernel or delegate execution.
+   * temporary data during kernel or delegate execution. If null, uses a
+   * PoolingMemoryAllocator, which reuses its memory across executions.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
    * @param[in] data_map_loader A DataLoader used for loading external weights.
    */
@@ -90,7 +127,8 @@ class Module {
    * the program uses is valid for the lifetime of the program.
    * @param[in] memory_allocator A MemoryAllocator used for memory management.
    * @param[in] temp_allocator A MemoryAllocator to use when allocating
-   * temporary data.
+   * temporary data. If null, uses a PoolingMemoryAllocator, which reuses its
+   * memory across executions.
    * @param[in] event_tracer A EventTracer used for tracking and logging events.
    * @param[in] data_map_loader A DataLoader used for loading external weights.
    */
@@ -138,6 +176,30 @@ class Module {
     return program_;
   }
 
+  /**
+   * EXPERIMENTAL: Loads methods that never execute at the same time, like an
+   * encoder and a decoder, with one set of memory-planned buffers, each sized
+   * to the largest across the methods, instead of a set per method. Their
+   * mutable buffers, like KV caches, are moved into memory of their own, so
+   * that their state is kept across calls to the other methods.
+   *
+   * Since activations are overwritten by each execution, the outputs of one
+   * of the methods must be used or copied before executing another, and the
+   * methods must not execute concurrently. The program must be exported with
+   * the names of its mutable buffers, so that their state can be kept; see
+   * Method::move_mutable_buffers(). This can be used once per
+   * Module, and only with methods that are not loaded yet.
+   *
+   * @param[in] method_names The names of the methods to load.
+   *
+   * @returns An Error to indicate success or failure. If a method has a
+   * mutable buffer with an initial state but no name, returns
+   * Error::NotSupported and leaves the methods unloaded.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error
+  load_methods_with_shared_planned_memory(
+      const std::vector<std::string>& method_names);
+
   /**
    * Get the number of methods available in the loaded program.
    *
@@ -273,6 +335,46 @@ class Module {
     return execute(method_name, std::vector<runtime::EValue>{});
   }
 
+  /**
+   * Executes a specific method once for each of several requests, and returns
+   * the outputs of each request. Loads the program and method before
+   * executing if needed.
+   *
+   * If `coalesce_rows` is true, every tensor input of the method has a
+   * dynamic shape, and the requests differ only in the leading dimension of
+   * their tensor inputs, the requests are concatenated along that dimension
+   * into one batch that runs in a single execution, as long as the batch fits
+   * in the upper bound of the leading dimension. The outputs are split back
+   * along the leading dimension. Only set it for methods whose rows don't
+   * affect each other; a method that reduces over or mixes the leading
+   * dimension returns wrong results for every request. If an output's leading
+   * dimension doesn't match the batch, the requests are run one at a time
+   * instead.
+   *
+   * Otherwise, the requests are spread across clones of the method (see
+   * `Method::clone_with_memory()`), which run at the same time on separate
+   * threads. Methods that use backend delegates, or whose outputs are not
+   * memory-planned, run the requests one after another.
+   *
+   * @param[in] method_name The name of the method to execute.
+   * @param[in] requests The input values of each request. Each must provide a
+   * value for every input of the method.
+   * @param[in] coalesce_rows Whether the requests may run as one batch along
+   * the leading dimension, as described above.
+   *
+   * @returns A Result object containing either the output values of each
+   * request, in the order of `requests`, or an error to indicate failure.
+   * Output tensors are owned by the Module and stay valid until the next call
+   * to `execute_batch()` for this method.
+   *
+   * @note Outputs bound through `bind_output()` are not supported.
+   */
+  ET_NODISCARD
+  runtime::Result<std::vector<std::vector<runtime::EValue>>> execute_batch(
+      const std::string& method_name,
+      const std::vector<std::vector<runtime::EValue>>& requests,
+      bool coalesce_rows = false);
+
   /**
    * Retrieve the output value of a specific method with the given input values.
    * Loads the program and method before execution if needed.
@@ -419,6 +521,79 @@ class Module {
     return set_inputs("forward", input_values);
   }
 
+  /**
+   * Binds an input of a specific method to the caller's tensor, so that every
+   * later execution reads the tensor's memory directly instead of copying it
+   * into the method's memory-planned buffers. See `Method::bind_input()`.
+   *
+   * The binding persists across calls until the input is set again through
+   * `set_input()`, `set_inputs()` or the arguments of `execute()`. The tensor's
+   * memory must stay valid while it is bound. When the tensor's shape or
+   * layout doesn't allow sharing, its data is copied on each execution.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] input_value The EValue to bind as the method input.
+   * @param[in] input_index Zero-based index of the input to bind.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  runtime::Error bind_input(
+      const std::string& method_name,
+      const runtime::EValue& input_value,
+      size_t input_index);
+
+  /**
+   * Binds an input of the "forward" method to the caller's tensor.
+   *
+   * @param[in] input_value The EValue to bind as the method input.
+   * @param[in] input_index Zero-based index of the input to bind.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  inline runtime::Error bind_input(
+      const runtime::EValue& input_value,
+      size_t input_index) {
+    return bind_input("forward", input_value, input_index);
+  }
+
+  /**
+   * Binds an output of a specific method to the caller's tensor, which
+   * receives the output of every later execution. Outputs without
+   * memory-planned storage are written there directly, as with `set_output()`;
+   * others are copied there after the method finishes, with the tensor
+   * resized to the output's shape.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] output_value The EValue containing the Tensor to bind, or a
+   * None EValue to remove an existing binding.
+   * @param[in] output_index Zero-based index of the output to bind.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  runtime::Error bind_output(
+      const std::string& method_name,
+      runtime::EValue output_value,
+      size_t output_index = 0);
+
+  /**
+   * Binds an output of the "forward" method to the caller's tensor.
+   *
+   * @param[in] output_value The EValue containing the Tensor to bind, or a
+   * None EValue to remove an existing binding.
+   * @param[in] output_index Zero-based index of the output to bind.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  inline runtime::Error bind_output(
+      runtime::EValue output_value,
+      size_t output_index = 0) {
+    return bind_output("forward", std::move(output_value), output_index);
+  }
+
   /**
    * Sets the output tensor for a specific method.
    *
@@ -455,6 +630,99 @@ class Module {
     return set_output("forward", std::move(output_value), output_index);
   }
 
+  /**
+   * EXPERIMENTAL: Points the external constants of a method that are in a
+   * .ptd file at its data, e.g. to switch the LoRA adapter of a model whose
+   * adapter weights were exported separately from the base weights. The
+   * other constants stay shared, and the method is not loaded again. Loads
+   * the program and method if needed.
+   *
+   * See Method::update_external_constants() for which tensors are updated.
+   * The .ptd file stays loaded until the next update of the method.
+   *
+   * @param[in] method_name The name of the method to update.
+   * @param[in] data_map_path The path to the .ptd file.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error update_external_constants(
+      const std::string& method_name,
+      const std::string& data_map_path);
+
+  /**
+   * EXPERIMENTAL: Executes a method on synthesized inputs before it serves
+   * requests, so that one-time costs like lazy delegate initialization,
+   * operator reshapes, kernel or pipeline compilation and page faults in the
+   * planned memory are not paid by the first request. Loads the program and
+   * method if needed.
+   *
+   * Tensor inputs are filled with ones, at the upper bound of their sizes
+   * from MethodMeta unless `input_sizes` are given; other inputs keep the
+   * values the method was traced with. The mutable buffers that the program
+   * names, like KV caches, are restored afterwards, and the inputs and
+   * outputs set on the Module are left as they were.
+   *
+   * @param[in] method_name The name of the method to warm up.
+   * @param[in] num_iterations The number of times to execute the method for
+   *     each set of sizes.
+   * @param[in] input_sizes Each set of sizes to execute with, like the common
+   *     prompt lengths of an LLM, as the sizes of each tensor input of the
+   *     method. Values for inputs that are not tensors are ignored.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error warmup(
+      const std::string& method_name = "forward",
+      size_t num_iterations = 1,
+      const std::vector<std::vector<std::vector<executorch::aten::SizesType>>>&
+          input_sizes = {});
+
+  /**
+   * EXPERIMENTAL: Makes a method use the mutable buffers, like a KV cache, of
+   * another method of the program that have the same names, e.g. so that
+   * `prefill` and `decode` methods update one cache. Loads the program and
+   * both methods if needed.
+   *
+   * See Method::share_mutable_buffers() for which tensors are shared and the
+   * limitations. The buffers stay shared until the methods are unloaded,
+   * and `other_method_name` must not be unloaded before `method_name`.
+   *
+   * @param[in] method_name The name of the method whose buffers to replace.
+   * @param[in] other_method_name The name of the method whose buffers to use.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error share_mutable_buffers(
+      const std::string& method_name,
+      const std::string& other_method_name);
+
+  /**
+   * EXPERIMENTAL: Returns the tensors of the mutable buffers that the program
+   * names for a method, like its KV caches, in the order of
+   * Method::get_mutable_buffer(), e.g. to save and restore the state of the
+   * method. Loads the program and method if needed.
+   *
+   * The tensors point at the method's memory, and stay valid until the method
+   * is unloaded or its buffers are moved or shared.
+   *
+   * @param[in] method_name The name of the method.
+   *
+   * @returns The tensors of the buffers, or an error.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD
+  runtime::Result<std::vector<executorch::aten::Tensor>> mutable_buffers(
+      const std::string& method_name = "forward");
+
+  /**
+   * Sets how the memory-planned buffers of methods that are loaded from now
+   * on are allocated. Has no effect on buffers passed to load_method().
+   *
+   * @param[in] options The options for the buffers.
+   */
+  inline void set_planned_memory_options(const PlannedMemoryOptions& options) {
+    planned_memory_options_ = options;
+  }
+
   /**
    * Retrieves the EventTracer instance being used by the Module.
    * EventTracer is used for tracking and logging events during the execution
@@ -468,18 +736,85 @@ class Module {
   }
 
  private:
+  // A memory-planned buffer allocated according to planned_memory_options_.
+  using PlannedBuffer =
+      std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>;
+
+  // A copy of a method, with memory of its own, that execute_batch() runs
+  // requests on at the same time as the original.
+  struct MethodClone {
+    std::vector<PlannedBuffer> planned_buffers;
+    std::vector<runtime::Span<uint8_t>> planned_spans;
+    std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
+    std::unique_ptr<runtime::MemoryAllocator> method_allocator;
+    std::unique_ptr<runtime::MemoryAllocator> temp_allocator;
+    std::unique_ptr<runtime::MemoryManager> memory_manager;
+    std::unique_ptr<runtime::Method> method;
+  };
+
   struct MethodHolder {
-    std::vector<std::vector<uint8_t>> planned_buffers;
+    std::vector<PlannedBuffer> planned_buffers;
     std::vector<runtime::Span<uint8_t>> planned_spans;
     std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
     std::unique_ptr<runtime::MemoryManager> memory_manager;
     std::unique_ptr<runtime::Method> method;
     std::vector<runtime::EValue> inputs;
+    // Whether each input was set through bind_input().
+    std::vector<bool> bound_inputs;
+    // Tensors set through bind_output(), or None.
+    std::vector<runtime::EValue> bound_outputs;
+    // Clones created by execute_batch(), reused across calls.
+    std::vector<std::unique_ptr<MethodClone>> clones;
+    // Tensors backing the inputs and outputs of the last execute_batch().
+    std::vector<TensorPtr> batch_tensors;
+    // The outputs that warmup() set for outputs that are not memory-planned.
+    std::vector<std::vector<uint8_t>> warmup_outputs;
+    // The .ptd of the last update_external_constants().
+    std::unique_ptr<runtime::DataLoader> external_data_loader;
+    std::unique_ptr<runtime::NamedDataMap> external_data_map;
   };
 
+  // Allocates a memory-planned buffer of `size` bytes according to
+  // planned_memory_options_.
+  PlannedBuffer allocate_planned_buffer(size_t size) const;
+
+  // Allocates memory-planned buffers of the given sizes into `buffers`, and
+  // returns an allocator over them.
+  runtime::Result<std::unique_ptr<runtime::HierarchicalAllocator>>
+  make_planned_memory(
+      const std::vector<size_t>& buffer_sizes,
+      std::vector<PlannedBuffer>& buffers,
+      std::vector<runtime::Span<uint8_t>>& spans) const;
+
+  // Runs the requests as one batch. Leaves `results` empty if the outputs
+  // can't be split back into requests.
+  ET_NODISCARD
+  runtime::Error execute_coalesced(
+      MethodHolder& method_holder,
+      const std::vector<std::vector<runtime::EValue>>& requests,
+      const std::vector<size_t>& rows,
+      std::vector<std::vector<runtime::EValue>>& results);
+
+  // Runs the requests one at a time, spread across clones of the method if
+  // `concurrent` is true.
+  ET_NODISCARD
+  runtime::Result<std::vector<std::vector<runtime::EValue>>> execute_pipelined(
+      MethodHolder& method_holder,
+      const std::vector<std::vector<runtime::EValue>>& requests,
+      bool concurrent);
+
+  // Returns the cache that the loaders of this Module share when
+  // share_weights_ is false, creating it on first use, or null otherwise.
+  SharedWeightCache* segment_cache();
+
   std::string file_path_;
   std::string data_map_path_;
   LoadMode load_mode_{LoadMode::MmapUseMlock};
+  bool share_weights_{false};
+  // Shares read-only segments between the methods of this Module when
+  // share_weights_ is false.
+  std::shared_ptr<SharedWeightCache> segment_cache_;
+  PlannedMemoryOptions planned_memory_options_;
   std::shared_ptr<runtime::Program> program_;
   std::unique_ptr<runtime::DataLoader> data_loader_;
   std::unique_ptr<runtime::MemoryAllocator> memory_allocator_;
@@ -487,6 +822,10 @@ class Module {
   std::unique_ptr<runtime::EventTracer> event_tracer_;
   std::unique_ptr<runtime::DataLoader> data_map_loader_;
   std::unique_ptr<runtime::NamedDataMap> data_map_;
+  // The memory-planned buffers of load_methods_with_shared_planned_memory().
+  std::vector<PlannedBuffer> shared_planned_buffers_;
+  std::vector<runtime::Span<uint8_t>> shared_planned_spans_;
+  std::unique_ptr<runtime::HierarchicalAllocator> shared_planned_memory_;
 
  protected:
   std::unordered_map<std::string, MethodHolder> methods_;
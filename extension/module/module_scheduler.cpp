@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/module_scheduler.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+// Copies the outputs of a method into a response that owns its tensors.
+ModuleScheduler::Response make_response(
+    const std::vector<runtime::EValue>& outputs) {
+  ModuleScheduler::Response response;
+  response.outputs.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    if (output.isTensor()) {
+      response.tensors.push_back(clone_tensor_ptr(output.toTensor()));
+      response.outputs.emplace_back(*response.tensors.back());
+    } else {
+      response.outputs.push_back(output);
+    }
+  }
+  return response;
+}
+
+} // namespace
+
+ModuleScheduler::~ModuleScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& entry : backends_) {
+    for (auto& thread : entry.second->threads) {
+      thread.join();
+    }
+  }
+}
+
+runtime::Error ModuleScheduler::add_backend(
+    const std::string& name,
+    size_t max_concurrency) {
+  ET_CHECK_OR_RETURN_ERROR(
+      max_concurrency > 0,
+      InvalidArgument,
+      "Backend %s needs at least one worker",
+      name.c_str());
+  std::lock_guard<std::mutex> lock(mutex_);
+  ET_CHECK_OR_RETURN_ERROR(
+      backends_.count(name) == 0,
+      InvalidArgument,
+      "Backend %s already exists",
+      name.c_str());
+  auto& backend = backends_[name];
+  backend = std::make_unique<Backend>();
+  backend->threads.reserve(max_concurrency);
+  for (size_t i = 0; i < max_concurrency; ++i) {
+    Backend* backend_ptr = backend.get();
+    backend->threads.emplace_back(
+        [this, backend_ptr]() { worker_loop(*backend_ptr); });
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Error ModuleScheduler::add_model(
+    const std::string& name,
+    const std::string& backend,
+    std::vector<std::unique_ptr<Module>> replicas,
+    const ModelOptions& options) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !replicas.empty(),
+      InvalidArgument,
+      "Model %s needs at least one replica",
+      name.c_str());
+  ET_CHECK_OR_RETURN_ERROR(
+      options.max_batch_size > 0,
+      InvalidArgument,
+      "Model %s needs a max_batch_size of at least one",
+      name.c_str());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ET_CHECK_OR_RETURN_ERROR(
+        models_.count(name) == 0,
+        InvalidArgument,
+        "Model %s already exists",
+        name.c_str());
+    const auto backend_it = backends_.find(backend);
+    ET_CHECK_OR_RETURN_ERROR(
+        backend_it != backends_.end(),
+        InvalidArgument,
+        "Model %s uses unknown backend %s",
+        name.c_str(),
+        backend.c_str());
+    auto model = std::make_unique<Model>();
+    model->options = options;
+    model->replicas = std::move(replicas);
+    for (auto& replica : model->replicas) {
+      model->idle_replicas.push_back(replica.get());
+    }
+    backend_it->second->models.push_back(model.get());
+    models_[name] = std::move(model);
+  }
+  cv_.notify_all();
+  return runtime::Error::Ok;
+}
+
+std::future<runtime::Result<ModuleScheduler::Response>>
+ModuleScheduler::submit(
+    const std::string& model,
+    const std::string& method_name,
+    std::vector<runtime::EValue> inputs,
+    Clock::time_point deadline) {
+  auto request = std::make_unique<Request>();
+  request->method_name = method_name;
+  request->inputs = std::move(inputs);
+  request->deadline = deadline;
+  request->enqueue_time = Clock::now();
+  auto future = request->promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto model_it = models_.find(model);
+    if (model_it == models_.end()) {
+      ET_LOG(Error, "Unknown model %s", model.c_str());
+      request->promise.set_value(runtime::Error::NotFound);
+      return future;
+    }
+    request->sequence_number = next_sequence_number_++;
+    auto& queue = model_it->second->queue;
+    const auto position = std::upper_bound(
+        queue.begin(),
+        queue.end(),
+        request,
+        [](const auto& a, const auto& b) { return runs_before(*a, *b); });
+    queue.insert(position, std::move(request));
+  }
+  cv_.notify_all();
+  return future;
+}
+
+runtime::Result<ModuleScheduler::Metrics> ModuleScheduler::metrics(
+    const std::string& model) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto model_it = models_.find(model);
+  ET_CHECK_OR_RETURN_ERROR(
+      model_it != models_.end(), NotFound, "Unknown model %s", model.c_str());
+  return model_it->second->metrics;
+}
+
+/* static */ bool ModuleScheduler::runs_before(
+    const Request& a,
+    const Request& b) {
+  return std::tie(a.deadline, a.sequence_number) <
+      std::tie(b.deadline, b.sequence_number);
+}
+
+/* static */ std::vector<std::unique_ptr<ModuleScheduler::Request>>
+ModuleScheduler::take_batch(Model& model) {
+  auto& queue = model.queue;
+  const std::string method_name = queue.front()->method_name;
+  std::vector<std::unique_ptr<Request>> batch;
+  auto kept = queue.begin();
+  for (auto it = queue.begin(); it != queue.end(); ++it) {
+    if (batch.size() < model.options.max_batch_size &&
+        (*it)->method_name == method_name) {
+      batch.push_back(std::move(*it));
+    } else {
+      *kept++ = std::move(*it);
+    }
+  }
+  queue.erase(kept, queue.end());
+  return batch;
+}
+
+/* static */ std::vector<runtime::Result<ModuleScheduler::Response>>
+ModuleScheduler::run_batch(
+    Module& module,
+    std::vector<std::unique_ptr<Request>>& batch,
+    bool coalesce_rows) {
+  std::vector<runtime::Result<Response>> results;
+  results.reserve(batch.size());
+  const std::string& method_name = batch.front()->method_name;
+  if (batch.size() == 1) {
+    auto outputs = module.execute(method_name, batch.front()->inputs);
+    if (outputs.ok()) {
+      results.emplace_back(make_response(*outputs));
+    } else {
+      results.emplace_back(outputs.error());
+    }
+    return results;
+  }
+  std::vector<std::vector<runtime::EValue>> requests;
+  requests.reserve(batch.size());
+  for (auto& request : batch) {
+    requests.push_back(request->inputs);
+  }
+  auto outputs = module.execute_batch(method_name, requests, coalesce_rows);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (outputs.ok()) {
+      results.emplace_back(make_response(outputs->at(i)));
+    } else {
+      results.emplace_back(outputs.error());
+    }
+  }
+  return results;
+}
+
+void ModuleScheduler::worker_loop(Backend& backend) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Find the model with the most urgent request that can run now.
+    const auto now = Clock::now();
+    Model* next = nullptr;
+    bool pending = false;
+    auto wake_time = Clock::time_point::max();
+    for (Model* model : backend.models) {
+      if (model->queue.empty()) {
+        continue;
+      }
+      pending = true;
+      if (model->idle_replicas.empty()) {
+        continue;
+      }
+      const Request& head = *model->queue.front();
+      if (!stopping_ &&
+          model->queue.size() < model->options.max_batch_size) {
+        const auto ready_time = std::min(
+            head.enqueue_time +
+                duration_cast<Clock::duration>(model->options.max_batch_delay),
+            head.deadline);
+        if (ready_time > now) {
+          wake_time = std::min(wake_time, ready_time);
+          continue;
+        }
+      }
+      if (next == nullptr || runs_before(head, *next->queue.front())) {
+        next = model;
+      }
+    }
+    if (next == nullptr) {
+      if (stopping_ && !pending) {
+        return;
+      }
+      if (wake_time == Clock::time_point::max()) {
+        cv_.wait(lock);
+      } else {
+        cv_.wait_until(lock, wake_time);
+      }
+      continue;
+    }
+
+    Module* module = next->idle_replicas.back();
+    next->idle_replicas.pop_back();
+    std::vector<std::unique_ptr<Request>> batch = take_batch(*next);
+    lock.unlock();
+    const auto start = Clock::now();
+    std::vector<runtime::Result<Response>> results =
+        run_batch(*module, batch, next->options.coalesce_rows);
+    const auto end = Clock::now();
+    lock.lock();
+
+    next->idle_replicas.push_back(module);
+    Metrics& metrics = next->metrics;
+    const auto execution_time = duration_cast<microseconds>(end - start);
+    metrics.num_batches += 1;
+    metrics.total_execution_time += execution_time;
+    metrics.max_execution_time =
+        std::max(metrics.max_execution_time, execution_time);
+    for (size_t i = 0; i < batch.size(); ++i) {
+      const auto queue_time =
+          duration_cast<microseconds>(start - batch[i]->enqueue_time);
+      metrics.num_requests += 1;
+      metrics.num_failed_requests += results[i].ok() ? 0 : 1;
+      metrics.num_missed_deadlines += end > batch[i]->deadline ? 1 : 0;
+      metrics.total_queue_time += queue_time;
+      metrics.max_queue_time = std::max(metrics.max_queue_time, queue_time);
+      batch[i]->promise.set_value(std::move(results[i]));
+    }
+    // The replica is free again.
+    cv_.notify_all();
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: Serves requests for several models, ordered by deadline, on
+ * a bounded number of threads per backend.
+ *
+ * Each model is a pool of replicas: Modules that load the same program. A
+ * replica runs one batch of requests at a time, so the number of replicas
+ * bounds how many batches of a model run at once. Models are assigned to a
+ * backend, which has a fixed number of worker threads shared by all of its
+ * models; for example one worker for the models that run on an NPU and one
+ * per core for the models that run on the CPU.
+ *
+ * Whenever a worker and a replica are free, the worker takes the queued
+ * request of its backend with the earliest deadline, and as many other
+ * requests for the same method of the same model as fit in a batch, and runs
+ * them with `Module::execute_batch()`. Deadlines only order requests; late
+ * requests still run, and are counted in the model's Metrics.
+ *
+ * All methods are thread-safe.
+ */
+class ModuleScheduler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// How a model's requests are run.
+  struct ModelOptions {
+    /// The most requests to run in one `Module::execute_batch()` call.
+    size_t max_batch_size = 1;
+    /**
+     * How long to keep the first queued request of a model waiting for more
+     * requests to batch it with, unless the batch is already full or the
+     * request's deadline comes first.
+     */
+    std::chrono::microseconds max_batch_delay{0};
+    /**
+     * Whether a batch may run as one execution along the leading dimension;
+     * see the `coalesce_rows` argument of `Module::execute_batch()`.
+     */
+    bool coalesce_rows = false;
+  };
+
+  /// Counters describing the requests a model has served so far.
+  struct Metrics {
+    /// The number of requests that finished, successfully or not.
+    uint64_t num_requests = 0;
+    /// The number of requests that failed.
+    uint64_t num_failed_requests = 0;
+    /// The number of requests that finished after their deadline.
+    uint64_t num_missed_deadlines = 0;
+    /// The number of batches the requests were run in.
+    uint64_t num_batches = 0;
+    /// The total and longest time requests spent waiting in the queue.
+    std::chrono::microseconds total_queue_time{0};
+    std::chrono::microseconds max_queue_time{0};
+    /// The total and longest time spent executing batches.
+    std::chrono::microseconds total_execution_time{0};
+    std::chrono::microseconds max_execution_time{0};
+  };
+
+  /// The outputs of a request.
+  struct Response {
+    /// The outputs of the method. Tensors refer to `tensors`.
+    std::vector<runtime::EValue> outputs;
+    /// Copies of the output tensors, owned by the response.
+    std::vector<TensorPtr> tensors;
+  };
+
+  ModuleScheduler() = default;
+
+  /// Waits for all submitted requests to finish, then stops the workers.
+  ~ModuleScheduler();
+
+  ModuleScheduler(const ModuleScheduler&) = delete;
+  ModuleScheduler& operator=(const ModuleScheduler&) = delete;
+  ModuleScheduler(ModuleScheduler&&) = delete;
+  ModuleScheduler& operator=(ModuleScheduler&&) = delete;
+
+  /**
+   * Adds a backend and starts its worker threads.
+   *
+   * @param[in] name The name to assign models to the backend by.
+   * @param[in] max_concurrency The number of batches that the models of this
+   *     backend can run at the same time.
+   *
+   * @returns Error::Ok on success, or Error::InvalidArgument if the name is
+   *     taken or `max_concurrency` is zero.
+   */
+  ET_NODISCARD runtime::Error add_backend(
+      const std::string& name,
+      size_t max_concurrency);
+
+  /**
+   * Adds a model that requests can be submitted for.
+   *
+   * @param[in] name The name to submit requests for the model by.
+   * @param[in] backend The name of the backend that runs the model.
+   * @param[in] replicas Modules that load the same program. Must not be
+   *     used by anything else while the scheduler owns them.
+   * @param[in] options How to run the model's requests.
+   *
+   * @returns Error::Ok on success, or Error::InvalidArgument if the name is
+   *     taken, the backend does not exist, there are no replicas, or
+   *     `options.max_batch_size` is zero.
+   */
+  ET_NODISCARD runtime::Error add_model(
+      const std::string& name,
+      const std::string& backend,
+      std::vector<std::unique_ptr<Module>> replicas,
+      const ModelOptions& options);
+
+  /**
+   * Queues a request to execute a method of a model.
+   *
+   * @param[in] model The name of the model.
+   * @param[in] method_name The name of the method to execute.
+   * @param[in] inputs The input values of the method. Tensors must stay valid
+   *     until the returned future is ready.
+   * @param[in] deadline When the response is needed by.
+   *
+   * @returns A future that becomes ready once the request has finished,
+   *     holding its outputs or an error. Error::NotFound means that there is
+   *     no such model.
+   */
+  ET_NODISCARD std::future<runtime::Result<Response>> submit(
+      const std::string& model,
+      const std::string& method_name,
+      std::vector<runtime::EValue> inputs,
+      Clock::time_point deadline = Clock::time_point::max());
+
+  /**
+   * Returns the metrics of a model, or Error::NotFound if there is no such
+   * model.
+   */
+  runtime::Result<Metrics> metrics(const std::string& model) const;
+
+ private:
+  struct Request {
+    std::string method_name;
+    std::vector<runtime::EValue> inputs;
+    Clock::time_point deadline;
+    Clock::time_point enqueue_time;
+    uint64_t sequence_number;
+    std::promise<runtime::Result<Response>> promise;
+  };
+
+  struct Model {
+    ModelOptions options;
+    std::vector<std::unique_ptr<Module>> replicas;
+    // Replicas that are not running a batch.
+    std::vector<Module*> idle_replicas;
+    // Queued requests, ordered by runs_before().
+    std::vector<std::unique_ptr<Request>> queue;
+    Metrics metrics;
+  };
+
+  struct Backend {
+    std::vector<Model*> models;
+    std::vector<std::thread> threads;
+  };
+
+  // Whether request `a` should run before request `b`.
+  static bool runs_before(const Request& a, const Request& b);
+
+  // Removes the next batch of requests from the queue of `model`. Must hold
+  // `mutex_`.
+  static std::vector<std::unique_ptr<Request>> take_batch(Model& model);
+
+  // Runs `batch` on `module`, and returns the result of each request.
+  static std::vector<runtime::Result<Response>> run_batch(
+      Module& module,
+      std::vector<std::unique_ptr<Request>>& batch,
+      bool coalesce_rows);
+
+  void worker_loop(Backend& backend);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unordered_map<std::string, std::unique_ptr<Backend>> backends_;
+  std::unordered_map<std::string, std::unique_ptr<Model>> models_;
+  uint64_t next_sequence_number_ = 0;
+  bool stopping_ = false;
+};
+
+} // namespace extension
+} // namespace executorch
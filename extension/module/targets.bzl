@@ -23,10 +23,45 @@ def define_common_targets():
             ],
             deps = [
                 "//executorch/extension/memory_allocator:malloc_memory_allocator",
+                "//executorch/extension/memory_allocator:pooling_memory_allocator",
                 "//executorch/extension/data_loader:file_data_loader",
                 "//executorch/extension/data_loader:mmap_data_loader",
+                "//executorch/extension/data_loader:shared_weight_cache",
                 "//executorch/extension/flat_tensor:flat_tensor_data_map",
             ],
+            exported_deps = [
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+                "//executorch/runtime/executor:program" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "module_scheduler" + aten_suffix,
+            srcs = [
+                "module_scheduler.cpp",
+            ],
+            exported_headers = [
+                "module_scheduler.h",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":module" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "method_scheduler" + aten_suffix,
+            srcs = [
+                "method_scheduler.cpp",
+            ],
+            exported_headers = [
+                "method_scheduler.h",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
             exported_deps = [
                 "//executorch/runtime/executor:program" + aten_suffix,
             ],
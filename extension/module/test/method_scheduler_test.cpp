@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/method_scheduler.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::FileDataLoader;
+using executorch::extension::make_tensor_ptr;
+using executorch::extension::MethodScheduler;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::Method;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::testing::ManagedMemoryManager;
+
+class MethodSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+
+    std::string resources_path;
+    if (const char* env = std::getenv("RESOURCES_PATH")) {
+      resources_path = env;
+    }
+    Result<FileDataLoader> loader =
+        FileDataLoader::from((resources_path + "/add.pte").c_str());
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+
+    Result<Program> program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+  }
+
+  /// Loads another instance of forward() with its own memory, and sets both
+  /// its inputs to `value`.
+  Method& load_method(float value) {
+    mmms_.push_back(std::make_unique<ManagedMemoryManager>(
+        /*planned_memory_bytes=*/32 * 1024U,
+        /*method_allocator_bytes=*/32 * 1024U));
+    Result<Method> method =
+        program_->load_method("forward", &mmms_.back()->get());
+    EXPECT_EQ(method.error(), Error::Ok);
+    methods_.push_back(std::make_unique<Method>(std::move(method.get())));
+    set_inputs(*methods_.back(), value);
+    return *methods_.back();
+  }
+
+  static void set_inputs(Method& method, float value) {
+    auto tensor = make_tensor_ptr({value});
+    EXPECT_EQ(method.set_input(EValue(*tensor), 0), Error::Ok);
+    EXPECT_EQ(method.set_input(EValue(*tensor), 1), Error::Ok);
+  }
+
+  static float output(const Method& method) {
+    return method.get_output(0).toTensor().const_data_ptr<float>()[0];
+  }
+
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<Program> program_;
+  std::vector<std::unique_ptr<ManagedMemoryManager>> mmms_;
+  std::vector<std::unique_ptr<Method>> methods_;
+};
+
+TEST_F(MethodSchedulerTest, RunsSubmittedMethod) {
+  MethodScheduler scheduler;
+  Method& method = load_method(1.f);
+
+  EXPECT_EQ(scheduler.submit(method).get(), Error::Ok);
+  EXPECT_NEAR(output(method), 2.f, 1e-5);
+
+  // The Method is reset, so it can be submitted again.
+  set_inputs(method, 3.f);
+  EXPECT_EQ(scheduler.submit(method).get(), Error::Ok);
+  EXPECT_NEAR(output(method), 6.f, 1e-5);
+}
+
+TEST_F(MethodSchedulerTest, RunsJobsOfAllPriorities) {
+  MethodScheduler scheduler(/*num_threads=*/2);
+  std::vector<Method*> methods;
+  std::vector<std::future<Error>> futures;
+  for (int i = 0; i < 8; ++i) {
+    methods.push_back(&load_method(float(i)));
+    MethodScheduler::JobOptions options;
+    options.priority = i % 3;
+    options.deadline =
+        MethodScheduler::Clock::now() + std::chrono::milliseconds(10 * i);
+    futures.push_back(scheduler.submit(*methods.back(), options));
+  }
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(futures[i].get(), Error::Ok);
+    EXPECT_NEAR(output(*methods[i]), 2.f * i, 1e-5);
+  }
+}
+
+TEST_F(MethodSchedulerTest, PausedSchedulerQueuesJobs) {
+  MethodScheduler scheduler;
+  Method& method = load_method(2.f);
+
+  scheduler.pause();
+  std::future<Error> future = scheduler.submit(method);
+  EXPECT_EQ(
+      future.wait_for(std::chrono::milliseconds(20)),
+      std::future_status::timeout);
+
+  // A Method can only have one unfinished job.
+  EXPECT_EQ(scheduler.submit(method).get(), Error::InvalidState);
+
+  scheduler.resume();
+  EXPECT_EQ(future.get(), Error::Ok);
+  EXPECT_NEAR(output(method), 4.f, 1e-5);
+}
+
+TEST_F(MethodSchedulerTest, DestructorFinishesPausedJobs) {
+  Method& method = load_method(5.f);
+  std::future<Error> future;
+  {
+    MethodScheduler scheduler;
+    scheduler.pause();
+    future = scheduler.submit(method);
+  }
+  EXPECT_EQ(future.get(), Error::Ok);
+  EXPECT_NEAR(output(method), 10.f, 1e-5);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/module_scheduler.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::make_tensor_ptr;
+using executorch::extension::Module;
+using executorch::extension::ModuleScheduler;
+using executorch::extension::TensorPtr;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::Result;
+
+class ModuleSchedulerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    executorch::runtime::runtime_init();
+    std::string resources_path;
+    if (const char* env = std::getenv("RESOURCES_PATH")) {
+      resources_path = env;
+    }
+    model_path_ = resources_path + "/add.pte";
+  }
+
+  static std::vector<std::unique_ptr<Module>> make_replicas(size_t count) {
+    std::vector<std::unique_ptr<Module>> replicas;
+    for (size_t i = 0; i < count; ++i) {
+      replicas.push_back(std::make_unique<Module>(model_path_));
+    }
+    return replicas;
+  }
+
+  static inline std::string model_path_;
+};
+
+TEST_F(ModuleSchedulerTest, ServesRequests) {
+  ModuleScheduler scheduler;
+  ASSERT_EQ(scheduler.add_backend("cpu", 2), Error::Ok);
+  ModuleScheduler::ModelOptions options;
+  options.max_batch_size = 4;
+  ASSERT_EQ(
+      scheduler.add_model("add", "cpu", make_replicas(2), options), Error::Ok);
+
+  std::vector<TensorPtr> inputs;
+  std::vector<std::future<Result<ModuleScheduler::Response>>> futures;
+  for (int i = 0; i < 6; ++i) {
+    inputs.push_back(make_tensor_ptr({float(i)}));
+    futures.push_back(scheduler.submit(
+        "add",
+        "forward",
+        {EValue(*inputs.back()), EValue(*inputs.back())},
+        ModuleScheduler::Clock::now() + std::chrono::seconds(10)));
+  }
+  for (int i = 0; i < 6; ++i) {
+    auto response = futures[i].get();
+    ASSERT_EQ(response.error(), Error::Ok);
+    ASSERT_EQ(response->outputs.size(), 1);
+    EXPECT_NEAR(
+        response->outputs[0].toTensor().const_data_ptr<float>()[0],
+        2.f * i,
+        1e-5);
+  }
+
+  const auto metrics = scheduler.metrics("add");
+  ASSERT_EQ(metrics.error(), Error::Ok);
+  EXPECT_EQ(metrics->num_requests, 6);
+  EXPECT_EQ(metrics->num_failed_requests, 0);
+  EXPECT_EQ(metrics->num_missed_deadlines, 0);
+  EXPECT_GE(metrics->num_batches, 2);
+  EXPECT_LE(metrics->num_batches, 6);
+}
+
+TEST_F(ModuleSchedulerTest, BatchDelayGroupsRequests) {
+  ModuleScheduler scheduler;
+  ASSERT_EQ(scheduler.add_backend("npu", 1), Error::Ok);
+  ModuleScheduler::ModelOptions options;
+  options.max_batch_size = 3;
+  options.max_batch_delay = std::chrono::seconds(10);
+  ASSERT_EQ(
+      scheduler.add_model("add", "npu", make_replicas(1), options), Error::Ok);
+
+  // The first requests wait for the batch to fill up.
+  auto input = make_tensor_ptr({1.f});
+  std::vector<std::future<Result<ModuleScheduler::Response>>> futures;
+  for (int i = 0; i < 3; ++i) {
+    futures.push_back(
+        scheduler.submit("add", "forward", {EValue(*input), EValue(*input)}));
+  }
+  for (auto& future : futures) {
+    EXPECT_EQ(future.get().error(), Error::Ok);
+  }
+  EXPECT_EQ(scheduler.metrics("add")->num_batches, 1);
+}
+
+TEST_F(ModuleSchedulerTest, CountsFailedRequests) {
+  ModuleScheduler scheduler;
+  ASSERT_EQ(scheduler.add_backend("cpu", 1), Error::Ok);
+  ASSERT_EQ(
+      scheduler.add_model("add", "cpu", make_replicas(1), {}), Error::Ok);
+
+  auto response = scheduler.submit("add", "no_such_method", {}).get();
+  EXPECT_NE(response.error(), Error::Ok);
+  EXPECT_EQ(scheduler.metrics("add")->num_requests, 1);
+  EXPECT_EQ(scheduler.metrics("add")->num_failed_requests, 1);
+}
+
+TEST_F(ModuleSchedulerTest, RejectsInvalidConfigurations) {
+  ModuleScheduler scheduler;
+  EXPECT_EQ(scheduler.add_backend("cpu", 0), Error::InvalidArgument);
+  ASSERT_EQ(scheduler.add_backend("cpu", 1), Error::Ok);
+  EXPECT_EQ(scheduler.add_backend("cpu", 1), Error::InvalidArgument);
+
+  EXPECT_EQ(
+      scheduler.add_model("add", "gpu", make_replicas(1), {}),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      scheduler.add_model("add", "cpu", make_replicas(0), {}),
+      Error::InvalidArgument);
+  ModuleScheduler::ModelOptions options;
+  options.max_batch_size = 0;
+  EXPECT_EQ(
+      scheduler.add_model("add", "cpu", make_replicas(1), options),
+      Error::InvalidArgument);
+  ASSERT_EQ(
+      scheduler.add_model("add", "cpu", make_replicas(1), {}), Error::Ok);
+  EXPECT_EQ(
+      scheduler.add_model("add", "cpu", make_replicas(1), {}),
+      Error::InvalidArgument);
+
+  EXPECT_EQ(
+      scheduler.submit("missing", "forward", {}).get().error(),
+      Error::NotFound);
+  EXPECT_EQ(scheduler.metrics("missing").error(), Error::NotFound);
+}
@@ -14,6 +14,7 @@
 #include <gtest/gtest.h>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/data_loader/shared_weight_cache.h>
 #include <executorch/extension/tensor/tensor.h>
 
 using namespace ::executorch::extension;
@@ -247,6 +248,51 @@ TEST_F(ModuleTest, TestForward) {
   EXPECT_NEAR(data2[0], 4, 1e-5);
 }
 
+TEST_F(ModuleTest, TestPlannedMemoryOptions) {
+  for (const size_t prefault_threads : {0, 1, 4}) {
+    Module module(model_path_);
+    Module::PlannedMemoryOptions options;
+    options.use_huge_pages = true;
+    options.prefault_threads = prefault_threads;
+    module.set_planned_memory_options(options);
+    auto tensor = make_tensor_ptr({21.f});
+
+    const auto result = module.forward({tensor, tensor});
+    ASSERT_EQ(result.error(), Error::Ok);
+
+    const auto data = result->at(0).toTensor().const_data_ptr<float>();
+
+    EXPECT_NEAR(data[0], 42, 1e-5);
+  }
+}
+
+TEST_F(ModuleTest, TestWarmup) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.warmup(), Error::Ok);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+  EXPECT_EQ(module.warmup("forward", 2, {{{1}, {1}}}), Error::Ok);
+  EXPECT_EQ(module.warmup("forward", 1, {{{1}}}), Error::InvalidArgument);
+  EXPECT_NE(module.warmup("backward"), Error::Ok);
+
+  // Warming up leaves the Module ready to execute.
+  auto tensor = make_tensor_ptr({21.f});
+  const auto result = module.forward({tensor, tensor});
+  ASSERT_EQ(result.error(), Error::Ok);
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 42, 1e-5);
+}
+
+TEST_F(ModuleTest, TestMutableBuffers) {
+  Module module(model_path_);
+
+  // The add model has no state.
+  const auto buffers = module.mutable_buffers();
+  ASSERT_EQ(buffers.error(), Error::Ok);
+  EXPECT_TRUE(buffers->empty());
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+  EXPECT_NE(module.mutable_buffers("backward").error(), Error::Ok);
+}
+
 TEST_F(ModuleTest, TestForwardWithInvalidInputs) {
   Module module(model_path_);
 
@@ -436,6 +482,96 @@ TEST_F(ModuleTest, TestUnsetInputs) {
   EXPECT_NE(result.error(), Error::Ok);
 }
 
+TEST_F(ModuleTest, TestBindInputPersistsAcrossExecutions) {
+  Module module(model_path_);
+
+  std::vector<float> data1 = {4.f};
+  std::vector<float> data2 = {5.f};
+  auto tensor1 = from_blob(data1.data(), {1});
+  auto tensor2 = from_blob(data2.data(), {1});
+  ASSERT_EQ(module.bind_input(tensor1, 0), Error::Ok);
+  ASSERT_EQ(module.bind_input(tensor2, 1), Error::Ok);
+
+  const auto result1 = module.forward();
+  ASSERT_EQ(result1.error(), Error::Ok);
+  EXPECT_NEAR(result1->at(0).toTensor().const_data_ptr<float>()[0], 9, 1e-5);
+
+  // The method reads the bound memory, so updates show up without rebinding.
+  data1[0] = 10.f;
+  const auto result2 = module.forward();
+  ASSERT_EQ(result2.error(), Error::Ok);
+  EXPECT_NEAR(result2->at(0).toTensor().const_data_ptr<float>()[0], 15, 1e-5);
+
+  // Setting an input replaces its binding.
+  auto tensor3 = make_tensor_ptr({1.f});
+  ASSERT_EQ(module.set_input(tensor3, 0), Error::Ok);
+  data1[0] = 100.f;
+  const auto result3 = module.forward();
+  ASSERT_EQ(result3.error(), Error::Ok);
+  EXPECT_NEAR(result3->at(0).toTensor().const_data_ptr<float>()[0], 6, 1e-5);
+  EXPECT_EQ(data1[0], 100.f);
+}
+
+TEST_F(ModuleTest, TestBindOutputReceivesResults) {
+  Module module(model_path_);
+
+  auto output = empty({1});
+  ASSERT_EQ(module.bind_output(output), Error::Ok);
+
+  auto tensor = make_tensor_ptr({21.f});
+  const auto result1 = module.forward({tensor, tensor});
+  ASSERT_EQ(result1.error(), Error::Ok);
+  EXPECT_NEAR(output->const_data_ptr<float>()[0], 42, 1e-5);
+
+  auto tensor2 = make_tensor_ptr({2.f});
+  const auto result2 = module.forward({tensor2, tensor2});
+  ASSERT_EQ(result2.error(), Error::Ok);
+  EXPECT_NEAR(output->const_data_ptr<float>()[0], 4, 1e-5);
+
+  EXPECT_NE(module.bind_output(output, 1), Error::Ok);
+  EXPECT_NE(module.bind_input(tensor, 2), Error::Ok);
+  EXPECT_EQ(module.bind_output(EValue()), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestExecuteBatch) {
+  Module module(model_path_);
+
+  std::vector<TensorPtr> tensors;
+  std::vector<std::vector<EValue>> requests;
+  for (int i = 0; i < 5; ++i) {
+    tensors.push_back(make_tensor_ptr({float(i)}));
+    requests.push_back({tensors.back(), tensors.back()});
+  }
+  const auto result = module.execute_batch("forward", requests);
+  ASSERT_EQ(result.error(), Error::Ok);
+  ASSERT_EQ(result->size(), requests.size());
+  for (size_t i = 0; i < result->size(); ++i) {
+    ASSERT_EQ(result->at(i).size(), 1);
+    const auto& output = result->at(i)[0].toTensor();
+    EXPECT_NEAR(output.const_data_ptr<float>()[0], 2 * i, 1e-5);
+  }
+
+  // The inputs of "forward" have static shapes, so opting into coalescing
+  // still runs the requests separately.
+  const auto coalesced =
+      module.execute_batch("forward", requests, /*coalesce_rows=*/true);
+  ASSERT_EQ(coalesced.error(), Error::Ok);
+  ASSERT_EQ(coalesced->size(), requests.size());
+  for (size_t i = 0; i < coalesced->size(); ++i) {
+    const auto& output = coalesced->at(i)[0].toTensor();
+    EXPECT_NEAR(output.const_data_ptr<float>()[0], 2 * i, 1e-5);
+  }
+
+  // Requests must provide every input.
+  std::vector<std::vector<EValue>> short_requests(1);
+  short_requests[0].push_back(tensors[0]);
+  EXPECT_NE(module.execute_batch("forward", short_requests).error(), Error::Ok);
+
+  auto output = empty({1});
+  ASSERT_EQ(module.bind_output(output), Error::Ok);
+  EXPECT_NE(module.execute_batch("forward", requests).error(), Error::Ok);
+}
+
 TEST_F(ModuleTest, TestSetOutputInvalidIndex) {
   Module module(model_path_);
 
@@ -460,3 +596,75 @@ TEST_F(ModuleTest, TestPTD) {
 
   ASSERT_EQ(module.forward(tensor1).error(), Error::Ok);
 }
+
+TEST_F(ModuleTest, TestUpdateExternalConstants) {
+  Module module(linear_path_, linear_data_path_);
+
+  auto tensor =
+      make_tensor_ptr({3, 3}, {2.f, 3.f, 4.f, 2.f, 3.f, 4.f, 2.f, 3.f, 4.f});
+  const auto before = module.forward(tensor);
+  ASSERT_EQ(before.error(), Error::Ok);
+  const auto expected = clone_tensor_ptr(before->at(0).toTensor());
+
+  // Reloading the same weights from their own .ptd doesn't change the output.
+  ASSERT_EQ(
+      module.update_external_constants("forward", linear_data_path_),
+      Error::Ok);
+  const auto after = module.forward(tensor);
+  ASSERT_EQ(after.error(), Error::Ok);
+  const auto& output = after->at(0).toTensor();
+  ASSERT_EQ(output.numel(), expected->numel());
+  for (ssize_t i = 0; i < output.numel(); ++i) {
+    EXPECT_EQ(
+        output.const_data_ptr<float>()[i],
+        expected->const_data_ptr<float>()[i]);
+  }
+
+  EXPECT_NE(
+      module.update_external_constants("forward", "/path/to/nonexistent.ptd"),
+      Error::Ok);
+  EXPECT_NE(
+      module.update_external_constants("forward", linear_path_), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestShareWeightsBetweenModules) {
+  Module module1(
+      linear_path_, linear_data_path_, Module::LoadMode::File, nullptr, true);
+  Module module2(
+      linear_path_, linear_data_path_, Module::LoadMode::File, nullptr, true);
+
+  ASSERT_EQ(module1.load_method("forward"), Error::Ok);
+  const auto live_segments = SharedWeightCache::global().num_live_segments();
+  EXPECT_GT(live_segments, 0);
+
+  // The second Module reuses the segments that the first one loaded.
+  ASSERT_EQ(module2.load_method("forward"), Error::Ok);
+  EXPECT_EQ(SharedWeightCache::global().num_live_segments(), live_segments);
+
+  auto tensor =
+      make_tensor_ptr({3, 3}, {2.f, 3.f, 4.f, 2.f, 3.f, 4.f, 2.f, 3.f, 4.f});
+  const auto result1 = module1.forward(tensor);
+  ASSERT_EQ(result1.error(), Error::Ok);
+  const auto result2 = module2.forward(tensor);
+  ASSERT_EQ(result2.error(), Error::Ok);
+  const auto& output1 = result1->at(0).toTensor();
+  const auto& output2 = result2->at(0).toTensor();
+  ASSERT_EQ(output1.numel(), output2.numel());
+  for (ssize_t i = 0; i < output1.numel(); ++i) {
+    EXPECT_EQ(
+        output1.const_data_ptr<float>()[i], output2.const_data_ptr<float>()[i]);
+  }
+}
+
+TEST_F(ModuleTest, TestSegmentsSharedWithinModuleByDefault) {
+  const auto live_segments = SharedWeightCache::global().num_live_segments();
+  Module module(linear_path_, linear_data_path_, Module::LoadMode::File);
+
+  // The methods of the Module share its segments through a cache of its own.
+  ASSERT_EQ(module.load_method("forward"), Error::Ok);
+  EXPECT_EQ(SharedWeightCache::global().num_live_segments(), live_segments);
+
+  auto tensor =
+      make_tensor_ptr({3, 3}, {2.f, 3.f, 4.f, 2.f, 3.f, 4.f, 2.f, 3.f, 4.f});
+  ASSERT_EQ(module.forward(tensor).error(), Error::Ok);
+}
@@ -23,6 +23,7 @@ def define_common_targets():
             deps = [
                 "//executorch/kernels/portable:generated_lib" + aten_suffix,
                 "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/data_loader:shared_weight_cache",
                 "//executorch/extension/module:module" + aten_suffix,
                 "//executorch/extension/tensor:tensor" + aten_suffix,
             ],
@@ -35,6 +36,43 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_test(
+            name = "module_scheduler_test" + aten_suffix,
+            srcs = [
+                "module_scheduler_test.cpp",
+            ],
+            deps = [
+                "//executorch/kernels/portable:generated_lib" + aten_suffix,
+                "//executorch/extension/module:module_scheduler" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+            env = {
+                "RESOURCES_PATH": "$(location :resources)/resources",
+            },
+            platforms = [CXX, ANDROID],  # Cannot bundle resources on Apple platform.
+            compiler_flags = [
+                "-Wno-error=deprecated-declarations",
+            ],
+        )
+
+        runtime.cxx_test(
+            name = "method_scheduler_test" + aten_suffix,
+            srcs = [
+                "method_scheduler_test.cpp",
+            ],
+            deps = [
+                "//executorch/kernels/portable:generated_lib" + aten_suffix,
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/module:method_scheduler" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+                "//executorch/runtime/executor/test:managed_memory_manager",
+            ],
+            env = {
+                "RESOURCES_PATH": "$(location :resources)/resources",
+            },
+            platforms = [CXX, ANDROID],  # Cannot bundle resources on Apple platform.
+        )
+
     runtime.filegroup(
         name = "resources",
         srcs = native.glob([
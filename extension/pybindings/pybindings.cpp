@@ -7,10 +7,15 @@
  */
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 
 #include <pybind11/iostream.h>
@@ -114,6 +119,7 @@ using torch::executor::ETDumpGen;
 #ifndef USE_ATEN_LIB
 using ::executorch::extension::alias_attensor_to_etensor;
 using ::executorch::extension::alias_etensor_to_attensor;
+using ::executorch::extension::get_attensor_dim_order;
 using ::executorch::extension::torch_to_executorch_scalar_type;
 #endif // !USE_ATEN_LIB
 
@@ -141,6 +147,19 @@ void write_data_to_file(const std::string& path, void* buf, size_t size) {
   }
 }
 
+/**
+ * Returns `python_input`, a torch.Tensor or an object that supports DLPack
+ * like a numpy array, as an at::Tensor that shares its memory.
+ */
+at::Tensor tensor_from_python(const py::handle& python_input) {
+  if (THPVariable_Check(python_input.ptr())) {
+    return python_input.cast<at::Tensor>();
+  }
+  return py::module_::import("torch.utils.dlpack")
+      .attr("from_dlpack")(python_input)
+      .cast<at::Tensor>();
+}
+
 void setup_output_storage(
     Method& method,
     const std::vector<Span<uint8_t>>& output_storages) {
@@ -257,7 +276,16 @@ class Module final {
       const std::vector<EValue>& args,
       const std::optional<std::vector<Span<uint8_t>>>& output_storages =
           std::nullopt) {
-    auto& method = get_method(method_name);
+    return run_method(get_method(method_name), args, output_storages);
+  }
+
+  /// Executes `method`, one of the methods of this module or a clone of one,
+  /// on the provided inputs and returns its outputs.
+  static std::vector<EValue> run_method(
+      Method& method,
+      const std::vector<EValue>& args,
+      const std::optional<std::vector<Span<uint8_t>>>& output_storages =
+          std::nullopt) {
     executorch::aten::ArrayRef<EValue> input_evalue_list(
         args.data(), args.size());
 
@@ -265,7 +293,7 @@ class Module final {
     THROW_IF_ERROR(
         set_inputs_status,
         "method->set_inputs() for method '%s' failed with error 0x%" PRIx32,
-        method_name.c_str(),
+        method.method_meta().name(),
         static_cast<uint32_t>(set_inputs_status));
 
 #ifdef USE_ATEN_LIB
@@ -290,19 +318,22 @@ class Module final {
         "method->execute() failed with error 0x%" PRIx32,
         static_cast<uint32_t>(execute_status));
     // process outputs
-    return get_outputs(method_name);
+    return get_outputs(method);
   }
 
   std::vector<EValue> get_outputs(const std::string& method_name) {
-    auto& method = methods_[method_name];
-    std::vector<EValue> result(method->outputs_size());
+    return get_outputs(*methods_[method_name]);
+  }
+
+  static std::vector<EValue> get_outputs(Method& method) {
+    std::vector<EValue> result(method.outputs_size());
 
     Error get_outputs_status =
-        method->get_outputs(result.data(), method->outputs_size());
+        method.get_outputs(result.data(), method.outputs_size());
     THROW_IF_ERROR(
         get_outputs_status,
         "method->get_outputs() for method '%s' failed with error 0x%" PRIx32,
-        method_name.c_str(),
+        method.method_meta().name(),
         static_cast<uint32_t>(get_outputs_status));
 
     return result;
@@ -327,6 +358,41 @@ class Module final {
     return names;
   }
 
+ private:
+  class Memory;
+
+ public:
+  /// A clone of one of the methods, along with the planned memory it uses.
+  struct MethodClone {
+    std::unique_ptr<Memory> memory;
+    std::unique_ptr<Method> method;
+  };
+
+  /// Returns a clone of the specified method that can execute at the same
+  /// time as the method and its other clones; see
+  /// `Method::clone_with_memory()`. Must not be called while the method is
+  /// executing, and the clone must not outlive this module.
+  std::unique_ptr<MethodClone> clone_method(const std::string& method_name) {
+    const auto& method = get_method(method_name);
+    const auto method_meta = method.method_meta();
+    std::vector<std::vector<uint8_t>> non_const_buffers;
+    for (size_t i = 0; i < method_meta.num_non_const_buffers(); ++i) {
+      non_const_buffers.emplace_back(
+          method_meta.non_const_buffer_size(i).get());
+    }
+    auto clone = std::make_unique<MethodClone>();
+    clone->memory = std::make_unique<Memory>(std::move(non_const_buffers));
+    Result<Method> method_clone =
+        method.clone_with_memory(clone->memory->mem_manager());
+    THROW_IF_ERROR(
+        method_clone.error(),
+        "cloning method %s failed with error 0x%" PRIx32,
+        method_name.c_str(),
+        static_cast<uint32_t>(method_clone.error()));
+    clone->method = std::make_unique<Method>(std::move(method_clone.get()));
+    return clone;
+  }
+
   bool has_etdump() {
     return static_cast<bool>(event_tracer_);
   }
@@ -597,6 +663,26 @@ struct PyMethodMeta final {
   torch::executor::MethodMeta meta_;
 };
 
+/**
+ * Python inputs converted into EValues, along with the state that the EValues
+ * refer to. The EValues point into the other members, so this must not be
+ * copied or moved once it is filled in.
+ */
+struct ConvertedInputs final {
+  std::vector<EValue> evalues;
+  // Inputs converted from DLPack have no other owner, so keep them alive
+  // until the method has run.
+  std::vector<at::Tensor> at_tensors;
+#ifndef USE_ATEN_LIB // Portable mode
+  // So the ETensors and their metadata stay in scope for
+  // Module->run_method.
+  std::vector<torch::executor::TensorImpl> tensor_impls;
+  std::vector<std::vector<torch::executor::Tensor::SizesType>> sizes;
+  std::vector<std::vector<torch::executor::Tensor::StridesType>> strides;
+  std::vector<std::vector<torch::executor::Tensor::DimOrderType>> dim_orders;
+#endif
+};
+
 struct PyModule final {
   explicit PyModule(
       const py::bytes& buffer,
@@ -639,8 +725,12 @@ struct PyModule final {
 
   PyModule(const PyModule&) = delete;
   PyModule& operator=(const PyModule&) = delete;
-  PyModule(PyModule&&) = default;
-  PyModule& operator=(PyModule&&) = default;
+  PyModule(PyModule&&) = delete;
+  PyModule& operator=(PyModule&&) = delete;
+
+  ~PyModule() {
+    stop_async_workers();
+  }
 
   // Module is only valid as long as the python buffer is alive.
   static std::unique_ptr<PyModule> load_from_buffer(
@@ -676,104 +766,91 @@ struct PyModule final {
   py::list run_method(
       const std::string& method_name,
       const py::sequence& inputs,
-      bool clone_outputs = true) {
-    const auto inputs_size = py::len(inputs);
-    std::vector<EValue> cpp_inputs;
-    cpp_inputs.reserve(inputs_size);
-
-#ifndef USE_ATEN_LIB // Portable mode
-    // So the ETensors and their metadata stay in scope for
-    // Module->run_method.
-    std::vector<torch::executor::TensorImpl> input_tensors;
-    std::vector<std::vector<torch::executor::Tensor::SizesType>> input_sizes;
-    std::vector<std::vector<torch::executor::Tensor::StridesType>>
-        input_strides;
-    std::vector<std::vector<torch::executor::Tensor::DimOrderType>>
-        input_dim_order;
-    // We store pointers to these vector elements so important to reserve so
-    // that we don't lose those on a vector resize. Don't need to do this for
-    // the others since they are vectors of vectors, and we don't store a
-    // pointer to the root level vector data.
-    input_tensors.reserve(inputs_size);
-#endif
-
-    // Convert python objects into EValues.
-    for (size_t i = 0; i < inputs_size; ++i) {
-      auto python_input = inputs[i];
-      const std::string& type_str = py::str(python_input.get_type());
-      if (type_str == "<class 'torch.Tensor'>") {
-        auto at_tensor = python_input.cast<at::Tensor>();
-        // alias_etensor_to_attensor will assert on this later, so to better
-        // propogate up to python we check early and throw an exception.
-        if (!at_tensor.is_contiguous()) {
-          auto error_msg = "Input " + std::to_string(i) + "for method " +
-              method_name + " is not contiguous.";
-          throw std::runtime_error(error_msg);
-        }
-
-#ifdef USE_ATEN_LIB
-        EValue evalue(at_tensor);
-#else
-        // convert at::Tensor to torch::executor::Tensor
-        auto type =
-            torch_to_executorch_scalar_type(at_tensor.options().dtype());
-        size_t dim = at_tensor.dim();
-        // cant directly alias at::Tensor sizes and strides due to int64 vs
-        // int32 typing conflict
-        input_sizes.emplace_back(
-            at_tensor.sizes().begin(), at_tensor.sizes().end());
-        input_strides.emplace_back(
-            at_tensor.strides().begin(), at_tensor.strides().end());
-
-        // Only works for MemoryFormat::Contiguous inputs
-        std::vector<torch::executor::Tensor::DimOrderType> dim_order;
-        for (size_t cur_dim = 0; cur_dim < dim; cur_dim++) {
-          dim_order.push_back(cur_dim);
-        }
-        input_dim_order.push_back(std::move(dim_order));
-        input_tensors.emplace_back(
-            type,
-            dim,
-            input_sizes.back().data(),
-            nullptr,
-            input_dim_order.back().data(),
-            input_strides.back().data());
-
-        torch::executor::Tensor temp =
-            torch::executor::Tensor(&input_tensors.back());
-        alias_etensor_to_attensor(at_tensor, temp);
-        EValue evalue(temp);
-#endif
-
-        cpp_inputs.push_back(evalue);
-      } else if (py::isinstance<py::none>(python_input)) {
-        cpp_inputs.push_back(EValue());
-      } else if (py::isinstance<py::bool_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<bool>(python_input)));
-      } else if (py::isinstance<py::int_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<int64_t>(python_input)));
-      } else {
-        ET_ASSERT_UNREACHABLE_MSG("Unsupported pytype: %s", type_str.c_str());
-      }
-    }
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
+    auto lock = lock_for_execution();
+    ConvertedInputs cpp_inputs;
+    convert_inputs(method_name, inputs, cpp_inputs);
 
     const auto& method = module_->get_method(method_name);
     const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
+    const auto output_tensors = get_output_tensors(method, outputs);
+    output_storages_ = make_output_storages(method, output_tensors);
     std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
     for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
+      if (output_tensors[i].has_value()) {
+        output_storage_spans[i] = Span<uint8_t>(
+            static_cast<uint8_t*>(output_tensors[i]->data_ptr()),
+            output_tensors[i]->nbytes());
+      } else {
+        output_storage_spans[i] = Span<uint8_t>(
+            output_storages_[i].data(), output_storages_[i].size());
+      }
+    }
+    std::vector<EValue> cpp_outputs;
+    {
+      // Execution doesn't touch python objects, so let other threads run
+      // python, and other modules, in the meantime.
+      py::gil_scoped_release release;
+      cpp_outputs = module_->run_method(
+          method_name, cpp_inputs.evalues, output_storage_spans);
     }
-    auto outputs =
-        module_->run_method(method_name, cpp_inputs, output_storage_spans);
 
     // Retrieve outputs
-    return get_outputs_as_py_list(outputs, clone_outputs);
+    return get_outputs_as_py_list(cpp_outputs, clone_outputs, output_tensors);
   }
 
-  py::list forward(const py::sequence& inputs, bool clone_outputs = true) {
-    return run_method("forward", inputs, clone_outputs);
+  py::list forward(
+      const py::sequence& inputs,
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
+    return run_method("forward", inputs, clone_outputs, outputs);
+  }
+
+  /**
+   * Queues a run of the method on the inputs, and returns a
+   * concurrent.futures.Future for the list of its outputs, which are always
+   * cloned. Requests run on a pool of worker threads owned by this module,
+   * each with its own clone of the method, without holding the GIL.
+   */
+  py::object run_method_async(
+      const std::string& method_name,
+      const py::sequence& inputs) {
+    // Fail right away for a bad name.
+    module_->get_method(method_name);
+    auto request = std::make_shared<AsyncRequest>();
+    request->method_name = method_name;
+    convert_inputs(method_name, inputs, request->inputs);
+    request->future =
+        py::module_::import("concurrent.futures").attr("Future")();
+    py::object future = request->future;
+    {
+      std::lock_guard<std::mutex> guard(async_mutex_);
+      while (async_workers_.size() < num_async_workers_) {
+        auto worker = std::make_unique<AsyncWorker>();
+        worker->thread =
+            std::thread(&PyModule::run_async_worker, this, worker.get());
+        async_workers_.push_back(std::move(worker));
+      }
+      async_requests_.push_back(std::move(request));
+    }
+    async_cv_.notify_one();
+    return future;
+  }
+
+  /// Sets the number of threads that run requests from run_method_async().
+  /// Must be called before its first request.
+  void set_num_async_workers(size_t num_workers) {
+    if (num_workers == 0) {
+      throw std::runtime_error("num_workers must be positive");
+    }
+    std::lock_guard<std::mutex> guard(async_mutex_);
+    if (!async_workers_.empty()) {
+      throw std::runtime_error(
+          "The async workers are already running; set their number before "
+          "the first call to run_method_async()");
+    }
+    num_async_workers_ = num_workers;
   }
 
   py::list forward_single_input(
@@ -821,6 +898,7 @@ struct PyModule final {
       PyBundledModule& m,
       const std::string method_name,
       size_t testset_idx) {
+    auto lock = lock_for_execution();
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
     Error status = executorch::bundled_program::load_bundled_input(
         module_->get_method(method_name), bundled_program_ptr, testset_idx);
@@ -836,6 +914,7 @@ struct PyModule final {
       size_t testset_idx,
       double rtol = 1e-5,
       double atol = 1e-8) {
+    auto lock = lock_for_execution();
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
     auto& method = module_->get_method(method_name);
     Error status = executorch::bundled_program::load_bundled_input(
@@ -844,7 +923,7 @@ struct PyModule final {
         status,
         "load_bundled_input failed with status 0x%" PRIx32,
         static_cast<uint32_t>(status));
-    py::list outputs = plan_execute(method_name);
+    py::list outputs = execute_planned(method_name);
     status = executorch::bundled_program::verify_method_outputs(
         method, bundled_program_ptr, testset_idx, rtol, atol);
     THROW_IF_ERROR(
@@ -857,28 +936,14 @@ struct PyModule final {
   py::list plan_execute(
       const std::string method_name,
       bool clone_outputs = true) {
-    auto& method = module_->get_method(method_name);
-    // Need to pre-allocate space for outputs just like in run_method.
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
-    setup_output_storage(method, output_storage_spans);
-    auto status = method.execute();
-    THROW_IF_ERROR(
-        status,
-        "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
-        static_cast<uint32_t>(status));
-    const auto outputs = module_->get_outputs(method_name);
-    return get_outputs_as_py_list(outputs, clone_outputs);
+    auto lock = lock_for_execution();
+    return execute_planned(method_name, clone_outputs);
   }
 
   py::list get_outputs_as_py_list(
       const std::vector<EValue>& outputs,
-      bool clone_outputs = true) {
+      bool clone_outputs = true,
+      const std::vector<std::optional<at::Tensor>>& output_tensors = {}) {
     const auto outputs_size = outputs.size();
     py::list list(outputs_size);
     for (size_t i = 0; i < outputs_size; ++i) {
@@ -894,6 +959,19 @@ struct PyModule final {
       } else if (Tag::String == v.tag) {
         list[i] = py::cast(std::string(v.toString().data()));
       } else if (Tag::Tensor == v.tag) {
+        if (i < output_tensors.size() && output_tensors[i].has_value()) {
+          // The method wrote this output into the caller's tensor. Shrink the
+          // tensor to the output's shape if the shape is dynamic; this never
+          // reallocates since the tensor is at least as large as the output.
+          at::Tensor output_tensor = *output_tensors[i];
+          const auto sizes = v.toTensor().sizes();
+          const std::vector<int64_t> output_sizes(sizes.begin(), sizes.end());
+          if (output_tensor.sizes() != at::IntArrayRef(output_sizes)) {
+            output_tensor.resize_(output_sizes);
+          }
+          list[i] = py::cast(output_tensor);
+          continue;
+        }
 #ifdef USE_ATEN_LIB
         // Clone so the outputs in python do not share a lifetime with the
         // module object
@@ -930,15 +1008,341 @@ struct PyModule final {
   // Need to keep-alive output storages until they can be compared in case of
   // bundled programs.
   std::vector<std::vector<uint8_t>> output_storages_;
+  // Serializes the executions of this module, which the GIL no longer does
+  // since it is released while a method executes.
+  std::mutex execution_mutex_;
+
+  /// A request queued by run_method_async(). Holds python objects, so it must
+  /// only be destroyed with the GIL held.
+  struct AsyncRequest final {
+    std::string method_name;
+    ConvertedInputs inputs;
+    py::object future;
+  };
 
-  std::vector<std::vector<uint8_t>> make_output_storages(const Method& method) {
+  /// A clone of a method that a worker runs requests on.
+  struct AsyncMethod final {
+    std::unique_ptr<Module::MethodClone> clone;
+    std::vector<std::vector<uint8_t>> output_storages;
+  };
+
+  struct AsyncWorker final {
+    std::thread thread;
+    // The clones of the methods that this worker has run, by name.
+    std::unordered_map<std::string, AsyncMethod> methods;
+  };
+
+  static constexpr size_t kDefaultNumAsyncWorkers = 2;
+
+  // Guards the members below.
+  std::mutex async_mutex_;
+  std::condition_variable async_cv_;
+  std::deque<std::shared_ptr<AsyncRequest>> async_requests_;
+  std::vector<std::unique_ptr<AsyncWorker>> async_workers_;
+  size_t num_async_workers_ = kDefaultNumAsyncWorkers;
+  bool stop_async_workers_ = false;
+
+  /// Runs queued requests until the module is destroyed, and the queue is
+  /// empty.
+  void run_async_worker(AsyncWorker* worker) {
+    while (true) {
+      std::shared_ptr<AsyncRequest> request;
+      {
+        std::unique_lock<std::mutex> lock(async_mutex_);
+        async_cv_.wait(lock, [this] {
+          return stop_async_workers_ || !async_requests_.empty();
+        });
+        if (async_requests_.empty()) {
+          return;
+        }
+        request = std::move(async_requests_.front());
+        async_requests_.pop_front();
+      }
+      bool cancelled = false;
+      {
+        py::gil_scoped_acquire acquire;
+        try {
+          // Skip the requests that were cancelled while they were queued.
+          cancelled = !request->future.attr("set_running_or_notify_cancel")()
+                           .cast<bool>();
+        } catch (py::error_already_set& e) {
+          e.discard_as_unraisable("run_method_async");
+          cancelled = true;
+        }
+        if (cancelled) {
+          request.reset();
+          continue;
+        }
+      }
+      std::vector<EValue> outputs;
+      std::string error;
+      try {
+        outputs = run_async_request(*worker, *request);
+      } catch (const std::exception& e) {
+        error = e.what();
+      }
+      py::gil_scoped_acquire acquire;
+      py::list result;
+      if (error.empty()) {
+        try {
+          // The outputs are overwritten by the next request on this worker.
+          result = get_outputs_as_py_list(outputs, /*clone_outputs=*/true);
+        } catch (const std::exception& e) {
+          error = e.what();
+        }
+      }
+      try {
+        if (error.empty()) {
+          request->future.attr("set_result")(result);
+        } else {
+          request->future.attr("set_exception")(
+              py::reinterpret_borrow<py::object>(PyExc_RuntimeError)(error));
+        }
+      } catch (py::error_already_set& e) {
+        e.discard_as_unraisable("run_method_async");
+      }
+      request.reset();
+    }
+  }
+
+  /// Runs `request` on the worker's clone of its method. Called without the
+  /// GIL.
+  std::vector<EValue> run_async_request(
+      AsyncWorker& worker,
+      AsyncRequest& request) {
+    auto it = worker.methods.find(request.method_name);
+    if (it == worker.methods.end()) {
+      AsyncMethod async_method;
+      {
+        // The method must not execute while it is cloned.
+        std::lock_guard<std::mutex> guard(execution_mutex_);
+        async_method.clone = module_->clone_method(request.method_name);
+      }
+      async_method.output_storages =
+          make_output_storages(*async_method.clone->method);
+      it = worker.methods.emplace(request.method_name, std::move(async_method))
+               .first;
+    }
+    auto& output_storages = it->second.output_storages;
+    Method& method = *it->second.clone->method;
+    std::vector<Span<uint8_t>> output_storage_spans(output_storages.size());
+    for (size_t i = 0; i < output_storages.size(); ++i) {
+      output_storage_spans[i] =
+          Span<uint8_t>(output_storages[i].data(), output_storages[i].size());
+    }
+    // Clones share delegate handles with the method, and backends may not
+    // support executing a handle on several threads at once.
+    std::unique_lock<std::mutex> lock(execution_mutex_, std::defer_lock);
+    if (method.method_meta().num_backends() > 0) {
+      lock.lock();
+    }
+    return Module::run_method(
+        method, request.inputs.evalues, output_storage_spans);
+  }
+
+  void stop_async_workers() {
+    {
+      std::lock_guard<std::mutex> guard(async_mutex_);
+      stop_async_workers_ = true;
+    }
+    async_cv_.notify_all();
+    // The workers take the GIL to complete the remaining requests.
+    std::optional<py::gil_scoped_release> release;
+    if (PyGILState_Check()) {
+      release.emplace();
+    }
+    for (auto& worker : async_workers_) {
+      worker->thread.join();
+    }
+    async_workers_.clear();
+  }
+
+  /// Converts the python objects in `inputs` into EValues in `converted`.
+  static void convert_inputs(
+      const std::string& method_name,
+      const py::sequence& inputs,
+      ConvertedInputs& converted) {
+    const auto inputs_size = py::len(inputs);
+    auto& cpp_inputs = converted.evalues;
+    cpp_inputs.reserve(inputs_size);
+    auto& input_at_tensors = converted.at_tensors;
+    input_at_tensors.reserve(inputs_size);
+
+#ifndef USE_ATEN_LIB // Portable mode
+    auto& input_tensors = converted.tensor_impls;
+    auto& input_sizes = converted.sizes;
+    auto& input_strides = converted.strides;
+    auto& input_dim_order = converted.dim_orders;
+    // We store pointers to these vector elements so important to reserve so
+    // that we don't lose those on a vector resize. Don't need to do this for
+    // the others since they are vectors of vectors, and we don't store a
+    // pointer to the root level vector data.
+    input_tensors.reserve(inputs_size);
+#endif
+
+    // Convert python objects into EValues.
+    for (size_t i = 0; i < inputs_size; ++i) {
+      auto python_input = inputs[i];
+      const std::string& type_str = py::str(python_input.get_type());
+      if (type_str == "<class 'torch.Tensor'>" ||
+          py::hasattr(python_input, "__dlpack__")) {
+        auto& at_tensor =
+            input_at_tensors.emplace_back(tensor_from_python(python_input));
+        // alias_etensor_to_attensor will assert on this later, so to better
+        // propogate up to python we check early and throw an exception.
+        auto at_dim_order = get_attensor_dim_order(at_tensor);
+        if (!at_dim_order.ok()) {
+          auto error_msg = "Input " + std::to_string(i) + " for method " +
+              method_name + " is not dense in any dim order.";
+          throw std::runtime_error(error_msg);
+        }
+
+#ifdef USE_ATEN_LIB
+        EValue evalue(at_tensor);
+#else
+        // convert at::Tensor to torch::executor::Tensor
+        auto type =
+            torch_to_executorch_scalar_type(at_tensor.options().dtype());
+        size_t dim = at_tensor.dim();
+        // cant directly alias at::Tensor sizes and strides due to int64 vs
+        // int32 typing conflict
+        input_sizes.emplace_back(
+            at_tensor.sizes().begin(), at_tensor.sizes().end());
+        input_strides.emplace_back(
+            at_tensor.strides().begin(), at_tensor.strides().end());
+
+        // E.g. channels-last inputs alias with their own dim order.
+        input_dim_order.push_back(std::move(at_dim_order.get()));
+        input_tensors.emplace_back(
+            type,
+            dim,
+            input_sizes.back().data(),
+            nullptr,
+            input_dim_order.back().data(),
+            input_strides.back().data());
+
+        torch::executor::Tensor temp =
+            torch::executor::Tensor(&input_tensors.back());
+        alias_etensor_to_attensor(at_tensor, temp);
+        EValue evalue(temp);
+#endif
+
+        cpp_inputs.push_back(evalue);
+      } else if (py::isinstance<py::none>(python_input)) {
+        cpp_inputs.push_back(EValue());
+      } else if (py::isinstance<py::bool_>(python_input)) {
+        cpp_inputs.push_back(EValue(py::cast<bool>(python_input)));
+      } else if (py::isinstance<py::int_>(python_input)) {
+        cpp_inputs.push_back(EValue(py::cast<int64_t>(python_input)));
+      } else {
+        ET_ASSERT_UNREACHABLE_MSG("Unsupported pytype: %s", type_str.c_str());
+      }
+    }
+  }
+
+  std::unique_lock<std::mutex> lock_for_execution() {
+    // Wait without the GIL, so the thread that holds the lock can take the GIL
+    // to finish.
+    py::gil_scoped_release release;
+    return std::unique_lock<std::mutex>(execution_mutex_);
+  }
+
+  py::list execute_planned(
+      const std::string& method_name,
+      bool clone_outputs = true) {
+    auto& method = module_->get_method(method_name);
+    // Need to pre-allocate space for outputs just like in run_method.
     const auto num_outputs = method.outputs_size();
-    // Create a buffer for each output tensor. Memory planned outputs and non
-    // tensor outputs get an empty buffer in this list which is ignored later.
+    output_storages_ = make_output_storages(method);
+    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
+    for (int i = 0; i < output_storages_.size(); ++i) {
+      output_storage_spans[i] =
+          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
+    }
+    setup_output_storage(method, output_storage_spans);
+    Error status = Error::Ok;
+    {
+      py::gil_scoped_release release;
+      status = method.execute();
+    }
+    THROW_IF_ERROR(
+        status,
+        "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
+        static_cast<uint32_t>(status));
+    const auto outputs = module_->get_outputs(method_name);
+    return get_outputs_as_py_list(outputs, clone_outputs);
+  }
+
+  /**
+   * Returns the tensors that the caller passed to write the outputs of
+   * `method` into, or nullopt for the outputs that the caller didn't pass a
+   * tensor for.
+   */
+  std::vector<std::optional<at::Tensor>> get_output_tensors(
+      const Method& method,
+      const py::object& outputs) {
+    const auto num_outputs = method.outputs_size();
+    std::vector<std::optional<at::Tensor>> output_tensors(num_outputs);
+    if (outputs.is_none()) {
+      return output_tensors;
+    }
+    const auto py_outputs = outputs.cast<py::sequence>();
+    if (py::len(py_outputs) != num_outputs) {
+      throw std::runtime_error(
+          "Expected " + std::to_string(num_outputs) + " outputs, got " +
+          std::to_string(py::len(py_outputs)));
+    }
+    const auto meta = method.method_meta();
+    for (size_t i = 0; i < num_outputs; ++i) {
+      if (py_outputs[i].is_none()) {
+        continue;
+      }
+      const auto output_tensor_meta = meta.output_tensor_meta(i);
+      if (!output_tensor_meta.ok()) {
+        throw std::runtime_error(
+            "Output " + std::to_string(i) + " is not a tensor");
+      }
+      if (output_tensor_meta->is_memory_planned()) {
+        throw std::runtime_error(
+            "Output " + std::to_string(i) +
+            " is memory planned; pass None for it and clone_outputs=False "
+            "to alias its planned memory instead");
+      }
+      at::Tensor output_tensor = tensor_from_python(py_outputs[i]);
+      if (!output_tensor.is_contiguous()) {
+        throw std::runtime_error(
+            "Output " + std::to_string(i) + " is not contiguous");
+      }
+#ifdef USE_ATEN_LIB
+      const auto output_type = output_tensor.scalar_type();
+#else
+      const auto output_type =
+          torch_to_executorch_scalar_type(output_tensor.options().dtype());
+#endif
+      if (output_type != output_tensor_meta->scalar_type()) {
+        throw std::runtime_error(
+            "Output " + std::to_string(i) + " has the wrong dtype");
+      }
+      output_tensors[i] = std::move(output_tensor);
+    }
+    return output_tensors;
+  }
+
+  std::vector<std::vector<uint8_t>> make_output_storages(
+      const Method& method,
+      const std::vector<std::optional<at::Tensor>>& output_tensors = {}) {
+    const auto num_outputs = method.outputs_size();
+    // Create a buffer for each output tensor. Memory planned outputs, non
+    // tensor outputs and outputs that the caller passed a tensor for get an
+    // empty buffer in this list which is ignored later.
     std::vector<std::vector<uint8_t>> output_storages;
-    output_storages_.reserve(num_outputs);
+    output_storages.reserve(num_outputs);
     auto meta = method.method_meta();
     for (size_t i = 0; i < num_outputs; ++i) {
+      if (i < output_tensors.size() && output_tensors[i].has_value()) {
+        output_storages.emplace_back();
+        continue;
+      }
       auto output_type = meta.output_tag(i);
       THROW_IF_ERROR(
           output_type.error(), "Failed to get output type for output %zu", i);
@@ -1103,12 +1507,25 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           py::arg("method_name"),
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "forward",
           &PyModule::forward,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
+          call_guard)
+      .def(
+          "run_method_async",
+          &PyModule::run_method_async,
+          py::arg("method_name"),
+          py::arg("inputs") = py::list(),
+          call_guard)
+      .def(
+          "set_num_async_workers",
+          &PyModule::set_num_async_workers,
+          py::arg("num_workers"),
           call_guard)
       .def("has_etdump", &PyModule::has_etdump, call_guard)
       .def(
@@ -1122,6 +1539,7 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           &PyModule::forward,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "__call__",
@@ -7,6 +7,7 @@
 # pyre-strict
 from __future__ import annotations
 
+from concurrent.futures import Future
 from typing import Any, Dict, Enum, List, Optional, Sequence, Tuple
 
 from executorch.exir._warnings import experimental
@@ -33,21 +34,62 @@ class ExecuTorchModule:
     """
 
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
-    def __call__(self, inputs: Any, clone_outputs: bool = True) -> List[Any]: ...
+    def __call__(
+        self,
+        inputs: Any,
+        clone_outputs: bool = True,
+        outputs: Optional[Sequence[Any]] = None,
+    ) -> List[Any]: ...
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
     def run_method(
         self,
         method_name: str,
         inputs: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
         clone_outputs: bool = True,
-    ) -> List[Any]: ...
+        outputs: Optional[Sequence[Any]] = None,
+    ) -> List[Any]:
+        """Runs the method on the inputs and returns its outputs.
+
+        Tensor inputs may be torch.Tensors or any contiguous object that
+        supports DLPack, like a numpy array. The method reads them in place.
+
+        By default the outputs are cloned. With ``clone_outputs=False``, they
+        alias the memory of the module and are overwritten by its next run.
+
+        ``outputs`` may hold a preallocated tensor for each output that isn't
+        memory planned, or None. The method writes into these tensors, which
+        are returned, resized to the shape of the output.
+
+        The GIL is released while the method executes, so modules can run on
+        several threads at once. Runs of the same module are serialized.
+        """
+        ...
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
     def forward(
         self,
         inputs: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
         clone_outputs: bool = True,
+        outputs: Optional[Sequence[Any]] = None,
     ) -> List[Any]: ...
     # pyre-ignore[3]: "Any" in return type annotations.
+    def run_method_async(
+        self,
+        method_name: str,
+        inputs: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
+    ) -> Future[List[Any]]:
+        """Queues a run of the method on the inputs and returns a future for its
+        outputs, which are always cloned.
+
+        Requests run on worker threads owned by the module, each with its own
+        clone of the method, without holding the GIL. Use
+        ``asyncio.wrap_future()`` to await the result from asyncio code.
+        """
+        ...
+    def set_num_async_workers(self, num_workers: int) -> None:
+        """Sets the number of worker threads used by ``run_method_async()``.
+        Defaults to 2, and must be set before its first call."""
+        ...
+    # pyre-ignore[3]: "Any" in return type annotations.
     def plan_execute(self) -> List[Any]: ...
     # Bundled program methods.
     def load_bundled_input(
@@ -380,6 +380,87 @@ def make_test(  # noqa: C901
 
                 tester.assertEqual(str(expected), str(executorch_output))
 
+        def test_numpy_input(tester) -> None:
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+
+            # numpy arrays are passed through DLPack without a copy.
+            numpy_inputs = [t.numpy() for t in inputs]
+            executorch_output = executorch_module.forward(numpy_inputs)[0]
+
+            expected = inputs[0] + inputs[1]
+            tester.assertTrue(torch.allclose(expected, executorch_output))
+
+        def test_preallocated_outputs(tester) -> None:
+            exported_program, inputs = create_program(
+                ModuleAdd(),
+                et_config=ExecutorchBackendConfig(
+                    memory_planning_pass=MemoryPlanningPass(alloc_graph_output=False)
+                ),
+            )
+            executorch_module = load_fn(exported_program.buffer)
+
+            # The method writes into the tensor that is passed, which is returned.
+            output = torch.zeros(2, 2)
+            executorch_output = executorch_module.forward(inputs, outputs=[output])[0]
+            tester.assertIs(executorch_output, output)
+            tester.assertTrue(torch.allclose(output, inputs[0] + inputs[1]))
+
+            # None falls back to a buffer owned by the module.
+            executorch_output = executorch_module.forward(inputs, outputs=[None])[0]
+            tester.assertTrue(torch.allclose(executorch_output, inputs[0] + inputs[1]))
+
+            with tester.assertRaises(RuntimeError):
+                executorch_module.forward(inputs, outputs=[torch.zeros(2, 2).int()])
+            with tester.assertRaises(RuntimeError):
+                executorch_module.forward(inputs, outputs=[])
+
+            # Planned outputs can't be redirected.
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+            with tester.assertRaises(RuntimeError):
+                executorch_module.forward(inputs, outputs=[torch.zeros(2, 2)])
+
+        def test_run_on_threads(tester) -> None:
+            from concurrent.futures import ThreadPoolExecutor
+
+            exported_program, inputs = create_program(ModuleMulti())
+            executorch_modules = [load_fn(exported_program.buffer) for _ in range(2)]
+
+            # Modules run concurrently, and runs of one module are serialized.
+            def run(i):
+                executorch_module = executorch_modules[i % 2]
+                return [executorch_module.forward(inputs)[0] for _ in range(10)]
+
+            with ThreadPoolExecutor(max_workers=4) as executor:
+                results = list(executor.map(run, range(4)))
+            for outputs in results:
+                for output in outputs:
+                    tester.assertTrue(torch.allclose(output, torch.ones(2, 2) * 2))
+
+        def test_run_method_async(tester) -> None:
+            program, inputs = create_program(ModuleMulti())
+            executorch_module = load_fn(program.buffer)
+            executorch_module.set_num_async_workers(3)
+
+            # Several requests per module are queued at once.
+            futures = [
+                executorch_module.run_method_async(method_name, inputs)
+                for method_name in ["forward", "forward2"] * 4
+            ]
+            for i, future in enumerate(futures):
+                expected = torch.ones(2, 2) * (2 if i % 2 == 0 else 3)
+                tester.assertTrue(torch.allclose(future.result()[0], expected))
+
+            # Errors surface through the future, except for a bad name.
+            future = executorch_module.run_method_async("forward", inputs[:1])
+            with tester.assertRaises(RuntimeError):
+                future.result()
+            with tester.assertRaises(RuntimeError):
+                executorch_module.run_method_async("not_a_real_method", inputs)
+            with tester.assertRaises(RuntimeError):
+                executorch_module.set_num_async_workers(1)
+
         ######### RUN TEST CASES #########
         test_e2e(tester)
         test_multiple_entry(tester)
@@ -392,5 +473,9 @@ def make_test(  # noqa: C901
         test_method_meta(tester)
         test_bad_name(tester)
         test_verification_config(tester)
+        test_numpy_input(tester)
+        test_preallocated_outputs(tester)
+        test_run_on_threads(tester)
+        test_run_method_async(tester)
 
     return wrapper
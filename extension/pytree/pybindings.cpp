@@ -47,8 +47,21 @@ class PyTypeRegistry {
     return it == registry->regs_.end() ? nullptr : it->second.get();
   }
 
+  // Avoids formatting py::str(pytype) for the exact builtin containers and for
+  // types that are neither those nor registered, which covers every tensor.
   static const PyTypeReg* get_by_type(py::handle pytype) {
-    return get_by_str(py::str(pytype));
+    auto* registry = instance();
+    if (pytype.ptr() == reinterpret_cast<PyObject*>(&PyTuple_Type)) {
+      return registry->tuple_;
+    }
+    if (pytype.ptr() == reinterpret_cast<PyObject*>(&PyList_Type)) {
+      return registry->list_;
+    }
+    if (pytype.ptr() == reinterpret_cast<PyObject*>(&PyDict_Type)) {
+      return registry->dict_;
+    }
+    auto it = registry->custom_regs_.find(pytype.ptr());
+    return it == registry->custom_regs_.end() ? nullptr : it->second;
   }
 
   static void register_custom_type(
@@ -61,10 +74,13 @@ class PyTypeRegistry {
     reg->flatten = std::move(flatten);
     reg->unflatten = std::move(unflatten);
     std::string pytype_str = py::str(type);
+    // reg->type keeps the type object alive for the key.
+    PyObject* type_ptr = reg->type.ptr();
     auto it = registry->regs_.emplace(pytype_str, std::move(reg));
     if (!it.second) {
       assert(false);
     }
+    registry->custom_regs_.emplace(type_ptr, it.first->second.get());
   }
 
  private:
@@ -79,6 +95,9 @@ class PyTypeRegistry {
       add_pytype_reg("<class 'tuple'>", Kind::Tuple);
       add_pytype_reg("<class 'list'>", Kind::List);
       add_pytype_reg("<class 'dict'>", Kind::Dict);
+      registry->tuple_ = registry->regs_["<class 'tuple'>"].get();
+      registry->list_ = registry->regs_["<class 'list'>"].get();
+      registry->dict_ = registry->regs_["<class 'dict'>"].get();
 
       return registry;
     }();
@@ -86,10 +105,76 @@ class PyTypeRegistry {
     return registry_instance;
   }
   std::unordered_map<std::string, std::unique_ptr<PyTypeReg>> regs_;
+  // The registrations of custom types, keyed by their type object.
+  std::unordered_map<PyObject*, const PyTypeReg*> custom_regs_;
+  const PyTypeReg* tuple_ = nullptr;
+  const PyTypeReg* list_ = nullptr;
+  const PyTypeReg* dict_ = nullptr;
 };
 
+// Beyond this many, the caches of parsed and flat specs start over.
+constexpr size_t kMaxCachedSpecs = 1024;
+
 class PyTree {
-  PyTreeSpec spec_;
+  // Shared by the trees of the same spec string, or of the same flat tuple or
+  // list. Specs are never modified once built, except for their leaves_num.
+  std::shared_ptr<const PyTreeSpec> spec_;
+
+  static bool is_leaf(py::handle x) {
+    if (PyTypeRegistry::get_by_type(x.get_type()) != nullptr) {
+      return false;
+    }
+    return !(PyTuple_Check(x.ptr()) && py::hasattr(x, "_fields"));
+  }
+
+  // Returns the shared spec of a tuple or list of n leaves.
+  static std::shared_ptr<const PyTreeSpec> flat_spec(Kind kind, size_t n) {
+    static auto* cache =
+        new std::unordered_map<size_t, std::shared_ptr<const PyTreeSpec>>;
+    const size_t key = 2 * n + (kind == Kind::List ? 1 : 0);
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      return it->second;
+    }
+    if (cache->size() >= kMaxCachedSpecs) {
+      cache->clear();
+    }
+    auto spec = std::make_shared<PyTreeSpec>(kind, n);
+    for (size_t i = 0; i < n; ++i) {
+      (*spec)[i] = PyTreeSpec(Kind::Leaf);
+    }
+    refresh_leaves_num(*spec);
+    cache->emplace(key, spec);
+    return spec;
+  }
+
+  // Fast path of tree_flatten() for a tuple or list of leaves, like the
+  // tensors passed to a method: the leaves are the items, and the spec is
+  // shared. Returns nullptr, leaving `leaves` empty, for any other tree.
+  static std::shared_ptr<const PyTreeSpec> flatten_flat_sequence(
+      py::handle x,
+      std::vector<py::object>& leaves) {
+    Kind kind;
+    if (PyTuple_CheckExact(x.ptr())) {
+      kind = Kind::Tuple;
+    } else if (PyList_CheckExact(x.ptr())) {
+      kind = Kind::List;
+    } else {
+      return nullptr;
+    }
+    PyObject** items = PySequence_Fast_ITEMS(x.ptr());
+    const size_t n = PySequence_Fast_GET_SIZE(x.ptr());
+    for (size_t i = 0; i < n; ++i) {
+      if (!is_leaf(items[i])) {
+        return nullptr;
+      }
+    }
+    leaves.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      leaves.push_back(py::reinterpret_borrow<py::object>(items[i]));
+    }
+    return flat_spec(kind, n);
+  }
 
   static void flatten_internal(
       py::handle x,
@@ -186,15 +271,21 @@ class PyTree {
     }
   }
 
-  template <typename T>
-  py::object unflatten_internal(const PyTreeSpec& spec, T&& leaves_it) const {
+  // Builds the tree of `spec` from leaves[next], leaves[next + 1], ...
+  static py::object unflatten_internal(
+      const PyTreeSpec& spec,
+      PyObject* const* leaves,
+      size_t& next) {
     switch (spec.kind()) {
       case Kind::NamedTuple:
       case Kind::Tuple: {
         const size_t size = spec.size();
         py::tuple tuple(size);
         for (size_t i = 0; i < size; ++i) {
-          tuple[i] = unflatten_internal(spec[i], leaves_it);
+          PyTuple_SET_ITEM(
+              tuple.ptr(),
+              i,
+              unflatten_internal(spec[i], leaves, next).release().ptr());
         }
         return std::move(tuple);
       }
@@ -202,7 +293,10 @@ class PyTree {
         const size_t size = spec.size();
         py::list list(size);
         for (size_t i = 0; i < size; ++i) {
-          list[i] = unflatten_internal(spec[i], leaves_it);
+          PyList_SET_ITEM(
+              list.ptr(),
+              i,
+              unflatten_internal(spec[i], leaves, next).release().ptr());
         }
         return std::move(list);
       }
@@ -212,7 +306,7 @@ class PyTree {
         const size_t size = spec.size();
         py::list list(size);
         for (size_t i = 0; i < size; ++i) {
-          list[i] = unflatten_internal(spec[i], leaves_it);
+          list[i] = unflatten_internal(spec[i], leaves, next);
         }
         py::object o = reg->unflatten(list, spec.handle->custom_type_context);
         return o;
@@ -235,15 +329,12 @@ class PyTree {
                     " in pytree dict; must be int or string");
             }
           }();
-          dict[py_key] = unflatten_internal(spec[i], leaves_it);
+          dict[py_key] = unflatten_internal(spec[i], leaves, next);
         }
         return std::move(dict);
       }
       case Kind::Leaf: {
-        py::object o =
-            py::reinterpret_borrow<py::object>(*std::forward<T>(leaves_it));
-        leaves_it++;
-        return o;
+        return py::reinterpret_borrow<py::object>(leaves[next++]);
       }
       case Kind::None: {
         return py::none();
@@ -255,26 +346,48 @@ class PyTree {
   }
 
  public:
-  explicit PyTree(PyTreeSpec spec) : spec_(std::move(spec)) {}
+  explicit PyTree(std::shared_ptr<const PyTreeSpec> spec)
+      : spec_(std::move(spec)) {}
 
   const PyTreeSpec& spec() const {
-    return spec_;
+    return *spec_;
+  }
+
+  // Parsing a spec string again, e.g. the one of the outputs of a method on
+  // every call, returns the spec parsed the first time.
+  static std::shared_ptr<const PyTreeSpec> parse(const std::string& spec) {
+    static auto* cache =
+        new std::unordered_map<std::string, std::shared_ptr<const PyTreeSpec>>;
+    auto it = cache->find(spec);
+    if (it != cache->end()) {
+      return it->second;
+    }
+    if (cache->size() >= kMaxCachedSpecs) {
+      cache->clear();
+    }
+    auto parsed = std::make_shared<PyTreeSpec>(from_str<PyAux>(spec));
+    refresh_leaves_num(*parsed);
+    cache->emplace(spec, parsed);
+    return parsed;
   }
 
   static PyTree py_from_str(std::string spec) {
-    return PyTree(from_str<PyAux>(spec));
+    return PyTree(parse(spec));
   }
 
   StrTreeSpec py_to_str() const {
-    return to_str(spec_);
+    return to_str(*spec_);
   }
 
   static std::pair<std::vector<py::object>, std::unique_ptr<PyTree>>
   tree_flatten(py::handle x) {
     std::vector<py::object> leaves{};
-    PyTreeSpec spec{};
-    flatten_internal(x, leaves, spec);
-    refresh_leaves_num(spec);
+    if (auto spec = flatten_flat_sequence(x, leaves)) {
+      return {std::move(leaves), std::make_unique<PyTree>(std::move(spec))};
+    }
+    auto spec = std::make_shared<PyTreeSpec>();
+    flatten_internal(x, leaves, *spec);
+    refresh_leaves_num(*spec);
     return {std::move(leaves), std::make_unique<PyTree>(std::move(spec))};
   }
 
@@ -282,17 +395,31 @@ class PyTree {
     return o.cast<PyTree*>()->tree_unflatten(leaves);
   }
 
-  template <typename T>
-  py::object tree_unflatten(T leaves) const {
-    return unflatten_internal(spec_, leaves.begin());
+  // Lists and tuples of leaves are read in place, other iterables are
+  // gathered into a list first.
+  py::object tree_unflatten(py::iterable leaves) const {
+    auto sequence = py::reinterpret_steal<py::object>(
+        PySequence_Fast(leaves.ptr(), "leaves must be iterable"));
+    if (!sequence) {
+      throw py::error_already_set();
+    }
+    const size_t num_leaves = PySequence_Fast_GET_SIZE(sequence.ptr());
+    if (num_leaves < spec_->leaves_num()) {
+      throw std::runtime_error(
+          "tree_unflatten got " + std::to_string(num_leaves) +
+          " leaves, expected " + std::to_string(spec_->leaves_num()));
+    }
+    size_t next = 0;
+    return unflatten_internal(
+        *spec_, PySequence_Fast_ITEMS(sequence.ptr()), next);
   }
 
   bool operator==(const PyTree& rhs) {
-    return spec_ == rhs.spec_;
+    return *spec_ == *rhs.spec_;
   }
 
   size_t leaves_num() const {
-    return refresh_leaves_num(spec_);
+    return spec_->leaves_num();
   }
 };
 
@@ -309,15 +436,15 @@ static py::object tree_map(py::function& fn, py::handle x) {
   auto p = tree_flatten(x);
   const auto& leaves = p.first;
   const auto& pytree = p.second;
-  std::vector<py::handle> vec;
-  for (const py::handle& h : leaves) {
-    vec.push_back(fn(h));
+  py::list mapped(leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i) {
+    mapped[i] = fn(leaves[i]);
   }
-  return pytree->tree_unflatten(vec);
+  return pytree->tree_unflatten(mapped);
 }
 
 static std::unique_ptr<PyTree> py_from_str(std::string spec) {
-  return std::make_unique<PyTree>(from_str<PyAux>(spec));
+  return std::make_unique<PyTree>(PyTree::parse(spec));
 }
 
 static py::object broadcast_to_and_flatten(
@@ -241,7 +241,7 @@ struct ContainerHandle {
   }
 
   // Checks only structure, no leaves comparison
-  bool operator==(const ContainerHandle& rhs) {
+  bool operator==(const ContainerHandle& rhs) const {
     const Kind knd = kind();
     if (knd != rhs.kind()) {
       return false;
@@ -265,7 +265,7 @@ struct ContainerHandle {
     return true;
   }
 
-  bool operator!=(const ContainerHandle& rhs) {
+  bool operator!=(const ContainerHandle& rhs) const {
     return !operator==(rhs);
   }
 };
@@ -121,6 +121,39 @@ class TestPytree(unittest.TestCase):
         self.assertTrue(_spec((1)) != _spec([1]))
         self.assertTrue(_spec((1)) == _spec((2)))
 
+    def test_treespec_from_str_is_cached(self):
+        spec = "T2#1#2($,L2#1#1($,$))"
+        first = TreeSpec.from_str(spec)
+        second = TreeSpec.from_str(spec)
+        self.assertEqual(first, second)
+        self.assertEqual(second.to_str(), spec)
+        self.assertEqual(second.num_leaves(), 3)
+        self.assertEqual(second.tree_unflatten([1, 2, 3]), (1, [2, 3]))
+
+    def test_flatten_flat_sequence_of_tensors(self):
+        tensors = (torch.ones(2), torch.zeros(3), torch.randn(4))
+        values, treespec = tree_flatten(tensors)
+        for value, tensor in zip(values, tensors):
+            self.assertIs(value, tensor)
+        self.assertEqual(treespec, TreeSpec.from_str(_spec_str("T", 3)))
+        self.assertEqual(treespec.num_leaves(), 3)
+
+        # Flat sequences share their spec, which must not leak between kinds.
+        _, list_spec = tree_flatten(list(tensors))
+        self.assertEqual(list_spec.to_str(), _spec_str("L", 3))
+        self.assertTrue(list_spec != treespec)
+
+        # A tuple holding a container is not flat.
+        _, nested_spec = tree_flatten((torch.ones(2), [torch.ones(2)]))
+        self.assertEqual(nested_spec.to_str(), "T2#1#1($,L1#1($))")
+
+    def test_unflatten_reads_any_iterable(self):
+        _, treespec = tree_flatten((1, [2, 3]))
+        self.assertEqual(tree_unflatten(iter([4, 5, 6]), treespec), (4, [5, 6]))
+        self.assertEqual(tree_unflatten((4, 5, 6), treespec), (4, [5, 6]))
+        with self.assertRaises(RuntimeError):
+            tree_unflatten([4, 5], treespec)
+
     def test_flatten_unflatten_leaf(self):
         def run_test_with_leaf(leaf):
             values, treespec = tree_flatten(leaf)
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/device_monitor.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+#if defined(__linux__) || defined(__ANDROID__)
+constexpr const char* kThermalRoot = "/sys/class/thermal";
+constexpr const char* kHwmonRoot = "/sys/class/hwmon";
+constexpr const char* kCpuRoot = "/sys/devices/system/cpu";
+constexpr const char* kKgslGpuClock = "/sys/class/kgsl/kgsl-3d0/gpuclk";
+constexpr const char* kDevfreqRoot = "/sys/class/devfreq";
+constexpr const char* kPowercapRoot = "/sys/class/powercap";
+constexpr const char* kPowerSupplyRoot = "/sys/class/power_supply";
+
+// Reads the first number of the file, like sysfs attributes hold.
+std::optional<double> read_number(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == nullptr) {
+    return std::nullopt;
+  }
+  double value = 0;
+  const bool ok = fscanf(file, "%lf", &value) == 1;
+  fclose(file);
+  return ok ? std::optional<double>(value) : std::nullopt;
+}
+
+std::string read_line(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == nullptr) {
+    return "";
+  }
+  char buffer[64] = {};
+  const bool ok = fgets(buffer, sizeof(buffer), file) != nullptr;
+  fclose(file);
+  std::string line = ok ? buffer : "";
+  while (!line.empty() && (line.back() == '\n' || line.back() == ' ')) {
+    line.pop_back();
+  }
+  return line;
+}
+
+// The names of the entries of the directory that start with prefix, sorted.
+std::vector<std::string> list_dir(const char* dir, const std::string& prefix) {
+  std::vector<std::string> names;
+  DIR* d = opendir(dir);
+  if (d == nullptr) {
+    return names;
+  }
+  while (const dirent* entry = readdir(d)) {
+    const std::string name = entry->d_name;
+    if (name.compare(0, prefix.size(), prefix) == 0 && name != "." &&
+        name != "..") {
+      names.push_back(name);
+    }
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+bool contains(const std::string& haystack, const char* needle) {
+  return haystack.find(needle) != std::string::npos;
+}
+#endif
+
+} // namespace
+
+DeviceMonitor::DeviceMonitor() : start_(std::chrono::steady_clock::now()) {
+#if defined(__linux__) || defined(__ANDROID__)
+  for (const std::string& zone : list_dir(kThermalRoot, "thermal_zone")) {
+    const std::string path = std::string(kThermalRoot) + "/" + zone + "/temp";
+    if (read_number(path)) {
+      temperature_paths_.push_back(path);
+    }
+  }
+  for (const std::string& hwmon : list_dir(kHwmonRoot, "hwmon")) {
+    const std::string dir = std::string(kHwmonRoot) + "/" + hwmon;
+    for (const std::string& name : list_dir(dir.c_str(), "temp")) {
+      const std::string suffix = "_input";
+      if (name.size() > suffix.size() &&
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) ==
+              0 &&
+          read_number(dir + "/" + name)) {
+        temperature_paths_.push_back(dir + "/" + name);
+      }
+    }
+  }
+
+  const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+  for (long cpu = 0; cpu < num_cpus; ++cpu) {
+    const std::string path = std::string(kCpuRoot) + "/cpu" +
+        std::to_string(cpu) + "/cpufreq/scaling_cur_freq";
+    if (read_number(path)) {
+      cpu_freq_paths_.push_back(path);
+    }
+  }
+
+  if (read_number(kKgslGpuClock)) {
+    gpu_freq_path_ = kKgslGpuClock;
+  } else {
+    // Mali and other GPUs are devfreq devices named after the GPU.
+    for (const std::string& device : list_dir(kDevfreqRoot, "")) {
+      if (contains(device, "gpu") || contains(device, "mali") ||
+          contains(device, "kgsl")) {
+        const std::string path =
+            std::string(kDevfreqRoot) + "/" + device + "/cur_freq";
+        if (read_number(path)) {
+          gpu_freq_path_ = path;
+          break;
+        }
+      }
+    }
+  }
+
+  // The top-level zones, one per CPU package, whose subzones they include.
+  for (const std::string& zone : list_dir(kPowercapRoot, "intel-rapl:")) {
+    if (std::count(zone.begin(), zone.end(), ':') != 1) {
+      continue;
+    }
+    const std::string dir = std::string(kPowercapRoot) + "/" + zone;
+    const auto energy_uj = read_number(dir + "/energy_uj");
+    const auto max_range_uj = read_number(dir + "/max_energy_range_uj");
+    if (energy_uj && max_range_uj) {
+      energy_counters_.push_back(
+          {dir + "/energy_uj", *max_range_uj, *energy_uj, 0});
+    }
+  }
+
+  for (const std::string& supply : list_dir(kPowerSupplyRoot, "")) {
+    const std::string dir = std::string(kPowerSupplyRoot) + "/" + supply;
+    if (read_line(dir + "/type") == "Battery" &&
+        read_number(dir + "/current_now")) {
+      battery_current_path_ = dir + "/current_now";
+      break;
+    }
+  }
+#endif
+}
+
+DeviceSample DeviceMonitor::sample() {
+  DeviceSample sample;
+  sample.timestamp_ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start_)
+                            .count();
+#if defined(__linux__) || defined(__ANDROID__)
+  for (const std::string& path : temperature_paths_) {
+    // In millidegrees Celsius.
+    if (const auto temperature = read_number(path)) {
+      const double celsius = *temperature / 1000;
+      sample.max_temperature_c = std::max(
+          sample.max_temperature_c.value_or(celsius), celsius);
+    }
+  }
+  for (const std::string& path : cpu_freq_paths_) {
+    // In kHz.
+    if (const auto freq = read_number(path)) {
+      sample.cpu_freq_mhz.push_back(*freq / 1000);
+    }
+  }
+  if (!gpu_freq_path_.empty()) {
+    if (const auto freq = read_number(gpu_freq_path_)) {
+      sample.gpu_freq_mhz = *freq / 1e6;
+    }
+  }
+  if (!energy_counters_.empty()) {
+    double total_uj = 0;
+    for (EnergyCounter& counter : energy_counters_) {
+      if (const auto energy_uj = read_number(counter.path)) {
+        double delta_uj = *energy_uj - counter.last_uj;
+        if (delta_uj < 0) {
+          delta_uj += counter.max_range_uj;
+        }
+        counter.total_uj += delta_uj;
+        counter.last_uj = *energy_uj;
+      }
+      total_uj += counter.total_uj;
+    }
+    sample.energy_j = total_uj / 1e6;
+  }
+  if (!battery_current_path_.empty()) {
+    // In uA.
+    if (const auto current = read_number(battery_current_path_)) {
+      sample.battery_current_ma = *current / 1000;
+    }
+  }
+#endif
+  return sample;
+}
+
+DeviceSampleSummary summarize_device_samples(
+    const std::vector<DeviceSample>& samples) {
+  DeviceSampleSummary summary;
+  double cpu_freq_sum = 0;
+  size_t num_cpu_freqs = 0;
+  double current_sum = 0;
+  size_t num_currents = 0;
+  const auto update_max = [](std::optional<double>& max, double value) {
+    max = std::max(max.value_or(value), value);
+  };
+  const auto update_min = [](std::optional<double>& min, double value) {
+    min = std::min(min.value_or(value), value);
+  };
+  for (const DeviceSample& sample : samples) {
+    if (sample.max_temperature_c) {
+      update_max(summary.max_temperature_c, *sample.max_temperature_c);
+    }
+    if (!sample.cpu_freq_mhz.empty()) {
+      double sum = 0;
+      for (double freq : sample.cpu_freq_mhz) {
+        sum += freq;
+      }
+      const double mean = sum / sample.cpu_freq_mhz.size();
+      update_min(summary.min_cpu_freq_mhz, mean);
+      cpu_freq_sum += mean;
+      ++num_cpu_freqs;
+    }
+    if (sample.gpu_freq_mhz) {
+      update_min(summary.min_gpu_freq_mhz, *sample.gpu_freq_mhz);
+    }
+    if (sample.battery_current_ma) {
+      current_sum += *sample.battery_current_ma;
+      ++num_currents;
+    }
+  }
+  if (num_cpu_freqs > 0) {
+    summary.avg_cpu_freq_mhz = cpu_freq_sum / num_cpu_freqs;
+  }
+  if (num_currents > 0) {
+    summary.avg_battery_current_ma = current_sum / num_currents;
+  }
+  if (samples.size() >= 2 && samples.front().energy_j &&
+      samples.back().energy_j) {
+    summary.energy_j = *samples.back().energy_j - *samples.front().energy_j;
+    const double seconds =
+        (samples.back().timestamp_ms - samples.front().timestamp_ms) / 1000;
+    if (seconds > 0) {
+      summary.avg_power_w = *summary.energy_j / seconds;
+    }
+  }
+  return summary;
+}
+
+double sustained_latency_ratio(const std::vector<double>& latencies) {
+  const size_t n = std::max<size_t>(latencies.size() / 10, 1);
+  if (latencies.size() < 2 * n) {
+    return 1;
+  }
+  double first = 0;
+  double last = 0;
+  for (size_t i = 0; i < n; ++i) {
+    first += latencies[i];
+    last += latencies[latencies.size() - n + i];
+  }
+  return first > 0 ? last / first : 1;
+}
+
+} // namespace extension
+} // namespace executorch
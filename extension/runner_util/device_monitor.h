@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Samples the thermal and power state of a Linux or Android device from sysfs
+// while the runners benchmark a model.
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+
+/// The state of the device at one point of a benchmark.
+struct DeviceSample {
+  // Milliseconds since the DeviceMonitor was created.
+  double timestamp_ms = 0;
+  // The highest temperature of the thermal zones and hwmon sensors, in
+  // degrees Celsius.
+  std::optional<double> max_temperature_c;
+  // The current frequency of each online CPU, in MHz.
+  std::vector<double> cpu_freq_mhz;
+  std::optional<double> gpu_freq_mhz;
+  // The energy the CPU packages used since the DeviceMonitor was created, in
+  // joules, from powercap (RAPL).
+  std::optional<double> energy_j;
+  // The current drawn from the battery, in mA. Its sign convention depends on
+  // the device.
+  std::optional<double> battery_current_ma;
+};
+
+/// The extremes and averages of a series of DeviceSamples.
+struct DeviceSampleSummary {
+  std::optional<double> max_temperature_c;
+  // The lowest and the average of the mean CPU frequency of each sample.
+  std::optional<double> min_cpu_freq_mhz;
+  std::optional<double> avg_cpu_freq_mhz;
+  std::optional<double> min_gpu_freq_mhz;
+  // The energy used between the first and the last sample, and the average
+  // power over that time.
+  std::optional<double> energy_j;
+  std::optional<double> avg_power_w;
+  std::optional<double> avg_battery_current_ma;
+};
+
+/**
+ * Reads the thermal, frequency and power counters that Linux and Android
+ * expose in sysfs:
+ * - /sys/class/thermal/thermal_zone* and /sys/class/hwmon/hwmon* for the
+ *   temperatures;
+ * - /sys/devices/system/cpu/cpuN/cpufreq for the CPU frequencies;
+ * - /sys/class/kgsl (Adreno) and the GPU devfreq devices for the GPU
+ *   frequency;
+ * - /sys/class/powercap/intel-rapl:* for the energy;
+ * - /sys/class/power_supply for the battery current.
+ *
+ * The files are looked up once, when the monitor is created, and the ones
+ * that are missing or not readable, e.g. because of SELinux on Android, are
+ * left out of the samples. On other platforms the samples only have their
+ * timestamp.
+ */
+class DeviceMonitor {
+ public:
+  DeviceMonitor();
+
+  /**
+   * Reads the current state of the device. The energy counters wrap around,
+   * after minutes at high power, so sample at least every few seconds, e.g.
+   * after each iteration.
+   */
+  DeviceSample sample();
+
+ private:
+  struct EnergyCounter {
+    std::string path;
+    double max_range_uj;
+    double last_uj;
+    // The energy since the monitor was created, across wraparounds.
+    double total_uj;
+  };
+
+  std::chrono::steady_clock::time_point start_;
+  std::vector<std::string> temperature_paths_;
+  std::vector<std::string> cpu_freq_paths_;
+  // In Hz, like all the GPU frequency files.
+  std::string gpu_freq_path_;
+  std::vector<EnergyCounter> energy_counters_;
+  std::string battery_current_path_;
+};
+
+/// Summarizes samples, e.g. the ones taken after each benchmark iteration.
+DeviceSampleSummary summarize_device_samples(
+    const std::vector<DeviceSample>& samples);
+
+/**
+ * The ratio of the average of the last tenth of the latencies to the average
+ * of their first tenth, in the order the iterations ran. Above 1 when the
+ * device slowed down during the benchmark, e.g. because it throttled.
+ */
+double sustained_latency_ratio(const std::vector<double>& latencies);
+
+} // namespace extension
+} // namespace executorch
@@ -100,5 +100,84 @@ Result<BufferCleanup> prepare_input_tensors(
   return BufferCleanup({inputs, num_allocated});
 }
 
+namespace {
+size_t align_up(size_t size) {
+  return (size + InputWorkspace::kAlignment - 1) &
+      ~(InputWorkspace::kAlignment - 1);
+}
+} // namespace
+
+Error InputWorkspace::prepare(
+    Method& method,
+    PrepareInputTensorsOptions options) {
+  MethodMeta method_meta = method.method_meta();
+  size_t num_inputs = method_meta.num_inputs();
+  ET_CHECK_OR_RETURN_ERROR(
+      num_inputs <= options.max_inputs,
+      InvalidProgram,
+      "Too many inputs: %zu > %zu",
+      num_inputs,
+      options.max_inputs);
+
+  // Plan the buffers first, so that a malformed program fails before the
+  // workspace grows.
+  size_t total_size = 0;
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto tag = method_meta.input_tag(i);
+    if (!tag.ok()) {
+      return tag.error();
+    }
+    if (tag.get() != Tag::Tensor) {
+      continue;
+    }
+    Result<TensorInfo> tensor_meta = method_meta.input_tensor_meta(i);
+    if (!tensor_meta.ok()) {
+      return tensor_meta.error();
+    }
+    size_t tensor_size = tensor_meta->nbytes();
+    ET_CHECK_OR_RETURN_ERROR(
+        total_size + tensor_size <= options.max_total_allocation_size,
+        InvalidProgram,
+        "Allocating %zu bytes for input %zu would exceed "
+        "max_total_allocation_size %zu",
+        tensor_size,
+        i,
+        options.max_total_allocation_size);
+    total_size = align_up(total_size + tensor_size);
+  }
+
+  if (total_size > capacity_) {
+    void* allocation = malloc(total_size + kAlignment - 1);
+    ET_CHECK_OR_RETURN_ERROR(
+        allocation != nullptr,
+        MemoryAllocationFailed,
+        "malloc(%zu) failed",
+        total_size + kAlignment - 1);
+    free(allocation_);
+    allocation_ = allocation;
+    data_ = reinterpret_cast<uint8_t*>(
+        align_up(reinterpret_cast<uintptr_t>(allocation)));
+    capacity_ = total_size;
+  }
+
+  size_t offset = 0;
+  for (size_t i = 0; i < num_inputs; i++) {
+    if (method_meta.input_tag(i).get() != Tag::Tensor) {
+      ET_LOG(Debug, "Skipping non-tensor input %zu", i);
+      continue;
+    }
+    TensorInfo tensor_meta = method_meta.input_tensor_meta(i).get();
+    Error err =
+        internal::fill_and_set_input(method, tensor_meta, i, data_ + offset);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error, "Failed to prepare input %zu: 0x%" PRIx32, i, (uint32_t)err);
+      return err;
+    }
+    offset = align_up(offset + tensor_meta.nbytes());
+  }
+  return Error::Ok;
+}
+
 } // namespace extension
 } // namespace executorch
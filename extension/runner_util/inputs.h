@@ -83,6 +83,75 @@ executorch::runtime::Result<BufferCleanup> prepare_input_tensors(
     executorch::runtime::Method& method,
     PrepareInputTensorsOptions options = {});
 
+/**
+ * Owns the buffers of the tensor inputs of a Method across executions, so that
+ * preparing the inputs again does not allocate. Movable.
+ *
+ * The buffers are laid out back to back in a single allocation, each aligned
+ * to kAlignment bytes. The allocation only grows, when the inputs of a Method
+ * no longer fit, e.g. when the workspace is used for a Method with bigger
+ * inputs.
+ */
+class InputWorkspace final {
+ public:
+  /// The alignment of the buffer of every input.
+  static constexpr size_t kAlignment = 64;
+
+  InputWorkspace() = default;
+
+  /**
+   * Move ctor. Takes ownership of the allocation of `rhs`, leaving `rhs`
+   * empty.
+   */
+  InputWorkspace(InputWorkspace&& rhs) noexcept
+      : allocation_(rhs.allocation_),
+        data_(rhs.data_),
+        capacity_(rhs.capacity_) {
+    rhs.allocation_ = nullptr;
+    rhs.data_ = nullptr;
+    rhs.capacity_ = 0;
+  }
+
+  ~InputWorkspace() {
+    free(allocation_);
+  }
+
+  /**
+   * Sets the tensor inputs of the provided Method to buffers in the workspace,
+   * filling them with ones, like `prepare_input_tensors()`. Does not modify
+   * inputs that are not Tensors.
+   *
+   * Each input gets the size of its TensorInfo, which for dynamic shapes is
+   * the upper bound, so executing with smaller shapes needs no new buffers.
+   *
+   * @param[in] method The Method that owns the inputs to prepare.
+   * @param[in] options Extra options for preparing the inputs.
+   *
+   * @returns An error on failure. The workspace must remain alive, and must not
+   *     prepare the inputs of another Method, when calling `method.execute()`.
+   */
+  executorch::runtime::Error prepare(
+      executorch::runtime::Method& method,
+      PrepareInputTensorsOptions options = {});
+
+  /// The size in bytes that the inputs can take without growing the workspace.
+  size_t capacity() const {
+    return capacity_;
+  }
+
+ private:
+  // Delete other rule-of-five methods.
+  InputWorkspace(const InputWorkspace&) = delete;
+  InputWorkspace& operator=(const InputWorkspace&) = delete;
+  InputWorkspace& operator=(InputWorkspace&&) noexcept = delete;
+
+  // What malloc() returned, and the first address in it aligned to
+  // kAlignment.
+  void* allocation_ = nullptr;
+  uint8_t* data_ = nullptr;
+  size_t capacity_ = 0;
+};
+
 namespace internal {
 /**
  * INTERNAL-ONLY: Creates a Tensor using the provided shape and buffer,
@@ -104,6 +173,7 @@ namespace util {
 // TODO(T197294990): Remove these deprecated aliases once all users have moved
 // to the new `::executorch` namespaces.
 using ::executorch::extension::BufferCleanup;
+using ::executorch::extension::InputWorkspace;
 using ::executorch::extension::prepare_input_tensors;
 } // namespace util
 } // namespace executor
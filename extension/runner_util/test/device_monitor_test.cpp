@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/device_monitor.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::DeviceMonitor;
+using ::executorch::extension::DeviceSample;
+using ::executorch::extension::DeviceSampleSummary;
+using ::executorch::extension::summarize_device_samples;
+using ::executorch::extension::sustained_latency_ratio;
+
+TEST(DeviceMonitorTest, SamplesAreTimestamped) {
+  // The counters depend on the machine, but the timestamps don't.
+  DeviceMonitor monitor;
+  const DeviceSample first = monitor.sample();
+  const DeviceSample second = monitor.sample();
+  EXPECT_GE(first.timestamp_ms, 0);
+  EXPECT_GE(second.timestamp_ms, first.timestamp_ms);
+}
+
+TEST(DeviceMonitorTest, SummarizesSamples) {
+  std::vector<DeviceSample> samples(3);
+  samples[0].timestamp_ms = 0;
+  samples[0].max_temperature_c = 40;
+  samples[0].cpu_freq_mhz = {1500, 2500};
+  samples[0].energy_j = 1;
+  samples[1].timestamp_ms = 1000;
+  samples[1].max_temperature_c = 55;
+  samples[1].cpu_freq_mhz = {1000, 1000};
+  samples[1].gpu_freq_mhz = 300;
+  samples[2].timestamp_ms = 2000;
+  samples[2].max_temperature_c = 50;
+  samples[2].cpu_freq_mhz = {1500, 1500};
+  samples[2].gpu_freq_mhz = 200;
+  samples[2].energy_j = 9;
+
+  const DeviceSampleSummary summary = summarize_device_samples(samples);
+  EXPECT_EQ(summary.max_temperature_c, 55);
+  EXPECT_EQ(summary.min_cpu_freq_mhz, 1000);
+  EXPECT_EQ(summary.avg_cpu_freq_mhz, 1500);
+  EXPECT_EQ(summary.min_gpu_freq_mhz, 200);
+  EXPECT_EQ(summary.energy_j, 8);
+  EXPECT_EQ(summary.avg_power_w, 4);
+  EXPECT_FALSE(summary.avg_battery_current_ma.has_value());
+
+  EXPECT_FALSE(summarize_device_samples({}).max_temperature_c.has_value());
+}
+
+TEST(DeviceMonitorTest, SustainedLatencyRatio) {
+  std::vector<double> latencies(20, 10);
+  EXPECT_EQ(sustained_latency_ratio(latencies), 1);
+  // The last tenth of the iterations took twice as long.
+  latencies[18] = latencies[19] = 20;
+  EXPECT_EQ(sustained_latency_ratio(latencies), 2);
+  EXPECT_EQ(sustained_latency_ratio({5}), 1);
+}
@@ -22,6 +22,7 @@ using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
 using executorch::extension::BufferCleanup;
 using executorch::extension::FileDataLoader;
+using executorch::extension::InputWorkspace;
 using executorch::extension::prepare_input_tensors;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
@@ -130,6 +131,56 @@ TEST_F(InputsTest, ExceedingInputAllocationLimitFails) {
   ASSERT_NE(input_buffers.error(), Error::Ok);
 }
 
+TEST_F(InputsTest, WorkspaceReusesItsBuffers) {
+  InputWorkspace workspace;
+  EXPECT_EQ(workspace.capacity(), 0);
+
+  for (int run = 0; run < 3; run++) {
+    ASSERT_EQ(workspace.prepare(*method_), Error::Ok);
+    if (run == 0) {
+      EXPECT_GT(workspace.capacity(), 0);
+    }
+    ASSERT_EQ(method_->execute(), Error::Ok);
+
+    // ModuleAdd adds its two inputs together, so every run should see inputs
+    // filled with ones again.
+    Tensor output = method_->get_output(0).toTensor();
+    Span<float> elements(output.mutable_data_ptr<float>(), output.numel());
+    EXPECT_GT(elements.size(), 0);
+    for (float e : elements) {
+      EXPECT_EQ(e, 2.0);
+    }
+  }
+
+  // The two float inputs of ModuleAdd are laid out in a single allocation,
+  // which later runs do not grow.
+  const size_t input_size =
+      method_->method_meta().input_tensor_meta(0)->nbytes();
+  EXPECT_GE(workspace.capacity(), 2 * input_size);
+  EXPECT_LT(
+      workspace.capacity(), 2 * (input_size + InputWorkspace::kAlignment));
+
+  // Moving the workspace keeps the buffers the inputs point to alive.
+  InputWorkspace moved(std::move(workspace));
+  EXPECT_EQ(workspace.capacity(), 0);
+  ASSERT_EQ(method_->execute(), Error::Ok);
+}
+
+TEST_F(InputsTest, WorkspaceExceedingLimitsFails) {
+  InputWorkspace workspace;
+
+  executorch::extension::PrepareInputTensorsOptions options;
+  options.max_inputs = method_->method_meta().num_inputs() - 1;
+  EXPECT_NE(workspace.prepare(*method_, options), Error::Ok);
+
+  options = {};
+  options.max_total_allocation_size = 1;
+  EXPECT_NE(workspace.prepare(*method_, options), Error::Ok);
+
+  // Nothing was allocated for the failed attempts.
+  EXPECT_EQ(workspace.capacity(), 0);
+}
+
 TEST(BufferCleanupTest, Smoke) {
   // Returns the size of the buffer at index `i`.
   auto test_buffer_size = [](size_t i) {
@@ -7,6 +7,16 @@ def define_common_targets(is_fbcode = False):
     TARGETS and BUCK files that call this function.
     """
 
+    runtime.cxx_test(
+        name = "device_monitor_test",
+        srcs = [
+            "device_monitor_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/runner_util:device_monitor",
+        ],
+    )
+
     for aten_mode in get_aten_mode_options():
         aten_suffix = ("_aten" if aten_mode else "")
 
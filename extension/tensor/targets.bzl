@@ -13,12 +13,14 @@ def define_common_targets():
         runtime.cxx_library(
             name = "tensor" + aten_suffix,
             srcs = [
+                "tensor_pool.cpp",
                 "tensor_ptr.cpp",
                 "tensor_ptr_maker.cpp",
             ],
             exported_headers = [
                 "tensor.h",
                 "tensor_accessor.h",
+                "tensor_pool.h",
                 "tensor_ptr.h",
                 "tensor_ptr_maker.h",
             ],
@@ -9,5 +9,6 @@
 #pragma once
 
 // Umbrella header for the Tensor extension.
+#include <executorch/extension/tensor/tensor_pool.h>
 #include <executorch/extension/tensor/tensor_ptr.h>
 #include <executorch/extension/tensor/tensor_ptr_maker.h>
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/tensor/tensor_pool.h>
+
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <numeric>
+
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_dimension_limit.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
+namespace executorch {
+namespace extension {
+namespace internal {
+
+/**
+ * The free lists of a TensorPool. Shared by the pool and by its live tensors,
+ * which return their memory here when they are destroyed.
+ */
+class TensorPoolState final {
+ public:
+  /// The smallest size class of data buffers.
+  static constexpr size_t kMinDataCapacity = 64;
+  /// The alignment of data buffers.
+  static constexpr size_t kDataAlignment = 64;
+
+  explicit TensorPoolState(size_t max_cached_bytes)
+      : max_cached_bytes_(max_cached_bytes) {}
+
+  ~TensorPoolState() {
+    release_cached();
+  }
+
+  /// Allocates a block for a tensor and its metadata.
+  void* allocate_block(size_t size) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (size == block_size_ && !free_blocks_.empty()) {
+        void* block = free_blocks_.back();
+        free_blocks_.pop_back();
+        cached_bytes_ -= size;
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  void release_block(void* block, size_t size) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      // Tensors of a pool all have blocks of the same size.
+      if (block_size_ == 0) {
+        block_size_ = size;
+      }
+      if (size == block_size_ && cached_bytes_ + size <= max_cached_bytes_) {
+        free_blocks_.push_back(block);
+        cached_bytes_ += size;
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+
+  /// Allocates at least `nbytes` of data, and sets `*capacity` to the size of
+  /// the buffer.
+  void* allocate_data(size_t nbytes, size_t* capacity) {
+    const size_t size_class = size_class_of(nbytes);
+    *capacity = kMinDataCapacity << size_class;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      std::vector<void*>& free_data = free_data_[size_class];
+      if (!free_data.empty()) {
+        void* data = free_data.back();
+        free_data.pop_back();
+        cached_bytes_ -= *capacity;
+        return data;
+      }
+    }
+    return ::operator new(*capacity, std::align_val_t(kDataAlignment));
+  }
+
+  void release_data(void* data, size_t capacity) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (cached_bytes_ + capacity <= max_cached_bytes_) {
+        free_data_[size_class_of(capacity)].push_back(data);
+        cached_bytes_ += capacity;
+        return;
+      }
+    }
+    ::operator delete(data, std::align_val_t(kDataAlignment));
+  }
+
+  size_t cached_bytes() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return cached_bytes_;
+  }
+
+  void release_cached() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (void* block : free_blocks_) {
+      ::operator delete(block);
+    }
+    free_blocks_.clear();
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      for (void* data : free_data_[i]) {
+        ::operator delete(data, std::align_val_t(kDataAlignment));
+      }
+      free_data_[i].clear();
+    }
+    cached_bytes_ = 0;
+  }
+
+ private:
+  static constexpr size_t kNumSizeClasses = 48;
+
+  /// Returns the index of the smallest power-of-two size class that holds
+  /// `nbytes`.
+  static size_t size_class_of(size_t nbytes) {
+    size_t size_class = 0;
+    while ((kMinDataCapacity << size_class) < nbytes) {
+      size_class++;
+    }
+    ET_CHECK_MSG(
+        size_class < kNumSizeClasses, "Tensor of %zu bytes is too big", nbytes);
+    return size_class;
+  }
+
+  mutable std::mutex mutex_;
+  const size_t max_cached_bytes_;
+  size_t cached_bytes_ = 0;
+  size_t block_size_ = 0;
+  std::vector<void*> free_blocks_;
+  std::vector<void*> free_data_[kNumSizeClasses];
+};
+
+} // namespace internal
+
+namespace {
+
+using internal::TensorPoolState;
+
+/// Allocates the shared_ptr control block and the tensor from the pool.
+template <typename T>
+struct PoolAllocator final {
+  using value_type = T;
+
+  explicit PoolAllocator(std::shared_ptr<TensorPoolState> state)
+      : state(std::move(state)) {}
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& other) : state(other.state) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(state->allocate_block(n * sizeof(T)));
+  }
+
+  void deallocate(T* block, size_t n) {
+    state->release_block(block, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>& other) const {
+    return state == other.state;
+  }
+
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>& other) const {
+    return state != other.state;
+  }
+
+  std::shared_ptr<TensorPoolState> state;
+};
+
+/// A data buffer allocated from the pool, returned to it on destruction.
+struct PooledData final {
+  /// No data, for tensors that wrap existing data.
+  PooledData() = default;
+
+  PooledData(std::shared_ptr<TensorPoolState> state, size_t nbytes)
+      : state(std::move(state)) {
+    data = this->state->allocate_data(nbytes, &capacity);
+  }
+
+  PooledData(PooledData&& rhs) noexcept
+      : state(std::move(rhs.state)), data(rhs.data), capacity(rhs.capacity) {
+    rhs.data = nullptr;
+  }
+
+  ~PooledData() {
+    if (data != nullptr) {
+      state->release_data(data, capacity);
+    }
+  }
+
+  std::shared_ptr<TensorPoolState> state;
+  void* data = nullptr;
+  size_t capacity = 0;
+};
+
+#ifndef USE_ATEN_LIB
+/// The metadata of a pooled tensor, stored inline.
+struct PooledMetadata {
+  PooledMetadata(
+      const executorch::aten::SizesType* sizes,
+      size_t dim,
+      const executorch::aten::DimOrderType* dim_order) {
+    if (dim > 0) {
+      std::memcpy(this->sizes, sizes, dim * sizeof(*sizes));
+    }
+    if (dim_order != nullptr && dim > 0) {
+      std::memcpy(this->dim_order, dim_order, dim * sizeof(*dim_order));
+    } else {
+      std::iota(this->dim_order, this->dim_order + dim, 0);
+    }
+    const auto error = runtime::dim_order_to_stride(
+        this->sizes, this->dim_order, dim, this->strides);
+    ET_CHECK_MSG(error == runtime::Error::Ok, "Failed to compute strides.");
+  }
+
+  executorch::aten::SizesType sizes[runtime::kTensorDimensionLimit];
+  executorch::aten::DimOrderType dim_order[runtime::kTensorDimensionLimit];
+  executorch::aten::StridesType strides[runtime::kTensorDimensionLimit];
+};
+
+/**
+ * A pooled tensor: its metadata, and its data if the pool allocated it. The
+ * metadata is a base so that it is initialized before the TensorImpl that
+ * refers to it.
+ */
+struct PooledStorage final : PooledMetadata {
+  PooledStorage(
+      const executorch::aten::SizesType* sizes,
+      size_t dim,
+      const executorch::aten::DimOrderType* dim_order,
+      void* data,
+      PooledData&& pooled_data,
+      executorch::aten::ScalarType type,
+      executorch::aten::TensorShapeDynamism dynamism)
+      : PooledMetadata(sizes, dim, dim_order),
+        pooled_data(std::move(pooled_data)),
+        tensor_impl(
+            type,
+            dim,
+            this->sizes,
+            data != nullptr ? data : this->pooled_data.data,
+            this->dim_order,
+            this->strides,
+            dim > 0 ? dynamism
+                    : executorch::aten::TensorShapeDynamism::STATIC),
+        tensor(&tensor_impl) {}
+
+  PooledData pooled_data;
+  executorch::aten::TensorImpl tensor_impl;
+  executorch::aten::Tensor tensor;
+};
+
+TensorPtr make_pooled_tensor_ptr(
+    const std::shared_ptr<TensorPoolState>& state,
+    const executorch::aten::SizesType* sizes,
+    size_t dim,
+    const executorch::aten::DimOrderType* dim_order,
+    void* data,
+    PooledData&& pooled_data,
+    executorch::aten::ScalarType type,
+    executorch::aten::TensorShapeDynamism dynamism) {
+  auto storage = std::allocate_shared<PooledStorage>(
+      PoolAllocator<PooledStorage>(state),
+      sizes,
+      dim,
+      dim_order,
+      data,
+      std::move(pooled_data),
+      type,
+      dynamism);
+  const auto tensor_ptr = &storage->tensor;
+  return TensorPtr(std::move(storage), tensor_ptr);
+}
+#endif // USE_ATEN_LIB
+
+} // namespace
+
+TensorPool::TensorPool(size_t max_cached_bytes)
+    : state_(std::make_shared<TensorPoolState>(max_cached_bytes)) {}
+
+TensorPtr TensorPool::make(
+    void* data,
+    const executorch::aten::SizesType* sizes,
+    size_t dim,
+    executorch::aten::ScalarType type,
+    executorch::aten::TensorShapeDynamism dynamism) {
+  PooledData pooled_data = data != nullptr
+      ? PooledData()
+      : PooledData(
+            state_,
+            executorch::aten::compute_numel(sizes, dim) *
+                executorch::aten::elementSize(type));
+#ifndef USE_ATEN_LIB
+  if (dim <= runtime::kTensorDimensionLimit) {
+    return make_pooled_tensor_ptr(
+        state_,
+        sizes,
+        dim,
+        /*dim_order=*/nullptr,
+        data,
+        std::move(pooled_data),
+        type,
+        dynamism);
+  }
+#endif // USE_ATEN_LIB
+  // Only the data is pooled.
+  void* tensor_data = data != nullptr ? data : pooled_data.data;
+  return make_tensor_ptr(
+      std::vector<executorch::aten::SizesType>(sizes, sizes + dim),
+      tensor_data,
+      {},
+      {},
+      type,
+      dynamism,
+      [pooled_data =
+           std::make_shared<PooledData>(std::move(pooled_data))](void*) {});
+}
+
+TensorPtr TensorPool::clone_tensor_ptr(const executorch::aten::Tensor& tensor) {
+  const size_t dim = tensor.dim();
+#ifndef USE_ATEN_LIB
+  if (dim <= runtime::kTensorDimensionLimit) {
+    PooledData pooled_data = tensor.const_data_ptr() == nullptr
+        ? PooledData()
+        : PooledData(state_, tensor.nbytes());
+    if (pooled_data.data != nullptr) {
+      std::memcpy(pooled_data.data, tensor.const_data_ptr(), tensor.nbytes());
+    }
+    return make_pooled_tensor_ptr(
+        state_,
+        tensor.sizes().data(),
+        dim,
+        tensor.dim_order().data(),
+        /*data=*/nullptr,
+        std::move(pooled_data),
+        tensor.scalar_type(),
+        tensor.shape_dynamism());
+  }
+#endif // USE_ATEN_LIB
+  (void)dim;
+  return extension::clone_tensor_ptr(tensor);
+}
+
+size_t TensorPool::cached_bytes() const {
+  return state_->cached_bytes();
+}
+
+void TensorPool::release_cached() {
+  state_->release_cached();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <executorch/extension/tensor/tensor_ptr.h>
+
+namespace executorch {
+namespace extension {
+
+namespace internal {
+class TensorPoolState;
+} // namespace internal
+
+/**
+ * A factory for TensorPtrs that recycles their memory, for code that creates
+ * short-lived tensors in a loop, like a runner that wraps its inputs for every
+ * token.
+ *
+ * A TensorPtr made by `make_tensor_ptr()` allocates the Tensor, its sizes,
+ * dim order and strides, and its data separately. A pooled TensorPtr keeps the
+ * Tensor and its metadata in a single block, along with the shared_ptr control
+ * block, and allocates data in power-of-two size classes. When the TensorPtr is
+ * destroyed, its block and data are kept for later tensors, up to
+ * `max_cached_bytes`.
+ *
+ * Pooled tensors may outlive the pool. The pool is thread-safe, and its
+ * tensors may be created and destroyed on any thread.
+ */
+class TensorPool final {
+ public:
+  /// The default limit on the memory that the pool keeps for later tensors.
+  static constexpr size_t kDefaultMaxCachedBytes = 16 * 1024 * 1024;
+
+  /**
+   * Creates an empty pool.
+   *
+   * @param max_cached_bytes The maximum number of bytes of free blocks and data
+   * buffers to keep for later tensors. Memory released beyond this is freed.
+   */
+  explicit TensorPool(size_t max_cached_bytes = kDefaultMaxCachedBytes);
+
+  TensorPool(TensorPool&&) noexcept = default;
+  TensorPool& operator=(TensorPool&&) noexcept = default;
+  ~TensorPool() = default;
+
+  /**
+   * Creates a contiguous TensorPtr that wraps existing data, like
+   * `from_blob()`.
+   *
+   * @param data A pointer to the raw data used by the tensor. The data must
+   * outlive the TensorPtr created by this function.
+   * @param sizes The size of each dimension.
+   * @param type The scalar type of the tensor elements.
+   * @param dynamism Specifies whether the tensor's shape is static or dynamic.
+   * @return A TensorPtr instance managing the newly created Tensor.
+   */
+  TensorPtr from_blob(
+      void* data,
+      std::initializer_list<executorch::aten::SizesType> sizes,
+      executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+      executorch::aten::TensorShapeDynamism dynamism =
+          executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND) {
+    return make(data, sizes.begin(), sizes.size(), type, dynamism);
+  }
+
+  TensorPtr from_blob(
+      void* data,
+      const std::vector<executorch::aten::SizesType>& sizes,
+      executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+      executorch::aten::TensorShapeDynamism dynamism =
+          executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND) {
+    return make(data, sizes.data(), sizes.size(), type, dynamism);
+  }
+
+  /**
+   * Creates a contiguous TensorPtr with uninitialized data from the pool, like
+   * `empty()`.
+   *
+   * @param sizes The size of each dimension.
+   * @param type The scalar type of the tensor elements.
+   * @param dynamism Specifies whether the tensor's shape is static or dynamic.
+   * @return A TensorPtr instance managing the newly created Tensor.
+   */
+  TensorPtr empty(
+      std::initializer_list<executorch::aten::SizesType> sizes,
+      executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+      executorch::aten::TensorShapeDynamism dynamism =
+          executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND) {
+    return make(nullptr, sizes.begin(), sizes.size(), type, dynamism);
+  }
+
+  TensorPtr empty(
+      const std::vector<executorch::aten::SizesType>& sizes,
+      executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+      executorch::aten::TensorShapeDynamism dynamism =
+          executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND) {
+    return make(nullptr, sizes.data(), sizes.size(), type, dynamism);
+  }
+
+  /**
+   * Creates a TensorPtr with a copy of the data and metadata of `tensor`, like
+   * `clone_tensor_ptr()`, with the data allocated from the pool.
+   *
+   * @param tensor The Tensor to clone.
+   * @return A TensorPtr instance managing the newly created Tensor.
+   */
+  TensorPtr clone_tensor_ptr(const executorch::aten::Tensor& tensor);
+
+  /**
+   * @returns The number of bytes of free blocks and data buffers that the pool
+   * keeps for later tensors.
+   */
+  size_t cached_bytes() const;
+
+  /**
+   * Frees the blocks and data buffers that the pool keeps for later tensors.
+   * Live tensors are not affected.
+   */
+  void release_cached();
+
+ private:
+  TensorPool(const TensorPool&) = delete;
+  TensorPool& operator=(const TensorPool&) = delete;
+
+  /// Wraps `data`, or allocates it from the pool if it is null.
+  TensorPtr make(
+      void* data,
+      const executorch::aten::SizesType* sizes,
+      size_t dim,
+      executorch::aten::ScalarType type,
+      executorch::aten::TensorShapeDynamism dynamism);
+
+  std::shared_ptr<internal::TensorPoolState> state_;
+};
+
+} // namespace extension
+} // namespace executorch
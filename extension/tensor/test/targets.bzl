@@ -14,6 +14,7 @@ def define_common_targets():
             name = "test" + aten_suffix,
             srcs = [
                 "tensor_accessor_test.cpp",
+                "tensor_pool_test.cpp",
                 "tensor_ptr_maker_test.cpp",
                 "tensor_ptr_test.cpp",
             ],
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/tensor/tensor_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+
+class TensorPoolTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    runtime_init();
+  }
+};
+
+TEST_F(TensorPoolTest, FromBlob) {
+  TensorPool pool;
+  int64_t data[6] = {1, 2, 3, 4, 5, 6};
+  auto tensor =
+      pool.from_blob(data, {2, 3}, executorch::aten::ScalarType::Long);
+
+  EXPECT_EQ(tensor->dim(), 2);
+  EXPECT_EQ(tensor->size(0), 2);
+  EXPECT_EQ(tensor->size(1), 3);
+  EXPECT_EQ(tensor->strides()[0], 3);
+  EXPECT_EQ(tensor->strides()[1], 1);
+  EXPECT_EQ(tensor->scalar_type(), executorch::aten::ScalarType::Long);
+  EXPECT_EQ(tensor->const_data_ptr<int64_t>(), data);
+
+  // The pool doesn't own the data of the tensors it wraps.
+  tensor.reset();
+  EXPECT_EQ(data[5], 6);
+
+  const std::vector<executorch::aten::SizesType> sizes = {6};
+  auto flat = pool.from_blob(data, sizes, executorch::aten::ScalarType::Long);
+  EXPECT_EQ(flat->dim(), 1);
+  EXPECT_EQ(flat->numel(), 6);
+}
+
+TEST_F(TensorPoolTest, EmptyRecyclesData) {
+  TensorPool pool;
+  auto tensor = pool.empty({4, 5});
+  EXPECT_EQ(tensor->dim(), 2);
+  EXPECT_EQ(tensor->numel(), 20);
+  EXPECT_EQ(tensor->scalar_type(), executorch::aten::ScalarType::Float);
+  ASSERT_NE(tensor->mutable_data_ptr<float>(), nullptr);
+  EXPECT_EQ(
+      reinterpret_cast<uintptr_t>(tensor->const_data_ptr()) % alignof(float),
+      0);
+  tensor->mutable_data_ptr<float>()[19] = 3;
+  const void* data = tensor->const_data_ptr();
+  EXPECT_EQ(pool.cached_bytes(), 0);
+
+  tensor.reset();
+  EXPECT_GT(pool.cached_bytes(), 0);
+
+  // A tensor of the same size class reuses the buffer.
+  auto other = pool.empty({3, 6});
+  EXPECT_EQ(other->const_data_ptr(), data);
+
+  // A bigger one doesn't.
+  auto bigger = pool.empty({100, 100});
+  EXPECT_NE(bigger->const_data_ptr(), data);
+}
+
+TEST_F(TensorPoolTest, RecyclesTensors) {
+  TensorPool pool;
+  int64_t pos = 0;
+  auto tensor = pool.from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
+  const auto* first = tensor.get();
+  tensor.reset();
+  for (int i = 0; i < 10; ++i) {
+    auto recycled =
+        pool.from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
+    EXPECT_EQ(recycled->const_data_ptr<int64_t>(), &pos);
+#ifndef USE_ATEN_LIB
+    // The Tensor and its metadata are recycled too.
+    EXPECT_EQ(recycled.get(), first);
+#endif // USE_ATEN_LIB
+  }
+  (void)first;
+}
+
+TEST_F(TensorPoolTest, CloneTensorPtr) {
+  TensorPool pool;
+  float data[4] = {1, 2, 3, 4};
+  auto original = from_blob(data, {2, 2});
+  auto clone = pool.clone_tensor_ptr(*original);
+
+  EXPECT_EQ(clone->dim(), 2);
+  EXPECT_EQ(clone->size(0), 2);
+  EXPECT_EQ(clone->size(1), 2);
+  EXPECT_NE(clone->const_data_ptr<float>(), data);
+  EXPECT_EQ(clone->const_data_ptr<float>()[3], 4);
+
+  data[3] = 5;
+  EXPECT_EQ(clone->const_data_ptr<float>()[3], 4);
+}
+
+TEST_F(TensorPoolTest, ResizeTensor) {
+  TensorPool pool;
+  auto tensor = pool.empty({1, 8}, executorch::aten::ScalarType::Long);
+  EXPECT_EQ(resize_tensor_ptr(tensor, {1, 4}), Error::Ok);
+  EXPECT_EQ(tensor->size(1), 4);
+  EXPECT_EQ(tensor->numel(), 4);
+}
+
+TEST_F(TensorPoolTest, MaxCachedBytes) {
+  TensorPool pool(/*max_cached_bytes=*/0);
+  auto tensor = pool.empty({16});
+  tensor.reset();
+  EXPECT_EQ(pool.cached_bytes(), 0);
+
+  TensorPool caching_pool;
+  auto first = caching_pool.empty({16});
+  auto second = caching_pool.empty({1024});
+  first.reset();
+  second.reset();
+  EXPECT_GT(caching_pool.cached_bytes(), 0);
+  caching_pool.release_cached();
+  EXPECT_EQ(caching_pool.cached_bytes(), 0);
+}
+
+TEST_F(TensorPoolTest, TensorsOutliveThePool) {
+  TensorPtr tensor;
+  {
+    TensorPool pool;
+    tensor = pool.empty({2, 2});
+    tensor->mutable_data_ptr<float>()[0] = 1;
+  }
+  EXPECT_EQ(tensor->const_data_ptr<float>()[0], 1);
+  tensor.reset();
+}
@@ -9,11 +9,17 @@
 #include <c10/util/irange.h>
 #include <executorch/extension/threadpool/cpuinfo_utils.h>
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include <executorch/runtime/platform/assert.h>
 
 namespace executorch::extension::cpuinfo {
@@ -27,8 +33,8 @@ namespace executorch::extension::cpuinfo {
 #define RIVISION_MASK UINT32_C(0xFFFFFFF0)
 
 namespace {
-bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
-  switch (uarch_info->uarch) {
+bool is_non_performant_uarch(enum cpuinfo_uarch uarch, uint32_t midr) {
+  switch (uarch) {
     case cpuinfo_uarch_cortex_a55:
     case cpuinfo_uarch_cortex_a53:
     case cpuinfo_uarch_cortex_a510:
@@ -44,13 +50,44 @@ bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
     // A520 is not yet updated in cpuinfo
     // Hence decode it separately.
 #if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-  if ((uarch_info->midr & RIVISION_MASK) == CPUINFO_ARM_MIDR_CORTEX_A520) {
+  if ((midr & RIVISION_MASK) == CPUINFO_ARM_MIDR_CORTEX_A520) {
     return true;
   }
+#else
+  (void)midr;
 #endif
   return false;
 }
 
+bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+  return is_non_performant_uarch(uarch_info->uarch, uarch_info->midr);
+#else
+  return is_non_performant_uarch(uarch_info->uarch, 0);
+#endif
+}
+
+bool is_non_performant_cluster(const struct cpuinfo_cluster* cluster) {
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+  return is_non_performant_uarch(cluster->uarch, cluster->midr);
+#else
+  return is_non_performant_uarch(cluster->uarch, 0);
+#endif
+}
+
+// Classifies a MIDR read from sysfs, for when cpuinfo's topology is wrong.
+bool is_non_performant_midr(uint32_t midr) {
+  switch (midr & RIVISION_MASK) {
+    case CPUINFO_ARM_MIDR_CORTEX_A520:
+    case CPUINFO_ARM_MIDR_CORTEX_A53:
+    case CPUINFO_ARM_MIDR_CORTEX_A55:
+    case CPUINFO_ARM_MIDR_CORTEX_A57:
+      return true;
+    default:
+      return false;
+  }
+}
+
 std::vector<uint32_t>* get_static_cpu_midr_vector() {
   static std::vector<uint32_t> cpu_midrs;
   return &cpu_midrs;
@@ -105,33 +142,121 @@ bool populate_available_cpu_mids() {
   return true;
 }
 
-uint32_t _get_num_performant_cores() {
+const std::vector<uint32_t>* get_available_cpu_midrs() {
   // @lint-ignore CLANGTIDY facebook-hte-std::once_flag
   static std::once_flag flag;
   // @lint-ignore CLANGTIDY facebook-hte-std::call_once
   std::call_once(flag, []() { populate_available_cpu_mids(); });
-  std::vector<uint32_t>* cpu_midrs = get_static_cpu_midr_vector();
+  return get_static_cpu_midr_vector();
+}
+
+uint32_t _get_num_performant_cores() {
+  const std::vector<uint32_t>* cpu_midrs = get_available_cpu_midrs();
   uint32_t num_possible_cores = cpuinfo_get_processors_count();
   if (num_possible_cores != cpu_midrs->size()) {
     ET_LOG(Info, "CPU info and manual query on # of cpus dont match.");
     return 0;
   }
   for (const auto i : c10::irange(cpu_midrs->size())) {
-    uint32_t masked_midr = (*cpu_midrs)[i] & RIVISION_MASK;
-    switch (masked_midr) {
-      case CPUINFO_ARM_MIDR_CORTEX_A520:
-      case CPUINFO_ARM_MIDR_CORTEX_A53:
-      case CPUINFO_ARM_MIDR_CORTEX_A55:
-      case CPUINFO_ARM_MIDR_CORTEX_A57:
-        num_possible_cores--;
-        break;
-      default:
-        break;
+    if (is_non_performant_midr((*cpu_midrs)[i])) {
+      num_possible_cores--;
     }
   }
   return num_possible_cores;
 }
 
+uint32_t get_os_processor_id(uint32_t processor) {
+#if defined(__linux__)
+  return static_cast<uint32_t>(cpuinfo_get_processor(processor)->linux_id);
+#else
+  return processor;
+#endif
+}
+
+struct CoreTypeCpus {
+  std::vector<uint32_t> performance;
+  std::vector<uint32_t> efficiency;
+};
+
+// Marks each processor as an efficiency core or not.
+std::vector<bool> classify_processors() {
+  const uint32_t num_processors = cpuinfo_get_processors_count();
+  std::vector<bool> is_efficiency(num_processors, false);
+
+  const uint32_t num_clusters = cpuinfo_get_clusters_count();
+  if (num_clusters <= 1) {
+    // Some devices report a single cluster despite having little cores (see
+    // get_num_performant_cores()), so check each processor's MIDR instead.
+    const std::vector<uint32_t>* cpu_midrs = get_available_cpu_midrs();
+    if (cpu_midrs->size() == num_processors) {
+      for (const auto i : c10::irange(num_processors)) {
+        is_efficiency[i] = is_non_performant_midr((*cpu_midrs)[i]);
+      }
+    }
+    return is_efficiency;
+  }
+
+  std::vector<bool> is_efficiency_cluster(num_clusters, false);
+  bool found_efficiency_cluster = false;
+  uint64_t min_frequency = std::numeric_limits<uint64_t>::max();
+  uint64_t max_frequency = 0;
+  for (const auto i : c10::irange(num_clusters)) {
+    const struct cpuinfo_cluster* cluster = cpuinfo_get_cluster(i);
+    is_efficiency_cluster[i] = is_non_performant_cluster(cluster);
+    found_efficiency_cluster |= is_efficiency_cluster[i];
+    min_frequency = std::min(min_frequency, cluster->frequency);
+    max_frequency = std::max(max_frequency, cluster->frequency);
+  }
+  if (!found_efficiency_cluster && min_frequency > 0 &&
+      min_frequency < max_frequency) {
+    // cpuinfo doesn't know every little core. Fall back to the clock speed:
+    // the slowest clusters are the efficiency ones.
+    for (const auto i : c10::irange(num_clusters)) {
+      is_efficiency_cluster[i] =
+          cpuinfo_get_cluster(i)->frequency == min_frequency;
+    }
+  }
+  for (const auto i : c10::irange(num_clusters)) {
+    const struct cpuinfo_cluster* cluster = cpuinfo_get_cluster(i);
+    for (const auto p : c10::irange(cluster->processor_count)) {
+      const uint32_t processor = cluster->processor_start + p;
+      if (processor < num_processors) {
+        is_efficiency[processor] = is_efficiency_cluster[i];
+      }
+    }
+  }
+  return is_efficiency;
+}
+
+const CoreTypeCpus& get_core_type_cpus() {
+  static CoreTypeCpus cpus;
+  // @lint-ignore CLANGTIDY facebook-hte-std::once_flag
+  static std::once_flag flag;
+  // @lint-ignore CLANGTIDY facebook-hte-std::call_once
+  std::call_once(flag, []() {
+    ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo cannot be initialized.");
+    std::vector<bool> is_efficiency = classify_processors();
+    if (std::find(is_efficiency.begin(), is_efficiency.end(), false) ==
+        is_efficiency.end()) {
+      // Without faster cores to prefer, every core counts as a performance
+      // core.
+      is_efficiency.assign(is_efficiency.size(), false);
+    }
+    for (const auto i : c10::irange(is_efficiency.size())) {
+      const uint32_t id = get_os_processor_id(static_cast<uint32_t>(i));
+      (is_efficiency[i] ? cpus.efficiency : cpus.performance).push_back(id);
+    }
+    std::sort(cpus.performance.begin(), cpus.performance.end());
+    std::sort(cpus.efficiency.begin(), cpus.efficiency.end());
+    ET_LOG(
+        Info,
+        "Found %zu performance and %zu efficiency cores",
+        cpus.performance.size(),
+        cpus.efficiency.size());
+  });
+  return cpus;
+}
+
 } // namespace
 
 uint32_t get_num_performant_cores() {
@@ -171,4 +296,49 @@ uint32_t get_num_performant_cores() {
   }
 }
 
+std::vector<uint32_t> get_cpus(CoreType type) {
+  const CoreTypeCpus& cpus = get_core_type_cpus();
+  return type == CoreType::Performance ? cpus.performance : cpus.efficiency;
+}
+
+bool set_thread_affinity(const std::vector<uint32_t>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpus.empty()) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  for (const uint32_t cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      ET_LOG(Info, "CPU %u is out of range for thread affinity.", cpu);
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  // On Linux, pid 0 refers to the calling thread rather than the process.
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+std::vector<uint32_t> get_thread_affinity() {
+  std::vector<uint32_t> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(static_cast<uint32_t>(cpu));
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
 } // namespace executorch::extension::cpuinfo
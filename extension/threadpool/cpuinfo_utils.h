@@ -8,12 +8,50 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include <cpuinfo.h>
 
 namespace executorch::extension::cpuinfo {
 
 uint32_t get_num_performant_cores();
 
+/**
+ * The kinds of cores found on SoCs that mix fast and slow cores, like ARM
+ * big.LITTLE.
+ */
+enum class CoreType {
+  /// The fast cores, which latency-sensitive work like decoding should use.
+  Performance,
+  /// The slow, power-efficient cores, which suit background work.
+  Efficiency,
+};
+
+/**
+ * Returns the OS ids of the processors of the given type, in ascending order.
+ * Processors are classified by cpuinfo cluster. On systems with a single kind
+ * of core, every processor is a performance core and there are no efficiency
+ * cores.
+ */
+std::vector<uint32_t> get_cpus(CoreType type);
+
+/**
+ * Restricts the calling thread to the processors with the given OS ids, or
+ * lets it run anywhere if `cpus` is empty. Threads created afterwards by the
+ * calling thread inherit the restriction.
+ *
+ * @returns false if the platform doesn't support thread affinity, or if the
+ *     restriction couldn't be applied.
+ */
+bool set_thread_affinity(const std::vector<uint32_t>& cpus);
+
+/**
+ * Returns the OS ids of the processors the calling thread may run on, or an
+ * empty vector if the platform doesn't support thread affinity.
+ */
+std::vector<uint32_t> get_thread_affinity();
+
 } // namespace executorch::extension::cpuinfo
 
 namespace torch::executorch::cpuinfo { // DEPRECATED
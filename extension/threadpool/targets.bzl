@@ -12,11 +12,14 @@ def define_common_targets():
         "thread_parallel.cpp",
         "threadpool.cpp",
         "threadpool_guard.cpp",
+        "work_stealing_scheduler.cpp",
     ] + (["fb/threadpool_use_n_threads.cpp"] if not runtime.is_oss else [])
 
     _THREADPOOL_HEADERS = [
         "threadpool.h",
         "threadpool_guard.h",
+        "threadpool_task_runner.h",
+        "work_stealing_scheduler.h",
     ] + (["fb/threadpool_use_n_threads.h"] if not runtime.is_oss else [])
 
     runtime.cxx_library(
@@ -28,10 +31,12 @@ def define_common_targets():
         ],
         exported_headers = _THREADPOOL_HEADERS,
         exported_deps = [
+            ":cpuinfo_utils",
             third_party_dep("pthreadpool"),
             third_party_dep("cpuinfo"),
             # Allow users to use the header without an extra deps entry.
             "//executorch/runtime/kernel:thread_parallel_interface",
+            "//executorch/runtime/executor:parallel_task_runner",
         ],
         exported_preprocessor_flags = [
             "-DET_USE_THREADPOOL",
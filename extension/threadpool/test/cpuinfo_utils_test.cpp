@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::cpuinfo::CoreType;
+using ::executorch::extension::cpuinfo::get_cpus;
+using ::executorch::extension::cpuinfo::get_thread_affinity;
+using ::executorch::extension::cpuinfo::set_thread_affinity;
+
+class CpuinfoUtilsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Classifying cores logs, so the PAL must be initialized first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(CpuinfoUtilsTest, CoreTypesPartitionProcessors) {
+  const std::vector<uint32_t> performance = get_cpus(CoreType::Performance);
+  const std::vector<uint32_t> efficiency = get_cpus(CoreType::Efficiency);
+
+  // Every system has somewhere to run latency-sensitive work.
+  EXPECT_FALSE(performance.empty());
+  EXPECT_TRUE(std::is_sorted(performance.begin(), performance.end()));
+  EXPECT_TRUE(std::is_sorted(efficiency.begin(), efficiency.end()));
+  EXPECT_EQ(
+      performance.size() + efficiency.size(), cpuinfo_get_processors_count());
+
+  std::vector<uint32_t> both;
+  std::set_intersection(
+      performance.begin(),
+      performance.end(),
+      efficiency.begin(),
+      efficiency.end(),
+      std::back_inserter(both));
+  EXPECT_TRUE(both.empty());
+}
+
+TEST_F(CpuinfoUtilsTest, ThreadAffinityRoundTrips) {
+  const std::vector<uint32_t> original = get_thread_affinity();
+  if (original.empty()) {
+    GTEST_SKIP() << "Thread affinity is not supported here";
+  }
+
+  ASSERT_TRUE(set_thread_affinity({original.front()}));
+  EXPECT_EQ(get_thread_affinity(), std::vector<uint32_t>{original.front()});
+
+  // An empty list lifts the restriction.
+  ASSERT_TRUE(set_thread_affinity({}));
+  EXPECT_GE(get_thread_affinity().size(), original.size());
+
+  ASSERT_TRUE(set_thread_affinity(original));
+  EXPECT_EQ(get_thread_affinity(), original);
+}
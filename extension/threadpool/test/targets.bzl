@@ -16,6 +16,7 @@ def define_common_targets():
         srcs = _THREADPOOL_TESTS,
         deps = [
             "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/platform:platform",
         ],
     )
 
@@ -30,3 +31,24 @@ def define_common_targets():
             "//executorch/runtime/platform:platform",
         ],
     )
+
+    runtime.cxx_test(
+        name = "work_stealing_scheduler_test",
+        srcs = [
+            "work_stealing_scheduler_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "cpuinfo_utils_test",
+        srcs = [
+            "cpuinfo_utils_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/threadpool:cpuinfo_utils",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
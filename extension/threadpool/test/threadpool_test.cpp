@@ -8,11 +8,17 @@
 
 #include <executorch/extension/threadpool/threadpool.h>
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <numeric>
 #include <random>
+#include <thread>
 
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
 #include <executorch/extension/threadpool/threadpool_guard.h>
+#include <executorch/extension/threadpool/threadpool_task_runner.h>
+#include <executorch/runtime/platform/runtime.h>
 
 #include <gtest/gtest.h>
 
@@ -192,3 +198,151 @@ TEST(TestNoThreadPoolGuard, TestRunWithGuard) {
   }
   ASSERT_EQ(inner, 6);
 }
+
+TEST(ThreadPoolTaskRunnerTest, RunsEveryTaskOnce) {
+  ::executorch::extension::threadpool::ThreadPoolTaskRunner runner;
+
+  std::vector<int32_t> counts(37, 0);
+  std::mutex m;
+  struct Context {
+    std::vector<int32_t>* counts;
+    std::mutex* m;
+  } context{&counts, &m};
+
+  runner.run(
+      [](void* ctx, size_t i) {
+        auto* c = static_cast<Context*>(ctx);
+        // Nested threadpool use must run on the worker thread.
+        EXPECT_EQ(
+            ::executorch::extension::threadpool::get_pthreadpool(), nullptr);
+        std::lock_guard<std::mutex> lock(*c->m);
+        (*c->counts)[i]++;
+      },
+      &context,
+      counts.size());
+
+  EXPECT_EQ(counts, std::vector<int32_t>(counts.size(), 1));
+}
+
+TEST(ThreadPoolTest, WorkStealingRunsNestedCalls) {
+  using ::executorch::extension::threadpool::ThreadPool;
+  ThreadPool threadpool(4, ThreadPool::Scheduler::WorkStealing);
+  EXPECT_EQ(threadpool.scheduler(), ThreadPool::Scheduler::WorkStealing);
+
+  std::vector<int32_t> counts(8 * 16, 0);
+  threadpool.run(
+      [&](size_t i) {
+        // Unlike with pthreadpool, the inner call is not inlined by a
+        // NoThreadPoolGuard.
+        threadpool.run([&counts, i](size_t j) { counts[i * 16 + j]++; }, 16);
+      },
+      8);
+  EXPECT_EQ(counts, std::vector<int32_t>(counts.size(), 1));
+}
+
+TEST(TestThreadPoolGuard, InstallsPoolForCurrentThread) {
+  using ::executorch::extension::threadpool::get_pthreadpool;
+  using ::executorch::extension::threadpool::get_threadpool;
+  using ::executorch::extension::threadpool::ThreadPool;
+  using ::executorch::extension::threadpool::ThreadPoolGuard;
+
+  ThreadPool* const global = get_threadpool();
+  const auto global_pthreadpool = get_pthreadpool();
+  ThreadPool outer(2);
+  ThreadPool inner(1);
+  {
+    ThreadPoolGuard g1(&outer);
+    EXPECT_EQ(get_threadpool(), &outer);
+    EXPECT_NE(get_pthreadpool(), global_pthreadpool);
+    {
+      ThreadPoolGuard g2(&inner);
+      EXPECT_EQ(get_threadpool(), &inner);
+    }
+    EXPECT_EQ(get_threadpool(), &outer);
+
+    // Other threads keep using the global pool.
+    ThreadPool* other_thread_pool = nullptr;
+    std::thread([&other_thread_pool]() {
+      other_thread_pool = get_threadpool();
+    }).join();
+    EXPECT_EQ(other_thread_pool, global);
+  }
+  EXPECT_EQ(get_threadpool(), global);
+  EXPECT_EQ(get_pthreadpool(), global_pthreadpool);
+}
+
+TEST(TestThreadPoolGuard, WorkStealingTasksSeeTheirPool) {
+  using ::executorch::extension::threadpool::get_threadpool;
+  using ::executorch::extension::threadpool::ThreadPool;
+
+  ThreadPool threadpool(4, ThreadPool::Scheduler::WorkStealing);
+  std::vector<ThreadPool*> seen(16, nullptr);
+  threadpool.run([&seen](size_t i) { seen[i] = get_threadpool(); }, 16);
+  EXPECT_EQ(seen, std::vector<ThreadPool*>(seen.size(), &threadpool));
+}
+
+TEST(ThreadPoolTest, PinnedThreadsStayOnTheirCores) {
+  using ::executorch::extension::threadpool::ThreadPool;
+  namespace cpuinfo = ::executorch::extension::cpuinfo;
+
+  // Classifying cores logs, so the PAL must be initialized first.
+  ::executorch::runtime::runtime_init();
+  ThreadPool threadpool(
+      4,
+      ThreadPool::Scheduler::WorkStealing,
+      ThreadPool::Affinity::Performance);
+  EXPECT_EQ(threadpool.affinity(), ThreadPool::Affinity::Performance);
+  if (threadpool.cpus().empty()) {
+    GTEST_SKIP() << "Thread affinity is not supported here";
+  }
+  EXPECT_EQ(
+      threadpool.cpus(), cpuinfo::get_cpus(cpuinfo::CoreType::Performance));
+
+  // The caller keeps its affinity, while the pool's threads only run on the
+  // performance cores.
+  const auto caller = std::this_thread::get_id();
+  const std::vector<uint32_t> caller_cpus = cpuinfo::get_thread_affinity();
+  std::mutex mutex;
+  std::vector<std::vector<uint32_t>> worker_cpus;
+  threadpool.run(
+      [&](size_t) {
+        if (std::this_thread::get_id() != caller) {
+          std::lock_guard<std::mutex> lock(mutex);
+          worker_cpus.push_back(cpuinfo::get_thread_affinity());
+        }
+      },
+      64);
+  EXPECT_EQ(cpuinfo::get_thread_affinity(), caller_cpus);
+  for (const auto& cpus : worker_cpus) {
+    EXPECT_TRUE(std::includes(
+        threadpool.cpus().begin(),
+        threadpool.cpus().end(),
+        cpus.begin(),
+        cpus.end()));
+  }
+}
+
+TEST(TestKeepWorkersHotGuard, KeepsWorkStealingWorkersHot) {
+  using namespace std::chrono_literals;
+  using ::executorch::extension::threadpool::KeepWorkersHotGuard;
+  using ::executorch::extension::threadpool::ThreadPool;
+
+  ThreadPool threadpool(4, ThreadPool::Scheduler::WorkStealing);
+  threadpool.set_wait_policy({/*spin=*/20us, /*yield=*/100us});
+  EXPECT_EQ(threadpool.wait_policy().spin, 20us);
+  EXPECT_EQ(threadpool.wait_policy().yield, 100us);
+
+  std::vector<int32_t> counts(64, 0);
+  {
+    KeepWorkersHotGuard guard(&threadpool);
+    // A scheduler created while the guard is alive picks up both settings.
+    threadpool._unsafe_set_scheduler(ThreadPool::Scheduler::Pthreadpool);
+    threadpool._unsafe_set_scheduler(ThreadPool::Scheduler::WorkStealing);
+    for (int step = 0; step < 10; ++step) {
+      threadpool.run([&counts](size_t i) { counts[i]++; }, counts.size());
+    }
+  }
+  KeepWorkersHotGuard null_guard(nullptr);
+  EXPECT_EQ(threadpool.wait_policy().spin, 20us);
+  EXPECT_EQ(counts, std::vector<int32_t>(counts.size(), 10));
+}
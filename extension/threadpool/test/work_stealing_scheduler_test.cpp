@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/threadpool/work_stealing_scheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::threadpool::WorkStealingScheduler;
+
+TEST(WorkStealingSchedulerTest, RunsEveryIndexOnce) {
+  WorkStealingScheduler scheduler(4);
+  EXPECT_EQ(scheduler.num_threads(), 4);
+
+  std::vector<std::atomic<int>> counts(1000);
+  scheduler.run([&counts](size_t i) { counts[i]++; }, counts.size());
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+
+  // Empty ranges are fine.
+  scheduler.run([](size_t) { FAIL(); }, 0);
+}
+
+TEST(WorkStealingSchedulerTest, SingleThreadRunsOnCaller) {
+  WorkStealingScheduler scheduler(1);
+  EXPECT_EQ(scheduler.num_threads(), 1);
+
+  const auto caller = std::this_thread::get_id();
+  size_t sum = 0;
+  scheduler.run(
+      [&](size_t i) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        sum += i;
+      },
+      10);
+  EXPECT_EQ(sum, 45);
+}
+
+TEST(WorkStealingSchedulerTest, NestedRunsComplete) {
+  WorkStealingScheduler scheduler(4);
+
+  constexpr size_t kOuter = 16;
+  constexpr size_t kInner = 64;
+  std::vector<std::atomic<int>> counts(kOuter * kInner);
+  scheduler.run(
+      [&](size_t i) {
+        scheduler.run(
+            [&counts, i](size_t j) { counts[i * kInner + j]++; }, kInner);
+      },
+      kOuter);
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(WorkStealingSchedulerTest, ConcurrentCallersDontInterfere) {
+  WorkStealingScheduler scheduler(4);
+
+  constexpr size_t kCallers = 4;
+  constexpr size_t kRange = 256;
+  std::vector<std::vector<std::atomic<int>>> counts(kCallers);
+  std::vector<std::thread> callers;
+  for (size_t c = 0; c < kCallers; ++c) {
+    counts[c] = std::vector<std::atomic<int>>(kRange);
+    callers.emplace_back([&scheduler, &counts, c]() {
+      for (int iteration = 0; iteration < 20; ++iteration) {
+        scheduler.run([&counts, c](size_t i) { counts[c][i]++; }, kRange);
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (const auto& caller_counts : counts) {
+    for (const auto& count : caller_counts) {
+      EXPECT_EQ(count.load(), 20);
+    }
+  }
+}
+
+TEST(WorkStealingSchedulerTest, WaitPolicyKeepsWorkersRunningTasks) {
+  using namespace std::chrono_literals;
+  WorkStealingScheduler scheduler(4);
+  EXPECT_EQ(scheduler.wait_policy().spin, 0us);
+  EXPECT_EQ(scheduler.wait_policy().yield, 0us);
+
+  scheduler.set_wait_policy({/*spin=*/50us, /*yield=*/200us});
+  EXPECT_EQ(scheduler.wait_policy().spin, 50us);
+  EXPECT_EQ(scheduler.wait_policy().yield, 200us);
+
+  // Short gaps between calls land in the spin and yield phases, longer ones
+  // put the workers to sleep; hot workers never sleep.
+  std::vector<std::atomic<int>> counts(128);
+  for (int iteration = 0; iteration < 40; ++iteration) {
+    if (iteration == 20) {
+      scheduler.keep_workers_hot();
+    }
+    scheduler.run([&counts](size_t i) { counts[i]++; }, counts.size());
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(iteration % 2 == 0 ? 10 : 1000));
+  }
+  scheduler.let_workers_sleep();
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 40);
+  }
+}
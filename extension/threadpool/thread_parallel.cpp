@@ -20,7 +20,11 @@ namespace extension {
 
 namespace {
 thread_local int64_t thread_num_ = 0;
-}
+
+// With work stealing, splitting the range into more tasks than threads lets
+// idle threads pick up the slack when some tasks take longer than others.
+constexpr int64_t kWorkStealingTasksPerThread = 4;
+} // namespace
 
 using namespace ::executorch::extension::threadpool;
 
@@ -42,8 +46,12 @@ calc_num_tasks_and_chunk_size(int64_t begin, int64_t end, int64_t grain_size) {
     return std::make_tuple(1, std::max((int64_t)0, end - begin));
   }
   // Choose number of tasks based on grain size and number of threads.
-  int64_t chunk_size =
-      divup((end - begin), get_threadpool()->get_thread_count());
+  ThreadPool* const threadpool = get_threadpool();
+  int64_t max_num_tasks = threadpool->get_thread_count();
+  if (threadpool->scheduler() == ThreadPool::Scheduler::WorkStealing) {
+    max_num_tasks *= kWorkStealingTasksPerThread;
+  }
+  int64_t chunk_size = divup((end - begin), max_num_tasks);
   // Make sure each task is at least grain_size size.
   chunk_size = std::max(grain_size, chunk_size);
   int64_t num_tasks = divup((end - begin), chunk_size);
@@ -12,6 +12,7 @@
 #include <atomic>
 #include <memory>
 
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
 #include <executorch/extension/threadpool/threadpool_guard.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -34,8 +35,62 @@ void child_atfork() {
 } // namespace
 #endif
 
-ThreadPool::ThreadPool(size_t thread_count)
-    : threadpool_(pthreadpool_create(thread_count), pthreadpool_destroy) {}
+namespace {
+std::vector<uint32_t> get_cpus(ThreadPool::Affinity affinity) {
+  switch (affinity) {
+    case ThreadPool::Affinity::Performance:
+      return cpuinfo::get_cpus(cpuinfo::CoreType::Performance);
+    case ThreadPool::Affinity::Efficiency:
+      return cpuinfo::get_cpus(cpuinfo::CoreType::Efficiency);
+    case ThreadPool::Affinity::Any:
+      break;
+  }
+  return {};
+}
+
+// Threads inherit the affinity of the thread that creates them, so run
+// `create` with the calling thread restricted to `cpus`, then restore the
+// calling thread's affinity. Returns false if the calling thread couldn't be
+// restricted, in which case `create` still runs.
+template <typename Fn>
+bool create_on_cpus(const std::vector<uint32_t>& cpus, const Fn& create) {
+  if (cpus.empty()) {
+    create();
+    return true;
+  }
+  const std::vector<uint32_t> previous = cpuinfo::get_thread_affinity();
+  const bool pinned = cpuinfo::set_thread_affinity(cpus);
+  create();
+  if (pinned) {
+    cpuinfo::set_thread_affinity(previous);
+  } else {
+    ET_LOG(Info, "Failed to pin threadpool threads; the OS will place them.");
+  }
+  return pinned;
+}
+} // namespace
+
+ThreadPool::ThreadPool(
+    size_t thread_count,
+    Scheduler scheduler,
+    Affinity affinity)
+    : threadpool_(nullptr, pthreadpool_destroy),
+      affinity_(affinity),
+      cpus_(get_cpus(affinity)) {
+  if (thread_count == 0) {
+    thread_count = cpus_.size();
+  }
+  const bool pinned = create_on_cpus(cpus_, [&]() {
+    threadpool_.reset(pthreadpool_create(thread_count));
+    if (scheduler == Scheduler::WorkStealing) {
+      work_stealing_ =
+          make_work_stealing(pthreadpool_get_threads_count(threadpool_.get()));
+    }
+  });
+  if (!pinned) {
+    cpus_.clear();
+  }
+}
 
 size_t ThreadPool::get_thread_count() const {
   std::lock_guard<std::mutex> lock{mutex_};
@@ -52,10 +107,86 @@ bool ThreadPool::_unsafe_reset_threadpool(uint32_t new_thread_count) {
 
   std::lock_guard<std::mutex> lock{mutex_};
 
-  threadpool_.reset(pthreadpool_create(new_thread_count));
+  // cpus_ is only non-empty if pinning worked before.
+  create_on_cpus(cpus_, [&]() {
+    threadpool_.reset(pthreadpool_create(new_thread_count));
+    if (work_stealing_) {
+      work_stealing_ = make_work_stealing(new_thread_count);
+    }
+  });
   return true;
 }
 
+void ThreadPool::_unsafe_set_scheduler(Scheduler scheduler) {
+  if (scheduler == this->scheduler()) {
+    return;
+  }
+  const size_t thread_count = get_thread_count();
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (scheduler == Scheduler::WorkStealing) {
+    create_on_cpus(cpus_, [&]() {
+      work_stealing_ = make_work_stealing(thread_count);
+    });
+  } else {
+    work_stealing_.reset();
+  }
+}
+
+bool ThreadPool::_unsafe_set_affinity(Affinity affinity) {
+  const size_t thread_count = get_thread_count();
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  affinity_ = affinity;
+  cpus_ = get_cpus(affinity);
+  const bool pinned = create_on_cpus(cpus_, [&]() {
+    threadpool_.reset(pthreadpool_create(thread_count));
+    if (work_stealing_) {
+      work_stealing_ = make_work_stealing(thread_count);
+    }
+  });
+  if (!pinned) {
+    cpus_.clear();
+  }
+  return pinned;
+}
+
+void ThreadPool::set_wait_policy(const WaitPolicy& policy) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  wait_policy_ = policy;
+  if (work_stealing_) {
+    work_stealing_->set_wait_policy(policy);
+  }
+}
+
+ThreadPool::WaitPolicy ThreadPool::wait_policy() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return wait_policy_;
+}
+
+void ThreadPool::keep_workers_hot() {
+  num_hot_holds_.fetch_add(1);
+  if (work_stealing_) {
+    work_stealing_->keep_workers_hot();
+  }
+}
+
+void ThreadPool::let_workers_sleep() {
+  num_hot_holds_.fetch_sub(1);
+  if (work_stealing_) {
+    work_stealing_->let_workers_sleep();
+  }
+}
+
+std::unique_ptr<WorkStealingScheduler> ThreadPool::make_work_stealing(
+    size_t thread_count) const {
+  auto scheduler = std::make_unique<WorkStealingScheduler>(thread_count);
+  scheduler->set_wait_policy(wait_policy_);
+  for (size_t i = 0; i < num_hot_holds_.load(); ++i) {
+    scheduler->keep_workers_hot();
+  }
+  return scheduler;
+}
+
 void ThreadPool::run(
     const std::function<void(size_t)>& fn,
     const size_t range) {
@@ -67,6 +198,18 @@ void ThreadPool::run(
     return;
   }
 
+  if (work_stealing_) {
+    // The scheduler handles concurrent and nested calls itself. Point nested
+    // calls on worker threads back at this pool.
+    work_stealing_->run(
+        [this, &fn](size_t i) {
+          ThreadPoolGuard guard(this);
+          fn(i);
+        },
+        range);
+    return;
+  }
+
   std::lock_guard<std::mutex> lock{mutex_};
 
   ET_CHECK_MSG(!NoThreadPoolGuard::is_enabled(), "Inside a threadpool guard!");
@@ -96,6 +239,9 @@ void ThreadPool::run(
 // get_threadpool is not thread safe due to leak_corrupted_threadpool
 // Make this part threadsafe: TODO(kimishpatel)
 ThreadPool* get_threadpool() {
+  if (ThreadPool* const scoped = ThreadPoolGuard::current()) {
+    return scoped;
+  }
   ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo initialization failed");
   int num_threads = cpuinfo_get_processors_count();
   /*
@@ -138,4 +284,17 @@ pthreadpool_t get_pthreadpool() {
   return threadpool->threadpool_.get();
 }
 
+ThreadPool* get_efficiency_threadpool() {
+  static auto threadpool = []() -> std::unique_ptr<ThreadPool> {
+    if (cpuinfo::get_cpus(cpuinfo::CoreType::Efficiency).empty()) {
+      return nullptr;
+    }
+    return std::make_unique<ThreadPool>(
+        0,
+        ThreadPool::Scheduler::Pthreadpool,
+        ThreadPool::Affinity::Efficiency);
+  }();
+  return threadpool.get();
+}
+
 } // namespace executorch::extension::threadpool
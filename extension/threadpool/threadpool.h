@@ -8,17 +8,64 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <pthreadpool.h>
 
+#include <executorch/extension/threadpool/work_stealing_scheduler.h>
+
 namespace executorch::extension::threadpool {
 
 class ThreadPool final {
  public:
-  explicit ThreadPool(size_t thread_count = 0);
+  /**
+   * How run() spreads tasks across threads.
+   */
+  enum class Scheduler {
+    /// Hand each call to pthreadpool. Calls from different threads take
+    /// turns, and calls made from inside a task run on the calling thread.
+    Pthreadpool,
+    /// Use a WorkStealingScheduler. Calls from different threads run at the
+    /// same time, and calls made from inside a task run in parallel too.
+    WorkStealing,
+  };
+
+  /**
+   * Which processors the pool's threads may run on. See
+   * cpuinfo::get_cpus() for how cores are classified.
+   */
+  enum class Affinity {
+    /// Let the OS place the threads.
+    Any,
+    /// Pin the threads to the performance cores, so that latency-sensitive
+    /// work doesn't migrate to slow cores.
+    Performance,
+    /// Pin the threads to the efficiency cores, for background work that
+    /// shouldn't compete with the performance cores.
+    Efficiency,
+  };
+
+  /// How idle threads wait for tasks. See WorkStealingScheduler::WaitPolicy.
+  using WaitPolicy = WorkStealingScheduler::WaitPolicy;
+
+  /**
+   * @param[in] thread_count The number of threads that run tasks, including
+   *     the thread that calls run(). If 0, one per processor, or one per
+   *     processor in `affinity` if the pool is pinned.
+   * @param[in] scheduler How run() spreads tasks across threads.
+   * @param[in] affinity Which processors the pool's threads may run on. The
+   *     thread that calls run() keeps its own affinity; pin it with
+   *     cpuinfo::set_thread_affinity() if needed.
+   */
+  explicit ThreadPool(
+      size_t thread_count = 0,
+      Scheduler scheduler = Scheduler::Pthreadpool,
+      Affinity affinity = Affinity::Any);
   ~ThreadPool() = default;
 
   // Make threadpool non copyable
@@ -46,18 +93,81 @@ class ThreadPool final {
   [[deprecated("This API is experimental and may change without notice.")]]
   bool _unsafe_reset_threadpool(uint32_t num_threads);
 
+  /**
+   * INTERNAL: Switches the scheduler that run() uses. Like
+   * _unsafe_reset_threadpool(), this is not thread safe and must not be
+   * called while run() is running on another thread.
+   */
+  [[deprecated("This API is experimental and may change without notice.")]]
+  void _unsafe_set_scheduler(Scheduler scheduler);
+
+  /**
+   * INTERNAL: Re-creates the pool's threads with the given affinity, keeping
+   * their number. Like _unsafe_reset_threadpool(), this is not thread safe.
+   *
+   * @returns false if the threads couldn't be pinned, in which case the OS
+   *     places them.
+   */
+  [[deprecated("This API is experimental and may change without notice.")]]
+  bool _unsafe_set_affinity(Affinity affinity);
+
+  /// Returns the scheduler that run() uses.
+  Scheduler scheduler() const {
+    return work_stealing_ ? Scheduler::WorkStealing : Scheduler::Pthreadpool;
+  }
+
+  /// Returns the affinity the pool was asked for.
+  Affinity affinity() const {
+    return affinity_;
+  }
+
+  /**
+   * Returns the OS ids of the processors the pool's threads are pinned to, or
+   * an empty vector if the OS places them.
+   */
+  const std::vector<uint32_t>& cpus() const {
+    return cpus_;
+  }
+
+  /**
+   * Sets how idle threads wait for the next run() call. Only the WorkStealing
+   * scheduler follows the policy: pthreadpool's threads always spin for a
+   * fixed number of iterations before sleeping.
+   */
+  void set_wait_policy(const WaitPolicy& policy);
+
+  /// Returns how idle threads wait for the next run() call.
+  WaitPolicy wait_policy() const;
+
+  /**
+   * Keeps idle threads from sleeping between run() calls until a matching
+   * let_workers_sleep() call, for loops that call run() every few
+   * milliseconds. Calls nest, and are thread-safe. See KeepWorkersHotGuard
+   * in threadpool_guard.h for a scoped version.
+   */
+  void keep_workers_hot();
+
+  /// Undoes one keep_workers_hot() call.
+  void let_workers_sleep();
+
   /**
    * Run, in parallel, function fn(task_id) over task_id in range [0, range).
    * This function is blocking.  All input is processed by the time it returns.
    * NoThreadPoolGuard (see threadpool_guard.h) can used to disable use of
    * multiple threads with the scope of the guard When NoThreadPoolGuard is not
-   * used all calls to run method are serialized.
+   * used all calls to run method are serialized, unless the pool uses the
+   * WorkStealing scheduler.
    */
   void run(const std::function<void(size_t)>& fn, size_t range);
 
  private:
   friend pthreadpool_t get_pthreadpool();
 
+  /// Creates a WorkStealingScheduler that follows the pool's wait policy and
+  /// keep_workers_hot() calls.
+  std::unique_ptr<WorkStealingScheduler> make_work_stealing(
+      size_t thread_count) const;
+
  private:
   // This mutex is used inside get_thread_count API but it is not really needed
   // since data members of ThreadPool objects are not really mutable.
@@ -65,10 +175,18 @@ class ThreadPool final {
   // which case this mutex will be useful. Otherwise remove it.
   mutable std::mutex mutex_;
   std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool_;
+  // Non-null when run() uses the WorkStealing scheduler.
+  std::unique_ptr<WorkStealingScheduler> work_stealing_;
+  Affinity affinity_;
+  std::vector<uint32_t> cpus_;
+  WaitPolicy wait_policy_;
+  std::atomic<size_t> num_hot_holds_{0};
 };
 
 /**
- * Returns the singleton instance of ThreadPool for ATen/TH multithreading.
+ * Returns the singleton instance of ThreadPool for ATen/TH multithreading, or
+ * the pool installed on the calling thread by a ThreadPoolGuard (see
+ * threadpool_guard.h).
  */
 ThreadPool* get_threadpool();
 
@@ -80,6 +198,13 @@ ThreadPool* get_threadpool();
  */
 pthreadpool_t get_pthreadpool();
 
+/**
+ * Returns a ThreadPool pinned to the efficiency cores, for background work,
+ * or nullptr if there are no efficiency cores. Use a ThreadPoolGuard (see
+ * threadpool_guard.h) to run code on it.
+ */
+ThreadPool* get_efficiency_threadpool();
+
 } // namespace executorch::extension::threadpool
 
 namespace torch::executorch::threadpool { // DEPRECATED
@@ -8,6 +8,8 @@
 
 #include <executorch/extension/threadpool/threadpool_guard.h>
 
+#include <executorch/extension/threadpool/threadpool.h>
+
 namespace executorch::extension::threadpool {
 
 thread_local bool NoThreadPoolGuard_enabled = false;
@@ -20,4 +22,27 @@ void NoThreadPoolGuard::set_enabled(bool enabled) {
   NoThreadPoolGuard_enabled = enabled;
 }
 
+thread_local ThreadPool* ThreadPoolGuard_threadpool = nullptr;
+
+ThreadPool* ThreadPoolGuard::current() {
+  return ThreadPoolGuard_threadpool;
+}
+
+void ThreadPoolGuard::set_current(ThreadPool* threadpool) {
+  ThreadPoolGuard_threadpool = threadpool;
+}
+
+KeepWorkersHotGuard::KeepWorkersHotGuard(ThreadPool* threadpool)
+    : threadpool_(threadpool) {
+  if (threadpool_ != nullptr) {
+    threadpool_->keep_workers_hot();
+  }
+}
+
+KeepWorkersHotGuard::~KeepWorkersHotGuard() {
+  if (threadpool_ != nullptr) {
+    threadpool_->let_workers_sleep();
+  }
+}
+
 } // namespace executorch::extension::threadpool
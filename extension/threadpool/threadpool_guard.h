@@ -10,6 +10,8 @@
 
 namespace executorch::extension::threadpool {
 
+class ThreadPool;
+
 // A RAII, thread local (!) guard that enables or disables guard upon
 // construction, and sets it back to the original value upon destruction.
 struct NoThreadPoolGuard {
@@ -27,6 +29,52 @@ struct NoThreadPoolGuard {
   const bool prev_mode_;
 };
 
+// A RAII, thread local (!) guard that makes get_threadpool() and
+// get_pthreadpool() return the given pool on the current thread instead of
+// the global one, until destruction. Guards nest; the innermost one wins. Use
+// it to keep the kernels of one model on a dedicated pool, e.g. one sized for
+// the big cores, while other threads keep using the global pool.
+//
+// Tasks that a WorkStealing pool runs on its own threads see that pool too,
+// so nested parallel_for() calls stay in it. NoThreadPoolGuard still takes
+// precedence. XNNPACK picks its pthreadpool when a delegate is initialized,
+// so the guard must also be active while loading methods that use it.
+struct ThreadPoolGuard {
+  // Returns the pool installed by the innermost guard on this thread, or
+  // nullptr.
+  static ThreadPool* current();
+  static void set_current(ThreadPool* threadpool);
+
+  explicit ThreadPoolGuard(ThreadPool* threadpool)
+      : prev_threadpool_(ThreadPoolGuard::current()) {
+    ThreadPoolGuard::set_current(threadpool);
+  }
+  ~ThreadPoolGuard() {
+    ThreadPoolGuard::set_current(prev_threadpool_);
+  }
+
+  ThreadPoolGuard(const ThreadPoolGuard&) = delete;
+  ThreadPoolGuard& operator=(const ThreadPoolGuard&) = delete;
+
+ private:
+  ThreadPool* const prev_threadpool_;
+};
+
+// A RAII guard that keeps the idle threads of a pool from sleeping until
+// destruction (see ThreadPool::keep_workers_hot()). Hold one around loops
+// that call run() every few milliseconds, like LLM token generation, to trade
+// some power for lower wakeup latency. A null pool is ignored.
+struct KeepWorkersHotGuard {
+  explicit KeepWorkersHotGuard(ThreadPool* threadpool);
+  ~KeepWorkersHotGuard();
+
+  KeepWorkersHotGuard(const KeepWorkersHotGuard&) = delete;
+  KeepWorkersHotGuard& operator=(const KeepWorkersHotGuard&) = delete;
+
+ private:
+  ThreadPool* const threadpool_;
+};
+
 } // namespace executorch::extension::threadpool
 
 namespace torch::executorch::threadpool { // DEPRECATED
@@ -34,4 +82,5 @@ namespace torch::executorch::threadpool { // DEPRECATED
 // to the new `::executorch` namespaces. Note that threadpool incorrectly used
 // the namespace `torch::executorch` instead of `torch::executor`.
 using ::executorch::extension::threadpool::NoThreadPoolGuard; // DEPRECATED
+using ::executorch::extension::threadpool::ThreadPoolGuard; // DEPRECATED
 } // namespace torch::executorch::threadpool
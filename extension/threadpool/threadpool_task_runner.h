@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/runtime/executor/parallel_task_runner.h>
+
+namespace executorch::extension::threadpool {
+
+/**
+ * A ParallelTaskRunner that runs tasks on a ThreadPool. Pass one to
+ * `Method::set_parallel_execution()` to run independent instructions on the
+ * threadpool.
+ *
+ * Tasks run inside a NoThreadPoolGuard, so kernels that call parallel_for()
+ * from within a task run their work on the calling worker thread.
+ */
+class ThreadPoolTaskRunner final
+    : public ::executorch::runtime::ParallelTaskRunner {
+ public:
+  /**
+   * @param[in] threadpool The threadpool to run tasks on. Must outlive this
+   *     object. Defaults to the global threadpool.
+   */
+  explicit ThreadPoolTaskRunner(ThreadPool* threadpool = get_threadpool())
+      : threadpool_(threadpool) {}
+
+  void run(TaskFn fn, void* context, size_t num_tasks) override {
+    threadpool_->run([fn, context](size_t i) { fn(context, i); }, num_tasks);
+  }
+
+ private:
+  ThreadPool* threadpool_;
+};
+
+} // namespace executorch::extension::threadpool
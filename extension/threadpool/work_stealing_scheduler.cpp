@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/threadpool/work_stealing_scheduler.h>
+
+namespace executorch::extension::threadpool {
+
+namespace {
+// The scheduler that owns the current thread, if it's a worker, and the
+// index of the worker's queue.
+thread_local const WorkStealingScheduler* current_scheduler = nullptr;
+thread_local size_t current_queue = 0;
+} // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(size_t num_threads) {
+  const size_t num_workers = num_threads > 1 ? num_threads - 1 : 0;
+  queues_.reserve(num_workers + 1);
+  for (size_t i = 0; i < num_workers + 1; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this, i]() { worker_loop(i); });
+  }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkStealingScheduler::run(
+    const std::function<void(size_t)>& fn,
+    size_t range) {
+  if (workers_.empty() || range <= 1) {
+    for (size_t i = 0; i < range; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  const size_t q =
+      current_scheduler == this ? current_queue : queues_.size() - 1;
+  Job job{&fn, range};
+  execute(q, Task{&job, 0, range});
+
+  // Help with what is left of this job until every index has finished. Tasks
+  // of other jobs are left alone, so that a task waiting here never has to
+  // wait for a task that is stuck below it on the same stack.
+  Task task;
+  while (job.pending.load(std::memory_order_acquire) != 0) {
+    if (pop(q, &job, task) || steal(q, &job, task)) {
+      execute(q, task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void WorkStealingScheduler::set_wait_policy(const WaitPolicy& policy) {
+  spin_us_.store(policy.spin.count(), std::memory_order_relaxed);
+  yield_us_.store(policy.yield.count(), std::memory_order_relaxed);
+}
+
+WorkStealingScheduler::WaitPolicy WorkStealingScheduler::wait_policy() const {
+  return WaitPolicy{
+      std::chrono::microseconds(spin_us_.load(std::memory_order_relaxed)),
+      std::chrono::microseconds(yield_us_.load(std::memory_order_relaxed))};
+}
+
+void WorkStealingScheduler::keep_workers_hot() {
+  if (num_hot_holds_.fetch_add(1) == 0 && num_sleeping_.load() != 0) {
+    // Wake the sleeping workers so that they are hot for the next call.
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    wake_.notify_all();
+  }
+}
+
+void WorkStealingScheduler::let_workers_sleep() {
+  num_hot_holds_.fetch_sub(1);
+}
+
+void WorkStealingScheduler::push(size_t q, const Task& task) {
+  {
+    std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+    queues_[q]->tasks.push_back(task);
+  }
+  num_queued_.fetch_add(1);
+  if (num_sleeping_.load() != 0) {
+    // Taking the lock orders this with a worker that is about to sleep.
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    wake_.notify_one();
+  }
+}
+
+bool WorkStealingScheduler::pop(size_t q, const Job* job, Task& task) {
+  Queue& queue = *queues_[q];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  for (auto it = queue.tasks.rbegin(); it != queue.tasks.rend(); ++it) {
+    if (job == nullptr || it->job == job) {
+      task = *it;
+      queue.tasks.erase(std::next(it).base());
+      num_queued_.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WorkStealingScheduler::steal(size_t q, const Job* job, Task& task) {
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    Queue& queue = *queues_[(q + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (auto it = queue.tasks.begin(); it != queue.tasks.end(); ++it) {
+      if (job == nullptr || it->job == job) {
+        task = *it;
+        queue.tasks.erase(it);
+        num_queued_.fetch_sub(1);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void WorkStealingScheduler::execute(size_t q, Task task) {
+  // Keep the lower half and offer the upper half to other threads, so that
+  // thieves take the largest pieces of work.
+  while (task.end - task.begin > 1) {
+    const size_t mid = task.begin + (task.end - task.begin) / 2;
+    push(q, Task{task.job, mid, task.end});
+    task.end = mid;
+  }
+  (*task.job->fn)(task.begin);
+  task.job->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void WorkStealingScheduler::worker_loop(size_t q) {
+  current_scheduler = this;
+  current_queue = q;
+  Task task;
+  while (true) {
+    if (pop(q, nullptr, task) || steal(q, nullptr, task)) {
+      execute(q, task);
+      continue;
+    }
+    if (!wait_for_tasks()) {
+      return;
+    }
+  }
+}
+
+bool WorkStealingScheduler::wait_for_tasks() {
+  using Clock = std::chrono::steady_clock;
+  const WaitPolicy policy = wait_policy();
+  const Clock::time_point spin_until = Clock::now() + policy.spin;
+  const Clock::time_point yield_until = spin_until + policy.yield;
+  while (num_queued_.load() == 0) {
+    if (stop_.load()) {
+      return false;
+    }
+    const Clock::time_point now = Clock::now();
+    if (now < spin_until) {
+      continue;
+    }
+    if (now < yield_until || num_hot_holds_.load() != 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    num_sleeping_.fetch_add(1);
+    wake_.wait(lock, [this]() {
+      return stop_.load() || num_queued_.load() != 0 ||
+          num_hot_holds_.load() != 0;
+    });
+    num_sleeping_.fetch_sub(1);
+    return !stop_.load();
+  }
+  return !stop_.load();
+}
+
+} // namespace executorch::extension::threadpool
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace executorch::extension::threadpool {
+
+/**
+ * A pool of worker threads that share work by stealing it from each other.
+ *
+ * Each call to run() splits its range in halves: the calling thread keeps
+ * working on one half and queues the other, where idle threads can steal it
+ * and split it further. Unlike pthreadpool, calls don't have to take turns:
+ * several threads can call run() at the same time, and a task may call run()
+ * again to parallelize an inner loop. A thread waiting in run() only helps
+ * with tasks of its own call, which keeps nested calls deadlock-free.
+ */
+class WorkStealingScheduler final {
+ public:
+  /**
+   * How an idle worker waits for tasks: it busy-waits for `spin`, then yields
+   * its time slice until `spin + yield` has passed, then sleeps until woken.
+   * Spinning and yielding cost power, but cut the latency of the next run()
+   * call, which matters when calls come every few milliseconds.
+   */
+  struct WaitPolicy {
+    std::chrono::microseconds spin{0};
+    std::chrono::microseconds yield{0};
+  };
+
+  /**
+   * Starts the worker threads.
+   *
+   * @param[in] num_threads The number of threads that run tasks, including
+   *     the thread that calls run(). At most num_threads - 1 threads are
+   *     started.
+   */
+  explicit WorkStealingScheduler(size_t num_threads);
+
+  /// Stops and joins the worker threads. run() must not be running.
+  ~WorkStealingScheduler();
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler(WorkStealingScheduler&&) = delete;
+  WorkStealingScheduler& operator=(WorkStealingScheduler&&) = delete;
+
+  /// Returns the number of threads that run tasks, including the caller.
+  size_t num_threads() const {
+    return workers_.size() + 1;
+  }
+
+  /**
+   * Runs fn(i) for every i in [0, range), in parallel, and returns once all
+   * of them have finished. Thread-safe, and may be called from inside `fn`.
+   */
+  void run(const std::function<void(size_t)>& fn, size_t range);
+
+  /// Sets how idle workers wait for tasks. Thread-safe; workers that are
+  /// already asleep stay asleep until the next task arrives.
+  void set_wait_policy(const WaitPolicy& policy);
+
+  /// Returns how idle workers wait for tasks.
+  WaitPolicy wait_policy() const;
+
+  /**
+   * Keeps idle workers from sleeping until a matching let_workers_sleep()
+   * call: they spin for the policy's `spin`, then keep yielding. Calls nest,
+   * and are thread-safe.
+   */
+  void keep_workers_hot();
+
+  /// Undoes one keep_workers_hot() call.
+  void let_workers_sleep();
+
+ private:
+  struct Job {
+    const std::function<void(size_t)>* fn;
+    /// The number of indices that haven't finished running.
+    std::atomic<size_t> pending;
+  };
+
+  struct Task {
+    Job* job;
+    size_t begin;
+    size_t end;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /// Adds a task to the back of queue `q`, and wakes a worker if any sleep.
+  void push(size_t q, const Task& task);
+
+  /// Takes the newest task from the back of queue `q`. If `job` is non-null,
+  /// only takes tasks of that job.
+  bool pop(size_t q, const Job* job, Task& task);
+
+  /// Takes the oldest task from the front of some queue other than `q`. If
+  /// `job` is non-null, only takes tasks of that job.
+  bool steal(size_t q, const Job* job, Task& task);
+
+  /// Runs `task`, queueing halves of it on queue `q` until one index is left.
+  void execute(size_t q, Task task);
+
+  void worker_loop(size_t q);
+
+  /// Waits according to the wait policy until a task may be queued. Returns
+  /// false if the scheduler is stopping.
+  bool wait_for_tasks();
+
+  /// One queue per worker, then one shared by threads outside the pool.
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<size_t> num_queued_{0};
+  std::atomic<size_t> num_sleeping_{0};
+  std::atomic<bool> stop_{false};
+
+  std::atomic<int64_t> spin_us_{0};
+  std::atomic<int64_t> yield_us_{0};
+  std::atomic<size_t> num_hot_holds_{0};
+};
+
+} // namespace executorch::extension::threadpool
@@ -153,3 +153,96 @@ TEST_F(TrainingModuleTest, SeperateDataTest) {
   ASSERT_EQ(res.error(), Error::Ok);
   ASSERT_EQ(res.get().size(), 1);
 }
+
+TEST_F(TrainingModuleTest, GradientAccumulationTest) {
+  const char* path = std::getenv("ET_MODULE_SIMPLE_TRAIN_PATH");
+  executorch::runtime::Result<torch::executor::util::FileDataLoader>
+      loader_res = torch::executor::util::FileDataLoader::from(path);
+  ASSERT_EQ(loader_res.error(), Error::Ok);
+  auto loader = std::make_unique<torch::executor::util::FileDataLoader>(
+      std::move(loader_res.get()));
+
+  auto mod = executorch::extension::training::TrainingModule(std::move(loader));
+
+  ASSERT_EQ(
+      mod.step_every("forward", 0, [](const auto&) { return Error::Ok; }),
+      Error::InvalidArgument);
+
+  int num_steps = 0;
+  std::vector<float> stepped_weight_grad;
+  ASSERT_EQ(
+      mod.step_every(
+          "forward",
+          2,
+          [&](const std::map<executorch::aten::string_view, Tensor>&
+                  named_gradients) {
+            ++num_steps;
+            const auto& grad = named_gradients.at("linear.weight");
+            stepped_weight_grad.assign(
+                grad.const_data_ptr<float>(),
+                grad.const_data_ptr<float>() + grad.numel());
+            return Error::Ok;
+          }),
+      Error::Ok);
+  ASSERT_EQ(
+      mod.accumulated_gradients("forward").error(), Error::InvalidArgument);
+
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.make({3}, {1.0, 1.0, 1.0});
+  Tensor label = tf.make({3}, {1.0, 0.0, 0.0});
+
+  std::vector<executorch::runtime::EValue> inputs;
+  inputs.push_back(input);
+  inputs.push_back(label);
+
+  ASSERT_EQ(mod.execute_forward_backward("forward", inputs).error(), Error::Ok);
+  ASSERT_EQ(num_steps, 0);
+  ASSERT_EQ(mod.execute_forward_backward("forward", inputs).error(), Error::Ok);
+  ASSERT_EQ(num_steps, 1);
+
+  // The parameters didn't change between the micro-batches, so the mean of
+  // their gradients is the gradient of either.
+  auto grad_res = mod.named_gradients("forward");
+  ASSERT_EQ(grad_res.error(), Error::Ok);
+  const auto& grad = grad_res.get().at("linear.weight");
+  ASSERT_EQ(stepped_weight_grad.size(), grad.numel());
+  for (size_t i = 0; i < stepped_weight_grad.size(); ++i) {
+    EXPECT_FLOAT_EQ(stepped_weight_grad[i], grad.const_data_ptr<float>()[i]);
+  }
+
+  auto accumulated_res = mod.accumulated_gradients("forward");
+  ASSERT_EQ(accumulated_res.error(), Error::Ok);
+  const auto& accumulated = accumulated_res.get();
+  ASSERT_EQ(accumulated.size(), 2);
+  EXPECT_NE(
+      accumulated.at("linear.weight").const_data_ptr(), grad.const_data_ptr());
+}
+
+TEST_F(TrainingModuleTest, MemoryBudgetWithoutVariantsTest) {
+  const char* path = std::getenv("ET_MODULE_SIMPLE_TRAIN_PATH");
+  executorch::runtime::Result<torch::executor::util::FileDataLoader>
+      loader_res = torch::executor::util::FileDataLoader::from(path);
+  ASSERT_EQ(loader_res.error(), Error::Ok);
+  auto loader = std::make_unique<torch::executor::util::FileDataLoader>(
+      std::move(loader_res.get()));
+
+  auto mod = executorch::extension::training::TrainingModule(std::move(loader));
+  // The method wasn't exported with checkpointed variants, so it runs as is
+  // whatever the budget.
+  mod.set_memory_budget(1);
+
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.make({3}, {1.0, 1.0, 1.0});
+  Tensor label = tf.make({3}, {1.0, 0.0, 0.0});
+
+  std::vector<executorch::runtime::EValue> inputs;
+  inputs.push_back(input);
+  inputs.push_back(label);
+
+  auto res = mod.execute_forward_backward("forward", inputs);
+  ASSERT_EQ(res.error(), Error::Ok);
+  ASSERT_EQ(res.get().size(), 1);
+  auto param_res = mod.named_parameters("forward");
+  ASSERT_EQ(param_res.error(), Error::Ok);
+  ASSERT_EQ(param_res.get().size(), 2);
+}
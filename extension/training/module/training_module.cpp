@@ -8,6 +8,10 @@
 
 #include <executorch/extension/training/module/training_module.h>
 
+#include <cinttypes>
+
+#include <executorch/extension/tensor/tensor_ptr_maker.h>
+
 namespace executorch {
 namespace extension {
 namespace training {
@@ -16,15 +20,93 @@ namespace {
 std::string gradients_method_prefix = "__et_training_gradients_index_";
 std::string parameters_method_prefix = "__et_training_parameters_index_";
 std::string fqn_method_prefix = "__et_training_fqn_";
+std::string checkpointed_methods_prefix = "__et_training_checkpointed_methods_";
 } // namespace
 
+runtime::Result<std::string> TrainingModule::resolve_method_name(
+    const std::string& method_name) {
+  auto resolved = resolved_method_names_.find(method_name);
+  if (resolved != resolved_method_names_.end()) {
+    return resolved->second;
+  }
+
+  std::string resolved_name = method_name;
+  const std::string checkpointed_methods_name =
+      checkpointed_methods_prefix + method_name;
+  bool has_variants = false;
+  if (memory_budget_ > 0) {
+    auto method_names = executorch::extension::Module::method_names();
+    if (!method_names.ok()) {
+      return method_names.error();
+    }
+    has_variants = method_names->count(checkpointed_methods_name) != 0;
+  }
+  if (has_variants) {
+    auto checkpointed_res =
+        executorch::extension::Module::execute(checkpointed_methods_name);
+    if (!checkpointed_res.ok()) {
+      return checkpointed_res.error();
+    }
+    std::vector<std::string> candidates = {method_name};
+    for (const auto& name : checkpointed_res.get()) {
+      const auto name_view = name.toString();
+      candidates.emplace_back(name_view.data(), name_view.size());
+    }
+
+    // Among the variants that fit, prefer the one with the most memory, since
+    // it recomputes the least. If none fit, take the smallest.
+    int64_t best_nbytes = -1;
+    bool best_fits = false;
+    for (const auto& candidate : candidates) {
+      auto meta = executorch::extension::Module::method_meta(candidate);
+      if (!meta.ok()) {
+        return meta.error();
+      }
+      int64_t nbytes = 0;
+      for (size_t i = 0; i < meta->num_memory_planned_buffers(); ++i) {
+        auto size = meta->memory_planned_buffer_size(i);
+        if (!size.ok()) {
+          return size.error();
+        }
+        nbytes += size.get();
+      }
+      const bool fits = static_cast<uint64_t>(nbytes) <= memory_budget_;
+      const bool better = fits ? !best_fits || nbytes > best_nbytes
+                               : !best_fits && nbytes < best_nbytes;
+      if (best_nbytes < 0 || better) {
+        resolved_name = candidate;
+        best_nbytes = nbytes;
+        best_fits = fits;
+      }
+    }
+    if (!best_fits) {
+      ET_LOG(
+          Info,
+          "No variant of method %s fits a budget of %zu bytes, running %s "
+          "with %" PRId64 " bytes",
+          method_name.c_str(),
+          memory_budget_,
+          resolved_name.c_str(),
+          best_nbytes);
+    }
+  }
+  resolved_method_names_.insert({method_name, resolved_name});
+  return resolved_name;
+}
+
 runtime::Result<std::vector<runtime::EValue>>
 TrainingModule::execute_forward_backward(
     const std::string& method_name,
     const std::vector<runtime::EValue>& input) {
+  auto resolved = resolve_method_name(method_name);
+  if (!resolved.ok()) {
+    return resolved.error();
+  }
+  const std::string& resolved_name = resolved.get();
+
   // Find where the user outputs end.
   const std::string gradients_method_name =
-      gradients_method_prefix + method_name;
+      gradients_method_prefix + resolved_name;
   auto res = executorch::extension::Module::execute(gradients_method_name);
   if (!res.ok()) {
     return res.error();
@@ -32,7 +114,7 @@ TrainingModule::execute_forward_backward(
   uint64_t grad_start = res.get()[0].toInt();
 
   const std::string parameters_method_name =
-      parameters_method_prefix + method_name;
+      parameters_method_prefix + resolved_name;
   // get params start.
   auto param_res =
       executorch::extension::Module::execute(parameters_method_name);
@@ -43,7 +125,7 @@ TrainingModule::execute_forward_backward(
   uint64_t param_start = param_res.get()[0].toInt();
 
   // Execute the forward and backward pass.
-  auto outputs = torch::executor::Module::execute(method_name, input);
+  auto outputs = torch::executor::Module::execute(resolved_name, input);
   if (!outputs.ok()) {
     return outputs.error();
   }
@@ -66,7 +148,7 @@ TrainingModule::execute_forward_backward(
     auto& gradients_map = method_named_gradients_.at(method_name);
 
     // Get names if we havent seen this method before.
-    const std::string fqn_method_name = fqn_method_prefix + method_name;
+    const std::string fqn_method_name = fqn_method_prefix + resolved_name;
     auto fqn_res = executorch::extension::Module::execute(fqn_method_name);
     if (!fqn_res.ok()) {
       return fqn_res.error();
@@ -84,6 +166,15 @@ TrainingModule::execute_forward_backward(
     }
   }
 
+  auto accumulation = method_gradient_accumulations_.find(method_name);
+  if (accumulation != method_gradient_accumulations_.end()) {
+    auto e = accumulate_gradients(
+        accumulation->second, method_named_gradients_.at(method_name));
+    if (e != runtime::Error::Ok) {
+      return e;
+    }
+  }
+
   return user_outputs;
 }
 
@@ -93,9 +184,14 @@ TrainingModule::named_parameters(const std::string& method_name) {
   // If we haven't seen this method before, populate the dict.
   if (method_named_parameters_.find(method_name) ==
       method_named_parameters_.end()) {
-    const std::string fqn_method_name = fqn_method_prefix + method_name;
+    auto resolved = resolve_method_name(method_name);
+    if (!resolved.ok()) {
+      return resolved.error();
+    }
+    const std::string& resolved_name = resolved.get();
+    const std::string fqn_method_name = fqn_method_prefix + resolved_name;
     const std::string parameters_method_name =
-        parameters_method_prefix + method_name;
+        parameters_method_prefix + resolved_name;
 
     method_named_parameters_.insert({method_name, {}});
 
@@ -116,11 +212,11 @@ TrainingModule::named_parameters(const std::string& method_name) {
     uint64_t param_start = param_res.get()[0].toInt();
 
     // Load the method if it is not already loaded.
-    auto e = executorch::extension::Module::load_method(method_name);
+    auto e = executorch::extension::Module::load_method(resolved_name);
     if (e != runtime::Error::Ok) {
       return e;
     }
-    auto& method = methods_.at(method_name).method;
+    auto& method = methods_.at(resolved_name).method;
 
     // populate dict
     size_t name_index = 0;
@@ -146,6 +242,94 @@ TrainingModule::named_gradients(const std::string& method_name) {
   return method_named_gradients_.at(method_name);
 }
 
+runtime::Error TrainingModule::step_every(
+    const std::string& method_name,
+    size_t num_micro_batches,
+    StepFn step) {
+  ET_CHECK_OR_RETURN_ERROR(
+      num_micro_batches > 0,
+      InvalidArgument,
+      "Need at least one micro-batch per step");
+  ET_CHECK_OR_RETURN_ERROR(
+      step != nullptr,
+      InvalidArgument,
+      "No step for method %s",
+      method_name.c_str());
+  GradientAccumulation accumulation;
+  accumulation.num_micro_batches = num_micro_batches;
+  accumulation.step = std::move(step);
+  method_gradient_accumulations_[method_name] = std::move(accumulation);
+  return runtime::Error::Ok;
+}
+
+runtime::Result<
+    const std::map<executorch::aten::string_view, executorch::aten::Tensor>>
+TrainingModule::accumulated_gradients(const std::string& method_name) {
+  auto accumulation = method_gradient_accumulations_.find(method_name);
+  if (accumulation == method_gradient_accumulations_.end() ||
+      accumulation->second.buffers.empty()) {
+    ET_LOG(
+        Error,
+        "No accumulated gradients found for method %s",
+        method_name.c_str());
+    return executorch::runtime::Error::InvalidArgument;
+  }
+  return accumulation->second.named_gradients;
+}
+
+runtime::Error TrainingModule::accumulate_gradients(
+    GradientAccumulation& accumulation,
+    const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+        gradients) {
+  if (accumulation.num_micro_batches == 1) {
+    return accumulation.step(gradients);
+  }
+  // Allocate the buffers on the first micro-batch, once the gradients are
+  // known.
+  if (accumulation.buffers.empty()) {
+    for (const auto& named_gradient : gradients) {
+      const auto& gradient = named_gradient.second;
+      ET_CHECK_OR_RETURN_ERROR(
+          gradient.scalar_type() == executorch::aten::ScalarType::Float,
+          NotSupported,
+          "Only float gradients can be accumulated");
+      accumulation.buffers.push_back(empty_strided(
+          {gradient.sizes().begin(), gradient.sizes().end()},
+          {gradient.strides().begin(), gradient.strides().end()},
+          gradient.scalar_type()));
+      accumulation.named_gradients.insert(
+          {named_gradient.first, *accumulation.buffers.back()});
+    }
+  }
+
+  // The first micro-batch overwrites what was left from the last step, so the
+  // buffers never need to be cleared.
+  const bool first = accumulation.micro_batch == 0;
+  const float scale = 1.0f / accumulation.num_micro_batches;
+  for (const auto& named_gradient : gradients) {
+    const auto& gradient = named_gradient.second;
+    auto& accumulated = accumulation.named_gradients.at(named_gradient.first);
+    const float* src = gradient.const_data_ptr<float>();
+    float* dst = accumulated.mutable_data_ptr<float>();
+    const size_t numel = gradient.numel();
+    if (first) {
+      for (size_t i = 0; i < numel; ++i) {
+        dst[i] = src[i] * scale;
+      }
+    } else {
+      for (size_t i = 0; i < numel; ++i) {
+        dst[i] += src[i] * scale;
+      }
+    }
+  }
+
+  if (++accumulation.micro_batch < accumulation.num_micro_batches) {
+    return runtime::Error::Ok;
+  }
+  accumulation.micro_batch = 0;
+  return accumulation.step(accumulation.named_gradients);
+}
+
 } // namespace training
 } // namespace extension
 } // namespace executorch
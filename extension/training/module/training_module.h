@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -15,6 +17,7 @@
 #include <vector>
 
 #include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor_ptr.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/executor/program.h>
 
@@ -44,6 +47,20 @@ class ET_EXPERIMENTAL TrainingModule final
         method_named_gradients_({}),
         method_named_parameters_({}) {}
 
+  /**
+   * An optimizer step, called with the accumulated gradients by fully
+   * qualified name. For example:
+   *
+   * @code
+   * module.step_every("forward", 4, [&](const auto& named_gradients) {
+   *   return optimizer.step(named_gradients);
+   * });
+   * @endcode
+   */
+  using StepFn = std::function<runtime::Error(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_gradients)>;
+
   explicit TrainingModule(const Module&) = delete;
   TrainingModule& operator=(const Module&) = delete;
   explicit TrainingModule(Module&&) = delete;
@@ -57,14 +74,35 @@ class ET_EXPERIMENTAL TrainingModule final
    * @param[in] method_name The name of the joint graph method to execute.
    * @param[in] input A vector of input values to be passed to the method.
    *
+   * If step_every() was called for the method, the gradients are also
+   * accumulated, and the step is called after the last micro-batch.
+   *
    * @returns A Result object containing the output values from the method or an
-   * error to indicate failure.
+   * error to indicate failure, including one returned by the step.
    */
   ET_EXPERIMENTAL runtime::Result<std::vector<runtime::EValue>>
   execute_forward_backward(
       const std::string& method_name,
       const std::vector<runtime::EValue>& input);
 
+  /**
+   * Sets the memory budget that picks the activation checkpointing plan of
+   * joint graph methods.
+   *
+   * A method exported with activation_checkpointing_plans() has variants that
+   * recompute more activations during the backward pass and need less memory.
+   * The first time the method is executed, the variant with the most memory
+   * planned that fits the budget is picked, or the one with the least memory
+   * if none do, and the method always runs that variant afterwards, along with
+   * its parameters. Methods without variants are unaffected.
+   *
+   * @param[in] memory_budget The number of bytes of memory-planned buffers a
+   * joint graph method may use, or 0 to always run the method as exported.
+   */
+  ET_EXPERIMENTAL void set_memory_budget(size_t memory_budget) {
+    memory_budget_ = memory_budget;
+  }
+
   /**
    * Retrieve the trainable parameters for a joint graph method.
    *
@@ -95,7 +133,77 @@ class ET_EXPERIMENTAL TrainingModule final
       const std::map<executorch::aten::string_view, executorch::aten::Tensor>>
   named_gradients(const std::string& method_name);
 
+  /**
+   * Accumulates the gradients of a joint graph method across micro-batches,
+   * so that the model can be trained with batches bigger than fit in memory.
+   *
+   * Each call to execute_forward_backward() for the method adds its gradients,
+   * divided by `num_micro_batches`, in place into buffers that are allocated
+   * once. After every `num_micro_batches` calls, `step` is called with the
+   * accumulated gradients, and the next call starts over. These are the mean
+   * of the gradients of the micro-batches, so when the loss is a mean, the
+   * step is the one the whole batch would take. Only float gradients are
+   * supported.
+   *
+   * With `num_micro_batches` of 1, nothing is accumulated and `step` is called
+   * with the gradients of every call.
+   *
+   * Calling this again for the method replaces the step and discards any
+   * partially accumulated gradients.
+   *
+   * @param[in] method_name The name of the joint graph method.
+   * @param[in] num_micro_batches The number of micro-batches per step.
+   * @param[in] step The optimizer step to take.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL runtime::Error step_every(
+      const std::string& method_name,
+      size_t num_micro_batches,
+      StepFn step);
+
+  /**
+   * Retrieve the gradients accumulated for a joint graph method. Right after a
+   * step, these are the gradients the step was taken with.
+   *
+   * @param[in] method_name The name of the joint graph method.
+   *
+   * @returns A Result object containing a map of the fully qualified name to
+   * accumulated gradient, or an error if step_every() wasn't called for the
+   * method with more than one micro-batch, or it has not been executed yet.
+   */
+  ET_EXPERIMENTAL
+  runtime::Result<
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>>
+  accumulated_gradients(const std::string& method_name);
+
  private:
+  // Returns the variant of `method_name` that fits memory_budget_.
+  runtime::Result<std::string> resolve_method_name(
+      const std::string& method_name);
+
+  struct GradientAccumulation {
+    size_t num_micro_batches;
+    StepFn step;
+    // The number of micro-batches accumulated since the last step.
+    size_t micro_batch = 0;
+    // Owns the storage of named_gradients.
+    std::vector<TensorPtr> buffers;
+    std::map<executorch::aten::string_view, executorch::aten::Tensor>
+        named_gradients;
+  };
+
+  runtime::Error accumulate_gradients(
+      GradientAccumulation& accumulation,
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          gradients);
+
+  std::unordered_map<std::string, GradientAccumulation>
+      method_gradient_accumulations_;
+
+  size_t memory_budget_ = 0;
+  std::unordered_map<std::string, std::string> resolved_method_names_;
+
   std::unordered_map<
       std::string,
       std::map<executorch::aten::string_view, executorch::aten::Tensor>>
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adamw.h>
+
+#include <cmath>
+
+#include <executorch/runtime/core/error.h>
+
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+namespace {
+
+using internal::load;
+using internal::store;
+using internal::Vec;
+
+/// A parameter that an AdamW step updates, with the coefficients of its step.
+struct AdamWUpdate {
+  float* param;
+  const float* grad;
+  float* exp_avg;
+  float* exp_avg_sq;
+  size_t numel;
+  // 1 - lr * weight_decay.
+  float decay;
+  float beta1;
+  float beta2;
+  // lr / (1 - beta1^step).
+  float step_size;
+  // 1 / sqrt(1 - beta2^step).
+  float inv_sqrt_bias_correction2;
+  float eps;
+};
+
+inline float sqrt_of(float x) {
+  return std::sqrt(x);
+}
+
+inline Vec sqrt_of(const Vec& x) {
+  return x.sqrt();
+}
+
+/// Updates element `i` of the parameter, or the Vec::size() elements from `i`
+/// if `V` is Vec.
+template <typename V>
+inline void adamw_update(const AdamWUpdate& update, size_t i) {
+  const V g = load<V>(update.grad + i);
+  const V exp_avg = load<V>(update.exp_avg + i) * V(update.beta1) +
+      g * V(1 - update.beta1);
+  const V exp_avg_sq = load<V>(update.exp_avg_sq + i) * V(update.beta2) +
+      g * g * V(1 - update.beta2);
+  store(exp_avg, update.exp_avg + i);
+  store(exp_avg_sq, update.exp_avg_sq + i);
+  const V denom =
+      sqrt_of(exp_avg_sq) * V(update.inv_sqrt_bias_correction2) + V(update.eps);
+  const V p = load<V>(update.param + i) * V(update.decay);
+  store(p - V(update.step_size) * exp_avg / denom, update.param + i);
+}
+
+/// Updates the elements [begin, end) of the parameter.
+void adamw_update(const AdamWUpdate& update, size_t begin, size_t end) {
+  size_t i = begin;
+  for (; i + Vec::size() <= end; i += Vec::size()) {
+    adamw_update<Vec>(update, i);
+  }
+  for (; i < end; ++i) {
+    adamw_update<float>(update, i);
+  }
+}
+
+} // namespace
+
+bool AdamWParamGroup::has_options() const {
+  return options_ != nullptr;
+}
+
+AdamWOptions& AdamWParamGroup::options() {
+  return *options_.get();
+}
+
+const AdamWOptions& AdamWParamGroup::options() const {
+  return *options_.get();
+}
+
+void AdamWParamGroup::set_options(std::unique_ptr<AdamWOptions> options) {
+  options_ = std::move(options);
+}
+
+const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+AdamWParamGroup::named_parameters() const {
+  return named_parameters_;
+}
+
+void AdamW::add_param_group(const AdamWParamGroup& param_group) {
+  AdamWParamGroup param_group_(param_group.named_parameters());
+  if (!param_group.has_options()) {
+    param_group_.set_options(defaults_->clone());
+  } else {
+    param_group_.set_options(param_group.options().clone());
+  }
+  param_groups_.emplace_back(std::move(param_group_));
+}
+
+Error AdamW::step(
+    const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+        named_gradients) {
+  // Give every parameter that has a gradient its state before taking any
+  // pointers into the arena.
+  std::vector<std::pair<const void*, size_t>> new_state;
+  for (const auto& group : param_groups_) {
+    for (const auto& named_parameter : group.named_parameters()) {
+      const auto& p = named_parameter.second;
+      if (named_gradients.count(named_parameter.first) != 0) {
+        ET_CHECK_OK_OR_RETURN_ERROR(internal::check_param_and_grad(
+            p, named_gradients.at(named_parameter.first)));
+        new_state.emplace_back(p.unsafeGetTensorImpl(), p.numel());
+      }
+    }
+  }
+  state_.add(new_state);
+
+  std::vector<AdamWUpdate> updates;
+  std::vector<size_t> numels;
+  for (const auto& group : param_groups_) {
+    const auto& options = group.options();
+    for (const auto& named_parameter : group.named_parameters()) {
+      // if param name and gradient name match, run the optimizer step
+      const auto& named_gradient = named_gradients.find(named_parameter.first);
+      if (named_gradient == named_gradients.end()) {
+        continue;
+      }
+      const auto& p = named_parameter.second;
+      const void* key = p.unsafeGetTensorImpl();
+      const int64_t step = ++steps_[key];
+      const double bias_correction1 =
+          1 - std::pow(options.beta1(), static_cast<double>(step));
+      const double bias_correction2 =
+          1 - std::pow(options.beta2(), static_cast<double>(step));
+      updates.push_back(AdamWUpdate{
+          p.mutable_data_ptr<float>(),
+          named_gradient->second.const_data_ptr<float>(),
+          state_.get(key, 0),
+          state_.get(key, 1),
+          static_cast<size_t>(p.numel()),
+          static_cast<float>(1 - options.lr() * options.weight_decay()),
+          static_cast<float>(options.beta1()),
+          static_cast<float>(options.beta2()),
+          static_cast<float>(options.lr() / bias_correction1),
+          static_cast<float>(1 / std::sqrt(bias_correction2)),
+          static_cast<float>(options.eps())});
+      numels.push_back(updates.back().numel);
+    }
+  }
+
+  const bool success = internal::multi_tensor_apply(
+      numels, [&](size_t index, size_t begin, size_t end) {
+        adamw_update(updates[index], begin, end);
+      });
+  ET_CHECK_OR_RETURN_ERROR(success, Internal, "parallel_for failed");
+  return Error::Ok;
+}
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * AdamW optimizer to perform on-device training. This is Adam with weight
+ * decay decoupled from the gradient, as in "Decoupled Weight Decay
+ * Regularization" (Loshchilov & Hutter), and matches torch.optim.AdamW without
+ * amsgrad.
+ */
+#pragma once
+
+#include <executorch/extension/training/optimizer/multi_tensor_apply.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+/**
+ * AdamW optimizer options. This contains options for performing training on a
+ * param group, such as the learning rate.
+ */
+class ET_EXPERIMENTAL AdamWOptions {
+ public:
+  /**
+   * Constructs a new AdamW optimizer options.
+   *
+   * @param[in] lr The learning rate.
+   * @param[in] beta1 The decay rate of the running average of the gradient.
+   * @param[in] beta2 The decay rate of the running average of the square of
+   *   the gradient.
+   * @param[in] eps The term added to the denominator of the update for
+   *   numerical stability.
+   * @param[in] weight_decay The fraction of the weight's value, scaled by the
+   *   learning rate, that is subtracted from itself at each step.
+   */
+  explicit AdamWOptions(
+      double lr = 1e-3,
+      double beta1 = 0.9,
+      double beta2 = 0.999,
+      double eps = 1e-8,
+      double weight_decay = 1e-2)
+      : lr_(lr),
+        beta1_(beta1),
+        beta2_(beta2),
+        eps_(eps),
+        weight_decay_(weight_decay) {}
+
+  std::unique_ptr<AdamWOptions> clone() const {
+    return std::make_unique<AdamWOptions>(
+        static_cast<const AdamWOptions&>(*this));
+  }
+
+  double lr() const {
+    return lr_;
+  }
+
+  double beta1() const {
+    return beta1_;
+  }
+
+  double beta2() const {
+    return beta2_;
+  }
+
+  double eps() const {
+    return eps_;
+  }
+
+  double weight_decay() const {
+    return weight_decay_;
+  }
+
+ private:
+  double lr_;
+  double beta1_;
+  double beta2_;
+  double eps_;
+  double weight_decay_;
+};
+
+/**
+ * AdamW optimizer param group. This contains the parameters and
+ * the AdamWOptions associated to it.
+ */
+class ET_EXPERIMENTAL AdamWParamGroup {
+ public:
+  // NOTE: In order to store `AdamWParamGroup` in a `std::vector`, it has
+  // to be copy-constructible.
+  AdamWParamGroup(const AdamWParamGroup& param_group)
+      : named_parameters_(param_group.named_parameters()),
+        options_(
+            param_group.has_options() ? param_group.options().clone()
+                                      : nullptr) {}
+  AdamWParamGroup& operator=(const AdamWParamGroup& param_group) {
+    this->named_parameters_ = param_group.named_parameters_;
+    this->options_ =
+        param_group.has_options() ? param_group.options().clone() : nullptr;
+    return *this;
+  }
+
+  /**
+   * Constructs an AdamW param group.
+   *
+   * @param[in] named_parameters The parameters to be optimized and their fully
+   * qualified names.
+   */
+  /* implicit */ AdamWParamGroup(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_parameters)
+      : named_parameters_(named_parameters) {}
+  AdamWParamGroup(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_parameters,
+      std::unique_ptr<AdamWOptions> options)
+      : named_parameters_(named_parameters), options_(std::move(options)) {}
+
+  bool has_options() const;
+  AdamWOptions& options();
+  const AdamWOptions& options() const;
+  void set_options(std::unique_ptr<AdamWOptions> options);
+  const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+  named_parameters() const;
+
+ private:
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_parameters_;
+  std::unique_ptr<AdamWOptions> options_;
+};
+
+/**
+ * AdamW optimizer class. This is responsible for performing the optimization
+ * step.
+ */
+class ET_EXPERIMENTAL AdamW {
+ public:
+  explicit AdamW(
+      const std::vector<AdamWParamGroup>& param_groups,
+      AdamWOptions defaults)
+      : defaults_(std::make_unique<AdamWOptions>(defaults)) {
+    for (const auto& param_group : param_groups) {
+      add_param_group(param_group);
+    }
+  }
+
+  explicit AdamW(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_parameters,
+      AdamWOptions defaults)
+      : AdamW({AdamWParamGroup(named_parameters)}, defaults) {}
+
+  // Adds the given param_group to the optimizer's param_group list.
+  void add_param_group(const AdamWParamGroup& param_group);
+
+  /**
+   * Performs the optimization step.
+   *
+   * All parameters are updated in one fused step, split into chunks that run
+   * in parallel on the threadpool when there is one. The gradients are not
+   * modified. Parameters and gradients must be float tensors with the same
+   * number of elements.
+   *
+   * @param[in] named_gradients The gradients of the tensors specified by the
+   * fully qualified name.
+   */
+  ::executorch::runtime::Error step(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_gradients);
+
+ private:
+  std::vector<AdamWParamGroup> param_groups_;
+  // The running averages of the gradient and of its square for each
+  // parameter, by TensorImpl.
+  internal::StateArena state_{/*num_buffers=*/2};
+  // The number of steps taken by each parameter, by TensorImpl.
+  std::unordered_map<const void*, int64_t> steps_;
+  std::unique_ptr<AdamWOptions> defaults_;
+};
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Helpers for optimizers that update all of their parameters in one fused
+ * step, rather than with a sequence of loops per parameter.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+namespace internal {
+
+using Vec = ::executorch::vec::Vectorized<float>;
+
+/// Loads a float, or Vec::size() floats if `V` is Vec, so that an update can
+/// be written once for the vectorized loop and its tail.
+template <typename V>
+inline V load(const float* data);
+
+template <>
+inline float load<float>(const float* data) {
+  return *data;
+}
+
+template <>
+inline Vec load<Vec>(const float* data) {
+  return Vec::loadu(data);
+}
+
+inline void store(float value, float* data) {
+  *data = value;
+}
+
+inline void store(const Vec& value, float* data) {
+  value.store(data);
+}
+
+/// The maximum number of elements of a tensor that one task of
+/// multi_tensor_apply() updates.
+constexpr size_t kMultiTensorApplyChunkSize = 16384;
+
+/**
+ * Splits every tensor of an optimizer step into chunks of at most
+ * kMultiTensorApplyChunkSize elements, and calls `fn(index, begin, end)` for
+ * the elements [begin, end) of each chunk of the tensor at `index`. Chunks of
+ * all tensors are spread across threads with parallel_for(), so small tensors
+ * don't each pay for a parallel loop and large ones are split.
+ *
+ * @param[in] numels The number of elements of each tensor.
+ * @param[in] fn The update to apply. Chunks run in parallel and in any order,
+ *     so it must only write the elements of its chunk.
+ *
+ * @returns false if parallel_for() failed, true otherwise.
+ */
+template <typename Fn>
+bool multi_tensor_apply(const std::vector<size_t>& numels, const Fn& fn) {
+  // The index of the first chunk of each tensor, and the total at the end.
+  std::vector<int64_t> first_chunk(numels.size() + 1, 0);
+  for (size_t i = 0; i < numels.size(); ++i) {
+    first_chunk[i + 1] = first_chunk[i] +
+        (numels[i] + kMultiTensorApplyChunkSize - 1) /
+            kMultiTensorApplyChunkSize;
+  }
+  return ::executorch::extension::parallel_for(
+      0, first_chunk.back(), 1, [&](int64_t begin, int64_t end) {
+        for (int64_t chunk = begin; chunk < end; ++chunk) {
+          const size_t index =
+              std::upper_bound(first_chunk.begin(), first_chunk.end(), chunk) -
+              first_chunk.begin() - 1;
+          const size_t chunk_begin =
+              (chunk - first_chunk[index]) * kMultiTensorApplyChunkSize;
+          fn(index,
+             chunk_begin,
+             std::min(chunk_begin + kMultiTensorApplyChunkSize, numels[index]));
+        }
+      });
+}
+
+/**
+ * Checks that a fused optimizer step can update `param` with `grad`.
+ */
+inline ::executorch::runtime::Error check_param_and_grad(
+    const executorch::aten::Tensor& param,
+    const executorch::aten::Tensor& grad) {
+  ET_CHECK_OR_RETURN_ERROR(
+      param.scalar_type() == executorch::aten::ScalarType::Float &&
+          grad.scalar_type() == executorch::aten::ScalarType::Float,
+      InvalidArgument,
+      "Only float parameters and gradients are supported");
+  ET_CHECK_OR_RETURN_ERROR(
+      param.numel() == grad.numel(),
+      InvalidArgument,
+      "Parameter has %zd elements but its gradient has %zd",
+      static_cast<ssize_t>(param.numel()),
+      static_cast<ssize_t>(grad.numel()));
+  return ::executorch::runtime::Error::Ok;
+}
+
+/**
+ * The float state of the parameters of an optimizer, like their momentum, in
+ * one contiguous allocation rather than one per parameter. Each parameter has
+ * `num_buffers` buffers of its number of elements.
+ */
+class StateArena final {
+ public:
+  explicit StateArena(size_t num_buffers) : num_buffers_(num_buffers) {}
+
+  /**
+   * Adds zero-initialized buffers for the parameters in `params`, pairs of
+   * key and number of elements, that don't have them yet. Existing buffers
+   * keep their contents, but may move, so pointers returned by `get()` are
+   * invalidated.
+   */
+  void add(const std::vector<std::pair<const void*, size_t>>& params) {
+    size_t size = data_.size();
+    for (const auto& param : params) {
+      if (entries_.count(param.first) == 0) {
+        const size_t stride = aligned(param.second);
+        entries_[param.first] = Entry{size, stride};
+        size += stride * num_buffers_;
+      }
+    }
+    data_.resize(size, 0.0f);
+  }
+
+  /**
+   * @returns The buffer at `index` of the parameter with `key`, or nullptr if
+   *     it doesn't have one.
+   */
+  float* get(const void* key, size_t index) {
+    const auto entry = entries_.find(key);
+    if (entry == entries_.end() || index >= num_buffers_) {
+      return nullptr;
+    }
+    return data_.data() + entry->second.offset + entry->second.stride * index;
+  }
+
+  /// @returns The number of bytes of state.
+  size_t nbytes() const {
+    return data_.size() * sizeof(float);
+  }
+
+ private:
+  // Pads buffers to 64 bytes so that each starts on a cache line boundary
+  // relative to the arena.
+  static size_t aligned(size_t numel) {
+    constexpr size_t kAlignment = 64 / sizeof(float);
+    return (numel + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  // The buffers of a parameter follow each other, `stride` elements apart.
+  struct Entry {
+    size_t offset;
+    size_t stride;
+  };
+
+  const size_t num_buffers_;
+  std::unordered_map<const void*, Entry> entries_;
+  std::vector<float> data_;
+};
+
+} // namespace internal
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
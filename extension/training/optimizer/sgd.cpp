@@ -8,10 +8,10 @@
 
 #include <executorch/extension/training/optimizer/sgd.h>
 
+#include <unordered_set>
+
 #include <executorch/runtime/core/error.h>
 
-using executorch::aten::Tensor;
-using executorch::aten::TensorImpl;
 using ::executorch::runtime::Error;
 
 namespace executorch {
@@ -20,34 +20,56 @@ namespace training {
 namespace optimizer {
 
 namespace {
-void add_out_hack(
-    const Tensor& a,
-    const Tensor& b,
-    const double alpha,
-    Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto b_ptr = b.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i] + b_ptr[i] * alpha;
-  }
-}
 
-void mul_out_hack(const Tensor& a, const double alpha, Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i] * alpha;
+using internal::load;
+using internal::store;
+using internal::Vec;
+
+/// A parameter that an SGD step updates.
+struct SGDUpdate {
+  float* param;
+  const float* grad;
+  // Null when the options have no momentum.
+  float* momentum_buffer;
+  size_t numel;
+  const SGDOptions* options;
+  // The momentum buffer is initialized from the gradient on the first step.
+  bool first_step;
+};
+
+/// Updates element `i` of the parameter, or the Vec::size() elements from `i`
+/// if `V` is Vec.
+template <typename V>
+inline void sgd_update(const SGDUpdate& update, size_t i) {
+  const auto& options = *update.options;
+  const V p = load<V>(update.param + i);
+  V g = load<V>(update.grad + i);
+  if (options.weight_decay() != 0) {
+    g = g + p * V(options.weight_decay());
+  }
+  if (update.momentum_buffer != nullptr) {
+    V buf = g;
+    if (!update.first_step) {
+      buf = load<V>(update.momentum_buffer + i) * V(options.momentum()) +
+          g * V(1 - options.dampening());
+    }
+    store(buf, update.momentum_buffer + i);
+    g = options.nesterov() ? g + buf * V(options.momentum()) : buf;
   }
+  store(p - g * V(options.lr()), update.param + i);
 }
 
-void clone_out_hack(const Tensor& a, Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i];
+/// Updates the elements [begin, end) of the parameter.
+void sgd_update(const SGDUpdate& update, size_t begin, size_t end) {
+  size_t i = begin;
+  for (; i + Vec::size() <= end; i += Vec::size()) {
+    sgd_update<Vec>(update, i);
+  }
+  for (; i < end; ++i) {
+    sgd_update<float>(update, i);
   }
 }
+
 } // namespace
 
 bool SGDParamGroup::has_options() const {
@@ -84,85 +106,59 @@ void SGD::add_param_group(const SGDParamGroup& param_group) {
 Error SGD::step(
     const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
         named_gradients) {
+  // Give every parameter that needs one a momentum buffer before taking any
+  // pointers into the arena.
+  std::vector<std::pair<const void*, size_t>> new_buffers;
+  std::unordered_set<const void*> first_steps;
+  for (auto& group : param_groups_) {
+    if (group.options().momentum() == 0) {
+      continue;
+    }
+    for (const auto& named_parameter : group.named_parameters()) {
+      const auto& p = named_parameter.second;
+      if (named_gradients.count(named_parameter.first) != 0 &&
+          state_.get(p.unsafeGetTensorImpl(), 0) == nullptr) {
+        new_buffers.emplace_back(p.unsafeGetTensorImpl(), p.numel());
+        first_steps.insert(p.unsafeGetTensorImpl());
+      }
+    }
+  }
+  state_.add(new_buffers);
+
+  std::vector<SGDUpdate> updates;
+  std::vector<size_t> numels;
   for (auto& group : param_groups_) {
-    auto& options = static_cast<SGDOptions&>(group.options());
-    auto weight_decay = options.weight_decay();
-    auto momentum = options.momentum();
-    auto dampening = options.dampening();
-    auto nesterov = options.nesterov();
-
-    for (auto param_iter = group.named_parameters().begin();
-         param_iter != group.named_parameters().end();
-         ++param_iter) {
+    const auto& options = group.options();
+    for (const auto& named_parameter : group.named_parameters()) {
       // if param name and gradient name match, run the optimizer step
-      const auto& named_gradient = named_gradients.find(param_iter->first);
-      if (named_gradient != named_gradients.end()) {
-        auto d_p = named_gradient->second;
-        auto p = param_iter->second;
-        if (weight_decay != 0) {
-          // uses weight_decay specified and adds it to the gradient
-          add_out_hack(d_p, p, weight_decay, d_p);
-        }
-        if (momentum != 0) {
-          Tensor buf(nullptr);
-          auto param_state = state_.find(p.unsafeGetTensorImpl());
-          // look for the momentum buffer for the given parameter. this is the
-          // momentum as of the previous epoch
-          if (param_state == state_.end()) {
-            // create a new momentum buffer if it doesn't exist. this memory
-            // needs to be freed when the optimizer is destroyed
-            void* buf_ptr = malloc(d_p.nbytes());
-
-#ifdef USE_ATEN_LIB
-            std::vector<int64_t> sizes(d_p.sizes().begin(), d_p.sizes().end());
-            buf = torch::from_blob(buf_ptr, sizes, d_p.scalar_type());
-#else
-            TensorImpl* buf_impl = new TensorImpl(
-                d_p.scalar_type(),
-                d_p.sizes().size(),
-                const_cast<TensorImpl::SizesType*>(d_p.sizes().data()),
-                buf_ptr,
-                const_cast<TensorImpl::DimOrderType*>(d_p.dim_order().data()));
-            buf = Tensor(buf_impl);
-#endif
-            clone_out_hack(d_p, buf);
-
-            // save the state of the momentum buffer to be reused in later
-            // epochs
-            auto state = std::make_unique<SGDParamState>(buf);
-            state_[p.unsafeGetTensorImpl()] = std::move(state);
-          } else {
-            buf = static_cast<SGDParamState&>(*param_state->second)
-                      .momentum_buffer();
-
-            // update the momentum buffer and apply dampening
-            mul_out_hack(buf, momentum, buf);
-            add_out_hack(buf, d_p, 1 - dampening, buf);
-          }
-          if (nesterov) {
-            // apply nesterov momentum
-            add_out_hack(d_p, buf, momentum, d_p);
-          } else {
-            d_p = buf;
-          }
-        }
-        // update the parameter using the gradient and learning rate
-        add_out_hack(p, d_p, -1 * options.lr(), p);
+      const auto& named_gradient = named_gradients.find(named_parameter.first);
+      if (named_gradient == named_gradients.end()) {
+        continue;
       }
+      const auto& p = named_parameter.second;
+      const auto& d_p = named_gradient->second;
+      ET_CHECK_OK_OR_RETURN_ERROR(internal::check_param_and_grad(p, d_p));
+      const void* key = p.unsafeGetTensorImpl();
+      updates.push_back(SGDUpdate{
+          p.mutable_data_ptr<float>(),
+          d_p.const_data_ptr<float>(),
+          options.momentum() != 0 ? state_.get(key, 0) : nullptr,
+          static_cast<size_t>(p.numel()),
+          &options,
+          first_steps.count(key) != 0});
+      numels.push_back(updates.back().numel);
     }
   }
+
+  const bool success = internal::multi_tensor_apply(
+      numels, [&](size_t index, size_t begin, size_t end) {
+        sgd_update(updates[index], begin, end);
+      });
+  ET_CHECK_OR_RETURN_ERROR(success, Internal, "parallel_for failed");
   return Error::Ok;
 }
 
-SGD::~SGD() {
-  for (const auto& state_kv : state_) {
-    auto state_tensor = static_cast<SGDParamState&>(*state_kv.second);
-    free(state_tensor.momentum_buffer().unsafeGetTensorImpl()->mutable_data());
-#ifndef USE_ATEN_LIB
-    delete state_tensor.momentum_buffer().unsafeGetTensorImpl();
-#endif
-  }
-}
+SGD::~SGD() = default;
 
 } // namespace optimizer
 } // namespace training
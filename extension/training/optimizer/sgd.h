@@ -16,11 +16,11 @@
  */
 #pragma once
 
+#include <executorch/extension/training/optimizer/multi_tensor_apply.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <map>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace executorch {
@@ -202,6 +202,11 @@ class ET_EXPERIMENTAL SGD {
   /**
    * Performs the optimization step.
    *
+   * All parameters are updated in one fused step, split into chunks that run
+   * in parallel on the threadpool when there is one. The gradients are not
+   * modified. Parameters and gradients must be float tensors with the same
+   * number of elements.
+   *
    * @param[in] named_gradients The gradients of the tensors specified by the
    * fully qualified name.
    */
@@ -211,7 +216,8 @@ class ET_EXPERIMENTAL SGD {
 
  private:
   std::vector<SGDParamGroup> param_groups_;
-  std::unordered_map<void*, std::unique_ptr<SGDParamState>> state_;
+  // The momentum buffer of each parameter, by TensorImpl.
+  internal::StateArena state_{/*num_buffers=*/1};
   std::unique_ptr<SGDOptions> defaults_;
 };
 
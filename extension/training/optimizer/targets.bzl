@@ -24,6 +24,22 @@ def define_common_targets():
         #         "//executorch/kernels/portable:generated_lib_headers",
         #     ]
 
+        runtime.cxx_library(
+            name = "multi_tensor_apply" + aten_suffix,
+            exported_headers = [
+                "multi_tensor_apply.h",
+            ],
+            exported_deps = [
+                "//executorch/kernels/optimized:libvec",
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+                "//executorch/runtime/kernel:thread_parallel_interface",
+            ],
+            visibility = [
+                "//executorch/extension/training/...",
+            ],
+        )
+
         runtime.cxx_library(
             name = "sgd" + aten_suffix,
             srcs = [
@@ -33,6 +49,7 @@ def define_common_targets():
                 "sgd.h",
             ],
             exported_deps = [
+                ":multi_tensor_apply" + aten_suffix,
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
             ],  # + kernel_deps,
@@ -40,3 +57,21 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
         )
+
+        runtime.cxx_library(
+            name = "adamw" + aten_suffix,
+            srcs = [
+                "adamw.cpp",
+            ],
+            exported_headers = [
+                "adamw.h",
+            ],
+            exported_deps = [
+                ":multi_tensor_apply" + aten_suffix,
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
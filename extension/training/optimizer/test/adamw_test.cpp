@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adamw.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+// @lint-ignore-every CLANGTIDY facebook-hte-CArray
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using ::executorch::extension::training::optimizer::AdamW;
+using ::executorch::extension::training::optimizer::AdamWOptions;
+using ::executorch::extension::training::optimizer::AdamWParamGroup;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+/// Takes `steps` AdamW steps on a single value with a constant gradient.
+float reference_adamw(
+    float p,
+    float g,
+    const AdamWOptions& options,
+    int steps) {
+  double m = 0;
+  double v = 0;
+  for (int step = 1; step <= steps; ++step) {
+    p *= 1 - options.lr() * options.weight_decay();
+    m = options.beta1() * m + (1 - options.beta1()) * g;
+    v = options.beta2() * v + (1 - options.beta2()) * g * g;
+    const double m_hat = m / (1 - std::pow(options.beta1(), step));
+    const double v_hat = v / (1 - std::pow(options.beta2(), step));
+    p -= options.lr() * m_hat / (std::sqrt(v_hat) + options.eps());
+  }
+  return p;
+}
+
+} // namespace
+
+class AdamWOptimizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(AdamWOptimizerTest, AdamWOptionsDefaultValuesTest) {
+  AdamWOptions options;
+
+  EXPECT_EQ(options.lr(), 1e-3);
+  EXPECT_EQ(options.beta1(), 0.9);
+  EXPECT_EQ(options.beta2(), 0.999);
+  EXPECT_EQ(options.eps(), 1e-8);
+  EXPECT_EQ(options.weight_decay(), 1e-2);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerSimple) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_parameters;
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_gradients;
+
+  named_parameters.insert({"param1", tf.make({2}, {1, -2})});
+  named_gradients.insert({"param1", tf.make({2}, {-1, 0.5})});
+
+  AdamWOptions options(0.1, 0.9, 0.99, 1e-8, 0.1);
+  AdamW optimizer(named_parameters, options);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  auto p = named_parameters.at("param1").const_data_ptr<float>();
+  EXPECT_NEAR(p[0], reference_adamw(1, -1, options, 10), 1e-5);
+  EXPECT_NEAR(p[1], reference_adamw(-2, 0.5, options, 10), 1e-5);
+  // The gradients are left alone.
+  auto g = named_gradients.at("param1").const_data_ptr<float>();
+  EXPECT_EQ(g[0], -1);
+  EXPECT_EQ(g[1], 0.5);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerParamGroups) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      group1_parameters;
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      group2_parameters;
+  // Big enough to be split into several chunks.
+  const int32_t numel = 40000;
+  group1_parameters.insert({"param1", tf.full({numel}, 1)});
+  group2_parameters.insert({"param2", tf.make({1}, {1})});
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_gradients;
+  named_gradients.insert({"param1", tf.full({numel}, 0.5)});
+  named_gradients.insert({"param2", tf.make({1}, {0.5})});
+
+  AdamWOptions defaults(0.01);
+  AdamWOptions group2_options(0.1, 0.8, 0.9, 1e-6, 0);
+  std::vector<AdamWParamGroup> param_groups;
+  param_groups.emplace_back(group1_parameters);
+  param_groups.emplace_back(
+      group2_parameters, std::make_unique<AdamWOptions>(group2_options));
+  AdamW optimizer(param_groups, defaults);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+  // Only param2 takes the last step.
+  named_gradients.erase("param1");
+  EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+
+  auto p1 = group1_parameters.at("param1").const_data_ptr<float>();
+  const float expected1 = reference_adamw(1, 0.5, defaults, 3);
+  for (int32_t i = 0; i < numel; ++i) {
+    ASSERT_NEAR(p1[i], expected1, 1e-5) << "at " << i;
+  }
+  auto p2 = group2_parameters.at("param2").const_data_ptr<float>();
+  EXPECT_NEAR(p2[0], reference_adamw(1, 0.5, group2_options, 4), 1e-5);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerRejectsMismatchedGradient) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_parameters;
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_gradients;
+  named_parameters.insert({"param1", tf.make({2}, {1, 1})});
+  named_gradients.insert({"param1", tf.make({1}, {1})});
+
+  AdamW optimizer(named_parameters, AdamWOptions());
+  EXPECT_EQ(optimizer.step(named_gradients), Error::InvalidArgument);
+  auto p = named_parameters.at("param1").const_data_ptr<float>();
+  EXPECT_EQ(p[0], 1);
+}
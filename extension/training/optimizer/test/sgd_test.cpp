@@ -116,3 +116,39 @@ TEST_F(SGDOptimizerTest, SGDOptimizerComplex) {
   EXPECT_NEAR(p1[0], 0.540303, 0.1);
   EXPECT_NEAR(p2[0], 0.620909, 0.1);
 }
+
+TEST_F(SGDOptimizerTest, SGDOptimizerLargeParameter) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Big enough to be split into several chunks, with a tail that isn't a
+  // multiple of the vector size.
+  const int32_t numel = 40003;
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_parameters;
+  named_parameters.insert({"param1", tf.full({numel}, 1)});
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_gradients;
+  named_gradients.insert({"param1", tf.full({numel}, -1)});
+
+  SGDOptions options(0.1, 0.9, 0.1, 0.01, false);
+  SGD optimizer(named_parameters, options);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  // The same steps on a single value.
+  float p = 1;
+  float buf = 0;
+  for (int i = 0; i < 3; ++i) {
+    const float g = -1 + options.weight_decay() * p;
+    buf = i == 0 ? g : buf * options.momentum() + g * (1 - options.dampening());
+    p -= options.lr() * buf;
+  }
+  auto p1 = named_parameters.at("param1").const_data_ptr<float>();
+  for (int32_t i = 0; i < numel; ++i) {
+    ASSERT_NEAR(p1[i], p, 1e-5) << "at " << i;
+  }
+  // The gradients are left alone.
+  auto g1 = named_gradients.at("param1").const_data_ptr<float>();
+  EXPECT_EQ(g1[numel - 1], -1);
+}
@@ -88,10 +88,10 @@ struct PySGD final {
     for (const auto& pair : py_named_gradients) {
       fqn.push_back(pair.first);
       auto at_tensor = pair.second;
-      // alias_etensor_to_attensor will assert on this later, so to better
+      // alias_tensor_ptr_to_attensor will assert on this later, so to better
       // propogate up to python we check early and throw an exception.
-      if (!at_tensor.is_contiguous()) {
-        auto error_msg = "Gradient is not contiguous.";
+      if (!get_attensor_dim_order(at_tensor).ok()) {
+        auto error_msg = "Gradient is not dense in any dim order.";
         throw std::runtime_error(error_msg);
       }
 #ifndef USE_ATEN_LIB
@@ -19,6 +19,20 @@
 namespace executorch {
 namespace cpublas {
 
+#ifdef __aarch64__
+namespace internal {
+float bf16_dot_with_fp32_arith(
+    const torch::executor::BFloat16* vec1,
+    const torch::executor::BFloat16* vec2,
+    int64_t len);
+} // namespace internal
+#endif
+
+// Multi-versioned kernels instantiate these templates; see
+// Note [CPU_CAPABILITY namespace] in
+// kernels/optimized/dispatch/dispatch_stub.h.
+inline namespace CPU_CAPABILITY {
+
 template <typename scalar_t, typename opmath_t>
 void scale_(int64_t m, int64_t n, opmath_t alpha, scalar_t* a, int64_t lda) {
   if (alpha == opmath_t(1)) {
@@ -159,10 +173,6 @@ void gemm_transa_(
 }
 
 #ifdef __aarch64__
-namespace internal {
-float bf16_dot_with_fp32_arith(const torch::executor::BFloat16* vec1, const torch::executor::BFloat16* vec2, int64_t len);
-} // namespace internal
-
 template <>
 inline void gemm_transa_<torch::executor::BFloat16, torch::executor::BFloat16>(
     int64_t m, int64_t n, int64_t k,
@@ -302,5 +312,6 @@ void gemm_transab_(
 }
 // clang-format on
 
+} // namespace CPU_CAPABILITY
 } // namespace cpublas
 } // namespace executorch
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/blas/multiversion/gemm_kernels.h>
 
 #include <limits.h>
 
@@ -27,6 +28,11 @@ namespace cpublas {
 using executorch::aten::BFloat16;
 using executorch::aten::Half;
 
+ET_DEFINE_DISPATCH(gemm_double_stub);
+ET_DEFINE_DISPATCH(gemm_float_stub);
+ET_DEFINE_DISPATCH(gemm_half_stub);
+ET_DEFINE_DISPATCH(gemm_bfloat16_stub);
+
 #ifdef ET_BUILD_WITH_BLAS
 #ifdef ET_BUILD_FOR_APPLE
 inline CBLAS_TRANSPOSE to_cblas_transpose(TransposeType trans) {
@@ -99,7 +105,7 @@ void gemm(
 #endif // ET_BUILD_FOR_APPLE
 #else
   using acc_type = utils::compute_dtype<float>;
-  gemm_impl(
+  gemm_double_stub(
       transa, transb,
       m, n, k,
       static_cast<const acc_type>(alpha),
@@ -121,26 +127,29 @@ void gemm(
     const float beta,
     float *c, int64_t ldc) {
   normalize_last_dims(transa, transb, m, n, k, &lda, &ldb, &ldc);
-#ifdef ET_BUILD_WITH_BLAS
-#ifdef ET_BUILD_FOR_APPLE
+#if defined(ET_BUILD_WITH_BLAS) && defined(ET_BUILD_FOR_APPLE)
   cblas_sgemm(CblasColMajor, to_cblas_transpose(transa), to_cblas_transpose(transb), m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
 #else
-  int m_ = m, n_ = n, k_ = k, lda_ = lda, ldb_ = ldb, ldc_ = ldc;
-  float alpha_ = alpha, beta_ = beta;
-  char transa_ = to_blas(transa), transb_ = to_blas(transb);
-  sgemm_(
-      &transa_, &transb_,
-      &m_, &n_, &k_,
-      &alpha_,
-      a, &lda_,
-      b, &ldb_,
-      &beta_,
-      c, &ldc_);
-#endif // ET_BUILD_FOR_APPLE
-
-#else
+#ifdef ET_BUILD_WITH_BLAS
+  // The packed kernels behind gemm_float_stub are for matrix-matrix products;
+  // leave matrix-vector products to BLAS.
+  if (m == 1 || n == 1) {
+    int m_ = m, n_ = n, k_ = k, lda_ = lda, ldb_ = ldb, ldc_ = ldc;
+    float alpha_ = alpha, beta_ = beta;
+    char transa_ = to_blas(transa), transb_ = to_blas(transb);
+    sgemm_(
+        &transa_, &transb_,
+        &m_, &n_, &k_,
+        &alpha_,
+        a, &lda_,
+        b, &ldb_,
+        &beta_,
+        c, &ldc_);
+    return;
+  }
+#endif // ET_BUILD_WITH_BLAS
   using acc_type = utils::compute_dtype<float>;
-  gemm_impl(
+  gemm_float_stub(
       transa, transb,
       m, n, k,
       static_cast<const acc_type>(alpha),
@@ -163,7 +172,7 @@ void gemm(
   normalize_last_dims(transa, transb, m, n, k, &lda, &ldb, &ldc);
 
   using acc_type = utils::compute_dtype<Half>;
-  gemm_impl(
+  gemm_half_stub(
       transa, transb,
       m, n, k,
       static_cast<const acc_type>(alpha),
@@ -186,7 +195,7 @@ void gemm(
   normalize_last_dims(transa, transb, m, n, k, &lda, &ldb, &ldc);
 
   using acc_type = utils::compute_dtype<BFloat16>;
-  gemm_impl(
+  gemm_bfloat16_stub(
       transa, transb,
       m, n, k,
       static_cast<const acc_type>(alpha),
@@ -43,6 +43,9 @@ inline char to_blas(TransposeType trans) {
   return 'N';
 }
 
+// See Note [CPU_CAPABILITY namespace] in
+// kernels/optimized/dispatch/dispatch_stub.h.
+inline namespace CPU_CAPABILITY {
 // clang-format off
 template <typename scalar_t, typename opmath_t>
 void gemm_impl(
@@ -70,6 +73,7 @@ void gemm_impl(
   }
 }
 // clang-format on
+} // namespace CPU_CAPABILITY
 
 // clang-format off
 void gemm(
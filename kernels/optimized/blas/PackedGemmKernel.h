@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/kernels/optimized/utils/unroll.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_convert.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+/**
+ * A packed-panel gemm in the style of BLIS, for float, Half and BFloat16.
+ *
+ * C is split into kMc x kNc tiles, which are computed in parallel. For each
+ * kKc-deep slice of the shared dimension, a task copies the slices of op(A)
+ * and op(B) it needs into contiguous float panels: op(A) as kMr-row panels,
+ * which stay in L2, and op(B) as kNr-column panels, each of which stays in L1
+ * while the microkernel sweeps the A panels past it. The microkernel keeps a
+ * kMr x kNr block of C in vector registers for the whole slice.
+ *
+ * Products accumulate in float in a per-task buffer, so Half and BFloat16
+ * only round once, when the tile is written back to C.
+ */
+
+namespace executorch {
+namespace cpublas {
+
+// See Note [CPU_CAPABILITY namespace] in
+// kernels/optimized/dispatch/dispatch_stub.h.
+inline namespace CPU_CAPABILITY {
+
+namespace packed_gemm_internal {
+
+using Vec = executorch::vec::Vectorized<float>;
+
+/// Rows of a microkernel block: two vectors.
+constexpr int64_t kMr = 2 * Vec::size();
+/// Columns of a microkernel block. AVX-512 and SVE have 32 vector registers,
+/// enough to keep twice as many accumulators live.
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_SVE256)
+constexpr int64_t kNr = 12;
+#else
+constexpr int64_t kNr = 6;
+#endif
+/// Depth of a slice of the shared dimension.
+constexpr int64_t kKc = 256;
+/// Rows of a tile of C; the packed A block is kMc x kKc.
+constexpr int64_t kMc = 128;
+/// Columns of a tile of C; the packed B block is kKc x kNc.
+constexpr int64_t kNc = 192;
+
+static_assert(kMc % kMr == 0, "kMc must be a multiple of kMr");
+static_assert(kNc % kNr == 0, "kNc must be a multiple of kNr");
+
+inline int64_t round_up(int64_t x, int64_t multiple) {
+  return utils::divup(x, multiple) * multiple;
+}
+
+/**
+ * Copies rows [i0, i0 + mc) and columns [p0, p0 + kc) of op(A) into kMr-row
+ * panels, zero-padding the last panel. Within a panel, the kMr values of each
+ * column are contiguous.
+ */
+template <typename scalar_t>
+void pack_a(
+    bool transa,
+    const scalar_t* a,
+    int64_t lda,
+    int64_t i0,
+    int64_t mc,
+    int64_t p0,
+    int64_t kc,
+    float* packed) {
+  for (int64_t ir = 0; ir < mc; ir += kMr) {
+    const int64_t rows = std::min(kMr, mc - ir);
+    for (int64_t p = 0; p < kc; ++p) {
+      if (!transa && rows == kMr) {
+        // The column of the panel is contiguous in A: convert it to float
+        // a vector at a time.
+        const scalar_t* const col = a + (i0 + ir) + (p0 + p) * lda;
+        executorch::vec::store_from_float(
+            executorch::vec::load_as_float(col), packed);
+        executorch::vec::store_from_float(
+            executorch::vec::load_as_float(col + Vec::size()),
+            packed + Vec::size());
+        packed += kMr;
+        continue;
+      }
+      for (int64_t r = 0; r < rows; ++r) {
+        const int64_t i = i0 + ir + r;
+        const int64_t l = p0 + p;
+        packed[r] =
+            static_cast<float>(transa ? a[l + i * lda] : a[i + l * lda]);
+      }
+      std::fill(packed + rows, packed + kMr, 0.0f);
+      packed += kMr;
+    }
+  }
+}
+
+/**
+ * Copies rows [p0, p0 + kc) and columns [j0, j0 + nc) of op(B) into
+ * kNr-column panels, zero-padding the last panel. Within a panel, the kNr
+ * values of each row are contiguous.
+ */
+template <typename scalar_t>
+void pack_b(
+    bool transb,
+    const scalar_t* b,
+    int64_t ldb,
+    int64_t p0,
+    int64_t kc,
+    int64_t j0,
+    int64_t nc,
+    float* packed) {
+  for (int64_t jr = 0; jr < nc; jr += kNr) {
+    const int64_t cols = std::min(kNr, nc - jr);
+    for (int64_t p = 0; p < kc; ++p) {
+      for (int64_t col = 0; col < cols; ++col) {
+        const int64_t j = j0 + jr + col;
+        const int64_t l = p0 + p;
+        packed[col] =
+            static_cast<float>(transb ? b[j + l * ldb] : b[l + j * ldb]);
+      }
+      std::fill(packed + cols, packed + kNr, 0.0f);
+      packed += kNr;
+    }
+  }
+}
+
+/**
+ * Computes the kMr x kNr block acc (+)= a_panel @ b_panel, where acc is
+ * column-major with leading dimension ldacc. Overwrites acc on the first
+ * slice of the shared dimension and adds to it afterwards.
+ */
+inline void microkernel(
+    int64_t kc,
+    const float* a_panel,
+    const float* b_panel,
+    float* acc,
+    int64_t ldacc,
+    bool accumulate) {
+  Vec lo[kNr];
+  Vec hi[kNr];
+  utils::ForcedUnroll<kNr>{}([&](int j) {
+    if (accumulate) {
+      lo[j] = Vec::loadu(acc + j * ldacc);
+      hi[j] = Vec::loadu(acc + j * ldacc + Vec::size());
+    } else {
+      lo[j] = Vec(0.0f);
+      hi[j] = Vec(0.0f);
+    }
+  });
+  for (int64_t p = 0; p < kc; ++p) {
+    const Vec a_lo = Vec::loadu(a_panel);
+    const Vec a_hi = Vec::loadu(a_panel + Vec::size());
+    utils::ForcedUnroll<kNr>{}([&](int j) {
+      const Vec b = Vec(b_panel[j]);
+      lo[j] = executorch::vec::fmadd(a_lo, b, lo[j]);
+      hi[j] = executorch::vec::fmadd(a_hi, b, hi[j]);
+    });
+    a_panel += kMr;
+    b_panel += kNr;
+  }
+  utils::ForcedUnroll<kNr>{}([&](int j) {
+    lo[j].store(acc + j * ldacc);
+    hi[j].store(acc + j * ldacc + Vec::size());
+  });
+}
+
+} // namespace packed_gemm_internal
+
+/**
+ * Returns true if packed_gemm() is likely to beat the loops in BlasKernel.h.
+ * Packing costs O(m * k + k * n) and pads C out to whole microkernel blocks,
+ * which doesn't pay off for matrix-vector products or tiny matrices.
+ */
+inline bool use_packed_gemm(int64_t m, int64_t n, int64_t k) {
+  using namespace packed_gemm_internal;
+  return m >= kMr / 2 && n >= kNr / 2 && k >= 8;
+}
+
+/**
+ * c = alpha * (op(a) @ op(b)) + beta * c, with column-major matrices as in
+ * BLAS. When beta is zero, c is not read.
+ */
+// clang-format off
+template <typename scalar_t>
+void packed_gemm(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const scalar_t *a, int64_t lda,
+    const scalar_t *b, int64_t ldb,
+    float beta,
+    scalar_t *c, int64_t ldc) {
+  // clang-format on
+  using namespace packed_gemm_internal;
+
+  const int64_t m_tiles = utils::divup(m, kMc);
+  const int64_t n_tiles = utils::divup(n, kNc);
+  // Size the buffers for the largest tile, padded to whole blocks.
+  const int64_t mc_max = round_up(std::min(m, kMc), kMr);
+  const int64_t nc_max = round_up(std::min(n, kNc), kNr);
+  const int64_t kc_max = std::min(k, kKc);
+
+  executorch::extension::parallel_for(
+      0, m_tiles * n_tiles, 1, [&](int64_t begin, int64_t end) {
+        // One allocation for each task, shared by all of its tiles.
+        const int64_t a_size = mc_max * kc_max;
+        const int64_t b_size = nc_max * kc_max;
+        const int64_t acc_size = mc_max * nc_max;
+        std::unique_ptr<float[]> buffer(
+            new float[a_size + b_size + acc_size]);
+        float* const a_packed = buffer.get();
+        float* const b_packed = a_packed + a_size;
+        float* const acc = b_packed + b_size;
+
+        for (int64_t tile = begin; tile < end; ++tile) {
+          const int64_t i0 = (tile % m_tiles) * kMc;
+          const int64_t j0 = (tile / m_tiles) * kNc;
+          const int64_t mc = std::min(kMc, m - i0);
+          const int64_t nc = std::min(kNc, n - j0);
+          const int64_t mc_padded = round_up(mc, kMr);
+          const int64_t nc_padded = round_up(nc, kNr);
+
+          for (int64_t p0 = 0; p0 < k; p0 += kKc) {
+            const int64_t kc = std::min(kKc, k - p0);
+            pack_b(transb, b, ldb, p0, kc, j0, nc, b_packed);
+            pack_a(transa, a, lda, i0, mc, p0, kc, a_packed);
+            for (int64_t jr = 0; jr < nc_padded; jr += kNr) {
+              for (int64_t ir = 0; ir < mc_padded; ir += kMr) {
+                microkernel(
+                    kc,
+                    a_packed + ir * kc,
+                    b_packed + jr * kc,
+                    acc + jr * mc_padded + ir,
+                    mc_padded,
+                    p0 > 0);
+              }
+            }
+          }
+
+          for (int64_t j = 0; j < nc; ++j) {
+            const float* acc_col = acc + j * mc_padded;
+            scalar_t* c_col = c + (j0 + j) * ldc + i0;
+            if (beta == 0.0f) {
+              for (int64_t i = 0; i < mc; ++i) {
+                c_col[i] = static_cast<scalar_t>(alpha * acc_col[i]);
+              }
+            } else {
+              for (int64_t i = 0; i < mc; ++i) {
+                c_col[i] = static_cast<scalar_t>(
+                    beta * static_cast<float>(c_col[i]) + alpha * acc_col[i]);
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace cpublas
+} // namespace executorch
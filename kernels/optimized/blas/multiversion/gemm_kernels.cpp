@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This file is compiled once per CPU capability; see dispatch_stub.h. The
+// loops in BlasKernel.h are written for the compiler to vectorize, and
+// PackedGemmKernel.h uses the vec library, so each version gets the widest
+// vectors its capability allows.
+
+#include <executorch/kernels/optimized/blas/PackedGemmKernel.h>
+#include <executorch/kernels/optimized/blas/multiversion/gemm_kernels.h>
+
+#include <type_traits>
+
+namespace executorch {
+namespace cpublas {
+
+namespace {
+
+// clang-format off
+template <typename scalar_t, typename opmath_t>
+void gemm_kernel(
+    TransposeType transa, TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    opmath_t alpha,
+    const scalar_t *a, int64_t lda,
+    const scalar_t *b, int64_t ldb,
+    opmath_t beta,
+    scalar_t *c, int64_t ldc) {
+  // packed_gemm() computes in float, so double keeps the reference loops.
+  if constexpr (!std::is_same<scalar_t, double>::value) {
+    if (use_packed_gemm(m, n, k)) {
+      packed_gemm(
+          transa != TransposeType::NoTranspose,
+          transb != TransposeType::NoTranspose,
+          m, n, k,
+          static_cast<float>(alpha),
+          a, lda,
+          b, ldb,
+          static_cast<float>(beta),
+          c, ldc);
+      return;
+    }
+  }
+  gemm_impl(
+      transa, transb,
+      m, n, k,
+      alpha,
+      a, lda,
+      b, ldb,
+      beta,
+      c, ldc);
+}
+// clang-format on
+
+} // namespace
+
+ET_REGISTER_DISPATCH(gemm_double_stub, (&gemm_kernel<double, float>));
+ET_REGISTER_DISPATCH(gemm_float_stub, (&gemm_kernel<float, float>));
+ET_REGISTER_DISPATCH(
+    gemm_half_stub,
+    (&gemm_kernel<executorch::aten::Half, executorch::aten::Half>));
+ET_REGISTER_DISPATCH(
+    gemm_bfloat16_stub,
+    (&gemm_kernel<executorch::aten::BFloat16, executorch::aten::BFloat16>));
+
+} // namespace cpublas
+} // namespace executorch
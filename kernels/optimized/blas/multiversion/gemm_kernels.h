@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/dispatch/dispatch_stub.h>
+
+namespace executorch {
+namespace cpublas {
+
+/**
+ * The gemm that cpublas runs when it doesn't call an external BLAS library:
+ * packed_gemm() from PackedGemmKernel.h for float, Half and BFloat16 when
+ * use_packed_gemm() says so, and gemm_impl() otherwise. The leading
+ * dimensions must already be normalized.
+ */
+// clang-format off
+template <typename scalar_t, typename opmath_t>
+using gemm_fn = void (*)(
+    TransposeType transa, TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    opmath_t alpha,
+    const scalar_t *a, int64_t lda,
+    const scalar_t *b, int64_t ldb,
+    opmath_t beta,
+    scalar_t *c, int64_t ldc);
+// clang-format on
+
+using gemm_double_fn = gemm_fn<double, float>;
+using gemm_float_fn = gemm_fn<float, float>;
+using gemm_half_fn =
+    gemm_fn<executorch::aten::Half, executorch::aten::Half>;
+using gemm_bfloat16_fn =
+    gemm_fn<executorch::aten::BFloat16, executorch::aten::BFloat16>;
+
+// Multi-versioned by the build; see dispatch_stub.h. Defined in CPUBlas.cpp.
+ET_DECLARE_DISPATCH(gemm_double_fn, gemm_double_stub);
+ET_DECLARE_DISPATCH(gemm_float_fn, gemm_float_stub);
+ET_DECLARE_DISPATCH(gemm_half_fn, gemm_half_stub);
+ET_DECLARE_DISPATCH(gemm_bfloat16_fn, gemm_bfloat16_stub);
+
+} // namespace cpublas
+} // namespace executorch
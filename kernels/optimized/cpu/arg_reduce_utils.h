@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Arg-reductions for argmax, argmin, max.dim and min.dim. Each vector lane
+// keeps its own best value and the position where it was found, updated
+// with compares and blends, and the lanes are merged at the end. Rows along
+// a contiguous dim are split into chunks that are reduced in parallel, and
+// a strided dim is reduced for many adjacent outputs at once.
+//
+// Like the portable kernels, the first occurrence of the best value wins,
+// and NaN is better than any number.
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// The number of elements of a contiguous row that one task reduces.
+constexpr int64_t kArgReduceChunk =
+    ::executorch::extension::internal::GRAIN_SIZE;
+/// The number of adjacent outputs one task computes for a strided dim.
+constexpr int64_t kArgReduceLanes = 256;
+
+/// The types with vector compares and blends. Positions are kept in lanes of
+/// the same type, so they must be exact up to kMaxExactPosition.
+template <typename T>
+constexpr bool kIsVectorizedArgReduceType = std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_same_v<T, int32_t> ||
+    std::is_same_v<T, int64_t>;
+
+template <typename T>
+constexpr int64_t kMaxExactPosition = std::is_floating_point_v<T>
+    ? (int64_t(1) << std::numeric_limits<T>::digits)
+    : static_cast<int64_t>(std::numeric_limits<T>::max());
+
+template <typename T>
+inline bool is_nan(T v) {
+  if constexpr (std::is_integral_v<T>) {
+    return false;
+  } else {
+    return std::isnan(v);
+  }
+}
+
+/**
+ * Whether `v`, found after `best`, replaces it.
+ */
+template <bool kMax, typename T>
+inline bool improves(T v, T best) {
+  return !is_nan(best) && (is_nan(v) || (kMax ? v > best : v < best));
+}
+
+/**
+ * Whether `v` at `i` replaces `best` at `best_i`, in any order.
+ */
+template <bool kMax, typename T>
+inline bool improves_at(T v, int64_t i, T best, int64_t best_i) {
+  if (is_nan(best)) {
+    return is_nan(v) && i < best_i;
+  }
+  if (is_nan(v)) {
+    return true;
+  }
+  if (v == best) {
+    return i < best_i;
+  }
+  return kMax ? v > best : v < best;
+}
+
+/**
+ * The lanes of `v` that replace those of `best`, as a blend mask.
+ */
+template <bool kMax, typename T>
+inline executorch::vec::Vectorized<T> improves(
+    const executorch::vec::Vectorized<T>& v,
+    const executorch::vec::Vectorized<T>& best) {
+  const auto better = kMax ? (v > best) : (v < best);
+  if constexpr (std::is_floating_point_v<T>) {
+    return better | ((v != v) & (best == best));
+  } else {
+    return better;
+  }
+}
+
+/**
+ * Returns the best of `data[0:n]`, n > 0, and its index.
+ */
+template <bool kMax, typename T>
+std::tuple<T, int64_t> arg_reduce_contiguous(const T* data, int64_t n) {
+  T best = data[0];
+  int64_t best_i = 0;
+  int64_t i = 1;
+  if constexpr (kIsVectorizedArgReduceType<T>) {
+    using Vec = executorch::vec::Vectorized<T>;
+    constexpr int64_t W = Vec::size();
+    if (n >= 2 * W && n / W < kMaxExactPosition<T>) {
+      // Every lane tracks the block in which it found its best value.
+      Vec best_vec = Vec::loadu(data);
+      Vec best_block(0);
+      Vec block(0);
+      const Vec one(1);
+      for (i = W; i + W <= n; i += W) {
+        const Vec v = Vec::loadu(data + i);
+        block = block + one;
+        const Vec take = improves<kMax>(v, best_vec);
+        best_vec = Vec::blendv(best_vec, v, take);
+        best_block = Vec::blendv(best_block, block, take);
+      }
+      T vals[W];
+      T blocks[W];
+      best_vec.store(vals);
+      best_block.store(blocks);
+      best = vals[0];
+      best_i = static_cast<int64_t>(blocks[0]) * W;
+      for (const auto lane : c10::irange(1, W)) {
+        const int64_t lane_i = static_cast<int64_t>(blocks[lane]) * W + lane;
+        if (improves_at<kMax>(vals[lane], lane_i, best, best_i)) {
+          best = vals[lane];
+          best_i = lane_i;
+        }
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    if (improves<kMax>(data[i], best)) {
+      best = data[i];
+      best_i = i;
+    }
+  }
+  return {best, best_i};
+}
+
+/**
+ * Reduces `data[j * stride + t]` over `j` in [0, size) for each `t` in
+ * [0, n), n <= kArgReduceLanes, writing the best values to `vals` if not
+ * null and their `j` to `indices`.
+ */
+template <bool kMax, typename T>
+void arg_reduce_strided(
+    const T* data,
+    int64_t size,
+    int64_t stride,
+    int64_t n,
+    T* vals,
+    int64_t* indices) {
+  int64_t t = 0;
+  if constexpr (kIsVectorizedArgReduceType<T>) {
+    using Vec = executorch::vec::Vectorized<T>;
+    constexpr int64_t W = Vec::size();
+    if (size < kMaxExactPosition<T>) {
+      for (; t + W <= n; t += W) {
+        Vec best_vec = Vec::loadu(data + t);
+        Vec best_pos(0);
+        Vec pos(0);
+        const Vec one(1);
+        for (const auto j : c10::irange(1, size)) {
+          const Vec v = Vec::loadu(data + j * stride + t);
+          pos = pos + one;
+          const Vec take = improves<kMax>(v, best_vec);
+          best_vec = Vec::blendv(best_vec, v, take);
+          best_pos = Vec::blendv(best_pos, pos, take);
+        }
+        if (vals != nullptr) {
+          best_vec.store(vals + t);
+        }
+        T positions[W];
+        best_pos.store(positions);
+        for (const auto lane : c10::irange(W)) {
+          indices[t + lane] = static_cast<int64_t>(positions[lane]);
+        }
+      }
+    }
+  }
+  if (t == n) {
+    return;
+  }
+  // The remaining lanes, a row at a time.
+  T best[kArgReduceLanes];
+  for (const auto l : c10::irange(t, n)) {
+    best[l] = data[l];
+    indices[l] = 0;
+  }
+  for (const auto j : c10::irange(1, size)) {
+    const T* row = data + j * stride;
+    for (const auto l : c10::irange(t, n)) {
+      if (improves<kMax>(row[l], best[l])) {
+        best[l] = row[l];
+        indices[l] = j;
+      }
+    }
+  }
+  if (vals != nullptr) {
+    std::copy(best + t, best + n, vals + t);
+  }
+}
+
+/**
+ * Reduces `in` over `dim`, or over all elements if `dim` is not set,
+ * writing the best values to `vals` if not null and their indices along
+ * `dim` to `indices`. `in` must be non-empty and contiguous. Long rows need
+ * temp memory from `ctx`.
+ *
+ * @returns false if parallel_for failed or the temp memory could not be
+ *     allocated, which is reported on `ctx`.
+ */
+template <bool kMax, typename T>
+[[nodiscard]] bool parallel_arg_reduce(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    executorch::aten::optional<int64_t> dim,
+    T* vals,
+    int64_t* indices) {
+  const T* const data = in.const_data_ptr<T>();
+  int64_t outer = 1;
+  int64_t size = in.numel();
+  int64_t inner = 1;
+  if (dim.has_value() && in.dim() > 0) {
+    const int64_t d = dim.value() < 0 ? dim.value() + in.dim() : dim.value();
+    for (const auto i : c10::irange(d)) {
+      outer *= in.size(i);
+    }
+    size = in.size(d);
+    inner = 1;
+    for (const auto i : c10::irange(d + 1, in.dim())) {
+      inner *= in.size(i);
+    }
+  }
+
+  if (inner > 1) {
+    const int64_t num_groups = (inner + kArgReduceLanes - 1) / kArgReduceLanes;
+    return ::executorch::extension::parallel_for(
+        0,
+        outer * num_groups,
+        std::max<int64_t>(
+            1,
+            ::executorch::extension::internal::GRAIN_SIZE /
+                (size * std::min(inner, kArgReduceLanes))),
+        [&](const auto begin, const auto end) {
+          for (const auto task : c10::irange(begin, end)) {
+            const int64_t o = task / num_groups;
+            const int64_t t = task % num_groups * kArgReduceLanes;
+            const int64_t out_ix = o * inner + t;
+            arg_reduce_strided<kMax>(
+                data + o * size * inner + t,
+                size,
+                inner,
+                std::min(kArgReduceLanes, inner - t),
+                vals == nullptr ? nullptr : vals + out_ix,
+                indices + out_ix);
+          }
+        });
+  }
+
+  // Long rows are split into chunks whose results are merged in order.
+  const int64_t num_chunks = (size + kArgReduceChunk - 1) / kArgReduceChunk;
+  if (num_chunks == 1) {
+    return ::executorch::extension::parallel_for(
+        0,
+        outer,
+        std::max<int64_t>(
+            1, ::executorch::extension::internal::GRAIN_SIZE / size),
+        [&](const auto begin, const auto end) {
+          for (const auto o : c10::irange(begin, end)) {
+            const auto [best, best_i] =
+                arg_reduce_contiguous<kMax>(data + o * size, size);
+            if (vals != nullptr) {
+              vals[o] = best;
+            }
+            indices[o] = best_i;
+          }
+        });
+  }
+
+  T* const chunk_vals = allocate_scratch<T>(ctx, outer * num_chunks);
+  int64_t* const chunk_indices =
+      allocate_scratch<int64_t>(ctx, outer * num_chunks);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      chunk_vals != nullptr && chunk_indices != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate arg reduction buffers");
+  const bool success = ::executorch::extension::parallel_for(
+      0, outer * num_chunks, 1, [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t o = task / num_chunks;
+          const int64_t start = task % num_chunks * kArgReduceChunk;
+          const auto [best, best_i] = arg_reduce_contiguous<kMax>(
+              data + o * size + start,
+              std::min(kArgReduceChunk, size - start));
+          chunk_vals[task] = best;
+          chunk_indices[task] = start + best_i;
+        }
+      });
+  for (const auto o : c10::irange(outer)) {
+    T best = chunk_vals[o * num_chunks];
+    int64_t best_i = chunk_indices[o * num_chunks];
+    for (const auto c : c10::irange(1, num_chunks)) {
+      if (improves<kMax>(chunk_vals[o * num_chunks + c], best)) {
+        best = chunk_vals[o * num_chunks + c];
+        best_i = chunk_indices[o * num_chunks + c];
+      }
+    }
+    if (vals != nullptr) {
+      vals[o] = best;
+    }
+    indices[o] = best_i;
+  }
+  return success;
+}
+
+/**
+ * The reduction of the portable kernels, for inputs that
+ * parallel_arg_reduce doesn't take: `in` empty or not contiguous.
+ *
+ * @returns false if parallel_for failed.
+ */
+template <bool kMax, typename T>
+[[nodiscard]] bool reduce_over_dim_arg_reduce(
+    const Tensor& in,
+    executorch::aten::optional<int64_t> dim,
+    const Tensor& out,
+    T* vals,
+    int64_t* indices) {
+  return parallel_for_each_reduce_over_dim_output_index(
+      in, dim, out, [&](const auto begin, const auto end) {
+        for (const auto out_ix : c10::irange(begin, end)) {
+          std::tuple<T, long> acc = reduce_over_dim<T>(
+              [](T v, long ix, T acc_val, long acc_ix) {
+                if (improves<kMax>(v, acc_val)) {
+                  acc_val = v;
+                  acc_ix = ix;
+                }
+                return std::tuple<T, long>{acc_val, acc_ix};
+              },
+              in,
+              dim,
+              out_ix);
+          if (vals != nullptr) {
+            vals[out_ix] = std::get<0>(acc);
+          }
+          indices[out_ix] = std::get<1>(acc);
+        }
+      });
+}
+
+/**
+ * Reduces `in` over `dim` into `vals`, if not null, and `indices`, which
+ * are laid out like `out`.
+ *
+ * @returns false if parallel_for failed or the temp memory could not be
+ *     allocated, which is reported on `ctx`.
+ */
+template <bool kMax, typename T>
+[[nodiscard]] bool arg_reduce(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    executorch::aten::optional<int64_t> dim,
+    const Tensor& out,
+    T* vals,
+    int64_t* indices) {
+  if (in.numel() == 0 || !tensor_is_default_dim_order(in) ||
+      !tensor_is_default_dim_order(out)) {
+    return reduce_over_dim_arg_reduce<kMax>(in, dim, out, vals, indices);
+  }
+  return parallel_arg_reduce<kMax>(ctx, in, dim, vals, indices);
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -150,6 +150,16 @@ inline ElementwiseOptimizedPath select_broadcast_optimized_path(
 }
 } // namespace internal
 
+namespace internal {
+inline bool
+can_treat_as_1d(const Tensor& a, const Tensor& b, const Tensor& out) {
+  return a.sizes().equals(b.sizes()) ||
+      (a.numel() == b.numel() &&
+       (a.numel() == out.numel() ||
+        sizes_match_ignoring_leading_1s(a.sizes(), b.sizes())));
+}
+} // namespace internal
+
 ElementwiseOptimizedPath inline select_optimized_path(
     const Tensor& a,
     const Tensor& b,
@@ -162,15 +172,77 @@ ElementwiseOptimizedPath inline select_optimized_path(
       a_type == ScalarType::BFloat16) {
     return ElementwiseOptimizedPath::kNone;
   }
-  if (a.sizes().equals(b.sizes()) ||
-      (a.numel() == b.numel() &&
-       (a.numel() == out.numel() ||
-        internal::sizes_match_ignoring_leading_1s(a.sizes(), b.sizes())))) {
+  if (internal::can_treat_as_1d(a, b, out)) {
     return ElementwiseOptimizedPath::kTreatAs1d;
   }
   return internal::select_broadcast_optimized_path(a, b);
 }
 
+/**
+ * Whether a, b and out all have the same Half or BFloat16 dtype and can be
+ * treated as 1d: the kTreatAs1d case of select_optimized_path(), which only
+ * considers types that have a Vectorized<T>. Such tensors can be computed
+ * with binary_op_via_float().
+ */
+inline bool can_treat_as_1d_via_float(
+    const Tensor& a,
+    const Tensor& b,
+    const Tensor& out) {
+  ScalarType a_type = a.scalar_type();
+  return a_type == b.scalar_type() && a_type == out.scalar_type() &&
+      (a_type == ScalarType::Half || a_type == ScalarType::BFloat16) &&
+      internal::can_treat_as_1d(a, b, out);
+}
+
+/**
+ * Computes out = op(a, b) elementwise for a Half or BFloat16 out. a has the
+ * dtype and the number of elements of out, and b is either a float scalar or
+ * a tensor of the same dtype that has a single element or can be treated as
+ * 1d together with a. Like the portable kernels, op computes in float on
+ * Vectorized<float> and every result is rounded once.
+ */
+template <const char* op_name, typename Op>
+void binary_op_via_float(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    const float b,
+    Tensor& out,
+    const Op& op) {
+  ET_SWITCH_TWO_TYPES(
+      Half, BFloat16, out.scalar_type(), ctx, op_name, CTYPE, [&]() {
+        using Vec = executorch::vec::Vectorized<float>;
+        const Vec b_vec(b);
+        executorch::vec::map_via_float<CTYPE>(
+            [&op, b_vec](Vec x) { return op(x, b_vec); },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            out.numel());
+      });
+}
+
+template <const char* op_name, typename Op>
+void binary_op_via_float(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    Tensor& out,
+    const Op& op) {
+  ET_SWITCH_TWO_TYPES(
+      Half, BFloat16, out.scalar_type(), ctx, op_name, CTYPE, [&]() {
+        if (b.numel() == 1) {
+          binary_op_via_float<op_name>(
+              ctx, a, static_cast<float>(*b.const_data_ptr<CTYPE>()), out, op);
+          return;
+        }
+        executorch::vec::map2_via_float<CTYPE>(
+            op,
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      });
+}
+
 std::array<int32_t, 3> inline get_normalized_tensor_size(
     const Tensor& a,
     const int32_t broadcast_dim) {
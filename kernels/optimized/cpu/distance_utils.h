@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Pairwise distances for cdist and pdist. Euclidean distances between many
+// rows use ||x||^2 + ||y||^2 - 2 x.y, with the dot products computed by a
+// GEMM. Other norms compare cache sized tiles of rows with vectorized
+// reductions.
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/distance_util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// With more rows than this on either side, Euclidean distances are
+/// computed with a GEMM, as ATen does for the default compute_mode.
+constexpr int64_t kDistanceMmThreshold = 25;
+/// The number of rows one task compares against all the others.
+constexpr int64_t kDistanceRowBlock = 32;
+/// The bytes of the rows that a tile keeps in cache while every row of the
+/// row block is compared against them.
+constexpr int64_t kDistanceTileBytes = 32 * 1024;
+
+/// Only float and double have vectorized reductions and GEMM accuracy that
+/// the Euclidean identity needs; Half and BFloat16 keep the scalar loops.
+template <typename CTYPE>
+constexpr bool kIsVectorizedDistanceType =
+    std::is_same_v<CTYPE, float> || std::is_same_v<CTYPE, double>;
+
+/// The vectorized counterpart of each norm of distance_util.h.
+template <typename Norm>
+struct VecNorm;
+
+template <typename CTYPE>
+struct VecNorm<L0<CTYPE>> {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  static Vec map(const Vec& a, const Vec& b, const Vec&) {
+    return (a != b) & Vec(1);
+  }
+  static Vec reduce(const Vec& agg, const Vec& up) {
+    return agg + up;
+  }
+};
+
+template <typename CTYPE>
+struct VecNorm<L1<CTYPE>> {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  static Vec map(const Vec& a, const Vec& b, const Vec&) {
+    return (a - b).abs();
+  }
+  static Vec reduce(const Vec& agg, const Vec& up) {
+    return agg + up;
+  }
+};
+
+template <typename CTYPE>
+struct VecNorm<L2<CTYPE>> {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  static Vec map(const Vec& a, const Vec& b, const Vec&) {
+    const Vec diff = a - b;
+    return diff * diff;
+  }
+  static Vec reduce(const Vec& agg, const Vec& up) {
+    return agg + up;
+  }
+};
+
+template <typename CTYPE>
+struct VecNorm<Lp<CTYPE>> {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  static Vec map(const Vec& a, const Vec& b, const Vec& p) {
+    return (a - b).abs().pow(p);
+  }
+  static Vec reduce(const Vec& agg, const Vec& up) {
+    return agg + up;
+  }
+};
+
+template <typename CTYPE>
+struct VecNorm<Linf<CTYPE>> {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  static Vec map(const Vec& a, const Vec& b, const Vec&) {
+    return (a - b).abs();
+  }
+  static Vec reduce(const Vec& agg, const Vec& up) {
+    return executorch::vec::maximum(agg, up);
+  }
+};
+
+/**
+ * Returns the distance between `a[0:m]` and `b[0:m]`.
+ */
+template <typename CTYPE, typename Norm>
+CTYPE row_distance(const CTYPE* a, const CTYPE* b, int64_t m, CTYPE p) {
+  if constexpr (kIsVectorizedDistanceType<CTYPE>) {
+    if (m == 0) {
+      return Norm::finish(0, p);
+    }
+    using V = VecNorm<Norm>;
+    const typename V::Vec p_vec(p);
+    const CTYPE agg = executorch::vec::map2_reduce_all<CTYPE>(
+        [&](const auto& x, const auto& y) { return V::map(x, y, p_vec); },
+        [](const auto& x, const auto& y) { return V::reduce(x, y); },
+        a,
+        b,
+        m);
+    return Norm::finish(agg, p);
+  } else {
+    CTYPE agg = 0;
+    for (const auto k : c10::irange(m)) {
+      CTYPE diff = std::abs(a[k] - b[k]);
+      agg = Norm::reduce(agg, Norm::map(diff, p));
+    }
+    return Norm::finish(agg, p);
+  }
+}
+
+/**
+ * Calls `fn(i, j, distance)` for the rows `i` in [i_begin, i_end) of `x1`
+ * and `j` in [j_begin, j_end) of `x2`, or only those with `j > i` if
+ * `upper`. Rows of `x2` are visited a tile at a time, so that each tile is
+ * read from cache by all the rows of `x1`.
+ */
+template <typename CTYPE, typename Norm, typename Fn>
+void distance_tiles(
+    const CTYPE* x1,
+    int64_t i_begin,
+    int64_t i_end,
+    const CTYPE* x2,
+    int64_t j_begin,
+    int64_t j_end,
+    int64_t m,
+    CTYPE p,
+    bool upper,
+    const Fn& fn) {
+  const int64_t tile_rows = std::max<int64_t>(
+      1, kDistanceTileBytes / std::max<int64_t>(1, m * sizeof(CTYPE)));
+  for (int64_t j0 = j_begin; j0 < j_end; j0 += tile_rows) {
+    const int64_t j1 = std::min(j0 + tile_rows, j_end);
+    for (const auto i : c10::irange(i_begin, i_end)) {
+      const CTYPE* row_i = x1 + i * m;
+      for (int64_t j = upper ? std::max(j0, i + 1) : j0; j < j1; ++j) {
+        fn(i, j, row_distance<CTYPE, Norm>(row_i, x2 + j * m, m, p));
+      }
+    }
+  }
+}
+
+/**
+ * Writes the squared L2 norms of the `n` rows of `x[n, m]` to `norms`.
+ */
+template <typename CTYPE>
+void squared_norms(const CTYPE* x, int64_t n, int64_t m, CTYPE* norms) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  for (const auto i : c10::irange(n)) {
+    norms[i] = m == 0 ? CTYPE(0)
+                      : executorch::vec::map_reduce_all<CTYPE>(
+                            [](const Vec& v) { return v * v; },
+                            [](const Vec& a, const Vec& b) { return a + b; },
+                            x + i * m,
+                            m);
+  }
+}
+
+/**
+ * Writes `-2 * x1[0:rows1] @ x2[0:rows2].T` to `out`, whose rows are `ldo`
+ * elements apart.
+ */
+template <typename CTYPE>
+void minus_two_gram(
+    const CTYPE* x1,
+    int64_t rows1,
+    const CTYPE* x2,
+    int64_t rows2,
+    int64_t m,
+    CTYPE* out,
+    int64_t ldo) {
+  // gemm is column-major, where the row-major out is out.T = x2 @ x1.T.
+  executorch::cpublas::gemm(
+      executorch::cpublas::TransposeType::Transpose,
+      executorch::cpublas::TransposeType::NoTranspose,
+      rows2,
+      rows1,
+      m,
+      static_cast<CTYPE>(-2),
+      x2,
+      m,
+      x1,
+      m,
+      static_cast<CTYPE>(0),
+      out,
+      ldo);
+}
+
+/**
+ * Returns the Euclidean distance given `-2 x.y` and the squared norms of x
+ * and y. Rounding can make the sum slightly negative, so it is clamped at 0.
+ */
+template <typename CTYPE>
+CTYPE euclidean_from_gram(CTYPE minus_two_dot, CTYPE norm1, CTYPE norm2) {
+  return std::sqrt(std::max<CTYPE>(norm1 + norm2 + minus_two_dot, 0));
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
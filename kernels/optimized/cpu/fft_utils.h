@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// Every file that includes pocketfft must see the same cache size, since the
+// plan cache is a static in an inline function. Keeping the plans of the last
+// few lengths lets repeated calls, like one per audio chunk, skip computing
+// twiddle factors.
+#ifndef POCKETFFT_CACHE_SIZE
+#define POCKETFFT_CACHE_SIZE 16
+#endif
+// Transforms are split between threads by parallel_fft() below instead.
+#ifndef POCKETFFT_NO_MULTITHREADING
+#define POCKETFFT_NO_MULTITHREADING
+#endif
+#include <pocketfft_hdronly.h>
+
+#include <algorithm>
+#include <optional>
+
+namespace torch::executor::native {
+
+// TODO: the helpers below down to compute_fct() are copy/pasted from
+// PyTorch core (aten/src/ATen/native/mkl/SpectralOps.cpp). Small
+// portions (the parts that don't depend on Tensor) could be reused;
+// refactor to enable that once we can share headers from PyTorch
+// core.
+inline pocketfft::stride_t stride_from_tensor(const Tensor& t) {
+  pocketfft::stride_t stride(t.strides().begin(), t.strides().end());
+  for (auto& s : stride) {
+    s *= t.element_size();
+  }
+  return stride;
+}
+
+inline pocketfft::shape_t shape_from_tensor(const Tensor& t) {
+  return pocketfft::shape_t(t.sizes().begin(), t.sizes().end());
+}
+
+// NOTE: The reinterpret_cast in tensor_cdata is UB, but it's what
+// PyTorch core does and I'm not aware of a portable way to do this
+// that doesn't rely on UB.
+template <typename T>
+inline std::complex<T>* tensor_cdata(Tensor& t) {
+  return reinterpret_cast<std::complex<T>*>(
+      t.data_ptr<executorch::runtime::etensor::complex<T>>());
+}
+
+template <typename T>
+inline const std::complex<T>* tensor_cdata(const Tensor& t) {
+  return reinterpret_cast<const std::complex<T>*>(
+      t.const_data_ptr<executorch::runtime::etensor::complex<T>>());
+}
+
+// NOTE: in particular this is in ATen/native/SpectralOpsUtils.h and
+// could be shared immediately.
+enum class fft_norm_mode {
+  none, // No normalization
+  by_root_n, // Divide by sqrt(signal_size)
+  by_n, // Divide by signal_size
+};
+
+// NOTE: slight fork from upstream PyTorch to use ET_KERNEL_CHECK;
+// upstream with TORCH_CHECK will be fine to use once we have code
+// sharing.
+template <typename T>
+std::optional<T>
+compute_fct(KernelRuntimeContext& ctx, int64_t size, int64_t normalization) {
+  constexpr auto one = static_cast<T>(1);
+  switch (static_cast<fft_norm_mode>(normalization)) {
+    case fft_norm_mode::none:
+      return one;
+    case fft_norm_mode::by_n:
+      return one / static_cast<T>(size);
+    case fft_norm_mode::by_root_n:
+      return one / std::sqrt(static_cast<T>(size));
+  }
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      false,
+      InvalidArgument,
+      std::nullopt,
+      "Unsupported normalization type: %" PRId64,
+      normalization);
+}
+
+template <typename T>
+std::optional<T> compute_fct(
+    KernelRuntimeContext& ctx,
+    const Tensor& t,
+    IntArrayRef dim,
+    int64_t normalization) {
+  if (static_cast<fft_norm_mode>(normalization) == fft_norm_mode::none) {
+    return static_cast<T>(1);
+  }
+  const auto& sizes = t.sizes();
+  int64_t n = 1;
+  for (auto idx : dim) {
+    n *= sizes[idx];
+  }
+  return compute_fct<T>(ctx, n, normalization);
+}
+
+/// Whether each of `dim` is a dim of `t`.
+inline bool check_fft_dims(const Tensor& t, IntArrayRef dim) {
+  for (const auto d : dim) {
+    ET_CHECK_OR_RETURN_FALSE(
+        d >= 0 && d < t.dim(), "dims must be in bounds (got %" PRId64 ")", d);
+  }
+  return true;
+}
+
+/**
+ * Computes the transforms of `in` into `out` over the dims `dim`, splitting
+ * the batch of independent transforms between threads: each thread calls
+ *
+ *   fn(in_shape, out_shape, in_data, out_data)
+ *
+ * with the shapes and data pointers of its slice of the largest dim that is
+ * not transformed, which is what the pocketfft functions take. `in` and `out`
+ * may only differ in size along the dims in `dim`.
+ */
+template <typename TIn, typename TOut, typename Fn>
+bool parallel_fft(
+    const Tensor& in,
+    const Tensor& out,
+    IntArrayRef dim,
+    const TIn* in_data,
+    TOut* out_data,
+    const Fn& fn) {
+  if (in.numel() == 0 || out.numel() == 0) {
+    return true;
+  }
+
+  int64_t batch_dim = -1;
+  for (const auto d : c10::irange(in.dim())) {
+    if (std::find(dim.begin(), dim.end(), d) == dim.end() &&
+        (batch_dim < 0 || in.size(d) > in.size(batch_dim))) {
+      batch_dim = d;
+    }
+  }
+
+  const pocketfft::shape_t in_shape = shape_from_tensor(in);
+  const pocketfft::shape_t out_shape = shape_from_tensor(out);
+  if (batch_dim < 0 || in.size(batch_dim) == 1) {
+    fn(in_shape, out_shape, in_data, out_data);
+    return true;
+  }
+
+  const int64_t batch_size = in.size(batch_dim);
+  const int64_t in_stride = in.strides()[batch_dim];
+  const int64_t out_stride = out.strides()[batch_dim];
+  const int64_t slice_numel = std::max(in.numel(), out.numel()) / batch_size;
+  const int64_t grain_size = std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / slice_numel);
+  return ::executorch::extension::parallel_for(
+      0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+        pocketfft::shape_t slice_in_shape = in_shape;
+        pocketfft::shape_t slice_out_shape = out_shape;
+        slice_in_shape[batch_dim] = end - begin;
+        slice_out_shape[batch_dim] = end - begin;
+        fn(slice_in_shape,
+           slice_out_shape,
+           in_data + begin * in_stride,
+           out_data + begin * out_stride);
+      });
+}
+
+} // namespace torch::executor::native
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Row gathers for embedding, index_select and gather. Lookups are split
+// between threads, and the rows a few lookups ahead are prefetched so that
+// several cache misses are in flight at once instead of one per row.
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// How many lookups ahead of the current one to prefetch.
+constexpr int64_t kGatherPrefetchDistance = 8;
+/// At most this many bytes of each upcoming row are prefetched, so that a
+/// long row doesn't evict the rows that are about to be copied.
+constexpr int64_t kGatherMaxPrefetchBytes = 1024;
+constexpr int64_t kCacheLineBytes = 64;
+
+inline void prefetch_for_read(const void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(ptr, /*rw=*/0, /*locality=*/1);
+#else
+  (void)ptr;
+#endif
+}
+
+inline void prefetch_row(const char* row, int64_t row_bytes) {
+  const int64_t nbytes = std::min(row_bytes, kGatherMaxPrefetchBytes);
+  for (int64_t offset = 0; offset < nbytes; offset += kCacheLineBytes) {
+    prefetch_for_read(row + offset);
+  }
+}
+
+/// gather_rows() for rows of one ELEMENT_T, which are copied by assignment
+/// rather than memcpy.
+template <typename ELEMENT_T, typename INDEX_T>
+[[nodiscard]] bool gather_single_elements(
+    const ELEMENT_T* src,
+    int64_t src_block_size,
+    const INDEX_T* indices,
+    int64_t num_indices,
+    int64_t num_blocks,
+    ELEMENT_T* dst) {
+  return executorch::extension::parallel_for(
+      0,
+      num_blocks * num_indices,
+      executorch::extension::internal::GRAIN_SIZE,
+      [&](const auto begin, const auto end) {
+        for (const auto i : c10::irange(begin, end)) {
+          const int64_t block = i / num_indices;
+          dst[i] = src[block * src_block_size + indices[i % num_indices]];
+        }
+      });
+}
+
+} // namespace internal
+
+/**
+ * Copies rows between num_blocks pairs of blocks: src block b starts at
+ * src + b * src_block_bytes, dst block b starts at
+ * dst + b * num_indices * row_bytes, and row i of each dst block is a copy
+ * of row indices[i] of the matching src block. All rows are contiguous and
+ * row_bytes long, and the indices must already be in range.
+ *
+ * Returns false if parallel_for failed.
+ */
+template <typename INDEX_T>
+[[nodiscard]] bool gather_rows(
+    const char* src,
+    int64_t src_block_bytes,
+    const INDEX_T* indices,
+    int64_t num_indices,
+    int64_t row_bytes,
+    int64_t num_blocks,
+    char* dst) {
+  if (num_indices == 0 || row_bytes == 0 || num_blocks == 0) {
+    return true;
+  }
+  // Rows of a single element, e.g. index_select along the innermost dim,
+  // are too short for memcpy or prefetching to pay off.
+  if (src_block_bytes % row_bytes == 0) {
+    const int64_t src_block_size = src_block_bytes / row_bytes;
+    switch (row_bytes) {
+      case 2:
+        return internal::gather_single_elements(
+            reinterpret_cast<const uint16_t*>(src),
+            src_block_size,
+            indices,
+            num_indices,
+            num_blocks,
+            reinterpret_cast<uint16_t*>(dst));
+      case 4:
+        return internal::gather_single_elements(
+            reinterpret_cast<const uint32_t*>(src),
+            src_block_size,
+            indices,
+            num_indices,
+            num_blocks,
+            reinterpret_cast<uint32_t*>(dst));
+      case 8:
+        return internal::gather_single_elements(
+            reinterpret_cast<const uint64_t*>(src),
+            src_block_size,
+            indices,
+            num_indices,
+            num_blocks,
+            reinterpret_cast<uint64_t*>(dst));
+      default:
+        break;
+    }
+  }
+
+  using internal::kGatherPrefetchDistance;
+  return executorch::extension::parallel_for(
+      0,
+      num_blocks * num_indices,
+      std::max<int64_t>(
+          1, executorch::extension::internal::GRAIN_SIZE / row_bytes),
+      [&](const auto begin, const auto end) {
+        for (const auto i : c10::irange(begin, end)) {
+          if (i + kGatherPrefetchDistance < end) {
+            const int64_t ahead = i + kGatherPrefetchDistance;
+            internal::prefetch_row(
+                src + ahead / num_indices * src_block_bytes +
+                    indices[ahead % num_indices] * row_bytes,
+                row_bytes);
+          }
+          const int64_t block = i / num_indices;
+          std::memcpy(
+              dst + i * row_bytes,
+              src + block * src_block_bytes +
+                  indices[i % num_indices] * row_bytes,
+              row_bytes);
+        }
+      });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Two-pass parallel stream compaction for nonzero, masked_select and
+// masked_scatter. Every block of elements first counts what it selects, in
+// parallel. The counts are then turned into the offset each block starts at
+// in the compacted data, and every block writes its part in parallel.
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// The number of elements in every block but the last.
+constexpr int64_t kCompactionBlockSize =
+    ::executorch::extension::internal::GRAIN_SIZE;
+
+/**
+ * Returns the number of true elements of `mask[0:numel]`.
+ */
+inline int64_t count_true(const bool* mask, int64_t numel) {
+  // Summing bytes instead of branching lets the compiler vectorize this.
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(mask);
+  int64_t count = 0;
+  for (const auto i : c10::irange(numel)) {
+    count += bytes[i] != 0;
+  }
+  return count;
+}
+
+/**
+ * The offsets at which the blocks of `numel` elements start in the
+ * compacted data, which live in the temp memory of `ctx`.
+ */
+class BlockOffsets final {
+ public:
+  BlockOffsets(KernelRuntimeContext& ctx, int64_t numel)
+      : numel_(numel),
+        num_blocks_(
+            (numel + kCompactionBlockSize - 1) / kCompactionBlockSize),
+        offsets_(allocate_scratch<int64_t>(ctx, num_blocks_ + 1)) {}
+
+  /// Whether the offsets could be allocated. The other methods must only be
+  /// called if so.
+  bool ok() const {
+    return offsets_ != nullptr;
+  }
+
+  /**
+   * Counts the elements every block selects in parallel, with
+   * `count(begin, end)`, which returns the number selected in
+   * [begin, end).
+   *
+   * @returns false if parallel_for failed.
+   */
+  template <typename Count>
+  [[nodiscard]] bool count(const Count& count) {
+    const bool success = ::executorch::extension::parallel_for(
+        0, num_blocks_, 1, [&](const auto begin, const auto end) {
+          for (const auto block : c10::irange(begin, end)) {
+            const int64_t start = block * kCompactionBlockSize;
+            offsets_[block + 1] = count(start, block_end(start));
+          }
+        });
+    offsets_[0] = 0;
+    for (const auto block : c10::irange(num_blocks_)) {
+      offsets_[block + 1] += offsets_[block];
+    }
+    return success;
+  }
+
+  /// The number of elements selected by all blocks. Valid after count().
+  int64_t total() const {
+    return offsets_[num_blocks_];
+  }
+
+  /**
+   * Writes every block in parallel, with `write(begin, end, offset)`, where
+   * `offset` is the number of elements selected before `begin`. Valid after
+   * count().
+   *
+   * @returns false if parallel_for failed.
+   */
+  template <typename Write>
+  [[nodiscard]] bool write(const Write& write) const {
+    return ::executorch::extension::parallel_for(
+        0, num_blocks_, 1, [&](const auto begin, const auto end) {
+          for (const auto block : c10::irange(begin, end)) {
+            const int64_t start = block * kCompactionBlockSize;
+            write(start, block_end(start), offsets_[block]);
+          }
+        });
+  }
+
+ private:
+  int64_t block_end(int64_t start) const {
+    return std::min(start + kCompactionBlockSize, numel_);
+  }
+
+  int64_t numel_;
+  int64_t num_blocks_;
+  int64_t* offsets_;
+};
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
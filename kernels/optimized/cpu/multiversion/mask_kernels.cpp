@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This file is compiled once per CPU capability; see dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/multiversion/mask_kernels.h>
+
+#include <array>
+#include <cstdint>
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+#include <immintrin.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// The mask bits of 16 bools, for 32-bit lanes.
+__mmask16 mask16(const bool* mask) {
+  const __m512i m = _mm512_cvtepu8_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+  return _mm512_test_epi32_mask(m, m);
+}
+
+// The mask bits of 8 bools, for 64-bit lanes.
+__mmask8 mask8(const bool* mask) {
+  const __m512i m = _mm512_cvtepu8_epi64(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask)));
+  return _mm512_test_epi64_mask(m, m);
+}
+
+#elif defined(CPU_CAPABILITY_AVX2)
+
+// For every 8-bit mask, the lanes whose bit is set, in order, 4 bits each.
+constexpr std::array<uint32_t, 256> make_compress_lanes() {
+  std::array<uint32_t, 256> lanes{};
+  for (uint32_t m = 0; m < 256; ++m) {
+    uint32_t packed = 0;
+    uint32_t count = 0;
+    for (uint32_t lane = 0; lane < 8; ++lane) {
+      if (m & (1u << lane)) {
+        packed |= lane << (4 * count++);
+      }
+    }
+    lanes[m] = packed;
+  }
+  return lanes;
+}
+
+constexpr std::array<uint32_t, 256> kCompressLanes = make_compress_lanes();
+
+#endif
+
+template <typename T>
+size_t compress(const T* in, const bool* mask, size_t numel, T* out) {
+  size_t i = 0;
+  size_t j = 0;
+#if defined(CPU_CAPABILITY_AVX512)
+  // vpcompress writes only the selected lanes, so it never runs past them.
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 16 <= numel; i += 16) {
+      const __mmask16 m = mask16(mask + i);
+      _mm512_mask_compressstoreu_epi32(
+          out + j, m, _mm512_loadu_si512(in + i));
+      j += __builtin_popcount(m);
+    }
+  } else if constexpr (sizeof(T) == 8) {
+    for (; i + 8 <= numel; i += 8) {
+      const __mmask8 m = mask8(mask + i);
+      _mm512_mask_compressstoreu_epi64(
+          out + j, m, _mm512_loadu_si512(in + i));
+      j += __builtin_popcount(m);
+    }
+  }
+#elif defined(CPU_CAPABILITY_AVX2)
+  // Moves the selected lanes to the front with a permutation looked up from
+  // the mask, then stores only as many lanes as were selected.
+  if constexpr (sizeof(T) == 4) {
+    const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i seven = _mm256_set1_epi32(7);
+    for (; i + 8 <= numel; i += 8) {
+      const __m128i bools =
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i));
+      const uint32_t m =
+          ~_mm_movemask_epi8(_mm_cmpeq_epi8(bools, _mm_setzero_si128())) &
+          0xff;
+      const __m256i lanes = _mm256_and_si256(
+          _mm256_srlv_epi32(_mm256_set1_epi32(kCompressLanes[m]), shifts),
+          seven);
+      const __m256i packed = _mm256_permutevar8x32_epi32(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)),
+          lanes);
+      const int count = __builtin_popcount(m);
+      _mm256_maskstore_epi32(
+          reinterpret_cast<int*>(out + j),
+          _mm256_cmpgt_epi32(_mm256_set1_epi32(count), iota),
+          packed);
+      j += count;
+    }
+  }
+#endif
+  for (; i < numel; ++i) {
+    if (mask[i]) {
+      out[j++] = in[i];
+    }
+  }
+  return j;
+}
+
+template <typename T>
+size_t expand(
+    const T* in,
+    const bool* mask,
+    const T* src,
+    size_t numel,
+    T* out) {
+  size_t i = 0;
+  size_t j = 0;
+#if defined(CPU_CAPABILITY_AVX512)
+  // vpexpand reads only as many elements of src as there are selected lanes.
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 16 <= numel; i += 16) {
+      const __mmask16 m = mask16(mask + i);
+      const __m512i vals = _mm512_mask_expandloadu_epi32(
+          _mm512_loadu_si512(in + i), m, src + j);
+      _mm512_storeu_si512(out + i, vals);
+      j += __builtin_popcount(m);
+    }
+  } else if constexpr (sizeof(T) == 8) {
+    for (; i + 8 <= numel; i += 8) {
+      const __mmask8 m = mask8(mask + i);
+      const __m512i vals = _mm512_mask_expandloadu_epi64(
+          _mm512_loadu_si512(in + i), m, src + j);
+      _mm512_storeu_si512(out + i, vals);
+      j += __builtin_popcount(m);
+    }
+  }
+#endif
+  for (; i < numel; ++i) {
+    out[i] = mask[i] ? src[j++] : in[i];
+  }
+  return j;
+}
+
+size_t masked_select_kernel(
+    const void* in,
+    const bool* mask,
+    size_t numel,
+    size_t element_size,
+    void* out) {
+  switch (element_size) {
+    case 1:
+      return compress(
+          static_cast<const uint8_t*>(in),
+          mask,
+          numel,
+          static_cast<uint8_t*>(out));
+    case 2:
+      return compress(
+          static_cast<const uint16_t*>(in),
+          mask,
+          numel,
+          static_cast<uint16_t*>(out));
+    case 4:
+      return compress(
+          static_cast<const uint32_t*>(in),
+          mask,
+          numel,
+          static_cast<uint32_t*>(out));
+    default:
+      ET_DCHECK(element_size == 8);
+      return compress(
+          static_cast<const uint64_t*>(in),
+          mask,
+          numel,
+          static_cast<uint64_t*>(out));
+  }
+}
+
+size_t masked_scatter_kernel(
+    const void* in,
+    const bool* mask,
+    const void* src,
+    size_t numel,
+    size_t element_size,
+    void* out) {
+  switch (element_size) {
+    case 1:
+      return expand(
+          static_cast<const uint8_t*>(in),
+          mask,
+          static_cast<const uint8_t*>(src),
+          numel,
+          static_cast<uint8_t*>(out));
+    case 2:
+      return expand(
+          static_cast<const uint16_t*>(in),
+          mask,
+          static_cast<const uint16_t*>(src),
+          numel,
+          static_cast<uint16_t*>(out));
+    case 4:
+      return expand(
+          static_cast<const uint32_t*>(in),
+          mask,
+          static_cast<const uint32_t*>(src),
+          numel,
+          static_cast<uint32_t*>(out));
+    default:
+      ET_DCHECK(element_size == 8);
+      return expand(
+          static_cast<const uint64_t*>(in),
+          mask,
+          static_cast<const uint64_t*>(src),
+          numel,
+          static_cast<uint64_t*>(out));
+  }
+}
+
+} // namespace
+
+ET_REGISTER_DISPATCH(masked_select_stub, &masked_select_kernel);
+ET_REGISTER_DISPATCH(masked_scatter_stub, &masked_scatter_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/kernels/optimized/dispatch/dispatch_stub.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Copies the elements of `in[0:numel]` whose `mask` is true to the front of
+ * `out`, in order, and returns how many were copied. Elements are
+ * `element_size` bytes. Nothing past the copied elements of `out` is
+ * written, so that neighboring ranges of `out` can be filled concurrently.
+ */
+using compress_fn = size_t (*)(
+    const void* in,
+    const bool* mask,
+    size_t numel,
+    size_t element_size,
+    void* out);
+
+/**
+ * The inverse of compress: writes the next element of `src` to every
+ * position of `out[0:numel]` whose `mask` is true, and `in` elsewhere.
+ * Returns how many elements of `src` were read.
+ */
+using expand_fn = size_t (*)(
+    const void* in,
+    const bool* mask,
+    const void* src,
+    size_t numel,
+    size_t element_size,
+    void* out);
+
+// Multi-versioned by the build; see dispatch_stub.h. Defined in op_<name>.cpp.
+ET_DECLARE_DISPATCH(compress_fn, masked_select_stub);
+ET_DECLARE_DISPATCH(expand_fn, masked_scatter_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
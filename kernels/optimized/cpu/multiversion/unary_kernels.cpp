@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This file is compiled once per CPU capability; see dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/multiversion/unary_kernels.h>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <type_traits>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+using executorch::aten::ScalarType;
+
+template <typename CTYPE, typename Op>
+void map_contiguous(const void* in, void* out, size_t numel, const Op& op) {
+  executorch::vec::map<CTYPE>(
+      op, static_cast<CTYPE*>(out), static_cast<const CTYPE*>(in), numel);
+}
+
+// Computes Half and BFloat16 in float; see Note [Reduced precision through
+// float].
+template <typename CTYPE, typename Op>
+void map_contiguous_via_float(
+    const void* in,
+    void* out,
+    size_t numel,
+    const Op& op) {
+  executorch::vec::map_via_float<CTYPE>(
+      op, static_cast<CTYPE*>(out), static_cast<const CTYPE*>(in), numel);
+}
+
+template <typename Op>
+void map_floating(
+    ScalarType dtype,
+    const void* in,
+    void* out,
+    size_t numel,
+    const Op& op) {
+  switch (dtype) {
+    case ScalarType::Double:
+      map_contiguous<double>(in, out, numel, op);
+      break;
+    case ScalarType::Half:
+      map_contiguous_via_float<executorch::aten::Half>(in, out, numel, op);
+      break;
+    case ScalarType::BFloat16:
+      map_contiguous_via_float<executorch::aten::BFloat16>(
+          in, out, numel, op);
+      break;
+    default:
+      ET_DCHECK(dtype == ScalarType::Float);
+      map_contiguous<float>(in, out, numel, op);
+      break;
+  }
+}
+
+/**
+ * On x86, Vectorized<float>::erf() is the approximation 7.1.26 of Abramowitz
+ * and Stegun, whose absolute error of 1.5e-7 is a large relative error near
+ * zero. Below 1 in magnitude this uses the Taylor series of erf up to x^21
+ * instead, whose truncation error is below 2e-9 relative there. The result
+ * is then within 2.5e-7 relative error, or 4 ULP, everywhere. Elsewhere
+ * erf() is Sleef's 1 ULP erf or std::erf, and is used as is.
+ */
+template <typename Vec>
+Vec erf_vec(const Vec& x) {
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+  if constexpr (std::is_same_v<typename Vec::value_type, float>) {
+    using executorch::vec::fmadd;
+    const Vec x2 = x * x;
+    Vec p = Vec(1.4807192815879218e-8f);
+    p = fmadd(p, x2, Vec(-1.6365844691234924e-7f));
+    p = fmadd(p, x2, Vec(1.6462114365889246e-6f));
+    p = fmadd(p, x2, Vec(-1.492565035840625e-5f));
+    p = fmadd(p, x2, Vec(1.2055332981789664e-4f));
+    p = fmadd(p, x2, Vec(-8.548327023450852e-4f));
+    p = fmadd(p, x2, Vec(5.223977625442188e-3f));
+    p = fmadd(p, x2, Vec(-2.6866170645131252e-2f));
+    p = fmadd(p, x2, Vec(1.1283791670955126e-1f));
+    p = fmadd(p, x2, Vec(-3.7612638903183754e-1f));
+    p = fmadd(p, x2, Vec(1.1283791670955126f));
+    return Vec::blendv(x.erf(), x * p, x.abs() < Vec(1.0f));
+  }
+#endif
+  return x.erf();
+}
+
+void erf_kernel(ScalarType dtype, const void* in, void* out, size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) { return erf_vec(x); });
+}
+
+void exp_kernel(ScalarType dtype, const void* in, void* out, size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) { return x.exp(); });
+}
+
+void expm1_kernel(ScalarType dtype, const void* in, void* out, size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) { return x.expm1(); });
+}
+
+void log_kernel(ScalarType dtype, const void* in, void* out, size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) { return x.log(); });
+}
+
+void log1p_kernel(ScalarType dtype, const void* in, void* out, size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) { return x.log1p(); });
+}
+
+void sigmoid_kernel(
+    ScalarType dtype,
+    const void* in,
+    void* out,
+    size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) {
+    using Vec = decltype(x);
+    using CTYPE = typename Vec::value_type;
+    auto one_plus_exp = x.neg().exp() + Vec(static_cast<CTYPE>(1.0));
+    return one_plus_exp.reciprocal();
+  });
+}
+
+void tanh_kernel(ScalarType dtype, const void* in, void* out, size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) { return x.tanh(); });
+}
+
+} // namespace
+
+ET_REGISTER_DISPATCH(erf_stub, &erf_kernel);
+ET_REGISTER_DISPATCH(exp_stub, &exp_kernel);
+ET_REGISTER_DISPATCH(expm1_stub, &expm1_kernel);
+ET_REGISTER_DISPATCH(log_stub, &log_kernel);
+ET_REGISTER_DISPATCH(log1p_stub, &log1p_kernel);
+ET_REGISTER_DISPATCH(sigmoid_stub, &sigmoid_kernel);
+ET_REGISTER_DISPATCH(tanh_stub, &tanh_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/kernels/optimized/dispatch/dispatch_stub.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Applies an element-wise function to `numel` contiguous elements of `in`,
+ * writing them to `out`. Both buffers hold elements of `dtype`, which must be
+ * Float or Double, or Half or BFloat16, which are computed in float.
+ *
+ * The vectorized math these use is that of the vec library: for float and
+ * double on AVX2, AVX-512 and aarch64 with Sleef, exp, expm1, log, log1p and
+ * tanh are within 1 ULP of the correctly rounded result, and elsewhere they
+ * are the libm functions applied to each lane. See erf_kernel() for erf.
+ */
+using unary_fn = void (*)(
+    executorch::aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    size_t numel);
+
+// Multi-versioned by the build; see dispatch_stub.h. Defined in op_<name>.cpp.
+ET_DECLARE_DISPATCH(unary_fn, erf_stub);
+ET_DECLARE_DISPATCH(unary_fn, exp_stub);
+ET_DECLARE_DISPATCH(unary_fn, expm1_stub);
+ET_DECLARE_DISPATCH(unary_fn, log_stub);
+ET_DECLARE_DISPATCH(unary_fn, log1p_stub);
+ET_DECLARE_DISPATCH(unary_fn, sigmoid_stub);
+ET_DECLARE_DISPATCH(unary_fn, tanh_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/permute_utils.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include <numeric>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+template <typename T>
+using OptionalArrayRef = executorch::aten::OptionalArrayRef<T>;
+
+// _to_dim_order_copy.out(Tensor self, *, bool non_blocking=False, int[]?
+// dim_order=None, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt__to_dim_order_copy_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    bool non_blocking,
+    OptionalArrayRef<int64_t> dim_order,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check__to_dim_order_copy_args(self, non_blocking, dim_order, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, self.sizes()) == torch::executor::Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (self.numel() == 0) {
+    return out;
+  }
+
+  // Same index in self and out should have same value, no matter the order
+  // of dimensions.
+  int64_t dims[kTensorDimensionLimit];
+  std::iota(dims, dims + self.dim(), 0);
+  const PermutedCopyShape shape = make_permuted_copy_shape(self, out, dims);
+
+  if (self.scalar_type() == out.scalar_type()) {
+    ET_SWITCH_REALHBBF16_TYPES(
+        self.scalar_type(),
+        ctx,
+        "dim_order_ops::_to_dim_order_copy.out",
+        CTYPE,
+        [&] {
+          const bool success = permuted_copy<sizeof(CTYPE)>(
+              shape, self.const_data_ptr(), out.mutable_data_ptr());
+          ET_KERNEL_CHECK_MSG(
+              ctx, success, Internal, , "parallel_for failed");
+        });
+    return out;
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(
+      self.scalar_type(),
+      ctx,
+      "dim_order_ops::_to_dim_order_copy.out",
+      CTYPE_IN,
+      [&] {
+        ET_SWITCH_REALHBBF16_TYPES(
+            out.scalar_type(),
+            ctx,
+            "dim_order_ops::_to_dim_order_copy.out",
+            CTYPE_OUT,
+            [&] {
+              permuted_convert(
+                  shape,
+                  self.const_data_ptr<CTYPE_IN>(),
+                  out.mutable_data_ptr<CTYPE_OUT>());
+            });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -31,6 +31,7 @@ Tensor& opt_add_out(
   ScalarType a_type = a.scalar_type();
   ScalarType b_type = b.scalar_type();
   ScalarType out_type = out.scalar_type();
+  static constexpr const char op_name[] = "add.out";
 
   if (b.numel() == 1) {
     if (a_type == b_type && a_type == out_type && a_type != ScalarType::Half &&
@@ -62,12 +63,32 @@ Tensor& opt_add_out(
         });
       });
       return out;
+    } else if (
+        a_type == b_type && a_type == out_type &&
+        (a_type == ScalarType::Half || a_type == ScalarType::BFloat16)) {
+      ET_KERNEL_CHECK(
+          ctx,
+          resize_to_broadcast_target_size(a, b, out) == Error::Ok,
+          InvalidArgument,
+          out);
+
+      float alpha_val;
+      ET_KERNEL_CHECK(
+          ctx,
+          torch::executor::native::utils::extract_scalar(alpha, &alpha_val),
+          InvalidArgument,
+          out);
+      using Vec = executorch::vec::Vectorized<float>;
+      binary_op_via_float<op_name>(
+          ctx, a, b, out, [alpha_val](Vec x, Vec y) {
+            return x + Vec(alpha_val) * y;
+          });
+      return out;
     }
   } else if (a.numel() == 1) {
     return opt_add_out(ctx, b, a, alpha, out);
   }
 
-  static constexpr const char op_name[] = "add.out";
   return torch::executor::kernels::impl::opt_add_sub_out_impl<false, op_name>(
       ctx, a, b, alpha, out);
 }
@@ -116,6 +137,24 @@ Tensor& opt_add_scalar_out(
             out.numel());
       });
     });
+  } else if (
+      a_type == out_type &&
+      (a_type == ScalarType::Half || a_type == ScalarType::BFloat16)) {
+    ET_SWITCH_SCALAR_OBJ_TYPES(b_type, ctx, "add.Scalar_out", CTYPE_B, [&]() {
+      CTYPE_B b_val;
+      ET_EXTRACT_SCALAR(b, b_val);
+      float alpha_val;
+      ET_EXTRACT_SCALAR(alpha, alpha_val);
+
+      static constexpr const char op_name[] = "add.Scalar_out";
+      using Vec = executorch::vec::Vectorized<float>;
+      binary_op_via_float<op_name>(
+          ctx,
+          a,
+          static_cast<float>(b_val),
+          out,
+          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; });
+    });
   } else {
     ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "add.Scalar_out", CTYPE_A, [&]() {
       ET_SWITCH_SCALAR_OBJ_TYPES(b_type, ctx, "add.Scalar_out", CTYPE_B, [&]() {
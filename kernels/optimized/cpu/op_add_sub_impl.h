@@ -173,6 +173,28 @@ Tensor& opt_add_sub_out_impl(
         }
       }
     });
+  } else if (can_treat_as_1d_via_float(a, b, out)) {
+    auto error = resize_tensor(out, a.sizes());
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        error == Error::Ok,
+        InvalidArgument,
+        out,
+        "Failed to resize output tensor.");
+
+    float alpha_val;
+    ET_KERNEL_CHECK(
+        ctx,
+        torch::executor::native::utils::extract_scalar(alpha, &alpha_val),
+        InvalidArgument,
+        out);
+    if constexpr (is_sub) {
+      alpha_val = -alpha_val;
+    }
+    using Vec = executorch::vec::Vectorized<float>;
+    binary_op_via_float<op_name>(ctx, a, b, out, [alpha_val](Vec x, Vec y) {
+      return x + Vec(alpha_val) * y;
+    });
   } else {
     ScalarType common_type =
         promoteTypes(a_type, b_type, /*half_to_float*/ true);
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/arg_reduce_utils.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using executorch::aten::optional;
+using executorch::aten::Tensor;
+
+Tensor& opt_argmin_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    optional<int64_t> dim,
+    bool keepdim,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_argmin_argmax_args(in, dim, keepdim, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "argmin.out", CTYPE, [&] {
+    const bool success = internal::arg_reduce</*kMax=*/false, CTYPE>(
+        ctx, in, dim, out, nullptr, out.mutable_data_ptr<int64_t>());
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/pool2d_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+using internal::Pool2dWindow;
+
+/**
+ * Writes the sum of the window divided by `divisor` for `num_channels`
+ * contiguous channels. Like the portable kernel, the sum is accumulated in
+ * CTYPE, in window order.
+ *
+ * WINDOW_SIZE is the number of positions of the window when it is known at
+ * compile time, so that the loops over it are unrolled, or 0.
+ */
+template <typename CTYPE, int64_t WINDOW_SIZE>
+void avg_pool_window(
+    const Pool2dWindow& window,
+    const CTYPE* in,
+    int64_t num_channels,
+    int64_t divisor,
+    CTYPE* out) {
+  const int64_t size = WINDOW_SIZE > 0 ? WINDOW_SIZE : window.size;
+  const int64_t* const offsets = window.offsets;
+  const CTYPE ctype_divisor = static_cast<CTYPE>(divisor);
+  if (size == 0) {
+    // No position of the window is inside the input.
+    for (const auto c : c10::irange(num_channels)) {
+      out[c] = CTYPE(0) / ctype_divisor;
+    }
+    return;
+  }
+
+  int64_t c = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    for (; c + Vec::size() <= num_channels; c += Vec::size()) {
+      Vec sum = Vec::loadu(in + offsets[0] + c);
+      for (int64_t i = 1; i < size; ++i) {
+        sum = Vec::loadu(in + offsets[i] + c) + sum;
+      }
+      (sum / Vec(ctype_divisor)).store(out + c);
+    }
+  }
+  for (; c < num_channels; ++c) {
+    CTYPE sum = in[offsets[0] + c];
+    for (int64_t i = 1; i < size; ++i) {
+      sum = static_cast<CTYPE>(in[offsets[i] + c] + sum);
+    }
+    out[c] = sum / ctype_divisor;
+  }
+}
+
+template <typename CTYPE>
+bool avg_pool2d(
+    KernelRuntimeContext& ctx,
+    const internal::Pool2dParams& params,
+    bool channels_last,
+    bool count_include_pad,
+    const executorch::aten::optional<int64_t>& divisor_override,
+    const Tensor& in,
+    Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  return internal::for_each_pool2d_window(
+      ctx,
+      params,
+      count_include_pad,
+      channels_last,
+      [&](const Pool2dWindow& window,
+          int64_t in_offset,
+          int64_t /*base_index*/,
+          int64_t out_offset,
+          int64_t num_channels) {
+        const CTYPE* const window_in = in_data + in_offset;
+        CTYPE* const window_out = out_data + out_offset;
+        const int64_t divisor = divisor_override.has_value()
+            ? divisor_override.value()
+            : window.count;
+        // Unrolled loops for the common 2x2 and 3x3 windows.
+        if (window.size == 4) {
+          avg_pool_window<CTYPE, 4>(
+              window, window_in, num_channels, divisor, window_out);
+        } else if (window.size == 9) {
+          avg_pool_window<CTYPE, 9>(
+              window, window_in, num_channels, divisor, window_out);
+        } else {
+          avg_pool_window<CTYPE, 0>(
+              window, window_in, num_channels, divisor, window_out);
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_avg_pool2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    executorch::aten::optional<int64_t> divisor_override,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_avg_pool2d_args(
+          in,
+          kernel_size,
+          stride,
+          padding,
+          ceil_mode,
+          count_include_pad,
+          divisor_override,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_avg_pool2d_out_target_size(
+      in, kernel_size, stride, padding, ceil_mode, output_sizes, &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // Unlike the portable kernel, channels last inputs are supported, and
+  // vectorized along the channels.
+  const auto params = internal::make_pool2d_params(
+      in, out, kernel_size, stride, padding, /*dilation=*/{});
+  const bool channels_last = in.dim() == 4 && params.in_strides[1] == 1 &&
+      params.out_strides[1] == 1 && params.channels > 1;
+
+  ScalarType in_type = in.scalar_type();
+  ET_SWITCH_FLOATHBF16_TYPES_AND(
+      Long, in_type, ctx, "avg_pool2d.out", CTYPE, [&]() {
+        const bool success = avg_pool2d<CTYPE>(
+            ctx,
+            params,
+            channels_last,
+            count_include_pad,
+            divisor_override,
+            in,
+            out);
+        // Failures to allocate have already been reported.
+        ET_KERNEL_CHECK_MSG(
+            ctx,
+            success || ctx.failure_state() != Error::Ok,
+            Internal,
+            ,
+            "parallel_for failed");
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/distance_utils.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/kernels/portable/cpu/util/distance_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using executorch::aten::optional;
+using executorch::aten::Tensor;
+
+namespace {
+
+using internal::allocate_scratch;
+
+inline ArrayRef<Tensor::SizesType> get_batch_sizes(const Tensor& tensor) {
+  return {tensor.sizes().data(), tensor.sizes().size() - 2};
+}
+
+/**
+ * Calls `fn(x1_base, x2_base, out_base, i_begin, i_end)` in parallel for
+ * every block of kDistanceRowBlock rows of x1 of every batch, with the
+ * offsets of the batch in each tensor.
+ *
+ * @returns false if parallel_for failed.
+ */
+template <typename Fn>
+[[nodiscard]] bool for_each_row_block(
+    const Tensor& x1,
+    const Tensor& x2,
+    const Tensor& out,
+    const Fn& fn) {
+  const ArrayRef<Tensor::SizesType> x1_batch_sizes = get_batch_sizes(x1);
+  const ArrayRef<Tensor::SizesType> x2_batch_sizes = get_batch_sizes(x2);
+  const ArrayRef<Tensor::SizesType> out_batch_sizes = get_batch_sizes(out);
+
+  const bool x1_is_broadcasted = !out_batch_sizes.equals(x1_batch_sizes);
+  const bool x2_is_broadcasted = !out_batch_sizes.equals(x2_batch_sizes);
+  const bool any_is_broadcasted = (x1_is_broadcasted || x2_is_broadcasted);
+
+  int64_t out_batch_numel = 1;
+  for (auto i : out_batch_sizes) {
+    out_batch_numel *= i;
+  }
+
+  const int64_t P = x1.size(x1.dim() - 2);
+  const int64_t R = x2.size(x2.dim() - 2);
+  const int64_t M = x1.size(x1.dim() - 1);
+  const int64_t num_blocks =
+      (P + internal::kDistanceRowBlock - 1) / internal::kDistanceRowBlock;
+  const int64_t block_work =
+      std::max<int64_t>(1, internal::kDistanceRowBlock * R * M);
+
+  return ::executorch::extension::parallel_for(
+      0,
+      out_batch_numel * num_blocks,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / block_work),
+      [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t b = task / num_blocks;
+          const int64_t i_begin =
+              task % num_blocks * internal::kDistanceRowBlock;
+          const int64_t i_end =
+              std::min(i_begin + internal::kDistanceRowBlock, P);
+
+          size_t x1_base_ix = b * P * M;
+          size_t x2_base_ix = b * R * M;
+          const size_t out_base_ix = b * P * R;
+          if (any_is_broadcasted) {
+            size_t out_base_coord[kTensorDimensionLimit];
+            delinearize_index(
+                out_base_ix, out, out_base_coord, kTensorDimensionLimit);
+
+            if (x1_is_broadcasted) {
+              x1_base_ix =
+                  linearize_access_indexes(out_base_coord, out.dim(), x1);
+            }
+            if (x2_is_broadcasted) {
+              x2_base_ix =
+                  linearize_access_indexes(out_base_coord, out.dim(), x2);
+            }
+          }
+          fn(x1_base_ix, x2_base_ix, out_base_ix, i_begin, i_end);
+        }
+      });
+}
+
+template <typename CTYPE, typename Norm>
+[[nodiscard]] bool
+cdist_tiled(const Tensor& x1, const Tensor& x2, Tensor& out, double p) {
+  const CTYPE* x1_data = x1.const_data_ptr<CTYPE>();
+  const CTYPE* x2_data = x2.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t R = x2.size(x2.dim() - 2);
+  const int64_t M = x1.size(x1.dim() - 1);
+
+  return for_each_row_block(
+      x1,
+      x2,
+      out,
+      [&](size_t x1_base,
+          size_t x2_base,
+          size_t out_base,
+          int64_t i_begin,
+          int64_t i_end) {
+        CTYPE* const out_batch = out_data + out_base;
+        internal::distance_tiles<CTYPE, Norm>(
+            x1_data + x1_base,
+            i_begin,
+            i_end,
+            x2_data + x2_base,
+            0,
+            R,
+            M,
+            static_cast<CTYPE>(p),
+            /*upper=*/false,
+            [&](int64_t i, int64_t j, CTYPE d) { out_batch[i * R + j] = d; });
+      });
+}
+
+/**
+ * Euclidean distances from the GEMM of every row block of x1 with all of
+ * x2, and the squared norms of all rows. The norms are kept in temp memory
+ * from `ctx`.
+ *
+ * @returns false if a parallel_for or the allocation failed; allocation
+ *     failures are also reported to `ctx`.
+ */
+template <typename CTYPE>
+[[nodiscard]] bool cdist_mm(
+    KernelRuntimeContext& ctx,
+    const Tensor& x1,
+    const Tensor& x2,
+    Tensor& out) {
+  const CTYPE* x1_data = x1.const_data_ptr<CTYPE>();
+  const CTYPE* x2_data = x2.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t R = x2.size(x2.dim() - 2);
+  const int64_t M = x1.size(x1.dim() - 1);
+
+  // The norms of all rows of both inputs, indexed like their first element.
+  const int64_t x1_rows = x1.numel() / M;
+  const int64_t x2_rows = x2.numel() / M;
+  CTYPE* const x1_norms = allocate_scratch<CTYPE>(ctx, x1_rows + x2_rows);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      x1_norms != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate the row norms");
+  CTYPE* const x2_norms = x1_norms + x1_rows;
+  bool success = ::executorch::extension::parallel_for(
+      0,
+      x1_rows + x2_rows,
+      std::max<int64_t>(1, ::executorch::extension::internal::GRAIN_SIZE / M),
+      [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          if (row < x1_rows) {
+            internal::squared_norms(x1_data + row * M, 1, M, x1_norms + row);
+          } else {
+            const int64_t r = row - x1_rows;
+            internal::squared_norms(x2_data + r * M, 1, M, x2_norms + r);
+          }
+        }
+      });
+  if (!success) {
+    return false;
+  }
+
+  return for_each_row_block(
+      x1,
+      x2,
+      out,
+      [&](size_t x1_base,
+          size_t x2_base,
+          size_t out_base,
+          int64_t i_begin,
+          int64_t i_end) {
+        CTYPE* const out_rows = out_data + out_base + i_begin * R;
+        internal::minus_two_gram(
+            x1_data + x1_base + i_begin * M,
+            i_end - i_begin,
+            x2_data + x2_base,
+            R,
+            M,
+            out_rows,
+            R);
+        const CTYPE* const norms1 = x1_norms + x1_base / M + i_begin;
+        const CTYPE* const norms2 = x2_norms + x2_base / M;
+        for (const auto i : c10::irange(i_end - i_begin)) {
+          for (const auto j : c10::irange(R)) {
+            CTYPE& d = out_rows[i * R + j];
+            d = internal::euclidean_from_gram(d, norms1[i], norms2[j]);
+          }
+        }
+      });
+}
+
+/**
+ * Whether the Euclidean distances use the GEMM, following the
+ * compute_mode of ATen: 0 or none uses it for more than
+ * kDistanceMmThreshold rows on either side, 1 always, and 2 never.
+ */
+bool use_mm(
+    const Tensor& x1,
+    const Tensor& x2,
+    optional<int64_t> compute_mode) {
+  const int64_t mode = compute_mode.has_value() ? compute_mode.value() : 0;
+  if (mode == 0) {
+    return x1.size(x1.dim() - 2) > internal::kDistanceMmThreshold ||
+        x2.size(x2.dim() - 2) > internal::kDistanceMmThreshold;
+  }
+  return mode == 1;
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool cdist(
+    KernelRuntimeContext& ctx,
+    const Tensor& x1,
+    const Tensor& x2,
+    Tensor& out,
+    double p,
+    optional<int64_t> compute_mode) {
+  if (out.numel() == 0) {
+    return true;
+  }
+
+  // If the last dimension of x1 (which is equal to the last dimension of x2)
+  // has size 0, then the output is filled with 0s.
+  if (x1.numel() == 0) {
+    std::fill_n(out.mutable_data_ptr<CTYPE>(), out.numel(), CTYPE(0));
+    return true;
+  }
+
+  if constexpr (internal::kIsVectorizedDistanceType<CTYPE>) {
+    if (p == 2.0 && use_mm(x1, x2, compute_mode)) {
+      return cdist_mm<CTYPE>(ctx, x1, x2, out);
+    }
+  }
+
+  if (p == 0.0) {
+    return cdist_tiled<CTYPE, L0<CTYPE>>(x1, x2, out, p);
+  } else if (p == 1.0) {
+    return cdist_tiled<CTYPE, L1<CTYPE>>(x1, x2, out, p);
+  } else if (p == 2.0) {
+    return cdist_tiled<CTYPE, L2<CTYPE>>(x1, x2, out, p);
+  } else if (p == INFINITY) {
+    return cdist_tiled<CTYPE, Linf<CTYPE>>(x1, x2, out, p);
+  } else {
+    return cdist_tiled<CTYPE, Lp<CTYPE>>(x1, x2, out, p);
+  }
+}
+
+} // namespace
+
+Tensor& opt_cdist_forward_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& x1,
+    const Tensor& x2,
+    double p,
+    optional<int64_t> compute_mode,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(x1, x2, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(x1), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_cdist_args(x1, x2, p, compute_mode, out),
+      InvalidArgument,
+      out);
+
+  Tensor::SizesType target_sizes[kTensorDimensionLimit];
+  size_t target_ndim = 0;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      get_broadcast_target_size(
+          {x1.sizes().data(), x1.sizes().size() - 2},
+          {x2.sizes().data(), x2.sizes().size() - 2},
+          target_sizes,
+          kTensorDimensionLimit,
+          &target_ndim) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  target_ndim += 2;
+  target_sizes[target_ndim - 2] = x1.size(x1.dim() - 2);
+  target_sizes[target_ndim - 1] = x2.size(x2.dim() - 2);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {target_sizes, target_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ScalarType out_type = out.scalar_type();
+  constexpr auto name = "_cdist_forward.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(out_type, ctx, name, CTYPE, [&] {
+    const bool success = cdist<CTYPE>(ctx, x1, x2, out, p, compute_mode);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,1086 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/dtype_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Convolution, lowered onto cpublas::gemm.
+ *
+ * - General convolutions use im2col: each task gathers the input patches of
+ *   a tile of output positions into a buffer and multiplies them by the
+ *   packed weights.
+ * - 3x3, stride 1, undilated convolutions with enough channels use Winograd
+ *   F(4x4, 3x3), or F(2x2, 3x3) for small outputs, which turns each tile of
+ *   outputs into a batch of channel-by-channel matrix products.
+ * - Depthwise convolutions (one input and one output channel per group) don't
+ *   have a useful matrix product, so they use a direct stencil that is
+ *   vectorized along channels or along rows, depending on the layout.
+ * - Transposed convolutions multiply the input by the packed weights and
+ *   scatter the products into the output (col2im).
+ *
+ * All of these read and write through the tensor strides, so they handle
+ * both of the dim orders check_convolution_args() accepts: contiguous (NCHW)
+ * and channels last (NHWC). Their buffers come from the kernel's temp memory;
+ * see scratch_utils.h. They return false after reporting a failure to ctx,
+ * or if parallel_for failed.
+ */
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+using executorch::cpublas::TransposeType;
+using internal::allocate_scratch;
+using internal::num_scratch_slots;
+using internal::parallel_for_slots;
+
+/// Elements in the per-slot im2col buffer; 256 KB of float, so it stays in
+/// L2 while the gemm sweeps it.
+constexpr int64_t kIm2colBufferSize = 64 * 1024;
+/// The fewest output positions an im2col task handles at once.
+constexpr int64_t kIm2colMinTileSize = 16;
+/// Elements in the per-slot Winograd buffers, and the most tiles they hold.
+constexpr int64_t kWinogradBufferSize = 256 * 1024;
+constexpr int64_t kWinogradMaxTiles = 64;
+/// With fewer channels per group, the transforms cost more than Winograd
+/// saves in the matrix products.
+constexpr int64_t kWinogradMinChannels = 16;
+/// Elements of the per-slot column buffer of a transposed convolution.
+constexpr int64_t kCol2imBufferSize = 64 * 1024;
+
+/**
+ * A 1D or 2D convolution viewed as 2D; a 1D convolution has height 1. The
+ * strides are those of the tensors in NCHW order, in elements.
+ */
+struct ConvParams {
+  int64_t batch;
+  int64_t groups;
+  int64_t in_c_per_group;
+  int64_t out_c_per_group;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  std::array<int64_t, 4> in_strides;
+  std::array<int64_t, 4> weight_strides;
+  std::array<int64_t, 4> out_strides;
+
+  int64_t out_channels() const {
+    return groups * out_c_per_group;
+  }
+};
+
+std::array<int64_t, 4> nchw_strides(const Tensor& t) {
+  const auto strides = t.strides();
+  if (t.dim() == 3) {
+    // The height dim has size 1, so its stride only has to keep the spatial
+    // dims flattenable into one.
+    return {strides[0], strides[1], strides[2] * t.size(2), strides[2]};
+  }
+  return {strides[0], strides[1], strides[2], strides[3]};
+}
+
+ConvParams get_conv_params(
+    const Tensor& in,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    const Tensor& out) {
+  const bool is_1d = in.dim() == 3;
+  const size_t w_dim = is_1d ? 0 : 1;
+  ConvParams p;
+  p.batch = in.size(0);
+  p.groups = groups;
+  p.in_c_per_group = in.size(1) / groups;
+  p.out_c_per_group = out.size(1) / groups;
+  p.in_h = is_1d ? 1 : in.size(2);
+  p.in_w = in.size(in.dim() - 1);
+  p.out_h = is_1d ? 1 : out.size(2);
+  p.out_w = out.size(out.dim() - 1);
+  p.kernel_h = is_1d ? 1 : weight.size(2);
+  p.kernel_w = weight.size(weight.dim() - 1);
+  p.stride_h = is_1d ? 1 : val_at(stride, 0);
+  p.stride_w = val_at(stride, w_dim);
+  p.pad_h = is_1d ? 0 : val_at(padding, 0, /*default_value=*/0);
+  p.pad_w = val_at(padding, w_dim, /*default_value=*/0);
+  p.dilation_h = is_1d ? 1 : val_at(dilation, 0);
+  p.dilation_w = val_at(dilation, w_dim);
+  p.in_strides = nchw_strides(in);
+  p.weight_strides = nchw_strides(weight);
+  p.out_strides = nchw_strides(out);
+  return p;
+}
+
+/**
+ * Returns the range [begin, end) of positions i in [0, size) for which
+ * i * stride + offset is in [0, limit).
+ */
+std::pair<int64_t, int64_t>
+valid_range(int64_t offset, int64_t stride, int64_t limit, int64_t size) {
+  const int64_t begin =
+      offset >= 0 ? 0 : executorch::utils::divup(-offset, stride);
+  const int64_t end =
+      offset >= limit ? 0 : std::min(size, (limit - 1 - offset) / stride + 1);
+  return {std::min(begin, end), end};
+}
+
+/**
+ * out(co, p) (+)= sum_k w[co * k_size + k] * x(k, p) for co in [0, out_c) and
+ * p in [0, num_p). Element (k, p) of x is at x[k * x_ks + p * x_ps], and
+ * element (co, p) of out is at out[co * out_cs + p * out_ps]; one of the two
+ * strides of each must be 1.
+ */
+template <typename CTYPE>
+void packed_weight_gemm(
+    int64_t out_c,
+    int64_t num_p,
+    int64_t k_size,
+    const CTYPE* w,
+    const CTYPE* x,
+    int64_t x_ks,
+    int64_t x_ps,
+    bool accumulate,
+    CTYPE* out,
+    int64_t out_cs,
+    int64_t out_ps) {
+  const CTYPE one = static_cast<CTYPE>(1);
+  const CTYPE beta = static_cast<CTYPE>(accumulate ? 1 : 0);
+  if (out_cs == 1) {
+    // out is a column-major out_c x num_p matrix: out = w @ x.
+    executorch::cpublas::gemm(
+        TransposeType::Transpose,
+        x_ks == 1 ? TransposeType::NoTranspose : TransposeType::Transpose,
+        out_c,
+        num_p,
+        k_size,
+        one,
+        w,
+        k_size,
+        x,
+        x_ks == 1 ? x_ps : x_ks,
+        beta,
+        out,
+        out_ps);
+  } else {
+    ET_DCHECK(out_ps == 1);
+    // out is a column-major num_p x out_c matrix: out = x^T @ w^T.
+    executorch::cpublas::gemm(
+        x_ps == 1 ? TransposeType::NoTranspose : TransposeType::Transpose,
+        TransposeType::NoTranspose,
+        num_p,
+        out_c,
+        k_size,
+        one,
+        x,
+        x_ps == 1 ? x_ks : x_ps,
+        w,
+        k_size,
+        beta,
+        out,
+        out_cs);
+  }
+}
+
+/**
+ * Copies the weights of each group into a [out_c_per_group][k] matrix, where
+ * k walks the kernel in (kh, kw, ci) order if kernel_major, and in
+ * (ci, kh, kw) order otherwise.
+ */
+template <typename CTYPE>
+void pack_conv_weight(
+    const ConvParams& p,
+    const CTYPE* weight,
+    bool kernel_major,
+    CTYPE* packed) {
+  const auto& ws = p.weight_strides;
+  for (const auto co : c10::irange(p.out_channels())) {
+    for (const auto ci : c10::irange(p.in_c_per_group)) {
+      for (const auto kh : c10::irange(p.kernel_h)) {
+        for (const auto kw : c10::irange(p.kernel_w)) {
+          const int64_t k = kernel_major
+              ? (kh * p.kernel_w + kw) * p.in_c_per_group + ci
+              : (ci * p.kernel_h + kh) * p.kernel_w + kw;
+          packed[k] = weight[co * ws[0] + ci * ws[1] + kh * ws[2] + kw * ws[3]];
+        }
+      }
+    }
+    packed += p.in_c_per_group * p.kernel_h * p.kernel_w;
+  }
+}
+
+/**
+ * Gathers the input patches of output positions [p_begin, p_begin + num_p)
+ * of one group. For a channels last input, patch p is row p of col, in
+ * (kh, kw, ci) order; otherwise, col has a row of num_p positions for each
+ * (ci, kh, kw).
+ */
+template <typename CTYPE>
+void im2col(
+    const ConvParams& p,
+    const CTYPE* in,
+    bool channels_last,
+    int64_t p_begin,
+    int64_t num_p,
+    CTYPE* col) {
+  const auto& is = p.in_strides;
+  if (channels_last) {
+    for (const auto i : c10::irange(num_p)) {
+      const int64_t oh = (p_begin + i) / p.out_w;
+      const int64_t ow = (p_begin + i) % p.out_w;
+      for (const auto kh : c10::irange(p.kernel_h)) {
+        const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dilation_h;
+        for (const auto kw : c10::irange(p.kernel_w)) {
+          const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dilation_w;
+          if (ih >= 0 && ih < p.in_h && iw >= 0 && iw < p.in_w) {
+            std::memcpy(
+                col,
+                in + ih * is[2] + iw * is[3],
+                p.in_c_per_group * sizeof(CTYPE));
+          } else {
+            std::fill(col, col + p.in_c_per_group, static_cast<CTYPE>(0));
+          }
+          col += p.in_c_per_group;
+        }
+      }
+    }
+    return;
+  }
+  for (const auto ci : c10::irange(p.in_c_per_group)) {
+    for (const auto kh : c10::irange(p.kernel_h)) {
+      for (const auto kw : c10::irange(p.kernel_w)) {
+        int64_t oh = p_begin / p.out_w;
+        int64_t ow = p_begin % p.out_w;
+        for (const auto i : c10::irange(num_p)) {
+          const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dilation_h;
+          const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dilation_w;
+          col[i] = ih >= 0 && ih < p.in_h && iw >= 0 && iw < p.in_w
+              ? in[ci * is[1] + ih * is[2] + iw * is[3]]
+              : static_cast<CTYPE>(0);
+          if (++ow == p.out_w) {
+            ow = 0;
+            ++oh;
+          }
+        }
+        col += num_p;
+      }
+    }
+  }
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool conv_im2col(
+    KernelRuntimeContext& ctx,
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* weight,
+    const CTYPE* bias,
+    CTYPE* out) {
+  const auto& is = p.in_strides;
+  const auto& os = p.out_strides;
+  const bool channels_last = is[1] == 1;
+  const int64_t k_size = p.in_c_per_group * p.kernel_h * p.kernel_w;
+  const int64_t out_size = p.out_h * p.out_w;
+  // A 1x1 convolution with unit stride and no padding multiplies the input
+  // itself, which is already a matrix of positions by channels.
+  const bool pointwise = p.kernel_h == 1 && p.kernel_w == 1 &&
+      p.stride_h == 1 && p.stride_w == 1 && p.pad_h == 0 && p.pad_w == 0;
+
+  const int64_t tile_size = std::min(
+      out_size, std::max(kIm2colMinTileSize, kIm2colBufferSize / k_size));
+  const int64_t num_tiles = executorch::utils::divup(out_size, tile_size);
+  const int64_t num_tasks = p.batch * p.groups * num_tiles;
+  const int64_t col_size = pointwise ? 0 : k_size * tile_size;
+
+  CTYPE* const packed_weight =
+      allocate_scratch<CTYPE>(ctx, p.out_channels() * k_size);
+  CTYPE* const cols =
+      allocate_scratch<CTYPE>(ctx, num_scratch_slots(num_tasks) * col_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      packed_weight != nullptr && cols != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate im2col buffers");
+  pack_conv_weight(p, weight, channels_last, packed_weight);
+
+  return parallel_for_slots(
+      num_tasks, [&](int64_t slot, int64_t begin, int64_t end) {
+        CTYPE* const col = cols + slot * col_size;
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t tile = task % num_tiles;
+          const int64_t group = (task / num_tiles) % p.groups;
+          const int64_t n = task / num_tiles / p.groups;
+          const int64_t p_begin = tile * tile_size;
+          const int64_t num_p = std::min(tile_size, out_size - p_begin);
+          const CTYPE* const group_in =
+              in + n * is[0] + group * p.in_c_per_group * is[1];
+
+          const CTYPE* x = col;
+          int64_t x_ks = channels_last ? 1 : num_p;
+          int64_t x_ps = channels_last ? k_size : 1;
+          if (pointwise) {
+            // The spatial dims of both layouts flatten into one.
+            x = group_in + p_begin * is[3];
+            x_ks = is[1];
+            x_ps = is[3];
+          } else {
+            im2col(p, group_in, channels_last, p_begin, num_p, col);
+          }
+
+          const int64_t out_c_begin = group * p.out_c_per_group;
+          CTYPE* const out_block =
+              out + n * os[0] + out_c_begin * os[1] + p_begin * os[3];
+          if (bias != nullptr) {
+            for (const auto co : c10::irange(p.out_c_per_group)) {
+              for (const auto i : c10::irange(num_p)) {
+                out_block[co * os[1] + i * os[3]] = bias[out_c_begin + co];
+              }
+            }
+          }
+          packed_weight_gemm(
+              p.out_c_per_group,
+              num_p,
+              k_size,
+              packed_weight + out_c_begin * k_size,
+              x,
+              x_ks,
+              x_ps,
+              /*accumulate=*/bias != nullptr,
+              out_block,
+              os[1],
+              os[3]);
+        }
+      });
+}
+
+/**
+ * The transforms of Winograd F(kM x kM, 3x3) [Lavin & Gray, 2015]: for a
+ * kAlpha x kAlpha input tile d and a 3x3 filter g, the kM x kM output tile is
+ * AT ((G g G^T) * (BT d BT^T)) AT^T, where * is elementwise.
+ */
+template <int kM>
+struct WinogradTransform;
+
+template <>
+struct WinogradTransform<2> {
+  static constexpr int kAlpha = 4;
+  static constexpr float BT[4][4] = {
+      {1, 0, -1, 0},
+      {0, 1, 1, 0},
+      {0, -1, 1, 0},
+      {0, 1, 0, -1},
+  };
+  static constexpr float G[4][3] = {
+      {1, 0, 0},
+      {0.5f, 0.5f, 0.5f},
+      {0.5f, -0.5f, 0.5f},
+      {0, 0, 1},
+  };
+  static constexpr float AT[2][4] = {
+      {1, 1, 1, 0},
+      {0, 1, -1, -1},
+  };
+};
+
+template <>
+struct WinogradTransform<4> {
+  static constexpr int kAlpha = 6;
+  static constexpr float BT[6][6] = {
+      {4, 0, -5, 0, 1, 0},
+      {0, -4, -4, 1, 1, 0},
+      {0, 4, -4, -1, 1, 0},
+      {0, -2, -1, 2, 1, 0},
+      {0, 2, -1, -2, 1, 0},
+      {0, 4, 0, -5, 0, 1},
+  };
+  static constexpr float G[6][3] = {
+      {1.0f / 4, 0, 0},
+      {-1.0f / 6, -1.0f / 6, -1.0f / 6},
+      {-1.0f / 6, 1.0f / 6, -1.0f / 6},
+      {1.0f / 24, 1.0f / 12, 1.0f / 6},
+      {1.0f / 24, -1.0f / 12, 1.0f / 6},
+      {0, 0, 1},
+  };
+  static constexpr float AT[4][6] = {
+      {1, 1, 1, 1, 1, 0},
+      {0, 1, -1, 2, -2, 0},
+      {0, 1, 1, 4, 4, 0},
+      {0, 1, -1, 8, -8, 1},
+  };
+};
+
+/// out = l @ x @ r^T, for an M x K matrix l, a K x K matrix x and an N x K
+/// matrix r.
+template <int M, int N, int K>
+void sandwich(
+    const float (&l)[M][K],
+    const float (&x)[K][K],
+    const float (&r)[N][K],
+    float (&out)[M][N]) {
+  float tmp[M][K];
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < K; ++j) {
+      float sum = 0;
+      for (int k = 0; k < K; ++k) {
+        sum += l[i][k] * x[k][j];
+      }
+      tmp[i][j] = sum;
+    }
+  }
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      float sum = 0;
+      for (int k = 0; k < K; ++k) {
+        sum += tmp[i][k] * r[j][k];
+      }
+      out[i][j] = sum;
+    }
+  }
+}
+
+bool can_use_winograd(const ConvParams& p) {
+  return p.kernel_h == 3 && p.kernel_w == 3 && p.stride_h == 1 &&
+      p.stride_w == 1 && p.dilation_h == 1 && p.dilation_w == 1 &&
+      p.in_c_per_group >= kWinogradMinChannels &&
+      p.out_c_per_group >= kWinogradMinChannels;
+}
+
+template <typename CTYPE, int kM>
+[[nodiscard]] bool conv_winograd(
+    KernelRuntimeContext& ctx,
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* weight,
+    const CTYPE* bias,
+    CTYPE* out) {
+  using Transform = WinogradTransform<kM>;
+  constexpr int kAlpha = Transform::kAlpha;
+  constexpr int kAlpha2 = kAlpha * kAlpha;
+  const auto& is = p.in_strides;
+  const auto& ws = p.weight_strides;
+  const auto& os = p.out_strides;
+  const int64_t in_c = p.in_c_per_group;
+  const int64_t out_c = p.out_c_per_group;
+
+  const int64_t tiles_h = executorch::utils::divup(p.out_h, kM);
+  const int64_t tiles_w = executorch::utils::divup(p.out_w, kM);
+  const int64_t num_tiles = p.batch * tiles_h * tiles_w;
+  const int64_t block_size = std::max<int64_t>(
+      1,
+      std::min(
+          kWinogradMaxTiles,
+          kWinogradBufferSize / (kAlpha2 * (in_c + out_c))));
+  const int64_t num_blocks = executorch::utils::divup(num_tiles, block_size);
+  const int64_t num_tasks = p.groups * num_blocks;
+
+  // u[group][xi][co][ci] = (G g G^T)[xi] for the filter g of (co, ci). Each
+  // slot has v[xi][t][ci], the transformed input tiles, and m[xi][t][co],
+  // their products with u.
+  const int64_t u_group_size = kAlpha2 * out_c * in_c;
+  const int64_t v_size = kAlpha2 * block_size * in_c;
+  const int64_t m_size = kAlpha2 * block_size * out_c;
+  float* const u = allocate_scratch<float>(ctx, p.groups * u_group_size);
+  float* const vm = allocate_scratch<float>(
+      ctx, num_scratch_slots(num_tasks) * (v_size + m_size));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      u != nullptr && vm != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate Winograd buffers");
+  const bool transformed = executorch::extension::parallel_for(
+      0, p.out_channels(), 1, [&](int64_t begin, int64_t end) {
+        for (const auto co_total : c10::irange(begin, end)) {
+          const int64_t group = co_total / out_c;
+          const int64_t co = co_total % out_c;
+          float* const group_u = u + group * u_group_size;
+          for (const auto ci : c10::irange(in_c)) {
+            const CTYPE* const filter = weight + co_total * ws[0] + ci * ws[1];
+            float g[3][3];
+            for (int kh = 0; kh < 3; ++kh) {
+              for (int kw = 0; kw < 3; ++kw) {
+                g[kh][kw] = static_cast<float>(filter[kh * ws[2] + kw * ws[3]]);
+              }
+            }
+            float gt[kAlpha][kAlpha];
+            sandwich(Transform::G, g, Transform::G, gt);
+            for (int xi = 0; xi < kAlpha2; ++xi) {
+              group_u[(xi * out_c + co) * in_c + ci] =
+                  gt[xi / kAlpha][xi % kAlpha];
+            }
+          }
+        }
+      });
+  if (!transformed) {
+    return false;
+  }
+
+  return parallel_for_slots(
+      num_tasks, [&](int64_t slot, int64_t begin, int64_t end) {
+        float* const v = vm + slot * (v_size + m_size);
+        float* const m = v + v_size;
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t group = task / num_blocks;
+          const int64_t tile_begin = (task % num_blocks) * block_size;
+          const int64_t block_tiles =
+              std::min(block_size, num_tiles - tile_begin);
+
+          for (const auto t : c10::irange(block_tiles)) {
+            const int64_t tile = tile_begin + t;
+            const int64_t n = tile / (tiles_h * tiles_w);
+            const int64_t ih0 = (tile / tiles_w % tiles_h) * kM - p.pad_h;
+            const int64_t iw0 = (tile % tiles_w) * kM - p.pad_w;
+            const CTYPE* const tile_in =
+                in + n * is[0] + group * in_c * is[1];
+            for (const auto ci : c10::irange(in_c)) {
+              float d[kAlpha][kAlpha];
+              for (int i = 0; i < kAlpha; ++i) {
+                const int64_t ih = ih0 + i;
+                for (int j = 0; j < kAlpha; ++j) {
+                  const int64_t iw = iw0 + j;
+                  d[i][j] = ih >= 0 && ih < p.in_h && iw >= 0 && iw < p.in_w
+                      ? static_cast<float>(
+                            tile_in[ci * is[1] + ih * is[2] + iw * is[3]])
+                      : 0.0f;
+                }
+              }
+              float dt[kAlpha][kAlpha];
+              sandwich(Transform::BT, d, Transform::BT, dt);
+              for (int xi = 0; xi < kAlpha2; ++xi) {
+                v[(xi * block_size + t) * in_c + ci] =
+                    dt[xi / kAlpha][xi % kAlpha];
+              }
+            }
+          }
+
+          for (int xi = 0; xi < kAlpha2; ++xi) {
+            packed_weight_gemm<float>(
+                out_c,
+                block_tiles,
+                in_c,
+                u + group * u_group_size + xi * out_c * in_c,
+                v + xi * block_size * in_c,
+                /*x_ks=*/1,
+                /*x_ps=*/in_c,
+                /*accumulate=*/false,
+                m + xi * block_size * out_c,
+                /*out_cs=*/1,
+                /*out_ps=*/out_c);
+          }
+
+          for (const auto t : c10::irange(block_tiles)) {
+            const int64_t tile = tile_begin + t;
+            const int64_t n = tile / (tiles_h * tiles_w);
+            const int64_t oh0 = (tile / tiles_w % tiles_h) * kM;
+            const int64_t ow0 = (tile % tiles_w) * kM;
+            const int64_t rows = std::min<int64_t>(kM, p.out_h - oh0);
+            const int64_t cols = std::min<int64_t>(kM, p.out_w - ow0);
+            for (const auto co : c10::irange(out_c)) {
+              const int64_t co_total = group * out_c + co;
+              float mt[kAlpha][kAlpha];
+              for (int xi = 0; xi < kAlpha2; ++xi) {
+                mt[xi / kAlpha][xi % kAlpha] =
+                    m[(xi * block_size + t) * out_c + co];
+              }
+              float y[kM][kM];
+              sandwich(Transform::AT, mt, Transform::AT, y);
+              const float b =
+                  bias == nullptr ? 0.0f : static_cast<float>(bias[co_total]);
+              CTYPE* const tile_out = out + n * os[0] + co_total * os[1];
+              for (const auto i : c10::irange(rows)) {
+                for (const auto j : c10::irange(cols)) {
+                  tile_out[(oh0 + i) * os[2] + (ow0 + j) * os[3]] =
+                      static_cast<CTYPE>(y[i][j] + b);
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+/// acc[i] += w[i] * x[i] for i in [0, size).
+template <typename CTYPE>
+void multiply_accumulate(
+    float* acc,
+    const float* w,
+    const CTYPE* x,
+    int64_t size) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    for (; i + Vec::size() <= size; i += Vec::size()) {
+      executorch::vec::fmadd(
+          Vec::loadu(w + i), Vec::loadu(x + i), Vec::loadu(acc + i))
+          .store(acc + i);
+    }
+  }
+  for (; i < size; ++i) {
+    acc[i] += w[i] * static_cast<float>(x[i]);
+  }
+}
+
+/// acc[i] += w * x[i] for i in [0, size).
+template <typename CTYPE>
+void scale_accumulate(float* acc, float w, const CTYPE* x, int64_t size) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    const Vec w_vec(w);
+    for (; i + Vec::size() <= size; i += Vec::size()) {
+      executorch::vec::fmadd(w_vec, Vec::loadu(x + i), Vec::loadu(acc + i))
+          .store(acc + i);
+    }
+  }
+  for (; i < size; ++i) {
+    acc[i] += w * static_cast<float>(x[i]);
+  }
+}
+
+bool is_depthwise(const ConvParams& p) {
+  return p.groups > 1 && p.in_c_per_group == 1 && p.out_c_per_group == 1;
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool conv_depthwise(
+    KernelRuntimeContext& ctx,
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* weight,
+    const CTYPE* bias,
+    CTYPE* out) {
+  const auto& is = p.in_strides;
+  const auto& ws = p.weight_strides;
+  const auto& os = p.out_strides;
+  const int64_t channels = p.groups;
+  const int64_t kernel_size = p.kernel_h * p.kernel_w;
+
+  if (is[1] == 1 && os[1] == 1) {
+    // Channels last: accumulate all of the channels of an output pixel at
+    // once, against weights repacked as [kh][kw][c].
+    const int64_t num_rows = p.batch * p.out_h;
+    float* const packed = allocate_scratch<float>(ctx, kernel_size * channels);
+    float* const accs =
+        allocate_scratch<float>(ctx, num_scratch_slots(num_rows) * channels);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        packed != nullptr && accs != nullptr,
+        MemoryAllocationFailed,
+        false,
+        "Failed to allocate depthwise convolution buffers");
+    for (const auto c : c10::irange(channels)) {
+      for (const auto kh : c10::irange(p.kernel_h)) {
+        for (const auto kw : c10::irange(p.kernel_w)) {
+          packed[(kh * p.kernel_w + kw) * channels + c] =
+              static_cast<float>(weight[c * ws[0] + kh * ws[2] + kw * ws[3]]);
+        }
+      }
+    }
+    return parallel_for_slots(
+        num_rows, [&](int64_t slot, int64_t begin, int64_t end) {
+          float* const acc = accs + slot * channels;
+          for (const auto row : c10::irange(begin, end)) {
+            const int64_t n = row / p.out_h;
+            const int64_t oh = row % p.out_h;
+            for (const auto ow : c10::irange(p.out_w)) {
+              for (const auto c : c10::irange(channels)) {
+                acc[c] =
+                    bias == nullptr ? 0.0f : static_cast<float>(bias[c]);
+              }
+              for (const auto kh : c10::irange(p.kernel_h)) {
+                const int64_t ih =
+                    oh * p.stride_h - p.pad_h + kh * p.dilation_h;
+                if (ih < 0 || ih >= p.in_h) {
+                  continue;
+                }
+                for (const auto kw : c10::irange(p.kernel_w)) {
+                  const int64_t iw =
+                      ow * p.stride_w - p.pad_w + kw * p.dilation_w;
+                  if (iw < 0 || iw >= p.in_w) {
+                    continue;
+                  }
+                  multiply_accumulate(
+                      acc,
+                      packed + (kh * p.kernel_w + kw) * channels,
+                      in + n * is[0] + ih * is[2] + iw * is[3],
+                      channels);
+                }
+              }
+              CTYPE* const pixel = out + n * os[0] + oh * os[2] + ow * os[3];
+              for (const auto c : c10::irange(channels)) {
+                pixel[c] = static_cast<CTYPE>(acc[c]);
+              }
+            }
+          }
+        });
+  }
+
+  // Channels first: accumulate an output row at a time, one kernel tap at a
+  // time. Each tap only touches the outputs whose inputs aren't padding.
+  const int64_t num_planes = p.batch * channels;
+  float* const accs =
+      allocate_scratch<float>(ctx, num_scratch_slots(num_planes) * p.out_w);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      accs != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate depthwise convolution buffers");
+  return parallel_for_slots(
+      num_planes, [&](int64_t slot, int64_t begin, int64_t end) {
+        float* const acc = accs + slot * p.out_w;
+        for (const auto plane : c10::irange(begin, end)) {
+          const int64_t n = plane / channels;
+          const int64_t c = plane % channels;
+          const CTYPE* const plane_in = in + n * is[0] + c * is[1];
+          CTYPE* const plane_out = out + n * os[0] + c * os[1];
+          for (const auto oh : c10::irange(p.out_h)) {
+            std::fill(
+                acc,
+                acc + p.out_w,
+                bias == nullptr ? 0.0f : static_cast<float>(bias[c]));
+            for (const auto kh : c10::irange(p.kernel_h)) {
+              const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dilation_h;
+              if (ih < 0 || ih >= p.in_h) {
+                continue;
+              }
+              const CTYPE* const row_in = plane_in + ih * is[2];
+              for (const auto kw : c10::irange(p.kernel_w)) {
+                const float w = static_cast<float>(
+                    weight[c * ws[0] + kh * ws[2] + kw * ws[3]]);
+                const int64_t offset = kw * p.dilation_w - p.pad_w;
+                const auto [ow_begin, ow_end] =
+                    valid_range(offset, p.stride_w, p.in_w, p.out_w);
+                if (p.stride_w == 1 && is[3] == 1) {
+                  scale_accumulate(
+                      acc + ow_begin,
+                      w,
+                      row_in + ow_begin + offset,
+                      ow_end - ow_begin);
+                } else {
+                  for (const auto ow : c10::irange(ow_begin, ow_end)) {
+                    const int64_t iw = ow * p.stride_w + offset;
+                    acc[ow] += w * static_cast<float>(row_in[iw * is[3]]);
+                  }
+                }
+              }
+            }
+            for (const auto ow : c10::irange(p.out_w)) {
+              plane_out[oh * os[2] + ow * os[3]] = static_cast<CTYPE>(acc[ow]);
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Transposed convolution: cols = w^T @ in for each group, where row
+ * (co, kh, kw) of cols holds the contribution of tap (kh, kw) of every input
+ * position to output channel co; then each row is added into the output at
+ * the positions its tap reaches.
+ */
+template <typename CTYPE>
+[[nodiscard]] bool conv_transposed(
+    KernelRuntimeContext& ctx,
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* weight,
+    const CTYPE* bias,
+    CTYPE* out) {
+  const auto& is = p.in_strides;
+  const auto& ws = p.weight_strides;
+  const auto& os = p.out_strides;
+  const int64_t in_c = p.in_c_per_group;
+  const int64_t out_c = p.out_c_per_group;
+  const int64_t kernel_size = p.kernel_h * p.kernel_w;
+  const int64_t in_size = p.in_h * p.in_w;
+
+  // Output channels don't share outputs, so tasks split them.
+  const int64_t chunk_c = std::max<int64_t>(
+      1, std::min(out_c, kCol2imBufferSize / (kernel_size * in_size)));
+  const int64_t num_chunks = executorch::utils::divup(out_c, chunk_c);
+  const int64_t num_tasks = p.batch * p.groups * num_chunks;
+  const int64_t cols_size = chunk_c * kernel_size * in_size;
+
+  // The weight is [in channels][out_c][kh][kw]; pack each group as a
+  // [(co, kh, kw)][ci] matrix.
+  const int64_t rows_per_group = out_c * kernel_size;
+  CTYPE* const packed =
+      allocate_scratch<CTYPE>(ctx, p.groups * rows_per_group * in_c);
+  CTYPE* const all_cols =
+      allocate_scratch<CTYPE>(ctx, num_scratch_slots(num_tasks) * cols_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      packed != nullptr && all_cols != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate transposed convolution buffers");
+  for (const auto group : c10::irange(p.groups)) {
+    CTYPE* const group_packed = packed + group * rows_per_group * in_c;
+    for (const auto ci : c10::irange(in_c)) {
+      const CTYPE* const w = weight + (group * in_c + ci) * ws[0];
+      for (const auto co : c10::irange(out_c)) {
+        for (const auto kh : c10::irange(p.kernel_h)) {
+          for (const auto kw : c10::irange(p.kernel_w)) {
+            const int64_t row = (co * p.kernel_h + kh) * p.kernel_w + kw;
+            group_packed[row * in_c + ci] =
+                w[co * ws[1] + kh * ws[2] + kw * ws[3]];
+          }
+        }
+      }
+    }
+  }
+
+  return parallel_for_slots(
+      num_tasks, [&](int64_t slot, int64_t begin, int64_t end) {
+        CTYPE* const cols = all_cols + slot * cols_size;
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t co_begin = (task % num_chunks) * chunk_c;
+          const int64_t group = (task / num_chunks) % p.groups;
+          const int64_t n = task / num_chunks / p.groups;
+          const int64_t num_c = std::min(chunk_c, out_c - co_begin);
+
+          // The spatial dims of both layouts flatten into one.
+          packed_weight_gemm(
+              num_c * kernel_size,
+              in_size,
+              in_c,
+              packed + (group * rows_per_group + co_begin * kernel_size) * in_c,
+              in + n * is[0] + group * in_c * is[1],
+              is[1],
+              is[3],
+              /*accumulate=*/false,
+              cols,
+              in_size,
+              1);
+
+          for (const auto c : c10::irange(num_c)) {
+            const int64_t co_total = group * out_c + co_begin + c;
+            CTYPE* const plane_out = out + n * os[0] + co_total * os[1];
+            const CTYPE b =
+                bias == nullptr ? static_cast<CTYPE>(0) : bias[co_total];
+            for (const auto oh : c10::irange(p.out_h)) {
+              for (const auto ow : c10::irange(p.out_w)) {
+                plane_out[oh * os[2] + ow * os[3]] = b;
+              }
+            }
+            for (const auto kh : c10::irange(p.kernel_h)) {
+              const auto [ih_begin, ih_end] = valid_range(
+                  kh * p.dilation_h - p.pad_h, p.stride_h, p.out_h, p.in_h);
+              for (const auto kw : c10::irange(p.kernel_w)) {
+                const int64_t w_offset = kw * p.dilation_w - p.pad_w;
+                const auto [iw_begin, iw_end] =
+                    valid_range(w_offset, p.stride_w, p.out_w, p.in_w);
+                const CTYPE* const row =
+                    cols + ((c * p.kernel_h + kh) * p.kernel_w + kw) * in_size;
+                for (const auto ih : c10::irange(ih_begin, ih_end)) {
+                  const int64_t oh =
+                      ih * p.stride_h + kh * p.dilation_h - p.pad_h;
+                  CTYPE* const row_out = plane_out + oh * os[2];
+                  for (const auto iw : c10::irange(iw_begin, iw_end)) {
+                    row_out[(iw * p.stride_w + w_offset) * os[3]] +=
+                        row[ih * p.in_w + iw];
+                  }
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool convolution_impl(
+    KernelRuntimeContext& ctx,
+    const ConvParams& p,
+    bool transposed,
+    const CTYPE* in,
+    const CTYPE* weight,
+    const CTYPE* bias,
+    CTYPE* out) {
+  if (transposed) {
+    return conv_transposed(ctx, p, in, weight, bias, out);
+  }
+  // The direct and Winograd kernels compute in float.
+  constexpr bool kComputesInFloat = std::is_same_v<CTYPE, float> ||
+      std::is_same_v<CTYPE, executorch::aten::Half> ||
+      std::is_same_v<CTYPE, executorch::aten::BFloat16>;
+  if constexpr (kComputesInFloat) {
+    if (is_depthwise(p)) {
+      return conv_depthwise(ctx, p, in, weight, bias, out);
+    }
+    if (can_use_winograd(p)) {
+      // F(4x4, 3x3) needs fewer products per output, but pads small outputs
+      // out to whole 4x4 tiles.
+      if (p.out_h >= 8 && p.out_w >= 8) {
+        return conv_winograd<CTYPE, 4>(ctx, p, in, weight, bias, out);
+      }
+      return conv_winograd<CTYPE, 2>(ctx, p, in, weight, bias, out);
+    }
+  }
+  return conv_im2col(ctx, p, in, weight, bias, out);
+}
+
+} // namespace
+
+Tensor& opt_convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const executorch::aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const ConvParams params = get_conv_params(
+      in, weight, stride, padding, dilation, groups, out);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char name[] = "convolution.out";
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    const int64_t out_channels = params.out_channels();
+    CTYPE* bias_data = nullptr;
+    if (bias.has_value()) {
+      const auto load_bias =
+          utils::internal::get_load_to_compute_fn<CTYPE, name>(
+              bias.value(), utils::SupportedTensorDtypes::REALHBF16);
+      const char* const bias_ptr =
+          reinterpret_cast<const char*>(bias.value().const_data_ptr());
+      bias_data = allocate_scratch<CTYPE>(ctx, out_channels);
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          bias_data != nullptr,
+          MemoryAllocationFailed,
+          ,
+          "Failed to allocate the bias buffer");
+      for (const auto c : c10::irange(out_channels)) {
+        bias_data[c] = load_bias(&bias_ptr[c * bias.value().element_size()]);
+      }
+    }
+
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+    if (in.numel() == 0 || weight.numel() == 0) {
+      // Every output is just its bias.
+      const int64_t channel_size = out.numel() / params.batch / out_channels;
+      for (const auto ix : c10::irange(out.numel())) {
+        const int64_t c = params.out_strides[1] == 1
+            ? ix % out_channels
+            : ix / channel_size % out_channels;
+        out_data[ix] =
+            bias_data == nullptr ? static_cast<CTYPE>(0) : bias_data[c];
+      }
+      return;
+    }
+
+    const bool success = convolution_impl(
+        ctx,
+        params,
+        transposed,
+        in.const_data_ptr<CTYPE>(),
+        weight.const_data_ptr<CTYPE>(),
+        bias_data,
+        out_data);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
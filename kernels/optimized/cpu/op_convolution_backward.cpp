@@ -0,0 +1,637 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <tuple>
+
+/**
+ * Gradients of a 2D convolution, lowered onto cpublas::gemm. For each group,
+ * with cols the im2col matrix of the input patches, [(ci, kh, kw)][position]:
+ *
+ * - grad_weight = grad_output @ cols^T, summed over the batch. Tasks split
+ *   the rows of cols, so that each task owns a slice of grad_weight and
+ *   gathers only the rows of cols it needs.
+ * - The gradient of cols is weight^T @ grad_output, which is added into
+ *   grad_input at the positions each row reads from (col2im). Tasks split
+ *   the batch and groups, which don't share any of grad_input.
+ * - grad_bias sums grad_output over the batch and positions, in parallel
+ *   over channels.
+ *
+ * All of these read and write through the tensor strides, so they handle
+ * both contiguous (NCHW) and channels last (NHWC) tensors. The packed weights
+ * and column buffers come from the temp memory of the kernel context; the
+ * helpers return false after reporting to it if there isn't enough.
+ */
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+using OptIntArrayRef = executorch::aten::OptionalArrayRef<int64_t>;
+
+namespace {
+
+using executorch::cpublas::TransposeType;
+using internal::allocate_scratch;
+using internal::num_scratch_slots;
+using internal::parallel_for_slots;
+
+/// Elements in the per-slot column buffers; 256 KB of float, so they stay
+/// in L2 while the gemm sweeps them.
+constexpr int64_t kColBufferSize = 64 * 1024;
+/// The fewest output positions a column buffer holds.
+constexpr int64_t kMinTileSize = 16;
+/// The fewest rows of cols that a grad_weight task handles.
+constexpr int64_t kMinWeightRows = 64;
+
+bool check_convolution_backward_args(
+    const Tensor& grad_output,
+    const Tensor& input,
+    const Tensor& weight,
+    ET_UNUSED const OptIntArrayRef bias_sizes_opt,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    executorch::aten::ArrayRef<bool> output_mask,
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    Tensor& grad_bias) {
+  ET_CHECK_OR_RETURN_FALSE(
+      transposed == false, "Transposed Convolution Backward not supported yet");
+  ET_CHECK_OR_RETURN_FALSE(
+      weight.dim() == 4, "Only 2D Convolution Backward supported for now");
+
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(weight, input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(grad_output, input));
+
+  if (output_mask[0]) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(grad_input, input));
+  }
+
+  if (output_mask[1]) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(grad_weight, input));
+  }
+
+  if (output_mask[2]) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(grad_bias, input));
+  }
+
+  ET_CHECK_OR_RETURN_FALSE(
+      check_convolution_args(
+          input,
+          weight,
+          executorch::aten::optional<Tensor>(),
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          grad_output),
+      "Invalid convolution arguments");
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      input,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_LOG_AND_RETURN_IF_FALSE(
+      output_size_is_valid({output_sizes, output_ndim}, input.dim() - 2));
+
+  ET_CHECK_OR_RETURN_FALSE(
+      grad_output.dim() == input.dim(),
+      "grad_output should have same number of dimensions as input");
+
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensor_has_expected_size(grad_output, {output_sizes, output_ndim}));
+
+  return true;
+}
+
+/**
+ * A 2D convolution. The strides are those of the tensors in NCHW order, in
+ * elements; the spatial dims of both dim orders flatten into one with the
+ * stride of the width.
+ */
+struct ConvBackwardParams {
+  int64_t batch;
+  int64_t groups;
+  int64_t in_c_per_group;
+  int64_t out_c_per_group;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  std::array<int64_t, 4> in_strides;
+  std::array<int64_t, 4> grad_out_strides;
+
+  int64_t out_channels() const {
+    return groups * out_c_per_group;
+  }
+  int64_t k_size() const {
+    return in_c_per_group * kernel_h * kernel_w;
+  }
+};
+
+std::array<int64_t, 4> get_strides(const Tensor& t) {
+  const auto strides = t.strides();
+  return {strides[0], strides[1], strides[2], strides[3]};
+}
+
+ConvBackwardParams get_params(
+    const Tensor& grad_output,
+    const Tensor& input,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  ConvBackwardParams p;
+  p.batch = input.size(0);
+  p.groups = groups;
+  p.in_c_per_group = input.size(1) / groups;
+  p.out_c_per_group = weight.size(0) / groups;
+  p.in_h = input.size(2);
+  p.in_w = input.size(3);
+  p.out_h = grad_output.size(2);
+  p.out_w = grad_output.size(3);
+  p.kernel_h = weight.size(2);
+  p.kernel_w = weight.size(3);
+  p.stride_h = val_at(stride, 0);
+  p.stride_w = val_at(stride, 1);
+  p.pad_h = val_at(padding, 0, /*default_value=*/0);
+  p.pad_w = val_at(padding, 1, /*default_value=*/0);
+  p.dilation_h = val_at(dilation, 0);
+  p.dilation_w = val_at(dilation, 1);
+  p.in_strides = get_strides(input);
+  p.grad_out_strides = get_strides(grad_output);
+  return p;
+}
+
+/**
+ * Calls `fn(k, ci, ih, iw, i)` for every row k in [k_begin, k_end) of cols,
+ * k walking (ci, kh, kw), and every output position p_begin + i in the
+ * tile of num_p positions whose input (ih, iw) is inside the input.
+ */
+template <typename Fn>
+void for_each_col_element(
+    const ConvBackwardParams& p,
+    int64_t k_begin,
+    int64_t k_end,
+    int64_t p_begin,
+    int64_t num_p,
+    const Fn& fn) {
+  const int64_t kernel_size = p.kernel_h * p.kernel_w;
+  for (const auto k : c10::irange(k_begin, k_end)) {
+    const int64_t ci = k / kernel_size;
+    const int64_t kh = k % kernel_size / p.kernel_w;
+    const int64_t kw = k % p.kernel_w;
+    int64_t oh = p_begin / p.out_w;
+    int64_t ow = p_begin % p.out_w;
+    for (const auto i : c10::irange(num_p)) {
+      const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dilation_h;
+      const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dilation_w;
+      if (ih >= 0 && ih < p.in_h && iw >= 0 && iw < p.in_w) {
+        fn(k, ci, ih, iw, i);
+      }
+      if (++ow == p.out_w) {
+        ow = 0;
+        ++oh;
+      }
+    }
+  }
+}
+
+/**
+ * grad_weight: for the rows [k_begin, k_end) of cols of one group, sums
+ * grad_output @ cols^T over the batch into the rows of packed, which is
+ * [out channels][k_size].
+ */
+template <typename CTYPE>
+void weight_grad_rows(
+    const ConvBackwardParams& p,
+    const CTYPE* grad_output,
+    const CTYPE* input,
+    int64_t group,
+    int64_t k_begin,
+    int64_t k_end,
+    CTYPE* col,
+    int64_t tile_size,
+    CTYPE* packed) {
+  const auto& is = p.in_strides;
+  const auto& os = p.grad_out_strides;
+  const int64_t k_size = p.k_size();
+  const int64_t num_k = k_end - k_begin;
+  const int64_t out_size = p.out_h * p.out_w;
+  const int64_t out_c_begin = group * p.out_c_per_group;
+  for (const auto n : c10::irange(p.batch)) {
+    const CTYPE* const group_in =
+        input + n * is[0] + group * p.in_c_per_group * is[1];
+    const CTYPE* const group_grad_out =
+        grad_output + n * os[0] + out_c_begin * os[1];
+    for (int64_t p_begin = 0; p_begin < out_size; p_begin += tile_size) {
+      const int64_t num_p = std::min(tile_size, out_size - p_begin);
+      std::fill(col, col + num_k * num_p, static_cast<CTYPE>(0));
+      for_each_col_element(
+          p,
+          k_begin,
+          k_end,
+          p_begin,
+          num_p,
+          [&](int64_t k, int64_t ci, int64_t ih, int64_t iw, int64_t i) {
+            col[(k - k_begin) * num_p + i] =
+                group_in[ci * is[1] + ih * is[2] + iw * is[3]];
+          });
+      // Column-major, packed rows are an num_k x out_c matrix:
+      // packed += cols @ grad_output^T.
+      const CTYPE* const g = group_grad_out + p_begin * os[3];
+      executorch::cpublas::gemm(
+          TransposeType::Transpose,
+          os[3] == 1 ? TransposeType::NoTranspose : TransposeType::Transpose,
+          num_k,
+          p.out_c_per_group,
+          num_p,
+          static_cast<CTYPE>(1),
+          col,
+          num_p,
+          g,
+          os[3] == 1 ? os[1] : os[3],
+          static_cast<CTYPE>(1),
+          packed + out_c_begin * k_size + k_begin,
+          k_size);
+    }
+  }
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool conv2d_weight_grad(
+    KernelRuntimeContext& ctx,
+    const ConvBackwardParams& p,
+    const CTYPE* grad_output,
+    const CTYPE* input,
+    Tensor& grad_weight) {
+  const int64_t k_size = p.k_size();
+  const int64_t out_size = p.out_h * p.out_w;
+  // The rows of cols of each task, and the positions of a column buffer.
+  const int64_t rows = std::min(
+      k_size,
+      std::max(
+          kMinWeightRows,
+          executorch::utils::divup(
+              ::executorch::extension::internal::GRAIN_SIZE,
+              p.batch * out_size * p.out_c_per_group)));
+  const int64_t num_row_blocks = executorch::utils::divup(k_size, rows);
+  const int64_t tile_size =
+      std::min(out_size, std::max(kMinTileSize, kColBufferSize / rows));
+
+  const int64_t num_tasks = p.groups * num_row_blocks;
+  const int64_t col_size = rows * tile_size;
+  CTYPE* const packed = allocate_scratch<CTYPE>(ctx, p.out_channels() * k_size);
+  CTYPE* const cols =
+      allocate_scratch<CTYPE>(ctx, num_scratch_slots(num_tasks) * col_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      packed != nullptr && cols != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate grad_weight buffers");
+  std::fill(packed, packed + p.out_channels() * k_size, CTYPE(0));
+  const bool success = parallel_for_slots(
+      num_tasks, [&](int64_t slot, int64_t begin, int64_t end) {
+        CTYPE* const col = cols + slot * col_size;
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t group = task / num_row_blocks;
+          const int64_t k_begin = task % num_row_blocks * rows;
+          weight_grad_rows(
+              p,
+              grad_output,
+              input,
+              group,
+              k_begin,
+              std::min(k_begin + rows, k_size),
+              col,
+              tile_size,
+              packed);
+        }
+      });
+  if (!success) {
+    return false;
+  }
+
+  // Unpack into the layout of grad_weight.
+  CTYPE* const out = grad_weight.mutable_data_ptr<CTYPE>();
+  const auto ws = get_strides(grad_weight);
+  for (const auto co : c10::irange(p.out_channels())) {
+    for (const auto ci : c10::irange(p.in_c_per_group)) {
+      for (const auto kh : c10::irange(p.kernel_h)) {
+        for (const auto kw : c10::irange(p.kernel_w)) {
+          out[co * ws[0] + ci * ws[1] + kh * ws[2] + kw * ws[3]] =
+              packed[co * k_size + (ci * p.kernel_h + kh) * p.kernel_w + kw];
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool conv2d_input_grad(
+    KernelRuntimeContext& ctx,
+    const ConvBackwardParams& p,
+    const CTYPE* grad_output,
+    const Tensor& weight,
+    Tensor& grad_input) {
+  const auto& os = p.grad_out_strides;
+  const auto gs = get_strides(grad_input);
+  const int64_t k_size = p.k_size();
+  const int64_t out_size = p.out_h * p.out_w;
+  const int64_t tile_size =
+      std::min(out_size, std::max(kMinTileSize, kColBufferSize / k_size));
+
+  // The weights of each group as an [out_c_per_group][k_size] matrix.
+  const int64_t num_tasks = p.batch * p.groups;
+  const int64_t col_size = k_size * tile_size;
+  CTYPE* const packed = allocate_scratch<CTYPE>(ctx, p.out_channels() * k_size);
+  CTYPE* const cols =
+      allocate_scratch<CTYPE>(ctx, num_scratch_slots(num_tasks) * col_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      packed != nullptr && cols != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate grad_input buffers");
+  const CTYPE* const weight_data = weight.const_data_ptr<CTYPE>();
+  const auto ws = get_strides(weight);
+  for (const auto co : c10::irange(p.out_channels())) {
+    for (const auto ci : c10::irange(p.in_c_per_group)) {
+      for (const auto kh : c10::irange(p.kernel_h)) {
+        for (const auto kw : c10::irange(p.kernel_w)) {
+          packed[co * k_size + (ci * p.kernel_h + kh) * p.kernel_w + kw] =
+              weight_data[co * ws[0] + ci * ws[1] + kh * ws[2] + kw * ws[3]];
+        }
+      }
+    }
+  }
+
+  CTYPE* const grad_input_data = grad_input.mutable_data_ptr<CTYPE>();
+  return parallel_for_slots(
+      num_tasks, [&](int64_t slot, int64_t begin, int64_t end) {
+        CTYPE* const col = cols + slot * col_size;
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t n = task / p.groups;
+          const int64_t group = task % p.groups;
+          const int64_t out_c_begin = group * p.out_c_per_group;
+          CTYPE* const group_grad_in =
+              grad_input_data + n * gs[0] + group * p.in_c_per_group * gs[1];
+          for (int64_t p_begin = 0; p_begin < out_size; p_begin += tile_size) {
+            const int64_t num_p = std::min(tile_size, out_size - p_begin);
+            // Column-major, cols is a num_p x k_size matrix:
+            // cols = grad_output^T @ weight.
+            const CTYPE* const g =
+                grad_output + n * os[0] + out_c_begin * os[1] + p_begin * os[3];
+            executorch::cpublas::gemm(
+                os[3] == 1 ? TransposeType::NoTranspose
+                           : TransposeType::Transpose,
+                TransposeType::Transpose,
+                num_p,
+                k_size,
+                p.out_c_per_group,
+                static_cast<CTYPE>(1),
+                g,
+                os[3] == 1 ? os[1] : os[3],
+                packed + out_c_begin * k_size,
+                k_size,
+                static_cast<CTYPE>(0),
+                col,
+                num_p);
+            for_each_col_element(
+                p,
+                0,
+                k_size,
+                p_begin,
+                num_p,
+                [&](int64_t k, int64_t ci, int64_t ih, int64_t iw, int64_t i) {
+                  group_grad_in[ci * gs[1] + ih * gs[2] + iw * gs[3]] +=
+                      col[k * num_p + i];
+                });
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool conv2d_bias_grad(
+    const ConvBackwardParams& p,
+    const CTYPE* grad_output,
+    CTYPE* grad_bias) {
+  const auto& os = p.grad_out_strides;
+  const int64_t out_size = p.out_h * p.out_w;
+  return ::executorch::extension::parallel_for(
+      0,
+      p.out_channels(),
+      std::max<int64_t>(
+          1,
+          ::executorch::extension::internal::GRAIN_SIZE /
+              std::max<int64_t>(1, p.batch * out_size)),
+      [&](const auto begin, const auto end) {
+        for (const auto co : c10::irange(begin, end)) {
+          CTYPE sum = 0;
+          for (const auto n : c10::irange(p.batch)) {
+            const CTYPE* const plane = grad_output + n * os[0] + co * os[1];
+            for (const auto i : c10::irange(out_size)) {
+              sum += plane[i * os[3]];
+            }
+          }
+          grad_bias[co] = sum;
+        }
+      });
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool conv2d_backward_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& grad_output,
+    const Tensor& input,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    executorch::aten::ArrayRef<bool> output_mask,
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    Tensor& grad_bias) {
+  if (output_mask[0]) {
+    memset(grad_input.mutable_data_ptr<CTYPE>(), 0, grad_input.nbytes());
+  }
+  if (output_mask[1]) {
+    memset(grad_weight.mutable_data_ptr<CTYPE>(), 0, grad_weight.nbytes());
+  }
+  if (output_mask[2]) {
+    memset(grad_bias.mutable_data_ptr<CTYPE>(), 0, grad_bias.nbytes());
+  }
+  if (grad_output.numel() == 0) {
+    return true;
+  }
+
+  const ConvBackwardParams p =
+      get_params(grad_output, input, weight, stride, padding, dilation, groups);
+  const CTYPE* const grad_output_data = grad_output.const_data_ptr<CTYPE>();
+
+  if (p.k_size() == 0) {
+    // The input has no channels, and all gradients but grad_bias are empty.
+    return !output_mask[2] ||
+        conv2d_bias_grad(
+               p, grad_output_data, grad_bias.mutable_data_ptr<CTYPE>());
+  }
+
+  bool success = true;
+  if (output_mask[0]) {
+    success &= conv2d_input_grad(ctx, p, grad_output_data, weight, grad_input);
+  }
+  if (output_mask[1]) {
+    success &= conv2d_weight_grad(
+        ctx, p, grad_output_data, input.const_data_ptr<CTYPE>(), grad_weight);
+  }
+  if (output_mask[2]) {
+    success &= conv2d_bias_grad(
+        p, grad_output_data, grad_bias.mutable_data_ptr<CTYPE>());
+  }
+  return success;
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&, Tensor&> opt_convolution_backward_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& grad_output,
+    const Tensor& input,
+    const Tensor& weight,
+    const OptIntArrayRef bias_sizes_opt,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    executorch::aten::ArrayRef<bool> output_mask,
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    Tensor& grad_bias) {
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(
+      grad_input, grad_weight, grad_bias);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_backward_args(
+          grad_output,
+          input,
+          weight,
+          bias_sizes_opt,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          output_mask,
+          grad_input,
+          grad_weight,
+          grad_bias),
+      InvalidArgument,
+      ret_val);
+
+  if (output_mask[0]) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(grad_input, input.sizes()) == Error::Ok,
+        InvalidArgument,
+        ret_val);
+  }
+
+  if (output_mask[1]) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(grad_weight, weight.sizes()) == Error::Ok,
+        InvalidArgument,
+        ret_val);
+  }
+
+  if (bias_sizes_opt.has_value() && output_mask[2]) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(grad_bias, bias_sizes_opt.value()) == Error::Ok,
+        InvalidArgument,
+        ret_val);
+  }
+
+  constexpr auto name = "convolution_backward.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    const bool success = conv2d_backward_impl<CTYPE>(
+        ctx,
+        grad_output,
+        input,
+        weight,
+        stride,
+        padding,
+        dilation,
+        groups,
+        output_mask,
+        grad_input,
+        grad_weight,
+        grad_bias);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
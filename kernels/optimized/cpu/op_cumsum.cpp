@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/dtype_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+using internal::allocate_scratch;
+
+// The number of elements whose prefix sum is computed in registers at once.
+constexpr int64_t kScanBlock = 8;
+
+// The number of elements of a row scanned by one task when a long row is
+// split across tasks.
+constexpr int64_t kScanChunk = ::executorch::extension::internal::GRAIN_SIZE;
+
+// The number of trailing elements one task scans along the dim.
+constexpr int64_t kTrailingChunk = 1024;
+
+// Half and BFloat16 round after every addition, so they keep the serial
+// order; bool has no meaningful blocked sum.
+template <typename CTYPE>
+constexpr bool kCanReassociate =
+    std::is_arithmetic_v<CTYPE> && !std::is_same_v<CTYPE, bool>;
+
+/**
+ * Writes the inclusive prefix sum of `in[0:n]`, offset by `carry`, to
+ * `out[0:n]`, which may be the same memory. Returns the last sum.
+ */
+template <typename CTYPE>
+CTYPE scan_contiguous(const CTYPE* in, CTYPE* out, int64_t n, CTYPE carry) {
+  int64_t i = 0;
+  if constexpr (kCanReassociate<CTYPE>) {
+    // Blocks are scanned in log2(kScanBlock) shift-and-add steps that the
+    // compiler keeps in vector registers.
+    for (; i + kScanBlock <= n; i += kScanBlock) {
+      CTYPE block[kScanBlock];
+      for (const auto l : c10::irange(kScanBlock)) {
+        block[l] = in[i + l];
+      }
+      for (int64_t shift = 1; shift < kScanBlock; shift *= 2) {
+        for (int64_t l = kScanBlock - 1; l >= shift; --l) {
+          block[l] += block[l - shift];
+        }
+      }
+      for (const auto l : c10::irange(kScanBlock)) {
+        out[i + l] = block[l] + carry;
+      }
+      carry = out[i + kScanBlock - 1];
+    }
+  }
+  for (; i < n; ++i) {
+    carry = carry + in[i];
+    out[i] = carry;
+  }
+  return carry;
+}
+
+/**
+ * Returns the sum of `in[0:n]`.
+ */
+template <typename CTYPE>
+CTYPE sum_contiguous(const CTYPE* in, int64_t n) {
+  CTYPE sum[kScanBlock] = {};
+  int64_t i = 0;
+  for (; i + kScanBlock <= n; i += kScanBlock) {
+    for (const auto l : c10::irange(kScanBlock)) {
+      sum[l] += in[i + l];
+    }
+  }
+  for (; i < n; ++i) {
+    sum[0] += in[i];
+  }
+  CTYPE total = sum[0];
+  for (const auto l : c10::irange(1, kScanBlock)) {
+    total += sum[l];
+  }
+  return total;
+}
+
+/**
+ * Scans `leading` contiguous rows of `dim_size` elements. Rows are split
+ * across tasks; when there are fewer rows than chunks in a row, the rows are
+ * also split into chunks with a two-pass scan: the first pass sums every
+ * chunk and the second scans every chunk starting from the sum of the
+ * chunks before it. The chunk sums are kept in temp memory from `ctx`.
+ *
+ * @returns false if a parallel_for or the allocation failed; allocation
+ *     failures are also reported to `ctx`.
+ */
+template <typename CTYPE>
+bool scan_rows(
+    KernelRuntimeContext& ctx,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t leading,
+    int64_t dim_size) {
+  const int64_t num_chunks = (dim_size + kScanChunk - 1) / kScanChunk;
+  if constexpr (kCanReassociate<CTYPE>) {
+    if (num_chunks > 1 && leading < num_chunks) {
+      const int64_t num_tasks = leading * num_chunks;
+      const auto chunk_size = [&](int64_t task) {
+        return std::min(kScanChunk, dim_size - task % num_chunks * kScanChunk);
+      };
+      const auto chunk_offset = [&](int64_t task) {
+        return task / num_chunks * dim_size + task % num_chunks * kScanChunk;
+      };
+
+      CTYPE* const carries = allocate_scratch<CTYPE>(ctx, num_tasks);
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          carries != nullptr,
+          MemoryAllocationFailed,
+          false,
+          "Failed to allocate the chunk sums");
+      bool success = ::executorch::extension::parallel_for(
+          0, num_tasks, 1, [&](const auto begin, const auto end) {
+            for (const auto task : c10::irange(begin, end)) {
+              carries[task] =
+                  sum_contiguous(in + chunk_offset(task), chunk_size(task));
+            }
+          });
+      if (!success) {
+        return false;
+      }
+      // Turn the chunk sums into the sum of the chunks before each one.
+      for (const auto row : c10::irange(leading)) {
+        CTYPE carry = 0;
+        for (const auto chunk : c10::irange(num_chunks)) {
+          const CTYPE sum = carries[row * num_chunks + chunk];
+          carries[row * num_chunks + chunk] = carry;
+          carry += sum;
+        }
+      }
+      return ::executorch::extension::parallel_for(
+          0, num_tasks, 1, [&](const auto begin, const auto end) {
+            for (const auto task : c10::irange(begin, end)) {
+              const int64_t offset = chunk_offset(task);
+              scan_contiguous(
+                  in + offset, out + offset, chunk_size(task), carries[task]);
+            }
+          });
+    }
+  }
+
+  const int64_t grain_size = std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / dim_size);
+  return ::executorch::extension::parallel_for(
+      0, leading, grain_size, [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t offset = row * dim_size;
+          scan_contiguous(in + offset, out + offset, dim_size, CTYPE(0));
+        }
+      });
+}
+
+/**
+ * Writes `prev[0:n] + in[0:n]` to `out[0:n]`, with vector instructions.
+ */
+template <typename CTYPE>
+void add_contiguous(const CTYPE* prev, const CTYPE* in, CTYPE* out, int64_t n) {
+  if constexpr (std::is_floating_point_v<CTYPE>) {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map2(
+        [](Vec x, Vec y) { return x + y; }, out, prev, in, n);
+  } else if constexpr (
+      std::is_same_v<CTYPE, executorch::aten::Half> ||
+      std::is_same_v<CTYPE, executorch::aten::BFloat16>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    executorch::vec::map2_via_float(
+        [](Vec x, Vec y) { return x + y; }, out, prev, in, n);
+  } else {
+    for (const auto i : c10::irange(n)) {
+      out[i] = prev[i] + in[i];
+    }
+  }
+}
+
+/**
+ * Scans `leading` slices of `dim_size` by `trailing` elements along their
+ * first dim. Every step adds a contiguous run of trailing elements to the
+ * previous one, so the trailing elements are vectorized and split across
+ * tasks together with the slices.
+ */
+template <typename CTYPE>
+bool scan_slices(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t leading,
+    int64_t dim_size,
+    int64_t trailing) {
+  const int64_t chunk = std::min(trailing, kTrailingChunk);
+  const int64_t chunks_per_slice = (trailing + chunk - 1) / chunk;
+  const int64_t grain_size = std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / (dim_size * chunk));
+  return ::executorch::extension::parallel_for(
+      0,
+      leading * chunks_per_slice,
+      grain_size,
+      [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t slice = task / chunks_per_slice;
+          const int64_t start = task % chunks_per_slice * chunk;
+          const int64_t n = std::min(chunk, trailing - start);
+          const int64_t base = slice * dim_size * trailing + start;
+          if (in != out) {
+            std::copy(in + base, in + base + n, out + base);
+          }
+          for (const auto j : c10::irange(1, dim_size)) {
+            const int64_t offset = base + j * trailing;
+            add_contiguous(
+                out + offset - trailing, in + offset, out + offset, n);
+          }
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Returns the cumulative sum of elements of input in the dimension dim.
+ * If dtype is specified, the input tensor is casted to dtype before the
+ * operation is performed.
+ *
+ * Unlike the portable kernel, independent slices are scanned in parallel,
+ * long contiguous rows are split with a two-pass blocked scan, and the sums
+ * are vectorized. Floating point sums may therefore be associated
+ * differently than a serial scan would.
+ */
+Tensor& opt_cumsum_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    int64_t dim,
+    optional<ScalarType> enforced_dtype,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_cumsum_args(self, dim, enforced_dtype, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(self, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, self.sizes()) == Error::Ok, InvalidArgument, out);
+
+  if (self.numel() == 0) {
+    return out;
+  }
+
+  dim = (self.dim() == 0) ? 0 : dim < 0 ? dim + self.dim() : dim;
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "cumsum.out";
+
+  ET_SWITCH_REALHBBF16_TYPES(out.scalar_type(), ctx, op_name, CTYPE_OUT, [&] {
+    CTYPE_OUT* const out_data = out.mutable_data_ptr<CTYPE_OUT>();
+    const CTYPE_OUT* in_data = out_data;
+    if (self.scalar_type() == out.scalar_type()) {
+      in_data = self.const_data_ptr<CTYPE_OUT>();
+    } else {
+      // Cast into out first, then scan it in place.
+      const auto load_self =
+          utils::internal::get_load_to_compute_fn<CTYPE_OUT, op_name>(
+              self, utils::SupportedTensorDtypes::REALHBBF16);
+      const char* const self_data =
+          reinterpret_cast<const char*>(self.const_data_ptr());
+      const size_t element_size = self.element_size();
+      const bool success = ::executorch::extension::parallel_for(
+          0,
+          self.numel(),
+          ::executorch::extension::internal::GRAIN_SIZE,
+          [&](const auto begin, const auto end) {
+            for (const auto i : c10::irange(begin, end)) {
+              out_data[i] = load_self(self_data + i * element_size);
+            }
+          });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+    }
+
+    if (self.dim() == 0) {
+      out_data[0] = in_data[0];
+      return;
+    }
+
+    const int64_t dim_size = self.size(dim);
+    const int64_t leading = getLeadingDims(self, dim);
+    const int64_t trailing = getTrailingDims(self, dim);
+    const bool success = trailing == 1
+        ? scan_rows(ctx, in_data, out_data, leading, dim_size)
+        : scan_slices(in_data, out_data, leading, dim_size, trailing);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/fft_utils.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+Tensor& opt_fft_c2c_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef dim,
+    int64_t normalization,
+    bool forward,
+    Tensor& out) {
+  ET_KERNEL_CHECK(ctx, in.dim() <= kTensorDimensionLimit, InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, !dim.empty(), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      executorch::runtime::isComplexType(in.scalar_type()),
+      InvalidArgument,
+      out,
+      "the input type for _fft_c2c must be Complex");
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out.scalar_type() == in.scalar_type(),
+      InvalidArgument,
+      out,
+      "the output type for _fft_c2c must match the input type");
+
+  ET_KERNEL_CHECK(ctx, check_fft_dims(in, dim), InvalidArgument, out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  pocketfft::shape_t axes(dim.begin(), dim.end());
+  auto in_stride = stride_from_tensor(in);
+  auto out_stride = stride_from_tensor(out);
+  ET_SWITCH_FLOAT_TYPES(
+      executorch::runtime::toRealValueType(in.scalar_type()),
+      ctx,
+      "_fft_c2c.out",
+      CTYPE,
+      [&] {
+        auto fct = compute_fct<CTYPE>(ctx, in, dim, normalization);
+        if (!fct) {
+          // Check failed, just bail out of the lambda.
+          return;
+        }
+        const bool success = parallel_fft(
+            in,
+            out,
+            dim,
+            tensor_cdata<CTYPE>(in),
+            tensor_cdata<CTYPE>(out),
+            [&](const pocketfft::shape_t& shape,
+                const pocketfft::shape_t&,
+                const std::complex<CTYPE>* in_data,
+                std::complex<CTYPE>* out_data) {
+              pocketfft::c2c<CTYPE>(
+                  shape,
+                  in_stride,
+                  out_stride,
+                  axes,
+                  forward,
+                  in_data,
+                  out_data,
+                  *fct);
+            });
+        ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+      });
+  return out;
+}
+} // namespace torch::executor::native
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/fft_utils.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch::executor::native {
+
+Tensor& opt_fft_c2r_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef dim,
+    int64_t normalization,
+    int64_t last_dim_size,
+    Tensor& out) {
+  auto in_sizes = in.sizes();
+  ET_KERNEL_CHECK(ctx, in.dim() <= kTensorDimensionLimit, InvalidArgument, out);
+
+  std::array<Tensor::SizesType, kTensorDimensionLimit> out_sizes_storage;
+  executorch::runtime::Span<Tensor::SizesType> out_sizes(
+      out_sizes_storage.data(), in_sizes.size());
+  std::copy(in_sizes.begin(), in_sizes.end(), out_sizes.begin());
+  ET_KERNEL_CHECK(ctx, !dim.empty(), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      executorch::runtime::isComplexType(in.scalar_type()),
+      InvalidArgument,
+      out,
+      "the input type for _fft_c2r must be Complex");
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out.scalar_type() ==
+          executorch::runtime::toRealValueType(in.scalar_type()),
+      InvalidArgument,
+      out,
+      "the output type for _fft_c2r must be the real type corresponding to the input type");
+
+  ET_KERNEL_CHECK(ctx, check_fft_dims(in, dim), InvalidArgument, out);
+
+  // The input holds the first last_dim_size / 2 + 1 entries of a
+  // Hermitian-symmetric signal along dim.back(); the rest are implied.
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      last_dim_size >= 1 && in.size(dim.back()) >= last_dim_size / 2 + 1,
+      InvalidArgument,
+      out,
+      "last_dim_size %" PRId64 " does not match input size %" PRId64,
+      last_dim_size,
+      static_cast<int64_t>(in.size(dim.back())));
+
+  out_sizes[dim.back()] = last_dim_size;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(
+          out,
+          executorch::runtime::ArrayRef<Tensor::SizesType>(
+              out_sizes.data(), out_sizes.size())) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor (last dim %d).",
+      out_sizes[dim.back()]);
+
+  pocketfft::shape_t axes(dim.begin(), dim.end());
+  auto in_stride = stride_from_tensor(in);
+  auto out_stride = stride_from_tensor(out);
+  ET_SWITCH_FLOAT_TYPES(out.scalar_type(), ctx, "_fft_c2r.out", CTYPE_OUT, [&] {
+    // The normalization is by the size of the signal, which is the output.
+    auto fct = compute_fct<CTYPE_OUT>(ctx, out, dim, normalization);
+    if (!fct) {
+      // Check failed, just bail out of the lambda.
+      return;
+    }
+    const bool success = parallel_fft(
+        in,
+        out,
+        dim,
+        tensor_cdata<CTYPE_OUT>(in),
+        out.mutable_data_ptr<CTYPE_OUT>(),
+        [&](const pocketfft::shape_t&,
+            const pocketfft::shape_t& out_shape,
+            const std::complex<CTYPE_OUT>* in_data,
+            CTYPE_OUT* out_data) {
+          pocketfft::c2r<CTYPE_OUT>(
+              out_shape,
+              in_stride,
+              out_stride,
+              axes,
+              false,
+              in_data,
+              out_data,
+              *fct);
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+  return out;
+}
+} // namespace torch::executor::native
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <algorithm>
+#include <cstdint>
+
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+using executorch::extension::parallel_for;
+using executorch::extension::internal::GRAIN_SIZE;
+
+// The offset in `in` of the first element of block `outer` of `index`,
+// where blocks span dims [dim, ndim).
+int64_t in_offset_of_outer_block(
+    const Tensor& in,
+    const Tensor& index,
+    int64_t dim,
+    int64_t outer) {
+  int64_t offset = 0;
+  int64_t in_block_size = static_cast<int64_t>(getTrailingDims(in, dim - 1));
+  for (int64_t d = dim - 1; d >= 0; --d) {
+    offset += outer % index.size(d) * in_block_size;
+    outer /= index.size(d);
+    in_block_size *= in.size(d);
+  }
+  return offset;
+}
+
+// out[o][j][k] = in[o][index[o][j][k]][k], where o indexes the dims before
+// dim and k the dims after it. Requires index and in to have the same
+// sizes after dim, so that k is contiguous in both.
+template <typename CTYPE>
+[[nodiscard]] bool gather_over_contiguous_inner_dims(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t dim_size = index.size(dim);
+  const int64_t inner_size = static_cast<int64_t>(getTrailingDims(index, dim));
+  const int64_t block_size = dim_size * inner_size;
+
+  return parallel_for(
+      0, index.numel(), GRAIN_SIZE, [&](const auto begin, const auto end) {
+        // Walk [begin, end) a block at a time, so that the input offset of
+        // a block is only computed once.
+        int64_t outer = begin / block_size;
+        int64_t k = begin % inner_size;
+        int64_t i = begin;
+        while (i < end) {
+          const CTYPE* const in_block =
+              in_data + in_offset_of_outer_block(in, index, dim, outer);
+          const int64_t block_end =
+              std::min<int64_t>(end, (outer + 1) * block_size);
+          for (; i < block_end; ++i) {
+            out_data[i] = in_block[index_data[i] * inner_size + k];
+            if (++k == inner_size) {
+              k = 0;
+            }
+          }
+          ++outer;
+        }
+      });
+}
+
+// Any other gather, one coordinate at a time.
+template <typename CTYPE>
+[[nodiscard]] bool gather_elementwise(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  return parallel_for(
+      0, index.numel(), GRAIN_SIZE, [&](const auto begin, const auto end) {
+        size_t coord[kTensorDimensionLimit];
+        for (const auto ix : c10::irange(begin, end)) {
+          indexToCoordinate(index, ix, coord);
+          coord[dim] = index_data[ix];
+          out_data[ix] = in_data[coordinateToIndex(in, coord)];
+        }
+      });
+}
+
+} // namespace
+
+// gather.out(Tensor self, int dim, Tensor index, *, bool sparse_grad=False,
+// Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_gather_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    bool sparse_grad,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_gather_args(in, dim, index, sparse_grad, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, index.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (index.numel() == 0) {
+    return out;
+  }
+
+  constexpr auto name = "gather.out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    if (index.dim() == 0 || in.dim() == 0) {
+      // A single input element, or a single index.
+      const int64_t* const index_data = index.const_data_ptr<int64_t>();
+      for (const auto i : c10::irange(index.numel())) {
+        out.mutable_data_ptr<CTYPE>()[i] =
+            in.const_data_ptr<CTYPE>()[index_data[i]];
+      }
+      return;
+    }
+    const bool success =
+        getTrailingDims(index, dim) == getTrailingDims(in, dim)
+        ? gather_over_contiguous_inner_dims<CTYPE>(in, index, out, dim)
+        : gather_elementwise<CTYPE>(in, index, out, dim);
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/portable/cpu/util/advanced_index_util.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+using internal::allocate_scratch;
+using internal::parallel_for_slots;
+
+namespace {
+
+/**
+ * Returns the position of the only index in `indices` if it is an integral
+ * index, and `values` has exactly the shape of `in[indices]` with contiguous
+ * data, so that every index value writes a contiguous row of `out` from a
+ * contiguous row of `values`. Otherwise returns -1.
+ */
+int64_t get_row_index_dim(
+    TensorOptList indices,
+    const Tensor& values,
+    ArrayRef<Tensor::SizesType> x_sizes) {
+  int64_t dim = -1;
+  for (const auto i : c10::irange(indices.size())) {
+    if (!indices[i].has_value()) {
+      continue;
+    }
+    const ScalarType ix_type = indices[i].value().scalar_type();
+    if (dim >= 0 ||
+        (ix_type != ScalarType::Long && ix_type != ScalarType::Int)) {
+      return -1;
+    }
+    dim = i;
+  }
+  if (values.sizes() != x_sizes || !tensor_is_default_dim_order(values)) {
+    return -1;
+  }
+  return dim;
+}
+
+/**
+ * Writes `values` to the rows of `out` selected along `dim` by `index`.
+ *
+ * The rows of every slice of `out` are split into partitions, and the index
+ * values are sorted into buckets by partition, keeping their order. A task
+ * then handles one partition of one slice, so no two tasks write the same
+ * row, and duplicate index values are applied in order, like a serial loop.
+ */
+template <typename CTYPE>
+void put_rows(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& index,
+    int64_t dim,
+    const Tensor& values,
+    bool accumulate,
+    Tensor& out) {
+  int64_t leading = 1;
+  for (const auto d : c10::irange(dim)) {
+    leading *= in.size(d);
+  }
+  const int64_t dim_size = in.size(dim);
+  int64_t row_size = 1;
+  for (const auto d : c10::irange(dim + 1, in.dim())) {
+    row_size *= in.size(d);
+  }
+  const int64_t num_rows = index.numel();
+  if (num_rows == 0) {
+    return;
+  }
+
+  // Enough partitions that every task of a slice writes about GRAIN_SIZE
+  // elements, but no more than there are rows.
+  constexpr int64_t kGrainSize = ::executorch::extension::internal::GRAIN_SIZE;
+  const int64_t num_partitions = std::max<int64_t>(
+      1,
+      std::min(dim_size, (num_rows * row_size + kGrainSize - 1) / kGrainSize));
+
+  int64_t* const rows = allocate_scratch<int64_t>(ctx, num_rows);
+  int64_t* const starts = allocate_scratch<int64_t>(ctx, num_partitions + 1);
+  int64_t* const next = allocate_scratch<int64_t>(ctx, num_partitions);
+  int64_t* const order = allocate_scratch<int64_t>(ctx, num_rows);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      rows != nullptr && starts != nullptr && next != nullptr &&
+          order != nullptr,
+      MemoryAllocationFailed,
+      ,
+      "Failed to allocate index_put row buffers");
+
+  const bool is_long = index.scalar_type() == ScalarType::Long;
+  for (const auto k : c10::irange(num_rows)) {
+    int64_t row = is_long ? index.const_data_ptr<int64_t>()[k]
+                          : index.const_data_ptr<int32_t>()[k];
+    if (row < 0) {
+      row += dim_size;
+    }
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        row >= 0 && row < dim_size,
+        InvalidArgument,
+        ,
+        "Index %" PRId64
+        " is out of bounds for input dimension %" PRId64
+        " with size %" PRId64 ".",
+        row,
+        dim,
+        dim_size);
+    rows[k] = row;
+  }
+
+  // A stable counting sort of the index values by partition.
+  std::fill(starts, starts + num_partitions + 1, 0);
+  const auto partition = [&](int64_t row) {
+    return row * num_partitions / dim_size;
+  };
+  for (const auto k : c10::irange(num_rows)) {
+    starts[partition(rows[k]) + 1]++;
+  }
+  for (const auto p : c10::irange(num_partitions)) {
+    starts[p + 1] += starts[p];
+  }
+  std::copy(starts, starts + num_partitions, next);
+  for (const auto k : c10::irange(num_rows)) {
+    order[next[partition(rows[k])]++] = k;
+  }
+
+  const CTYPE* const values_data = values.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  // The partitions already hold about GRAIN_SIZE elements each, so the tasks
+  // are only grouped to bound the number of threads.
+  const bool success = parallel_for_slots(
+      leading * num_partitions,
+      [&](int64_t /*slot*/, int64_t begin, int64_t end) {
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t l = task / num_partitions;
+          const int64_t p = task % num_partitions;
+          for (const auto i : c10::irange(starts[p], starts[p + 1])) {
+            const int64_t k = order[i];
+            CTYPE* const dst = out_data + (l * dim_size + rows[k]) * row_size;
+            const CTYPE* const src =
+                values_data + (l * num_rows + k) * row_size;
+            if (accumulate) {
+              for (const auto r : c10::irange(row_size)) {
+                dst[r] += src[r];
+              }
+            } else {
+              memcpy(dst, src, row_size * sizeof(CTYPE));
+            }
+          }
+        }
+      });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+}
+
+} // namespace
+
+Tensor& opt_index_put_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    executorch::aten::ArrayRef<executorch::aten::optional<Tensor>> indices,
+    const Tensor& values,
+    const bool accumulate,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_index_args(in, indices, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dtype(in, values), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  ScalarType in_type = in.scalar_type();
+  size_t block_count = count_index_blocks(indices);
+
+  // If indices list is empty or all indices are null, then the operation is
+  // performed over then entire input tensor. So, this is equivalent to
+  // out = values when accumulate is false. Otherwise, the operation is
+  // out = in + values where accumulate is true.
+  if (block_count == 0) {
+    ET_KERNEL_CHECK(
+        ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+    // Check that values tensors can be broadcasted to out
+    ET_KERNEL_CHECK(
+        ctx, tensor_is_broadcastable_to(values, out), InvalidArgument, out);
+
+    ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, "index_put.out", CTYPE, [&]() {
+      apply_binary_elementwise_fn<CTYPE, CTYPE, CTYPE>(
+          [accumulate](const CTYPE val_in, const CTYPE val) {
+            return accumulate ? val_in + val : val;
+          },
+          in,
+          values,
+          out);
+    });
+    return out;
+  }
+
+  // The index output shape depends on whether all the non-null indices are
+  // adjacent or not.
+  bool adjacent = (block_count == 1);
+
+  // Compute the expected index output shape.
+  Tensor::SizesType x_sizes[kTensorDimensionLimit];
+  size_t x_dim = 0;
+  ET_KERNEL_CHECK(
+      ctx,
+      get_index_out_target_size(in, indices, adjacent, x_sizes, &x_dim),
+      InvalidArgument,
+      out);
+
+  // Check that values tensors can be broadcasted to indexing result
+  ET_KERNEL_CHECK(
+      ctx,
+      tensor_is_broadcastable_to(values.sizes(), {x_sizes, x_dim}),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  // No further action if the input is empty
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  // To start, copy the input data into the out tensor
+  if (out.const_data_ptr() != in.const_data_ptr()) {
+    memcpy(
+        out.mutable_data_ptr<char>(), in.const_data_ptr<char>(), in.nbytes());
+  }
+
+  // A single index along one dim, such as the positions of a KV cache
+  // update, selects whole rows, which are written in parallel.
+  const int64_t row_dim = get_row_index_dim(indices, values, {x_sizes, x_dim});
+  if (row_dim >= 0) {
+    ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, "index_put.out", CTYPE, [&]() {
+      put_rows<CTYPE>(
+          ctx,
+          in,
+          indices[row_dim].value(),
+          row_dim,
+          values,
+          accumulate,
+          out);
+    });
+    return out;
+  }
+
+  // In what follows, `x = in[indices]`. This tensor is implicit, and it would
+  // be much easier to be able to allocate memory, and then call index.Tensor
+  // to compute `x`. But since we can't do that, we have to keep track of its
+  // shape, number of dimensions, number of elements, and use it to translate
+  // coordinates from `x` to `in`.
+
+  // Compute the dim_map and ix_map needed for `x -> in` coordinate translation
+  int32_t dim_map[kTensorDimensionLimit];
+  int32_t ix_map[kTensorDimensionLimit];
+  size_t start = 0;
+
+  if (adjacent) {
+    start = get_num_leading_null_indices(indices);
+  }
+  size_t bc_ndim = get_indices_broadcast_ndim(indices);
+  compute_dim_map(in, indices, dim_map, block_count == 1);
+  compute_index_map(in, indices, ix_map);
+
+  // Compute the number of elements in the indexed space
+  size_t x_numel = 1;
+  for (const auto i : c10::irange(x_dim)) {
+    x_numel *= x_sizes[i];
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, "index_put.out", CTYPE, [&]() {
+    const CTYPE* const values_data = values.const_data_ptr<CTYPE>();
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+    for (const auto x_ix : c10::irange(x_numel)) {
+      size_t in_ix = 0;
+
+      size_t x_coord[kTensorDimensionLimit];
+      delinearize_index(x_ix, {x_sizes, x_dim}, x_coord, kTensorDimensionLimit);
+
+      size_t in_coord[kTensorDimensionLimit];
+
+      ET_KERNEL_CHECK(
+          ctx,
+          get_in_coord(
+              in, indices, start, bc_ndim, dim_map, ix_map, x_coord, in_coord),
+          InvalidArgument, );
+
+      in_ix = coordinateToIndex(in, in_coord);
+
+      // Braodcast values
+      size_t val_ix = linearize_access_indexes(x_coord, x_dim, values);
+      if (accumulate) {
+        out_data[in_ix] += values_data[val_ix];
+      } else {
+        out_data[in_ix] = values_data[val_ix];
+      }
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+// index_select.out(Tensor self, int dim, Tensor index, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_index_select_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_index_select_args(in, dim, index, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  size_t expected_ndim = 0;
+  Tensor::SizesType expected_size[kTensorDimensionLimit];
+  get_index_select_out_target_size(
+      in, dim, index, expected_size, &expected_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_size, expected_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (in.dim() == 0) {
+    memcpy(out.mutable_data_ptr(), in.const_data_ptr(), in.nbytes());
+    return out;
+  }
+
+  const int64_t leading_dims = getLeadingDims(in, dim);
+  const int64_t trailing_dims = getTrailingDims(in, dim);
+
+  if (leading_dims == 0 || trailing_dims == 0) {
+    return out;
+  }
+
+  // Each of the leading_dims blocks of out is a gather of rows of
+  // trailing_dims elements from the matching block of in.
+  const int64_t length_per_step = trailing_dims * in.element_size();
+  const int64_t in_block_bytes = in.size(dim) * length_per_step;
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, index.scalar_type(), ctx, "index_select.out", CTYPE, [&]() {
+        const bool success = gather_rows(
+            in.const_data_ptr<char>(),
+            in_block_bytes,
+            index.const_data_ptr<CTYPE>(),
+            index.numel(),
+            length_per_step,
+            leading_dims,
+            out.mutable_data_ptr<char>());
+        ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
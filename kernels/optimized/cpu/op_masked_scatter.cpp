@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/mask_utils.h>
+#include <executorch/kernels/optimized/cpu/multiversion/mask_kernels.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_indexes_range.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+ET_DEFINE_DISPATCH(masked_scatter_stub);
+
+Tensor& opt_masked_scatter_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mask,
+    const Tensor& src,
+    Tensor& out) {
+  ScalarType in_type = in.scalar_type();
+
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensor_is_realhbbf16_type(in),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, mask.scalar_type() == ScalarType::Bool, InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, src.scalar_type() == in_type, InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.scalar_type() == in_type, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, mask, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_to_broadcast_target_size(in, mask, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const bool any_is_broadcasted =
+      in.sizes() != out.sizes() || mask.sizes() != out.sizes();
+
+  const char* const in_data =
+      reinterpret_cast<const char*>(in.const_data_ptr());
+  const bool* const mask_data = mask.const_data_ptr<bool>();
+  const char* const src_data =
+      reinterpret_cast<const char*>(src.const_data_ptr());
+  char* const out_data = reinterpret_cast<char*>(out.mutable_data_ptr());
+  const size_t elem_size = in.element_size();
+
+  // Counting the true elements first gives every block the offset of the
+  // first src element it reads.
+  internal::BlockOffsets offsets(ctx, out.numel());
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      offsets.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate block offsets");
+  bool success = offsets.count([&](int64_t begin, int64_t end) {
+    if (!any_is_broadcasted) {
+      return internal::count_true(mask_data + begin, end - begin);
+    }
+    int64_t count = 0;
+    auto it = BroadcastIndexesRange<2>(out, in, mask).begin();
+    it += begin;
+    for (; (*it)[0] < end; ++it) {
+      count += mask_data[(*it)[2]];
+    }
+    return count;
+  });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      offsets.total() <= src.numel(),
+      InvalidArgument,
+      out,
+      "masked_scatter: src doesn't have enough elements");
+
+  success = offsets.write([&](int64_t begin, int64_t end, int64_t offset) {
+    if (!any_is_broadcasted) {
+      // Expand the block with vector instructions where available.
+      masked_scatter_stub(
+          in_data + begin * elem_size,
+          mask_data + begin,
+          src_data + offset * elem_size,
+          end - begin,
+          elem_size,
+          out_data + begin * elem_size);
+      return;
+    }
+    auto it = BroadcastIndexesRange<2>(out, in, mask).begin();
+    it += begin;
+    for (; (*it)[0] < end; ++it) {
+      const auto [out_index, in_index, mask_index] = *it;
+      const char* const val = mask_data[mask_index]
+          ? src_data + elem_size * offset++
+          : in_data + elem_size * in_index;
+      memcpy(out_data + elem_size * out_index, val, elem_size);
+    }
+  });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <cstring>
+#include <utility>
+
+#include <executorch/kernels/optimized/cpu/mask_utils.h>
+#include <executorch/kernels/optimized/cpu/multiversion/mask_kernels.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+ET_DEFINE_DISPATCH(masked_select_stub);
+
+Tensor& opt_masked_select_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mask,
+    Tensor& out) {
+  ScalarType in_type = in.scalar_type();
+
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensor_is_realhbbf16_type(in),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, mask.scalar_type() == ScalarType::Bool, InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, out.scalar_type() == in_type, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, mask, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_are_broadcastable_between(in, mask), InvalidArgument, out);
+
+  // If input or mask is empty, the output should be empty
+  if (in.numel() == 0 || mask.numel() == 0) {
+    ET_KERNEL_CHECK(
+        ctx, resize_tensor(out, {0}) == Error::Ok, InvalidArgument, out);
+    return out;
+  }
+
+  // Compute the shape resulting from broadcasting the mask against the input
+  size_t broadcast_ndim = 0;
+  Tensor::SizesType broadcast_sizes[kTensorDimensionLimit];
+  Error err = get_broadcast_target_size(
+      in, mask, broadcast_sizes, kTensorDimensionLimit, &broadcast_ndim);
+  if (err != Error::Ok) {
+    ET_KERNEL_CHECK_MSG(
+        ctx, false, InvalidArgument, out, "Failed to broadcast input and mask");
+  }
+  const ArrayRef<Tensor::SizesType> sizes(broadcast_sizes, broadcast_ndim);
+  int64_t broadcast_numel = 1;
+  for (const auto i : c10::irange(broadcast_ndim)) {
+    broadcast_numel *= broadcast_sizes[i];
+  }
+
+  const bool in_is_broadcasted = in.sizes() != sizes;
+  const bool mask_is_broadcasted = mask.sizes() != sizes;
+
+  const char* const in_data =
+      reinterpret_cast<const char*>(in.const_data_ptr());
+  const bool* const mask_data = mask.const_data_ptr<bool>();
+  const size_t elem_size = in.element_size();
+
+  // Maps an index of the broadcast shape to the indexes of `in` and `mask`.
+  const auto access_indexes = [&](int64_t i) {
+    size_t in_index = i;
+    size_t mask_index = i;
+    if (in_is_broadcasted || mask_is_broadcasted) {
+      size_t broadcast_indexes[kTensorDimensionLimit];
+      delinearize_index(i, sizes, broadcast_indexes, kTensorDimensionLimit);
+      if (in_is_broadcasted) {
+        in_index =
+            linearize_access_indexes(broadcast_indexes, broadcast_ndim, in);
+      }
+      if (mask_is_broadcasted) {
+        mask_index =
+            linearize_access_indexes(broadcast_indexes, broadcast_ndim, mask);
+      }
+    }
+    return std::make_pair(in_index, mask_index);
+  };
+
+  internal::BlockOffsets offsets(ctx, broadcast_numel);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      offsets.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate block offsets");
+  bool success = offsets.count([&](int64_t begin, int64_t end) {
+    if (!mask_is_broadcasted) {
+      return internal::count_true(mask_data + begin, end - begin);
+    }
+    int64_t count = 0;
+    for (const auto i : c10::irange(begin, end)) {
+      count += mask_data[access_indexes(i).second];
+    }
+    return count;
+  });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  // Resize the out tensor
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {static_cast<Tensor::SizesType>(offsets.total())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  char* const out_data = reinterpret_cast<char*>(out.mutable_data_ptr());
+  success = offsets.write([&](int64_t begin, int64_t end, int64_t offset) {
+    if (!in_is_broadcasted && !mask_is_broadcasted) {
+      // Compact the block with vector instructions where available.
+      masked_select_stub(
+          in_data + begin * elem_size,
+          mask_data + begin,
+          end - begin,
+          elem_size,
+          out_data + offset * elem_size);
+      return;
+    }
+    for (const auto i : c10::irange(begin, end)) {
+      const auto [in_index, mask_index] = access_indexes(i);
+      if (mask_data[mask_index]) {
+        memcpy(
+            out_data + offset * elem_size,
+            in_data + in_index * elem_size,
+            elem_size);
+        offset++;
+      }
+    }
+  });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <tuple>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/pool2d_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+using internal::Pool2dWindow;
+
+/**
+ * Writes the max of the window, and the index of its first maximum, for
+ * `num_channels` contiguous channels. Like the portable kernel, an element
+ * only replaces the max so far if it is greater, so the first of equal
+ * values wins and a NaN only wins when it comes first.
+ *
+ * WINDOW_SIZE is the number of positions of the window when it is known at
+ * compile time, so that the loops over it are unrolled, or 0.
+ */
+template <typename CTYPE, int64_t WINDOW_SIZE>
+void max_pool_window(
+    const Pool2dWindow& window,
+    const CTYPE* in,
+    int64_t base_index,
+    int64_t num_channels,
+    CTYPE* out,
+    int64_t* indices) {
+  const int64_t size = WINDOW_SIZE > 0 ? WINDOW_SIZE : window.size;
+  if (size == 0) {
+    // No position of the window is inside the input.
+    for (const auto c : c10::irange(num_channels)) {
+      out[c] = 0;
+      indices[c] = 0;
+    }
+    return;
+  }
+  const int64_t* const offsets = window.offsets;
+
+  int64_t c = 0;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    // The position of the max of each lane is tracked as a float, which is
+    // exact for any realistic window size.
+    using Vec = executorch::vec::Vectorized<float>;
+    for (; c + Vec::size() <= num_channels; c += Vec::size()) {
+      Vec max = Vec::loadu(in + offsets[0] + c);
+      Vec max_pos(0.0f);
+      for (int64_t i = 1; i < size; ++i) {
+        const Vec val = Vec::loadu(in + offsets[i] + c);
+        const Vec greater = val > max;
+        max = Vec::blendv(max, val, greater);
+        max_pos = Vec::blendv(max_pos, Vec(static_cast<float>(i)), greater);
+      }
+      max.store(out + c);
+      float pos[Vec::size()];
+      max_pos.store(pos);
+      for (const auto lane : c10::irange(Vec::size())) {
+        indices[c + lane] =
+            base_index + window.indices[static_cast<int64_t>(pos[lane])];
+      }
+    }
+  }
+  for (; c < num_channels; ++c) {
+    CTYPE max = in[offsets[0] + c];
+    int64_t max_pos = 0;
+    for (int64_t i = 1; i < size; ++i) {
+      const CTYPE val = in[offsets[i] + c];
+      if (val > max) {
+        max = val;
+        max_pos = i;
+      }
+    }
+    out[c] = max;
+    indices[c] = base_index + window.indices[max_pos];
+  }
+}
+
+template <typename CTYPE>
+bool max_pool2d_with_indices(
+    KernelRuntimeContext& ctx,
+    const internal::Pool2dParams& params,
+    bool channels_last,
+    const Tensor& in,
+    Tensor& out,
+    Tensor& indices) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  int64_t* const indices_data = indices.mutable_data_ptr<int64_t>();
+  return internal::for_each_pool2d_window(
+      ctx,
+      params,
+      /*include_pad=*/false,
+      channels_last,
+      [&](const Pool2dWindow& window,
+          int64_t in_offset,
+          int64_t base_index,
+          int64_t out_offset,
+          int64_t num_channels) {
+        const CTYPE* const window_in = in_data + in_offset;
+        CTYPE* const window_out = out_data + out_offset;
+        // Like the portable kernel, indices are written with the layout of
+        // out.
+        int64_t* const window_indices = indices_data + out_offset;
+        // Unrolled loops for the common 2x2 and 3x3 windows.
+        if (window.size == 4) {
+          max_pool_window<CTYPE, 4>(
+              window,
+              window_in,
+              base_index,
+              num_channels,
+              window_out,
+              window_indices);
+        } else if (window.size == 9) {
+          max_pool_window<CTYPE, 9>(
+              window,
+              window_in,
+              base_index,
+              num_channels,
+              window_out,
+              window_indices);
+        } else {
+          max_pool_window<CTYPE, 0>(
+              window,
+              window_in,
+              base_index,
+              num_channels,
+              window_out,
+              window_indices);
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> opt_max_pool2d_with_indices_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out,
+    Tensor& indices) {
+  std::tuple<Tensor&, Tensor&> ret_val(out, indices);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_max_pool2d_with_indices_args(
+          in, kernel_size, stride, padding, dilation, ceil_mode, out, indices),
+      InvalidArgument,
+      ret_val);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_max_pool2d_with_indices_out_target_size(
+      in,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      ceil_mode,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  if (out.numel() == 0) {
+    return ret_val;
+  }
+
+  const auto params = internal::make_pool2d_params(
+      in, out, kernel_size, stride, padding, dilation);
+  // Vectorize along the channels when they are contiguous.
+  const bool channels_last = in.dim() == 4 && params.in_strides[1] == 1 &&
+      params.out_strides[1] == 1 && params.channels > 1;
+
+  ScalarType in_type = in.scalar_type();
+  ET_SWITCH_REALHBF16_TYPES(
+      in_type, ctx, "max_pool2d_with_indices.out", CTYPE, [&]() {
+        const bool success = max_pool2d_with_indices<CTYPE>(
+            ctx, params, channels_last, in, out, indices);
+        // Failures to allocate have already been reported.
+        ET_KERNEL_CHECK_MSG(
+            ctx,
+            success || ctx.failure_state() != Error::Ok,
+            Internal,
+            ,
+            "parallel_for failed");
+      });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/pool2d_utils.h>
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+/// The channels one task handles when channels are contiguous.
+constexpr int64_t kChannelBlock = 64;
+
+bool check_max_pool2d_backward_args(
+    const Tensor& grad_output,
+    const Tensor& input,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    const Tensor& indices,
+    const Tensor& grad_input) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(grad_output, input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(grad_input, input));
+
+  ET_CHECK_OR_RETURN_FALSE(
+      check_max_pool2d_with_indices_args(
+          input,
+          kernel_size,
+          stride,
+          padding,
+          dilation,
+          ceil_mode,
+          grad_output,
+          indices),
+      "Invalid max_pool_2d arguments");
+
+  size_t output_ndim = 0;
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_max_pool2d_with_indices_out_target_size(
+      input,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      ceil_mode,
+      output_sizes,
+      &output_ndim);
+
+  ET_LOG_AND_RETURN_IF_FALSE(
+      output_size_is_valid({output_sizes, output_ndim}, 2));
+
+  ET_CHECK_OR_RETURN_FALSE(
+      grad_output.dim() == input.dim(),
+      "grad_output should have same number of dimensions as input");
+
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensor_has_expected_size(grad_output, {output_sizes, output_ndim}));
+
+  return true;
+}
+
+/**
+ * Adds each element of grad_output into grad_input at the index in the
+ * input plane that indices holds for it, in parallel over planes, or over
+ * blocks of channels when channels are contiguous. Overlapping windows can
+ * send several outputs to the same input, so tasks never split a plane.
+ *
+ * @returns false if parallel_for failed.
+ */
+template <typename CTYPE>
+[[nodiscard]] bool max_pool2d_backward(
+    const internal::Pool2dParams& p,
+    const Tensor& grad_output,
+    const Tensor& indices,
+    Tensor& grad_input) {
+  const CTYPE* const grad_output_data = grad_output.const_data_ptr<CTYPE>();
+  // Like the forward kernel, indices have the layout of the output.
+  const int64_t* const indices_data = indices.const_data_ptr<int64_t>();
+  CTYPE* const grad_input_data = grad_input.mutable_data_ptr<CTYPE>();
+  std::fill(
+      grad_input_data,
+      grad_input_data + grad_input.numel(),
+      static_cast<CTYPE>(0));
+
+  const auto& is = p.in_strides;
+  const auto& os = p.out_strides;
+  const int64_t out_size = p.out_h * p.out_w;
+  const bool channels_last = is[1] == 1 && os[1] == 1 && p.channels > 1;
+  const int64_t block = channels_last ? kChannelBlock : 1;
+  const int64_t num_blocks = executorch::utils::divup(p.channels, block);
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, out_size * block));
+
+  return ::executorch::extension::parallel_for(
+      0,
+      p.batch * num_blocks,
+      grain_size,
+      [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t n = task / num_blocks;
+          const int64_t c_begin = task % num_blocks * block;
+          const int64_t c_end = std::min(c_begin + block, p.channels);
+          const CTYPE* const go = grad_output_data + n * os[0];
+          const int64_t* const ix = indices_data + n * os[0];
+          CTYPE* const gi = grad_input_data + n * is[0];
+          if (channels_last) {
+            // Each output position reads its channels contiguously.
+            for (const auto oh : c10::irange(p.out_h)) {
+              for (const auto ow : c10::irange(p.out_w)) {
+                const int64_t o = oh * os[2] + ow * os[3];
+                for (const auto c : c10::irange(c_begin, c_end)) {
+                  const int64_t max_index = ix[o + c];
+                  if (max_index != -1) {
+                    const int64_t ih = max_index / p.in_w;
+                    const int64_t iw = max_index % p.in_w;
+                    gi[ih * is[2] + iw * is[3] + c] += go[o + c];
+                  }
+                }
+              }
+            }
+            continue;
+          }
+          const CTYPE* const go_plane = go + c_begin * os[1];
+          const int64_t* const ix_plane = ix + c_begin * os[1];
+          CTYPE* const gi_plane = gi + c_begin * is[1];
+          const bool contiguous = os[3] == 1 && os[2] == p.out_w &&
+              is[3] == 1 && is[2] == p.in_w;
+          if (contiguous) {
+            // The common NCHW case: plain indexed adds.
+            for (const auto i : c10::irange(out_size)) {
+              const int64_t max_index = ix_plane[i];
+              if (max_index != -1) {
+                gi_plane[max_index] += go_plane[i];
+              }
+            }
+            continue;
+          }
+          for (const auto oh : c10::irange(p.out_h)) {
+            for (const auto ow : c10::irange(p.out_w)) {
+              const int64_t o = oh * os[2] + ow * os[3];
+              const int64_t max_index = ix_plane[o];
+              if (max_index != -1) {
+                const int64_t ih = max_index / p.in_w;
+                const int64_t iw = max_index % p.in_w;
+                gi_plane[ih * is[2] + iw * is[3]] += go_plane[o];
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_max_pool2d_with_indices_backward_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& grad_output,
+    const Tensor& input,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    const Tensor& indices,
+    Tensor& grad_input) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_max_pool2d_backward_args(
+          grad_output,
+          input,
+          kernel_size,
+          stride,
+          padding,
+          dilation,
+          ceil_mode,
+          indices,
+          grad_input),
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(grad_input, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_strides(grad_output, indices),
+      InvalidArgument,
+      grad_input);
+
+  if (grad_input.numel() == 0) {
+    return grad_input;
+  }
+
+  const auto params = internal::make_pool2d_params(
+      grad_input, grad_output, kernel_size, stride, padding, dilation);
+
+  constexpr auto name = "max_pool2d_with_indices_backward.grad_input";
+
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    const bool success =
+        max_pool2d_backward<CTYPE>(params, grad_output, indices, grad_input);
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+
+  return grad_input;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
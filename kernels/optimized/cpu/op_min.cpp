@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/arg_reduce_utils.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+template <typename CTYPE>
+constexpr CTYPE upper_bound() {
+  using lim = std::numeric_limits<CTYPE>;
+  return lim::has_infinity ? lim::infinity() : lim::max();
+}
+
+} // namespace
+
+using ScalarType = executorch::aten::ScalarType;
+using Tensor = executorch::aten::Tensor;
+
+std::tuple<Tensor&, Tensor&> opt_min_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool keepdim,
+    Tensor& min,
+    Tensor& min_indices) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_min_max_args(in, dim, keepdim, min, min_indices),
+      InvalidArgument,
+      (std::tuple<Tensor&, Tensor&>({min, min_indices})));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim, keepdim, min) == Error::Ok,
+      InvalidArgument,
+      (std::tuple<Tensor&, Tensor&>({min, min_indices})));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(min_indices, min.sizes()) == Error::Ok,
+      InvalidArgument,
+      (std::tuple<Tensor&, Tensor&>({min, min_indices})));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(in, min),
+      InvalidArgument,
+      (std::tuple<Tensor&, Tensor&>({min, min_indices})));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensor_is_default_dim_order(min_indices),
+      InvalidArgument,
+      (std::tuple<Tensor&, Tensor&>({min, min_indices})));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensor_is_default_dim_order(in),
+      InvalidArgument,
+      (std::tuple<Tensor&, Tensor&>({min, min_indices})));
+
+  dim = dim < 0 ? dim + in.dim() : dim;
+
+  ET_SWITCH_REAL_TYPES_AND(
+      Bool, in.scalar_type(), ctx, "min.dim_min", CTYPE, [&]() {
+        const bool success = internal::arg_reduce</*kMax=*/false, CTYPE>(
+            ctx,
+            in,
+            dim,
+            min,
+            min.mutable_data_ptr<CTYPE>(),
+            min_indices.mutable_data_ptr<int64_t>());
+        // Failures to allocate have already been reported.
+        ET_KERNEL_CHECK_MSG(
+            ctx,
+            success || ctx.failure_state() != Error::Ok,
+            Internal,
+            ,
+            "parallel_for failed");
+      });
+
+  return {min, min_indices};
+}
+
+Tensor&
+opt_min_unary_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, {}) == Error::Ok, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ScalarType in_type = in.scalar_type();
+  ScalarType out_type = out.scalar_type();
+
+  ET_KERNEL_CHECK(ctx, canCast(in_type, out_type), InvalidArgument, out);
+
+  constexpr auto name = "min.unary_out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in_type, ctx, name, CTYPE_IN, [&] {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, name, CTYPE_OUT, [&] {
+      auto data_out = out.mutable_data_ptr<CTYPE_OUT>();
+      if constexpr (std::is_same_v<CTYPE_IN, CTYPE_OUT>) {
+        // The order of the elements doesn't matter for the value, so any
+        // dim order is reduced as a flat buffer.
+        if (in.numel() > 0) {
+          int64_t index = 0;
+          const bool success = internal::parallel_arg_reduce</*kMax=*/false>(
+              ctx, in, {}, data_out, &index);
+          // Failures to allocate have already been reported.
+          ET_KERNEL_CHECK_MSG(
+              ctx,
+              success || ctx.failure_state() != Error::Ok,
+              Internal,
+              ,
+              "parallel_for failed");
+          return;
+        }
+      }
+      const auto data_in = in.const_data_ptr<CTYPE_IN>();
+      data_out[0] = upper_bound<CTYPE_OUT>();
+      for (const auto i : c10::irange(in.numel())) {
+        CTYPE_OUT val = static_cast<CTYPE_OUT>(data_in[i]);
+        if (std::isnan(val)) {
+          data_out[0] = val;
+          break;
+        }
+        if (val < data_out[0]) {
+          data_out[0] = val;
+        }
+      }
+    });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
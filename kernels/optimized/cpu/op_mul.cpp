@@ -80,6 +80,7 @@ Tensor& opt_mul_out(
   ScalarType a_type = a.scalar_type();
   ScalarType b_type = b.scalar_type();
   ScalarType out_type = out.scalar_type();
+  static constexpr const char op_name[] = "mul.out";
 
   if (b.numel() == 1) {
     if (a_type == b_type && a_type == out_type && a_type != ScalarType::Half &&
@@ -104,6 +105,19 @@ Tensor& opt_mul_out(
         });
       });
       return out;
+    } else if (
+        a_type == b_type && a_type == out_type &&
+        (a_type == ScalarType::Half || a_type == ScalarType::BFloat16)) {
+      ET_KERNEL_CHECK(
+          ctx,
+          resize_to_broadcast_target_size(a, b, out) == Error::Ok,
+          InvalidArgument,
+          out);
+
+      using Vec = executorch::vec::Vectorized<float>;
+      binary_op_via_float<op_name>(
+          ctx, a, b, out, [](Vec x, Vec y) { return x * y; });
+      return out;
     }
   } else if (a.numel() == 1) {
     return opt_mul_out(ctx, b, a, out);
@@ -135,6 +149,18 @@ Tensor& opt_mul_out(
       return torch::executor::handle_broadcast_elementwise<CTYPE>(
           ctx, mul_lambda, a, b, out, selected_optimized_path);
     });
+  } else if (can_treat_as_1d_via_float(a, b, out)) {
+    auto error = resize_tensor(out, a.sizes());
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        error == Error::Ok,
+        InvalidArgument,
+        out,
+        "Failed to resize output tensor.");
+
+    using Vec = executorch::vec::Vectorized<float>;
+    binary_op_via_float<op_name>(
+        ctx, a, b, out, [](Vec x, Vec y) { return x * y; });
   } else {
     ScalarType common_type =
         promoteTypes(a_type, b_type, /*half_to_float*/ true);
@@ -210,6 +236,20 @@ Tensor& opt_mul_scalar_out(
             out.numel());
       });
     });
+  } else if (
+      a_type == out_type &&
+      (a_type == ScalarType::Half || a_type == ScalarType::BFloat16)) {
+    ET_SWITCH_SCALAR_OBJ_TYPES(b_type, ctx, "mul.Scalar_out", CTYPE_B, [&]() {
+      CTYPE_B b_val;
+      ET_EXTRACT_SCALAR(b, b_val);
+
+      static constexpr const char op_name[] = "mul.Scalar_out";
+      using Vec = executorch::vec::Vectorized<float>;
+      binary_op_via_float<op_name>(
+          ctx, a, static_cast<float>(b_val), out, [](Vec x, Vec y) {
+            return x * y;
+          });
+    });
   } else {
     ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "mul.Scalar_out", CTYPE_A, [&]() {
       ET_SWITCH_SCALAR_OBJ_TYPES(b_type, ctx, "mul.Scalar_out", CTYPE_B, [&]() {
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+using internal::allocate_scratch;
+
+namespace {
+
+/**
+ * Applies batch norm with running statistics. The normalization and the
+ * affine transform of each channel are folded into a single scale and shift,
+ * computed once per channel in the accumulation type, so that each element
+ * only needs one multiply-add. The rows of `inner` elements of each (outer,
+ * channel) pair are processed in parallel. A channels last input instead has
+ * a row of C channels at each of its outer * inner positions, and applies
+ * the scales and shifts of the whole row at once.
+ *
+ * @returns false if parallel_for failed or the scales and shifts could not
+ *     be allocated, which is reported on `ctx`.
+ */
+template <typename CTYPE>
+bool batch_norm_no_training(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::optional<Tensor>& weight,
+    const executorch::aten::optional<Tensor>& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    double eps,
+    int64_t outer,
+    int64_t C,
+    int64_t inner,
+    bool channels_last,
+    Tensor& out) {
+  // Reduced precision types are folded and applied in float, since the
+  // shift is the difference of two nearby values for most channels.
+  using ACC =
+      std::conditional_t<std::is_same_v<CTYPE, double>, double, float>;
+
+  const int64_t num_rows = outer * C;
+  if (num_rows == 0 || inner == 0) {
+    return true;
+  }
+
+  const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
+  const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
+  const CTYPE* const weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* const bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+
+  ACC* const scale = allocate_scratch<ACC>(ctx, C);
+  ACC* const shift = allocate_scratch<ACC>(ctx, C);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      scale != nullptr && shift != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate batch norm scales");
+  for (const auto c : c10::irange(C)) {
+    const ACC invstd = ACC(1) /
+        std::sqrt(static_cast<ACC>(var_data[c]) + static_cast<ACC>(eps));
+    const ACC w =
+        weight_data == nullptr ? ACC(1) : static_cast<ACC>(weight_data[c]);
+    const ACC b =
+        bias_data == nullptr ? ACC(0) : static_cast<ACC>(bias_data[c]);
+    scale[c] = invstd * w;
+    shift[c] = b - static_cast<ACC>(mean_data[c]) * scale[c];
+  }
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  if (channels_last) {
+    return ::executorch::extension::parallel_for(
+        0,
+        outer * inner,
+        std::max<int64_t>(
+            1, ::executorch::extension::internal::GRAIN_SIZE / C),
+        [&](int64_t begin, int64_t end) {
+          for (const auto pos : c10::irange(begin, end)) {
+            const CTYPE* const x = in_data + pos * C;
+            CTYPE* const y = out_data + pos * C;
+            if constexpr (std::is_same_v<CTYPE, ACC>) {
+              using Vec = executorch::vec::Vectorized<CTYPE>;
+              executorch::vec::map3<CTYPE>(
+                  [](Vec v, Vec s, Vec t) { return v * s + t; },
+                  y,
+                  x,
+                  scale,
+                  shift,
+                  C);
+            } else {
+              for (const auto c : c10::irange(C)) {
+                y[c] = static_cast<CTYPE>(
+                    static_cast<ACC>(x[c]) * scale[c] + shift[c]);
+              }
+            }
+          }
+        });
+  }
+
+  const int64_t grain_size = std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / inner);
+  return ::executorch::extension::parallel_for(
+      0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t c = row % C;
+          const ACC s = scale[c];
+          const ACC t = shift[c];
+          const CTYPE* const x = in_data + row * inner;
+          CTYPE* const y = out_data + row * inner;
+          if constexpr (std::is_same_v<CTYPE, ACC>) {
+            using Vec = executorch::vec::Vectorized<CTYPE>;
+            executorch::vec::map<CTYPE>(
+                [s, t](Vec v) { return v * Vec(s) + Vec(t); }, y, x, inner);
+          } else {
+            for (const auto j : c10::irange(inner)) {
+              y[j] = static_cast<CTYPE>(static_cast<ACC>(x[j]) * s + t);
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&, Tensor&>
+opt__native_batch_norm_legit_no_training_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::optional<Tensor>& weight,
+    const executorch::aten::optional<Tensor>& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    double momentum,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& invstd_out) {
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, invstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(mean_out, {0}) == Error::Ok, InvalidArgument, ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(invstd_out, {0}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_batch_norm_args(
+          in,
+          weight,
+          bias,
+          running_mean,
+          running_var,
+          momentum,
+          eps,
+          out,
+          mean_out,
+          invstd_out),
+      InvalidArgument,
+      ret_val);
+
+  const size_t C_dim = in.dim() >= 1 ? 1 : 0;
+  const int64_t C = in.size(C_dim);
+  const int64_t outer = getLeadingDims(in, C_dim);
+  const int64_t inner = getTrailingDims(in, C_dim);
+
+  constexpr auto name = "native_batch_norm_legit_no_training.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&] {
+    const bool success = batch_norm_no_training<CTYPE>(
+        ctx,
+        in,
+        weight,
+        bias,
+        running_mean,
+        running_var,
+        eps,
+        outer,
+        C,
+        inner,
+        is_channels_last_dim_order(
+            in.dim_order().data(), in.dim_order().size()),
+        out);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
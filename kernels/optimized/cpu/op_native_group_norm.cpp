@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <executorch/kernels/optimized/cpu/moments_utils.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+/**
+ * Normalizes each (n, group) slice of the input in parallel. The moments of a
+ * slice come from one Welford pass over it, and the normalization and the
+ * affine transform of each channel are folded into a single scale and shift,
+ * applied in one vectorized pass.
+ */
+template <typename CTYPE>
+bool group_norm(
+    const Tensor& input,
+    const optional<Tensor>& weight,
+    const optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    CTYPE eps,
+    Tensor& out,
+    Tensor& mean,
+    Tensor& rstd) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const int64_t leading = N * group;
+  const int64_t D = C / group;
+  const int64_t inner_size = D * HxW;
+
+  if (leading == 0) {
+    return true;
+  }
+
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  CTYPE* const mean_data = mean.mutable_data_ptr<CTYPE>();
+  CTYPE* const rstd_data = rstd.mutable_data_ptr<CTYPE>();
+
+  if (inner_size == 0) {
+    for (const auto i : c10::irange(leading)) {
+      mean_data[i] = static_cast<CTYPE>(0);
+      rstd_data[i] = static_cast<CTYPE>(NAN);
+    }
+    return true;
+  }
+
+  const CTYPE* const input_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* const weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* const bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+
+  const int64_t grain_size = std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / inner_size);
+  return ::executorch::extension::parallel_for(
+      0, leading, grain_size, [&](int64_t begin, int64_t end) {
+        for (const auto i : c10::irange(begin, end)) {
+          const CTYPE* const x = input_data + i * inner_size;
+          CTYPE* const y = out_data + i * inner_size;
+
+          CTYPE mean_val;
+          CTYPE rstd_val;
+          std::tie(mean_val, rstd_val) = RowwiseMoments(x, inner_size);
+          rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
+
+          const int64_t g = i % group;
+          for (const auto j : c10::irange(D)) {
+            const int64_t ch = g * D + j;
+            const CTYPE w = weight_data == nullptr ? CTYPE(1) : weight_data[ch];
+            const CTYPE b = bias_data == nullptr ? CTYPE(0) : bias_data[ch];
+            const CTYPE scale = rstd_val * w;
+            const CTYPE shift = -scale * mean_val + b;
+            executorch::vec::map<CTYPE>(
+                [scale, shift](Vec v) { return v * Vec(scale) + Vec(shift); },
+                y + j * HxW,
+                x + j * HxW,
+                HxW);
+          }
+
+          mean_data[i] = mean_val;
+          rstd_data[i] = rstd_val;
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_group_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const executorch::aten::optional<Tensor>& weight,
+    const executorch::aten::optional<Tensor>& bias,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& rstd_out) {
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(out, mean_out, rstd_out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_group_norm_args(
+          input, weight, bias, N, C, HxW, group, out, mean_out, rstd_out),
+      InvalidArgument,
+      ret_val);
+
+  Tensor::SizesType mean_rstd_sizes[kTensorDimensionLimit];
+  mean_rstd_sizes[0] = N;
+  mean_rstd_sizes[1] = group;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(mean_out, {mean_rstd_sizes, 2}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(rstd_out, {mean_rstd_sizes, 2}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_default_dim_order(input), InvalidArgument, ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(input, out, mean_out, rstd_out),
+      InvalidArgument,
+      ret_val);
+
+  if (weight.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(input, weight.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  if (bias.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        tensors_have_same_dim_order(input, bias.value()),
+        InvalidArgument,
+        ret_val);
+  }
+
+  constexpr auto name = "native_group_norm.out";
+
+  ET_SWITCH_FLOAT_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    const bool success = group_norm<CTYPE>(
+        input, weight, bias, N, C, HxW, group, eps, out, mean_out, rstd_out);
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/mask_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using SizesType = executorch::aten::SizesType;
+
+namespace {
+
+/**
+ * Writes the indices of the non zero elements of `in` to `out`, counting
+ * and then writing blocks of elements in parallel.
+ */
+template <typename CTYPE>
+void nonzero(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  const int64_t ndim = in.dim();
+  const auto sizes = in.sizes();
+
+  internal::BlockOffsets offsets(ctx, in.numel());
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      offsets.ok(),
+      MemoryAllocationFailed,
+      ,
+      "Failed to allocate block offsets");
+  bool success = offsets.count([&](int64_t begin, int64_t end) {
+    int64_t count = 0;
+    for (const auto i : c10::irange(begin, end)) {
+      count += in_data[i] != static_cast<CTYPE>(0);
+    }
+    return count;
+  });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+
+  SizesType out_shape[2] = {
+      static_cast<SizesType>(offsets.total()), static_cast<SizesType>(ndim)};
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, ArrayRef<SizesType>(out_shape, 2)) == Error::Ok,
+      InvalidArgument, );
+
+  int64_t* const out_data = out.mutable_data_ptr<int64_t>();
+  success = offsets.write([&](int64_t begin, int64_t end, int64_t offset) {
+    // The index of `begin`, which is then incremented along with it.
+    int64_t index[kTensorDimensionLimit];
+    int64_t remainder = begin;
+    for (int64_t j = ndim - 1; j >= 0; --j) {
+      index[j] = remainder % sizes[j];
+      remainder /= sizes[j];
+    }
+    int64_t* row = out_data + offset * ndim;
+    for (const auto i : c10::irange(begin, end)) {
+      if (in_data[i] != static_cast<CTYPE>(0)) {
+        std::copy(index, index + ndim, row);
+        row += ndim;
+      }
+      for (int64_t j = ndim - 1; j >= 0; --j) {
+        if (++index[j] < sizes[j]) {
+          break;
+        }
+        index[j] = 0;
+      }
+    }
+  });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+}
+
+} // namespace
+
+/**
+ * Determines the non zero indices of input.
+ * Out is a 2-D tensor where every row is a non zero index of the input.
+ */
+Tensor&
+opt_nonzero_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  ET_KERNEL_CHECK(ctx, check_nonzero_args(in, out), InvalidArgument, out);
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, "nonzero.out", CTYPE, [&] {
+    nonzero<CTYPE>(ctx, in, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/distance_utils.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/portable/cpu/util/distance_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+using internal::allocate_scratch;
+using internal::num_scratch_slots;
+using internal::parallel_for_slots;
+
+/// The index in out of the distance between row `i` and row `i + 1`.
+inline int64_t pair_offset(int64_t i, int64_t n) {
+  return i * n - i * (i + 1) / 2;
+}
+
+/// The number of blocks of kDistanceRowBlock rows in `n` rows.
+inline int64_t num_row_blocks(int64_t n) {
+  return (n + internal::kDistanceRowBlock - 1) / internal::kDistanceRowBlock;
+}
+
+/**
+ * Calls `fn(i_begin, i_end)` for block `task` from the front and block `task`
+ * from the back. Row `i` is compared with the `n - i - 1` rows after it, so
+ * every pair of blocks has about the same work.
+ */
+template <typename Fn>
+void run_block_pair(int64_t task, int64_t n, const Fn& fn) {
+  const int64_t num_blocks = num_row_blocks(n);
+  const auto run_block = [&](int64_t block) {
+    const int64_t i_begin = block * internal::kDistanceRowBlock;
+    fn(i_begin, std::min(i_begin + internal::kDistanceRowBlock, n));
+  };
+  run_block(task);
+  if (num_blocks - 1 - task != task) {
+    run_block(num_blocks - 1 - task);
+  }
+}
+
+/**
+ * Calls `fn(i_begin, i_end)` in parallel for every block of
+ * kDistanceRowBlock rows, a pair of blocks per task; see run_block_pair().
+ *
+ * @returns false if parallel_for failed.
+ */
+template <typename Fn>
+[[nodiscard]] bool for_each_row_block(int64_t n, int64_t m, const Fn& fn) {
+  const int64_t pair_work =
+      std::max<int64_t>(1, internal::kDistanceRowBlock * n * m);
+  return ::executorch::extension::parallel_for(
+      0,
+      (num_row_blocks(n) + 1) / 2,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / pair_work),
+      [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          run_block_pair(task, n, fn);
+        }
+      });
+}
+
+template <typename CTYPE, typename Norm>
+[[nodiscard]] bool pdist_tiled(const Tensor& in, Tensor& out, double p) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t n = in.size(0);
+  const int64_t m = in.size(1);
+
+  return for_each_row_block(n, m, [&](int64_t i_begin, int64_t i_end) {
+    internal::distance_tiles<CTYPE, Norm>(
+        in_data,
+        i_begin,
+        i_end,
+        in_data,
+        i_begin + 1,
+        n,
+        m,
+        static_cast<CTYPE>(p),
+        /*upper=*/true,
+        [&](int64_t i, int64_t j, CTYPE d) {
+          out_data[pair_offset(i, n) + j - i - 1] = d;
+        });
+  });
+}
+
+/**
+ * Euclidean distances from the GEMM of every row block with the rows after
+ * its first row, and the squared norms of all rows. The norms and the
+ * products are kept in temp memory from `ctx`.
+ *
+ * @returns false if a parallel_for or an allocation failed; allocation
+ *     failures are also reported to `ctx`.
+ */
+template <typename CTYPE>
+[[nodiscard]] bool
+pdist_mm(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t n = in.size(0);
+  const int64_t m = in.size(1);
+
+  // The products of a block with the rows after its first row, for every
+  // slot.
+  const int64_t num_tasks = (num_row_blocks(n) + 1) / 2;
+  const int64_t gram_size = internal::kDistanceRowBlock * (n - 1);
+  CTYPE* const norms = allocate_scratch<CTYPE>(ctx, n);
+  CTYPE* const grams =
+      allocate_scratch<CTYPE>(ctx, num_scratch_slots(num_tasks) * gram_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      norms != nullptr && grams != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate pdist buffers");
+
+  bool success = ::executorch::extension::parallel_for(
+      0,
+      n,
+      std::max<int64_t>(1, ::executorch::extension::internal::GRAIN_SIZE / m),
+      [&](const auto begin, const auto end) {
+        internal::squared_norms(
+            in_data + begin * m, end - begin, m, norms + begin);
+      });
+  if (!success) {
+    return false;
+  }
+
+  return parallel_for_slots(
+      num_tasks, [&](int64_t slot, int64_t begin, int64_t end) {
+        CTYPE* const gram = grams + slot * gram_size;
+        for (const auto task : c10::irange(begin, end)) {
+          run_block_pair(task, n, [&](int64_t i_begin, int64_t i_end) {
+            const int64_t cols = n - i_begin - 1;
+            if (cols == 0) {
+              return;
+            }
+            internal::minus_two_gram(
+                in_data + i_begin * m,
+                i_end - i_begin,
+                in_data + (i_begin + 1) * m,
+                cols,
+                m,
+                gram,
+                cols);
+            for (const auto i : c10::irange(i_begin, i_end)) {
+              const CTYPE* const gram_row = gram + (i - i_begin) * cols;
+              CTYPE* const out_row = out_data + pair_offset(i, n);
+              for (const auto j : c10::irange(i + 1, n)) {
+                out_row[j - i - 1] = internal::euclidean_from_gram(
+                    gram_row[j - i_begin - 1], norms[i], norms[j]);
+              }
+            }
+          });
+        }
+      });
+}
+
+template <typename CTYPE>
+[[nodiscard]] bool
+pdist(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out, double p) {
+  if (out.numel() == 0) {
+    return true;
+  }
+
+  if constexpr (internal::kIsVectorizedDistanceType<CTYPE>) {
+    if (p == 2.0 && in.size(0) > internal::kDistanceMmThreshold &&
+        in.size(1) > 0) {
+      return pdist_mm<CTYPE>(ctx, in, out);
+    }
+  }
+
+  if (p == 0.0) {
+    return pdist_tiled<CTYPE, L0<CTYPE>>(in, out, p);
+  } else if (p == 1.0) {
+    return pdist_tiled<CTYPE, L1<CTYPE>>(in, out, p);
+  } else if (p == 2.0) {
+    return pdist_tiled<CTYPE, L2<CTYPE>>(in, out, p);
+  } else if (p == INFINITY) {
+    return pdist_tiled<CTYPE, Linf<CTYPE>>(in, out, p);
+  } else {
+    return pdist_tiled<CTYPE, Lp<CTYPE>>(in, out, p);
+  }
+}
+
+} // namespace
+
+Tensor& opt_pdist_forward_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    double p,
+    Tensor& out) {
+  ET_KERNEL_CHECK(ctx, check_pdist_args(in, p, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  Tensor::SizesType target_sizes[kTensorDimensionLimit];
+  size_t target_ndim = 0;
+  get_pdist_out_target_size(in, target_sizes, &target_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {target_sizes, target_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ScalarType in_type = in.scalar_type();
+  constexpr auto name = "_pdist_forward.out";
+
+  ET_SWITCH_FLOATHBF16_TYPES(in_type, ctx, name, CTYPE, [&] {
+    const bool success = pdist<CTYPE>(ctx, in, out, p);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/scatter_utils.h>
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+template <typename CTYPE, typename Fn>
+bool scatter_helper(
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor* src,
+    Tensor& out,
+    const Fn& fn) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  if (out_data != in_data) {
+    memcpy(out_data, in_data, in.nbytes());
+  }
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  return internal::parallel_scatter(
+      index, src, out, dim, [&](int64_t out_ix, int64_t src_ix) {
+        out_data[out_ix] = fn(src_ix);
+      });
+}
+
+} // namespace
+
+Tensor& opt_scatter_src_out(
+    KernelRuntimeContext& context,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      context,
+      check_scatter_src_args(in, dim, index, src, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "scatter.src_out";
+
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    const CTYPE* src_data = src.const_data_ptr<CTYPE>();
+    const bool success = scatter_helper<CTYPE>(
+        in, dim, index, &src, out, [&](int64_t src_ix) {
+          return src_data[src_ix];
+        });
+    ET_KERNEL_CHECK_MSG(context, success, Internal, , "parallel_for failed");
+  });
+
+  return out;
+}
+
+Tensor& opt_scatter_value_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    const Scalar& value,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_scatter_value_args(in, dim, index, value, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ScalarType val_type = utils::get_scalar_dtype(value);
+
+  constexpr auto name = "scatter.value_out";
+
+  ET_SWITCH_SCALAR_OBJ_TYPES(val_type, ctx, name, CTYPE_VAL, [&] {
+    CTYPE_VAL val;
+    ET_KERNEL_CHECK(ctx, utils::extract_scalar(value, &val), InvalidArgument, );
+
+    ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+      const CTYPE casted = static_cast<CTYPE>(val);
+      const bool success = scatter_helper<CTYPE>(
+          in, dim, index, nullptr, out, [&](int64_t) { return casted; });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+    });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
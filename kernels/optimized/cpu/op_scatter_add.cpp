@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/scatter_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+Tensor& opt_scatter_add_out(
+    KernelRuntimeContext& context,
+    const Tensor& self,
+    int64_t dim,
+    const Tensor& index,
+    const Tensor& src,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      context,
+      check_scatter_add_args(self, dim, index, src, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context,
+      tensors_have_same_dim_order(self, src, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context, tensor_is_default_dim_order(index), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(self);
+  }
+
+  ET_KERNEL_CHECK(
+      context,
+      resize_tensor(out, self.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ScalarType self_type = self.scalar_type();
+
+  ET_SWITCH_REAL_TYPES_AND(
+      Bool, self_type, ctx, "scatter_add.out", CTYPE, [&]() {
+        const CTYPE* self_data = self.const_data_ptr<CTYPE>();
+        const CTYPE* src_data = src.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+        if (out_data != self_data) {
+          memcpy(out_data, self_data, self.nbytes());
+        }
+
+        if (index.numel() != 0) {
+          if (self.dim() == 0) {
+            out_data[0] += nonempty_size(index, 0) * src_data[0];
+          } else {
+            // Every task accumulates into its own elements of out, so no
+            // atomics are needed.
+            const bool success = internal::parallel_scatter(
+                index, &src, out, dim, [&](int64_t out_ix, int64_t src_ix) {
+                  out_data[out_ix] += src_data[src_ix];
+                });
+            ET_KERNEL_CHECK_MSG(
+                context, success, Internal, , "parallel_for failed");
+          }
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
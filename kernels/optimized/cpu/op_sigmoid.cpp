@@ -8,14 +8,15 @@
 
 #include <cmath>
 
-#include <executorch/kernels/optimized/vec/functional.h>
-#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/multiversion/unary_kernels.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
 namespace executor {
 namespace native {
 
+ET_DEFINE_DISPATCH(sigmoid_stub);
+
 namespace {
 
 template <typename T>
@@ -33,15 +34,7 @@ void sigmoid_data(
     const CTYPE_IN* in_data,
     const size_t numel,
     CTYPE_OUT* out_data) {
-  using Vec = executorch::vec::Vectorized<CTYPE_IN>;
-  executorch::vec::map<CTYPE_IN>(
-      [](Vec x) {
-        auto one_plus_exp = x.neg().exp() + Vec(static_cast<CTYPE_IN>(1.0));
-        return one_plus_exp.reciprocal();
-      },
-      out_data,
-      in_data,
-      numel);
+  sigmoid_stub(CppTypeToScalarType<CTYPE_IN>::value, in_data, out_data, numel);
 }
 
 template <
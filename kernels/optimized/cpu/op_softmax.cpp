@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `_softmax_out` Applies the Softmax function to an n-dimensional input
+// Tensor rescaling them so that the elements of the n-dimensional output
+// Tensor lie in the range [0,1] and sum to 1.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+namespace {
+
+using executorch::extension::parallel_for;
+using executorch::extension::internal::GRAIN_SIZE;
+
+// A long row is split into at most this many chunks for the exp pass.
+constexpr int64_t kMaxRowChunks = 64;
+
+// out = exp(in - max); returns sum(out). Like
+// _exp_reduce_sum_fusion_kernel in extension/llm/custom_ops/op_sdpa.cpp.
+template <typename CTYPE>
+CTYPE exp_reduce_sum_fusion(
+    const CTYPE* in,
+    int64_t size,
+    CTYPE max,
+    CTYPE* out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const Vec max_vec(max);
+  Vec sum_vec(CTYPE(0));
+  int64_t i = 0;
+  for (; i + static_cast<int64_t>(Vec::size()) <= size; i += Vec::size()) {
+    const Vec e = (Vec::loadu(in + i) - max_vec).exp();
+    sum_vec = sum_vec + e;
+    e.store(out + i);
+  }
+  CTYPE sum = executorch::vec::vec_reduce_all<CTYPE>(
+      [](Vec& x, Vec& y) { return x + y; }, sum_vec);
+  for (; i < size; ++i) {
+    out[i] = std::exp(in[i] - max);
+    sum += out[i];
+  }
+  return sum;
+}
+
+// Softmax over one contiguous row, for float and double. Each element is
+// exponentiated once: the exp pass writes to out, which is then scaled by
+// the reciprocal of the sum. When called outside of a parallel region the
+// row itself is split between threads.
+template <typename CTYPE>
+[[nodiscard]] bool softmax_row(const CTYPE* in, CTYPE* out, int64_t size) {
+  CTYPE max_in;
+  if (!parallel_vectorized_reduce<CTYPE, CTYPE>(
+          MaxReducer<CTYPE>(), in, size, max_in)) {
+    return false;
+  }
+
+  const int64_t num_chunks =
+      std::clamp<int64_t>(size / GRAIN_SIZE, 1, kMaxRowChunks);
+  const int64_t chunk_size = executorch::utils::divup(size, num_chunks);
+  std::array<CTYPE, kMaxRowChunks> partials;
+  if (!parallel_for(0, num_chunks, 1, [&](const auto begin, const auto end) {
+        for (const auto chunk : c10::irange(begin, end)) {
+          const int64_t start = chunk * chunk_size;
+          const int64_t len = std::min(chunk_size, size - start);
+          partials[chunk] = len > 0
+              ? exp_reduce_sum_fusion(in + start, len, max_in, out + start)
+              : CTYPE(0);
+        }
+      })) {
+    return false;
+  }
+  CTYPE sum = 0;
+  for (const auto chunk : c10::irange(num_chunks)) {
+    sum += partials[chunk];
+  }
+
+  const CTYPE inv_sum = CTYPE(1) / sum;
+  return parallel_for(
+      0, size, GRAIN_SIZE, [&](const auto begin, const auto end) {
+        executorch::vec::map<CTYPE>(
+            [inv_sum](executorch::vec::Vectorized<CTYPE> x) {
+              return x * executorch::vec::Vectorized<CTYPE>(inv_sum);
+            },
+            out + begin,
+            out + begin,
+            end - begin);
+      });
+}
+
+// Softmax over the single column at in/out, whose elements are stride
+// apart, accumulating in CTYPE_ACC.
+template <typename CTYPE>
+void softmax_column(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t dim_size,
+    int64_t stride) {
+  using CTYPE_ACC = reduce_acc_type_t<CTYPE>;
+  CTYPE_ACC max_in = -std::numeric_limits<CTYPE_ACC>::infinity();
+  for (const auto d : c10::irange(dim_size)) {
+    const CTYPE_ACC v = static_cast<CTYPE_ACC>(in[d * stride]);
+    max_in = std::isnan(v) || v > max_in ? v : max_in;
+  }
+  CTYPE_ACC sum = 0;
+  for (const auto d : c10::irange(dim_size)) {
+    sum += std::exp(static_cast<CTYPE_ACC>(in[d * stride]) - max_in);
+  }
+  for (const auto d : c10::irange(dim_size)) {
+    out[d * stride] = static_cast<CTYPE>(
+        std::exp(static_cast<CTYPE_ACC>(in[d * stride]) - max_in) / sum);
+  }
+}
+
+// Like softmax_column(), but for a vector's worth of adjacent columns, one
+// per lane. Half and BFloat16 are converted to float as they are loaded,
+// and exponentiated again rather than staged in out at reduced precision.
+template <typename CTYPE>
+void softmax_columns_vec(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t dim_size,
+    int64_t stride) {
+  using CTYPE_ACC = reduce_acc_type_t<CTYPE>;
+  using Vec = executorch::vec::Vectorized<CTYPE_ACC>;
+  using internal::load_for_reduce;
+  Vec max_vec(-std::numeric_limits<CTYPE_ACC>::infinity());
+  for (const auto d : c10::irange(dim_size)) {
+    max_vec = executorch::vec::maximum(
+        max_vec, load_for_reduce<CTYPE_ACC>(in + d * stride));
+  }
+  Vec sum_vec(CTYPE_ACC(0));
+  for (const auto d : c10::irange(dim_size)) {
+    const Vec e = (load_for_reduce<CTYPE_ACC>(in + d * stride) - max_vec).exp();
+    sum_vec = sum_vec + e;
+    if constexpr (std::is_same_v<CTYPE, CTYPE_ACC>) {
+      e.store(out + d * stride);
+    }
+  }
+  const Vec inv_sum = Vec(CTYPE_ACC(1)) / sum_vec;
+  for (const auto d : c10::irange(dim_size)) {
+    CTYPE* const row_out = out + d * stride;
+    if constexpr (std::is_same_v<CTYPE, CTYPE_ACC>) {
+      (Vec::loadu(row_out) * inv_sum).store(row_out);
+    } else {
+      const Vec y =
+          (load_for_reduce<CTYPE_ACC>(in + d * stride) - max_vec).exp() *
+          inv_sum;
+      CTYPE_ACC lanes[Vec::size()];
+      y.store(lanes);
+      for (const auto lane : c10::irange(Vec::size())) {
+        row_out[lane] = static_cast<CTYPE>(lanes[lane]);
+      }
+    }
+  }
+}
+
+// Softmax over the middle dim of a contiguous
+// [outer_size, dim_size, inner_size] tensor. Work is split between threads
+// by blocks of a vector's worth of columns.
+template <typename CTYPE>
+[[nodiscard]] bool softmax_over_middle_dim(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  constexpr int64_t kVecSize =
+      executorch::vec::Vectorized<reduce_acc_type_t<CTYPE>>::size();
+  const int64_t num_blocks = executorch::utils::divup(inner_size, kVecSize);
+  return parallel_for(
+      0,
+      outer_size * num_blocks,
+      std::max<int64_t>(1, GRAIN_SIZE / (dim_size * kVecSize)),
+      [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t outer = task / num_blocks;
+          const int64_t column = task % num_blocks * kVecSize;
+          const int64_t offset = outer * dim_size * inner_size + column;
+          if (column + kVecSize <= inner_size) {
+            softmax_columns_vec(
+                in_data + offset, out_data + offset, dim_size, inner_size);
+            continue;
+          }
+          for (const auto j : c10::irange(inner_size - column)) {
+            softmax_column(
+                in_data + offset + j,
+                out_data + offset + j,
+                dim_size,
+                inner_size);
+          }
+        }
+      });
+}
+
+// Softmax over each of the num_rows contiguous rows of row_size elements.
+template <typename CTYPE>
+[[nodiscard]] bool softmax_over_last_dim(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t num_rows,
+    int64_t row_size) {
+  if constexpr (std::is_same_v<CTYPE, reduce_acc_type_t<CTYPE>>) {
+    return parallel_for_each_reduce_row(
+        num_rows, row_size, [&](const int64_t row) {
+          const int64_t offset = row * row_size;
+          return softmax_row(in_data + offset, out_data + offset, row_size);
+        });
+  } else {
+    // Half and BFloat16 can't stage exp() in out without losing precision.
+    return softmax_over_contiguous_rows<CTYPE, false>(
+        in_data, out_data, num_rows, row_size);
+  }
+}
+
+} // namespace
+
+// _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_softmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_softmax_args(in, dim, half_to_float, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  // Adjust for negative dim
+  dim = dim < 0 ? dim + nonzero_dim(in) : dim;
+
+  const auto shape = get_contiguous_reduce_shape(in, dim);
+  ET_SWITCH_FLOATHBF16_TYPES(
+      in.scalar_type(), ctx, "_softmax.out", CTYPE, [&]() {
+        const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+        bool success = true;
+        if (!shape.has_value()) {
+          // Not contiguous, e.g. channels last: one column at a time.
+          apply_over_dim(
+              [in_data, out_data](
+                  const size_t size, const size_t stride, const size_t base) {
+                softmax_column(
+                    in_data + base, out_data + base, size, stride);
+              },
+              in,
+              dim);
+        } else if (shape->inner_size != 1) {
+          success = softmax_over_middle_dim(
+              in_data,
+              out_data,
+              shape->outer_size,
+              shape->reduce_size,
+              shape->inner_size);
+        } else {
+          success = softmax_over_last_dim(
+              in_data, out_data, shape->outer_size, shape->reduce_size);
+        }
+        ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+using internal::allocate_scratch;
+using internal::num_scratch_slots;
+using internal::parallel_for_slots;
+
+namespace {
+
+template <typename T>
+bool is_nan(T x) {
+  if constexpr (std::is_integral_v<T>) {
+    return false;
+  } else {
+    return std::isnan(static_cast<float>(x));
+  }
+}
+
+// Like the portable kernel, NaN compares greater than any other value.
+template <typename T>
+bool nan_greatest_less_than(T x, T y) {
+  return (!is_nan(x) && is_nan(y)) || x < y;
+}
+
+/**
+ * Orders the elements of a row from the first to the last of the top k:
+ * largest (or smallest) value first, and the lowest index among equal
+ * values, so that the result does not depend on how the row is traversed.
+ */
+template <typename CTYPE>
+struct TopkBefore {
+  bool largest;
+
+  bool operator()(
+      const std::pair<CTYPE, int64_t>& x,
+      const std::pair<CTYPE, int64_t>& y) const {
+    const bool x_first = largest
+        ? nan_greatest_less_than(y.first, x.first)
+        : nan_greatest_less_than(x.first, y.first);
+    if (x_first) {
+      return true;
+    }
+    const bool y_first = largest
+        ? nan_greatest_less_than(x.first, y.first)
+        : nan_greatest_less_than(y.first, x.first);
+    return !y_first && x.second < y.second;
+  }
+};
+
+/**
+ * Whether no element of `data[0:Vec::size()]` can replace an element of the
+ * top k whose last value is `threshold`. Elements are visited in increasing
+ * index order, so an element equal to the threshold never does.
+ */
+template <typename Vec>
+bool none_can_enter(const float* data, float threshold, bool largest) {
+  const Vec vals = Vec::loadu(data);
+  const Vec enter = largest ? (vals > Vec(threshold)) | vals.isnan()
+                            : vals < Vec(threshold);
+  constexpr int kAllZero = (1 << Vec::size()) - 1;
+  return enter.zero_mask() == kAllZero;
+}
+
+/**
+ * The top k of a row of `size` elements `stride` apart, for small k: a
+ * bounded heap whose front is the last of the k best elements so far, so
+ * that most elements only need one comparison against it.
+ */
+template <typename CTYPE>
+void topk_heap(
+    const CTYPE* row,
+    int64_t size,
+    int64_t stride,
+    int64_t k,
+    bool largest,
+    std::pair<CTYPE, int64_t>* heap) {
+  const TopkBefore<CTYPE> before{largest};
+  for (const auto i : c10::irange(k)) {
+    heap[i] = {row[i * stride], i};
+  }
+  std::make_heap(heap, heap + k, before);
+
+  const auto push = [&](int64_t i) {
+    const std::pair<CTYPE, int64_t> elem{row[i * stride], i};
+    if (before(elem, heap[0])) {
+      std::pop_heap(heap, heap + k, before);
+      heap[k - 1] = elem;
+      std::push_heap(heap, heap + k, before);
+    }
+  };
+
+  int64_t i = k;
+  if constexpr (std::is_same_v<CTYPE, float>) {
+    // Skip whole vectors of contiguous elements that can't enter the top k.
+    // All non-NaN values come before a NaN threshold when looking for the
+    // smallest, so there is nothing to skip then.
+    using Vec = executorch::vec::Vectorized<float>;
+    if (stride == 1) {
+      for (; i + Vec::size() <= size; i += Vec::size()) {
+        const float threshold = heap[0].first;
+        if ((largest || !std::isnan(threshold)) &&
+            none_can_enter<Vec>(row + i, threshold, largest)) {
+          continue;
+        }
+        for (const auto j : c10::irange(Vec::size())) {
+          push(i + j);
+        }
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    push(i);
+  }
+
+  std::sort_heap(heap, heap + k, before);
+}
+
+/**
+ * The top k of a row for larger k: a selection over a copy of the whole row,
+ * then a sort of the selected elements.
+ */
+template <typename CTYPE>
+void topk_select(
+    const CTYPE* row,
+    int64_t size,
+    int64_t stride,
+    int64_t k,
+    bool largest,
+    bool sorted,
+    std::pair<CTYPE, int64_t>* queue) {
+  const TopkBefore<CTYPE> before{largest};
+  for (const auto i : c10::irange(size)) {
+    queue[i] = {row[i * stride], i};
+  }
+  std::nth_element(queue, queue + k - 1, queue + size, before);
+  if (sorted) {
+    std::sort(queue, queue + k - 1, before);
+  }
+}
+
+/**
+ * @returns false if parallel_for failed or the work queues could not be
+ *     allocated, which is reported on `ctx`.
+ */
+template <typename CTYPE>
+bool topk(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted,
+    Tensor& values,
+    Tensor& indices) {
+  using elem_t = std::pair<CTYPE, int64_t>;
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const values_data = values.mutable_data_ptr<CTYPE>();
+  int64_t* const indices_data = indices.mutable_data_ptr<int64_t>();
+
+  const int64_t dim_size = in.size(dim);
+  const int64_t dim_stride = in.strides()[dim];
+  const int64_t num_rows = getLeadingDims(in, dim) * dim_stride;
+  // Same cutoff as the portable kernel between its partial sort and its
+  // selection.
+  const bool use_heap = k * 64 <= dim_size;
+  const int64_t buffer_size = use_heap ? k : dim_size;
+  elem_t* const buffers =
+      allocate_scratch<elem_t>(ctx, num_scratch_slots(num_rows) * buffer_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      buffers != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate topk work queues");
+
+  return parallel_for_slots(
+      num_rows, [&](int64_t slot, int64_t begin, int64_t end) {
+        elem_t* const buffer = buffers + slot * buffer_size;
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t outer = row / dim_stride;
+          const int64_t inner = row % dim_stride;
+          const CTYPE* const row_in =
+              in_data + outer * dim_size * dim_stride + inner;
+          if (use_heap) {
+            topk_heap(row_in, dim_size, dim_stride, k, largest, buffer);
+          } else {
+            topk_select(
+                row_in,
+                dim_size,
+                dim_stride,
+                k,
+                largest,
+                sorted,
+                buffer);
+          }
+
+          const int64_t base_out = outer * k * dim_stride + inner;
+          for (const auto i : c10::irange(k)) {
+            values_data[base_out + i * dim_stride] = buffer[i].first;
+            indices_data[base_out + i * dim_stride] = buffer[i].second;
+          }
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> opt_topk_values(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted,
+    Tensor& values,
+    Tensor& indices) {
+  auto out = std::tuple<Tensor&, Tensor&>({values, indices});
+
+  ET_KERNEL_CHECK(
+      ctx, check_topk_args(in, k, dim, values, indices), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  Tensor::SizesType target_size[kTensorDimensionLimit];
+  size_t target_dim = 0;
+  get_topk_out_target_size(in, k, dim, target_size, &target_dim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(values, {target_size, target_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {target_size, target_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "topk.values";
+
+  if (in.numel() == 0 || (k == 0 && in.dim() > 0)) {
+    return out;
+  }
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    if (in.dim() == 0) {
+      values.mutable_data_ptr<CTYPE>()[0] = in.const_data_ptr<CTYPE>()[0];
+      indices.mutable_data_ptr<int64_t>()[0] = 0;
+      return;
+    }
+    const bool success =
+        topk<CTYPE>(ctx, in, k, dim, largest, sorted, values, indices);
+    // Failures to allocate have already been reported.
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        success || ctx.failure_state() != Error::Ok,
+        Internal,
+        ,
+        "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
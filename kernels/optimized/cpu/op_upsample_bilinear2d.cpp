@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+using internal::allocate_scratch;
+using internal::num_scratch_slots;
+using internal::parallel_for_slots;
+
+namespace {
+
+/**
+ * The two source indices of each output index of one dimension, as element
+ * offsets, and their weights, in temp memory. Computed once per call rather
+ * than once per output element.
+ */
+struct InterpolationTable {
+  int64_t* offset0 = nullptr;
+  int64_t* offset1 = nullptr;
+  float* lambda0 = nullptr;
+  float* lambda1 = nullptr;
+
+  /// Whether the table could be allocated.
+  bool ok() const {
+    return offset0 != nullptr && offset1 != nullptr && lambda0 != nullptr &&
+        lambda1 != nullptr;
+  }
+};
+
+InterpolationTable make_interpolation_table(
+    KernelRuntimeContext& ctx,
+    int64_t in_size,
+    int64_t out_size,
+    int64_t stride,
+    float scale,
+    bool align_corners) {
+  InterpolationTable table{
+      allocate_scratch<int64_t>(ctx, out_size),
+      allocate_scratch<int64_t>(ctx, out_size),
+      allocate_scratch<float>(ctx, out_size),
+      allocate_scratch<float>(ctx, out_size)};
+  if (!table.ok()) {
+    return table;
+  }
+  for (const auto i : c10::irange(out_size)) {
+    int64_t index0, index1;
+    compute_source_index_and_lambda(
+        index0,
+        index1,
+        table.lambda0[i],
+        table.lambda1[i],
+        scale,
+        i,
+        in_size,
+        out_size,
+        align_corners);
+    table.offset0[i] = index0 * stride;
+    table.offset1[i] = index1 * stride;
+  }
+  return table;
+}
+
+// Weights are float, so the portable kernel computes in float for every
+// dtype but double; so does this one.
+template <typename CTYPE>
+using acc_type_t =
+    std::conditional_t<std::is_same_v<CTYPE, double>, double, float>;
+
+/// The number of output rows of `row_size` elements per parallel_for task.
+int64_t rows_grain_size(int64_t row_size) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(row_size, 1));
+}
+
+/// Interpolates an input row at the output columns of `w`.
+template <typename CTYPE>
+void interpolate_row(
+    const CTYPE* src,
+    const InterpolationTable& w,
+    int64_t out_w,
+    acc_type_t<CTYPE>* dst) {
+  using ACC = acc_type_t<CTYPE>;
+  for (const auto i : c10::irange(out_w)) {
+    dst[i] = static_cast<ACC>(src[w.offset0[i]]) * w.lambda0[i] +
+        static_cast<ACC>(src[w.offset1[i]]) * w.lambda1[i];
+  }
+}
+
+/**
+ * NCHW: each output row blends two input rows, interpolated at the output
+ * columns. Consecutive output rows mostly share their input rows, so these
+ * are kept from one row to the next, and the blend is vectorized along the
+ * row.
+ *
+ * @returns false if parallel_for failed or the interpolated rows could not
+ *     be allocated, which is reported on `ctx`.
+ */
+template <typename CTYPE>
+bool upsample_bilinear2d_nchw(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const InterpolationTable& h,
+    const InterpolationTable& w,
+    Tensor& out) {
+  using ACC = acc_type_t<CTYPE>;
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t channels = out.size(1);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t in_batch_stride = in.strides()[0];
+  const int64_t in_channel_stride = in.strides()[1];
+  const int64_t num_rows = out.size(0) * channels * out_h;
+
+  ACC* const rows =
+      allocate_scratch<ACC>(ctx, num_scratch_slots(num_rows) * 2 * out_w);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      rows != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate interpolated rows");
+
+  return parallel_for_slots(
+      num_rows, [&](int64_t slot, int64_t begin, int64_t end) {
+        ACC* top = rows + slot * 2 * out_w;
+        ACC* bottom = top + out_w;
+        const CTYPE* top_src = nullptr;
+        const CTYPE* bottom_src = nullptr;
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t plane = row / out_h;
+          const int64_t oh = row % out_h;
+          const CTYPE* const in_plane = in_data +
+              (plane / channels) * in_batch_stride +
+              (plane % channels) * in_channel_stride;
+          const CTYPE* const src0 = in_plane + h.offset0[oh];
+          const CTYPE* const src1 = in_plane + h.offset1[oh];
+          // Moving down one input row turns the bottom row into the top one.
+          if (src0 == bottom_src) {
+            std::swap(top, bottom);
+            std::swap(top_src, bottom_src);
+          }
+          if (src0 != top_src) {
+            interpolate_row(src0, w, out_w, top);
+            top_src = src0;
+          }
+          if (src1 != bottom_src) {
+            interpolate_row(src1, w, out_w, bottom);
+            bottom_src = src1;
+          }
+
+          const ACC lambda0 = h.lambda0[oh];
+          const ACC lambda1 = h.lambda1[oh];
+          CTYPE* const out_row = out_data + row * out_w;
+          int64_t i = 0;
+          if constexpr (std::is_same_v<CTYPE, ACC>) {
+            using Vec = executorch::vec::Vectorized<ACC>;
+            for (; i + Vec::size() <= out_w; i += Vec::size()) {
+              const Vec val = Vec::loadu(top + i) * Vec(lambda0) +
+                  Vec::loadu(bottom + i) * Vec(lambda1);
+              val.store(out_row + i);
+            }
+          }
+          for (; i < out_w; ++i) {
+            out_row[i] =
+                static_cast<CTYPE>(top[i] * lambda0 + bottom[i] * lambda1);
+          }
+        }
+      });
+}
+
+/**
+ * NHWC: each output pixel blends the channels of four input pixels, which
+ * are contiguous, so the blend is vectorized along the channels.
+ */
+template <typename CTYPE>
+bool upsample_bilinear2d_nhwc(
+    const Tensor& in,
+    const InterpolationTable& h,
+    const InterpolationTable& w,
+    Tensor& out) {
+  using ACC = acc_type_t<CTYPE>;
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t channels = out.size(1);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t in_batch_stride = in.strides()[0];
+
+  return ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * out_h,
+      rows_grain_size(out_w * channels),
+      [&](int64_t begin, int64_t end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t oh = row % out_h;
+          const CTYPE* const in_n = in_data + (row / out_h) * in_batch_stride;
+          const CTYPE* const top = in_n + h.offset0[oh];
+          const CTYPE* const bottom = in_n + h.offset1[oh];
+          const ACC lambda0_h = h.lambda0[oh];
+          const ACC lambda1_h = h.lambda1[oh];
+          CTYPE* out_pixel = out_data + row * out_w * channels;
+          for (const auto ow : c10::irange(out_w)) {
+            const CTYPE* const top_left = top + w.offset0[ow];
+            const CTYPE* const top_right = top + w.offset1[ow];
+            const CTYPE* const bottom_left = bottom + w.offset0[ow];
+            const CTYPE* const bottom_right = bottom + w.offset1[ow];
+            const ACC lambda0_w = w.lambda0[ow];
+            const ACC lambda1_w = w.lambda1[ow];
+            int64_t c = 0;
+            if constexpr (std::is_same_v<CTYPE, ACC>) {
+              using Vec = executorch::vec::Vectorized<ACC>;
+              for (; c + Vec::size() <= channels; c += Vec::size()) {
+                const Vec top_val = Vec::loadu(top_left + c) * Vec(lambda0_w) +
+                    Vec::loadu(top_right + c) * Vec(lambda1_w);
+                const Vec bottom_val =
+                    Vec::loadu(bottom_left + c) * Vec(lambda0_w) +
+                    Vec::loadu(bottom_right + c) * Vec(lambda1_w);
+                const Vec val =
+                    top_val * Vec(lambda0_h) + bottom_val * Vec(lambda1_h);
+                val.store(out_pixel + c);
+              }
+            }
+            for (; c < channels; ++c) {
+              const ACC top_val = static_cast<ACC>(top_left[c]) * lambda0_w +
+                  static_cast<ACC>(top_right[c]) * lambda1_w;
+              const ACC bottom_val =
+                  static_cast<ACC>(bottom_left[c]) * lambda0_w +
+                  static_cast<ACC>(bottom_right[c]) * lambda1_w;
+              out_pixel[c] = static_cast<CTYPE>(
+                  top_val * lambda0_h + bottom_val * lambda1_h);
+            }
+            out_pixel += channels;
+          }
+        }
+      });
+}
+
+} // namespace
+
+// Signatures are auto-generated, so disable pass-by-value lint.
+// NOLINTBEGIN(facebook-hte-ConstantArgumentPassByValue,
+// facebook-hte-ParameterMightThrowOnCopy)
+Tensor& opt_upsample_bilinear2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::OptionalArrayRef<int64_t> output_size,
+    bool align_corners,
+    const executorch::aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  // Preconditions (checked in check_..._args):
+  //  In and out tensors have same dtype.
+  //  In and out tensors are rank 4 and have same dim[0] and dim[1].
+  //  In and out tensors are NHWC or NCHW dim order.
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_bilinear2d_args(
+          in, output_size, align_corners, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h, scale_w;
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim_order().size());
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      channels_last ||
+          is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      InvalidArgument,
+      out,
+      "Unsupported dim order");
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // Like the portable kernel, the source indices are computed with float
+  // scales.
+  const float kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], align_corners, scale_h);
+  const float kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], align_corners, scale_w);
+  const InterpolationTable h_table = make_interpolation_table(
+      ctx,
+      in.sizes()[2],
+      out.sizes()[2],
+      in.strides()[2],
+      kernel_scale_h,
+      align_corners);
+  const InterpolationTable w_table = make_interpolation_table(
+      ctx,
+      in.sizes()[3],
+      out.sizes()[3],
+      in.strides()[3],
+      kernel_scale_w,
+      align_corners);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      h_table.ok() && w_table.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate interpolation tables");
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_bilinear2d.out", CTYPE, [&]() {
+        const bool success = channels_last
+            ? upsample_bilinear2d_nhwc<CTYPE>(in, h_table, w_table, out)
+            : upsample_bilinear2d_nchw<CTYPE>(ctx, in, h_table, w_table, out);
+        // Failures to allocate have already been reported.
+        ET_KERNEL_CHECK_MSG(
+            ctx,
+            success || ctx.failure_state() != Error::Ok,
+            Internal,
+            ,
+            "parallel_for failed");
+      });
+
+  return out;
+}
+// NOLINTEND(facebook-hte-ConstantArgumentPassByValue,
+// facebook-hte-ParameterMightThrowOnCopy)
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+using internal::allocate_scratch;
+
+namespace {
+
+/// The source index of each output index of one dimension, as an element
+/// offset, in the temp memory of `ctx`. Computed once per call rather than
+/// once per output element. Returns nullptr if the offsets could not be
+/// allocated.
+int64_t* make_nearest_offsets(
+    KernelRuntimeContext& ctx,
+    int64_t in_size,
+    int64_t out_size,
+    int64_t stride,
+    float scale) {
+  int64_t* const offsets = allocate_scratch<int64_t>(ctx, out_size);
+  if (offsets == nullptr) {
+    return nullptr;
+  }
+  for (const auto i : c10::irange(out_size)) {
+    offsets[i] =
+        nearest_neighbor_compute_source_index(scale, i, in_size) * stride;
+  }
+  return offsets;
+}
+
+/// The number of output rows of `row_size` elements per parallel_for task.
+int64_t rows_grain_size(int64_t row_size) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(row_size, 1));
+}
+
+/**
+ * NCHW: each output row gathers the output columns from one input row. When
+ * upsampling, consecutive output rows come from the same input row, so those
+ * copy the previous output row instead.
+ */
+template <typename CTYPE>
+bool upsample_nearest2d_nchw(
+    const Tensor& in,
+    const int64_t* h_offsets,
+    const int64_t* w_offsets,
+    Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t channels = out.size(1);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t in_batch_stride = in.strides()[0];
+  const int64_t in_channel_stride = in.strides()[1];
+
+  return ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * channels * out_h,
+      rows_grain_size(out_w),
+      [&](int64_t begin, int64_t end) {
+        const CTYPE* prev_src = nullptr;
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t plane = row / out_h;
+          const CTYPE* const src = in_data +
+              (plane / channels) * in_batch_stride +
+              (plane % channels) * in_channel_stride + h_offsets[row % out_h];
+          CTYPE* const out_row = out_data + row * out_w;
+          if (src == prev_src) {
+            std::memcpy(out_row, out_row - out_w, out_w * sizeof(CTYPE));
+          } else {
+            for (const auto ow : c10::irange(out_w)) {
+              out_row[ow] = src[w_offsets[ow]];
+            }
+          }
+          prev_src = src;
+        }
+      });
+}
+
+/// NHWC: each output pixel is a copy of the channels of one input pixel.
+template <typename CTYPE>
+bool upsample_nearest2d_nhwc(
+    const Tensor& in,
+    const int64_t* h_offsets,
+    const int64_t* w_offsets,
+    Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t channels = out.size(1);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+  const int64_t in_batch_stride = in.strides()[0];
+
+  return ::executorch::extension::parallel_for(
+      0,
+      out.size(0) * out_h,
+      rows_grain_size(out_w * channels),
+      [&](int64_t begin, int64_t end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const CTYPE* const src = in_data +
+              (row / out_h) * in_batch_stride + h_offsets[row % out_h];
+          CTYPE* out_pixel = out_data + row * out_w * channels;
+          for (const auto ow : c10::irange(out_w)) {
+            std::memcpy(
+                out_pixel, src + w_offsets[ow], channels * sizeof(CTYPE));
+            out_pixel += channels;
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_upsample_nearest2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const executorch::aten::OptionalArrayRef<int64_t> output_size,
+    const executorch::aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  // Preconditions (checked in check_..._args):
+  //  In and out tensors have same dtype.
+  //  In and out tensors are rank 4 and have same dim[0] and dim[1].
+  //  In and out tensors are NHWC or NCHW dim order.
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_nearest2d_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h, scale_w;
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim_order().size());
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      channels_last ||
+          is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      InvalidArgument,
+      out,
+      "Unsupported dim order");
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // Like the portable kernel, the source indices are computed with float
+  // scales.
+  const float kernel_scale_h = area_pixel_compute_scale<double>(
+      in.sizes()[2], out.sizes()[2], false, scale_h);
+  const float kernel_scale_w = area_pixel_compute_scale<double>(
+      in.sizes()[3], out.sizes()[3], false, scale_w);
+  const int64_t* const h_offsets = make_nearest_offsets(
+      ctx, in.sizes()[2], out.sizes()[2], in.strides()[2], kernel_scale_h);
+  const int64_t* const w_offsets = make_nearest_offsets(
+      ctx, in.sizes()[3], out.sizes()[3], in.strides()[3], kernel_scale_w);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      h_offsets != nullptr && w_offsets != nullptr,
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate source index tables");
+
+  ET_SWITCH_REALHBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_nearest2d.out", CTYPE, [&]() {
+        const bool success = channels_last
+            ? upsample_nearest2d_nhwc<CTYPE>(in, h_offsets, w_offsets, out)
+            : upsample_nearest2d_nchw<CTYPE>(in, h_offsets, w_offsets, out);
+        ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Copies between dense tensors that hold the same elements in different
+// orders, as permute_copy, transpose_copy and _to_dim_order_copy do. Dims
+// that stay adjacent are merged, runs that stay contiguous are copied with
+// memcpy, and the rest is transposed in cache-sized 2D tiles, in parallel.
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * A copy between two dense tensors of the same numel: element (i_0, ...,
+ * i_{ndim-1}) is at sum(i_k * in_strides[k]) in the input and at
+ * sum(i_k * out_strides[k]) in the output. Dims are ordered by decreasing
+ * out stride, without size-1 dims, and adjacent dims are merged wherever
+ * both sides allow it.
+ */
+struct PermutedCopyShape {
+  size_t ndim = 0;
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t in_strides[kTensorDimensionLimit];
+  int64_t out_strides[kTensorDimensionLimit];
+};
+
+/**
+ * Builds the PermutedCopyShape of copying the ndim-dimensional input, whose
+ * dim k has size sizes[k] and stride in_strides[k], to an output in which
+ * that dim has stride out_strides[k].
+ */
+inline PermutedCopyShape make_permuted_copy_shape(
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* in_strides,
+    const int64_t* out_strides) {
+  size_t order[kTensorDimensionLimit];
+  size_t num_dims = 0;
+  for (const auto k : c10::irange(ndim)) {
+    if (sizes[k] != 1) {
+      order[num_dims++] = k;
+    }
+  }
+  std::stable_sort(order, order + num_dims, [&](size_t a, size_t b) {
+    return out_strides[a] > out_strides[b];
+  });
+
+  PermutedCopyShape shape;
+  for (const auto i : c10::irange(num_dims)) {
+    const size_t k = order[i];
+    if (shape.ndim > 0) {
+      const size_t last = shape.ndim - 1;
+      if (shape.in_strides[last] == in_strides[k] * sizes[k] &&
+          shape.out_strides[last] == out_strides[k] * sizes[k]) {
+        shape.sizes[last] *= sizes[k];
+        shape.in_strides[last] = in_strides[k];
+        shape.out_strides[last] = out_strides[k];
+        continue;
+      }
+    }
+    shape.sizes[shape.ndim] = sizes[k];
+    shape.in_strides[shape.ndim] = in_strides[k];
+    shape.out_strides[shape.ndim] = out_strides[k];
+    ++shape.ndim;
+  }
+  return shape;
+}
+
+/**
+ * The PermutedCopyShape of copying `in` to `out`, whose dim k is dim
+ * dims[k] of `in`. dims must be a permutation of [0, out.dim()).
+ */
+inline PermutedCopyShape make_permuted_copy_shape(
+    const executorch::aten::Tensor& in,
+    const executorch::aten::Tensor& out,
+    const int64_t* dims) {
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t in_strides[kTensorDimensionLimit];
+  int64_t out_strides[kTensorDimensionLimit];
+  for (const auto k : c10::irange(out.dim())) {
+    sizes[k] = out.size(k);
+    in_strides[k] = in.strides()[dims[k]];
+    out_strides[k] = out.strides()[k];
+  }
+  return make_permuted_copy_shape(out.dim(), sizes, in_strides, out_strides);
+}
+
+namespace internal {
+
+template <size_t kElementSize>
+struct ElementBytes {
+  uint8_t bytes[kElementSize];
+};
+
+/// An unsigned integer of kElementSize bytes if there is one, so that
+/// elements can be moved as a unit; otherwise just the bytes.
+template <size_t kElementSize>
+using element_of_size_t = std::conditional_t<
+    kElementSize == 1,
+    uint8_t,
+    std::conditional_t<
+        kElementSize == 2,
+        uint16_t,
+        std::conditional_t<
+            kElementSize == 4,
+            uint32_t,
+            std::conditional_t<
+                kElementSize == 8,
+                uint64_t,
+                ElementBytes<kElementSize>>>>>;
+
+/// Tiles are transposed as 2x2 blocks of kTransposeMicroSize<T> square
+/// blocks, each of which spans one 16-byte vector per row: e.g. 8x8 tiles
+/// of 4x4 blocks for 4-byte types, and 16x16 tiles for 2-byte types.
+template <typename T>
+constexpr int64_t kTransposeMicroSize =
+    std::max<int64_t>(1, 16 / sizeof(T));
+template <typename T>
+constexpr int64_t kTransposeTileSize = 2 * kTransposeMicroSize<T>;
+
+/// dst[c * dst_stride + r] = src[r * src_stride + c] for r < rows and
+/// c < cols.
+template <typename T>
+inline void transpose_block_scalar(
+    const T* src,
+    int64_t src_stride,
+    T* dst,
+    int64_t dst_stride,
+    int64_t rows,
+    int64_t cols) {
+  for (const auto c : c10::irange(cols)) {
+    for (const auto r : c10::irange(rows)) {
+      dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+  }
+}
+
+/// transpose_block_scalar() of a kTransposeMicroSize<T> square block.
+template <typename T>
+inline void transpose_micro_block(
+    const T* src,
+    int64_t src_stride,
+    T* dst,
+    int64_t dst_stride) {
+#if defined(__aarch64__)
+  if constexpr (sizeof(T) == 4) {
+    const uint32_t* const s = reinterpret_cast<const uint32_t*>(src);
+    uint32_t* const d = reinterpret_cast<uint32_t*>(dst);
+    const uint32x4x2_t t01 =
+        vtrnq_u32(vld1q_u32(s), vld1q_u32(s + src_stride));
+    const uint32x4x2_t t23 = vtrnq_u32(
+        vld1q_u32(s + 2 * src_stride), vld1q_u32(s + 3 * src_stride));
+    vst1q_u32(
+        d, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+    vst1q_u32(
+        d + dst_stride,
+        vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+    vst1q_u32(
+        d + 2 * dst_stride,
+        vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+    vst1q_u32(
+        d + 3 * dst_stride,
+        vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+    return;
+  } else if constexpr (sizeof(T) == 2) {
+    const uint16_t* const s = reinterpret_cast<const uint16_t*>(src);
+    uint16_t* const d = reinterpret_cast<uint16_t*>(dst);
+    uint16x8x2_t t[4];
+    for (const auto i : c10::irange(4)) {
+      t[i] = vtrnq_u16(
+          vld1q_u16(s + 2 * i * src_stride),
+          vld1q_u16(s + (2 * i + 1) * src_stride));
+    }
+    // u[i].val[j] holds 2-element columns 2 * j + i and 2 * j + i + 4 of
+    // rows 4 * (i / 2) to 4 * (i / 2) + 3, for even and odd columns.
+    uint32x4x2_t u[4];
+    for (const auto i : c10::irange(2)) {
+      u[i] = vtrnq_u32(
+          vreinterpretq_u32_u16(t[0].val[i]),
+          vreinterpretq_u32_u16(t[1].val[i]));
+      u[i + 2] = vtrnq_u32(
+          vreinterpretq_u32_u16(t[2].val[i]),
+          vreinterpretq_u32_u16(t[3].val[i]));
+    }
+    for (const auto c : c10::irange(4)) {
+      // Column c comes from lane pair c % 2 of t, then trn pair c / 2 of u.
+      const uint32x4_t top = u[c % 2].val[c / 2];
+      const uint32x4_t bottom = u[c % 2 + 2].val[c / 2];
+      vst1q_u16(
+          d + c * dst_stride,
+          vreinterpretq_u16_u32(
+              vcombine_u32(vget_low_u32(top), vget_low_u32(bottom))));
+      vst1q_u16(
+          d + (c + 4) * dst_stride,
+          vreinterpretq_u16_u32(
+              vcombine_u32(vget_high_u32(top), vget_high_u32(bottom))));
+    }
+    return;
+  }
+#elif defined(__SSE2__)
+  if constexpr (sizeof(T) == 4) {
+    const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i r1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_stride));
+    const __m128i r2 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + 2 * src_stride));
+    const __m128i r3 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + 3 * src_stride));
+    const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + dst_stride),
+        _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + 2 * dst_stride),
+        _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + 3 * dst_stride),
+        _mm_unpackhi_epi64(t2, t3));
+    return;
+  } else if constexpr (sizeof(T) == 2) {
+    __m128i r[8];
+    for (const auto i : c10::irange(8)) {
+      r[i] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(src + i * src_stride));
+    }
+    // t[2 * i] and t[2 * i + 1] interleave rows 2 * i and 2 * i + 1.
+    __m128i t[8];
+    for (const auto i : c10::irange(4)) {
+      t[2 * i] = _mm_unpacklo_epi16(r[2 * i], r[2 * i + 1]);
+      t[2 * i + 1] = _mm_unpackhi_epi16(r[2 * i], r[2 * i + 1]);
+    }
+    // u[j] (u[j + 4]) holds columns 2 * j and 2 * j + 1 of rows 0-3 (4-7).
+    __m128i u[8];
+    for (const auto i : c10::irange(2)) {
+      u[4 * i] = _mm_unpacklo_epi32(t[4 * i], t[4 * i + 2]);
+      u[4 * i + 1] = _mm_unpackhi_epi32(t[4 * i], t[4 * i + 2]);
+      u[4 * i + 2] = _mm_unpacklo_epi32(t[4 * i + 1], t[4 * i + 3]);
+      u[4 * i + 3] = _mm_unpackhi_epi32(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for (const auto j : c10::irange(4)) {
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(dst + 2 * j * dst_stride),
+          _mm_unpacklo_epi64(u[j], u[j + 4]));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(dst + (2 * j + 1) * dst_stride),
+          _mm_unpackhi_epi64(u[j], u[j + 4]));
+    }
+    return;
+  }
+#endif
+  constexpr int64_t kSize = kTransposeMicroSize<T>;
+  transpose_block_scalar(src, src_stride, dst, dst_stride, kSize, kSize);
+}
+
+/// transpose_block_scalar(), a kTransposeTileSize<T> square tile at a time.
+template <typename T>
+void transpose_2d(
+    const T* src,
+    int64_t src_stride,
+    T* dst,
+    int64_t dst_stride,
+    int64_t rows,
+    int64_t cols) {
+  constexpr int64_t kMicro = kTransposeMicroSize<T>;
+  constexpr int64_t kTile = kTransposeTileSize<T>;
+  for (int64_t r0 = 0; r0 < rows; r0 += kTile) {
+    const int64_t tile_rows = std::min(kTile, rows - r0);
+    for (int64_t c0 = 0; c0 < cols; c0 += kTile) {
+      const int64_t tile_cols = std::min(kTile, cols - c0);
+      const T* const tile_src = src + r0 * src_stride + c0;
+      T* const tile_dst = dst + c0 * dst_stride + r0;
+      if (tile_rows < kTile || tile_cols < kTile) {
+        transpose_block_scalar(
+            tile_src, src_stride, tile_dst, dst_stride, tile_rows, tile_cols);
+        continue;
+      }
+      for (int64_t r = 0; r < kTile; r += kMicro) {
+        for (int64_t c = 0; c < kTile; c += kMicro) {
+          transpose_micro_block(
+              tile_src + r * src_stride + c,
+              src_stride,
+              tile_dst + c * dst_stride + r,
+              dst_stride);
+        }
+      }
+    }
+  }
+}
+
+/// The input and output offsets of the index'th element of the dims
+/// [0, ndim) of shape, other than `skip0` and `skip1`.
+inline void offsets_of_outer_index(
+    const PermutedCopyShape& shape,
+    int64_t index,
+    size_t skip0,
+    size_t skip1,
+    int64_t& in_offset,
+    int64_t& out_offset) {
+  in_offset = 0;
+  out_offset = 0;
+  for (size_t k = shape.ndim; k > 0; --k) {
+    if (k - 1 == skip0 || k - 1 == skip1) {
+      continue;
+    }
+    const int64_t i = index % shape.sizes[k - 1];
+    index /= shape.sizes[k - 1];
+    in_offset += i * shape.in_strides[k - 1];
+    out_offset += i * shape.out_strides[k - 1];
+  }
+}
+
+} // namespace internal
+
+/**
+ * Copies the elements of `in_data` to `out_data`, which hold elements of
+ * the same kElementSize-byte type, as described by `shape`. Returns false
+ * if parallel_for failed.
+ */
+template <size_t kElementSize>
+[[nodiscard]] bool permuted_copy(
+    const PermutedCopyShape& shape,
+    const void* in_data,
+    void* out_data) {
+  using T = internal::element_of_size_t<kElementSize>;
+  using executorch::extension::parallel_for;
+  using executorch::extension::internal::GRAIN_SIZE;
+  const T* const in = static_cast<const T*>(in_data);
+  T* const out = static_cast<T*>(out_data);
+
+  int64_t numel = 1;
+  for (const auto k : c10::irange(shape.ndim)) {
+    numel *= shape.sizes[k];
+  }
+  if (numel == 0) {
+    return true;
+  }
+  if (shape.ndim == 0) {
+    out[0] = in[0];
+    return true;
+  }
+  const size_t last = shape.ndim - 1;
+
+  // The innermost dim is contiguous on both sides: copy whole runs.
+  if (shape.in_strides[last] == 1 && shape.out_strides[last] == 1) {
+    const int64_t run_size = shape.sizes[last];
+    if (shape.ndim == 1) {
+      return parallel_for(
+          0, run_size, GRAIN_SIZE, [&](const auto begin, const auto end) {
+            std::memcpy(out + begin, in + begin, (end - begin) * sizeof(T));
+          });
+    }
+    return parallel_for(
+        0,
+        numel / run_size,
+        std::max<int64_t>(1, GRAIN_SIZE / run_size),
+        [&](const auto begin, const auto end) {
+          for (const auto run : c10::irange(begin, end)) {
+            int64_t in_offset = 0;
+            int64_t out_offset = 0;
+            internal::offsets_of_outer_index(
+                shape, run, last, last, in_offset, out_offset);
+            std::memcpy(
+                out + out_offset, in + in_offset, run_size * sizeof(T));
+          }
+        });
+  }
+
+  // Otherwise, the dim that is contiguous in the input and the one that is
+  // contiguous in the output form a 2D transpose for each index of the
+  // other dims.
+  size_t in_inner = shape.ndim;
+  for (const auto k : c10::irange(shape.ndim)) {
+    if (shape.in_strides[k] == 1) {
+      in_inner = k;
+    }
+  }
+  if (in_inner == shape.ndim || shape.out_strides[last] != 1) {
+    // Not dense; copy an element at a time.
+    for (const auto i : c10::irange(numel)) {
+      int64_t in_offset = 0;
+      int64_t out_offset = 0;
+      internal::offsets_of_outer_index(
+          shape, i, shape.ndim, shape.ndim, in_offset, out_offset);
+      out[out_offset] = in[in_offset];
+    }
+    return true;
+  }
+
+  // Rows of the transpose are input rows, one per index of the dim that is
+  // contiguous in the output; each task handles a strip of kTile columns.
+  constexpr int64_t kTile = internal::kTransposeTileSize<T>;
+  const int64_t rows = shape.sizes[last];
+  const int64_t cols = shape.sizes[in_inner];
+  const int64_t src_stride = shape.in_strides[last];
+  const int64_t dst_stride = shape.out_strides[in_inner];
+  const int64_t num_strips = executorch::utils::divup(cols, kTile);
+  const int64_t num_outer = numel / (rows * cols);
+  return parallel_for(
+      0,
+      num_outer * num_strips,
+      std::max<int64_t>(1, GRAIN_SIZE / (rows * kTile)),
+      [&](const auto begin, const auto end) {
+        for (const auto task : c10::irange(begin, end)) {
+          int64_t in_offset = 0;
+          int64_t out_offset = 0;
+          internal::offsets_of_outer_index(
+              shape, task / num_strips, last, in_inner, in_offset, out_offset);
+          const int64_t c0 = task % num_strips * kTile;
+          internal::transpose_2d(
+              in + in_offset + c0,
+              src_stride,
+              out + out_offset + c0 * dst_stride,
+              dst_stride,
+              rows,
+              std::min(kTile, cols - c0));
+        }
+      });
+}
+
+/**
+ * Like permuted_copy(), but converts each element from IN_T to OUT_T, one
+ * at a time.
+ */
+template <typename IN_T, typename OUT_T>
+void permuted_convert(
+    const PermutedCopyShape& shape,
+    const IN_T* in,
+    OUT_T* out) {
+  int64_t numel = 1;
+  for (const auto k : c10::irange(shape.ndim)) {
+    numel *= shape.sizes[k];
+  }
+  for (const auto i : c10::irange(numel)) {
+    int64_t in_offset = 0;
+    int64_t out_offset = 0;
+    internal::offsets_of_outer_index(
+        shape, i, shape.ndim, shape.ndim, in_offset, out_offset);
+    out[out_offset] = static_cast<OUT_T>(in[in_offset]);
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
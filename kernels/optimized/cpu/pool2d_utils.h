@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Window traversal shared by the optimized 2D pooling kernels. Windows are
+// visited in the same order, and with the same bounds and counts, as
+// kernel_reduction_then_map_2d() in the portable kernel_ops_util.h, so that
+// results match the portable kernels.
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/scratch_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/**
+ * The geometry of a 2D pooling of a 3-D {C, H, W} or 4-D {N, C, H, W}
+ * tensor. Strides are in elements, in N, C, H, W order.
+ */
+struct Pool2dParams {
+  int64_t batch;
+  int64_t channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t in_strides[4];
+  int64_t out_strides[4];
+};
+
+inline Pool2dParams make_pool2d_params(
+    const Tensor& in,
+    const Tensor& out,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const bool batched = in.dim() == 4;
+  const int64_t c_dim = in.dim() - 3;
+  Pool2dParams p;
+  p.batch = batched ? in.size(0) : 1;
+  p.channels = in.size(c_dim);
+  p.in_h = in.size(c_dim + 1);
+  p.in_w = in.size(c_dim + 2);
+  p.out_h = out.size(c_dim + 1);
+  p.out_w = out.size(c_dim + 2);
+  p.kernel_h = val_at(kernel_size, 0);
+  p.kernel_w = val_at(kernel_size, 1);
+  p.stride_h = val_at(stride, 0, /*default_value=*/p.kernel_h);
+  p.stride_w = val_at(stride, 1, /*default_value=*/p.kernel_w);
+  p.pad_h = val_at(padding, 0, /*default_value=*/0);
+  p.pad_w = val_at(padding, 1, /*default_value=*/0);
+  p.dilation_h = val_at(dilation, 0, /*default_value=*/1);
+  p.dilation_w = val_at(dilation, 1, /*default_value=*/1);
+  for (const auto i : c10::irange(3)) {
+    p.in_strides[i + 1] = in.strides()[c_dim + i];
+    p.out_strides[i + 1] = out.strides()[c_dim + i];
+  }
+  p.in_strides[0] = batched ? in.strides()[0] : 0;
+  p.out_strides[0] = batched ? out.strides()[0] : 0;
+  return p;
+}
+
+/**
+ * The in-bound input positions of the pooling window of one output, as
+ * element offsets and as indices in an H x W input plane, both relative to
+ * the ones passed along with the window.
+ */
+struct Pool2dWindow {
+  const int64_t* offsets;
+  const int64_t* indices;
+  int64_t size;
+  // What average pooling divides the sum of the window by.
+  int64_t count;
+};
+
+/**
+ * Calls `fn(window, in_offset, base_index, out_offset, num_channels)` for
+ * the pooling window of each output, in parallel over output rows. The
+ * window reads the input elements at `in_offset` plus its offsets, whose
+ * indices in the input plane are `base_index` plus its indices, and writes
+ * the output element at `out_offset`. When `channels_last` is true,
+ * channels are contiguous in both tensors and one call handles all of them;
+ * otherwise there is one call per channel, with num_channels 1.
+ *
+ * Windows that the portable kernels would skip aren't passed to `fn`. The
+ * windows live in temp memory from `ctx`.
+ *
+ * @returns false if parallel_for() failed or the windows could not be
+ *     allocated, which is reported on `ctx`, and true otherwise.
+ */
+template <typename Fn>
+bool for_each_pool2d_window(
+    KernelRuntimeContext& ctx,
+    const Pool2dParams& p,
+    bool include_pad,
+    bool channels_last,
+    const Fn& fn) {
+  const int64_t window_size = p.kernel_h * p.kernel_w;
+  const int64_t num_planes = channels_last ? p.batch : p.batch * p.channels;
+  const int64_t num_rows = num_planes * p.out_h;
+
+  // The offsets and indices of the windows that lie inside the input, from
+  // their first position. Most windows are like this, so they don't need
+  // bounds checks. The others are built in the window of their slot.
+  int64_t* const interior_offsets = allocate_scratch<int64_t>(ctx, window_size);
+  int64_t* const interior_indices = allocate_scratch<int64_t>(ctx, window_size);
+  int64_t* const windows = allocate_scratch<int64_t>(
+      ctx, num_scratch_slots(num_rows) * 2 * window_size);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      interior_offsets != nullptr && interior_indices != nullptr &&
+          windows != nullptr,
+      MemoryAllocationFailed,
+      false,
+      "Failed to allocate pooling windows");
+  for (const auto wy : c10::irange(p.kernel_h)) {
+    for (const auto wx : c10::irange(p.kernel_w)) {
+      const int64_t y = wy * p.dilation_h;
+      const int64_t x = wx * p.dilation_w;
+      interior_offsets[wy * p.kernel_w + wx] =
+          y * p.in_strides[2] + x * p.in_strides[3];
+      interior_indices[wy * p.kernel_w + wx] = y * p.in_w + x;
+    }
+  }
+
+  const int64_t num_channels = channels_last ? p.channels : 1;
+
+  return parallel_for_slots(
+      num_rows, [&](int64_t slot, int64_t begin, int64_t end) {
+        int64_t* const offsets = windows + slot * 2 * window_size;
+        int64_t* const window_indices = offsets + window_size;
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t plane = row / p.out_h;
+          const int64_t out_y = row % p.out_h;
+          int64_t in_plane_offset = 0;
+          int64_t out_row_offset = out_y * p.out_strides[2];
+          if (channels_last) {
+            in_plane_offset = plane * p.in_strides[0];
+            out_row_offset += plane * p.out_strides[0];
+          } else {
+            const int64_t n = plane / p.channels;
+            const int64_t c = plane % p.channels;
+            in_plane_offset = n * p.in_strides[0] + c * p.in_strides[1];
+            out_row_offset += n * p.out_strides[0] + c * p.out_strides[1];
+          }
+
+          const int64_t y0 = out_y * p.stride_h - p.pad_h;
+          const int64_t y_end = std::min(y0 + p.kernel_h, p.in_h + p.pad_h);
+          const bool interior_y =
+              y0 >= 0 && y0 + (p.kernel_h - 1) * p.dilation_h < p.in_h;
+
+          for (const auto out_x : c10::irange(p.out_w)) {
+            const int64_t x0 = out_x * p.stride_w - p.pad_w;
+            const int64_t out_offset =
+                out_row_offset + out_x * p.out_strides[3];
+            if (interior_y && x0 >= 0 &&
+                x0 + (p.kernel_w - 1) * p.dilation_w < p.in_w) {
+              const int64_t base = y0 * p.in_strides[2] + x0 * p.in_strides[3];
+              fn(Pool2dWindow{
+                     interior_offsets,
+                     interior_indices,
+                     window_size,
+                     window_size},
+                 in_plane_offset + base,
+                 y0 * p.in_w + x0,
+                 out_offset,
+                 num_channels);
+              continue;
+            }
+
+            const int64_t x_end = std::min(x0 + p.kernel_w, p.in_w + p.pad_w);
+            const int64_t pool_size = (y_end - y0) * (x_end - x0);
+            const int64_t y_begin_clamped = std::max<int64_t>(y0, 0);
+            const int64_t x_begin_clamped = std::max<int64_t>(x0, 0);
+            const int64_t y_end_clamped = std::min(y_end, p.in_h);
+            const int64_t x_end_clamped = std::min(x_end, p.in_w);
+            if (y_begin_clamped >= y_end_clamped ||
+                x_begin_clamped >= x_end_clamped) {
+              continue;
+            }
+
+            int64_t size = 0;
+            for (const auto wy : c10::irange(p.kernel_h)) {
+              const int64_t y = y0 + wy * p.dilation_h;
+              if (y < 0 || y >= p.in_h) {
+                continue;
+              }
+              for (const auto wx : c10::irange(p.kernel_w)) {
+                const int64_t x = x0 + wx * p.dilation_w;
+                if (x < 0 || x >= p.in_w) {
+                  continue;
+                }
+                offsets[size] = y * p.in_strides[2] + x * p.in_strides[3];
+                window_indices[size] = y * p.in_w + x;
+                ++size;
+              }
+            }
+            const int64_t count = include_pad
+                ? pool_size
+                : (y_end_clamped - y_begin_clamped) *
+                    (x_end_clamped - x_begin_clamped);
+            fn(Pool2dWindow{offsets, window_indices, size, count},
+               in_plane_offset,
+               /*base_index=*/0,
+               out_offset,
+               num_channels);
+          }
+        }
+      });
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Parallel traversal of scatter and scatter_add. An element of index writes
+// the element of out at the same coordinates, except along `dim`, where the
+// coordinate is the index value. Elements of index that differ in any other
+// coordinate therefore never write the same element of out, so tasks split
+// those coordinates between them without conflicts, and each task visits
+// the elements along `dim` in order, like a serial loop would.
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// The number of trailing positions of index that one task handles.
+constexpr int64_t kScatterChunkSize = 256;
+
+/**
+ * Calls `fn(out_ix, src_ix)` for every element of `index`, with the linear
+ * index of the element of `out` it writes, and of the element of `src` at
+ * the same coordinates. `src` may be null, in which case `src_ix` is 0.
+ *
+ * @returns false if parallel_for failed.
+ */
+template <typename Fn>
+[[nodiscard]] bool parallel_scatter(
+    const executorch::aten::Tensor& index,
+    const executorch::aten::Tensor* src,
+    const executorch::aten::Tensor& out,
+    int64_t dim,
+    const Fn& fn) {
+  const int64_t* const index_data = index.const_data_ptr<int64_t>();
+  if (index.dim() == 0 || out.dim() == 0) {
+    // There is at most one element along every dim but `dim`.
+    const int64_t out_stride = out.dim() == 0 ? 0 : out.strides()[dim];
+    for (const auto i : c10::irange(index.numel())) {
+      fn(index_data[i] * out_stride, 0);
+    }
+    return true;
+  }
+
+  const int64_t ndim = index.dim();
+  const auto index_strides = index.strides();
+  const auto out_strides = out.strides();
+  const auto src_stride = [&](int64_t d) -> int64_t {
+    return src == nullptr || src->dim() == 0 ? 0 : src->strides()[d];
+  };
+
+  int64_t leading = 1;
+  for (const auto d : c10::irange(dim)) {
+    leading *= index.size(d);
+  }
+  const int64_t dim_size = index.size(dim);
+  int64_t trailing = 1;
+  for (const auto d : c10::irange(dim + 1, ndim)) {
+    trailing *= index.size(d);
+  }
+  const int64_t num_chunks =
+      (trailing + kScatterChunkSize - 1) / kScatterChunkSize;
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(
+              1, dim_size * std::min(trailing, kScatterChunkSize)));
+
+  return ::executorch::extension::parallel_for(
+      0,
+      leading * num_chunks,
+      grain_size,
+      [&](const auto begin, const auto end) {
+        // The offsets of the trailing coordinates of a chunk in each tensor.
+        int64_t index_offsets[kScatterChunkSize];
+        int64_t src_offsets[kScatterChunkSize];
+        int64_t out_offsets[kScatterChunkSize];
+        for (const auto task : c10::irange(begin, end)) {
+          const int64_t outer = task / num_chunks;
+          const int64_t first = task % num_chunks * kScatterChunkSize;
+          const int64_t n = std::min(kScatterChunkSize, trailing - first);
+
+          int64_t index_base = 0;
+          int64_t src_base = 0;
+          int64_t out_base = 0;
+          int64_t remainder = outer;
+          for (int64_t d = dim - 1; d >= 0; --d) {
+            const int64_t coord = remainder % index.size(d);
+            remainder /= index.size(d);
+            index_base += coord * index_strides[d];
+            src_base += coord * src_stride(d);
+            out_base += coord * out_strides[d];
+          }
+          for (const auto t : c10::irange(n)) {
+            index_offsets[t] = 0;
+            src_offsets[t] = 0;
+            out_offsets[t] = 0;
+            remainder = first + t;
+            for (int64_t d = ndim - 1; d > dim; --d) {
+              const int64_t coord = remainder % index.size(d);
+              remainder /= index.size(d);
+              index_offsets[t] += coord * index_strides[d];
+              src_offsets[t] += coord * src_stride(d);
+              out_offsets[t] += coord * out_strides[d];
+            }
+          }
+
+          // Visit whole rows along `dim` in order, which keeps the accesses
+          // to contiguous tensors sequential.
+          for (const auto j : c10::irange(dim_size)) {
+            const int64_t* const index_row =
+                index_data + index_base + j * index_strides[dim];
+            const int64_t src_row = src_base + j * src_stride(dim);
+            for (const auto t : c10::irange(n)) {
+              fn(out_base + index_row[index_offsets[t]] * out_strides[dim] +
+                     out_offsets[t],
+                 src_row + src_offsets[t]);
+            }
+          }
+        }
+      });
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Scratch memory for kernels that split their work across parallel_for()
+// tasks. KernelRuntimeContext::allocate_temp() is not thread-safe, so the
+// buffers that tasks use are reserved before the work goes parallel, one per
+// slot, and the tasks are grouped into that many slots.
+
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// The most scratch buffers a kernel reserves for its tasks, which is also
+/// the most of those tasks that run at once.
+constexpr int64_t kMaxScratchSlots = 16;
+
+/**
+ * Returns `n` elements of T from the temp memory of `ctx`, or nullptr if there
+ * isn't enough. Reserves at least one element, so nullptr always means
+ * failure.
+ */
+template <typename T>
+T* allocate_scratch(KernelRuntimeContext& ctx, size_t n) {
+  Result<void*> temp =
+      ctx.allocate_temp(std::max<size_t>(n, 1) * sizeof(T), alignof(T));
+  return temp.ok() ? static_cast<T*>(temp.get()) : nullptr;
+}
+
+/// Returns the number of slots that parallel_for_slots() splits `num_tasks`
+/// tasks into, and so the number of scratch buffers they need.
+inline int64_t num_scratch_slots(int64_t num_tasks) {
+  return std::max<int64_t>(1, std::min(num_tasks, kMaxScratchSlots));
+}
+
+/**
+ * Calls fn(slot, begin, end) in parallel for ranges of tasks that together
+ * cover [0, num_tasks). Calls that run at the same time get different slots
+ * in [0, num_scratch_slots(num_tasks)), so each can use the scratch buffer of
+ * its slot.
+ *
+ * @returns false if parallel_for failed.
+ */
+template <typename Fn>
+[[nodiscard]] bool parallel_for_slots(int64_t num_tasks, const Fn& fn) {
+  const int64_t num_slots = num_scratch_slots(num_tasks);
+  const int64_t slot_tasks = executorch::utils::divup(num_tasks, num_slots);
+  return ::executorch::extension::parallel_for(
+      0, num_slots, 1, [&](int64_t begin, int64_t end) {
+        fn(begin,
+           std::min(num_tasks, begin * slot_tasks),
+           std::min(num_tasks, end * slot_tasks));
+      });
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
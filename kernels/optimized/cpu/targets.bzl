@@ -1,7 +1,15 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+load("@fbsource//xplat/executorch/kernels/optimized:lib_defs.bzl", "define_multiversion_library")
 load("@fbsource//xplat/executorch/kernels/optimized:op_registration_util.bzl", "define_op_target", "op_target")
 
 _OPTIMIZED_ATEN_OPS = (
+    op_target(
+        name = "op__to_dim_order_copy",
+        deps = [
+            ":permute_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
     op_target(
         name = "op_add",
         deps = [
@@ -11,12 +19,69 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_argmax",
+        deps = [
+            ":arg_reduce_utils",
+        ],
+    ),
+    op_target(
+        name = "op_argmin",
+        deps = [
+            ":arg_reduce_utils",
+        ],
+    ),
+    op_target(
+        name = "op_avg_pool2d",
+        deps = [
+            ":pool2d_utils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
             "//executorch/kernels/optimized:libblas",
         ],
     ),
+    op_target(
+        name = "op_cdist_forward",
+        deps = [
+            ":distance_utils",
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:dtype_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_convolution_backward",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_cumsum",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:dtype_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_div",
         deps = [
@@ -25,16 +90,74 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
-    op_target(name = "op_exp"),
+    op_target(
+        name = "op_embedding",
+        deps = [
+            ":gather_utils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_erf",
+        deps = [
+            ":unary_ops",
+        ],
+    ),
+    op_target(
+        name = "op_exp",
+        deps = [
+            ":multiversion_kernels",
+        ],
+    ),
+    op_target(
+        name = "op_expm1",
+        deps = [
+            ":unary_ops",
+        ],
+    ),
+    op_target(
+        name = "op_fft_c2c",
+        compiler_flags = [] if runtime.is_oss else [
+            "-Wno-global-constructors",
+            "-Wno-shadow",
+        ],
+        deps = [
+            ":fft_utils",
+        ],
+    ),
+    op_target(
+        name = "op_fft_c2r",
+        compiler_flags = [] if runtime.is_oss else [
+            "-Wno-global-constructors",
+            "-Wno-shadow",
+        ],
+        deps = [
+            ":fft_utils",
+        ],
+    ),
     op_target(
         name = "op_fft_r2c",
         compiler_flags = [] if runtime.is_oss else [
             "-Wno-global-constructors",
             "-Wno-shadow",
         ],
-        deps = [] if runtime.is_oss else ["fbsource//third-party/pocket_fft:pocketfft"],
+        deps = [
+            ":fft_utils",
+        ],
+    ),
+    op_target(
+        name = "op_gather",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:index_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_sigmoid",
+        deps = [
+            ":multiversion_kernels",
+        ],
     ),
-    op_target(name = "op_sigmoid"),
     op_target(
         name = "op_gelu",
         deps = [
@@ -42,6 +165,22 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_index_put",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:advanced_index_util",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_index_select",
+        deps = [
+            ":gather_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
     op_target(
         name = "op_le",
         deps = [
@@ -56,6 +195,18 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
         ],
     ),
+    op_target(
+        name = "op_log",
+        deps = [
+            ":unary_ops",
+        ],
+    ),
+    op_target(
+        name = "op_log1p",
+        deps = [
+            ":unary_ops",
+        ],
+    ),
     op_target(
         name = "op_log_softmax",
         deps = [
@@ -63,6 +214,50 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_masked_scatter",
+        deps = [
+            ":mask_utils",
+            ":multiversion_kernels",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+        ],
+    ),
+    op_target(
+        name = "op_masked_select",
+        deps = [
+            ":mask_utils",
+            ":multiversion_kernels",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+        ],
+    ),
+    op_target(
+        name = "op_max",
+        deps = [
+            ":arg_reduce_utils",
+        ],
+    ),
+    op_target(
+        name = "op_max_pool2d_with_indices",
+        deps = [
+            ":pool2d_utils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_max_pool2d_with_indices_backward",
+        deps = [
+            ":pool2d_utils",
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_min",
+        deps = [
+            ":arg_reduce_utils",
+        ],
+    ),
     op_target(
         name = "op_mm",
         deps = [
@@ -79,6 +274,22 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/exec_aten/util:tensor_util",
         ],
     ),
+    op_target(
+        name = "op_native_batch_norm",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_native_group_norm",
+        deps = [
+            ":moments_utils",
+            "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_native_layer_norm",
         deps = [
@@ -87,6 +298,52 @@ _OPTIMIZED_ATEN_OPS = (
         ],
     ),
     op_target(name = "op_neg"),
+    op_target(
+        name = "op_nonzero",
+        deps = [
+            ":mask_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
+    op_target(
+        name = "op_pdist_forward",
+        deps = [
+            ":distance_utils",
+            ":scratch_utils",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_permute_copy",
+        deps = [
+            ":permute_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_scatter",
+        deps = [
+            ":scatter_utils",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
+    op_target(
+        name = "op_scatter_add",
+        deps = [
+            ":scatter_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
@@ -96,6 +353,43 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_tanh",
+        deps = [
+            ":unary_ops",
+        ],
+    ),
+    op_target(
+        name = "op_topk",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_transpose_copy",
+        deps = [
+            ":permute_utils",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_bilinear2d",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_nearest2d",
+        deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_where",
         deps = [
@@ -148,6 +442,66 @@ def define_common_targets():
         exported_deps = all_op_targets,
     )
 
+    # Kernels compiled once per CPU capability, which the ops above call
+    # through dispatch stubs.
+    define_multiversion_library(
+        name = "multiversion_kernels",
+        srcs = native.glob(["multiversion/*.cpp"]),
+        headers = native.glob(["multiversion/*.h"]),
+        header_namespace = "executorch/kernels/optimized/cpu",
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+        visibility = ["//executorch/kernels/optimized/..."],
+    )
+
+    runtime.cxx_library(
+        name = "arg_reduce_utils",
+        srcs = [],
+        exported_headers = ["arg_reduce_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            ":scratch_utils",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/kernel:kernel_includes",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "distance_utils",
+        srcs = [],
+        exported_headers = ["distance_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:distance_util",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "gather_utils",
+        srcs = [],
+        exported_headers = ["gather_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "mask_utils",
+        srcs = [],
+        exported_headers = ["mask_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            ":scratch_utils",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
     runtime.cxx_library(
         name = "moments_utils",
         srcs = [],
@@ -158,3 +512,71 @@ def define_common_targets():
             "//executorch/kernels/optimized:libutils",
         ],
     )
+
+    runtime.cxx_library(
+        name = "pool2d_utils",
+        srcs = [],
+        exported_headers = ["pool2d_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            ":scratch_utils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "scratch_utils",
+        srcs = [],
+        exported_headers = ["scratch_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/runtime/kernel:kernel_runtime_context",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "scatter_utils",
+        srcs = [],
+        exported_headers = ["scatter_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "fft_utils",
+        srcs = [],
+        exported_headers = ["fft_utils.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ] + ([] if runtime.is_oss else ["fbsource//third-party/pocket_fft:pocketfft"]),
+    )
+
+    runtime.cxx_library(
+        name = "unary_ops",
+        srcs = [],
+        exported_headers = ["unary_ops.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            ":multiversion_kernels",
+            "//executorch/kernels/portable/cpu/pattern:pattern",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "permute_utils",
+        srcs = [],
+        exported_headers = ["permute_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    )
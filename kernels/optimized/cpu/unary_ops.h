@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/kernels/optimized/cpu/multiversion/unary_kernels.h>
+#include <executorch/kernels/portable/cpu/pattern/pattern.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/**
+ * Like unary_ufunc_realhbbf16_to_floathbf16(), which it falls back to when
+ * `in` and `out` have different dtypes. When they have the same floating
+ * dtype, `out` is computed by the vectorized kernel behind `stub` instead,
+ * on chunks of the tensor in parallel.
+ */
+inline Tensor& unary_ufunc_floating_via_stub(
+    const ::executorch::dispatch::DispatchStub<unary_fn>& stub,
+    double (*fn)(double),
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    Tensor& out) {
+  if (in.scalar_type() != out.scalar_type()) {
+    return unary_ufunc_realhbbf16_to_floathbf16(fn, ctx, in, out);
+  }
+
+  ET_KERNEL_CHECK(ctx, tensor_is_floating_type(out), InvalidArgument, out);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  const ScalarType dtype = out.scalar_type();
+  const size_t element_size = out.element_size();
+  const char* const in_data = static_cast<const char*>(in.const_data_ptr());
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
+  const bool success = ::executorch::extension::parallel_for(
+      0,
+      out.numel(),
+      ::executorch::extension::internal::GRAIN_SIZE,
+      [&](int64_t begin, int64_t end) {
+        stub(
+            dtype,
+            in_data + begin * element_size,
+            out_data + begin * element_size,
+            end - begin);
+      });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
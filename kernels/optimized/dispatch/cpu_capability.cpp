@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/dispatch/cpu_capability.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#include <cpuinfo.h>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+namespace executorch {
+namespace dispatch {
+
+namespace {
+
+bool detect_support(CPUCapability capability) {
+  if (capability == CPUCapability::DEFAULT) {
+    return true;
+  }
+  if (!cpuinfo_initialize()) {
+    return false;
+  }
+  switch (capability) {
+#if defined(__x86_64__) || defined(_M_X64)
+    case CPUCapability::AVX2:
+      return cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3() &&
+          cpuinfo_has_x86_f16c();
+    case CPUCapability::AVX512:
+      return detect_support(CPUCapability::AVX2) && cpuinfo_has_x86_avx512f();
+#endif
+#if defined(__aarch64__) && defined(__linux__) && defined(PR_SVE_GET_VL)
+    case CPUCapability::SVE256: {
+      if (!cpuinfo_has_arm_sve()) {
+        return false;
+      }
+      // SVE256 kernels are compiled for registers of exactly 32 bytes.
+      const int vl = prctl(PR_SVE_GET_VL);
+      return vl >= 0 && (vl & PR_SVE_VL_LEN_MASK) == 32;
+    }
+#endif
+    default:
+      return false;
+  }
+}
+
+CPUCapability compute_cpu_capability() {
+  CPUCapability best = CPUCapability::DEFAULT;
+  for (const CPUCapability capability :
+       {CPUCapability::AVX2, CPUCapability::AVX512, CPUCapability::SVE256}) {
+    if (cpu_supports(capability)) {
+      best = capability;
+    }
+  }
+
+  const char* requested = std::getenv("ET_CPU_CAPABILITY");
+  if (requested != nullptr) {
+    for (size_t i = 0; i < kNumCPUCapabilities; ++i) {
+      const auto capability = static_cast<CPUCapability>(i);
+      if (std::strcmp(requested, cpu_capability_name(capability)) == 0 &&
+          cpu_supports(capability) &&
+          static_cast<uint8_t>(capability) <= static_cast<uint8_t>(best)) {
+        return capability;
+      }
+    }
+  }
+  return best;
+}
+
+} // namespace
+
+bool cpu_supports(CPUCapability capability) {
+  static const bool supported[kNumCPUCapabilities] = {
+      detect_support(CPUCapability::DEFAULT),
+      detect_support(CPUCapability::AVX2),
+      detect_support(CPUCapability::AVX512),
+      detect_support(CPUCapability::SVE256),
+  };
+  const auto index = static_cast<size_t>(capability);
+  return index < kNumCPUCapabilities && supported[index];
+}
+
+CPUCapability get_cpu_capability() {
+  static const CPUCapability capability = compute_cpu_capability();
+  return capability;
+}
+
+const char* cpu_capability_name(CPUCapability capability) {
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return "default";
+    case CPUCapability::AVX2:
+      return "avx2";
+    case CPUCapability::AVX512:
+      return "avx512";
+    case CPUCapability::SVE256:
+      return "sve256";
+  }
+  return "unknown";
+}
+
+} // namespace dispatch
+} // namespace executorch
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace executorch {
+namespace dispatch {
+
+/**
+ * The instruction sets that multi-versioned kernels are compiled for. The
+ * names match the values of the CPU_CAPABILITY macro that each version is
+ * compiled with; see Note [CPU_CAPABILITY namespace] in dispatch_stub.h.
+ *
+ * Within an architecture, later values support everything earlier values do.
+ */
+enum class CPUCapability : uint8_t {
+  /// The architecture's baseline: SSE2 on x86-64, NEON on AArch64.
+  DEFAULT = 0,
+  /// x86-64 with AVX2, FMA and F16C (Haswell and later).
+  AVX2 = 1,
+  /// x86-64 with AVX-512F, in addition to AVX2.
+  AVX512 = 2,
+  /// AArch64 with 256-bit SVE registers (Graviton3, Neoverse V1).
+  SVE256 = 3,
+};
+
+constexpr size_t kNumCPUCapabilities = 4;
+
+/**
+ * Returns the best capability that the CPU running this process supports.
+ * Detected once, with cpuinfo.
+ *
+ * The ET_CPU_CAPABILITY environment variable may lower the result, to compare
+ * kernel versions or to work around a broken one: it may be set to "default",
+ * "avx2", "avx512" or "sve256". Values the CPU doesn't support are ignored.
+ */
+CPUCapability get_cpu_capability();
+
+/// Returns true if the CPU running this process can run code compiled for
+/// `capability`.
+bool cpu_supports(CPUCapability capability);
+
+/// Returns the lower-case name of `capability`, e.g. "avx2".
+const char* cpu_capability_name(CPUCapability capability);
+
+} // namespace dispatch
+} // namespace executorch
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include <executorch/kernels/optimized/dispatch/cpu_capability.h>
+#include <executorch/runtime/platform/assert.h>
+
+/**
+ * Runtime selection between versions of a kernel compiled for different
+ * instruction sets, so that one binary runs well on every CPU it ships to.
+ *
+ * A multi-versioned kernel lives in a source file that the build compiles once
+ * per CPUCapability, with the matching compiler flags and with
+ * -DCPU_CAPABILITY=<name> -DCPU_CAPABILITY_<name>. The file registers its
+ * entry point with ET_REGISTER_DISPATCH(), and a header shared with the caller
+ * declares the stub with ET_DECLARE_DISPATCH(). Exactly one ordinary source
+ * file defines the stub with ET_DEFINE_DISPATCH(), and calls through it:
+ *
+ *   // unary_kernels.h
+ *   using exp_fn = void (*)(const float* in, float* out, size_t numel);
+ *   ET_DECLARE_DISPATCH(exp_fn, exp_stub);
+ *
+ *   // multiversion/unary_kernels.cpp, compiled once per capability
+ *   namespace { void exp_kernel(const float*, float*, size_t) {...} }
+ *   ET_REGISTER_DISPATCH(exp_stub, &exp_kernel);
+ *
+ *   // op_exp.cpp
+ *   ET_DEFINE_DISPATCH(exp_stub);
+ *   ... exp_stub(in, out, numel);
+ *
+ * The stub picks the version for get_cpu_capability(), or the best one below
+ * it that was compiled, on the first call. The DEFAULT version must always be
+ * compiled. The build tells the file that defines the stub which other
+ * versions exist by defining ET_HAVE_<name>_CPU_DEFINITION.
+ *
+ * Note [CPU_CAPABILITY namespace]
+ * Inline functions and templates, like everything in the vec library, are
+ * compiled into every version of a multi-versioned file. If they were emitted
+ * under the same symbol names in each version, the linker would keep one of
+ * them for all callers, and a CPU without AVX2 could end up running code
+ * compiled for AVX2. Headers that hold such code therefore wrap it in
+ * `inline namespace CPU_CAPABILITY`, which gives each version its own names,
+ * and multi-versioned files keep their own functions in an anonymous
+ * namespace. Files compiled only once don't define CPU_CAPABILITY and use the
+ * namespace literally named `CPU_CAPABILITY`.
+ */
+
+namespace executorch {
+namespace dispatch {
+
+template <typename FnPtr>
+class DispatchStub;
+
+template <typename Ret, typename... Args>
+class DispatchStub<Ret (*)(Args...)> final {
+ public:
+  using FnPtr = Ret (*)(Args...);
+
+  /**
+   * Takes the addresses of the entry points of each version, or null for
+   * versions that weren't compiled. Use ET_DEFINE_DISPATCH() instead of
+   * calling this directly.
+   */
+  constexpr DispatchStub(
+      const FnPtr* default_impl,
+      const FnPtr* avx2_impl,
+      const FnPtr* avx512_impl,
+      const FnPtr* sve256_impl)
+      : impls_{default_impl, avx2_impl, avx512_impl, sve256_impl} {}
+
+  DispatchStub(const DispatchStub&) = delete;
+  DispatchStub& operator=(const DispatchStub&) = delete;
+  DispatchStub(DispatchStub&&) = delete;
+  DispatchStub& operator=(DispatchStub&&) = delete;
+
+  /// Calls the best version of the kernel for this CPU.
+  template <typename... ArgTypes>
+  Ret operator()(ArgTypes&&... args) const {
+    return choose()(std::forward<ArgTypes>(args)...);
+  }
+
+  /**
+   * Returns the version compiled for `capability`, or null if there is none
+   * or if this CPU can't run it. Lets tests compare versions with each other.
+   */
+  FnPtr get(CPUCapability capability) const {
+    const auto index = static_cast<size_t>(capability);
+    if (index >= kNumCPUCapabilities || impls_[index] == nullptr ||
+        !cpu_supports(capability)) {
+      return nullptr;
+    }
+    return *impls_[index];
+  }
+
+  /// Returns the version that operator() calls.
+  FnPtr choose() const {
+    FnPtr fn = chosen_.load(std::memory_order_acquire);
+    if (fn == nullptr) {
+      // Racing callers choose the same version, so either store may win.
+      fn = choose_uncached();
+      chosen_.store(fn, std::memory_order_release);
+    }
+    return fn;
+  }
+
+ private:
+  FnPtr choose_uncached() const {
+    for (size_t i = static_cast<size_t>(get_cpu_capability()) + 1; i-- > 0;) {
+      const FnPtr fn = get(static_cast<CPUCapability>(i));
+      if (fn != nullptr) {
+        return fn;
+      }
+    }
+    ET_CHECK_MSG(false, "No DEFAULT version of the kernel was registered");
+    return nullptr;
+  }
+
+  const FnPtr* const impls_[kNumCPUCapabilities];
+  mutable std::atomic<FnPtr> chosen_{nullptr};
+};
+
+} // namespace dispatch
+} // namespace executorch
+
+#define ET_DISPATCH_CONCAT_IMPL(a, b) a##b
+#define ET_DISPATCH_CONCAT(a, b) ET_DISPATCH_CONCAT_IMPL(a, b)
+
+/**
+ * Declares the stub `name` for kernels of type `fn_type`, which must be a
+ * function pointer type, along with the entry point of each version.
+ */
+#define ET_DECLARE_DISPATCH(fn_type, name) \
+  extern fn_type const name##_DEFAULT;     \
+  extern fn_type const name##_AVX2;        \
+  extern fn_type const name##_AVX512;      \
+  extern fn_type const name##_SVE256;      \
+  extern ::executorch::dispatch::DispatchStub<fn_type> name
+
+#if defined(ET_HAVE_AVX2_CPU_DEFINITION)
+#define ET_DISPATCH_AVX2_IMPL(name) &name##_AVX2
+#else
+#define ET_DISPATCH_AVX2_IMPL(name) nullptr
+#endif
+
+#if defined(ET_HAVE_AVX512_CPU_DEFINITION)
+#define ET_DISPATCH_AVX512_IMPL(name) &name##_AVX512
+#else
+#define ET_DISPATCH_AVX512_IMPL(name) nullptr
+#endif
+
+#if defined(ET_HAVE_SVE256_CPU_DEFINITION)
+#define ET_DISPATCH_SVE256_IMPL(name) &name##_SVE256
+#else
+#define ET_DISPATCH_SVE256_IMPL(name) nullptr
+#endif
+
+/**
+ * Defines the stub `name`, referring to every version that the build
+ * compiled. The stub is constant-initialized, so it may be called from static
+ * initializers.
+ */
+#define ET_DEFINE_DISPATCH(name)        \
+  decltype(name) name(                  \
+      &name##_DEFAULT,                  \
+      ET_DISPATCH_AVX2_IMPL(name),      \
+      ET_DISPATCH_AVX512_IMPL(name),    \
+      ET_DISPATCH_SVE256_IMPL(name))
+
+/**
+ * Registers `fn` as the version of the stub `name` for the capability this
+ * file is being compiled for. Must be used at the scope where the stub was
+ * declared.
+ */
+#if defined(CPU_CAPABILITY)
+#define ET_REGISTER_DISPATCH(name, fn)                     \
+  decltype(name)::FnPtr const ET_DISPATCH_CONCAT(          \
+      name##_, CPU_CAPABILITY) = fn
+#else
+#define ET_REGISTER_DISPATCH(name, fn) \
+  static_assert(                       \
+      false,                           \
+      "ET_REGISTER_DISPATCH requires a file compiled with -DCPU_CAPABILITY")
+#endif
@@ -71,6 +71,84 @@ def get_vec_fbcode_preprocessor_flags():
     ]
     return preprocessor_flags
 
+def _cpu_capabilities():
+    """Returns the CPU capabilities, besides DEFAULT, that multi-versioned
+    kernels are compiled for: the platform that supports each, and its compiler
+    and preprocessor flags. See kernels/optimized/dispatch/dispatch_stub.h.
+    """
+    capabilities = [
+        ("AVX2", "ovr_config//cpu:x86_64", ["-mavx2", "-mfma", "-mf16c"], ["-DCPU_CAPABILITY_AVX2"]),
+        ("AVX512", "ovr_config//cpu:x86_64", ["-mavx512f", "-mavx2", "-mfma", "-mf16c"], ["-DCPU_CAPABILITY_AVX512"]),
+    ]
+    # OSS doesn't have ovr_config//os:linux-arm64. Phones don't have 256-bit
+    # SVE, so only Linux servers get this version, and only when enabled with
+    # -c executorch.optimized_sve256=true until it is tested on SVE hardware.
+    if not runtime.is_oss and native.read_config("executorch", "optimized_sve256", "false") == "true":
+        capabilities.append(
+            ("SVE256", "ovr_config//os:linux-arm64", ["-march=armv8.2-a+sve", "-msve-vector-bits=256"], ["-DCPU_CAPABILITY_SVE", "-DCPU_CAPABILITY_SVE256"]),
+        )
+    return capabilities
+
+def define_multiversion_library(name, srcs, headers = [], header_namespace = None, compiler_flags = [], deps = [], visibility = None):
+    """Compiles `srcs` once per CPU capability, for runtime dispatch.
+
+    Each version is a separate cxx_library compiled with -DCPU_CAPABILITY=<name>
+    and the flags of its capability, on the platforms that support it. The
+    library `name` links every version in, and exports the
+    ET_HAVE_<name>_CPU_DEFINITION flags that ET_DEFINE_DISPATCH() uses to find
+    them.
+
+    Args:
+        name: The name of the library that dependents use.
+        srcs: Sources that register kernels with ET_REGISTER_DISPATCH().
+        headers: Headers that declare the dispatch stubs. Exported by `name`.
+        header_namespace: Optional header_namespace for `headers`.
+        compiler_flags: Extra compiler flags for every version.
+        deps: Deps of every version.
+        visibility: Visibility of `name`.
+    """
+    namespace_kwargs = {} if header_namespace == None else {"header_namespace": header_namespace}
+    versions = []
+    have_flags = {}
+    for capability, platform, capability_compiler_flags, capability_preprocessor_flags in [("DEFAULT", None, [], [])] + _cpu_capabilities():
+        version = "{}_{}".format(name, capability.lower())
+        if platform == None:
+            version_srcs = srcs
+            version_compiler_flags = compiler_flags
+        else:
+            version_srcs = select({platform: srcs, "DEFAULT": []})
+            version_compiler_flags = compiler_flags + select({platform: capability_compiler_flags, "DEFAULT": []})
+            have_flags.setdefault(platform, []).append("-DET_HAVE_{}_CPU_DEFINITION".format(capability))
+        runtime.cxx_library(
+            name = version,
+            srcs = version_srcs,
+            headers = headers,
+            compiler_flags = version_compiler_flags,
+            preprocessor_flags = ["-DCPU_CAPABILITY={}".format(capability)] + capability_preprocessor_flags + get_vec_preprocessor_flags(),
+            visibility = [":{}".format(name)],
+            deps = deps + get_vec_deps() + [
+                "//executorch/kernels/optimized:libdispatch",
+                "//executorch/kernels/optimized:libvec",
+                "//executorch/kernels/optimized:libutils",
+            ],
+            **namespace_kwargs
+        )
+        versions.append(":{}".format(version))
+
+    have_flags_select = dict(have_flags)
+    have_flags_select["DEFAULT"] = []
+    runtime.cxx_library(
+        name = name,
+        srcs = [],
+        exported_headers = headers,
+        exported_preprocessor_flags = select(have_flags_select),
+        visibility = visibility,
+        exported_deps = versions + [
+            "//executorch/kernels/optimized:libdispatch",
+        ],
+        **namespace_kwargs
+    )
+
 def get_apple_framework_deps_kwargs(is_fbcode):
     # various ovr_configs are not available in oss
     if not runtime.is_oss and not is_fbcode:
@@ -186,17 +264,61 @@ def define_libs(is_fbcode=False):
         ],
     )
 
+    runtime.cxx_library(
+        name = "libdispatch",
+        srcs = native.glob([
+            "dispatch/**/*.cpp",
+        ]),
+        exported_headers = native.glob([
+            "dispatch/**/*.h",
+        ]),
+        header_namespace = "executorch/kernels/optimized",
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            third_party_dep("cpuinfo"),
+        ],
+        exported_deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    # The fallback gemm kernels, compiled once per CPU capability.
+    define_multiversion_library(
+        name = "libblas_kernels",
+        srcs = native.glob([
+            "blas/multiversion/**/*.cpp",
+        ]),
+        headers = native.glob([
+            "blas/**/*.h",
+        ]),
+        header_namespace = "executorch/kernels/optimized",
+        compiler_flags = get_compiler_optimization_flags(),
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+        visibility = [
+            "//executorch/kernels/optimized/...",
+        ],
+    )
+
     LIBBLAS_DEPS = [
         third_party_dep("cpuinfo"),
         "//executorch/extension/threadpool:threadpool",
+        ":libblas_kernels",
     ]
 
     for libblas_name, mkl_dep in [("libblas", "fbsource//third-party/mkl:mkl_lp64_omp"), ("libblas_mkl_noomp", "fbsource//third-party/mkl:mkl")]:
         runtime.cxx_library(
             name = libblas_name,
-            srcs = native.glob([
-                "blas/**/*.cpp",
-            ]),
+            srcs = native.glob(
+                ["blas/**/*.cpp"],
+                exclude = ["blas/multiversion/**/*.cpp"],
+            ),
             exported_headers = native.glob([
                 "blas/**/*.h",
             ]),
@@ -9,8 +9,10 @@
 #include <gtest/gtest.h>
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/blas/multiversion/gemm_kernels.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 
+#include <array>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_, N) \
@@ -76,3 +78,145 @@ void test_matmul_ones() {
 TEST(BlasTest, MatmulOnes) {
   TEST_FORALL_SUPPORTED_CTYPES(test_matmul_ones, 25);
 }
+
+template <typename CTYPE, typename Stub>
+void test_gemm_versions_agree(const Stub& stub) {
+  using executorch::cpublas::TransposeType;
+  using executorch::dispatch::CPUCapability;
+  constexpr int64_t m = 37;
+  constexpr int64_t n = 19;
+  constexpr int64_t k = 45;
+
+  std::vector<CTYPE> a(k * m);
+  std::vector<CTYPE> b(n * k);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<CTYPE>(static_cast<int>(i % 7) - 3);
+  }
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<CTYPE>(static_cast<int>(i % 5) - 2);
+  }
+
+  const auto reference = stub.get(CPUCapability::DEFAULT);
+  ASSERT_NE(reference, nullptr);
+  const auto transposes = {
+      TransposeType::NoTranspose, TransposeType::Transpose};
+  for (const auto transa : transposes) {
+    for (const auto transb : transposes) {
+      const int64_t lda = transa == TransposeType::NoTranspose ? m : k;
+      const int64_t ldb = transb == TransposeType::NoTranspose ? k : n;
+      std::vector<CTYPE> expected(m * n, static_cast<CTYPE>(1));
+      reference(
+          transa, transb, m, n, k, 2, a.data(), lda, b.data(), ldb, 1,
+          expected.data(), m);
+
+      for (const auto capability :
+           {CPUCapability::AVX2,
+            CPUCapability::AVX512,
+            CPUCapability::SVE256}) {
+        const auto version = stub.get(capability);
+        if (version == nullptr) {
+          continue;
+        }
+        std::vector<CTYPE> out(m * n, static_cast<CTYPE>(1));
+          version(
+            transa, transb, m, n, k, 2, a.data(), lda, b.data(), ldb, 1,
+            out.data(), m);
+          for (size_t i = 0; i < out.size(); ++i) {
+          // The inputs are small integers, so every version is exact.
+          EXPECT_EQ(
+              static_cast<float>(out[i]), static_cast<float>(expected[i]))
+              << executorch::dispatch::cpu_capability_name(capability)
+              << " at " << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(BlasTest, GemmVersionsAgree) {
+  test_gemm_versions_agree<float>(executorch::cpublas::gemm_float_stub);
+  test_gemm_versions_agree<double>(executorch::cpublas::gemm_double_stub);
+  test_gemm_versions_agree<executorch::aten::Half>(
+      executorch::cpublas::gemm_half_stub);
+  test_gemm_versions_agree<executorch::aten::BFloat16>(
+      executorch::cpublas::gemm_bfloat16_stub);
+}
+
+template <typename CTYPE>
+void test_gemm_matches_reference(int64_t m, int64_t n, int64_t k) {
+  using executorch::cpublas::TransposeType;
+
+  std::vector<CTYPE> a(m * k);
+  std::vector<CTYPE> b(k * n);
+  std::vector<CTYPE> c_init(m * n);
+  // Small integers keep every product and partial sum exact in float, so
+  // the only rounding is the final conversion to CTYPE.
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<CTYPE>(static_cast<int>(i * 7 % 3) - 1);
+  }
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<CTYPE>(static_cast<int>(i * 5 % 3) - 1);
+  }
+  for (size_t i = 0; i < c_init.size(); ++i) {
+    c_init[i] = static_cast<CTYPE>(static_cast<int>(i % 5) - 2);
+  }
+
+  for (const bool transa : {false, true}) {
+    for (const bool transb : {false, true}) {
+      for (const float beta : {0.0f, 2.0f}) {
+        const int64_t lda = transa ? k : m;
+        const int64_t ldb = transb ? n : k;
+        const auto a_at = [&](int64_t i, int64_t l) {
+          return static_cast<double>(transa ? a[l + i * lda] : a[i + l * lda]);
+        };
+        const auto b_at = [&](int64_t l, int64_t j) {
+          return static_cast<double>(transb ? b[j + l * ldb] : b[l + j * ldb]);
+        };
+
+        std::vector<CTYPE> c = c_init;
+        // clang-format off
+        executorch::cpublas::gemm(
+            transa ? TransposeType::Transpose : TransposeType::NoTranspose,
+            transb ? TransposeType::Transpose : TransposeType::NoTranspose,
+            m, n, k,
+            static_cast<CTYPE>(3),
+            a.data(), lda,
+            b.data(), ldb,
+            static_cast<CTYPE>(beta),
+            c.data(), m);
+        // clang-format on
+
+        for (int64_t j = 0; j < n; ++j) {
+          for (int64_t i = 0; i < m; ++i) {
+            double dot = 0;
+            for (int64_t l = 0; l < k; ++l) {
+              dot += a_at(i, l) * b_at(l, j);
+            }
+            const double expected = 3 * dot +
+                (beta == 0.0f
+                     ? 0.0
+                     : beta * static_cast<double>(c_init[j * m + i]));
+            ASSERT_EQ(
+                static_cast<float>(c[j * m + i]),
+                static_cast<float>(static_cast<CTYPE>(expected)))
+                << "transa=" << transa << " transb=" << transb
+                << " beta=" << beta << " i=" << i << " j=" << j;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(BlasTest, GemmMatchesReference) {
+  // Both small shapes, which use the reference loops, and shapes that span
+  // several tiles and slices of the packed kernels.
+  for (const auto& shape : std::vector<std::array<int64_t, 3>>{
+           {5, 3, 4}, {17, 5, 9}, {33, 7, 64}, {150, 200, 300}}) {
+    test_gemm_matches_reference<float>(shape[0], shape[1], shape[2]);
+    test_gemm_matches_reference<executorch::aten::Half>(
+        shape[0], shape[1], shape[2]);
+    test_gemm_matches_reference<executorch::aten::BFloat16>(
+        shape[0], shape[1], shape[2]);
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/dispatch/cpu_capability.h>
+#include <executorch/kernels/optimized/dispatch/dispatch_stub.h>
+
+using executorch::dispatch::cpu_capability_name;
+using executorch::dispatch::cpu_supports;
+using executorch::dispatch::CPUCapability;
+using executorch::dispatch::DispatchStub;
+using executorch::dispatch::get_cpu_capability;
+
+namespace {
+
+using version_fn = CPUCapability (*)();
+
+CPUCapability default_version() {
+  return CPUCapability::DEFAULT;
+}
+
+CPUCapability avx2_version() {
+  return CPUCapability::AVX2;
+}
+
+CPUCapability avx512_version() {
+  return CPUCapability::AVX512;
+}
+
+CPUCapability sve256_version() {
+  return CPUCapability::SVE256;
+}
+
+const version_fn kDefault = &default_version;
+const version_fn kAVX2 = &avx2_version;
+const version_fn kAVX512 = &avx512_version;
+const version_fn kSVE256 = &sve256_version;
+
+bool at_least(CPUCapability capability) {
+  return cpu_supports(capability) &&
+      static_cast<int>(get_cpu_capability()) >= static_cast<int>(capability);
+}
+
+} // namespace
+
+TEST(CPUCapabilityTest, DetectsASupportedCapability) {
+  EXPECT_TRUE(cpu_supports(CPUCapability::DEFAULT));
+  EXPECT_TRUE(cpu_supports(get_cpu_capability()));
+  // Capabilities of other architectures are never supported.
+  EXPECT_FALSE(
+      cpu_supports(CPUCapability::AVX2) && cpu_supports(CPUCapability::SVE256));
+
+  EXPECT_STREQ(cpu_capability_name(CPUCapability::DEFAULT), "default");
+  EXPECT_STREQ(cpu_capability_name(CPUCapability::AVX2), "avx2");
+  EXPECT_STREQ(cpu_capability_name(CPUCapability::AVX512), "avx512");
+  EXPECT_STREQ(cpu_capability_name(CPUCapability::SVE256), "sve256");
+}
+
+TEST(DispatchStubTest, ChoosesTheBestSupportedVersion) {
+  DispatchStub<version_fn> all(&kDefault, &kAVX2, &kAVX512, &kSVE256);
+  EXPECT_EQ(all(), get_cpu_capability());
+  // The choice is cached.
+  EXPECT_EQ(all.choose(), all.choose());
+
+  // Without an AVX-512 version, AVX-512 CPUs fall back to AVX2.
+  DispatchStub<version_fn> no_avx512(&kDefault, &kAVX2, nullptr, nullptr);
+  EXPECT_EQ(
+      no_avx512(),
+      at_least(CPUCapability::AVX2) ? CPUCapability::AVX2
+                                    : CPUCapability::DEFAULT);
+
+  DispatchStub<version_fn> only_default(&kDefault, nullptr, nullptr, nullptr);
+  EXPECT_EQ(only_default(), CPUCapability::DEFAULT);
+}
+
+TEST(DispatchStubTest, GetSkipsMissingAndUnsupportedVersions) {
+  DispatchStub<version_fn> stub(&kDefault, &kAVX2, nullptr, &kSVE256);
+  EXPECT_EQ(stub.get(CPUCapability::DEFAULT), &default_version);
+  EXPECT_EQ(stub.get(CPUCapability::AVX512), nullptr);
+  EXPECT_EQ(
+      stub.get(CPUCapability::AVX2),
+      cpu_supports(CPUCapability::AVX2) ? &avx2_version : nullptr);
+  EXPECT_EQ(
+      stub.get(CPUCapability::SVE256),
+      cpu_supports(CPUCapability::SVE256) ? &sve256_version : nullptr);
+}
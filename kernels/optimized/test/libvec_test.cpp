@@ -10,7 +10,13 @@
 
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_convert.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_) \
@@ -72,3 +78,235 @@ void test_load_and_add() {
 TEST(VecFloatTest, LoadAndAdd) {
   TEST_FORALL_SUPPORTED_CTYPES(test_load_and_add);
 }
+
+// The tests below exercise the float specialization of whichever backend the
+// build selects (generic, AVX2, AVX-512, NEON or SVE), which is where the
+// backends differ the most.
+using VecF = executorch::vec::Vectorized<float>;
+
+TEST(VecFloatTest, PartialLoadAndStore) {
+  constexpr int64_t kVecSize = VecF::size();
+  std::vector<float> in(kVecSize);
+  fill_monotonic(in, 1);
+
+  for (int64_t count = 0; count <= kVecSize; ++count) {
+    std::vector<float> out(kVecSize, -1.f);
+    VecF::loadu(in.data(), count).store(out.data(), count);
+    for (int64_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], i < count ? in[i] : -1.f);
+    }
+
+    // Lanes past `count` are zeroed.
+    VecF::loadu(in.data(), count).store(out.data());
+    for (int64_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], i < count ? in[i] : 0.f);
+    }
+  }
+}
+
+TEST(VecFloatTest, SetAndBlend) {
+  constexpr int64_t kVecSize = VecF::size();
+  const VecF a(1.f);
+  const VecF b(2.f);
+  std::vector<float> out(kVecSize);
+
+  VecF::set(a, b, 3).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], i < 3 ? 2.f : 1.f);
+  }
+
+  VecF::blend<0x5>(a, b).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], i == 0 || i == 2 ? 2.f : 1.f);
+  }
+
+  const VecF index = VecF::arange(0.f, 1.f);
+  VecF::blendv(a, b, index < VecF(2.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], i < 2 ? 2.f : 1.f);
+  }
+}
+
+TEST(VecFloatTest, ComparisonsAndMasks) {
+  constexpr int64_t kVecSize = VecF::size();
+  std::vector<float> in(kVecSize);
+  fill_monotonic(in, -2);
+  const VecF x = VecF::loadu(in.data());
+
+  std::vector<float> out(kVecSize);
+  x.le(VecF(0.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], in[i] <= 0.f ? 1.f : 0.f);
+  }
+  x.ne(VecF(0.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], in[i] != 0.f ? 1.f : 0.f);
+  }
+  EXPECT_EQ(x.zero_mask(), 1 << 2);
+
+  in[1] = NAN;
+  const VecF with_nan = VecF::loadu(in.data());
+  (with_nan.isnan() & VecF(1.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], i == 1 ? 1.f : 0.f);
+  }
+
+  // maximum and minimum propagate NaN from either side.
+  executorch::vec::maximum(VecF(0.f), with_nan).store(out.data());
+  EXPECT_TRUE(std::isnan(out[1]));
+  EXPECT_EQ(out[0], 0.f);
+  executorch::vec::minimum(with_nan, VecF(0.f)).store(out.data());
+  EXPECT_TRUE(std::isnan(out[1]));
+  EXPECT_EQ(out[0], -2.f);
+}
+
+TEST(VecFloatTest, ArithmeticAndReduce) {
+  constexpr int64_t kVecSize = VecF::size();
+  const VecF index = VecF::arange(1.f, 1.f);
+  std::vector<float> out(kVecSize);
+
+  executorch::vec::fmadd(index, VecF(2.f), VecF(1.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], 2.f * (i + 1) + 1.f);
+  }
+  executorch::vec::fmsub(index, VecF(2.f), VecF(1.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], 2.f * (i + 1) - 1.f);
+  }
+  executorch::vec::clamp(index, VecF(2.f), VecF(4.f)).store(out.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], std::min(std::max(i + 1.f, 2.f), 4.f));
+  }
+
+  const float sum = executorch::vec::vec_reduce_all<float>(
+      [](const VecF& a, const VecF& b) { return a + b; }, index, kVecSize);
+  EXPECT_EQ(sum, kVecSize * (kVecSize + 1) / 2.f);
+  const float max = executorch::vec::vec_reduce_all<float>(
+      [](const VecF& a, const VecF& b) {
+        return executorch::vec::maximum(a, b);
+      },
+      index);
+  EXPECT_EQ(max, static_cast<float>(kVecSize));
+}
+
+namespace {
+
+// Values around the rounding boundaries of Half and BFloat16, and special
+// values.
+std::vector<float> conversion_test_values(size_t size) {
+  const float specials[] = {
+      0.f,
+      -0.f,
+      1.f,
+      1.00390625f, // A tie for BFloat16.
+      1.01171875f, // Another tie for BFloat16, rounding up.
+      1.00048828125f, // A tie for Half.
+      65504.f,
+      65520.f, // Overflows Half.
+      6.0e-8f, // Subnormal Half.
+      1.0e-40f, // Subnormal float.
+      std::numeric_limits<float>::infinity(),
+      -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::quiet_NaN(),
+      -3.3333333f,
+  };
+  std::vector<float> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = i < std::size(specials)
+        ? specials[i]
+        : static_cast<float>(i) * 1.37f - 100.f;
+  }
+  return values;
+}
+
+template <typename T>
+uint16_t bits(T x) {
+  uint16_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return b;
+}
+
+// Checks load_as_float() and store_from_float() against the scalar
+// conversions of T, a full vector at a time and for a partial vector.
+template <typename T>
+void test_convert() {
+  constexpr int64_t kVecSize = VecF::size();
+  const std::vector<float> values = conversion_test_values(3 * kVecSize);
+
+  for (int64_t begin = 0; begin < values.size(); begin += kVecSize) {
+    std::vector<T> converted(kVecSize);
+    executorch::vec::store_from_float(
+        VecF::loadu(values.data() + begin), converted.data());
+    for (int64_t i = 0; i < kVecSize; ++i) {
+      const T expected = static_cast<T>(values[begin + i]);
+      if (std::isnan(values[begin + i])) {
+        EXPECT_TRUE(std::isnan(static_cast<float>(converted[i])));
+      } else {
+        EXPECT_EQ(bits(converted[i]), bits(expected)) << values[begin + i];
+      }
+    }
+
+    std::vector<float> back(kVecSize);
+    executorch::vec::load_as_float(converted.data()).store(back.data());
+    for (int64_t i = 0; i < kVecSize; ++i) {
+      const float expected = static_cast<float>(converted[i]);
+      if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(back[i]));
+      } else {
+        EXPECT_EQ(back[i], expected);
+      }
+    }
+  }
+
+  const int64_t count = kVecSize / 2 + 1;
+  std::vector<T> partial(kVecSize, static_cast<T>(7.f));
+  executorch::vec::store_from_float(VecF(2.5f), partial.data(), count);
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(static_cast<float>(partial[i]), i < count ? 2.5f : 7.f);
+  }
+  std::vector<float> loaded(kVecSize);
+  executorch::vec::load_as_float(partial.data(), count).store(loaded.data());
+  for (int64_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(loaded[i], i < count ? 2.5f : 0.f);
+  }
+}
+
+} // namespace
+
+TEST(VecConvertTest, BFloat16) {
+  test_convert<executorch::aten::BFloat16>();
+}
+
+TEST(VecConvertTest, Half) {
+  test_convert<executorch::aten::Half>();
+}
+
+TEST(VecConvertTest, MapViaFloat) {
+  // Sizes with and without a partial last vector.
+  for (const int64_t size : {int64_t(3), int64_t(2 * VecF::size() + 5)}) {
+    std::vector<executorch::aten::BFloat16> a(size);
+    std::vector<executorch::aten::BFloat16> b(size);
+    for (int64_t i = 0; i < size; ++i) {
+      a[i] = static_cast<float>(i) * 0.75f;
+      b[i] = static_cast<float>(size - i);
+    }
+    std::vector<executorch::aten::BFloat16> out(size);
+    executorch::vec::map2_via_float<executorch::aten::BFloat16>(
+        [](VecF x, VecF y) { return x * y + VecF(1.f); },
+        out.data(),
+        a.data(),
+        b.data(),
+        size);
+    for (int64_t i = 0; i < size; ++i) {
+      const executorch::aten::BFloat16 expected =
+          static_cast<float>(a[i]) * static_cast<float>(b[i]) + 1.f;
+      EXPECT_EQ(bits(out[i]), bits(expected));
+    }
+
+    executorch::vec::map_via_float<executorch::aten::BFloat16>(
+        [](VecF x) { return x + x; }, out.data(), a.data(), size);
+    for (int64_t i = 0; i < size; ++i) {
+      EXPECT_EQ(static_cast<float>(out[i]), 2.f * static_cast<float>(a[i]));
+    }
+  }
+}
@@ -41,3 +41,4 @@ def define_common_targets():
     _lib_test_bin("libvec_test_bin")
     _lib_test_bin("moments_utils_test_bin", in_cpu = True)
     _lib_test_bin("libblas_test_bin")
+    _lib_test_bin("libdispatch_test_bin")
@@ -12,6 +12,7 @@
 // See Note [Do not compile initializers with AVX]
 
 #include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_convert.h>
 
 namespace executorch {
 namespace vec {
@@ -270,6 +271,52 @@ inline void map2(
   }
 }
 
+// Like map(), but vec_fun takes and returns Vectorized<float>, so that it can
+// be used for Half and BFloat16 (and float) data; see
+// Note [Reduced precision through float].
+template <typename scalar_t, typename Op>
+inline void map_via_float(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    int64_t size) {
+  using Vec = vec::Vectorized<float>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec output_vec = vec_fun(load_as_float(input_data + d));
+    store_from_float(output_vec, output_data + d);
+  }
+  if (size - d > 0) {
+    Vec output_vec = vec_fun(load_as_float(input_data + d, size - d));
+    store_from_float(output_vec, output_data + d, size - d);
+  }
+}
+
+// Like map2(), but vec_fun takes and returns Vectorized<float>; see
+// map_via_float().
+template <typename scalar_t, typename Op>
+inline void map2_via_float(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    const scalar_t* input_data2,
+    int64_t size) {
+  using Vec = vec::Vectorized<float>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec data_vec = load_as_float(input_data + d);
+    Vec data_vec2 = load_as_float(input_data2 + d);
+    Vec output_vec = vec_fun(data_vec, data_vec2);
+    store_from_float(output_vec, output_data + d);
+  }
+  if (size - d > 0) {
+    Vec data_vec = load_as_float(input_data + d, size - d);
+    Vec data_vec2 = load_as_float(input_data2 + d, size - d);
+    Vec output_vec = vec_fun(data_vec, data_vec2);
+    store_from_float(output_vec, output_data + d, size - d);
+  }
+}
+
 template <typename scalar_t, typename Op>
 inline void map3(
     const Op& vec_fun,
@@ -8,7 +8,13 @@
 
 #pragma once
 
+// Builds for AVX-512 define CPU_CAPABILITY_AVX512 instead of, not in addition
+// to, CPU_CAPABILITY_AVX2, so that Vectorized<T> has one width for every T.
+#if defined(CPU_CAPABILITY_AVX512)
+#include <executorch/kernels/optimized/vec/vec512/vec512.h>
+#else
 #include <executorch/kernels/optimized/vec/vec256/vec256.h>
+#endif
 
 namespace executorch {
 namespace vec {
@@ -17,6 +17,7 @@
 #if !(defined(__VSX__)  || defined(CPU_CAPABILITY_VSX) || defined(CPU_CAPABILITY_ZVECTOR))
 #include <executorch/kernels/optimized/vec/vec256/vec256_float.h>
 #include <executorch/kernels/optimized/vec/vec256/vec256_float_neon.h>
+#include <executorch/kernels/optimized/vec/vec256/vec256_float_sve.h>
 #include <executorch/kernels/optimized/vec/vec256/vec256_double.h>
 #include <executorch/kernels/optimized/vec/vec256/vec256_int.h>
 #endif
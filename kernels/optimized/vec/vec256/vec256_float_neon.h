@@ -15,7 +15,7 @@
 #include <executorch/kernels/optimized/vec/vec_base.h>
 
 
-#if defined(__aarch64__) && defined(ET_BUILD_ARM_VEC256_WITH_SLEEF)
+#if defined(__aarch64__) && !defined(CPU_CAPABILITY_SVE256) && defined(ET_BUILD_ARM_VEC256_WITH_SLEEF)
 #include <sleef.h>
 #endif
 
@@ -38,7 +38,7 @@ inline namespace CPU_CAPABILITY {
 //    https://github.com/android/ndk/issues/1248
 //    https://bugs.llvm.org/show_bug.cgi?id=45824
 // Most likely we will do aarch32 support with inline asm.
-#if defined(__aarch64__)
+#if defined(__aarch64__) && !defined(CPU_CAPABILITY_SVE256)
 
 #ifdef __BIG_ENDIAN__
 #error "Big endian is not supported."
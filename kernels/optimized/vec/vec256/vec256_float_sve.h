@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <executorch/kernels/optimized/vec/intrinsics.h>
+#include <executorch/kernels/optimized/vec/vec_base.h>
+
+#if defined(CPU_CAPABILITY_SVE256) && defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#if defined(ET_BUILD_ARM_VEC256_WITH_SLEEF)
+#include <sleef.h>
+#endif
+#endif
+
+namespace executorch {
+namespace vec {
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+// SVE registers have no size known at compile time, so they can't be class
+// members. Builds that define CPU_CAPABILITY_SVE256 must also pass
+// -msve-vector-bits=256, which fixes the register size to that of Graviton3
+// and Neoverse V1 and lets Vectorized<float> hold one register, like the AVX2
+// version. The result only runs on parts with 256-bit SVE. Only builds that
+// opt in with EXECUTORCH_BUILD_KERNELS_OPTIMIZED_SVE256 (CMake) or
+// executorch.optimized_sve256 (Buck) compile this version.
+#if defined(CPU_CAPABILITY_SVE256) && defined(__ARM_FEATURE_SVE)
+
+#if !defined(__ARM_FEATURE_SVE_BITS) || __ARM_FEATURE_SVE_BITS != 256
+#error "CPU_CAPABILITY_SVE256 requires -msve-vector-bits=256"
+#endif
+
+#ifdef __BIG_ENDIAN__
+#error "Big endian is not supported."
+#endif
+
+#if defined(ET_BUILD_ARM_VEC256_WITH_SLEEF)
+#define USE_SLEEF(sleef_code, non_sleef_code) sleef_code
+#else
+#define USE_SLEEF(sleef_code, non_sleef_code) non_sleef_code
+#endif
+
+typedef svfloat32_t vls_float32_t __attribute__((arm_sve_vector_bits(256)));
+
+template <> class Vectorized<float> {
+private:
+  vls_float32_t values;
+  // Expands a predicate into all-ones/all-zeros lanes, the mask format the
+  // rest of the library expects.
+  static svfloat32_t mask_to_vec(svbool_t mask) {
+    return svreinterpret_f32_u32(svdup_n_u32_z(mask, 0xFFFFFFFF));
+  }
+  Vectorized<float> map2(
+      const Vectorized<float>& other,
+      float (*const f)(float, float)) const {
+    __at_align__ float tmp[size()];
+    __at_align__ float tmp_other[size()];
+    store(tmp);
+    other.store(tmp_other);
+    for (size_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i], tmp_other[i]);
+    }
+    return loadu(tmp);
+  }
+public:
+  using value_type = float;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 8;
+  }
+  Vectorized() {}
+  Vectorized(svfloat32_t v) : values(v) {}
+  Vectorized(float val) : values(svdup_n_f32(val)) {}
+  Vectorized(float val0, float val1, float val2, float val3,
+         float val4, float val5, float val6, float val7) {
+    __at_align__ float vals[size()] = {val0, val1, val2, val3, val4, val5, val6, val7};
+    values = svld1_f32(svptrue_b32(), vals);
+  }
+  operator svfloat32_t() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<float> blend(const Vectorized<float>& a, const Vectorized<float>& b) {
+    __at_align__ int32_t flags[size()] = {
+        (mask & 0x01) != 0, (mask & 0x02) != 0, (mask & 0x04) != 0, (mask & 0x08) != 0,
+        (mask & 0x10) != 0, (mask & 0x20) != 0, (mask & 0x40) != 0, (mask & 0x80) != 0};
+    const svbool_t pg = svptrue_b32();
+    const svbool_t select = svcmpne_n_s32(pg, svld1_s32(pg, flags), 0);
+    return svsel_f32(select, b.values, a.values);
+  }
+  static Vectorized<float> blendv(const Vectorized<float>& a, const Vectorized<float>& b,
+                              const Vectorized<float>& mask) {
+    // NB: Like the NEON version, this requires each lane of the mask to be
+    // all zeros or all ones.
+    const svbool_t select = svcmpne_n_u32(
+        svptrue_b32(), svreinterpret_u32_f32(mask.values), 0);
+    return svsel_f32(select, b.values, a.values);
+  }
+  template<typename step_t>
+  static Vectorized<float> arange(float base = 0.f, step_t step = static_cast<step_t>(1)) {
+    const svbool_t pg = svptrue_b32();
+    const svfloat32_t index = svcvt_f32_s32_x(pg, svindex_s32(0, 1));
+    return svmad_f32_x(
+        pg, index, svdup_n_f32(static_cast<float>(step)), svdup_n_f32(base));
+  }
+  static Vectorized<float> set(const Vectorized<float>& a, const Vectorized<float>& b,
+                           int64_t count = size()) {
+    return svsel_f32(svwhilelt_b32_s64(0, count), b.values, a.values);
+  }
+  static Vectorized<float> loadu(const void* ptr, int64_t count = size()) {
+    // Inactive lanes are zeroed and their memory is not touched, so partial
+    // loads neither overrun the buffer nor see uninitialized values.
+    const svbool_t pg =
+        count == size() ? svptrue_b32() : svwhilelt_b32_s64(0, count);
+    return svld1_f32(pg, reinterpret_cast<const float*>(ptr));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    const svbool_t pg =
+        count == size() ? svptrue_b32() : svwhilelt_b32_s64(0, count);
+    svst1_f32(pg, reinterpret_cast<float*>(ptr), values);
+  }
+  const float& operator[](int idx) const  = delete;
+  float& operator[](int idx) = delete;
+  int zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit and others are translated to 0-bit
+    const svbool_t pg = svptrue_b32();
+    const svbool_t is_zero = svcmpeq_n_f32(pg, values, 0.f);
+    __at_align__ int32_t tmp[size()];
+    svst1_s32(pg, tmp, svdup_n_s32_z(is_zero, 1));
+    int mask = 0;
+    for (size_t i = 0; i < size(); ++i) {
+      mask |= tmp[i] << i;
+    }
+    return mask;
+  }
+  Vectorized<float> isnan() const {
+    return mask_to_vec(svcmpuo_f32(svptrue_b32(), values, values));
+  }
+  Vectorized<float> map(float (*const f)(float)) const {
+    __at_align__ float tmp[size()];
+    store(tmp);
+    for (size_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vectorized<float> abs() const {
+    return svabs_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> acos() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_acosfx_u10sve(values)), map(std::acos));
+  }
+  Vectorized<float> asin() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_asinfx_u10sve(values)), map(std::asin));
+  }
+  Vectorized<float> atan() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_atanfx_u10sve(values)), map(std::atan));
+  }
+  Vectorized<float> atan2(const Vectorized<float> &b) const {
+    return USE_SLEEF(
+        Vectorized<float>(Sleef_atan2fx_u10sve(values, b.values)),
+        map2(b, std::atan2));
+  }
+  Vectorized<float> copysign(const Vectorized<float> &sign) const {
+    const svbool_t pg = svptrue_b32();
+    const svuint32_t magnitude =
+        svand_n_u32_x(pg, svreinterpret_u32_f32(values), 0x7FFFFFFF);
+    const svuint32_t sign_bit =
+        svand_n_u32_x(pg, svreinterpret_u32_f32(sign.values), 0x80000000);
+    return svreinterpret_f32_u32(svorr_u32_x(pg, magnitude, sign_bit));
+  }
+  Vectorized<float> erf() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_erffx_u10sve(values)), map(std::erf));
+  }
+  Vectorized<float> erfc() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_erfcfx_u15sve(values)), map(std::erfc));
+  }
+  Vectorized<float> exp() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_expfx_u10sve(values)), map(std::exp));
+  }
+  Vectorized<float> exp2() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_exp2fx_u10sve(values)), map(std::exp2));
+  }
+  Vectorized<float> expm1() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_expm1fx_u10sve(values)), map(std::expm1));
+  }
+  Vectorized<float> fmod(const Vectorized<float>& q) const {
+    return USE_SLEEF(
+        Vectorized<float>(Sleef_fmodfx_sve(values, q.values)),
+        map2(q, std::fmod));
+  }
+  Vectorized<float> log() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_logfx_u10sve(values)), map(std::log));
+  }
+  Vectorized<float> log2() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_log2fx_u10sve(values)), map(std::log2));
+  }
+  Vectorized<float> log10() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_log10fx_u10sve(values)), map(std::log10));
+  }
+  Vectorized<float> log1p() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_log1pfx_u10sve(values)), map(std::log1p));
+  }
+  Vectorized<float> frac() const;
+  Vectorized<float> sin() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_sinfx_u10sve(values)), map(std::sin));
+  }
+  Vectorized<float> sinh() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_sinhfx_u10sve(values)), map(std::sinh));
+  }
+  Vectorized<float> cos() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_cosfx_u10sve(values)), map(std::cos));
+  }
+  Vectorized<float> cosh() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_coshfx_u10sve(values)), map(std::cosh));
+  }
+  Vectorized<float> ceil() const {
+    return svrintp_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> floor() const {
+    return svrintm_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> hypot(const Vectorized<float> &b) const {
+    return USE_SLEEF(
+        Vectorized<float>(Sleef_hypotfx_u05sve(values, b.values)),
+        map2(b, std::hypot));
+  }
+  Vectorized<float> neg() const {
+    return svneg_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> nextafter(const Vectorized<float> &b) const {
+    return USE_SLEEF(
+        Vectorized<float>(Sleef_nextafterfx_sve(values, b.values)),
+        map2(b, std::nextafter));
+  }
+  Vectorized<float> round() const {
+    // Round half to even, like _MM_FROUND_TO_NEAREST_INT.
+    return svrintn_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> tan() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_tanfx_u10sve(values)), map(std::tan));
+  }
+  Vectorized<float> tanh() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_tanhfx_u10sve(values)), map(std::tanh));
+  }
+  Vectorized<float> trunc() const {
+    return svrintz_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> lgamma() const {
+    return USE_SLEEF(Vectorized<float>(Sleef_lgammafx_u10sve(values)), map(std::lgamma));
+  }
+  Vectorized<float> sqrt() const {
+    return svsqrt_f32_x(svptrue_b32(), values);
+  }
+  Vectorized<float> reciprocal() const {
+    return svdiv_f32_x(svptrue_b32(), svdup_n_f32(1.f), values);
+  }
+  Vectorized<float> rsqrt() const {
+    const svbool_t pg = svptrue_b32();
+    return svdiv_f32_x(pg, svdup_n_f32(1.f), svsqrt_f32_x(pg, values));
+  }
+  Vectorized<float> pow(const Vectorized<float> &b) const {
+    return USE_SLEEF(
+        Vectorized<float>(Sleef_powfx_u10sve(values, b.values)),
+        map2(b, std::pow));
+  }
+  // Ordered comparisons are false if an operand is NaN, and != is true.
+  Vectorized<float> operator==(const Vectorized<float>& other) const {
+    return mask_to_vec(svcmpeq_f32(svptrue_b32(), values, other.values));
+  }
+
+  Vectorized<float> operator!=(const Vectorized<float>& other) const {
+    return mask_to_vec(svcmpne_f32(svptrue_b32(), values, other.values));
+  }
+
+  Vectorized<float> operator<(const Vectorized<float>& other) const {
+    return mask_to_vec(svcmplt_f32(svptrue_b32(), values, other.values));
+  }
+
+  Vectorized<float> operator<=(const Vectorized<float>& other) const {
+    return mask_to_vec(svcmple_f32(svptrue_b32(), values, other.values));
+  }
+
+  Vectorized<float> operator>(const Vectorized<float>& other) const {
+    return mask_to_vec(svcmpgt_f32(svptrue_b32(), values, other.values));
+  }
+
+  Vectorized<float> operator>=(const Vectorized<float>& other) const {
+    return mask_to_vec(svcmpge_f32(svptrue_b32(), values, other.values));
+  }
+
+  Vectorized<float> eq(const Vectorized<float>& other) const;
+  Vectorized<float> ne(const Vectorized<float>& other) const;
+  Vectorized<float> gt(const Vectorized<float>& other) const;
+  Vectorized<float> ge(const Vectorized<float>& other) const;
+  Vectorized<float> lt(const Vectorized<float>& other) const;
+  Vectorized<float> le(const Vectorized<float>& other) const;
+};
+
+template <>
+Vectorized<float> inline operator+(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svadd_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline operator-(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svsub_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline operator*(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svmul_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline operator/(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svdiv_f32_x(svptrue_b32(), a, b);
+}
+
+// frac. Implement this here so we can use subtraction
+inline Vectorized<float> Vectorized<float>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN. FMAX (unlike FMAXNM) already does.
+template <>
+Vectorized<float> inline maximum(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svmax_f32_x(svptrue_b32(), a, b);
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN. FMIN (unlike FMINNM) already does.
+template <>
+Vectorized<float> inline minimum(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svmin_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline clamp(const Vectorized<float>& a, const Vectorized<float>& min, const Vectorized<float>& max) {
+  return minimum(max, maximum(min, a));
+}
+
+template <>
+Vectorized<float> inline clamp_max(const Vectorized<float>& a, const Vectorized<float>& max) {
+  return minimum(max, a);
+}
+
+template <>
+Vectorized<float> inline clamp_min(const Vectorized<float>& a, const Vectorized<float>& min) {
+  return maximum(min, a);
+}
+
+template <>
+Vectorized<float> inline operator&(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svreinterpret_f32_u32(svand_u32_x(
+      svptrue_b32(), svreinterpret_u32_f32(a), svreinterpret_u32_f32(b)));
+}
+
+template <>
+Vectorized<float> inline operator|(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svreinterpret_f32_u32(svorr_u32_x(
+      svptrue_b32(), svreinterpret_u32_f32(a), svreinterpret_u32_f32(b)));
+}
+
+template <>
+Vectorized<float> inline operator^(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svreinterpret_f32_u32(sveor_u32_x(
+      svptrue_b32(), svreinterpret_u32_f32(a), svreinterpret_u32_f32(b)));
+}
+
+inline Vectorized<float> Vectorized<float>::eq(const Vectorized<float>& other) const {
+  return (*this == other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::ne(const Vectorized<float>& other) const {
+  return (*this != other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::gt(const Vectorized<float>& other) const {
+  return (*this > other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::ge(const Vectorized<float>& other) const {
+  return (*this >= other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::lt(const Vectorized<float>& other) const {
+  return (*this < other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::le(const Vectorized<float>& other) const {
+  return (*this <= other) & Vectorized<float>(1.0f);
+}
+
+template <>
+inline void convert(const float* src, float* dst, int64_t n) {
+  const svbool_t pg = svptrue_b32();
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vectorized<float>::size()); i += Vectorized<float>::size()) {
+    svst1_f32(pg, dst + i, svld1_f32(pg, src + i));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <>
+Vectorized<float> inline fmadd(const Vectorized<float>& a, const Vectorized<float>& b, const Vectorized<float>& c) {
+  // a * b + c
+  return svmad_f32_x(svptrue_b32(), a, b, c);
+}
+
+template <>
+Vectorized<float> inline fmsub(const Vectorized<float>& a, const Vectorized<float>& b, const Vectorized<float>& c) {
+  // a * b - c
+  return svnmsb_f32_x(svptrue_b32(), a, b, c);
+}
+
+#endif /* defined(CPU_CAPABILITY_SVE256) && defined(__ARM_FEATURE_SVE) */
+
+}}}
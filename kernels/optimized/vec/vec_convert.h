@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/portable_type/bfloat16.h>
+#include <executorch/runtime/core/portable_type/half.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace executorch {
+namespace vec {
+
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+// Note [Reduced precision through float]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// There is no Vectorized<Half> or Vectorized<BFloat16>. Kernels for these
+// types load Vectorized<float>::size() elements at a time converted to float,
+// compute in float, and round the result back once, which is also how the
+// portable kernels compute them. The conversions below use the conversion
+// instructions of the target when there are some, and are scalar otherwise.
+// The float overloads let the same code handle float tensors.
+
+inline Vectorized<float> load_as_float(const float* ptr) {
+  return Vectorized<float>::loadu(ptr);
+}
+
+inline void store_from_float(const Vectorized<float>& v, float* ptr) {
+  v.store(ptr);
+}
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+inline Vectorized<float> load_as_float(
+    const executorch::runtime::etensor::BFloat16* ptr) {
+  const __m512i bits = _mm512_cvtepu16_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 16));
+}
+
+inline void store_from_float(
+    const Vectorized<float>& v,
+    executorch::runtime::etensor::BFloat16* ptr) {
+  // Round to nearest even, like c10::BFloat16, and quiet NaNs as 0x7fc0.
+  const __m512 x = v;
+  const __m512i u = _mm512_castps_si512(x);
+  const __m512i lsb = _mm512_and_si512(
+      _mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+  const __m512i bias = _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff));
+  __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(u, bias), 16);
+  const __mmask16 nan = _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+  rounded = _mm512_mask_blend_epi32(nan, rounded, _mm512_set1_epi32(0x7fc0));
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(ptr), _mm512_cvtepi32_epi16(rounded));
+}
+
+inline Vectorized<float> load_as_float(
+    const executorch::runtime::etensor::Half* ptr) {
+  return _mm512_cvtph_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)));
+}
+
+inline void store_from_float(
+    const Vectorized<float>& v,
+    executorch::runtime::etensor::Half* ptr) {
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(ptr),
+      _mm512_cvtps_ph(__m512(v), _MM_FROUND_TO_NEAREST_INT));
+}
+
+#elif defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+inline Vectorized<float> load_as_float(
+    const executorch::runtime::etensor::BFloat16* ptr) {
+  const __m256i bits = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+}
+
+inline void store_from_float(
+    const Vectorized<float>& v,
+    executorch::runtime::etensor::BFloat16* ptr) {
+  // Round to nearest even, like c10::BFloat16, and quiet NaNs as 0x7fc0.
+  const __m256 x = v;
+  const __m256i u = _mm256_castps_si256(x);
+  const __m256i lsb = _mm256_and_si256(
+      _mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+  const __m256i bias = _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff));
+  __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(u, bias), 16);
+  const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+  rounded = _mm256_blendv_epi8(rounded, _mm256_set1_epi32(0x7fc0), nan);
+  // packus works within 128-bit lanes; gather the two useful quarters.
+  const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packus_epi32(rounded, rounded), 0x08);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(ptr), _mm256_castsi256_si128(packed));
+}
+
+inline Vectorized<float> load_as_float(
+    const executorch::runtime::etensor::Half* ptr) {
+  return _mm256_cvtph_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+inline void store_from_float(
+    const Vectorized<float>& v,
+    executorch::runtime::etensor::Half* ptr) {
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(ptr),
+      _mm256_cvtps_ph(__m256(v), _MM_FROUND_TO_NEAREST_INT));
+}
+
+#elif defined(__aarch64__) && !defined(CPU_CAPABILITY_SVE256)
+
+inline Vectorized<float> load_as_float(
+    const executorch::runtime::etensor::BFloat16* ptr) {
+  const uint16x8_t bits = vld1q_u16(reinterpret_cast<const uint16_t*>(ptr));
+  float32x4x2_t out;
+  out.val[0] = vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(bits), 16));
+  out.val[1] = vreinterpretq_f32_u32(vshll_n_u16(vget_high_u16(bits), 16));
+  return out;
+}
+
+namespace internal {
+
+// Round to nearest even, like c10::BFloat16, and quiet NaNs as 0x7fc0.
+inline uint16x4_t float_to_bfloat16_bits(float32x4_t x) {
+  const uint32x4_t u = vreinterpretq_u32_f32(x);
+  const uint32x4_t lsb = vandq_u32(vshrq_n_u32(u, 16), vdupq_n_u32(1));
+  const uint32x4_t bias = vaddq_u32(lsb, vdupq_n_u32(0x7fff));
+  const uint32x4_t rounded = vshrq_n_u32(vaddq_u32(u, bias), 16);
+  const uint32x4_t not_nan = vceqq_f32(x, x);
+  return vmovn_u32(vbslq_u32(not_nan, rounded, vdupq_n_u32(0x7fc0)));
+}
+
+} // namespace internal
+
+inline void store_from_float(
+    const Vectorized<float>& v,
+    executorch::runtime::etensor::BFloat16* ptr) {
+  const float32x4x2_t x = v;
+  vst1q_u16(
+      reinterpret_cast<uint16_t*>(ptr),
+      vcombine_u16(
+          internal::float_to_bfloat16_bits(x.val[0]),
+          internal::float_to_bfloat16_bits(x.val[1])));
+}
+
+inline Vectorized<float> load_as_float(
+    const executorch::runtime::etensor::Half* ptr) {
+  const float16x8_t h =
+      vreinterpretq_f16_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(ptr)));
+  float32x4x2_t out;
+  out.val[0] = vcvt_f32_f16(vget_low_f16(h));
+  out.val[1] = vcvt_high_f32_f16(h);
+  return out;
+}
+
+inline void store_from_float(
+    const Vectorized<float>& v,
+    executorch::runtime::etensor::Half* ptr) {
+  const float32x4x2_t x = v;
+  const float16x8_t h = vcvt_high_f16_f32(vcvt_f16_f32(x.val[0]), x.val[1]);
+  vst1q_u16(reinterpret_cast<uint16_t*>(ptr), vreinterpretq_u16_f16(h));
+}
+
+#else
+
+template <
+    typename T,
+    typename std::enable_if_t<
+        std::is_same_v<T, executorch::runtime::etensor::Half> ||
+            std::is_same_v<T, executorch::runtime::etensor::BFloat16>,
+        int> = 0>
+inline Vectorized<float> load_as_float(const T* ptr) {
+  __at_align__ float buffer[Vectorized<float>::size()];
+  for (int64_t i = 0; i < Vectorized<float>::size(); ++i) {
+    buffer[i] = static_cast<float>(ptr[i]);
+  }
+  return Vectorized<float>::loadu(buffer);
+}
+
+template <
+    typename T,
+    typename std::enable_if_t<
+        std::is_same_v<T, executorch::runtime::etensor::Half> ||
+            std::is_same_v<T, executorch::runtime::etensor::BFloat16>,
+        int> = 0>
+inline void store_from_float(const Vectorized<float>& v, T* ptr) {
+  __at_align__ float buffer[Vectorized<float>::size()];
+  v.store(buffer);
+  for (int64_t i = 0; i < Vectorized<float>::size(); ++i) {
+    ptr[i] = static_cast<T>(buffer[i]);
+  }
+}
+
+#endif
+
+/**
+ * Loads the first `count` elements at `ptr` converted to float, and zeros for
+ * the rest of the vector.
+ */
+template <typename T>
+inline Vectorized<float> load_as_float(const T* ptr, int64_t count) {
+  T buffer[Vectorized<float>::size()];
+  std::memset(buffer, 0, sizeof(buffer));
+  std::memcpy(buffer, ptr, count * sizeof(T));
+  return load_as_float(static_cast<const T*>(buffer));
+}
+
+/// Stores the first `count` elements of `v` converted to T at `ptr`.
+template <typename T>
+inline void
+store_from_float(const Vectorized<float>& v, T* ptr, int64_t count) {
+  T buffer[Vectorized<float>::size()];
+  store_from_float(v, static_cast<T*>(buffer));
+  std::memcpy(ptr, buffer, count * sizeof(T));
+}
+
+} // namespace CPU_CAPABILITY
+
+} // namespace vec
+} // namespace executorch
@@ -53,9 +53,10 @@ Tensor& add_out(
   ET_SWITCH_REALB_TYPES(compute_type, ctx, op_name, CTYPE_COMPUTE, [&]() {
     const CTYPE_COMPUTE val_alpha = utils::scalar_to<CTYPE_COMPUTE>(alpha);
     utils::apply_bitensor_elementwise_fn<CTYPE_COMPUTE, op_name>(
-        [val_alpha](const CTYPE_COMPUTE val_a, const CTYPE_COMPUTE val_b) {
-          return val_a + val_alpha * val_b;
-        },
+        utils::vectorizable([val_alpha](const auto val_a, const auto val_b) {
+          using T = decltype(val_b);
+          return val_a + T(val_alpha) * val_b;
+        }),
         ctx,
         a,
         utils::SupportedTensorDtypes::REALHBBF16,
@@ -43,18 +43,15 @@ Tensor& amax_out(
   ET_KERNEL_CHECK(
       ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
 
-  ReduceOverDimListPlan plan(in, dim_list);
   ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, "amax.out", CTYPE, [&]() {
+    using CTYPE_ACC = reduce_acc_type_t<CTYPE>;
     CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
-    const bool success = parallel_for_each_reduce_over_dim_list_output_index(
-        in, dim_list, out, [&](const auto begin, const auto end) {
-          for (const auto out_ix : c10::irange(begin, end)) {
-            out_data[out_ix] = plan.execute<CTYPE>(
-                [](CTYPE v, CTYPE max_v) {
-                  return std::isnan(v) || v > max_v ? v : max_v;
-                },
-                out_ix);
-          }
+    const bool success = parallel_reduce_over_dim_list<CTYPE, CTYPE_ACC>(
+        MaxReducer<CTYPE_ACC>(),
+        in,
+        dim_list,
+        [out_data](const size_t out_ix, const CTYPE_ACC max_v) {
+          out_data[out_ix] = static_cast<CTYPE>(max_v);
         });
     ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
   });
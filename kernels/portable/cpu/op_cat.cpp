@@ -56,6 +56,43 @@ Tensor& cat_out(
   const size_t ninputs = tensors.size();
 
   const auto out_type = out.scalar_type();
+
+  // Without dtype conversion, each input is a strided copy into out; this is
+  // the common case, e.g. when appending to a KV cache.
+  bool same_dtype = true;
+  for (size_t i = 0; i < ninputs; ++i) {
+    if (tensors[i].numel() != 0 && tensors[i].scalar_type() != out_type) {
+      same_dtype = false;
+      break;
+    }
+  }
+  if (same_dtype) {
+    const size_t element_size = out.element_size();
+    const size_t out_row_nbytes = out.size(dim) * dim_stride * element_size;
+    char* out_ptr = out.mutable_data_ptr<char>();
+    for (size_t j = 0; j < ninputs; ++j) {
+      if (tensors[j].numel() == 0) {
+        continue;
+      }
+      const size_t inner_nbytes =
+          tensors[j].size(dim) * dim_stride * element_size;
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          copy_chunks(
+              tensors[j].const_data_ptr(),
+              inner_nbytes,
+              out_ptr,
+              out_row_nbytes,
+              outer,
+              inner_nbytes),
+          Internal,
+          out,
+          "parallel_for failed");
+      out_ptr += inner_nbytes;
+    }
+    return out;
+  }
+
   ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "cat.out", CTYPE_OUT, [&] {
     CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
     for (size_t i = 0; i < outer; ++i) {
@@ -42,6 +42,23 @@ Tensor& log_softmax_out(
   // Adjust for negative dim
   dim = dim < 0 ? dim + nonzero_dim(in) : dim;
 
+  // Softmax over the innermost non-trivial dim of a contiguous tensor works
+  // on whole rows, which is vectorized and can split long rows between
+  // threads.
+  const auto shape = get_contiguous_reduce_shape(in, dim);
+  if (shape.has_value() && shape->inner_size == 1) {
+    ET_SWITCH_FLOATHBF16_TYPES(
+        in.scalar_type(), ctx, "_log_softmax.out", CTYPE, [&]() {
+          const bool success = softmax_over_contiguous_rows<CTYPE, true>(
+              in.const_data_ptr<CTYPE>(),
+              out.mutable_data_ptr<CTYPE>(),
+              shape->outer_size,
+              shape->reduce_size);
+          ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+        });
+    return out;
+  }
+
   ET_SWITCH_FLOATHBF16_TYPES(
       in.scalar_type(), ctx, "_log_softmax.out", CTYPE, [&]() {
         const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
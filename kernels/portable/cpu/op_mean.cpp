@@ -45,25 +45,19 @@ Tensor& mean_dim_out(
       InvalidArgument,
       out);
 
-  MapReduceOverDimListPlan plan(in, dim_list);
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "add.out";
   ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, op_name, CTYPE_IN, [&] {
     ET_SWITCH_FLOATHBF16_TYPES(out.scalar_type(), ctx, op_name, CTYPE_OUT, [&] {
+      using CTYPE_ACC = reduce_acc_type_t<CTYPE_OUT>;
       CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
-      const size_t num = get_reduced_dim_product(in, dim_list);
-      const bool success = parallel_for_each_reduce_over_dim_list_output_index(
-          in, dim_list, out, [&](const auto begin, const auto end) {
-            for (const auto out_ix : c10::irange(begin, end)) {
-              CTYPE_OUT sum = 0;
-              if (in.numel() > 0) {
-                sum = plan.execute<CTYPE_IN, CTYPE_OUT>(
-                    [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
-                    [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
-                    out_ix);
-              }
-              out_data[out_ix] = sum / static_cast<float>(num);
-            }
+      const CTYPE_ACC num = get_reduced_dim_product(in, dim_list);
+      const bool success = parallel_reduce_over_dim_list<CTYPE_IN, CTYPE_ACC>(
+          SumReducer<CTYPE_ACC>(),
+          in,
+          dim_list,
+          [out_data, num](const size_t out_ix, const CTYPE_ACC sum) {
+            out_data[out_ix] = static_cast<CTYPE_OUT>(sum / num);
           });
       ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
     });
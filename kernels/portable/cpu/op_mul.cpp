@@ -53,9 +53,9 @@ Tensor& mul_out(
 
   ET_SWITCH_REALB_TYPES(compute_type, ctx, op_name, CTYPE_COMPUTE, [&]() {
     utils::apply_bitensor_elementwise_fn<CTYPE_COMPUTE, op_name>(
-        [](const CTYPE_COMPUTE val_a, const CTYPE_COMPUTE val_b) {
+        utils::vectorizable([](const auto val_a, const auto val_b) {
           return val_a * val_b;
-        },
+        }),
         ctx,
         a,
         utils::SupportedTensorDtypes::REALHBBF16,
@@ -46,7 +46,12 @@ Tensor& narrow_copy_out(
       out);
 
   if (length != 0) {
-    compute_slice(in, dim, start, length, 1, out);
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        compute_slice(in, dim, start, length, 1, out),
+        Internal,
+        out,
+        "parallel_for failed");
   }
 
   return out;
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <tuple>
 
@@ -21,6 +22,54 @@ namespace native {
 using Tensor = executorch::aten::Tensor;
 using SizesType = executorch::aten::SizesType;
 
+namespace {
+
+/// The channels normalized together by the channels last loops.
+constexpr size_t kChannelBlock = 64;
+
+/**
+ * Normalizes a channels last input, whose C channels are its innermost dim
+ * and repeat at each of its positions. The parameters of a block of channels
+ * are looked up once and then applied at every position, so the input is
+ * read in contiguous runs of a block. channel_params(c, mean, invstd) sets
+ * the statistics of channel c.
+ */
+template <typename CTYPE, typename ChannelParamsFn>
+void normalize_channels_last(
+    const CTYPE* const in_data,
+    const size_t positions,
+    const size_t C,
+    const executorch::aten::optional<Tensor>& weight,
+    const executorch::aten::optional<Tensor>& bias,
+    const ChannelParamsFn& channel_params,
+    CTYPE* const out_data) {
+  CTYPE mean[kChannelBlock];
+  CTYPE invstd[kChannelBlock];
+  CTYPE weight_val[kChannelBlock];
+  CTYPE bias_val[kChannelBlock];
+  for (size_t c_begin = 0; c_begin < C; c_begin += kChannelBlock) {
+    const size_t block = std::min(kChannelBlock, C - c_begin);
+    for (size_t k = 0; k < block; ++k) {
+      const size_t c = c_begin + k;
+      channel_params(c, mean[k], invstd[k]);
+      weight_val[k] = weight.has_value()
+          ? weight.value().const_data_ptr<CTYPE>()[c]
+          : static_cast<CTYPE>(1);
+      bias_val[k] = bias.has_value() ? bias.value().const_data_ptr<CTYPE>()[c]
+                                     : static_cast<CTYPE>(0);
+    }
+    for (size_t p = 0; p < positions; ++p) {
+      const CTYPE* const x = in_data + p * C + c_begin;
+      CTYPE* const y = out_data + p * C + c_begin;
+      for (size_t k = 0; k < block; ++k) {
+        y[k] = (x[k] - mean[k]) * invstd[k] * weight_val[k] + bias_val[k];
+      }
+    }
+  }
+}
+
+} // namespace
+
 std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
     KernelRuntimeContext& ctx,
     const Tensor& in,
@@ -68,39 +117,12 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
       InvalidArgument,
       ret_val);
 
-  // For now, only support the contiguous dim order
-  ET_KERNEL_CHECK(
-      ctx,
-      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
-      InvalidArgument,
-      ret_val);
-
-  ET_KERNEL_CHECK(
-      ctx,
-      tensors_have_same_dim_order(in, out, mean_out, invstd_out),
-      InvalidArgument,
-      ret_val);
-
-  if (weight.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, weight.value()),
-        InvalidArgument,
-        ret_val);
-  }
-
-  if (bias.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, bias.value()),
-        InvalidArgument,
-        ret_val);
-  }
-
   size_t C_dim = in.dim() >= 1 ? 1 : 0;
   size_t C = in.size(C_dim);
   size_t outer = getLeadingDims(in, C_dim);
   size_t inner = getTrailingDims(in, C_dim);
+  const bool is_channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim_order().size());
 
   constexpr auto name = "native_batch_norm_legit_no_training.out";
 
@@ -111,6 +133,21 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
     const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
     const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
 
+    if (is_channels_last) {
+      normalize_channels_last(
+          in_data,
+          outer * inner,
+          C,
+          weight,
+          bias,
+          [&](const size_t c, CTYPE& mean, CTYPE& invstd) {
+            mean = mean_data[c];
+            invstd = 1.0 / std::sqrt(var_data[c] + eps);
+          },
+          out_data);
+      return;
+    }
+
     for (size_t i = 0; i < outer; ++i) {
       for (size_t c = 0; c < C; ++c) {
         CTYPE mean = mean_data[c];
@@ -206,40 +243,14 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
       InvalidArgument,
       ret_val);
 
-  ET_KERNEL_CHECK(
-      ctx,
-      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
-      InvalidArgument,
-      ret_val);
-
-  ET_KERNEL_CHECK(
-      ctx,
-      tensors_have_same_dim_order(in, out, mean_out, invstd_out),
-      InvalidArgument,
-      ret_val);
-
-  if (weight.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, weight.value()),
-        InvalidArgument,
-        ret_val);
-  }
-
-  if (bias.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, bias.value()),
-        InvalidArgument,
-        ret_val);
-  }
-
   ET_KERNEL_CHECK(ctx, in.dim() >= 2, InvalidArgument, ret_val);
 
   size_t N = in.size(0);
   size_t C = in.size(1);
   size_t inner = getTrailingDims(in, 1);
   size_t elements_per_channel = N * inner;
+  const bool is_channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim_order().size());
 
   ET_KERNEL_CHECK(
       ctx,
@@ -268,16 +279,26 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
     CTYPE* invstd_data = invstd_out.mutable_data_ptr<CTYPE>();
 
     // Compute sum and sum of squares for each channel
-    for (size_t b = 0; b < N; ++b) {
-      const CTYPE* b_in_data = in_data + b * C * inner;
-      for (size_t c = 0; c < C; ++c) {
-        const CTYPE* x = b_in_data + c * inner;
+    if (is_channels_last) {
+      for (size_t p = 0; p < elements_per_channel; ++p) {
+        const CTYPE* x = in_data + p * C;
+        for (size_t c = 0; c < C; ++c) {
+          mean_data[c] += x[c];
+          invstd_data[c] += x[c] * x[c];
+        }
+      }
+    } else {
+      for (size_t b = 0; b < N; ++b) {
+        const CTYPE* b_in_data = in_data + b * C * inner;
+        for (size_t c = 0; c < C; ++c) {
+          const CTYPE* x = b_in_data + c * inner;
 
-        CTYPE sum = reduce_add(x, inner);
-        CTYPE sq_sum = vec_powerf(x, inner);
+          CTYPE sum = reduce_add(x, inner);
+          CTYPE sq_sum = vec_powerf(x, inner);
 
-        mean_data[c] += sum;
-        invstd_data[c] += sq_sum;
+          mean_data[c] += sum;
+          invstd_data[c] += sq_sum;
+        }
       }
     }
 
@@ -293,6 +314,21 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
       invstd_data[c] = invstd;
     }
 
+    if (is_channels_last) {
+      normalize_channels_last(
+          in_data,
+          elements_per_channel,
+          C,
+          weight,
+          bias,
+          [&](const size_t c, CTYPE& mean, CTYPE& invstd) {
+            mean = mean_data[c];
+            invstd = invstd_data[c];
+          },
+          out_data);
+      return;
+    }
+
     for (size_t i = 0; i < N; ++i) {
       for (size_t c = 0; c < C; ++c) {
         CTYPE mean = mean_data[c];
@@ -7,6 +7,7 @@
  */
 #include <c10/util/irange.h>
 
+#include <executorch/kernels/portable/cpu/selective_build.h>
 #include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
 #include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -68,27 +69,31 @@ void layer_norm(
   }
 
   const CTYPE ct_normalized = static_cast<CTYPE>(normalized);
-  for (const auto i : c10::irange(leading)) {
-    const CTYPE* x = input_data + i * normalized;
-    CTYPE* y = out_data + i * normalized;
-
-    // compute E[X] and Var[x] = E[x^2] - E[x]^2
-    CTYPE sum = reduce_add(x, ct_normalized);
-    CTYPE sq_sum = vec_powerf(x, ct_normalized);
-    CTYPE mean_value = sum / ct_normalized;
-    CTYPE variance = sq_sum / ct_normalized - mean_value * mean_value;
-    CTYPE std = std::sqrt(variance + eps);
-
-    // Calculate the elements of output
-    for (const auto j : c10::irange(normalized)) {
-      CTYPE w = weight_data ? weight_data[j] : static_cast<CTYPE>(1);
-      CTYPE b = bias_data ? bias_data[j] : static_cast<CTYPE>(0);
-      y[j] = (x[j] - mean_value) / std * w + b;
-    }
-
-    mean_data[i] = mean_value;
-    rstd_data[i] = 1.0 / std;
-  }
+  // With a static size, the loop over the elements of a row can be unrolled.
+  ET_SPECIALIZE_STATIC_INNER_SIZE(
+      "native_layer_norm.out", normalized, row_size, [&]() {
+        for (const auto i : c10::irange(leading)) {
+          const CTYPE* x = input_data + i * row_size;
+          CTYPE* y = out_data + i * row_size;
+
+          // compute E[X] and Var[x] = E[x^2] - E[x]^2
+          CTYPE sum = reduce_add(x, ct_normalized);
+          CTYPE sq_sum = vec_powerf(x, ct_normalized);
+          CTYPE mean_value = sum / ct_normalized;
+          CTYPE variance = sq_sum / ct_normalized - mean_value * mean_value;
+          CTYPE std = std::sqrt(variance + eps);
+
+          // Calculate the elements of output
+          for (size_t j = 0; j < row_size; ++j) {
+            CTYPE w = weight_data ? weight_data[j] : static_cast<CTYPE>(1);
+            CTYPE b = bias_data ? bias_data[j] : static_cast<CTYPE>(0);
+            y[j] = (x[j] - mean_value) / std * w + b;
+          }
+
+          mean_data[i] = mean_value;
+          rstd_data[i] = 1.0 / std;
+        }
+      });
 }
 
 } // namespace
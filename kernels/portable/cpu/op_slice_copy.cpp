@@ -55,7 +55,12 @@ Tensor& slice_copy_Tensor_out(
       InvalidArgument,
       out);
 
-  compute_slice(in, dim, start, length, step, out);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      compute_slice(in, dim, start, length, step, out),
+      Internal,
+      out,
+      "parallel_for failed");
 
   return out;
 }
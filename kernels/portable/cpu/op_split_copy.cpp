@@ -58,6 +58,30 @@ void split_copy_Tensor_out(
   ScalarType in_type = input.scalar_type();
   ScalarType out_type = out[0].scalar_type();
 
+  // Without dtype conversion, each chunk is a strided copy out of input.
+  if (in_type == out_type) {
+    const size_t element_size = input.element_size();
+    const char* input_data = input.const_data_ptr<char>();
+    for (size_t i = 0, e = out.size(); i < e; ++i) {
+      const size_t out_step_nbytes =
+          out[i].size(dim) * trailing_dims * element_size;
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          copy_chunks(
+              input_data,
+              step * element_size,
+              out[i].mutable_data_ptr(),
+              out_step_nbytes,
+              leading_dims,
+              out_step_nbytes),
+          Internal,
+          ,
+          "parallel_for failed");
+      input_data += out_step_nbytes;
+    }
+    return;
+  }
+
   ET_SWITCH_REALHBBF16_TYPES(
       in_type, ctx, "split_copy.Tensor_out", CTYPE_IN, [&]() {
         ET_SWITCH_REALHBBF16_TYPES(
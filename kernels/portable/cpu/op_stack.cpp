@@ -55,6 +55,36 @@ Tensor& stack_out(
   const size_t ninputs = tensors.size();
 
   const auto out_type = out.scalar_type();
+
+  // Without dtype conversion, each input is a strided copy into out.
+  bool same_dtype = true;
+  for (size_t i = 0; i < ninputs; ++i) {
+    if (tensors[i].scalar_type() != out_type) {
+      same_dtype = false;
+      break;
+    }
+  }
+  if (same_dtype) {
+    const size_t inner_nbytes = inner * out.element_size();
+    char* out_ptr = out.mutable_data_ptr<char>();
+    for (size_t j = 0; j < ninputs; ++j) {
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          copy_chunks(
+              tensors[j].const_data_ptr(),
+              inner_nbytes,
+              out_ptr,
+              ninputs * inner_nbytes,
+              outer,
+              inner_nbytes),
+          Internal,
+          out,
+          "parallel_for failed");
+      out_ptr += inner_nbytes;
+    }
+    return out;
+  }
+
   ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "stack.out", CTYPE_OUT, [&] {
     CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
     for (size_t i = 0; i < outer; ++i) {
@@ -11,8 +11,6 @@
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
-#include <optional>
-
 namespace torch {
 namespace executor {
 namespace native {
@@ -46,27 +44,18 @@ Tensor& sum_dim_out(
 
   ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
 
-  std::optional<MapReduceOverDimListPlan> plan;
-  if (in.numel() > 0) {
-    plan.emplace(in, dim_list);
-  }
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "sum.IntList_out";
   ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, op_name, CTYPE_IN, [&] {
     ET_SWITCH_REALHBBF16_TYPES(out.scalar_type(), ctx, op_name, CTYPE_OUT, [&] {
+      using CTYPE_ACC = reduce_acc_type_t<CTYPE_OUT>;
       CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
-      const bool success = parallel_for_each_reduce_over_dim_list_output_index(
-          in, dim_list, out, [&](const auto begin, const auto end) {
-            for (const auto out_ix : c10::irange(begin, end)) {
-              CTYPE_OUT sum = 0;
-              if (plan.has_value()) {
-                sum = plan->execute<CTYPE_IN, CTYPE_OUT>(
-                    [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
-                    [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
-                    out_ix);
-              }
-              out_data[out_ix] = sum;
-            }
+      const bool success = parallel_reduce_over_dim_list<CTYPE_IN, CTYPE_ACC>(
+          SumReducer<CTYPE_ACC>(),
+          in,
+          dim_list,
+          [out_data](const size_t out_ix, const CTYPE_ACC sum) {
+            out_data[out_ix] = static_cast<CTYPE_OUT>(sum);
           });
       ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
     });
@@ -10,6 +10,7 @@
 #include <cmath>
 #include <tuple>
 
+#include <executorch/kernels/portable/cpu/util/index_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -17,40 +18,6 @@ namespace executor {
 namespace native {
 namespace {
 
-bool check_topk_args(
-    const Tensor& in,
-    int64_t k,
-    int64_t dim,
-    Tensor& values,
-    Tensor& indices) {
-  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, values));
-  ET_LOG_AND_RETURN_IF_FALSE(indices.scalar_type() == ScalarType::Long);
-  ET_LOG_AND_RETURN_IF_FALSE(tensor_has_dim(in, dim));
-  if (dim < 0) {
-    dim += nonzero_dim(in);
-  }
-  ET_CHECK_OR_RETURN_FALSE(
-      k >= 0 && k <= nonempty_size(in, dim), "selected index k out of range");
-  return true;
-}
-
-bool get_topk_target_size(
-    const Tensor& in,
-    int64_t k,
-    int64_t dim,
-    Tensor::SizesType* target_size,
-    size_t* target_dim) {
-  *target_dim = in.dim();
-  for (const auto i : c10::irange(*target_dim)) {
-    if (static_cast<int64_t>(i) == dim) {
-      target_size[i] = k;
-    } else {
-      target_size[i] = in.size(i);
-    }
-  }
-  return true;
-}
-
 template <typename T>
 bool float_less_than(T x, T y) {
   if constexpr (std::is_integral_v<T>) {
@@ -165,7 +132,7 @@ std::tuple<Tensor&, Tensor&> topk_values(
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   Tensor::SizesType target_size[kTensorDimensionLimit];
   size_t target_dim = 0;
-  get_topk_target_size(in, k, dim, target_size, &target_dim);
+  get_topk_out_target_size(in, k, dim, target_size, &target_dim);
 
   ET_KERNEL_CHECK(
       ctx,
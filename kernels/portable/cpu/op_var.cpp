@@ -19,6 +19,18 @@ namespace executor {
 namespace native {
 namespace {
 
+/// Sums the squares of the differences between the elements and `mean`.
+template <typename CTYPE_ACC>
+struct SquaredDeviationReducer : SumReducer<CTYPE_ACC> {
+  CTYPE_ACC mean;
+
+  template <typename T>
+  T map(const T& v) const {
+    const T deviation = v - T(mean);
+    return deviation * deviation;
+  }
+};
+
 template <typename CTYPE_IN, typename CTYPE_OUT>
 void compute_variance(
     KernelRuntimeContext& ctx,
@@ -32,6 +44,33 @@ void compute_variance(
     for (const auto out_ix : c10::irange(out.numel())) {
       out_data[out_ix] = NAN;
     }
+    return;
+  }
+
+  const auto shape = get_contiguous_reduce_shape(in, dim_list);
+  if (shape.has_value() && shape->inner_size == 1) {
+    // Each output element reduces a contiguous row of the input.
+    using CTYPE_ACC = reduce_acc_type_t<CTYPE_OUT>;
+    const CTYPE_IN* const in_data = in.const_data_ptr<CTYPE_IN>();
+    const bool success = parallel_for_each_reduce_row(
+        out.numel(), num, [&](const int64_t out_ix) {
+          const CTYPE_IN* const row = in_data + out_ix * num;
+          CTYPE_ACC sum;
+          if (!parallel_vectorized_reduce<CTYPE_IN, CTYPE_ACC>(
+                  SumReducer<CTYPE_ACC>(), row, num, sum)) {
+            return false;
+          }
+          const SquaredDeviationReducer<CTYPE_ACC> deviation_reducer{
+              {}, sum / static_cast<CTYPE_ACC>(num)};
+          CTYPE_ACC sum2;
+          if (!parallel_vectorized_reduce<CTYPE_IN, CTYPE_ACC>(
+                  deviation_reducer, row, num, sum2)) {
+            return false;
+          }
+          out_data[out_ix] = static_cast<CTYPE_OUT>(sum2 / denominator);
+          return true;
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
   } else {
     MapReduceOverDimListPlan plan(in, dim_list);
     const bool success = parallel_for_each_reduce_over_dim_list_output_index(
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 
 #ifdef EXECUTORCH_SELECTIVE_BUILD_DTYPE
@@ -24,6 +28,15 @@ inline constexpr bool should_include_kernel_dtype(
 }
 #endif
 
+#ifndef EXECUTORCH_SELECTIVE_BUILD_STATIC_SIZES
+// dummy implementation: no operator has a static size
+inline constexpr int64_t kernel_static_inner_size(
+    const char* /*operator_name*/
+) {
+  return 0;
+}
+#endif
+
 namespace torch {
 namespace executor {
 #define ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type)               \
@@ -38,6 +51,30 @@ namespace executor {
     }                                                              \
   } while (0)
 
+/**
+ * Runs the lambda in __VA_ARGS__ with SIZE_ALIAS bound to SIZE. When the
+ * model this lib was selectively built for always calls OP_NAME with the same
+ * inner size (see gen_oplist.py --include_static_sizes) and SIZE matches it,
+ * SIZE_ALIAS is a std::integral_constant, so that loops over it have a trip
+ * count known at compile time and can be unrolled. Otherwise, and in regular
+ * builds, it is a size_t.
+ *
+ * OP_NAME must be a constant expression, like the name passed to ET_SWITCH.
+ */
+#define ET_SPECIALIZE_STATIC_INNER_SIZE(OP_NAME, SIZE, SIZE_ALIAS, ...)     \
+  [&]() {                                                                  \
+    constexpr int64_t et_static_size = kernel_static_inner_size(OP_NAME); \
+    if constexpr (et_static_size > 0) {                                   \
+      if (static_cast<int64_t>(SIZE) == et_static_size) {                 \
+        constexpr std::integral_constant<size_t, et_static_size>          \
+            SIZE_ALIAS{};                                                 \
+        return __VA_ARGS__();                                             \
+      }                                                                   \
+    }                                                                     \
+    const size_t SIZE_ALIAS = SIZE;                                       \
+    return __VA_ARGS__();                                                 \
+  }()
+
 } // namespace executor
 } // namespace torch
 
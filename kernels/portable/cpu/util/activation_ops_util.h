@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <cmath>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -31,5 +35,85 @@ bool check_softmax_args(
 
 Error resize_glu_out(const Tensor& in, int64_t dim, Tensor& out);
 
+namespace internal {
+/// Sums exp(x - max) for softmax.
+template <typename CTYPE_ACC>
+struct ExpSumReducer : SumReducer<CTYPE_ACC> {
+  CTYPE_ACC max;
+
+  template <typename T>
+  T map(const T& v) const {
+    if constexpr (std::is_same_v<T, CTYPE_ACC>) {
+      return std::exp(v - max);
+    } else {
+      return (v - T(max)).exp();
+    }
+  }
+};
+} // namespace internal
+
+/**
+ * Computes softmax, or log_softmax if kLog, over each of the num_rows
+ * contiguous rows of row_size elements at in_data, accumulating Half and
+ * BFloat16 in float. Returns false if parallel_for failed.
+ */
+template <typename CTYPE, bool kLog>
+[[nodiscard]] bool softmax_over_contiguous_rows(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t num_rows,
+    int64_t row_size) {
+  using CTYPE_ACC = reduce_acc_type_t<CTYPE>;
+  return parallel_for_each_reduce_row(
+      num_rows, row_size, [&](const int64_t row) {
+        const CTYPE* const row_in = in_data + row * row_size;
+        CTYPE* const row_out = out_data + row * row_size;
+        // Subtract the maximum before calling exp to preserve numerical
+        // stability.
+        CTYPE_ACC max_in;
+        if (!parallel_vectorized_reduce<CTYPE, CTYPE_ACC>(
+                MaxReducer<CTYPE_ACC>(), row_in, row_size, max_in)) {
+          return false;
+        }
+        CTYPE_ACC sum;
+        if (!parallel_vectorized_reduce<CTYPE, CTYPE_ACC>(
+                internal::ExpSumReducer<CTYPE_ACC>{{}, max_in},
+                row_in,
+                row_size,
+                sum)) {
+          return false;
+        }
+        const CTYPE_ACC log_sum = std::log(sum);
+        return executorch::extension::parallel_for(
+            0,
+            row_size,
+            executorch::extension::internal::GRAIN_SIZE,
+            [&](const auto begin, const auto end) {
+              int64_t i = begin;
+              if constexpr (std::is_same_v<CTYPE, CTYPE_ACC>) {
+                using Vec = executorch::vec::Vectorized<CTYPE_ACC>;
+                const Vec max_vec(max_in);
+                const Vec sum_vec(sum);
+                const Vec log_sum_vec(log_sum);
+                for (; i + static_cast<int64_t>(Vec::size()) <= end;
+                     i += Vec::size()) {
+                  const Vec shifted = Vec::loadu(row_in + i) - max_vec;
+                  if constexpr (kLog) {
+                    (shifted - log_sum_vec).store(row_out + i);
+                  } else {
+                    (shifted.exp() / sum_vec).store(row_out + i);
+                  }
+                }
+              }
+              for (; i < end; ++i) {
+                const CTYPE_ACC shifted =
+                    static_cast<CTYPE_ACC>(row_in[i]) - max_in;
+                row_out[i] = static_cast<CTYPE>(
+                    kLog ? shifted - log_sum : std::exp(shifted) / sum);
+              }
+            });
+      });
+}
+
 } // namespace executor
 } // namespace torch
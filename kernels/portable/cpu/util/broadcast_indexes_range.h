@@ -21,6 +21,38 @@
 namespace torch::executor {
 
 namespace internal {
+using BroadcastShapeType =
+    std::array<std::size_t, executorch::runtime::kTensorDimensionLimit>;
+
+/**
+ * Returns the strides of t, padded with leading dims to output.dim() and with
+ * 0 wherever t is broadcast along a dim of the output.
+ */
+inline BroadcastShapeType effective_input_broadcast_stride(
+    const Tensor& output,
+    const Tensor& t) {
+  BroadcastShapeType result = {0};
+  ET_CHECK_MSG(
+      t.dim() <= output.dim(),
+      "input to broadcasting op should have dim at most output dim, but %d > %d!",
+      (int)t.dim(),
+      (int)output.dim());
+
+  const auto num_leading_ones = output.dim() - t.dim();
+  for (const auto idx : c10::irange(num_leading_ones)) {
+    result[idx] = 0;
+  }
+  const auto t_sizes = t.sizes();
+  const auto t_strides = t.strides();
+  for (const auto idx :
+       c10::irange(num_leading_ones, num_leading_ones + t.dim())) {
+    result[idx] = t_sizes[idx - num_leading_ones] == 1
+        ? 0
+        : t_strides[idx - num_leading_ones];
+  }
+  return result;
+}
+
 template <std::size_t kNumInputs>
 class BroadcastIndexesIterator {
  public:
@@ -154,8 +186,7 @@ class BroadcastIndexesIterator {
   }
 
  private:
-  using ShapeType =
-      std::array<std::size_t, executorch::runtime::kTensorDimensionLimit>;
+  using ShapeType = BroadcastShapeType;
 
   ssize_t output_index() const {
     return current_indexes_[0];
@@ -165,31 +196,6 @@ class BroadcastIndexesIterator {
     return current_indexes_[0];
   }
 
-  ShapeType effective_input_broadcast_stride(
-      const Tensor& output,
-      const Tensor& t) const {
-    ShapeType result = {0};
-    ET_CHECK_MSG(
-        t.dim() <= output.dim(),
-        "input to broadcasting op should have dim at most output dim, but %d > %d!",
-        (int)t.dim(),
-        (int)output.dim());
-
-    const auto num_leading_ones = output.dim() - t.dim();
-    for (const auto idx : c10::irange(num_leading_ones)) {
-      result[idx] = 0;
-    }
-    const auto t_sizes = t.sizes();
-    const auto t_strides = t.strides();
-    for (const auto idx :
-         c10::irange(num_leading_ones, num_leading_ones + t.dim())) {
-      result[idx] = t_sizes[idx - num_leading_ones] == 1
-          ? 0
-          : t_strides[idx - num_leading_ones];
-    }
-    return result;
-  }
-
   // The 0th entry is the current linear index into the output,
   // followed by kNumInputs input indexes.
   std::array<ssize_t, kNumInputs + 1> current_indexes_ = {0};
@@ -250,4 +256,262 @@ class BroadcastIndexesRange {
  private:
   std::array<const Tensor*, kNumInputs + 1> tensors_;
 };
+
+/**
+ * A run of output elements whose input elements are also evenly spaced:
+ * element k of the block, for k in [0, size), is at
+ * indexes[0] + k in the output and at
+ * indexes[i] + k * strides[i] in input i - 1.
+ * strides[0] is always 1, and an input that is broadcast along the run has
+ * stride 0.
+ */
+template <std::size_t kNumInputs>
+struct BroadcastIndexesBlock {
+  std::array<ssize_t, kNumInputs + 1> indexes = {0};
+  std::array<ssize_t, kNumInputs + 1> strides = {0};
+  ssize_t size = 0;
+};
+
+namespace internal {
+/**
+ * The output shape of a broadcast with adjacent dims merged wherever every
+ * tensor can step through both of them with a single stride, as in
+ * TensorIterator::coalesce_dimensions(). The innermost merged dim becomes
+ * the blocks of BroadcastIndexesBlockRange; the rest are the outer dims.
+ */
+template <std::size_t kNumInputs>
+struct BroadcastBlockShape {
+  BroadcastBlockShape() = default;
+
+  template <typename... Args>
+  explicit BroadcastBlockShape(const Tensor& output, const Args&... args) {
+    const ssize_t ndim = output.dim();
+    // As in BroadcastIndexesIterator, tensors with the output's sizes are
+    // indexed like the output.
+    const bool no_broadcasting = ((args.sizes() == output.sizes()) && ...);
+    std::array<BroadcastShapeType, kNumInputs + 1> strides;
+    strides[0] = {0};
+    for (ssize_t i = ndim - 1, stride = 1; i >= 0; --i) {
+      strides[0][i] = stride;
+      stride *= output.size(i);
+    }
+    if (no_broadcasting) {
+      std::fill(strides.begin() + 1, strides.end(), strides[0]);
+    } else {
+      size_t input = 1;
+      ((strides[input++] = effective_input_broadcast_stride(output, args)),
+       ...);
+    }
+
+    // Merge from the innermost dim outwards, skipping size-1 dims, which
+    // never move any index.
+    std::array<ssize_t, executorch::runtime::kTensorDimensionLimit> sizes;
+    std::array<
+        std::array<ssize_t, kNumInputs + 1>,
+        executorch::runtime::kTensorDimensionLimit>
+        merged_strides;
+    ssize_t num_dims = 0;
+    for (ssize_t i = ndim - 1; i >= 0; --i) {
+      const ssize_t size = output.size(i);
+      if (size == 1) {
+        continue;
+      }
+      bool mergeable = num_dims > 0;
+      for (size_t t = 0; mergeable && t < kNumInputs + 1; ++t) {
+        mergeable = static_cast<ssize_t>(strides[t][i]) ==
+            merged_strides[num_dims - 1][t] * sizes[num_dims - 1];
+      }
+      if (mergeable) {
+        sizes[num_dims - 1] *= size;
+        continue;
+      }
+      sizes[num_dims] = size;
+      for (size_t t = 0; t < kNumInputs + 1; ++t) {
+        merged_strides[num_dims][t] = strides[t][i];
+      }
+      num_dims++;
+    }
+
+    if (num_dims == 0) {
+      // A single element, or none.
+      inner_size = output.numel();
+      return;
+    }
+    inner_size = sizes[0];
+    inner_strides = merged_strides[0];
+    num_outer_dims = num_dims - 1;
+    for (ssize_t d = 0; d < num_outer_dims; ++d) {
+      outer_sizes[d] = sizes[num_dims - 1 - d];
+      outer_strides[d] = merged_strides[num_dims - 1 - d];
+    }
+  }
+
+  ssize_t inner_size = 0;
+  std::array<ssize_t, kNumInputs + 1> inner_strides = {0};
+  // Outermost first.
+  ssize_t num_outer_dims = 0;
+  std::array<ssize_t, executorch::runtime::kTensorDimensionLimit> outer_sizes =
+      {0};
+  std::array<
+      std::array<ssize_t, kNumInputs + 1>,
+      executorch::runtime::kTensorDimensionLimit>
+      outer_strides = {};
+};
+
+template <std::size_t kNumInputs>
+class BroadcastIndexesBlockIterator {
+ public:
+  using difference_type = ssize_t;
+  using value_type = BroadcastIndexesBlock<kNumInputs>;
+  using reference = const value_type&;
+  using pointer = const value_type*;
+  using iterator_category = std::forward_iterator_tag;
+
+  BroadcastIndexesBlockIterator() = default;
+
+  /// Starts at output index `begin` of a loop that stops at output index
+  /// `end`. The first block is cut short if begin is not at the start of
+  /// one.
+  BroadcastIndexesBlockIterator(
+      const BroadcastBlockShape<kNumInputs>* shape,
+      ssize_t begin,
+      ssize_t end)
+      : shape_(shape), end_(end) {
+    if (begin >= end) {
+      block_.indexes[0] = end;
+      return;
+    }
+    inner_offset_ = begin % shape_->inner_size;
+    ssize_t outer_index = begin / shape_->inner_size;
+    for (ssize_t d = shape_->num_outer_dims - 1; d >= 0; --d) {
+      outer_index_[d] = outer_index % shape_->outer_sizes[d];
+      outer_index /= shape_->outer_sizes[d];
+    }
+    block_.strides = shape_->inner_strides;
+    for (size_t t = 0; t < kNumInputs + 1; ++t) {
+      block_.indexes[t] = inner_offset_ * shape_->inner_strides[t];
+      for (ssize_t d = 0; d < shape_->num_outer_dims; ++d) {
+        block_.indexes[t] += outer_index_[d] * shape_->outer_strides[d][t];
+      }
+    }
+    block_.size = std::min(shape_->inner_size - inner_offset_, end - begin);
+  }
+
+  bool operator==(const BroadcastIndexesBlockIterator& rhs) const {
+    return block_.indexes[0] == rhs.block_.indexes[0];
+  }
+
+  bool operator!=(const BroadcastIndexesBlockIterator& rhs) const {
+    return !operator==(rhs);
+  }
+
+  reference operator*() const {
+    return block_;
+  }
+
+  pointer operator->() const {
+    return &block_;
+  }
+
+  BroadcastIndexesBlockIterator& operator++() {
+    // Every block but the last runs to the end of its row; go back to the
+    // start of the row, then carry into the outer dims.
+    const ssize_t next_output_index =
+        block_.indexes[0] - inner_offset_ + shape_->inner_size;
+    if (next_output_index >= end_) {
+      block_.indexes[0] = end_;
+      return *this;
+    }
+    for (size_t t = 0; t < kNumInputs + 1; ++t) {
+      block_.indexes[t] -= inner_offset_ * shape_->inner_strides[t];
+    }
+    inner_offset_ = 0;
+    for (ssize_t d = shape_->num_outer_dims - 1; d >= 0; --d) {
+      if (outer_index_[d] == shape_->outer_sizes[d] - 1) {
+        for (size_t t = 0; t < kNumInputs + 1; ++t) {
+          block_.indexes[t] -= outer_index_[d] * shape_->outer_strides[d][t];
+        }
+        outer_index_[d] = 0;
+      } else {
+        outer_index_[d]++;
+        for (size_t t = 0; t < kNumInputs + 1; ++t) {
+          block_.indexes[t] += shape_->outer_strides[d][t];
+        }
+        break;
+      }
+    }
+    block_.size = std::min(shape_->inner_size, end_ - next_output_index);
+    return *this;
+  }
+
+  BroadcastIndexesBlockIterator operator++(int) {
+    auto it = *this;
+    operator++();
+    return it;
+  }
+
+ private:
+  const BroadcastBlockShape<kNumInputs>* shape_ = nullptr;
+  ssize_t end_ = 0;
+  value_type block_;
+  // Position of the block's first element within its row.
+  ssize_t inner_offset_ = 0;
+  std::array<ssize_t, executorch::runtime::kTensorDimensionLimit>
+      outer_index_ = {0};
+};
+} // namespace internal
+
+/**
+ * Like BroadcastIndexesRange, but yields BroadcastIndexesBlock runs of
+ * elements instead of one element at a time, so that the caller's inner loop
+ * needs no index math and can be vectorized when the strides are 0 or 1:
+ *
+ * for (const auto& block : BroadcastIndexesBlockRange<2>(output, a, b)) {
+ *   for (ssize_t k = 0; k < block.size; ++k) {
+ *     output_data[block.indexes[0] + k] = fn(
+ *         a_data[block.indexes[1] + k * block.strides[1]],
+ *         b_data[block.indexes[2] + k * block.strides[2]]);
+ *   }
+ * }
+ *
+ * Dims are merged where possible, so inputs with the output's sizes give
+ * blocks as long as the output, and a bias add like [B, S, H] + [H] gives
+ * blocks of H elements with unit strides. Use slice() to split the work
+ * between threads. Iterators refer to the range, which must outlive them.
+ */
+template <std::size_t kNumInputs>
+class BroadcastIndexesBlockRange {
+ public:
+  using iterator = internal::BroadcastIndexesBlockIterator<kNumInputs>;
+
+  template <typename... Args>
+  BroadcastIndexesBlockRange(const Tensor& output, const Args&... args)
+      : shape_(output, args...), begin_(0), end_(output.numel()) {
+    static_assert(
+        sizeof...(args) == kNumInputs && (std::is_same_v<Args, Tensor> && ...),
+        "BroadcastIndexesBlockRange constructor requires kNumInputs input "
+        "tensor arguments!");
+  }
+
+  /// Returns the blocks covering output indexes [begin, end).
+  BroadcastIndexesBlockRange slice(ssize_t begin, ssize_t end) const {
+    auto result = *this;
+    result.begin_ = begin;
+    result.end_ = end;
+    return result;
+  }
+
+  iterator begin() const {
+    return iterator(&shape_, begin_, end_);
+  }
+
+  iterator end() const {
+    return iterator(&shape_, end_, end_);
+  }
+
+ private:
+  internal::BroadcastBlockShape<kNumInputs> shape_;
+  ssize_t begin_;
+  ssize_t end_;
+};
 } // namespace torch::executor
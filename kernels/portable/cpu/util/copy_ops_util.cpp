@@ -7,11 +7,13 @@
  */
 
 #include <c10/util/irange.h>
+#include <algorithm>
 #include <cstring>
 
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -36,6 +38,56 @@ size_t as_strided_copy_compute_storage_nbytes(
   return size * itemsize_bytes;
 }
 
+// Copies smaller than this are not worth splitting across threads.
+constexpr size_t kMinParallelCopyNbytes = 256 * 1024;
+
+// The fixed size lets the compiler turn each memcpy into plain loads and
+// stores, which matters when chunks are a few elements, e.g. for cat along
+// the last dim.
+template <size_t N>
+void copy_fixed_size_chunks(
+    const char* src,
+    size_t src_stride_nbytes,
+    char* dst,
+    size_t dst_stride_nbytes,
+    size_t begin,
+    size_t end) {
+  for (const auto i : c10::irange(begin, end)) {
+    std::memcpy(dst + i * dst_stride_nbytes, src + i * src_stride_nbytes, N);
+  }
+}
+
+void copy_chunk_range(
+    const char* src,
+    size_t src_stride_nbytes,
+    char* dst,
+    size_t dst_stride_nbytes,
+    size_t chunk_nbytes,
+    size_t begin,
+    size_t end) {
+  switch (chunk_nbytes) {
+#define COPY_FIXED_SIZE_CHUNKS(n)                                    \
+  case n:                                                            \
+    copy_fixed_size_chunks<n>(                                       \
+        src, src_stride_nbytes, dst, dst_stride_nbytes, begin, end); \
+    return;
+    COPY_FIXED_SIZE_CHUNKS(1)
+    COPY_FIXED_SIZE_CHUNKS(2)
+    COPY_FIXED_SIZE_CHUNKS(4)
+    COPY_FIXED_SIZE_CHUNKS(8)
+    COPY_FIXED_SIZE_CHUNKS(16)
+    COPY_FIXED_SIZE_CHUNKS(32)
+#undef COPY_FIXED_SIZE_CHUNKS
+    default:
+      for (const auto i : c10::irange(begin, end)) {
+        std::memcpy(
+            dst + i * dst_stride_nbytes,
+            src + i * src_stride_nbytes,
+            chunk_nbytes);
+      }
+  }
+}
+
 } // namespace
 
 bool check_as_strided_copy_args(
@@ -1005,5 +1057,52 @@ void get_unfold_copy_out_target_size(
   *out_ndim = self.dim() + 1;
 }
 
+bool copy_chunks(
+    const void* src,
+    size_t src_stride_nbytes,
+    void* dst,
+    size_t dst_stride_nbytes,
+    size_t num_chunks,
+    size_t chunk_nbytes) {
+  if (num_chunks == 0 || chunk_nbytes == 0) {
+    return true;
+  }
+  const char* const src_bytes = static_cast<const char*>(src);
+  char* const dst_bytes = static_cast<char*>(dst);
+
+  // Chunks that follow each other in both buffers are one big chunk.
+  if (num_chunks == 1 ||
+      (src_stride_nbytes == chunk_nbytes &&
+       dst_stride_nbytes == chunk_nbytes)) {
+    const size_t nbytes = num_chunks * chunk_nbytes;
+    const size_t num_tasks =
+        (nbytes + kMinParallelCopyNbytes - 1) / kMinParallelCopyNbytes;
+    return ::executorch::extension::parallel_for(
+        0, num_tasks, 1, [&](const auto begin, const auto end) {
+          const size_t begin_byte = begin * kMinParallelCopyNbytes;
+          const size_t end_byte =
+              std::min<size_t>(end * kMinParallelCopyNbytes, nbytes);
+          std::memcpy(
+              dst_bytes + begin_byte,
+              src_bytes + begin_byte,
+              end_byte - begin_byte);
+        });
+  }
+
+  const int64_t grain_size =
+      std::max<size_t>(1, kMinParallelCopyNbytes / chunk_nbytes);
+  return ::executorch::extension::parallel_for(
+      0, num_chunks, grain_size, [&](const auto begin, const auto end) {
+        copy_chunk_range(
+            src_bytes,
+            src_stride_nbytes,
+            dst_bytes,
+            dst_stride_nbytes,
+            chunk_nbytes,
+            begin,
+            end);
+      });
+}
+
 } // namespace executor
 } // namespace torch
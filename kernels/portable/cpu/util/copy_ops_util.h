@@ -247,5 +247,25 @@ void get_unfold_copy_out_target_size(
     executorch::aten::SizesType* out_sizes,
     size_t* out_ndim);
 
+/**
+ * Copies `num_chunks` chunks of `chunk_nbytes` bytes, where chunk i starts
+ * at `src + i * src_stride_nbytes` and is copied to
+ * `dst + i * dst_stride_nbytes`. This is the copy that cat, stack, split and
+ * slice perform between tensors of the same dtype.
+ *
+ * Consecutive chunks that are contiguous in both buffers are copied with a
+ * single memcpy, large copies are split across threads, and small chunks are
+ * copied with fixed-size copies rather than calls to memcpy.
+ *
+ * @returns false if parallel_for() failed, true otherwise.
+ */
+bool copy_chunks(
+    const void* src,
+    size_t src_stride_nbytes,
+    void* dst,
+    size_t dst_stride_nbytes,
+    size_t num_chunks,
+    size_t chunk_nbytes);
+
 } // namespace executor
 } // namespace torch
@@ -9,13 +9,16 @@
 #pragma once
 
 #include <c10/util/irange.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/util/broadcast_indexes_range.h>
 #include <executorch/kernels/portable/cpu/util/broadcast_util.h>
 #include <executorch/kernels/portable/cpu/util/dtype_util.h>
 #include <executorch/runtime/kernel/kernel_runtime_context.h>
 #include <executorch/runtime/kernel/thread_parallel_interface.h>
 
+#include <algorithm>
 #include <array>
+#include <type_traits>
 #include <utility>
 
 namespace torch {
@@ -50,7 +53,124 @@ inline int64_t scalar_to<int64_t>(const Scalar& s) {
                              : s.to<int64_t>();
 }
 
+/**
+ * Wraps a compute function that is also valid for
+ * executorch::vec::Vectorized<CTYPE_COMPUTE> arguments, e.g. a generic lambda
+ * that only uses arithmetic operators. When the inputs have the output's
+ * dtype, the apply_*_elementwise_fn() helpers below then compute floating
+ * point ops a whole vector at a time:
+ *
+ *   utils::apply_bitensor_elementwise_fn<CTYPE_COMPUTE, op_name>(
+ *       utils::vectorizable(
+ *           [](const auto val_a, const auto val_b) { return val_a * val_b; }),
+ *       ...);
+ */
+template <typename Op>
+struct Vectorizable {
+  Op op;
+
+  template <typename... Args>
+  auto operator()(const Args&... args) const {
+    return op(args...);
+  }
+};
+
+template <typename Op>
+Vectorizable<Op> vectorizable(Op op) {
+  return Vectorizable<Op>{std::move(op)};
+}
+
 namespace internal {
+
+template <typename Op>
+struct is_vectorizable : std::false_type {};
+
+template <typename Op>
+struct is_vectorizable<Vectorizable<Op>> : std::true_type {};
+
+/**
+ * Returns true if every input has the same dtype as the output, so that
+ * apply_elementwise_fn_same_dtype() can be used.
+ */
+template <typename... Args>
+inline bool inputs_have_same_dtype_as_out(const Tensor& out, Args... inputs) {
+  return ((inputs.first->scalar_type() == out.scalar_type()) && ...);
+}
+
+/**
+ * The fast path of apply_elementwise_fn(), for inputs and output that all
+ * hold CTYPE_IO: values are converted to CTYPE_COMPUTE directly rather than
+ * through the load/store function pointers, and the loop runs over
+ * BroadcastIndexesBlockRange blocks. Blocks in which every input is either
+ * contiguous or broadcast, such as every block of a same-shape op or of a
+ * [B, S, H] + [H] bias add, are computed a vector at a time.
+ */
+template <
+    typename CTYPE_COMPUTE,
+    typename CTYPE_IO,
+    typename Op,
+    typename... Args>
+inline void apply_elementwise_fn_same_dtype(
+    const Op& compute_fun,
+    const Tensor& out,
+    Args... inputs) {
+  constexpr auto kNumInputs = sizeof...(inputs);
+  const std::array<const CTYPE_IO*, kNumInputs> inputs_data = {
+      inputs.first->template const_data_ptr<CTYPE_IO>()...};
+  CTYPE_IO* const data_out = out.mutable_data_ptr<CTYPE_IO>();
+  const auto blocks =
+      BroadcastIndexesBlockRange<kNumInputs>(out, (*inputs.first)...);
+
+  ::executorch::extension::parallel_for(
+      0,
+      out.numel(),
+      ::executorch::extension::internal::GRAIN_SIZE,
+      [&](const auto begin, const auto end) {
+        for (const auto& block : blocks.slice(begin, end)) {
+          CTYPE_IO* const block_out = data_out + block.indexes[0];
+          std::array<const CTYPE_IO*, kNumInputs> block_inputs;
+          for (const auto i : c10::irange(kNumInputs)) {
+            block_inputs[i] = inputs_data[i] + block.indexes[i + 1];
+          }
+          ssize_t k = 0;
+          if constexpr (
+              is_vectorizable<Op>::value &&
+              std::is_same_v<CTYPE_IO, CTYPE_COMPUTE> &&
+              std::is_floating_point_v<CTYPE_COMPUTE>) {
+            using Vec = ::executorch::vec::Vectorized<CTYPE_COMPUTE>;
+            const bool vectorize = std::all_of(
+                block.strides.begin() + 1,
+                block.strides.end(),
+                [](const ssize_t stride) {
+                  return stride == 0 || stride == 1;
+                });
+            if (vectorize) {
+              for (; k + Vec::size() <= block.size; k += Vec::size()) {
+                std::array<Vec, kNumInputs> loaded_inputs;
+                for (const auto i : c10::irange(kNumInputs)) {
+                  loaded_inputs[i] = block.strides[i + 1] == 0
+                      ? Vec(block_inputs[i][0])
+                      : Vec::loadu(block_inputs[i] + k);
+                }
+                const Vec result = std::apply(compute_fun, loaded_inputs);
+                result.store(block_out + k);
+              }
+            }
+          }
+          for (; k < block.size; ++k) {
+            std::array<CTYPE_COMPUTE, kNumInputs> loaded_inputs;
+            for (const auto i : c10::irange(kNumInputs)) {
+              loaded_inputs[i] = static_cast<CTYPE_COMPUTE>(
+                  block_inputs[i][k * block.strides[i + 1]]);
+            }
+            const CTYPE_COMPUTE result =
+                std::apply(compute_fun, loaded_inputs);
+            block_out[k] = static_cast<CTYPE_IO>(result);
+          }
+        }
+      });
+}
+
 template <
     typename CTYPE_COMPUTE,
     const char* op_name,
@@ -77,6 +197,29 @@ inline void apply_elementwise_fn(
           internal::check_tensor_dtype(out, out_dtypes, compute_type),
       InvalidArgument, );
 
+  if (inputs_have_same_dtype_as_out(out, inputs...)) {
+    if (out.scalar_type() == compute_type) {
+      apply_elementwise_fn_same_dtype<CTYPE_COMPUTE, CTYPE_COMPUTE>(
+          compute_fun, out, inputs...);
+      return;
+    }
+    // Reduced-precision floating point ops compute in float; see
+    // get_compute_type().
+    if constexpr (std::is_same_v<CTYPE_COMPUTE, float>) {
+      if (out.scalar_type() == ScalarType::Half) {
+        apply_elementwise_fn_same_dtype<CTYPE_COMPUTE, executorch::aten::Half>(
+            compute_fun, out, inputs...);
+        return;
+      }
+      if (out.scalar_type() == ScalarType::BFloat16) {
+        apply_elementwise_fn_same_dtype<
+            CTYPE_COMPUTE,
+            executorch::aten::BFloat16>(compute_fun, out, inputs...);
+        return;
+      }
+    }
+  }
+
   struct InputInfo {
     load_to_compute_fn<CTYPE_COMPUTE> load_to_compute;
     const char* data_ptr;
@@ -95,27 +238,29 @@ inline void apply_elementwise_fn(
   char* const data_out = reinterpret_cast<char*>(out.mutable_data_ptr());
   const auto out_element_size = out.element_size();
 
+  const auto blocks =
+      BroadcastIndexesBlockRange<kNumInputs>(out, (*inputs.first)...);
+
   ::executorch::extension::parallel_for(
       0,
       out.numel(),
       ::executorch::extension::internal::GRAIN_SIZE,
       [&](const auto begin, const auto end) {
-        const auto range =
-            BroadcastIndexesRange<kNumInputs>(out, (*inputs.first)...);
-        auto begin_it = range.begin();
-        begin_it += begin;
-        for (; (*begin_it)[0] < end; ++begin_it) {
-          const auto& indexes = *begin_it;
-          std::array<CTYPE_COMPUTE, kNumInputs> loaded_inputs;
-          for (const auto idx : c10::irange(kNumInputs)) {
-            const auto& input_info = inputs_info[idx];
-            loaded_inputs[idx] = input_info.load_to_compute(
-                &input_info
-                     .data_ptr[indexes[idx + 1] * input_info.element_size]);
+        for (const auto& block : blocks.slice(begin, end)) {
+          for (ssize_t k = 0; k < block.size; ++k) {
+            std::array<CTYPE_COMPUTE, kNumInputs> loaded_inputs;
+            for (const auto idx : c10::irange(kNumInputs)) {
+              const auto& input_info = inputs_info[idx];
+              const auto index =
+                  block.indexes[idx + 1] + k * block.strides[idx + 1];
+              loaded_inputs[idx] = input_info.load_to_compute(
+                  &input_info.data_ptr[index * input_info.element_size]);
+            }
+            auto result = std::apply(compute_fun, loaded_inputs);
+            store_compute_to_out(
+                result,
+                &data_out[(block.indexes[0] + k) * out_element_size]);
           }
-          auto result = std::apply(compute_fun, loaded_inputs);
-          store_compute_to_out(
-              result, &data_out[indexes[0] * out_element_size]);
         }
       });
 }
@@ -262,5 +262,38 @@ bool check_select_scatter_args(
   return true;
 }
 
+bool check_topk_args(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    Tensor& values,
+    Tensor& indices) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, values));
+  ET_LOG_AND_RETURN_IF_FALSE(indices.scalar_type() == ScalarType::Long);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_has_dim(in, dim));
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+  ET_CHECK_OR_RETURN_FALSE(
+      k >= 0 && k <= nonempty_size(in, dim), "selected index k out of range");
+  return true;
+}
+
+void get_topk_out_target_size(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    executorch::aten::SizesType* out_sizes,
+    size_t* out_ndim) {
+  *out_ndim = in.dim();
+  for (const auto i : c10::irange(*out_ndim)) {
+    if (static_cast<int64_t>(i) == dim) {
+      out_sizes[i] = k;
+    } else {
+      out_sizes[i] = in.size(i);
+    }
+  }
+}
+
 } // namespace executor
 } // namespace torch
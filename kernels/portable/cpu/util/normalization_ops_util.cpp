@@ -70,6 +70,11 @@ bool check_batch_norm_args(
         tensors_have_same_size_at_dims(running_var.value(), 0, in, C_dim));
   }
 
+  // in and out may be contiguous or channels last. The parameter tensors are
+  // 1-D, so their dim order is always the default one.
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_or_channels_last_dim_order(in));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dim_order(in, out));
+
   return true;
 }
 
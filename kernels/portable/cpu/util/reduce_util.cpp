@@ -11,6 +11,7 @@
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/assert.h>
 #include <cstring>
+#include <optional>
 
 namespace torch {
 namespace executor {
@@ -210,6 +211,60 @@ size_t get_init_index(
   return init_ix;
 }
 
+std::optional<ContiguousReduceShape> get_contiguous_reduce_shape(
+    const Tensor& in,
+    const executorch::aten::optional<executorch::aten::ArrayRef<int64_t>>&
+        dim_list) {
+  const bool reduce_all = !dim_list.has_value() || dim_list.value().empty();
+  ContiguousReduceShape shape = {1, 1, 1};
+  // Whether we are before, within or after the reduced dims.
+  enum class Position { kOuter, kReduce, kInner } position = Position::kOuter;
+  int64_t expected_stride = 1;
+  for (ssize_t d = in.dim() - 1; d >= 0; --d) {
+    const size_t size = in.size(d);
+    if (size == 1) {
+      continue;
+    }
+    if (in.strides()[d] != expected_stride) {
+      return std::nullopt;
+    }
+    expected_stride *= size;
+  }
+  for (const auto d : c10::irange(in.dim())) {
+    const size_t size = in.size(d);
+    if (size == 1) {
+      continue;
+    }
+    if (reduce_all || check_dim_in_dim_list(d, in.dim(), dim_list.value())) {
+      if (position == Position::kInner) {
+        return std::nullopt;
+      }
+      position = Position::kReduce;
+      shape.reduce_size *= size;
+    } else if (position == Position::kOuter) {
+      shape.outer_size *= size;
+    } else {
+      position = Position::kInner;
+      shape.inner_size *= size;
+    }
+  }
+  return shape;
+}
+
+std::optional<ContiguousReduceShape> get_contiguous_reduce_shape(
+    const Tensor& in,
+    const executorch::aten::optional<int64_t>& dim) {
+  if (!dim.has_value()) {
+    return get_contiguous_reduce_shape(
+        in, executorch::aten::optional<executorch::aten::ArrayRef<int64_t>>());
+  }
+  const int64_t dim_value = dim.value();
+  return get_contiguous_reduce_shape(
+      in,
+      executorch::aten::optional<executorch::aten::ArrayRef<int64_t>>(
+          executorch::aten::ArrayRef<int64_t>(&dim_value, 1)));
+}
+
 //
 // Resize out tensor of reduction op
 //
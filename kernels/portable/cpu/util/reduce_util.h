@@ -8,11 +8,20 @@
 
 #pragma once
 
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <optional>
 #include <tuple>
+#include <type_traits>
 
 namespace torch {
 namespace executor {
@@ -244,6 +253,32 @@ void apply_over_dim(
 
   const size_t size = in.size(d);
   const size_t stride = in.strides()[d];
+
+  // The loops below assume contiguous strides. Otherwise, e.g. for channels
+  // last, find the first element of each reduction from its coordinates.
+  size_t contiguous_stride = 1;
+  bool is_contiguous = true;
+  for (size_t i = in.dim(); i > 0; --i) {
+    is_contiguous = is_contiguous &&
+        static_cast<size_t>(in.strides()[i - 1]) == contiguous_stride;
+    contiguous_stride *= in.size(i - 1);
+  }
+  if (!is_contiguous) {
+    const size_t num_reductions = in.numel() / size;
+    for (size_t reduction = 0; reduction < num_reductions; ++reduction) {
+      size_t remaining = reduction;
+      size_t base = 0;
+      for (size_t i = in.dim(); i > 0; --i) {
+        if (i - 1 != d) {
+          base += remaining % in.size(i - 1) * in.strides()[i - 1];
+          remaining /= in.size(i - 1);
+        }
+      }
+      fn(size, stride, base);
+    }
+    return;
+  }
+
   const size_t outer_size = getLeadingDims(in, d);
   const size_t outer_stride = size * stride;
   // Loop through all outer dimensions
@@ -858,5 +893,467 @@ template <typename Func>
   return executorch::extension::parallel_for(0, out.numel(), grain_size, func);
 }
 
+//
+// Vectorized, multithreaded reductions
+//
+
+/**
+ * The shape of a reduction over a contiguous tensor whose reduced dims,
+ * ignoring dims of size 1, are adjacent: the input is then
+ * [outer_size, reduce_size, inner_size], and the output, in order, is
+ * [outer_size, inner_size].
+ */
+struct ContiguousReduceShape {
+  size_t outer_size;
+  size_t reduce_size;
+  size_t inner_size;
+};
+
+/**
+ * Returns the ContiguousReduceShape of reducing `in` over `dim_list`, or
+ * nullopt if `in` isn't contiguous or the reduced dims aren't adjacent. As
+ * elsewhere in this file, an empty or missing dim_list reduces over all dims.
+ */
+std::optional<ContiguousReduceShape> get_contiguous_reduce_shape(
+    const executorch::aten::Tensor& in,
+    const executorch::aten::optional<executorch::aten::ArrayRef<int64_t>>&
+        dim_list);
+
+std::optional<ContiguousReduceShape> get_contiguous_reduce_shape(
+    const executorch::aten::Tensor& in,
+    const executorch::aten::optional<int64_t>& dim);
+
+// Resolve ambiguity between the above two overloads -- ArrayRef and
+// optional are both implicitly constructible from int64_t.
+inline std::optional<ContiguousReduceShape> get_contiguous_reduce_shape(
+    const executorch::aten::Tensor& in,
+    int64_t dim) {
+  return get_contiguous_reduce_shape(
+      in, executorch::aten::optional<int64_t>(dim));
+}
+
+/**
+ * Sum for the vectorized reductions below. A reducer provides, for T either
+ * CTYPE_ACC or executorch::vec::Vectorized<CTYPE_ACC>:
+ *
+ *   CTYPE_ACC identity() const;
+ *   // Applied to each input element after converting it to CTYPE_ACC.
+ *   T map(const T& v) const;
+ *   // Must be associative and commutative: elements are combined in blocks,
+ *   // vector lanes and threads rather than in order.
+ *   T combine(const T& a, const T& b) const;
+ */
+template <typename CTYPE_ACC>
+struct SumReducer {
+  CTYPE_ACC identity() const {
+    return 0;
+  }
+
+  template <typename T>
+  T map(const T& v) const {
+    return v;
+  }
+
+  template <typename T>
+  T combine(const T& a, const T& b) const {
+    return a + b;
+  }
+};
+
+/// Maximum for the vectorized reductions below. Propagates NaN.
+template <typename CTYPE_ACC>
+struct MaxReducer {
+  CTYPE_ACC identity() const {
+    if constexpr (std::numeric_limits<CTYPE_ACC>::has_infinity) {
+      return -std::numeric_limits<CTYPE_ACC>::infinity();
+    } else {
+      return std::numeric_limits<CTYPE_ACC>::lowest();
+    }
+  }
+
+  template <typename T>
+  T map(const T& v) const {
+    return v;
+  }
+
+  template <typename T>
+  T combine(const T& a, const T& b) const {
+    if constexpr (std::is_same_v<T, CTYPE_ACC>) {
+      if constexpr (std::is_floating_point_v<CTYPE_ACC>) {
+        return std::isnan(a) || a > b ? a : b;
+      } else {
+        return a > b ? a : b;
+      }
+    } else {
+      return executorch::vec::maximum(a, b);
+    }
+  }
+};
+
+/// The accumulator type for reductions that produce CTYPE: float for Half
+/// and BFloat16, otherwise CTYPE itself.
+template <typename CTYPE>
+using reduce_acc_type_t = std::conditional_t<
+    std::is_same_v<CTYPE, executorch::aten::Half> ||
+        std::is_same_v<CTYPE, executorch::aten::BFloat16>,
+    float,
+    CTYPE>;
+
+namespace internal {
+
+/// Runs of at most this many elements are reduced in one pass; longer runs
+/// are split in half recursively, so rounding error grows with the log of
+/// the reduction size rather than linearly. A multiple of every vector width
+/// times kReduceVecAccumulators.
+constexpr int64_t kReducePairwiseBlockSize = 1024;
+/// Independent vector accumulators, to hide the latency of combine().
+constexpr size_t kReduceVecAccumulators = 4;
+/// A reduction over a single run splits it into at most this many chunks,
+/// whose partial results live on the stack.
+constexpr int64_t kMaxReducePartials = 64;
+/// Rows of a reduction are split between threads, rather than handed out
+/// whole, when there are fewer rows than this and they are long.
+constexpr int64_t kMinRowsForParallelRowReduce = 8;
+
+template <typename CTYPE_ACC>
+constexpr bool kReduceVectorized = std::is_floating_point_v<CTYPE_ACC>;
+
+/// Loads a vector's worth of elements, converting them to CTYPE_ACC.
+template <typename CTYPE_ACC, typename CTYPE_IN>
+inline executorch::vec::Vectorized<CTYPE_ACC> load_for_reduce(
+    const CTYPE_IN* data) {
+  using Vec = executorch::vec::Vectorized<CTYPE_ACC>;
+  if constexpr (std::is_same_v<CTYPE_IN, CTYPE_ACC>) {
+    return Vec::loadu(data);
+  } else {
+    CTYPE_ACC converted[Vec::size()];
+    for (const auto i : c10::irange(Vec::size())) {
+      converted[i] = static_cast<CTYPE_ACC>(data[i]);
+    }
+    return Vec::loadu(converted);
+  }
+}
+
+/**
+ * Reduces the columns [0, kNumVecs * Vec::size()) of the size x (row stride
+ * `stride`) matrix at `data` into `acc`, pairwise over the rows. With
+ * kNumVecs == 0, reduces the single column 0 with scalar code instead.
+ */
+template <typename CTYPE_IN, typename CTYPE_ACC, size_t kNumVecs, typename R>
+void reduce_columns(
+    const R& reducer,
+    const CTYPE_IN* data,
+    int64_t size,
+    int64_t stride,
+    std::conditional_t<
+        kNumVecs == 0,
+        std::array<CTYPE_ACC, 1>,
+        std::array<executorch::vec::Vectorized<CTYPE_ACC>, kNumVecs>>& acc) {
+  if (size > kReducePairwiseBlockSize) {
+    const int64_t half = size / 2;
+    auto rest = acc;
+    reduce_columns<CTYPE_IN, CTYPE_ACC, kNumVecs>(
+        reducer, data, half, stride, acc);
+    reduce_columns<CTYPE_IN, CTYPE_ACC, kNumVecs>(
+        reducer, data + half * stride, size - half, stride, rest);
+    for (const auto i : c10::irange(acc.size())) {
+      acc[i] = reducer.combine(acc[i], rest[i]);
+    }
+    return;
+  }
+  using Lane = typename std::remove_reference_t<decltype(acc)>::value_type;
+  acc.fill(Lane(reducer.identity()));
+  for (int64_t r = 0; r < size; ++r) {
+    const CTYPE_IN* const row = data + r * stride;
+    for (const auto i : c10::irange(acc.size())) {
+      if constexpr (kNumVecs == 0) {
+        acc[i] = reducer.combine(
+            acc[i], reducer.map(static_cast<CTYPE_ACC>(row[i])));
+      } else {
+        acc[i] = reducer.combine(
+            acc[i],
+            reducer.map(load_for_reduce<CTYPE_ACC>(row + i * Lane::size())));
+      }
+    }
+  }
+}
+
+/**
+ * Reduces an [outer_size, reduce_size, inner_size] input over its middle
+ * dim, for the output elements [begin, end): the inner dim is contiguous, so
+ * each vector lane reduces a different output element.
+ */
+template <typename CTYPE_IN, typename CTYPE_ACC, typename R, typename StoreFn>
+void reduce_strided_outputs(
+    const R& reducer,
+    const CTYPE_IN* data,
+    const ContiguousReduceShape& shape,
+    int64_t begin,
+    int64_t end,
+    const StoreFn& store) {
+  const int64_t inner_size = shape.inner_size;
+  const int64_t reduce_size = shape.reduce_size;
+  for (int64_t out_ix = begin; out_ix < end;) {
+    const int64_t outer = out_ix / inner_size;
+    const int64_t inner = out_ix % inner_size;
+    const int64_t count = std::min(end - out_ix, inner_size - inner);
+    const CTYPE_IN* const base =
+        data + outer * reduce_size * inner_size + inner;
+    int64_t j = 0;
+    if constexpr (kReduceVectorized<CTYPE_ACC>) {
+      using Vec = executorch::vec::Vectorized<CTYPE_ACC>;
+      const auto store_vecs = [&](const auto& acc, int64_t offset) {
+        for (const auto i : c10::irange(acc.size())) {
+          CTYPE_ACC lanes[Vec::size()];
+          acc[i].store(lanes);
+          for (const auto lane : c10::irange(Vec::size())) {
+            store(offset + i * Vec::size() + lane, lanes[lane]);
+          }
+        }
+      };
+      constexpr int64_t kTileWidth = kReduceVecAccumulators * Vec::size();
+      for (; j + kTileWidth <= count; j += kTileWidth) {
+        std::array<Vec, kReduceVecAccumulators> acc;
+        reduce_columns<CTYPE_IN, CTYPE_ACC, kReduceVecAccumulators>(
+            reducer, base + j, reduce_size, inner_size, acc);
+        store_vecs(acc, out_ix + j);
+      }
+      for (; j + static_cast<int64_t>(Vec::size()) <= count;
+           j += Vec::size()) {
+        std::array<Vec, 1> acc;
+        reduce_columns<CTYPE_IN, CTYPE_ACC, 1>(
+            reducer, base + j, reduce_size, inner_size, acc);
+        store_vecs(acc, out_ix + j);
+      }
+    }
+    for (; j < count; ++j) {
+      std::array<CTYPE_ACC, 1> acc;
+      reduce_columns<CTYPE_IN, CTYPE_ACC, 0>(
+          reducer, base + j, reduce_size, inner_size, acc);
+      store(out_ix + j, acc[0]);
+    }
+    out_ix += count;
+  }
+}
+
+} // namespace internal
+
+/**
+ * Reduces the `size` contiguous elements at `data` with `reducer` (see
+ * SumReducer), converting them to CTYPE_ACC first. Floating point
+ * accumulators are reduced a vector at a time, and pairwise in blocks of
+ * internal::kReducePairwiseBlockSize, which keeps Half and BFloat16 inputs
+ * accurate when CTYPE_ACC is float.
+ */
+template <typename CTYPE_IN, typename CTYPE_ACC, typename R>
+CTYPE_ACC vectorized_reduce(
+    const R& reducer,
+    const CTYPE_IN* data,
+    int64_t size) {
+  using internal::kReducePairwiseBlockSize;
+  if (size > kReducePairwiseBlockSize) {
+    // Split on a block boundary so that both halves stay vectorized.
+    const int64_t half = (size / 2 + kReducePairwiseBlockSize - 1) /
+        kReducePairwiseBlockSize * kReducePairwiseBlockSize;
+    return reducer.combine(
+        vectorized_reduce<CTYPE_IN, CTYPE_ACC>(reducer, data, half),
+        vectorized_reduce<CTYPE_IN, CTYPE_ACC>(
+            reducer, data + half, size - half));
+  }
+  CTYPE_ACC result = reducer.identity();
+  int64_t i = 0;
+  if constexpr (internal::kReduceVectorized<CTYPE_ACC>) {
+    using Vec = executorch::vec::Vectorized<CTYPE_ACC>;
+    constexpr int64_t kVecSize = Vec::size();
+    constexpr auto kNumAcc = internal::kReduceVecAccumulators;
+    if (size >= kVecSize) {
+      std::array<Vec, kNumAcc> acc;
+      acc.fill(Vec(reducer.identity()));
+      for (; i + kVecSize * kNumAcc <= size; i += kVecSize * kNumAcc) {
+        for (const auto j : c10::irange(kNumAcc)) {
+          const CTYPE_IN* const chunk = data + i + j * kVecSize;
+          acc[j] = reducer.combine(
+              acc[j],
+              reducer.map(internal::load_for_reduce<CTYPE_ACC>(chunk)));
+        }
+      }
+      for (; i + kVecSize <= size; i += kVecSize) {
+        acc[0] = reducer.combine(
+            acc[0],
+            reducer.map(internal::load_for_reduce<CTYPE_ACC>(data + i)));
+      }
+      for (size_t step = 1; step < kNumAcc; step *= 2) {
+        for (size_t j = 0; j + step < kNumAcc; j += 2 * step) {
+          acc[j] = reducer.combine(acc[j], acc[j + step]);
+        }
+      }
+      CTYPE_ACC lanes[kVecSize];
+      acc[0].store(lanes);
+      for (const auto lane : c10::irange(kVecSize)) {
+        result = reducer.combine(result, lanes[lane]);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    result = reducer.combine(
+        result, reducer.map(static_cast<CTYPE_ACC>(data[i])));
+  }
+  return result;
+}
+
+/**
+ * Like vectorized_reduce(), but splits long runs into up to
+ * internal::kMaxReducePartials chunks that are reduced in parallel. The
+ * partial results are then combined as a tree, in an order that doesn't
+ * depend on the number of threads.
+ */
+template <typename CTYPE_IN, typename CTYPE_ACC, typename R>
+[[nodiscard]] bool parallel_vectorized_reduce(
+    const R& reducer,
+    const CTYPE_IN* data,
+    int64_t size,
+    CTYPE_ACC& result) {
+  using executorch::extension::internal::GRAIN_SIZE;
+  const int64_t num_chunks = std::clamp<int64_t>(
+      size / GRAIN_SIZE, 1, internal::kMaxReducePartials);
+  if (num_chunks == 1) {
+    result = vectorized_reduce<CTYPE_IN, CTYPE_ACC>(reducer, data, size);
+    return true;
+  }
+  const int64_t chunk_size = (size + num_chunks - 1) / num_chunks;
+  std::array<CTYPE_ACC, internal::kMaxReducePartials> partials;
+  const bool success = executorch::extension::parallel_for(
+      0, num_chunks, 1, [&](const auto begin, const auto end) {
+        for (const auto chunk : c10::irange(begin, end)) {
+          const int64_t start = chunk * chunk_size;
+          partials[chunk] = vectorized_reduce<CTYPE_IN, CTYPE_ACC>(
+              reducer, data + start, std::min(chunk_size, size - start));
+        }
+      });
+  for (int64_t step = 1; step < num_chunks; step *= 2) {
+    for (int64_t i = 0; i + step < num_chunks; i += 2 * step) {
+      partials[i] = reducer.combine(partials[i], partials[i + step]);
+    }
+  }
+  result = partials[0];
+  return success;
+}
+
+/**
+ * Calls `fn(row)` for each row in [0, num_rows) of a reduction over rows of
+ * row_size contiguous elements, and returns false if any call does. Rows are
+ * handed out to threads whole, unless there are only a few long ones: then
+ * they are processed one at a time, so that fn can split each of them
+ * between threads with parallel_vectorized_reduce() and parallel_for().
+ */
+template <typename Func>
+[[nodiscard]] bool parallel_for_each_reduce_row(
+    int64_t num_rows,
+    int64_t row_size,
+    const Func& fn) {
+  using executorch::extension::internal::GRAIN_SIZE;
+  if (num_rows < internal::kMinRowsForParallelRowReduce &&
+      row_size >= 2 * GRAIN_SIZE) {
+    for (const auto row : c10::irange(num_rows)) {
+      if (!fn(row)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  std::atomic<bool> success = true;
+  const bool parallel_for_success = executorch::extension::parallel_for(
+      0,
+      num_rows,
+      std::max<int64_t>(1, GRAIN_SIZE / std::max<int64_t>(1, row_size)),
+      [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          if (!fn(row)) {
+            success = false;
+          }
+        }
+      });
+  return parallel_for_success && success;
+}
+
+/**
+ * Reduces `in` over `dim_list` with `reducer` (see SumReducer), calling
+ * `store(out_ix, value)` with the CTYPE_ACC result for each output element,
+ * in any order and from any thread.
+ *
+ * Contiguous inputs whose reduced dims are adjacent use vectorized code, in
+ * parallel across output elements, or within each output element when there
+ * are only a few long ones. Other inputs fall back to
+ * MapReduceOverDimListPlan. Returns false if parallel_for failed.
+ */
+template <typename CTYPE_IN, typename CTYPE_ACC, typename R, typename StoreFn>
+[[nodiscard]] bool parallel_reduce_over_dim_list(
+    const R& reducer,
+    const executorch::aten::Tensor& in,
+    const executorch::aten::optional<executorch::aten::ArrayRef<int64_t>>&
+        dim_list,
+    const StoreFn& store) {
+  using executorch::extension::parallel_for;
+  using executorch::extension::internal::GRAIN_SIZE;
+  const CTYPE_IN* const in_data = in.const_data_ptr<CTYPE_IN>();
+  const auto shape = get_contiguous_reduce_shape(in, dim_list);
+  if (!shape.has_value()) {
+    const int64_t out_numel = get_out_numel(in, dim_list);
+    std::optional<MapReduceOverDimListPlan> plan;
+    if (in.numel() > 0) {
+      plan.emplace(in, dim_list);
+    }
+    const int64_t reduce_size = get_reduced_dim_product(in, dim_list);
+    return parallel_for(
+        0,
+        out_numel,
+        std::max<int64_t>(1, GRAIN_SIZE / std::max<int64_t>(1, reduce_size)),
+        [&](const auto begin, const auto end) {
+          for (const auto out_ix : c10::irange(begin, end)) {
+            if (!plan.has_value()) {
+              store(out_ix, reducer.identity());
+              continue;
+            }
+            store(
+                out_ix,
+                plan->execute<CTYPE_IN, CTYPE_ACC>(
+                    [&reducer](CTYPE_IN v) {
+                      return reducer.map(static_cast<CTYPE_ACC>(v));
+                    },
+                    [&reducer](CTYPE_ACC v, CTYPE_ACC acc) {
+                      return reducer.combine(acc, v);
+                    },
+                    out_ix));
+          }
+        });
+  }
+
+  const int64_t outer_size = shape->outer_size;
+  const int64_t reduce_size = shape->reduce_size;
+  const int64_t inner_size = shape->inner_size;
+  const int64_t grain_size =
+      std::max<int64_t>(1, GRAIN_SIZE / std::max<int64_t>(1, reduce_size));
+  if (inner_size != 1) {
+    return parallel_for(
+        0,
+        outer_size * inner_size,
+        grain_size,
+        [&](const auto begin, const auto end) {
+          internal::reduce_strided_outputs<CTYPE_IN, CTYPE_ACC>(
+              reducer, in_data, *shape, begin, end, store);
+        });
+  }
+  return parallel_for_each_reduce_row(
+      outer_size, reduce_size, [&](const int64_t out_ix) {
+        CTYPE_ACC result;
+        if (!parallel_vectorized_reduce<CTYPE_IN, CTYPE_ACC>(
+                reducer, in_data + out_ix * reduce_size, reduce_size, result)) {
+          return false;
+        }
+        store(out_ix, result);
+        return true;
+      });
+}
+
 } // namespace executor
 } // namespace torch
@@ -7,6 +7,7 @@
  */
 
 #include <c10/util/irange.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/kernels/portable/cpu/util/slice_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <cstring>
@@ -146,7 +147,7 @@ int64_t adjust_slice_indices(
   return num_values;
 }
 
-void compute_slice(
+bool compute_slice(
     const Tensor& in,
     int64_t dim,
     int64_t start,
@@ -159,7 +160,7 @@ void compute_slice(
   size_t trailing_dims = getTrailingDims(in, dim);
 
   if (trailing_dims == 0) {
-    return;
+    return true;
   }
 
   size_t length_per_step = trailing_dims * in.element_size();
@@ -167,14 +168,31 @@ void compute_slice(
   const char* input_data = in.const_data_ptr<char>();
   char* dest = out.mutable_data_ptr<char>();
 
+  if (step == 1) {
+    // The slice of each leading index is contiguous.
+    return copy_chunks(
+        input_data + start * length_per_step,
+        dim_length * length_per_step,
+        dest,
+        length * length_per_step,
+        leading_dims,
+        length * length_per_step);
+  }
+
   for (const auto i : c10::irange(leading_dims)) {
     const char* src = input_data + (i * dim_length + start) * length_per_step;
-    for ([[maybe_unused]] const auto j : c10::irange(length)) {
-      memcpy(dest, src, length_per_step);
-      src += step * length_per_step;
-      dest += length_per_step;
+    if (!copy_chunks(
+            src,
+            step * length_per_step,
+            dest,
+            length_per_step,
+            length,
+            length_per_step)) {
+      return false;
     }
+    dest += length * length_per_step;
   }
+  return true;
 }
 
 } // namespace executor
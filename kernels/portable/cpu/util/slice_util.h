@@ -54,7 +54,13 @@ int64_t adjust_slice_indices(
     int64_t* end,
     int64_t step);
 
-void compute_slice(
+/**
+ * Copies the `length` indices of `in` along `dim` from `start` with `step`
+ * to `out`.
+ *
+ * @returns false if parallel_for() failed, true otherwise.
+ */
+bool compute_slice(
     const Tensor& in,
     int64_t dim,
     int64_t start,
@@ -15,6 +15,7 @@
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
 using executorch::runtime::testing::TensorFactory;
+using torch::executor::BroadcastIndexesBlockRange;
 using torch::executor::BroadcastIndexesRange;
 using torch::executor::delinearize_index;
 using torch::executor::linearize_access_indexes;
@@ -25,6 +26,44 @@ auto range_to_vec(const Range& rng) {
   return std::vector<typename Range::iterator::value_type>(
       rng.begin(), rng.end());
 }
+
+template <size_t kNumInputs>
+std::vector<std::array<ssize_t, kNumInputs + 1>> blocks_to_vec(
+    const BroadcastIndexesBlockRange<kNumInputs>& rng) {
+  std::vector<std::array<ssize_t, kNumInputs + 1>> result;
+  for (const auto& block : rng) {
+    EXPECT_GT(block.size, 0);
+    EXPECT_EQ(block.strides[0], 1);
+    for (ssize_t k = 0; k < block.size; ++k) {
+      std::array<ssize_t, kNumInputs + 1> indexes;
+      for (size_t t = 0; t < kNumInputs + 1; ++t) {
+        indexes[t] = block.indexes[t] + k * block.strides[t];
+      }
+      result.push_back(indexes);
+    }
+  }
+  return result;
+}
+
+// Checks that the blocks of BroadcastIndexesBlockRange, and of every slice
+// of it, visit the same indexes as BroadcastIndexesRange.
+template <typename... Args>
+void expect_blocks_match_elements(const Tensor& out, const Args&... inputs) {
+  constexpr auto kNumInputs = sizeof...(Args);
+  const auto expected =
+      range_to_vec(BroadcastIndexesRange<kNumInputs>(out, inputs...));
+  const auto blocks = BroadcastIndexesBlockRange<kNumInputs>(out, inputs...);
+  EXPECT_EQ(expected, blocks_to_vec(blocks));
+
+  const ssize_t numel = out.numel();
+  for (ssize_t begin = 0; begin <= numel; ++begin) {
+    for (ssize_t end = begin; end <= numel; ++end) {
+      const decltype(expected) expected_slice(
+          expected.begin() + begin, expected.begin() + end);
+      EXPECT_EQ(expected_slice, blocks_to_vec(blocks.slice(begin, end)));
+    }
+  }
+}
 } // namespace
 TEST(BroadcastIndexesRangeTest, Empty) {
   TensorFactory<ScalarType::Int> tf;
@@ -282,3 +321,111 @@ TEST(BroadcastIndexesRangeTest, FourDBroadcastingWithOneDimsInOutput) {
   four_d_broadcasting_test<2, 3, 1, 5>();
   four_d_broadcasting_test<2, 1, 3, 1>();
 }
+
+TEST(BroadcastIndexesBlockRangeTest, Empty) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor a = tf.make({0}, {});
+  const auto range = BroadcastIndexesBlockRange<1>(a, a);
+  EXPECT_EQ(range.begin(), range.end());
+}
+
+TEST(BroadcastIndexesBlockRangeTest, ZeroDim) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor a = tf.zeros({});
+  const auto blocks = range_to_vec(BroadcastIndexesBlockRange<1>(a, a));
+  ASSERT_EQ(blocks.size(), 1);
+  EXPECT_EQ(blocks[0].size, 1);
+  EXPECT_EQ(blocks[0].indexes[0], 0);
+  EXPECT_EQ(blocks[0].indexes[1], 0);
+}
+
+TEST(BroadcastIndexesBlockRangeTest, SameSizesIsOneBlock) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor out = tf.zeros({2, 3, 4});
+  Tensor in = tf.zeros({2, 3, 4});
+  const auto blocks = range_to_vec(BroadcastIndexesBlockRange<2>(out, in, in));
+  ASSERT_EQ(blocks.size(), 1);
+  EXPECT_EQ(blocks[0].size, 24);
+  EXPECT_EQ(blocks[0].strides, (std::array<ssize_t, 3>{1, 1, 1}));
+  expect_blocks_match_elements(out, in, in);
+}
+
+// [B, S, H] + [H]
+TEST(BroadcastIndexesBlockRangeTest, BiasAdd) {
+  TensorFactory<ScalarType::Int> tf;
+  constexpr auto B = 2;
+  constexpr auto S = 3;
+  constexpr auto H = 5;
+
+  Tensor out = tf.zeros({B, S, H});
+  Tensor bias = tf.zeros({H});
+  const auto blocks =
+      range_to_vec(BroadcastIndexesBlockRange<2>(out, out, bias));
+  ASSERT_EQ(blocks.size(), B * S);
+  for (const auto i : c10::irange(blocks.size())) {
+    EXPECT_EQ(blocks[i].size, H);
+    const auto offset = static_cast<ssize_t>(i * H);
+    EXPECT_EQ(blocks[i].indexes, (std::array<ssize_t, 3>{offset, offset, 0}));
+    EXPECT_EQ(blocks[i].strides, (std::array<ssize_t, 3>{1, 1, 1}));
+  }
+  expect_blocks_match_elements(out, out, bias);
+}
+
+// [B, S, 1] * [B, S, H]: the broadcast input has stride 0 within each block.
+TEST(BroadcastIndexesBlockRangeTest, BroadcastAlongInnerDim) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor out = tf.zeros({2, 3, 4});
+  Tensor scale = tf.zeros({2, 3, 1});
+  const auto blocks =
+      range_to_vec(BroadcastIndexesBlockRange<2>(out, scale, out));
+  ASSERT_EQ(blocks.size(), 6);
+  for (const auto i : c10::irange(blocks.size())) {
+    EXPECT_EQ(blocks[i].size, 4);
+    const auto block = static_cast<ssize_t>(i);
+    EXPECT_EQ(
+        blocks[i].indexes,
+        (std::array<ssize_t, 3>{block * 4, block, block * 4}));
+    EXPECT_EQ(blocks[i].strides, (std::array<ssize_t, 3>{1, 0, 1}));
+  }
+  expect_blocks_match_elements(out, scale, out);
+}
+
+TEST(BroadcastIndexesBlockRangeTest, MatchesBroadcastIndexesRange) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor out = tf.zeros({2, 3, 4});
+  const std::array<Tensor, 9> inputs = {
+      tf.zeros({}),
+      tf.zeros({2, 3, 1}),
+      tf.zeros({2, 1, 4}),
+      tf.zeros({1, 3, 4}),
+      tf.zeros({2, 1, 1}),
+      tf.zeros({1, 3, 1}),
+      tf.zeros({4}),
+      tf.zeros({3, 4}),
+      tf.zeros({2, 3, 4}),
+  };
+  for (const auto& a : inputs) {
+    for (const auto& b : inputs) {
+      expect_blocks_match_elements(out, a, b);
+    }
+  }
+
+  // Size-1 dims in the output.
+  Tensor out_with_ones = tf.zeros({2, 1, 3, 1, 4});
+  expect_blocks_match_elements(
+      out_with_ones, tf.zeros({2, 1, 1, 1, 4}), tf.zeros({3, 1, 1}));
+}
+
+TEST(BroadcastIndexesBlockRangeTest, NonContiguousInput) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor out = tf.zeros({2, 3, 4});
+  // A [3, 4] view with transposed strides.
+  Tensor transposed = tf.make({3, 4}, std::vector<int32_t>(12), {1, 3});
+  expect_blocks_match_elements(out, transposed, tf.zeros({4}));
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using torch::executor::copy_chunks;
+
+namespace {
+
+// Checks copy_chunks() against a byte by byte copy of the same chunks.
+void test_copy_chunks(
+    size_t src_stride_nbytes,
+    size_t dst_stride_nbytes,
+    size_t num_chunks,
+    size_t chunk_nbytes) {
+  std::vector<uint8_t> src(num_chunks * src_stride_nbytes);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  std::vector<uint8_t> expected(num_chunks * dst_stride_nbytes, 0xff);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    for (size_t j = 0; j < chunk_nbytes; ++j) {
+      expected[i * dst_stride_nbytes + j] = src[i * src_stride_nbytes + j];
+    }
+  }
+
+  std::vector<uint8_t> dst(expected.size(), 0xff);
+  ASSERT_TRUE(copy_chunks(
+      src.data(),
+      src_stride_nbytes,
+      dst.data(),
+      dst_stride_nbytes,
+      num_chunks,
+      chunk_nbytes));
+  EXPECT_EQ(dst, expected);
+}
+
+} // namespace
+
+TEST(CopyOpsUtilTest, CopyChunksContiguous) {
+  // Collapsed into a single copy, small and large enough to be split.
+  test_copy_chunks(12, 12, 5, 12);
+  test_copy_chunks(4096, 4096, 300, 4096);
+}
+
+TEST(CopyOpsUtilTest, CopyChunksStrided) {
+  // Fixed-size chunks, as when concatenating along the last dim.
+  for (const size_t chunk_nbytes : {1, 2, 4, 8, 16, 32}) {
+    test_copy_chunks(chunk_nbytes * 3, chunk_nbytes * 2, 17, chunk_nbytes);
+    test_copy_chunks(chunk_nbytes, chunk_nbytes * 5, 17, chunk_nbytes);
+  }
+  // Other sizes, with enough chunks to be split across tasks.
+  test_copy_chunks(40, 24, 7, 12);
+  test_copy_chunks(3000, 7000, 200, 3000);
+}
+
+TEST(CopyOpsUtilTest, CopyChunksEmpty) {
+  EXPECT_TRUE(copy_chunks(nullptr, 8, nullptr, 8, 0, 8));
+  EXPECT_TRUE(copy_chunks(nullptr, 8, nullptr, 8, 4, 0));
+}
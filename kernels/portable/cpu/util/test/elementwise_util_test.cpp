@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::native::utils::apply_bitensor_elementwise_fn;
+using torch::executor::native::utils::apply_unitensor_elementwise_fn;
+using torch::executor::native::utils::SupportedTensorDtypes;
+using torch::executor::native::utils::vectorizable;
+
+namespace {
+constexpr const char kOpName[] = "test.out";
+
+std::vector<float> iota_floats(size_t size, float start) {
+  std::vector<float> result(size);
+  std::iota(result.begin(), result.end(), start);
+  return result;
+}
+} // namespace
+
+// Sizes that aren't a multiple of the vector width exercise both the
+// vectorized loop and the scalar tail of the same-layout fast path.
+TEST(ElementwiseUtilTest, SameLayoutVectorizable) {
+  TensorFactory<ScalarType::Float> tf;
+  KernelRuntimeContext ctx;
+
+  const auto a_data = iota_floats(3 * 37, 1);
+  const auto b_data = iota_floats(3 * 37, -50);
+  Tensor a = tf.make({3, 37}, a_data);
+  Tensor b = tf.make({3, 37}, b_data);
+  Tensor out = tf.zeros({3, 37});
+
+  apply_bitensor_elementwise_fn<float, kOpName>(
+      vectorizable([](const auto x, const auto y) { return x * y - x; }),
+      ctx,
+      a,
+      SupportedTensorDtypes::REALHBBF16,
+      b,
+      SupportedTensorDtypes::REALHBBF16,
+      out,
+      SupportedTensorDtypes::REALHBBF16);
+
+  ASSERT_EQ(ctx.failure_state(), executorch::runtime::Error::Ok);
+  std::vector<float> expected(a_data.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = a_data[i] * b_data[i] - a_data[i];
+  }
+  EXPECT_TENSOR_EQ(out, tf.make({3, 37}, expected));
+}
+
+TEST(ElementwiseUtilTest, SameLayoutScalarFunction) {
+  TensorFactory<ScalarType::Int> tf;
+  KernelRuntimeContext ctx;
+
+  Tensor in = tf.make({2, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor out = tf.zeros({2, 3});
+
+  apply_unitensor_elementwise_fn<int32_t, kOpName>(
+      [](const int32_t x) { return x * x + 1; },
+      ctx,
+      in,
+      SupportedTensorDtypes::REALHBBF16,
+      out,
+      SupportedTensorDtypes::REALHBBF16);
+
+  EXPECT_TENSOR_EQ(out, tf.make({2, 3}, {2, 5, 10, 17, 26, 37}));
+}
+
+TEST(ElementwiseUtilTest, SameLayoutReducedPrecisionComputesInFloat) {
+  TensorFactory<ScalarType::Half> tf;
+  KernelRuntimeContext ctx;
+
+  Tensor a = tf.make({4}, {1.5, 2048, -3, 0.25});
+  Tensor b = tf.make({4}, {2, 1, 4, 0.5});
+  Tensor out = tf.zeros({4});
+
+  // 2048 + 1 isn't representable in Half, but (2048 + 1) - 1 is exact in
+  // float.
+  apply_bitensor_elementwise_fn<float, kOpName>(
+      [](const float x, const float y) { return x + y - 1.0f; },
+      ctx,
+      a,
+      SupportedTensorDtypes::FLOATHBF16,
+      b,
+      SupportedTensorDtypes::FLOATHBF16,
+      out,
+      SupportedTensorDtypes::FLOATHBF16);
+
+  EXPECT_TENSOR_EQ(out, tf.make({4}, {2.5, 2048, 0, -0.25}));
+}
+
+// [B, S, H] + [H], and [B, S, 1] * [B, S, H], with H long enough to use the
+// vectorized loop for each block.
+TEST(ElementwiseUtilTest, BroadcastingVectorizable) {
+  TensorFactory<ScalarType::Float> tf;
+  KernelRuntimeContext ctx;
+  constexpr int B = 2;
+  constexpr int S = 3;
+  constexpr int H = 37;
+
+  const auto x_data = iota_floats(B * S * H, 1);
+  const auto bias_data = iota_floats(H, -20);
+  const auto scale_data = iota_floats(B * S, 2);
+  Tensor x = tf.make({B, S, H}, x_data);
+  Tensor bias = tf.make({H}, bias_data);
+  Tensor scale = tf.make({B, S, 1}, scale_data);
+  Tensor out = tf.zeros({B, S, H});
+
+  apply_bitensor_elementwise_fn<float, kOpName>(
+      vectorizable([](const auto x, const auto y) { return x + y; }),
+      ctx,
+      x,
+      SupportedTensorDtypes::REALHBBF16,
+      bias,
+      SupportedTensorDtypes::REALHBBF16,
+      out,
+      SupportedTensorDtypes::REALHBBF16);
+  std::vector<float> expected(x_data.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = x_data[i] + bias_data[i % H];
+  }
+  EXPECT_TENSOR_EQ(out, tf.make({B, S, H}, expected));
+
+  apply_bitensor_elementwise_fn<float, kOpName>(
+      vectorizable([](const auto x, const auto y) { return x * y; }),
+      ctx,
+      scale,
+      SupportedTensorDtypes::REALHBBF16,
+      x,
+      SupportedTensorDtypes::REALHBBF16,
+      out,
+      SupportedTensorDtypes::REALHBBF16);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = scale_data[i / H] * x_data[i];
+  }
+  EXPECT_TENSOR_EQ(out, tf.make({B, S, H}, expected));
+  EXPECT_EQ(ctx.failure_state(), executorch::runtime::Error::Ok);
+}
+
+TEST(ElementwiseUtilTest, MixedDtypesAndBroadcasting) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Int> tf_int;
+  KernelRuntimeContext ctx;
+
+  Tensor a = tf_int.make({2, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor b = tf_float.make({3}, {0.5, 1, 2});
+  Tensor out = tf_float.zeros({2, 3});
+
+  apply_bitensor_elementwise_fn<float, kOpName>(
+      vectorizable([](const auto x, const auto y) { return x * y; }),
+      ctx,
+      a,
+      SupportedTensorDtypes::REALHBBF16,
+      b,
+      SupportedTensorDtypes::REALHBBF16,
+      out,
+      SupportedTensorDtypes::REALHBBF16);
+
+  EXPECT_TENSOR_EQ(out, tf_float.make({2, 3}, {0.5, 2, 6, 2, 5, 12}));
+}
@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::optional;
@@ -22,7 +26,13 @@ using executorch::aten::Tensor;
 using executorch::runtime::testing::TensorFactory;
 using torch::executor::apply_over_dim;
 using torch::executor::apply_over_dim_list;
+using torch::executor::get_contiguous_reduce_shape;
 using torch::executor::get_out_numel;
+using torch::executor::map_reduce_over_dim_list;
+using torch::executor::MaxReducer;
+using torch::executor::parallel_reduce_over_dim_list;
+using torch::executor::parallel_vectorized_reduce;
+using torch::executor::SumReducer;
 
 void _apply_over_dim(const Tensor& in, const optional<int64_t>& dim) {
   int64_t* in_data = in.mutable_data_ptr<int64_t>();
@@ -581,3 +591,135 @@ TEST(ReduceUtilTest, ApplyOverDimListInvalid) {
   ET_EXPECT_DEATH(
       apply_over_dim_list([](size_t in_ix) { return; }, in, dim_list, 0), "");
 }
+
+TEST(ReduceUtilTest, GetContiguousReduceShape) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor in = tf.zeros({2, 3, 1, 4, 5});
+
+  int64_t inner_dims[] = {3, -1};
+  auto shape = get_contiguous_reduce_shape(in, ArrayRef<int64_t>(inner_dims));
+  ASSERT_TRUE(shape.has_value());
+  EXPECT_EQ(shape->outer_size, 6);
+  EXPECT_EQ(shape->reduce_size, 20);
+  EXPECT_EQ(shape->inner_size, 1);
+
+  // The size-1 dim between the reduced dims doesn't matter.
+  int64_t middle_dims[] = {1, 2, 3};
+  shape = get_contiguous_reduce_shape(in, ArrayRef<int64_t>(middle_dims));
+  ASSERT_TRUE(shape.has_value());
+  EXPECT_EQ(shape->outer_size, 2);
+  EXPECT_EQ(shape->reduce_size, 12);
+  EXPECT_EQ(shape->inner_size, 5);
+
+  shape = get_contiguous_reduce_shape(in, optional<ArrayRef<int64_t>>());
+  ASSERT_TRUE(shape.has_value());
+  EXPECT_EQ(shape->outer_size, 1);
+  EXPECT_EQ(shape->reduce_size, 120);
+  EXPECT_EQ(shape->inner_size, 1);
+
+  int64_t split_dims[] = {0, 3};
+  EXPECT_FALSE(
+      get_contiguous_reduce_shape(in, ArrayRef<int64_t>(split_dims))
+          .has_value());
+
+  Tensor transposed =
+      tf.make({3, 2}, {0, 1, 2, 3, 4, 5}, /*strides=*/{1, 3});
+  EXPECT_FALSE(
+      get_contiguous_reduce_shape(transposed, optional<int64_t>(1))
+          .has_value());
+}
+
+namespace {
+// Checks parallel_reduce_over_dim_list against map_reduce_over_dim_list.
+void expect_matches_reference(
+    const Tensor& in,
+    const optional<ArrayRef<int64_t>>& dim_list) {
+  const size_t out_numel = get_out_numel(in, dim_list);
+  std::vector<double> actual(out_numel, NAN);
+  const bool success = parallel_reduce_over_dim_list<float, double>(
+      SumReducer<double>(), in, dim_list, [&](size_t out_ix, double sum) {
+        actual[out_ix] = sum;
+      });
+  ASSERT_TRUE(success);
+  for (const auto out_ix : c10::irange(out_numel)) {
+    const double expected = map_reduce_over_dim_list<float, double>(
+        [](float v) { return static_cast<double>(v); },
+        [](double v, double acc) { return acc + v; },
+        in,
+        dim_list,
+        out_ix);
+    EXPECT_EQ(actual[out_ix], expected) << "out_ix " << out_ix;
+  }
+}
+} // namespace
+
+TEST(ReduceUtilTest, ParallelReduceMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  // Long enough in each dim to exercise the vector tiles and the scalar
+  // tails of the strided case.
+  std::vector<float> data(3 * 37 * 41);
+  for (const auto i : c10::irange(data.size())) {
+    data[i] = static_cast<float>(i % 97) - 48;
+  }
+  Tensor in = tf.make({3, 37, 41}, data);
+
+  expect_matches_reference(in, optional<ArrayRef<int64_t>>());
+  for (int64_t dim = 0; dim < 3; ++dim) {
+    expect_matches_reference(in, ArrayRef<int64_t>(&dim, 1));
+  }
+  int64_t leading_dims[] = {0, 1};
+  expect_matches_reference(in, ArrayRef<int64_t>(leading_dims));
+  int64_t trailing_dims[] = {1, 2};
+  expect_matches_reference(in, ArrayRef<int64_t>(trailing_dims));
+  // Not adjacent, so this falls back to MapReduceOverDimListPlan.
+  int64_t split_dims[] = {0, 2};
+  expect_matches_reference(in, ArrayRef<int64_t>(split_dims));
+}
+
+TEST(ReduceUtilTest, ParallelReduceEmpty) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor in = tf.zeros({2, 0, 3});
+
+  int64_t dim = 1;
+  std::vector<float> actual(6, NAN);
+  const bool success = parallel_reduce_over_dim_list<float, float>(
+      SumReducer<float>(),
+      in,
+      ArrayRef<int64_t>(&dim, 1),
+      [&](size_t out_ix, float sum) { actual[out_ix] = sum; });
+  ASSERT_TRUE(success);
+  EXPECT_EQ(actual, std::vector<float>(6, 0));
+}
+
+TEST(ReduceUtilTest, ParallelVectorizedReduceLongRun) {
+  // Long enough to be split into many chunks.
+  const int64_t size = 5 * executorch::extension::internal::GRAIN_SIZE + 7;
+  std::vector<float> data(size, 1.0f);
+  data[size / 3] = 2.5f;
+
+  float sum = 0;
+  ASSERT_TRUE((parallel_vectorized_reduce<float, float>(
+      SumReducer<float>(), data.data(), size, sum)));
+  EXPECT_EQ(sum, size + 1.5f);
+
+  float max = 0;
+  ASSERT_TRUE((parallel_vectorized_reduce<float, float>(
+      MaxReducer<float>(), data.data(), size, max)));
+  EXPECT_EQ(max, 2.5f);
+
+  data[size - 1] = NAN;
+  ASSERT_TRUE((parallel_vectorized_reduce<float, float>(
+      MaxReducer<float>(), data.data(), size, max)));
+  EXPECT_TRUE(std::isnan(max));
+}
+
+TEST(ReduceUtilTest, ParallelVectorizedReduceHalfAccumulatesInFloat) {
+  // A Half accumulator would get stuck at 2048, where adding 1 rounds away.
+  const int64_t size = 10000;
+  std::vector<executorch::aten::Half> data(size, executorch::aten::Half(1));
+
+  float sum = 0;
+  ASSERT_TRUE((parallel_vectorized_reduce<executorch::aten::Half, float>(
+      SumReducer<float>(), data.data(), size, sum)));
+  EXPECT_EQ(sum, size);
+}
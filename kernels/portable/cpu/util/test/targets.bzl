@@ -23,6 +23,24 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "copy_ops_util_test",
+        srcs = ["copy_ops_util_test.cpp"],
+        deps = [
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "elementwise_util_test",
+        srcs = ["elementwise_util_test.cpp"],
+        deps = [
+            "//executorch/kernels/portable/cpu/util:elementwise_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
     runtime.cxx_test(
         name = "reduce_test",
         srcs = ["reduce_test.cpp"],
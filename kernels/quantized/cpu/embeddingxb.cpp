@@ -6,12 +6,21 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/quantized/cpu/embeddingxb.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
+#include <type_traits>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace torch {
 namespace executor {
@@ -107,13 +116,15 @@ void check_embedding_xbit_args(
 
   ET_CHECK_MSG(
       out.scalar_type() == ScalarType::Float ||
-          out.scalar_type() == ScalarType::Half,
+          out.scalar_type() == ScalarType::Half ||
+          out.scalar_type() == ScalarType::BFloat16,
       "out.scalar_type() %" PRId8 " is not supported:",
       static_cast<int8_t>(out.scalar_type()));
 
   ET_CHECK_MSG(
       weight_scales.scalar_type() == ScalarType::Float ||
-          weight_scales.scalar_type() == ScalarType::Half,
+          weight_scales.scalar_type() == ScalarType::Half ||
+          weight_scales.scalar_type() == ScalarType::BFloat16,
       "weight_scales.scalar_type() %" PRId8 " is not supported:",
       static_cast<int8_t>(weight_scales.scalar_type()));
 
@@ -162,9 +173,119 @@ void check_embedding_xbit_args(
   }
 }
 
+/**
+ * Dequantizes the 32 4-bit values packed in w[0, 16), and stores
+ * (value - zero_point) * scale for each of them in out, in the same order
+ * and with the same rounding as weight_value() followed by the scalar
+ * expression in dequantize_row().
+ */
+inline void dequantize_32_nibbles(
+    const uint8_t* w,
+    float scale,
+    float zero_point,
+    float* out) {
+#if defined(__aarch64__)
+  const uint8x16_t packed = vld1q_u8(w);
+  // The first value of each byte is its high nibble.
+  const uint8x16x2_t values =
+      vzipq_u8(vshrq_n_u8(packed, 4), vandq_u8(packed, vdupq_n_u8(0x0F)));
+  const float32x4_t offset = vdupq_n_f32(8.0f);
+  const float32x4_t zp = vdupq_n_f32(zero_point);
+  const float32x4_t sc = vdupq_n_f32(scale);
+  for (const auto h : c10::irange(2)) {
+    const uint16x8_t low = vmovl_u8(vget_low_u8(values.val[h]));
+    const uint16x8_t high = vmovl_u8(vget_high_u8(values.val[h]));
+    const uint32x4_t q[4] = {
+        vmovl_u16(vget_low_u16(low)),
+        vmovl_u16(vget_high_u16(low)),
+        vmovl_u16(vget_low_u16(high)),
+        vmovl_u16(vget_high_u16(high))};
+    for (const auto i : c10::irange(4)) {
+      const float32x4_t v = vsubq_f32(vcvtq_f32_u32(q[i]), offset);
+      vst1q_f32(out + 16 * h + 4 * i, vmulq_f32(vsubq_f32(v, zp), sc));
+    }
+  }
+#elif defined(__AVX2__)
+  const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  // The first value of each byte is its high nibble.
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(packed, 4), mask);
+  const __m128i low = _mm_and_si128(packed, mask);
+  const __m128i values[2] = {
+      _mm_unpacklo_epi8(high, low), _mm_unpackhi_epi8(high, low)};
+  const __m256 offset = _mm256_set1_ps(8.0f);
+  const __m256 zp = _mm256_set1_ps(zero_point);
+  const __m256 sc = _mm256_set1_ps(scale);
+  for (const auto h : c10::irange(2)) {
+    for (const auto i : c10::irange(2)) {
+      const __m256i q = _mm256_cvtepu8_epi32(
+          i == 0 ? values[h] : _mm_srli_si128(values[h], 8));
+      const __m256 v = _mm256_sub_ps(_mm256_cvtepi32_ps(q), offset);
+      _mm256_storeu_ps(
+          out + 16 * h + 8 * i, _mm256_mul_ps(_mm256_sub_ps(v, zp), sc));
+    }
+  }
+#else
+  for (const auto i : c10::irange(32)) {
+    out[i] = (static_cast<float>(weight_value(w, i, 4)) - zero_point) * scale;
+  }
+#endif
+}
+
+/**
+ * Dequantizes one row of embedding_dim values into out, a group of
+ * group_size values at a time. Each group has its own scale, and a zero
+ * point if zero_points isn't null.
+ */
+template <typename CTYPE_PARAMS, typename CTYPE_OUT>
+void dequantize_row(
+    const uint8_t* w_data,
+    const CTYPE_PARAMS* scale_ptr,
+    const CTYPE_PARAMS* zero_points_ptr,
+    int32_t embedding_dim,
+    int32_t group_size,
+    int weight_nbit,
+    CTYPE_OUT* out_data) {
+  constexpr int32_t kNibblesPerStep = 32;
+  for (int32_t group_start = 0; group_start < embedding_dim;
+       group_start += group_size) {
+    const int32_t group_id = group_start / group_size;
+    const float scale = static_cast<float>(scale_ptr[group_id]);
+    const float zp = zero_points_ptr != nullptr
+        ? static_cast<float>(zero_points_ptr[group_id])
+        : 0.0f;
+    const int32_t group_end = group_start + group_size;
+    int32_t j = group_start;
+    if (weight_nbit == 4) {
+      // Groups of an odd size don't start on a byte boundary.
+      if (j % 2 != 0) {
+        out_data[j] = static_cast<CTYPE_OUT>(
+            (static_cast<float>(weight_value(w_data, j, 4)) - zp) * scale);
+        ++j;
+      }
+      for (; j + kNibblesPerStep <= group_end; j += kNibblesPerStep) {
+        if constexpr (std::is_same_v<CTYPE_OUT, float>) {
+          dequantize_32_nibbles(w_data + j / 2, scale, zp, out_data + j);
+        } else {
+          float values[kNibblesPerStep];
+          dequantize_32_nibbles(w_data + j / 2, scale, zp, values);
+          for (const auto k : c10::irange(kNibblesPerStep)) {
+            out_data[j + k] = static_cast<CTYPE_OUT>(values[k]);
+          }
+        }
+      }
+    }
+    for (; j < group_end; ++j) {
+      out_data[j] = static_cast<CTYPE_OUT>(
+          (static_cast<float>(weight_value(w_data, j, weight_nbit)) - zp) *
+          scale);
+    }
+  }
+}
+
 /**
  * Retrieves the embeddings specified by indices, dequantizes them, and stores
- * them in out. Weight will always be uint8
+ * them in out. Weight will always be uint8. Rows are dequantized in parallel.
  */
 template <typename CTYPE_PARAMS, typename CTYPE_OUT>
 void embedding_xbit_per_channel(
@@ -191,33 +312,27 @@ void embedding_xbit_per_channel(
     zero_points = opt_weight_zero_points.value().const_data_ptr<CTYPE_PARAMS>();
   }
 
-  for (int i = 0; i < indices.numel(); i++) {
-    int64_t index = indices_ptr[i];
-    // If using groupwise embedding
-    int32_t qparams_index = index * num_groups_per_channel;
-    CTYPE_PARAMS zp = 0.0;
-    const CTYPE_PARAMS* scale_ptr = scales + qparams_index;
-    const CTYPE_PARAMS* zero_points_ptr = nullptr;
-    if (opt_weight_zero_points.has_value()) {
-      zero_points_ptr = zero_points + qparams_index;
-    }
-
-    const uint8_t* w_data =
-        weight.const_data_ptr<uint8_t>() + weight.size(1) * index;
-
-    for (int j = 0; j < embedding_dim; ++j) {
-      int32_t group_id = j / group_size;
-      const CTYPE_PARAMS scale = scale_ptr[group_id];
-      if (opt_weight_zero_points.has_value()) {
-        zp = zero_points_ptr[group_id];
-      }
-      out_data[j] = static_cast<CTYPE_OUT>(
-          (static_cast<float>(weight_value(w_data, j, weight_nbit)) -
-           static_cast<float>(zp)) *
-          static_cast<float>(scale));
-    }
-    out_data += embedding_dim;
-  }
+  const bool success = executorch::extension::parallel_for(
+      0,
+      indices.numel(),
+      std::max<int64_t>(
+          1, executorch::extension::internal::GRAIN_SIZE / embedding_dim),
+      [&](const auto begin, const auto end) {
+        for (const auto i : c10::irange(begin, end)) {
+          int64_t index = indices_ptr[i];
+          // If using groupwise embedding
+          int64_t qparams_index = index * num_groups_per_channel;
+          dequantize_row(
+              weight.const_data_ptr<uint8_t>() + weight.size(1) * index,
+              scales + qparams_index,
+              zero_points != nullptr ? zero_points + qparams_index : nullptr,
+              embedding_dim,
+              group_size,
+              weight_nbit,
+              out_data + i * embedding_dim);
+        }
+      });
+  ET_CHECK_MSG(success, "parallel_for failed");
 }
 
 void resize_out_tensor(
@@ -282,15 +397,16 @@ Tensor& quantized_embedding_xbit_out(
       weight_nbit);
 
   constexpr auto name = "quantized_decomposed::embedding_xbit.out";
-  ET_SWITCH_TWO_TYPES(Float, Half, out_type, ctx, name, CTYPE_OUT, [&]() {
-    embedding_xbit_per_channel<CTYPE_OUT, CTYPE_OUT>(
-        weight,
-        weight_scales,
-        opt_weight_zero_points,
-        indices,
-        out,
-        weight_nbit);
-  });
+  ET_SWITCH_THREE_TYPES(
+      Float, Half, BFloat16, out_type, ctx, name, CTYPE_OUT, [&]() {
+        embedding_xbit_per_channel<CTYPE_OUT, CTYPE_OUT>(
+            weight,
+            weight_scales,
+            opt_weight_zero_points,
+            indices,
+            out,
+            weight_nbit);
+      });
 
   return out;
 }
@@ -349,17 +465,19 @@ Tensor& quantized_embedding_xbit_dtype_out(
   ScalarType out_type = out.scalar_type();
 
   constexpr auto name = "quantized_decomposed::embedding_xbit.dtype_out";
-  ET_SWITCH_TWO_TYPES(Float, Half, params_type, ctx, name, CTYPE_P, [&]() {
-    ET_SWITCH_TWO_TYPES(Float, Half, out_type, ctx, name, CTYPE_OUT, [&]() {
-      embedding_xbit_per_channel<CTYPE_P, CTYPE_OUT>(
-          weight,
-          weight_scales,
-          opt_weight_zero_points,
-          indices,
-          out,
-          weight_nbit);
-    });
-  });
+  ET_SWITCH_THREE_TYPES(
+      Float, Half, BFloat16, params_type, ctx, name, CTYPE_P, [&]() {
+        ET_SWITCH_THREE_TYPES(
+            Float, Half, BFloat16, out_type, ctx, name, CTYPE_OUT, [&]() {
+              embedding_xbit_per_channel<CTYPE_P, CTYPE_OUT>(
+                  weight,
+                  weight_scales,
+                  opt_weight_zero_points,
+                  indices,
+                  out,
+                  weight_nbit);
+            });
+      });
 
   return out;
 }
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+/// The rows of b that gemm_int8_nt() multiplies with each row of a at once.
+constexpr int64_t kInt8GemmBlockN = 4;
+
+#if defined(__aarch64__)
+/// The bytes of each row consumed by one dot_step().
+constexpr int64_t kInt8DotStep = 16;
+
+inline int32x4_t dot_step(int32x4_t acc, int8x16_t a, int8x16_t b) {
+#if defined(__ARM_FEATURE_DOTPROD)
+  return vdotq_s32(acc, a, b);
+#else
+  // Each product fits in 16 bits, but the sum of two may not, so they are
+  // widened before being added up.
+  acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(a), vget_low_s8(b)));
+  return vpadalq_s16(acc, vmull_high_s8(a, b));
+#endif
+}
+
+inline int8x16_t load_step(const int8_t* p) {
+  return vld1q_s8(p);
+}
+
+inline int32_t reduce_add(int32x4_t v) {
+  return vaddvq_s32(v);
+}
+
+using DotAcc = int32x4_t;
+
+inline DotAcc zero_acc() {
+  return vdupq_n_s32(0);
+}
+#elif defined(__AVX2__)
+/// The bytes of each row consumed by one dot_step().
+constexpr int64_t kInt8DotStep = 16;
+
+/// Multiplies the int16 lanes of a and b and adds pairs of them to acc.
+inline __m256i dot_step(__m256i acc, __m256i a, __m256i b) {
+#if defined(__AVXVNNI__)
+  return _mm256_dpwssd_avx_epi32(acc, a, b);
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+  return _mm256_dpwssd_epi32(acc, a, b);
+#else
+  return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+#endif
+}
+
+/// Loads 16 int8 values, sign extended to int16 lanes.
+inline __m256i load_step(const int8_t* p) {
+  return _mm256_cvtepi8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline int32_t reduce_add(__m256i v) {
+  __m128i sum = _mm_add_epi32(
+      _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  sum = _mm_hadd_epi32(sum, sum);
+  sum = _mm_hadd_epi32(sum, sum);
+  return _mm_cvtsi128_si32(sum);
+}
+
+using DotAcc = __m256i;
+
+inline DotAcc zero_acc() {
+  return _mm256_setzero_si256();
+}
+#endif
+
+/**
+ * Sets c[j] to the dot product of the k int8 values of a and of row j of b,
+ * for the kInt8GemmBlockN rows of b that are ldb apart.
+ */
+inline void dot_int8_block(
+    const int8_t* a,
+    const int8_t* b,
+    int64_t ldb,
+    int64_t k,
+    int32_t* c) {
+  int64_t kk = 0;
+#if defined(__aarch64__) || defined(__AVX2__)
+  DotAcc acc[kInt8GemmBlockN];
+  for (const auto j : c10::irange(kInt8GemmBlockN)) {
+    acc[j] = zero_acc();
+  }
+  for (; kk + kInt8DotStep <= k; kk += kInt8DotStep) {
+    const auto a_vec = load_step(a + kk);
+    for (const auto j : c10::irange(kInt8GemmBlockN)) {
+      acc[j] = dot_step(acc[j], a_vec, load_step(b + j * ldb + kk));
+    }
+  }
+  for (const auto j : c10::irange(kInt8GemmBlockN)) {
+    c[j] = reduce_add(acc[j]);
+  }
+#else
+  for (const auto j : c10::irange(kInt8GemmBlockN)) {
+    c[j] = 0;
+  }
+#endif
+  for (; kk < k; ++kk) {
+    const int32_t a_val = a[kk];
+    for (const auto j : c10::irange(kInt8GemmBlockN)) {
+      c[j] += a_val * b[j * ldb + kk];
+    }
+  }
+}
+
+/// Returns the dot product of the k int8 values of a and b.
+inline int32_t dot_int8(const int8_t* a, const int8_t* b, int64_t k) {
+  int64_t kk = 0;
+  int32_t sum = 0;
+#if defined(__aarch64__) || defined(__AVX2__)
+  DotAcc acc = zero_acc();
+  for (; kk + kInt8DotStep <= k; kk += kInt8DotStep) {
+    acc = dot_step(acc, load_step(a + kk), load_step(b + kk));
+  }
+  sum = reduce_add(acc);
+#endif
+  for (; kk < k; ++kk) {
+    sum += static_cast<int32_t>(a[kk]) * b[kk];
+  }
+  return sum;
+}
+
+/**
+ * Computes the int32 products of the int8 matrices a [m, k] and b [n, k]:
+ * c[i * ldc + j] is the dot product of row i of a and row j of b. Each row of
+ * a is multiplied with kInt8GemmBlockN rows of b at a time, so that it is
+ * loaded once per block. The products are exact as long as k is below 2^17.
+ */
+inline void gemm_int8_nt(
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t* c,
+    int64_t ldc) {
+  const int64_t n_blocked = n - n % kInt8GemmBlockN;
+  for (const auto i : c10::irange(m)) {
+    const int8_t* const a_row = a + i * lda;
+    int32_t* const c_row = c + i * ldc;
+    for (int64_t j = 0; j < n_blocked; j += kInt8GemmBlockN) {
+      dot_int8_block(a_row, b + j * ldb, ldb, k, c_row + j);
+    }
+    for (const auto j : c10::irange(n_blocked, n)) {
+      c_row[j] = dot_int8(a_row, b + j * ldb, k);
+    }
+  }
+}
+
+/// Returns the sum of the k int8 values of a.
+inline int32_t sum_int8(const int8_t* a, int64_t k) {
+  int32_t sum = 0;
+  for (const auto kk : c10::irange(k)) {
+    sum += a[kk];
+  }
+  return sum;
+}
+
+/**
+ * Returns value quantized like quantize_per_tensor: rounded to the nearest
+ * integer, ties to even, after scaling by inv_scale, then shifted by
+ * zero_point and clamped to [quant_min, quant_max].
+ */
+inline int8_t requantize_int8(
+    float value,
+    float inv_scale,
+    int32_t zero_point,
+    int32_t quant_min,
+    int32_t quant_max) {
+  const int64_t q = zero_point +
+      static_cast<int64_t>(std::nearbyint(static_cast<float>(
+          inv_scale * value)));
+  return static_cast<int8_t>(std::clamp<int64_t>(q, quant_min, quant_max));
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
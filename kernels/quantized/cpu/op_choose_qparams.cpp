@@ -6,12 +6,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <limits>
 #include <tuple>
+#include <utility>
 /**
  * For an input tensor, use the scale and zero_point arguments to quantize it.
  */
@@ -170,6 +175,38 @@ void calculate_scale_and_zero_point(
   return;
 }
 
+/**
+ * Returns the minimum and maximum of the n elements at `x`, found in a single
+ * pass.
+ */
+std::pair<float, float> min_max(const float* x, int64_t n) {
+  using Vec = executorch::vec::Vectorized<float>;
+  float min = std::numeric_limits<float>::infinity();
+  float max = -std::numeric_limits<float>::infinity();
+  int64_t i = 0;
+  if (n >= static_cast<int64_t>(Vec::size())) {
+    Vec min_vec = Vec::loadu(x);
+    Vec max_vec = min_vec;
+    for (i = Vec::size(); i + static_cast<int64_t>(Vec::size()) <= n;
+         i += Vec::size()) {
+      const Vec v = Vec::loadu(x + i);
+      min_vec = executorch::vec::minimum(min_vec, v);
+      max_vec = executorch::vec::maximum(max_vec, v);
+    }
+    min = executorch::vec::vec_reduce_all<float>(
+        [](Vec& a, Vec& b) { return executorch::vec::minimum(a, b); },
+        min_vec);
+    max = executorch::vec::vec_reduce_all<float>(
+        [](Vec& a, Vec& b) { return executorch::vec::maximum(a, b); },
+        max_vec);
+  }
+  for (; i < n; ++i) {
+    min = std::min(min, x[i]);
+    max = std::max(max, x[i]);
+  }
+  return {min, max};
+}
+
 void choose_qparams(
     const Tensor& input,
     int32_t qmin,
@@ -178,8 +215,7 @@ void choose_qparams(
     Tensor& zero_point_out) {
   const float* x_fp32 = input.const_data_ptr<float>();
   // Compute x_min, x_max and q_params (scale, zero_point)
-  float min = torch::executor::vec_minf(x_fp32, input.numel());
-  float max = torch::executor::vec_maxf(x_fp32, input.numel());
+  const auto [min, max] = min_max(x_fp32, input.numel());
 
   double scale;
   int32_t zero_point;
@@ -201,19 +237,29 @@ void choose_qparams_per_token(
   for (auto i = 0; i < input.dim() - 1; i++) {
     num_tokens *= input.size(i);
   }
-  auto token_dim_size = input.size(input.dim() - 1);
-  for (auto i = 0; i < num_tokens; i++) {
-    // vec_minf uses std::min_element. Check if it actually
-    // gets vectorized.
-    float min = torch::executor::vec_minf(x_fp32, token_dim_size);
-    float max = torch::executor::vec_maxf(x_fp32, token_dim_size);
-    double scale;
-    int32_t zero_point;
-    calculate_scale_and_zero_point(min, max, qmin, qmax, scale, zero_point);
-    scale_out.mutable_data_ptr<double>()[i] = scale;
-    zero_point_out.mutable_data_ptr<int64_t>()[i] = zero_point;
-    x_fp32 += token_dim_size;
-  }
+  const int64_t token_dim_size = input.size(input.dim() - 1);
+  double* const scale_data = scale_out.mutable_data_ptr<double>();
+  int64_t* const zero_point_data = zero_point_out.mutable_data_ptr<int64_t>();
+  const bool success = executorch::extension::parallel_for(
+      0,
+      num_tokens,
+      std::max<int64_t>(
+          1,
+          executorch::extension::internal::GRAIN_SIZE /
+              std::max<int64_t>(1, token_dim_size)),
+      [&](const auto begin, const auto end) {
+        for (const auto i : c10::irange(begin, end)) {
+          const auto [min, max] =
+              min_max(x_fp32 + i * token_dim_size, token_dim_size);
+          double scale;
+          int32_t zero_point;
+          calculate_scale_and_zero_point(
+              min, max, qmin, qmax, scale, zero_point);
+          scale_data[i] = scale;
+          zero_point_data[i] = zero_point;
+        }
+      });
+  ET_CHECK_MSG(success, "parallel_for failed");
 }
 } // namespace
 
@@ -6,11 +6,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 #if defined(__aarch64__) || defined(__ARM_NEON)
 #include <arm_neon.h>
 #endif
@@ -68,89 +73,66 @@ void check_dequantize_per_tensor_args(
       quant_max);
 }
 
+using executorch::extension::parallel_for;
+using executorch::extension::internal::GRAIN_SIZE;
+
 /**
- * Useful to reduce a tensor `in` over a given dimension `dim` using the
- * reduce function `fn`, which should have the following signature:
- * void fn(const size_t size, const size_t stride, const size_t base_ix)
- * where `size` and `stride` are the size and stride of the dimension being
- * reduced and `base_ix` is the index of the first element of the reduction.
+ * Dequantizes the n contiguous elements at `in` with a single scale and zero
+ * point. Float outputs are scaled a vector at a time.
  */
-template <typename Fn>
-void apply_over_unpacked_dim(
-    const Fn& fn,
-    const executorch::aten::Tensor& in,
-    const int64_t& dim) {
-  if (in.numel() == 0) {
-    return;
-  }
-
-  ET_CHECK_MSG(in.dim() > 0, "Input tensor must have at least one dimension");
-  ET_CHECK_VALID_DIM(dim, in.dim());
-
-  const size_t d = ET_NORMALIZE_IX(dim, in.dim());
-  const size_t dim_size = in.size(d);
-  const size_t outer_size = getLeadingDims(in, d);
-  const size_t inner_size = getTrailingDims(in, d);
-  // Loop through all outer dimensions
-  for (size_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
-    // Loop through dim
-    for (size_t unpacked_dim_idx = 0; unpacked_dim_idx < dim_size;
-         ++unpacked_dim_idx) {
-      fn(inner_size, outer_idx, unpacked_dim_idx);
-    }
-  }
-}
-
-void dequantize_optimized(
-    const int8_t* in,
-    const double scale,
-    const int64_t zero_point,
-    float* out,
-    int64_t quant_min,
-    int64_t quant_max,
-    size_t numel) {
-  ET_CHECK_MSG(
-      zero_point >= quant_min,
-      "zero_point must be %" PRId64 " <= quant_min %" PRId64,
-      zero_point,
-      quant_min);
-  ET_CHECK_MSG(
-      zero_point <= quant_max,
-      "zero_point must be %" PRId64 " >= quant_max %" PRId64,
-      zero_point,
-      quant_max);
-  size_t i = 0;
+template <typename CTYPE_IN, typename CTYPE_OUT>
+void dequantize_contiguous(
+    const CTYPE_IN* in,
+    float scale,
+    int64_t zero_point,
+    CTYPE_OUT* out,
+    int64_t n) {
+  int64_t i = 0;
 #if defined(__aarch64__) || defined(__ARM_NEON)
-  int8x8_t zero_point_vec = vdup_n_s8(zero_point);
-  float32x4_t scales = vdupq_n_f32(static_cast<float>(scale));
-  constexpr int32_t kVecSize = 16;
-  const size_t num_vecs = numel / kVecSize;
-  const int8_t* in_copy = in;
-  float* out_copy = out;
-  for (; i < num_vecs; i++) {
-    int8x16_t in_vec = vld1q_s8(in_copy);
-    int16x8_t sub_vec_0_7 = vsubl_s8(vget_low_s8(in_vec), zero_point_vec);
-    int32x4_t sub_vec_0_3 = vmovl_s16(vget_low_s16(sub_vec_0_7));
-    int32x4_t sub_vec_4_7 = vmovl_s16(vget_high_s16(sub_vec_0_7));
-    float32x4_t out_vec_0_3 = vmulq_f32(vcvtq_f32_s32(sub_vec_0_3), scales);
-    float32x4_t out_vec_4_7 = vmulq_f32(vcvtq_f32_s32(sub_vec_4_7), scales);
-
-    int16x8_t sub_vec_8_15 = vsubl_s8(vget_high_s8(in_vec), zero_point_vec);
-    int32x4_t sub_vec_8_11 = vmovl_s16(vget_low_s16(sub_vec_8_15));
-    int32x4_t sub_vec_12_15 = vmovl_s16(vget_high_s16(sub_vec_8_15));
-    float32x4_t out_vec_8_11 = vmulq_f32(vcvtq_f32_s32(sub_vec_8_11), scales);
-    float32x4_t out_vec_12_15 = vmulq_f32(vcvtq_f32_s32(sub_vec_12_15), scales);
-    vst1q_f32(out_copy + 0, out_vec_0_3);
-    vst1q_f32(out_copy + 4, out_vec_4_7);
-    vst1q_f32(out_copy + 8, out_vec_8_11);
-    vst1q_f32(out_copy + 12, out_vec_12_15);
-    in_copy += kVecSize;
-    out_copy += kVecSize;
+  if constexpr (
+      std::is_same_v<CTYPE_IN, int8_t> && std::is_same_v<CTYPE_OUT, float>) {
+    if (zero_point >= std::numeric_limits<int8_t>::min() &&
+        zero_point <= std::numeric_limits<int8_t>::max()) {
+      int8x8_t zero_point_vec = vdup_n_s8(zero_point);
+      float32x4_t scales = vdupq_n_f32(scale);
+      constexpr int32_t kVecSize = 16;
+      for (; i + kVecSize <= n; i += kVecSize) {
+        int8x16_t in_vec = vld1q_s8(in + i);
+        int16x8_t sub_vec_0_7 = vsubl_s8(vget_low_s8(in_vec), zero_point_vec);
+        int32x4_t sub_vec_0_3 = vmovl_s16(vget_low_s16(sub_vec_0_7));
+        int32x4_t sub_vec_4_7 = vmovl_s16(vget_high_s16(sub_vec_0_7));
+        float32x4_t out_vec_0_3 = vmulq_f32(vcvtq_f32_s32(sub_vec_0_3), scales);
+        float32x4_t out_vec_4_7 = vmulq_f32(vcvtq_f32_s32(sub_vec_4_7), scales);
+
+        int16x8_t sub_vec_8_15 =
+            vsubl_s8(vget_high_s8(in_vec), zero_point_vec);
+        int32x4_t sub_vec_8_11 = vmovl_s16(vget_low_s16(sub_vec_8_15));
+        int32x4_t sub_vec_12_15 = vmovl_s16(vget_high_s16(sub_vec_8_15));
+        float32x4_t out_vec_8_11 =
+            vmulq_f32(vcvtq_f32_s32(sub_vec_8_11), scales);
+        float32x4_t out_vec_12_15 =
+            vmulq_f32(vcvtq_f32_s32(sub_vec_12_15), scales);
+        vst1q_f32(out + i + 0, out_vec_0_3);
+        vst1q_f32(out + i + 4, out_vec_4_7);
+        vst1q_f32(out + i + 8, out_vec_8_11);
+        vst1q_f32(out + i + 12, out_vec_12_15);
+      }
+    }
   }
-  i = i * kVecSize;
 #endif
-  for (; i < numel; i++) {
-    out[i] = (in[i] - zero_point) * scale;
+  if constexpr (std::is_same_v<CTYPE_OUT, float>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    const Vec scale_vec(scale);
+    float lanes[Vec::size()];
+    for (; i + static_cast<int64_t>(Vec::size()) <= n; i += Vec::size()) {
+      for (const auto lane : c10::irange(Vec::size())) {
+        lanes[lane] = static_cast<float>(in[i + lane] - zero_point);
+      }
+      (Vec::loadu(lanes) * scale_vec).store(out + i);
+    }
+  }
+  for (; i < n; ++i) {
+    out[i] = static_cast<CTYPE_OUT>((in[i] - zero_point) * scale);
   }
 }
 
@@ -170,7 +152,7 @@ float get_scale(const Tensor& scale, size_t channel_ix) {
 bool can_use_optimized_dequantize_per_channel(
     const Tensor& in,
     const ScalarType in_dtype,
-    executorch::aten::optional<ScalarType>& out_dtype) {
+    const Tensor& out) {
   bool is_contiguous = false;
 #ifdef USE_ATEN_LIB
   is_contiguous = in.is_contiguous();
@@ -178,13 +160,54 @@ bool can_use_optimized_dequantize_per_channel(
   is_contiguous = executorch::runtime::is_contiguous_dim_order(
       in.dim_order().data(), in.dim());
 #endif
-  if (!is_contiguous || (in_dtype != ScalarType::Char) ||
-      (out_dtype.has_value() && out_dtype.value() != ScalarType::Float)) {
+  if (!is_contiguous || (in_dtype == ScalarType::Bits16) ||
+      (in_dtype == ScalarType::UInt16) ||
+      (out.scalar_type() != ScalarType::Float &&
+       out.scalar_type() != ScalarType::Double)) {
     return false;
   }
   return true;
 }
 
+/**
+ * Dequantizes a contiguous input, viewed as [outer, channels, inner]: each
+ * run of inner elements shares a channel, and the runs are split between
+ * threads.
+ */
+template <typename CTYPE_IN, typename CTYPE_OUT>
+[[nodiscard]] bool dequantize_per_channel_contiguous(
+    const Tensor& in,
+    const Tensor& scales,
+    const int64_t* zero_points_data,
+    int64_t axis,
+    Tensor& out) {
+  const CTYPE_IN* const in_data = in.const_data_ptr<CTYPE_IN>();
+  CTYPE_OUT* const out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  const int64_t num_channels = in.size(axis);
+  const int64_t inner_size = getTrailingDims(in, axis);
+  const int64_t num_runs = getLeadingDims(in, axis) * num_channels;
+  if (inner_size == 0) {
+    return true;
+  }
+  return parallel_for(
+      0,
+      num_runs,
+      std::max<int64_t>(1, GRAIN_SIZE / inner_size),
+      [&](const auto begin, const auto end) {
+        for (const auto run : c10::irange(begin, end)) {
+          const int64_t channel = run % num_channels;
+          const int64_t zero_point =
+              zero_points_data != nullptr ? zero_points_data[channel] : 0;
+          dequantize_contiguous(
+              in_data + run * inner_size,
+              get_scale(scales, channel),
+              zero_point,
+              out_data + run * inner_size,
+              inner_size);
+        }
+      });
+}
+
 void dequantize_per_channel_optimized(
     const Tensor& in,
     const Tensor& scales,
@@ -197,52 +220,34 @@ void dequantize_per_channel_optimized(
     executorch::aten::optional<ScalarType>& out_dtype) {
   check_dequantize_per_tensor_args(
       in, quant_min, quant_max, in_dtype, out_dtype, out);
-  ET_CHECK_MSG(
-      in_dtype == ScalarType::Char,
-      "in.scalar_type() %" PRId8 " is not supported:",
-      static_cast<int8_t>(in.scalar_type()));
-  if (out_dtype.has_value()) {
-    ET_CHECK_MSG(
-        out_dtype.value() == ScalarType::Float,
-        "Only float output is supported");
-  }
-  const int8_t* in_data = in.const_data_ptr<int8_t>();
-  float* out_data = out.mutable_data_ptr<float>();
   const int64_t* zero_points_data = nullptr;
   if (opt_zero_points.has_value()) {
     zero_points_data = opt_zero_points.value().const_data_ptr<int64_t>();
   }
-  const StridesType axis_stride = in.strides()[axis];
-  const StridesType outer_stride = in.size(axis) * axis_stride;
-  apply_over_unpacked_dim(
-      [in_data,
-       out_data,
-       &scales,
-       zero_points_data,
-       axis_stride,
-       outer_stride,
-       quant_min,
-       quant_max](
-          SizesType numel, SizesType outer_idx, SizesType unpacked_dim_idx) {
-        const int8_t* in_data_local =
-            in_data + outer_idx * outer_stride + unpacked_dim_idx * axis_stride;
-        const double scale = get_scale(scales, unpacked_dim_idx);
-        const int64_t zero_point = zero_points_data != nullptr
-            ? zero_points_data[unpacked_dim_idx]
-            : 0;
-        float* out_data_local = out_data + outer_idx * outer_stride +
-            unpacked_dim_idx * axis_stride;
-        dequantize_optimized(
-            in_data_local,
-            scale,
-            zero_point,
-            out_data_local,
-            quant_min,
-            quant_max,
-            numel);
-      },
-      in,
-      axis);
+  if (in_dtype == ScalarType::Char && zero_points_data != nullptr) {
+    for (const auto channel : c10::irange(in.size(axis))) {
+      const int64_t zero_point = zero_points_data[channel];
+      ET_CHECK_MSG(
+          zero_point >= quant_min,
+          "zero_point must be %" PRId64 " <= quant_min %" PRId64,
+          zero_point,
+          quant_min);
+      ET_CHECK_MSG(
+          zero_point <= quant_max,
+          "zero_point must be %" PRId64 " >= quant_max %" PRId64,
+          zero_point,
+          quant_max);
+    }
+  }
+  bool success = true;
+  constexpr auto name = "quantized_decomposed::dequantize_per_channel.out";
+  ET_SWITCH_INT_TYPES(in_dtype, ctx, name, CTYPE_IN, [&]() {
+    ET_SWITCH_FLOAT_TYPES(out.scalar_type(), ctx, name, CTYPE_OUT, [&]() {
+      success = dequantize_per_channel_contiguous<CTYPE_IN, CTYPE_OUT>(
+          in, scales, zero_points_data, axis, out);
+    });
+  });
+  ET_CHECK_MSG(success, "parallel_for failed");
 }
 
 } // namespace
@@ -281,12 +286,16 @@ Tensor& dequantize_per_tensor_out(
      * get inlined without LTO, particularly in ATen mode. */                  \
     auto* out_data_ptr = out.mutable_data_ptr<OUT_CTYPE>();                    \
     const auto* input_data_ptr = input.const_data_ptr<IN_CTYPE>();             \
-    const auto input_numel = input.numel();                                    \
-    for (size_t i = 0; i < input_numel; i++) {                                 \
-      out_data_ptr[i] = static_cast<OUT_CTYPE>(                                \
-          (input_data_ptr[i] - static_cast<int32_t>(zero_point)) *             \
-          static_cast<float>(scale));                                          \
-    }                                                                          \
+    const bool success = parallel_for(                                         \
+        0, input.numel(), GRAIN_SIZE, [&](const auto begin, const auto end) {  \
+          dequantize_contiguous(                                               \
+              input_data_ptr + begin,                                          \
+              static_cast<float>(scale),                                       \
+              static_cast<int64_t>(static_cast<int32_t>(zero_point)),          \
+              out_data_ptr + begin,                                            \
+              end - begin);                                                    \
+        });                                                                    \
+    ET_CHECK_MSG(success, "parallel_for failed");                              \
   } break;
 #define CALCULATE_INT_TYPE(IN_CTYPE, in_dtype)               \
   case ScalarType::in_dtype:                                 \
@@ -398,7 +407,7 @@ Tensor& dequantize_per_channel_out(
   check_dequantize_per_tensor_args(
       input, quant_min, quant_max, dtype, out_dtype, out);
 
-  if (can_use_optimized_dequantize_per_channel(input, dtype, out_dtype)) {
+  if (can_use_optimized_dequantize_per_channel(input, dtype, out)) {
     dequantize_per_channel_optimized(
         input,
         scale,
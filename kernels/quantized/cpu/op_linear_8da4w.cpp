@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cfloat>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+constexpr int32_t kActQuantMin = -128;
+constexpr int32_t kActQuantMax = 127;
+
+/**
+ * Quantizes a row of activations to int8 with a per-token asymmetric scale
+ * and zero point, computed like choose_qparams_per_token_asymmetric and
+ * quantize_per_token in torch.ao's quantized_decomposed library so that the
+ * results match the decomposed 8da4w graph.
+ */
+template <typename CTYPE>
+void quantize_token(
+    const CTYPE* in,
+    int64_t size,
+    int8_t* out,
+    float& scale,
+    int32_t& zero_point) {
+  float min = 0.0f;
+  float max = 0.0f;
+  for (const auto k : c10::irange(size)) {
+    const float v = static_cast<float>(in[k]);
+    min = std::min(min, v);
+    max = std::max(max, v);
+  }
+  scale = std::max(
+      (max - min) / static_cast<float>(kActQuantMax - kActQuantMin),
+      FLT_EPSILON);
+  const float descaled_min = min / scale;
+  const float descaled_max = max / scale;
+  const float zero_point_from_min = kActQuantMin - descaled_min;
+  const float zero_point_from_max = kActQuantMax - descaled_max;
+  const float initial_zero_point =
+      (kActQuantMin + descaled_min) + (kActQuantMax + descaled_max) > 0
+      ? zero_point_from_min
+      : zero_point_from_max;
+  zero_point = static_cast<int32_t>(std::nearbyint(std::clamp(
+      initial_zero_point,
+      static_cast<float>(kActQuantMin),
+      static_cast<float>(kActQuantMax))));
+
+  const float inv_scale = 1.0f / scale;
+  for (const auto k : c10::irange(size)) {
+    const float q =
+        std::nearbyint(static_cast<float>(in[k]) * inv_scale + zero_point);
+    out[k] = static_cast<int8_t>(std::clamp(
+        q, static_cast<float>(kActQuantMin), static_cast<float>(kActQuantMax)));
+  }
+}
+
+// The dot product steps below rely on the weights being in [-8, 7]: the
+// products of two int8 lanes then always fit in 16 bits, even in pairs.
+#if defined(__aarch64__)
+inline int32x4_t dot_step(int32x4_t acc, int8x16_t a, int8x16_t w) {
+#if defined(__ARM_FEATURE_DOTPROD)
+  return vdotq_s32(acc, a, w);
+#else
+  int16x8_t products = vmull_s8(vget_low_s8(a), vget_low_s8(w));
+  products = vmlal_high_s8(products, a, w);
+  return vpadalq_s16(acc, products);
+#endif
+}
+
+// The 32 int4 values packed in w[0, 16), high nibble first.
+inline int8x16x2_t unpack_32_nibbles(const uint8_t* w) {
+  const uint8x16_t packed = vld1q_u8(w);
+  const uint8x16x2_t values =
+      vzipq_u8(vshrq_n_u8(packed, 4), vandq_u8(packed, vdupq_n_u8(0x0F)));
+  const int8x16_t offset = vdupq_n_s8(8);
+  return {
+      vsubq_s8(vreinterpretq_s8_u8(values.val[0]), offset),
+      vsubq_s8(vreinterpretq_s8_u8(values.val[1]), offset)};
+}
+#elif defined(__AVX2__)
+inline __m256i dot_step(__m256i acc, __m256i a, __m256i w) {
+  // The instructions multiply unsigned by signed bytes, so move the sign of
+  // a over to w.
+  const __m256i abs_a = _mm256_abs_epi8(a);
+  const __m256i signed_w = _mm256_sign_epi8(w, a);
+#if defined(__AVXVNNI__)
+  return _mm256_dpbusd_avx_epi32(acc, abs_a, signed_w);
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+  return _mm256_dpbusd_epi32(acc, abs_a, signed_w);
+#else
+  return _mm256_add_epi32(
+      acc,
+      _mm256_madd_epi16(
+          _mm256_maddubs_epi16(abs_a, signed_w), _mm256_set1_epi16(1)));
+#endif
+}
+
+inline int32_t reduce_add(__m256i v) {
+  __m128i sum = _mm_add_epi32(
+      _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  sum = _mm_hadd_epi32(sum, sum);
+  sum = _mm_hadd_epi32(sum, sum);
+  return _mm_cvtsi128_si32(sum);
+}
+
+// The 32 int4 values packed in w[0, 16), high nibble first.
+inline __m256i unpack_32_nibbles(const uint8_t* w) {
+  const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(packed, 4), mask);
+  const __m128i low = _mm_and_si128(packed, mask);
+  return _mm256_sub_epi8(
+      _mm256_set_m128i(
+          _mm_unpackhi_epi8(high, low), _mm_unpacklo_epi8(high, low)),
+      _mm256_set1_epi8(8));
+}
+#endif
+
+/**
+ * Returns the sum of a[k] * w[k] over n int4 weights stored one per byte,
+ * and sets w_sum to the sum of the weights.
+ */
+int32_t dot_int4(const int8_t* a, const int8_t* w, int64_t n, int32_t& w_sum) {
+  int64_t k = 0;
+  int32_t sum = 0;
+  w_sum = 0;
+#if defined(__aarch64__)
+  const int8x16_t ones = vdupq_n_s8(1);
+  int32x4_t acc = vdupq_n_s32(0);
+  int32x4_t w_acc = vdupq_n_s32(0);
+  for (; k + 16 <= n; k += 16) {
+    const int8x16_t w_vec = vld1q_s8(w + k);
+    acc = dot_step(acc, vld1q_s8(a + k), w_vec);
+    w_acc = dot_step(w_acc, ones, w_vec);
+  }
+  sum = vaddvq_s32(acc);
+  w_sum = vaddvq_s32(w_acc);
+#elif defined(__AVX2__)
+  const __m256i ones = _mm256_set1_epi8(1);
+  __m256i acc = _mm256_setzero_si256();
+  __m256i w_acc = _mm256_setzero_si256();
+  for (; k + 32 <= n; k += 32) {
+    const __m256i w_vec =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k));
+    acc = dot_step(
+        acc,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)),
+        w_vec);
+    w_acc = dot_step(w_acc, ones, w_vec);
+  }
+  sum = reduce_add(acc);
+  w_sum = reduce_add(w_acc);
+#endif
+  for (; k < n; ++k) {
+    sum += static_cast<int32_t>(a[k]) * w[k];
+    w_sum += w[k];
+  }
+  return sum;
+}
+
+/**
+ * Like dot_int4, but with the weights packed two per byte like
+ * embedding_4bit: the value plus 8, the even ones in the high nibble. n must
+ * be even.
+ */
+int32_t dot_packed_int4(
+    const int8_t* a,
+    const uint8_t* w,
+    int64_t n,
+    int32_t& w_sum) {
+  int64_t k = 0;
+  int32_t sum = 0;
+  w_sum = 0;
+#if defined(__aarch64__)
+  const int8x16_t ones = vdupq_n_s8(1);
+  int32x4_t acc = vdupq_n_s32(0);
+  int32x4_t w_acc = vdupq_n_s32(0);
+  for (; k + 32 <= n; k += 32) {
+    const int8x16x2_t w_vec = unpack_32_nibbles(w + k / 2);
+    acc = dot_step(acc, vld1q_s8(a + k), w_vec.val[0]);
+    acc = dot_step(acc, vld1q_s8(a + k + 16), w_vec.val[1]);
+    w_acc = dot_step(w_acc, ones, w_vec.val[0]);
+    w_acc = dot_step(w_acc, ones, w_vec.val[1]);
+  }
+  sum = vaddvq_s32(acc);
+  w_sum = vaddvq_s32(w_acc);
+#elif defined(__AVX2__)
+  const __m256i ones = _mm256_set1_epi8(1);
+  __m256i acc = _mm256_setzero_si256();
+  __m256i w_acc = _mm256_setzero_si256();
+  for (; k + 32 <= n; k += 32) {
+    const __m256i w_vec = unpack_32_nibbles(w + k / 2);
+    acc = dot_step(
+        acc,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)),
+        w_vec);
+    w_acc = dot_step(w_acc, ones, w_vec);
+  }
+  sum = reduce_add(acc);
+  w_sum = reduce_add(w_acc);
+#endif
+  for (; k < n; k += 2) {
+    const int32_t w_even = (w[k / 2] >> 4) - 8;
+    const int32_t w_odd = (w[k / 2] & 0x0F) - 8;
+    sum += a[k] * w_even + a[k + 1] * w_odd;
+    w_sum += w_even + w_odd;
+  }
+  return sum;
+}
+
+bool check_linear_8da4w_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& opt_weight_zero_points,
+    int64_t group_size,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(input.dim() >= 1);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(weight));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(weight_scales));
+
+  const bool packed = weight.scalar_type() == ScalarType::Byte;
+  ET_CHECK_OR_RETURN_FALSE(
+      packed || weight.scalar_type() == ScalarType::Char,
+      "weight dtype must be int8 or packed uint8, got %" PRId8,
+      static_cast<int8_t>(weight.scalar_type()));
+
+  const int64_t in_features = input.sizes().back();
+  ET_CHECK_OR_RETURN_FALSE(
+      (packed ? 2 * weight.size(1) : weight.size(1)) == in_features,
+      "weight has %zd input features, expected %zd",
+      ssize_t(packed ? 2 * weight.size(1) : weight.size(1)),
+      ssize_t(in_features));
+  ET_CHECK_OR_RETURN_FALSE(
+      group_size > 0 && in_features % group_size == 0 &&
+          (!packed || group_size % 2 == 0),
+      "group_size %zd must divide the %zd input features, and be even for "
+      "packed weights",
+      ssize_t(group_size),
+      ssize_t(in_features));
+
+  const int64_t num_groups = in_features / group_size;
+  ET_CHECK_OR_RETURN_FALSE(
+      weight_scales.size(0) == weight.size(0) &&
+          ((weight_scales.dim() == 2 && weight_scales.size(1) == num_groups) ||
+           (weight_scales.dim() == 1 && num_groups == 1)),
+      "weight_scales must be [%zd, %zd]",
+      ssize_t(weight.size(0)),
+      ssize_t(num_groups));
+
+  if (opt_weight_zero_points.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensors_have_same_shape(opt_weight_zero_points.value(), weight_scales));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensors_have_same_dtype(opt_weight_zero_points.value(), weight_scales));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensor_is_default_dim_order(opt_weight_zero_points.value()));
+  }
+  return true;
+}
+
+} // namespace
+
+/**
+ * Computes input @ dequantize(weight).T, quantizing each token of input to
+ * int8 on the fly so that the inner products are int8 x int4 dot products
+ * with int32 accumulation. This matches the 8da4w linear decomposition:
+ *
+ *   x = dequantize_per_token(quantize_per_token(input, ...), ...)
+ *   w = dequantize_per_channel_group(weight, weight_scales,
+ *       weight_zero_points, -8, 7, int8, group_size, ...)
+ *   out = linear(x, w)
+ *
+ * weight is [out_features, in_features] int8 with values in [-8, 7], or
+ * [out_features, in_features / 2] uint8 packed like embedding_4bit. Rows of
+ * out are split between threads by output channel.
+ */
+Tensor& quantized_linear_8da4w_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& opt_weight_zero_points,
+    int64_t group_size,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_linear_8da4w_args(
+          input,
+          weight,
+          weight_scales,
+          opt_weight_zero_points,
+          group_size,
+          out),
+      InvalidArgument,
+      out);
+
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  for (const auto i : c10::irange(input.dim())) {
+    output_sizes[i] = input.size(i);
+  }
+  output_sizes[input.dim() - 1] = weight.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(
+          out, {output_sizes, static_cast<size_t>(input.dim())}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t k = input.sizes().back();
+  const int64_t m = k == 0 ? 0 : input.numel() / k;
+  const int64_t n = weight.size(0);
+  const int64_t num_groups = k / group_size;
+  const bool packed = weight.scalar_type() == ScalarType::Byte;
+  const bool has_zero_points = opt_weight_zero_points.has_value();
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // The quantized tokens, their scales and zero points, and with weight zero
+  // points, the sum of each group of each token.
+  const size_t temp_size = m * k * sizeof(int8_t) +
+      m * (sizeof(float) + sizeof(int32_t)) +
+      (has_zero_points ? m * num_groups * sizeof(int32_t) : 0);
+  Result<void*> temp = ctx.allocate_temp(temp_size, alignof(float));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      temp.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate %zu bytes of temp memory",
+      temp_size);
+  float* const act_scales = static_cast<float*>(temp.get());
+  int32_t* const act_zero_points = reinterpret_cast<int32_t*>(act_scales + m);
+  int32_t* const act_group_sums = act_zero_points + m;
+  int8_t* const act_data = reinterpret_cast<int8_t*>(
+      act_group_sums + (has_zero_points ? m * num_groups : 0));
+
+  constexpr auto name = "quantized_decomposed::linear_8da4w.out";
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    const CTYPE* const in_data = input.const_data_ptr<CTYPE>();
+    bool success = executorch::extension::parallel_for(
+        0,
+        m,
+        std::max<int64_t>(
+            1,
+            executorch::extension::internal::GRAIN_SIZE /
+                std::max<int64_t>(1, k)),
+        [&](const auto begin, const auto end) {
+          for (const auto i : c10::irange(begin, end)) {
+            int8_t* const act_row = act_data + i * k;
+            quantize_token(
+                in_data + i * k,
+                k,
+                act_row,
+                act_scales[i],
+                act_zero_points[i]);
+            if (has_zero_points) {
+              for (const auto g : c10::irange(num_groups)) {
+                int32_t sum = 0;
+                for (const auto kk : c10::irange(group_size)) {
+                  sum += act_row[g * group_size + kk];
+                }
+                act_group_sums[i * num_groups + g] = sum;
+              }
+            }
+          }
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+
+    ET_SWITCH_FLOATHBF16_TYPES(
+        weight_scales.scalar_type(), ctx, name, CTYPE_SCALES, [&]() {
+          const CTYPE_SCALES* const scales_data =
+              weight_scales.const_data_ptr<CTYPE_SCALES>();
+          const CTYPE_SCALES* const zero_points_data = has_zero_points
+              ? opt_weight_zero_points->const_data_ptr<CTYPE_SCALES>()
+              : nullptr;
+          CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+          const int64_t row_bytes = packed ? k / 2 : k;
+          const auto* const w_data =
+              static_cast<const uint8_t*>(weight.const_data_ptr());
+          success = executorch::extension::parallel_for(
+              0,
+              n,
+              std::max<int64_t>(
+                  1,
+                  executorch::extension::internal::GRAIN_SIZE /
+                      std::max<int64_t>(1, m * k)),
+              [&](const auto begin, const auto end) {
+                for (const auto j : c10::irange(begin, end)) {
+                  const uint8_t* const w_row = w_data + j * row_bytes;
+                  const CTYPE_SCALES* const w_scales =
+                      scales_data + j * num_groups;
+                  for (const auto i : c10::irange(m)) {
+                    const int8_t* const act_row = act_data + i * k;
+                    const int32_t act_zp = act_zero_points[i];
+                    float acc = 0.0f;
+                    for (const auto g : c10::irange(num_groups)) {
+                      const int64_t offset = g * group_size;
+                      int32_t w_sum = 0;
+                      int32_t dot = packed
+                          ? dot_packed_int4(
+                                act_row + offset,
+                                w_row + offset / 2,
+                                group_size,
+                                w_sum)
+                          : dot_int4(
+                                act_row + offset,
+                                reinterpret_cast<const int8_t*>(w_row) + offset,
+                                group_size,
+                                w_sum);
+                      // (a - act_zp) . (w - w_zp), expanded.
+                      dot -= act_zp * w_sum;
+                      if (zero_points_data != nullptr) {
+                        const auto w_zp = static_cast<int32_t>(std::nearbyint(
+                            static_cast<float>(
+                                zero_points_data[j * num_groups + g])));
+                        dot -= w_zp *
+                            (act_group_sums[i * num_groups + g] -
+                             act_zp * static_cast<int32_t>(group_size));
+                      }
+                      acc += static_cast<float>(dot) *
+                          static_cast<float>(w_scales[g]);
+                    }
+                    out_data[i * n + j] =
+                        static_cast<CTYPE>(acc * act_scales[i]);
+                  }
+                }
+              });
+          ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+        });
+  });
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,11 +6,15 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <type_traits>
 
 /**
  * For an input tensor, use the scale and zero_point arguments to quantize it.
@@ -105,6 +109,117 @@ T quantize_val(
   return static_cast<T>(qvalue);
 }
 
+namespace {
+
+using executorch::extension::parallel_for;
+using executorch::extension::internal::GRAIN_SIZE;
+
+// Adding and then subtracting 1.5 * 2^23 rounds a float of magnitude at most
+// 2^22 to the nearest integer, ties to even, as std::nearbyint() does in the
+// default rounding mode.
+constexpr float kRoundMagic = 12582912.0f;
+constexpr int64_t kMaxMagicRoundable = int64_t(1) << 22;
+
+bool is_contiguous(const Tensor& t) {
+#ifdef USE_ATEN_LIB
+  return t.is_contiguous();
+#else
+  return executorch::runtime::is_contiguous_dim_order(
+      t.dim_order().data(), t.dim());
+#endif
+}
+
+/**
+ * Quantizes the n contiguous elements at `in` with a single scale and zero
+ * point, giving the same values as quantize_val(). Float inputs are
+ * quantized a vector at a time. They are clamped to the quantized range
+ * before being rounded rather than after, which gives the same result since
+ * the bounds of the range are integers.
+ */
+template <typename CTYPE_IN, typename CTYPE_OUT>
+void quantize_contiguous(
+    const CTYPE_IN* in,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    CTYPE_OUT* out,
+    int64_t n) {
+  int64_t i = 0;
+  if constexpr (std::is_same_v<CTYPE_IN, float>) {
+    const int64_t lo = quant_min - zero_point;
+    const int64_t hi = quant_max - zero_point;
+    const auto roundable = [](int64_t v) {
+      return v >= -kMaxMagicRoundable && v <= kMaxMagicRoundable;
+    };
+    if (roundable(lo) && roundable(hi) && roundable(quant_min) &&
+        roundable(quant_max)) {
+      using Vec = executorch::vec::Vectorized<float>;
+      const Vec inv_scale(1.0f / static_cast<float>(scale));
+      const Vec lo_vec(static_cast<float>(lo));
+      const Vec hi_vec(static_cast<float>(hi));
+      const Vec magic(kRoundMagic);
+      float lanes[Vec::size()];
+      for (; i + static_cast<int64_t>(Vec::size()) <= n; i += Vec::size()) {
+        const Vec clamped = executorch::vec::clamp(
+            Vec::loadu(in + i) * inv_scale, lo_vec, hi_vec);
+        ((clamped + magic) - magic).store(lanes);
+        for (const auto lane : c10::irange(Vec::size())) {
+          out[i + lane] = static_cast<CTYPE_OUT>(
+              static_cast<int64_t>(lanes[lane]) + zero_point);
+        }
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    out[i] = quantize_val<CTYPE_OUT, CTYPE_IN>(
+        scale, zero_point, in[i], quant_min, quant_max);
+  }
+}
+
+/**
+ * quantize_per_channel_out() for a contiguous input, viewed as
+ * [outer, channels, inner]: each run of inner elements shares a channel, and
+ * the runs are split between threads.
+ */
+template <typename CTYPE_IN, typename CTYPE_OUT>
+[[nodiscard]] bool quantize_per_channel_contiguous(
+    const Tensor& input,
+    const double* scale_data,
+    const int64_t* zero_point_data,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  const CTYPE_IN* const in_data = input.const_data_ptr<CTYPE_IN>();
+  CTYPE_OUT* const out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  const int64_t num_channels = input.size(axis);
+  const int64_t inner_size = getTrailingDims(input, axis);
+  const int64_t num_runs = getLeadingDims(input, axis) * num_channels;
+  if (inner_size == 0) {
+    return true;
+  }
+  return parallel_for(
+      0,
+      num_runs,
+      std::max<int64_t>(1, GRAIN_SIZE / inner_size),
+      [&](const auto begin, const auto end) {
+        for (const auto run : c10::irange(begin, end)) {
+          const int64_t channel = run % num_channels;
+          quantize_contiguous(
+              in_data + run * inner_size,
+              scale_data[channel],
+              zero_point_data[channel],
+              quant_min,
+              quant_max,
+              out_data + run * inner_size,
+              inner_size);
+        }
+      });
+}
+
+} // namespace
+
 Tensor& quantize_per_tensor_out(
     const Tensor& input,
     double scale,
@@ -127,12 +242,18 @@ Tensor& quantize_per_tensor_out(
      * get inlined without LTO, particularly in ATen mode. */                  \
     auto* out_data_ptr = out.mutable_data_ptr<OUT_CTYPE>();                    \
     const auto* input_data_ptr = input.const_data_ptr<IN_CTYPE>();             \
-    const auto input_numel = input.numel();                                    \
-    for (size_t i = 0; i < input_numel; i++) {                                 \
-      IN_CTYPE value = input_data_ptr[i];                                      \
-      out_data_ptr[i] = quantize_val<OUT_CTYPE, IN_CTYPE>(                     \
-          scale, zero_point, value, quant_min, quant_max);                     \
-    }                                                                          \
+    const bool success = parallel_for(                                         \
+        0, input.numel(), GRAIN_SIZE, [&](const auto begin, const auto end) {  \
+          quantize_contiguous(                                                 \
+              input_data_ptr + begin,                                          \
+              scale,                                                           \
+              zero_point,                                                      \
+              quant_min,                                                       \
+              quant_max,                                                       \
+              out_data_ptr + begin,                                            \
+              end - begin);                                                    \
+        });                                                                    \
+    ET_CHECK_MSG(success, "parallel_for failed");                              \
   } break;
 #define CALCULATE_FLOAT_TYPE(IN_CTYPE, in_dtype)         \
   case ScalarType::in_dtype:                             \
@@ -287,11 +408,12 @@ Tensor& quantize_per_channel_out(
     if (i < axis) {
       dims[i] = i;
     } else {
-      dims[i] = i - 1;
+      dims[i] = i + 1;
     }
   }
   const double* scale_data = scale.const_data_ptr<double>();
   const int64_t* zero_point_data = zero_point.const_data_ptr<int64_t>();
+  const bool input_is_contiguous = is_contiguous(input);
 
   executorch::aten::optional<executorch::aten::ArrayRef<int64_t>>
       optional_dim_list{
@@ -307,6 +429,19 @@ Tensor& quantize_per_channel_out(
   //   in other words you are quantizing in_data[in_ix]
 #define QUANTIZE_IMPL(CTYPE_IN, CTYPE_OUT, out_dtype)                          \
   case ScalarType::out_dtype:                                                  \
+    if (input_is_contiguous) {                                                 \
+      const bool success =                                                     \
+          quantize_per_channel_contiguous<CTYPE_IN, CTYPE_OUT>(                \
+              input,                                                           \
+              scale_data,                                                      \
+              zero_point_data,                                                 \
+              axis,                                                            \
+              quant_min,                                                       \
+              quant_max,                                                       \
+              out);                                                            \
+      ET_CHECK_MSG(success, "parallel_for failed");                            \
+      break;                                                                   \
+    }                                                                          \
     for (size_t channel_ix = 0; channel_ix < input.size(axis); ++channel_ix) { \
       double _scale = scale_data[channel_ix];                                  \
       int64_t _zero_point = zero_point_data[channel_ix];                       \
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/quantized/cpu/int8_gemm.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstring>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+/// The output channels and output positions that one task computes.
+constexpr int64_t kChannelBlock = 64;
+constexpr int64_t kPositionBlock = 64;
+
+/// Returns the value of a 2d conv parameter along dimension d, where a single
+/// value applies to both dimensions.
+int64_t param_at(IntArrayRef param, size_t d) {
+  return param.size() == 1 ? param[0] : param[d];
+}
+
+bool check_quantized_conv2d_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(input, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 4));
+  ET_CHECK_OR_RETURN_FALSE(
+      input.scalar_type() == ScalarType::Char &&
+          weight.scalar_type() == ScalarType::Char &&
+          out.scalar_type() == ScalarType::Char,
+      "input, weight and out must be int8");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(weight));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(out));
+
+  for (const auto& param : {stride, padding, dilation}) {
+    ET_CHECK_OR_RETURN_FALSE(
+        param.size() == 1 || param.size() == 2,
+        "stride, padding and dilation must have 1 or 2 values");
+  }
+  for (const auto d : c10::irange(2)) {
+    ET_CHECK_OR_RETURN_FALSE(
+        param_at(stride, d) > 0 && param_at(dilation, d) > 0 &&
+            param_at(padding, d) >= 0,
+        "stride and dilation must be positive and padding non-negative");
+  }
+
+  ET_CHECK_OR_RETURN_FALSE(groups > 0, "groups must be positive");
+  const int64_t out_channels = weight.size(0);
+  ET_CHECK_OR_RETURN_FALSE(
+      input.size(1) % groups == 0 && out_channels % groups == 0 &&
+          weight.size(1) == input.size(1) / groups,
+      "weight of size [%zd, %zd, ...] does not match %zd input channels in "
+      "%" PRId64 " groups",
+      ssize_t(out_channels),
+      ssize_t(weight.size(1)),
+      ssize_t(input.size(1)),
+      groups);
+
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight_scales, 1));
+  ET_CHECK_OR_RETURN_FALSE(
+      weight_scales.scalar_type() == ScalarType::Float &&
+          weight_scales.size(0) == out_channels,
+      "weight_scales must be float [%zd]",
+      ssize_t(out_channels));
+  if (weight_zero_points.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight_zero_points.value(), 1));
+    ET_CHECK_OR_RETURN_FALSE(
+        weight_zero_points->scalar_type() == ScalarType::Long &&
+            weight_zero_points->size(0) == out_channels,
+        "weight_zero_points must be int64 [%zd]",
+        ssize_t(out_channels));
+  }
+  if (bias.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(bias.value(), 1));
+    ET_CHECK_OR_RETURN_FALSE(
+        bias->scalar_type() == ScalarType::Float &&
+            bias->size(0) == out_channels,
+        "bias must be float [%zd]",
+        ssize_t(out_channels));
+  }
+  ET_CHECK_OR_RETURN_FALSE(
+      -128 <= quant_min && quant_min <= quant_max && quant_max <= 127,
+      "[quant_min, quant_max] = [%" PRId64 ", %" PRId64
+      "] must be within the int8 range",
+      quant_min,
+      quant_max);
+  return true;
+}
+
+} // namespace
+
+/**
+ * Computes the int8 2d convolution of the int8 NCHW input with the int8
+ * weight, which matches the decomposed graph that PT2E quantization produces:
+ *
+ *   x = dequantize_per_tensor(input, input_scale, input_zero_point, ...)
+ *   w = dequantize_per_channel(weight, weight_scales, weight_zero_points, 0,
+ *       ...)
+ *   out = quantize_per_tensor(conv2d(x, w, bias, stride, padding, dilation,
+ *       groups), output_scale, output_zero_point, quant_min, quant_max, int8)
+ *
+ * For each batch and group, the input patches are gathered into rows of int8
+ * values (im2col), padded with input_zero_point so that padding dequantizes to
+ * zero. Every output is then the int8 dot product of a weight row and a patch
+ * row, from which the zero points are removed with the row sums of both, and
+ * which is rescaled, offset by the float bias and requantized like in
+ * quantized_linear. Tiles of output channels by output positions are split
+ * between threads.
+ */
+Tensor& quantized_conv2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    double input_scale,
+    int64_t input_zero_point,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    double output_scale,
+    int64_t output_zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_quantized_conv2d_args(
+          input,
+          weight,
+          weight_scales,
+          weight_zero_points,
+          bias,
+          stride,
+          padding,
+          dilation,
+          groups,
+          quant_min,
+          quant_max,
+          out),
+      InvalidArgument,
+      out);
+
+  const int64_t batch = input.size(0);
+  const int64_t in_channels = input.size(1);
+  const int64_t in_h = input.size(2);
+  const int64_t in_w = input.size(3);
+  const int64_t out_channels = weight.size(0);
+  const int64_t kernel_h = weight.size(2);
+  const int64_t kernel_w = weight.size(3);
+  const int64_t stride_h = param_at(stride, 0);
+  const int64_t stride_w = param_at(stride, 1);
+  const int64_t pad_h = param_at(padding, 0);
+  const int64_t pad_w = param_at(padding, 1);
+  const int64_t dilation_h = param_at(dilation, 0);
+  const int64_t dilation_w = param_at(dilation, 1);
+
+  const int64_t out_h =
+      (in_h + 2 * pad_h - dilation_h * (kernel_h - 1) - 1) / stride_h + 1;
+  const int64_t out_w =
+      (in_w + 2 * pad_w - dilation_w * (kernel_w - 1) - 1) / stride_w + 1;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out_h > 0 && out_w > 0,
+      InvalidArgument,
+      out,
+      "Kernel of size %zd x %zd does not fit the padded input",
+      ssize_t(kernel_h),
+      ssize_t(kernel_w));
+
+  const executorch::aten::SizesType output_sizes[] = {
+      static_cast<executorch::aten::SizesType>(batch),
+      static_cast<executorch::aten::SizesType>(out_channels),
+      static_cast<executorch::aten::SizesType>(out_h),
+      static_cast<executorch::aten::SizesType>(out_w)};
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, 4}) == Error::Ok,
+      InvalidArgument,
+      out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const int64_t group_in_channels = in_channels / groups;
+  const int64_t group_out_channels = out_channels / groups;
+  const int64_t k = group_in_channels * kernel_h * kernel_w;
+  const int64_t positions = out_h * out_w;
+
+  // The patch rows of one batch and group, their sums, the sums of the rows
+  // of weight, and the scale of each output channel.
+  const size_t temp_size = out_channels * (sizeof(float) + sizeof(int32_t)) +
+      positions * sizeof(int32_t) + positions * k;
+  Result<void*> temp = ctx.allocate_temp(temp_size, alignof(float));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      temp.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate %zu bytes of temp memory",
+      temp_size);
+  float* const channel_scales = static_cast<float*>(temp.get());
+  int32_t* const weight_sums =
+      reinterpret_cast<int32_t*>(channel_scales + out_channels);
+  int32_t* const col_sums = weight_sums + out_channels;
+  int8_t* const cols = reinterpret_cast<int8_t*>(col_sums + positions);
+
+  const int8_t* const in_data = input.const_data_ptr<int8_t>();
+  const int8_t* const w_data = weight.const_data_ptr<int8_t>();
+  const float* const w_scales = weight_scales.const_data_ptr<float>();
+  const int64_t* const w_zero_points = weight_zero_points.has_value()
+      ? weight_zero_points->const_data_ptr<int64_t>()
+      : nullptr;
+  const float* const bias_data =
+      bias.has_value() ? bias->const_data_ptr<float>() : nullptr;
+  int8_t* const out_data = out.mutable_data_ptr<int8_t>();
+
+  for (const auto c : c10::irange(out_channels)) {
+    channel_scales[c] = static_cast<float>(input_scale) * w_scales[c];
+    weight_sums[c] = internal::sum_int8(w_data + c * k, k);
+  }
+
+  const int8_t in_zp = static_cast<int8_t>(input_zero_point);
+  const float inv_out_scale = 1.0f / static_cast<float>(output_scale);
+  const int64_t channel_blocks =
+      (group_out_channels + kChannelBlock - 1) / kChannelBlock;
+  const int64_t position_blocks =
+      (positions + kPositionBlock - 1) / kPositionBlock;
+
+  for (const auto b : c10::irange(batch)) {
+    for (const auto g : c10::irange(groups)) {
+      const int8_t* const group_in =
+          in_data + (b * in_channels + g * group_in_channels) * in_h * in_w;
+      bool success = executorch::extension::parallel_for(
+          0,
+          positions,
+          std::max<int64_t>(
+              1,
+              executorch::extension::internal::GRAIN_SIZE /
+                  std::max<int64_t>(1, k)),
+          [&](const auto begin, const auto end) {
+            for (const auto p : c10::irange(begin, end)) {
+              const int64_t ih0 = p / out_w * stride_h - pad_h;
+              const int64_t iw0 = p % out_w * stride_w - pad_w;
+              int8_t* col = cols + p * k;
+              for (const auto ic : c10::irange(group_in_channels)) {
+                const int8_t* const plane = group_in + ic * in_h * in_w;
+                for (const auto kh : c10::irange(kernel_h)) {
+                  const int64_t ih = ih0 + kh * dilation_h;
+                  if (ih < 0 || ih >= in_h) {
+                    std::memset(col, in_zp, kernel_w);
+                    col += kernel_w;
+                    continue;
+                  }
+                  for (const auto kw : c10::irange(kernel_w)) {
+                    const int64_t iw = iw0 + kw * dilation_w;
+                    *col++ =
+                        iw < 0 || iw >= in_w ? in_zp : plane[ih * in_w + iw];
+                  }
+                }
+              }
+              if (w_zero_points != nullptr) {
+                col_sums[p] = internal::sum_int8(cols + p * k, k);
+              }
+            }
+          });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+      success = executorch::extension::parallel_for(
+          0,
+          channel_blocks * position_blocks,
+          1,
+          [&](const auto begin, const auto end) {
+            int32_t acc[kChannelBlock * kPositionBlock];
+            for (const auto task : c10::irange(begin, end)) {
+              const int64_t c_begin = task / position_blocks * kChannelBlock;
+              const int64_t p_begin = task % position_blocks * kPositionBlock;
+              const int64_t c_block =
+                  std::min(kChannelBlock, group_out_channels - c_begin);
+              const int64_t p_block =
+                  std::min(kPositionBlock, positions - p_begin);
+              const int64_t oc_begin = g * group_out_channels + c_begin;
+              internal::gemm_int8_nt(
+                  c_block,
+                  p_block,
+                  k,
+                  w_data + oc_begin * k,
+                  k,
+                  cols + p_begin * k,
+                  k,
+                  acc,
+                  kPositionBlock);
+              for (const auto cc : c10::irange(c_block)) {
+                const int64_t oc = oc_begin + cc;
+                const int64_t w_zp =
+                    w_zero_points == nullptr ? 0 : w_zero_points[oc];
+                const int64_t offset = k * int64_t(in_zp) * w_zp -
+                    int64_t(in_zp) * weight_sums[oc];
+                const float out_bias =
+                    bias_data == nullptr ? 0.0f : bias_data[oc];
+                int8_t* const out_row =
+                    out_data + (b * out_channels + oc) * positions + p_begin;
+                for (const auto pp : c10::irange(p_block)) {
+                  // sum((x - x_zp) * (w - w_zp)), expanded.
+                  int64_t dot = acc[cc * kPositionBlock + pp] + offset;
+                  if (w_zero_points != nullptr) {
+                    dot -= w_zp * col_sums[p_begin + pp];
+                  }
+                  out_row[pp] = internal::requantize_int8(
+                      channel_scales[oc] * static_cast<float>(dot) + out_bias,
+                      inv_out_scale,
+                      static_cast<int32_t>(output_zero_point),
+                      static_cast<int32_t>(quant_min),
+                      static_cast<int32_t>(quant_max));
+                }
+              }
+            }
+          });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+    }
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/quantized/cpu/int8_gemm.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+/// The output channels that one task computes for one row of input.
+constexpr int64_t kChannelBlock = 64;
+
+bool check_quantized_linear_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(input.dim() >= 1);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 2));
+  ET_CHECK_OR_RETURN_FALSE(
+      input.scalar_type() == ScalarType::Char &&
+          weight.scalar_type() == ScalarType::Char &&
+          out.scalar_type() == ScalarType::Char,
+      "input, weight and out must be int8");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(weight));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(out));
+  ET_CHECK_OR_RETURN_FALSE(
+      weight.size(1) == input.sizes().back(),
+      "weight has %zd input features, expected %zd",
+      ssize_t(weight.size(1)),
+      ssize_t(input.sizes().back()));
+
+  const int64_t out_features = weight.size(0);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight_scales, 1));
+  ET_CHECK_OR_RETURN_FALSE(
+      weight_scales.scalar_type() == ScalarType::Float &&
+          weight_scales.size(0) == out_features,
+      "weight_scales must be float [%zd]",
+      ssize_t(out_features));
+  if (weight_zero_points.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight_zero_points.value(), 1));
+    ET_CHECK_OR_RETURN_FALSE(
+        weight_zero_points->scalar_type() == ScalarType::Long &&
+            weight_zero_points->size(0) == out_features,
+        "weight_zero_points must be int64 [%zd]",
+        ssize_t(out_features));
+  }
+  if (bias.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(bias.value(), 1));
+    ET_CHECK_OR_RETURN_FALSE(
+        bias->scalar_type() == ScalarType::Float &&
+            bias->size(0) == out_features,
+        "bias must be float [%zd]",
+        ssize_t(out_features));
+  }
+  ET_CHECK_OR_RETURN_FALSE(
+      -128 <= quant_min && quant_min <= quant_max && quant_max <= 127,
+      "[quant_min, quant_max] = [%" PRId64 ", %" PRId64
+      "] must be within the int8 range",
+      quant_min,
+      quant_max);
+  return true;
+}
+
+} // namespace
+
+/**
+ * Computes the int8 linear of the int8 input with the int8 weight, which
+ * matches the decomposed graph that PT2E quantization produces:
+ *
+ *   x = dequantize_per_tensor(input, input_scale, input_zero_point, ...)
+ *   w = dequantize_per_channel(weight, weight_scales, weight_zero_points, 0,
+ *       ...)
+ *   out = quantize_per_tensor(linear(x, w, bias), output_scale,
+ *       output_zero_point, quant_min, quant_max, int8)
+ *
+ * The inner products are int8 dot products with int32 accumulation, from
+ * which the zero points are removed with the row sums of input and weight.
+ * Each output channel is then rescaled by input_scale * weight_scales[c],
+ * offset by the float bias, and requantized. Blocks of output channels are
+ * split between threads, and each task keeps its block of weight rows in
+ * cache across consecutive rows of input.
+ */
+Tensor& quantized_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    double input_scale,
+    int64_t input_zero_point,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const executorch::aten::optional<Tensor>& weight_zero_points,
+    const executorch::aten::optional<Tensor>& bias,
+    double output_scale,
+    int64_t output_zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_quantized_linear_args(
+          input,
+          weight,
+          weight_scales,
+          weight_zero_points,
+          bias,
+          quant_min,
+          quant_max,
+          out),
+      InvalidArgument,
+      out);
+
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  for (const auto i : c10::irange(input.dim())) {
+    output_sizes[i] = input.size(i);
+  }
+  output_sizes[input.dim() - 1] = weight.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(
+          out, {output_sizes, static_cast<size_t>(input.dim())}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t k = input.sizes().back();
+  const int64_t n = weight.size(0);
+  const int64_t m = k == 0 ? out.numel() / std::max<int64_t>(n, 1)
+                           : input.numel() / k;
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // The sums of the rows of weight, and the scale of each output channel.
+  const size_t temp_size = n * (sizeof(int32_t) + sizeof(float));
+  Result<void*> temp = ctx.allocate_temp(temp_size, alignof(float));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      temp.ok(),
+      MemoryAllocationFailed,
+      out,
+      "Failed to allocate %zu bytes of temp memory",
+      temp_size);
+  float* const channel_scales = static_cast<float*>(temp.get());
+  int32_t* const weight_sums = reinterpret_cast<int32_t*>(channel_scales + n);
+
+  const int8_t* const in_data = input.const_data_ptr<int8_t>();
+  const int8_t* const w_data = weight.const_data_ptr<int8_t>();
+  const float* const w_scales = weight_scales.const_data_ptr<float>();
+  const int64_t* const w_zero_points = weight_zero_points.has_value()
+      ? weight_zero_points->const_data_ptr<int64_t>()
+      : nullptr;
+  const float* const bias_data =
+      bias.has_value() ? bias->const_data_ptr<float>() : nullptr;
+  int8_t* const out_data = out.mutable_data_ptr<int8_t>();
+
+  for (const auto j : c10::irange(n)) {
+    channel_scales[j] = static_cast<float>(input_scale) * w_scales[j];
+    weight_sums[j] = internal::sum_int8(w_data + j * k, k);
+  }
+
+  const int32_t in_zp = static_cast<int32_t>(input_zero_point);
+  const float inv_out_scale = 1.0f / static_cast<float>(output_scale);
+  const int64_t num_blocks = (n + kChannelBlock - 1) / kChannelBlock;
+  const bool success = executorch::extension::parallel_for(
+      0,
+      num_blocks * m,
+      std::max<int64_t>(
+          1,
+          executorch::extension::internal::GRAIN_SIZE /
+              std::max<int64_t>(1, kChannelBlock * k)),
+      [&](const auto begin, const auto end) {
+        int32_t acc[kChannelBlock];
+        for (const auto task : c10::irange(begin, end)) {
+          // Consecutive tasks share a block of weight rows.
+          const int64_t j_begin = task / m * kChannelBlock;
+          const int64_t i = task % m;
+          const int64_t block = std::min(kChannelBlock, n - j_begin);
+          const int8_t* const in_row = in_data + i * k;
+          internal::gemm_int8_nt(
+              1, block, k, in_row, k, w_data + j_begin * k, k, acc, block);
+          const int32_t in_sum =
+              w_zero_points == nullptr ? 0 : internal::sum_int8(in_row, k);
+          int8_t* const out_row = out_data + i * n;
+          for (const auto jj : c10::irange(block)) {
+            const int64_t j = j_begin + jj;
+            const int64_t w_zp =
+                w_zero_points == nullptr ? 0 : w_zero_points[j];
+            // sum((x - x_zp) * (w - w_zp)), expanded.
+            const int64_t dot = acc[jj] - int64_t(in_zp) * weight_sums[j] -
+                w_zp * in_sum + k * int64_t(in_zp) * w_zp;
+            float value = channel_scales[j] * static_cast<float>(dot);
+            if (bias_data != nullptr) {
+              value += bias_data[j];
+            }
+            out_row[j] = internal::requantize_int8(
+                value,
+                inv_out_scale,
+                static_cast<int32_t>(output_zero_point),
+                static_cast<int32_t>(quant_min),
+                static_cast<int32_t>(quant_max));
+          }
+        }
+      });
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
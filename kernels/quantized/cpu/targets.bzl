@@ -8,13 +8,16 @@ _QUANT_OPS = (
     op_target(
         name = "op_choose_qparams",
         deps = [
-            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
         name = "op_dequantize",
         deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
         _aten_mode_deps = [
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
@@ -37,6 +40,12 @@ _QUANT_OPS = (
             "//executorch/kernels/quantized/cpu:embeddingxb_aten",
         ],
     ),
+    op_target(
+        name = "op_linear_8da4w",
+        deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_mixed_mm",
         deps = [
@@ -52,12 +61,28 @@ _QUANT_OPS = (
     op_target(
         name = "op_quantize",
         deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
         _aten_mode_deps = [
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
         ],
     ),
+    op_target(
+        name = "op_quantized_conv2d",
+        deps = [
+            "//executorch/kernels/quantized/cpu:int8_gemm",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_quantized_linear",
+        deps = [
+            "//executorch/kernels/quantized/cpu:int8_gemm",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
 )
 
 def define_common_targets():
@@ -76,6 +101,18 @@ def define_common_targets():
         exported_deps = quant_op_targets,
     )
 
+    runtime.cxx_library(
+        name = "int8_gemm",
+        srcs = [],
+        exported_headers = ["int8_gemm.h"],
+        exported_deps = [
+            "//executorch/runtime/core/portable_type/c10/c10:c10",
+        ],
+        visibility = [
+            "//executorch/kernels/quantized/...",
+        ],
+    )
+
     runtime.cxx_library(
         name = "embeddingxb",
         srcs = ["embeddingxb.cpp"],
@@ -83,7 +120,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes"],
+        deps = [
+            "//executorch/runtime/kernel:kernel_includes",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     )
 
     runtime.cxx_library(
@@ -93,7 +133,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes_aten"],
+        deps = [
+            "//executorch/runtime/kernel:kernel_includes_aten",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     )
 
     runtime.cxx_library(
@@ -21,6 +21,7 @@ def define_common_targets():
             "quantized_decomposed::dequantize_per_tensor.out",
             "quantized_decomposed::dequantize_per_tensor.Tensor_out",
             "quantized_decomposed::dequantize_per_token.out",
+            "quantized_decomposed::linear_8da4w.out",
             "quantized_decomposed::mixed_linear.out",
             "quantized_decomposed::mixed_mm.out",
             "quantized_decomposed::quantize_per_channel.out",
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -163,3 +164,49 @@ TEST(OpChooseQparamsPerTokenAsymmetricTensorOutTest, DynamicShapeFloat) {
   EXPECT_TENSOR_CLOSE_WITH_TOL(scale_out, new_expected_scale, 1e-4, 1e-4);
   EXPECT_TENSOR_EQ(zero_point_out, new_expected_zero_point);
 }
+
+TEST(OpChooseQparamsPerTokenAsymmetricTensorOutTest, MatchesPerTensor) {
+  et_pal_init();
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Each token's qparams should be the ones chosen for the token on its own.
+  constexpr int32_t kNumTokens = 33;
+  constexpr int32_t kTokenSize = 45;
+  std::vector<float> input_data(kNumTokens * kTokenSize);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] =
+        static_cast<float>((i * 37) % 101) * 0.03f - 1.5f + (i / kTokenSize);
+  }
+  Tensor scale_out = tf_double.zeros({kNumTokens, 1});
+  Tensor zero_point_out = tf_long.zeros({kNumTokens, 1});
+  choose_qparams_per_token_asymmetric_out(
+      tf_float.make({kNumTokens, kTokenSize}, input_data),
+      ScalarType::Float,
+      scale_out,
+      zero_point_out);
+
+  for (int32_t token = 0; token < kNumTokens; ++token) {
+    Tensor token_scale = tf_double.zeros({1});
+    Tensor token_zero_point = tf_long.zeros({1});
+    choose_qparams_tensor_out(
+        tf_float.make(
+            {kTokenSize},
+            std::vector<float>(
+                input_data.begin() + token * kTokenSize,
+                input_data.begin() + (token + 1) * kTokenSize)),
+        -128,
+        127,
+        0.0,
+        ScalarType::Char,
+        token_scale,
+        token_zero_point);
+    EXPECT_EQ(
+        scale_out.const_data_ptr<double>()[token],
+        token_scale.const_data_ptr<double>()[0]);
+    EXPECT_EQ(
+        zero_point_out.const_data_ptr<int64_t>()[token],
+        token_zero_point.const_data_ptr<int64_t>()[0]);
+  }
+}
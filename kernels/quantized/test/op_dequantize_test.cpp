@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -229,3 +230,49 @@ TEST(OpDequantizeOutTest, DequantizePerChannel) {
   test_per_channel_dtype<ScalarType::Byte>();
   test_per_channel_dtype<ScalarType::Char>();
 }
+
+template <ScalarType DTYPE, ScalarType OUT_DTYPE>
+void test_per_channel_3d() {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  using CTYPE_OUT = typename TensorFactory<OUT_DTYPE>::ctype;
+  TensorFactory<DTYPE> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+  TensorFactory<OUT_DTYPE> tfo;
+
+  std::vector<CTYPE> input_data(2 * 3 * 37);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<CTYPE>(i % 100);
+  }
+  const std::vector<double> scales = {0.5, 0.25, 2};
+  const std::vector<int64_t> zero_points = {10, 20, 30};
+  std::vector<CTYPE_OUT> expected_data(input_data.size());
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    const size_t channel = i / 37 % 3;
+    expected_data[i] = static_cast<CTYPE_OUT>(
+        (input_data[i] - zero_points[channel]) *
+        static_cast<float>(scales[channel]));
+  }
+
+  Tensor out = tfo.zeros({2, 3, 37});
+  dequantize_per_channel_out(
+      tf.make({2, 3, 37}, input_data),
+      tf_double.make({3}, scales),
+      tf_long.make({3}, zero_points),
+      /*axis=*/1,
+      0,
+      100,
+      DTYPE,
+      optional<ScalarType>(),
+      out);
+
+  EXPECT_TENSOR_EQ(out, tfo.make({2, 3, 37}, expected_data));
+}
+
+TEST(OpDequantizeOutTest, DequantizePerChannel3D) {
+  et_pal_init();
+  test_per_channel_3d<ScalarType::Byte, ScalarType::Float>();
+  test_per_channel_3d<ScalarType::Char, ScalarType::Float>();
+  test_per_channel_3d<ScalarType::Short, ScalarType::Float>();
+  test_per_channel_3d<ScalarType::Byte, ScalarType::Double>();
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
@@ -15,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <utility>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -22,6 +24,7 @@ using executorch::aten::optional;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
 using executorch::runtime::KernelRuntimeContext;
+using torch::executor::native::quantized_embedding_4bit_dtype_out;
 using torch::executor::native::quantized_embedding_4bit_out;
 
 using torch::executor::testing::TensorFactory;
@@ -101,6 +104,83 @@ TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbedding) {
   EXPECT_TENSOR_EQ(out, expected);
 }
 
+namespace {
+
+// Dequantizes rows of random 4-bit weights of shape
+// [num_embeddings, packed_dim], with num_groups groups per row, to
+// DTYPE_OUT, and checks them against a scalar reference. The scales and
+// zero points are DTYPE_OUT too.
+template <ScalarType DTYPE_OUT>
+void test_many_rows(int32_t packed_dim, int32_t num_groups) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Long> tfl;
+  TensorFactory<DTYPE_OUT> tf_out;
+  using CTYPE_OUT = typename TensorFactory<DTYPE_OUT>::ctype;
+
+  constexpr int32_t kNumEmbeddings = 41;
+  const int32_t embedding_dim = 2 * packed_dim;
+  const int32_t group_size = embedding_dim / num_groups;
+
+  std::vector<uint8_t> weight_data(kNumEmbeddings * packed_dim);
+  for (const auto i : c10::irange(weight_data.size())) {
+    weight_data[i] = static_cast<uint8_t>((i * 113 + 7) % 256);
+  }
+  std::vector<CTYPE_OUT> scales_data(kNumEmbeddings * num_groups);
+  std::vector<CTYPE_OUT> zero_points_data(kNumEmbeddings * num_groups);
+  for (const auto i : c10::irange(scales_data.size())) {
+    scales_data[i] = static_cast<CTYPE_OUT>(0.25f + 0.125f * (i % 17));
+    zero_points_data[i] = static_cast<CTYPE_OUT>(static_cast<int>(i % 5) - 2);
+  }
+
+  std::vector<int64_t> indices_data(300);
+  std::vector<CTYPE_OUT> expected_data;
+  for (const auto i : c10::irange(indices_data.size())) {
+    const int64_t row = (i * 13) % kNumEmbeddings;
+    indices_data[i] = row;
+    for (const auto j : c10::irange(embedding_dim)) {
+      const uint8_t byte = weight_data[row * packed_dim + j / 2];
+      const int32_t value =
+          static_cast<int32_t>(j % 2 == 0 ? byte >> 4 : byte & 0x0F) - 8;
+      const int64_t group = row * num_groups + j / group_size;
+      expected_data.push_back(static_cast<CTYPE_OUT>(
+          (static_cast<float>(value) -
+           static_cast<float>(zero_points_data[group])) *
+          static_cast<float>(scales_data[group])));
+    }
+  }
+
+  const std::vector<int32_t> qparams_sizes = {kNumEmbeddings, num_groups};
+  const std::vector<int32_t> out_sizes = {
+      static_cast<int32_t>(indices_data.size()), embedding_dim};
+  Tensor out = tf_out.zeros(out_sizes);
+  quantized_embedding_4bit_dtype_out(
+      tfb.make({kNumEmbeddings, packed_dim}, weight_data),
+      tf_out.make(qparams_sizes, scales_data),
+      tf_out.make(qparams_sizes, zero_points_data),
+      /*weight_quant_min=*/-8,
+      /*weight_quant_max=*/7,
+      tfl.make({static_cast<int32_t>(indices_data.size())}, indices_data),
+      DTYPE_OUT,
+      out);
+  EXPECT_TENSOR_EQ(out, tf_out.make(out_sizes, expected_data));
+}
+
+} // namespace
+
+TEST(OpQuantizedEmbedding4bTest, ManyRows) {
+  et_pal_init();
+  // Groups of varying sizes, including odd ones that start mid-byte.
+  for (const auto& [packed_dim, num_groups] :
+       {std::pair<int32_t, int32_t>{64, 1},
+        {64, 4},
+        {51, 2},
+        {45, 6}}) {
+    test_many_rows<ScalarType::Float>(packed_dim, num_groups);
+    test_many_rows<ScalarType::Half>(packed_dim, num_groups);
+    test_many_rows<ScalarType::BFloat16>(packed_dim, num_groups);
+  }
+}
+
 TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbeddingDeath1) {
   et_pal_init();
   TensorFactory<ScalarType::Byte> tfb;
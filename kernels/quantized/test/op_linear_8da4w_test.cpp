@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the aten operator
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using torch::executor::native::quantized_linear_8da4w_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+std::vector<float> make_data(size_t n, uint32_t seed, float range) {
+  std::vector<float> data(n);
+  for (auto& x : data) {
+    seed = seed * 1664525u + 1013904223u;
+    x = (static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) - 0.5f) *
+        range;
+  }
+  return data;
+}
+
+std::vector<int8_t> make_int4_data(size_t n, uint32_t seed) {
+  std::vector<int8_t> data(n);
+  for (auto& x : data) {
+    seed = seed * 1664525u + 1013904223u;
+    x = static_cast<int8_t>(static_cast<int32_t>((seed >> 16) % 16) - 8);
+  }
+  return data;
+}
+
+// Two values per byte, plus 8, the even ones in the high nibble.
+std::vector<uint8_t> pack_int4(const std::vector<int8_t>& values) {
+  std::vector<uint8_t> packed(values.size() / 2);
+  for (size_t i = 0; i < packed.size(); ++i) {
+    packed[i] = static_cast<uint8_t>(
+        ((values[2 * i] + 8) << 4) | (values[2 * i + 1] + 8));
+  }
+  return packed;
+}
+
+// The decomposed 8da4w graph: per-token fake quantization of the input, then
+// a float linear with the dequantized weight.
+std::vector<float> reference_linear_8da4w(
+    const std::vector<float>& input,
+    const std::vector<int8_t>& weight,
+    const std::vector<float>& scales,
+    const std::vector<float>& zero_points,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    int64_t group_size) {
+  const int64_t num_groups = k / group_size;
+  std::vector<float> out(m * n);
+  for (int64_t i = 0; i < m; ++i) {
+    const float* row = input.data() + i * k;
+    float min = 0.0f;
+    float max = 0.0f;
+    for (int64_t kk = 0; kk < k; ++kk) {
+      min = std::min(min, row[kk]);
+      max = std::max(max, row[kk]);
+    }
+    const float scale = std::max((max - min) / 255.0f, FLT_EPSILON);
+    const float zp_from_min = -128.0f - min / scale;
+    const float zp_from_max = 127.0f - max / scale;
+    const float zp = std::nearbyint(std::clamp(
+        (-128.0f + min / scale) + (127.0f + max / scale) > 0 ? zp_from_min
+                                                              : zp_from_max,
+        -128.0f,
+        127.0f));
+    std::vector<float> x(k);
+    for (int64_t kk = 0; kk < k; ++kk) {
+      const float q =
+          std::clamp(std::nearbyint(row[kk] / scale + zp), -128.0f, 127.0f);
+      x[kk] = (q - zp) * scale;
+    }
+    for (int64_t j = 0; j < n; ++j) {
+      float acc = 0.0f;
+      for (int64_t kk = 0; kk < k; ++kk) {
+        const int64_t g = j * num_groups + kk / group_size;
+        const float w_zp = zero_points.empty() ? 0.0f : zero_points[g];
+        acc += x[kk] * (weight[j * k + kk] - w_zp) * scales[g];
+      }
+      out[i * n + j] = acc;
+    }
+  }
+  return out;
+}
+
+class OpQuantizedLinear8da4wTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  KernelRuntimeContext make_context() {
+    temp_allocator_.reset();
+    return KernelRuntimeContext(nullptr, &temp_allocator_);
+  }
+
+  // Checks the kernel against the decomposed graph for an input of the given
+  // sizes, with Char and with packed weights.
+  void test_shape(
+      const std::vector<int32_t>& input_sizes,
+      int64_t n,
+      int64_t group_size,
+      bool with_zero_points) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Char> tf_char;
+    TensorFactory<ScalarType::Byte> tf_byte;
+
+    const int64_t k = input_sizes.back();
+    int64_t m = 1;
+    for (size_t d = 0; d + 1 < input_sizes.size(); ++d) {
+      m *= input_sizes[d];
+    }
+    const int64_t num_groups = k / group_size;
+    const auto input_data = make_data(m * k, 1, 4.0f);
+    const auto weight_data = make_int4_data(n * k, 2);
+    auto scales_data = make_data(n * num_groups, 3, 0.1f);
+    for (auto& s : scales_data) {
+      s = std::abs(s) + 0.01f;
+    }
+    std::vector<float> zero_points_data;
+    if (with_zero_points) {
+      for (const auto w : make_int4_data(n * num_groups, 4)) {
+        zero_points_data.push_back(w / 4);
+      }
+    }
+
+    std::vector<int32_t> out_sizes = input_sizes;
+    out_sizes.back() = n;
+    const Tensor expected = tf.make(
+        out_sizes,
+        reference_linear_8da4w(
+            input_data,
+            weight_data,
+            scales_data,
+            zero_points_data,
+            m,
+            n,
+            k,
+            group_size));
+
+    const Tensor input = tf.make(input_sizes, input_data);
+    const Tensor scales = tf.make(
+        {static_cast<int32_t>(n), static_cast<int32_t>(num_groups)},
+        scales_data);
+    optional<Tensor> zero_points;
+    if (with_zero_points) {
+      zero_points = tf.make(
+          {static_cast<int32_t>(n), static_cast<int32_t>(num_groups)},
+          zero_points_data);
+    }
+
+    const Tensor weight = tf_char.make(
+        {static_cast<int32_t>(n), static_cast<int32_t>(k)}, weight_data);
+    Tensor out = tf.zeros(out_sizes);
+    KernelRuntimeContext ctx = make_context();
+    quantized_linear_8da4w_out(
+        ctx, input, weight, scales, zero_points, group_size, out);
+    ASSERT_EQ(ctx.failure_state(), Error::Ok);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-4);
+
+    if (group_size % 2 == 0) {
+      const Tensor packed_weight = tf_byte.make(
+          {static_cast<int32_t>(n), static_cast<int32_t>(k / 2)},
+          pack_int4(weight_data));
+      Tensor packed_out = tf.zeros(out_sizes);
+      ctx = make_context();
+      quantized_linear_8da4w_out(
+          ctx,
+          input,
+          packed_weight,
+          scales,
+          zero_points,
+          group_size,
+          packed_out);
+      ASSERT_EQ(ctx.failure_state(), Error::Ok);
+      EXPECT_TENSOR_EQ(packed_out, out);
+    }
+  }
+
+ private:
+  alignas(16) uint8_t temp_buffer_[64 * 1024];
+  MemoryAllocator temp_allocator_{sizeof(temp_buffer_), temp_buffer_};
+};
+
+} // namespace
+
+TEST_F(OpQuantizedLinear8da4wTest, SmallExample) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // The input quantizes exactly with scale 1/51 and zero point -128.
+  Tensor input = tf.make({1, 4}, {0.0, 1.0, 2.0, 5.0});
+  Tensor weight = tf_char.make({2, 4}, {1, 2, 3, 4, -8, 7, 0, -1});
+  Tensor weight_scales = tf.make({2, 2}, {0.5, 0.25, 1.0, 2.0});
+  Tensor out = tf.zeros({1, 2});
+
+  KernelRuntimeContext ctx = make_context();
+  quantized_linear_8da4w_out(
+      ctx, input, weight, weight_scales, {}, /*group_size=*/2, out);
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  // 0.5 * (0 + 2) + 0.25 * (6 + 20), 1 * (0 + 7) + 2 * (0 - 5)
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 2}, {7.5, -3.0}));
+}
+
+TEST_F(OpQuantizedLinear8da4wTest, MatchesDecomposedGraph) {
+  test_shape({3, 64}, 5, 32, /*with_zero_points=*/false);
+}
+
+TEST_F(OpQuantizedLinear8da4wTest, MatchesDecomposedGraphWithZeroPoints) {
+  test_shape({3, 64}, 5, 32, /*with_zero_points=*/true);
+}
+
+TEST_F(OpQuantizedLinear8da4wTest, BatchedInputWithTails) {
+  // Groups shorter than a vector, plus a group size that isn't a multiple of
+  // the vector length.
+  test_shape({2, 3, 48}, 7, 8, /*with_zero_points=*/true);
+  test_shape({2, 2, 120}, 3, 40, /*with_zero_points=*/false);
+}
+
+TEST_F(OpQuantizedLinear8da4wTest, RejectsGroupSizeNotDividingK) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf.ones({1, 6});
+  Tensor weight = tf_char.zeros({2, 6});
+  Tensor weight_scales = tf.ones({2, 2});
+  Tensor out = tf.zeros({1, 2});
+
+  KernelRuntimeContext ctx = make_context();
+  quantized_linear_8da4w_out(
+      ctx, input, weight, weight_scales, {}, /*group_size=*/4, out);
+  EXPECT_EQ(ctx.failure_state(), Error::InvalidArgument);
+}
+
+TEST_F(OpQuantizedLinear8da4wTest, FailsWithoutTempAllocator) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf.ones({1, 4});
+  Tensor weight = tf_char.zeros({2, 4});
+  Tensor weight_scales = tf.ones({2});
+  Tensor out = tf.zeros({1, 2});
+
+  KernelRuntimeContext ctx{};
+  quantized_linear_8da4w_out(
+      ctx, input, weight, weight_scales, {}, /*group_size=*/4, out);
+  EXPECT_EQ(ctx.failure_state(), Error::MemoryAllocationFailed);
+}
@@ -14,7 +14,9 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -141,3 +143,66 @@ TEST(OpQuantizeOutTest, QuantizePerChannel) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpQuantizeOutTest, RoundsHalfToEvenAndClamps) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Char> tfo;
+
+  // Multiples of 0.25 quantized with a scale of 0.5 land on every half
+  // integer, in more elements than fit in a couple of vectors.
+  std::vector<float> input_data;
+  std::vector<int8_t> expected_data;
+  const int64_t zero_point = 3;
+  for (int i = -300; i < 301; ++i) {
+    const float value = 0.25f * i;
+    input_data.push_back(value);
+    const float q = zero_point + std::nearbyint(value / 0.5f);
+    expected_data.push_back(
+        static_cast<int8_t>(std::min(127.f, std::max(-128.f, q))));
+  }
+  const auto size = static_cast<int32_t>(input_data.size());
+  Tensor input = tf_float.make({size}, input_data);
+  Tensor out = tfo.zeros({size});
+  quantize_per_tensor_out(
+      input, 0.5, zero_point, -128, 127, ScalarType::Char, out);
+
+  EXPECT_TENSOR_EQ(out, tfo.make({size}, expected_data));
+}
+
+TEST(OpQuantizeOutTest, QuantizePerChannel3D) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+  TensorFactory<ScalarType::Byte> tfo;
+
+  std::vector<float> input_data(2 * 3 * 20);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>(i % 7);
+  }
+  Tensor input = tf_float.make({2, 3, 20}, input_data);
+  const std::vector<double> scales = {0.5, 1, 2};
+  const std::vector<int64_t> zero_points = {10, 20, 30};
+
+  for (const int64_t axis : {0, 1}) {
+    const int64_t num_channels = input.size(axis);
+    std::vector<uint8_t> expected_data(input_data.size());
+    for (size_t i = 0; i < input_data.size(); ++i) {
+      const size_t channel = axis == 0 ? i / 60 : i / 20 % 3;
+      expected_data[i] = static_cast<uint8_t>(
+          zero_points[channel] +
+          std::nearbyint(input_data[i] / static_cast<float>(scales[channel])));
+    }
+    Tensor scale = tf_double.make(
+        {static_cast<int32_t>(num_channels)},
+        std::vector<double>(scales.begin(), scales.begin() + num_channels));
+    Tensor zero_point = tf_long.make(
+        {static_cast<int32_t>(num_channels)},
+        std::vector<int64_t>(
+            zero_points.begin(), zero_points.begin() + num_channels));
+    Tensor out = tfo.zeros({2, 3, 20});
+    quantize_per_channel_out(
+        input, scale, zero_point, axis, 0, 255, ScalarType::Byte, out);
+
+    EXPECT_TENSOR_EQ(out, tfo.make({2, 3, 20}, expected_data));
+  }
+}
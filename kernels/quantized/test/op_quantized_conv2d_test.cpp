@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the aten operator
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ArrayRef;
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using torch::executor::native::quantized_conv2d_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+std::vector<int8_t> make_int8_data(size_t n, uint32_t seed) {
+  std::vector<int8_t> data(n);
+  for (auto& x : data) {
+    seed = seed * 1664525u + 1013904223u;
+    x = static_cast<int8_t>(static_cast<int32_t>((seed >> 16) % 256) - 128);
+  }
+  return data;
+}
+
+struct ConvParams {
+  int64_t batch;
+  int64_t in_channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_channels;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride;
+  int64_t padding;
+  int64_t dilation;
+  int64_t groups;
+
+  int64_t out_h() const {
+    return (in_h + 2 * padding - dilation * (kernel_h - 1) - 1) / stride + 1;
+  }
+  int64_t out_w() const {
+    return (in_w + 2 * padding - dilation * (kernel_w - 1) - 1) / stride + 1;
+  }
+};
+
+// The decomposed graph: dequantize input and weight, a conv2d in double with
+// zero padding, then quantize_per_tensor.
+std::vector<int8_t> reference_quantized_conv2d(
+    const ConvParams& p,
+    const std::vector<int8_t>& input,
+    double input_scale,
+    int64_t input_zero_point,
+    const std::vector<int8_t>& weight,
+    const std::vector<float>& weight_scales,
+    const std::vector<int64_t>& weight_zero_points,
+    const std::vector<float>& bias,
+    double output_scale,
+    int64_t output_zero_point) {
+  const int64_t out_h = p.out_h();
+  const int64_t out_w = p.out_w();
+  const int64_t group_in = p.in_channels / p.groups;
+  const int64_t group_out = p.out_channels / p.groups;
+  std::vector<int8_t> out(p.batch * p.out_channels * out_h * out_w);
+  for (int64_t b = 0; b < p.batch; ++b) {
+    for (int64_t oc = 0; oc < p.out_channels; ++oc) {
+      const int64_t g = oc / group_out;
+      const int64_t w_zp =
+          weight_zero_points.empty() ? 0 : weight_zero_points[oc];
+      for (int64_t oh = 0; oh < out_h; ++oh) {
+        for (int64_t ow = 0; ow < out_w; ++ow) {
+          double acc = bias.empty() ? 0.0 : bias[oc];
+          for (int64_t ic = 0; ic < group_in; ++ic) {
+            for (int64_t kh = 0; kh < p.kernel_h; ++kh) {
+              for (int64_t kw = 0; kw < p.kernel_w; ++kw) {
+                const int64_t ih = oh * p.stride - p.padding + kh * p.dilation;
+                const int64_t iw = ow * p.stride - p.padding + kw * p.dilation;
+                if (ih < 0 || ih >= p.in_h || iw < 0 || iw >= p.in_w) {
+                  continue;
+                }
+                const int64_t x = input
+                    [((b * p.in_channels + g * group_in + ic) * p.in_h + ih) *
+                         p.in_w +
+                     iw];
+                const int64_t w = weight
+                    [((oc * group_in + ic) * p.kernel_h + kh) * p.kernel_w +
+                     kw];
+                acc += (x - input_zero_point) * input_scale * (w - w_zp) *
+                    weight_scales[oc];
+              }
+            }
+          }
+          const double q =
+              output_zero_point + std::nearbyint(acc / output_scale);
+          out[((b * p.out_channels + oc) * out_h + oh) * out_w + ow] =
+              static_cast<int8_t>(std::clamp(q, -128.0, 127.0));
+        }
+      }
+    }
+  }
+  return out;
+}
+
+class OpQuantizedConv2dTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  KernelRuntimeContext make_context() {
+    temp_allocator_.reset();
+    return KernelRuntimeContext(nullptr, &temp_allocator_);
+  }
+
+  // Checks the kernel against the decomposed graph. The kernel rescales in
+  // float, so a result that lies close to a rounding boundary may end up one
+  // step away from the double reference.
+  void test_params(const ConvParams& p, bool with_zero_points, bool with_bias) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Char> tf_char;
+    TensorFactory<ScalarType::Long> tf_long;
+
+    const int64_t group_in = p.in_channels / p.groups;
+    const auto input_data =
+        make_int8_data(p.batch * p.in_channels * p.in_h * p.in_w, 1);
+    const auto weight_data = make_int8_data(
+        p.out_channels * group_in * p.kernel_h * p.kernel_w, 2);
+    std::vector<float> scales_data(p.out_channels);
+    std::vector<int64_t> zero_points_data;
+    std::vector<float> bias_data;
+    for (int64_t c = 0; c < p.out_channels; ++c) {
+      scales_data[c] = 0.001f * (1 + c % 7);
+      if (with_zero_points) {
+        zero_points_data.push_back(c % 5 - 2);
+      }
+      if (with_bias) {
+        bias_data.push_back(0.25f * (c % 9) - 1.0f);
+      }
+    }
+    const double input_scale = 0.05;
+    const int64_t input_zero_point = -7;
+    const double output_scale = 0.2 *
+        std::sqrt(static_cast<double>(group_in * p.kernel_h * p.kernel_w));
+    const int64_t output_zero_point = 5;
+
+    const auto expected = reference_quantized_conv2d(
+        p,
+        input_data,
+        input_scale,
+        input_zero_point,
+        weight_data,
+        scales_data,
+        zero_points_data,
+        bias_data,
+        output_scale,
+        output_zero_point);
+
+    const auto i32 = [](int64_t v) { return static_cast<int32_t>(v); };
+    const Tensor input = tf_char.make(
+        {i32(p.batch), i32(p.in_channels), i32(p.in_h), i32(p.in_w)},
+        input_data);
+    const Tensor weight = tf_char.make(
+        {i32(p.out_channels), i32(group_in), i32(p.kernel_h), i32(p.kernel_w)},
+        weight_data);
+    const Tensor scales = tf.make({i32(p.out_channels)}, scales_data);
+    optional<Tensor> zero_points;
+    if (with_zero_points) {
+      zero_points = tf_long.make({i32(p.out_channels)}, zero_points_data);
+    }
+    optional<Tensor> bias;
+    if (with_bias) {
+      bias = tf.make({i32(p.out_channels)}, bias_data);
+    }
+
+    const int64_t stride[] = {p.stride};
+    const int64_t padding[] = {p.padding};
+    const int64_t dilation[] = {p.dilation};
+    Tensor out = tf_char.zeros(
+        {i32(p.batch), i32(p.out_channels), i32(p.out_h()), i32(p.out_w())});
+    KernelRuntimeContext ctx = make_context();
+    quantized_conv2d_out(
+        ctx,
+        input,
+        input_scale,
+        input_zero_point,
+        weight,
+        scales,
+        zero_points,
+        bias,
+        ArrayRef<int64_t>(stride, 1),
+        ArrayRef<int64_t>(padding, 1),
+        ArrayRef<int64_t>(dilation, 1),
+        p.groups,
+        output_scale,
+        output_zero_point,
+        -128,
+        127,
+        out);
+    ASSERT_EQ(ctx.failure_state(), Error::Ok);
+    const int8_t* const out_data = out.const_data_ptr<int8_t>();
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_LE(std::abs(out_data[i] - expected[i]), 1) << "at " << i;
+    }
+  }
+
+ private:
+  alignas(16) uint8_t temp_buffer_[64 * 1024];
+  MemoryAllocator temp_allocator_{sizeof(temp_buffer_), temp_buffer_};
+};
+
+} // namespace
+
+TEST_F(OpQuantizedConv2dTest, SmallExample) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // x = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}} after removing the zero point.
+  Tensor input = tf_char.make({1, 1, 3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  Tensor weight = tf_char.make({2, 1, 2, 2}, {1, 0, 0, 1, 0, 1, -1, 0});
+  Tensor weight_scales = tf.make({2}, {1.0, 0.5});
+  optional<Tensor> bias = tf.make({2}, {0.0, 2.0});
+  Tensor out = tf_char.zeros({1, 2, 2, 2});
+
+  const int64_t one[] = {1};
+  const int64_t zero[] = {0};
+  KernelRuntimeContext ctx = make_context();
+  quantized_conv2d_out(
+      ctx,
+      input,
+      /*input_scale=*/1.0,
+      /*input_zero_point=*/1,
+      weight,
+      weight_scales,
+      {},
+      bias,
+      /*stride=*/{one, 1},
+      /*padding=*/{zero, 1},
+      /*dilation=*/{one, 1},
+      /*groups=*/1,
+      /*output_scale=*/1.0,
+      /*output_zero_point=*/0,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  // Channel 0 adds the diagonal of each window, channel 1 takes half of the
+  // top right minus the bottom left, which is always -2, plus 2.
+  EXPECT_TENSOR_EQ(
+      out, tf_char.make({1, 2, 2, 2}, {4, 6, 10, 12, 1, 1, 1, 1}));
+}
+
+TEST_F(OpQuantizedConv2dTest, PaddingUsesInputZeroPoint) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // Every input is at the zero point, so padding or not, the output is the
+  // bias alone.
+  Tensor input = tf_char.full({1, 2, 3, 3}, 20);
+  Tensor weight = tf_char.full({3, 2, 3, 3}, 5);
+  Tensor weight_scales = tf.ones({3});
+  optional<Tensor> bias = tf.make({3}, {1.0, -2.0, 3.0});
+  Tensor out = tf_char.zeros({1, 3, 3, 3});
+
+  const int64_t one[] = {1};
+  KernelRuntimeContext ctx = make_context();
+  quantized_conv2d_out(
+      ctx,
+      input,
+      1.0,
+      20,
+      weight,
+      weight_scales,
+      {},
+      bias,
+      {one, 1},
+      {one, 1},
+      {one, 1},
+      1,
+      1.0,
+      0,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  Tensor expected = tf_char.zeros({1, 3, 3, 3});
+  int8_t* const expected_data = expected.mutable_data_ptr<int8_t>();
+  std::fill(expected_data, expected_data + 9, 1);
+  std::fill(expected_data + 9, expected_data + 18, -2);
+  std::fill(expected_data + 18, expected_data + 27, 3);
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST_F(OpQuantizedConv2dTest, MatchesDecomposedGraph) {
+  test_params(
+      {/*batch=*/2,
+       /*in_channels=*/3,
+       /*in_h=*/9,
+       /*in_w=*/8,
+       /*out_channels=*/5,
+       /*kernel_h=*/3,
+       /*kernel_w=*/3,
+       /*stride=*/1,
+       /*padding=*/1,
+       /*dilation=*/1,
+       /*groups=*/1},
+      /*with_zero_points=*/false,
+      /*with_bias=*/true);
+}
+
+TEST_F(OpQuantizedConv2dTest, StridedDilatedWithZeroPoints) {
+  test_params(
+      {/*batch=*/1,
+       /*in_channels=*/4,
+       /*in_h=*/13,
+       /*in_w=*/11,
+       /*out_channels=*/6,
+       /*kernel_h=*/3,
+       /*kernel_w=*/2,
+       /*stride=*/2,
+       /*padding=*/2,
+       /*dilation=*/2,
+       /*groups=*/1},
+      /*with_zero_points=*/true,
+      /*with_bias=*/false);
+}
+
+TEST_F(OpQuantizedConv2dTest, GroupsWithTails) {
+  // More than one block of output positions and of output channels, with
+  // partial last blocks.
+  test_params(
+      {/*batch=*/1,
+       /*in_channels=*/4,
+       /*in_h=*/10,
+       /*in_w=*/9,
+       /*out_channels=*/140,
+       /*kernel_h=*/1,
+       /*kernel_w=*/1,
+       /*stride=*/1,
+       /*padding=*/0,
+       /*dilation=*/1,
+       /*groups=*/2},
+      /*with_zero_points=*/true,
+      /*with_bias=*/true);
+}
+
+TEST_F(OpQuantizedConv2dTest, RejectsMismatchedGroups) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf_char.ones({1, 4, 3, 3});
+  Tensor weight = tf_char.ones({2, 4, 1, 1});
+  Tensor weight_scales = tf.ones({2});
+  Tensor out = tf_char.zeros({1, 2, 3, 3});
+
+  const int64_t one[] = {1};
+  const int64_t zero[] = {0};
+  KernelRuntimeContext ctx = make_context();
+  quantized_conv2d_out(
+      ctx,
+      input,
+      1.0,
+      0,
+      weight,
+      weight_scales,
+      {},
+      {},
+      {one, 1},
+      {zero, 1},
+      {one, 1},
+      /*groups=*/2,
+      1.0,
+      0,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::InvalidArgument);
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the aten operator
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::optional;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using torch::executor::native::quantized_linear_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+std::vector<int8_t> make_int8_data(size_t n, uint32_t seed) {
+  std::vector<int8_t> data(n);
+  for (auto& x : data) {
+    seed = seed * 1664525u + 1013904223u;
+    x = static_cast<int8_t>(static_cast<int32_t>((seed >> 16) % 256) - 128);
+  }
+  return data;
+}
+
+// The decomposed graph: dequantize input and weight, a linear in double, then
+// quantize_per_tensor.
+std::vector<int8_t> reference_quantized_linear(
+    const std::vector<int8_t>& input,
+    double input_scale,
+    int64_t input_zero_point,
+    const std::vector<int8_t>& weight,
+    const std::vector<float>& weight_scales,
+    const std::vector<int64_t>& weight_zero_points,
+    const std::vector<float>& bias,
+    double output_scale,
+    int64_t output_zero_point,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  std::vector<int8_t> out(m * n);
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t j = 0; j < n; ++j) {
+      const int64_t w_zp =
+          weight_zero_points.empty() ? 0 : weight_zero_points[j];
+      double acc = bias.empty() ? 0.0 : bias[j];
+      for (int64_t kk = 0; kk < k; ++kk) {
+        acc += (input[i * k + kk] - input_zero_point) * input_scale *
+            (weight[j * k + kk] - w_zp) * weight_scales[j];
+      }
+      const double q = output_zero_point + std::nearbyint(acc / output_scale);
+      out[i * n + j] = static_cast<int8_t>(std::clamp(q, -128.0, 127.0));
+    }
+  }
+  return out;
+}
+
+class OpQuantizedLinearTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  KernelRuntimeContext make_context() {
+    temp_allocator_.reset();
+    return KernelRuntimeContext(nullptr, &temp_allocator_);
+  }
+
+  // Checks the kernel against the decomposed graph for an input of the given
+  // sizes. The kernel rescales in float, so a result that lies close to a
+  // rounding boundary may end up one step away from the double reference.
+  void test_shape(
+      const std::vector<int32_t>& input_sizes,
+      int64_t n,
+      bool with_zero_points,
+      bool with_bias) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Char> tf_char;
+    TensorFactory<ScalarType::Long> tf_long;
+
+    const int64_t k = input_sizes.back();
+    int64_t m = 1;
+    for (size_t d = 0; d + 1 < input_sizes.size(); ++d) {
+      m *= input_sizes[d];
+    }
+    const auto input_data = make_int8_data(m * k, 1);
+    const auto weight_data = make_int8_data(n * k, 2);
+    std::vector<float> scales_data(n);
+    std::vector<int64_t> zero_points_data;
+    std::vector<float> bias_data;
+    for (int64_t j = 0; j < n; ++j) {
+      scales_data[j] = 0.001f * (1 + j % 7);
+      if (with_zero_points) {
+        zero_points_data.push_back(j % 5 - 2);
+      }
+      if (with_bias) {
+        bias_data.push_back(0.25f * (j % 9) - 1.0f);
+      }
+    }
+    const double input_scale = 0.05;
+    const int64_t input_zero_point = 3;
+    const double output_scale = 0.2 * std::sqrt(static_cast<double>(k));
+    const int64_t output_zero_point = -4;
+
+    std::vector<int32_t> out_sizes = input_sizes;
+    out_sizes.back() = n;
+    const auto expected = reference_quantized_linear(
+        input_data,
+        input_scale,
+        input_zero_point,
+        weight_data,
+        scales_data,
+        zero_points_data,
+        bias_data,
+        output_scale,
+        output_zero_point,
+        m,
+        n,
+        k);
+
+    const int32_t n32 = static_cast<int32_t>(n);
+    const Tensor input = tf_char.make(input_sizes, input_data);
+    const Tensor weight =
+        tf_char.make({n32, static_cast<int32_t>(k)}, weight_data);
+    const Tensor scales = tf.make({n32}, scales_data);
+    optional<Tensor> zero_points;
+    if (with_zero_points) {
+      zero_points = tf_long.make({n32}, zero_points_data);
+    }
+    optional<Tensor> bias;
+    if (with_bias) {
+      bias = tf.make({n32}, bias_data);
+    }
+
+    Tensor out = tf_char.zeros(out_sizes);
+    KernelRuntimeContext ctx = make_context();
+    quantized_linear_out(
+        ctx,
+        input,
+        input_scale,
+        input_zero_point,
+        weight,
+        scales,
+        zero_points,
+        bias,
+        output_scale,
+        output_zero_point,
+        -128,
+        127,
+        out);
+    ASSERT_EQ(ctx.failure_state(), Error::Ok);
+    const int8_t* const out_data = out.const_data_ptr<int8_t>();
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_LE(std::abs(out_data[i] - expected[i]), 1) << "at " << i;
+    }
+  }
+
+ private:
+  alignas(16) uint8_t temp_buffer_[64 * 1024];
+  MemoryAllocator temp_allocator_{sizeof(temp_buffer_), temp_buffer_};
+};
+
+} // namespace
+
+TEST_F(OpQuantizedLinearTest, SmallExample) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf_char.make({1, 3}, {3, 4, 5});
+  Tensor weight = tf_char.make({2, 3}, {1, 2, 3, -1, 0, 1});
+  Tensor weight_scales = tf.make({2}, {0.5, 2.0});
+  optional<Tensor> weight_zero_points = tf_long.make({2}, {1, 0});
+  optional<Tensor> bias = tf.make({2}, {1.0, -1.0});
+  Tensor out = tf_char.zeros({1, 2});
+
+  KernelRuntimeContext ctx = make_context();
+  quantized_linear_out(
+      ctx,
+      input,
+      /*input_scale=*/1.0,
+      /*input_zero_point=*/3,
+      weight,
+      weight_scales,
+      weight_zero_points,
+      bias,
+      /*output_scale=*/0.5,
+      /*output_zero_point=*/10,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  // x = {0, 1, 2}: 0.5 * (0 * 0 + 1 * 1 + 2 * 2) + 1 = 3.5 and
+  // 2 * (0 * -1 + 1 * 0 + 2 * 1) - 1 = 3, over 0.5 plus 10.
+  EXPECT_TENSOR_EQ(out, tf_char.make({1, 2}, {17, 16}));
+}
+
+TEST_F(OpQuantizedLinearTest, ClampsToQuantRange) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf_char.make({1, 2}, {100, -100});
+  Tensor weight = tf_char.make({2, 2}, {100, 0, 100, 0});
+  Tensor weight_scales = tf.make({2}, {1.0, -1.0});
+  Tensor out = tf_char.zeros({1, 2});
+
+  KernelRuntimeContext ctx = make_context();
+  quantized_linear_out(
+      ctx, input, 1.0, 0, weight, weight_scales, {}, {}, 1.0, 0, -5, 5, out);
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_EQ(out, tf_char.make({1, 2}, {5, -5}));
+}
+
+TEST_F(OpQuantizedLinearTest, MatchesDecomposedGraph) {
+  test_shape({4, 64}, 8, /*with_zero_points=*/false, /*with_bias=*/false);
+}
+
+TEST_F(OpQuantizedLinearTest, MatchesDecomposedGraphWithZeroPointsAndBias) {
+  test_shape({4, 64}, 8, /*with_zero_points=*/true, /*with_bias=*/true);
+}
+
+TEST_F(OpQuantizedLinearTest, BatchedInputWithTails) {
+  // Input features that aren't a multiple of the vector length, and output
+  // features that span more than one block, with a partial last block.
+  test_shape({2, 3, 37}, 70, /*with_zero_points=*/true, /*with_bias=*/true);
+  test_shape({5, 7}, 3, /*with_zero_points=*/false, /*with_bias=*/true);
+}
+
+TEST_F(OpQuantizedLinearTest, RejectsFloatInput) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf.ones({1, 4});
+  Tensor weight = tf_char.zeros({2, 4});
+  Tensor weight_scales = tf.ones({2});
+  Tensor out = tf_char.zeros({1, 2});
+
+  KernelRuntimeContext ctx = make_context();
+  quantized_linear_out(
+      ctx,
+      input,
+      1.0,
+      0,
+      weight,
+      weight_scales,
+      {},
+      {},
+      1.0,
+      0,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::InvalidArgument);
+}
+
+TEST_F(OpQuantizedLinearTest, RejectsMismatchedWeightScales) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf_char.ones({1, 4});
+  Tensor weight = tf_char.zeros({2, 4});
+  Tensor weight_scales = tf.ones({3});
+  Tensor out = tf_char.zeros({1, 2});
+
+  KernelRuntimeContext ctx = make_context();
+  quantized_linear_out(
+      ctx,
+      input,
+      1.0,
+      0,
+      weight,
+      weight_scales,
+      {},
+      {},
+      1.0,
+      0,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::InvalidArgument);
+}
+
+TEST_F(OpQuantizedLinearTest, FailsWithoutTempAllocator) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf_char.ones({1, 4});
+  Tensor weight = tf_char.zeros({2, 4});
+  Tensor weight_scales = tf.ones({2});
+  Tensor out = tf_char.zeros({1, 2});
+
+  KernelRuntimeContext ctx{};
+  quantized_linear_out(
+      ctx,
+      input,
+      1.0,
+      0,
+      weight,
+      weight_scales,
+      {},
+      {},
+      1.0,
+      0,
+      -128,
+      127,
+      out);
+  EXPECT_EQ(ctx.failure_state(), Error::MemoryAllocationFailed);
+}
@@ -27,6 +27,12 @@ def define_common_targets():
     ])
     op_test("op_embedding2b_test", kernel_name = "quantized")
     op_test("op_embedding4b_test", kernel_name = "quantized")
+    op_test("op_linear_8da4w_test", kernel_name = "quantized", deps = [
+        "//executorch/kernels/quantized/cpu:op_linear_8da4w",
+        "//executorch/kernels/quantized:generated_lib_headers",
+        "//executorch/kernels/portable:generated_lib_headers",
+        "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+    ])
     op_test("op_mixed_mm_test", kernel_name = "quantized", deps = [
         "//executorch/kernels/quantized/cpu:op_mixed_mm",
         "//executorch/kernels/quantized:generated_lib_headers",
@@ -39,3 +45,15 @@ def define_common_targets():
         "//executorch/kernels/portable:generated_lib_headers",
         "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
     ])
+    op_test("op_quantized_conv2d_test", kernel_name = "quantized", deps = [
+        "//executorch/kernels/quantized/cpu:op_quantized_conv2d",
+        "//executorch/kernels/quantized:generated_lib_headers",
+        "//executorch/kernels/portable:generated_lib_headers",
+        "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+    ])
+    op_test("op_quantized_linear_test", kernel_name = "quantized", deps = [
+        "//executorch/kernels/quantized/cpu:op_quantized_linear",
+        "//executorch/kernels/quantized:generated_lib_headers",
+        "//executorch/kernels/portable:generated_lib_headers",
+        "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+    ])
@@ -14,11 +14,15 @@
 #pragma once
 
 #include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <executorch/test/utils/DeathTest.h>
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <cstdlib>
+
 #ifdef USE_ATEN_LIB
 /**
  * Ensure the kernel will fail when `_statement` is executed.
@@ -90,9 +94,88 @@
 
 #endif // USE_ATEN_LIB
 
+/**
+ * A MemoryAllocator that mallocs each allocation and frees them all on
+ * reset() or destruction, for use as the temp allocator of a
+ * KernelRuntimeContext in tests.
+ */
+class TempMemoryAllocator final : public executorch::runtime::MemoryAllocator {
+ private:
+  // We allocate a little more than requested and use that memory as a node in
+  // a linked list, pushing the allocated buffers onto a list that's iterated
+  // and freed when the KernelRuntimeContext is destroyed.
+  struct AllocationNode {
+    void* data;
+    AllocationNode* next;
+  };
+
+  AllocationNode* head_ = nullptr;
+
+ public:
+  TempMemoryAllocator() : MemoryAllocator(0, nullptr) {}
+
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+
+    // Allocate enough memory for the node, the data and the alignment bump.
+    size_t alloc_size = sizeof(AllocationNode) + size + alignment;
+    void* node_memory = std::malloc(alloc_size);
+
+    // If allocation failed, log message and return nullptr.
+    if (node_memory == nullptr) {
+      ET_LOG(Error, "Failed to allocate %zu bytes", alloc_size);
+      return nullptr;
+    }
+
+    // Compute data pointer.
+    uint8_t* data_ptr =
+        reinterpret_cast<uint8_t*>(node_memory) + sizeof(AllocationNode);
+
+    // Align the data pointer.
+    void* aligned_data_ptr = alignPointer(data_ptr, alignment);
+
+    // Assert that the alignment didn't overflow the allocated memory.
+    ET_DCHECK_MSG(
+        reinterpret_cast<uintptr_t>(aligned_data_ptr) + size <=
+            reinterpret_cast<uintptr_t>(node_memory) + alloc_size,
+        "aligned_data_ptr %p + size %zu > node_memory %p + alloc_size %zu",
+        aligned_data_ptr,
+        size,
+        node_memory,
+        alloc_size);
+
+    // Construct the node.
+    AllocationNode* new_node = reinterpret_cast<AllocationNode*>(node_memory);
+    new_node->data = aligned_data_ptr;
+    new_node->next = head_;
+    head_ = new_node;
+
+    // Return the aligned data pointer.
+    return head_->data;
+  }
+
+  void reset() override {
+    AllocationNode* current = head_;
+    while (current != nullptr) {
+      AllocationNode* next = current->next;
+      std::free(current);
+      current = next;
+    }
+    head_ = nullptr;
+  }
+
+  ~TempMemoryAllocator() override {
+    reset();
+  }
+};
+
 /*
  * Common test fixture for kernel / operator-level tests. Provides
- * a runtime context object and verifies failure state post-execution.
+ * a runtime context object, with temp memory for kernels that need
+ * scratch space, and verifies failure state post-execution.
  */
 class OperatorTest : public ::testing::Test {
  public:
@@ -116,6 +199,9 @@ class OperatorTest : public ::testing::Test {
   }
 
  protected:
-  executorch::runtime::KernelRuntimeContext context_;
+  TempMemoryAllocator temp_allocator_;
+  executorch::runtime::KernelRuntimeContext context_{
+      nullptr,
+      &temp_allocator_};
   bool expect_failure_;
 };
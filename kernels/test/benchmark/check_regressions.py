@@ -0,0 +1,312 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Checks the kernel microbenchmarks of op_benchmark against baseline timings.
+
+Baselines are stored per ISA, and within an ISA per benchmark, i.e. per
+(op, dtype, shape, kernel library):
+
+    {
+      "x86_64-avx2": {
+        "mm/Float/256x256x256/optimized": {"time_us": 41.2},
+        ...
+      },
+      ...
+    }
+
+Only the combinations that the kernel library supports according to the
+supported features of kernels/test/supported_features.yaml, with the
+overrides of kernels/<library>/test/supported_features_def.yaml, are run and
+compared. A feature of an op named dtype_<dtype>, e.g. dtype_double of
+op_gelu, disables the benchmarks of that op with that dtype when false.
+
+Usage:
+
+    python check_regressions.py --op_benchmark=<path to op_benchmark> \\
+        --baseline=<baseline.json> [--threshold=0.1] [--update_baseline]
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+from dataclasses import dataclass
+from typing import Any, Dict, List, Optional, Tuple
+
+import yaml
+
+_KERNELS_DIR = os.path.dirname(
+    os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+)
+
+# (namespace, feature) -> value.
+Features = Dict[Tuple[str, str], Any]
+
+
+@dataclass
+class BenchmarkName:
+    op: str
+    dtype: str
+    shape: str
+    library: str
+
+    @staticmethod
+    def parse(name: str) -> Optional["BenchmarkName"]:
+        """Parses <op>/<dtype>/<shape>/<library>, None for other names."""
+        parts = name.split("/")
+        if len(parts) != 4:
+            return None
+        return BenchmarkName(*parts)
+
+
+@dataclass
+class Comparison:
+    name: str
+    baseline_us: float
+    current_us: float
+
+    @property
+    def ratio(self) -> float:
+        return self.current_us / self.baseline_us
+
+
+def load_features(library: str, kernels_dir: str = _KERNELS_DIR) -> Features:
+    """
+    Returns the supported features of a kernel library: the defaults of
+    kernels/test/supported_features.yaml with the overrides of the library, if
+    it has any.
+    """
+    with open(os.path.join(kernels_dir, "test", "supported_features.yaml")) as f:
+        definitions = yaml.full_load(f)
+    features: Features = {}
+    for entry in definitions:
+        for feature, properties in entry.items():
+            if feature != "namespace":
+                features[entry["namespace"], feature] = properties["default"]
+
+    overrides_path = os.path.join(
+        kernels_dir, library, "test", "supported_features_def.yaml"
+    )
+    if os.path.isfile(overrides_path):
+        with open(overrides_path) as f:
+            overrides = yaml.full_load(f) or []
+        for entry in overrides:
+            for feature, value in entry.items():
+                if feature != "namespace":
+                    features[entry["namespace"], feature] = value
+    return features
+
+
+def is_supported(name: BenchmarkName, features: Features) -> bool:
+    """False if the library disables the dtype of the benchmark for its op."""
+    dtype_feature = ("op_" + name.op, "dtype_" + name.dtype.lower())
+    return features.get(dtype_feature, True) is not False
+
+
+def detect_isa() -> str:
+    """Returns the architecture, with its widest vector extension if known."""
+    machine = platform.machine().lower()
+    flags = set()
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                key, _, value = line.partition(":")
+                if key.strip() in ("flags", "Features"):
+                    flags.update(value.split())
+    except OSError:
+        pass
+    for flag, extension in (
+        ("avx512f", "avx512"),
+        ("avx2", "avx2"),
+        ("sve", "sve"),
+        ("asimd", "neon"),
+    ):
+        if flag in flags:
+            return f"{machine}-{extension}"
+    return machine
+
+
+def list_benchmarks(op_benchmark: str) -> List[str]:
+    output = subprocess.run(
+        [op_benchmark, "--benchmark_list_tests=true"],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+    return [line.strip() for line in output.splitlines() if line.strip()]
+
+
+def select_supported(names: List[str], kernels_dir: str = _KERNELS_DIR) -> List[str]:
+    """Returns the names of the benchmarks that their library supports."""
+    features_by_library: Dict[str, Features] = {}
+    selected = []
+    for name in names:
+        parsed = BenchmarkName.parse(name)
+        if parsed is None:
+            continue
+        if parsed.library not in features_by_library:
+            features_by_library[parsed.library] = load_features(
+                parsed.library, kernels_dir
+            )
+        if is_supported(parsed, features_by_library[parsed.library]):
+            selected.append(name)
+    return selected
+
+
+def run_benchmarks(
+    op_benchmark: str, names: List[str], repetitions: int
+) -> Dict[str, float]:
+    """Runs the named benchmarks, and returns their median times in us."""
+    benchmark_filter = "^(" + "|".join(re.escape(name) for name in names) + ")$"
+    output = subprocess.run(
+        [
+            op_benchmark,
+            f"--benchmark_filter={benchmark_filter}",
+            f"--benchmark_repetitions={repetitions}",
+            "--benchmark_report_aggregates_only=true",
+            "--benchmark_format=json",
+        ],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+    return parse_results(json.loads(output))
+
+
+_TIME_UNIT_TO_US = {"ns": 1e-3, "us": 1.0, "ms": 1e3, "s": 1e6}
+
+
+def parse_results(results: Dict[str, Any]) -> Dict[str, float]:
+    """
+    Returns the times in us of the benchmarks of a Google Benchmark JSON
+    report: the median if the benchmarks were repeated, else the only run.
+    """
+    times: Dict[str, float] = {}
+    for benchmark in results["benchmarks"]:
+        if benchmark.get("error_occurred"):
+            continue
+        aggregate = benchmark.get("aggregate_name")
+        if aggregate is not None and aggregate != "median":
+            continue
+        name = benchmark.get("run_name", benchmark["name"])
+        unit_us = _TIME_UNIT_TO_US[benchmark["time_unit"]]
+        times[name] = benchmark["real_time"] * unit_us
+    return times
+
+
+def compare(
+    baseline: Dict[str, Dict[str, float]],
+    current: Dict[str, float],
+    threshold: float,
+) -> Tuple[List[Comparison], List[Comparison]]:
+    """
+    Returns the benchmarks slower than their baseline by more than threshold,
+    and the ones faster by more than threshold. Benchmarks without a baseline
+    are ignored.
+    """
+    regressions = []
+    improvements = []
+    for name, current_us in sorted(current.items()):
+        if name not in baseline:
+            continue
+        comparison = Comparison(name, baseline[name]["time_us"], current_us)
+        if comparison.ratio > 1 + threshold:
+            regressions.append(comparison)
+        elif comparison.ratio < 1 - threshold:
+            improvements.append(comparison)
+    return regressions, improvements
+
+
+def main(argv: List[str]) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--op_benchmark", required=True, help="op_benchmark binary")
+    parser.add_argument("--baseline", required=True, help="Baseline JSON file")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="Slowdown over the baseline that is a regression, e.g. 0.1 for 10%%",
+    )
+    parser.add_argument(
+        "--isa", default=None, help="ISA of the baselines; detected by default"
+    )
+    parser.add_argument(
+        "--repetitions",
+        type=int,
+        default=5,
+        help="Repetitions of each benchmark, whose median is compared",
+    )
+    parser.add_argument(
+        "--benchmark_filter",
+        default=None,
+        help="Regex of the benchmarks to check; all the supported ones by default",
+    )
+    parser.add_argument(
+        "--kernels_dir",
+        default=_KERNELS_DIR,
+        help="The kernels/ directory, with the supported features",
+    )
+    parser.add_argument(
+        "--update_baseline",
+        action="store_true",
+        help="Write the current timings to the baseline instead of comparing",
+    )
+    args = parser.parse_args(argv)
+
+    isa = args.isa or detect_isa()
+    names = select_supported(list_benchmarks(args.op_benchmark), args.kernels_dir)
+    if args.benchmark_filter:
+        names = [name for name in names if re.search(args.benchmark_filter, name)]
+    if not names:
+        print("No supported benchmark to run")
+        return 1
+    current = run_benchmarks(args.op_benchmark, names, args.repetitions)
+
+    baselines: Dict[str, Dict[str, Dict[str, float]]] = {}
+    if os.path.isfile(args.baseline):
+        with open(args.baseline) as f:
+            baselines = json.load(f)
+
+    if args.update_baseline:
+        baseline = baselines.setdefault(isa, {})
+        for name, time_us in current.items():
+            baseline[name] = {"time_us": round(time_us, 3)}
+        with open(args.baseline, "w") as f:
+            json.dump(baselines, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"Updated {len(current)} {isa} baselines in {args.baseline}")
+        return 0
+
+    if isa not in baselines:
+        print(f"No baselines for {isa} in {args.baseline}")
+        return 1
+    regressions, improvements = compare(baselines[isa], current, args.threshold)
+    for comparison in improvements:
+        print(
+            f"Faster: {comparison.name}: {comparison.baseline_us:.3f} us -> "
+            f"{comparison.current_us:.3f} us ({comparison.ratio:.2f}x)"
+        )
+    for comparison in regressions:
+        print(
+            f"REGRESSION: {comparison.name}: {comparison.baseline_us:.3f} us -> "
+            f"{comparison.current_us:.3f} us ({comparison.ratio:.2f}x)"
+        )
+    missing = sorted(set(current) - set(baselines[isa]))
+    if missing:
+        print(f"{len(missing)} benchmarks have no {isa} baseline, e.g. {missing[0]}")
+    print(
+        f"{len(regressions)} regressions over {args.threshold:.0%} out of "
+        f"{len(current)} benchmarks on {isa}"
+    )
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))  # pragma: no cover
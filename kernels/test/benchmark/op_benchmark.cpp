@@ -0,0 +1,570 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Microbenchmarks of the portable, optimized, quantized and custom LLM
+// kernels over representative shapes and dtypes.
+//
+// Each benchmark is named <op>/<dtype>/<shape>/<kernel library>, so the
+// implementations of an op show up next to each other, e.g.
+//
+//   op_benchmark --benchmark_filter='^mm/'
+//
+// reports the portable and the optimized mm on the same shapes. Every
+// benchmark reports the bytes its kernel reads and writes per second, and the
+// matmul and attention kernels also report their FLOP/s.
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/platform/runtime.h>
+
+// The portable, optimized and quantized kernels are only declared by the
+// headers generated for their operator libraries. This binary calls the
+// kernels directly instead of through an operator library, so declare the
+// ones it benchmarks here.
+namespace torch {
+namespace executor {
+namespace native {
+
+Tensor& add_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    const Scalar& alpha,
+    Tensor& out);
+Tensor& opt_add_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    const Scalar& alpha,
+    Tensor& out);
+
+Tensor& mul_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    Tensor& out);
+Tensor& opt_mul_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    Tensor& out);
+
+Tensor& gelu_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    string_view approximate,
+    Tensor& out);
+Tensor& opt_gelu_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    string_view approximate,
+    Tensor& out);
+
+Tensor& softmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out);
+Tensor& opt_softmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out);
+
+std::tuple<Tensor&, Tensor&, Tensor&> native_layer_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const optional<Tensor>& weight,
+    const optional<Tensor>& bias,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& rstd_out);
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_layer_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const optional<Tensor>& weight,
+    const optional<Tensor>& bias,
+    double eps,
+    Tensor& out,
+    Tensor& mean_out,
+    Tensor& rstd_out);
+
+Tensor& mm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    Tensor& out);
+Tensor& opt_mm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    Tensor& out);
+
+Tensor& bmm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    Tensor& out);
+Tensor& opt_bmm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    Tensor& out);
+
+Tensor& opt_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    const optional<Tensor>& bias,
+    Tensor& out);
+
+Tensor& quantize_per_tensor_out(
+    const Tensor& input,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    ScalarType dtype,
+    Tensor& out);
+Tensor& dequantize_per_tensor_out(
+    const Tensor& input,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    ScalarType dtype,
+    optional<ScalarType> out_dtype,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace native = ::torch::executor::native;
+using ::executorch::aten::IntArrayRef;
+using ::executorch::aten::optional;
+using ::executorch::aten::Scalar;
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::SizesType;
+using ::executorch::aten::Tensor;
+using ::executorch::extension::empty;
+using ::executorch::extension::MallocMemoryAllocator;
+using ::executorch::extension::rand;
+using ::executorch::extension::TensorPtr;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::KernelRuntimeContext;
+
+namespace {
+
+using Run = std::function<void(KernelRuntimeContext&)>;
+
+// The kernel libraries an op is implemented by, with the same signature.
+template <typename Fn>
+using Implementations = std::vector<std::pair<const char*, Fn>>;
+
+std::string shape_to_string(const std::vector<SizesType>& sizes) {
+  std::string result;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    result += (i == 0 ? "" : "x") + std::to_string(sizes[i]);
+  }
+  return result;
+}
+
+int64_t nbytes(const std::vector<SizesType>& sizes, ScalarType dtype) {
+  int64_t numel = 1;
+  for (SizesType size : sizes) {
+    numel *= size;
+  }
+  return numel * ::executorch::runtime::elementSize(dtype);
+}
+
+/**
+ * Registers a benchmark of a kernel. setup() allocates the tensors of the
+ * kernel when the benchmark runs, and returns the call to measure. bytes and
+ * flops are per call; flops are only reported if positive.
+ */
+void register_kernel(
+    const std::string& name,
+    int64_t bytes,
+    int64_t flops,
+    std::function<Run()> setup) {
+  benchmark::RegisterBenchmark(
+      name.c_str(),
+      [=](benchmark::State& state) {
+        const Run run = setup();
+        // Like a method, frees the temp memory of the kernel after each call.
+        MallocMemoryAllocator temp_allocator;
+        KernelRuntimeContext context(nullptr, &temp_allocator);
+        // Also warms the caches up before the measured calls.
+        run(context);
+        temp_allocator.reset();
+        if (context.failure_state() != Error::Ok) {
+          state.SkipWithError("The kernel failed");
+          return;
+        }
+        for (auto _ : state) {
+          run(context);
+          temp_allocator.reset();
+          benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * bytes);
+        if (flops > 0) {
+          state.counters["FLOPS"] = benchmark::Counter(
+              static_cast<double>(flops),
+              benchmark::Counter::kIsIterationInvariantRate,
+              benchmark::Counter::kIs1000);
+        }
+      })
+      ->Unit(benchmark::kMicrosecond);
+}
+
+void register_binary_ops() {
+  using BinaryFn = std::function<void(
+      KernelRuntimeContext&, const Tensor&, const Tensor&, Tensor&)>;
+  const Scalar alpha(1.0);
+  const std::vector<std::pair<const char*, Implementations<BinaryFn>>> ops = {
+      {"add",
+       {{"portable",
+         [alpha](auto& ctx, const auto& a, const auto& b, auto& out) {
+           native::add_out(ctx, a, b, alpha, out);
+         }},
+        {"optimized",
+         [alpha](auto& ctx, const auto& a, const auto& b, auto& out) {
+           native::opt_add_out(ctx, a, b, alpha, out);
+         }}}},
+      {"mul",
+       {{"portable", native::mul_out}, {"optimized", native::opt_mul_out}}},
+  };
+  for (const auto& op : ops) {
+    for (ScalarType dtype :
+         {ScalarType::Float, ScalarType::Half, ScalarType::BFloat16}) {
+      for (SizesType numel : {1 << 12, 1 << 16, 1 << 20}) {
+        const std::vector<SizesType> sizes = {numel};
+        for (const auto& impl : op.second) {
+          const BinaryFn fn = impl.second;
+          register_kernel(
+              std::string(op.first) + "/" +
+                  ::executorch::runtime::toString(dtype) + "/" +
+                  shape_to_string(sizes) + "/" + impl.first,
+              3 * nbytes(sizes, dtype),
+              /*flops=*/0,
+              [=]() -> Run {
+                TensorPtr a = rand(sizes, dtype);
+                TensorPtr b = rand(sizes, dtype);
+                TensorPtr out = empty(sizes, dtype);
+                return [=](KernelRuntimeContext& ctx) {
+                  fn(ctx, *a, *b, *out);
+                };
+              });
+        }
+      }
+    }
+  }
+}
+
+void register_activation_ops() {
+  using UnaryFn =
+      std::function<void(KernelRuntimeContext&, const Tensor&, Tensor&)>;
+  const std::vector<std::pair<const char*, Implementations<UnaryFn>>> ops = {
+      {"gelu",
+       {{"portable",
+         [](auto& ctx, const auto& in, auto& out) {
+           native::gelu_out(ctx, in, "none", out);
+         }},
+        {"optimized",
+         [](auto& ctx, const auto& in, auto& out) {
+           native::opt_gelu_out(ctx, in, "none", out);
+         }}}},
+      {"softmax",
+       {{"portable",
+         [](auto& ctx, const auto& in, auto& out) {
+           native::softmax_out(ctx, in, -1, false, out);
+         }},
+        {"optimized",
+         [](auto& ctx, const auto& in, auto& out) {
+           native::opt_softmax_out(ctx, in, -1, false, out);
+         }}}},
+  };
+  // Activations of a transformer layer, and logits over a 32k vocabulary.
+  const std::vector<std::vector<SizesType>> shapes = {
+      {128, 4096}, {1, 32000}, {32, 32000}};
+  for (const auto& op : ops) {
+    for (ScalarType dtype : {ScalarType::Float, ScalarType::Double}) {
+      for (const auto& sizes : shapes) {
+        for (const auto& impl : op.second) {
+          const UnaryFn fn = impl.second;
+          register_kernel(
+              std::string(op.first) + "/" +
+                  ::executorch::runtime::toString(dtype) + "/" +
+                  shape_to_string(sizes) + "/" + impl.first,
+              2 * nbytes(sizes, dtype),
+              /*flops=*/0,
+              [=]() -> Run {
+                TensorPtr in = rand(sizes, dtype);
+                TensorPtr out = empty(sizes, dtype);
+                return [=](KernelRuntimeContext& ctx) { fn(ctx, *in, *out); };
+              });
+        }
+      }
+    }
+  }
+}
+
+void register_layer_norm() {
+  using LayerNormFn = std::tuple<Tensor&, Tensor&, Tensor&> (*)(
+      KernelRuntimeContext&,
+      const Tensor&,
+      IntArrayRef,
+      const optional<Tensor>&,
+      const optional<Tensor>&,
+      double,
+      Tensor&,
+      Tensor&,
+      Tensor&);
+  const Implementations<LayerNormFn> impls = {
+      {"portable", native::native_layer_norm_out},
+      {"optimized", native::opt_native_layer_norm_out}};
+  for (const std::vector<SizesType>& sizes :
+       std::vector<std::vector<SizesType>>{{128, 768}, {128, 4096}}) {
+    const std::vector<SizesType> weight_sizes = {sizes[1]};
+    const std::vector<SizesType> stats_sizes = {sizes[0], 1};
+    for (const auto& impl : impls) {
+      const LayerNormFn fn = impl.second;
+      register_kernel(
+          "native_layer_norm/Float/" + shape_to_string(sizes) + "/" +
+              impl.first,
+          2 * nbytes(sizes, ScalarType::Float) +
+              2 * nbytes(weight_sizes, ScalarType::Float),
+          /*flops=*/0,
+          [=]() -> Run {
+            TensorPtr in = rand(sizes);
+            TensorPtr weight = rand(weight_sizes);
+            TensorPtr bias = rand(weight_sizes);
+            TensorPtr out = empty(sizes);
+            TensorPtr mean = empty(stats_sizes);
+            TensorPtr rstd = empty(stats_sizes);
+            return [=](KernelRuntimeContext& ctx) {
+              const int64_t normalized_shape[] = {sizes[1]};
+              fn(ctx,
+                 *in,
+                 IntArrayRef(normalized_shape, 1),
+                 *weight,
+                 *bias,
+                 1e-5,
+                 *out,
+                 *mean,
+                 *rstd);
+            };
+          });
+    }
+  }
+}
+
+void register_matmul_ops() {
+  using MatmulFn = Tensor& (*)(
+      KernelRuntimeContext&, const Tensor&, const Tensor&, Tensor&);
+  const Implementations<MatmulFn> mm_impls = {
+      {"portable", native::mm_out}, {"optimized", native::opt_mm_out}};
+  for (SizesType n : {64, 256, 512}) {
+    for (const auto& impl : mm_impls) {
+      const MatmulFn fn = impl.second;
+      register_kernel(
+          "mm/Float/" + shape_to_string({n, n, n}) + "/" + impl.first,
+          3 * nbytes({n, n}, ScalarType::Float),
+          2 * static_cast<int64_t>(n) * n * n,
+          [=]() -> Run {
+            TensorPtr a = rand({n, n});
+            TensorPtr b = rand({n, n});
+            TensorPtr out = empty({n, n});
+            return [=](KernelRuntimeContext& ctx) { fn(ctx, *a, *b, *out); };
+          });
+    }
+  }
+
+  // Attention scores of 8 heads.
+  const Implementations<MatmulFn> bmm_impls = {
+      {"portable", native::bmm_out}, {"optimized", native::opt_bmm_out}};
+  constexpr SizesType kBatch = 8;
+  for (SizesType n : {64, 128}) {
+    for (const auto& impl : bmm_impls) {
+      const MatmulFn fn = impl.second;
+      register_kernel(
+          "bmm/Float/" + shape_to_string({kBatch, n, n, n}) + "/" +
+              impl.first,
+          3 * nbytes({kBatch, n, n}, ScalarType::Float),
+          2 * static_cast<int64_t>(kBatch) * n * n * n,
+          [=]() -> Run {
+            TensorPtr a = rand({kBatch, n, n});
+            TensorPtr b = rand({kBatch, n, n});
+            TensorPtr out = empty({kBatch, n, n});
+            return [=](KernelRuntimeContext& ctx) { fn(ctx, *a, *b, *out); };
+          });
+    }
+  }
+
+  // Projections of a 4096 wide model, when decoding (1 token) and in
+  // prefill. Only the optimized library implements linear; the portable one
+  // runs it as a decomposed mm.
+  constexpr SizesType kWidth = 4096;
+  for (SizesType m : {1, 64}) {
+    register_kernel(
+        "linear/Float/" + shape_to_string({m, kWidth, kWidth}) + "/optimized",
+        nbytes({m, kWidth}, ScalarType::Float) * 2 +
+            nbytes({kWidth, kWidth}, ScalarType::Float),
+        2 * static_cast<int64_t>(m) * kWidth * kWidth,
+        [=]() -> Run {
+          TensorPtr in = rand({m, kWidth});
+          TensorPtr weight = rand({kWidth, kWidth});
+          TensorPtr out = empty({m, kWidth});
+          return [=](KernelRuntimeContext& ctx) {
+            native::opt_linear_out(ctx, *in, *weight, {}, *out);
+          };
+        });
+  }
+}
+
+void register_quantized_ops() {
+  for (SizesType numel : {1 << 16, 1 << 20}) {
+    const std::vector<SizesType> sizes = {numel};
+    const int64_t bytes = nbytes(sizes, ScalarType::Float) +
+        nbytes(sizes, ScalarType::Char);
+    register_kernel(
+        "quantize_per_tensor/Float/" + shape_to_string(sizes) + "/quantized",
+        bytes,
+        /*flops=*/0,
+        [=]() -> Run {
+          TensorPtr in = rand(sizes);
+          TensorPtr out = empty(sizes, ScalarType::Char);
+          return [=](KernelRuntimeContext&) {
+            native::quantize_per_tensor_out(
+                *in, 0.01, 0, -128, 127, ScalarType::Char, *out);
+          };
+        });
+    register_kernel(
+        "dequantize_per_tensor/Char/" + shape_to_string(sizes) + "/quantized",
+        bytes,
+        /*flops=*/0,
+        [=]() -> Run {
+          TensorPtr in = empty(sizes, ScalarType::Char);
+          TensorPtr out = empty(sizes);
+          return [=](KernelRuntimeContext&) {
+            native::dequantize_per_tensor_out(
+                *in,
+                0.01,
+                0,
+                -128,
+                127,
+                ScalarType::Char,
+                ScalarType::Float,
+                *out);
+          };
+        });
+  }
+}
+
+void register_custom_ops() {
+  for (const std::vector<SizesType>& sizes :
+       std::vector<std::vector<SizesType>>{{1, 4096}, {128, 4096}}) {
+    const std::vector<SizesType> weight_sizes = {sizes[1]};
+    register_kernel(
+        "rms_norm/Float/" + shape_to_string(sizes) + "/custom",
+        2 * nbytes(sizes, ScalarType::Float) +
+            nbytes(weight_sizes, ScalarType::Float),
+        /*flops=*/0,
+        [=]() -> Run {
+          TensorPtr in = rand(sizes);
+          TensorPtr weight = rand(weight_sizes);
+          TensorPtr out = empty(sizes);
+          return [=](KernelRuntimeContext& ctx) {
+            native::rms_norm_out(ctx, *in, *weight, 1e-5, *out);
+          };
+        });
+  }
+
+  // Causal attention of 32 heads of 128 over [batch, seq, heads, head_dim]
+  // tensors: decoding one token after a prompt, and a prefill.
+  constexpr SizesType kHeads = 32;
+  constexpr SizesType kHeadDim = 128;
+  const std::vector<std::pair<SizesType, SizesType>> configs = {
+      // {query length, cached tokens before the query}
+      {1, 127},
+      {1, 1023},
+      {128, 0},
+  };
+  for (const auto& config : configs) {
+    const SizesType q_len = config.first;
+    const SizesType start_pos = config.second;
+    const SizesType kv_len = start_pos + q_len;
+    const std::vector<SizesType> q_sizes = {1, q_len, kHeads, kHeadDim};
+    const std::vector<SizesType> kv_sizes = {1, kv_len, kHeads, kHeadDim};
+    register_kernel(
+        "custom_sdpa/Float/" + shape_to_string(q_sizes) + "_kv" +
+            std::to_string(kv_len) + "/custom",
+        2 * nbytes(q_sizes, ScalarType::Float) +
+            2 * nbytes(kv_sizes, ScalarType::Float),
+        // QK^T and the product with V.
+        4 * static_cast<int64_t>(kHeads) * q_len * kv_len * kHeadDim,
+        [=]() -> Run {
+          TensorPtr q = rand(q_sizes);
+          TensorPtr k = rand(kv_sizes);
+          TensorPtr v = rand(kv_sizes);
+          TensorPtr out = empty(q_sizes);
+          return [=](KernelRuntimeContext& ctx) {
+            native::custom_sdpa_out(
+                ctx,
+                *q,
+                *k,
+                *v,
+                start_pos,
+                {},
+                /*dropout_p=*/0.0,
+                /*is_causal=*/true,
+                {},
+                *out);
+          };
+        });
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  ::executorch::runtime::runtime_init();
+
+  register_binary_ops();
+  register_activation_ops();
+  register_layer_norm();
+  register_matmul_ops();
+  register_quantized_ops();
+  register_custom_ops();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
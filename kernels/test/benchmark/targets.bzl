@@ -0,0 +1,72 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+_PORTABLE_AND_OPTIMIZED_OPS = [
+    "op_add",
+    "op_bmm",
+    "op_gelu",
+    "op_mm",
+    "op_mul",
+    "op_native_layer_norm",
+    "op_softmax",
+]
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Microbenchmarks of the kernels of all the kernel libraries, which call the
+    # kernels directly rather than through registered operators.
+    runtime.cxx_binary(
+        name = "op_benchmark",
+        srcs = ["op_benchmark.cpp"],
+        compiler_flags = ["-Wno-global-constructors"],
+        define_static_target = False,
+        deps = [
+            "//third-party/benchmark:benchmark",
+            "//executorch/extension/llm/custom_ops:custom_ops",
+            "//executorch/extension/memory_allocator:malloc_memory_allocator",
+            "//executorch/extension/tensor:tensor",
+            "//executorch/kernels/optimized/cpu:op_linear",
+            "//executorch/kernels/quantized/cpu:op_dequantize",
+            "//executorch/kernels/quantized/cpu:op_quantize",
+            "//executorch/runtime/kernel:kernel_includes",
+            "//executorch/runtime/platform:platform",
+        ] + [
+            "//executorch/kernels/portable/cpu:{}".format(op)
+            for op in _PORTABLE_AND_OPTIMIZED_OPS
+        ] + [
+            "//executorch/kernels/optimized/cpu:{}".format(op)
+            for op in _PORTABLE_AND_OPTIMIZED_OPS
+        ],
+    )
+
+    runtime.python_library(
+        name = "check_regressions_lib",
+        srcs = ["check_regressions.py"],
+        base_module = "executorch.kernels.test.benchmark",
+        visibility = ["//executorch/kernels/test/..."],
+        deps = [
+            "fbsource//third-party/pypi/pyyaml:pyyaml",
+        ],
+    )
+
+    # Compares the timings of op_benchmark with the baselines of the ISA it runs
+    # on, for the combinations that the kernel libraries support.
+    runtime.python_binary(
+        name = "check_regressions",
+        main_module = "executorch.kernels.test.benchmark.check_regressions",
+        deps = [
+            ":check_regressions_lib",
+        ],
+    )
+
+    runtime.python_test(
+        name = "test_check_regressions",
+        srcs = ["test_check_regressions.py"],
+        deps = [
+            ":check_regressions_lib",
+        ],
+    )
@@ -0,0 +1,137 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import os
+import tempfile
+import unittest
+
+from executorch.kernels.test.benchmark.check_regressions import (  # type: ignore[import-not-found]
+    compare,
+    load_features,
+    parse_results,
+    select_supported,
+)
+
+_DEFINITIONS = """
+- namespace: global
+  is_aten:
+    type: bool
+    default: false
+
+- namespace: op_gelu
+  dtype_double:
+    type: bool
+    default: true
+"""
+
+_OPTIMIZED_OVERRIDES = """
+- namespace: op_gelu
+  dtype_double: false
+"""
+
+
+class TestCheckRegressions(unittest.TestCase):
+    def setUp(self) -> None:
+        self.tmp = tempfile.TemporaryDirectory()
+        self.kernels_dir = self.tmp.name
+        for path, content in (
+            ("test/supported_features.yaml", _DEFINITIONS),
+            ("optimized/test/supported_features_def.yaml", _OPTIMIZED_OVERRIDES),
+            ("portable/test/supported_features_def.yaml", "# no override\n"),
+        ):
+            full_path = os.path.join(self.kernels_dir, path)
+            os.makedirs(os.path.dirname(full_path), exist_ok=True)
+            with open(full_path, "w") as f:
+                f.write(content)
+
+    def tearDown(self) -> None:
+        self.tmp.cleanup()
+
+    def test_load_features_applies_overrides(self) -> None:
+        portable = load_features("portable", self.kernels_dir)
+        optimized = load_features("optimized", self.kernels_dir)
+        # A library without overrides gets the defaults.
+        custom = load_features("custom", self.kernels_dir)
+        self.assertTrue(portable["op_gelu", "dtype_double"])
+        self.assertFalse(optimized["op_gelu", "dtype_double"])
+        self.assertTrue(custom["op_gelu", "dtype_double"])
+        self.assertFalse(optimized["global", "is_aten"])
+
+    def test_select_supported_skips_disabled_dtypes(self) -> None:
+        names = [
+            "gelu/Float/1x32000/portable",
+            "gelu/Float/1x32000/optimized",
+            "gelu/Double/1x32000/portable",
+            "gelu/Double/1x32000/optimized",
+            "softmax/Double/1x32000/optimized",
+            "not_an_op_benchmark",
+        ]
+        self.assertEqual(
+            select_supported(names, self.kernels_dir),
+            [
+                "gelu/Float/1x32000/portable",
+                "gelu/Float/1x32000/optimized",
+                "gelu/Double/1x32000/portable",
+                "softmax/Double/1x32000/optimized",
+            ],
+        )
+
+    def test_parse_results_uses_medians(self) -> None:
+        results = {
+            "benchmarks": [
+                {
+                    "name": "mm/Float/64x64x64/portable_mean",
+                    "run_name": "mm/Float/64x64x64/portable",
+                    "aggregate_name": "mean",
+                    "real_time": 30.0,
+                    "time_unit": "us",
+                },
+                {
+                    "name": "mm/Float/64x64x64/portable_median",
+                    "run_name": "mm/Float/64x64x64/portable",
+                    "aggregate_name": "median",
+                    "real_time": 20.0,
+                    "time_unit": "us",
+                },
+                {
+                    "name": "mm/Float/64x64x64/optimized",
+                    "run_name": "mm/Float/64x64x64/optimized",
+                    "run_type": "iteration",
+                    "real_time": 5000.0,
+                    "time_unit": "ns",
+                },
+                {
+                    "name": "add/Half/4096/optimized",
+                    "error_occurred": True,
+                    "error_message": "The kernel failed",
+                },
+            ]
+        }
+        self.assertEqual(
+            parse_results(results),
+            {
+                "mm/Float/64x64x64/portable": 20.0,
+                "mm/Float/64x64x64/optimized": 5.0,
+            },
+        )
+
+    def test_compare_flags_changes_beyond_threshold(self) -> None:
+        baseline = {
+            "a/Float/1/portable": {"time_us": 10.0},
+            "b/Float/1/portable": {"time_us": 10.0},
+            "c/Float/1/portable": {"time_us": 10.0},
+        }
+        current = {
+            "a/Float/1/portable": 10.5,
+            "b/Float/1/portable": 12.0,
+            "c/Float/1/portable": 8.0,
+            # No baseline, so never a regression.
+            "d/Float/1/portable": 100.0,
+        }
+        regressions, improvements = compare(baseline, current, threshold=0.1)
+        self.assertEqual([c.name for c in regressions], ["b/Float/1/portable"])
+        self.assertAlmostEqual(regressions[0].ratio, 1.2)
+        self.assertEqual([c.name for c in improvements], ["c/Float/1/portable"])
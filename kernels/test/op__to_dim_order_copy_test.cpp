@@ -11,6 +11,7 @@
 #include <typeindex>
 #include <variant>
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -62,6 +63,57 @@ class OpToDimOrderCopyTest : public OperatorTest {
     return torch::executor::dim_order_ops::_to_dim_order_copy_outf(
         context_, self, non_blocking, dim_order, out);
   }
+
+  // Converts a tensor large enough to be copied in tiles between contiguous
+  // and channels last, in both directions, from DTYPE_IN to DTYPE_OUT.
+  template <ScalarType DTYPE_IN, ScalarType DTYPE_OUT>
+  void test_large_channels_last_round_trip() {
+    TensorFactory<DTYPE_IN> tf_in;
+    TensorFactory<DTYPE_OUT> tf_out;
+    using CTYPE_IN = typename TensorFactory<DTYPE_IN>::ctype;
+    using CTYPE_OUT = typename TensorFactory<DTYPE_OUT>::ctype;
+
+    constexpr int32_t N = 2, C = 19, H = 7, W = 11;
+    const std::vector<int32_t> sizes = {N, C, H, W};
+    std::vector<CTYPE_IN> contiguous_data;
+    std::vector<CTYPE_OUT> channels_last_data(N * C * H * W);
+    for (int32_t n = 0; n < N; ++n) {
+      for (int32_t c = 0; c < C; ++c) {
+        for (int32_t h = 0; h < H; ++h) {
+          for (int32_t w = 0; w < W; ++w) {
+            const auto v = contiguous_data.size() % 101;
+            contiguous_data.push_back(static_cast<CTYPE_IN>(v));
+            channels_last_data[((n * H + h) * W + w) * C + c] =
+                static_cast<CTYPE_OUT>(v);
+          }
+        }
+      }
+    }
+    const std::vector<uint8_t> channels_last = {0, 2, 3, 1};
+
+    std::vector<int64_t> dim_order_vec = {0, 2, 3, 1};
+    Tensor in = tf_in.make(sizes, contiguous_data);
+    Tensor out = tf_out.full_channels_last(sizes, 0);
+    op__to_dim_order_copy_out(
+        in, false, ArrayRef<int64_t>(dim_order_vec.data(), 4), out);
+    EXPECT_TENSOR_EQ(
+        out,
+        tf_out.make_with_dimorder(sizes, channels_last_data, channels_last));
+
+    std::vector<CTYPE_IN> in_channels_last_data(contiguous_data.size());
+    std::vector<CTYPE_OUT> contiguous_out_data(contiguous_data.size());
+    for (const auto i : c10::irange(contiguous_data.size())) {
+      in_channels_last_data[i] =
+          static_cast<CTYPE_IN>(channels_last_data[i]);
+      contiguous_out_data[i] = static_cast<CTYPE_OUT>(contiguous_data[i]);
+    }
+    dim_order_vec = {0, 1, 2, 3};
+    in = tf_in.make_with_dimorder(sizes, in_channels_last_data, channels_last);
+    out = tf_out.zeros(sizes);
+    op__to_dim_order_copy_out(
+        in, false, ArrayRef<int64_t>(dim_order_vec.data(), 4), out);
+    EXPECT_TENSOR_EQ(out, tf_out.make(sizes, contiguous_out_data));
+  }
   // Cast float vector to OUTPUT_CTYPE vector
   template <typename INPUT_CTYPE, typename OUTPUT_CTYPE>
   std::vector<OUTPUT_CTYPE> vector_type_cast(std::vector<INPUT_CTYPE> input) {
@@ -659,3 +711,12 @@ TEST_F(OpToDimOrderCopyTest, PreserveChanneslLast) {
   EXPECT_TENSOR_EQ(out, expected);
   EXPECT_TENSOR_EQ(ret, expected);
 }
+
+TEST_F(OpToDimOrderCopyTest, LargeChannelsLastRoundTrip) {
+  test_large_channels_last_round_trip<ScalarType::Float, ScalarType::Float>();
+  test_large_channels_last_round_trip<ScalarType::Half, ScalarType::Half>();
+  test_large_channels_last_round_trip<ScalarType::Char, ScalarType::Char>();
+  test_large_channels_last_round_trip<ScalarType::Long, ScalarType::Long>();
+  test_large_channels_last_round_trip<ScalarType::Float, ScalarType::Half>();
+  test_large_channels_last_round_trip<ScalarType::Int, ScalarType::Float>();
+}
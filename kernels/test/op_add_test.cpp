@@ -589,6 +589,17 @@ TEST_F(OpAddOutKernelTest, MismatchedNonBroadcastableInputShapesDies) {
   ET_EXPECT_KERNEL_FAILURE(context_, op_add_out(a, b, /*unused=*/0, out));
 }
 
+TEST_F(OpAddOutKernelTest, OutAliasesSelf) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 3}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+  op_add_out(x, tf.make({2, 3}, {6.0, 5.0, 4.0, 3.0, 2.0, 1.0}), 1, x);
+  EXPECT_TENSOR_EQ(x, tf.full({2, 3}, 7.0));
+
+  // other broadcasts over the rows of self.
+  op_add_out(x, tf.make({3}, {1.0, 2.0, 3.0}), 2, x);
+  EXPECT_TENSOR_EQ(x, tf.make({2, 3}, {9.0, 11.0, 13.0, 9.0, 11.0, 13.0}));
+}
+
 TEST_F(OpAddOutKernelTest, MismatchedOutputShapesDies) {
   if (SupportedFeatures::get()->output_resize) {
     GTEST_SKIP()
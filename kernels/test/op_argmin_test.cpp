@@ -15,6 +15,9 @@
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::optional;
@@ -103,3 +106,53 @@ TEST_F(OpArgminTest, FirstNaNWins) {
   EXPECT_TENSOR_EQ(out, ret);
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST_F(OpArgminTest, LargeInput) {
+  // Rows long enough to be split across tasks, with ties and NaNs.
+  constexpr int64_t kRows = 3;
+  constexpr int64_t kCols = 40000;
+  std::vector<float> data(kRows * kCols);
+  for (int64_t i = 0; i < kRows * kCols; ++i) {
+    data[i] = static_cast<float>(i * 7919 % 1000);
+  }
+  data[1 * kCols + 30000] = NAN;
+  data[1 * kCols + 35000] = NAN;
+  data[2 * kCols + 39999] = -2000;
+
+  const auto reference = [&](int64_t size, int64_t stride, int64_t start) {
+    int64_t best = 0;
+    for (int64_t j = 1; j < size; ++j) {
+      const float v = data[start + j * stride];
+      const float acc = data[start + best * stride];
+      if (!std::isnan(acc) && (std::isnan(v) || v < acc)) {
+        best = j;
+      }
+    }
+    return best;
+  };
+
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor in = tf_float.make({kRows, kCols}, data);
+
+  std::vector<int64_t> expected_rows(kRows);
+  for (int64_t i = 0; i < kRows; ++i) {
+    expected_rows[i] = reference(kCols, 1, i * kCols);
+  }
+  Tensor out = tf_long.zeros({kRows});
+  op_argmin_out(in, 1, false, out);
+  EXPECT_TENSOR_EQ(out, tf_long.make({kRows}, expected_rows));
+
+  std::vector<int64_t> expected_cols(kCols);
+  for (int64_t j = 0; j < kCols; ++j) {
+    expected_cols[j] = reference(kRows, kCols, j);
+  }
+  Tensor out_cols = tf_long.zeros({kCols});
+  op_argmin_out(in, 0, false, out_cols);
+  EXPECT_TENSOR_EQ(out_cols, tf_long.make({kCols}, expected_cols));
+
+  Tensor out_all = tf_long.zeros({});
+  op_argmin_out(in, {}, false, out_all);
+  EXPECT_TENSOR_EQ(
+      out_all, tf_long.make({}, {reference(kRows * kCols, 1, 0)}));
+}
@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::optional;
@@ -29,7 +33,8 @@ Tensor& op_cdist_forward_out(
     double p,
     optional<int64_t> compute_mode,
     Tensor& out) {
-  executorch::runtime::KernelRuntimeContext context{};
+  TempMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::aten::_cdist_forward_outf(
       context, x1, x2, p, compute_mode, out);
 }
@@ -149,3 +154,57 @@ TEST_F(OpCdistForwardOutTest, SmokeTest) {
   ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY);
 #undef TEST_ENTRY
 }
+
+TEST_F(OpCdistForwardOutTest, LargeInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Enough rows to be split into blocks and tiles, and for p = 2 to use the
+  // matrix multiplication unless compute_mode is 2. Broadcasts x2 across the
+  // batch of x1.
+  const int64_t B = 2;
+  const int64_t P = 70;
+  const int64_t R = 90;
+  const int64_t M = 33;
+  std::vector<float> x1_data(B * P * M);
+  std::vector<float> x2_data(R * M);
+  for (size_t i = 0; i < x1_data.size(); ++i) {
+    x1_data[i] = static_cast<float>((i * 7 + 3) % 11) - 5;
+  }
+  for (size_t i = 0; i < x2_data.size(); ++i) {
+    x2_data[i] = static_cast<float>((i * 5 + 1) % 13) - 6;
+  }
+  Tensor x1 = tf.make({2, 70, 33}, x1_data);
+  Tensor x2 = tf.make({1, 90, 33}, x2_data);
+
+  for (const double p : {0.0, 1.0, 1.5, 2.0, 3.0, double(INFINITY)}) {
+    std::vector<float> expected(B * P * R);
+    for (int64_t b = 0; b < B; ++b) {
+      for (int64_t i = 0; i < P; ++i) {
+        for (int64_t j = 0; j < R; ++j) {
+          double agg = 0;
+          for (int64_t k = 0; k < M; ++k) {
+            const double diff =
+                std::abs(x1_data[(b * P + i) * M + k] - x2_data[j * M + k]);
+            if (p == 0.0) {
+              agg += diff != 0;
+            } else if (p == INFINITY) {
+              agg = std::max(agg, diff);
+            } else {
+              agg += std::pow(diff, p);
+            }
+          }
+          expected[(b * P + i) * R + j] = static_cast<float>(
+              p == 0.0 || p == INFINITY ? agg : std::pow(agg, 1.0 / p));
+        }
+      }
+    }
+
+    for (const auto compute_mode :
+         {optional<int64_t>(), optional<int64_t>(1), optional<int64_t>(2)}) {
+      Tensor out = tf.zeros({2, 70, 90});
+      op_cdist_forward_out(x1, x2, p, compute_mode, out);
+      EXPECT_TENSOR_CLOSE_WITH_TOL(
+          out, tf.make({2, 70, 90}, expected), 1e-5, 1e-4);
+    }
+  }
+}
@@ -370,6 +370,13 @@ TEST_F(OpClampOutTest, FloatTensorTooLargeClampDies) {
   expect_bad_clamp_value_dies<ScalarType::Float>(3.41e+38);
 }
 
+TEST_F(OpClampOutTest, OutAliasesSelf) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 3}, {-2.0, -0.5, 0.0, 0.5, 1.5, 3.0});
+  op_clamp_out(x, OptScalar(-1.0), OptScalar(1.0), x);
+  EXPECT_TENSOR_EQ(x, tf.make({2, 3}, {-1.0, -0.5, 0.0, 0.5, 1.0, 1.0}));
+}
+
 TEST_F(OpClampOutTest, SimpleGeneratedCase) {
   TensorFactory<ScalarType::Float> tf;
 
@@ -14,6 +14,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::optional;
@@ -214,3 +217,113 @@ TEST_F(OpConvolutionBackwardOutTest, SmokeTest) {
   ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY);
 #undef TEST_ENTRY
 }
+
+TEST_F(OpConvolutionBackwardOutTest, LargeInput) {
+  // Enough channels and positions to split the matrix products across tasks
+  // and column buffers, for a grouped and a depthwise convolution.
+  TensorFactory<ScalarType::Float> tf;
+  struct Config {
+    int32_t in_c;
+    int32_t out_c;
+    int64_t groups;
+  };
+  for (const Config config : {Config{16, 24, 2}, Config{32, 32, 32}}) {
+    const int32_t n = 2, in_h = 20, in_w = 17, k_h = 3, k_w = 3;
+    const int32_t in_c_per_group = config.in_c / config.groups;
+    const int32_t out_c_per_group = config.out_c / config.groups;
+    int64_t stride[2] = {2, 1};
+    int64_t padding[2] = {1, 1};
+    int64_t dilation[2] = {1, 2};
+    int64_t output_padding[2] = {0, 0};
+    const int32_t out_h = (in_h + 2 * 1 - 1 * (k_h - 1) - 1) / 2 + 1;
+    const int32_t out_w = (in_w + 2 * 1 - 2 * (k_w - 1) - 1) / 1 + 1;
+
+    std::vector<float> input_data(n * config.in_c * in_h * in_w);
+    for (size_t i = 0; i < input_data.size(); ++i) {
+      input_data[i] = static_cast<float>(i * 37 % 17) / 8 - 1;
+    }
+    std::vector<float> weight_data(config.out_c * in_c_per_group * k_h * k_w);
+    for (size_t i = 0; i < weight_data.size(); ++i) {
+      weight_data[i] = static_cast<float>(i * 11 % 13) / 6 - 1;
+    }
+    std::vector<float> grad_output_data(n * config.out_c * out_h * out_w);
+    for (size_t i = 0; i < grad_output_data.size(); ++i) {
+      grad_output_data[i] = static_cast<float>(i * 29 % 19) / 9 - 1;
+    }
+
+    std::vector<float> expected_grad_input(input_data.size(), 0);
+    std::vector<float> expected_grad_weight(weight_data.size(), 0);
+    std::vector<float> expected_grad_bias(config.out_c, 0);
+    for (int32_t b = 0; b < n; ++b) {
+      for (int32_t co = 0; co < config.out_c; ++co) {
+        const int32_t group = co / out_c_per_group;
+        for (int32_t oh = 0; oh < out_h; ++oh) {
+          for (int32_t ow = 0; ow < out_w; ++ow) {
+            const float g = grad_output_data
+                [((b * config.out_c + co) * out_h + oh) * out_w + ow];
+            expected_grad_bias[co] += g;
+            for (int32_t ci = 0; ci < in_c_per_group; ++ci) {
+              for (int32_t kh = 0; kh < k_h; ++kh) {
+                for (int32_t kw = 0; kw < k_w; ++kw) {
+                  const int32_t ih = oh * 2 - 1 + kh;
+                  const int32_t iw = ow - 1 + kw * 2;
+                  if (ih < 0 || ih >= in_h || iw < 0 || iw >= in_w) {
+                    continue;
+                  }
+                  const int32_t in_ix =
+                      ((b * config.in_c + group * in_c_per_group + ci) * in_h +
+                       ih) *
+                          in_w +
+                      iw;
+                  const int32_t w_ix =
+                      ((co * in_c_per_group + ci) * k_h + kh) * k_w + kw;
+                  expected_grad_input[in_ix] += g * weight_data[w_ix];
+                  expected_grad_weight[w_ix] += g * input_data[in_ix];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+
+    auto grad_output =
+        tf.make({n, config.out_c, out_h, out_w}, grad_output_data);
+    auto input = tf.make({n, config.in_c, in_h, in_w}, input_data);
+    auto weight =
+        tf.make({config.out_c, in_c_per_group, k_h, k_w}, weight_data);
+    int64_t bias_sizes[1] = {config.out_c};
+    auto grad_input = tf.zeros({n, config.in_c, in_h, in_w});
+    auto grad_weight = tf.zeros({config.out_c, in_c_per_group, k_h, k_w});
+    auto grad_bias = tf.zeros({config.out_c});
+
+    op_convolution_backward_out(
+        grad_output,
+        input,
+        weight,
+        IntArrayRef{bias_sizes, 1},
+        IntArrayRef{stride, 2},
+        IntArrayRef{padding, 2},
+        IntArrayRef{dilation, 2},
+        /*transposed=*/false,
+        IntArrayRef{output_padding, 2},
+        config.groups,
+        {true, true, true},
+        grad_input,
+        grad_weight,
+        grad_bias);
+
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        grad_input,
+        tf.make({n, config.in_c, in_h, in_w}, expected_grad_input),
+        1e-4,
+        1e-4);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        grad_weight,
+        tf.make({config.out_c, in_c_per_group, k_h, k_w}, expected_grad_weight),
+        1e-4,
+        1e-4);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        grad_bias, tf.make({config.out_c}, expected_grad_bias), 1e-4, 1e-4);
+  }
+}
@@ -728,3 +728,174 @@ TEST_F(OpConvCorrectnessTest, InvalidOutputPadding) {
           groups,
           out));
 }
+
+namespace {
+
+/// A 2D convolution, with the weight sizes in [C_out, C_in / groups, kH, kW]
+/// order.
+struct Conv2dCase {
+  std::vector<int32_t> in_sizes;
+  std::vector<int32_t> weight_sizes;
+  std::vector<int64_t> stride;
+  std::vector<int64_t> padding;
+  std::vector<int64_t> dilation;
+  int64_t groups;
+};
+
+/// Values that are exact in float, so that only the order of the sums
+/// differs between implementations.
+std::vector<float> conv_test_data(int32_t size, int32_t seed) {
+  std::vector<float> data(size);
+  for (int32_t i = 0; i < size; ++i) {
+    data[i] = static_cast<float>((i * 37 + seed) % 17 - 8) / 8.0f;
+  }
+  return data;
+}
+
+std::vector<int32_t> numel_and_out_sizes(
+    const Conv2dCase& c,
+    int32_t* in_numel,
+    int32_t* weight_numel) {
+  *in_numel = c.in_sizes[0] * c.in_sizes[1] * c.in_sizes[2] * c.in_sizes[3];
+  *weight_numel = c.weight_sizes[0] * c.weight_sizes[1] * c.weight_sizes[2] *
+      c.weight_sizes[3];
+  std::vector<int32_t> out_sizes = {c.in_sizes[0], c.weight_sizes[0], 0, 0};
+  for (int d = 0; d < 2; ++d) {
+    out_sizes[2 + d] = (c.in_sizes[2 + d] + 2 * c.padding[d] -
+                        c.dilation[d] * (c.weight_sizes[2 + d] - 1) - 1) /
+            c.stride[d] +
+        1;
+  }
+  return out_sizes;
+}
+
+/// Computes the convolution of contiguous data by its definition.
+std::vector<float> reference_conv2d(
+    const Conv2dCase& c,
+    const std::vector<float>& in,
+    const std::vector<float>& weight,
+    const std::vector<float>& bias,
+    const std::vector<int32_t>& out_sizes) {
+  const int32_t N = c.in_sizes[0], C = c.in_sizes[1];
+  const int32_t H = c.in_sizes[2], W = c.in_sizes[3];
+  const int32_t OC = out_sizes[1], OH = out_sizes[2], OW = out_sizes[3];
+  const int32_t IC_G = c.weight_sizes[1];
+  const int32_t KH = c.weight_sizes[2], KW = c.weight_sizes[3];
+  const int32_t OC_G = OC / c.groups;
+  std::vector<float> out(N * OC * OH * OW);
+  for (int32_t n = 0; n < N; ++n) {
+    for (int32_t oc = 0; oc < OC; ++oc) {
+      const int32_t g = oc / OC_G;
+      for (int32_t oh = 0; oh < OH; ++oh) {
+        for (int32_t ow = 0; ow < OW; ++ow) {
+          double acc = bias[oc];
+          for (int32_t ic = 0; ic < IC_G; ++ic) {
+            for (int32_t kh = 0; kh < KH; ++kh) {
+              const int64_t ih =
+                  oh * c.stride[0] - c.padding[0] + kh * c.dilation[0];
+              for (int32_t kw = 0; kw < KW; ++kw) {
+                const int64_t iw =
+                    ow * c.stride[1] - c.padding[1] + kw * c.dilation[1];
+                if (ih < 0 || ih >= H || iw < 0 || iw >= W) {
+                  continue;
+                }
+                acc += in[((n * C + g * IC_G + ic) * H + ih) * W + iw] *
+                    weight[((oc * IC_G + ic) * KH + kh) * KW + kw];
+              }
+            }
+          }
+          out[((n * OC + oc) * OH + oh) * OW + ow] = static_cast<float>(acc);
+        }
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+// Covers the shapes that optimized kernels treat specially, in both dim
+// orders, against a direct computation.
+class OpConvAlgorithmTest : public OpConvOutTest {
+ protected:
+  void test_against_reference(const Conv2dCase& c, bool channels_last) {
+    TensorFactory<ScalarType::Float> tf;
+
+    int32_t in_numel = 0;
+    int32_t weight_numel = 0;
+    const std::vector<int32_t> out_sizes =
+        numel_and_out_sizes(c, &in_numel, &weight_numel);
+    const std::vector<float> in_data = conv_test_data(in_numel, 1);
+    const std::vector<float> weight_data = conv_test_data(weight_numel, 5);
+    const std::vector<float> bias_data = conv_test_data(out_sizes[1], 3);
+    const std::vector<float> expected_data =
+        reference_conv2d(c, in_data, weight_data, bias_data, out_sizes);
+
+    Tensor input = tf.make(c.in_sizes, in_data);
+    Tensor weight = tf.make(c.weight_sizes, weight_data);
+    Tensor expected = tf.make(out_sizes, expected_data);
+    Tensor out = tf.zeros(out_sizes);
+    if (channels_last) {
+      input = tf.make_channels_last(
+          c.in_sizes, get_channels_last_data<float>(input));
+      weight = tf.make_channels_last(
+          c.weight_sizes, get_channels_last_data<float>(weight));
+      expected = tf.make_channels_last(
+          out_sizes, get_channels_last_data<float>(expected));
+      out = tf.full_channels_last(out_sizes, 0);
+    }
+    const optional<Tensor> bias(tf.make({out_sizes[1]}, bias_data));
+    const int64_t output_padding[2] = {0, 0};
+
+    op_convolution_out(
+        input,
+        weight,
+        bias,
+        {c.stride.data(), c.stride.size()},
+        {c.padding.data(), c.padding.size()},
+        {c.dilation.data(), c.dilation.size()},
+        /*transposed=*/false,
+        output_padding,
+        c.groups,
+        out);
+    // Winograd reassociates the sums.
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-4);
+  }
+};
+
+TEST_F(OpConvAlgorithmTest, General) {
+  // Grouped, strided, padded and dilated, with a non-square kernel.
+  const Conv2dCase c{
+      {2, 6, 9, 8}, {4, 3, 3, 2}, {2, 1}, {1, 0}, {2, 1}, /*groups=*/2};
+  test_against_reference(c, /*channels_last=*/false);
+  test_against_reference(c, /*channels_last=*/true);
+}
+
+TEST_F(OpConvAlgorithmTest, Pointwise) {
+  const Conv2dCase c{
+      {2, 12, 5, 7}, {10, 12, 1, 1}, {1, 1}, {0, 0}, {1, 1}, /*groups=*/1};
+  test_against_reference(c, /*channels_last=*/false);
+  test_against_reference(c, /*channels_last=*/true);
+}
+
+TEST_F(OpConvAlgorithmTest, Depthwise) {
+  const Conv2dCase c{
+      {2, 8, 9, 11}, {8, 1, 3, 3}, {2, 1}, {1, 1}, {1, 2}, /*groups=*/8};
+  test_against_reference(c, /*channels_last=*/false);
+  test_against_reference(c, /*channels_last=*/true);
+}
+
+TEST_F(OpConvAlgorithmTest, Winograd3x3LargeOutput) {
+  // Outputs that don't divide into whole tiles.
+  const Conv2dCase c{
+      {1, 16, 10, 11}, {24, 16, 3, 3}, {1, 1}, {1, 1}, {1, 1}, /*groups=*/1};
+  test_against_reference(c, /*channels_last=*/false);
+  test_against_reference(c, /*channels_last=*/true);
+}
+
+TEST_F(OpConvAlgorithmTest, Winograd3x3SmallOutput) {
+  const Conv2dCase c{
+      {2, 32, 7, 5}, {32, 16, 3, 3}, {1, 1}, {0, 1}, {1, 1}, /*groups=*/2};
+  test_against_reference(c, /*channels_last=*/false);
+  test_against_reference(c, /*channels_last=*/true);
+}
@@ -15,6 +15,7 @@
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -286,3 +287,74 @@ TEST_F(OpCumSumOutTest, DynamicShapeUnbound) {
   Tensor ret = op_cumsum_out(x, 1, ScalarType::Float, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpCumSumOutTest, LongRows) {
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Rows long enough to be split into chunks, whose length is not a multiple
+  // of the chunk or block size.
+  constexpr int32_t kRowSize = 100003;
+  std::vector<int32_t> in_data(2 * kRowSize);
+  std::vector<int64_t> expected_data(2 * kRowSize);
+  for (int32_t row = 0; row < 2; ++row) {
+    int64_t sum = 0;
+    for (int32_t i = 0; i < kRowSize; ++i) {
+      const int32_t value = (i * 7 + row) % 13 - 6;
+      sum += value;
+      in_data[row * kRowSize + i] = value;
+      expected_data[row * kRowSize + i] = sum;
+    }
+  }
+  Tensor in = tf_int.make({2, kRowSize}, in_data);
+
+  Tensor out = tf_long.zeros({2, kRowSize});
+  op_cumsum_out(in, /*dim=*/1, ScalarType::Long, out);
+  EXPECT_TENSOR_EQ(out, tf_long.make({2, kRowSize}, expected_data));
+
+  Tensor out_int = tf_int.zeros({2, kRowSize});
+  op_cumsum_out(in, /*dim=*/1, {}, out_int);
+  std::vector<int32_t> expected_int(expected_data.begin(), expected_data.end());
+  EXPECT_TENSOR_EQ(out_int, tf_int.make({2, kRowSize}, expected_int));
+}
+
+TEST_F(OpCumSumOutTest, WideSlices) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // More trailing elements than one task scans, and a non-unit leading dim.
+  constexpr int32_t kTrailing = 1500;
+  std::vector<float> in_data(2 * 3 * kTrailing);
+  std::vector<float> expected_data(in_data.size());
+  for (int32_t slice = 0; slice < 2; ++slice) {
+    for (int32_t t = 0; t < kTrailing; ++t) {
+      float sum = 0;
+      for (int32_t j = 0; j < 3; ++j) {
+        const size_t index = (slice * 3 + j) * kTrailing + t;
+        const float value = static_cast<float>((t + j + slice) % 5);
+        sum += value;
+        in_data[index] = value;
+        expected_data[index] = sum;
+      }
+    }
+  }
+  Tensor in = tf.make({2, 3, kTrailing}, in_data);
+  Tensor out = tf.zeros({2, 3, kTrailing});
+  op_cumsum_out(in, /*dim=*/1, {}, out);
+  EXPECT_TENSOR_EQ(out, tf.make({2, 3, kTrailing}, expected_data));
+}
+
+TEST_F(OpCumSumOutTest, HalfRow) {
+  TensorFactory<ScalarType::Half> tf;
+
+  std::vector<executorch::aten::Half> in_data;
+  std::vector<executorch::aten::Half> expected_data;
+  float sum = 0;
+  for (int i = 0; i < 21; ++i) {
+    in_data.push_back(static_cast<float>(i % 3));
+    sum += i % 3;
+    expected_data.push_back(sum);
+  }
+  Tensor out = tf.zeros({21});
+  op_cumsum_out(tf.make({21}, in_data), /*dim=*/0, {}, out);
+  EXPECT_TENSOR_EQ(out, tf.make({21}, expected_data));
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -189,6 +190,56 @@ TEST_F(OpEmbeddingOutTest, IndicesMultiDims) {
   // clang-format on
 }
 
+TEST_F(OpEmbeddingOutTest, ManyIndices) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+  TensorFactory<ScalarType::Int> tfi;
+
+  // Enough lookups to be split between threads, for rows of several
+  // elements and of a single element.
+  for (const int32_t embedding_dim : {19, 1}) {
+    constexpr int32_t kNumEmbeddings = 257;
+    std::vector<float> weight_data(kNumEmbeddings * embedding_dim);
+    for (const auto i : c10::irange(weight_data.size())) {
+      weight_data[i] = static_cast<float>(i);
+    }
+    Tensor weight = tf.make({kNumEmbeddings, embedding_dim}, weight_data);
+
+    std::vector<int64_t> indices_data(3 * 700);
+    std::vector<float> expected_data;
+    for (const auto i : c10::irange(indices_data.size())) {
+      indices_data[i] = (i * 37) % kNumEmbeddings;
+      expected_data.insert(
+          expected_data.end(),
+          weight_data.begin() + indices_data[i] * embedding_dim,
+          weight_data.begin() + (indices_data[i] + 1) * embedding_dim);
+    }
+    const Tensor expected = tf.make({3, 700, embedding_dim}, expected_data);
+
+    Tensor out = tf.zeros({3, 700, embedding_dim});
+    op_embedding_out(
+        weight,
+        tfl.make({3, 700}, indices_data),
+        /*padding_idx=*/0,
+        /*scale_grad_by_freq=*/false,
+        /*sparse=*/false,
+        out);
+    EXPECT_TENSOR_EQ(out, expected);
+
+    out = tf.zeros({3, 700, embedding_dim});
+    op_embedding_out(
+        weight,
+        tfi.make(
+            {3, 700},
+            std::vector<int32_t>(indices_data.begin(), indices_data.end())),
+        /*padding_idx=*/0,
+        /*scale_grad_by_freq=*/false,
+        /*sparse=*/false,
+        out);
+    EXPECT_TENSOR_EQ(out, expected);
+  }
+}
+
 TEST_F(OpEmbeddingOutTest, WeightWrongDimensionsDies) {
   TensorFactory<ScalarType::Float> tff;
   // clang-format off
@@ -50,4 +50,27 @@ TEST_F(OpErfOutTest, SanityCheck) {
   EXPECT_TENSOR_CLOSE(out, expected);
 }
 
+TEST_F(OpErfOutTest, ManyValuesMatchReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Several vectors' worth of values spanning [-4, 4], including values very
+  // close to zero, where erf(x) is about 1.128 * x.
+  std::vector<float> in_data;
+  for (int i = -50; i <= 50; ++i) {
+    in_data.push_back(i * 0.08f);
+    in_data.push_back(i * 1e-5f);
+  }
+  std::vector<float> expected_data;
+  for (const float x : in_data) {
+    expected_data.push_back(static_cast<float>(std::erf(double(x))));
+  }
+  const int32_t numel = static_cast<int32_t>(in_data.size());
+
+  Tensor in = tf.make({numel}, in_data);
+  Tensor out = tf.zeros({numel});
+  op_out(in, out);
+
+  EXPECT_TENSOR_CLOSE(out, tf.make({numel}, expected_data));
+}
+
 IMPLEMENT_UNARY_UFUNC_REALHB_TO_FLOATH_TEST(OpErfOutTest)
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using executorch::aten::IntArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpFftC2cOutTest : public OperatorTest {
+ protected:
+  Tensor& op_fft_c2c_out(
+      const Tensor& in,
+      IntArrayRef dim,
+      int64_t normalization,
+      bool forward,
+      Tensor& out) {
+    return torch::executor::aten::_fft_c2c_outf(
+        context_, in, dim, normalization, forward, out);
+  }
+
+  template <
+      class CTYPE,
+      executorch::aten::ScalarType DTYPE,
+      bool expect_failure = false>
+  void test_dtype(int64_t norm, int64_t dim = 1, bool forward = true) {
+    constexpr auto DTYPE_C = executorch::runtime::toComplexType(DTYPE);
+    TensorFactory<DTYPE_C> tf;
+
+    using CTYPE_C =
+        typename executorch::runtime::ScalarTypeToCppType<DTYPE_C>::type;
+
+    std::vector<CTYPE_C> signal = {
+        CTYPE_C{0, 0}, CTYPE_C{1, 0}, CTYPE_C{2, 0}, CTYPE_C{3, 0}};
+    std::vector<CTYPE_C> spectrum = {
+        CTYPE_C{6, 0}, CTYPE_C{-2, 2}, CTYPE_C{-2, 0}, CTYPE_C{-2, -2}};
+    // The inverse transform of the spectrum is the signal scaled by 4.
+    std::vector<CTYPE_C> in_data = forward ? signal : spectrum;
+    std::vector<CTYPE_C> expected_data = forward ? spectrum : signal;
+    double scale = forward ? 1 : 4;
+    if (norm == 1) {
+      scale /= 2;
+    } else if (norm == 2) {
+      scale /= 4;
+    }
+    for (auto& elem : expected_data) {
+      elem.real_ *= scale;
+      elem.imag_ *= scale;
+    }
+    in_data.insert(in_data.end(), in_data.begin(), in_data.end());
+    expected_data.insert(
+        expected_data.end(), expected_data.begin(), expected_data.end());
+
+    Tensor in = tf.make({2, 4}, in_data);
+    Tensor out = tf.full({2, 4}, CTYPE_C{0, 0});
+
+    op_fft_c2c_out(in, {dim}, norm, forward, out);
+
+    if (!expect_failure) {
+      EXPECT_TENSOR_CLOSE(out, tf.make({2, 4}, expected_data));
+    }
+  }
+
+  template <class CTYPE, executorch::aten::ScalarType DTYPE>
+  void test_dtype_multiple_axes() {
+    constexpr auto DTYPE_C = executorch::runtime::toComplexType(DTYPE);
+    TensorFactory<DTYPE_C> tf;
+
+    using CTYPE_C =
+        typename executorch::runtime::ScalarTypeToCppType<DTYPE_C>::type;
+
+    Tensor in = tf.make(
+        {2, 2},
+        {CTYPE_C{1, 0}, CTYPE_C{2, 0}, CTYPE_C{0, 1}, CTYPE_C{0, 3}});
+    Tensor out = tf.full({2, 2}, CTYPE_C{0, 0});
+
+    std::array<int64_t, 2> dim = {0, 1};
+    op_fft_c2c_out(in, dim, 0, true, out);
+
+    Tensor expected = tf.make(
+        {2, 2},
+        {CTYPE_C{3, 4}, CTYPE_C{-1, -2}, CTYPE_C{3, -4}, CTYPE_C{-1, 2}});
+    EXPECT_TENSOR_CLOSE(out, expected);
+  }
+};
+
+TEST_F(OpFftC2cOutTest, AllDtypesSupported) {
+#define TEST_ENTRY(ctype, dtype)                             \
+  test_dtype<ctype, ScalarType::dtype>(0);                   \
+  test_dtype<ctype, ScalarType::dtype>(1);                   \
+  test_dtype<ctype, ScalarType::dtype>(2);                   \
+  test_dtype<ctype, ScalarType::dtype>(0, 1, /*forward=*/false); \
+  test_dtype<ctype, ScalarType::dtype>(2, 1, /*forward=*/false);
+  ET_FORALL_FLOAT_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpFftC2cOutTest, MultipleDims) {
+#define TEST_ENTRY(ctype, dtype) \
+  test_dtype_multiple_axes<ctype, ScalarType::dtype>();
+  ET_FORALL_FLOAT_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpFftC2cOutTest, InvalidNorm) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen MKL path does not validate norm";
+    return;
+  }
+  auto invalid_norm = [this](int64_t norm) {
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(norm);
+  };
+  ET_EXPECT_KERNEL_FAILURE(context_, invalid_norm(3));
+  ET_EXPECT_KERNEL_FAILURE(context_, invalid_norm(-1));
+}
+
+TEST_F(OpFftC2cOutTest, InvalidDim) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen fails UBSAN";
+    return;
+  }
+  auto invalid_dim = [this]() {
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(0, -1);
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(0, 3);
+  };
+  ET_EXPECT_KERNEL_FAILURE(context_, invalid_dim());
+}
+
+TEST_F(OpFftC2cOutTest, RealInputDies) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen promotes real inputs";
+    return;
+  }
+  TensorFactory<ScalarType::Float> tf;
+  Tensor in = tf.make({4}, {0, 1, 2, 3});
+  Tensor out = tf.zeros({4});
+  ET_EXPECT_KERNEL_FAILURE(context_, op_fft_c2c_out(in, {0}, 0, true, out));
+}
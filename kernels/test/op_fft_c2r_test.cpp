@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using executorch::aten::IntArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpFftC2rOutTest : public OperatorTest {
+ protected:
+  Tensor& op_fft_c2r_out(
+      const Tensor& in,
+      IntArrayRef dim,
+      int64_t normalization,
+      int64_t last_dim_size,
+      Tensor& out) {
+    return torch::executor::aten::_fft_c2r_outf(
+        context_, in, dim, normalization, last_dim_size, out);
+  }
+
+  template <
+      class CTYPE,
+      executorch::aten::ScalarType DTYPE,
+      bool expect_failure = false>
+  void test_dtype(int64_t norm, int64_t dim = 1, int64_t last_dim_size = 4) {
+    TensorFactory<DTYPE> tf;
+    constexpr auto DTYPE_IN = executorch::runtime::toComplexType(DTYPE);
+    TensorFactory<DTYPE_IN> tf_in;
+
+    using CTYPE_IN =
+        typename executorch::runtime::ScalarTypeToCppType<DTYPE_IN>::type;
+
+    // The onesided spectrum of {0, 1, 2, 3}, as computed by _fft_r2c.
+    Tensor in = tf_in.make(
+        {2, 3},
+        {CTYPE_IN{6, 0},
+         CTYPE_IN{-2, 2},
+         CTYPE_IN{-2, 0},
+         CTYPE_IN{6, 0},
+         CTYPE_IN{-2, 2},
+         CTYPE_IN{-2, 0}});
+    Tensor out = tf.zeros({2, 4});
+
+    op_fft_c2r_out(in, {dim}, norm, last_dim_size, out);
+
+    double scale = 4;
+    if (norm == 1) {
+      scale = 2;
+    } else if (norm == 2) {
+      scale = 1;
+    }
+    std::vector<CTYPE> expected_data = {0, 1, 2, 3, 0, 1, 2, 3};
+    for (auto& elem : expected_data) {
+      elem *= scale;
+    }
+
+    if (!expect_failure) {
+      EXPECT_TENSOR_CLOSE(out, tf.make({2, 4}, expected_data));
+    }
+  }
+
+  template <class CTYPE, executorch::aten::ScalarType DTYPE>
+  void test_dtype_multiple_axes() {
+    TensorFactory<DTYPE> tf;
+    constexpr auto DTYPE_IN = executorch::runtime::toComplexType(DTYPE);
+    TensorFactory<DTYPE_IN> tf_in;
+
+    using CTYPE_IN =
+        typename executorch::runtime::ScalarTypeToCppType<DTYPE_IN>::type;
+
+    // The output of OpFftR2cOutTest.MultipleDims.
+    Tensor in = tf_in.make(
+        {4, 3},
+        {CTYPE_IN{24, 0},
+         CTYPE_IN{0, -4},
+         CTYPE_IN{0, 0},
+
+         CTYPE_IN{0, 0},
+         CTYPE_IN{-4, 0},
+         CTYPE_IN{0, 0},
+
+         CTYPE_IN{0, 0},
+         CTYPE_IN{0, 4},
+         CTYPE_IN{-8, 0},
+
+         CTYPE_IN{0, 0},
+         CTYPE_IN{-4, 8},
+         CTYPE_IN{0, 0}});
+    Tensor out = tf.zeros({4, 4});
+
+    std::array<int64_t, 2> dim = {0, 1};
+    op_fft_c2r_out(in, dim, 2, 4, out);
+
+    Tensor expected =
+        tf.make({4, 4}, {0, 1, 2, 3, 3, 2, 1, 0, 2, 3, 0, 1, 1, 2, 3, 0});
+    EXPECT_TENSOR_CLOSE(out, expected);
+  }
+};
+
+TEST_F(OpFftC2rOutTest, AllDtypesSupported) {
+#define TEST_ENTRY(ctype, dtype)           \
+  test_dtype<ctype, ScalarType::dtype>(0); \
+  test_dtype<ctype, ScalarType::dtype>(1); \
+  test_dtype<ctype, ScalarType::dtype>(2);
+  ET_FORALL_FLOAT_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpFftC2rOutTest, MultipleDims) {
+#define TEST_ENTRY(ctype, dtype) \
+  test_dtype_multiple_axes<ctype, ScalarType::dtype>();
+  ET_FORALL_FLOAT_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpFftC2rOutTest, InvalidNorm) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen MKL path does not validate norm";
+    return;
+  }
+  auto invalid_norm = [this](int64_t norm) {
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(norm);
+  };
+  ET_EXPECT_KERNEL_FAILURE(context_, invalid_norm(3));
+  ET_EXPECT_KERNEL_FAILURE(context_, invalid_norm(-1));
+}
+
+TEST_F(OpFftC2rOutTest, InvalidDim) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen fails UBSAN";
+    return;
+  }
+  auto invalid_dim = [this]() {
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(0, -1);
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(0, 3);
+  };
+  ET_EXPECT_KERNEL_FAILURE(context_, invalid_dim());
+}
+
+TEST_F(OpFftC2rOutTest, LastDimSizeTooLargeDies) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen reads past the end of the input";
+    return;
+  }
+  auto too_large = [this]() {
+    test_dtype<float, ScalarType::Float, /* expect_failure = */ true>(0, 1, 6);
+  };
+  ET_EXPECT_KERNEL_FAILURE(context_, too_large());
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -17,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 using executorch::aten::IntArrayRef;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
@@ -157,6 +160,56 @@ TEST_F(OpFftR2cOutTest, InvalidDim) {
   ET_EXPECT_KERNEL_FAILURE(context_, negative_dim());
 }
 
+TEST_F(OpFftR2cOutTest, BatchedMatchesNaiveDft) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::ComplexFloat> tf_out;
+  using CTYPE_OUT = executorch::aten::complex<float>;
+
+  // Enough transforms along a non-leading batch dim to be split between
+  // threads.
+  constexpr int64_t kOuter = 2;
+  constexpr int64_t kN = 64;
+  constexpr int64_t kBatch = 600;
+  constexpr int64_t kOutN = kN / 2 + 1;
+  std::vector<float> in_data(kOuter * kN * kBatch);
+  for (const auto i : c10::irange(in_data.size())) {
+    in_data[i] = static_cast<float>((i * 7919) % 13) - 6;
+  }
+  // Complex tensors are compared bitwise, so compare the real and imaginary
+  // parts as floats instead.
+  std::vector<float> expected_data(kOuter * kOutN * kBatch * 2);
+  for (const auto o : c10::irange(kOuter)) {
+    for (const auto b : c10::irange(kBatch)) {
+      for (const auto k : c10::irange(kOutN)) {
+        double re = 0;
+        double im = 0;
+        for (const auto n : c10::irange(kN)) {
+          const double x = in_data[(o * kN + n) * kBatch + b];
+          const double angle = -2 * M_PI * double((n * k) % kN) / kN;
+          re += x * std::cos(angle);
+          im += x * std::sin(angle);
+        }
+        const auto idx = ((o * kOutN + k) * kBatch + b) * 2;
+        expected_data[idx] = static_cast<float>(re);
+        expected_data[idx + 1] = static_cast<float>(im);
+      }
+    }
+  }
+
+  Tensor in = tf.make({kOuter, kN, kBatch}, in_data);
+  Tensor out = tf_out.full({kOuter, kOutN, kBatch}, CTYPE_OUT{0, 0});
+  op_fft_r2c_out(in, {1}, 0, true, out);
+
+  const float* out_data =
+      reinterpret_cast<const float*>(out.const_data_ptr<CTYPE_OUT>());
+  std::vector<float> actual_data(out_data, out_data + out.numel() * 2);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      tf.make({kOuter, kOutN, kBatch, 2}, actual_data),
+      tf.make({kOuter, kOutN, kBatch, 2}, expected_data),
+      0,
+      1e-3);
+}
+
 // TODO: support this and patch test accordingly!
 TEST_F(OpFftR2cOutTest, TwoSidedIsNotSupported) {
   if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
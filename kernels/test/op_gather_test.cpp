@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -34,6 +35,44 @@ class OpGatherOutTest : public OperatorTest {
         context_, self, dim, index, sparse_grad, out);
   }
 
+  // Gathers along each dim of a 3-D tensor with an index of index_sizes,
+  // and checks the result one coordinate at a time.
+  template <ScalarType DTYPE>
+  void test_large_gather(const std::vector<int32_t>& index_sizes) {
+    TensorFactory<DTYPE> tf_data;
+    TensorFactory<ScalarType::Long> tf_index;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    const std::vector<int32_t> sizes = {6, 9, 13};
+    std::vector<CTYPE> in_data(6 * 9 * 13);
+    for (const auto i : c10::irange(in_data.size())) {
+      in_data[i] = static_cast<CTYPE>(i % 101);
+    }
+    const Tensor in = tf_data.make(sizes, in_data);
+
+    for (const auto dim : c10::irange(3)) {
+      std::vector<int64_t> index_data;
+      std::vector<CTYPE> expected_data;
+      int64_t c[3];
+      for (c[0] = 0; c[0] < index_sizes[0]; ++c[0]) {
+        for (c[1] = 0; c[1] < index_sizes[1]; ++c[1]) {
+          for (c[2] = 0; c[2] < index_sizes[2]; ++c[2]) {
+            int64_t in_c[3] = {c[0], c[1], c[2]};
+            in_c[dim] = (index_data.size() * 7) % sizes[dim];
+            index_data.push_back(in_c[dim]);
+            expected_data.push_back(
+                in_data[(in_c[0] * sizes[1] + in_c[1]) * sizes[2] + in_c[2]]);
+          }
+        }
+      }
+
+      Tensor out = tf_data.zeros(index_sizes);
+      op_gather_out(
+          in, dim, tf_index.make(index_sizes, index_data), false, out);
+      EXPECT_TENSOR_EQ(out, tf_data.make(index_sizes, expected_data));
+    }
+  }
+
   // Common testing for the operator
   template <ScalarType DATA_DTYPE>
   void test_gather_out() {
@@ -198,6 +237,15 @@ TEST_F(OpGatherOutTest, AllValidInputOutputSupport) {
 #undef TEST_ENTRY
 }
 
+TEST_F(OpGatherOutTest, LargeIndexAlongEachDim) {
+  // Index as large as self, and with fewer elements than self along every
+  // dim.
+  test_large_gather<ScalarType::Float>({6, 9, 13});
+  test_large_gather<ScalarType::Float>({5, 8, 11});
+  test_large_gather<ScalarType::Half>({6, 9, 13});
+  test_large_gather<ScalarType::Char>({4, 9, 13});
+}
+
 TEST_F(OpGatherOutTest, InfinityAndNANTest) {
   TensorFactory<ScalarType::Long> tf_index;
   TensorFactory<ScalarType::Float> tf_data;
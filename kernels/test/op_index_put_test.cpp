@@ -1011,3 +1011,44 @@ TEST_F(OpIndexPutOutTest, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST_F(OpIndexPutOutTest, PutRowsLargeInput) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // A single index along one dim writes whole rows, in parallel when there
+  // are enough of them. Repeated and negative index values must behave as
+  // they do serially.
+  const std::vector<int32_t> sizes = {2, 1000, 40};
+  const int64_t num_rows = 1500;
+  std::vector<int64_t> index_data(num_rows);
+  for (int64_t k = 0; k < num_rows; ++k) {
+    index_data[k] = (k * 37) % 1000 - (k % 3 == 0 ? 1000 : 0);
+  }
+  std::vector<float> values_data(2 * num_rows * 40);
+  for (size_t i = 0; i < values_data.size(); ++i) {
+    values_data[i] = static_cast<float>(i % 17);
+  }
+
+  for (const bool accumulate : {false, true}) {
+    std::vector<float> expected(2 * 1000 * 40, 1.0f);
+    for (int64_t l = 0; l < 2; ++l) {
+      for (int64_t k = 0; k < num_rows; ++k) {
+        const int64_t row = (index_data[k] + 1000) % 1000;
+        for (int64_t r = 0; r < 40; ++r) {
+          float& dst = expected[(l * 1000 + row) * 40 + r];
+          const float val = values_data[(l * num_rows + k) * 40 + r];
+          dst = accumulate ? dst + val : val;
+        }
+      }
+    }
+
+    Tensor x = tf.ones(sizes);
+    optional<Tensor> indices[] = {
+        optional<Tensor>(), optional<Tensor>(tfl.make({1500}, index_data))};
+    Tensor values = tf.make({2, 1500, 40}, values_data);
+    Tensor out = tf.zeros(sizes);
+    op_index_put_out(x, indices, values, accumulate, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected));
+  }
+}
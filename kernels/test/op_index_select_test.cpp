@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -34,6 +35,47 @@ class OpIndexSelectOutTest : public OperatorTest {
         context_, self, dim, index, out);
   }
 
+  // Selects many indices along each dim of a 3-D tensor and checks the
+  // result one coordinate at a time.
+  template <ScalarType DTYPE>
+  void test_many_indices() {
+    TensorFactory<DTYPE> tf;
+    TensorFactory<ScalarType::Long> tfl;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    const std::vector<int32_t> sizes = {5, 7, 11};
+    std::vector<CTYPE> in_data(5 * 7 * 11);
+    for (const auto i : c10::irange(in_data.size())) {
+      in_data[i] = static_cast<CTYPE>(i % 101);
+    }
+    const Tensor in = tf.make(sizes, in_data);
+
+    for (const auto dim : c10::irange(3)) {
+      std::vector<int64_t> index_data(300);
+      for (const auto i : c10::irange(index_data.size())) {
+        index_data[i] = (i * 3) % sizes[dim];
+      }
+      std::vector<int32_t> out_sizes = sizes;
+      out_sizes[dim] = index_data.size();
+      std::vector<CTYPE> expected_data;
+      int64_t c[3];
+      for (c[0] = 0; c[0] < out_sizes[0]; ++c[0]) {
+        for (c[1] = 0; c[1] < out_sizes[1]; ++c[1]) {
+          for (c[2] = 0; c[2] < out_sizes[2]; ++c[2]) {
+            int64_t in_c[3] = {c[0], c[1], c[2]};
+            in_c[dim] = index_data[c[dim]];
+            expected_data.push_back(
+                in_data[(in_c[0] * sizes[1] + in_c[1]) * sizes[2] + in_c[2]]);
+          }
+        }
+      }
+
+      Tensor out = tf.zeros(out_sizes);
+      op_index_select_out(in, dim, tfl.make({300}, index_data), out);
+      EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected_data));
+    }
+  }
+
   template <class CTYPE, executorch::aten::ScalarType DTYPE>
   void test_dtype() {
     TensorFactory<DTYPE> tf;
@@ -281,6 +323,13 @@ TEST_F(OpIndexSelectOutTest, AllDtypesSupported) {
 
 // In this test we are gonnna find if our select function support non-empty
 // tensor input and empty-size tensor output.
+TEST_F(OpIndexSelectOutTest, ManyIndicesAlongEachDim) {
+  test_many_indices<ScalarType::Float>();
+  test_many_indices<ScalarType::Half>();
+  test_many_indices<ScalarType::Char>();
+  test_many_indices<ScalarType::Long>();
+}
+
 TEST_F(OpIndexSelectOutTest, NonEmptyInputEmptyOutputWithMismatchDimDies) {
   if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
     GTEST_SKIP() << "ATen kernel can handle out with mismatched dimensions";
@@ -461,3 +461,13 @@ TEST_F(OpMaskedFillTest, BroadcastDimSizeMissingBA) {
   Tensor ret = op_masked_fill_scalar_out(x, y, z, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpMaskedFillTest, OutAliasesSelf) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tf_bool;
+  Tensor x = tf.make({2, 3}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+  // The mask broadcasts over the rows of self.
+  op_masked_fill_scalar_out(
+      x, tf_bool.make({3}, {true, false, true}), /*value=*/-1.0, x);
+  EXPECT_TENSOR_EQ(x, tf.make({2, 3}, {-1.0, 2.0, -1.0, -1.0, 5.0, -1.0}));
+}
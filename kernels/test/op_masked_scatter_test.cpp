@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
@@ -31,6 +33,40 @@ class OpMaskedScatterOutTest : public OperatorTest {
     return torch::executor::aten::masked_scatter_outf(
         context_, in, mask, src, out);
   }
+
+  // Scatters into enough elements for several blocks of the optimized
+  // kernel, and a count that isn't a multiple of any vector size.
+  template <ScalarType DTYPE>
+  void test_large_input() {
+    TensorFactory<DTYPE> tf;
+    TensorFactory<ScalarType::Bool> tfBool;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    constexpr int32_t kNumel = 70001;
+    std::vector<CTYPE> in_data;
+    std::vector<uint8_t> mask_data;
+    std::vector<CTYPE> src_data;
+    std::vector<CTYPE> expected;
+    for (int32_t i = 0; i < kNumel; ++i) {
+      in_data.push_back(static_cast<CTYPE>(i % 50));
+      mask_data.push_back(i % 3 == 0 || i % 7 == 0);
+      if (mask_data.back()) {
+        src_data.push_back(static_cast<CTYPE>(50 + src_data.size() % 50));
+        expected.push_back(src_data.back());
+      } else {
+        expected.push_back(in_data.back());
+      }
+    }
+    const int32_t src_numel = src_data.size();
+
+    Tensor out = tf.zeros({kNumel});
+    op_masked_scatter_out(
+        tf.make({kNumel}, in_data),
+        tfBool.make({kNumel}, mask_data),
+        tf.make({src_numel}, src_data),
+        out);
+    EXPECT_TENSOR_EQ(out, tf.make({kNumel}, expected));
+  }
 };
 
 TEST_F(OpMaskedScatterOutTest, SmokeTest) {
@@ -143,3 +179,10 @@ TEST_F(OpMaskedScatterOutTest, EmptyMaskAndSrc) {
   op_masked_scatter_out(in, mask, src, out);
   EXPECT_TENSOR_EQ(out, tf.make({2, 0}, {}));
 }
+
+TEST_F(OpMaskedScatterOutTest, LargeInput) {
+  test_large_input<ScalarType::Byte>();
+  test_large_input<ScalarType::Half>();
+  test_large_input<ScalarType::Float>();
+  test_large_input<ScalarType::Long>();
+}
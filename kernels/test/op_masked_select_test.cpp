@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
@@ -27,6 +29,33 @@ class OpMaskedSelectOutTest : public OperatorTest {
   op_masked_select_out(const Tensor& in, const Tensor& mask, Tensor& out) {
     return torch::executor::aten::masked_select_outf(context_, in, mask, out);
   }
+
+  // Selects from enough elements for several blocks of the optimized kernel,
+  // and a count that isn't a multiple of any vector size.
+  template <ScalarType DTYPE>
+  void test_large_input() {
+    TensorFactory<DTYPE> tf;
+    TensorFactory<ScalarType::Bool> tfBool;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    constexpr int32_t kNumel = 70001;
+    std::vector<CTYPE> data;
+    std::vector<uint8_t> mask_data;
+    std::vector<CTYPE> expected;
+    for (int32_t i = 0; i < kNumel; ++i) {
+      data.push_back(static_cast<CTYPE>(i % 100));
+      mask_data.push_back(i % 3 == 0 || i % 7 == 0);
+      if (mask_data.back()) {
+        expected.push_back(data.back());
+      }
+    }
+    const int32_t num_selected = expected.size();
+
+    Tensor out = tf.zeros({num_selected});
+    op_masked_select_out(
+        tf.make({kNumel}, data), tfBool.make({kNumel}, mask_data), out);
+    EXPECT_TENSOR_EQ(out, tf.make({num_selected}, expected));
+  }
 };
 
 TEST_F(OpMaskedSelectOutTest, SmokeTest) {
@@ -113,3 +142,10 @@ TEST_F(OpMaskedSelectOutTest, EmptyInputAndMask) {
   op_masked_select_out(in, mask, out);
   EXPECT_TENSOR_EQ(out, tf.make({0}, {}));
 }
+
+TEST_F(OpMaskedSelectOutTest, LargeInput) {
+  test_large_input<ScalarType::Byte>();
+  test_large_input<ScalarType::Half>();
+  test_large_input<ScalarType::Float>();
+  test_large_input<ScalarType::Long>();
+}
@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 
 class OpMaxPool2DWithIndicesBackwardOutTest : public OperatorTest {
@@ -227,3 +229,68 @@ TEST_F(OpMaxPool2DWithIndicesBackwardOutTest, SanityTest3D) {
   ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY);
 #undef TEST_ENTRY
 }
+
+TEST_F(OpMaxPool2DWithIndicesBackwardOutTest, LargeInput) {
+  // Overlapping windows send several outputs to the same input.
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tf;
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Long>
+      tfLong;
+  const int32_t n = 2, c = 24, in_h = 21, in_w = 18;
+  const int32_t out_h = (in_h + 2 - 3) / 2 + 1;
+  const int32_t out_w = (in_w + 2 - 3) / 2 + 1;
+
+  std::vector<float> input_data(n * c * in_h * in_w);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>(i * 53 % 101);
+  }
+  std::vector<float> grad_output_data(n * c * out_h * out_w);
+  std::vector<int64_t> indices_data(grad_output_data.size());
+  std::vector<float> expected(input_data.size(), 0);
+  for (int32_t plane = 0; plane < n * c; ++plane) {
+    for (int32_t oh = 0; oh < out_h; ++oh) {
+      for (int32_t ow = 0; ow < out_w; ++ow) {
+        int64_t best = -1;
+        for (int32_t ih = oh * 2 - 1; ih < oh * 2 + 2; ++ih) {
+          for (int32_t iw = ow * 2 - 1; iw < ow * 2 + 2; ++iw) {
+            if (ih < 0 || ih >= in_h || iw < 0 || iw >= in_w) {
+              continue;
+            }
+            const int64_t ix = ih * in_w + iw;
+            if (best == -1 ||
+                input_data[plane * in_h * in_w + ix] >
+                    input_data[plane * in_h * in_w + best]) {
+              best = ix;
+            }
+          }
+        }
+        const int32_t o = (plane * out_h + oh) * out_w + ow;
+        grad_output_data[o] = static_cast<float>(o % 7) - 3;
+        indices_data[o] = best;
+        expected[plane * in_h * in_w + best] += grad_output_data[o];
+      }
+    }
+  }
+
+  int64_t kernel_size[2] = {3, 3};
+  int64_t stride[2] = {2, 2};
+  int64_t padding[2] = {1, 1};
+  int64_t dilation[2] = {1, 1};
+  executorch::aten::Tensor grad_output =
+      tf.make({n, c, out_h, out_w}, grad_output_data);
+  executorch::aten::Tensor input = tf.make({n, c, in_h, in_w}, input_data);
+  executorch::aten::Tensor indices =
+      tfLong.make({n, c, out_h, out_w}, indices_data);
+  executorch::aten::Tensor grad_input = tf.zeros({n, c, in_h, in_w});
+  op_max_pool2d_with_indices_backward_out(
+      grad_output,
+      input,
+      executorch::aten::ArrayRef<int64_t>{kernel_size, 2},
+      executorch::aten::ArrayRef<int64_t>{stride, 2},
+      executorch::aten::ArrayRef<int64_t>{padding, 2},
+      executorch::aten::ArrayRef<int64_t>{dilation, 2},
+      false,
+      indices,
+      grad_input);
+  EXPECT_TENSOR_CLOSE(grad_input, tf.make({n, c, in_h, in_w}, expected));
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -15,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+
 using namespace ::testing;
 
 class OpMaxPool2DWithIndicesOutTest : public OperatorTest {
@@ -387,3 +390,77 @@ TEST_F(OpMaxPool2DWithIndicesOutTest, CeilMode) {
       self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
   EXPECT_TENSOR_CLOSE(out, out_expected);
 }
+
+TEST_F(OpMaxPool2DWithIndicesOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tfFloat;
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Long>
+      tfLong;
+
+  // Enough channels for both full vectors and a remainder, and windows
+  // that are partly in the padding.
+  const std::vector<int32_t> in_sizes = {2, 19, 9, 11};
+  const std::vector<int32_t> out_sizes = {2, 19, 5, 6};
+  executorch::aten::Tensor self = tfFloat.zeros(in_sizes);
+  executorch::aten::Tensor self_cl = tfFloat.zeros_channels_last(in_sizes);
+  auto self_data = self.mutable_data_ptr<float>();
+  auto self_cl_data = self_cl.mutable_data_ptr<float>();
+  for (const auto n : c10::irange(in_sizes[0])) {
+    for (const auto c : c10::irange(in_sizes[1])) {
+      for (const auto h : c10::irange(in_sizes[2])) {
+        for (const auto w : c10::irange(in_sizes[3])) {
+          // Few distinct values, so that windows have ties.
+          const float val =
+              static_cast<float>((n * 7 + c * 13 + h * 5 + w * 3) % 11);
+          self_data
+              [n * self.strides()[0] + c * self.strides()[1] +
+               h * self.strides()[2] + w * self.strides()[3]] = val;
+          self_cl_data
+              [n * self_cl.strides()[0] + c * self_cl.strides()[1] +
+               h * self_cl.strides()[2] + w * self_cl.strides()[3]] = val;
+        }
+      }
+    }
+  }
+
+  std::array<int64_t, 2> kernel_size = {3, 3};
+  std::array<int64_t, 2> stride = {2, 2};
+  std::array<int64_t, 2> padding = {1, 1};
+  std::array<int64_t, 2> dilation = {1, 1};
+  executorch::aten::Tensor out = tfFloat.zeros(out_sizes);
+  executorch::aten::Tensor indices = tfLong.zeros(out_sizes);
+  executorch::aten::Tensor out_cl = tfFloat.zeros_channels_last(out_sizes);
+  executorch::aten::Tensor indices_cl = tfLong.zeros_channels_last(out_sizes);
+
+  op_max_pool2d_with_indices_out(
+      self, kernel_size, stride, padding, dilation, false, out, indices);
+  op_max_pool2d_with_indices_out(
+      self_cl,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      false,
+      out_cl,
+      indices_cl);
+
+  const auto out_data = out.const_data_ptr<float>();
+  const auto out_cl_data = out_cl.const_data_ptr<float>();
+  const auto indices_data = indices.const_data_ptr<int64_t>();
+  const auto indices_cl_data = indices_cl.const_data_ptr<int64_t>();
+  for (const auto n : c10::irange(out_sizes[0])) {
+    for (const auto c : c10::irange(out_sizes[1])) {
+      for (const auto h : c10::irange(out_sizes[2])) {
+        for (const auto w : c10::irange(out_sizes[3])) {
+          const auto i = n * out.strides()[0] + c * out.strides()[1] +
+              h * out.strides()[2] + w * out.strides()[3];
+          const auto i_cl = n * out_cl.strides()[0] +
+              c * out_cl.strides()[1] + h * out_cl.strides()[2] +
+              w * out_cl.strides()[3];
+          EXPECT_EQ(out_data[i], out_cl_data[i_cl]);
+          EXPECT_EQ(indices_data[i], indices_cl_data[i_cl]);
+        }
+      }
+    }
+  }
+}
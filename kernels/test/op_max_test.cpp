@@ -16,6 +16,7 @@
 #include <executorch/test/utils/DeathTest.h>
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -398,3 +399,72 @@ TEST_F(OpMaxOutTest, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST_F(OpMaxOutTest, LargeInput) {
+  // A contiguous dim split across tasks and a strided dim reduced for many
+  // outputs at once, with ties.
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Long> tf_long;
+  constexpr int64_t kOuter = 2;
+  constexpr int64_t kSize = 40000;
+  constexpr int64_t kInner = 3;
+  std::vector<int32_t> data(kOuter * kSize * kInner);
+  for (int64_t i = 0; i < static_cast<int64_t>(data.size()); ++i) {
+    data[i] = static_cast<int32_t>(i * 7919 % 10007);
+  }
+
+  for (const int64_t dim : {0, 1, 2}) {
+    const int64_t sizes[] = {kOuter, kSize, kInner};
+    int64_t outer = 1;
+    for (int64_t d = 0; d < dim; ++d) {
+      outer *= sizes[d];
+    }
+    const int64_t size = sizes[dim];
+    const int64_t inner = static_cast<int64_t>(data.size()) / outer / size;
+
+    std::vector<int32_t> expected_values;
+    std::vector<int64_t> expected_indices;
+    for (int64_t o = 0; o < outer; ++o) {
+      for (int64_t t = 0; t < inner; ++t) {
+        const int32_t* base = data.data() + o * size * inner + t;
+        int64_t best = 0;
+        for (int64_t j = 1; j < size; ++j) {
+          if (base[j * inner] > base[best * inner]) {
+            best = j;
+          }
+        }
+        expected_values.push_back(base[best * inner]);
+        expected_indices.push_back(best);
+      }
+    }
+
+    std::vector<int32_t> out_sizes;
+    for (int64_t d = 0; d < 3; ++d) {
+      if (d != dim) {
+        out_sizes.push_back(static_cast<int32_t>(sizes[d]));
+      }
+    }
+    Tensor in = tf_int.make({kOuter, kSize, kInner}, data);
+    Tensor max = tf_int.zeros(out_sizes);
+    Tensor max_indices = tf_long.zeros(out_sizes);
+    op_max_dim_max(in, dim, /*keepdim=*/false, max, max_indices);
+    EXPECT_TENSOR_EQ(max, tf_int.make(out_sizes, expected_values));
+    EXPECT_TENSOR_EQ(max_indices, tf_long.make(out_sizes, expected_indices));
+  }
+}
+
+TEST_F(OpMaxUnaryOutTest, LargeInput) {
+  TensorFactory<ScalarType::Float> tf;
+  std::vector<float> data(100000);
+  for (int64_t i = 0; i < static_cast<int64_t>(data.size()); ++i) {
+    data[i] = static_cast<float>(i * 7919 % 10007);
+  }
+  data[77777] = 20000;
+  Tensor out = tf.zeros({});
+  op_max_unary_out(tf.make({100000}, data), out);
+  EXPECT_TENSOR_EQ(out, tf.make({}, {20000}));
+
+  data[12345] = NAN;
+  op_max_unary_out(tf.make({100000}, data), out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({}, {NAN}));
+}
@@ -472,6 +472,17 @@ TEST_F(OpMulOutTest, BothScalarInputBroadcastTest) {
   test_both_scalar_input_broadcast<ScalarType::BFloat16>();
 }
 
+TEST_F(OpMulOutTest, OutAliasesSelf) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 3}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+  op_mul_out(x, tf.make({2, 3}, {2.0, 2.0, 2.0, 0.5, 0.5, 0.5}), x);
+  EXPECT_TENSOR_EQ(x, tf.make({2, 3}, {2.0, 4.0, 6.0, 2.0, 2.5, 3.0}));
+
+  // other broadcasts over the rows of self.
+  op_mul_out(x, tf.make({3}, {1.0, -1.0, 2.0}), x);
+  EXPECT_TENSOR_EQ(x, tf.make({2, 3}, {2.0, -4.0, 12.0, 2.0, -2.5, 6.0}));
+}
+
 TEST_F(OpMulOutTest, MismatchedOutputShapesDies) {
   if (SupportedFeatures::get()->is_aten) {
     GTEST_SKIP() << "ATen currently supports mismatched shapes";
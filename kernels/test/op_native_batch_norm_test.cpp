@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -17,6 +18,54 @@
 
 using namespace ::testing;
 
+namespace {
+
+// Sizes that give a channel count with a partial block of channels.
+const std::vector<int32_t> kChannelsLastSizes = {2, 70, 3, 5};
+
+/// Fills a 4-D tensor of any dim order with the same logical values.
+void fill_4d(executorch::aten::Tensor& t) {
+  float* const data = t.mutable_data_ptr<float>();
+  const auto strides = t.strides();
+  for (const auto n : c10::irange(t.size(0))) {
+    for (const auto c : c10::irange(t.size(1))) {
+      for (const auto h : c10::irange(t.size(2))) {
+        for (const auto w : c10::irange(t.size(3))) {
+          data
+              [n * strides[0] + c * strides[1] + h * strides[2] +
+               w * strides[3]] =
+                  static_cast<float>((n * 7 + c * 13 + h * 5 + w * 3) % 11) -
+              4.0f;
+        }
+      }
+    }
+  }
+}
+
+/// Expects two 4-D tensors of any dim order to hold close logical values.
+void expect_4d_close(
+    const executorch::aten::Tensor& a,
+    const executorch::aten::Tensor& b) {
+  const float* const a_data = a.const_data_ptr<float>();
+  const float* const b_data = b.const_data_ptr<float>();
+  const auto as = a.strides();
+  const auto bs = b.strides();
+  for (const auto n : c10::irange(a.size(0))) {
+    for (const auto c : c10::irange(a.size(1))) {
+      for (const auto h : c10::irange(a.size(2))) {
+        for (const auto w : c10::irange(a.size(3))) {
+          EXPECT_NEAR(
+              a_data[n * as[0] + c * as[1] + h * as[2] + w * as[3]],
+              b_data[n * bs[0] + c * bs[1] + h * bs[2] + w * bs[3]],
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
 class OpNativeBatchNormLegitNoTrainingOutTest : public OperatorTest {
  protected:
   ::std::tuple<
@@ -989,6 +1038,55 @@ TEST_F(
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
 
+TEST_F(
+    OpNativeBatchNormLegitNoTrainingOutTest,
+    ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tf;
+  const int32_t C = kChannelsLastSizes[1];
+  std::vector<float> mean_data(C);
+  std::vector<float> var_data(C);
+  std::vector<float> weight_data(C);
+  std::vector<float> bias_data(C);
+  for (const auto c : c10::irange(C)) {
+    mean_data[c] = 0.1f * (c % 7) - 0.3f;
+    var_data[c] = 0.5f + 0.05f * (c % 5);
+    weight_data[c] = 1.0f + 0.02f * c;
+    bias_data[c] = 0.01f * c - 0.2f;
+  }
+  executorch::aten::Tensor mean = tf.make({C}, mean_data);
+  executorch::aten::Tensor var = tf.make({C}, var_data);
+  executorch::aten::optional<executorch::aten::Tensor> weight =
+      tf.make({C}, weight_data);
+  executorch::aten::optional<executorch::aten::Tensor> bias =
+      tf.make({C}, bias_data);
+
+  executorch::aten::Tensor input = tf.zeros(kChannelsLastSizes);
+  executorch::aten::Tensor input_cl =
+      tf.zeros_channels_last(kChannelsLastSizes);
+  fill_4d(input);
+  fill_4d(input_cl);
+
+  executorch::aten::Tensor out = tf.zeros(kChannelsLastSizes);
+  executorch::aten::Tensor out_cl = tf.zeros_channels_last(kChannelsLastSizes);
+  executorch::aten::Tensor mean_out = tf.zeros({0});
+  executorch::aten::Tensor invstd_out = tf.zeros({0});
+  op_native_batch_norm_legit_no_training_out(
+      input, weight, bias, mean, var, 0.1, 1e-5, out, mean_out, invstd_out);
+  op_native_batch_norm_legit_no_training_out(
+      input_cl,
+      weight,
+      bias,
+      mean,
+      var,
+      0.1,
+      1e-5,
+      out_cl,
+      mean_out,
+      invstd_out);
+  expect_4d_close(out, out_cl);
+}
+
 TEST_F(OpNativeBatchNormLegitOutTest, SampleAtomicTest2D) {
   torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
       tfFloat;
@@ -1156,3 +1254,40 @@ TEST_F(OpNativeBatchNormLegitNoStatsOutTest, SampleAtomicTest4D) {
   EXPECT_TENSOR_CLOSE(out1, out1_expected);
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
+
+TEST_F(OpNativeBatchNormLegitNoStatsOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<executorch::aten::ScalarType::Float>
+      tf;
+  const int32_t C = kChannelsLastSizes[1];
+  executorch::aten::optional<executorch::aten::Tensor> weight =
+      tf.full({C}, 1.5);
+  executorch::aten::optional<executorch::aten::Tensor> bias = tf.full({C}, 0.5);
+
+  executorch::aten::Tensor input = tf.zeros(kChannelsLastSizes);
+  executorch::aten::Tensor input_cl =
+      tf.zeros_channels_last(kChannelsLastSizes);
+  fill_4d(input);
+  fill_4d(input_cl);
+
+  executorch::aten::Tensor out = tf.zeros(kChannelsLastSizes);
+  executorch::aten::Tensor out_cl = tf.zeros_channels_last(kChannelsLastSizes);
+  executorch::aten::Tensor mean_out = tf.zeros({C});
+  executorch::aten::Tensor mean_out_cl = tf.zeros({C});
+  executorch::aten::Tensor invstd_out = tf.zeros({C});
+  executorch::aten::Tensor invstd_out_cl = tf.zeros({C});
+  op_native_batch_norm_legit_no_stats_out(
+      input, weight, bias, true, 0.1, 1e-5, out, mean_out, invstd_out);
+  op_native_batch_norm_legit_no_stats_out(
+      input_cl,
+      weight,
+      bias,
+      true,
+      0.1,
+      1e-5,
+      out_cl,
+      mean_out_cl,
+      invstd_out_cl);
+  expect_4d_close(out, out_cl);
+  EXPECT_TENSOR_CLOSE(mean_out, mean_out_cl);
+  EXPECT_TENSOR_CLOSE(invstd_out, invstd_out_cl);
+}
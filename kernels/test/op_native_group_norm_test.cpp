@@ -14,6 +14,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::optional;
 using executorch::aten::ScalarType;
@@ -127,3 +130,57 @@ TEST(OpNativeGroupNormOutTest, SmokeTest) {
   EXPECT_TENSOR_CLOSE(out1, out1_expected);
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
+
+TEST(OpNativeGroupNormOutTest, LongGroupsMatchReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Groups long enough to be vectorized, with a tail, against a reference
+  // computed in double.
+  constexpr int64_t N = 3, C = 4, HxW = 67, G = 2;
+  constexpr int64_t D = C / G;
+  constexpr double eps = 1e-5;
+  std::vector<float> in_data(N * C * HxW);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    const int v = static_cast<int>(i * 37 % 101) - 50;
+    in_data[i] = static_cast<float>(v) / 8.0f + 2.0f;
+  }
+  const std::vector<float> w_data = {0.5f, -1.25f, 2.0f, 0.75f};
+  const std::vector<float> b_data = {1.0f, 0.0f, -3.5f, 0.25f};
+
+  std::vector<float> out_ref(in_data.size());
+  std::vector<float> mean_ref(N * G);
+  std::vector<float> rstd_ref(N * G);
+  for (int64_t i = 0; i < N * G; ++i) {
+    const float* x = in_data.data() + i * D * HxW;
+    double sum = 0;
+    for (int64_t j = 0; j < D * HxW; ++j) {
+      sum += x[j];
+    }
+    const double mean = sum / (D * HxW);
+    double sq = 0;
+    for (int64_t j = 0; j < D * HxW; ++j) {
+      sq += (x[j] - mean) * (x[j] - mean);
+    }
+    const double rstd = 1.0 / std::sqrt(sq / (D * HxW) + eps);
+    for (int64_t j = 0; j < D * HxW; ++j) {
+      const int64_t c = (i % G) * D + j / HxW;
+      out_ref[i * D * HxW + j] =
+          static_cast<float>((x[j] - mean) * rstd * w_data[c] + b_data[c]);
+    }
+    mean_ref[i] = static_cast<float>(mean);
+    rstd_ref[i] = static_cast<float>(rstd);
+  }
+
+  Tensor input = tf.make({N, C, HxW}, in_data);
+  optional<Tensor> weight = tf.make({C}, w_data);
+  optional<Tensor> bias = tf.make({C}, b_data);
+  Tensor out0 = tf.zeros({N, C, HxW});
+  Tensor out1 = tf.zeros({N, G});
+  Tensor out2 = tf.zeros({N, G});
+  op_native_group_norm_out(
+      input, weight, bias, N, C, HxW, G, eps, out0, out1, out2);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out0, tf.make({N, C, HxW}, out_ref), 1e-4, 1e-4);
+  EXPECT_TENSOR_CLOSE(out1, tf.make({N, G}, mean_ref));
+  EXPECT_TENSOR_CLOSE(out2, tf.make({N, G}, rstd_ref));
+}
@@ -13,6 +13,8 @@
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
@@ -47,6 +49,32 @@ TEST_F(OpNonzeroTest, AllDtypesSupported) {
 #undef TEST_ENTRY
 }
 
+TEST_F(OpNonzeroTest, LargeInput) {
+  TensorFactory<ScalarType::Float> tf_input;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Enough elements for several blocks of the optimized kernel.
+  const std::vector<int32_t> sizes = {3, 200, 123};
+  std::vector<float> data;
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < sizes[0]; ++i) {
+    for (int64_t j = 0; j < sizes[1]; ++j) {
+      for (int64_t k = 0; k < sizes[2]; ++k) {
+        const bool nonzero = (i + j * 7 + k * 3) % 5 == 0;
+        data.push_back(nonzero ? 1.5f : 0.0f);
+        if (nonzero) {
+          expected.insert(expected.end(), {i, j, k});
+        }
+      }
+    }
+  }
+  const int32_t num_nonzero = expected.size() / 3;
+
+  Tensor out = tf_long.zeros({num_nonzero, 3});
+  op_nonzero_out(tf_input.make(sizes, data), out);
+  EXPECT_TENSOR_EQ(out, tf_long.make({num_nonzero, 3}, expected));
+}
+
 #if !defined(USE_ATEN_LIB)
 TEST_F(OpNonzeroTest, StaticShapeInconsistentSize) {
   TensorFactory<ScalarType::Float> tf_input;
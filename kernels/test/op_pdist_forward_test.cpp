@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::ScalarType;
@@ -23,7 +27,8 @@ using executorch::aten::Tensor;
 using torch::executor::testing::TensorFactory;
 
 Tensor& op_pdist_forward_out(const Tensor& input, double p, Tensor& out) {
-  executorch::runtime::KernelRuntimeContext context{};
+  TempMemoryAllocator temp_allocator;
+  executorch::runtime::KernelRuntimeContext context(nullptr, &temp_allocator);
   return torch::executor::aten::_pdist_forward_outf(context, input, p, out);
 }
 
@@ -105,3 +110,45 @@ TEST_F(OpPdistForwardOutTest, SmokeTest) {
   ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY)
 #undef TEST_ENTRY
 }
+
+TEST_F(OpPdistForwardOutTest, LargeInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Enough rows to be split into blocks and tiles, and for p = 2 to use the
+  // matrix multiplication.
+  const int64_t n = 100;
+  const int64_t m = 37;
+  std::vector<float> in_data(n * m);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>((i * 7 + 3) % 11) - 5;
+  }
+  // Two identical rows, whose distance must be exactly 0.
+  std::copy(in_data.begin(), in_data.begin() + m, in_data.begin() + 57 * m);
+  Tensor in = tf.make({100, 37}, in_data);
+
+  for (const double p : {0.0, 1.0, 1.5, 2.0, 3.0, double(INFINITY)}) {
+    std::vector<float> expected;
+    for (int64_t i = 0; i < n; ++i) {
+      for (int64_t j = i + 1; j < n; ++j) {
+        double agg = 0;
+        for (int64_t k = 0; k < m; ++k) {
+          const double diff = std::abs(in_data[i * m + k] - in_data[j * m + k]);
+          if (p == 0.0) {
+            agg += diff != 0;
+          } else if (p == INFINITY) {
+            agg = std::max(agg, diff);
+          } else {
+            agg += std::pow(diff, p);
+          }
+        }
+        expected.push_back(static_cast<float>(
+            p == 0.0 || p == INFINITY ? agg : std::pow(agg, 1.0 / p)));
+      }
+    }
+
+    Tensor out = tf.zeros({4950});
+    op_pdist_forward_out(in, p, out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.make({4950}, expected), 1e-5, 1e-4);
+  }
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -28,6 +29,49 @@ class OpPermuteCopyTest : public OperatorTest {
   op_permute_copy_out(const Tensor& self, IntArrayRef dims, Tensor& out) {
     return torch::executor::aten::permute_copy_outf(context_, self, dims, out);
   }
+
+  // Permutes a 4-D tensor that is large enough to be copied in tiles, and
+  // checks it against a copy computed one coordinate at a time.
+  template <ScalarType DTYPE>
+  void test_large_permute(const std::vector<int64_t>& dims) {
+    TensorFactory<DTYPE> tf;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    const std::vector<int32_t> sizes = {2, 5, 19, 23};
+    const int64_t in_strides[4] = {5 * 19 * 23, 19 * 23, 23, 1};
+    std::vector<CTYPE> in_data(2 * 5 * 19 * 23);
+    for (const auto i : c10::irange(in_data.size())) {
+      in_data[i] = static_cast<CTYPE>(i % 101);
+    }
+    Tensor in = tf.make(sizes, in_data);
+
+    std::vector<int32_t> out_sizes(4);
+    for (const auto k : c10::irange(4)) {
+      out_sizes[k] = sizes[dims[k]];
+    }
+    // Walk the output in order, tracking the matching input coordinate.
+    std::vector<CTYPE> expected_data;
+    int64_t c[4];
+    for (c[0] = 0; c[0] < out_sizes[0]; ++c[0]) {
+      for (c[1] = 0; c[1] < out_sizes[1]; ++c[1]) {
+        for (c[2] = 0; c[2] < out_sizes[2]; ++c[2]) {
+          for (c[3] = 0; c[3] < out_sizes[3]; ++c[3]) {
+            int64_t in_index = 0;
+            for (const auto k : c10::irange(4)) {
+              in_index += c[k] * in_strides[dims[k]];
+            }
+            expected_data.push_back(in_data[in_index]);
+          }
+        }
+      }
+    }
+
+    Tensor out = tf.zeros(out_sizes);
+    Tensor ret = op_permute_copy_out(
+        in, ArrayRef<int64_t>(dims.data(), dims.size()), out);
+    EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected_data));
+    EXPECT_TENSOR_EQ(ret, out);
+  }
 };
 
 TEST_F(OpPermuteCopyTest, OneDPermute) {
@@ -221,6 +265,16 @@ TEST_F(OpPermuteCopyTest, FourDPermute) {
   // clang-format on
 }
 
+TEST_F(OpPermuteCopyTest, LargePermute) {
+#define TEST_ENTRY(ctype, dtype)                       \
+  test_large_permute<ScalarType::dtype>({0, 2, 3, 1}); \
+  test_large_permute<ScalarType::dtype>({0, 3, 1, 2}); \
+  test_large_permute<ScalarType::dtype>({3, 1, 2, 0}); \
+  test_large_permute<ScalarType::dtype>({1, 0, 2, 3});
+  ET_FORALL_REALHBF16_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
 TEST_F(OpPermuteCopyTest, FiveDPermute) {
   TensorFactory<ScalarType::Int> tf;
 
@@ -314,3 +314,12 @@ TEST_F(OpReluTest, DynamicShapeUnbound) {
   Tensor ret = op_relu_out(x, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpReluTest, OutAliasesSelf) {
+  // relu is registered as in-place safe, so memory planning may pass the
+  // same tensor as self and out.
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 3}, {-1.5, 2.0, 0.0, -0.5, 3.5, -4.0});
+  op_relu_out(x, x);
+  EXPECT_TENSOR_EQ(x, tf.make({2, 3}, {0.0, 2.0, 0.0, 0.0, 3.5, 0.0}));
+}
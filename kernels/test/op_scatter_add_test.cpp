@@ -402,3 +402,44 @@ TEST_F(OpScatterAddOutTest, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST_F(OpScatterAddOutTest, LargeInput) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  // Large enough to be split into several tasks, with index smaller than
+  // self along the other dims, and every element it reaches receiving
+  // several additions.
+  const std::vector<int32_t> self_sizes = {6, 20, 600};
+  const int64_t self_strides[] = {20 * 600, 600, 1};
+
+  for (int64_t dim = 0; dim < 3; ++dim) {
+    std::vector<int32_t> index_sizes = {5, 19, 500};
+    index_sizes[dim] = self_sizes[dim] * 3;
+    const int64_t numel = index_sizes[0] * index_sizes[1] * index_sizes[2];
+
+    std::vector<int64_t> index_data(numel);
+    std::vector<float> src_data(numel);
+    std::vector<float> expected(6 * 20 * 600, 1.0f);
+    for (int64_t i = 0; i < numel; ++i) {
+      src_data[i] = static_cast<float>(i % 13);
+      index_data[i] = (i * 7 + i / 5) % self_sizes[dim];
+      const int64_t coord[] = {
+          i / (index_sizes[1] * index_sizes[2]),
+          i / index_sizes[2] % index_sizes[1],
+          i % index_sizes[2]};
+      int64_t out_ix = 0;
+      for (int64_t d = 0; d < 3; ++d) {
+        out_ix += (d == dim ? index_data[i] : coord[d]) * self_strides[d];
+      }
+      expected[out_ix] += src_data[i];
+    }
+
+    Tensor self = tf_data.ones(self_sizes);
+    Tensor index = tf_index.make(index_sizes, index_data);
+    Tensor src = tf_data.make(index_sizes, src_data);
+    Tensor out = tf_data.zeros(self_sizes);
+    op_scatter_add_out(self, dim, index, src, out);
+    EXPECT_TENSOR_CLOSE(out, tf_data.make(self_sizes, expected));
+  }
+}
@@ -652,3 +652,65 @@ TEST_F(OpScatterSrcOutTest, InvalidOneDimInputAndZeroDimIndex) {
   ET_EXPECT_KERNEL_FAILURE(
       context_, op_scatter_src_out(self, 0, index, src, out));
 }
+
+TEST_F(OpScatterSrcOutTest, LargeInput) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Int> tf_data;
+
+  // Large enough to be split into several tasks. Index values repeat along
+  // `dim`, and the last of them must win, as it does serially.
+  const std::vector<int32_t> self_sizes = {6, 20, 600};
+  const int64_t self_strides[] = {20 * 600, 600, 1};
+
+  for (int64_t dim = 0; dim < 3; ++dim) {
+    std::vector<int32_t> index_sizes = {5, 19, 500};
+    index_sizes[dim] = self_sizes[dim] * 2;
+    const int64_t numel = index_sizes[0] * index_sizes[1] * index_sizes[2];
+
+    std::vector<int64_t> index_data(numel);
+    std::vector<int32_t> src_data(numel);
+    std::vector<int32_t> expected(6 * 20 * 600, -1);
+    for (int64_t i = 0; i < numel; ++i) {
+      src_data[i] = static_cast<int32_t>(i);
+      index_data[i] = (i * 7 + i / 5) % self_sizes[dim];
+      const int64_t coord[] = {
+          i / (index_sizes[1] * index_sizes[2]),
+          i / index_sizes[2] % index_sizes[1],
+          i % index_sizes[2]};
+      int64_t out_ix = 0;
+      for (int64_t d = 0; d < 3; ++d) {
+        out_ix += (d == dim ? index_data[i] : coord[d]) * self_strides[d];
+      }
+      expected[out_ix] = src_data[i];
+    }
+
+    Tensor self = tf_data.full(self_sizes, -1);
+    Tensor index = tf_index.make(index_sizes, index_data);
+    Tensor src = tf_data.make(index_sizes, src_data);
+    Tensor out = tf_data.zeros(self_sizes);
+    op_scatter_src_out(self, dim, index, src, out);
+    EXPECT_TENSOR_EQ(out, tf_data.make(self_sizes, expected));
+  }
+}
+
+TEST_F(OpScatterValueOutTest, LargeInput) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  const std::vector<int32_t> self_sizes = {4, 300, 100};
+  const std::vector<int32_t> index_sizes = {4, 50, 100};
+  const int64_t numel = 4 * 50 * 100;
+
+  std::vector<int64_t> index_data(numel);
+  std::vector<float> expected(4 * 300 * 100, 0.0f);
+  for (int64_t i = 0; i < numel; ++i) {
+    index_data[i] = (i * 11) % 300;
+    expected[i / 5000 * 30000 + index_data[i] * 100 + i % 100] = 2.5f;
+  }
+
+  Tensor self = tf_data.zeros(self_sizes);
+  Tensor index = tf_index.make(index_sizes, index_data);
+  Tensor out = tf_data.ones(self_sizes);
+  op_scatter_value_out(self, 1, index, 2.5, out);
+  EXPECT_TENSOR_EQ(out, tf_data.make(self_sizes, expected));
+}
@@ -16,12 +16,63 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
 using torch::executor::testing::TensorFactory;
 
+namespace {
+
+// Softmax in double over dim of the contiguous tensor with the given sizes.
+std::vector<float> reference_softmax(
+    const std::vector<float>& data,
+    const std::vector<int32_t>& sizes,
+    size_t dim) {
+  size_t outer_size = 1;
+  size_t inner_size = 1;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (i < dim) {
+      outer_size *= sizes[i];
+    } else if (i > dim) {
+      inner_size *= sizes[i];
+    }
+  }
+  const size_t dim_size = sizes[dim];
+  std::vector<float> out(data.size());
+  for (size_t outer = 0; outer < outer_size; ++outer) {
+    for (size_t inner = 0; inner < inner_size; ++inner) {
+      const size_t base = outer * dim_size * inner_size + inner;
+      double max_in = data[base];
+      for (size_t d = 0; d < dim_size; ++d) {
+        max_in = std::max<double>(max_in, data[base + d * inner_size]);
+      }
+      double sum = 0;
+      for (size_t d = 0; d < dim_size; ++d) {
+        sum += std::exp(data[base + d * inner_size] - max_in);
+      }
+      for (size_t d = 0; d < dim_size; ++d) {
+        out[base + d * inner_size] =
+            std::exp(data[base + d * inner_size] - max_in) / sum;
+      }
+    }
+  }
+  return out;
+}
+
+std::vector<float> softmax_test_data(size_t size) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = 4.0f * std::sin(0.61f * i);
+  }
+  return data;
+}
+
+} // namespace
+
 class OpSoftmaxOutTest : public OperatorTest {
  protected:
   Tensor& op_softmax_out(
@@ -71,6 +122,34 @@ class OpSoftmaxOutTest : public OperatorTest {
       EXPECT_TENSOR_CLOSE(out, expected);
     }
   }
+
+  // Compares softmax along each dim of an input that is large enough to be
+  // vectorized, and whose dims aren't multiples of the vector width, against
+  // a reference.
+  template <class CTYPE, executorch::aten::ScalarType DTYPE>
+  void test_large_input_along_each_dim() {
+    TensorFactory<DTYPE> tf;
+    const std::vector<int32_t> sizes = {3, 37, 19};
+    // Round the data to CTYPE first so that the reference sees the same
+    // values as the kernel.
+    auto data = softmax_test_data(3 * 37 * 19);
+    for (auto& v : data) {
+      v = static_cast<float>(static_cast<CTYPE>(v));
+    }
+    const Tensor in = tf.make(sizes, {data.begin(), data.end()});
+    for (size_t dim = 0; dim < sizes.size(); ++dim) {
+      const auto expected_data = reference_softmax(data, sizes, dim);
+      const Tensor expected =
+          tf.make(sizes, {expected_data.begin(), expected_data.end()});
+      Tensor out = tf.zeros(sizes);
+      op_softmax_out(in, dim, /*half_to_float=*/false, out);
+      if (DTYPE == ScalarType::Float || DTYPE == ScalarType::Double) {
+        EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-7);
+      } else {
+        EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-2, 1e-3);
+      }
+    }
+  }
 };
 
 TEST_F(OpSoftmaxOutTest, Smoke) {
@@ -116,6 +195,39 @@ TEST_F(OpSoftmaxOutTest, AllDtypesSupported) {
   // for those types.
 }
 
+TEST_F(OpSoftmaxOutTest, LargeInputAlongEachDim) {
+#define TEST_ENTRY(ctype, dtype) \
+  test_large_input_along_each_dim<ctype, ScalarType::dtype>();
+  ET_FORALL_FLOATHBF16_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpSoftmaxOutTest, FewLongRows) {
+  TensorFactory<ScalarType::Float> tf;
+  // Long enough that each row may be split between threads.
+  const std::vector<int32_t> sizes = {2, 70001};
+  const auto data = softmax_test_data(2 * 70001);
+  const auto expected_data = reference_softmax(data, sizes, 1);
+  Tensor out = tf.zeros(sizes);
+  op_softmax_out(tf.make(sizes, data), 1, /*half_to_float=*/false, out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out, tf.make(sizes, expected_data), 1e-5, 1e-9);
+}
+
+TEST_F(OpSoftmaxOutTest, ChannelsLast) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int32_t> sizes = {2, 11, 3, 5};
+  const auto data = softmax_test_data(2 * 11 * 3 * 5);
+  const Tensor in = tf.channels_last_like(tf.make(sizes, data));
+  for (size_t dim = 0; dim < sizes.size(); ++dim) {
+    const Tensor expected = tf.channels_last_like(
+        tf.make(sizes, reference_softmax(data, sizes, dim)));
+    Tensor out = tf.zeros_channels_last(sizes);
+    op_softmax_out(in, dim, /*half_to_float=*/false, out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-7);
+  }
+}
+
 TEST_F(OpSoftmaxOutTest, MismatchedDimensionsDies) {
   TensorFactory<ScalarType::Float> tff;
 
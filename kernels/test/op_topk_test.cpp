@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -16,87 +17,16 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::IntArrayRef;
 using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
-using executorch::runtime::MemoryAllocator;
 using torch::executor::testing::TensorFactory;
 
-class TempMemoryAllocator final : public MemoryAllocator {
- private:
-  // We allocate a little more than requested and use that memory as a node in
-  // a linked list, pushing the allocated buffers onto a list that's iterated
-  // and freed when the KernelRuntimeContext is destroyed.
-  struct AllocationNode {
-    void* data;
-    AllocationNode* next;
-  };
-
-  AllocationNode* head_ = nullptr;
-
- public:
-  TempMemoryAllocator() : MemoryAllocator(0, nullptr) {}
-
-  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
-    if (!isPowerOf2(alignment)) {
-      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
-      return nullptr;
-    }
-
-    // Allocate enough memory for the node, the data and the alignment bump.
-    size_t alloc_size = sizeof(AllocationNode) + size + alignment;
-    void* node_memory = malloc(alloc_size);
-
-    // If allocation failed, log message and return nullptr.
-    if (node_memory == nullptr) {
-      ET_LOG(Error, "Failed to allocate %zu bytes", alloc_size);
-      return nullptr;
-    }
-
-    // Compute data pointer.
-    uint8_t* data_ptr =
-        reinterpret_cast<uint8_t*>(node_memory) + sizeof(AllocationNode);
-
-    // Align the data pointer.
-    void* aligned_data_ptr = alignPointer(data_ptr, alignment);
-
-    // Assert that the alignment didn't overflow the allocated memory.
-    ET_DCHECK_MSG(
-        reinterpret_cast<uintptr_t>(aligned_data_ptr) + size <=
-            reinterpret_cast<uintptr_t>(node_memory) + alloc_size,
-        "aligned_data_ptr %p + size %zu > node_memory %p + alloc_size %zu",
-        aligned_data_ptr,
-        size,
-        node_memory,
-        alloc_size);
-
-    // Construct the node.
-    AllocationNode* new_node = reinterpret_cast<AllocationNode*>(node_memory);
-    new_node->data = aligned_data_ptr;
-    new_node->next = head_;
-    head_ = new_node;
-
-    // Return the aligned data pointer.
-    return head_->data;
-  }
-
-  void reset() override {
-    AllocationNode* current = head_;
-    while (current != nullptr) {
-      AllocationNode* next = current->next;
-      free(current);
-      current = next;
-    }
-    head_ = nullptr;
-  }
-
-  ~TempMemoryAllocator() override {
-    reset();
-  }
-};
-
 std::tuple<Tensor&, Tensor&> op_topk_values(
     const Tensor& input,
     int64_t k,
@@ -173,3 +103,76 @@ TEST_F(OpTopkValuesTest, NonPartialSort) {
     EXPECT_TENSOR_EQ(indices, indices_expected);
   }
 }
+
+TEST_F(OpTopkValuesTest, LongRowsSmallK) {
+  TensorFactory<ScalarType::Float> tfFloat;
+  TensorFactory<ScalarType::Long> tfLong;
+
+  // Distinct values, in a scrambled order, with a NaN in each row.
+  constexpr int kRows = 3;
+  constexpr int kSize = 1000;
+  constexpr int kK = 5;
+  std::vector<float> data(kRows * kSize);
+  for (const auto row : c10::irange(kRows)) {
+    for (const auto i : c10::irange(kSize)) {
+      data[row * kSize + i] = static_cast<float>((i * 37 + row) % kSize);
+    }
+    data[row * kSize + 100 * row + 7] = NAN;
+  }
+
+  for (const bool largest : {true, false}) {
+    std::vector<float> values_data;
+    std::vector<int64_t> indices_data;
+    for (const auto row : c10::irange(kRows)) {
+      std::vector<std::pair<float, int64_t>> elems;
+      for (const auto i : c10::irange(kSize)) {
+        elems.emplace_back(data[row * kSize + i], i);
+      }
+      // NaN is the largest value.
+      std::partial_sort(
+          elems.begin(),
+          elems.begin() + kK,
+          elems.end(),
+          [largest](const auto& x, const auto& y) {
+            if (std::isnan(x.first) || std::isnan(y.first)) {
+              return std::isnan(largest ? x.first : y.first) &&
+                  !std::isnan(largest ? y.first : x.first);
+            }
+            return largest ? x.first > y.first : x.first < y.first;
+          });
+      for (const auto i : c10::irange(kK)) {
+        values_data.push_back(elems[i].first);
+        indices_data.push_back(elems[i].second);
+      }
+    }
+
+    // Along the contiguous last dim, then along a strided dim.
+    Tensor input = tfFloat.make({kRows, kSize}, data);
+    Tensor values = tfFloat.zeros({kRows, kK});
+    Tensor indices = tfLong.zeros({kRows, kK});
+    op_topk_values(input, kK, 1, largest, true, values, indices);
+    EXPECT_TENSOR_CLOSE(values, tfFloat.make({kRows, kK}, values_data));
+    EXPECT_TENSOR_EQ(indices, tfLong.make({kRows, kK}, indices_data));
+
+    std::vector<float> data_t(data.size());
+    for (const auto row : c10::irange(kRows)) {
+      for (const auto i : c10::irange(kSize)) {
+        data_t[i * kRows + row] = data[row * kSize + i];
+      }
+    }
+    std::vector<float> values_data_t(values_data.size());
+    std::vector<int64_t> indices_data_t(indices_data.size());
+    for (const auto row : c10::irange(kRows)) {
+      for (const auto i : c10::irange(kK)) {
+        values_data_t[i * kRows + row] = values_data[row * kK + i];
+        indices_data_t[i * kRows + row] = indices_data[row * kK + i];
+      }
+    }
+    Tensor input_t = tfFloat.make({kSize, kRows}, data_t);
+    Tensor values_t = tfFloat.zeros({kK, kRows});
+    Tensor indices_t = tfLong.zeros({kK, kRows});
+    op_topk_values(input_t, kK, 0, largest, true, values_t, indices_t);
+    EXPECT_TENSOR_CLOSE(values_t, tfFloat.make({kK, kRows}, values_data_t));
+    EXPECT_TENSOR_EQ(indices_t, tfLong.make({kK, kRows}, indices_data_t));
+  }
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -15,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <utility>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::ScalarType;
@@ -31,6 +34,44 @@ class OpTransposeIntCopyTest : public OperatorTest {
     return torch::executor::aten::transpose_copy_outf(
         context_, self, dim0, dim1, out);
   }
+
+  // Transposes a 3-D tensor that spans several tiles of a blocked transpose,
+  // with partial tiles at the edges, and checks it element by element.
+  template <ScalarType DTYPE>
+  void test_large_transpose(int64_t dim0, int64_t dim1) {
+    TensorFactory<DTYPE> tf;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    const std::vector<int32_t> sizes = {3, 37, 45};
+    std::vector<CTYPE> in_data(3 * 37 * 45);
+    for (const auto i : c10::irange(in_data.size())) {
+      in_data[i] = static_cast<CTYPE>(i % 101);
+    }
+    Tensor in = tf.make(sizes, in_data);
+
+    std::vector<int32_t> out_sizes = sizes;
+    std::swap(out_sizes[dim0], out_sizes[dim1]);
+    std::vector<CTYPE> expected_data(in_data.size());
+    int64_t coord[3];
+    for (coord[0] = 0; coord[0] < sizes[0]; ++coord[0]) {
+      for (coord[1] = 0; coord[1] < sizes[1]; ++coord[1]) {
+        for (coord[2] = 0; coord[2] < sizes[2]; ++coord[2]) {
+          int64_t out_coord[3] = {coord[0], coord[1], coord[2]};
+          std::swap(out_coord[dim0], out_coord[dim1]);
+          const int64_t out_index =
+              (out_coord[0] * out_sizes[1] + out_coord[1]) * out_sizes[2] +
+              out_coord[2];
+          expected_data[out_index] =
+              in_data[(coord[0] * sizes[1] + coord[1]) * sizes[2] + coord[2]];
+        }
+      }
+    }
+
+    Tensor out = tf.zeros(out_sizes);
+    Tensor ret = op_transpose_copy_int_out(in, dim0, dim1, out);
+    EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected_data));
+    EXPECT_TENSOR_EQ(ret, out);
+  }
 };
 
 TEST_F(OpTransposeIntCopyTest, TwoDTranspose) {
@@ -146,6 +187,15 @@ TEST_F(OpTransposeIntCopyTest, ThreeDTranspose) {
   // clang-format on
 }
 
+TEST_F(OpTransposeIntCopyTest, LargeTranspose) {
+#define TEST_ENTRY(ctype, dtype)                \
+  test_large_transpose<ScalarType::dtype>(1, 2); \
+  test_large_transpose<ScalarType::dtype>(0, 2); \
+  test_large_transpose<ScalarType::dtype>(0, 1);
+  ET_FORALL_REALHBF16_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
 // transpose an out of bounds dim
 TEST_F(OpTransposeIntCopyTest, OutOfBoundDimDies) {
   TensorFactory<ScalarType::Float> tf;
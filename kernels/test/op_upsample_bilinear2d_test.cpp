@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/kernels/test/supported_features.h>
@@ -725,3 +726,69 @@ TEST_F(OpUpsampleBilinear2dTest, NumericsCheckAlignCornersChannelsLast) {
     EXPECT_FLOAT_EQ(expected, actual);
   }
 }
+
+TEST_F(OpUpsampleBilinear2dTest, ChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Enough channels and columns for both vectorized loops and their tails,
+  // and a fractional scale so that rows don't map evenly onto input rows.
+  const std::vector<int32_t> in_sizes = {2, 19, 7, 13};
+  const std::vector<int32_t> out_sizes = {2, 19, 17, 30};
+  std::array<int64_t, 2> output_size = {17, 30};
+  const auto input = tf.zeros(in_sizes);
+  const auto input_cl = tf.zeros_channels_last(in_sizes);
+  auto out = tf.zeros(out_sizes);
+  auto out_cl = tf.zeros_channels_last(out_sizes);
+
+  auto input_data = input.mutable_data_ptr<float>();
+  auto input_cl_data = input_cl.mutable_data_ptr<float>();
+  for (const auto n : c10::irange(in_sizes[0])) {
+    for (const auto c : c10::irange(in_sizes[1])) {
+      for (const auto h : c10::irange(in_sizes[2])) {
+        for (const auto w : c10::irange(in_sizes[3])) {
+          const float val =
+              static_cast<float>((n * 31 + c * 7 + h * 3 + w) % 50);
+          input_data
+              [n * input.strides()[0] + c * input.strides()[1] +
+               h * input.strides()[2] + w * input.strides()[3]] = val;
+          input_cl_data
+              [n * input_cl.strides()[0] + c * input_cl.strides()[1] +
+               h * input_cl.strides()[2] + w * input_cl.strides()[3]] = val;
+        }
+      }
+    }
+  }
+
+  for (const bool align_corners : {false, true}) {
+    op_upsample_bilinear2d_vec_out(
+        input,
+        OptionalArrayRef<int64_t>({output_size.data(), output_size.size()}),
+        align_corners,
+        {},
+        out);
+    op_upsample_bilinear2d_vec_out(
+        input_cl,
+        OptionalArrayRef<int64_t>({output_size.data(), output_size.size()}),
+        align_corners,
+        {},
+        out_cl);
+
+    const auto out_data = out.const_data_ptr<float>();
+    const auto out_cl_data = out_cl.const_data_ptr<float>();
+    for (const auto n : c10::irange(out_sizes[0])) {
+      for (const auto c : c10::irange(out_sizes[1])) {
+        for (const auto h : c10::irange(out_sizes[2])) {
+          for (const auto w : c10::irange(out_sizes[3])) {
+            EXPECT_FLOAT_EQ(
+                out_data
+                    [n * out.strides()[0] + c * out.strides()[1] +
+                     h * out.strides()[2] + w * out.strides()[3]],
+                out_cl_data
+                    [n * out_cl.strides()[0] + c * out_cl.strides()[1] +
+                     h * out_cl.strides()[2] + w * out_cl.strides()[3]]);
+          }
+        }
+      }
+    }
+  }
+}
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <c10/util/irange.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 #include <executorch/kernels/test/supported_features.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -445,3 +446,75 @@ TEST_F(OpUpsampleNearest2dTest, SmokeTestChannelsLast) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST_F(OpUpsampleNearest2dTest, ChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Fractional scales, upsampling the rows and downsampling the columns.
+  const std::vector<int32_t> in_sizes = {2, 5, 7, 13};
+  const std::vector<int32_t> out_sizes = {2, 5, 17, 9};
+  std::array<int64_t, 2> output_size = {17, 9};
+  const auto input = tf.zeros(in_sizes);
+  const auto input_cl = tf.zeros_channels_last(in_sizes);
+  auto out = tf.zeros(out_sizes);
+  auto out_cl = tf.zeros_channels_last(out_sizes);
+
+  auto input_data = input.mutable_data_ptr<float>();
+  auto input_cl_data = input_cl.mutable_data_ptr<float>();
+  for (const auto n : c10::irange(in_sizes[0])) {
+    for (const auto c : c10::irange(in_sizes[1])) {
+      for (const auto h : c10::irange(in_sizes[2])) {
+        for (const auto w : c10::irange(in_sizes[3])) {
+          const float val = static_cast<float>(
+              n * 1000 + c * 100 + h * 10 + w);
+          input_data
+              [n * input.strides()[0] + c * input.strides()[1] +
+               h * input.strides()[2] + w * input.strides()[3]] = val;
+          input_cl_data
+              [n * input_cl.strides()[0] + c * input_cl.strides()[1] +
+               h * input_cl.strides()[2] + w * input_cl.strides()[3]] = val;
+        }
+      }
+    }
+  }
+
+  op_upsample_nearest2d_out(
+      input,
+      OptionalArrayRef<int64_t>({output_size.data(), output_size.size()}),
+      {},
+      out);
+  op_upsample_nearest2d_out(
+      input_cl,
+      OptionalArrayRef<int64_t>({output_size.data(), output_size.size()}),
+      {},
+      out_cl);
+
+  const auto out_data = out.const_data_ptr<float>();
+  const auto out_cl_data = out_cl.const_data_ptr<float>();
+  for (const auto n : c10::irange(out_sizes[0])) {
+    for (const auto c : c10::irange(out_sizes[1])) {
+      for (const auto h : c10::irange(out_sizes[2])) {
+        for (const auto w : c10::irange(out_sizes[3])) {
+          // The source pixel of each output pixel, as the portable kernel
+          // computes it.
+          const int64_t in_h = std::min<int64_t>(
+              static_cast<int64_t>(floorf(h * (7.0f / 17))), 6);
+          const int64_t in_w = std::min<int64_t>(
+              static_cast<int64_t>(floorf(w * (13.0f / 9))), 12);
+          const float expected =
+              static_cast<float>(n * 1000 + c * 100 + in_h * 10 + in_w);
+          EXPECT_EQ(
+              out_data
+                  [n * out.strides()[0] + c * out.strides()[1] +
+                   h * out.strides()[2] + w * out.strides()[3]],
+              expected);
+          EXPECT_EQ(
+              out_cl_data
+                  [n * out_cl.strides()[0] + c * out_cl.strides()[1] +
+                   h * out_cl.strides()[2] + w * out_cl.strides()[3]],
+              expected);
+        }
+      }
+    }
+  }
+}
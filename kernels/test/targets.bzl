@@ -174,7 +174,7 @@ def define_common_targets():
     codegen_function_header_wrapper("executorch/kernels/quantized", "quantized")
     codegen_function_header_wrapper("executorch/kernels/test/custom_kernel_example", "custom_kernel_example")
 
-    _common_op_test("op__to_dim_order_copy_test", ["aten", "portable"])
+    _common_op_test("op__to_dim_order_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op__empty_dim_order_test", ["aten", "portable"])
     _common_op_test("op_abs_test", ["aten", "portable"])
     _common_op_test("op_acos_test", ["aten", "portable"])
@@ -186,43 +186,45 @@ def define_common_targets():
     _common_op_test("op_amin_test", ["aten", "portable"])
     _common_op_test("op_any_test", ["aten", "portable"])
     _common_op_test("op_arange_test", ["aten", "portable"])
-    _common_op_test("op_argmax_test", ["aten", "portable"])
-    _common_op_test("op_argmin_test", ["aten", "portable"])
+    _common_op_test("op_argmax_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_argmin_test", ["aten", "portable", "optimized"])
     _common_op_test("op_as_strided_copy_test", ["aten", "portable"])
     _common_op_test("op_asin_test", ["aten", "portable"])
     _common_op_test("op_asinh_test", ["aten", "portable"])
     _common_op_test("op_atan_test", ["aten", "portable"])
     _common_op_test("op_atan2_test", ["aten", "portable"])
     _common_op_test("op_atanh_test", ["aten", "portable"])
-    _common_op_test("op_avg_pool2d_test", ["aten", "portable"])
+    _common_op_test("op_avg_pool2d_test", ["aten", "portable", "optimized"])
     _common_op_test("op_bitwise_and_test", ["aten", "portable"])
     _common_op_test("op_bitwise_not_test", ["aten", "portable"])
     _common_op_test("op_bitwise_or_test", ["aten", "portable"])
     _common_op_test("op_bitwise_xor_test", ["aten", "portable"])
     _common_op_test("op_bmm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_cat_test", ["aten", "portable"])
-    _common_op_test("op_cdist_forward_test", ["aten", "portable"])
+    _common_op_test("op_cdist_forward_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ceil_test", ["aten", "portable"])
     _common_op_test("op_clamp_test", ["aten", "portable"])
     _common_op_test("op_clone_test", ["aten", "portable"])
     _common_op_test("op_constant_pad_nd_test", ["aten", "portable"])
-    _common_op_test("op_convolution_test", ["aten", "portable"])
-    _common_op_test("op_convolution_backward_test", ["aten", "portable"])
+    _common_op_test("op_convolution_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_convolution_backward_test", ["aten", "portable", "optimized"])
     _common_op_test("op_copy_test", ["aten", "portable"])
     _common_op_test("op_cos_test", ["aten", "portable"])
     _common_op_test("op_cosh_test", ["aten", "portable"])
-    _common_op_test("op_cumsum_test", ["aten", "portable"])
+    _common_op_test("op_cumsum_test", ["aten", "portable", "optimized"])
     _common_op_test("op_detach_copy_test", ["aten", "portable"])
     _common_op_test("op_diagonal_copy_test", ["aten", "portable"])
     _common_op_test("op_div_test", ["aten", "portable", "optimized"])
     _common_op_test("op_elu_test", ["aten", "portable"])
-    _common_op_test("op_embedding_test", ["aten", "portable"])
+    _common_op_test("op_embedding_test", ["aten", "portable", "optimized"])
     _common_op_test("op_empty_test", ["aten", "portable"])
     _common_op_test("op_eq_test", ["aten", "portable"])
-    _common_op_test("op_erf_test", ["aten", "portable"])
+    _common_op_test("op_erf_test", ["aten", "portable", "optimized"])
     _common_op_test("op_exp_test", ["aten", "portable", "optimized"])
     _common_op_test("op_expand_copy_test", ["aten", "portable"])
-    _common_op_test("op_expm1_test", ["aten", "portable"])
+    _common_op_test("op_expm1_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_fft_c2c_test", ["aten", "optimized"])
+    _common_op_test("op_fft_c2r_test", ["aten", "optimized"])
     _common_op_test("op_fft_r2c_test", ["aten", "optimized"])
     _common_op_test("op_fill_test", ["aten", "portable"])
     _common_op_test("op_flip_test", ["aten", "portable"])
@@ -231,14 +233,14 @@ def define_common_targets():
     _common_op_test("op_fmod_test", ["aten", "portable"])
     _common_op_test("op_full_like_test", ["aten", "portable"])
     _common_op_test("op_full_test", ["aten", "portable"])
-    _common_op_test("op_gather_test", ["aten", "portable"])
+    _common_op_test("op_gather_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ge_test", ["aten", "portable"])
     _common_op_test("op_gelu_test", ["aten", "portable", "optimized"])
     _common_op_test("op_glu_test", ["aten", "portable"])
     _common_op_test("op_gt_test", ["aten", "portable"])
     _common_op_test("op_hardtanh_test", ["aten", "portable"])
-    _common_op_test("op_index_put_test", ["aten", "portable"])
-    _common_op_test("op_index_select_test", ["aten", "portable"])
+    _common_op_test("op_index_put_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_index_select_test", ["aten", "portable", "optimized"])
     _common_op_test("op_index_test", ["aten", "portable"])
     _common_op_test("op_isinf_test", ["aten", "portable"])
     _common_op_test("op_isnan_test", ["aten", "portable"])
@@ -247,9 +249,9 @@ def define_common_targets():
     _common_op_test("op_lift_fresh_copy_test", ["aten", "portable"])
     _common_op_test("op_linear_test", ["aten", "optimized"])
     _common_op_test("op_log_softmax_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_log_test", ["aten", "portable"])
+    _common_op_test("op_log_test", ["aten", "portable", "optimized"])
     _common_op_test("op_log10_test", ["aten", "portable"])
-    _common_op_test("op_log1p_test", ["aten", "portable"])
+    _common_op_test("op_log1p_test", ["aten", "portable", "optimized"])
     _common_op_test("op_log2_test", ["aten", "portable"])
     _common_op_test("op_logical_and_test", ["aten", "portable"])
     _common_op_test("op_logical_not_test", ["aten", "portable"])
@@ -258,27 +260,27 @@ def define_common_targets():
     _common_op_test("op_logit_test", ["aten", "portable"])
     _common_op_test("op_lt_test", ["aten", "portable"])
     _common_op_test("op_masked_fill_test", ["aten", "portable"])
-    _common_op_test("op_masked_scatter_test", ["aten", "portable"])
-    _common_op_test("op_masked_select_test", ["aten", "portable"])
-    _common_op_test("op_max_test", ["aten", "portable"])
-    _common_op_test("op_max_pool2d_with_indices_test", ["aten", "portable"])
-    _common_op_test("op_max_pool2d_with_indices_backward_test", ["aten", "portable"])
+    _common_op_test("op_masked_scatter_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_masked_select_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_max_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_max_pool2d_with_indices_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_max_pool2d_with_indices_backward_test", ["aten", "portable", "optimized"])
     _common_op_test("op_maximum_test", ["aten", "portable"])
     _common_op_test("op_mean_test", ["aten", "portable"])
-    _common_op_test("op_min_test", ["aten", "portable"])
+    _common_op_test("op_min_test", ["aten", "portable", "optimized"])
     _common_op_test("op_minimum_test", ["aten", "portable"])
     _common_op_test("op_mm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_mul_test", ["aten", "portable", "optimized"])
     _common_op_test("op_narrow_copy_test", ["aten", "portable"])
-    _common_op_test("op_native_batch_norm_test", ["aten", "portable"])
-    _common_op_test("op_native_group_norm_test", ["aten", "portable"])
+    _common_op_test("op_native_batch_norm_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_native_group_norm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_native_layer_norm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ne_test", ["aten", "portable"])
     _common_op_test("op_neg_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_nonzero_test", ["aten", "portable"])
+    _common_op_test("op_nonzero_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ones_test", ["aten", "portable"])
-    _common_op_test("op_pdist_forward_test", ["aten", "portable"])
-    _common_op_test("op_permute_copy_test", ["aten", "portable"])
+    _common_op_test("op_pdist_forward_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_permute_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_pixel_shuffle_test", ["aten", "portable"])
     _common_op_test("op_pixel_unshuffle_test", ["aten", "portable"])
     _common_op_test("op_pow_test", ["aten", "portable"])
@@ -299,8 +301,8 @@ def define_common_targets():
     _common_op_test("op_rsqrt_test", ["aten", "portable"])
     _common_op_test("op_rsub_test", ["aten", "portable"])
     _common_op_test("op_scalar_tensor_test", ["aten", "portable"])
-    _common_op_test("op_scatter_test", ["aten", "portable"])
-    _common_op_test("op_scatter_add_test", ["aten", "portable"])
+    _common_op_test("op_scatter_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_scatter_add_test", ["aten", "portable", "optimized"])
     _common_op_test("op_select_scatter_test", ["aten", "portable"])
     _common_op_test("op_select_copy_test", ["aten", "portable"])
     _common_op_test("op_sigmoid_test", ["aten", "portable", "optimized"])
@@ -309,7 +311,7 @@ def define_common_targets():
     _common_op_test("op_sinh_test", ["aten", "portable"])
     _common_op_test("op_slice_scatter_test", ["aten", "portable"])
     _common_op_test("op_slice_copy_test", ["aten", "portable"])
-    _common_op_test("op_softmax_test", ["aten", "portable"])
+    _common_op_test("op_softmax_test", ["aten", "portable", "optimized"])
     _common_op_test("op_split_copy_test", ["aten", "portable"])
     _common_op_test("op_split_with_sizes_copy_test", ["aten", "portable"])
     _common_op_test("op_sqrt_test", ["aten", "portable"])
@@ -319,17 +321,17 @@ def define_common_targets():
     _common_op_test("op_sum_test", ["aten", "portable"])
     _common_op_test("op_t_copy_test", ["aten", "portable"])
     _common_op_test("op_tan_test", ["aten", "portable"])
-    _common_op_test("op_tanh_test", ["aten", "portable"])
+    _common_op_test("op_tanh_test", ["aten", "portable", "optimized"])
     _common_op_test("op_to_copy_test", ["aten", "portable"])
-    _common_op_test("op_topk_test", ["aten", "portable"])
-    _common_op_test("op_transpose_copy_test", ["aten", "portable"])
+    _common_op_test("op_topk_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_transpose_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_tril_test", ["aten", "portable"])
     _common_op_test("op_trunc_test", ["aten", "portable"])
     _common_op_test("op_unbind_copy_test", ["aten", "portable"])
     _common_op_test("op_unfold_copy_test", ["aten", "portable"])
     _common_op_test("op_unsqueeze_copy_test", ["aten", "portable"])
-    _common_op_test("op_upsample_bilinear2d_test", ["aten", "portable"])
-    _common_op_test("op_upsample_nearest2d_test", ["aten", "portable"])
+    _common_op_test("op_upsample_bilinear2d_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_upsample_nearest2d_test", ["aten", "portable", "optimized"])
     _common_op_test("op_var_test", ["aten", "portable"])
     _common_op_test("op_view_copy_test", ["aten", "portable"])
     _common_op_test("op_where_test", ["aten", "portable"])
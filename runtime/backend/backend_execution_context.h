@@ -8,12 +8,52 @@
 
 #pragma once
 
+#include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/span.h>
 
 namespace executorch {
 namespace runtime {
 
+/**
+ * Signals the end of delegate work that BackendInterface::execute_async()
+ * left running. Owned by the backend, typically as part of its handle.
+ */
+class BackendCompletion {
+ public:
+  virtual ~BackendCompletion() = default;
+
+  /**
+   * Blocks until the delegate has written all of its outputs, and returns the
+   * status of the execution. Called exactly once per execute_async() call that
+   * set this completion.
+   */
+  ET_NODISCARD virtual Error wait() = 0;
+};
+
+/**
+ * The data of a tensor that a delegate left in device memory instead of
+ * writing it to the tensor's CPU memory. Owned by the backend.
+ */
+class DeviceBuffer {
+ public:
+  virtual ~DeviceBuffer() = default;
+
+  /**
+   * Copies the data to `host_data`, the CPU memory of the tensor. Called when
+   * the runtime needs the tensor on the CPU.
+   */
+  ET_NODISCARD virtual Error copy_to_host(void* host_data, size_t nbytes) = 0;
+
+  /**
+   * Called once the runtime no longer refers to the buffer: after copying it
+   * to the host, after the tensor is overwritten on the device, or when
+   * execution of the method ends.
+   */
+  virtual void release() {}
+};
+
 /**
  * BackendExecutionContext will be used to inject run time context.
  */
@@ -22,10 +62,12 @@ class BackendExecutionContext final {
   BackendExecutionContext(
       EventTracer* event_tracer = nullptr,
       MemoryAllocator* temp_allocator = nullptr,
-      const char* method_name = nullptr)
+      const char* method_name = nullptr,
+      Span<DeviceBuffer*> device_buffers = {})
       : event_tracer_(event_tracer),
         temp_allocator_(temp_allocator),
-        method_name_(method_name) {}
+        method_name_(method_name),
+        device_buffers_(device_buffers) {}
 
   /**
    * Returns a pointer to an instance of EventTracer to do profiling/debugging
@@ -62,10 +104,59 @@ class BackendExecutionContext final {
     return method_name_;
   }
 
+  /**
+   * Called by BackendInterface::execute_async() to signal that the delegate is
+   * still running when it returns, and that `completion` must be waited on
+   * before its outputs are used.
+   */
+  void set_completion(BackendCompletion* completion) {
+    completion_ = completion;
+  }
+
+  /**
+   * Returns the completion set by the backend, or nullptr if the delegate
+   * finished before returning.
+   */
+  BackendCompletion* get_completion() const {
+    return completion_;
+  }
+
+  /**
+   * Returns the device data of the tensor `args[arg_index]`, if an earlier
+   * call to this backend left it on the device with set_device_buffer(). Its
+   * CPU memory is stale in that case; a backend that wants to read it from
+   * there must call copy_to_host() first. Returns nullptr if the CPU memory
+   * is up to date.
+   */
+  DeviceBuffer* get_device_buffer(size_t arg_index) const {
+    return arg_index < device_buffers_.size() ? device_buffers_[arg_index]
+                                              : nullptr;
+  }
+
+  /**
+   * Tells the runtime that the output tensor `args[arg_index]` was only
+   * written to `buffer`, so that a later call to this backend can read it
+   * from the device. The runtime copies it to the CPU memory of the tensor
+   * before anything else uses that memory. Passing nullptr means that the CPU
+   * memory is up to date again. `args[arg_index]` must be a tensor.
+   *
+   * @returns false if the runtime cannot track device data for this call, in
+   *     which case the backend must write the output to its CPU memory.
+   */
+  bool set_device_buffer(size_t arg_index, DeviceBuffer* buffer) {
+    if (arg_index >= device_buffers_.size()) {
+      return false;
+    }
+    device_buffers_[arg_index] = buffer;
+    return true;
+  }
+
  private:
   EventTracer* event_tracer_ = nullptr;
   MemoryAllocator* temp_allocator_ = nullptr;
   const char* method_name_ = nullptr;
+  BackendCompletion* completion_ = nullptr;
+  Span<DeviceBuffer*> device_buffers_;
 };
 
 } // namespace runtime
@@ -75,6 +166,8 @@ namespace torch {
 namespace executor {
 // TODO(T197294990): Remove these deprecated aliases once all users have moved
 // to the new `::executorch` namespaces.
+using ::executorch::runtime::BackendCompletion;
 using ::executorch::runtime::BackendExecutionContext;
+using ::executorch::runtime::DeviceBuffer;
 } // namespace executor
 } // namespace torch
@@ -84,6 +84,16 @@ class BackendInterface {
       FreeableBuffer* processed,
       ArrayRef<CompileSpec> compile_specs) const = 0;
 
+  /**
+   * Returns true if init() may be called from several threads at once, for
+   * different delegates of this backend and concurrently with the init() of
+   * other backends. Such delegates are initialized in parallel when
+   * `Program::load_method()` is given a ParallelTaskRunner.
+   */
+  virtual bool is_init_thread_safe() const {
+    return false;
+  }
+
   /**
    * Responsible for executing the given method’s handle, as it was produced
    * by compile.
@@ -99,6 +109,30 @@ class BackendInterface {
       DelegateHandle* handle,
       EValue** args) const = 0;
 
+  /**
+   * Like execute(), but may return while the delegate is still running, so
+   * that the runtime can execute instructions that don't depend on it in the
+   * meantime. To do so, call `context.set_completion()` before returning Ok;
+   * the runtime calls the completion's wait() before any later instruction
+   * touches the memory of `args`, before `handle` is executed again, and
+   * before the method finishes executing. The delegate must not use memory
+   * from the context's temp allocator after returning.
+   *
+   * Backends that do not override this execute synchronously.
+   *
+   * @param[in] context The execution context, which receives the completion.
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @param[in] args The method’s inputs and outputs.
+   * @retval Error::Ok if the execution was started or finished successfully.
+   *     Errors that happen later are returned by the completion's wait().
+   */
+  ET_NODISCARD virtual Error execute_async(
+      BackendExecutionContext& context,
+      DelegateHandle* handle,
+      EValue** args) const {
+    return execute(context, handle, args);
+  }
+
   /**
    * Responsible for destroying a handle, if it's required for some backend.
    * It may be needed for some backends. For example, resources associated with
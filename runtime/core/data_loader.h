@@ -123,6 +123,61 @@ class DataLoader {
     return Error::NotImplemented;
   }
 
+  /**
+   * Hints that a range of the underlying data source will be loaded soon, so
+   * that the implementation can start reading it in the background. Must not
+   * wait for the data to be read; a later load() or load_into() of the range
+   * waits for any outstanding reads instead.
+   *
+   * NOTE: This must be thread-safe. If this call modifies common state, the
+   * implementation must do its own locking.
+   *
+   * @param offset The byte offset in the data source of the range.
+   * @param size The number of bytes in the range.
+   * @param segment_info Information about the segment that will be loaded.
+   *
+   * @returns Error::Ok if the hint was accepted or ignored, or an error if the
+   *     range is invalid.
+   */
+  ET_NODISCARD virtual Error prefetch(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const {
+    // Prefetching is optional, so loaders that don't support it can ignore the
+    // hint.
+    (void)offset;
+    (void)size;
+    (void)segment_info;
+    return Error::Ok;
+  }
+
+  /**
+   * Hints that a range of a buffer returned by load() will not be read for a
+   * while, although the buffer itself stays alive, so that the implementation
+   * can release the memory behind it. The range must stay readable, for
+   * example by reading it from the data source again when it is touched.
+   *
+   * NOTE: This must be thread-safe. If this call modifies common state, the
+   * implementation must do its own locking.
+   *
+   * @param buffer A buffer returned by load() of this DataLoader that has not
+   *     been freed.
+   * @param offset The byte offset in `buffer` of the range.
+   * @param size The number of bytes in the range.
+   *
+   * @returns Error::Ok if the hint was accepted or ignored, or an error if the
+   *     range is invalid.
+   */
+  ET_NODISCARD virtual Error
+  release(const FreeableBuffer& buffer, size_t offset, size_t size) const {
+    // Releasing is optional, so loaders that don't support it can ignore the
+    // hint.
+    (void)buffer;
+    (void)offset;
+    (void)size;
+    return Error::Ok;
+  }
+
   /**
    * Returns the length of the underlying data source, typically the file size.
    */
@@ -14,6 +14,11 @@ template <>
 executorch::aten::ArrayRef<executorch::aten::optional<executorch::aten::Tensor>>
 BoxedEvalueList<executorch::aten::optional<executorch::aten::Tensor>>::get()
     const {
+  if (cache_ && unwrapped_) {
+    return executorch::aten::ArrayRef<
+        executorch::aten::optional<executorch::aten::Tensor>>{
+        unwrapped_vals_, wrapped_vals_.size()};
+  }
   for (typename executorch::aten::ArrayRef<
            executorch::aten::optional<executorch::aten::Tensor>>::size_type i =
            0;
@@ -27,6 +32,7 @@ BoxedEvalueList<executorch::aten::optional<executorch::aten::Tensor>>::get()
               ->to<executorch::aten::optional<executorch::aten::Tensor>>();
     }
   }
+  unwrapped_ = true;
   return executorch::aten::ArrayRef<
       executorch::aten::optional<executorch::aten::Tensor>>{
       unwrapped_vals_, wrapped_vals_.size()};
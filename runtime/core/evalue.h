@@ -11,6 +11,8 @@
 #include <executorch/runtime/core/tag.h>
 #include <executorch/runtime/platform/assert.h>
 
+#include <type_traits>
+
 namespace executorch {
 namespace runtime {
 
@@ -69,11 +71,39 @@ class BoxedEvalueList {
    */
   executorch::aten::ArrayRef<T> get() const;
 
+  /*
+   * Makes the next get() construct the list again. Needed after one of the
+   * EValues that the list points to is replaced with another Tensor.
+   */
+  void invalidate() {
+    unwrapped_ = false;
+  }
+
+  /*
+   * Makes every get() construct the list. Needed when the EValues that the
+   * list points to can be replaced at any point of an execution, as MoveCall
+   * instructions do.
+   */
+  void disable_cache() {
+    cache_ = false;
+    unwrapped_ = false;
+  }
+
  private:
+  // Ops like sym_size replace the ints of int lists on every execution, but
+  // the Tensors of most tensor lists are only updated in place, so tensor
+  // lists are constructed once instead of on every get() unless
+  // disable_cache() is called.
+  static constexpr bool kCacheUnwrapped = !std::is_same_v<T, int64_t>;
+
   // Source of truth for the list
   executorch::aten::ArrayRef<EValue*> wrapped_vals_;
   // Same size as wrapped_vals
   mutable T* unwrapped_vals_;
+  // Whether get() may return unwrapped_vals_ without constructing it again.
+  bool cache_ = kCacheUnwrapped;
+  // Whether unwrapped_vals_ holds the list, if cache_.
+  mutable bool unwrapped_ = false;
 };
 
 template <>
@@ -541,11 +571,14 @@ EVALUE_DEFINE_TO(
 
 template <typename T>
 executorch::aten::ArrayRef<T> BoxedEvalueList<T>::get() const {
-  for (typename executorch::aten::ArrayRef<T>::size_type i = 0;
-       i < wrapped_vals_.size();
-       i++) {
-    ET_CHECK(wrapped_vals_[i] != nullptr);
-    unwrapped_vals_[i] = wrapped_vals_[i]->template to<T>();
+  if (!cache_ || !unwrapped_) {
+    for (typename executorch::aten::ArrayRef<T>::size_type i = 0;
+         i < wrapped_vals_.size();
+         i++) {
+      ET_CHECK(wrapped_vals_[i] != nullptr);
+      unwrapped_vals_[i] = wrapped_vals_[i]->template to<T>();
+    }
+    unwrapped_ = true;
   }
   return executorch::aten::ArrayRef<T>{unwrapped_vals_, wrapped_vals_.size()};
 }
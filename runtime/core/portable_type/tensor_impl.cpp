@@ -117,6 +117,11 @@ Error TensorImpl::internal_resize_contiguous(ArrayRef<SizesType> new_sizes) {
       // TODO(T175194371): Unbounded dynamic tensor resizing is not yet
       // supported: treat them as upper-bounded.
     case TensorShapeDynamism::DYNAMIC_UNBOUND: {
+      // Kernels resize their outputs on every call, usually to the size they
+      // already have; skip recomputing numel and strides in that case.
+      if (std::equal(sizes_, sizes_ + dim_, new_sizes.begin())) {
+        return Error::Ok;
+      }
       const auto new_numel = compute_numel(new_sizes.data(), dim_);
 
       ET_CHECK_OR_RETURN_ERROR(
@@ -212,6 +212,53 @@ TEST_F(EValueTest, BoxedEvalueList) {
   EXPECT_EQ(unwrapped[2], 3);
 }
 
+TEST_F(EValueTest, BoxedEvalueListRereadsInts) {
+  EValue values[2] = {EValue((int64_t)1), EValue((int64_t)2)};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  int64_t storage[2] = {0, 0};
+  BoxedEvalueList<int64_t> x{values_p, storage, 2};
+  EXPECT_EQ(x.get()[1], 2);
+
+  // Ints are replaced by ops like sym_size, so they are read on every get().
+  values[1] = EValue((int64_t)5);
+  EXPECT_EQ(x.get()[1], 5);
+}
+
+TEST_F(EValueTest, BoxedEvalueListCachesTensors) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue values[2] = {EValue(tf.ones({2})), EValue(tf.zeros({3}))};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  executorch::aten::Tensor storage[2] = {tf.zeros({1}), tf.zeros({1})};
+  BoxedEvalueList<executorch::aten::Tensor> x{values_p, storage, 2};
+  auto unwrapped = x.get();
+  EXPECT_EQ(unwrapped[0].numel(), 2);
+  EXPECT_EQ(unwrapped[1].numel(), 3);
+
+  // The list is only constructed again once invalidated.
+  values[1] = EValue(tf.zeros({4}));
+  EXPECT_EQ(x.get()[1].numel(), 3);
+  x.invalidate();
+  EXPECT_EQ(x.get()[1].numel(), 4);
+}
+
+TEST_F(EValueTest, BoxedEvalueListWithoutCache) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue values[2] = {EValue(tf.ones({2})), EValue(tf.zeros({3}))};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  executorch::aten::optional<executorch::aten::Tensor> storage[2];
+  BoxedEvalueList<executorch::aten::optional<executorch::aten::Tensor>> x{
+      values_p, storage, 2};
+  EXPECT_EQ(x.get()[1]->numel(), 3);
+
+  // Like the target of a MoveCall, the value is replaced without invalidating
+  // the list.
+  x.disable_cache();
+  values[1] = EValue(tf.zeros({4}));
+  EXPECT_EQ(x.get()[1]->numel(), 4);
+  values[1] = EValue();
+  EXPECT_FALSE(x.get()[1].has_value());
+}
+
 TEST_F(EValueTest, toOptionalTensorList) {
   // create list, empty evalue ctor gets tag::None
   EValue values[2] = {EValue(), EValue()};
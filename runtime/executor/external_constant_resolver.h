@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: Provides the data of external constants right before the
+ * instructions that read them execute.
+ *
+ * By default a Method loads all of its external constants at init time and
+ * keeps them resident. Clients whose weights do not fit in memory can instead
+ * page them in on demand: see `Method::set_external_constant_resolver()`, and
+ * `executorch::extension::LayerStreamingDataMap` for an implementation that
+ * keeps a sliding window of layers resident.
+ */
+class ExternalConstantResolver {
+ public:
+  virtual ~ExternalConstantResolver() = default;
+
+  /**
+   * Called before instruction `instruction_index` of chain `chain_index`
+   * executes, once for every external constant that the instruction reads.
+   * Instructions are announced in execution order, so implementations can use
+   * the sequence of calls to predict which constants are needed next.
+   *
+   * @param[in] key The fully qualified name of the constant.
+   * @param[in] chain_index The chain of the instruction.
+   * @param[in] instruction_index The index of the instruction in its chain.
+   *
+   * @returns A pointer to the data of the constant, with the size and layout
+   *     that the NamedDataMap of the Method reports for `key`. The data must
+   *     stay valid until the instruction returns.
+   */
+  virtual Result<const void*> resolve(
+      const char* key,
+      size_t chain_index,
+      size_t instruction_index) = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -9,10 +9,12 @@
 #include <executorch/runtime/executor/method.h>
 
 #include <c10/util/irange.h>
+#include <algorithm>
 #include <array>
 #include <cinttypes> // @donotremove
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
@@ -28,6 +30,7 @@
 #include <executorch/runtime/platform/assert.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/profiler.h>
 #include <executorch/schema/program_generated.h>
 
@@ -62,6 +65,32 @@ class BackendDelegate final {
       const Program* program,
       BackendInitContext& backend_init_context,
       BackendDelegate* out) {
+    Error err = Prepare(
+        delegate, program, backend_init_context.get_runtime_allocator(), out);
+    if (err != Error::Ok) {
+      return err;
+    }
+    return out->InitBackend(backend_init_context, delegate.id()->c_str());
+  }
+
+  /**
+   * The first half of Init(): looks up the backend and loads the processed
+   * data and compile specs of an already-allocated BackendDelegate, without
+   * calling the backend's init(). Every successful call must be followed by
+   * either InitBackend() or Discard().
+   *
+   * @param[in] delegate The serialized backend delegate to load.
+   * @param[in] program The serialized program to load from.
+   * @param[in] allocator The allocator to allocate the compile specs from.
+   * @param[out] out The BackendDelegate to prepare.
+   *
+   * @returns Error::Ok if the preparation succeeded, or an error otherwise.
+   */
+  static Error Prepare(
+      const executorch_flatbuffer::BackendDelegate& delegate,
+      const Program* program,
+      MemoryAllocator* allocator,
+      BackendDelegate* out) {
     // Look up the backend.
     ET_CHECK_OR_RETURN_ERROR(
         delegate.id() != nullptr, InvalidProgram, "Missing backend id");
@@ -88,7 +117,7 @@ class BackendDelegate final {
     // Parse compilation specs from program
     CompileSpec* compile_specs;
     Error err = PopulateCompileSpecs(
-        delegate.compile_specs(), backend_init_context, &compile_specs);
+        delegate.compile_specs(), allocator, &compile_specs);
     if (err != Error::Ok) {
       ET_LOG(Error, "Failed to get compile specs for backend %s", backend_id);
       return err;
@@ -97,28 +126,50 @@ class BackendDelegate final {
 
     out->backend_ = backend;
     out->handle_ = nullptr;
+    out->compile_specs_ =
+        ArrayRef<CompileSpec>(compile_specs, num_compile_specs);
     // Pass a pointer to this buffer to the backend. It's safe for the backend
     // to point its handle to this object, since it will outlive the backend.
     new (&out->segment_) FreeableBuffer(std::move(processed_data.get()));
+    return Error::Ok;
+  }
 
-    // Initialize the delegate.
-    Result<DelegateHandle*> handle = backend->init(
-        backend_init_context,
-        &out->segment_,
-        ArrayRef<CompileSpec>(compile_specs, num_compile_specs));
+  /**
+   * The second half of Init(): calls the backend's init() on a BackendDelegate
+   * set up by Prepare(). Only touches this BackendDelegate, so different
+   * delegates may be initialized concurrently if their backends allow it.
+   *
+   * @param[in] backend_init_context The context pointer to pass to the
+   *     backend's init() method.
+   * @param[in] backend_id The name of the backend, for logging.
+   *
+   * @returns Error::Ok if the initialization succeeded, or an error otherwise,
+   *     in which case the processed data has been freed.
+   */
+  Error InitBackend(
+      BackendInitContext& backend_init_context,
+      const char* backend_id) {
+    Result<DelegateHandle*> handle =
+        backend_->init(backend_init_context, &segment_, compile_specs_);
     if (!handle.ok()) {
       ET_LOG(
           Error,
           "Init failed for backend %s: 0x%" PRIx32,
           backend_id,
           static_cast<uint32_t>(handle.error()));
-      out->segment_.Free();
+      segment_.Free();
       return handle.error();
     }
-    out->handle_ = handle.get();
+    handle_ = handle.get();
     return Error::Ok;
   }
 
+  /// Frees the processed data of a BackendDelegate that was prepared but
+  /// whose backend was never initialized. It must not be destroyed after.
+  void Discard() {
+    segment_.Free();
+  }
+
   ~BackendDelegate() {
     if (backend_ != nullptr) {
       backend_->destroy(handle_);
@@ -132,6 +183,17 @@ class BackendDelegate final {
     return backend_->execute(backend_execution_context, handle_, args);
   }
 
+  const BackendInterface* backend() const {
+    return backend_;
+  }
+
+  Error ExecuteAsync(
+      BackendExecutionContext& backend_execution_context,
+      EValue** args) const {
+    EXECUTORCH_SCOPE_PROF("delegate_execute_async");
+    return backend_->execute_async(backend_execution_context, handle_, args);
+  }
+
  private:
   // Not constructible.
   BackendDelegate() = delete;
@@ -145,13 +207,12 @@ class BackendDelegate final {
   static Error PopulateCompileSpecs(
       const flatbuffers::Vector<flatbuffers::Offset<
           executorch_flatbuffer::CompileSpec>>* compile_specs_in_program,
-      BackendInitContext& backend_init_context,
+      MemoryAllocator* allocator,
       CompileSpec** out_spec) {
     auto number_of_compile_specs = compile_specs_in_program->size();
 
     CompileSpec* compile_specs_list =
-        backend_init_context.get_runtime_allocator()->allocateList<CompileSpec>(
-            number_of_compile_specs);
+        allocator->allocateList<CompileSpec>(number_of_compile_specs);
     if (compile_specs_list == nullptr) {
       return Error::MemoryAllocationFailed;
     }
@@ -172,6 +233,13 @@ class BackendDelegate final {
     return Error::Ok;
   }
 
+  /// FreeableBuffer::FreeFn for delegate data inside the program data.
+  static void ReleaseProgramData(void* context, void* data, size_t size) {
+    // Only a hint, which loaders may ignore, so errors don't matter.
+    (void)static_cast<const Program*>(context)->release_program_data(
+        data, size);
+  }
+
   static Result<FreeableBuffer> GetProcessedData(
       const executorch_flatbuffer::BackendDelegate& delegate,
       const Program* program) {
@@ -186,10 +254,13 @@ class BackendDelegate final {
         if (err != Error::Ok) {
           return err;
         }
+        // The data is part of the program data, which stays loaded. When the
+        // backend frees it, let the loader release the memory behind it.
         return FreeableBuffer(
             data,
             size,
-            /*free_fn=*/nullptr);
+            ReleaseProgramData,
+            /*free_fn_context=*/const_cast<Program*>(program));
       }
       case executorch_flatbuffer::DataLocation::SEGMENT: {
         const char* backend_id = delegate.id()->c_str();
@@ -210,19 +281,89 @@ class BackendDelegate final {
   FreeableBuffer segment_;
   const BackendInterface* backend_;
   DelegateHandle* handle_;
+  ArrayRef<CompileSpec> compile_specs_;
+};
+
+/**
+ * An instruction decoded from its serialized form during Method::init(). All
+ * indices have been validated and turned into pointers, so executing an
+ * instruction doesn't need to touch the flatbuffer.
+ */
+struct Instruction {
+  enum class Type : uint8_t {
+    KernelCall,
+    DelegateCall,
+    JumpFalseCall,
+    MoveCall,
+    FreeCall,
+    /// An instruction type that this runtime doesn't know how to execute.
+    /// Fails when executed, not at init time.
+    Unknown,
+  };
+
+  struct JumpFalse {
+    /// The value to test.
+    const EValue* cond_value;
+    /// The instruction to jump to if the condition is false.
+    size_t destination_instruction;
+  };
+
+  struct Move {
+    const EValue* from;
+    EValue* to;
+  };
+
+  /// Arguments for a kernel or delegate call. Empty for other types.
+  InstructionArgs args;
+
+  /// Type-specific state, selected by `type`.
+  union {
+    /// KernelCall: the resolved kernel.
+    OpFunction kernel;
+    /// DelegateCall: the initialized delegate to execute.
+    const BackendDelegate* delegate;
+    /// JumpFalseCall
+    JumpFalse jump_false;
+    /// MoveCall
+    Move move;
+    /// FreeCall: the tensor value whose data pointer should be reset.
+    EValue* free_value;
+  };
+
+  Type type;
 };
 
 /**
  * Runtime state for a chain of instructions.
  */
 struct Chain {
-  /// Pointer to the associated flatbuffer chain.
+  /// Pointer to the associated flatbuffer chain. Only used for logging; the
+  /// information needed to execute is in `instructions_`.
   const executorch_flatbuffer::Chain* s_chain_;
 
-  /// Each entry is a list of parameters for a kernel or delegate call.
-  Span<InstructionArgs> argument_lists_;
-  /// Each instruction will have one kernel (not for delegate).
-  OpFunction* kernels_;
+  /// The decoded instructions of the chain, in execution order.
+  Span<Instruction> instructions_;
+
+  /// Only set when parallel execution has been enabled. For an instruction
+  /// index that starts a wave of independent instructions, the exclusive end
+  /// index of that wave. Entries for other indices are not meaningful.
+  uint32_t* wave_ends_;
+
+  /// Only set when an external constant resolver has been set. The exclusive
+  /// end index in `constant_uses_` of the constants that each instruction
+  /// reads; the constants of instruction `i` start at the end of instruction
+  /// `i - 1`.
+  uint32_t* constant_use_ends_;
+
+  /// The value indices of the external constants that the instructions read,
+  /// in instruction order.
+  uint32_t* constant_uses_;
+
+  /// Only set when a kernel of the chain has scratch memory, planned ahead of
+  /// time or declared by the kernel (see `Kernel::scratch_size_`). For each
+  /// instruction, the memory that KernelRuntimeContext::allocate_temp() hands
+  /// out first, empty for instructions without scratch memory.
+  Span<uint8_t>* scratch_;
 };
 
 namespace {
@@ -289,6 +430,283 @@ Result<bool> parse_cond_value(const EValue& cond_value) {
   return true;
 }
 
+/// The maximum number of instructions that execute concurrently as one wave.
+constexpr size_t kMaxWaveSize = 16;
+
+/// The alignment of the buffer that holds the scratch memory which kernels
+/// declare, the same as that of memory-planned tensors.
+constexpr size_t kKernelScratchAlignment = 16;
+
+/// A range of memory [begin, end) that an instruction reads or writes.
+struct AccessRange {
+  uintptr_t begin;
+  uintptr_t end;
+  bool write;
+};
+
+/// All of the memory that a single instruction touches.
+struct InstructionAccess {
+  const AccessRange* ranges;
+  size_t size;
+};
+
+/// Returns the number of AccessRanges that append_access_ranges() will produce
+/// for `value`.
+size_t num_access_ranges(const EValue& value) {
+  if (value.isTensorList()) {
+    return 1 + value.toTensorList().size();
+  }
+  if (value.isListOptionalTensor()) {
+    return 1 + value.toListOptionalTensor().size();
+  }
+  return 1;
+}
+
+using SerializedValues =
+    flatbuffers::Vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>;
+
+/// Returns the number of bytes that the planner reserved for `s_tensor`, which
+/// holds every shape the tensor can be resized to, or 0 if the tensor is not
+/// memory-planned.
+size_t planned_capacity(const executorch_flatbuffer::Tensor* s_tensor) {
+  if (s_tensor == nullptr || s_tensor->allocation_info() == nullptr) {
+    return 0;
+  }
+  // Use the full namespace to disambiguate from c10::elementSize.
+  size_t nbytes = executorch::runtime::elementSize(
+      static_cast<executorch::aten::ScalarType>(s_tensor->scalar_type()));
+  if (s_tensor->sizes() != nullptr) {
+    for (const auto size : *s_tensor->sizes()) {
+      nbytes *= static_cast<size_t>(size);
+    }
+  }
+  return nbytes;
+}
+
+/// Returns planned_capacity() of the tensor at `value_idx` of `s_values`, or 0
+/// if there is no such tensor.
+size_t planned_capacity(const SerializedValues* s_values, int64_t value_idx) {
+  if (value_idx < 0 || static_cast<size_t>(value_idx) >= s_values->size()) {
+    return 0;
+  }
+  return planned_capacity(s_values->Get(value_idx)->val_as_Tensor());
+}
+
+/**
+ * Returns the memory of `t`. A memory-planned tensor covers its whole planned
+ * allocation, `capacity` bytes from where the planner (or
+ * move_mutable_buffers()) placed it, so that resizing it doesn't change what
+ * it overlaps.
+ */
+AccessRange tensor_access_range(
+    const executorch::aten::Tensor& t,
+    size_t capacity,
+    bool write) {
+  const void* data = t.const_data_ptr();
+  const size_t nbytes = capacity > 0 ? capacity : t.nbytes();
+  if (data != nullptr && nbytes > 0) {
+    const auto begin = reinterpret_cast<uintptr_t>(data);
+    return AccessRange{begin, begin + nbytes, write};
+  }
+  // Tensors without memory at this point, like unplanned inputs and outputs,
+  // get their data later. Identify them by their TensorImpl instead.
+  const auto begin = reinterpret_cast<uintptr_t>(t.unsafeGetTensorImpl());
+  return AccessRange{begin, begin + 1, write};
+}
+
+/**
+ * Calls `fn` with each of the num_access_ranges(value) memory ranges that
+ * `value` covers. `value` must be an entry of `values`, whose serialized form
+ * is `s_values`.
+ */
+template <typename Fn>
+void for_each_access_range(
+    const EValue& value,
+    const EValue* values,
+    const SerializedValues* s_values,
+    bool write,
+    const Fn& fn) {
+  const auto* s_value = s_values->Get(&value - values);
+  if (value.isTensor()) {
+    fn(tensor_access_range(
+        value.toTensor(), planned_capacity(s_value->val_as_Tensor()), write));
+    return;
+  }
+  // Non-tensor values and the list containers themselves live in the EValue.
+  const auto begin = reinterpret_cast<uintptr_t>(&value);
+  fn(AccessRange{begin, begin + sizeof(EValue), write});
+  if (value.isTensorList()) {
+    const auto* items = s_value->val_as_TensorList()->items();
+    size_t j = 0;
+    for (const auto& t : value.toTensorList()) {
+      fn(tensor_access_range(
+          t, planned_capacity(s_values, items->Get(j++)), write));
+    }
+  } else if (value.isListOptionalTensor()) {
+    const auto* items = s_value->val_as_OptionalTensorList()->items();
+    size_t j = 0;
+    for (const auto& t : value.toListOptionalTensor()) {
+      const int64_t item = items->Get(j++);
+      if (t.has_value()) {
+        fn(tensor_access_range(
+            t.value(), planned_capacity(s_values, item), write));
+      } else {
+        // Keep the count in sync with num_access_ranges() with an empty range,
+        // which never overlaps anything.
+        fn(AccessRange{0, 0, false});
+      }
+    }
+  }
+}
+
+/**
+ * Writes the memory that `value` covers to `out`, which must have room for
+ * num_access_ranges(value) entries. Returns the new end of `out`.
+ */
+AccessRange* append_access_ranges(
+    const EValue& value,
+    const EValue* values,
+    const SerializedValues* s_values,
+    bool write,
+    AccessRange* out) {
+  for_each_access_range(
+      value, values, s_values, write, [&](const AccessRange& range) {
+        *out++ = range;
+      });
+  return out;
+}
+
+/// Returns true if `a` and `b` must not run concurrently.
+bool accesses_conflict(const InstructionAccess& a, const InstructionAccess& b) {
+  for (size_t i = 0; i < a.size; ++i) {
+    for (size_t j = 0; j < b.size; ++j) {
+      const AccessRange& ra = a.ranges[i];
+      const AccessRange& rb = b.ranges[j];
+      if ((ra.write || rb.write) && ra.begin < rb.end && rb.begin < ra.end) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// Returns true if any memory that `a` covers overlaps memory that `b` covers.
+bool args_overlap(
+    InstructionArgs a,
+    InstructionArgs b,
+    const EValue* values,
+    const SerializedValues* s_values) {
+  bool overlap = false;
+  for (size_t i = 0; i < a.size() && !overlap; ++i) {
+    for_each_access_range(
+        *a[i], values, s_values, false, [&](const AccessRange& ra) {
+          for (size_t j = 0; j < b.size() && !overlap; ++j) {
+            for_each_access_range(
+                *b[j], values, s_values, false, [&](const AccessRange& rb) {
+                  overlap = overlap || (ra.begin < rb.end && rb.begin < ra.end);
+                });
+          }
+        });
+  }
+  return overlap;
+}
+
+/// Returns the offset into its planned buffer of a tensor with
+/// `allocation_info`.
+size_t planned_offset(
+    const executorch_flatbuffer::AllocationDetails* allocation_info) {
+  size_t offset = allocation_info->memory_offset_low();
+  if (sizeof(size_t) > sizeof(uint32_t)) {
+    offset |= static_cast<size_t>(allocation_info->memory_offset_high())
+        << 32;
+  }
+  return offset;
+}
+
+/// Where a memory-planned tensor lives, and the instructions that use it.
+struct PlannedTensorUse {
+  size_t offset;
+  size_t nbytes;
+  /// The first and last instruction that reference the tensor, or -1 if no
+  /// instruction does.
+  int64_t first;
+  int64_t last;
+};
+
+/// Records that the instruction at `instr_idx` references value `value_idx`,
+/// and the tensors in it if it is a list.
+void mark_value_use(
+    const flatbuffers::Vector<
+        flatbuffers::Offset<executorch_flatbuffer::EValue>>* s_values,
+    size_t value_idx,
+    int64_t instr_idx,
+    PlannedTensorUse* uses) {
+  auto mark = [&](size_t idx) {
+    if (idx >= s_values->size()) {
+      return;
+    }
+    PlannedTensorUse& use = uses[idx];
+    if (use.first < 0 || instr_idx < use.first) {
+      use.first = instr_idx;
+    }
+    if (instr_idx > use.last) {
+      use.last = instr_idx;
+    }
+  };
+  mark(value_idx);
+  if (value_idx >= s_values->size()) {
+    return;
+  }
+  const auto* s_value = s_values->Get(value_idx);
+  const flatbuffers::Vector<int32_t>* items = nullptr;
+  if (s_value->val_type() == executorch_flatbuffer::KernelTypes::TensorList) {
+    items = s_value->val_as_TensorList()->items();
+  } else if (
+      s_value->val_type() ==
+      executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+    items = s_value->val_as_OptionalTensorList()->items();
+  }
+  if (items != nullptr) {
+    for (const auto item : *items) {
+      if (item >= 0) {
+        mark(static_cast<size_t>(item));
+      }
+    }
+  }
+}
+
+/// State shared by the tasks of a wave. See Method::execute_instruction_wave().
+struct WaveContext {
+  const Instruction* instructions;
+  PlatformMemoryAllocator* temp_allocators;
+  Error* errors;
+  const char* method_name;
+};
+
+void run_wave_task(void* context, size_t task_index) {
+  auto* wave = static_cast<WaveContext*>(context);
+  const Instruction& instruction = wave->instructions[task_index];
+  PlatformMemoryAllocator* temp_allocator = &wave->temp_allocators[task_index];
+  Error err = Error::Ok;
+  if (instruction.type == Instruction::Type::KernelCall) {
+    // Event tracers are not thread-safe, and Method does not allow parallel
+    // execution when one is present. The kernels of a wave run concurrently,
+    // so they can't use the scratch memory reserved for them, which may be
+    // shared, and get their temp memory from their own allocators instead.
+    KernelRuntimeContext kernel_context(
+        /*event_tracer=*/nullptr, temp_allocator);
+    instruction.kernel(kernel_context, instruction.args.data());
+    err = kernel_context.failure_state();
+  } else {
+    BackendExecutionContext backend_execution_context(
+        /*event_tracer=*/nullptr, temp_allocator, wave->method_name);
+    err = instruction.delegate->Execute(
+        backend_execution_context, instruction.args.data());
+  }
+  temp_allocator->reset();
+  wave->errors[task_index] = err;
+}
+
 } // namespace
 
 Result<size_t> Method::get_num_external_constants() {
@@ -661,8 +1079,8 @@ Error populate_operator_name(
 
 Error Method::resolve_operator(
     int32_t op_index,
-    OpFunction* kernels,
-    size_t kernel_index,
+    OpFunction* kernel,
+    ScratchSizeFunction* scratch_size,
     InstructionArgs args,
     size_t n_args) {
   // TODO(T153505381, T153506819) Investigate optimizing this function for both
@@ -730,7 +1148,163 @@ Error Method::resolve_operator(
         operator_name);
     return op_function.error();
   }
-  kernels[kernel_index] = op_function.get();
+  *kernel = op_function.get();
+  *scratch_size =
+      registry_op_scratch_size_function(operator_name, {meta, count});
+  return Error::Ok;
+}
+
+Error Method::prepare_tensor_lists() {
+  const auto* s_values = serialization_plan_->values();
+
+  // MoveCall replaces its target outright, e.g. with the output of the branch
+  // that a cond took, so a cached list could keep the Tensor of the other
+  // branch. Callers can replace inputs and outputs between executions.
+  constexpr uint8_t kMoveTarget = 1;
+  constexpr uint8_t kInputOrOutput = 2;
+  uint8_t* replaced = temp_allocator_->allocateList<uint8_t>(n_value_);
+  if (replaced == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  memset(replaced, 0, n_value_);
+  for (size_t i = 0; i < n_chains_; ++i) {
+    for (const Instruction& instruction : chains_[i].instructions_) {
+      if (instruction.type == Instruction::Type::MoveCall) {
+        replaced[instruction.move.to - values_] |= kMoveTarget;
+      }
+    }
+  }
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    replaced[get_input_index(i)] |= kInputOrOutput;
+  }
+  for (size_t i = 0; i < outputs_size(); ++i) {
+    replaced[get_output_index(i)] |= kInputOrOutput;
+  }
+
+  // Returns how the elements of values_[i] can be replaced, or 0 if it is not
+  // a tensor list.
+  const auto list_flags = [&](size_t i) -> uint8_t {
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    if (values_[i].isTensorList()) {
+      items = s_values->Get(i)->val_as_TensorList()->items();
+    } else if (values_[i].isListOptionalTensor()) {
+      items = s_values->Get(i)->val_as_OptionalTensorList()->items();
+    } else {
+      return 0;
+    }
+    uint8_t flags = 0;
+    for (const auto item : *items) {
+      // Optional tensor lists use -1 for none.
+      if (item >= 0) {
+        flags |= replaced[item];
+      }
+    }
+    return flags;
+  };
+
+  size_t n_io_tensor_lists = 0;
+  for (size_t i = 0; i < n_value_; ++i) {
+    const uint8_t flags = list_flags(i);
+    if (flags & kMoveTarget) {
+      if (values_[i].isTensorList()) {
+        values_[i].payload.copyable_union.as_tensor_list.disable_cache();
+      } else {
+        values_[i]
+            .payload.copyable_union.as_list_optional_tensor.disable_cache();
+      }
+    } else if (flags & kInputOrOutput) {
+      ++n_io_tensor_lists;
+    }
+  }
+
+  // Lists that are not cached don't need to be invalidated.
+  n_io_tensor_lists_ = 0;
+  io_tensor_lists_ = nullptr;
+  if (n_io_tensor_lists > 0) {
+    io_tensor_lists_ =
+        memory_manager_->method_allocator()->allocateList<size_t>(
+            n_io_tensor_lists);
+    if (io_tensor_lists_ == nullptr) {
+      temp_allocator_->reset();
+      return Error::MemoryAllocationFailed;
+    }
+    for (size_t i = 0; i < n_value_; ++i) {
+      if (list_flags(i) == kInputOrOutput) {
+        io_tensor_lists_[n_io_tensor_lists_++] = i;
+      }
+    }
+  }
+  temp_allocator_->reset();
+  return Error::Ok;
+}
+
+Error Method::reserve_kernel_scratch() {
+  // Outside of parallel waves kernels run one at a time, so the scratch memory
+  // that they declare can share one buffer. Planned scratch memory stays where
+  // the memory plan put it.
+  size_t shared_size = 0;
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    if (chain.scratch_ == nullptr) {
+      continue;
+    }
+    for (size_t j = 0; j < chain.instructions_.size(); ++j) {
+      const size_t size = chain.scratch_[j].size();
+      if (size == 0) {
+        continue;
+      }
+      // init() only gives scratch memory to kernel calls.
+      const auto* allocation_info = chain.s_chain_->instructions()
+                                        ->Get(j)
+                                        ->instr_args_as_KernelCall()
+                                        ->scratch();
+      if (allocation_info == nullptr) {
+        shared_size = std::max(shared_size, size);
+        continue;
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          memory_manager_->planned_memory() != nullptr,
+          InvalidArgument,
+          "Instruction %" ET_PRIsize_t
+          " has planned scratch memory but there is no planned memory",
+          j);
+      Result<void*> planned =
+          memory_manager_->planned_memory()->get_offset_address(
+              allocation_info->memory_id() - 1,
+              planned_offset(allocation_info),
+              size);
+      if (!planned.ok()) {
+        return planned.error();
+      }
+      chain.scratch_[j] =
+          Span<uint8_t>(static_cast<uint8_t*>(planned.get()), size);
+    }
+  }
+  if (shared_size == 0) {
+    return Error::Ok;
+  }
+  auto* shared = static_cast<uint8_t*>(
+      memory_manager_->method_allocator()->allocate(
+          shared_size, kKernelScratchAlignment));
+  if (shared == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    if (chain.scratch_ == nullptr) {
+      continue;
+    }
+    for (size_t j = 0; j < chain.instructions_.size(); ++j) {
+      const size_t size = chain.scratch_[j].size();
+      if (size > 0 &&
+          chain.s_chain_->instructions()
+                  ->Get(j)
+                  ->instr_args_as_KernelCall()
+                  ->scratch() == nullptr) {
+        chain.scratch_[j] = Span<uint8_t>(shared, size);
+      }
+    }
+  }
   return Error::Ok;
 }
 
@@ -739,7 +1313,8 @@ Result<Method> Method::load(
     const Program* program,
     MemoryManager* memory_manager,
     EventTracer* event_tracer,
-    const NamedDataMap* named_data_map) {
+    const NamedDataMap* named_data_map,
+    ParallelTaskRunner* init_task_runner) {
   MemoryAllocator* temp_allocator = memory_manager->temp_allocator();
   if (temp_allocator == nullptr) {
     PlatformMemoryAllocator* platform_allocator =
@@ -753,7 +1328,7 @@ Result<Method> Method::load(
   }
   Method method(program, memory_manager, event_tracer, temp_allocator);
 
-  Error err = method.init(s_plan, named_data_map);
+  Error err = method.init(s_plan, named_data_map, init_task_runner);
   if (err != Error::Ok) {
     return err;
   } else {
@@ -762,9 +1337,119 @@ Result<Method> Method::load(
   }
 }
 
+namespace {
+
+/// The state of one delegate during Method::init_delegates_in_parallel().
+struct DelegateInitTask {
+  BackendDelegate* delegate;
+  const char* backend_id;
+  MemoryAllocator* runtime_allocator;
+  const char* method_name;
+  const NamedDataMap* named_data_map;
+  /// Whether the backend of `delegate` is thread-safe for init.
+  bool thread_safe;
+  /// Whether InitBackend() was called on `delegate`, and what it returned.
+  bool attempted;
+  Error error;
+
+  void run() {
+    BackendInitContext backend_init_context(
+        runtime_allocator,
+        /*event_tracer=*/nullptr,
+        method_name,
+        named_data_map);
+    error = delegate->InitBackend(backend_init_context, backend_id);
+    attempted = true;
+  }
+};
+
+void run_thread_safe_delegate_init(void* context, size_t task_index) {
+  DelegateInitTask& task = static_cast<DelegateInitTask*>(context)[task_index];
+  if (task.thread_safe) {
+    task.run();
+  }
+}
+
+} // namespace
+
+Error Method::init_delegates_in_parallel(
+    ParallelTaskRunner* init_task_runner,
+    size_t n_delegate,
+    const NamedDataMap* pte_data_map) {
+  if (n_delegate == 0) {
+    return Error::Ok;
+  }
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto delegates = serialization_plan_->delegates();
+  const char* method_name = serialization_plan_->name()->c_str();
+
+  // Each delegate gets a runtime allocator of its own, since the method
+  // allocator is not thread-safe.
+  DelegateInitTask* tasks =
+      method_allocator->allocateList<DelegateInitTask>(n_delegate);
+  PlatformMemoryAllocator* allocators =
+      method_allocator->allocateList<PlatformMemoryAllocator>(n_delegate);
+  if (tasks == nullptr || allocators == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+
+  // Look up the backends and load the processed data and compile specs of all
+  // delegates first, since neither the program nor the method allocator is
+  // thread-safe.
+  Error err = Error::Ok;
+  size_t n_prepared = 0;
+  for (; n_prepared < n_delegate; ++n_prepared) {
+    const auto& delegate = *delegates->Get(n_prepared);
+    err = BackendDelegate::Prepare(
+        delegate, program_, method_allocator, &delegates_[n_prepared]);
+    if (err != Error::Ok) {
+      break;
+    }
+    new (&allocators[n_prepared]) PlatformMemoryAllocator();
+    tasks[n_prepared] = DelegateInitTask{
+        &delegates_[n_prepared],
+        delegate.id()->c_str(),
+        &allocators[n_prepared],
+        method_name,
+        pte_data_map,
+        delegates_[n_prepared].backend()->is_init_thread_safe(),
+        /*attempted=*/false,
+        Error::Ok};
+  }
+
+  if (err == Error::Ok) {
+    init_task_runner->run(run_thread_safe_delegate_init, tasks, n_delegate);
+    // The other backends are initialized on this thread, in order, stopping
+    // at the first failure like the serial path.
+    for (size_t i = 0; i < n_delegate && err == Error::Ok; ++i) {
+      if (!tasks[i].thread_safe) {
+        tasks[i].run();
+      }
+      err = tasks[i].error;
+    }
+  }
+
+  if (err != Error::Ok) {
+    for (size_t i = 0; i < n_prepared; ++i) {
+      if (tasks[i].attempted && tasks[i].error == Error::Ok) {
+        delegates_[i].~BackendDelegate();
+      } else {
+        delegates_[i].Discard();
+      }
+      allocators[i].~PlatformMemoryAllocator();
+    }
+    return err;
+  }
+
+  delegate_init_allocators_ = allocators;
+  n_delegate_ = n_delegate;
+  return Error::Ok;
+}
+
 Error Method::init(
     executorch_flatbuffer::ExecutionPlan* s_plan,
-    const NamedDataMap* named_data_map) {
+    const NamedDataMap* named_data_map,
+    ParallelTaskRunner* init_task_runner) {
   EXECUTORCH_SCOPE_PROF("Method::init");
   internal::EventTracerProfileMethodScope event_tracer_profile_scope =
       internal::EventTracerProfileMethodScope(event_tracer_, "Method::init");
@@ -811,7 +1496,17 @@ Error Method::init(
     // makes it safe for errors to return without updating any state.
     n_delegate_ = 0;
 
-    for (size_t i = 0; i < n_delegate; ++i) {
+    // Event tracers are not thread-safe, so delegates are only initialized in
+    // parallel when there is none.
+    if (init_task_runner != nullptr && event_tracer_ == nullptr) {
+      Error err = init_delegates_in_parallel(
+          init_task_runner, n_delegate, pte_data_map);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+
+    for (size_t i = n_delegate_; i < n_delegate; ++i) {
       const auto& delegate = *delegates->Get(i);
       BackendInitContext backend_init_context(
           method_allocator,
@@ -854,19 +1549,17 @@ Error Method::init(
           "Missing instructions in chain %" ET_PRIsize_t,
           i);
       auto num_instructions = s_instructions->size();
-      auto chain_instruction_kernels =
-          method_allocator->allocateList<OpFunction>(num_instructions);
-      if (chain_instruction_kernels == nullptr) {
-        return Error::MemoryAllocationFailed;
-      }
-      auto chain_instruction_arg_lists =
-          method_allocator->allocateList<InstructionArgs>(num_instructions);
-      if (chain_instruction_arg_lists == nullptr) {
+      auto chain_instructions =
+          method_allocator->allocateList<Instruction>(num_instructions);
+      if (chain_instructions == nullptr) {
         return Error::MemoryAllocationFailed;
       }
+      // Sized here, and pointed at memory by reserve_kernel_scratch() once
+      // every chain is decoded.
+      Span<uint8_t>* chain_scratch = nullptr;
 
-      // Set up the argument lists ahead of time and store pointers to them to
-      // use when the instructions are called
+      // Decode the instructions ahead of time, validating indices and setting
+      // up argument lists, so that execution can use them directly.
       for (size_t instr_idx = 0; instr_idx < s_instructions->size();
            ++instr_idx) {
         const auto instruction = s_instructions->Get(instr_idx);
@@ -877,6 +1570,8 @@ Error Method::init(
             "Null instruction at index %" ET_PRIsize_t,
             instr_idx);
 
+        Instruction& decoded = chain_instructions[instr_idx];
+        decoded.args = InstructionArgs();
         const void* instr_args = instruction->instr_args();
         switch (instruction->instr_args_type()) {
           case executorch_flatbuffer::InstructionArguments::KernelCall: {
@@ -895,11 +1590,14 @@ Error Method::init(
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.type = Instruction::Type::KernelCall;
+            decoded.args = res.get();
+            decoded.kernel = nullptr;
+            ScratchSizeFunction scratch_size_fn = nullptr;
             auto err = resolve_operator(
                 instr_args_as_KernelCall->op_index(),
-                chain_instruction_kernels,
-                instr_idx,
+                &decoded.kernel,
+                &scratch_size_fn,
                 res.get(),
                 arg_idxs->size());
             if (err == Error::OperatorMissing) {
@@ -909,16 +1607,56 @@ Error Method::init(
             } else {
               delayed_error = err;
             }
+            // Scratch memory planned ahead of time takes precedence over the
+            // size that the kernel declares. The tensors have their
+            // upper-bound sizes here, so the kernel declares the most it can
+            // need.
+            size_t scratch_size = 0;
+            if (instr_args_as_KernelCall->scratch() != nullptr) {
+              scratch_size = static_cast<size_t>(
+                  instr_args_as_KernelCall->scratch_size());
+            } else if (err == Error::Ok && scratch_size_fn != nullptr) {
+              scratch_size = scratch_size_fn(decoded.args.data());
+            }
+            if (scratch_size > 0) {
+              if (chain_scratch == nullptr) {
+                chain_scratch =
+                    method_allocator->allocateList<Span<uint8_t>>(
+                        num_instructions);
+                if (chain_scratch == nullptr) {
+                  return Error::MemoryAllocationFailed;
+                }
+                for (size_t k = 0; k < num_instructions; ++k) {
+                  new (&chain_scratch[k]) Span<uint8_t>();
+                }
+              }
+              chain_scratch[instr_idx] =
+                  Span<uint8_t>(static_cast<uint8_t*>(nullptr), scratch_size);
+            }
           } break;
           case executorch_flatbuffer::InstructionArguments::DelegateCall: {
-            const auto arg_idxs =
+            const auto* instr_args_as_DelegateCall =
                 static_cast<const executorch_flatbuffer::DelegateCall*>(
-                    instr_args)
-                    ->args();
+                    instr_args);
+            const auto arg_idxs = instr_args_as_DelegateCall->args();
             ET_CHECK_OR_RETURN_ERROR(
                 arg_idxs != nullptr,
                 InvalidProgram,
                 "DelegateCall args missing");
+            // Delegates are initialized before chains, so n_delegate_ is the
+            // final count here.
+            const auto delegate_idx =
+                instr_args_as_DelegateCall->delegate_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                delegate_idx >= 0 &&
+                    static_cast<size_t>(delegate_idx) < n_delegate_,
+                InvalidProgram,
+                "DELEGATE_CALL index %" PRId32
+                " >= num delegates %" ET_PRIsize_t
+                " at instruction %" ET_PRIsize_t,
+                delegate_idx,
+                n_delegate_,
+                instr_idx);
             auto res = gen_instruction_arguments(
                 method_allocator,
                 n_value_,
@@ -928,32 +1666,70 @@ Error Method::init(
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.type = Instruction::Type::DelegateCall;
+            decoded.args = res.get();
+            decoded.delegate = &delegates_[delegate_idx];
           } break;
           case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
             // Validate the index at load time so we can trust it during
             // execution.
-            auto index =
+            const auto* jf_call =
                 static_cast<const executorch_flatbuffer::JumpFalseCall*>(
-                    instr_args)
-                    ->cond_value_index();
+                    instr_args);
+            auto index = jf_call->cond_value_index();
             ET_CHECK_OR_RETURN_ERROR(
                 index >= 0 && static_cast<size_t>(index) < n_value_,
                 InvalidProgram,
                 "Index %zd negative or >= %" ET_PRIsize_t,
                 static_cast<ssize_t>(index),
                 n_value_);
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            decoded.type = Instruction::Type::JumpFalseCall;
+            decoded.jump_false = Instruction::JumpFalse{
+                &values_[index],
+                static_cast<size_t>(jf_call->destination_instruction())};
+          } break;
+          case executorch_flatbuffer::InstructionArguments::MoveCall: {
+            const auto* move_call =
+                static_cast<const executorch_flatbuffer::MoveCall*>(
+                    instr_args);
+            auto from = move_call->move_from();
+            auto to = move_call->move_to();
+            ET_CHECK_OR_RETURN_ERROR(
+                from >= 0 && static_cast<size_t>(from) < n_value_ && to >= 0 &&
+                    static_cast<size_t>(to) < n_value_,
+                InvalidProgram,
+                "MoveCall indices %zd -> %zd negative or >= %" ET_PRIsize_t,
+                static_cast<ssize_t>(from),
+                static_cast<ssize_t>(to),
+                n_value_);
+            decoded.type = Instruction::Type::MoveCall;
+            decoded.move = Instruction::Move{&values_[from], &values_[to]};
+          } break;
+          case executorch_flatbuffer::InstructionArguments::FreeCall: {
+            auto index = static_cast<const executorch_flatbuffer::FreeCall*>(
+                             instr_args)
+                             ->value_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                index >= 0 && static_cast<size_t>(index) < n_value_,
+                InvalidProgram,
+                "FreeCall index %zd negative or >= %" ET_PRIsize_t,
+                static_cast<ssize_t>(index),
+                n_value_);
+            decoded.type = Instruction::Type::FreeCall;
+            decoded.free_value = &values_[index];
           } break;
           default: {
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            decoded.type = Instruction::Type::Unknown;
           } break;
         }
       }
       chains_[i] = Chain{
           s_chain,
-          Span<InstructionArgs>(chain_instruction_arg_lists, num_instructions),
-          chain_instruction_kernels,
+          Span<Instruction>(chain_instructions, num_instructions),
+          /*wave_ends_=*/nullptr,
+          /*constant_use_ends_=*/nullptr,
+          /*constant_uses_=*/nullptr,
+          chain_scratch,
       };
     }
     ET_CHECK_OR_RETURN_ERROR(
@@ -965,6 +1741,8 @@ Error Method::init(
     if (delayed_error != Error::Ok) {
       return delayed_error;
     }
+    ET_CHECK_OK_OR_RETURN_ERROR(reserve_kernel_scratch());
+    ET_CHECK_OK_OR_RETURN_ERROR(prepare_tensor_lists());
   }
 
   step_state_ = StepState{0, 0};
@@ -973,47 +1751,702 @@ Error Method::init(
   return Error::Ok;
 }
 
-ET_NODISCARD Error
-Method::set_input(const EValue& input_evalue, size_t input_idx) {
+Result<Method> Method::clone_with_memory(
+    MemoryManager* memory_manager,
+    EventTracer* event_tracer) const {
+  EXECUTORCH_SCOPE_PROF("Method::clone_with_memory");
   ET_CHECK_OR_RETURN_ERROR(
       initialized(),
       InvalidState,
-      "Input can not be set until method has been initialized.");
-
-  ET_CHECK_OR_RETURN_ERROR(
-      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
-      InvalidState,
-      "Inputs can not be set mid execution.");
-
+      "Cannot clone method until it has been initialized.");
   ET_CHECK_OR_RETURN_ERROR(
-      input_idx < inputs_size(),
+      memory_manager != nullptr && memory_manager != memory_manager_,
       InvalidArgument,
-      "Input index (%" ET_PRIsize_t
-      ") must be less than the number of inputs in method (%" ET_PRIsize_t ").",
-      input_idx,
-      inputs_size());
-
-  const auto& e = get_value(get_input_index(input_idx));
-
-  if (!e.isTensor() && !e.isScalar()) {
-#if ET_LOG_ENABLED
-    std::array<char, kTagNameBufferSize> tag_name;
-    tag_to_string(e.tag, tag_name.data(), tag_name.size());
-    ET_LOG(
-        Error,
-        "Input %" ET_PRIsize_t
-        " was expected to be a Tensor or primitive but was %s.",
-        input_idx,
-        tag_name.data());
-#endif
+      "Clone needs its own MemoryManager");
+  auto method_allocator = memory_manager->method_allocator();
 
-    return Error::InvalidArgument;
+  MemoryAllocator* temp_allocator = memory_manager->temp_allocator();
+  if (temp_allocator == nullptr) {
+    PlatformMemoryAllocator* platform_allocator =
+        method_allocator->allocateInstance<PlatformMemoryAllocator>();
+    if (platform_allocator == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    new (platform_allocator) PlatformMemoryAllocator();
+    temp_allocator = platform_allocator;
   }
+  Method clone(program_, memory_manager, event_tracer, temp_allocator);
+  clone.serialization_plan_ = serialization_plan_;
+  clone.init_state_ = InitializationState::InitializationFailed;
 
-  if (e.tag != input_evalue.tag) {
-#if ET_LOG_ENABLED
-    std::array<char, kTagNameBufferSize> e_tag_name;
-    std::array<char, kTagNameBufferSize> input_tag_name;
+  {
+    // Recreate the values. Everything that lives in planned memory gets a new
+    // TensorImpl pointing into the clone's memory, and lists are rebuilt so
+    // that they refer to the clone's values. Everything else is immutable and
+    // can be shared. init() already validated the serialized values, so this
+    // doesn't check them again.
+    const auto flatbuffer_values = serialization_plan_->values();
+    EValue* values = method_allocator->allocateList<EValue>(n_value_);
+    if (values == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    clone.values_ = values;
+
+    // As in parse_values(), clone.n_value_ counts the number of
+    // successfully-initialized values for ~Method() to clean up.
+    for (size_t i = 0; i < n_value_; ++i) {
+      auto serialization_value = flatbuffer_values->Get(i);
+      const auto val = serialization_value->val();
+
+      switch (serialization_value->val_type()) {
+        case executorch_flatbuffer::KernelTypes::Null: {
+          new (&values[i]) EValue();
+        } break;
+        case executorch_flatbuffer::KernelTypes::Tensor: {
+          const auto s_tensor =
+              static_cast<const executorch_flatbuffer::Tensor*>(val);
+          const bool is_external = s_tensor->extra_tensor_info() != nullptr &&
+              s_tensor->extra_tensor_info()->location() ==
+                  executorch_flatbuffer::TensorDataLocation::EXTERNAL;
+          if (s_tensor->allocation_info() == nullptr &&
+              (is_external || s_tensor->data_buffer_idx() > 0)) {
+            // Constant tensors can't be resized or written to, so the clone
+            // can share the TensorImpl.
+            new (&values[i]) EValue(values_[i]);
+          } else {
+            // The initial state of external mutable buffers comes from a
+            // NamedDataMap, which the Method doesn't keep a reference to.
+            ET_CHECK_OR_RETURN_ERROR(
+                !is_external,
+                NotSupported,
+                "Cannot clone external mutable tensor at index %" ET_PRIsize_t,
+                i);
+            auto t = deserialization::parseTensor(
+                program_, memory_manager, s_tensor);
+            if (!t.ok()) {
+              ET_LOG(
+                  Error,
+                  "Failed cloning tensor at index %" ET_PRIsize_t
+                  ": 0x%" PRIx32,
+                  i,
+                  static_cast<uint32_t>(t.error()));
+              return t.error();
+            }
+            new (&values[i]) EValue(t.get());
+          }
+        } break;
+        case executorch_flatbuffer::KernelTypes::IntList: {
+          const auto items =
+              static_cast<const executorch_flatbuffer::IntList*>(val)->items();
+          auto* evalp_list =
+              method_allocator->allocateList<EValue*>(items->size());
+          auto* int_list =
+              method_allocator->allocateList<int64_t>(items->size());
+          if (evalp_list == nullptr || int_list == nullptr) {
+            return Error::MemoryAllocationFailed;
+          }
+          for (size_t j = 0; j < items->size(); j++) {
+            evalp_list[j] = &values[static_cast<size_t>(items->Get(j))];
+          }
+          new (&values[i]) EValue(
+              BoxedEvalueList<int64_t>(evalp_list, int_list, items->size()));
+        } break;
+        case executorch_flatbuffer::KernelTypes::TensorList: {
+          const auto items =
+              static_cast<const executorch_flatbuffer::TensorList*>(val)
+                  ->items();
+          auto tensors = deserialization::parseTensorList(
+              items, values, n_value_, memory_manager);
+          if (!tensors.ok()) {
+            return tensors.error();
+          }
+          new (&values[i]) EValue(tensors.get());
+        } break;
+        case executorch_flatbuffer::KernelTypes::OptionalTensorList: {
+          const auto items =
+              static_cast<const executorch_flatbuffer::OptionalTensorList*>(
+                  val)
+                  ->items();
+          auto tensors =
+              deserialization::parseListOptionalType<executorch::aten::Tensor>(
+                  items, values, n_value_, memory_manager);
+          if (!tensors.ok()) {
+            return tensors.error();
+          }
+          new (&values[i]) EValue(tensors.get());
+        } break;
+        default:
+          // Scalars, strings, and bool/double lists only refer to program
+          // data.
+          new (&values[i]) EValue(values_[i]);
+          break;
+      }
+      clone.n_value_ = i + 1;
+    }
+  }
+
+  {
+    // Copy the decoded chains, pointing their arguments at the clone's values.
+    // Kernels and delegates are shared; the clone leaves n_delegate_ at zero
+    // so that it never destroys the delegates owned by this Method.
+    clone.chains_ = method_allocator->allocateList<Chain>(n_chains_);
+    if (clone.chains_ == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    clone.n_chains_ = n_chains_;
+    EValue* const values = clone.values_;
+    auto rebase = [this, values](const EValue* value) {
+      return values + (value - values_);
+    };
+    for (size_t i = 0; i < n_chains_; ++i) {
+      const Span<Instruction> source = chains_[i].instructions_;
+      auto instructions =
+          method_allocator->allocateList<Instruction>(source.size());
+      if (instructions == nullptr) {
+        return Error::MemoryAllocationFailed;
+      }
+      for (size_t j = 0; j < source.size(); ++j) {
+        instructions[j] = source[j];
+        Instruction& instruction = instructions[j];
+        switch (instruction.type) {
+          case Instruction::Type::KernelCall:
+          case Instruction::Type::DelegateCall: {
+            const InstructionArgs args = source[j].args;
+            EValue** arg_list =
+                method_allocator->allocateList<EValue*>(args.size());
+            if (arg_list == nullptr) {
+              return Error::MemoryAllocationFailed;
+            }
+            for (size_t k = 0; k < args.size(); ++k) {
+              arg_list[k] = rebase(args[k]);
+            }
+            instruction.args = InstructionArgs(arg_list, args.size());
+          } break;
+          case Instruction::Type::JumpFalseCall: {
+            instruction.jump_false.cond_value =
+                rebase(instruction.jump_false.cond_value);
+          } break;
+          case Instruction::Type::MoveCall: {
+            instruction.move.from = rebase(instruction.move.from);
+            instruction.move.to = rebase(instruction.move.to);
+          } break;
+          case Instruction::Type::FreeCall: {
+            instruction.free_value = rebase(instruction.free_value);
+          } break;
+          default:
+            break;
+        }
+      }
+      // The clone's scratch memory has the same sizes, in its own memory.
+      Span<uint8_t>* scratch = nullptr;
+      if (chains_[i].scratch_ != nullptr) {
+        scratch = method_allocator->allocateList<Span<uint8_t>>(source.size());
+        if (scratch == nullptr) {
+          return Error::MemoryAllocationFailed;
+        }
+        for (size_t j = 0; j < source.size(); ++j) {
+          new (&scratch[j]) Span<uint8_t>(
+              static_cast<uint8_t*>(nullptr), chains_[i].scratch_[j].size());
+        }
+      }
+      // The parallel schedule only depends on the program and its memory
+      // plan, so it can be shared too.
+      clone.chains_[i] = Chain{
+          chains_[i].s_chain_,
+          Span<Instruction>(instructions, source.size()),
+          chains_[i].wave_ends_,
+          /*constant_use_ends_=*/nullptr,
+          /*constant_uses_=*/nullptr,
+          scratch,
+      };
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(clone.reserve_kernel_scratch());
+    ET_CHECK_OK_OR_RETURN_ERROR(clone.prepare_tensor_lists());
+  }
+
+  clone.step_state_ = StepState{0, 0};
+  clone.init_state_ = InitializationState::Initialized;
+  return clone;
+}
+
+namespace {
+
+// Returns the fully qualified name of the tensor in `serialization_value` if
+// it is an external constant, or nullptr.
+const char* external_constant_key(
+    const executorch_flatbuffer::EValue* serialization_value) {
+  if (serialization_value->val_type() !=
+      executorch_flatbuffer::KernelTypes::Tensor) {
+    return nullptr;
+  }
+  const auto s_tensor = static_cast<const executorch_flatbuffer::Tensor*>(
+      serialization_value->val());
+  if (s_tensor->extra_tensor_info() == nullptr ||
+      s_tensor->extra_tensor_info()->location() !=
+          executorch_flatbuffer::TensorDataLocation::EXTERNAL ||
+      s_tensor->allocation_info() != nullptr ||
+      s_tensor->extra_tensor_info()->fully_qualified_name() == nullptr) {
+    return nullptr;
+  }
+  return s_tensor->extra_tensor_info()->fully_qualified_name()->c_str();
+}
+
+/// Returns the name of a memory-planned buffer that the program mutates, or
+/// nullptr if `serialization_value` is not one.
+const char* mutable_buffer_name(
+    const executorch_flatbuffer::EValue* serialization_value) {
+  if (serialization_value->val_type() !=
+      executorch_flatbuffer::KernelTypes::Tensor) {
+    return nullptr;
+  }
+  const auto s_tensor = static_cast<const executorch_flatbuffer::Tensor*>(
+      serialization_value->val());
+  if (s_tensor->extra_tensor_info() == nullptr ||
+      s_tensor->extra_tensor_info()->location() ==
+          executorch_flatbuffer::TensorDataLocation::EXTERNAL ||
+      s_tensor->allocation_info() == nullptr ||
+      s_tensor->extra_tensor_info()->fully_qualified_name() == nullptr) {
+    return nullptr;
+  }
+  return s_tensor->extra_tensor_info()->fully_qualified_name()->c_str();
+}
+
+/// Returns the index of the mutable buffer named `name` in `values`, or
+/// `values->size()` if there is none.
+size_t find_mutable_buffer(
+    const flatbuffers::Vector<
+        flatbuffers::Offset<executorch_flatbuffer::EValue>>* values,
+    const char* name) {
+  for (size_t i = 0; i < values->size(); ++i) {
+    const char* other_name = mutable_buffer_name(values->Get(i));
+    if (other_name != nullptr && strcmp(other_name, name) == 0) {
+      return i;
+    }
+  }
+  return values->size();
+}
+
+} // namespace
+
+Error Method::update_external_constants(const NamedDataMap* named_data_map) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "External constants can not be updated until method has been "
+      "initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "External constants can not be updated mid execution.");
+  ET_CHECK_OR_RETURN_ERROR(
+      named_data_map != nullptr, InvalidArgument, "Missing named_data_map");
+  auto flatbuffer_values = serialization_plan_->values();
+  const size_t n_value = flatbuffer_values->size();
+
+  // Check every tensor that the map replaces before touching any of them, so
+  // that a map that doesn't match leaves the method as it was.
+  size_t n_matched = 0;
+  for (size_t i = 0; i < n_value; ++i) {
+    auto serialization_value = flatbuffer_values->Get(i);
+    const char* key = external_constant_key(serialization_value);
+    if (key == nullptr) {
+      continue;
+    }
+    Result<const TensorLayout> tensor_layout =
+        named_data_map->get_metadata(key);
+    if (tensor_layout.error() == Error::NotFound) {
+      continue;
+    }
+    if (!tensor_layout.ok()) {
+      return tensor_layout.error();
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(deserialization::validateTensorLayout(
+        static_cast<const executorch_flatbuffer::Tensor*>(
+            serialization_value->val()),
+        tensor_layout.get()));
+    n_matched++;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      n_matched > 0,
+      NotFound,
+      "None of the external constants of the method are in named_data_map");
+  // Clones share the constants of their source Method but don't own them.
+  ET_CHECK_OR_RETURN_ERROR(
+      external_constants_ != nullptr,
+      NotSupported,
+      "Update the external constants of the Method this one was cloned from");
+
+  for (size_t i = 0; i < n_external_constants_; ++i) {
+    NamedData& constant = external_constants_[i];
+    if (!named_data_map->get_metadata(constant.key).ok()) {
+      continue;
+    }
+    Result<FreeableBuffer> buffer = named_data_map->get_data(constant.key);
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer.ok(),
+        InvalidExternalData,
+        "Buffer retrieved from get_data is not valid");
+    // Tensors that share the data share the key.
+    for (size_t j = 0; j < n_value; ++j) {
+      const char* key = external_constant_key(flatbuffer_values->Get(j));
+      if (key == nullptr || strcmp(key, constant.key) != 0) {
+        continue;
+      }
+      ET_CHECK_OK_OR_RETURN_ERROR(internal::set_tensor_data(
+          values_[j].toTensor(),
+          const_cast<void*>(buffer->data()),
+          buffer->size()));
+    }
+    constant.buffer.~FreeableBuffer();
+    new (&constant.buffer) FreeableBuffer(std::move(buffer.get()));
+  }
+  return Error::Ok;
+}
+
+Result<size_t> Method::share_mutable_buffers(const Method& other) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized() && other.initialized(),
+      InvalidState,
+      "Mutable buffers can not be shared until both methods have been "
+      "initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Mutable buffers can not be shared mid execution.");
+  ET_CHECK_OR_RETURN_ERROR(
+      &other != this,
+      InvalidArgument,
+      "A method can not share mutable buffers with itself");
+  auto flatbuffer_values = serialization_plan_->values();
+  auto other_values = other.serialization_plan_->values();
+  const size_t n_value = flatbuffer_values->size();
+
+  // Check every buffer that would be shared before moving any of them, so
+  // that a mismatch leaves the method as it was.
+  size_t n_shared = 0;
+  for (size_t i = 0; i < n_value; ++i) {
+    const char* name = mutable_buffer_name(flatbuffer_values->Get(i));
+    if (name == nullptr) {
+      continue;
+    }
+    const size_t j = find_mutable_buffer(other_values, name);
+    if (j == other_values->size()) {
+      continue;
+    }
+    const auto& t = values_[i].toTensor();
+    const auto& other_t = other.values_[j].toTensor();
+    ET_CHECK_OR_RETURN_ERROR(
+        t.scalar_type() == other_t.scalar_type() &&
+            t.nbytes() == other_t.nbytes(),
+        InvalidArgument,
+        "Mutable buffer %s has a different dtype or size in the other method",
+        name);
+    n_shared++;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      n_shared > 0,
+      NotFound,
+      "The methods have no mutable buffers in common");
+
+  for (size_t i = 0; i < n_value; ++i) {
+    const char* name = mutable_buffer_name(flatbuffer_values->Get(i));
+    if (name == nullptr) {
+      continue;
+    }
+    const size_t j = find_mutable_buffer(other_values, name);
+    if (j == other_values->size()) {
+      continue;
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(rebind_mutable_buffer(
+        i,
+        static_cast<uint8_t*>(other.values_[j].toTensor().mutable_data_ptr())));
+  }
+  return n_shared;
+}
+
+Result<size_t> Method::move_mutable_buffers(MemoryAllocator* allocator) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Mutable buffers can not be moved until the method has been "
+      "initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Mutable buffers can not be moved mid execution.");
+  ET_CHECK_OR_RETURN_ERROR(
+      allocator != nullptr, InvalidArgument, "allocator must not be null");
+  auto flatbuffer_values = serialization_plan_->values();
+  // A planned tensor with an initial state is a mutable buffer. Without a
+  // name it can't be moved, and its state would be lost, so fail before
+  // moving anything.
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    const auto* s_value = flatbuffer_values->Get(i);
+    if (s_value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+      continue;
+    }
+    const auto* s_tensor = s_value->val_as_Tensor();
+    ET_CHECK_OR_RETURN_ERROR(
+        s_tensor->allocation_info() == nullptr ||
+            s_tensor->data_buffer_idx() == 0 ||
+            mutable_buffer_name(s_value) != nullptr,
+        NotSupported,
+        "Mutable buffer at value %" ET_PRIsize_t
+        " has no name; export the program with named mutable buffers",
+        i);
+  }
+  size_t n_moved = 0;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    if (mutable_buffer_name(flatbuffer_values->Get(i)) == nullptr) {
+      continue;
+    }
+    const auto& t = values_[i].toTensor();
+    auto* data = static_cast<uint8_t*>(allocator->allocate(t.nbytes()));
+    ET_CHECK_OR_RETURN_ERROR(
+        data != nullptr || t.nbytes() == 0,
+        MemoryAllocationFailed,
+        "Failed to allocate %" ET_PRIsize_t " bytes for a mutable buffer",
+        t.nbytes());
+    if (t.nbytes() > 0) {
+      std::memcpy(data, t.const_data_ptr(), t.nbytes());
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(rebind_mutable_buffer(i, data));
+    n_moved++;
+  }
+  return n_moved;
+}
+
+size_t Method::num_mutable_buffers() const {
+  auto flatbuffer_values = serialization_plan_->values();
+  size_t n_buffer = 0;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    if (mutable_buffer_name(flatbuffer_values->Get(i)) != nullptr) {
+      n_buffer++;
+    }
+  }
+  return n_buffer;
+}
+
+Result<executorch::aten::Tensor> Method::get_mutable_buffer(
+    size_t index) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Mutable buffers can not be retrieved until the method has been "
+      "initialized.");
+  auto flatbuffer_values = serialization_plan_->values();
+  size_t n_buffer = 0;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    if (mutable_buffer_name(flatbuffer_values->Get(i)) == nullptr) {
+      continue;
+    }
+    if (n_buffer++ == index) {
+      return values_[i].toTensor();
+    }
+  }
+  ET_LOG(
+      Error,
+      "Mutable buffer index %" ET_PRIsize_t " out of range (%" ET_PRIsize_t
+      " buffers)",
+      index,
+      n_buffer);
+  return Error::InvalidArgument;
+}
+
+Error Method::rebind_mutable_buffer(size_t value_idx, uint8_t* data) {
+  auto flatbuffer_values = serialization_plan_->values();
+  const auto* allocation_info =
+      flatbuffer_values->Get(value_idx)->val_as_Tensor()->allocation_info();
+  const uint32_t memory_id = allocation_info->memory_id();
+  const size_t begin = planned_offset(allocation_info);
+  const size_t end = begin + values_[value_idx].toTensor().nbytes();
+  // The buffer is live for the whole method, so the planner only placed
+  // aliases of it, like in-place outputs, in its range.
+  for (size_t k = 0; k < flatbuffer_values->size(); ++k) {
+    const auto* s_tensor = flatbuffer_values->Get(k)->val_as_Tensor();
+    const auto* k_allocation_info =
+        s_tensor != nullptr ? s_tensor->allocation_info() : nullptr;
+    if (k_allocation_info == nullptr ||
+        k_allocation_info->memory_id() != memory_id) {
+      continue;
+    }
+    const auto& t = values_[k].toTensor();
+    const size_t offset = planned_offset(k_allocation_info);
+    if (offset < begin || offset + t.nbytes() > end) {
+      continue;
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        internal::set_tensor_data(t, data + (offset - begin), t.nbytes()));
+  }
+  return Error::Ok;
+}
+
+Error Method::set_external_constant_resolver(
+    ExternalConstantResolver* resolver) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot set an external constant resolver until method has been "
+      "initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Cannot change the external constant resolver mid execution.");
+  if (resolver == nullptr) {
+    if (constant_resolver_ != nullptr) {
+      constant_resolver_ = nullptr;
+      return restore_external_constants();
+    }
+    return Error::Ok;
+  }
+  // Clones share the constants of their source Method but don't own them.
+  ET_CHECK_OR_RETURN_ERROR(
+      external_constants_ != nullptr,
+      NotSupported,
+      "Method has no external constants of its own");
+  if (n_chains_ > 0 && chains_[0].constant_use_ends_ == nullptr) {
+    ET_CHECK_OK_OR_RETURN_ERROR(build_constant_use_table());
+  }
+  constant_resolver_ = resolver;
+  return Error::Ok;
+}
+
+Error Method::build_constant_use_table() {
+  auto flatbuffer_values = serialization_plan_->values();
+  MemoryAllocator* method_allocator = memory_manager_->method_allocator();
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    const size_t num_instructions = chain.instructions_.size();
+    uint32_t* ends = method_allocator->allocateList<uint32_t>(
+        num_instructions > 0 ? num_instructions : 1);
+    if (ends == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    // Count the uses first, so that the table can be allocated in one piece.
+    uint32_t num_uses = 0;
+    for (size_t j = 0; j < num_instructions; ++j) {
+      // Only kernel and delegate calls have arguments.
+      for (EValue* arg : chain.instructions_[j].args) {
+        const size_t value_idx = static_cast<size_t>(arg - values_);
+        if (external_constant_key(flatbuffer_values->Get(value_idx)) !=
+            nullptr) {
+          num_uses++;
+        }
+      }
+      ends[j] = num_uses;
+    }
+    uint32_t* uses =
+        method_allocator->allocateList<uint32_t>(num_uses > 0 ? num_uses : 1);
+    if (uses == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    uint32_t next_use = 0;
+    for (size_t j = 0; j < num_instructions; ++j) {
+      for (EValue* arg : chain.instructions_[j].args) {
+        const size_t value_idx = static_cast<size_t>(arg - values_);
+        if (external_constant_key(flatbuffer_values->Get(value_idx)) !=
+            nullptr) {
+          uses[next_use++] = static_cast<uint32_t>(value_idx);
+        }
+      }
+    }
+    chain.constant_use_ends_ = ends;
+    chain.constant_uses_ = uses;
+  }
+  return Error::Ok;
+}
+
+Error Method::resolve_external_constants() {
+  const Chain& chain = chains_[step_state_.chain_idx];
+  const size_t instr_idx = step_state_.instr_idx;
+  const uint32_t begin =
+      instr_idx == 0 ? 0 : chain.constant_use_ends_[instr_idx - 1];
+  const uint32_t end = chain.constant_use_ends_[instr_idx];
+  for (uint32_t i = begin; i < end; ++i) {
+    const uint32_t value_idx = chain.constant_uses_[i];
+    const char* key =
+        external_constant_key(serialization_plan_->values()->Get(value_idx));
+    Result<const void*> data =
+        constant_resolver_->resolve(key, step_state_.chain_idx, instr_idx);
+    if (!data.ok()) {
+      ET_LOG(
+          Error,
+          "Failed to resolve external constant '%s' for instruction "
+          "%" ET_PRIsize_t ":%" ET_PRIsize_t ": 0x%" PRIx32,
+          key,
+          step_state_.chain_idx,
+          instr_idx,
+          static_cast<uint32_t>(data.error()));
+      return data.error();
+    }
+    auto tensor = values_[value_idx].toTensor();
+    ET_CHECK_OK_OR_RETURN_ERROR(internal::set_tensor_data(
+        tensor, const_cast<void*>(data.get()), tensor.nbytes()));
+  }
+  return Error::Ok;
+}
+
+Error Method::restore_external_constants() {
+  auto flatbuffer_values = serialization_plan_->values();
+  const size_t n_value = flatbuffer_values->size();
+  for (size_t i = 0; i < n_external_constants_; ++i) {
+    const NamedData& constant = external_constants_[i];
+    for (size_t j = 0; j < n_value; ++j) {
+      const char* key = external_constant_key(flatbuffer_values->Get(j));
+      if (key == nullptr || strcmp(key, constant.key) != 0) {
+        continue;
+      }
+      ET_CHECK_OK_OR_RETURN_ERROR(internal::set_tensor_data(
+          values_[j].toTensor(),
+          const_cast<void*>(constant.buffer.data()),
+          constant.buffer.size()));
+    }
+  }
+  return Error::Ok;
+}
+
+
+ET_NODISCARD Error
+Method::set_input(const EValue& input_evalue, size_t input_idx) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Input can not be set until method has been initialized.");
+
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Inputs can not be set mid execution.");
+
+  ET_CHECK_OR_RETURN_ERROR(
+      input_idx < inputs_size(),
+      InvalidArgument,
+      "Input index (%" ET_PRIsize_t
+      ") must be less than the number of inputs in method (%" ET_PRIsize_t ").",
+      input_idx,
+      inputs_size());
+
+  const auto& e = get_value(get_input_index(input_idx));
+
+  if (!e.isTensor() && !e.isScalar()) {
+#if ET_LOG_ENABLED
+    std::array<char, kTagNameBufferSize> tag_name;
+    tag_to_string(e.tag, tag_name.data(), tag_name.size());
+    ET_LOG(
+        Error,
+        "Input %" ET_PRIsize_t
+        " was expected to be a Tensor or primitive but was %s.",
+        input_idx,
+        tag_name.data());
+#endif
+
+    return Error::InvalidArgument;
+  }
+
+  if (e.tag != input_evalue.tag) {
+#if ET_LOG_ENABLED
+    std::array<char, kTagNameBufferSize> e_tag_name;
+    std::array<char, kTagNameBufferSize> input_tag_name;
     tag_to_string(e.tag, e_tag_name.data(), e_tag_name.size());
     tag_to_string(
         input_evalue.tag, input_tag_name.data(), input_tag_name.size());
@@ -1052,7 +2485,11 @@ Method::set_input(const EValue& input_evalue, size_t input_idx) {
     Error error;
     auto tensor_meta = this->method_meta().input_tensor_meta(input_idx);
     if (tensor_meta->is_memory_planned()) {
-      error = internal::copy_tensor_data(t_dst, t_src);
+      // bind_input() may have pointed the tensor away from its planned memory.
+      error = restore_planned_data_ptr(get_input_index(input_idx));
+      if (error == Error::Ok) {
+        error = internal::copy_tensor_data(t_dst, t_src);
+      }
     } else {
       error = internal::share_tensor_data(t_dst, t_src);
     }
@@ -1162,6 +2599,87 @@ Method::set_inputs(const executorch::aten::ArrayRef<EValue>& input_evalues) {
   return Error::Ok;
 }
 
+ET_NODISCARD Error
+Method::bind_input(const EValue& input_evalue, size_t input_idx) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Input can not be set until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Inputs can not be set mid execution.");
+  ET_CHECK_OR_RETURN_ERROR(
+      input_idx < inputs_size(),
+      InvalidArgument,
+      "Input index (%" ET_PRIsize_t
+      ") must be less than the number of inputs in method (%" ET_PRIsize_t ").",
+      input_idx,
+      inputs_size());
+
+  const auto& e = get_value(get_input_index(input_idx));
+  auto tensor_meta = this->method_meta().input_tensor_meta(input_idx);
+  if (!e.isTensor() || !input_evalue.isTensor() || !tensor_meta.ok() ||
+      !tensor_meta->is_memory_planned()) {
+    // Other inputs are never copied, so set_input() already does the right
+    // thing, including reporting type mismatches.
+    return set_input(input_evalue, input_idx);
+  }
+
+  const auto& t_dst = e.toTensor();
+  const auto& t_src = input_evalue.toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      t_dst.scalar_type() == t_src.scalar_type(),
+      InvalidArgument,
+      "Input %" ET_PRIsize_t
+      " has unexpected scalar type: expected %s but was %s.",
+      input_idx,
+      executorch::runtime::toString(t_dst.scalar_type()),
+      executorch::runtime::toString(t_src.scalar_type()));
+  Error err = resize_tensor(t_dst, t_src.sizes());
+  ET_CHECK_OR_RETURN_ERROR(
+      err == Error::Ok,
+      InvalidArgument,
+      "Error setting input %" ET_PRIsize_t ": 0x%" PRIx32,
+      input_idx,
+      static_cast<uint32_t>(err));
+  if (t_src.const_data_ptr() == nullptr || t_src.nbytes() != t_dst.nbytes() ||
+      !tensors_have_same_dim_order(t_dst, t_src)) {
+    // The kernels expect the planned layout; fall back to copying into it.
+    return set_input(input_evalue, input_idx);
+  }
+  err = internal::share_tensor_data(t_dst, t_src);
+  ET_CHECK_OR_RETURN_ERROR(
+      err == Error::Ok,
+      InvalidArgument,
+      "Error setting data_ptr %" ET_PRIsize_t ": 0x%" PRIx32,
+      input_idx,
+      static_cast<uint32_t>(err));
+  return Error::Ok;
+}
+
+Error Method::restore_planned_data_ptr(size_t value_idx) {
+  const auto* s_tensor =
+      serialization_plan_->values()->Get(value_idx)->val_as_Tensor();
+  const auto* allocation_info =
+      s_tensor != nullptr ? s_tensor->allocation_info() : nullptr;
+  if (allocation_info == nullptr) {
+    return Error::Ok;
+  }
+  const auto& t = values_[value_idx].toTensor();
+  Result<void*> planned = memory_manager_->planned_memory()->get_offset_address(
+      allocation_info->memory_id() - 1,
+      planned_offset(allocation_info),
+      t.nbytes());
+  if (!planned.ok()) {
+    return planned.error();
+  }
+  if (t.const_data_ptr() == planned.get()) {
+    return Error::Ok;
+  }
+  return internal::set_tensor_data(t, planned.get(), t.nbytes());
+}
+
 ET_NODISCARD Error
 Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
   // Check method state
@@ -1269,36 +2787,54 @@ ET_NODISCARD Error Method::get_inputs(EValue* input_evalues, size_t length) {
 
 Error Method::execute_instruction() {
   auto& chain = chains_[step_state_.chain_idx];
-  auto instructions = chain.s_chain_->instructions();
 
   ET_CHECK_OR_RETURN_ERROR(
-      step_state_.instr_idx < instructions->size(),
+      step_state_.instr_idx < chain.instructions_.size(),
       Internal,
       "Instr index %" ET_PRIsize_t " >= chain[%" ET_PRIsize_t
       "] instr count %" ET_PRIsize_t,
       step_state_.instr_idx,
       step_state_.chain_idx,
-      (size_t)instructions->size());
+      chain.instructions_.size());
+
+  const Instruction& instruction = chain.instructions_[step_state_.instr_idx];
+  if (n_pending_delegate_calls_ > 0) {
+    ET_CHECK_OK_OR_RETURN_ERROR(wait_for_delegate_calls(&instruction));
+  }
+  if (n_device_values_ > 0) {
+    ET_CHECK_OK_OR_RETURN_ERROR(materialize_device_values(
+        &instruction, /*keep_for_delegate=*/true));
+  }
+
+  if (constant_resolver_ != nullptr) {
+    ET_CHECK_OK_OR_RETURN_ERROR(resolve_external_constants());
+  }
 
-  auto instruction = instructions->Get(step_state_.instr_idx);
   size_t next_instr_idx = step_state_.instr_idx + 1;
   Error err = Error::Ok;
 
-  switch (instruction->instr_args_type()) {
-    case executorch_flatbuffer::InstructionArguments::KernelCall: {
+  switch (instruction.type) {
+    case Instruction::Type::KernelCall: {
       EXECUTORCH_SCOPE_PROF("OPERATOR_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "OPERATOR_CALL");
       // TODO(T147221312): Also expose tensor resizer via the context.
-      KernelRuntimeContext context(event_tracer_, temp_allocator_);
-      auto args = chain.argument_lists_[step_state_.instr_idx];
-      chain.kernels_[step_state_.instr_idx](context, args.data());
+      KernelRuntimeContext context(
+          event_tracer_,
+          temp_allocator_,
+          chain.scratch_ != nullptr ? chain.scratch_[step_state_.instr_idx]
+                                    : Span<uint8_t>());
+      auto args = instruction.args;
+      instruction.kernel(context, args.data());
       // We reset the temp_allocator after the switch statement
       err = context.failure_state();
       if (err != Error::Ok) {
         // We know that instr_args_as_KernelCall is non-null because it was
         // checked at init time.
-        auto op_index = instruction->instr_args_as_KernelCall()->op_index();
+        auto op_index = chain.s_chain_->instructions()
+                            ->Get(step_state_.instr_idx)
+                            ->instr_args_as_KernelCall()
+                            ->op_index();
         ET_UNUSED auto op = serialization_plan_->operators()->Get(op_index);
         ET_LOG(
             Error,
@@ -1321,29 +2857,66 @@ Error Method::execute_instruction() {
         // little slow. Do the same for DelegateCall errors.
       }
     } break;
-    case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+    case Instruction::Type::DelegateCall: {
       EXECUTORCH_SCOPE_PROF("DELEGATE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "DELEGATE_CALL");
-      // We know that instr_args_as_DelegateCall is non-null because it was
-      // checked at init time.
-      auto delegate_idx =
-          instruction->instr_args_as_DelegateCall()->delegate_index();
-      ET_CHECK_OR_RETURN_ERROR(
-          static_cast<size_t>(delegate_idx) < n_delegate_,
-          Internal,
-          "DELEGATE_CALL index %" PRIu32 " >= num delegates %" ET_PRIsize_t
-          " at instruction %" ET_PRIsize_t,
-          delegate_idx,
-          n_delegate_,
-          step_state_.instr_idx);
+      // Let the delegate keep its outputs on the device, and see the inputs
+      // that earlier calls to the same backend left there. Not when the
+      // outputs are about to be logged.
+      Span<DeviceBuffer*> device_buffers;
+      const size_t num_args = instruction.args.size();
+      if (event_tracer_ == nullptr && num_args > 0) {
+        DeviceBuffer** buffers =
+            temp_allocator_->allocateList<DeviceBuffer*>(num_args);
+        if (buffers != nullptr) {
+          for (size_t i = 0; i < num_args; ++i) {
+            buffers[i] = nullptr;
+            for (size_t j = 0; j < n_device_values_; ++j) {
+              if (device_values_[j].value == instruction.args[i] &&
+                  device_values_[j].backend ==
+                      instruction.delegate->backend()) {
+                buffers[i] = device_values_[j].buffer;
+              }
+            }
+          }
+          device_buffers = Span<DeviceBuffer*>(buffers, num_args);
+        }
+      }
       BackendExecutionContext backend_execution_context(
           /*event_tracer=*/event_tracer_,
           /*temp_allocator=*/temp_allocator_,
-          /*method_name=*/serialization_plan_->name()->c_str());
-      err = delegates_[delegate_idx].Execute(
-          backend_execution_context,
-          chain.argument_lists_[step_state_.instr_idx].data());
+          /*method_name=*/serialization_plan_->name()->c_str(),
+          /*device_buffers=*/device_buffers);
+      err = instruction.delegate->ExecuteAsync(
+          backend_execution_context, instruction.args.data());
+      BackendCompletion* completion =
+          backend_execution_context.get_completion();
+      if (completion != nullptr) {
+        // Wait right away if the outputs are about to be logged, or if the
+        // constant resolver may release the data that the delegate reads.
+        if (err != Error::Ok || event_tracer_ != nullptr ||
+            constant_resolver_ != nullptr) {
+          Error wait_err = completion->wait();
+          if (err == Error::Ok) {
+            err = wait_err;
+          }
+        } else {
+          if (n_pending_delegate_calls_ == kMaxPendingDelegateCalls) {
+            err = pending_delegate_calls_[0].completion->wait();
+            for (size_t i = 1; i < n_pending_delegate_calls_; ++i) {
+              pending_delegate_calls_[i - 1] = pending_delegate_calls_[i];
+            }
+            --n_pending_delegate_calls_;
+          }
+          pending_delegate_calls_[n_pending_delegate_calls_++] =
+              PendingDelegateCall{
+                  instruction.delegate, completion, instruction.args};
+        }
+      }
+      if (err == Error::Ok && device_buffers.size() > 0) {
+        err = record_device_values(instruction, device_buffers);
+      }
       if (err != Error::Ok) {
         ET_LOG(
             Error,
@@ -1359,57 +2932,49 @@ Error Method::execute_instruction() {
       // log everything. This will be changed in the future when the inputs and
       // ouputs are separate lists.
 #ifdef ET_EVENT_TRACER_ENABLED
-      for (size_t i = 0;
-           i < chain.argument_lists_[step_state_.instr_idx].size();
-           i++) {
-        EValue* arg = chain.argument_lists_[step_state_.instr_idx].data()[i];
+      for (size_t i = 0; i < instruction.args.size(); i++) {
+        EValue* arg = instruction.args.data()[i];
         internal::event_tracer_log_evalue(event_tracer_, *arg);
       }
 #endif
     } break;
-    case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
+    case Instruction::Type::JumpFalseCall: {
       EXECUTORCH_SCOPE_PROF("JF_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "JF_CALL");
-      // We know that instr_args_as_JumpFalseCall is non-null because it was
-      // checked at init time.
-      auto jf_call = instruction->instr_args_as_JumpFalseCall();
-      // We know that index is a valid values_ index because it was checked at
-      // init time.
-      auto index = jf_call->cond_value_index();
-      Result<bool> jf_result = parse_cond_value(values_[index]);
+      // The cond value was validated at init time.
+      Result<bool> jf_result =
+          parse_cond_value(*instruction.jump_false.cond_value);
       if (jf_result.ok()) {
         if (!jf_result.get()) {
-          next_instr_idx = jf_call->destination_instruction();
+          next_instr_idx = instruction.jump_false.destination_instruction;
         }
       } else {
         err = jf_result.error();
       }
     } break;
-    case executorch_flatbuffer::InstructionArguments::MoveCall: {
+    case Instruction::Type::MoveCall: {
       EXECUTORCH_SCOPE_PROF("MOVE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "MOVE_CALL");
-      // We know that instr_args_as_MoveCall is non-null because it was checked
-      // at init time.
-      auto move_call = instruction->instr_args_as_MoveCall();
-      mutable_value(move_call->move_to()) = get_value(move_call->move_from());
+      // The move indices were validated at init time.
+      *instruction.move.to = *instruction.move.from;
     } break;
-    case executorch_flatbuffer::InstructionArguments::FreeCall: {
+    case Instruction::Type::FreeCall: {
       EXECUTORCH_SCOPE_PROF("FREE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "FREE_CALL");
-      // We know that instr_args_as_FreeCall is non-null because it was checked
-      // at init time.
-      auto free_call = instruction->instr_args_as_FreeCall();
-      auto t = values_[free_call->value_index()].toTensor();
+      // The value index was validated at init time.
+      auto t = instruction.free_value->toTensor();
       internal::reset_data_ptr(t);
     } break;
     default:
       ET_LOG(
           Error,
           "Unknown instruction: %hhu",
-          static_cast<uint8_t>(instruction->instr_args_type()));
+          static_cast<uint8_t>(chain.s_chain_->instructions()
+                                   ->Get(step_state_.instr_idx)
+                                   ->instr_args_type()));
       err = Error::InvalidProgram;
   }
   // Reset the temp allocator for every instruction.
@@ -1422,6 +2987,709 @@ Error Method::execute_instruction() {
   return err;
 }
 
+Error Method::execute_instruction_wave(size_t end) {
+  auto& chain = chains_[step_state_.chain_idx];
+  const size_t begin = step_state_.instr_idx;
+  const size_t num_tasks = end - begin;
+  ET_CHECK_OR_RETURN_ERROR(
+      begin < end && end <= chain.instructions_.size() &&
+          num_tasks <= kMaxWaveSize,
+      Internal,
+      "Invalid wave [%" ET_PRIsize_t ", %" ET_PRIsize_t
+      ") in chain %" ET_PRIsize_t,
+      begin,
+      end,
+      step_state_.chain_idx);
+
+  if (n_pending_delegate_calls_ > 0) {
+    for (size_t i = begin; i < end; ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          wait_for_delegate_calls(&chain.instructions_[i]));
+    }
+  }
+  // Delegates in a wave can't use device data.
+  if (n_device_values_ > 0) {
+    for (size_t i = begin; i < end; ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(materialize_device_values(
+          &chain.instructions_[i], /*keep_for_delegate=*/false));
+    }
+  }
+
+  // Each task gets its own temp allocator, since the shared temp_allocator_ is
+  // not thread-safe.
+  PlatformMemoryAllocator temp_allocators[kMaxWaveSize];
+  Error errors[kMaxWaveSize];
+  WaveContext context{
+      &chain.instructions_[begin],
+      temp_allocators,
+      errors,
+      serialization_plan_->name()->c_str(),
+  };
+  task_runner_->run(run_wave_task, &context, num_tasks);
+
+  for (size_t i = 0; i < num_tasks; ++i) {
+    if (errors[i] != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Parallel instruction %" ET_PRIsize_t ":%" ET_PRIsize_t
+          " failed: 0x%" PRIx32,
+          step_state_.chain_idx,
+          begin + i,
+          static_cast<uint32_t>(errors[i]));
+      return errors[i];
+    }
+  }
+  step_state_.instr_idx = end;
+  return Error::Ok;
+}
+
+Error Method::wait_for_delegate_calls(const Instruction* instruction) {
+  Error first_err = Error::Ok;
+  size_t num_kept = 0;
+  for (size_t i = 0; i < n_pending_delegate_calls_; ++i) {
+    const PendingDelegateCall& pending = pending_delegate_calls_[i];
+    bool depends = true;
+    if (instruction != nullptr) {
+      switch (instruction->type) {
+        case Instruction::Type::KernelCall:
+          depends = args_overlap(
+              instruction->args,
+              pending.args,
+              values_,
+              serialization_plan_->values());
+          break;
+        case Instruction::Type::DelegateCall:
+          // A backend handle only runs one call at a time.
+          depends = instruction->delegate == pending.delegate ||
+              args_overlap(
+                  instruction->args,
+                  pending.args,
+                  values_,
+                  serialization_plan_->values());
+          break;
+        default:
+          // Control flow and value moves: keep it simple and wait.
+          break;
+      }
+    }
+    if (!depends) {
+      pending_delegate_calls_[num_kept++] = pending;
+      continue;
+    }
+    Error err = pending.completion->wait();
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Asynchronous delegate call failed: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+      if (first_err == Error::Ok) {
+        first_err = err;
+      }
+    }
+  }
+  n_pending_delegate_calls_ = num_kept;
+  return first_err;
+}
+
+Error Method::materialize_device_values(
+    const Instruction* instruction,
+    bool keep_for_delegate) {
+  Error first_err = Error::Ok;
+  size_t num_kept = 0;
+  for (size_t i = 0; i < n_device_values_; ++i) {
+    DeviceResidentValue& entry = device_values_[i];
+    bool materialize = true;
+    if (instruction != nullptr) {
+      materialize = args_overlap(
+          instruction->args,
+          InstructionArgs(&entry.value, 1),
+          values_,
+          serialization_plan_->values());
+      if (materialize && keep_for_delegate &&
+          instruction->type == Instruction::Type::DelegateCall &&
+          instruction->delegate->backend() == entry.backend) {
+        // The delegate gets the device data of its own arguments.
+        for (size_t j = 0; j < instruction->args.size(); ++j) {
+          if (instruction->args[j] == entry.value) {
+            materialize = false;
+          }
+        }
+      }
+    }
+    if (!materialize) {
+      device_values_[num_kept++] = entry;
+      continue;
+    }
+    auto tensor = entry.value->toTensor();
+    void* host_data = tensor.mutable_data_ptr();
+    Error err = host_data != nullptr
+        ? entry.buffer->copy_to_host(host_data, tensor.nbytes())
+        : Error::InvalidState;
+    entry.buffer->release();
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to copy device data to the host: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+      if (first_err == Error::Ok) {
+        first_err = err;
+      }
+    }
+  }
+  n_device_values_ = num_kept;
+  return first_err;
+}
+
+Error Method::record_device_values(
+    const Instruction& instruction,
+    Span<DeviceBuffer*> device_buffers) {
+  for (size_t i = 0; i < device_buffers.size(); ++i) {
+    EValue* value = instruction.args[i];
+    DeviceBuffer* buffer = device_buffers[i];
+    size_t entry_idx = n_device_values_;
+    for (size_t j = 0; j < n_device_values_; ++j) {
+      if (device_values_[j].value == value) {
+        entry_idx = j;
+      }
+    }
+    const bool tracked = entry_idx < n_device_values_;
+    if (tracked ? device_values_[entry_idx].buffer == buffer
+                : buffer == nullptr) {
+      // Untouched.
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        buffer == nullptr || value->isTensor(),
+        InvalidArgument,
+        "Delegate arg %" ET_PRIsize_t " is not a tensor, but was left on the "
+        "device",
+        i);
+    if (tracked) {
+      device_values_[entry_idx].buffer->release();
+      if (buffer != nullptr) {
+        device_values_[entry_idx].buffer = buffer;
+      } else {
+        device_values_[entry_idx] = device_values_[--n_device_values_];
+      }
+    } else if (n_device_values_ < kMaxDeviceResidentValues) {
+      device_values_[n_device_values_++] =
+          DeviceResidentValue{value, instruction.delegate->backend(), buffer};
+    } else {
+      // No room to track it: copy it to the host right away.
+      ET_CHECK_OK_OR_RETURN_ERROR(wait_for_delegate_calls(&instruction));
+      auto tensor = value->toTensor();
+      void* host_data = tensor.mutable_data_ptr();
+      Error err = host_data != nullptr
+          ? buffer->copy_to_host(host_data, tensor.nbytes())
+          : Error::InvalidState;
+      buffer->release();
+      ET_CHECK_OK_OR_RETURN_ERROR(err);
+    }
+  }
+  return Error::Ok;
+}
+
+void Method::release_device_values() {
+  for (size_t i = 0; i < n_device_values_; ++i) {
+    device_values_[i].buffer->release();
+  }
+  n_device_values_ = 0;
+}
+
+Error Method::build_parallel_schedule() {
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto* s_values = serialization_plan_->values();
+
+  // Values that are defined when a chain starts: method inputs and constant
+  // tensors. The first instruction that references any other value produces
+  // it.
+  bool* defined = temp_allocator_->allocateList<bool>(n_value_);
+  if (defined == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto* s_value = s_values->Get(i);
+    const auto* s_tensor =
+        s_value->val_type() == executorch_flatbuffer::KernelTypes::Tensor
+        ? s_value->val_as_Tensor()
+        : nullptr;
+    defined[i] = s_tensor != nullptr &&
+        s_tensor->allocation_info() == nullptr &&
+        values_[i].toTensor().const_data_ptr() != nullptr;
+  }
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    defined[get_input_index(i)] = true;
+  }
+
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    Chain& chain = chains_[chain_idx];
+    const size_t num_instructions = chain.instructions_.size();
+    uint32_t* wave_ends =
+        method_allocator->allocateList<uint32_t>(num_instructions);
+    bool* jump_target = temp_allocator_->allocateList<bool>(num_instructions);
+    if (wave_ends == nullptr || jump_target == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    for (size_t i = 0; i < num_instructions; ++i) {
+      wave_ends[i] = static_cast<uint32_t>(i + 1);
+      jump_target[i] = false;
+    }
+    // Execution can land on a jump destination, so one must start a wave.
+    for (const auto& instruction : chain.instructions_) {
+      if (instruction.type == Instruction::Type::JumpFalseCall) {
+        const size_t dest = instruction.jump_false.destination_instruction;
+        if (dest < num_instructions) {
+          jump_target[dest] = true;
+        }
+      }
+    }
+
+    InstructionAccess wave[kMaxWaveSize];
+    size_t wave_size = 0;
+    size_t wave_begin = 0;
+    for (size_t instr_idx = 0; instr_idx < num_instructions; ++instr_idx) {
+      const Instruction& instruction = chain.instructions_[instr_idx];
+      bool parallelizable =
+          instruction.type == Instruction::Type::DelegateCall;
+      if (instruction.type == Instruction::Type::KernelCall) {
+        // Prim ops are cheap, and some of them mutate their first argument,
+        // so don't bother running them concurrently.
+        const auto op_index = chain.s_chain_->instructions()
+                                  ->Get(instr_idx)
+                                  ->instr_args_as_KernelCall()
+                                  ->op_index();
+        const char* op_name =
+            serialization_plan_->operators()->Get(op_index)->name()->c_str();
+        parallelizable = strncmp(op_name, "executorch_prim::", 17) != 0;
+      }
+
+      InstructionAccess access{nullptr, 0};
+      if (parallelizable) {
+        const InstructionArgs& args = instruction.args;
+        size_t num_ranges = 0;
+        for (size_t i = 0; i < args.size(); ++i) {
+          num_ranges += num_access_ranges(*args[i]);
+        }
+        AccessRange* ranges =
+            temp_allocator_->allocateList<AccessRange>(num_ranges);
+        if (ranges == nullptr && num_ranges > 0) {
+          return Error::MemoryAllocationFailed;
+        }
+        AccessRange* out = ranges;
+        for (size_t i = 0; i < args.size(); ++i) {
+          const size_t value_idx = args[i] - values_;
+          const bool write = i + 1 == args.size() || !defined[value_idx];
+          out = append_access_ranges(
+              *args[i], values_, serialization_plan_->values(), write, out);
+        }
+        access = InstructionAccess{ranges, num_ranges};
+      }
+
+      bool starts_new_wave = !parallelizable || jump_target[instr_idx] ||
+          wave_size == kMaxWaveSize;
+      for (size_t i = 0; i < wave_size && !starts_new_wave; ++i) {
+        starts_new_wave = accesses_conflict(wave[i], access);
+      }
+      if (starts_new_wave) {
+        wave_ends[wave_begin] = static_cast<uint32_t>(instr_idx);
+        wave_begin = instr_idx;
+        wave_size = 0;
+      }
+      if (parallelizable) {
+        wave[wave_size++] = access;
+      } else {
+        // Always runs alone; the next instruction starts a new wave.
+        wave_ends[instr_idx] = static_cast<uint32_t>(instr_idx + 1);
+        wave_begin = instr_idx + 1;
+      }
+      for (size_t i = 0; i < instruction.args.size(); ++i) {
+        defined[instruction.args[i] - values_] = true;
+      }
+    }
+    if (wave_begin < num_instructions) {
+      wave_ends[wave_begin] = static_cast<uint32_t>(num_instructions);
+    }
+    chain.wave_ends_ = wave_ends;
+  }
+  temp_allocator_->reset();
+  return Error::Ok;
+}
+
+Error Method::set_parallel_execution(ParallelTaskRunner* runner) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot enable parallel execution until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Cannot change parallel execution mid execution.");
+  if (runner == nullptr) {
+    task_runner_ = nullptr;
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      event_tracer_ == nullptr,
+      NotSupported,
+      "Parallel execution does not support event tracing.");
+  if (chains_[0].wave_ends_ == nullptr) {
+    Error err = build_parallel_schedule();
+    if (err != Error::Ok) {
+      temp_allocator_->reset();
+      return err;
+    }
+  }
+  task_runner_ = runner;
+  return Error::Ok;
+}
+
+size_t Method::num_instructions() const {
+  size_t count = 0;
+  for (size_t i = 0; i < n_chains_; ++i) {
+    count += chains_[i].instructions_.size();
+  }
+  return count;
+}
+
+Error Method::get_planned_memory_usage(
+    size_t buffer_index,
+    Span<size_t> live_bytes) const {
+  Error err = compute_planned_memory_usage(buffer_index, live_bytes);
+  temp_allocator_->reset();
+  return err;
+}
+
+Error Method::compute_planned_memory_usage(
+    size_t buffer_index,
+    Span<size_t> live_bytes) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot compute memory usage until method has been initialized.");
+  const auto* buffer_sizes = serialization_plan_->non_const_buffer_sizes();
+  // Entry 0 of non_const_buffer_sizes is reserved; see MethodMeta.
+  const size_t num_buffers =
+      buffer_sizes == nullptr || buffer_sizes->size() == 0
+      ? 0
+      : buffer_sizes->size() - 1;
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer_index < num_buffers,
+      InvalidArgument,
+      "Buffer index %" ET_PRIsize_t " >= %" ET_PRIsize_t,
+      buffer_index,
+      num_buffers);
+  const size_t n_instructions = num_instructions();
+  ET_CHECK_OR_RETURN_ERROR(
+      live_bytes.size() >= n_instructions,
+      InvalidArgument,
+      "live_bytes has %" ET_PRIsize_t " entries, need %" ET_PRIsize_t,
+      live_bytes.size(),
+      n_instructions);
+  if (n_instructions == 0) {
+    // Nothing executes, so there is no instruction to attribute memory to.
+    return Error::Ok;
+  }
+
+  PlannedTensorUse* uses =
+      temp_allocator_->allocateList<PlannedTensorUse>(n_value_);
+  if (uses == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  const auto* s_values = serialization_plan_->values();
+  for (size_t i = 0; i < n_value_; ++i) {
+    uses[i] = PlannedTensorUse{0, 0, -1, -1};
+  }
+
+  // Instructions are numbered in execution order across chains. Inputs are
+  // live from the start, and outputs until the end.
+  const int64_t last_instruction = static_cast<int64_t>(n_instructions) - 1;
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    mark_value_use(s_values, get_input_index(i), 0, uses);
+  }
+  for (size_t i = 0; i < outputs_size(); ++i) {
+    mark_value_use(s_values, get_output_index(i), last_instruction, uses);
+  }
+  int64_t instr_idx = 0;
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    for (const auto& instruction : chains_[chain_idx].instructions_) {
+      auto mark = [&](const EValue* value) {
+        mark_value_use(
+            s_values, static_cast<size_t>(value - values_), instr_idx, uses);
+      };
+      switch (instruction.type) {
+        case Instruction::Type::KernelCall:
+        case Instruction::Type::DelegateCall:
+          for (size_t i = 0; i < instruction.args.size(); ++i) {
+            mark(instruction.args[i]);
+          }
+          break;
+        case Instruction::Type::JumpFalseCall:
+          mark(instruction.jump_false.cond_value);
+          break;
+        case Instruction::Type::MoveCall:
+          mark(instruction.move.from);
+          mark(instruction.move.to);
+          break;
+        case Instruction::Type::FreeCall:
+          mark(instruction.free_value);
+          break;
+        default:
+          break;
+      }
+      ++instr_idx;
+    }
+  }
+
+  // Find the planned tensors in this buffer. Tensors that the planner placed
+  // at the same offset alias each other, so count them once, over the union
+  // of their lifetimes.
+  const uint32_t memory_id = static_cast<uint32_t>(buffer_index) + 1;
+  for (size_t i = 0; i < n_value_; ++i) {
+    PlannedTensorUse& use = uses[i];
+    const auto* s_value = s_values->Get(i);
+    const auto* s_tensor =
+        s_value->val_type() == executorch_flatbuffer::KernelTypes::Tensor
+        ? s_value->val_as_Tensor()
+        : nullptr;
+    const auto* allocation_info =
+        s_tensor != nullptr ? s_tensor->allocation_info() : nullptr;
+    if (allocation_info == nullptr ||
+        allocation_info->memory_id() != memory_id || use.first < 0) {
+      use.first = -1;
+      continue;
+    }
+    use.offset = planned_offset(allocation_info);
+    use.nbytes = planned_capacity(s_tensor);
+    for (size_t j = 0; j < i; ++j) {
+      PlannedTensorUse& other = uses[j];
+      if (other.first >= 0 && other.offset == use.offset) {
+        other.first = std::min(other.first, use.first);
+        other.last = std::max(other.last, use.last);
+        other.nbytes = std::max(other.nbytes, use.nbytes);
+        use.first = -1;
+        break;
+      }
+    }
+  }
+
+  // Accumulate the lifetimes as a difference array, then integrate it.
+  // Unsigned wraparound makes the subtractions safe.
+  for (size_t i = 0; i < n_instructions; ++i) {
+    live_bytes[i] = 0;
+  }
+  for (size_t i = 0; i < n_value_; ++i) {
+    const PlannedTensorUse& use = uses[i];
+    if (use.first < 0) {
+      continue;
+    }
+    live_bytes[use.first] += use.nbytes;
+    if (use.last < last_instruction) {
+      live_bytes[use.last + 1] -= use.nbytes;
+    }
+  }
+  for (size_t i = 1; i < n_instructions; ++i) {
+    live_bytes[i] += live_bytes[i - 1];
+  }
+  return Error::Ok;
+}
+
+Error Method::log_planned_memory_usage() {
+  ET_CHECK_OR_RETURN_ERROR(
+      event_tracer_ != nullptr,
+      InvalidState,
+      "Logging memory usage requires an event tracer.");
+  const size_t n_instructions = num_instructions();
+  const size_t num_buffers = method_meta().num_memory_planned_buffers();
+  for (size_t buffer_index = 0; buffer_index < num_buffers; ++buffer_index) {
+    size_t* live_bytes = temp_allocator_->allocateList<size_t>(n_instructions);
+    ET_CHECK_OR_RETURN_ERROR(
+        live_bytes != nullptr || n_instructions == 0,
+        MemoryAllocationFailed,
+        "Failed to allocate %" ET_PRIsize_t " entries",
+        n_instructions);
+    Error err = compute_planned_memory_usage(
+        buffer_index, Span<size_t>(live_bytes, n_instructions));
+    if (err != Error::Ok) {
+      temp_allocator_->reset();
+      return err;
+    }
+    char name[64];
+    snprintf(
+        name,
+        sizeof(name),
+        "%s.planned_buffer_%" ET_PRIsize_t,
+        serialization_plan_->name()->c_str(),
+        buffer_index);
+    AllocatorID id =
+        internal::event_tracer_track_allocator(event_tracer_, name);
+    for (size_t i = 0; i < n_instructions; ++i) {
+      internal::event_tracer_track_allocation(
+          event_tracer_, id, live_bytes[i]);
+    }
+    temp_allocator_->reset();
+  }
+  return Error::Ok;
+}
+
+Error Method::log_pal_allocator_usage() {
+  ET_CHECK_OR_RETURN_ERROR(
+      event_tracer_ != nullptr,
+      InvalidState,
+      "Logging allocator usage requires an event tracer.");
+  et_pal_allocator_stats_t stats;
+  et_pal_get_allocator_stats(&stats);
+  AllocatorID id =
+      internal::event_tracer_track_allocator(event_tracer_, "pal_allocator");
+  internal::event_tracer_track_allocation(event_tracer_, id, stats.live_bytes);
+  internal::event_tracer_track_allocation(
+      event_tracer_, id, stats.peak_live_bytes);
+  internal::event_tracer_track_allocation(
+      event_tracer_, id, stats.cached_bytes);
+  return Error::Ok;
+}
+
+struct Method::ShapeCache {
+  /// Indices into values_ of the dynamically-shaped tensors.
+  size_t* value_indices;
+  /// Whether each of those tensors is an input of the method.
+  bool* is_input;
+  size_t num_tensors;
+  /// The total rank of the tensors, which is the length of an entry.
+  size_t entry_size;
+  /// Room for `allocated` entries, each holding the sizes of every tensor.
+  executorch::aten::SizesType* entries;
+  size_t allocated;
+  size_t capacity;
+  size_t num_entries;
+  /// The entry to replace next once the cache is full.
+  size_t oldest;
+  /// The entry that matched the running execution, or `capacity` if none.
+  size_t current;
+};
+
+Error Method::enable_shape_cache(size_t max_entries) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot enable the shape cache until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Cannot change the shape cache mid execution.");
+  if (max_entries == 0) {
+    shape_cache_ = nullptr;
+    return Error::Ok;
+  }
+
+  if (shape_cache_ == nullptr || shape_cache_->allocated < max_entries) {
+    MemoryAllocator* allocator = memory_manager_->method_allocator();
+    const auto* s_values = serialization_plan_->values();
+    auto is_dynamic_tensor = [s_values](size_t i) {
+      const auto* s_value = s_values->Get(i);
+      return s_value->val_type() ==
+          executorch_flatbuffer::KernelTypes::Tensor &&
+          s_value->val_as_Tensor()->shape_dynamism() !=
+          executorch_flatbuffer::TensorShapeDynamism::STATIC;
+    };
+    size_t num_tensors = 0;
+    size_t entry_size = 0;
+    for (size_t i = 0; i < n_value_; ++i) {
+      if (is_dynamic_tensor(i)) {
+        num_tensors++;
+        entry_size += values_[i].toTensor().dim();
+      }
+    }
+    ShapeCache* cache = allocator->allocateInstance<ShapeCache>();
+    size_t* value_indices = allocator->allocateList<size_t>(num_tensors);
+    bool* is_input = allocator->allocateList<bool>(num_tensors);
+    auto* entries = allocator->allocateList<executorch::aten::SizesType>(
+        entry_size * max_entries);
+    ET_CHECK_OR_RETURN_ERROR(
+        cache != nullptr &&
+            ((value_indices != nullptr && is_input != nullptr) ||
+             num_tensors == 0) &&
+            (entries != nullptr || entry_size == 0),
+        MemoryAllocationFailed,
+        "Failed to allocate shape cache for %" ET_PRIsize_t " tensors",
+        num_tensors);
+    size_t t = 0;
+    for (size_t i = 0; i < n_value_; ++i) {
+      if (is_dynamic_tensor(i)) {
+        value_indices[t] = i;
+        is_input[t] = false;
+        for (size_t j = 0; j < inputs_size(); ++j) {
+          is_input[t] = is_input[t] || get_input_index(j) == i;
+        }
+        t++;
+      }
+    }
+    cache->value_indices = value_indices;
+    cache->is_input = is_input;
+    cache->num_tensors = num_tensors;
+    cache->entry_size = entry_size;
+    cache->entries = entries;
+    cache->allocated = max_entries;
+    shape_cache_ = cache;
+  }
+  shape_cache_->capacity = max_entries;
+  shape_cache_->num_entries = 0;
+  shape_cache_->oldest = 0;
+  shape_cache_->current = max_entries;
+  return Error::Ok;
+}
+
+Error Method::apply_cached_shapes() {
+  ShapeCache& cache = *shape_cache_;
+  cache.current = cache.capacity;
+  for (size_t e = 0; e < cache.num_entries; ++e) {
+    const auto* entry = cache.entries + e * cache.entry_size;
+    const auto* sizes = entry;
+    bool match = true;
+    for (size_t t = 0; t < cache.num_tensors && match; ++t) {
+      const auto tensor_sizes =
+          values_[cache.value_indices[t]].toTensor().sizes();
+      match = !cache.is_input[t] ||
+          std::equal(tensor_sizes.begin(), tensor_sizes.end(), sizes);
+      sizes += tensor_sizes.size();
+    }
+    if (!match) {
+      continue;
+    }
+    cache.current = e;
+    sizes = entry;
+    for (size_t t = 0; t < cache.num_tensors; ++t) {
+      auto& tensor = values_[cache.value_indices[t]].toTensor();
+      const size_t dim = tensor.dim();
+      if (!cache.is_input[t]) {
+        ET_CHECK_OK_OR_RETURN_ERROR(resize_tensor(tensor, {sizes, dim}));
+      }
+      sizes += dim;
+    }
+    return Error::Ok;
+  }
+  return Error::Ok;
+}
+
+void Method::record_shapes() {
+  ShapeCache& cache = *shape_cache_;
+  size_t slot = cache.current;
+  if (slot == cache.capacity) {
+    if (cache.num_entries < cache.capacity) {
+      slot = cache.num_entries++;
+    } else {
+      slot = cache.oldest;
+      cache.oldest = (cache.oldest + 1) % cache.capacity;
+    }
+  }
+  // Sizes are saved even on a hit, in case data-dependent shapes changed.
+  auto* sizes = cache.entries + slot * cache.entry_size;
+  for (size_t t = 0; t < cache.num_tensors; ++t) {
+    const auto tensor_sizes =
+        values_[cache.value_indices[t]].toTensor().sizes();
+    sizes = std::copy(tensor_sizes.begin(), tensor_sizes.end(), sizes);
+  }
+}
+
 Error Method::reset_execution() {
   ET_CHECK_OR_RETURN_ERROR(
       step_state_.chain_idx == n_chains_,
@@ -1472,8 +3740,7 @@ Error Method::step() {
     return Error::EndOfMethod;
   }
 
-  auto num_instructions =
-      chains_[step_state_.chain_idx].s_chain_->instructions()->size();
+  auto num_instructions = chains_[step_state_.chain_idx].instructions_.size();
 
   // Special case chains with no instructions. These appear for example in a
   // model that just returns the input/a constant.
@@ -1483,7 +3750,17 @@ Error Method::step() {
   }
 
   auto status = execute_instruction();
+  if (status == Error::Ok && step_state_.instr_idx == num_instructions) {
+    // The outputs of the chain must be ready when it ends.
+    status = wait_for_delegate_calls(/*instruction=*/nullptr);
+    if (status == Error::Ok) {
+      status = materialize_device_values(
+          /*instruction=*/nullptr, /*keep_for_delegate=*/false);
+    }
+  }
   if (status != Error::Ok) {
+    (void)wait_for_delegate_calls(/*instruction=*/nullptr);
+    release_device_values();
     return status;
   }
 
@@ -1511,22 +3788,20 @@ Error Method::execute() {
       initialized(),
       NotSupported,
       "Cannot execute until method has been initialized.");
+  if (shape_cache_ != nullptr) {
+    ET_CHECK_OK_OR_RETURN_ERROR(apply_cached_shapes());
+  }
 
   // Chains are executed sequentially today, but future async designs may
   // branch and run many in parallel or out of order.
   for (step_state_.chain_idx = 0; step_state_.chain_idx < n_chains_;
        ++step_state_.chain_idx) {
-    Chain& chain = chains_[step_state_.chain_idx];
-    auto instructions = chain.s_chain_->instructions();
-    ET_CHECK_OR_RETURN_ERROR(
-        instructions != nullptr,
-        Internal,
-        "chain %" ET_PRIsize_t " has no instructions field",
-        step_state_.chain_idx);
+    const Chain& chain = chains_[step_state_.chain_idx];
+    const size_t num_instructions = chain.instructions_.size();
 
     // Loop over instructions
     step_state_.instr_idx = 0;
-    while (step_state_.instr_idx < chain.s_chain_->instructions()->size()) {
+    while (step_state_.instr_idx < num_instructions) {
       EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
           static_cast<int32_t>(step_state_.chain_idx),
           static_cast<uint32_t>(step_state_.instr_idx));
@@ -1535,13 +3810,37 @@ Error Method::execute() {
               event_tracer_,
               static_cast<ChainID>(step_state_.chain_idx),
               static_cast<DebugHandle>(step_state_.instr_idx));
-      auto status = execute_instruction();
+      Error status = Error::Ok;
+      if (task_runner_ != nullptr && constant_resolver_ == nullptr &&
+          chain.wave_ends_[step_state_.instr_idx] >
+              step_state_.instr_idx + 1) {
+        status = execute_instruction_wave(
+            chain.wave_ends_[step_state_.instr_idx]);
+      } else {
+        status = execute_instruction();
+      }
       if (status != Error::Ok) {
+        // Don't leave delegates writing to memory after returning.
+        (void)wait_for_delegate_calls(/*instruction=*/nullptr);
+        release_device_values();
         return status;
       }
     }
+    // The outputs of the chain must be ready when it ends.
+    Error status = wait_for_delegate_calls(/*instruction=*/nullptr);
+    if (status == Error::Ok) {
+      status = materialize_device_values(
+          /*instruction=*/nullptr, /*keep_for_delegate=*/false);
+    }
+    if (status != Error::Ok) {
+      release_device_values();
+      return status;
+    }
   }
   internal::event_tracer_end_profiling_event(event_tracer_, event_tracer_entry);
+  if (shape_cache_ != nullptr) {
+    record_shapes();
+  }
   log_outputs();
 
   // TODO(jakeszwe, dbort): Decide on calling execute back to back without
@@ -1591,6 +3890,7 @@ const EValue& Method::get_input(size_t i) const {
 }
 
 EValue& Method::mutable_input(size_t i) {
+  invalidate_tensor_lists();
   return mutable_value(get_input_index(i));
 }
 
@@ -1613,14 +3913,29 @@ const EValue& Method::get_output(size_t i) const {
 }
 
 EValue& Method::mutable_output(size_t i) {
+  invalidate_tensor_lists();
   return mutable_value(get_output_index(i));
 }
 
+void Method::invalidate_tensor_lists() {
+  for (size_t i = 0; i < n_io_tensor_lists_; ++i) {
+    EValue& value = values_[io_tensor_lists_[i]];
+    if (value.isTensorList()) {
+      value.payload.copyable_union.as_tensor_list.invalidate();
+    } else {
+      value.payload.copyable_union.as_list_optional_tensor.invalidate();
+    }
+  }
+}
+
 EventTracer* Method::get_event_tracer() {
   return event_tracer_;
 }
 
 Method::~Method() {
+  // Delegates that are still running must not outlive the memory they use.
+  (void)wait_for_delegate_calls(/*instruction=*/nullptr);
+  release_device_values();
   // Destroy the values. It's necessary in ATen mode, where the refcount of
   // Tensors needs to be decremented properly.
   if (values_ != nullptr) {
@@ -1634,6 +3949,13 @@ Method::~Method() {
       delegates_[i].~BackendDelegate();
     }
   }
+  // Only after the delegates, which may still use the memory they allocated
+  // from these during init.
+  if (delegate_init_allocators_ != nullptr) {
+    for (size_t i = 0; i < n_delegate_; i++) {
+      delegate_init_allocators_[i].~PlatformMemoryAllocator();
+    }
+  }
   // Free resources associated with external constants.
   for (const auto i : c10::irange(n_external_constants_)) {
     external_constants_[i].buffer.~FreeableBuffer();
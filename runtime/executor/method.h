@@ -19,8 +19,10 @@
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/external_constant_resolver.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method_meta.h>
+#include <executorch/runtime/executor/parallel_task_runner.h>
 #include <executorch/runtime/platform/compiler.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
@@ -44,10 +46,18 @@ struct NamedData;
 class Program;
 
 // Forward declare internal types.
+class BackendCompletion;
 class BackendDelegate;
+class BackendInterface;
 struct Chain;
+class DeviceBuffer;
+namespace internal {
+class PlatformMemoryAllocator;
+} // namespace internal
+struct Instruction;
 class KernelRuntimeContext;
 using OpFunction = void (*)(KernelRuntimeContext&, EValue**);
+using ScratchSizeFunction = size_t (*)(EValue**);
 /// A list of pointers into the master values table that together compose the
 /// argument list for a single instruction
 using InstructionArgs = Span<EValue*>;
@@ -74,17 +84,34 @@ class Method final {
         values_(rhs.values_),
         n_delegate_(rhs.n_delegate_),
         delegates_(rhs.delegates_),
+        delegate_init_allocators_(rhs.delegate_init_allocators_),
         n_chains_(rhs.n_chains_),
         chains_(rhs.chains_),
         external_constants_(rhs.external_constants_),
         n_external_constants_(rhs.n_external_constants_),
+        n_io_tensor_lists_(rhs.n_io_tensor_lists_),
+        io_tensor_lists_(rhs.io_tensor_lists_),
+        task_runner_(rhs.task_runner_),
+        shape_cache_(rhs.shape_cache_),
+        constant_resolver_(rhs.constant_resolver_),
+        n_pending_delegate_calls_(rhs.n_pending_delegate_calls_),
+        n_device_values_(rhs.n_device_values_),
         init_state_(rhs.init_state_) {
+    for (size_t i = 0; i < n_pending_delegate_calls_; ++i) {
+      pending_delegate_calls_[i] = rhs.pending_delegate_calls_[i];
+    }
+    for (size_t i = 0; i < n_device_values_; ++i) {
+      device_values_[i] = rhs.device_values_[i];
+    }
     // Required: clear out fields that the dtor looks at, so that we don't free
     // anything twice.
     rhs.n_value_ = 0;
     rhs.values_ = nullptr;
     rhs.n_delegate_ = 0;
     rhs.delegates_ = nullptr;
+    rhs.delegate_init_allocators_ = nullptr;
+    rhs.n_pending_delegate_calls_ = 0;
+    rhs.n_device_values_ = 0;
     rhs.n_external_constants_ = 0;
     rhs.external_constants_ = nullptr;
 
@@ -98,6 +125,11 @@ class Method final {
     rhs.event_tracer_ = nullptr;
     rhs.n_chains_ = 0;
     rhs.chains_ = nullptr;
+    rhs.n_io_tensor_lists_ = 0;
+    rhs.io_tensor_lists_ = nullptr;
+    rhs.task_runner_ = nullptr;
+    rhs.shape_cache_ = nullptr;
+    rhs.constant_resolver_ = nullptr;
   }
 
   /**
@@ -135,6 +167,31 @@ class Method final {
   ET_NODISCARD Error
   set_inputs(const executorch::aten::ArrayRef<EValue>& input_evalues);
 
+  /**
+   * EXPERIMENTAL: Sets the specified method input like `set_input()`, but
+   * points the method's tensor at the data of `input_evalue` instead of
+   * copying it, even when the input has memory-planned storage.
+   *
+   * The method reads the caller's memory directly, so it must stay valid, and
+   * must not be modified, until the method has finished executing. The binding
+   * lasts until the next `set_input()` or `bind_input()` call for the same
+   * input, so callers that refill the same buffer for every execution only
+   * need to bind it once. A later `set_input()` copies into the planned
+   * storage again.
+   *
+   * If the tensor's size or dim order doesn't match what the method expects
+   * after resizing, falls back to copying like `set_input()`. Non-tensor
+   * inputs behave exactly like `set_input()`.
+   *
+   * @param[in] input_evalue The value to bind. Must have the same type as the
+   *     corresponding input.
+   * @param[in] input_idx Zero-based index of the input to bind.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  bind_input(const EValue& input_evalue, size_t input_idx);
+
   /**
    * Sets the data buffer of the specified method output to the provided value.
    *
@@ -198,6 +255,10 @@ class Method final {
    * NOTE: Will fail if the method has been partially executed using the
    * `step()` api.
    *
+   * Delegates whose backend implements BackendInterface::execute_async() may
+   * keep running while later instructions that don't use their memory
+   * execute. All of them have finished when this returns.
+   *
    * @returns Error::Ok on success, non-Ok on failure.
    */
   ET_NODISCARD Error execute();
@@ -228,6 +289,302 @@ class Method final {
   /// DEPRECATED: Use `reset_execution()` instead.
   ET_DEPRECATED ET_NODISCARD Error experimental_reset_execution();
 
+  /**
+   * EXPERIMENTAL: Lets execute() run independent instructions concurrently.
+   *
+   * The first call with a non-null runner analyzes the method and groups
+   * consecutive kernel and delegate calls into "waves" of instructions that do
+   * not depend on each other. An instruction depends on an earlier one if it
+   * touches memory that the earlier instruction writes, or writes memory that
+   * the earlier instruction touches. This accounts for the memory plan, so
+   * tensors that share planned memory are never run concurrently. Control flow,
+   * move, free, and prim-op instructions always run alone.
+   *
+   * Argument roles are not serialized, so the analysis treats an argument as
+   * written if it is the last argument (the out-variant convention) or if the
+   * instruction is the first to reference it. Methods whose kernels or
+   * delegates mutate other arguments in place must not use this mode.
+   *
+   * Kernels that run concurrently each get a private temp allocator, and
+   * `step()` always runs one instruction at a time.
+   *
+   * @param[in] runner The runner to dispatch waves on, or nullptr to go back to
+   *     sequential execution. Must outlive the Method, or a later call to this
+   *     method that replaces it.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method is not initialized, or is in
+   *     the middle of step-based execution.
+   * @retval Error::NotSupported if the method has an event tracer, which is
+   *     not thread-safe.
+   * @retval Error::MemoryAllocationFailed if the method or temp allocator ran
+   *     out of memory while building the schedule.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  set_parallel_execution(ParallelTaskRunner* runner);
+
+  /**
+   * EXPERIMENTAL: Creates another instance of this method that uses different
+   * planned memory, so that both instances can execute at the same time.
+   *
+   * This is much cheaper than calling `Program::load_method()` again: constant
+   * tensors, resolved kernels, and initialized delegates are shared with this
+   * Method, and only tensors that live in planned memory (plus the lists that
+   * refer to them) are created again, using `memory_manager`. Mutable buffers
+   * start from their serialized initial state, like in a newly-loaded Method.
+   *
+   * Delegate handles are shared, so instances that use a backend whose
+   * `execute()` cannot be called concurrently on the same handle must not run
+   * at the same time. The clone uses sequential execution regardless of
+   * `set_parallel_execution()` on this Method. Must not be called while this
+   * Method is executing.
+   *
+   * @param[in] memory_manager The memory to use for the clone. Its planned
+   *     memory must have the same layout as this Method's, and it must not be
+   *     used by any other Method. Must outlive the clone.
+   * @param[in] event_tracer The event tracer to use for the clone, or nullptr.
+   *     Event tracers are not thread-safe, so this should not be the same
+   *     tracer used by this Method.
+   *
+   * @returns The new Method on success. It refers to state owned by this
+   *     Method, so this Method must outlive it.
+   * @retval Error::InvalidState if this method is not initialized.
+   * @retval Error::NotSupported if the method has mutable buffers whose
+   *     initial state is stored in an external data map.
+   * @retval Error::MemoryAllocationFailed if `memory_manager` ran out of
+   *     memory.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<Method> clone_with_memory(
+      MemoryManager* memory_manager,
+      EventTracer* event_tracer = nullptr) const;
+
+  /**
+   * EXPERIMENTAL: Points the external constants whose names are in
+   * `named_data_map` at its data instead, e.g. to switch between LoRA
+   * adapters whose weights were exported to their own .ptd files. Constants
+   * that aren't in the map, like the base weights, are left as they are, and
+   * nothing is loaded, planned, or initialized again.
+   *
+   * Only tensors that the method's kernels read are updated: delegates that
+   * consumed a constant at init time, e.g. to pack it, keep their own copy,
+   * so adapter weights must not be lowered into such a delegate. Clones made
+   * by `clone_with_memory()` share the constants, so they see the new data
+   * too. Must not be called while this Method or any of its clones is
+   * executing.
+   *
+   * The data of the replaced constants is freed, and the new data is owned by
+   * the Method like the data loaded by `Program::load_method()`. A
+   * `FreeableBuffer` returned by the map may still refer to its DataLoader,
+   * which must then outlive the Method or the next update.
+   *
+   * @param[in] named_data_map The map to take the new data from.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method is not initialized, or is in
+   *     the middle of step-based execution.
+   * @retval Error::NotFound if none of the method's external constants are in
+   *     the map.
+   * @retval Error::InvalidExternalData if the layout of a tensor in the map
+   *     doesn't match the method's. No constant is updated in that case.
+   * @retval Error::NotSupported if this Method is a clone.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  update_external_constants(const NamedDataMap* named_data_map);
+
+  /**
+   * EXPERIMENTAL: Points the mutable buffers of this method, like a KV cache,
+   * at the memory of the mutable buffers with the same fully qualified names
+   * in `other`, so that both methods read and write the same state. This
+   * lets methods that are specialized for different shapes, like `prefill`
+   * and `decode` exported into one program, share one KV cache.
+   *
+   * Tensors that the memory planner placed inside a shared buffer, like the
+   * outputs of in-place updates of it, move along with it. This method's own
+   * memory for the buffers is left unused. Delegates that hold on to the
+   * memory of a buffer from init time keep using this method's copy, so
+   * shared buffers must only be passed to delegates as arguments.
+   *
+   * `other` must outlive this Method, and the two must not execute at the
+   * same time.
+   *
+   * @param[in] other The method whose buffers to use.
+   *
+   * @returns The number of buffers that are now shared with `other`.
+   * @retval Error::InvalidState if either method is not initialized, or this
+   *     one is in the middle of step-based execution.
+   * @retval Error::InvalidArgument if `other` is this method, or a buffer of
+   *     `other` has a different dtype or size than the one of the same name
+   *     in this method. No buffer is shared in that case.
+   * @retval Error::NotFound if the methods have no mutable buffer names in
+   *     common.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<size_t> share_mutable_buffers(
+      const Method& other);
+
+  /**
+   * EXPERIMENTAL: Moves the mutable buffers of this method, like a KV cache,
+   * out of its memory-planned buffers into memory from `allocator`, along
+   * with their current contents. This keeps the state of the method intact
+   * when its memory-planned buffers are reused by other methods between
+   * executions, like methods that never run at the same time sharing one
+   * activation arena.
+   *
+   * Only buffers that the program names are moved; see
+   * share_mutable_buffers() for which tensors move along with a buffer and
+   * the limitations.
+   *
+   * @param[in] allocator The allocator for the moved buffers. Must outlive
+   *     this Method.
+   *
+   * @returns The number of buffers that were moved.
+   * @retval Error::InvalidState if the method is not initialized, or is in
+   *     the middle of step-based execution.
+   * @retval Error::MemoryAllocationFailed if `allocator` ran out of memory.
+   * @retval Error::NotSupported if a mutable buffer with an initial state has
+   *     no name. Nothing is moved in that case.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<size_t> move_mutable_buffers(
+      MemoryAllocator* allocator);
+
+  /**
+   * EXPERIMENTAL: Returns the number of mutable buffers, like KV caches, that
+   * the program names. See share_mutable_buffers().
+   */
+  ET_EXPERIMENTAL size_t num_mutable_buffers() const;
+
+  /**
+   * EXPERIMENTAL: Returns the tensor of a mutable buffer that the program
+   * names, e.g. to save and restore the state of the method.
+   *
+   * @param[in] index The index of the buffer, less than num_mutable_buffers().
+   *
+   * @returns The tensor of the buffer.
+   * @retval Error::InvalidState if the method is not initialized.
+   * @retval Error::InvalidArgument if `index` is out of range.
+   */
+  ET_EXPERIMENTAL Result<executorch::aten::Tensor> get_mutable_buffer(
+      size_t index) const;
+
+  /**
+   * EXPERIMENTAL: Makes every kernel or delegate call ask `resolver` for the
+   * data of the external constants it reads, right before it executes, and
+   * point the constant tensors at the returned data. This lets the resolver
+   * page weights in and out while the method executes, e.g. to run models
+   * whose weights don't fit in memory; see
+   * `executorch::extension::LayerStreamingDataMap`.
+   *
+   * The data loaded at init time stays owned by the Method, so a resolver
+   * that streams weights should also be the NamedDataMap the method was
+   * loaded with, and hand out data that it can release. Delegates that
+   * consumed a constant at init time keep their own copy, which is not
+   * streamed. Independent instructions are not run concurrently while a
+   * resolver is set, regardless of `set_parallel_execution()`. Clones made by
+   * `clone_with_memory()` share the constant tensors, so they must not
+   * execute while a resolver is set.
+   *
+   * @param[in] resolver The resolver to use, or nullptr to point the constants
+   *     back at the data loaded at init time, which must then still be valid.
+   *     Must outlive the Method, or a later call to this method that replaces
+   *     it.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method is not initialized, or is in
+   *     the middle of step-based execution.
+   * @retval Error::NotSupported if the method has no external constants, or
+   *     is a clone.
+   * @retval Error::MemoryAllocationFailed if the method allocator ran out of
+   *     memory while finding the constants of each instruction.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  set_external_constant_resolver(ExternalConstantResolver* resolver);
+
+  /**
+   * EXPERIMENTAL: Returns the number of instructions that `execute()` steps
+   * through, across all chains of the method.
+   */
+  ET_EXPERIMENTAL size_t num_instructions() const;
+
+  /**
+   * EXPERIMENTAL: Computes how many bytes of a memory-planned buffer hold live
+   * tensors while each instruction runs. Comparing the peak with
+   * `MethodMeta::memory_planned_buffer_size()` shows how much of the buffer
+   * the memory plan leaves unused.
+   *
+   * Instructions are numbered in execution order across chains, as for
+   * `num_instructions()`. A tensor is live from the first instruction that
+   * references it to the last one; inputs are live from the start and
+   * outputs until the end. Tensors that the plan places at the same offset
+   * are counted once. Sizes are the serialized (upper bound) sizes. Back edges
+   * of jumps are not followed, so lifetimes inside loops are approximate.
+   *
+   * @param[in] buffer_index The index of the planned buffer, as for
+   *     `MethodMeta::memory_planned_buffer_size()`.
+   * @param[out] live_bytes Receives one entry per instruction. Must have at
+   *     least `num_instructions()` entries.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method is not initialized.
+   * @retval Error::InvalidArgument if `buffer_index` is out of range or
+   *     `live_bytes` is too small.
+   * @retval Error::MemoryAllocationFailed if the temp allocator ran out of
+   *     memory.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  get_planned_memory_usage(size_t buffer_index, Span<size_t> live_bytes) const;
+
+  /**
+   * EXPERIMENTAL: Reports the output of `get_planned_memory_usage()` to the
+   * method's event tracer. Each planned buffer is registered with
+   * `EventTracer::track_allocator()` as "<method name>.planned_buffer_<index>",
+   * followed by one `EventTracer::track_allocation()` per instruction in
+   * execution order, whose size is the number of live bytes.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method is not initialized or has no
+   *     event tracer.
+   * @retval Error::MemoryAllocationFailed if the temp allocator ran out of
+   *     memory.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error log_planned_memory_usage();
+
+  /**
+   * EXPERIMENTAL: Reports the statistics of `et_pal_allocate()`, which backs
+   * the temp memory of kernels when the method has no temp allocator, to the
+   * method's event tracer. "pal_allocator" is registered with
+   * `EventTracer::track_allocator()`, followed by one
+   * `EventTracer::track_allocation()` each for the live, peak live and cached
+   * bytes of `et_pal_allocator_stats_t`. They are process wide and only kept
+   * by some PALs, like the default one built with ET_PAL_USE_POOLED_ALLOCATOR.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method has no event tracer.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error log_pal_allocator_usage();
+
+  /**
+   * EXPERIMENTAL: Makes `execute()` remember the sizes of the method's
+   * dynamically-shaped tensors for each combination of input sizes it sees.
+   * When a combination recurs, every dynamically-shaped tensor is resized
+   * up front in one pass, so the resizes that kernels do on their outputs
+   * find them already at the right size and return early.
+   *
+   * Sizes recorded for tensors whose shape depends on input data rather than
+   * input shapes may be stale; kernels still resize their outputs, so this
+   * never changes results. Once the cache is full, the oldest entry is
+   * replaced. Clones made by `clone_with_memory()` don't share the cache.
+   *
+   * @param[in] max_entries The number of input size combinations to
+   *     remember, or zero to disable the cache. The cache starts out empty.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the method is not initialized, or is in
+   *     the middle of step-based execution.
+   * @retval Error::MemoryAllocationFailed if the method allocator ran out of
+   *     memory. Memory is only allocated when `max_entries` is larger than in
+   *     any earlier call.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error enable_shape_cache(size_t max_entries);
+
   /**
    * Returns the MethodMeta that corresponds to the calling Method.
    */
@@ -300,10 +657,18 @@ class Method final {
         values_(nullptr),
         n_delegate_(0),
         delegates_(nullptr),
+        delegate_init_allocators_(nullptr),
         n_chains_(0),
         chains_(nullptr),
         external_constants_(nullptr),
         n_external_constants_(0),
+        n_io_tensor_lists_(0),
+        io_tensor_lists_(nullptr),
+        task_runner_(nullptr),
+        shape_cache_(nullptr),
+        constant_resolver_(nullptr),
+        n_pending_delegate_calls_(0),
+        n_device_values_(0),
         init_state_(InitializationState::Uninitialized) {}
 
   /// Static factory used by Program.
@@ -312,7 +677,8 @@ class Method final {
       const Program* program,
       MemoryManager* memory_manager,
       EventTracer* event_tracer,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      ParallelTaskRunner* init_task_runner);
 
   /**
    * Initialize the method from its serialized representation.
@@ -321,7 +687,16 @@ class Method final {
    */
   ET_NODISCARD Error init(
       executorch_flatbuffer::ExecutionPlan* s_plan,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      ParallelTaskRunner* init_task_runner);
+
+  /// Initializes the delegates in `delegates_` whose backends are thread-safe
+  /// for init concurrently on `init_task_runner`, and the others serially.
+  /// They must all have been set up with BackendDelegate::Prepare().
+  ET_NODISCARD Error init_delegates_in_parallel(
+      ParallelTaskRunner* init_task_runner,
+      size_t n_delegate,
+      const NamedDataMap* pte_data_map);
 
   /// Returns true if the Method was successfully initialized.
   inline bool initialized() const {
@@ -330,12 +705,79 @@ class Method final {
 
   const EValue& get_value(size_t i) const;
   EValue& mutable_value(size_t i);
+
+  /// Makes tensor lists look up their Tensors again, for when the caller may
+  /// replace values through mutable_input() or mutable_output().
+  void invalidate_tensor_lists();
   size_t get_input_index(size_t i) const;
   size_t get_output_index(size_t i) const;
 
   // Executes a single instruction using the state in step_state_
   ET_NODISCARD Error execute_instruction();
 
+  // Concurrently executes the instructions in the current chain from
+  // step_state_.instr_idx up to (but not including) `end`, which must all be
+  // kernel or delegate calls that are independent of each other.
+  ET_NODISCARD Error execute_instruction_wave(size_t end);
+
+  // Waits for the delegate calls still running in the background that
+  // `instruction` depends on, or for all of them if it is nullptr. Returns the
+  // first error that a delegate call reports.
+  ET_NODISCARD Error wait_for_delegate_calls(const Instruction* instruction);
+
+  // Copies the tensors that delegates left on the device back to their CPU
+  // memory if `instruction` touches that memory, or all of them if it is
+  // nullptr. When `keep_for_delegate` is true, tensors that `instruction` can
+  // read from the device stay there.
+  ET_NODISCARD Error materialize_device_values(
+      const Instruction* instruction,
+      bool keep_for_delegate);
+
+  // Records the tensors that the delegate call `instruction` left on the
+  // device, as reported in `device_buffers`.
+  ET_NODISCARD Error record_device_values(
+      const Instruction& instruction,
+      Span<DeviceBuffer*> device_buffers);
+
+  // Forgets the tensors that delegates left on the device without copying
+  // them back.
+  void release_device_values();
+
+  // Fills in Chain::wave_ends_ for every chain. See set_parallel_execution().
+  ET_NODISCARD Error build_parallel_schedule();
+
+  // Fills in Chain::constant_use_ends_ and Chain::constant_uses_ for every
+  // chain. See set_external_constant_resolver().
+  ET_NODISCARD Error build_constant_use_table();
+
+  /// Points the external constants that the current instruction reads at the
+  /// data returned by constant_resolver_.
+  ET_NODISCARD Error resolve_external_constants();
+
+  /// Points the tensors of every external constant at external_constants_.
+  ET_NODISCARD Error restore_external_constants();
+
+  /// Points the tensor at value `value_idx` back at its memory-planned
+  /// storage, if it has any.
+  ET_NODISCARD Error restore_planned_data_ptr(size_t value_idx);
+
+  /// Points the mutable buffer at value `value_idx`, and the tensors planned
+  /// inside of it, at `data`.
+  ET_NODISCARD Error rebind_mutable_buffer(size_t value_idx, uint8_t* data);
+
+  /// Resizes dynamically-shaped tensors to the sizes cached for the current
+  /// input sizes, if there are any. See enable_shape_cache().
+  ET_NODISCARD Error apply_cached_shapes();
+
+  /// Saves the current sizes of dynamically-shaped tensors in the cache.
+  void record_shapes();
+
+  /// Does the work of get_planned_memory_usage(), leaving its scratch memory
+  /// in the temp allocator.
+  ET_NODISCARD Error compute_planned_memory_usage(
+      size_t buffer_index,
+      Span<size_t> live_bytes) const;
+
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
@@ -348,6 +790,10 @@ class Method final {
 
   size_t n_delegate_;
   BackendDelegate* delegates_;
+  /// Only set if delegates were initialized in parallel: one runtime
+  /// allocator per delegate, which own the memory those delegates allocated
+  /// during init.
+  internal::PlatformMemoryAllocator* delegate_init_allocators_;
 
   size_t n_chains_;
   Chain* chains_;
@@ -355,6 +801,48 @@ class Method final {
   NamedData* external_constants_;
   size_t n_external_constants_ = 0;
 
+  /// Indices in values_ of the cached tensor lists that refer to an input or
+  /// an output, which invalidate_tensor_lists() invalidates.
+  size_t n_io_tensor_lists_;
+  size_t* io_tensor_lists_;
+
+  /// When non-null, execute() dispatches independent instructions here.
+  ParallelTaskRunner* task_runner_;
+
+  /// When non-null, execute() caches tensor sizes. Lives in the method
+  /// allocator.
+  struct ShapeCache;
+  ShapeCache* shape_cache_;
+
+  /// When non-null, provides the data of external constants before each
+  /// instruction executes.
+  ExternalConstantResolver* constant_resolver_;
+
+  /// A delegate call whose BackendInterface::execute_async() returned before
+  /// the delegate finished.
+  struct PendingDelegateCall {
+    const BackendDelegate* delegate;
+    BackendCompletion* completion;
+    InstructionArgs args;
+  };
+  /// Once this many delegate calls are running, the oldest is waited on
+  /// before starting another.
+  static constexpr size_t kMaxPendingDelegateCalls = 8;
+  PendingDelegateCall pending_delegate_calls_[kMaxPendingDelegateCalls];
+  size_t n_pending_delegate_calls_;
+
+  /// A tensor whose data a delegate left in device memory. See
+  /// BackendExecutionContext::set_device_buffer().
+  struct DeviceResidentValue {
+    EValue* value;
+    const BackendInterface* backend;
+    DeviceBuffer* buffer;
+  };
+  /// Device data beyond this many tensors is copied to the CPU right away.
+  static constexpr size_t kMaxDeviceResidentValues = 16;
+  DeviceResidentValue device_values_[kMaxDeviceResidentValues];
+  size_t n_device_values_;
+
   InitializationState init_state_;
 
   /**
@@ -386,11 +874,20 @@ class Method final {
 
   ET_NODISCARD Error resolve_operator(
       int32_t op_index,
-      OpFunction* kernels,
-      size_t kernel_index,
+      OpFunction* kernel,
+      ScratchSizeFunction* scratch_size,
       InstructionArgs args,
       size_t n_args);
 
+  /// Points the scratch memory of the kernels in chains_, which init() sized,
+  /// at their planned memory or at a buffer from the method allocator.
+  ET_NODISCARD Error reserve_kernel_scratch();
+
+  /// Turns off the cache of the tensor lists that refer to a value that a
+  /// MoveCall replaces, and fills io_tensor_lists_. Must run after chains_ is
+  /// set up.
+  ET_NODISCARD Error prepare_tensor_lists();
+
   void log_outputs();
 };
 
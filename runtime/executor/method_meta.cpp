@@ -69,11 +69,13 @@ TensorInfo::TensorInfo(
     Span<const int32_t> sizes,
     Span<const uint8_t> dim_order,
     executorch::aten::ScalarType scalar_type,
-    const bool is_memory_planned)
+    const bool is_memory_planned,
+    TensorShapeDynamism shape_dynamism)
     : sizes_(sizes),
       dim_order_(dim_order),
       scalar_type_(scalar_type),
       is_memory_planned_(is_memory_planned),
+      shape_dynamism_(shape_dynamism),
       nbytes_(calculate_nbytes(sizes_, scalar_type_)) {}
 
 Span<const int32_t> TensorInfo::sizes() const {
@@ -92,6 +94,10 @@ bool TensorInfo::is_memory_planned() const {
   return is_memory_planned_;
 }
 
+TensorShapeDynamism TensorInfo::shape_dynamism() const {
+  return shape_dynamism_;
+}
+
 size_t TensorInfo::nbytes() const {
   return nbytes_;
 }
@@ -150,7 +156,8 @@ Result<TensorInfo> MethodMeta::input_tensor_meta(size_t index) const {
       static_cast<executorch::aten::ScalarType>(tensor_value->scalar_type()),
       tensor_value->allocation_info() != nullptr ||
           tensor_value->data_buffer_idx() !=
-              0); // Count constant returns as memory planned.
+              0, // Count constant returns as memory planned.
+      static_cast<TensorShapeDynamism>(tensor_value->shape_dynamism()));
 }
 
 size_t MethodMeta::num_outputs() const {
@@ -201,7 +208,8 @@ Result<TensorInfo> MethodMeta::output_tensor_meta(size_t index) const {
       static_cast<executorch::aten::ScalarType>(tensor_value->scalar_type()),
       tensor_value->allocation_info() != nullptr ||
           tensor_value->data_buffer_idx() !=
-              0); // Count constant returns as memory planned.
+              0, // Count constant returns as memory planned.
+      static_cast<TensorShapeDynamism>(tensor_value->shape_dynamism()));
 }
 
 size_t MethodMeta::num_memory_planned_buffers() const {
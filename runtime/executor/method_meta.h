@@ -12,6 +12,7 @@
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/core/tag.h>
+#include <executorch/runtime/core/tensor_shape_dynamism.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
 // include the generated flatbuffer header.
@@ -57,6 +58,12 @@ class TensorInfo final {
    */
   bool is_memory_planned() const;
 
+  /**
+   * Returns whether the tensor's shape can change at runtime. For dynamic
+   * tensors, `sizes()` are the upper bounds captured at export.
+   */
+  TensorShapeDynamism shape_dynamism() const;
+
   /**
    * Returns the size of the tensor in bytes.
    */
@@ -70,7 +77,8 @@ class TensorInfo final {
       Span<const int32_t> sizes,
       Span<const uint8_t> dim_order,
       executorch::aten::ScalarType scalar_type,
-      const bool is_memory_planned);
+      const bool is_memory_planned,
+      TensorShapeDynamism shape_dynamism);
 
   /**
    * The sizes of the tensor.
@@ -94,6 +102,9 @@ class TensorInfo final {
   /// Whether the tensor's memory was planned during export.
   bool is_memory_planned_;
 
+  /// The resizing capabilities of the tensor.
+  TensorShapeDynamism shape_dynamism_;
+
   /// The size in bytes of the tensor.
   size_t nbytes_;
 };
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: Runs a batch of independent tasks, potentially in parallel.
+ *
+ * The core runtime does not own any threads. Clients that want Method to run
+ * independent instructions concurrently provide an implementation of this
+ * interface backed by their threadpool of choice; see
+ * `Method::set_parallel_execution()`.
+ */
+class ParallelTaskRunner {
+ public:
+  /// The function to call for each task.
+  using TaskFn = void (*)(void* context, size_t task_index);
+
+  virtual ~ParallelTaskRunner() = default;
+
+  /**
+   * Calls `fn(context, i)` for every `i` in `[0, num_tasks)`, and returns only
+   * after all calls have completed. Calls may happen in any order and on any
+   * thread, including the calling thread.
+   *
+   * @param[in] fn The function to call for each task.
+   * @param[in] context The context pointer to pass to `fn`.
+   * @param[in] num_tasks The number of tasks to run.
+   */
+  virtual void run(TaskFn fn, void* context, size_t num_tasks) = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
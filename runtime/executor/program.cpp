@@ -14,6 +14,7 @@
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/segment_compression.h>
 #include <executorch/runtime/platform/profiler.h>
 #include <executorch/schema/extended_header.h>
 #include <executorch/schema/program_generated.h>
@@ -62,7 +63,9 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
 /* static */ Result<Program> Program::load(
     DataLoader* loader,
-    Program::Verification verification) {
+    Program::Verification verification,
+    ParallelTaskRunner* task_runner,
+    VerificationCache* verification_cache) {
   EXECUTORCH_SCOPE_PROF("Program::load");
 
   // See if the program size is in the header.
@@ -123,14 +126,23 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
   if (verification == Verification::InternalConsistency) {
 #if ET_ENABLE_PROGRAM_VERIFICATION
     EXECUTORCH_SCOPE_PROF("Program::verify_internal_consistency");
-    flatbuffers::Verifier verifier(
-        reinterpret_cast<const uint8_t*>(program_data->data()),
-        program_data->size());
-    bool ok = executorch_flatbuffer::VerifyProgramBuffer(verifier);
-    ET_CHECK_OR_RETURN_ERROR(
-        ok,
-        InvalidProgram,
-        "Verification failed; data may be truncated or corrupt");
+    if (verification_cache != nullptr &&
+        verification_cache->contains(
+            program_data->data(), program_data->size())) {
+      ET_LOG(Debug, "Program data already verified; skipping verification");
+    } else {
+      flatbuffers::Verifier verifier(
+          reinterpret_cast<const uint8_t*>(program_data->data()),
+          program_data->size());
+      bool ok = executorch_flatbuffer::VerifyProgramBuffer(verifier);
+      ET_CHECK_OR_RETURN_ERROR(
+          ok,
+          InvalidProgram,
+          "Verification failed; data may be truncated or corrupt");
+      if (verification_cache != nullptr) {
+        verification_cache->insert(program_data->data(), program_data->size());
+      }
+    }
 #else
     ET_LOG(
         Info, "InternalConsistency verification requested but not available");
@@ -159,7 +171,8 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
             loader,
             segment_base_offset,
             named_data,
-            flatbuffer_program->segments());
+            flatbuffer_program->segments(),
+            task_runner);
     if (!pte_data_map_result.ok()) {
       return pte_data_map_result.error();
     }
@@ -198,12 +211,14 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
     const executorch_flatbuffer::DataSegment* data_segment =
         segments->Get(constant_segment->segment_index());
-    Result<FreeableBuffer> constant_segment_data = loader->load(
-        segment_base_offset + data_segment->offset(),
-        data_segment->size(),
+    Result<FreeableBuffer> constant_segment_data = load_data_segment(
+        loader,
+        segment_base_offset,
+        data_segment,
         DataLoader::SegmentInfo(
             DataLoader::SegmentInfo::Type::Constant,
-            constant_segment->segment_index()));
+            constant_segment->segment_index()),
+        task_runner);
     if (!constant_segment_data.ok()) {
       return constant_segment_data.error();
     }
@@ -216,7 +231,8 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
         std::move(program_data.get()),
         flatbuffer_program,
         std::move(constant_segment_data.get()),
-        std::move(pte_data_map));
+        std::move(pte_data_map),
+        task_runner);
   } else {
     // The constant data is stored inside the flatbuffer, so this program does
     // not contain a separate segment for it.
@@ -226,7 +242,8 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
         std::move(program_data.get()),
         flatbuffer_program,
         /*constant_segment_data=*/FreeableBuffer{},
-        std::move(pte_data_map));
+        std::move(pte_data_map),
+        task_runner);
   }
 }
 
@@ -259,7 +276,8 @@ Result<Method> Program::load_method(
     const char* method_name,
     MemoryManager* memory_manager,
     EventTracer* event_tracer,
-    const NamedDataMap* named_data_map) const {
+    const NamedDataMap* named_data_map,
+    ParallelTaskRunner* init_task_runner) const {
   EXECUTORCH_SCOPE_PROF("Program::load_method");
   internal::event_tracer_create_event_block(event_tracer, "Default");
   internal::EventTracerProfileMethodScope event_tracer_scope =
@@ -277,7 +295,12 @@ Result<Method> Program::load_method(
     return plan.error();
   }
   return Method::load(
-      plan.get(), this, memory_manager, event_tracer, named_data_map);
+      plan.get(),
+      this,
+      memory_manager,
+      event_tracer,
+      named_data_map,
+      init_task_runner);
 }
 
 Result<MethodMeta> Program::method_meta(const char* method_name) const {
@@ -302,6 +325,62 @@ Result<MethodMeta> Program::method_meta(const char* method_name) const {
   return MethodMeta(plan.get());
 }
 
+Error Program::prefetch_method(const char* method_name) const {
+  EXECUTORCH_SCOPE_PROF("Program::prefetch_method");
+  auto plan = get_execution_plan(internal_program_, method_name);
+  if (!plan.ok()) {
+    return plan.error();
+  }
+  if (loader_ == nullptr || segment_base_offset_ == 0) {
+    // All of the program's data is already in memory.
+    return Error::Ok;
+  }
+
+  // Backend delegates stored in segments are loaded while initializing the
+  // method.
+  const auto delegates = plan.get()->delegates();
+  if (delegates != nullptr) {
+    for (size_t i = 0; i < delegates->size(); ++i) {
+      const auto delegate = delegates->Get(i);
+      if (delegate == nullptr || delegate->processed() == nullptr ||
+          delegate->processed()->location() !=
+              executorch_flatbuffer::DataLocation::SEGMENT) {
+        continue;
+      }
+      Error err = prefetch_segment(DataLoader::SegmentInfo(
+          DataLoader::SegmentInfo::Type::Backend,
+          delegate->processed()->index(),
+          delegate->id() != nullptr ? delegate->id()->c_str() : nullptr));
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+
+  // So is the initial state of mutable buffers, which always comes from the
+  // first mutable data segment.
+  const auto mutable_data_segments = internal_program_->mutable_data_segments();
+  const auto values = plan.get()->values();
+  if (mutable_data_segments != nullptr && mutable_data_segments->size() > 0 &&
+      values != nullptr) {
+    for (size_t i = 0; i < values->size(); ++i) {
+      const auto value = values->Get(i);
+      if (value == nullptr ||
+          value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+        continue;
+      }
+      const auto s_tensor = value->val_as_Tensor();
+      if (s_tensor != nullptr && s_tensor->data_buffer_idx() > 0 &&
+          s_tensor->allocation_info() != nullptr) {
+        return prefetch_segment(DataLoader::SegmentInfo(
+            DataLoader::SegmentInfo::Type::Mutable,
+            mutable_data_segments->Get(0)->segment_index()));
+      }
+    }
+  }
+  return Error::Ok;
+}
+
 Result<const void*> Program::get_constant_buffer_data(
     size_t buffer_index,
     size_t nbytes) const {
@@ -408,6 +487,18 @@ Error Program::get_backend_delegate_data(
   return Error::Ok;
 }
 
+Error Program::release_program_data(const void* data, size_t size) const {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(program_data_.data());
+  const uintptr_t start = reinterpret_cast<uintptr_t>(data);
+  ET_CHECK_OR_RETURN_ERROR(
+      start >= begin && start - begin + size <= program_data_.size(),
+      InvalidArgument,
+      "Range of %zu bytes at %p is not inside the program data",
+      size,
+      data);
+  return loader_->release(program_data_, start - begin, size);
+}
+
 /* static */ Program::HeaderStatus Program::check_header(
     const void* data,
     size_t size) {
@@ -446,7 +537,26 @@ Result<FreeableBuffer> Program::LoadSegment(
   // Could fail if offset and size are out of bound for the data, or if this
   // is reading from a file and fails, or for many other reasons depending on
   // the implementation of the loader.
-  return loader_->load(
+  return load_data_segment(
+      loader_, segment_base_offset_, segment, segment_info, task_runner_);
+}
+
+Error Program::prefetch_segment(
+    const DataLoader::SegmentInfo& segment_info) const {
+  size_t index = segment_info.segment_index;
+  if (loader_ == nullptr || segment_base_offset_ == 0) {
+    ET_LOG(Error, "No segments in program: requested index %zu", index);
+    return Error::NotFound;
+  }
+  size_t num_segments = internal_program_->segments()->size();
+  if (index >= num_segments) {
+    ET_LOG(
+        Error, "Segment index %zu out of range (>= %zu)", index, num_segments);
+    return Error::NotFound;
+  }
+  const executorch_flatbuffer::DataSegment* segment =
+      internal_program_->segments()->Get(index);
+  return loader_->prefetch(
       segment_base_offset_ + segment->offset(), segment->size(), segment_info);
 }
 
@@ -514,14 +624,26 @@ Error Program::load_mutable_subsegment_into(
   auto segment =
       internal_program_->segments()->Get(segment_offsets->segment_index());
 
-  // Check size
-  if (offset + size > segment->size()) {
+  // Check size. Offsets into compressed segments refer to the uncompressed
+  // data.
+  std::optional<SegmentCompression> compression;
+  uint64_t segment_size = segment->size();
+  if (segment->compression() != nullptr) {
+    Result<SegmentCompression> parsed =
+        parse_segment_compression(segment->compression(), segment->size());
+    if (!parsed.ok()) {
+      return parsed.error();
+    }
+    compression = parsed.get();
+    segment_size = compression->uncompressed_size;
+  }
+  if (offset + size > segment_size) {
     ET_LOG(
         Error,
         "offset %zu + size %zu out of range > %" PRIu64,
         offset,
         size,
-        segment->size());
+        segment_size);
     return Error::InvalidArgument;
   }
 
@@ -531,6 +653,17 @@ Error Program::load_mutable_subsegment_into(
       nullptr);
 
   // Load the data
+  if (compression.has_value()) {
+    return load_compressed_segment_into(
+        loader_,
+        segment_base_offset_ + segment->offset(),
+        info,
+        *compression,
+        offset,
+        size,
+        buffer,
+        task_runner_);
+  }
   return loader_->load_into(
       segment_base_offset_ + segment->offset() + offset, size, info, buffer);
 }
@@ -26,7 +26,9 @@
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/method_meta.h>
+#include <executorch/runtime/executor/parallel_task_runner.h>
 #include <executorch/runtime/executor/pte_data_map.h>
+#include <executorch/runtime/executor/verification_cache.h>
 #include <executorch/runtime/platform/compiler.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
@@ -85,10 +87,19 @@ class Program final {
    *     instance.
    * @param[in] verification The type of verification to do before returning
    *     success.
+   * @param[in] task_runner If not null, used to decompress the chunks of
+   *     compressed segments in parallel, here and in later loads of segments.
+   *     Must outlive the returned Program instance.
+   * @param[in] verification_cache If not null and `verification` is
+   *     InternalConsistency, data that the cache reports as already verified
+   *     is not verified again, and data that passes verification is added to
+   *     the cache. Only needs to outlive this call.
    */
   ET_NODISCARD static Result<Program> load(
       DataLoader* loader,
-      Verification verification = Verification::Minimal);
+      Verification verification = Verification::Minimal,
+      ParallelTaskRunner* task_runner = nullptr,
+      VerificationCache* verification_cache = nullptr);
 
   /// DEPRECATED: Use the lowercase `load()` instead.
   ET_DEPRECATED ET_NODISCARD static Result<Program> Load(
@@ -142,6 +153,12 @@ class Program final {
    * @param[in] event_tracer The event tracer to use for this method run.
    * @param[in] named_data_map An optional map of {name, blob} used to resolve
    *     data that is external to the PTE, if any.
+   * @param[in] init_task_runner If not null, the delegates whose backends
+   *     report `BackendInterface::is_init_thread_safe()` are initialized
+   *     concurrently on it. Memory that backends allocate from the runtime
+   *     allocator during init then comes from `et_pal_allocate()` instead of
+   *     the method allocator, and is freed with the Method. Ignored when
+   *     `event_tracer` is set, since event tracers are not thread-safe.
    *
    * @returns The loaded method on success, or an error on failure.
    */
@@ -149,7 +166,28 @@ class Program final {
       const char* method_name,
       MemoryManager* memory_manager,
       EventTracer* event_tracer = nullptr,
-      const NamedDataMap* named_data_map = nullptr) const;
+      const NamedDataMap* named_data_map = nullptr,
+      ParallelTaskRunner* init_task_runner = nullptr) const;
+
+  /**
+   * Asks the DataLoader to start reading the segments that the named method
+   * will need during `load_method()`, without waiting for them. This lets a
+   * caller overlap the I/O for methods it will load later with the
+   * initialization of the current one. The later `load_method()` call waits
+   * for any reads that are still outstanding.
+   *
+   * This is only a hint: how much reading happens in the background depends
+   * on the DataLoader's implementation of `DataLoader::prefetch()`.
+   *
+   * @param[in] method_name The name of the method to prefetch.
+   *
+   * @retval Error::Ok if the hints were issued, or if there was nothing to
+   *     prefetch.
+   * @retval Error::InvalidArgument if there is no method with that name.
+   * @retval Error::NotFound The program's segment table doesn't contain a
+   *     segment that the method refers to.
+   */
+  ET_NODISCARD Error prefetch_method(const char* method_name) const;
 
   /**
    * Gathers metadata for the named method.
@@ -230,6 +268,14 @@ class Program final {
       const void** out_data,
       size_t* out_size) const;
 
+  /**
+   * Hints to the loader that the `size` bytes at `data`, which must be inside
+   * the program data, will not be read for a while. Used by Method once a
+   * backend frees delegate data from get_backend_delegate_data(), so that
+   * the loader can release the memory behind it.
+   */
+  Error release_program_data(const void* data, size_t size) const;
+
   /**
    * Loads a segment by index.
    *
@@ -247,6 +293,20 @@ class Program final {
   ET_NODISCARD Result<FreeableBuffer> LoadSegment(
       const DataLoader::SegmentInfo& segment_info) const;
 
+  /**
+   * Hints to the DataLoader that the indexed segment will be loaded soon. See
+   * `DataLoader::prefetch()`.
+   *
+   * @param[in] segment_info Struct containing an index into the
+   * Program.segments list, as for LoadSegment().
+   *
+   * @retval Error::NotFound The program does not contain any segments or the
+   *     index is out of range.
+   * @returns Other errors depending on the implementation of DataLoader.
+   */
+  ET_NODISCARD Error
+  prefetch_segment(const DataLoader::SegmentInfo& segment_info) const;
+
   /**
    * Loads a portion of a mutable segment into the provided buffer.
    *
@@ -278,14 +338,15 @@ class Program final {
       FreeableBuffer&& program_data,
       const executorch_flatbuffer::Program* internal_program,
       FreeableBuffer&& constant_segment_data,
-      std::optional<internal::PteDataMap>&& pte_data_map)
+      std::optional<internal::PteDataMap>&& pte_data_map,
+      ParallelTaskRunner* task_runner)
       : program_data_(std::move(program_data)),
-        // Don't need the loader if there are no segments.
-        loader_(segment_base_offset > 0 ? loader : nullptr),
+        loader_(loader),
         internal_program_(internal_program),
         segment_base_offset_(segment_base_offset),
         constant_segment_data_(std::move(constant_segment_data)),
-        pte_data_map_(std::move(pte_data_map)) {}
+        pte_data_map_(std::move(pte_data_map)),
+        task_runner_(task_runner) {}
 
   // Not copyable or assignable.
   Program(const Program& rhs) = delete;
@@ -295,7 +356,7 @@ class Program final {
   /// The serialized program data. Tensors will point directly into this buffer.
   FreeableBuffer program_data_;
 
-  /// Used to load segment data. Null if there are no segments.
+  /// Used to load segment data, and to release parts of program_data_.
   DataLoader* loader_;
 
   /// The flatbuffer representation of the program. Must not be exposed to
@@ -311,6 +372,9 @@ class Program final {
 
   /// NamedDataMap holding named data from the program.
   std::optional<internal::PteDataMap> pte_data_map_;
+
+  /// Decompresses compressed segments in parallel. May be null.
+  ParallelTaskRunner* task_runner_;
 };
 
 } // namespace runtime
@@ -7,27 +7,78 @@
  */
 
 #include <executorch/runtime/executor/pte_data_map.h>
+#include <executorch/runtime/executor/segment_compression.h>
 #include <executorch/schema/program_generated.h>
 
+#include <cstring>
+
 namespace executorch {
 namespace runtime {
 namespace internal {
 
+namespace {
+
+/**
+ * Returns true if the keys of named_data are non-null and strictly increasing
+ * in byte order, as the serializer writes them.
+ */
+bool are_keys_sorted(const flatbuffers::FlatbufferNamedData* named_data) {
+  const char* prev_key = nullptr;
+  for (size_t i = 0; i < named_data->size(); i++) {
+    const auto* entry = named_data->Get(i);
+    if (entry == nullptr || entry->key() == nullptr) {
+      return false;
+    }
+    const char* key = entry->key()->c_str();
+    if (prev_key != nullptr && std::strcmp(prev_key, key) >= 0) {
+      return false;
+    }
+    prev_key = key;
+  }
+  return true;
+}
+
+} // namespace
+
 /* static */ executorch::runtime::Result<PteDataMap> PteDataMap::create(
     executorch::runtime::DataLoader* loader,
     size_t segment_base_offset,
     const flatbuffers::FlatbufferNamedData* named_data,
-    const flatbuffers::FlatbufferDataSegment* segments) {
+    const flatbuffers::FlatbufferDataSegment* segments,
+    ParallelTaskRunner* task_runner) {
   ET_CHECK_OR_RETURN_ERROR(
       loader != nullptr && named_data != nullptr && segments != nullptr,
       InvalidArgument,
       "PteDataMap loader, named_data or segments is null; most likely the program does not have any named_data segments");
-  return PteDataMap(loader, segment_base_offset, named_data, segments);
+  return PteDataMap(
+      loader,
+      segment_base_offset,
+      named_data,
+      segments,
+      task_runner,
+      are_keys_sorted(named_data));
 }
 
-ET_NODISCARD
-executorch::runtime::Result<executorch::runtime::FreeableBuffer>
-PteDataMap::get_data(const char* key) const {
+Result<size_t> PteDataMap::find_key(const char* key) const {
+  if (keys_sorted_) {
+    // create() checked that all keys are non-null.
+    size_t low = 0;
+    size_t high = named_data_->size();
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      const int cmp = std::strcmp(named_data_->Get(mid)->key()->c_str(), key);
+      if (cmp == 0) {
+        return mid;
+      } else if (cmp < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return Error::NotFound;
+  }
+
+  // Files from older serializers may not sort their keys.
   for (size_t i = 0; i < named_data_->size(); i++) {
     ET_CHECK_OR_RETURN_ERROR(
         named_data_->Get(i) != nullptr && named_data_->Get(i)->key() != nullptr,
@@ -35,30 +86,40 @@ PteDataMap::get_data(const char* key) const {
         "Searching for key %s: NamedData at index %zu is null",
         key,
         i);
-    if (strcmp(named_data_->Get(i)->key()->c_str(), key) == 0) {
-      // Get the segment index.
-      size_t segment_index = named_data_->Get(i)->segment_index();
-
-      // Get the segment offset and size.
-      ET_CHECK_OR_RETURN_ERROR(
-          segment_index < segments_->size(),
-          InvalidArgument,
-          "Segment index %zu for key %s is out of range for segments size %u",
-          segment_index,
-          key,
-          segments_->size());
-      size_t segment_offset = segments_->Get(segment_index)->offset();
-      size_t segment_size = segments_->Get(segment_index)->size();
-
-      return loader_->load(
-          /*offset=*/segment_base_offset_ + segment_offset,
-          segment_size,
-          DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External));
+    if (std::strcmp(named_data_->Get(i)->key()->c_str(), key) == 0) {
+      return i;
     }
   }
   return Error::NotFound;
 }
 
+ET_NODISCARD
+executorch::runtime::Result<executorch::runtime::FreeableBuffer>
+PteDataMap::get_data(const char* key) const {
+  Result<size_t> index = find_key(key);
+  if (!index.ok()) {
+    return index.error();
+  }
+  // Get the segment index.
+  size_t segment_index = named_data_->Get(index.get())->segment_index();
+
+  // Get the segment offset and size.
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_index < segments_->size(),
+      InvalidArgument,
+      "Segment index %zu for key %s is out of range for segments size %u",
+      segment_index,
+      key,
+      segments_->size());
+
+  return load_data_segment(
+      loader_,
+      segment_base_offset_,
+      segments_->Get(segment_index),
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External),
+      task_runner_);
+}
+
 ET_NODISCARD executorch::runtime::Result<size_t> PteDataMap::get_num_keys()
     const {
   return named_data_->size();
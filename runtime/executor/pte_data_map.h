@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/data_loader.h>
 #include <executorch/runtime/core/named_data_map.h>
+#include <executorch/runtime/executor/parallel_task_runner.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
 // include the generated flatbuffer header.
@@ -66,12 +67,15 @@ class PteDataMap final : public NamedDataMap {
    * passed here must outlive the PteDataMap instance.
    * @param[in] segments The segments from the PTE file. Note: the pointer
    * passed here must outlive the PteDataMap instance.
+   * @param[in] task_runner If not null, used to decompress compressed segments
+   * in parallel. Note: must outlive the PteDataMap instance.
    */
   static Result<PteDataMap> create(
       DataLoader* loader,
       size_t segment_base_offset,
       const flatbuffers::FlatbufferNamedData* named_data,
-      const flatbuffers::FlatbufferDataSegment* segments);
+      const flatbuffers::FlatbufferDataSegment* segments,
+      ParallelTaskRunner* task_runner = nullptr);
 
   /**
    * The PteDataMap currently only handles opaque data that does not contain
@@ -122,17 +126,27 @@ class PteDataMap final : public NamedDataMap {
       DataLoader* loader,
       size_t segment_base_offset,
       const flatbuffers::FlatbufferNamedData* named_data,
-      const flatbuffers::FlatbufferDataSegment* segments)
+      const flatbuffers::FlatbufferDataSegment* segments,
+      ParallelTaskRunner* task_runner,
+      bool keys_sorted)
       : loader_(loader),
         segment_base_offset_(segment_base_offset),
         named_data_(named_data),
-        segments_(segments) {}
+        segments_(segments),
+        task_runner_(task_runner),
+        keys_sorted_(keys_sorted) {}
 
   // Not copyable or assignable.
   PteDataMap(const PteDataMap& rhs) = delete;
   PteDataMap& operator=(PteDataMap&& rhs) noexcept = delete;
   PteDataMap& operator=(const PteDataMap& rhs) = delete;
 
+  /**
+   * Returns the index of the named_data entry with the given key, or
+   * Error::NotFound.
+   */
+  Result<size_t> find_key(const char* key) const;
+
   // Data loader, used to load segment data.
   DataLoader* loader_;
 
@@ -144,6 +158,13 @@ class PteDataMap final : public NamedDataMap {
 
   // Segments, to retrieve offset and size for the loader.
   const flatbuffers::FlatbufferDataSegment* segments_;
+
+  // Decompresses compressed segments in parallel. May be null.
+  ParallelTaskRunner* task_runner_;
+
+  // True if the keys of named_data are non-null and strictly increasing, so
+  // that find_key() can binary search them.
+  bool keys_sorted_;
 };
 
 } // namespace internal
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/segment_compression.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/runtime/platform/platform.h>
+#include <executorch/runtime/platform/profiler.h>
+
+namespace executorch {
+namespace runtime {
+namespace internal {
+
+namespace {
+
+constexpr size_t kLz4MinMatch = 4;
+
+/**
+ * Reads the extra bytes of a length field of an LZ4 token that is saturated at
+ * 15, adding them to *length. Returns false if the block ends first or the
+ * length overflows.
+ */
+bool lz4_read_length(const uint8_t** ip, const uint8_t* iend, size_t* length) {
+  uint8_t byte = 0;
+  do {
+    if (*ip >= iend) {
+      return false;
+    }
+    byte = *(*ip)++;
+    if (*length > SIZE_MAX - byte) {
+      return false;
+    }
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+} // namespace
+
+Result<size_t> lz4_decompress_block(
+    const void* src,
+    size_t src_size,
+    void* dst,
+    size_t dst_size) {
+  const uint8_t* ip = static_cast<const uint8_t*>(src);
+  const uint8_t* const iend = ip + src_size;
+  uint8_t* const ostart = static_cast<uint8_t*>(dst);
+  uint8_t* op = ostart;
+  uint8_t* const oend = ostart + dst_size;
+
+  while (true) {
+    ET_CHECK_OR_RETURN_ERROR(ip < iend, InvalidProgram, "Truncated LZ4 block");
+    const uint8_t token = *ip++;
+
+    // Copy the literals.
+    size_t literal_length = token >> 4;
+    ET_CHECK_OR_RETURN_ERROR(
+        literal_length != 15 || lz4_read_length(&ip, iend, &literal_length),
+        InvalidProgram,
+        "Truncated LZ4 literal length");
+    ET_CHECK_OR_RETURN_ERROR(
+        literal_length <= static_cast<size_t>(iend - ip) &&
+            literal_length <= static_cast<size_t>(oend - op),
+        InvalidProgram,
+        "LZ4 literals overflow the block or the output");
+    std::memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    // The last sequence of a block has literals only.
+    if (ip == iend) {
+      break;
+    }
+
+    // Copy the match.
+    ET_CHECK_OR_RETURN_ERROR(
+        iend - ip >= 2, InvalidProgram, "Truncated LZ4 match offset");
+    const size_t match_offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    ET_CHECK_OR_RETURN_ERROR(
+        match_offset != 0 && match_offset <= static_cast<size_t>(op - ostart),
+        InvalidProgram,
+        "Invalid LZ4 match offset %zu",
+        match_offset);
+    size_t match_length = token & 15;
+    ET_CHECK_OR_RETURN_ERROR(
+        match_length != 15 || lz4_read_length(&ip, iend, &match_length),
+        InvalidProgram,
+        "Truncated LZ4 match length");
+    match_length += kLz4MinMatch;
+    ET_CHECK_OR_RETURN_ERROR(
+        match_length <= static_cast<size_t>(oend - op),
+        InvalidProgram,
+        "LZ4 match overflows the output");
+    const uint8_t* match = op - match_offset;
+    if (match_offset >= match_length) {
+      std::memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      // The match overlaps the bytes it produces, e.g. to repeat a short
+      // pattern, so it must be copied in order.
+      for (size_t i = 0; i < match_length; ++i) {
+        *op++ = *match++;
+      }
+    }
+  }
+  return static_cast<size_t>(op - ostart);
+}
+
+void unshuffle_bytes(
+    const uint8_t* src,
+    size_t size,
+    size_t element_size,
+    uint8_t* dst) {
+  const size_t num_elements = size / element_size;
+  for (size_t i = 0; i < num_elements; ++i) {
+    for (size_t j = 0; j < element_size; ++j) {
+      dst[i * element_size + j] = src[j * num_elements + i];
+    }
+  }
+  const size_t whole = num_elements * element_size;
+  std::memcpy(dst + whole, src + whole, size - whole);
+}
+
+} // namespace internal
+
+namespace {
+
+/// The maximum number of chunks to decompress per ParallelTaskRunner::run().
+constexpr size_t kMaxChunksPerBatch = 64;
+
+/// Decompresses a whole chunk of `size` bytes into `dst`.
+Error decompress_chunk(
+    const uint8_t* src,
+    size_t src_size,
+    uint8_t* dst,
+    size_t size) {
+  Result<size_t> decompressed_size =
+      internal::lz4_decompress_block(src, src_size, dst, size);
+  if (!decompressed_size.ok()) {
+    return decompressed_size.error();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      decompressed_size.get() == size,
+      InvalidProgram,
+      "Chunk decompressed to %zu bytes, expected %zu",
+      decompressed_size.get(),
+      size);
+  return Error::Ok;
+}
+
+/// State shared by the tasks that decompress a batch of chunks.
+struct ChunkBatch {
+  const SegmentCompression* compression;
+  /// The index of the chunk of the first task.
+  size_t first_chunk;
+  /// The compressed data of each chunk of the batch.
+  const uint8_t* chunk_data[kMaxChunksPerBatch];
+  /// The range of the uncompressed data to write to `buffer`.
+  size_t offset;
+  size_t size;
+  uint8_t* buffer;
+  Error errors[kMaxChunksPerBatch];
+};
+
+Error decompress_chunk_range(const ChunkBatch& batch, size_t task_index) {
+  const SegmentCompression& compression = *batch.compression;
+  const size_t chunk_index = batch.first_chunk + task_index;
+  const uint8_t* src = batch.chunk_data[task_index];
+  const size_t src_size =
+      static_cast<size_t>(compression.chunk_compressed_sizes[chunk_index]);
+  const size_t chunk_begin = chunk_index * compression.chunk_size;
+  const size_t chunk_size = std::min(
+      compression.chunk_size, compression.uncompressed_size - chunk_begin);
+
+  // The part of the chunk that the range covers.
+  const size_t copy_begin = std::max(chunk_begin, batch.offset);
+  const size_t copy_end =
+      std::min(chunk_begin + chunk_size, batch.offset + batch.size);
+  uint8_t* dst = batch.buffer + (copy_begin - batch.offset);
+  const bool whole_chunk =
+      copy_begin == chunk_begin && copy_end == chunk_begin + chunk_size;
+  const bool shuffled = compression.shuffle_element_size > 1;
+  if (whole_chunk && !shuffled) {
+    return decompress_chunk(src, src_size, dst, chunk_size);
+  }
+
+  // Chunks decompress in one piece, so partial chunks need a scratch buffer, as
+  // do shuffled chunks to unshuffle from.
+  const size_t scratch_size =
+      !whole_chunk && shuffled ? 2 * chunk_size : chunk_size;
+  uint8_t* scratch = static_cast<uint8_t*>(et_pal_allocate(scratch_size));
+  ET_CHECK_OR_RETURN_ERROR(
+      scratch != nullptr,
+      MemoryAllocationFailed,
+      "Failed to allocate %zu bytes to decompress chunk %zu",
+      scratch_size,
+      chunk_index);
+  Error err = decompress_chunk(src, src_size, scratch, chunk_size);
+  if (err == Error::Ok) {
+    const uint8_t* chunk = scratch;
+    if (shuffled) {
+      uint8_t* unshuffled = whole_chunk ? dst : scratch + chunk_size;
+      internal::unshuffle_bytes(
+          scratch, chunk_size, compression.shuffle_element_size, unshuffled);
+      chunk = unshuffled;
+    }
+    if (!whole_chunk) {
+      std::memcpy(
+          dst, chunk + (copy_begin - chunk_begin), copy_end - copy_begin);
+    }
+  }
+  et_pal_free(scratch);
+  return err;
+}
+
+void run_chunk_task(void* context, size_t task_index) {
+  auto* batch = static_cast<ChunkBatch*>(context);
+  batch->errors[task_index] = decompress_chunk_range(*batch, task_index);
+}
+
+void free_compressed_segment(void* context, void* data, size_t size) {
+  (void)data;
+  (void)size;
+  et_pal_free(context);
+}
+
+} // namespace
+
+Error load_compressed_segment_into(
+    DataLoader* loader,
+    size_t segment_offset,
+    const DataLoader::SegmentInfo& segment_info,
+    const SegmentCompression& compression,
+    size_t offset,
+    size_t size,
+    void* buffer,
+    ParallelTaskRunner* task_runner) {
+  EXECUTORCH_SCOPE_PROF("load_compressed_segment_into");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset <= compression.uncompressed_size &&
+          size <= compression.uncompressed_size - offset,
+      InvalidArgument,
+      "Range offset %zu size %zu overflows uncompressed segment of %zu bytes",
+      offset,
+      size,
+      compression.uncompressed_size);
+  if (size == 0) {
+    return Error::Ok;
+  }
+
+  // Read only the compressed chunks that overlap the range.
+  const size_t first_chunk = offset / compression.chunk_size;
+  const size_t end_chunk = (offset + size - 1) / compression.chunk_size + 1;
+  size_t compressed_begin = 0;
+  for (size_t i = 0; i < first_chunk; ++i) {
+    compressed_begin += compression.chunk_compressed_sizes[i];
+  }
+  size_t compressed_size = 0;
+  for (size_t i = first_chunk; i < end_chunk; ++i) {
+    compressed_size += compression.chunk_compressed_sizes[i];
+  }
+  Result<FreeableBuffer> compressed = loader->load(
+      segment_offset + compressed_begin, compressed_size, segment_info);
+  if (!compressed.ok()) {
+    return compressed.error();
+  }
+
+  ChunkBatch batch;
+  batch.compression = &compression;
+  batch.offset = offset;
+  batch.size = size;
+  batch.buffer = static_cast<uint8_t*>(buffer);
+  const uint8_t* chunk_data =
+      static_cast<const uint8_t*>(compressed.get().data());
+  for (size_t begin = first_chunk; begin < end_chunk;
+       begin += kMaxChunksPerBatch) {
+    const size_t num_chunks = std::min(end_chunk - begin, kMaxChunksPerBatch);
+    batch.first_chunk = begin;
+    for (size_t i = 0; i < num_chunks; ++i) {
+      batch.chunk_data[i] = chunk_data;
+      chunk_data += compression.chunk_compressed_sizes[begin + i];
+    }
+    if (task_runner != nullptr && num_chunks > 1) {
+      task_runner->run(run_chunk_task, &batch, num_chunks);
+    } else {
+      for (size_t i = 0; i < num_chunks; ++i) {
+        run_chunk_task(&batch, i);
+      }
+    }
+    for (size_t i = 0; i < num_chunks; ++i) {
+      if (batch.errors[i] != Error::Ok) {
+        ET_LOG(
+            Error,
+            "Failed to decompress chunk %zu of segment %zu: 0x%" PRIx32,
+            begin + i,
+            segment_info.segment_index,
+            static_cast<uint32_t>(batch.errors[i]));
+        return batch.errors[i];
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+Result<FreeableBuffer> load_compressed_segment(
+    DataLoader* loader,
+    size_t segment_offset,
+    const DataLoader::SegmentInfo& segment_info,
+    const SegmentCompression& compression,
+    size_t offset,
+    size_t size,
+    ParallelTaskRunner* task_runner) {
+  void* allocation = et_pal_allocate(size + kCompressedSegmentAlignment);
+  ET_CHECK_OR_RETURN_ERROR(
+      allocation != nullptr,
+      MemoryAllocationFailed,
+      "Failed to allocate %zu bytes to decompress segment %zu",
+      size + kCompressedSegmentAlignment,
+      segment_info.segment_index);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(allocation);
+  void* data = reinterpret_cast<void*>(
+      (address + kCompressedSegmentAlignment - 1) &
+      ~(kCompressedSegmentAlignment - 1));
+  Error err = load_compressed_segment_into(
+      loader,
+      segment_offset,
+      segment_info,
+      compression,
+      offset,
+      size,
+      data,
+      task_runner);
+  if (err != Error::Ok) {
+    et_pal_free(allocation);
+    return err;
+  }
+  return FreeableBuffer(data, size, free_compressed_segment, allocation);
+}
+
+} // namespace runtime
+} // namespace executorch
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/parallel_task_runner.h>
+#include <executorch/runtime/platform/compiler.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Alignment of the buffers that load_compressed_segment() allocates. The
+ * serializer does not compress segments whose data needs a larger alignment.
+ */
+constexpr size_t kCompressedSegmentAlignment = 64;
+
+/**
+ * Describes how the data of a compressed segment is encoded. Mirrors the
+ * SegmentCompression table of schema/program.fbs and of the flat_tensor
+ * schema: the uncompressed data is split into chunks of `chunk_size` bytes that
+ * are compressed independently and stored back to back.
+ */
+struct SegmentCompression {
+  enum class Algorithm : uint8_t {
+    /// The LZ4 block format.
+    LZ4 = 1,
+  };
+
+  /// The algorithm that the chunks are compressed with.
+  Algorithm algorithm;
+  /// The size in bytes of the uncompressed data.
+  size_t uncompressed_size;
+  /// The size in bytes of each uncompressed chunk, except the last one.
+  size_t chunk_size;
+  /// The size in bytes of each compressed chunk.
+  Span<const uint64_t> chunk_compressed_sizes;
+  /// If greater than 1, the bytes of each chunk were grouped by their position
+  /// in elements of this size before compressing it.
+  size_t shuffle_element_size;
+};
+
+/**
+ * Converts a SegmentCompression flatbuffer table of the program or flat_tensor
+ * schema, and checks that its fields are consistent.
+ *
+ * @param[in] compression The flatbuffer table.
+ * @param[in] segment_size The size of the compressed segment data.
+ *
+ * @retval Error::NotSupported The algorithm is not supported.
+ * @retval Error::InvalidProgram The fields are inconsistent.
+ */
+template <typename FlatbufferSegmentCompression>
+ET_NODISCARD Result<SegmentCompression> parse_segment_compression(
+    const FlatbufferSegmentCompression* compression,
+    size_t segment_size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      static_cast<uint8_t>(compression->algorithm()) ==
+          static_cast<uint8_t>(SegmentCompression::Algorithm::LZ4),
+      NotSupported,
+      "Unsupported segment compression algorithm %u",
+      static_cast<unsigned>(compression->algorithm()));
+  ET_CHECK_OR_RETURN_ERROR(
+      compression->chunk_size() > 0 &&
+          compression->chunk_compressed_sizes() != nullptr,
+      InvalidProgram,
+      "Compressed segment has no chunks");
+  const uint64_t uncompressed_size = compression->uncompressed_size();
+  const uint64_t chunk_size = compression->chunk_size();
+  const size_t num_chunks = compression->chunk_compressed_sizes()->size();
+  ET_CHECK_OR_RETURN_ERROR(
+      num_chunks ==
+              uncompressed_size / chunk_size +
+                  (uncompressed_size % chunk_size != 0) &&
+          uncompressed_size <= SIZE_MAX,
+      InvalidProgram,
+      "%zu chunks of size %" PRIu64 " cannot hold %" PRIu64 " bytes",
+      num_chunks,
+      chunk_size,
+      uncompressed_size);
+  uint64_t compressed_size = 0;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const uint64_t chunk_compressed_size =
+        compression->chunk_compressed_sizes()->Get(i);
+    ET_CHECK_OR_RETURN_ERROR(
+        chunk_compressed_size <= segment_size - compressed_size,
+        InvalidProgram,
+        "Compressed chunk %zu overflows segment of %zu bytes",
+        i,
+        segment_size);
+    compressed_size += chunk_compressed_size;
+  }
+  return SegmentCompression{
+      SegmentCompression::Algorithm::LZ4,
+      static_cast<size_t>(uncompressed_size),
+      static_cast<size_t>(chunk_size),
+      Span<const uint64_t>(
+          compression->chunk_compressed_sizes()->data(), num_chunks),
+      compression->shuffle_element_size(),
+  };
+}
+
+/**
+ * Loads a range of the uncompressed data of a compressed segment into a
+ * buffer. Only the chunks that overlap the range are read and decompressed;
+ * chunks that the range covers entirely are decompressed directly into the
+ * buffer.
+ *
+ * @param[in] loader The loader of the file that contains the segment.
+ * @param[in] segment_offset The offset of the compressed data in the file.
+ * @param[in] segment_info Describes the segment to the loader.
+ * @param[in] compression How the segment is compressed.
+ * @param[in] offset The offset of the range in the uncompressed data.
+ * @param[in] size The size of the range.
+ * @param[out] buffer The buffer to decompress into. Must point to at least
+ *     `size` bytes of memory.
+ * @param[in] task_runner If not null, used to decompress chunks in parallel.
+ *
+ * @retval Error::InvalidArgument The range is out of bounds.
+ * @retval Error::InvalidProgram The compressed data is malformed.
+ * @returns Other errors depending on the implementation of DataLoader.
+ */
+ET_NODISCARD Error load_compressed_segment_into(
+    DataLoader* loader,
+    size_t segment_offset,
+    const DataLoader::SegmentInfo& segment_info,
+    const SegmentCompression& compression,
+    size_t offset,
+    size_t size,
+    void* buffer,
+    ParallelTaskRunner* task_runner = nullptr);
+
+/**
+ * Like load_compressed_segment_into(), but decompresses into a buffer of
+ * `size` bytes aligned to kCompressedSegmentAlignment, allocated with
+ * et_pal_allocate().
+ *
+ * @retval Error::MemoryAllocationFailed The buffer could not be allocated.
+ */
+ET_NODISCARD Result<FreeableBuffer> load_compressed_segment(
+    DataLoader* loader,
+    size_t segment_offset,
+    const DataLoader::SegmentInfo& segment_info,
+    const SegmentCompression& compression,
+    size_t offset,
+    size_t size,
+    ParallelTaskRunner* task_runner = nullptr);
+
+/**
+ * Loads a whole DataSegment of the program or flat_tensor schema, decompressing
+ * it if it is compressed.
+ *
+ * @param[in] loader The loader of the file that contains the segment.
+ * @param[in] segment_base_offset The offset of the first segment in the file.
+ * @param[in] segment The flatbuffer table of the segment.
+ * @param[in] segment_info Describes the segment to the loader.
+ * @param[in] task_runner If not null, used to decompress chunks in parallel.
+ */
+template <typename FlatbufferDataSegment>
+ET_NODISCARD Result<FreeableBuffer> load_data_segment(
+    DataLoader* loader,
+    size_t segment_base_offset,
+    const FlatbufferDataSegment* segment,
+    const DataLoader::SegmentInfo& segment_info,
+    ParallelTaskRunner* task_runner = nullptr) {
+  const size_t segment_offset = segment_base_offset + segment->offset();
+  if (segment->compression() == nullptr) {
+    return loader->load(segment_offset, segment->size(), segment_info);
+  }
+  Result<SegmentCompression> compression =
+      parse_segment_compression(segment->compression(), segment->size());
+  if (!compression.ok()) {
+    return compression.error();
+  }
+  return load_compressed_segment(
+      loader,
+      segment_offset,
+      segment_info,
+      compression.get(),
+      /*offset=*/0,
+      compression->uncompressed_size,
+      task_runner);
+}
+
+namespace internal {
+
+/**
+ * Decompresses a block in the LZ4 block format.
+ *
+ * @returns The number of bytes written to `dst`, or Error::InvalidProgram if
+ *     the block is malformed or does not fit in `dst_size` bytes.
+ */
+ET_NODISCARD Result<size_t> lz4_decompress_block(
+    const void* src,
+    size_t src_size,
+    void* dst,
+    size_t dst_size);
+
+/**
+ * Reverses the byte shuffle of a chunk: scatters the i-th group of bytes to the
+ * i-th byte of every element of `element_size` bytes. Bytes after the last
+ * whole element are copied as is.
+ */
+void unshuffle_bytes(
+    const uint8_t* src,
+    size_t size,
+    size_t element_size,
+    uint8_t* dst);
+
+} // namespace internal
+
+} // namespace runtime
+} // namespace executorch
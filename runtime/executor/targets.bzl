@@ -42,6 +42,61 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "external_constant_resolver",
+        exported_headers = [
+            "external_constant_resolver.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "parallel_task_runner",
+        exported_headers = [
+            "parallel_task_runner.h",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "verification_cache",
+        exported_headers = [
+            "verification_cache.h",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "segment_compression",
+        srcs = [
+            "segment_compression.cpp",
+        ],
+        exported_headers = [
+            "segment_compression.h",
+        ],
+        exported_deps = [
+            ":parallel_task_runner",
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     runtime.cxx_library(
         name = "pte_data_map",
         srcs = [
@@ -55,10 +110,12 @@ def define_common_targets():
             "@EXECUTORCH_CLIENTS",
         ],
         exported_deps = [
+            ":parallel_task_runner",
             "//executorch/runtime/core:core",
             "//executorch/runtime/core:named_data_map",
         ],
         deps = [
+            ":segment_compression",
             "//executorch/schema:program",
         ],
         exported_preprocessor_flags = [] if runtime.is_oss else ["-DEXECUTORCH_INTERNAL_FLATBUFFERS=1"],
@@ -102,8 +159,12 @@ def define_common_targets():
             }),
             preprocessor_flags = _program_preprocessor_flags(),
             exported_deps = [
+                ":external_constant_resolver",
                 ":memory_manager",
+                ":parallel_task_runner",
                 ":pte_data_map",
+                ":segment_compression",
+                ":verification_cache",
                 "//executorch/runtime/backend:interface",
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core:named_data_map",
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <functional>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include <executorch/extension/data_loader/buffer_data_loader.h>
@@ -29,17 +30,20 @@
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
+using executorch::runtime::BackendCompletion;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
 using executorch::runtime::BackendInterface;
 using executorch::runtime::CompileSpec;
 using executorch::runtime::DataLoader;
 using executorch::runtime::DelegateHandle;
+using executorch::runtime::DeviceBuffer;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Method;
+using executorch::runtime::ParallelTaskRunner;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
 using executorch::runtime::testing::ManagedMemoryManager;
@@ -79,6 +83,14 @@ class StubBackend final : public BackendInterface {
     init_fn_ = fn;
   }
 
+  void set_init_thread_safe(bool thread_safe) {
+    init_thread_safe_ = thread_safe;
+  }
+
+  bool is_init_thread_safe() const override {
+    return init_thread_safe_;
+  }
+
   Result<DelegateHandle*> init(
       BackendInitContext& context,
       FreeableBuffer* processed,
@@ -105,6 +117,21 @@ class StubBackend final : public BackendInterface {
     return Error::Ok;
   }
 
+  void install_execute_async(ExecuteFn fn) {
+    execute_async_fn_ = fn;
+  }
+
+  Error execute_async(
+      BackendExecutionContext& context,
+      DelegateHandle* handle,
+      EValue** args) const override {
+    if (execute_async_fn_) {
+      return execute_async_fn_.value()(context, handle, args);
+    }
+    // Behave like the default implementation otherwise.
+    return execute(context, handle, args);
+  }
+
   void install_destroy(DestroyFn fn) {
     destroy_fn_ = fn;
   }
@@ -122,7 +149,9 @@ class StubBackend final : public BackendInterface {
     is_available_fn_.reset();
     init_fn_.reset();
     execute_fn_.reset();
+    execute_async_fn_.reset();
     destroy_fn_.reset();
+    init_thread_safe_ = false;
   }
 
   /**
@@ -154,7 +183,9 @@ class StubBackend final : public BackendInterface {
   std::optional<IsAvailableFn> is_available_fn_;
   std::optional<InitFn> init_fn_;
   std::optional<ExecuteFn> execute_fn_;
+  std::optional<ExecuteFn> execute_async_fn_;
   std::optional<DestroyFn> destroy_fn_;
+  bool init_thread_safe_ = false;
 };
 
 bool StubBackend::registered_ = false;
@@ -168,12 +199,12 @@ class DataLoaderSpy final : public DataLoader {
  public:
   /// A record of an operation performed on this DataLoader.
   struct Operation {
-    enum { Load, Free } op;
-    size_t offset; // Set for Load; zero for Free.
-    void* data; // Set for Free; nullptr for Load.
-    size_t size; // Set for Load and Free.
+    enum { Load, Free, Prefetch, Release } op;
+    size_t offset; // Set for Load, Prefetch and Release; zero for Free.
+    void* data; // Set for Free and Release; nullptr for Load and Prefetch.
+    size_t size; // Set for all operations.
     std::unique_ptr<const DataLoader::SegmentInfo>
-        segment_info; // Set for Load; nullptr for Free.
+        segment_info; // Set for Load and Prefetch; nullptr for Free.
   };
 
   explicit DataLoaderSpy(DataLoader* delegate) : delegate_(delegate) {}
@@ -201,6 +232,30 @@ class DataLoaderSpy final : public DataLoader {
         context->buffer.data(), context->buffer.size(), FreeBuffer, context);
   }
 
+  Error prefetch(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const override {
+    operations_.push_back(
+        {Operation::Prefetch,
+         offset,
+         /*data=*/nullptr,
+         size,
+         /*segment_info=*/
+         std::make_unique<const DataLoader::SegmentInfo>(segment_info)});
+    return delegate_->prefetch(offset, size, segment_info);
+  }
+
+  Error release(const FreeableBuffer& buffer, size_t offset, size_t size)
+      const override {
+    void* data =
+        const_cast<uint8_t*>(static_cast<const uint8_t*>(buffer.data())) +
+        offset;
+    operations_.push_back(
+        {Operation::Release, offset, data, size, /*segment_info=*/nullptr});
+    return delegate_->release(buffer, offset, size);
+  }
+
   Result<size_t> size() const override {
     return delegate_->size();
   }
@@ -239,6 +294,19 @@ class DataLoaderSpy final : public DataLoader {
     return false;
   }
 
+  /**
+   * Returns true if the operations list shows that the memory at the provided
+   * data pointer was released.
+   */
+  bool WasReleased(const void* data) const {
+    for (const auto& op : operations_) {
+      if (op.op == Operation::Release && op.data == data) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   /**
    * Returns true if the operations list shows that the provided data pointer
    * was freed.
@@ -420,6 +488,9 @@ TEST_P(BackendIntegrationTest, FreeingProcessedBufferSucceeds) {
     // Didn't use the loader to create the FreeableBuffer that was passed to the
     // backend, so we can't see its Free() call.
     EXPECT_FALSE(processed_was_freed);
+    // But the data is part of the program data, which the loader is told it
+    // may release.
+    EXPECT_TRUE(spy_loader.WasReleased(processed_data));
   }
 }
 
@@ -565,6 +636,45 @@ TEST_P(BackendIntegrationTest, SegmentInfoIsPassedIntoDataLoader) {
   EXPECT_EQ(backend_load_was_called, using_segments());
 }
 
+TEST_P(BackendIntegrationTest, PrefetchMethodHintsBackendSegments) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  DataLoaderSpy spy_loader(&loader.get());
+
+  Result<Program> program = Program::load(&spy_loader);
+  ASSERT_EQ(program.error(), Error::Ok);
+  EXPECT_EQ(program->prefetch_method("not_a_method"), Error::InvalidArgument);
+  ASSERT_EQ(program->prefetch_method("forward"), Error::Ok);
+
+  // Only programs with extracted segments have anything to prefetch.
+  std::vector<std::pair<size_t, size_t>> prefetched;
+  for (const auto& op : spy_loader.operations()) {
+    if (op.op == DataLoaderSpy::Operation::Prefetch) {
+      EXPECT_EQ(
+          op.segment_info->segment_type,
+          DataLoader::SegmentInfo::Type::Backend);
+      EXPECT_STREQ(op.segment_info->descriptor, "StubBackend");
+      prefetched.emplace_back(op.offset, op.size);
+    }
+  }
+  EXPECT_EQ(!prefetched.empty(), using_segments());
+
+  // Loading the method reads the same ranges that were prefetched.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  for (const auto& range : prefetched) {
+    bool loaded = false;
+    for (const auto& op : spy_loader.operations()) {
+      if (op.op == DataLoaderSpy::Operation::Load &&
+          op.offset == range.first && op.size == range.second) {
+        loaded = true;
+      }
+    }
+    EXPECT_TRUE(loaded);
+  }
+}
+
 TEST_P(BackendIntegrationTest, GetMethodNameDuringInitSuccess) {
   Result<FileDataLoader> loader = FileDataLoader::from(program_path());
   ASSERT_EQ(loader.error(), Error::Ok);
@@ -607,6 +717,211 @@ TEST_P(BackendIntegrationTest, GetMethodNameDuringExecuteSuccess) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+/**
+ * A ParallelTaskRunner that runs the tasks in reverse order on the calling
+ * thread, and counts how many tasks it ran.
+ */
+class CountingTaskRunner final : public ParallelTaskRunner {
+ public:
+  void run(TaskFn fn, void* context, size_t num_tasks) override {
+    for (size_t i = num_tasks; i > 0; --i) {
+      fn(context, i - 1);
+    }
+    num_tasks_run += num_tasks;
+  }
+
+  size_t num_tasks_run = 0;
+};
+
+TEST_P(BackendIntegrationTest, ThreadSafeInitRunsOnInitTaskRunner) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  CountingTaskRunner runner;
+  size_t num_inits = 0;
+  StubBackend::singleton().set_init_thread_safe(true);
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> {
+        // Runtime allocations during a parallel init must still work.
+        void* handle =
+            backend_init_context.get_runtime_allocator()->allocate(64);
+        EXPECT_NE(handle, nullptr);
+        EXPECT_STREQ(backend_init_context.get_method_name(), "forward");
+        ++num_inits;
+        return handle;
+      });
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*named_data_map=*/nullptr,
+      /*init_task_runner=*/&runner);
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_GT(num_inits, 0);
+  EXPECT_EQ(runner.num_tasks_run, num_inits);
+  EXPECT_EQ(method->execute(), Error::Ok);
+}
+
+TEST_P(BackendIntegrationTest, ParallelInitFailureIsReturnedByLoadMethod) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  CountingTaskRunner runner;
+  StubBackend::singleton().set_init_thread_safe(true);
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> { return Error::DelegateInvalidHandle; });
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*named_data_map=*/nullptr,
+      /*init_task_runner=*/&runner);
+  EXPECT_EQ(method.error(), Error::DelegateInvalidHandle);
+}
+
+/**
+ * A BackendCompletion that counts how many times it was waited on.
+ */
+class CountingCompletion final : public BackendCompletion {
+ public:
+  explicit CountingCompletion(Error status = Error::Ok) : status_(status) {}
+
+  Error wait() override {
+    ++num_waits;
+    return status_;
+  }
+
+  int num_waits = 0;
+
+ private:
+  Error status_;
+};
+
+TEST_P(BackendIntegrationTest, AsyncExecuteIsWaitedOnBeforeExecuteReturns) {
+  CountingCompletion completion;
+  int num_calls = 0;
+  StubBackend::singleton().install_execute_async(
+      [&](BackendExecutionContext& backend_execution_context,
+          ET_UNUSED DelegateHandle* handle,
+          ET_UNUSED EValue** args) -> Error {
+        // Every earlier call must have been waited on before the handle is
+        // executed again.
+        EXPECT_EQ(completion.num_waits, num_calls);
+        ++num_calls;
+        backend_execution_context.set_completion(&completion);
+        return Error::Ok;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = executorch::extension::prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_GT(num_calls, 0);
+  EXPECT_EQ(completion.num_waits, num_calls);
+}
+
+TEST_P(BackendIntegrationTest, AsyncExecuteFailureIsReturnedByExecute) {
+  CountingCompletion completion(Error::Internal);
+  StubBackend::singleton().install_execute_async(
+      [&](BackendExecutionContext& backend_execution_context,
+          ET_UNUSED DelegateHandle* handle,
+          ET_UNUSED EValue** args) -> Error {
+        backend_execution_context.set_completion(&completion);
+        return Error::Ok;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = executorch::extension::prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  Error err = method->execute();
+  EXPECT_EQ(err, Error::Internal);
+  EXPECT_EQ(completion.num_waits, 1);
+}
+
+/**
+ * A DeviceBuffer that holds floats on the host, and counts how it was used.
+ */
+class FakeDeviceBuffer final : public DeviceBuffer {
+ public:
+  explicit FakeDeviceBuffer(float value) : value_(value) {}
+
+  Error copy_to_host(void* host_data, size_t nbytes) override {
+    ++num_copies;
+    for (size_t i = 0; i < nbytes / sizeof(float); ++i) {
+      static_cast<float*>(host_data)[i] = value_;
+    }
+    return Error::Ok;
+  }
+
+  void release() override {
+    ++num_releases;
+  }
+
+  int num_copies = 0;
+  int num_releases = 0;
+
+ private:
+  float value_;
+};
+
+TEST_P(BackendIntegrationTest, DeviceOutputIsCopiedToHostWhenExecuteEnds) {
+  FakeDeviceBuffer buffer(42.0f);
+  StubBackend::singleton().install_execute(
+      [&](BackendExecutionContext& backend_execution_context,
+          ET_UNUSED DelegateHandle* handle,
+          ET_UNUSED EValue** args) -> Error {
+        // The delegate of ModuleAddMul takes three inputs and then its output.
+        EXPECT_EQ(backend_execution_context.get_device_buffer(3), nullptr);
+        EXPECT_TRUE(backend_execution_context.set_device_buffer(3, &buffer));
+        return Error::Ok;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = executorch::extension::prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(buffer.num_copies, 1);
+  EXPECT_EQ(buffer.num_releases, 1);
+
+  const auto& output = method->get_output(0).toTensor();
+  for (int i = 0; i < output.numel(); ++i) {
+    EXPECT_EQ(output.const_data_ptr<float>()[i], 42.0f);
+  }
+}
+
 // TODO: Add more tests for the runtime-to-backend interface. E.g.:
 // - Errors during init() or execute() result in runtime init/execution failures
 // - Correct values are passed to init()/execute()
@@ -7,7 +7,10 @@
  */
 
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <filesystem>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
@@ -26,6 +29,8 @@ using executorch::extension::FlatTensorDataMap;
 using executorch::extension::prepare_input_tensors;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::MemoryManager;
 using executorch::runtime::Method;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
@@ -79,6 +84,8 @@ class MethodTest : public ::testing::Test {
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
     load_program(std::getenv("ET_MODULE_LINEAR_PATH"), "linear");
+    load_program(std::getenv("ET_MODULE_SHARED_STATE_PATH"), "shared_state");
+    load_program(std::getenv("ET_MODULE_NOOP_PATH"), "noop");
     load_program(
         std::getenv("DEPRECATED_ET_MODULE_LINEAR_CONSTANT_BUFFER_PATH"),
         "linear_constant_buffer");
@@ -339,6 +346,535 @@ TEST_F(MethodTest, ProgramDataSeparationTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+namespace {
+// Serves the layouts of another map, with all of their data set to zero.
+class ZeroDataMap final : public executorch::runtime::NamedDataMap {
+ public:
+  explicit ZeroDataMap(const NamedDataMap* base) : base_(base) {}
+
+  Result<const executorch::runtime::TensorLayout> get_metadata(
+      const char* key) const override {
+    return base_->get_metadata(key);
+  }
+  Result<executorch::runtime::FreeableBuffer> get_data(
+      const char* key) const override {
+    auto layout = base_->get_metadata(key);
+    if (!layout.ok()) {
+      return layout.error();
+    }
+    return executorch::runtime::FreeableBuffer(
+        std::calloc(layout->nbytes(), 1),
+        layout->nbytes(),
+        [](void*, void* data, size_t) { std::free(data); });
+  }
+  Error load_data_into(const char* key, void* buffer, size_t size)
+      const override {
+    std::memset(buffer, 0, size);
+    return base_->get_metadata(key).error();
+  }
+  Result<size_t> get_num_keys() const override {
+    return base_->get_num_keys();
+  }
+  Result<const char*> get_key(size_t index) const override {
+    return base_->get_key(index);
+  }
+
+ private:
+  const NamedDataMap* base_;
+};
+} // namespace
+
+TEST_F(MethodTest, UpdateExternalConstantsTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  const auto* linear_data = data_maps_["linear_data"].get();
+  Result<Method> method = programs_["linear_program"]->load_method(
+      "forward", &mmm.get(), nullptr, linear_data);
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& output = method->get_output(0).toTensor();
+  const std::vector<float> expected(
+      output.const_data_ptr<float>(),
+      output.const_data_ptr<float>() + output.numel());
+
+  // With all of the weights swapped for zeros, the output is zero.
+  ZeroDataMap zero_data(linear_data);
+  ASSERT_EQ(method->update_external_constants(&zero_data), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& zero_output = method->get_output(0).toTensor();
+  for (ssize_t i = 0; i < zero_output.numel(); ++i) {
+    EXPECT_EQ(zero_output.const_data_ptr<float>()[i], 0.0f);
+  }
+
+  // Switching back restores the original weights.
+  ASSERT_EQ(method->update_external_constants(linear_data), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& restored_output = method->get_output(0).toTensor();
+  for (ssize_t i = 0; i < restored_output.numel(); ++i) {
+    EXPECT_EQ(restored_output.const_data_ptr<float>()[i], expected[i]);
+  }
+
+  EXPECT_EQ(method->update_external_constants(nullptr), Error::InvalidArgument);
+}
+
+TEST_F(MethodTest, UpdateExternalConstantsRequiresMatchingKeys) {
+  // None of the tensors in the map are constants of this method.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(
+      method->update_external_constants(data_maps_["linear_data"].get()),
+      Error::NotFound);
+}
+
+namespace {
+// Points every external constant at zeros, and records which instructions
+// asked for them.
+class ZeroConstantResolver final
+    : public executorch::runtime::ExternalConstantResolver {
+ public:
+  explicit ZeroConstantResolver(const executorch::runtime::NamedDataMap* base)
+      : zeros_(base) {}
+
+  Result<const void*> resolve(
+      const char* key,
+      size_t chain_index,
+      size_t instruction_index) override {
+    (void)chain_index;
+    instruction_indices.push_back(instruction_index);
+    auto buffer = zeros_.get_data(key);
+    if (!buffer.ok()) {
+      return buffer.error();
+    }
+    buffers_.push_back(std::move(buffer.get()));
+    return buffers_.back().data();
+  }
+
+  std::vector<size_t> instruction_indices;
+
+ private:
+  ZeroDataMap zeros_;
+  std::deque<executorch::runtime::FreeableBuffer> buffers_;
+};
+} // namespace
+
+TEST_F(MethodTest, ExternalConstantResolverTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  const auto* linear_data = data_maps_["linear_data"].get();
+  Result<Method> method = programs_["linear_program"]->load_method(
+      "forward", &mmm.get(), nullptr, linear_data);
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& output = method->get_output(0).toTensor();
+  const std::vector<float> expected(
+      output.const_data_ptr<float>(),
+      output.const_data_ptr<float>() + output.numel());
+
+  // The constants are resolved right before the instructions that read them.
+  ZeroConstantResolver resolver(linear_data);
+  ASSERT_EQ(method->set_external_constant_resolver(&resolver), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  ASSERT_FALSE(resolver.instruction_indices.empty());
+  for (size_t i = 1; i < resolver.instruction_indices.size(); ++i) {
+    EXPECT_LE(
+        resolver.instruction_indices[i - 1], resolver.instruction_indices[i]);
+  }
+  const auto& zero_output = method->get_output(0).toTensor();
+  for (ssize_t i = 0; i < zero_output.numel(); ++i) {
+    EXPECT_EQ(zero_output.const_data_ptr<float>()[i], 0.0f);
+  }
+
+  // Removing the resolver restores the data loaded at init time.
+  ASSERT_EQ(method->set_external_constant_resolver(nullptr), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& restored_output = method->get_output(0).toTensor();
+  for (ssize_t i = 0; i < restored_output.numel(); ++i) {
+    EXPECT_EQ(restored_output.const_data_ptr<float>()[i], expected[i]);
+  }
+
+  // Methods without external constants have nothing to resolve.
+  ManagedMemoryManager add_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> add_method =
+      programs_["add"]->load_method("forward", &add_mmm.get());
+  ASSERT_EQ(add_method.error(), Error::Ok);
+  EXPECT_EQ(
+      add_method->set_external_constant_resolver(&resolver),
+      Error::NotSupported);
+}
+
+namespace {
+// Runs every task on the calling thread, in reverse order to catch code that
+// depends on task order.
+class ReverseOrderTaskRunner final
+    : public executorch::runtime::ParallelTaskRunner {
+ public:
+  void run(TaskFn fn, void* context, size_t num_tasks) override {
+    for (size_t i = num_tasks; i > 0; --i) {
+      fn(context, i - 1);
+    }
+  }
+};
+} // namespace
+
+TEST_F(MethodTest, ShareMutableBuffersTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  ManagedMemoryManager mmm2(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> forward =
+      programs_["shared_state"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(forward.error(), Error::Ok);
+  Result<Method> forward2 =
+      programs_["shared_state"]->load_method("forward2", &mmm2.get());
+  ASSERT_EQ(forward2.error(), Error::Ok);
+
+  Result<size_t> n_shared = forward2->share_mutable_buffers(*forward);
+  ASSERT_EQ(n_shared.error(), Error::Ok);
+  EXPECT_EQ(n_shared.get(), 1);
+
+  auto input_cleanup = prepare_input_tensors(*forward);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  auto input_cleanup2 = prepare_input_tensors(*forward2);
+  ASSERT_EQ(input_cleanup2.error(), Error::Ok);
+
+  // The inputs are ones; forward adds them to the state and forward2 adds
+  // twice them, both to the one state.
+  const float expected[] = {1.0f, 3.0f, 4.0f};
+  Method* const methods[] = {&forward.get(), &forward2.get(), &forward.get()};
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(methods[i]->execute(), Error::Ok);
+    const auto& output = methods[i]->get_output(0).toTensor();
+    for (ssize_t j = 0; j < output.numel(); ++j) {
+      EXPECT_EQ(output.const_data_ptr<float>()[j], expected[i]);
+    }
+  }
+}
+
+TEST_F(MethodTest, ShareMutableBuffersRequiresMatchingBuffers) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  ManagedMemoryManager mmm2(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> forward =
+      programs_["shared_state"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(forward.error(), Error::Ok);
+  Result<Method> add = programs_["add"]->load_method("forward", &mmm2.get());
+  ASSERT_EQ(add.error(), Error::Ok);
+
+  EXPECT_EQ(
+      forward->share_mutable_buffers(*forward).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(add->share_mutable_buffers(*forward).error(), Error::NotFound);
+}
+
+TEST_F(MethodTest, MoveMutableBuffersTest) {
+  // forward2 reuses the planned memory of forward, but not its state.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  std::vector<uint8_t> method_pool(kDefaultRuntimeMemBytes);
+  MemoryAllocator method_allocator(method_pool.size(), method_pool.data());
+  MemoryManager memory_manager(
+      &method_allocator, mmm.get().planned_memory(), nullptr);
+  std::vector<uint8_t> state_pool(1024);
+  MemoryAllocator state_allocator(state_pool.size(), state_pool.data());
+
+  Result<Method> forward =
+      programs_["shared_state"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(forward.error(), Error::Ok);
+  Result<size_t> n_moved = forward->move_mutable_buffers(&state_allocator);
+  ASSERT_EQ(n_moved.error(), Error::Ok);
+  EXPECT_EQ(n_moved.get(), 1);
+  Result<Method> forward2 =
+      programs_["shared_state"]->load_method("forward2", &memory_manager);
+  ASSERT_EQ(forward2.error(), Error::Ok);
+  Result<size_t> n_moved2 = forward2->move_mutable_buffers(&state_allocator);
+  ASSERT_EQ(n_moved2.error(), Error::Ok);
+  EXPECT_EQ(n_moved2.get(), 1);
+
+  // Each method keeps adding its inputs, which are ones, to its own state.
+  const float expected[] = {1.0f, 2.0f, 2.0f, 4.0f};
+  Method* const methods[] = {
+      &forward.get(), &forward2.get(), &forward.get(), &forward2.get()};
+  for (size_t i = 0; i < 4; ++i) {
+    auto input_cleanup = prepare_input_tensors(*methods[i]);
+    ASSERT_EQ(input_cleanup.error(), Error::Ok);
+    ASSERT_EQ(methods[i]->execute(), Error::Ok);
+    const auto& output = methods[i]->get_output(0).toTensor();
+    for (ssize_t j = 0; j < output.numel(); ++j) {
+      EXPECT_EQ(output.const_data_ptr<float>()[j], expected[i]);
+    }
+  }
+
+  EXPECT_EQ(
+      forward->move_mutable_buffers(nullptr).error(), Error::InvalidArgument);
+}
+
+TEST_F(MethodTest, GetMutableBufferTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["shared_state"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ASSERT_EQ(method->num_mutable_buffers(), 1);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+
+  // The buffer holds the state that the method updated.
+  Result<executorch::aten::Tensor> state = method->get_mutable_buffer(0);
+  ASSERT_EQ(state.error(), Error::Ok);
+  ASSERT_EQ(state->numel(), 4);
+  for (ssize_t i = 0; i < state->numel(); ++i) {
+    EXPECT_EQ(state->const_data_ptr<float>()[i], 1.0f);
+  }
+  EXPECT_EQ(method->get_mutable_buffer(1).error(), Error::InvalidArgument);
+}
+
+TEST_F(MethodTest, ParallelExecutionMatchesSequential) {
+  for (const char* name : {"add", "linear"}) {
+    ManagedMemoryManager sequential_mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> sequential =
+        programs_[name]->load_method("forward", &sequential_mmm.get());
+    ASSERT_EQ(sequential.error(), Error::Ok);
+    auto sequential_inputs = prepare_input_tensors(*sequential);
+    ASSERT_EQ(sequential_inputs.error(), Error::Ok);
+    ASSERT_EQ(sequential->execute(), Error::Ok);
+
+    ManagedMemoryManager parallel_mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> parallel =
+        programs_[name]->load_method("forward", &parallel_mmm.get());
+    ASSERT_EQ(parallel.error(), Error::Ok);
+    ReverseOrderTaskRunner runner;
+    ASSERT_EQ(parallel->set_parallel_execution(&runner), Error::Ok);
+    auto parallel_inputs = prepare_input_tensors(*parallel);
+    ASSERT_EQ(parallel_inputs.error(), Error::Ok);
+    // Run twice to make sure the schedule survives reset_execution().
+    ASSERT_EQ(parallel->execute(), Error::Ok);
+    ASSERT_EQ(parallel->execute(), Error::Ok);
+
+    ASSERT_EQ(parallel->outputs_size(), sequential->outputs_size());
+    for (size_t i = 0; i < parallel->outputs_size(); ++i) {
+      const auto& expected = sequential->get_output(i).toTensor();
+      const auto& actual = parallel->get_output(i).toTensor();
+      ASSERT_EQ(actual.nbytes(), expected.nbytes());
+      EXPECT_EQ(
+          memcmp(
+              actual.const_data_ptr(),
+              expected.const_data_ptr(),
+              expected.nbytes()),
+          0);
+    }
+
+    // Going back to sequential execution still works.
+    ASSERT_EQ(parallel->set_parallel_execution(nullptr), Error::Ok);
+    ASSERT_EQ(parallel->execute(), Error::Ok);
+  }
+}
+
+TEST_F(MethodTest, ParallelExecutionRequiresInitializedMethod) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  Method moved(std::move(method.get()));
+
+  // The moved-from Method is no longer initialized.
+  ReverseOrderTaskRunner runner;
+  EXPECT_EQ(method->set_parallel_execution(&runner), Error::InvalidState);
+  EXPECT_EQ(moved.set_parallel_execution(&runner), Error::Ok);
+}
+
+TEST_F(MethodTest, CloneWithMemoryMatchesOriginal) {
+  for (const char* name : {"add", "linear"}) {
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method =
+        programs_[name]->load_method("forward", &mmm.get());
+    ASSERT_EQ(method.error(), Error::Ok);
+
+    ManagedMemoryManager clone_mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> clone = method->clone_with_memory(&clone_mmm.get());
+    ASSERT_EQ(clone.error(), Error::Ok);
+
+    auto inputs = prepare_input_tensors(*method);
+    ASSERT_EQ(inputs.error(), Error::Ok);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    auto clone_inputs = prepare_input_tensors(*clone);
+    ASSERT_EQ(clone_inputs.error(), Error::Ok);
+    ASSERT_EQ(clone->execute(), Error::Ok);
+
+    ASSERT_EQ(clone->outputs_size(), method->outputs_size());
+    for (size_t i = 0; i < clone->outputs_size(); ++i) {
+      const auto& expected = method->get_output(i).toTensor();
+      const auto& actual = clone->get_output(i).toTensor();
+      // The clone writes its outputs to its own planned memory.
+      EXPECT_NE(actual.const_data_ptr(), expected.const_data_ptr());
+      ASSERT_EQ(actual.nbytes(), expected.nbytes());
+      EXPECT_EQ(
+          memcmp(
+              actual.const_data_ptr(),
+              expected.const_data_ptr(),
+              expected.nbytes()),
+          0);
+    }
+  }
+}
+
+TEST_F(MethodTest, CloneWithMemoryRequiresSeparateMemory) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(
+      method->clone_with_memory(&mmm.get()).error(), Error::InvalidArgument);
+  EXPECT_EQ(method->clone_with_memory(nullptr).error(), Error::InvalidArgument);
+
+  // A moved-from Method can't be cloned.
+  Method moved(std::move(method.get()));
+  ManagedMemoryManager clone_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  EXPECT_EQ(
+      method->clone_with_memory(&clone_mmm.get()).error(), Error::InvalidState);
+  EXPECT_EQ(moved.clone_with_memory(&clone_mmm.get()).error(), Error::Ok);
+}
+
+TEST_F(MethodTest, BindInputSharesPlannedInput) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto tensor_meta = method->method_meta().input_tensor_meta(0);
+  ASSERT_EQ(tensor_meta.error(), Error::Ok);
+  ASSERT_TRUE(tensor_meta->is_memory_planned());
+  ASSERT_EQ(tensor_meta->scalar_type(), executorch::aten::ScalarType::Float);
+
+  // A caller-owned tensor with the same shape and layout as input 0.
+  const auto meta_sizes = tensor_meta->sizes();
+  const auto meta_dim_order = tensor_meta->dim_order();
+  std::vector<int32_t> sizes(meta_sizes.begin(), meta_sizes.end());
+  std::vector<uint8_t> dim_order(meta_dim_order.begin(), meta_dim_order.end());
+  std::vector<int32_t> strides(sizes.size());
+  int32_t stride = 1;
+  for (size_t i = sizes.size(); i > 0; --i) {
+    strides[i - 1] = stride;
+    stride *= sizes[i - 1];
+  }
+  std::vector<float> buffer(tensor_meta->nbytes() / sizeof(float), 1.f);
+  executorch::aten::TensorImpl impl(
+      executorch::aten::ScalarType::Float,
+      sizes.size(),
+      sizes.data(),
+      buffer.data(),
+      dim_order.data(),
+      strides.data());
+
+  std::vector<EValue> inputs(method->inputs_size());
+  ASSERT_EQ(
+      method->bind_input(EValue(executorch::aten::Tensor(&impl)), 0),
+      Error::Ok);
+  ASSERT_EQ(method->get_inputs(inputs.data(), inputs.size()), Error::Ok);
+  EXPECT_EQ(inputs[0].toTensor().const_data_ptr(), buffer.data());
+
+  // set_input() copies into the planned buffer again.
+  ASSERT_EQ(
+      method->set_input(EValue(executorch::aten::Tensor(&impl)), 0),
+      Error::Ok);
+  ASSERT_EQ(method->get_inputs(inputs.data(), inputs.size()), Error::Ok);
+  EXPECT_NE(inputs[0].toTensor().const_data_ptr(), buffer.data());
+  EXPECT_EQ(inputs[0].toTensor().const_data_ptr<float>()[0], 1.f);
+}
+
+TEST_F(MethodTest, ShapeCacheHandlesRecurringShapes) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["cat"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ASSERT_EQ(method->enable_shape_cache(/*max_entries=*/2), Error::Ok);
+
+  // The model appends a row of ones to its [<=3, 4] input.
+  std::vector<float> input_data(12, 2.f);
+  std::vector<float> output_data(16, 0.f);
+  ASSERT_EQ(
+      method->set_output_data_ptr(
+          output_data.data(), output_data.size() * sizeof(float), 0),
+      Error::Ok);
+  // Revisits shapes both while they are cached and after they are evicted.
+  for (int32_t rows : {1, 3, 1, 2, 3, 3}) {
+    int32_t sizes[] = {rows, 4};
+    uint8_t dim_order[] = {0, 1};
+    int32_t strides[] = {4, 1};
+    executorch::aten::TensorImpl impl(
+        executorch::aten::ScalarType::Float,
+        2,
+        sizes,
+        input_data.data(),
+        dim_order,
+        strides);
+    ASSERT_EQ(
+        method->set_input(EValue(executorch::aten::Tensor(&impl)), 0),
+        Error::Ok);
+    ASSERT_EQ(method->execute(), Error::Ok);
+
+    const auto& output = method->get_output(0).toTensor();
+    ASSERT_EQ(output.size(0), rows + 1);
+    EXPECT_EQ(output.const_data_ptr<float>()[0], 2.f);
+    EXPECT_EQ(output.const_data_ptr<float>()[rows * 4], 1.f);
+  }
+
+  EXPECT_EQ(method->enable_shape_cache(0), Error::Ok);
+  EXPECT_EQ(method->execute(), Error::Ok);
+}
+
+TEST_F(MethodTest, PlannedMemoryUsage) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  const size_t num_instructions = method->num_instructions();
+  ASSERT_GT(num_instructions, 0);
+  const auto meta = method->method_meta();
+  ASSERT_GT(meta.num_memory_planned_buffers(), 0);
+
+  std::vector<size_t> live_bytes(num_instructions);
+  ASSERT_EQ(
+      method->get_planned_memory_usage(
+          0, {live_bytes.data(), live_bytes.size()}),
+      Error::Ok);
+  // Every instruction of "add" touches planned memory, and the live tensors
+  // always fit in the planned buffer.
+  for (size_t bytes : live_bytes) {
+    EXPECT_GT(bytes, 0);
+    EXPECT_LE(bytes, meta.memory_planned_buffer_size(0).get());
+  }
+
+  EXPECT_EQ(
+      method->get_planned_memory_usage(
+          meta.num_memory_planned_buffers(),
+          {live_bytes.data(), live_bytes.size()}),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      method->get_planned_memory_usage(
+          0, {live_bytes.data(), num_instructions - 1}),
+      Error::InvalidArgument);
+
+  // Logging needs an event tracer.
+  EXPECT_EQ(method->log_planned_memory_usage(), Error::InvalidState);
+}
+
+TEST_F(MethodTest, PlannedMemoryUsageWithNoInstructions) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  // "noop" returns its inputs, so its plan has no instructions.
+  Result<Method> method = programs_["noop"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ASSERT_EQ(method->num_instructions(), 0);
+
+  // The inputs are still planned, so there is a buffer to query.
+  const auto meta = method->method_meta();
+  const size_t num_buffers = meta.num_memory_planned_buffers();
+  ASSERT_GT(num_buffers, 0);
+  for (size_t i = 0; i < num_buffers; ++i) {
+    EXPECT_EQ(method->get_planned_memory_usage(i, {}), Error::Ok);
+  }
+}
+
 /*
  * TODO(T161163608): Test is disabled due to a resize bug in tensor_index_out of
  * the portable op lib
@@ -11,8 +11,10 @@
 #include <cctype>
 #include <filesystem>
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
@@ -30,6 +32,7 @@ using executorch::runtime::Error;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::VerificationCache;
 using torch::executor::util::BufferDataLoader;
 using torch::executor::util::FileDataLoader;
 
@@ -234,6 +237,78 @@ TEST_F(ProgramTest, VerificationCatchesCorruption) {
   ASSERT_EQ(program.error(), Error::InvalidProgram);
 }
 
+namespace {
+/// Remembers the sizes of the data inserted into it.
+class FakeVerificationCache final : public VerificationCache {
+ public:
+  bool contains(const void* /*data*/, size_t size) override {
+    ++num_lookups;
+    return std::find(sizes.begin(), sizes.end(), size) != sizes.end();
+  }
+
+  void insert(const void* /*data*/, size_t size) override {
+    sizes.push_back(size);
+  }
+
+  std::vector<size_t> sizes;
+  size_t num_lookups = 0;
+};
+} // namespace
+
+TEST_F(ProgramTest, VerificationCacheRemembersVerifiedData) {
+  FakeVerificationCache cache;
+
+  // The first load verifies the data and records it.
+  Result<Program> program = Program::load(
+      add_loader_.get(),
+      Program::Verification::InternalConsistency,
+      /*task_runner=*/nullptr,
+      &cache);
+  ASSERT_EQ(program.error(), Error::Ok);
+  EXPECT_EQ(cache.num_lookups, 1);
+  ASSERT_EQ(cache.sizes.size(), 1);
+
+  // The second load finds it in the cache and does not record it again.
+  Result<Program> program2 = Program::load(
+      add_loader_.get(),
+      Program::Verification::InternalConsistency,
+      /*task_runner=*/nullptr,
+      &cache);
+  ASSERT_EQ(program2.error(), Error::Ok);
+  EXPECT_EQ(cache.num_lookups, 2);
+  EXPECT_EQ(cache.sizes.size(), 1);
+
+  // Minimal verification does not use the cache.
+  Result<Program> program3 = Program::load(
+      add_loader_.get(),
+      Program::Verification::Minimal,
+      /*task_runner=*/nullptr,
+      &cache);
+  ASSERT_EQ(program3.error(), Error::Ok);
+  EXPECT_EQ(cache.num_lookups, 2);
+}
+
+TEST_F(ProgramTest, VerificationCacheIgnoresFailedData) {
+  // Make a loader that only exposes half of the data.
+  size_t full_data_len = add_loader_->size().get();
+  Result<FreeableBuffer> full_data = add_loader_->load(
+      /*offset=*/0,
+      full_data_len,
+      /*segment_info=*/
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(full_data.error(), Error::Ok);
+  BufferDataLoader half_data_loader(full_data->data(), full_data_len / 2);
+
+  FakeVerificationCache cache;
+  Result<Program> program = Program::load(
+      &half_data_loader,
+      Program::Verification::InternalConsistency,
+      /*task_runner=*/nullptr,
+      &cache);
+  ASSERT_EQ(program.error(), Error::InvalidProgram);
+  EXPECT_TRUE(cache.sizes.empty());
+}
+
 TEST_F(ProgramTest, UnalignedProgramDataFails) {
   // Make a local copy of the data, on an odd alignment.
   size_t data_len = add_loader_->size().get();
@@ -275,3 +275,43 @@ TEST_F(PteDataMapTest, ReloadAndFree) {
   // Free data_reload0.
   data0_reload->Free();
 }
+
+TEST_F(PteDataMapTest, UnsortedKeys) {
+  // Programs from older serializers may not sort their named_data by key.
+  flatbuffers::FlatBufferBuilder builder;
+  std::array<const flatbuffers::Offset<executorch_flatbuffer::NamedData>, 3>
+      named_data_arr = {
+          executorch_flatbuffer::CreateNamedDataDirect(
+              builder, "key1", /*segment_index=*/1),
+          executorch_flatbuffer::CreateNamedDataDirect(
+              builder, "key2", /*segment_index=*/0),
+          executorch_flatbuffer::CreateNamedDataDirect(
+              builder, "key0", /*segment_index=*/0),
+      };
+  const auto named_data =
+      builder.CreateVector(named_data_arr.data(), named_data_arr.size());
+  builder.Finish(executorch_flatbuffer::CreateProgram(
+      builder, 0, 0, 0, 0, 0, 0, 0, named_data));
+  const auto* program =
+      executorch_flatbuffer::GetProgram(builder.GetBufferPointer());
+
+  // Reuse the segments of the fixture.
+  Result<PteDataMap> data_map = PteDataMap::create(
+      data_map_loader_.get(), 0, program->named_data(), program_->segments());
+  ASSERT_TRUE(data_map.ok());
+
+  for (const char* key : {"key0", "key1", "key2"}) {
+    Result<FreeableBuffer> data = data_map->get_data(key);
+    ASSERT_EQ(data.error(), Error::Ok) << key;
+    const int segment = strcmp(key, "key1") == 0 ? 1 : 0;
+    EXPECT_EQ(data->size(), kSegmentSizes[segment]);
+    EXPECT_EQ(
+        memcmp(
+            data->data(),
+            sample_data_.data() + kSegmentOffsets[segment],
+            data->size()),
+        0);
+    data->Free();
+  }
+  EXPECT_EQ(data_map->get_data("key3").error(), Error::NotFound);
+}
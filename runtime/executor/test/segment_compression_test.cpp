@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/segment_compression.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::kCompressedSegmentAlignment;
+using executorch::runtime::load_compressed_segment;
+using executorch::runtime::load_compressed_segment_into;
+using executorch::runtime::ParallelTaskRunner;
+using executorch::runtime::Result;
+using executorch::runtime::SegmentCompression;
+using executorch::runtime::Span;
+using executorch::runtime::internal::lz4_decompress_block;
+using executorch::runtime::internal::unshuffle_bytes;
+
+namespace {
+
+/// Returns an LZ4 block of a single sequence holding `data` as literals.
+std::vector<uint8_t> literal_block(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> block;
+  if (data.size() < 15) {
+    block.push_back(static_cast<uint8_t>(data.size() << 4));
+  } else {
+    block.push_back(0xf0);
+    size_t length = data.size() - 15;
+    for (; length >= 255; length -= 255) {
+      block.push_back(255);
+    }
+    block.push_back(static_cast<uint8_t>(length));
+  }
+  block.insert(block.end(), data.begin(), data.end());
+  return block;
+}
+
+/// Groups the bytes of `data` by their position in elements of `element_size`.
+std::vector<uint8_t> shuffle(
+    const std::vector<uint8_t>& data,
+    size_t element_size) {
+  std::vector<uint8_t> shuffled(data.size());
+  const size_t num_elements = data.size() / element_size;
+  for (size_t i = 0; i < num_elements; ++i) {
+    for (size_t j = 0; j < element_size; ++j) {
+      shuffled[j * num_elements + i] = data[i * element_size + j];
+    }
+  }
+  for (size_t i = num_elements * element_size; i < data.size(); ++i) {
+    shuffled[i] = data[i];
+  }
+  return shuffled;
+}
+
+/// Runs the tasks serially in reverse order, counting the calls to run().
+class ReverseTaskRunner : public ParallelTaskRunner {
+ public:
+  void run(TaskFn fn, void* context, size_t num_tasks) override {
+    ++num_runs;
+    for (size_t i = num_tasks; i > 0; --i) {
+      fn(context, i - 1);
+    }
+  }
+
+  size_t num_runs = 0;
+};
+
+} // namespace
+
+class SegmentCompressionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+
+  /**
+   * Builds a file of some padding followed by a segment holding `data_`
+   * compressed in chunks of `chunk_size` bytes.
+   */
+  void build_segment(size_t chunk_size, size_t shuffle_element_size) {
+    data_.resize(1000);
+    for (size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = static_cast<uint8_t>(i * 7 + i / 13);
+    }
+    file_.assign(kSegmentOffset, 0xee);
+    chunk_compressed_sizes_.clear();
+    for (size_t begin = 0; begin < data_.size(); begin += chunk_size) {
+      std::vector<uint8_t> chunk(
+          data_.begin() + begin,
+          data_.begin() + std::min(begin + chunk_size, data_.size()));
+      if (shuffle_element_size > 1) {
+        chunk = shuffle(chunk, shuffle_element_size);
+      }
+      std::vector<uint8_t> block = literal_block(chunk);
+      file_.insert(file_.end(), block.begin(), block.end());
+      chunk_compressed_sizes_.push_back(block.size());
+    }
+    compression_ = SegmentCompression{
+        SegmentCompression::Algorithm::LZ4,
+        data_.size(),
+        chunk_size,
+        Span<const uint64_t>(
+            chunk_compressed_sizes_.data(), chunk_compressed_sizes_.size()),
+        shuffle_element_size,
+    };
+  }
+
+  /// Decompresses a range of the segment, and checks it against `data_`.
+  void expect_range(
+      size_t offset,
+      size_t size,
+      ParallelTaskRunner* task_runner = nullptr) {
+    BufferDataLoader loader(file_.data(), file_.size());
+    std::vector<uint8_t> buffer(size);
+    Error err = load_compressed_segment_into(
+        &loader,
+        kSegmentOffset,
+        kSegmentInfo,
+        compression_,
+        offset,
+        size,
+        buffer.data(),
+        task_runner);
+    ASSERT_EQ(err, Error::Ok);
+    EXPECT_EQ(0, std::memcmp(buffer.data(), data_.data() + offset, size))
+        << "offset " << offset << " size " << size;
+  }
+
+  static constexpr size_t kSegmentOffset = 24;
+  const DataLoader::SegmentInfo kSegmentInfo = DataLoader::SegmentInfo(
+      DataLoader::SegmentInfo::Type::Constant,
+      /*segment_index=*/3);
+
+  std::vector<uint8_t> data_;
+  std::vector<uint8_t> file_;
+  std::vector<uint64_t> chunk_compressed_sizes_;
+  SegmentCompression compression_;
+};
+
+TEST_F(SegmentCompressionTest, Lz4DecompressLiterals) {
+  std::vector<uint8_t> data(600);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  std::vector<uint8_t> block = literal_block(data);
+  std::vector<uint8_t> out(data.size());
+  Result<size_t> size =
+      lz4_decompress_block(block.data(), block.size(), out.data(), out.size());
+  ASSERT_EQ(size.error(), Error::Ok);
+  EXPECT_EQ(size.get(), data.size());
+  EXPECT_EQ(out, data);
+}
+
+TEST_F(SegmentCompressionTest, Lz4DecompressOverlappingMatch) {
+  // One literal "a" followed by a match of 10 bytes at offset 1, which repeats
+  // it, then the final literals "bcdef".
+  const uint8_t block[] = {
+      0x16, 'a', 0x01, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f'};
+  char out[16];
+  Result<size_t> size =
+      lz4_decompress_block(block, sizeof(block), out, sizeof(out));
+  ASSERT_EQ(size.error(), Error::Ok);
+  EXPECT_EQ(size.get(), 16);
+  EXPECT_EQ(std::string(out, sizeof(out)), "aaaaaaaaaaabcdef");
+}
+
+TEST_F(SegmentCompressionTest, Lz4RejectsMalformedBlocks) {
+  const uint8_t block[] = {
+      0x16, 'a', 0x01, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f'};
+  uint8_t out[16];
+
+  // Truncated literals.
+  EXPECT_EQ(
+      lz4_decompress_block(block, sizeof(block) - 2, out, sizeof(out)).error(),
+      Error::InvalidProgram);
+  // Truncated match offset.
+  EXPECT_EQ(
+      lz4_decompress_block(block, 3, out, sizeof(out)).error(),
+      Error::InvalidProgram);
+  // Output too small.
+  EXPECT_EQ(
+      lz4_decompress_block(block, sizeof(block), out, sizeof(out) - 1).error(),
+      Error::InvalidProgram);
+
+  // Match offsets of zero and before the start of the output.
+  const uint8_t zero_offset[] = {0x10, 'a', 0x00, 0x00, 0x00};
+  EXPECT_EQ(
+      lz4_decompress_block(zero_offset, sizeof(zero_offset), out, sizeof(out))
+          .error(),
+      Error::InvalidProgram);
+  const uint8_t far_offset[] = {0x10, 'a', 0x02, 0x00, 0x00};
+  EXPECT_EQ(
+      lz4_decompress_block(far_offset, sizeof(far_offset), out, sizeof(out))
+          .error(),
+      Error::InvalidProgram);
+
+  // Saturated literal length without its extra bytes.
+  const uint8_t truncated_length[] = {0xf0};
+  EXPECT_EQ(
+      lz4_decompress_block(
+          truncated_length, sizeof(truncated_length), out, sizeof(out))
+          .error(),
+      Error::InvalidProgram);
+}
+
+TEST_F(SegmentCompressionTest, UnshuffleBytes) {
+  const uint8_t shuffled[] = {0, 4, 1, 5, 2, 6, 3, 7, 8, 9, 10};
+  uint8_t out[sizeof(shuffled)];
+  unshuffle_bytes(shuffled, sizeof(shuffled), /*element_size=*/4, out);
+  for (size_t i = 0; i < sizeof(out); ++i) {
+    EXPECT_EQ(out[i], i);
+  }
+}
+
+TEST_F(SegmentCompressionTest, LoadWholeSegment) {
+  build_segment(/*chunk_size=*/256, /*shuffle_element_size=*/0);
+  BufferDataLoader loader(file_.data(), file_.size());
+  Result<FreeableBuffer> buffer = load_compressed_segment(
+      &loader,
+      kSegmentOffset,
+      kSegmentInfo,
+      compression_,
+      /*offset=*/0,
+      data_.size());
+  ASSERT_EQ(buffer.error(), Error::Ok);
+  EXPECT_EQ(buffer->size(), data_.size());
+  EXPECT_EQ(
+      reinterpret_cast<uintptr_t>(buffer->data()) % kCompressedSegmentAlignment,
+      0);
+  EXPECT_EQ(0, std::memcmp(buffer->data(), data_.data(), data_.size()));
+  buffer->Free();
+}
+
+TEST_F(SegmentCompressionTest, LoadRanges) {
+  build_segment(/*chunk_size=*/256, /*shuffle_element_size=*/0);
+  expect_range(/*offset=*/0, /*size=*/256);
+  expect_range(/*offset=*/300, /*size=*/500);
+  expect_range(/*offset=*/999, /*size=*/1);
+  expect_range(/*offset=*/768, /*size=*/232);
+  expect_range(/*offset=*/0, /*size=*/0);
+}
+
+TEST_F(SegmentCompressionTest, LoadShuffledRanges) {
+  build_segment(/*chunk_size=*/100, /*shuffle_element_size=*/4);
+  expect_range(/*offset=*/0, /*size=*/1000);
+  expect_range(/*offset=*/100, /*size=*/100);
+  expect_range(/*offset=*/37, /*size=*/611);
+  expect_range(/*offset=*/995, /*size=*/5);
+}
+
+TEST_F(SegmentCompressionTest, LoadWithTaskRunner) {
+  build_segment(/*chunk_size=*/10, /*shuffle_element_size=*/2);
+  ReverseTaskRunner task_runner;
+  // 100 chunks take two batches.
+  expect_range(/*offset=*/0, /*size=*/1000, &task_runner);
+  EXPECT_EQ(task_runner.num_runs, 2);
+  expect_range(/*offset=*/5, /*size=*/20, &task_runner);
+  EXPECT_EQ(task_runner.num_runs, 3);
+  // A single chunk decompresses on the calling thread.
+  expect_range(/*offset=*/21, /*size=*/3, &task_runner);
+  EXPECT_EQ(task_runner.num_runs, 3);
+}
+
+TEST_F(SegmentCompressionTest, LoadRejectsOutOfBoundsRanges) {
+  build_segment(/*chunk_size=*/256, /*shuffle_element_size=*/0);
+  BufferDataLoader loader(file_.data(), file_.size());
+  uint8_t buffer[2];
+  EXPECT_EQ(
+      load_compressed_segment_into(
+          &loader,
+          kSegmentOffset,
+          kSegmentInfo,
+          compression_,
+          /*offset=*/999,
+          /*size=*/2,
+          buffer),
+      Error::InvalidArgument);
+}
+
+TEST_F(SegmentCompressionTest, LoadRejectsCorruptChunks) {
+  build_segment(/*chunk_size=*/256, /*shuffle_element_size=*/0);
+  // Claim that the second chunk decompresses to more data than it holds.
+  compression_.chunk_size = 512;
+  compression_.chunk_compressed_sizes = Span<const uint64_t>(
+      chunk_compressed_sizes_.data(), /*length=*/2);
+  BufferDataLoader loader(file_.data(), file_.size());
+  std::vector<uint8_t> buffer(data_.size());
+  EXPECT_EQ(
+      load_compressed_segment_into(
+          &loader,
+          kSegmentOffset,
+          kSegmentInfo,
+          compression_,
+          /*offset=*/0,
+          data_.size(),
+          buffer.data()),
+      Error::InvalidProgram);
+}
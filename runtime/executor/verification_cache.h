@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: Remembers which program data has already passed
+ * `Program::Verification::InternalConsistency`.
+ *
+ * Full verification walks the whole flatbuffer, which can dominate the load
+ * time of large programs. Clients that load the same trusted file on every
+ * launch can provide an implementation of this interface, typically backed by
+ * an app-private directory, so that `Program::load()` only verifies the data
+ * the first time; see `executorch::extension::FileVerificationCache`.
+ *
+ * A cache that reports data it has not seen as verified disables
+ * verification, so implementations must only be used with data that nobody
+ * else can modify.
+ */
+class VerificationCache {
+ public:
+  virtual ~VerificationCache() = default;
+
+  /**
+   * Returns true if `data` is known to have passed verification before.
+   *
+   * @param[in] data The program data, starting with the flatbuffer header.
+   * @param[in] size The size of the program data in bytes.
+   */
+  virtual bool contains(const void* data, size_t size) = 0;
+
+  /**
+   * Records that `data` has passed verification. Failures to record it are
+   * not errors; the data will just be verified again on the next load.
+   *
+   * @param[in] data The program data, starting with the flatbuffer header.
+   * @param[in] size The size of the program data in bytes.
+   */
+  virtual void insert(const void* data, size_t size) = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
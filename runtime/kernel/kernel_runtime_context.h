@@ -12,6 +12,7 @@
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace executorch {
@@ -36,11 +37,16 @@ class KernelRuntimeContext {
    * @param[in] temp_allocator The optional MemoryAllocator used to allocate
    *     temporary memory for the kernel. If not provided, an error will be
    *     returned when calling allocate_temp.
+   * @param[in] scratch Optional memory reserved for the kernel ahead of time,
+   *     which allocate_temp hands out before turning to temp_allocator.
    */
   KernelRuntimeContext(
       EventTracer* event_tracer = nullptr,
-      MemoryAllocator* temp_allocator = nullptr)
-      : event_tracer_(event_tracer), temp_allocator_(temp_allocator) {}
+      MemoryAllocator* temp_allocator = nullptr,
+      Span<uint8_t> scratch = {})
+      : event_tracer_(event_tracer),
+        temp_allocator_(temp_allocator),
+        scratch_(scratch) {}
   /**
    * Tells the runtime that the kernel call has failed. Prefer this over
    * ET_CHECK_*(), which fatally panics the process/system.
@@ -78,6 +84,10 @@ class KernelRuntimeContext {
    * returns a pointer to the allocated memory or an error if the allocation
    * fails.
    *
+   * Allocations come from the scratch memory reserved for the kernel while it
+   * has room, see `Kernel::scratch_size_`, and from the temp allocator after
+   * that.
+   *
    * @param[in] size Number of bytes to allocate.
    * @param[in] alignment Minimum alignment for the returned pointer. Must be a
    *     power of 2.
@@ -88,6 +98,18 @@ class KernelRuntimeContext {
   Result<void*> allocate_temp(
       size_t size,
       size_t alignment = MemoryAllocator::kDefaultAlignment) {
+    // The temp allocator reports alignments that are not a power of 2.
+    if (scratch_used_ < scratch_.size() && alignment > 0 &&
+        (alignment & (alignment - 1)) == 0) {
+      const uintptr_t begin = reinterpret_cast<uintptr_t>(scratch_.data());
+      const uintptr_t start =
+          (begin + scratch_used_ + alignment - 1) & ~(alignment - 1);
+      if (start >= begin && start - begin <= scratch_.size() &&
+          size <= scratch_.size() - (start - begin)) {
+        scratch_used_ = start - begin + size;
+        return reinterpret_cast<void*>(start);
+      }
+    }
     ET_CHECK_OR_RETURN_ERROR(
         temp_allocator_ != nullptr, NotFound, "No temp allocator provided");
     void* temp_memory = temp_allocator_->allocate(size, alignment);
@@ -104,6 +126,8 @@ class KernelRuntimeContext {
  private:
   EventTracer* event_tracer_ = nullptr;
   MemoryAllocator* temp_allocator_ = nullptr;
+  Span<uint8_t> scratch_;
+  size_t scratch_used_ = 0;
   Error failure_state_ = Error::Ok;
 };
 
@@ -36,7 +36,7 @@ constexpr uint32_t kMaxRegisteredKernels = kMaxOperators * kMaxKernelsPerOp;
 // until we add each entry to the table, allocate static zeroed memory instead
 // and point the table at it.
 // @lint-ignore CLANGTIDY facebook-hte-CArray
-alignas(sizeof(Kernel)) uint8_t
+alignas(Kernel) uint8_t
     registered_kernels_data[kMaxRegisteredKernels * sizeof(Kernel)];
 
 /// Global table of registered kernels.
@@ -45,6 +45,76 @@ Kernel* registered_kernels = reinterpret_cast<Kernel*>(registered_kernels_data);
 /// The number of kernels registered in the table.
 size_t num_registered_kernels = 0;
 
+/// Returns the smallest power of two that is greater than or equal to `n`.
+constexpr uint32_t next_power_of_two(uint32_t n) {
+  uint32_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+// Number of slots in the kernel index. Keeping the table at most half full
+// keeps linear probe sequences short, and a power of two size lets us mask
+// instead of taking a modulus.
+constexpr uint32_t kKernelIndexSize =
+    next_power_of_two(kMaxRegisteredKernels * 2);
+constexpr uint32_t kKernelIndexMask = kKernelIndexSize - 1;
+
+/// Open-addressing hash index over `registered_kernels`, keyed on operator
+/// name plus kernel key. Each slot holds `1 + <index into
+/// registered_kernels>`, or zero if the slot is empty. Kernels are never
+/// unregistered, so there is no need for tombstones. This is zero-initialized
+/// static memory, so it is valid before any static constructors run.
+uint32_t kernel_index[kKernelIndexSize];
+
+/// FNV-1a hash of the operator name and, for non-fallback keys, the kernel key
+/// string.
+uint32_t hash_kernel(const char* name, const KernelKey& key) {
+  uint32_t hash = 2166136261u;
+  for (const char* p = name; *p != '\0'; p++) {
+    hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+  }
+  if (!key.is_fallback()) {
+    // Separate the name from the key so that different splits of the same
+    // concatenated string are unlikely to collide.
+    hash = (hash ^ static_cast<uint8_t>('/')) * 16777619u;
+    for (const char* p = key.data(); *p != '\0'; p++) {
+      hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+/**
+ * Returns the kernel registered with exactly this name and key, or nullptr if
+ * there is none.
+ */
+const Kernel* find_kernel(const char* name, const KernelKey& key) {
+  for (uint32_t slot = hash_kernel(name, key) & kKernelIndexMask;
+       kernel_index[slot] != 0;
+       slot = (slot + 1) & kKernelIndexMask) {
+    const Kernel& k = registered_kernels[kernel_index[slot] - 1];
+    if (k.kernel_key_ == key && strcmp(k.name_, name) == 0) {
+      return &k;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Adds registered_kernels[kernel_idx] to the index. The caller must ensure that
+ * the same name and key is not already present.
+ */
+void add_to_kernel_index(size_t kernel_idx) {
+  const Kernel& k = registered_kernels[kernel_idx];
+  uint32_t slot = hash_kernel(k.name_, k.kernel_key_) & kKernelIndexMask;
+  while (kernel_index[slot] != 0) {
+    slot = (slot + 1) & kKernelIndexMask;
+  }
+  kernel_index[slot] = static_cast<uint32_t>(kernel_idx + 1);
+}
+
 // Registers the kernels, but may return an error.
 Error register_kernels_internal(const Span<const Kernel> kernels) {
   // Operator registration happens in static initialization time before or after
@@ -78,17 +148,15 @@ Error register_kernels_internal(const Span<const Kernel> kernels) {
       et_pal_get_shared_library_name(kernels.data());
 
   for (const auto& kernel : kernels) {
-    // Linear search. This is fine if the number of kernels is small.
-    for (size_t i = 0; i < num_registered_kernels; i++) {
-      Kernel k = registered_kernels[i];
-      if (strcmp(kernel.name_, k.name_) == 0 &&
-          kernel.kernel_key_ == k.kernel_key_) {
-        ET_LOG(Error, "Re-registering %s, from %s", k.name_, lib_name);
-        ET_LOG_KERNEL_KEY(k.kernel_key_);
-        return Error::InvalidArgument;
-      }
+    const Kernel* existing = find_kernel(kernel.name_, kernel.kernel_key_);
+    if (existing != nullptr) {
+      ET_LOG(Error, "Re-registering %s, from %s", existing->name_, lib_name);
+      ET_LOG_KERNEL_KEY(existing->kernel_key_);
+      return Error::InvalidArgument;
     }
-    registered_kernels[num_registered_kernels++] = kernel;
+    registered_kernels[num_registered_kernels] = kernel;
+    add_to_kernel_index(num_registered_kernels);
+    num_registered_kernels++;
   }
   ET_LOG(
       Debug,
@@ -223,7 +291,12 @@ bool registry_has_op_function(
   return get_op_function_from_registry(name, meta_list).ok();
 }
 
-Result<OpFunction> get_op_function_from_registry(
+namespace {
+/**
+ * Returns the kernel registered for the given name and TensorMeta list, or
+ * nullptr if there is none.
+ */
+Result<const Kernel*> lookup_kernel(
     const char* name,
     Span<const TensorMeta> meta_list) {
   std::array<char, internal::kKernelKeyBufSize> key_string;
@@ -235,25 +308,48 @@ Result<OpFunction> get_op_function_from_registry(
   }
   KernelKey kernel_key = KernelKey(key_string.data());
 
-  int32_t fallback_idx = -1;
-  for (size_t idx = 0; idx < num_registered_kernels; idx++) {
-    if (strcmp(registered_kernels[idx].name_, name) == 0) {
-      if (registered_kernels[idx].kernel_key_ == kernel_key) {
-        return registered_kernels[idx].op_;
-      }
-      if (registered_kernels[idx].kernel_key_.is_fallback()) {
-        fallback_idx = idx;
-      }
-    }
+  // Prefer the kernel specialized for this key, then fall back to the
+  // operator's non-specialized kernel. Registration rejects duplicate
+  // name/key pairs, so each lookup has at most one match.
+  const Kernel* kernel = find_kernel(name, kernel_key);
+  if (kernel == nullptr && !kernel_key.is_fallback()) {
+    kernel = find_kernel(name, KernelKey());
   }
-  if (fallback_idx != -1) {
-    return registered_kernels[fallback_idx].op_;
+  return kernel;
+}
+} // namespace
+
+Result<OpFunction> get_op_function_from_registry(
+    const char* name,
+    Span<const TensorMeta> meta_list) {
+  Result<const Kernel*> kernel = lookup_kernel(name, meta_list);
+  if (!kernel.ok()) {
+    return kernel.error();
+  }
+  if (kernel.get() != nullptr) {
+    return kernel.get()->op_;
   }
   ET_LOG(Error, "kernel '%s' not found.", name);
   ET_LOG_TENSOR_META(meta_list);
   return Error::OperatorMissing;
 }
 
+bool registry_op_is_in_place_safe(
+    const char* name,
+    Span<const TensorMeta> meta_list) {
+  Result<const Kernel*> kernel = lookup_kernel(name, meta_list);
+  return kernel.ok() && kernel.get() != nullptr &&
+      kernel.get()->in_place_safe_;
+}
+
+ScratchSizeFunction registry_op_scratch_size_function(
+    const char* name,
+    Span<const TensorMeta> meta_list) {
+  Result<const Kernel*> kernel = lookup_kernel(name, meta_list);
+  return kernel.ok() && kernel.get() != nullptr ? kernel.get()->scratch_size_
+                                                : nullptr;
+}
+
 Span<const Kernel> get_registered_kernels() {
   return {registered_kernels, num_registered_kernels};
 }
@@ -44,6 +44,9 @@ namespace runtime {
 
 class KernelRuntimeContext; // Forward declaration
 using OpFunction = void (*)(KernelRuntimeContext&, EValue**);
+/// Returns the number of bytes of temp memory that a kernel needs for the
+/// given arguments. See `Kernel::scratch_size_`.
+using ScratchSizeFunction = size_t (*)(EValue**);
 
 /**
  * Dtype and dim order metadata for a Tensor argument to an operator.
@@ -184,6 +187,21 @@ struct Kernel {
   // Data is not owned by the Kernel struct.
   KernelKey kernel_key_;
   OpFunction op_;
+  /**
+   * Whether the kernel computes the right result when its out tensor aliases
+   * its first (self) argument, e.g. because it reads each element of self
+   * before writing the same element of out. Memory planning can then place
+   * out in the buffer of a self that is not used afterwards.
+   */
+  bool in_place_safe_ = false;
+  /**
+   * Optional. Returns the most temp memory, in bytes, that the kernel will
+   * request from KernelRuntimeContext::allocate_temp() for the given
+   * arguments. A Method calls it once when it is loaded, with tensors at their
+   * upper-bound sizes, and reserves that memory for the kernel so that
+   * allocate_temp() does not hit the temp allocator while executing.
+   */
+  ScratchSizeFunction scratch_size_ = nullptr;
   /**
    * We are doing a copy of the string pointer instead of duplicating the string
    * itself, we require the lifetime of the operator name to be at least as long
@@ -194,6 +212,28 @@ struct Kernel {
   explicit Kernel(const char* name, KernelKey key, OpFunction func)
       : name_(name), kernel_key_(key), op_(func) {}
 
+  explicit Kernel(
+      const char* name,
+      KernelKey key,
+      OpFunction func,
+      bool in_place_safe)
+      : name_(name),
+        kernel_key_(key),
+        op_(func),
+        in_place_safe_(in_place_safe) {}
+
+  explicit Kernel(
+      const char* name,
+      KernelKey key,
+      OpFunction func,
+      bool in_place_safe,
+      ScratchSizeFunction scratch_size)
+      : name_(name),
+        kernel_key_(key),
+        op_(func),
+        in_place_safe_(in_place_safe),
+        scratch_size_(scratch_size) {}
+
   Kernel() {}
 };
 
@@ -233,6 +273,25 @@ bool registry_has_op_function(
     const char* name,
     Span<const TensorMeta> meta_list = {});
 
+/**
+ * Returns whether the kernel that get_op_function_from_registry() would return
+ * for the given name and TensorMeta list is in-place safe: it may be called
+ * with its out tensor aliasing its self argument. Returns false if there is no
+ * such kernel.
+ */
+bool registry_op_is_in_place_safe(
+    const char* name,
+    Span<const TensorMeta> meta_list = {});
+
+/**
+ * Returns the `Kernel::scratch_size_` function of the kernel that
+ * get_op_function_from_registry() would return for the given name and
+ * TensorMeta list, or nullptr if it has none or there is no such kernel.
+ */
+ScratchSizeFunction registry_op_scratch_size_function(
+    const char* name,
+    Span<const TensorMeta> meta_list = {});
+
 /**
  * Returns all registered kernels.
  */
@@ -269,6 +328,7 @@ using ::executorch::runtime::Kernel;
 using ::executorch::runtime::KernelKey;
 using ::executorch::runtime::KernelRuntimeContext;
 using ::executorch::runtime::OpFunction;
+using ::executorch::runtime::ScratchSizeFunction;
 using ::executorch::runtime::TensorMeta;
 using KernelRuntimeContext = ::executorch::runtime::KernelRuntimeContext;
 
@@ -17,6 +17,7 @@ using executorch::runtime::Error;
 using executorch::runtime::KernelRuntimeContext;
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 
 class KernelRuntimeContextTest : public ::testing::Test {
  public:
@@ -100,3 +101,33 @@ TEST_F(KernelRuntimeContextTest, MemoryAllocatorAlignmentPassed) {
   EXPECT_EQ(allocated_memory.ok(), true);
   EXPECT_EQ(temp_allocator.last_seen_alignment, 2);
 }
+
+TEST_F(KernelRuntimeContextTest, AllocatesFromScratchFirst) {
+  alignas(16) uint8_t scratch[32];
+  constexpr size_t temp_memory_allocator_pool_size = 16;
+  auto temp_memory_allocator_pool =
+      std::make_unique<uint8_t[]>(temp_memory_allocator_pool_size);
+  MemoryAllocator temp_allocator(
+      temp_memory_allocator_pool_size, temp_memory_allocator_pool.get());
+  KernelRuntimeContext context(
+      nullptr, &temp_allocator, Span<uint8_t>(scratch, sizeof(scratch)));
+
+  Result<void*> first = context.allocate_temp(4, 1);
+  ASSERT_EQ(first.error(), Error::Ok);
+  EXPECT_EQ(first.get(), scratch);
+
+  // Allocations in the scratch memory are aligned.
+  Result<void*> second = context.allocate_temp(8, 16);
+  ASSERT_EQ(second.error(), Error::Ok);
+  EXPECT_EQ(second.get(), scratch + 16);
+
+  // What does not fit in the scratch memory comes from the temp allocator.
+  Result<void*> third = context.allocate_temp(16, 1);
+  ASSERT_EQ(third.error(), Error::Ok);
+  EXPECT_EQ(third.get(), temp_memory_allocator_pool.get());
+
+  // The scratch memory keeps serving what fits in its remainder.
+  Result<void*> fourth = context.allocate_temp(8, 1);
+  ASSERT_EQ(fourth.error(), Error::Ok);
+  EXPECT_EQ(fourth.get(), scratch + 24);
+}
@@ -7,6 +7,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string>
 #include <vector>
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -31,6 +32,8 @@ using executorch::runtime::KernelRuntimeContext;
 using executorch::runtime::OpFunction;
 using executorch::runtime::register_kernels;
 using executorch::runtime::registry_has_op_function;
+using executorch::runtime::registry_op_is_in_place_safe;
+using executorch::runtime::registry_op_scratch_size_function;
 using executorch::runtime::Result;
 using executorch::runtime::Span;
 using executorch::runtime::TensorMeta;
@@ -508,3 +511,161 @@ TEST_F(OperatorRegistryTest, ExecutorUsesFallbackKernel) {
   auto val = values[0].toScalar().to<int64_t>();
   ASSERT_EQ(val, 100);
 }
+
+TEST_F(OperatorRegistryTest, SpecializedKernelPreferredOverFallback) {
+  std::array<char, kKernelKeyBufSize> buf_long_contiguous;
+  Error err = make_kernel_key(
+      {{ScalarType::Long, {0, 1, 2, 3}}},
+      buf_long_contiguous.data(),
+      buf_long_contiguous.size());
+  ASSERT_EQ(err, Error::Ok);
+  KernelKey key = KernelKey(buf_long_contiguous.data());
+
+  // Register the fallback first so that lookup order cannot matter.
+  Kernel kernels[] = {
+      Kernel(
+          "test::grault",
+          KernelKey{},
+          [](KernelRuntimeContext& context, EValue** stack) {
+            (void)context;
+            *(stack[0]) = Scalar(50);
+          }),
+      Kernel(
+          "test::grault",
+          key,
+          [](KernelRuntimeContext& context, EValue** stack) {
+            (void)context;
+            *(stack[0]) = Scalar(100);
+          })};
+  err = register_kernels(kernels);
+  ASSERT_EQ(err, Error::Ok);
+
+  EValue values[1];
+  EValue* evalues[1] = {&values[0]};
+  KernelRuntimeContext context{};
+
+  // The specialized kernel matches the Long/contiguous key.
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = Span<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  Result<OpFunction> func =
+      get_op_function_from_registry("test::grault", meta_long);
+  ASSERT_EQ(func.error(), Error::Ok);
+  values[0] = Scalar(0);
+  (*func)(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 100);
+
+  // Any other key gets the fallback kernel.
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+  Result<OpFunction> fallback_func =
+      get_op_function_from_registry("test::grault", meta_float);
+  ASSERT_EQ(fallback_func.error(), Error::Ok);
+  values[0] = Scalar(0);
+  (*fallback_func)(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 50);
+}
+
+TEST_F(OperatorRegistryTest, InPlaceSafeFollowsSelectedKernel) {
+  std::array<char, kKernelKeyBufSize> buf_long_contiguous;
+  Error err = make_kernel_key(
+      {{ScalarType::Long, {0, 1, 2, 3}}},
+      buf_long_contiguous.data(),
+      buf_long_contiguous.size());
+  ASSERT_EQ(err, Error::Ok);
+  KernelKey key = KernelKey(buf_long_contiguous.data());
+
+  Kernel kernels[] = {
+      Kernel("test::waldo", [](KernelRuntimeContext&, EValue**) {}),
+      Kernel(
+          "test::fred",
+          KernelKey{},
+          [](KernelRuntimeContext&, EValue**) {},
+          /*in_place_safe=*/true),
+      Kernel(
+          "test::fred",
+          key,
+          [](KernelRuntimeContext&, EValue**) {},
+          /*in_place_safe=*/false)};
+  err = register_kernels(kernels);
+  ASSERT_EQ(err, Error::Ok);
+
+  // Kernels are not in-place safe unless they say so.
+  EXPECT_FALSE(registry_op_is_in_place_safe("test::waldo"));
+  EXPECT_TRUE(registry_op_is_in_place_safe("test::fred"));
+  EXPECT_FALSE(registry_op_is_in_place_safe("test::plugh"));
+
+  // The answer comes from the kernel that the lookup would select.
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = Span<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+  EXPECT_FALSE(registry_op_is_in_place_safe("test::fred", meta_long));
+  EXPECT_TRUE(registry_op_is_in_place_safe("test::fred", meta_float));
+}
+
+TEST_F(OperatorRegistryTest, ScratchSizeFunctionFollowsSelectedKernel) {
+  std::array<char, kKernelKeyBufSize> buf_long_contiguous;
+  Error err = make_kernel_key(
+      {{ScalarType::Long, {0, 1, 2, 3}}},
+      buf_long_contiguous.data(),
+      buf_long_contiguous.size());
+  ASSERT_EQ(err, Error::Ok);
+  KernelKey key = KernelKey(buf_long_contiguous.data());
+
+  Kernel kernels[] = {
+      Kernel("test::garply", [](KernelRuntimeContext&, EValue**) {}),
+      Kernel(
+          "test::thud",
+          KernelKey{},
+          [](KernelRuntimeContext&, EValue**) {},
+          /*in_place_safe=*/false,
+          [](EValue**) -> size_t { return 64; }),
+      Kernel(
+          "test::thud",
+          key,
+          [](KernelRuntimeContext&, EValue**) {},
+          /*in_place_safe=*/false,
+          [](EValue**) -> size_t { return 128; })};
+  err = register_kernels(kernels);
+  ASSERT_EQ(err, Error::Ok);
+
+  EXPECT_EQ(registry_op_scratch_size_function("test::garply"), nullptr);
+  EXPECT_EQ(registry_op_scratch_size_function("test::plugh"), nullptr);
+
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = Span<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+  auto scratch_long = registry_op_scratch_size_function("test::thud", meta_long);
+  auto scratch_float =
+      registry_op_scratch_size_function("test::thud", meta_float);
+  ASSERT_NE(scratch_long, nullptr);
+  ASSERT_NE(scratch_float, nullptr);
+  EXPECT_EQ(scratch_long(nullptr), 128);
+  EXPECT_EQ(scratch_float(nullptr), 64);
+}
+
+TEST_F(OperatorRegistryTest, LookupManyKernels) {
+  // Register enough kernels to force collisions in the registry's index, and
+  // make sure that every one of them can still be found.
+  constexpr size_t kNumOps = 200;
+  // The registry holds on to the name pointers, so they must outlive the test.
+  static std::vector<std::string> names;
+  names.reserve(kNumOps);
+  for (size_t i = 0; i < kNumOps; i++) {
+    names.push_back("test::many_" + std::to_string(i));
+  }
+  std::vector<Kernel> kernels;
+  kernels.reserve(kNumOps);
+  for (const auto& name : names) {
+    kernels.emplace_back(name.c_str(), [](KernelRuntimeContext&, EValue**) {});
+  }
+  Error err = register_kernels({kernels.data(), kernels.size()});
+  ASSERT_EQ(err, Error::Ok);
+
+  for (const auto& name : names) {
+    EXPECT_TRUE(registry_has_op_function(name.c_str())) << name;
+  }
+  EXPECT_FALSE(registry_has_op_function("test::many_"));
+  EXPECT_FALSE(registry_has_op_function("test::many_200"));
+}
@@ -53,3 +53,7 @@ void* et_pal_allocate(ET_UNUSED size_t size) {
 }
 
 void et_pal_free(ET_UNUSED void* ptr) {}
+
+void et_pal_get_allocator_stats(et_pal_allocator_stats_t* stats) {
+  *stats = {};
+}
@@ -134,4 +134,29 @@ void* et_pal_allocate(size_t size) ET_INTERNAL_PLATFORM_WEAKNESS;
  */
 void et_pal_free(void* ptr) ET_INTERNAL_PLATFORM_WEAKNESS;
 
+/**
+ * Statistics of the memory handed out by et_pal_allocate().
+ */
+typedef struct {
+  /// Bytes allocated and not freed yet.
+  size_t live_bytes;
+  /// The most bytes that were live at once.
+  size_t peak_live_bytes;
+  /// Bytes of freed memory kept by the allocator for reuse.
+  size_t cached_bytes;
+  /// Calls to et_pal_allocate() that returned memory.
+  size_t num_allocations;
+  /// Allocations that reused cached memory instead of asking the system.
+  size_t num_cache_hits;
+} et_pal_allocator_stats_t;
+
+/**
+ * Reports statistics of et_pal_allocate(). Implementations that don't keep
+ * them report zeros.
+ *
+ * @param[out] stats Receives the statistics.
+ */
+void et_pal_get_allocator_stats(et_pal_allocator_stats_t* stats)
+    ET_INTERNAL_PLATFORM_WEAKNESS;
+
 } // extern "C"
@@ -11,6 +11,15 @@ def _select_pal(dict_):
         fail("Missing key for executorch.pal_default value '{}' in dict '{}'".format(pal_default, dict_))
     return dict_[pal_default]
 
+def _get_pal_flags():
+    """Returns the preprocessor flags of the default PAL implementation."""
+    flags = []
+    if native.read_config("executorch", "pal_cycle_counter", "false") == "true":
+        flags.append("-DET_PAL_USE_CYCLE_COUNTER")
+    if native.read_config("executorch", "pal_pooled_allocator", "false") == "true":
+        flags.append("-DET_PAL_USE_POOLED_ALLOCATOR")
+    return flags
+
 def profiling_enabled():
     return native.read_config("executorch", "prof_enabled", "false") == "true"
 
@@ -45,6 +54,7 @@ def define_common_targets():
             "minimal": ["default/minimal.cpp"],
             "posix": ["default/posix.cpp"],
         }),
+        preprocessor_flags = _get_pal_flags(),
         deps = [
             ":pal_interface",
         ],
@@ -8,6 +8,12 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include <executorch/runtime/platform/clock.h>
 #include <executorch/runtime/platform/platform.h>
 
 TEST(ExecutorPalTest, Initialization) {
@@ -33,3 +39,66 @@ TEST(ExecutorPalTest, TickRateRatioSanity) {
   ASSERT_TRUE(tick_ns_ratio.numerator > 0);
   ASSERT_TRUE(tick_ns_ratio.denominator > 0);
 }
+
+TEST(ExecutorPalTest, TicksToNsMatchesSteadyClock) {
+  et_pal_init();
+
+  // Holds whether the ticks come from the steady_clock or from a calibrated
+  // cycle counter (ET_PAL_USE_CYCLE_COUNTER).
+  const auto clock_start = std::chrono::steady_clock::now();
+  const et_timestamp_t ticks_start = et_pal_current_ticks();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const et_timestamp_t ticks_end = et_pal_current_ticks();
+  const auto clock_end = std::chrono::steady_clock::now();
+
+  const double clock_ns =
+      std::chrono::duration<double, std::nano>(clock_end - clock_start)
+          .count();
+  const double ticks_ns =
+      static_cast<double>(executorch::runtime::ticks_to_ns(ticks_end)) -
+      static_cast<double>(executorch::runtime::ticks_to_ns(ticks_start));
+  EXPECT_GT(ticks_ns, 0);
+  EXPECT_LE(ticks_ns, clock_ns);
+  EXPECT_GT(ticks_ns, 0.9 * clock_ns);
+}
+
+TEST(ExecutorPalTest, AllocatorStatistics) {
+  et_pal_init();
+
+  et_pal_allocator_stats_t before;
+  et_pal_get_allocator_stats(&before);
+  void* a = et_pal_allocate(100);
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(std::max_align_t), 0);
+  memset(a, 0xff, 100);
+  et_pal_allocator_stats_t during;
+  et_pal_get_allocator_stats(&during);
+  et_pal_free(a);
+  void* b = et_pal_allocate(90);
+  ASSERT_NE(b, nullptr);
+  et_pal_free(b);
+  et_pal_free(nullptr);
+  et_pal_allocator_stats_t after;
+  et_pal_get_allocator_stats(&after);
+
+  if (during.num_allocations == 0) {
+    // The PAL doesn't keep statistics, e.g. the malloc() of the default one.
+    EXPECT_EQ(after.live_bytes, 0);
+    EXPECT_EQ(after.num_allocations, 0);
+    return;
+  }
+  // ET_PAL_USE_POOLED_ALLOCATOR: the second allocation reuses the first block.
+  EXPECT_EQ(during.live_bytes, before.live_bytes + 100);
+  EXPECT_GE(during.peak_live_bytes, during.live_bytes);
+  EXPECT_EQ(after.live_bytes, before.live_bytes);
+  EXPECT_EQ(after.num_allocations, before.num_allocations + 2);
+  EXPECT_EQ(after.num_cache_hits, before.num_cache_hits + 1);
+  EXPECT_GT(after.cached_bytes, 0);
+
+  // A thread gives its cached blocks back when it exits.
+  std::thread([] { et_pal_free(et_pal_allocate(1000)); }).join();
+  et_pal_allocator_stats_t joined;
+  et_pal_get_allocator_stats(&joined);
+  EXPECT_EQ(joined.cached_bytes, after.cached_bytes);
+  EXPECT_EQ(joined.live_bytes, after.live_bytes);
+}
@@ -85,6 +85,10 @@ void et_pal_free(void* ptr) {
   platform_intercept->free(ptr);
 }
 
+void et_pal_get_allocator_stats(et_pal_allocator_stats_t* stats) {
+  *stats = {};
+}
+
 } // extern "C"
 
 #include <gtest/gtest.h>
@@ -84,6 +84,7 @@ def et_operator_library(
         include_all_operators = False,
         ops_schema_yaml_target = None,
         server_generated_yaml_target = None,
+        include_static_sizes = False,
         **kwargs):
     # do a dummy copy if server_generated_yaml_target is set
     if server_generated_yaml_target:
@@ -116,6 +117,10 @@ def et_operator_library(
             genrule_cmd.append(
                 "--model_file_path=$(location {})".format(model),
             )
+            if include_static_sizes:
+                genrule_cmd.append(
+                    "--include_static_sizes",
+                )
         if include_all_operators:
             genrule_cmd.append(
                 "--include_all_operators",
@@ -1213,6 +1213,9 @@ ATEN_OPS = (
     ),
     op_target(
         name = "op_topk",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
     ),
     op_target(
         name = "op_transpose_copy",
@@ -166,6 +166,27 @@ class ModuleMultipleEntry(torch.nn.Module):
         return ["forward", "forward2"]
 
 
+class ModuleSharedState(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.register_buffer("state", torch.zeros(2, 2, dtype=torch.float))
+
+    def forward(self, x: torch.Tensor):
+        self.state.add_(x)
+        return self.state * 1
+
+    def forward2(self, x: torch.Tensor):
+        self.state.add_(2 * x)
+        return self.state * 1
+
+    def get_random_inputs(self):
+        return (torch.ones(2, 2, dtype=torch.float),)
+
+    @staticmethod
+    def get_method_names_to_export() -> List[str]:
+        return ["forward", "forward2"]
+
+
 class ModuleSimpleTrain(torch.nn.Module):
     def __init__(self):
         super().__init__()
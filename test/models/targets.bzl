@@ -64,6 +64,8 @@ def define_common_targets():
         "ModuleBasic",
         "ModuleLinear",
         "ModuleMultipleEntry",
+        "ModuleNoOp",
+        "ModuleSharedState",
         "ModuleIndex",
         "ModuleDynamicCatUnallocatedIO",
         "ModuleSimpleTrain",
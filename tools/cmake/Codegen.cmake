@@ -12,7 +12,9 @@
 include(${EXECUTORCH_ROOT}/tools/cmake/Utils.cmake)
 
 function(gen_selected_ops)
-  set(arg_names LIB_NAME OPS_SCHEMA_YAML ROOT_OPS INCLUDE_ALL_OPS)
+  set(arg_names LIB_NAME OPS_SCHEMA_YAML ROOT_OPS INCLUDE_ALL_OPS MODEL
+                DTYPE_SELECTIVE_BUILD
+  )
   cmake_parse_arguments(GEN "" "" "${arg_names}" ${ARGN})
 
   message(STATUS "Generating operator lib:")
@@ -20,6 +22,8 @@ function(gen_selected_ops)
   message(STATUS "  OPS_SCHEMA_YAML: ${GEN_OPS_SCHEMA_YAML}")
   message(STATUS "  ROOT_OPS: ${GEN_ROOT_OPS}")
   message(STATUS "  INCLUDE_ALL_OPS: ${GEN_INCLUDE_ALL_OPS}")
+  message(STATUS "  MODEL: ${GEN_MODEL}")
+  message(STATUS "  DTYPE_SELECTIVE_BUILD: ${GEN_DTYPE_SELECTIVE_BUILD}")
 
   set(_oplist_yaml
       ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/selected_operators.yaml
@@ -43,16 +47,41 @@ function(gen_selected_ops)
   if(GEN_INCLUDE_ALL_OPS)
     list(APPEND _gen_oplist_command --include_all_operators)
   endif()
+  if(GEN_MODEL)
+    list(APPEND _gen_oplist_command --model_file_path="${GEN_MODEL}")
+    # The dtypes and static sizes of the model's kernels are only used to
+    # specialize the kernels, see gen_selected_portable_kernels().
+    if(GEN_DTYPE_SELECTIVE_BUILD)
+      list(APPEND _gen_oplist_command --include_static_sizes)
+    endif()
+  endif()
 
   message("Command - ${_gen_oplist_command}")
   add_custom_command(
     COMMENT "Generating selected_operators.yaml for ${GEN_LIB_NAME}"
     OUTPUT ${_oplist_yaml}
     COMMAND ${_gen_oplist_command}
-    DEPENDS ${GEN_OPS_SCHEMA_YAML} ${_codegen_tools_srcs}
+    DEPENDS ${GEN_OPS_SCHEMA_YAML} ${GEN_MODEL} ${_codegen_tools_srcs}
     WORKING_DIRECTORY ${EXECUTORCH_ROOT}
   )
 
+  if(GEN_DTYPE_SELECTIVE_BUILD)
+    set(_opvariant_h_dir
+        ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/executorch/kernels/portable/cpu
+    )
+    set(_opvariant_h ${_opvariant_h_dir}/selected_op_variants.h)
+    file(MAKE_DIRECTORY ${_opvariant_h_dir})
+    add_custom_command(
+      COMMENT "Generating selected_op_variants.h for ${GEN_LIB_NAME}"
+      OUTPUT ${_opvariant_h}
+      COMMAND
+        "${PYTHON_EXECUTABLE}" -m codegen.tools.gen_selected_op_variants
+        --yaml-file-path=${_oplist_yaml} --output-dir=${_opvariant_h_dir}
+      DEPENDS ${_oplist_yaml} ${_codegen_tools_srcs}
+      WORKING_DIRECTORY ${EXECUTORCH_ROOT}
+    )
+  endif()
+
 endfunction()
 
 # Codegen for registering kernels. Kernels are defined in functions_yaml and
@@ -192,6 +221,39 @@ function(gen_operators_lib)
   )
 endfunction()
 
+# Build the portable kernels specialized for the ops selected by
+# gen_selected_ops(DTYPE_SELECTIVE_BUILD ON): kernels only keep the dtypes the
+# model uses and, when it always calls an op with the same inner size, are
+# compiled for that size. The library is named ${LIB_NAME}_portable_kernels.
+#
+# Invoked as gen_selected_portable_kernels(LIB_NAME lib_name), with the same
+# LIB_NAME as gen_selected_ops.
+function(gen_selected_portable_kernels)
+  cmake_parse_arguments(GEN "" "LIB_NAME" "" ${ARGN})
+  message(STATUS "Generating selected portable kernels:")
+  message(STATUS "  LIB_NAME: ${GEN_LIB_NAME}")
+
+  file(GLOB_RECURSE _portable_kernels_srcs
+       "${EXECUTORCH_ROOT}/kernels/portable/cpu/*.cpp"
+  )
+  list(FILTER _portable_kernels_srcs EXCLUDE REGEX "test/*.cpp")
+  list(FILTER _portable_kernels_srcs EXCLUDE REGEX "codegen")
+
+  set(_out_dir ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME})
+  set(_kernels_lib ${GEN_LIB_NAME}_portable_kernels)
+  add_library(
+    ${_kernels_lib}
+    ${_portable_kernels_srcs}
+    ${_out_dir}/executorch/kernels/portable/cpu/selected_op_variants.h
+  )
+  # Put the generated selected_op_variants.h ahead of the source tree.
+  target_include_directories(${_kernels_lib} BEFORE PRIVATE ${_out_dir})
+  target_compile_definitions(
+    ${_kernels_lib} PRIVATE EXECUTORCH_SELECTIVE_BUILD_DTYPE
+  )
+  target_link_libraries(${_kernels_lib} PRIVATE executorch)
+endfunction()
+
 # Merge two kernel yaml files, prioritizing functions from FUNCTIONS_YAML and
 # taking functions from FALLBACK_YAML when no implementation is found. This
 # corresponds to the merge_yaml buck implementation in codegen/tools.
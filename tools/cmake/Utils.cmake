@@ -40,6 +40,12 @@ function(executorch_print_configuration_summary)
   message(
     STATUS "  EXECUTORCH_LOG_LEVEL                   : ${EXECUTORCH_LOG_LEVEL}"
   )
+  message(STATUS "  EXECUTORCH_PAL_USE_CYCLE_COUNTER       : "
+                 "${EXECUTORCH_PAL_USE_CYCLE_COUNTER}"
+  )
+  message(STATUS "  EXECUTORCH_PAL_USE_POOLED_ALLOCATOR    : "
+                 "${EXECUTORCH_PAL_USE_POOLED_ALLOCATOR}"
+  )
   message(STATUS "  EXECUTORCH_BUILD_ANDROID_JNI           : "
                  "${EXECUTORCH_BUILD_ANDROID_JNI}"
   )
@@ -49,6 +55,9 @@ function(executorch_print_configuration_summary)
   message(STATUS "  EXECUTORCH_BUILD_CADENCE               : "
                  "${EXECUTORCH_BUILD_CADENCE}"
   )
+  message(STATUS "  EXECUTORCH_BUILD_CORTEX_M              : "
+                 "${EXECUTORCH_BUILD_CORTEX_M}"
+  )
   message(
     STATUS
       "  EXECUTORCH_BUILD_COREML                : ${EXECUTORCH_BUILD_COREML}"
@@ -96,6 +105,9 @@ function(executorch_print_configuration_summary)
   message(STATUS "  EXECUTORCH_BUILD_HOST_TARGETS          : "
                  "${EXECUTORCH_BUILD_HOST_TARGETS}"
   )
+  message(STATUS "  EXECUTORCH_BUILD_KERNELS_BENCHMARK     : "
+                 "${EXECUTORCH_BUILD_KERNELS_BENCHMARK}"
+  )
   message(STATUS "  EXECUTORCH_BUILD_KERNELS_CUSTOM        : "
                  "${EXECUTORCH_BUILD_KERNELS_CUSTOM}"
   )
@@ -65,6 +65,7 @@ endif()
 set(lib_list
     etdump
     bundled_program
+    bundled_program_batch_verification
     extension_data_loader
     ${FLATCCRT_LIB}
     coreml_util
@@ -99,6 +100,9 @@ set(lib_list
     quantized_kernels
     quantized_ops_lib
     quantized_ops_aot_lib
+    cortex_m_kernels
+    cortex_m_ops_lib
+    cmsis-nn
 )
 foreach(lib ${lib_list})
   # Name of the variable which stores result of the find_library search